@@ -0,0 +1,32 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/bump_allocator.h"
+
+#include <cstdint>
+
+namespace pw::allocator {
+
+void* BumpAllocator::DoAllocate(size_t size, size_t alignment) {
+  const uintptr_t next = reinterpret_cast<uintptr_t>(region_.data()) + used_;
+  const size_t padding = (alignment - next % alignment) % alignment;
+  if (padding > remaining() || size > remaining() - padding) {
+    return nullptr;
+  }
+  std::byte* const allocation = region_.data() + used_ + padding;
+  used_ += padding + size;
+  return allocation;
+}
+
+}  // namespace pw::allocator
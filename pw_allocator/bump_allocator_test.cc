@@ -0,0 +1,92 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/bump_allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_containers/inlined_vector.h"
+
+namespace pw::allocator {
+namespace {
+
+class BumpAllocatorTest : public ::testing::Test {
+ protected:
+  BumpAllocatorTest() : allocator_(buffer_) {}
+
+  alignas(std::max_align_t) std::array<std::byte, 128> buffer_ = {};
+  BumpAllocator allocator_;
+};
+
+TEST_F(BumpAllocatorTest, Allocate_Consecutive) {
+  void* first = allocator_.Allocate(8, 1);
+  void* second = allocator_.Allocate(8, 1);
+  EXPECT_EQ(buffer_.data(), first);
+  EXPECT_EQ(buffer_.data() + 8, second);
+  EXPECT_EQ(16u, allocator_.used());
+  EXPECT_EQ(112u, allocator_.remaining());
+}
+
+TEST_F(BumpAllocatorTest, Allocate_Aligned) {
+  ASSERT_NE(nullptr, allocator_.Allocate(1, 1));
+  void* aligned = allocator_.Allocate(4, 16);
+  EXPECT_EQ(buffer_.data() + 16, aligned);
+  EXPECT_EQ(20u, allocator_.used());
+}
+
+TEST_F(BumpAllocatorTest, Allocate_Exhausted) {
+  EXPECT_NE(nullptr, allocator_.Allocate(120, 1));
+  EXPECT_EQ(nullptr, allocator_.Allocate(9, 1));
+  EXPECT_NE(nullptr, allocator_.Allocate(8, 1));
+  EXPECT_EQ(nullptr, allocator_.Allocate(1, 1));
+}
+
+TEST_F(BumpAllocatorTest, Reset_ReclaimsEverything) {
+  ASSERT_NE(nullptr, allocator_.Allocate(100));
+  allocator_.Free(buffer_.data());
+  EXPECT_EQ(nullptr, allocator_.Allocate(100));
+
+  allocator_.Reset();
+  EXPECT_EQ(0u, allocator_.used());
+  EXPECT_EQ(buffer_.data(), allocator_.Allocate(100));
+}
+
+TEST_F(BumpAllocatorTest, New_ConstructsObject) {
+  struct Point {
+    int x;
+    int y;
+  };
+  Point* point = allocator_.New<Point>(Point{1, 2});
+  ASSERT_NE(nullptr, point);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(point) % alignof(Point));
+  EXPECT_EQ(2, point->y);
+  allocator_.Delete(point);
+}
+
+TEST_F(BumpAllocatorTest, InlinedVector_UsesAllocatorInterface) {
+  Allocator& allocator = allocator_;
+  InlinedVector<uint16_t, 4, Allocator> vector(allocator);
+  for (uint16_t i = 0; i < 10; ++i) {
+    ASSERT_EQ(OkStatus(), vector.push_back(i));
+  }
+  EXPECT_FALSE(vector.is_inline());
+  EXPECT_GT(allocator_.used(), 0u);
+  EXPECT_EQ(9u, vector.back());
+}
+
+}  // namespace
+}  // namespace pw::allocator
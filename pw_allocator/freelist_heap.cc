@@ -22,7 +22,7 @@
 namespace pw::allocator {
 
 FreeListHeap::FreeListHeap(std::span<std::byte> region, FreeList& freelist)
-    : freelist_(freelist), heap_stats_() {
+    : first_block_(nullptr), freelist_(freelist), heap_stats_() {
   Block* block;
   PW_CHECK_OK(
       Block::Init(region, &block),
@@ -32,6 +32,7 @@ FreeListHeap::FreeListHeap(std::span<std::byte> region, FreeList& freelist)
       .IgnoreError();  // TODO(pwbug/387): Handle Status properly
 
   region_ = region;
+  first_block_ = block;
   heap_stats_.total_bytes = region.size();
 }
 
@@ -41,6 +42,7 @@ void* FreeListHeap::Allocate(size_t size) {
   auto chunk = freelist_.FindChunk(size);
 
   if (chunk.data() == nullptr) {
+    heap_stats_.failed_allocate_calls += 1;
     return nullptr;
   }
   freelist_.RemoveChunk(chunk)
@@ -60,8 +62,13 @@ void* FreeListHeap::Allocate(size_t size) {
 
   chunk_block->MarkUsed();
 
-  heap_stats_.bytes_allocated += size;
-  heap_stats_.cumulative_allocated += size;
+  // Count the whole block, which Free subtracts when it is released.
+  const size_t block_size = chunk_block->InnerSize();
+  heap_stats_.bytes_allocated += block_size;
+  if (heap_stats_.bytes_allocated > heap_stats_.peak_bytes_allocated) {
+    heap_stats_.peak_bytes_allocated = heap_stats_.bytes_allocated;
+  }
+  heap_stats_.cumulative_allocated += block_size;
   heap_stats_.total_allocate_calls += 1;
 
   return chunk_block->UsableSpace();
@@ -171,6 +178,18 @@ void* FreeListHeap::Calloc(size_t num, size_t size) {
   return ptr;
 }
 
+FreeListHeap::FragmentationStats FreeListHeap::GetFragmentationStats() const {
+  FragmentationStats stats = {};
+  ForEachFreeBlock([&stats](size_t size) {
+    stats.free_bytes += size;
+    stats.free_blocks += 1;
+    if (size > stats.largest_free_block) {
+      stats.largest_free_block = size;
+    }
+  });
+  return stats;
+}
+
 void FreeListHeap::LogHeapStats() {
   PW_LOG_INFO(" ");
   PW_LOG_INFO("    The current heap information: ");
@@ -178,6 +197,8 @@ void FreeListHeap::LogHeapStats() {
               static_cast<unsigned int>(heap_stats_.total_bytes));
   PW_LOG_INFO("          The current allocated heap memory is %u bytes.",
               static_cast<unsigned int>(heap_stats_.bytes_allocated));
+  PW_LOG_INFO("          The peak allocated heap memory is %u bytes.",
+              static_cast<unsigned int>(heap_stats_.peak_bytes_allocated));
   PW_LOG_INFO("          The cumulative allocated heap memory is %u bytes.",
               static_cast<unsigned int>(heap_stats_.cumulative_allocated));
   PW_LOG_INFO("          The cumulative freed heap memory is %u bytes.",
@@ -189,6 +210,8 @@ void FreeListHeap::LogHeapStats() {
   PW_LOG_INFO(
       "          free() is called %u times. (realloc() counted as one time)",
       static_cast<unsigned int>(heap_stats_.total_free_calls));
+  PW_LOG_INFO("          %u allocations failed.",
+              static_cast<unsigned int>(heap_stats_.failed_allocate_calls));
   PW_LOG_INFO(" ");
 }
 
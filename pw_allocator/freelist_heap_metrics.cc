@@ -0,0 +1,101 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/freelist_heap_metrics.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace pw::allocator {
+namespace {
+
+constexpr uint32_t kGroupName = PW_TOKENIZE_STRING_DOMAIN("metrics", "heap");
+constexpr uint32_t kHistogramName = PW_TOKENIZE_STRING_MASK(
+    "metrics", _PW_METRIC_TOKEN_MASK, "free_block_sizes");
+
+uint32_t Saturate(size_t value) {
+  return static_cast<uint32_t>(
+      std::min<size_t>(value, std::numeric_limits<uint32_t>::max()));
+}
+
+}  // namespace
+
+FreeListHeapMetrics::FreeListHeapMetrics(FreeListHeap& heap)
+    : heap_(heap),
+      group_(kGroupName),
+      free_block_sizes_(kHistogramName, group_) {}
+
+FreeListHeapMetrics::FreeListHeapMetrics(FreeListHeap& heap,
+                                         IntrusiveList<metric::Group>& groups)
+    : heap_(heap),
+      group_(kGroupName, groups),
+      free_block_sizes_(kHistogramName, group_) {}
+
+void* FreeListHeapMetrics::Allocate(size_t size, uint32_t tag) {
+  void* ptr = heap_.Allocate(size);
+  if (ptr != nullptr) {
+    FindOrAddTag(tag)->Increment(Saturate(size));
+  }
+  return ptr;
+}
+
+void FreeListHeapMetrics::Update() {
+  const FreeListHeap::HeapStats& stats = heap_.heap_stats();
+  bytes_allocated_.Set(Saturate(stats.bytes_allocated));
+  peak_bytes_allocated_.Set(Saturate(stats.peak_bytes_allocated));
+  allocations_.Set(Saturate(stats.total_allocate_calls));
+  frees_.Set(Saturate(stats.total_free_calls));
+  failed_allocations_.Set(Saturate(stats.failed_allocate_calls));
+
+  // Walk the heap once for both the totals and the histogram.
+  size_t free_bytes = 0;
+  size_t free_blocks = 0;
+  size_t largest_free_block = 0;
+  free_block_sizes_.Reset();
+  heap_.ForEachFreeBlock([&](size_t size) {
+    free_bytes += size;
+    free_blocks += 1;
+    largest_free_block = std::max(largest_free_block, size);
+    free_block_sizes_.Record(Saturate(size));
+  });
+  free_bytes_.Set(Saturate(free_bytes));
+  free_blocks_.Set(Saturate(free_blocks));
+  largest_free_block_.Set(Saturate(largest_free_block));
+}
+
+uint32_t FreeListHeapMetrics::tag_bytes(uint32_t tag) const {
+  for (const metric::TypedMetric<uint32_t>& metric : tag_bytes_) {
+    if (metric.name() == (tag & _PW_METRIC_TOKEN_MASK)) {
+      return metric.value();
+    }
+  }
+  return 0;
+}
+
+metric::TypedMetric<uint32_t>* FreeListHeapMetrics::FindOrAddTag(
+    uint32_t tag) {
+  tag &= _PW_METRIC_TOKEN_MASK;
+  for (metric::TypedMetric<uint32_t>& metric : tag_bytes_) {
+    if (metric.name() == tag) {
+      return &metric;
+    }
+  }
+  if (tag_bytes_.full()) {
+    return &other_tag_;
+  }
+  tag_bytes_.emplace_back(tag, 0u, tags_.metrics());
+  return &tag_bytes_.back();
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,143 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/freelist_heap_metrics.h"
+
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "pw_tokenizer/hash.h"
+
+namespace pw::allocator {
+namespace {
+
+// Returns the value of the metric in the group with the given name.
+uint32_t Get(metric::Group& group, const char* name) {
+  const metric::Token token = tokenizer::Hash(name) & _PW_METRIC_TOKEN_MASK;
+  for (const metric::Metric& metric : group.metrics()) {
+    if (metric.name() == token) {
+      return metric.as_int();
+    }
+  }
+  ADD_FAILURE();
+  return 0;
+}
+
+metric::Group& Child(metric::Group& group, const char* name) {
+  const metric::Token token = tokenizer::Hash(name) & _PW_METRIC_TOKEN_MASK;
+  for (metric::Group& child : group.children()) {
+    if (child.name() == token) {
+      return child;
+    }
+  }
+  ADD_FAILURE();
+  return group;
+}
+
+class FreeListHeapMetricsTest : public ::testing::Test {
+ protected:
+  FreeListHeapMetricsTest() : heap_(buffer_), metrics_(heap_.heap()) {}
+
+  alignas(Block) std::byte buffer_[2048] = {};
+  FreeListHeapBuffer<> heap_;
+  FreeListHeapMetrics metrics_;
+};
+
+TEST_F(FreeListHeapMetricsTest, Update_CopiesHeapStats) {
+  void* ptr1 = heap_.Allocate(100);
+  void* ptr2 = heap_.Allocate(300);
+  ASSERT_NE(ptr2, nullptr);
+  heap_.Free(ptr1);
+  EXPECT_EQ(heap_.Allocate(4096), nullptr);
+
+  metrics_.Update();
+  metric::Group& group = metrics_.group();
+  EXPECT_EQ(Get(group, "bytes_allocated"),
+            heap_.heap_stats().bytes_allocated);
+  EXPECT_GE(Get(group, "peak_bytes_allocated"), 400u);
+  EXPECT_EQ(Get(group, "allocations"), 2u);
+  EXPECT_EQ(Get(group, "frees"), 1u);
+  EXPECT_EQ(Get(group, "failed_allocations"), 1u);
+  heap_.Free(ptr2);
+}
+
+TEST_F(FreeListHeapMetricsTest, Update_WalksFreeBlocks) {
+  void* ptr1 = heap_.Allocate(64);
+  void* ptr2 = heap_.Allocate(64);
+  ASSERT_NE(ptr2, nullptr);
+  heap_.Free(ptr1);
+
+  metrics_.Update();
+  const FreeListHeap::FragmentationStats stats =
+      heap_.heap().GetFragmentationStats();
+  metric::Group& group = metrics_.group();
+  EXPECT_EQ(Get(group, "free_blocks"), 2u);
+  EXPECT_EQ(Get(group, "free_bytes"), stats.free_bytes);
+  EXPECT_EQ(Get(group, "largest_free_block"), stats.largest_free_block);
+
+  // A 64-byte block and one large block.
+  metric::Group& histogram = Child(group, "free_block_sizes");
+  EXPECT_EQ(Get(histogram, "bucket_7"), 1u);  // [64, 128)
+  EXPECT_EQ(Get(histogram, "bucket_11"), 1u);  // [1024, 2048)
+
+  // The histogram is a snapshot, not a running count.
+  metrics_.Update();
+  EXPECT_EQ(Get(histogram, "bucket_7"), 1u);
+  heap_.Free(ptr2);
+}
+
+TEST_F(FreeListHeapMetricsTest, Construct_AddsGroupToList) {
+  IntrusiveList<metric::Group> groups;
+  FreeListHeapMetrics metrics(heap_.heap(), groups);
+  ASSERT_EQ(groups.size(), 1u);
+  EXPECT_EQ(&groups.front(), &metrics.group());
+  groups.clear();
+}
+
+TEST_F(FreeListHeapMetricsTest, Allocate_CountsBytesPerTag) {
+  constexpr uint32_t kRpcTag = PW_ALLOCATOR_TAG("rpc");
+  constexpr uint32_t kLogTag = PW_ALLOCATOR_TAG("log");
+
+  void* ptr1 = metrics_.Allocate(40, kRpcTag);
+  void* ptr2 = metrics_.Allocate(24, kRpcTag);
+  void* ptr3 = metrics_.Allocate(8, kLogTag);
+  ASSERT_NE(ptr3, nullptr);
+
+  EXPECT_EQ(metrics_.tag_bytes(kRpcTag), 64u);
+  EXPECT_EQ(metrics_.tag_bytes(kLogTag), 8u);
+  constexpr uint32_t kUnusedTag = PW_ALLOCATOR_TAG("unused");
+  EXPECT_EQ(metrics_.tag_bytes(kUnusedTag), 0u);
+
+  metric::Group& tags = Child(metrics_.group(), "tags");
+  EXPECT_EQ(Get(tags, "rpc"), 64u);
+  EXPECT_EQ(Get(tags, "log"), 8u);
+
+  heap_.Free(ptr1);
+  heap_.Free(ptr2);
+  heap_.Free(ptr3);
+}
+
+TEST_F(FreeListHeapMetricsTest, Allocate_TooManyTags_CountedAsOther) {
+  // Any token may be used as a tag.
+  constexpr uint32_t kTags = FreeListHeapMetrics::kMaxTags + 1;
+  for (uint32_t tag = 1; tag <= kTags; ++tag) {
+    heap_.Free(metrics_.Allocate(16, tag));
+  }
+  EXPECT_EQ(metrics_.tag_bytes(kTags - 1), 16u);
+  EXPECT_EQ(metrics_.tag_bytes(kTags), 0u);
+  EXPECT_EQ(Get(Child(metrics_.group(), "tags"), "other"), 16u);
+}
+
+}  // namespace
+}  // namespace pw::allocator
@@ -274,4 +274,53 @@ TEST(FreeListHeap, CallocTooLarge) {
 
   EXPECT_EQ(allocator.Calloc(1, kAllocSize), nullptr);
 }
+
+TEST(FreeListHeap, HeapStats_TrackPeakAndFailures) {
+  constexpr size_t N = 2048;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  FreeListHeapBuffer allocator(buf);
+
+  void* ptr1 = allocator.Allocate(512);
+  void* ptr2 = allocator.Allocate(256);
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  const size_t peak = allocator.heap_stats().bytes_allocated;
+  EXPECT_GE(peak, 768u);
+
+  allocator.Free(ptr1);
+  allocator.Free(ptr2);
+  EXPECT_EQ(allocator.heap_stats().bytes_allocated, 0u);
+  EXPECT_EQ(allocator.heap_stats().peak_bytes_allocated, peak);
+
+  EXPECT_EQ(allocator.Allocate(N), nullptr);
+  EXPECT_EQ(allocator.heap_stats().failed_allocate_calls, 1u);
+}
+
+TEST(FreeListHeap, GetFragmentationStats) {
+  constexpr size_t N = 2048;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  FreeListHeapBuffer allocator(buf);
+  FreeListHeap& heap = allocator.heap();
+
+  void* ptr1 = heap.Allocate(128);
+  void* ptr2 = heap.Allocate(128);
+  void* ptr3 = heap.Allocate(128);
+  ASSERT_NE(ptr3, nullptr);
+  heap.Free(ptr2);
+
+  // The freed block and the rest of the heap are separated by ptr3. Every
+  // byte is either allocated, free, or part of one of the four blocks' headers.
+  const FreeListHeap::FragmentationStats stats = heap.GetFragmentationStats();
+  EXPECT_EQ(stats.free_blocks, 2u);
+  EXPECT_GT(stats.largest_free_block, 128u);
+  EXPECT_EQ(stats.free_bytes,
+            N - allocator.heap_stats().bytes_allocated -
+                4 * (sizeof(Block) + 2 * PW_ALLOCATOR_POISON_OFFSET));
+
+  heap.Free(ptr1);
+  heap.Free(ptr3);
+  EXPECT_EQ(heap.GetFragmentationStats().free_blocks, 1u);
+}
 }  // namespace pw::allocator
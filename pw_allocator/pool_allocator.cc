@@ -0,0 +1,77 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/pool_allocator.h"
+
+#include <cstdint>
+
+#include "pw_assert/check.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t AlignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+PoolAllocator::PoolAllocator(std::span<std::byte> region, size_t block_size)
+    : block_size_(AlignUp(block_size == 0 ? 1 : block_size, alignof(void*))),
+      free_blocks_(0),
+      free_list_(nullptr) {
+  // The lowest set bit of the block size is the alignment every block shares
+  // with the first one.
+  block_alignment_ = block_size_ & (~block_size_ + 1);
+  if (block_alignment_ > alignof(std::max_align_t)) {
+    block_alignment_ = alignof(std::max_align_t);
+  }
+
+  const uintptr_t start = reinterpret_cast<uintptr_t>(region.data());
+  const size_t padding = AlignUp(start, block_alignment_) - start;
+  PW_CHECK_UINT_LE(padding, region.size());
+  begin_ = region.data() + padding;
+  total_blocks_ = (region.size() - padding) / block_size_;
+  PW_CHECK_UINT_GT(total_blocks_, 0, "PoolAllocator region is too small");
+
+  // Push the blocks in reverse so they are handed out in address order.
+  for (size_t i = total_blocks_; i > 0; --i) {
+    DoFree(begin_ + (i - 1) * block_size_);
+  }
+}
+
+void* PoolAllocator::DoAllocate(size_t size, size_t alignment) {
+  if (size > block_size_ || alignment > block_alignment_ ||
+      free_list_ == nullptr) {
+    return nullptr;
+  }
+  FreeBlock* const block = free_list_;
+  free_list_ = block->next;
+  free_blocks_ -= 1;
+  return block;
+}
+
+void PoolAllocator::DoFree(void* ptr) {
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(begin_);
+  const uintptr_t block = reinterpret_cast<uintptr_t>(ptr);
+  const bool in_pool =
+      block >= begin && block - begin < total_blocks_ * block_size_ &&
+      (block - begin) % block_size_ == 0;
+  PW_CHECK(in_pool, "Freed a pointer that is not from this PoolAllocator");
+
+  free_list_ = new (ptr) FreeBlock{free_list_};
+  free_blocks_ += 1;
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,82 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/pool_allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::allocator {
+namespace {
+
+alignas(std::max_align_t) std::array<std::byte, 256> buffer;
+
+TEST(PoolAllocator, Construct_RoundsBlockSize) {
+  PoolAllocator pool(buffer, 13);
+  EXPECT_EQ(16u, pool.block_size());
+  EXPECT_EQ(16u, pool.total_blocks());
+  EXPECT_EQ(16u, pool.free_blocks());
+}
+
+TEST(PoolAllocator, Allocate_AllBlocksThenFails) {
+  PoolAllocator pool(buffer, 64);
+  ASSERT_EQ(4u, pool.total_blocks());
+
+  std::array<void*, 4> blocks;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    blocks[i] = pool.Allocate(64);
+    EXPECT_EQ(buffer.data() + i * 64, blocks[i]);
+  }
+  EXPECT_EQ(0u, pool.free_blocks());
+  EXPECT_EQ(nullptr, pool.Allocate(1));
+
+  pool.Free(blocks[2]);
+  EXPECT_EQ(1u, pool.free_blocks());
+  EXPECT_EQ(blocks[2], pool.Allocate(10));
+}
+
+TEST(PoolAllocator, Allocate_TooLargeOrOverAligned) {
+  PoolAllocator pool(buffer, 24);
+  EXPECT_EQ(8u, pool.block_alignment());
+  EXPECT_EQ(nullptr, pool.Allocate(25, 8));
+  EXPECT_EQ(nullptr, pool.Allocate(8, 16));
+  EXPECT_NE(nullptr, pool.Allocate(24, 8));
+}
+
+TEST(PoolAllocator, UnalignedRegion_BlocksAreAligned) {
+  PoolAllocator pool(std::span<std::byte>(buffer).subspan(1), 32);
+  EXPECT_EQ(7u, pool.total_blocks());
+  void* block = pool.Allocate(32, 16);
+  ASSERT_NE(nullptr, block);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % 16);
+}
+
+TEST(PoolAllocator, NewDelete_ThroughInterface) {
+  PoolAllocator pool(buffer, 32);
+  Allocator& allocator = pool;
+
+  uint64_t* value = allocator.New<uint64_t>(uint64_t{42});
+  ASSERT_NE(nullptr, value);
+  EXPECT_EQ(42u, *value);
+  EXPECT_EQ(7u, pool.free_blocks());
+
+  allocator.Delete(value);
+  EXPECT_EQ(8u, pool.free_blocks());
+}
+
+}  // namespace
+}  // namespace pw::allocator
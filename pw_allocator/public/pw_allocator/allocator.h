@@ -0,0 +1,76 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace pw::allocator {
+
+// Polymorphic memory resource. Code that allocates takes an Allocator& so that
+// callers choose where its memory comes from; for example, a per-request
+// BumpAllocator that is reset when the request completes, or a PoolAllocator
+// of fixed-size blocks.
+//
+// Allocate returns nullptr on failure. Freeing nullptr does nothing.
+// Implementations are not required to be thread safe.
+//
+// Allocator has the same Allocate and Free members as the heaps in this module,
+// so it can be used with containers that are templated on an allocator type,
+// such as pw::InlinedVector<T, kInlineCapacity, pw::allocator::Allocator>.
+class Allocator {
+ public:
+  virtual ~Allocator() = default;
+
+  // Returns size bytes of memory aligned to the given power of two, or nullptr
+  // if the request cannot be satisfied.
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    return DoAllocate(size, alignment);
+  }
+
+  // Releases memory previously returned by Allocate on this allocator.
+  void Free(void* ptr) {
+    if (ptr != nullptr) {
+      DoFree(ptr);
+    }
+  }
+
+  // Allocates and constructs a T. Returns nullptr if allocation fails.
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    void* memory = Allocate(sizeof(T), alignof(T));
+    return memory == nullptr ? nullptr
+                             : new (memory) T(std::forward<Args>(args)...);
+  }
+
+  // Destroys and frees an object created with New.
+  template <typename T>
+  void Delete(T* object) {
+    if (object != nullptr) {
+      object->~T();
+      DoFree(object);
+    }
+  }
+
+ protected:
+  constexpr Allocator() = default;
+
+ private:
+  virtual void* DoAllocate(size_t size, size_t alignment) = 0;
+
+  virtual void DoFree(void* ptr) = 0;
+};
+
+}  // namespace pw::allocator
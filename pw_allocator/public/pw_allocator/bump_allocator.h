@@ -0,0 +1,53 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "pw_allocator/allocator.h"
+
+namespace pw::allocator {
+
+// Arena allocator that hands out consecutive slices of a region. Allocate only
+// aligns and advances a pointer. Free does nothing; all memory is reclaimed at
+// once by Reset. This suits work with a clear end, such as handling one RPC
+// request, where everything allocated for the request is released together.
+//
+// Objects allocated from the arena are not destroyed by Reset. Only trivially
+// destructible objects, or objects that are destroyed before the Reset, may be
+// allocated from it.
+class BumpAllocator final : public Allocator {
+ public:
+  explicit constexpr BumpAllocator(std::span<std::byte> region)
+      : region_(region), used_(0) {}
+
+  // Releases all allocations.
+  void Reset() { used_ = 0; }
+
+  // Bytes consumed by allocations since the last Reset, including padding.
+  size_t used() const { return used_; }
+
+  size_t remaining() const { return region_.size() - used_; }
+
+ private:
+  void* DoAllocate(size_t size, size_t alignment) override;
+
+  void DoFree(void*) override {}
+
+  std::span<std::byte> region_;
+  size_t used_;
+};
+
+}  // namespace pw::allocator
@@ -26,14 +26,26 @@ class FreeListHeap {
  public:
   template <size_t kNumBuckets>
   friend class FreeListHeapBuffer;
+  // Byte counts include the rounding of each allocation to its block size.
   struct HeapStats {
     size_t total_bytes;
     size_t bytes_allocated;
+    size_t peak_bytes_allocated;
     size_t cumulative_allocated;
     size_t cumulative_freed;
     size_t total_allocate_calls;
     size_t total_free_calls;
+    size_t failed_allocate_calls;
   };
+
+  // Snapshot of how free memory is distributed. Computing it walks every block
+  // in the heap, so it is intended for diagnostics rather than hot paths.
+  struct FragmentationStats {
+    size_t free_bytes;
+    size_t free_blocks;
+    size_t largest_free_block;
+  };
+
   FreeListHeap(std::span<std::byte> region, FreeList& freelist);
 
   void* Allocate(size_t size);
@@ -41,6 +53,21 @@ class FreeListHeap {
   void* Realloc(void* ptr, size_t size);
   void* Calloc(size_t num, size_t size);
 
+  const HeapStats& heap_stats() const { return heap_stats_; }
+
+  FragmentationStats GetFragmentationStats() const;
+
+  // Calls function(size_t inner_size) for each free block, in address order.
+  template <typename Function>
+  void ForEachFreeBlock(Function&& function) const {
+    for (const Block* block = first_block_; block != nullptr;
+         block = block->Last() ? nullptr : block->Next()) {
+      if (!block->Used()) {
+        function(block->InnerSize());
+      }
+    }
+  }
+
   void LogHeapStats();
 
  private:
@@ -51,6 +78,7 @@ class FreeListHeap {
   void InvalidFreeCrash();
 
   std::span<std::byte> region_;
+  Block* first_block_;
   FreeList& freelist_;
   HeapStats heap_stats_;
 };
@@ -73,6 +101,8 @@ class FreeListHeapBuffer {
     return heap_.heap_stats_;
   };
 
+  FreeListHeap& heap() { return heap_; }
+
   void LogHeapStats() { heap_.LogHeapStats(); }
 
  private:
@@ -0,0 +1,104 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/freelist_heap.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_containers/vector.h"
+#include "pw_metric/compound_metrics.h"
+#include "pw_metric/metric.h"
+#include "pw_tokenizer/tokenize.h"
+
+// Tags an allocation site for FreeListHeapMetrics::Allocate. The tag is a
+// metric name token, so it is detokenized like any other metric name. Like
+// PW_TOKENIZE_STRING, this can only be assigned to a variable:
+//
+//   constexpr uint32_t kTag = PW_ALLOCATOR_TAG("rpc_request");
+//   void* buffer = heap_metrics.Allocate(size, kTag);
+#define PW_ALLOCATOR_TAG(name) \
+  PW_TOKENIZE_STRING_MASK("metrics", _PW_METRIC_TOKEN_MASK, name)
+
+namespace pw::allocator {
+
+// Exposes a FreeListHeap's usage and fragmentation as pw_metric values, so
+// they can be dumped to logs or served by MetricService along with any other
+// metrics. The group contains:
+//
+//   bytes_allocated, peak_bytes_allocated, allocations, frees,
+//   failed_allocations: copied from the heap's HeapStats.
+//   free_bytes, free_blocks, largest_free_block: from a walk of the heap.
+//   free_block_sizes: Log2Histogram of the free block sizes.
+//   tags: bytes allocated through Allocate(size, tag), per tag.
+//
+// The heap maintains its counters itself at the cost of a few additions per
+// call. The metrics are only copied and the heap only walked in Update(), so
+// call it before dumping or serving the metrics, e.g. from a periodic task.
+//
+// Like FreeListHeap, this class is not thread safe.
+class FreeListHeapMetrics {
+ public:
+  // Number of distinct tags tracked. Allocations with further tags are counted
+  // in the "other" tag.
+  static constexpr size_t kMaxTags = 8;
+
+  // Free blocks of 2^(kHistogramBuckets - 2) bytes or more share the last
+  // bucket.
+  static constexpr size_t kHistogramBuckets = 16;
+
+  explicit FreeListHeapMetrics(FreeListHeap& heap);
+
+  // Adds the group to a list, such as a parent's children() or
+  // pw::metric::global_groups.
+  FreeListHeapMetrics(FreeListHeap& heap, IntrusiveList<metric::Group>& groups);
+
+  FreeListHeapMetrics(const FreeListHeapMetrics&) = delete;
+  FreeListHeapMetrics& operator=(const FreeListHeapMetrics&) = delete;
+
+  metric::Group& group() { return group_; }
+
+  // Allocates from the heap and adds the size to the tag's byte count. The tag
+  // is usually PW_ALLOCATOR_TAG("site name").
+  void* Allocate(size_t size, uint32_t tag);
+
+  // Refreshes the metrics from the heap. Walks every block, O(blocks).
+  void Update();
+
+  // The tag's byte count, or 0 if the tag has not been used.
+  uint32_t tag_bytes(uint32_t tag) const;
+
+ private:
+  metric::TypedMetric<uint32_t>* FindOrAddTag(uint32_t tag);
+
+  FreeListHeap& heap_;
+
+  metric::Group group_;
+  PW_METRIC(group_, bytes_allocated_, "bytes_allocated", 0u);
+  PW_METRIC(group_, peak_bytes_allocated_, "peak_bytes_allocated", 0u);
+  PW_METRIC(group_, allocations_, "allocations", 0u);
+  PW_METRIC(group_, frees_, "frees", 0u);
+  PW_METRIC(group_, failed_allocations_, "failed_allocations", 0u);
+  PW_METRIC(group_, free_bytes_, "free_bytes", 0u);
+  PW_METRIC(group_, free_blocks_, "free_blocks", 0u);
+  PW_METRIC(group_, largest_free_block_, "largest_free_block", 0u);
+  metric::Log2Histogram<kHistogramBuckets> free_block_sizes_;
+
+  PW_METRIC_GROUP(group_, tags_, "tags");
+  PW_METRIC(tags_, other_tag_, "other", 0u);
+  Vector<metric::TypedMetric<uint32_t>, kMaxTags> tag_bytes_;
+};
+
+}  // namespace pw::allocator
@@ -0,0 +1,62 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "pw_allocator/allocator.h"
+
+namespace pw::allocator {
+
+// Allocator of equally sized blocks carved from a region. Free blocks are kept
+// in a singly linked list threaded through the blocks themselves, so Allocate
+// and Free are O(1) and the pool never fragments.
+//
+// Requests larger than the block size, or with a stricter alignment than the
+// blocks have, fail. Blocks are aligned to the largest power of two that
+// divides the block size, up to alignof(std::max_align_t).
+class PoolAllocator final : public Allocator {
+ public:
+  // The block size is rounded up to a multiple of alignof(void*). Crashes if
+  // the region cannot hold any blocks.
+  PoolAllocator(std::span<std::byte> region, size_t block_size);
+
+  size_t block_size() const { return block_size_; }
+
+  size_t block_alignment() const { return block_alignment_; }
+
+  size_t total_blocks() const { return total_blocks_; }
+
+  size_t free_blocks() const { return free_blocks_; }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  void* DoAllocate(size_t size, size_t alignment) override;
+
+  // Crashes if ptr is not a block from this pool.
+  void DoFree(void* ptr) override;
+
+  std::byte* begin_;
+  size_t block_size_;
+  size_t block_alignment_;
+  size_t total_blocks_;
+  size_t free_blocks_;
+  FreeBlock* free_list_;
+};
+
+}  // namespace pw::allocator
@@ -0,0 +1,153 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_allocator/block.h"
+
+namespace pw::allocator {
+
+// Two-level segregated fit (TLSF) heap built on Block.
+//
+// Free blocks are kept in an array of doubly linked lists indexed by size
+// class. The first level splits sizes by powers of two; the second level
+// splits each power of two into kSecondLevelCount equally sized ranges. A
+// bitmap per level records which lists are non-empty, so finding a large
+// enough free block takes a constant number of bit scans regardless of how
+// fragmented the heap is. Allocate and Free are both O(1).
+//
+// Allocate requests are rounded up to the next size class before searching,
+// so any block in the selected list satisfies the request without walking the
+// list. This trades up to 1/kSecondLevelCount of internal fragmentation for
+// bounded latency. When no larger class has a free block, the head of the
+// request's own list is used if it happens to be large enough.
+//
+// The list links are stored in the usable space of free blocks, so every block
+// has an inner size of at least kMinInnerSize bytes.
+//
+//   first level  (fl_bitmap_)   0 1 1 0 ...
+//                                 | |
+//   second level (sl_bitmap_)     | '--> 0 0 1 0 0 0 0 1
+//                                 '----> 1 0 0 0 0 0 0 0
+//                                        |
+//   free_lists_[1][0] ------------------>  block --> block --> nullptr
+//
+// This class is not thread safe.
+class TlsfHeap {
+ public:
+  struct HeapStats {
+    size_t total_bytes;
+    size_t bytes_allocated;
+    size_t cumulative_allocated;
+    size_t cumulative_freed;
+    size_t total_allocate_calls;
+    size_t total_free_calls;
+  };
+
+  // Snapshot of how free memory is distributed. Computing it walks every block
+  // in the heap, so it is intended for diagnostics rather than hot paths.
+  struct FragmentationStats {
+    size_t free_bytes;
+    size_t free_blocks;
+    size_t largest_free_block;
+  };
+
+  // log2 of the number of second level lists per first level class.
+  static constexpr size_t kSecondLevelLog2 = 3;
+  static constexpr size_t kSecondLevelCount = size_t(1) << kSecondLevelLog2;
+  static constexpr size_t kFirstLevelCount = 24;
+
+  // Smallest inner size of any block; free blocks store their list links here.
+  static constexpr size_t kMinInnerSize = 2 * sizeof(Block*);
+
+  // The region must be aligned to alignof(Block) and smaller than
+  // MaxRegionSize().
+  explicit TlsfHeap(std::span<std::byte> region);
+
+  TlsfHeap(const TlsfHeap&) = delete;
+  TlsfHeap& operator=(const TlsfHeap&) = delete;
+
+  void* Allocate(size_t size);
+  void Free(void* ptr);
+  void* Realloc(void* ptr, size_t size);
+  void* Calloc(size_t num, size_t size);
+
+  const HeapStats& heap_stats() const { return heap_stats_; }
+
+  FragmentationStats GetFragmentationStats() const;
+
+  void LogHeapStats() const;
+
+  // Largest region whose blocks can all be indexed by the size classes.
+  static constexpr size_t MaxRegionSize() {
+    return size_t(1) << (kFirstLevelCount - 1 + kFirstLevelShift);
+  }
+
+ private:
+  // Links stored in the usable space of a free block.
+  struct FreeNode {
+    Block* prev;
+    Block* next;
+  };
+
+  static constexpr size_t kAlignLog2 = alignof(Block) == 8   ? 3
+                                       : alignof(Block) == 4 ? 2
+                                       : alignof(Block) == 2 ? 1
+                                                             : 0;
+
+  // Sizes below kSmallBlockSize all map to first level 0, where the second
+  // level lists are alignof(Block) bytes apart.
+  static constexpr size_t kFirstLevelShift = kSecondLevelLog2 + kAlignLog2;
+  static constexpr size_t kSmallBlockSize = size_t(1) << kFirstLevelShift;
+
+  static_assert(alignof(Block) == (size_t(1) << kAlignLog2),
+                "Block alignment must be a power of two up to 8");
+  static_assert(kFirstLevelCount <= 32, "fl_bitmap_ holds 32 classes");
+  static_assert(kSecondLevelCount <= 32, "sl_bitmap_ holds 32 lists");
+  static_assert(kMinInnerSize >= sizeof(FreeNode));
+
+  static FreeNode& Node(Block* block) {
+    return *reinterpret_cast<FreeNode*>(block->UsableSpace());
+  }
+
+  // Maps a block size to the list that holds blocks of that size.
+  static void MappingInsert(size_t size, size_t* fl, size_t* sl);
+
+  // Maps a request size to the first list whose blocks are all large enough.
+  // Returns false if no list can satisfy the request.
+  static bool MappingSearch(size_t size, size_t* fl, size_t* sl);
+
+  // Returns a free block from the smallest non-empty list at or above
+  // (fl, sl), updating fl and sl to that list, or nullptr if there is none.
+  Block* FindSuitableBlock(size_t* fl, size_t* sl) const;
+
+  void InsertFreeBlock(Block* block);
+  void RemoveFreeBlock(Block* block);
+
+  void InvalidFreeCrash();
+
+  std::span<std::byte> region_;
+  Block* first_block_;
+  uint32_t fl_bitmap_;
+  std::array<uint32_t, kFirstLevelCount> sl_bitmap_;
+  std::array<std::array<Block*, kSecondLevelCount>, kFirstLevelCount>
+      free_lists_;
+  HeapStats heap_stats_;
+};
+
+}  // namespace pw::allocator
@@ -0,0 +1,315 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/tlsf_heap.h"
+
+#include <cstring>
+
+#include "pw_assert/check.h"
+#include "pw_log/log.h"
+
+namespace pw::allocator {
+namespace {
+
+// Index of the most significant set bit. value must be non-zero.
+size_t MostSignificantBit(size_t value) {
+  return 63 - __builtin_clzll(static_cast<unsigned long long>(value));
+}
+
+// Index of the least significant set bit. value must be non-zero.
+size_t LeastSignificantBit(uint32_t value) { return __builtin_ctz(value); }
+
+size_t AlignUp(size_t size) {
+  return (size + alignof(Block) - 1) & ~(alignof(Block) - 1);
+}
+
+}  // namespace
+
+TlsfHeap::TlsfHeap(std::span<std::byte> region)
+    : region_(region),
+      first_block_(nullptr),
+      fl_bitmap_(0),
+      sl_bitmap_{},
+      free_lists_{},
+      heap_stats_() {
+  PW_CHECK_INT_LT(region.size(),
+                  MaxRegionSize(),
+                  "TlsfHeap region is too large for its size classes");
+  PW_CHECK_OK(Block::Init(region, &first_block_),
+              "Failed to initialize TlsfHeap region; misaligned or too small");
+  PW_CHECK_INT_GE(first_block_->InnerSize(),
+                  kMinInnerSize,
+                  "TlsfHeap region is too small");
+
+  InsertFreeBlock(first_block_);
+  heap_stats_.total_bytes = region.size();
+}
+
+void TlsfHeap::MappingInsert(size_t size, size_t* fl, size_t* sl) {
+  if (size < kSmallBlockSize) {
+    *fl = 0;
+    *sl = size >> kAlignLog2;
+    return;
+  }
+  const size_t msb = MostSignificantBit(size);
+  *fl = msb - kFirstLevelShift + 1;
+  *sl = (size >> (msb - kSecondLevelLog2)) - kSecondLevelCount;
+}
+
+bool TlsfHeap::MappingSearch(size_t size, size_t* fl, size_t* sl) {
+  if (size >= kSmallBlockSize) {
+    // Round up to the next list boundary so every block in the list fits.
+    size += (size_t(1) << (MostSignificantBit(size) - kSecondLevelLog2)) - 1;
+  }
+  MappingInsert(size, fl, sl);
+  return *fl < kFirstLevelCount;
+}
+
+Block* TlsfHeap::FindSuitableBlock(size_t* fl, size_t* sl) const {
+  // Look for a non-empty list in the same first level class first.
+  uint32_t sl_map = sl_bitmap_[*fl] & (~uint32_t(0) << *sl);
+  if (sl_map == 0) {
+    // Otherwise take the smallest list of the next non-empty class.
+    const uint32_t fl_map =
+        *fl + 1 < 32 ? fl_bitmap_ & (~uint32_t(0) << (*fl + 1)) : 0;
+    if (fl_map == 0) {
+      return nullptr;
+    }
+    *fl = LeastSignificantBit(fl_map);
+    sl_map = sl_bitmap_[*fl];
+  }
+  *sl = LeastSignificantBit(sl_map);
+  return free_lists_[*fl][*sl];
+}
+
+void TlsfHeap::InsertFreeBlock(Block* block) {
+  size_t fl;
+  size_t sl;
+  MappingInsert(block->InnerSize(), &fl, &sl);
+
+  Block*& head = free_lists_[fl][sl];
+  Node(block) = {.prev = nullptr, .next = head};
+  if (head != nullptr) {
+    Node(head).prev = block;
+  }
+  head = block;
+
+  fl_bitmap_ |= uint32_t(1) << fl;
+  sl_bitmap_[fl] |= uint32_t(1) << sl;
+}
+
+void TlsfHeap::RemoveFreeBlock(Block* block) {
+  size_t fl;
+  size_t sl;
+  MappingInsert(block->InnerSize(), &fl, &sl);
+
+  const FreeNode node = Node(block);
+  if (node.next != nullptr) {
+    Node(node.next).prev = node.prev;
+  }
+  if (node.prev != nullptr) {
+    Node(node.prev).next = node.next;
+    return;
+  }
+
+  // The block was the head of its list.
+  free_lists_[fl][sl] = node.next;
+  if (node.next == nullptr) {
+    sl_bitmap_[fl] &= ~(uint32_t(1) << sl);
+    if (sl_bitmap_[fl] == 0) {
+      fl_bitmap_ &= ~(uint32_t(1) << fl);
+    }
+  }
+}
+
+void* TlsfHeap::Allocate(size_t size) {
+  if (size > region_.size()) {
+    return nullptr;
+  }
+  size = size < kMinInnerSize ? kMinInnerSize : AlignUp(size);
+
+  size_t fl;
+  size_t sl;
+  Block* block = nullptr;
+  if (MappingSearch(size, &fl, &sl)) {
+    block = FindSuitableBlock(&fl, &sl);
+  }
+  if (block == nullptr) {
+    // No list is guaranteed to fit, but the head of the request's own list
+    // might. Checking only the head keeps this O(1).
+    MappingInsert(size, &fl, &sl);
+    block = fl < kFirstLevelCount ? free_lists_[fl][sl] : nullptr;
+    if (block == nullptr || block->InnerSize() < size) {
+      return nullptr;
+    }
+  }
+  block->CrashIfInvalid();
+  RemoveFreeBlock(block);
+
+  // Only split if the remainder can hold its free list links.
+  if (block->InnerSize() - size >=
+      sizeof(Block) + 2 * PW_ALLOCATOR_POISON_OFFSET + kMinInnerSize) {
+    Block* remainder;
+    if (block->Split(size, &remainder).ok()) {
+      InsertFreeBlock(remainder);
+    }
+  }
+
+  block->MarkUsed();
+
+  const size_t allocated = block->InnerSize();
+  heap_stats_.bytes_allocated += allocated;
+  heap_stats_.cumulative_allocated += allocated;
+  heap_stats_.total_allocate_calls += 1;
+
+  return block->UsableSpace();
+}
+
+void TlsfHeap::Free(void* ptr) {
+  std::byte* bytes = static_cast<std::byte*>(ptr);
+
+  if (bytes < region_.data() || bytes >= region_.data() + region_.size()) {
+    InvalidFreeCrash();
+    return;
+  }
+
+  Block* block = Block::FromUsableSpace(bytes);
+  block->CrashIfInvalid();
+
+  if (!block->Used()) {
+    InvalidFreeCrash();
+    return;
+  }
+
+  const size_t size_freed = block->InnerSize();
+  block->MarkFree();
+
+  // Coalesce with free neighbours so that free blocks are never adjacent.
+  Block* prev = block->Prev();
+  if (prev != nullptr && !prev->Used()) {
+    RemoveFreeBlock(prev);
+    PW_CHECK_OK(prev->MergeNext());
+    block = prev;
+  }
+
+  if (!block->Last()) {
+    Block* next = block->Next();
+    if (!next->Used()) {
+      RemoveFreeBlock(next);
+      PW_CHECK_OK(block->MergeNext());
+    }
+  }
+
+  InsertFreeBlock(block);
+
+  heap_stats_.bytes_allocated -= size_freed;
+  heap_stats_.cumulative_freed += size_freed;
+  heap_stats_.total_free_calls += 1;
+}
+
+// Follows the contract of the C standard realloc() function.
+void* TlsfHeap::Realloc(void* ptr, size_t size) {
+  if (size == 0) {
+    Free(ptr);
+    return nullptr;
+  }
+
+  if (ptr == nullptr) {
+    return Allocate(size);
+  }
+
+  std::byte* bytes = static_cast<std::byte*>(ptr);
+  if (bytes < region_.data() || bytes >= region_.data() + region_.size()) {
+    return nullptr;
+  }
+
+  Block* block = Block::FromUsableSpace(bytes);
+  if (!block->Used()) {
+    return nullptr;
+  }
+
+  const size_t old_size = block->InnerSize();
+  if (old_size >= size) {
+    return ptr;
+  }
+
+  void* new_ptr = Allocate(size);
+  if (new_ptr == nullptr) {
+    return nullptr;
+  }
+  std::memcpy(new_ptr, ptr, old_size);
+
+  Free(ptr);
+  return new_ptr;
+}
+
+void* TlsfHeap::Calloc(size_t num, size_t size) {
+  if (size != 0 && num > region_.size() / size) {
+    return nullptr;
+  }
+  void* ptr = Allocate(num * size);
+  if (ptr != nullptr) {
+    std::memset(ptr, 0, num * size);
+  }
+  return ptr;
+}
+
+TlsfHeap::FragmentationStats TlsfHeap::GetFragmentationStats() const {
+  FragmentationStats stats = {};
+  for (const Block* block = first_block_; block != nullptr;
+       block = block->Last() ? nullptr : block->Next()) {
+    if (block->Used()) {
+      continue;
+    }
+    const size_t size = block->InnerSize();
+    stats.free_bytes += size;
+    stats.free_blocks += 1;
+    if (size > stats.largest_free_block) {
+      stats.largest_free_block = size;
+    }
+  }
+  return stats;
+}
+
+void TlsfHeap::LogHeapStats() const {
+  const FragmentationStats fragmentation = GetFragmentationStats();
+
+  PW_LOG_INFO(" ");
+  PW_LOG_INFO("    The current heap information: ");
+  PW_LOG_INFO("          The total heap size is %u bytes.",
+              static_cast<unsigned int>(heap_stats_.total_bytes));
+  PW_LOG_INFO("          The current allocated heap memory is %u bytes.",
+              static_cast<unsigned int>(heap_stats_.bytes_allocated));
+  PW_LOG_INFO("          The cumulative allocated heap memory is %u bytes.",
+              static_cast<unsigned int>(heap_stats_.cumulative_allocated));
+  PW_LOG_INFO("          The cumulative freed heap memory is %u bytes.",
+              static_cast<unsigned int>(heap_stats_.cumulative_freed));
+  PW_LOG_INFO("          malloc() is called %u times.",
+              static_cast<unsigned int>(heap_stats_.total_allocate_calls));
+  PW_LOG_INFO("          free() is called %u times.",
+              static_cast<unsigned int>(heap_stats_.total_free_calls));
+  PW_LOG_INFO("          %u bytes are free in %u blocks; the largest is %u.",
+              static_cast<unsigned int>(fragmentation.free_bytes),
+              static_cast<unsigned int>(fragmentation.free_blocks),
+              static_cast<unsigned int>(fragmentation.largest_free_block));
+  PW_LOG_INFO(" ");
+}
+
+// TODO: Add stack tracing to locate which call to the heap operation caused
+// the corruption.
+void TlsfHeap::InvalidFreeCrash() {
+  PW_DCHECK(false, "You tried to free an invalid pointer!");
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,267 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/tlsf_heap.h"
+
+#include <array>
+#include <cstring>
+#include <span>
+
+#include "gtest/gtest.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t N = 2048;
+
+TEST(TlsfHeap, CanAllocate) {
+  constexpr size_t kAllocSize = 512;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap allocator(buf);
+
+  void* ptr = allocator.Allocate(kAllocSize);
+
+  ASSERT_NE(ptr, nullptr);
+  // The first allocation is carved from the start of the region.
+  EXPECT_EQ(ptr, &buf[0] + sizeof(Block) + PW_ALLOCATOR_POISON_OFFSET);
+}
+
+TEST(TlsfHeap, AllocationsDontOverlap) {
+  constexpr size_t kAllocSize = 512;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap allocator(buf);
+
+  void* ptr1 = allocator.Allocate(kAllocSize);
+  void* ptr2 = allocator.Allocate(kAllocSize);
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+
+  uintptr_t ptr1_start = reinterpret_cast<uintptr_t>(ptr1);
+  uintptr_t ptr1_end = ptr1_start + kAllocSize;
+  uintptr_t ptr2_start = reinterpret_cast<uintptr_t>(ptr2);
+
+  EXPECT_GT(ptr2_start, ptr1_end);
+}
+
+TEST(TlsfHeap, CanFreeAndAllocateAgain) {
+  constexpr size_t kAllocSize = 512;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap allocator(buf);
+
+  void* ptr1 = allocator.Allocate(kAllocSize);
+  allocator.Free(ptr1);
+  void* ptr2 = allocator.Allocate(kAllocSize);
+
+  EXPECT_EQ(ptr1, ptr2);
+}
+
+TEST(TlsfHeap, ReturnsNullWhenAllocationTooLarge) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap allocator(buf);
+
+  EXPECT_EQ(allocator.Allocate(N), nullptr);
+  EXPECT_EQ(allocator.Allocate(N - sizeof(Block) + 1), nullptr);
+}
+
+TEST(TlsfHeap, ReturnsNullWhenFull) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap allocator(buf);
+
+  EXPECT_NE(allocator.Allocate(N / 2), nullptr);
+  EXPECT_EQ(allocator.Allocate(N / 2), nullptr);
+}
+
+TEST(TlsfHeap, SmallAllocationsHoldFreeListLinks) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap allocator(buf);
+
+  std::byte* ptr1 = static_cast<std::byte*>(allocator.Allocate(1));
+  std::byte* ptr2 = static_cast<std::byte*>(allocator.Allocate(1));
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_EQ(Block::FromUsableSpace(ptr1)->InnerSize(),
+            TlsfHeap::kMinInnerSize);
+  EXPECT_GE(static_cast<size_t>(ptr2 - ptr1),
+            TlsfHeap::kMinInnerSize + sizeof(Block));
+}
+
+TEST(TlsfHeap, AllocationIsAtLeastRequestedSize) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  for (size_t size = 1; size < 600; size += 7) {
+    TlsfHeap allocator(buf);
+    std::byte* ptr = static_cast<std::byte*>(allocator.Allocate(size));
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_GE(Block::FromUsableSpace(ptr)->InnerSize(), size);
+  }
+}
+
+TEST(TlsfHeap, FreeCoalescesNeighbours) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap allocator(buf);
+  const TlsfHeap::FragmentationStats initial =
+      allocator.GetFragmentationStats();
+  EXPECT_EQ(initial.free_blocks, 1u);
+  EXPECT_EQ(initial.largest_free_block, initial.free_bytes);
+
+  void* ptr1 = allocator.Allocate(100);
+  void* ptr2 = allocator.Allocate(100);
+  void* ptr3 = allocator.Allocate(100);
+  ASSERT_NE(ptr3, nullptr);
+
+  // Freeing the outer allocations leaves two holes plus the tail.
+  allocator.Free(ptr1);
+  allocator.Free(ptr3);
+  TlsfHeap::FragmentationStats stats = allocator.GetFragmentationStats();
+  EXPECT_EQ(stats.free_blocks, 2u);
+  EXPECT_LT(stats.largest_free_block, stats.free_bytes);
+
+  // Freeing the middle one merges everything back into one block.
+  allocator.Free(ptr2);
+  stats = allocator.GetFragmentationStats();
+  EXPECT_EQ(stats.free_blocks, 1u);
+  EXPECT_EQ(stats.free_bytes, initial.free_bytes);
+  EXPECT_EQ(stats.largest_free_block, initial.largest_free_block);
+
+  EXPECT_NE(allocator.Allocate(initial.largest_free_block), nullptr);
+}
+
+TEST(TlsfHeap, ReusesFreedHoleOfMatchingSizeClass) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap allocator(buf);
+
+  void* small = allocator.Allocate(64);
+  void* separator = allocator.Allocate(16);
+  ASSERT_NE(separator, nullptr);
+
+  allocator.Free(small);
+
+  // The hole left by `small` is in the right size class, so it is used instead
+  // of splitting the large tail block.
+  EXPECT_EQ(allocator.Allocate(48), small);
+}
+
+TEST(TlsfHeap, TracksHeapStats) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap allocator(buf);
+  EXPECT_EQ(allocator.heap_stats().total_bytes, N);
+
+  void* ptr1 = allocator.Allocate(64);
+  void* ptr2 = allocator.Allocate(128);
+  EXPECT_EQ(allocator.heap_stats().bytes_allocated, 64u + 128u);
+  EXPECT_EQ(allocator.heap_stats().total_allocate_calls, 2u);
+
+  allocator.Free(ptr1);
+  allocator.Free(ptr2);
+  EXPECT_EQ(allocator.heap_stats().bytes_allocated, 0u);
+  EXPECT_EQ(allocator.heap_stats().cumulative_allocated, 64u + 128u);
+  EXPECT_EQ(allocator.heap_stats().cumulative_freed, 64u + 128u);
+  EXPECT_EQ(allocator.heap_stats().total_free_calls, 2u);
+}
+
+TEST(TlsfHeap, ReallocCopiesContents) {
+  constexpr size_t kAllocSize = 32;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+  constexpr std::byte kData[kAllocSize] = {std::byte(0xab)};
+
+  TlsfHeap allocator(buf);
+
+  void* ptr1 = allocator.Allocate(kAllocSize);
+  ASSERT_NE(ptr1, nullptr);
+  std::memcpy(ptr1, kData, kAllocSize);
+  // Keep the block after ptr1 in use so that Realloc has to move it.
+  ASSERT_NE(allocator.Allocate(kAllocSize), nullptr);
+
+  void* ptr2 = allocator.Realloc(ptr1, kAllocSize * 4);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_NE(ptr1, ptr2);
+  EXPECT_EQ(std::memcmp(ptr2, kData, kAllocSize), 0);
+}
+
+TEST(TlsfHeap, CallocZeroesMemory) {
+  constexpr size_t kNum = 4;
+  constexpr size_t kSize = 16;
+  alignas(Block) std::byte buf[N];
+  std::memset(buf, 0xff, sizeof(buf));
+
+  TlsfHeap allocator(buf);
+
+  std::byte* ptr = static_cast<std::byte*>(allocator.Calloc(kNum, kSize));
+  ASSERT_NE(ptr, nullptr);
+  for (size_t i = 0; i < kNum * kSize; ++i) {
+    EXPECT_EQ(ptr[i], std::byte(0));
+  }
+}
+
+TEST(TlsfHeap, CallocReturnsNullOnOverflow) {
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap allocator(buf);
+
+  EXPECT_EQ(allocator.Calloc(SIZE_MAX / 2, 4), nullptr);
+}
+
+TEST(TlsfHeap, InterleavedAllocationsKeepContents) {
+  constexpr size_t kSlots = 16;
+  alignas(Block) std::byte buf[N * 2] = {std::byte(0)};
+
+  TlsfHeap allocator(buf);
+  std::array<std::byte*, kSlots> ptrs = {};
+  std::array<size_t, kSlots> sizes = {};
+
+  // Allocate and free in a fixed pseudo-random pattern, filling each
+  // allocation with its slot number and checking it before freeing.
+  uint32_t state = 1;
+  for (size_t round = 0; round < 500; ++round) {
+    state = state * 1103515245u + 12345u;
+    const size_t slot = (state >> 16) % kSlots;
+
+    if (ptrs[slot] != nullptr) {
+      for (size_t i = 0; i < sizes[slot]; ++i) {
+        ASSERT_EQ(ptrs[slot][i], std::byte(slot));
+      }
+      allocator.Free(ptrs[slot]);
+      ptrs[slot] = nullptr;
+      continue;
+    }
+
+    sizes[slot] = 1 + (state >> 8) % 200;
+    ptrs[slot] = static_cast<std::byte*>(allocator.Allocate(sizes[slot]));
+    if (ptrs[slot] != nullptr) {
+      std::memset(ptrs[slot], static_cast<int>(slot), sizes[slot]);
+    }
+  }
+
+  for (std::byte* ptr : ptrs) {
+    if (ptr != nullptr) {
+      allocator.Free(ptr);
+    }
+  }
+  EXPECT_EQ(allocator.heap_stats().bytes_allocated, 0u);
+  EXPECT_EQ(allocator.GetFragmentationStats().free_blocks, 1u);
+}
+
+}  // namespace
+}  // namespace pw::allocator
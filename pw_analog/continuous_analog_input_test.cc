@@ -0,0 +1,148 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_analog/continuous_analog_input.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace analog {
+namespace {
+
+// Fake continuous input that fills its buffer when the test completes a half.
+class TestContinuousAnalogInput : public ContinuousAnalogInput {
+ public:
+  // Fills the next half of the buffer with consecutive values and invokes the
+  // callback with it, as a DMA half-complete or complete interrupt would.
+  void CompleteHalf() {
+    const size_t half_size = buffer_.size() / 2;
+    std::span<int32_t> half =
+        buffer_.subspan(next_half_ * half_size, half_size);
+    for (int32_t& sample : half) {
+      sample = next_sample_++;
+    }
+    next_half_ ^= 1;
+    callback_(half);
+  }
+
+  Status Stop() override {
+    if (!running_) {
+      return Status::FailedPrecondition();
+    }
+    running_ = false;
+    return OkStatus();
+  }
+
+  AnalogInput::Limits GetLimits() const override {
+    return {.min = 0, .max = 4096};
+  }
+
+  bool running() const { return running_; }
+
+ private:
+  Status DoStart(const Config&,
+                 std::span<int32_t> buffer,
+                 Callback&& callback) override {
+    if (running_) {
+      return Status::FailedPrecondition();
+    }
+    buffer_ = buffer;
+    callback_ = std::move(callback);
+    next_half_ = 0;
+    running_ = true;
+    return OkStatus();
+  }
+
+  std::span<int32_t> buffer_;
+  Callback callback_;
+  size_t next_half_ = 0;
+  int32_t next_sample_ = 0;
+  bool running_ = false;
+};
+
+constexpr std::array<uint32_t, 2> kChannels = {3, 5};
+constexpr ContinuousAnalogInput::Config kConfig = {.channels = kChannels,
+                                                   .scan_rate_hz = 10000};
+
+TEST(ContinuousAnalogInputTest, Start_InvalidBufferSize) {
+  TestContinuousAnalogInput input;
+  std::array<int32_t, 6> buffer;
+
+  EXPECT_EQ(Status::InvalidArgument(),
+            input.Start(kConfig, std::span(buffer).first(0), [](auto) {}));
+  EXPECT_EQ(Status::InvalidArgument(),
+            input.Start(kConfig, std::span(buffer).first(2), [](auto) {}));
+  EXPECT_EQ(Status::InvalidArgument(),
+            input.Start(kConfig, std::span(buffer).first(6), [](auto) {}));
+  EXPECT_FALSE(input.running());
+}
+
+TEST(ContinuousAnalogInputTest, Start_NoChannels) {
+  TestContinuousAnalogInput input;
+  std::array<int32_t, 4> buffer;
+
+  EXPECT_EQ(Status::InvalidArgument(),
+            input.Start({.channels = {}, .scan_rate_hz = 1}, buffer, [](auto) {
+            }));
+  EXPECT_FALSE(input.running());
+}
+
+TEST(ContinuousAnalogInputTest, Start_AlreadyStarted) {
+  TestContinuousAnalogInput input;
+  std::array<int32_t, 4> buffer;
+
+  EXPECT_EQ(OkStatus(), input.Start(kConfig, buffer, [](auto) {}));
+  EXPECT_EQ(Status::FailedPrecondition(),
+            input.Start(kConfig, buffer, [](auto) {}));
+  EXPECT_EQ(OkStatus(), input.Stop());
+  EXPECT_EQ(Status::FailedPrecondition(), input.Stop());
+}
+
+TEST(ContinuousAnalogInputTest, CallbackAlternatesHalves) {
+  TestContinuousAnalogInput input;
+  std::array<int32_t, 8> buffer;
+  struct {
+    std::span<int32_t> last_half;
+    int32_t sum = 0;
+  } received;
+
+  ASSERT_EQ(OkStatus(),
+            input.Start(kConfig, buffer, [&received](std::span<int32_t> half) {
+              received.last_half = half;
+              for (int32_t sample : half) {
+                received.sum += sample;
+              }
+            }));
+
+  input.CompleteHalf();
+  EXPECT_EQ(buffer.data(), received.last_half.data());
+  EXPECT_EQ(4u, received.last_half.size());
+  EXPECT_EQ(0 + 1 + 2 + 3, received.sum);
+
+  input.CompleteHalf();
+  EXPECT_EQ(buffer.data() + 4, received.last_half.data());
+  EXPECT_EQ(4u, received.last_half.size());
+
+  input.CompleteHalf();
+  EXPECT_EQ(buffer.data(), received.last_half.data());
+  EXPECT_EQ(8, buffer[0]);
+  EXPECT_EQ(OkStatus(), input.Stop());
+}
+
+}  // namespace
+}  // namespace analog
+}  // namespace pw
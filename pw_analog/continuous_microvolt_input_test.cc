@@ -0,0 +1,101 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_analog/continuous_microvolt_input.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace analog {
+namespace {
+
+class TestContinuousMicrovoltInput : public ContinuousMicrovoltInput {
+ public:
+  constexpr TestContinuousMicrovoltInput(AnalogInput::Limits limits,
+                                         MicrovoltInput::References reference)
+      : limits_(limits), reference_(reference) {}
+
+ private:
+  Status DoStart(const Config&, std::span<int32_t>, Callback&&) override {
+    return Status::Unimplemented();
+  }
+  Status Stop() override { return Status::Unimplemented(); }
+
+  AnalogInput::Limits GetLimits() const override { return limits_; }
+  MicrovoltInput::References GetReferences() const override {
+    return reference_;
+  }
+
+  const AnalogInput::Limits limits_;
+  const MicrovoltInput::References reference_;
+};
+
+TEST(ContinuousMicrovoltInputTest, ConvertToMicrovolts) {
+  TestContinuousMicrovoltInput input(
+      {.min = 0, .max = 4096},
+      {.max_voltage_uv = 1800000, .min_voltage_uv = 0});
+  std::array<int32_t, 4> samples = {0, 1024, 2048, 4096};
+
+  input.ConvertToMicrovolts(samples);
+  EXPECT_EQ(0, samples[0]);
+  EXPECT_EQ(450000, samples[1]);
+  EXPECT_EQ(900000, samples[2]);
+  EXPECT_EQ(1800000, samples[3]);
+}
+
+TEST(ContinuousMicrovoltInputTest, ConvertToMicrovolts_Bipolar) {
+  TestContinuousMicrovoltInput input(
+      {.min = -4096, .max = 4096},
+      {.max_voltage_uv = 1800000, .min_voltage_uv = -1800000});
+  std::array<int32_t, 3> samples = {-4096, 0, 4096};
+
+  input.ConvertToMicrovolts(samples);
+  EXPECT_EQ(-1800000, samples[0]);
+  EXPECT_EQ(0, samples[1]);
+  EXPECT_EQ(1800000, samples[2]);
+}
+
+TEST(ContinuousMicrovoltInputTest, ConvertToMicrovolts_MatchesSingleSample) {
+  constexpr AnalogInput::Limits kLimits = {.min = 0, .max = 4095};
+  constexpr MicrovoltInput::References kReference = {
+      .max_voltage_uv = 3300000, .min_voltage_uv = 0};
+  TestContinuousMicrovoltInput input(kLimits, kReference);
+
+  std::array<int32_t, 64> samples;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    samples[i] = static_cast<int32_t>(i * 63);
+  }
+  input.ConvertToMicrovolts(samples);
+
+  for (size_t i = 0; i < samples.size(); ++i) {
+    EXPECT_EQ(MicrovoltInput::ToMicrovolts(
+                  static_cast<int32_t>(i * 63), kLimits, kReference),
+              samples[i]);
+  }
+}
+
+TEST(ContinuousMicrovoltInputTest, ConvertToMicrovolts_Empty) {
+  TestContinuousMicrovoltInput input(
+      {.min = 0, .max = 4096},
+      {.max_voltage_uv = 1800000, .min_voltage_uv = 0});
+  input.ConvertToMicrovolts(std::span<int32_t>());
+}
+
+}  // namespace
+}  // namespace analog
+}  // namespace pw
@@ -0,0 +1,99 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "pw_analog/analog_input.h"
+#include "pw_function/function.h"
+#include "pw_status/status.h"
+
+namespace pw::analog {
+
+// The common interface for sampling ADC channels continuously into a buffer,
+// typically with DMA. Where AnalogInput returns one sample per call, a
+// continuous input delivers blocks of samples taken at a fixed rate by the
+// hardware, so sampling does not depend on when software runs.
+//
+// Sampling is double buffered. The buffer is split into two halves; while the
+// ADC fills one half, the callback is invoked with the other, as with the
+// half-complete and complete interrupts of a circular DMA transfer. The
+// callback must finish with its half before the ADC fills the other half. It
+// is typically invoked from an interrupt.
+//
+// Each scan samples every channel of the scan group once, in order, so the
+// samples in each half are interleaved by channel:
+//
+//   channel 0, channel 1, ..., channel 0, channel 1, ...
+class ContinuousAnalogInput {
+ public:
+  struct Config {
+    // Implementation-defined IDs of the channels to sample in each scan, in
+    // the order they are sampled.
+    std::span<const uint32_t> channels;
+
+    // The number of scans per second.
+    uint32_t scan_rate_hz;
+  };
+
+  // Invoked with each completed half of the buffer. The samples may be
+  // modified in place, e.g. converted to microvolts.
+  using Callback = Function<void(std::span<int32_t> samples)>;
+
+  virtual ~ContinuousAnalogInput() = default;
+
+  // Starts sampling continuously into the buffer until Stop is called. The
+  // buffer must hold a whole number of scans in each half.
+  //
+  // Returns:
+  //   OK: Sampling started.
+  //   InvalidArgument: There are no channels, or the buffer size is not a
+  //       nonzero multiple of twice the number of channels.
+  //   FailedPrecondition: Sampling was already started.
+  //   ResourceExhausted: ADC peripheral in use.
+  //   Other statuses left up to the implementer.
+  Status Start(const Config& config,
+               std::span<int32_t> buffer,
+               Callback&& callback) {
+    const size_t min_buffer_size = 2 * config.channels.size();
+    if (min_buffer_size == 0u || buffer.empty() ||
+        buffer.size() % min_buffer_size != 0u) {
+      return Status::InvalidArgument();
+    }
+    return DoStart(config, buffer, std::move(callback));
+  }
+
+  // Stops sampling. The callback is not invoked after Stop returns.
+  //
+  // Returns:
+  //   OK: Sampling stopped.
+  //   FailedPrecondition: Sampling was not started.
+  //   Other statuses left up to the implementer.
+  virtual Status Stop() = 0;
+
+  // Returns the range of the ADC samples.
+  // These values do not change at run time.
+  virtual AnalogInput::Limits GetLimits() const = 0;
+
+ private:
+  // Starts sampling. The arguments have been validated.
+  virtual Status DoStart(const Config& config,
+                         std::span<int32_t> buffer,
+                         Callback&& callback) = 0;
+};
+
+}  // namespace pw::analog
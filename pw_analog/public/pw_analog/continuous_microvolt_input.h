@@ -0,0 +1,48 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "pw_analog/continuous_analog_input.h"
+#include "pw_analog/microvolt_input.h"
+
+namespace pw::analog {
+
+// A continuous input whose samples can be converted to microvolts, as with
+// MicrovoltInput. Conversion is done on whole blocks of samples, typically in
+// the callback, so the limits and references are read once per block.
+class ContinuousMicrovoltInput : public ContinuousAnalogInput {
+ public:
+  virtual ~ContinuousMicrovoltInput() = default;
+
+  // Converts a block of samples to microvolts (uV) in place. Gives the same
+  // results as MicrovoltInput::ToMicrovolts for each sample.
+  void ConvertToMicrovolts(std::span<int32_t> samples) const {
+    const AnalogInput::Limits limits = GetLimits();
+    const MicrovoltInput::References reference = GetReferences();
+
+    for (int32_t& sample : samples) {
+      sample = MicrovoltInput::ToMicrovolts(sample, limits, reference);
+    }
+  }
+
+ private:
+  // Returns the reference voltages needed to calculate the voltage.
+  // These values do not change at run time.
+  virtual MicrovoltInput::References GetReferences() const = 0;
+};
+
+}  // namespace pw::analog
@@ -66,10 +66,14 @@ class MicrovoltInput : public AnalogInput {
   Result<int32_t> TryReadMicrovoltsUntil(
       chrono::SystemClock::time_point deadline) {
     PW_TRY_ASSIGN(const int32_t sample, TryReadUntil(deadline));
+    return ToMicrovolts(sample, GetLimits(), GetReferences());
+  }
 
-    const References reference = GetReferences();
-    const AnalogInput::Limits limits = GetLimits();
-
+  // Converts an ADC sample to microvolts (uV) using the given sample range and
+  // reference voltages.
+  static constexpr int32_t ToMicrovolts(int32_t sample,
+                                        const AnalogInput::Limits& limits,
+                                        const References& reference) {
     return ((static_cast<int64_t>(sample - limits.min) *
              (reference.max_voltage_uv - reference.min_voltage_uv)) /
             (limits.max - limits.min)) +
@@ -15,6 +15,21 @@
 #include "pw_base64/base64.h"
 
 #include <cstdint>
+#include <cstring>
+
+// On x86 hosts, blocks of input are processed with SSSE3 when the CPU supports
+// it. Define PW_BASE64_ENABLE_SSSE3 to 0 to always use the portable code.
+#ifndef PW_BASE64_ENABLE_SSSE3
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PW_BASE64_ENABLE_SSSE3 1
+#else
+#define PW_BASE64_ENABLE_SSSE3 0
+#endif  // x86 GCC or Clang
+#endif  // PW_BASE64_ENABLE_SSSE3
+
+#if PW_BASE64_ENABLE_SSSE3
+#include <tmmintrin.h>
+#endif  // PW_BASE64_ENABLE_SSSE3
 
 namespace pw::base64 {
 namespace {
@@ -44,9 +59,6 @@ constexpr char BitGroup2Char(uint8_t byte1, uint8_t byte2 = 0) {
   return kEncodeTable[((byte1 & 0b00001111) << 2) |
                       ((byte2 & 0b11000000) >> 6)];
 }
-constexpr char BitGroup3Char(uint8_t byte2) {
-  return kEncodeTable[byte2 & 0b00111111];
-}
 
 // Decoding functions
 constexpr char kMinValidChar = '+';
@@ -71,16 +83,147 @@ constexpr uint8_t CharToBits(char ch) {
   return kDecodeTable[ch - kMinValidChar];
 }
 
-constexpr uint8_t Byte0(uint8_t bits0, uint8_t bits1) {
-  return (bits0 << 2) | ((bits1 & 0b110000) >> 4);
+// Encodes one full 3-byte group. Combining the group into one 24-bit word
+// takes fewer operations than extracting each 6-bit pattern separately.
+inline void EncodeGroup(const uint8_t* bytes, char* output) {
+  const uint32_t bits = (uint32_t{bytes[0]} << 16) |
+                        (uint32_t{bytes[1]} << 8) | uint32_t{bytes[2]};
+  output[0] = kEncodeTable[bits >> 18];
+  output[1] = kEncodeTable[(bits >> 12) & 0b111111];
+  output[2] = kEncodeTable[(bits >> 6) & 0b111111];
+  output[3] = kEncodeTable[bits & 0b111111];
 }
-constexpr uint8_t Byte1(uint8_t bits1, uint8_t bits2) {
-  return ((bits1 & 0b001111) << 4) | ((bits2 & 0b111100) >> 2);
+
+// Decodes one 4-character group. All characters are read before any bytes are
+// written, so decoding may occur in place.
+inline void DecodeGroup(const char* base64, uint8_t* binary) {
+  const uint32_t bits = (uint32_t{CharToBits(base64[0])} << 18) |
+                        (uint32_t{CharToBits(base64[1])} << 12) |
+                        (uint32_t{CharToBits(base64[2])} << 6) |
+                        uint32_t{CharToBits(base64[3])};
+  binary[0] = static_cast<uint8_t>(bits >> 16);
+  binary[1] = static_cast<uint8_t>(bits >> 8);
+  binary[2] = static_cast<uint8_t>(bits);
 }
-constexpr uint8_t Byte2(uint8_t bits2, uint8_t bits3) {
-  return ((bits2 & 0b000011) << 6) | bits3;
+
+#if PW_BASE64_ENABLE_SSSE3
+
+bool HasSsse3() {
+  static const bool has_ssse3 = __builtin_cpu_supports("ssse3");
+  return has_ssse3;
+}
+
+// Encodes 12 bytes to 16 characters per iteration while at least 16 bytes
+// remain, since each iteration loads 16. Returns the number of bytes encoded.
+__attribute__((target("ssse3"))) size_t EncodeBlocksSsse3(const uint8_t* bytes,
+                                                          size_t size,
+                                                          char* output) {
+  // Each 32-bit lane gets one 3-byte group, arranged so that multiplies can
+  // shift the four 6-bit patterns into their own bytes.
+  const __m128i kGroupShuffle =
+      _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+  // Offsets from each 6-bit value to its character, indexed by a reduced
+  // value: 13 for A-Z, 0 for a-z, 1-10 for 0-9, 11 for + and 12 for /.
+  const __m128i kCharOffsets = _mm_setr_epi8('a' - 26,
+                                             '0' - 52,
+                                             '0' - 52,
+                                             '0' - 52,
+                                             '0' - 52,
+                                             '0' - 52,
+                                             '0' - 52,
+                                             '0' - 52,
+                                             '0' - 52,
+                                             '0' - 52,
+                                             '0' - 52,
+                                             '+' - 62,
+                                             '/' - 63,
+                                             'A',
+                                             0,
+                                             0);
+
+  size_t encoded = 0;
+  for (; size - encoded >= 16u; encoded += 12u, output += 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+    bytes += 12;
+    in = _mm_shuffle_epi8(in, kGroupShuffle);
+
+    const __m128i high = _mm_mulhi_epu16(
+        _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+        _mm_set1_epi32(0x04000040));
+    const __m128i low = _mm_mullo_epi16(
+        _mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+        _mm_set1_epi32(0x01000010));
+    const __m128i values = _mm_or_si128(high, low);
+
+    __m128i reduced = _mm_subs_epu8(values, _mm_set1_epi8(51));
+    const __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), values);
+    reduced = _mm_or_si128(reduced, _mm_and_si128(upper, _mm_set1_epi8(13)));
+
+    const __m128i chars =
+        _mm_add_epi8(values, _mm_shuffle_epi8(kCharOffsets, reduced));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output), chars);
+  }
+  return encoded;
 }
 
+// Decodes 16 characters to 12 bytes per iteration, leaving the last group,
+// which may have padding, for the scalar code. Returns the number of
+// characters decoded. Like the scalar code, this assumes the input is valid.
+__attribute__((target("ssse3"))) size_t DecodeBlocksSsse3(const char* base64,
+                                                          size_t size,
+                                                          uint8_t* binary) {
+  // Offsets from each character to its 6-bit value, indexed by the high
+  // nibble, and by the low nibble for +, - and /.
+  // clang-format off
+  const __m128i kHighNibbleOffsets = _mm_setr_epi8(
+      0, 0, 0, 52 - '0', 0 - 'A', 0 - 'A', 26 - 'a', 26 - 'a',
+      0, 0, 0, 0,        0,       0,       0,        0);
+  const __m128i kRow2Offsets = _mm_setr_epi8(
+      0, 0, 0, 0,        0, 0,        0, 0,
+      0, 0, 0, 62 - '+', 0, 62 - '-', 0, 63 - '/');
+  // clang-format on
+  size_t decoded = 0;
+  for (; size - decoded >= 20u; decoded += 16u, binary += 12) {
+    const __m128i chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(base64 + decoded));
+
+    // The high nibble determines the offset for every character except +, -,
+    // / and _. The first three are the only characters with high nibble 2.
+    // _ shares high nibble 5 with P-Z, so it is corrected separately.
+    const __m128i high_nibbles =
+        _mm_and_si128(_mm_srli_epi32(chars, 4), _mm_set1_epi8(0x0f));
+    const __m128i low_nibbles = _mm_and_si128(chars, _mm_set1_epi8(0x0f));
+    const __m128i row_2 =
+        _mm_and_si128(_mm_shuffle_epi8(kRow2Offsets, low_nibbles),
+                      _mm_cmpeq_epi8(high_nibbles, _mm_set1_epi8(2)));
+    const __m128i underscore =
+        _mm_and_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('_')),
+                      _mm_set1_epi8((63 - '_') - (0 - 'A')));
+    const __m128i offset =
+        _mm_add_epi8(_mm_shuffle_epi8(kHighNibbleOffsets, high_nibbles),
+                     _mm_add_epi8(row_2, underscore));
+    const __m128i values = _mm_add_epi8(chars, offset);
+
+    // Merge pairs of 6-bit values into 12 bits, then pairs of those into the
+    // 24 bits of each group, and gather the three bytes of each group.
+    const __m128i pairs =
+        _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    const __m128i bytes = _mm_shuffle_epi8(
+        groups,
+        _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+    // Store exactly 12 bytes so that the output may overlap the input.
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(binary), bytes);
+    const uint32_t last = static_cast<uint32_t>(
+        _mm_cvtsi128_si32(_mm_srli_si128(bytes, 8)));
+    std::memcpy(binary + 8, &last, sizeof(last));
+  }
+  return decoded;
+}
+
+#endif  // PW_BASE64_ENABLE_SSSE3
+
 }  // namespace
 
 extern "C" void pw_Base64Encode(const void* binary_data,
@@ -88,13 +231,26 @@ extern "C" void pw_Base64Encode(const void* binary_data,
                                 char* output) {
   const uint8_t* bytes = static_cast<const uint8_t*>(binary_data);
 
-  // Encode groups of 3 source bytes into 4 output characters.
   size_t remaining = binary_size_bytes;
-  for (; remaining >= 3u; remaining -= 3u, bytes += 3) {
-    *output++ = BitGroup0Char(bytes[0]);
-    *output++ = BitGroup1Char(bytes[0], bytes[1]);
-    *output++ = BitGroup2Char(bytes[1], bytes[2]);
-    *output++ = BitGroup3Char(bytes[2]);
+
+#if PW_BASE64_ENABLE_SSSE3
+  if (HasSsse3()) {
+    const size_t encoded = EncodeBlocksSsse3(bytes, remaining, output);
+    bytes += encoded;
+    output += encoded / 3 * 4;
+    remaining -= encoded;
+  }
+#endif  // PW_BASE64_ENABLE_SSSE3
+
+  // Encode blocks of four 3-byte groups, then any remaining groups.
+  for (; remaining >= 12u; remaining -= 12u, bytes += 12, output += 16) {
+    EncodeGroup(bytes, output);
+    EncodeGroup(bytes + 3, output + 4);
+    EncodeGroup(bytes + 6, output + 8);
+    EncodeGroup(bytes + 9, output + 12);
+  }
+  for (; remaining >= 3u; remaining -= 3u, bytes += 3, output += 4) {
+    EncodeGroup(bytes, output);
   }
 
   // If the source data length isn't a multiple of 3, pad the end with either 1
@@ -120,18 +276,7 @@ extern "C" size_t pw_Base64Decode(const char* base64,
     return 0;
   }
 
-  uint8_t* binary = static_cast<uint8_t*>(output);
-  for (size_t ch = 0; ch < base64_size_bytes; ch += kEncodedGroupSize) {
-    const uint8_t char0 = CharToBits(base64[ch + 0]);
-    const uint8_t char1 = CharToBits(base64[ch + 1]);
-    const uint8_t char2 = CharToBits(base64[ch + 2]);
-    const uint8_t char3 = CharToBits(base64[ch + 3]);
-
-    *binary++ = Byte0(char0, char1);
-    *binary++ = Byte1(char1, char2);
-    *binary++ = Byte2(char2, char3);
-  }
-
+  // Check the padding first, since decoding in place overwrites it.
   size_t pad = 0;
   if (base64[base64_size_bytes - 2] == kPadding) {
     pad = 2;
@@ -139,6 +284,27 @@ extern "C" size_t pw_Base64Decode(const char* base64,
     pad = 1;
   }
 
+  uint8_t* binary = static_cast<uint8_t*>(output);
+  size_t ch = 0;
+
+#if PW_BASE64_ENABLE_SSSE3
+  if (HasSsse3()) {
+    ch = DecodeBlocksSsse3(base64, base64_size_bytes, binary);
+    binary += ch / 4 * 3;
+  }
+#endif  // PW_BASE64_ENABLE_SSSE3
+
+  // Decode blocks of four groups, then any remaining groups.
+  for (; base64_size_bytes - ch >= 16u; ch += 16, binary += 12) {
+    DecodeGroup(&base64[ch], binary);
+    DecodeGroup(&base64[ch + 4], binary + 3);
+    DecodeGroup(&base64[ch + 8], binary + 6);
+    DecodeGroup(&base64[ch + 12], binary + 9);
+  }
+  for (; ch < base64_size_bytes; ch += kEncodedGroupSize, binary += 3) {
+    DecodeGroup(&base64[ch], binary);
+  }
+
   return binary - static_cast<uint8_t*>(output) - pad;
 }
 
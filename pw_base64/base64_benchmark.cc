@@ -0,0 +1,101 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures Base64 encode and decode throughput for several input sizes, and
+// checks that every decode reproduces its input. Run on the host or on a device
+// with a pw_chrono:system_clock backend; results are logged.
+
+#define PW_LOG_MODULE_NAME "BASE64"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_base64/base64.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_log/log.h"
+
+namespace pw::base64 {
+namespace {
+
+constexpr size_t kMaxSize = 4096;
+constexpr size_t kBytesPerSize = 1 << 20;
+
+std::array<std::byte, kMaxSize> binary;
+std::array<char, EncodedSize(kMaxSize)> encoded;
+std::array<std::byte, MaxDecodedSize(EncodedSize(kMaxSize))> decoded;
+
+// Returns the time in nanoseconds to run the function, divided by count.
+template <typename Function>
+int64_t NanosecondsPer(size_t count, Function&& function) {
+  const auto start = chrono::SystemClock::now();
+  function();
+  const auto elapsed = chrono::SystemClock::now() - start;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() /
+         static_cast<int64_t>(count);
+}
+
+bool Measure(size_t size) {
+  const size_t rounds = kBytesPerSize / size;
+  const size_t encoded_size = EncodedSize(size);
+  const std::span<const std::byte> input(binary.data(), size);
+  const std::string_view base64(encoded.data(), encoded_size);
+
+  const int64_t encode_ns = NanosecondsPer(rounds, [&] {
+    for (size_t i = 0; i < rounds; ++i) {
+      Encode(input, encoded.data());
+    }
+  });
+  size_t decoded_size = 0;
+  const int64_t decode_ns = NanosecondsPer(rounds, [&] {
+    for (size_t i = 0; i < rounds; ++i) {
+      decoded_size = Decode(base64, decoded.data());
+    }
+  });
+
+  if (decoded_size != size ||
+      std::memcmp(binary.data(), decoded.data(), size) != 0) {
+    PW_LOG_ERROR("%5u bytes: decoded data does not match",
+                 static_cast<unsigned>(size));
+    return false;
+  }
+
+  PW_LOG_INFO(
+      "%4u bytes: encode %5ld ns (%4ld MB/s), decode %5ld ns (%4ld MB/s)",
+      static_cast<unsigned>(size),
+      static_cast<long>(encode_ns),
+      static_cast<long>(encode_ns == 0 ? 0 : 1000 * size / encode_ns),
+      static_cast<long>(decode_ns),
+      static_cast<long>(decode_ns == 0 ? 0 : 1000 * size / decode_ns));
+  return true;
+}
+
+}  // namespace
+}  // namespace pw::base64
+
+int main() {
+  uint32_t seed = 1;
+  for (std::byte& byte : pw::base64::binary) {
+    seed = seed * 1664525u + 1013904223u;
+    byte = static_cast<std::byte>(seed >> 24);
+  }
+
+  bool ok = true;
+  for (size_t size : {16, 64, 256, 1024, 4096}) {
+    ok = pw::base64::Measure(size) && ok;
+  }
+  return ok ? 0 : 1;
+}
@@ -14,6 +14,8 @@
 
 #include "pw_base64/base64.h"
 
+#include <array>
+#include <cstdint>
 #include <cstring>
 
 #include "gtest/gtest.h"
@@ -365,6 +367,68 @@ bool pw_Base64CallIsValid(const char* base64_data, size_t base64_size);
 constexpr const char kBase64[] = "aaaabbbbcc#%";
 
 // Ensure that the C API works correctly from a C-only context.
+// Encodes one bit at a time, as a reference for the optimized implementation.
+void ReferenceEncode(const uint8_t* data, size_t size, char* output) {
+  constexpr char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  uint32_t bits = 0;
+  int bit_count = 0;
+  for (size_t i = 0; i < size; ++i) {
+    bits = (bits << 8) | data[i];
+    bit_count += 8;
+    while (bit_count >= 6) {
+      bit_count -= 6;
+      *output++ = kAlphabet[(bits >> bit_count) & 0x3f];
+    }
+  }
+  if (bit_count > 0) {
+    *output++ = kAlphabet[(bits << (6 - bit_count)) & 0x3f];
+  }
+  for (size_t i = size; i % 3 != 0; ++i) {
+    *output++ = '=';
+  }
+}
+
+// Covers every alignment of the block-based fast paths and their tails.
+TEST(Base64, EncodeDecode_AllSizesMatchReference) {
+  std::array<uint8_t, 300> data;
+  uint32_t seed = 1;
+  for (uint8_t& byte : data) {
+    seed = seed * 1664525u + 1013904223u;
+    byte = static_cast<uint8_t>(seed >> 24);
+  }
+
+  for (size_t size = 0; size <= data.size(); ++size) {
+    std::array<char, EncodedSize(300)> expected;
+    std::array<char, EncodedSize(300)> encoded;
+    ReferenceEncode(data.data(), size, expected.data());
+    pw_Base64Encode(data.data(), size, encoded.data());
+    ASSERT_EQ(0,
+              std::memcmp(expected.data(), encoded.data(), EncodedSize(size)));
+
+    const std::string_view base64(encoded.data(), EncodedSize(size));
+    std::array<uint8_t, 300> decoded;
+    ASSERT_EQ(size, Decode(base64, decoded.data()));
+    ASSERT_EQ(0, std::memcmp(data.data(), decoded.data(), size));
+
+    // The URL-safe alphabet decodes to the same data.
+    for (size_t i = 0; i < base64.size(); ++i) {
+      if (encoded[i] == '+') {
+        encoded[i] = '-';
+      } else if (encoded[i] == '/') {
+        encoded[i] = '_';
+      }
+    }
+    decoded = {};
+    ASSERT_EQ(size, Decode(base64, decoded.data()));
+    ASSERT_EQ(0, std::memcmp(data.data(), decoded.data(), size));
+
+    // Decode in place.
+    ASSERT_EQ(size, Decode(base64, encoded.data()));
+    ASSERT_EQ(0, std::memcmp(data.data(), encoded.data(), size));
+  }
+}
+
 TEST(Base64, IsValid_Ok) {
   EXPECT_TRUE(IsValid(std::string_view(kBase64, 4)));
   EXPECT_TRUE(IsValid(std::string_view(kBase64, 8)));
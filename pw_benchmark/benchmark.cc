@@ -0,0 +1,157 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_benchmark/benchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "pw_assert/check.h"
+#include "pw_polyfill/language_feature_macros.h"
+
+namespace pw::benchmark {
+namespace {
+
+// Upper bound on calibration, in case a benchmark's samples take no
+// measurable time (for example, if it never calls KeepRunning()).
+constexpr uint64_t kMaxIterations = uint64_t(1) << 30;
+
+// Constant-initialized, so benchmarks can register from static constructors
+// in any translation unit.
+PW_CONSTINIT IntrusiveList<Benchmark> registered_benchmarks;
+
+struct Sample {
+  uint64_t elapsed;
+  uint64_t bytes_per_iteration;
+};
+
+Sample RunSample(const Benchmark& benchmark, Timer& timer, uint64_t count) {
+  State state(timer, count, benchmark.argument());
+  benchmark.function()(state);
+  return {state.elapsed(), state.bytes_per_iteration()};
+}
+
+}  // namespace
+
+bool State::StartOrFinish() {
+  if (!started_) {
+    started_ = true;
+    if (iterations_ == 0u) {
+      return false;
+    }
+    remaining_ = iterations_ - 1;
+    start_ = timer_.Now();
+    return true;
+  }
+  elapsed_ += timer_.Now() - start_;
+  return false;
+}
+
+Benchmark::Benchmark(const char* name,
+                     Function benchmark_function,
+                     int64_t argument,
+                     bool has_argument)
+    : name_(name),
+      function_(benchmark_function),
+      argument_(argument),
+      has_argument_(has_argument) {
+  registered_benchmarks.push_back(*this);
+}
+
+IntrusiveList<Benchmark>& Benchmark::All() { return registered_benchmarks; }
+
+Statistics Statistics::Compute(std::span<uint64_t> samples) {
+  PW_CHECK(!samples.empty());
+  std::sort(samples.begin(), samples.end());
+
+  const size_t count = samples.size();
+  const size_t middle = count / 2;
+
+  uint64_t sum = 0;
+  for (uint64_t sample : samples) {
+    sum += sample;
+  }
+
+  Statistics statistics = {
+      .min = samples.front(),
+      .max = samples.back(),
+      .mean = sum / count,
+      .median = count % 2 == 0
+                    ? (samples[middle - 1] + samples[middle]) / 2
+                    : samples[middle],
+      .stddev = 0,
+  };
+
+  if (count > 1u) {
+    // Squared deviations can overflow 64 bits for slow benchmarks, so they
+    // are accumulated in floating point. This is outside of the measurement.
+    const double mean = double(sum) / double(count);
+    double squares = 0;
+    for (uint64_t sample : samples) {
+      const double deviation = double(sample) - mean;
+      squares += deviation * deviation;
+    }
+    statistics.stddev =
+        uint64_t(std::sqrt(squares / double(count - 1)) + 0.5);
+  }
+  return statistics;
+}
+
+Result RunBenchmark(const Benchmark& benchmark,
+                    Timer& timer,
+                    const Options& options) {
+  PW_CHECK_UINT_GT(options.repetitions, 0);
+  PW_CHECK_UINT_LE(options.repetitions, kMaxRepetitions);
+
+  const uint64_t min_sample_ticks =
+      timer.ticks_per_second() * options.min_sample_time_us / 1'000'000;
+
+  // Calibrate the iteration count. The last calibration sample also serves
+  // to warm up caches and is not reported.
+  uint64_t iterations = 1;
+  Sample sample = RunSample(benchmark, timer, iterations);
+  while (sample.elapsed < min_sample_ticks && iterations < kMaxIterations) {
+    iterations *= sample.elapsed <= min_sample_ticks / 10 ? 10 : 2;
+    iterations = std::min(iterations, kMaxIterations);
+    sample = RunSample(benchmark, timer, iterations);
+  }
+
+  std::array<uint64_t, kMaxRepetitions> samples;
+  for (uint32_t i = 0; i < options.repetitions; ++i) {
+    sample = RunSample(benchmark, timer, iterations);
+    samples[i] = sample.elapsed * 1000 / iterations;
+  }
+
+  return Result{
+      .benchmark = benchmark,
+      .iterations = iterations,
+      .repetitions = options.repetitions,
+      .bytes_per_iteration = sample.bytes_per_iteration,
+      .statistics = Statistics::Compute(
+          std::span(samples).first(options.repetitions)),
+  };
+}
+
+void RunAllBenchmarks(Timer& timer,
+                      Reporter& reporter,
+                      const Options& options) {
+  reporter.RunStart(timer);
+  for (const Benchmark& benchmark : registered_benchmarks) {
+    reporter.BenchmarkDone(RunBenchmark(benchmark, timer, options));
+  }
+  reporter.RunEnd();
+}
+
+}  // namespace pw::benchmark
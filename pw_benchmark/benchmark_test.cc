@@ -0,0 +1,215 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_benchmark/benchmark.h"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_assert/check.h"
+#include "pw_benchmark/json_reporter.h"
+#include "pw_containers/vector.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::benchmark {
+namespace {
+
+// Timer that only advances when told to. One tick is a microsecond.
+class FakeTimer final : public Timer {
+ public:
+  uint64_t Now() final { return now_; }
+  uint64_t ticks_per_second() const final { return 1'000'000; }
+  const char* unit() const final { return "us"; }
+
+  void Advance(uint64_t ticks) { now_ += ticks; }
+
+ private:
+  uint64_t now_ = 0;
+};
+
+FakeTimer fake_timer;
+
+constexpr Options kOptions = {.repetitions = 4, .min_sample_time_us = 1000};
+
+// Takes 7 ticks per iteration.
+void BM_SevenTicks(State& state) {
+  while (state.KeepRunning()) {
+    fake_timer.Advance(7);
+  }
+}
+PW_BENCHMARK(BM_SevenTicks);
+
+// Takes a tick per iteration, plus setup that is excluded from the timing.
+void BM_PausedSetup(State& state) {
+  state.set_bytes_per_iteration(state.argument());
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    fake_timer.Advance(1000);
+    state.ResumeTiming();
+    fake_timer.Advance(1);
+  }
+}
+PW_BENCHMARK_WITH_ARGUMENT(BM_PausedSetup, 32);
+
+const Benchmark& Find(std::string_view name) {
+  for (const Benchmark& benchmark : Benchmark::All()) {
+    if (name == benchmark.name()) {
+      return benchmark;
+    }
+  }
+  PW_CRASH("Benchmark not found");
+}
+
+TEST(Benchmark, Registration) {
+  const Benchmark& benchmark = Find("BM_PausedSetup");
+  EXPECT_TRUE(benchmark.function() == &BM_PausedSetup);
+  EXPECT_TRUE(benchmark.has_argument());
+  EXPECT_EQ(benchmark.argument(), 32);
+  EXPECT_FALSE(Find("BM_SevenTicks").has_argument());
+}
+
+TEST(State, KeepRunning_RunsEachIterationOnce) {
+  State state(fake_timer, 5, 0);
+  int count = 0;
+  while (state.KeepRunning()) {
+    count += 1;
+    fake_timer.Advance(2);
+  }
+  EXPECT_EQ(count, 5);
+  EXPECT_EQ(state.elapsed(), 10u);
+  EXPECT_FALSE(state.KeepRunning());
+}
+
+TEST(State, KeepRunning_ExcludesTimeBeforeLoop) {
+  State state(fake_timer, 1, 0);
+  fake_timer.Advance(100);
+  while (state.KeepRunning()) {
+    fake_timer.Advance(3);
+  }
+  EXPECT_EQ(state.elapsed(), 3u);
+}
+
+TEST(RunBenchmark, CalibratesToMinimumSampleTime) {
+  const Result result =
+      RunBenchmark(Find("BM_SevenTicks"), fake_timer, kOptions);
+  EXPECT_GE(result.iterations * 7, kOptions.min_sample_time_us);
+  EXPECT_EQ(result.repetitions, 4u);
+  EXPECT_EQ(result.bytes_per_iteration, 0u);
+  EXPECT_EQ(result.statistics.min, 7000u);
+  EXPECT_EQ(result.statistics.max, 7000u);
+  EXPECT_EQ(result.statistics.mean, 7000u);
+  EXPECT_EQ(result.statistics.median, 7000u);
+  EXPECT_EQ(result.statistics.stddev, 0u);
+}
+
+TEST(RunBenchmark, PausedTimeIsExcluded) {
+  const Result result =
+      RunBenchmark(Find("BM_PausedSetup"), fake_timer, kOptions);
+  EXPECT_EQ(result.bytes_per_iteration, 32u);
+  EXPECT_EQ(result.statistics.mean, 1000u);
+}
+
+TEST(Statistics, Compute) {
+  std::array<uint64_t, 4> samples = {4000, 1000, 3000, 2000};
+  const Statistics statistics = Statistics::Compute(samples);
+  EXPECT_EQ(statistics.min, 1000u);
+  EXPECT_EQ(statistics.max, 4000u);
+  EXPECT_EQ(statistics.mean, 2500u);
+  EXPECT_EQ(statistics.median, 2500u);
+  EXPECT_EQ(statistics.stddev, 1291u);  // sqrt(5/3) * 1000
+}
+
+TEST(Statistics, Compute_OddCountAndSingleSample) {
+  std::array<uint64_t, 3> samples = {10, 30, 11};
+  EXPECT_EQ(Statistics::Compute(samples).median, 11u);
+
+  std::array<uint64_t, 1> single = {42};
+  EXPECT_EQ(Statistics::Compute(single).median, 42u);
+  EXPECT_EQ(Statistics::Compute(single).stddev, 0u);
+}
+
+Vector<StringBuffer<384>, 8> lines;
+
+void CaptureLine(std::string_view line) {
+  lines.push_back({});
+  lines.back() << line;
+}
+
+TEST(JsonReporter, WritesResults) {
+  lines.clear();
+  JsonReporter reporter(CaptureLine);
+
+  reporter.RunStart(fake_timer);
+  reporter.BenchmarkDone({.benchmark = Find("BM_SevenTicks"),
+                          .iterations = 200,
+                          .repetitions = 4,
+                          .bytes_per_iteration = 0,
+                          .statistics = {.min = 7000,
+                                         .max = 7250,
+                                         .mean = 7100,
+                                         .median = 7005,
+                                         .stddev = 98}});
+  reporter.BenchmarkDone({.benchmark = Find("BM_PausedSetup"),
+                          .iterations = 1000,
+                          .repetitions = 4,
+                          .bytes_per_iteration = 32,
+                          .statistics = {.min = 1000,
+                                         .max = 1000,
+                                         .mean = 1000,
+                                         .median = 1000,
+                                         .stddev = 0}});
+  reporter.RunEnd();
+
+  ASSERT_EQ(lines.size(), 7u);
+  EXPECT_STREQ(lines[0].c_str(), "{");
+  EXPECT_STREQ(lines[1].c_str(),
+               "  \"context\": {\"unit\": \"us\", "
+               "\"ticks_per_second\": 1000000},");
+  EXPECT_STREQ(lines[2].c_str(), "  \"benchmarks\": [");
+  EXPECT_STREQ(lines[3].c_str(),
+               "    {\"name\": \"BM_SevenTicks\", \"iterations\": 200, "
+               "\"repetitions\": 4, \"min\": 7.000, \"max\": 7.250, "
+               "\"mean\": 7.100, \"median\": 7.005, \"stddev\": 0.098},");
+  EXPECT_STREQ(lines[4].c_str(),
+               "    {\"name\": \"BM_PausedSetup/32\", \"iterations\": 1000, "
+               "\"repetitions\": 4, \"bytes_per_iteration\": 32, "
+               "\"min\": 1.000, \"max\": 1.000, \"mean\": 1.000, "
+               "\"median\": 1.000, \"stddev\": 0.000}");
+  EXPECT_STREQ(lines[5].c_str(), "  ]");
+  EXPECT_STREQ(lines[6].c_str(), "}");
+}
+
+class CountingReporter final : public Reporter {
+ public:
+  void RunStart(const Timer&) final { started = true; }
+  void BenchmarkDone(const Result&) final { benchmarks += 1; }
+  void RunEnd() final { ended = true; }
+
+  bool started = false;
+  int benchmarks = 0;
+  bool ended = false;
+};
+
+TEST(RunAllBenchmarks, ReportsEveryBenchmark) {
+  CountingReporter reporter;
+  RunAllBenchmarks(fake_timer, reporter, kOptions);
+  EXPECT_TRUE(reporter.started);
+  EXPECT_EQ(reporter.benchmarks, 2);
+  EXPECT_TRUE(reporter.ended);
+}
+
+}  // namespace
+}  // namespace pw::benchmark
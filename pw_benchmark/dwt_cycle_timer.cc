@@ -0,0 +1,56 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_benchmark/dwt_cycle_timer.h"
+
+namespace pw::benchmark {
+namespace {
+
+// Memory mapped registers. (ARMv7-M Section C1.6 and C1.8)
+inline volatile uint32_t& cortex_m_demcr =
+    *reinterpret_cast<volatile uint32_t*>(0xE000EDFCu);
+inline volatile uint32_t& cortex_m_dwt_ctrl =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001000u);
+inline volatile uint32_t& cortex_m_dwt_cyccnt =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001004u);
+
+// Software lock access register, which must be unlocked on some cores (such as
+// the Cortex-M7) before the DWT can be configured.
+inline volatile uint32_t& cortex_m_dwt_lar =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001FB0u);
+
+constexpr uint32_t kDemcrTraceEnableMask = 0x1u << 24;    // TRCENA
+constexpr uint32_t kDwtCtrlCycleCountEnableMask = 0x1u;  // CYCCNTENA
+constexpr uint32_t kDwtLarUnlockKey = 0xC5ACCE55u;
+
+}  // namespace
+
+DwtCycleTimer::DwtCycleTimer(uint32_t cpu_clock_hz)
+    : cpu_clock_hz_(cpu_clock_hz), last_count_(0), upper_bits_(0) {
+  cortex_m_demcr |= kDemcrTraceEnableMask;
+  cortex_m_dwt_lar = kDwtLarUnlockKey;
+  cortex_m_dwt_cyccnt = 0;
+  cortex_m_dwt_ctrl |= kDwtCtrlCycleCountEnableMask;
+}
+
+uint64_t DwtCycleTimer::Now() {
+  const uint32_t count = cortex_m_dwt_cyccnt;
+  if (count < last_count_) {
+    upper_bits_ += uint64_t(1) << 32;
+  }
+  last_count_ = count;
+  return upper_bits_ | count;
+}
+
+}  // namespace pw::benchmark
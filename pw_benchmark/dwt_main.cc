@@ -0,0 +1,34 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <string_view>
+
+#include "pw_benchmark/benchmark.h"
+#include "pw_benchmark/dwt_cycle_timer.h"
+#include "pw_benchmark/json_reporter.h"
+#include "pw_benchmark_private/config.h"
+#include "pw_sys_io/sys_io.h"
+
+int main() {
+  pw::benchmark::DwtCycleTimer timer(pw::benchmark::kCpuClockHz);
+  pw::benchmark::JsonReporter reporter(
+      [](std::string_view line) { pw::sys_io::WriteLine(line); });
+
+  pw::benchmark::RunAllBenchmarks(
+      timer,
+      reporter,
+      {.repetitions = pw::benchmark::kDefaultRepetitions,
+       .min_sample_time_us = pw::benchmark::kDefaultMinSampleTimeUs});
+  return 0;
+}
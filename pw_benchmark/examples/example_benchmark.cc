@@ -0,0 +1,96 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Example benchmarks, which also serve as a baseline for a few commonly used
+// Pigweed primitives.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_benchmark/benchmark.h"
+#include "pw_checksum/crc16_ccitt.h"
+#include "pw_checksum/crc32.h"
+#include "pw_varint/varint.h"
+
+namespace pw::benchmark {
+namespace {
+
+constexpr size_t kMaxDataSize = 1024;
+
+std::array<std::byte, kMaxDataSize> data = {};
+
+void BM_Crc16Ccitt(State& state) {
+  const std::span<const std::byte> input =
+      std::span(data).first(state.argument());
+  state.set_bytes_per_iteration(input.size());
+
+  while (state.KeepRunning()) {
+    uint16_t crc = checksum::Crc16Ccitt::Calculate(input);
+    DoNotOptimize(crc);
+  }
+}
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc16Ccitt, 16);
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc16Ccitt, 256);
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc16Ccitt, 1024);
+
+void BM_Crc32(State& state) {
+  const std::span<const std::byte> input =
+      std::span(data).first(state.argument());
+  state.set_bytes_per_iteration(input.size());
+
+  while (state.KeepRunning()) {
+    uint32_t crc = checksum::Crc32::Calculate(input);
+    DoNotOptimize(crc);
+  }
+}
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc32, 16);
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc32, 256);
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc32, 1024);
+
+// The argument is the value to encode, which determines the encoded size.
+void BM_VarintEncode(State& state) {
+  std::array<std::byte, varint::kMaxVarint64SizeBytes> buffer;
+  uint64_t value = uint64_t(state.argument());
+
+  while (state.KeepRunning()) {
+    DoNotOptimize(value);
+    size_t size = varint::Encode(value, buffer);
+    DoNotOptimize(size);
+  }
+}
+PW_BENCHMARK_WITH_ARGUMENT(BM_VarintEncode, 1);
+PW_BENCHMARK_WITH_ARGUMENT(BM_VarintEncode, 1 << 20);
+PW_BENCHMARK_WITH_ARGUMENT(BM_VarintEncode, INT64_MAX);
+
+void BM_VarintDecode(State& state) {
+  std::array<std::byte, varint::kMaxVarint64SizeBytes> buffer;
+  const size_t encoded_size =
+      varint::Encode(uint64_t(state.argument()), buffer);
+  const std::span<const std::byte> input =
+      std::span(buffer).first(encoded_size);
+
+  while (state.KeepRunning()) {
+    uint64_t value;
+    size_t size = varint::Decode(input, &value);
+    DoNotOptimize(value);
+    DoNotOptimize(size);
+  }
+}
+PW_BENCHMARK_WITH_ARGUMENT(BM_VarintDecode, 1);
+PW_BENCHMARK_WITH_ARGUMENT(BM_VarintDecode, 1 << 20);
+PW_BENCHMARK_WITH_ARGUMENT(BM_VarintDecode, INT64_MAX);
+
+}  // namespace
+}  // namespace pw::benchmark
@@ -0,0 +1,91 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_benchmark/json_reporter.h"
+
+namespace pw::benchmark {
+namespace {
+
+// Writes a value in thousandths as a decimal number with three fractional
+// digits.
+void AppendThousandths(StringBuilder& sb, uint64_t value) {
+  const unsigned fraction = unsigned(value % 1000);
+  sb << value / 1000 << '.';
+  if (fraction < 100u) {
+    sb << '0';
+  }
+  if (fraction < 10u) {
+    sb << '0';
+  }
+  sb << fraction;
+}
+
+}  // namespace
+
+void JsonReporter::RunStart(const Timer& timer) {
+  pending_.clear();
+  write_line_("{");
+
+  StringBuffer<96> context;
+  context << "  \"context\": {\"unit\": \"" << timer.unit()
+          << "\", \"ticks_per_second\": " << timer.ticks_per_second() << "},";
+  write_line_(context);
+  write_line_("  \"benchmarks\": [");
+}
+
+void JsonReporter::BenchmarkDone(const Result& result) {
+  FlushPending(true);
+
+  pending_ << "    {\"name\": \"" << result.benchmark.name();
+  if (result.benchmark.has_argument()) {
+    pending_ << '/' << result.benchmark.argument();
+  }
+  pending_ << "\", \"iterations\": " << result.iterations
+           << ", \"repetitions\": " << result.repetitions;
+  if (result.bytes_per_iteration != 0u) {
+    pending_ << ", \"bytes_per_iteration\": " << result.bytes_per_iteration;
+  }
+
+  const Statistics& statistics = result.statistics;
+  pending_ << ", \"min\": ";
+  AppendThousandths(pending_, statistics.min);
+  pending_ << ", \"max\": ";
+  AppendThousandths(pending_, statistics.max);
+  pending_ << ", \"mean\": ";
+  AppendThousandths(pending_, statistics.mean);
+  pending_ << ", \"median\": ";
+  AppendThousandths(pending_, statistics.median);
+  pending_ << ", \"stddev\": ";
+  AppendThousandths(pending_, statistics.stddev);
+  pending_ << '}';
+}
+
+void JsonReporter::RunEnd() {
+  FlushPending(false);
+  write_line_("  ]");
+  write_line_("}");
+}
+
+void JsonReporter::FlushPending(bool more_follow) {
+  if (pending_.empty()) {
+    return;
+  }
+  if (more_follow) {
+    pending_ << ',';
+  }
+  write_line_(pending_);
+  pending_.clear();
+}
+
+}  // namespace pw::benchmark
@@ -0,0 +1,218 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_benchmark/timer.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_preprocessor/concat.h"
+
+// Registers a function with the signature void(pw::benchmark::State&) as a
+// benchmark. The function runs its measured code in a KeepRunning() loop:
+//
+//   void BM_Crc32(pw::benchmark::State& state) {
+//     while (state.KeepRunning()) {
+//       uint32_t crc = pw::checksum::Crc32::Calculate(kData);
+//       pw::benchmark::DoNotOptimize(crc);
+//     }
+//   }
+//   PW_BENCHMARK(BM_Crc32);
+//
+#define PW_BENCHMARK(function)                                    \
+  static ::pw::benchmark::Benchmark PW_CONCAT(                    \
+      _pw_benchmark_, function, _, __LINE__)(#function, function)
+
+// Registers a benchmark that is passed an integer argument, which it reads
+// with state.argument(). The same function may be registered with several
+// arguments, for example to measure how a cost scales with input size.
+#define PW_BENCHMARK_WITH_ARGUMENT(function, argument)         \
+  static ::pw::benchmark::Benchmark PW_CONCAT(                 \
+      _pw_benchmark_, function, _, __LINE__)(                  \
+      #function, function, static_cast<int64_t>(argument))
+
+namespace pw::benchmark {
+
+// Forces the compiler to materialize value, so that computations whose result
+// is otherwise unused are not optimized out of a benchmark.
+template <typename T>
+inline void DoNotOptimize(T& value) {
+#if defined(__clang__)
+  asm volatile("" : "+r,m"(value) : : "memory");
+#else
+  asm volatile("" : "+m,r"(value) : : "memory");
+#endif  // defined(__clang__)
+}
+
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Forces all pending memory writes to be performed.
+inline void ClobberMemory() { asm volatile("" : : : "memory"); }
+
+// Passed to a benchmark function to control one sample: a batch of
+// iterations() back-to-back runs of the measured code. Time is measured from
+// the first call to KeepRunning() until it returns false.
+class State {
+ public:
+  State(Timer& timer, uint64_t iterations, int64_t argument)
+      : timer_(timer),
+        iterations_(iterations),
+        remaining_(0),
+        argument_(argument),
+        start_(0),
+        elapsed_(0),
+        bytes_per_iteration_(0),
+        started_(false) {}
+
+  State(const State&) = delete;
+  State& operator=(const State&) = delete;
+
+  // Returns true once for each iteration in the sample.
+  bool KeepRunning() {
+    if (remaining_ != 0u) {
+      remaining_ -= 1;
+      return true;
+    }
+    return StartOrFinish();
+  }
+
+  // Excludes the code between PauseTiming() and ResumeTiming() from the
+  // measurement. Pausing has a cost of its own, so avoid doing it on every
+  // iteration of short benchmarks.
+  void PauseTiming() { elapsed_ += timer_.Now() - start_; }
+  void ResumeTiming() { start_ = timer_.Now(); }
+
+  // The number of iterations in this sample.
+  uint64_t iterations() const { return iterations_; }
+
+  // The argument the benchmark was registered with, or 0.
+  int64_t argument() const { return argument_; }
+
+  // Records how many bytes one iteration processes, so that throughput can be
+  // derived from the results.
+  void set_bytes_per_iteration(uint64_t bytes) { bytes_per_iteration_ = bytes; }
+  uint64_t bytes_per_iteration() const { return bytes_per_iteration_; }
+
+  // Ticks spent in the measured region.
+  uint64_t elapsed() const { return elapsed_; }
+
+ private:
+  bool StartOrFinish();
+
+  Timer& timer_;
+  const uint64_t iterations_;
+  uint64_t remaining_;
+  const int64_t argument_;
+  uint64_t start_;
+  uint64_t elapsed_;
+  uint64_t bytes_per_iteration_;
+  bool started_;
+};
+
+// A registered benchmark. Benchmarks are normally declared with PW_BENCHMARK
+// and live for the duration of the program.
+class Benchmark : public IntrusiveList<Benchmark>::Item {
+ public:
+  using Function = void (*)(State&);
+
+  Benchmark(const char* name, Function benchmark_function)
+      : Benchmark(name, benchmark_function, 0, false) {}
+
+  Benchmark(const char* name, Function benchmark_function, int64_t argument)
+      : Benchmark(name, benchmark_function, argument, true) {}
+
+  Benchmark(const Benchmark&) = delete;
+  Benchmark& operator=(const Benchmark&) = delete;
+
+  const char* name() const { return name_; }
+  Function function() const { return function_; }
+  int64_t argument() const { return argument_; }
+  bool has_argument() const { return has_argument_; }
+
+  // All registered benchmarks, in registration order.
+  static IntrusiveList<Benchmark>& All();
+
+ private:
+  Benchmark(const char* name,
+            Function benchmark_function,
+            int64_t argument,
+            bool has_argument);
+
+  const char* const name_;
+  const Function function_;
+  const int64_t argument_;
+  const bool has_argument_;
+};
+
+// Summary of a benchmark's samples. To keep sub-tick resolution without
+// floating point, all values are in thousandths of a tick per iteration.
+struct Statistics {
+  // Computes the statistics of the given per-iteration sample times. Sorts
+  // the samples in place.
+  static Statistics Compute(std::span<uint64_t> samples);
+
+  uint64_t min;
+  uint64_t max;
+  uint64_t mean;
+  uint64_t median;
+  uint64_t stddev;  // Sample standard deviation; 0 for a single sample.
+};
+
+struct Result {
+  const Benchmark& benchmark;
+  uint64_t iterations;  // Iterations in each sample.
+  uint32_t repetitions;
+  uint64_t bytes_per_iteration;
+  Statistics statistics;
+};
+
+inline constexpr size_t kMaxRepetitions = 32;
+
+struct Options {
+  // The number of samples to take of each benchmark. At most kMaxRepetitions.
+  uint32_t repetitions = 10;
+
+  // The iteration count of a benchmark is increased until one sample takes at
+  // least this long. Longer samples reduce the share of timer overhead and
+  // noise in the results.
+  uint32_t min_sample_time_us = 10'000;
+};
+
+// Receives the results of a benchmark run.
+class Reporter {
+ public:
+  virtual ~Reporter() = default;
+
+  virtual void RunStart(const Timer&) {}
+  virtual void BenchmarkDone(const Result& result) = 0;
+  virtual void RunEnd() {}
+};
+
+// Measures a single benchmark. The iteration count is first calibrated to
+// options.min_sample_time_us; then options.repetitions samples are taken.
+Result RunBenchmark(const Benchmark& benchmark,
+                    Timer& timer,
+                    const Options& options = {});
+
+// Measures every registered benchmark and reports the results.
+void RunAllBenchmarks(Timer& timer,
+                      Reporter& reporter,
+                      const Options& options = {});
+
+}  // namespace pw::benchmark
@@ -0,0 +1,38 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "pw_benchmark/timer.h"
+
+namespace pw::benchmark {
+
+// Timer backed by std::chrono::steady_clock, counting nanoseconds. This is
+// intended for host builds.
+class ChronoTimer final : public Timer {
+ public:
+  uint64_t Now() final {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  uint64_t ticks_per_second() const final { return 1'000'000'000; }
+
+  const char* unit() const final { return "ns"; }
+};
+
+}  // namespace pw::benchmark
@@ -0,0 +1,46 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_benchmark/timer.h"
+
+namespace pw::benchmark {
+
+// Timer backed by the ARMv7-M Data Watchpoint and Trace (DWT) unit's cycle
+// counter, counting CPU cycles. This is not available on ARMv6-M.
+//
+// The hardware counter is 32 bits wide. It is extended to 64 bits in
+// software, which requires Now() to be called at least once per counter
+// period (about 26 seconds at 168 MHz).
+class DwtCycleTimer final : public Timer {
+ public:
+  // Enables the cycle counter. cpu_clock_hz is the core clock frequency and is
+  // only used to convert cycles to seconds.
+  explicit DwtCycleTimer(uint32_t cpu_clock_hz);
+
+  uint64_t Now() final;
+
+  uint64_t ticks_per_second() const final { return cpu_clock_hz_; }
+
+  const char* unit() const final { return "cycles"; }
+
+ private:
+  const uint32_t cpu_clock_hz_;
+  uint32_t last_count_;
+  uint64_t upper_bits_;
+};
+
+}  // namespace pw::benchmark
@@ -0,0 +1,61 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <string_view>
+
+#include "pw_benchmark/benchmark.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::benchmark {
+
+// Reports benchmark results as a JSON document, for consumption by tools that
+// track performance over time. Statistics are in ticks per iteration, in the
+// timer's unit.
+//
+// Example output:
+//
+//   {
+//     "context": {"unit": "ns", "ticks_per_second": 1000000000},
+//     "benchmarks": [
+//       {"name": "BM_Crc32/256", "iterations": 100000, "repetitions": 10,
+//        "bytes_per_iteration": 256, "min": 451.120, "max": 460.004,
+//        "mean": 453.513, "median": 452.870, "stddev": 2.710}
+//     ]
+//   }
+//
+// Each benchmark is written on a single line. Benchmark names are C++
+// identifiers, so they are not escaped.
+class JsonReporter final : public Reporter {
+ public:
+  // Function for writing one line of output, without a trailing newline.
+  using WriteLineFunction = void (*)(std::string_view line);
+
+  explicit JsonReporter(WriteLineFunction write_line)
+      : write_line_(write_line) {}
+
+  void RunStart(const Timer& timer) final;
+  void BenchmarkDone(const Result& result) final;
+  void RunEnd() final;
+
+ private:
+  // Writes the previous benchmark, which is held back until it is known
+  // whether it needs a trailing comma.
+  void FlushPending(bool more_follow);
+
+  WriteLineFunction write_line_;
+  StringBuffer<384> pending_;
+};
+
+}  // namespace pw::benchmark
@@ -0,0 +1,37 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+namespace pw::benchmark {
+
+// Source of timestamps for benchmark measurements. Timers count in ticks of
+// a fixed, target-specific unit, such as nanoseconds or CPU cycles.
+class Timer {
+ public:
+  virtual ~Timer() = default;
+
+  // Returns the current time in ticks. Only differences between timestamps
+  // are meaningful.
+  virtual uint64_t Now() = 0;
+
+  // The number of ticks in one second.
+  virtual uint64_t ticks_per_second() const = 0;
+
+  // Short name for a tick, such as "ns" or "cycles", used when reporting.
+  virtual const char* unit() const = 0;
+};
+
+}  // namespace pw::benchmark
@@ -0,0 +1,43 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+// Defaults for the benchmark mains provided by this module.
+
+// The number of samples to take of each benchmark.
+#ifndef PW_BENCHMARK_REPETITIONS
+#define PW_BENCHMARK_REPETITIONS 10
+#endif  // PW_BENCHMARK_REPETITIONS
+
+// The minimum duration of each sample, in microseconds.
+#ifndef PW_BENCHMARK_MIN_SAMPLE_TIME_US
+#define PW_BENCHMARK_MIN_SAMPLE_TIME_US 10000
+#endif  // PW_BENCHMARK_MIN_SAMPLE_TIME_US
+
+// The core clock frequency used by the DWT cycle counter main to convert
+// cycles to time. The default is the reset clock of the stm32f429i_disc1.
+#ifndef PW_BENCHMARK_CPU_CLOCK_HZ
+#define PW_BENCHMARK_CPU_CLOCK_HZ 16000000
+#endif  // PW_BENCHMARK_CPU_CLOCK_HZ
+
+namespace pw::benchmark {
+
+inline constexpr uint32_t kDefaultRepetitions = PW_BENCHMARK_REPETITIONS;
+inline constexpr uint32_t kDefaultMinSampleTimeUs =
+    PW_BENCHMARK_MIN_SAMPLE_TIME_US;
+inline constexpr uint32_t kCpuClockHz = PW_BENCHMARK_CPU_CLOCK_HZ;
+
+}  // namespace pw::benchmark
@@ -0,0 +1,98 @@
+# Copyright 2022 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for comparing pw_benchmark results with baselines."""
+
+import unittest
+
+from pw_benchmark.compare import Comparison, Results, ResultsError, compare
+
+_OUTPUT = '''\
+INF  Starting benchmarks
+{
+  "context": {"unit": "cycles", "ticks_per_second": 16000000},
+  "benchmarks": [
+INF  Initializing key value store
+    {"name": "BM_KvsPut/16", "iterations": 100, "repetitions": 10, \
+"bytes_per_iteration": 16, "min": 90.000, "max": 110.000, "mean": 100.000, \
+"median": 100.000, "stddev": 5.000},
+    {"name": "BM_KvsGet/16", "iterations": 100, "repetitions": 10, \
+"min": 40.000, "max": 60.000, "mean": 50.000, "median": 50.000, \
+"stddev": 5.000}
+  ]
+}
+INF  Done
+'''
+
+
+def _results(unit: str = 'cycles', **medians: float) -> Results:
+    return Results(unit, 16_000_000, {
+        name: {
+            'name': name,
+            'median': median
+        }
+        for name, median in medians.items()
+    })
+
+
+class TestResults(unittest.TestCase):
+    """Tests reading benchmark results from captured output."""
+    def test_parse_ignores_interleaved_logs(self) -> None:
+        results = Results.parse(_OUTPUT)
+        self.assertEqual(results.unit, 'cycles')
+        self.assertEqual(results.ticks_per_second, 16_000_000)
+        self.assertEqual(list(results.benchmarks),
+                         ['BM_KvsPut/16', 'BM_KvsGet/16'])
+        self.assertEqual(results.benchmarks['BM_KvsPut/16']['median'], 100.0)
+
+    def test_parse_incomplete_output(self) -> None:
+        with self.assertRaises(ResultsError):
+            Results.parse(_OUTPUT[:_OUTPUT.index('  ]')])
+
+    def test_parse_malformed_output(self) -> None:
+        with self.assertRaises(ResultsError):
+            Results.parse('{\n  "context": {},\n}\n')
+
+    def test_to_json_round_trip(self) -> None:
+        results = Results.parse(_OUTPUT)
+        self.assertEqual(Results.parse(results.to_json()), results)
+
+
+class TestCompare(unittest.TestCase):
+    """Tests comparing results with a baseline."""
+    def test_compare(self) -> None:
+        comparisons = compare(_results(a=100, b=100, c=100),
+                              _results(a=104, b=110, c=80))
+        self.assertEqual([c.name for c in comparisons], ['a', 'b', 'c'])
+        self.assertFalse(comparisons[0].regressed(0.05))
+        self.assertTrue(comparisons[1].regressed(0.05))
+        self.assertFalse(comparisons[2].regressed(0.05))
+        self.assertAlmostEqual(comparisons[2].change(), -0.2)
+
+    def test_added_and_removed_benchmarks(self) -> None:
+        comparisons = compare(_results(old=100, both=100),
+                              _results(both=100, new=100))
+        self.assertEqual(comparisons, [
+            Comparison('both', 100, 100),
+            Comparison('new', None, 100),
+            Comparison('old', 100, None),
+        ])
+        self.assertFalse(any(c.regressed(0) for c in comparisons))
+
+    def test_different_units(self) -> None:
+        with self.assertRaises(ResultsError):
+            compare(_results('ns', a=1), _results('cycles', a=1))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,216 @@
+# Copyright 2022 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Compares pw_benchmark results against stored baselines.
+
+Benchmark binaries write a JSON document through pw_sys_io, so on a device it
+arrives over the UART, possibly mixed with log output. This tool extracts the
+document from captured output, compares the median time per iteration of each
+benchmark with a baseline captured earlier on the same target, and exits with
+an error if any benchmark became slower than the threshold allows.
+
+  out/host_clang_debug/obj/pw_kvs/benchmark/key_value_store_benchmark \
+      > kvs_results.txt
+  python -m pw_benchmark.compare kvs_results.txt \
+      --baseline baselines/host/key_value_store_benchmark.json
+
+Baselines are results documents. Pass --update-baseline to save the current
+results as the new baseline.
+"""
+
+import argparse
+from dataclasses import dataclass
+import json
+from pathlib import Path
+import sys
+from typing import Dict, List, Optional, TextIO
+
+_DEFAULT_THRESHOLD = 0.05
+
+
+class ResultsError(Exception):
+    """Raised when benchmark output cannot be read or compared."""
+
+
+@dataclass(frozen=True)
+class Results:
+    """The results of one run of a benchmark binary."""
+    unit: str
+    ticks_per_second: int
+    benchmarks: Dict[str, dict]
+
+    @classmethod
+    def parse(cls, output: str) -> 'Results':
+        """Parses the JSON document from a benchmark binary's output.
+
+        Lines outside of the document, and lines within it that are not part
+        of it, such as logs written while the benchmarks ran, are ignored.
+        """
+        lines: List[str] = []
+        for line in output.splitlines():
+            line = line.rstrip()
+            if not lines:
+                if line == '{':
+                    lines.append(line)
+            elif line == '}':
+                lines.append(line)
+                break
+            elif line.startswith(('  "', '    {', '  ]')):
+                lines.append(line)
+        else:
+            raise ResultsError('No complete benchmark results were found')
+
+        try:
+            document = json.loads('\n'.join(lines))
+            return cls(document['context']['unit'],
+                       document['context']['ticks_per_second'],
+                       {b['name']: b
+                        for b in document['benchmarks']})
+        except (ValueError, KeyError, TypeError) as error:
+            raise ResultsError(
+                f'Malformed benchmark results: {error}') from error
+
+    def to_json(self) -> str:
+        """Formats the results as the benchmark binaries do."""
+        context = json.dumps({
+            'unit': self.unit,
+            'ticks_per_second': self.ticks_per_second
+        })
+        benchmarks = ',\n'.join(f'    {json.dumps(benchmark)}'
+                                 for benchmark in self.benchmarks.values())
+        return (f'{{\n  "context": {context},\n  "benchmarks": [\n'
+                f'{benchmarks}\n  ]\n}}\n')
+
+
+@dataclass(frozen=True)
+class Comparison:
+    """A benchmark's median time per iteration in the baseline and now.
+
+    Either time is None if the benchmark only appears in one set of results.
+    """
+    name: str
+    baseline: Optional[float]
+    current: Optional[float]
+
+    def change(self) -> Optional[float]:
+        """The relative change in time per iteration; positive is slower."""
+        if not self.baseline or self.current is None:
+            return None
+        return self.current / self.baseline - 1
+
+    def regressed(self, threshold: float) -> bool:
+        change = self.change()
+        return change is not None and change > threshold
+
+
+def compare(baseline: Results, current: Results) -> List[Comparison]:
+    """Compares the median time per iteration of each benchmark."""
+    if baseline.unit != current.unit:
+        raise ResultsError(
+            f'The baseline is in {baseline.unit}, but the results are in '
+            f'{current.unit}; they were likely measured on different targets')
+
+    names = list(current.benchmarks)
+    names += [name for name in baseline.benchmarks if name not in names]
+
+    def median(results: Results, name: str) -> Optional[float]:
+        benchmark = results.benchmarks.get(name)
+        return None if benchmark is None else float(benchmark['median'])
+
+    return [
+        Comparison(name, median(baseline, name), median(current, name))
+        for name in names
+    ]
+
+
+def render(comparisons: List[Comparison], unit: str,
+           threshold: float) -> str:
+    """Formats comparisons as a table."""
+    def time(value: Optional[float]) -> str:
+        return '-' if value is None else f'{value:.3f}'
+
+    rows = [('Benchmark', f'Baseline ({unit})', f'Current ({unit})',
+             'Change', '')]
+    for comparison in comparisons:
+        change = comparison.change()
+        rows.append((
+            comparison.name,
+            time(comparison.baseline),
+            time(comparison.current),
+            '-' if change is None else f'{change:+.1%}',
+            'REGRESSION' if comparison.regressed(threshold) else '',
+        ))
+
+    widths = [max(len(row[i]) for row in rows) for i in range(4)]
+    return '\n'.join('  '.join(
+        [row[0].ljust(widths[0])] +
+        [cell.rjust(width)
+         for cell, width in zip(row[1:4], widths[1:])] + [row[4]]).rstrip()
+                     for row in rows)
+
+
+def _parse_args():
+    """Parses and returns the command line arguments."""
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('results',
+                        type=argparse.FileType('r'),
+                        help='captured benchmark output, or - for stdin')
+    parser.add_argument('-b',
+                        '--baseline',
+                        type=Path,
+                        required=True,
+                        help='the baseline results to compare against')
+    parser.add_argument(
+        '-t',
+        '--threshold',
+        type=float,
+        default=_DEFAULT_THRESHOLD,
+        help=('the largest allowed slowdown as a fraction of the baseline; '
+              'defaults to %(default)s'))
+    parser.add_argument('--update-baseline',
+                        action='store_true',
+                        help='save the results as the new baseline')
+    return parser.parse_args()
+
+
+def main(results: TextIO, baseline: Path, threshold: float,
+         update_baseline: bool) -> int:
+    """Compares results with a baseline; returns 1 if any regressed."""
+    try:
+        current = Results.parse(results.read())
+
+        if update_baseline:
+            baseline.parent.mkdir(parents=True, exist_ok=True)
+            baseline.write_text(current.to_json())
+            print(f'Saved {len(current.benchmarks)} results to {baseline}')
+            return 0
+
+        comparisons = compare(Results.parse(baseline.read_text()), current)
+    except (OSError, ResultsError) as error:
+        print(f'error: {error}', file=sys.stderr)
+        return 2
+
+    print(render(comparisons, current.unit, threshold))
+
+    regressions = [c for c in comparisons if c.regressed(threshold)]
+    if regressions:
+        print(f'{len(regressions)} of {len(comparisons)} benchmarks regressed '
+              f'by more than {threshold:.0%}')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(**vars(_parse_args())))
@@ -20,12 +20,13 @@ import logging
 import os
 import subprocess
 import sys
-from typing import List, Iterable, Optional
+from pathlib import Path
+from typing import Dict, List, Iterable, Optional
 
 import pw_cli.log
 
-from pw_bloat.binary_diff import BinaryDiff
-from pw_bloat import bloat_output
+from pw_bloat.binary_diff import BinaryDiff, DiffSegment
+from pw_bloat import bloat_output, map_file, stack_usage
 
 _LOG = logging.getLogger(__name__)
 
@@ -73,6 +74,15 @@ def parse_args() -> argparse.Namespace:
     parser.add_argument('--source-filter',
                         type=str,
                         help='Bloaty data source filter')
+    parser.add_argument('--memory-report',
+                        action='store_true',
+                        help='Also report RAM per module and stack depth, '
+                        "from the binaries' map files")
+    parser.add_argument('--stack-roots',
+                        type=delimited_list(';'),
+                        default=['main'],
+                        help='Functions from which to measure the stack depth '
+                        'in the memory report')
     parser.add_argument('diff_targets',
                         type=delimited_list(';', 2),
                         nargs='+',
@@ -126,6 +136,50 @@ def run_bloaty(
     return subprocess.check_output(cmd)
 
 
+def _map_file(binary: str) -> Path:
+    """The linker writes the map file next to the binary."""
+    return Path(binary).with_suffix('.map')
+
+
+def _stack_depths(binary: str, roots: Iterable[str]) -> Dict[str, int]:
+    graph = stack_usage.load(_map_file(binary))
+    depths: Dict[str, int] = {}
+    for root in roots:
+        try:
+            depth = graph.stack_depth(root)
+        except KeyError:
+            _LOG.warning('%s: no stack usage information for %s in %s',
+                         sys.argv[0], root, binary)
+            continue
+
+        name = f'stack: {root}'
+        if not depth.bounded:
+            name += ' (lower bound)'
+        depths[name] = depth.bytes
+    return depths
+
+
+def memory_diff(label: str, binary: str, base: str,
+                stack_roots: Iterable[str]) -> BinaryDiff:
+    """Diffs the RAM of each module and the stack depth of two binaries."""
+    diff = BinaryDiff(label)
+
+    before: Dict[str, int] = {}
+    after: Dict[str, int] = {}
+    for sizes, path in ((before, base), (after, binary)):
+        sizes.update((f'RAM: {module}', size)
+                     for module, size in map_file.ram_by_module(
+                         _map_file(path)).items())
+        sizes.update(_stack_depths(path, stack_roots))
+
+    for name in list(after) + [name for name in before if name not in after]:
+        old = before.get(name, 0)
+        new = after.get(name, 0)
+        diff.add_segment(DiffSegment(name, old, new, new - old, 0))
+
+    return diff
+
+
 def main() -> int:
     """Program entry point."""
 
@@ -154,6 +208,7 @@ def main() -> int:
         extra_args.extend(['--source-filter', args.source_filter])
 
     diffs: List[BinaryDiff] = []
+    memory_diffs: List[BinaryDiff] = []
     report = []
 
     for i, binary in enumerate(diff_binaries):
@@ -162,6 +217,11 @@ def main() -> int:
         try:
             output = run_bloaty(binary, args.bloaty_config[i],
                                 base_binaries[i], data_sources, extra_args)
+            if args.memory_report:
+                memory_diffs.append(
+                    memory_diff(binary_name, binary, base_binaries[i],
+                                args.stack_roots))
+
             if not output:
                 continue
 
@@ -178,6 +238,10 @@ def main() -> int:
         except subprocess.CalledProcessError:
             _LOG.error('%s: failed to run diff on %s', sys.argv[0], binary)
             return 1
+        except FileNotFoundError as err:
+            _LOG.error('%s: failed to read the map file of %s: %s',
+                       sys.argv[0], binary, err)
+            return 1
 
     def write_file(filename: str, contents: str) -> None:
         path = os.path.join(args.out_dir, filename)
@@ -193,7 +257,18 @@ def main() -> int:
         report.append(out.diff())
 
         rst = bloat_output.RstOutput(diffs)
-        write_file(f'{args.target}', rst.diff())
+        rst_report = rst.diff()
+
+        if memory_diffs:
+            report.append(
+                bloat_output.TableOutput(
+                    f'{args.title} (RAM and stack)',
+                    memory_diffs,
+                    charset=bloat_output.LineCharset).diff())
+            rst_report += '\n\n' + bloat_output.RstOutput(
+                memory_diffs).diff()
+
+        write_file(f'{args.target}', rst_report)
 
     complete_output = '\n'.join(report) + '\n'
     write_file(f'{args.target}.txt', complete_output)
@@ -0,0 +1,114 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Reads the input sections and files of a GNU ld map file."""
+
+import collections
+from pathlib import Path
+import re
+from typing import Dict, Iterable, List, NamedTuple, Union
+
+# Input sections which take up RAM. The compiler names these sections, so they
+# do not depend on the linker script's output sections.
+_RAM_SECTIONS = re.compile(r'(\.data|\.bss|\.tdata|\.tbss|\.noinit)(\.|$)'
+                           r'|COMMON$')
+
+# An input section, with its address and size on the same line or the next.
+_INPUT_SECTION = re.compile(r'^ (?P<name>[^\s*]\S*)'
+                            r'(?:\s+0x[0-9a-fA-F]+\s+0x(?P<size>[0-9a-fA-F]+)'
+                            r'\s+(?P<file>.+))?$')
+_CONTINUATION = re.compile(r'^\s+0x[0-9a-fA-F]+\s+0x(?P<size>[0-9a-fA-F]+)'
+                           r'\s+(?P<file>\S.*)$')
+
+_MEMORY_MAP = 'Linker script and memory map'
+
+
+class InputSection(NamedTuple):
+    """An input section placed in the linked binary."""
+    name: str
+    size: int
+    file: str  # Object file, or archive(member) for archive members.
+
+
+def _lines_after_header(path: Path) -> Iterable[str]:
+    with path.open() as map_file:
+        for line in map_file:
+            if line.startswith(_MEMORY_MAP):
+                break
+        yield from map_file
+
+
+def input_sections(path: Union[str, Path]) -> List[InputSection]:
+    """Returns the input sections placed in the binary.
+
+    Discarded sections, which are listed before the memory map, are skipped.
+    """
+    sections: List[InputSection] = []
+    pending_name = ''
+
+    for line in _lines_after_header(Path(path)):
+        line = line.rstrip('\n')
+
+        if pending_name:
+            match = _CONTINUATION.match(line)
+            if match:
+                sections.append(
+                    InputSection(pending_name, int(match['size'], 16),
+                                 match['file'].strip()))
+            pending_name = ''
+            continue
+
+        match = _INPUT_SECTION.match(line)
+        if not match:
+            continue
+
+        if match['size'] is None:
+            pending_name = match['name']  # Long names wrap to the next line.
+        else:
+            sections.append(
+                InputSection(match['name'], int(match['size'], 16),
+                             match['file'].strip()))
+
+    return sections
+
+
+def input_files(path: Union[str, Path]) -> List[str]:
+    """Returns the object files with sections placed in the binary."""
+    return list(
+        dict.fromkeys(section.file for section in input_sections(path)))
+
+
+def module_name(file: str) -> str:
+    """Attributes an object file to a module.
+
+    Objects in a GN build are under obj/<module>/, so the module is the
+    directory after obj. Other objects, such as those in toolchain libraries,
+    are attributed to their file or archive name.
+    """
+    archive = file.split('(', 1)[0]
+    parts = Path(archive).parts
+    if 'obj' in parts:
+        index = parts.index('obj')
+        if index + 2 < len(parts):
+            return parts[index + 1]
+    return Path(archive).name
+
+
+def ram_by_module(path: Union[str, Path]) -> Dict[str, int]:
+    """Returns the .data and .bss bytes of each module, largest first."""
+    sizes: Dict[str, int] = collections.defaultdict(int)
+    for section in input_sections(path):
+        if section.size and _RAM_SECTIONS.match(section.name):
+            sizes[module_name(section.file)] += section.size
+
+    return dict(sorted(sizes.items(), key=lambda item: (-item[1], item[0])))
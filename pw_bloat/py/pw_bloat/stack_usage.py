@@ -0,0 +1,234 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Computes worst-case stack depth from GCC's -fcallgraph-info=su output.
+
+Each object compiled with -fcallgraph-info=su has a .ci file next to it, which
+lists the stack frame of each function in the object and the calls it makes.
+The call graphs of the objects linked into a binary are merged, and the
+deepest path from each root function is found.
+
+Some paths cannot be bounded from the call graph alone. Calls through function
+pointers, recursion, and frames sized at run time (alloca or variable-length
+arrays) mark the depth as a lower bound. Calls to functions without stack
+information, such as those in precompiled libraries, count as zero bytes and
+are listed.
+"""
+
+import argparse
+from pathlib import Path
+import re
+import sys
+from typing import (Dict, Iterable, List, NamedTuple, Optional, Set, Tuple,
+                    Union)
+
+from pw_bloat import map_file
+
+_INDIRECT_CALL = '__indirect_call'
+
+_NODE = re.compile(r'^node:\s*{\s*title:\s*"(?P<title>[^"]+)"\s*'
+                   r'label:\s*"(?P<label>[^"]*)"')
+_EDGE = re.compile(r'^edge:\s*{\s*sourcename:\s*"(?P<source>[^"]+)"\s*'
+                   r'targetname:\s*"(?P<target>[^"]+)"')
+_FRAME = re.compile(r'(?P<bytes>\d+) bytes \((?P<kind>[a-z,]+)\)$')
+
+
+class Function(NamedTuple):
+    """A function defined in one of the objects."""
+    name: str  # The demangled declaration
+    location: str
+    frame_bytes: int
+    dynamic: bool  # True if part of the frame is sized at run time
+    calls: Tuple[str, ...]  # Symbol names of the functions called
+
+
+class StackDepth(NamedTuple):
+    """The deepest stack usage from a root function."""
+    root: str
+    bytes: int
+    path: Tuple[str, ...]  # Symbol names from the root to the deepest call
+    bounded: bool  # False if the depth is only a lower bound
+    notes: Tuple[str, ...]  # Why the depth is not bounded
+    unknown: Tuple[str, ...]  # Called functions without stack information
+
+
+class CallGraph:
+    """The merged call graph of the objects linked into a binary."""
+    def __init__(self) -> None:
+        self.functions: Dict[str, Function] = {}
+
+    def add_file(self, path: Union[str, Path]) -> None:
+        """Adds the functions in a .ci file to the graph."""
+        labels: Dict[str, str] = {}
+        calls: Dict[str, List[str]] = {}
+
+        with Path(path).open() as ci_file:
+            for line in ci_file:
+                node = _NODE.match(line)
+                if node:
+                    labels[node['title']] = node['label']
+                    continue
+
+                edge = _EDGE.match(line)
+                if edge:
+                    calls.setdefault(edge['source'], []).append(edge['target'])
+
+        for title, label in labels.items():
+            fields = label.split('\\n')
+            frame = _FRAME.search(fields[-1])
+            if frame is None:  # Declared, but defined elsewhere.
+                continue
+
+            # Functions with internal linkage may share a symbol name with
+            # functions in other objects. Keep the larger of them.
+            function = Function(
+                fields[0], fields[1] if len(fields) > 2 else '',
+                int(frame['bytes']), frame['kind'] == 'dynamic',
+                tuple(calls.get(title, ())))
+            existing = self.functions.get(title)
+            if existing is None or existing.frame_bytes < function.frame_bytes:
+                self.functions[title] = function
+
+    def stack_depth(self, root: str) -> StackDepth:
+        """Finds the deepest path from a function that is not recursive."""
+        notes: Set[str] = set()
+        unknown: Set[str] = set()
+        memo: Dict[str, Tuple[int, Tuple[str, ...]]] = {}
+
+        def visit(name: str, active: Set[str]) -> Tuple[int, Tuple[str, ...]]:
+            if name in memo:
+                return memo[name]
+
+            function = self.functions.get(name)
+            if function is None:
+                if name == _INDIRECT_CALL:
+                    notes.add('indirect calls')
+                else:
+                    unknown.add(name)
+                return 0, ()
+
+            if function.dynamic:
+                notes.add(f'dynamic stack in {function.name}')
+
+            active.add(name)
+            deepest: Tuple[int, Tuple[str, ...]] = (0, ())
+            for call in function.calls:
+                if call in active:
+                    notes.add(f'recursion in {self._name(call)}')
+                    continue
+                deepest = max(deepest, visit(call, active), key=lambda d: d[0])
+            active.remove(name)
+
+            memo[name] = (function.frame_bytes + deepest[0],
+                          (name, ) + deepest[1])
+            return memo[name]
+
+        if root not in self.functions:
+            raise KeyError(f'No stack usage information for {root}')
+
+        depth, path = visit(root, set())
+        return StackDepth(root, depth, path, not notes, tuple(sorted(notes)),
+                          tuple(sorted(unknown)))
+
+    def _name(self, symbol: str) -> str:
+        function = self.functions.get(symbol)
+        return function.name if function else symbol
+
+
+def callgraph_files(objects: Iterable[str],
+                    root: Optional[Path] = None) -> Iterable[Path]:
+    """Finds the .ci files for objects listed in a map file.
+
+    GCC writes a.cc.o's call graph to a.cc.ci. Archive members are looked up
+    in the archive's directory and its parent, where GN places the objects of
+    static libraries.
+    """
+    root = root or Path.cwd()
+
+    for obj in objects:
+        if '(' in obj:
+            archive, member = obj[:-1].split('(', 1)
+            directory = root / Path(archive).parent
+            candidates = [directory, directory.parent]
+            stem = Path(member).stem
+        else:
+            candidates = [(root / obj).parent]
+            stem = Path(obj).stem
+
+        for candidate in candidates:
+            path = candidate / f'{stem}.ci'
+            if path.exists():
+                yield path
+                break
+
+
+def load(map_path: Union[str, Path],
+         root: Optional[Path] = None) -> CallGraph:
+    """Loads the call graph of the objects linked into a binary."""
+    graph = CallGraph()
+    for path in callgraph_files(map_file.input_files(map_path), root):
+        graph.add_file(path)
+    return graph
+
+
+def _parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('map_file',
+                        type=Path,
+                        help='Map file of the binary, written by the linker')
+    parser.add_argument('--root',
+                        dest='roots',
+                        action='append',
+                        help='Function from which to measure the stack depth; '
+                        'may be repeated (default: main)')
+    parser.add_argument('--build-dir',
+                        type=Path,
+                        help='Directory that object paths in the map file are '
+                        'relative to (default: current directory)')
+    return parser.parse_args()
+
+
+def main(map_file: Path, roots: Optional[List[str]],
+         build_dir: Optional[Path]) -> int:
+    graph = load(map_file, build_dir)
+    if not graph.functions:
+        print(f'No .ci files found for {map_file}; compile with '
+              '-fcallgraph-info=su',
+              file=sys.stderr)
+        return 1
+
+    status = 0
+    for root in roots or ['main']:
+        try:
+            depth = graph.stack_depth(root)
+        except KeyError as err:
+            print(err.args[0], file=sys.stderr)
+            status = 1
+            continue
+
+        bound = '' if depth.bounded else ' (lower bound)'
+        print(f'{root}: {depth.bytes} bytes{bound}')
+        for symbol in depth.path:
+            function = graph.functions[symbol]
+            print(f'  {function.frame_bytes:6}  {function.name}  '
+                  f'{function.location}')
+        for note in depth.notes:
+            print(f'  Unbounded: {note}')
+        for symbol in depth.unknown:
+            print(f'  No stack information: {symbol}')
+
+    return status
+
+
+if __name__ == '__main__':
+    sys.exit(main(**vars(_parse_args())))
@@ -56,8 +56,12 @@ Status BlobStore::Init() {
   initialized_ = true;
 
   if (LoadMetadata().ok()) {
-    PW_LOG_DEBUG("BlobStore init - Have valid blob of %u bytes",
-                 static_cast<unsigned>(write_address_));
+    if (flash_erased_) {
+      PW_LOG_DEBUG("BlobStore init - Partition is erased");
+    } else {
+      PW_LOG_DEBUG("BlobStore init - Have valid blob of %u bytes",
+                   static_cast<unsigned>(write_address_));
+    }
     return OkStatus();
   }
 
@@ -72,20 +76,46 @@ Status BlobStore::LoadMetadata() {
   flash_address_ = 0;
   file_name_length_ = 0;
   valid_data_ = false;
+  erased_state_stored_ = false;
+  erased_bytes_ = 0;
+  metadata_version_ = internal::MetadataVersion::kLatest;
+  compression_ = internal::Compression::kNone;
+  compression_block_size_ = 0;
+  uncompressed_size_bytes_ = 0;
 
   BlobMetadataHeader metadata;
   metadata.reset();
 
   // For kVersion1 metadata versions, only the first member of
-  // BlobMetadataHeaderV2 will be populated. If a file name is present,
+  // BlobMetadataHeader will be populated. If a file name is present,
   // kvs_.Get() will return RESOURCE_EXHAUSTED as the file name won't fit in the
   // BlobMetadtataHeader object, which is intended behavior.
-  if (StatusWithSize sws = kvs_.acquire()->Get(
-          MetadataKey(), std::as_writable_bytes(std::span(&metadata, 1)));
-      !sws.ok() && !sws.IsResourceExhausted()) {
+  const StatusWithSize sws = kvs_.acquire()->Get(
+      MetadataKey(), std::as_writable_bytes(std::span(&metadata, 1)));
+  if (!sws.ok() && !sws.IsResourceExhausted()) {
     return Status::NotFound();
   }
 
+  // kVersion2 metadata ends before the compression fields, so any bytes read
+  // into them are the start of the file name.
+  if (metadata.version == internal::MetadataVersion::kVersion2) {
+    metadata.compression = internal::Compression::kNone;
+    metadata.compression_block_size = 0;
+    metadata.uncompressed_size_bytes = 0;
+  }
+
+  // An empty blob is never stored, so a current entry with no data records
+  // that the partition was erased ahead of time (see StoreErasedState()).
+  if (sws.size() == sizeof(metadata) &&
+      metadata.version == internal::MetadataVersion::kLatest &&
+      metadata.v1_metadata.data_size_bytes == 0u) {
+    flash_erased_ = true;
+    erased_state_stored_ = true;
+    erased_bytes_ = partition_.size_bytes();
+    valid_data_ = true;
+    return OkStatus();
+  }
+
   if (!ValidateChecksum(metadata.v1_metadata.data_size_bytes,
                         metadata.v1_metadata.checksum)
            .ok()) {
@@ -97,6 +127,10 @@ Status BlobStore::LoadMetadata() {
   write_address_ = metadata.v1_metadata.data_size_bytes;
   flash_address_ = metadata.v1_metadata.data_size_bytes;
   file_name_length_ = metadata.file_name_length;
+  metadata_version_ = metadata.version;
+  compression_ = metadata.compression;
+  compression_block_size_ = metadata.compression_block_size;
+  uncompressed_size_bytes_ = metadata.uncompressed_size_bytes;
   valid_data_ = true;
 
   return OkStatus();
@@ -142,11 +176,10 @@ StatusWithSize BlobStore::GetFileName(std::span<char> dest) const {
                       : Status::ResourceExhausted();
 
   // Read file name from KVS.
-  constexpr size_t kFileNameOffset = sizeof(BlobMetadataHeader);
   const StatusWithSize kvs_read_sws =
       kvs_.acquire()->Get(MetadataKey(),
                           std::as_writable_bytes(dest.first(bytes_to_read)),
-                          kFileNameOffset);
+                          internal::FileNameOffset(metadata_version_));
   status.Update(kvs_read_sws.status());
   return StatusWithSize(status, kvs_read_sws.size());
 }
@@ -197,8 +230,9 @@ Status BlobStore::Write(ConstByteSpan data) {
     return Status::InvalidArgument();
   }
 
-  if (!EraseIfNeeded().ok()) {
-    return Status::DataLoss();
+  if (Status status = EraseIfNeeded(); !status.ok()) {
+    // An in-progress background erase is not an error; try again later.
+    return status.IsUnavailable() ? status : Status::DataLoss();
   }
 
   // Write in (up to) 3 steps:
@@ -312,8 +346,9 @@ Status BlobStore::Flush() {
   // If there is no buffer there should never be any bytes enqueued.
   PW_DCHECK(!write_buffer_.empty());
 
-  if (!EraseIfNeeded().ok()) {
-    return Status::DataLoss();
+  if (Status status = EraseIfNeeded(); !status.ok()) {
+    // An in-progress background erase is not an error; try again later.
+    return status.IsUnavailable() ? status : Status::DataLoss();
   }
 
   ByteSpan data = std::span(write_buffer_.data(), WriteBufferBytesUsed());
@@ -370,18 +405,75 @@ Status BlobStore::CommitToFlash(ConstByteSpan source, size_t data_bytes) {
     data_bytes = source.size_bytes();
   }
 
+  const kvs::FlashPartition::Address address = flash_address_;
+  if (Status status = PrepareToWrite(address + source.size_bytes());
+      !status.ok()) {
+    valid_data_ = false;
+    return status;
+  }
+
   flash_erased_ = false;
-  StatusWithSize result = partition_.Write(flash_address_, source);
+  Status status = partition_.Write(address, source).status();
   flash_address_ += data_bytes;
   if (checksum_algo_ != nullptr) {
     checksum_algo_->Update(source.first(data_bytes));
   }
 
-  if (!result.status().ok()) {
+  // Verify each chunk as it is committed, so closing the writer does not need
+  // to read the whole blob back from flash.
+  if (status.ok()) {
+    status = VerifyCommittedData(address, source);
+  }
+
+  if (!status.ok()) {
     valid_data_ = false;
   }
 
-  return result.status();
+  return status;
+}
+
+Status BlobStore::PrepareToWrite(kvs::FlashPartition::Address end_address) {
+  if (erased_state_stored_) {
+    const Status status = kvs_.acquire()->Delete(MetadataKey());
+    if (!status.ok() && !status.IsNotFound()) {
+      return Status::Internal();
+    }
+    erased_state_stored_ = false;
+  }
+
+  if (end_address <= erased_bytes_) {
+    return OkStatus();
+  }
+
+  // Erase from the first sector not yet erased through the sector containing
+  // the end of the write.
+  const size_t sector_size = partition_.sector_size_bytes();
+  const size_t first_sector = erased_bytes_ / sector_size;
+  const size_t end_sector = (end_address + sector_size - 1) / sector_size;
+
+  PW_TRY(partition_.Erase(first_sector * sector_size,
+                          end_sector - first_sector));
+  erased_bytes_ = end_sector * sector_size;
+  return OkStatus();
+}
+
+Status BlobStore::VerifyCommittedData(kvs::FlashPartition::Address address,
+                                      ConstByteSpan expected) {
+  std::array<std::byte, kReadBufferSizeBytes> buffer;
+  while (!expected.empty()) {
+    const size_t read_size = std::min(expected.size_bytes(), buffer.size());
+    PW_TRY(partition_.Read(address, std::span(buffer).first(read_size)));
+
+    if (std::memcmp(buffer.data(), expected.data(), read_size) != 0) {
+      PW_LOG_ERROR("Blob data read back from flash address 0x%x did not match",
+                   static_cast<unsigned>(address));
+      return Status::DataLoss();
+    }
+
+    address += read_size;
+    expected = expected.subspan(read_size);
+  }
+  return OkStatus();
 }
 
 // Needs to be in .cc file since PW_CHECK doesn't like being in .h files.
@@ -398,11 +490,19 @@ size_t BlobStore::WriteBufferBytesFree() const {
 }
 
 Status BlobStore::EraseIfNeeded() {
-  if (flash_address_ == 0) {
-    // Always just erase. Erase is smart enough to only erase if needed.
-    return Erase();
+  if (flash_address_ != 0) {
+    return OkStatus();
   }
-  return OkStatus();
+
+  // In incremental mode, sectors are erased as data is committed to them, so
+  // starting a new blob only requires waiting for a background erase, if any.
+  if (erase_mode_ == EraseMode::kIncremental && !async_erase_started_) {
+    valid_data_ = true;
+    return OkStatus();
+  }
+
+  // Always just erase. Erase is smart enough to only erase if needed.
+  return Erase();
 }
 
 StatusWithSize BlobStore::Read(size_t offset, ByteSpan dest) const {
@@ -437,6 +537,19 @@ size_t BlobStore::ReadableDataBytes() const {
 }
 
 Status BlobStore::Erase() {
+  if (async_erase_started_) {
+    if (erase_in_progress_.load(std::memory_order_acquire)) {
+      return Status::Unavailable();
+    }
+    async_erase_started_ = false;
+    PW_TRY(async_erase_status_);
+
+    flash_erased_ = true;
+    erased_bytes_ = partition_.size_bytes();
+    valid_data_ = true;
+    return OkStatus();
+  }
+
   // If already erased our work here is done.
   if (flash_erased_) {
     // The write buffer might already have bytes when this call happens, due to
@@ -458,6 +571,7 @@ Status BlobStore::Erase() {
   PW_TRY(partition_.Erase());
 
   flash_erased_ = true;
+  erased_bytes_ = partition_.size_bytes();
 
   // Blob data is considered valid as soon as the flash is erased. Even though
   // there are 0 bytes written, they are valid.
@@ -465,14 +579,71 @@ Status BlobStore::Erase() {
   return OkStatus();
 }
 
+Status BlobStore::StartErase() {
+  if (flash_erased_ || async_erase_started_) {
+    return OkStatus();
+  }
+
+  // If any writes have been performed, reset the state.
+  if (flash_address_ != 0) {
+    Invalidate().IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  }
+
+  erase_in_progress_.store(true, std::memory_order_relaxed);
+  const Status status = partition_.StartErase(
+      0, partition_.sector_count(), [this](Status result) {
+        async_erase_status_ = result;
+        erase_in_progress_.store(false, std::memory_order_release);
+      });
+  if (!status.ok()) {
+    erase_in_progress_.store(false, std::memory_order_relaxed);
+    return status;
+  }
+
+  async_erase_started_ = true;
+  return OkStatus();
+}
+
+void BlobStore::StoreErasedState() {
+  if (erased_state_stored_ || !flash_erased_) {
+    return;
+  }
+
+  BlobMetadataHeader metadata;
+  metadata.reset();
+  if (const Status status = kvs_.acquire()->Put(
+          MetadataKey(), std::as_bytes(std::span(&metadata, 1)));
+      !status.ok()) {
+    PW_LOG_WARN("Failed to store erased state of blob partition: %s",
+                status.str());
+    return;
+  }
+  erased_state_stored_ = true;
+}
+
 Status BlobStore::Invalidate() {
   // Blob data is considered valid if the flash is erased. Even though
   // there are 0 bytes written, they are valid.
   valid_data_ = flash_erased_;
   ResetChecksum();
+
+  // Written sectors must be erased again for the next blob.
+  if (flash_address_ != 0) {
+    erased_bytes_ = 0;
+  }
   write_address_ = 0;
   flash_address_ = 0;
   file_name_length_ = 0;
+  metadata_version_ = internal::MetadataVersion::kLatest;
+  compression_ = internal::Compression::kNone;
+  compression_block_size_ = 0;
+  uncompressed_size_bytes_ = 0;
+
+  // A stored erased state is still accurate, since nothing was written.
+  if (erased_state_stored_ && flash_erased_) {
+    return OkStatus();
+  }
+  erased_state_stored_ = false;
 
   Status status = kvs_.acquire()->Delete(MetadataKey());
 
@@ -517,7 +688,6 @@ Status BlobStore::CalculateChecksumFromFlash(size_t bytes_to_check) {
   kvs::FlashPartition::Address address = 0;
   const kvs::FlashPartition::Address end = bytes_to_check;
 
-  constexpr size_t kReadBufferSizeBytes = 32;
   std::array<std::byte, kReadBufferSizeBytes> buffer;
   while (address < end) {
     const size_t read_size = std::min(size_t(end - address), buffer.size());
@@ -533,6 +703,33 @@ Status BlobStore::CalculateChecksumFromFlash(size_t bytes_to_check) {
   return OkStatus();
 }
 
+Result<ConstByteSpan> BlobStore::BlobReader::ReadInPlace(
+    size_t max_bytes, ByteSpan fallback_buffer) {
+  PW_DCHECK(open_);
+  if (offset_ >= store_.ReadableDataBytes()) {
+    return Status::OutOfRange();
+  }
+
+  Result<ConstByteSpan> mapped_blob = store_.GetMemoryMappedBlob();
+  if (mapped_blob.ok()) {
+    const size_t available_bytes = store_.ReadableDataBytes() - offset_;
+    ConstByteSpan data = mapped_blob.value().subspan(
+        offset_, std::min(max_bytes, available_bytes));
+    offset_ += data.size_bytes();
+    return data;
+  }
+  if (!mapped_blob.status().IsUnimplemented()) {
+    return mapped_blob.status();
+  }
+
+  // The flash is not memory mapped, so copy the data out instead.
+  ByteSpan dest =
+      fallback_buffer.first(std::min(max_bytes, fallback_buffer.size_bytes()));
+  const StatusWithSize result = DoRead(dest);
+  PW_TRY(result.status());
+  return ConstByteSpan(dest.first(result.size()));
+}
+
 Status BlobStore::BlobWriter::SetFileName(std::string_view file_name) {
   PW_DCHECK(open_);
   PW_DCHECK_NOTNULL(file_name.data());
@@ -581,13 +778,9 @@ Status BlobStore::BlobWriter::WriteMetadata() {
                 std::min(checksum.size(), sizeof(ChecksumValue)));
   }
 
-  // Check the in-memory checksum against the data that was actually committed
-  // to flash.
-  if (!store_.ValidateChecksum(store_.flash_address_, calculated_checksum)
-           .ok()) {
-    PW_CHECK_OK(store_.Invalidate());
-    return Status::DataLoss();
-  }
+  // The in-memory checksum does not need to be checked against flash here.
+  // CommitToFlash() read back and compared every chunk as it was written, and
+  // any mismatch already failed the write.
 
   // Encode the metadata header. This follows the latest struct behind
   // BlobMetadataHeader. Currently, the order is as follows:
@@ -595,6 +788,7 @@ Status BlobStore::BlobWriter::WriteMetadata() {
   // - Encode stored data size.
   // - Encode version magic.
   // - Encode file name size.
+  // - Encode compression, compression block size, and uncompressed size.
   // - File name, if present, is already staged at the end.
   //
   // Open() guarantees the metadata buffer is large enough to fit the metadata
@@ -604,6 +798,9 @@ Status BlobStore::BlobWriter::WriteMetadata() {
   metadata_builder.PutUint32(store_.flash_address_);
   metadata_builder.PutUint32(internal::MetadataVersion::kLatest);
   metadata_builder.PutUint8(store_.file_name_length_);
+  metadata_builder.PutUint8(static_cast<uint8_t>(store_.compression_));
+  metadata_builder.PutUint16(store_.compression_block_size_);
+  metadata_builder.PutUint32(store_.uncompressed_size_bytes_);
   PW_DCHECK_INT_EQ(metadata_builder.size(), sizeof(BlobMetadataHeader));
   PW_DCHECK_OK(metadata_builder.status());
 
@@ -622,6 +819,11 @@ Status BlobStore::BlobWriter::WriteMetadata() {
 
 Status BlobStore::BlobWriter::Close() {
   PW_DCHECK(open_);
+
+  // Leave the writer open so Close can be retried once the erase completes.
+  if (store_.erase_in_progress_.load(std::memory_order_acquire)) {
+    return Status::Unavailable();
+  }
   open_ = false;
 
   // This is a lambda so the BlobWriter will be unconditionally closed even if
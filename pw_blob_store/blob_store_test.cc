@@ -44,6 +44,9 @@ class BlobStoreTest : public ::testing::Test {
     partition_.Erase()
         .IgnoreError();  // TODO(pwbug/387): Handle Status properly
     std::memcpy(flash_.buffer().data(), contents.data(), contents.size());
+
+    // Metadata stored by a previous test no longer describes the flash.
+    kvs::TestKvs().acquire()->Delete(kBlobTitle).IgnoreError();
   }
 
   void InitSourceBufferToRandom(uint64_t seed,
@@ -560,6 +563,207 @@ TEST_F(BlobStoreTest, V1MetadataBackwardsCompatible) {
             reader.ConservativeReadLimit());
 }
 
+TEST_F(BlobStoreTest, V2MetadataWithFileNameBackwardsCompatible) {
+  constexpr size_t kWriteSize = 25;
+  WriteTestBlock(kWriteSize);
+
+  kvs::ChecksumCrc16 checksum;
+  constexpr size_t kBufferSize = 16;
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  EXPECT_EQ(OkStatus(), blob.Init());
+
+  internal::BlobMetadataHeader current_metadata;
+  ASSERT_EQ(OkStatus(),
+            kvs::TestKvs().acquire()->Get(kBlobTitle, &current_metadata));
+
+  // Re-save as V2 metadata, with the file name right after the V2 header.
+  constexpr std::string_view kFileName("old_format.bin");
+  std::array<std::byte, sizeof(internal::BlobMetadataHeaderV2) +
+                            kFileName.size()>
+      entry;
+  internal::BlobMetadataHeaderV2 v2_metadata = {
+      .v1_metadata = current_metadata.v1_metadata,
+      .version = internal::MetadataVersion::kVersion2,
+      .file_name_length = static_cast<uint8_t>(kFileName.size()),
+  };
+  std::memcpy(entry.data(), &v2_metadata, sizeof(v2_metadata));
+  std::memcpy(
+      entry.data() + sizeof(v2_metadata), kFileName.data(), kFileName.size());
+  ASSERT_EQ(OkStatus(), kvs::TestKvs().acquire()->Put(kBlobTitle, entry));
+
+  BlobStoreBuffer<kBufferSize> reloaded_blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  EXPECT_EQ(OkStatus(), reloaded_blob.Init());
+
+  BlobStore::BlobReader reader(reloaded_blob);
+  ASSERT_EQ(OkStatus(), reader.Open());
+  ASSERT_EQ(kWriteSize, reader.ConservativeReadLimit());
+
+  char file_name[32] = {};
+  const StatusWithSize sws = reader.GetFileName(file_name);
+  ASSERT_EQ(OkStatus(), sws.status());
+  EXPECT_EQ(kFileName, std::string_view(file_name, sws.size()));
+}
+
+TEST_F(BlobStoreTest, StartErase_WriteWaitsForErase) {
+  InitSourceBufferToRandom(0x5eed);
+  InitFlashTo(source_buffer_);
+
+  kvs::ChecksumCrc16 checksum;
+  constexpr size_t kBufferSize = 256;
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  EXPECT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriterWithBuffer writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(), writer.StartErase());
+  EXPECT_TRUE(writer.IsErasing());
+
+  // Starting again while the erase is in progress has no effect.
+  EXPECT_EQ(OkStatus(), writer.StartErase());
+
+  ConstByteSpan data = std::span(source_buffer_).first(kBufferSize);
+  EXPECT_EQ(Status::Unavailable(), writer.Write(data));
+  EXPECT_EQ(Status::Unavailable(), writer.Close());
+
+  ASSERT_TRUE(flash_.CompletePendingOperation());
+  EXPECT_FALSE(writer.IsErasing());
+  EXPECT_EQ(std::byte{0xff}, flash_.buffer()[kBlobDataSize - 1]);
+
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  EXPECT_EQ(OkStatus(), writer.Close());
+
+  BlobStore::BlobReader reader(blob);
+  ASSERT_EQ(OkStatus(), reader.Open());
+  EXPECT_EQ(kBufferSize, reader.ConservativeReadLimit());
+  EXPECT_EQ(0, std::memcmp(flash_.buffer().data(), data.data(), kBufferSize));
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+TEST_F(BlobStoreTest, StartErase_AlreadyErased) {
+  kvs::ChecksumCrc16 checksum;
+  constexpr size_t kBufferSize = 256;
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  EXPECT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriterWithBuffer writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(), writer.Erase());
+
+  EXPECT_EQ(OkStatus(), writer.StartErase());
+  EXPECT_FALSE(writer.IsErasing());
+  EXPECT_FALSE(flash_.operation_pending());
+  EXPECT_EQ(OkStatus(), writer.Close());
+}
+
+TEST_F(BlobStoreTest, IncrementalErase_ErasesSectorsAsWritten) {
+  InitSourceBufferToRandom(0x1234);
+  InitFlashTo(source_buffer_);
+  const std::byte last_byte = flash_.buffer()[kBlobDataSize - 1];
+
+  kvs::ChecksumCrc16 checksum;
+  constexpr size_t kBufferSize = 256;
+  BlobStoreBuffer<kBufferSize> blob(kBlobTitle,
+                                    partition_,
+                                    &checksum,
+                                    kvs::TestKvs(),
+                                    kBufferSize,
+                                    BlobStore::EraseMode::kIncremental);
+  EXPECT_EQ(OkStatus(), blob.Init());
+
+  InitSourceBufferToRandom(0x5678);
+  ConstByteSpan data = source_buffer_;
+
+  BlobStore::BlobWriterWithBuffer writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(), writer.Write(data.first(kBufferSize)));
+
+  // Only the first sector was erased and written.
+  EXPECT_EQ(std::byte{0xff}, flash_.buffer()[kSectorSize - 1]);
+  EXPECT_EQ(last_byte, flash_.buffer()[kBlobDataSize - 1]);
+
+  ASSERT_EQ(OkStatus(), writer.Write(data.subspan(kBufferSize)));
+  EXPECT_EQ(OkStatus(), writer.Close());
+
+  VerifyFlash(flash_.buffer());
+
+  BlobStore::BlobReader reader(blob);
+  ASSERT_EQ(OkStatus(), reader.Open());
+  EXPECT_EQ(kBlobDataSize, reader.ConservativeReadLimit());
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+TEST_F(BlobStoreTest, IncrementalErase_RewriteErasesAgain) {
+  InitSourceBufferToRandom(0x1234);
+  WriteTestBlock();
+
+  kvs::ChecksumCrc16 checksum;
+  constexpr size_t kBufferSize = 256;
+  BlobStoreBuffer<kBufferSize> blob(kBlobTitle,
+                                    partition_,
+                                    &checksum,
+                                    kvs::TestKvs(),
+                                    kBufferSize,
+                                    BlobStore::EraseMode::kIncremental);
+  EXPECT_EQ(OkStatus(), blob.Init());
+
+  InitSourceBufferToFill('a', kBufferSize);
+
+  BlobStore::BlobWriterWithBuffer writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(),
+            writer.Write(std::span(source_buffer_).first(kBufferSize)));
+  EXPECT_EQ(OkStatus(), writer.Close());
+
+  VerifyFlash(flash_.buffer().first(kSectorSize));
+}
+
+TEST_F(BlobStoreTest, Erase_StateSurvivesReinit) {
+  kvs::ChecksumCrc16 checksum;
+  constexpr size_t kBufferSize = 256;
+  {
+    BlobStoreBuffer<kBufferSize> blob(
+        kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+    EXPECT_EQ(OkStatus(), blob.Init());
+
+    BlobStore::BlobWriterWithBuffer writer(blob);
+    ASSERT_EQ(OkStatus(), writer.Open());
+    ASSERT_EQ(OkStatus(), writer.Erase());
+    EXPECT_EQ(OkStatus(), writer.Close());
+  }
+
+  // Mark the end of the flash, which a new erase would clear.
+  flash_.buffer()[kBlobDataSize - 1] = std::byte{0x42};
+
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  EXPECT_EQ(OkStatus(), blob.Init());
+
+  InitSourceBufferToFill('b', kBufferSize);
+  ConstByteSpan data = std::span(source_buffer_).first(kBufferSize);
+
+  BlobStore::BlobWriterWithBuffer writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+
+  // Once data is written, the erased state is no longer stored.
+  std::array<std::byte, 64> metadata;
+  EXPECT_EQ(Status::NotFound(),
+            kvs::TestKvs().acquire()->Get(kBlobTitle, metadata).status());
+  EXPECT_EQ(OkStatus(), writer.Close());
+
+  EXPECT_EQ(std::byte{0x42}, flash_.buffer()[kBlobDataSize - 1]);
+
+  BlobStore::BlobReader reader(blob);
+  ASSERT_EQ(OkStatus(), reader.Open());
+  EXPECT_EQ(kBufferSize, reader.ConservativeReadLimit());
+  EXPECT_EQ(0, std::memcmp(flash_.buffer().data(), data.data(), kBufferSize));
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
 TEST_F(BlobStoreTest, Discard) {
   InitSourceBufferToRandom(0x8675309);
   WriteTestBlock();
@@ -791,5 +995,161 @@ TEST_F(BlobStoreTest, MultipleWrites) {
   WriteTestBlock();
 }
 
+TEST_F(BlobStoreTest, ReadInPlace_MemoryMapped) {
+  InitSourceBufferToRandom(0x7701);
+  WriteTestBlock();
+
+  kvs::ChecksumCrc16 checksum;
+  constexpr size_t kBufferSize = 16;
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobReader reader(blob);
+  ASSERT_EQ(OkStatus(), reader.Open(100));
+
+  // The data comes straight from flash, so it is not limited by the buffer.
+  std::array<std::byte, 1> unused;
+  Result<ConstByteSpan> result = reader.ReadInPlace(1000, unused);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(flash_.buffer().data() + 100, result.value().data());
+  EXPECT_EQ(1000u, result.value().size());
+
+  result = reader.ReadInPlace(kBlobDataSize, unused);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(kBlobDataSize - 1100, result.value().size());
+  VerifyFlash(result.value(), 1100);
+
+  EXPECT_EQ(Status::OutOfRange(),
+            reader.ReadInPlace(kBlobDataSize, unused).status());
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+TEST_F(BlobStoreTest, ReadInPlace_NotMemoryMapped_Copies) {
+  InitSourceBufferToRandom(0x7702);
+  WriteTestBlock();
+
+  // Same flash contents, but without memory-mapped access.
+  class UnmappedFlash : public kvs::FakeFlashMemory {
+   public:
+    UnmappedFlash(std::span<std::byte> buffer)
+        : kvs::FakeFlashMemory(
+              buffer, kSectorSize, kSectorCount, kFlashAlignment) {}
+
+    std::byte* FlashAddressToMcuAddress(Address) const override {
+      return nullptr;
+    }
+  } unmapped_flash(flash_.buffer());
+  kvs::FlashPartition unmapped_partition(&unmapped_flash);
+
+  kvs::ChecksumCrc16 checksum;
+  constexpr size_t kBufferSize = 16;
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, unmapped_partition, &checksum, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobReader reader(blob);
+  ASSERT_EQ(OkStatus(), reader.Open());
+  ASSERT_EQ(Status::Unimplemented(), reader.GetMemoryMappedBlob().status());
+
+  std::array<std::byte, 32> buffer;
+  Result<ConstByteSpan> result = reader.ReadInPlace(1000, buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(buffer.data(), result.value().data());
+  EXPECT_EQ(buffer.size(), result.value().size());
+  VerifyFlash(result.value());
+
+  result = reader.ReadInPlace(8, buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(8u, result.value().size());
+  VerifyFlash(result.value(), buffer.size());
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+// FlashPartition that counts bytes read and can corrupt data after it is
+// written, as a failing flash part might.
+class VerifyTestPartition : public kvs::FlashPartition {
+ public:
+  using kvs::FlashPartition::Read;
+
+  VerifyTestPartition(kvs::FakeFlashMemory& flash)
+      : kvs::FlashPartition(&flash), flash_(flash) {}
+
+  StatusWithSize Read(Address address, std::span<std::byte> output) override {
+    bytes_read += output.size();
+    return kvs::FlashPartition::Read(address, output);
+  }
+
+  StatusWithSize Write(Address address,
+                       std::span<const std::byte> data) override {
+    StatusWithSize result = kvs::FlashPartition::Write(address, data);
+    if (corrupt_writes && !data.empty()) {
+      flash_.buffer()[address] ^= std::byte{0x01};
+    }
+    return result;
+  }
+
+  size_t bytes_read = 0;
+  bool corrupt_writes = false;
+
+ private:
+  kvs::FakeFlashMemory& flash_;
+};
+
+TEST(BlobStoreVerify, Close_DoesNotReadBackWholeBlob) {
+  constexpr size_t kBufferSize = 64;
+  kvs::FakeFlashMemoryBuffer<1024, 4> flash(1);
+  VerifyTestPartition partition(flash);
+  kvs::ChecksumCrc16 checksum;
+
+  std::array<std::byte, 4 * 1024> data;
+  random::XorShiftStarRng64 rng(0x5eed);
+  ASSERT_EQ(OkStatus(), rng.Get(data).status());
+
+  BlobStoreBuffer<kBufferSize> blob(
+      "Blob", partition, &checksum, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriterWithBuffer writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(), writer.Write(std::span(data).first(data.size() - 1)));
+  partition.bytes_read = 0;
+  ASSERT_EQ(OkStatus(), writer.Close());
+
+  // Only the final partial chunk is read back when the writer closes.
+  EXPECT_LE(partition.bytes_read, kBufferSize);
+
+  // The blob is still valid after reinitializing, which checks the checksum.
+  BlobStoreBuffer<kBufferSize> reinit(
+      "Blob", partition, &checksum, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), reinit.Init());
+  BlobStore::BlobReader reader(reinit);
+  ASSERT_EQ(OkStatus(), reader.Open());
+  EXPECT_EQ(data.size() - 1, reader.ConservativeReadLimit());
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+TEST(BlobStoreVerify, Write_CorruptedFlash_DataLoss) {
+  constexpr size_t kBufferSize = 64;
+  kvs::FakeFlashMemoryBuffer<1024, 4> flash(1);
+  VerifyTestPartition partition(flash);
+  kvs::ChecksumCrc16 checksum;
+
+  std::array<std::byte, 2 * kBufferSize> data{};
+
+  BlobStoreBuffer<kBufferSize> blob(
+      "Blob", partition, &checksum, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriterWithBuffer writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  partition.corrupt_writes = true;
+  EXPECT_EQ(Status::DataLoss(), writer.Write(data));
+  EXPECT_EQ(Status::DataLoss(), writer.Close());
+
+  BlobStore::BlobReader reader(blob);
+  EXPECT_EQ(Status::FailedPrecondition(), reader.Open());
+}
+
 }  // namespace
 }  // namespace pw::blob_store
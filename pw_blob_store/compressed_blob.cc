@@ -0,0 +1,502 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_blob_store/compressed_blob.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "pw_assert/check.h"
+#include "pw_blob_store/internal/metadata_format.h"
+#include "pw_bytes/endian.h"
+#include "pw_status/try.h"
+
+namespace pw::blob_store {
+namespace {
+
+constexpr size_t kBlockHeaderSize = sizeof(uint16_t);
+constexpr uint16_t kStoredBlockFlag = 0x8000;
+
+// Size of the buffers used to write and read compressed data in pieces.
+constexpr size_t kChunkSizeBytes = 32;
+
+// The compressed data of a block is a series of tokens:
+//
+//   0LLLLLLL                 L + 1 literal bytes follow.
+//   1MMMOOOO OOOOOOOO        Copy M + 3 bytes from O + 1 bytes back.
+//   1111OOOO OOOOOOOO EEEEEEEE
+//                            M = 7: copy E + 10 bytes from O + 1 bytes back.
+//
+// Copies only refer to earlier data in the same block.
+constexpr size_t kMaxLiteralRun = 128;
+constexpr size_t kMinMatch = 3;
+constexpr size_t kLongMatchCode = 7;
+constexpr size_t kMaxMatch = kMinMatch + kLongMatchCode + 255;
+
+static_assert(kMaxCompressionBlockSizeBytes <= 4096,
+              "Copy distances are 12 bits");
+
+size_t Hash(const std::byte* data) {
+  const uint32_t value = std::to_integer<uint32_t>(data[0]) |
+                         std::to_integer<uint32_t>(data[1]) << 8 |
+                         std::to_integer<uint32_t>(data[2]) << 16;
+  return (value * 2654435761u) >> 24;
+}
+
+// Counts the compressed size of a block without writing it.
+class SizeCounter {
+ public:
+  void Put(std::byte) { size_ += 1; }
+  void Put(ConstByteSpan data) { size_ += data.size(); }
+
+  size_t size() const { return size_; }
+
+ private:
+  size_t size_ = 0;
+};
+
+// Writes compressed data to the blob in chunks.
+class BufferedOutput {
+ public:
+  explicit BufferedOutput(stream::Writer& writer)
+      : writer_(writer), length_(0) {}
+
+  void Put(std::byte b) {
+    if (length_ == buffer_.size()) {
+      Flush().IgnoreError();  // The status is returned by the final Flush().
+    }
+    buffer_[length_++] = b;
+  }
+
+  void Put(ConstByteSpan data) {
+    for (std::byte b : data) {
+      Put(b);
+    }
+  }
+
+  Status Flush() {
+    if (status_.ok() && length_ != 0) {
+      status_ = writer_.Write(std::span(buffer_).first(length_));
+    }
+    length_ = 0;
+    return status_;
+  }
+
+ private:
+  stream::Writer& writer_;
+  std::array<std::byte, kChunkSizeBytes> buffer_;
+  size_t length_;
+  Status status_;
+};
+
+template <typename Output>
+void PutLiterals(ConstByteSpan literals, Output& output) {
+  while (!literals.empty()) {
+    const size_t run = std::min(literals.size(), kMaxLiteralRun);
+    output.Put(static_cast<std::byte>(run - 1));
+    output.Put(literals.first(run));
+    literals = literals.subspan(run);
+  }
+}
+
+template <typename Output>
+void PutMatch(size_t distance, size_t length, Output& output) {
+  const size_t offset = distance - 1;
+  const size_t code = std::min(length - kMinMatch, kLongMatchCode);
+  output.Put(static_cast<std::byte>(0x80 | code << 4 | offset >> 8));
+  output.Put(static_cast<std::byte>(offset & 0xff));
+  if (code == kLongMatchCode) {
+    output.Put(static_cast<std::byte>(length - kMinMatch - kLongMatchCode));
+  }
+}
+
+// Greedily replaces repeated data with copies of its last occurrence found
+// through the hash table. The output only depends on the block, so the block
+// may be compressed once to find its size and again to write it.
+template <typename Output>
+void CompressBlock(ConstByteSpan block,
+                   std::span<uint16_t> hash_table,
+                   Output& output) {
+  std::fill(hash_table.begin(), hash_table.end(), uint16_t{0});
+
+  size_t literals_start = 0;
+  size_t position = 0;
+  while (position + kMinMatch <= block.size()) {
+    uint16_t& entry = hash_table[Hash(&block[position])];
+    const size_t candidate = entry;
+    entry = static_cast<uint16_t>(position + 1);
+
+    size_t length = 0;
+    if (candidate != 0) {
+      const size_t max_length = std::min(block.size() - position, kMaxMatch);
+      const std::byte* const match = &block[candidate - 1];
+      while (length < max_length && match[length] == block[position + length]) {
+        length += 1;
+      }
+    }
+    if (length < kMinMatch) {
+      position += 1;
+      continue;
+    }
+
+    PutLiterals(block.subspan(literals_start, position - literals_start),
+                output);
+    PutMatch(position + 1 - candidate, length, output);
+
+    // Index the copied data, so later data may refer to it too.
+    for (size_t i = position + 1;
+         i < position + length && i + kMinMatch <= block.size();
+         ++i) {
+      hash_table[Hash(&block[i])] = static_cast<uint16_t>(i + 1);
+    }
+    position += length;
+    literals_start = position;
+  }
+  PutLiterals(block.subspan(literals_start), output);
+}
+
+// Reads the compressed data of a block in chunks.
+class BlockInput {
+ public:
+  BlockInput(stream::Reader& reader, size_t size_bytes)
+      : reader_(reader), remaining_(size_bytes), position_(0), length_(0) {}
+
+  bool empty() const { return remaining_ == 0 && position_ == length_; }
+
+  Status Get(std::byte& b) {
+    if (position_ == length_) {
+      PW_TRY(Fill());
+    }
+    b = buffer_[position_++];
+    return OkStatus();
+  }
+
+ private:
+  Status Fill() {
+    if (remaining_ == 0) {
+      return Status::DataLoss();
+    }
+    const size_t chunk = std::min(remaining_, buffer_.size());
+    const Result<ByteSpan> result =
+        reader_.Read(std::span(buffer_).first(chunk));
+    if (!result.ok() || result.value().size() != chunk) {
+      return Status::DataLoss();
+    }
+    remaining_ -= chunk;
+    position_ = 0;
+    length_ = chunk;
+    return OkStatus();
+  }
+
+  stream::Reader& reader_;
+  std::array<std::byte, kChunkSizeBytes> buffer_;
+  size_t remaining_;
+  size_t position_;
+  size_t length_;
+};
+
+// Decompresses a block, which must fill output exactly.
+Status DecompressBlock(BlockInput& input, ByteSpan output) {
+  size_t size = 0;
+  while (!input.empty()) {
+    std::byte token;
+    PW_TRY(input.Get(token));
+    const size_t value = std::to_integer<size_t>(token);
+
+    if (value < 0x80) {
+      const size_t run = value + 1;
+      if (run > output.size() - size) {
+        return Status::DataLoss();
+      }
+      for (size_t i = 0; i < run; ++i) {
+        PW_TRY(input.Get(output[size++]));
+      }
+      continue;
+    }
+
+    std::byte offset_low;
+    PW_TRY(input.Get(offset_low));
+    const size_t distance =
+        ((value & 0xf) << 8 | std::to_integer<size_t>(offset_low)) + 1;
+    const size_t code = (value >> 4) & 0x7;
+    size_t length = kMinMatch + code;
+    if (code == kLongMatchCode) {
+      std::byte extra;
+      PW_TRY(input.Get(extra));
+      length += std::to_integer<size_t>(extra);
+    }
+    if (distance > size || length > output.size() - size) {
+      return Status::DataLoss();
+    }
+
+    // Copy byte by byte, since the copy may overlap the data it produces.
+    for (size_t i = 0; i < length; ++i, ++size) {
+      output[size] = output[size - distance];
+    }
+  }
+  return size == output.size() ? OkStatus() : Status::DataLoss();
+}
+
+}  // namespace
+
+CompressedBlobWriter::CompressedBlobWriter(BlobStore::BlobWriter& writer,
+                                           ByteSpan block_buffer)
+    : writer_(writer),
+      block_buffer_(block_buffer),
+      block_bytes_(0),
+      uncompressed_size_bytes_(0),
+      hash_table_{} {
+  PW_CHECK_UINT_GT(block_buffer.size(), 0);
+  PW_CHECK_UINT_LE(block_buffer.size(), kMaxCompressionBlockSizeBytes);
+}
+
+Status CompressedBlobWriter::Open() {
+  PW_TRY(writer_.Open());
+  block_bytes_ = 0;
+  uncompressed_size_bytes_ = 0;
+  return OkStatus();
+}
+
+Status CompressedBlobWriter::Close() {
+  // Leave the writer open so Close can be retried once the erase completes.
+  if (writer_.IsErasing()) {
+    return Status::Unavailable();
+  }
+
+  if (block_bytes_ != 0) {
+    if (const Status status = WriteBlock(); !status.ok()) {
+      writer_.Discard().IgnoreError();
+      writer_.Close().IgnoreError();
+      return Status::DataLoss();
+    }
+  }
+
+  // An empty blob is stored as it is, without compression.
+  if (uncompressed_size_bytes_ != 0) {
+    BlobStore& store = writer_.store_;
+    store.compression_ = internal::Compression::kBlockLz;
+    store.compression_block_size_ =
+        static_cast<uint16_t>(block_buffer_.size());
+    store.uncompressed_size_bytes_ = uncompressed_size_bytes_;
+  }
+  return writer_.Close();
+}
+
+Status CompressedBlobWriter::Discard() {
+  block_bytes_ = 0;
+  uncompressed_size_bytes_ = 0;
+  return writer_.Discard();
+}
+
+Status CompressedBlobWriter::DoWrite(ConstByteSpan data) {
+  if (writer_.IsErasing()) {
+    return Status::Unavailable();
+  }
+
+  while (!data.empty()) {
+    const size_t bytes_to_copy =
+        std::min(data.size(), block_buffer_.size() - block_bytes_);
+    std::memcpy(
+        block_buffer_.data() + block_bytes_, data.data(), bytes_to_copy);
+    block_bytes_ += bytes_to_copy;
+    uncompressed_size_bytes_ += bytes_to_copy;
+    data = data.subspan(bytes_to_copy);
+
+    if (block_bytes_ == block_buffer_.size()) {
+      PW_TRY(WriteBlock());
+    }
+  }
+  return OkStatus();
+}
+
+size_t CompressedBlobWriter::ConservativeLimit(LimitType limit) const {
+  if (limit != LimitType::kWrite) {
+    return 0;
+  }
+
+  // Every block, including the buffered one, may be stored uncompressed.
+  const size_t available = writer_.ConservativeWriteLimit();
+  const size_t stored_block_size = block_buffer_.size() + kBlockHeaderSize;
+  size_t total = available / stored_block_size * block_buffer_.size();
+  const size_t remainder = available % stored_block_size;
+  if (remainder > kBlockHeaderSize) {
+    total += remainder - kBlockHeaderSize;
+  }
+  return total > block_bytes_ ? total - block_bytes_ : 0;
+}
+
+Status CompressedBlobWriter::WriteBlock() {
+  const ConstByteSpan block = block_buffer_.first(block_bytes_);
+  block_bytes_ = 0;
+
+  SizeCounter counter;
+  CompressBlock(block, hash_table_, counter);
+
+  // Store data that does not compress as it is.
+  const bool stored = counter.size() >= block.size();
+  const uint16_t header =
+      stored ? static_cast<uint16_t>(kStoredBlockFlag | block.size())
+             : static_cast<uint16_t>(counter.size());
+  PW_TRY(writer_.Write(bytes::CopyInOrder(std::endian::little, header)));
+
+  if (stored) {
+    return writer_.Write(block);
+  }
+  BufferedOutput output(writer_);
+  CompressBlock(block, hash_table_, output);
+  return output.Flush();
+}
+
+Status CompressedBlobReader::Open(size_t offset) {
+  PW_TRY(reader_.Open());
+
+  Status status = OkStatus();
+  switch (store_.compression_) {
+    case internal::Compression::kNone:
+      compressed_ = false;
+      size_bytes_ = store_.ReadableDataBytes();
+      block_size_bytes_ = 0;
+      break;
+    case internal::Compression::kBlockLz:
+      compressed_ = true;
+      size_bytes_ = store_.uncompressed_size_bytes_;
+      block_size_bytes_ = store_.compression_block_size_;
+      if (block_size_bytes_ == 0 || size_bytes_ == 0) {
+        status = Status::DataLoss();
+      } else if (block_buffer_.size() < block_size_bytes_) {
+        status = Status::ResourceExhausted();
+      }
+      break;
+    default:
+      status = Status::Unimplemented();
+  }
+  if (status.ok() && offset >= size_bytes_) {
+    status = Status::InvalidArgument();
+  }
+  if (!status.ok()) {
+    reader_.Close().IgnoreError();
+    return status;
+  }
+
+  position_ = offset;
+  block_index_ = kNoBlock;
+  block_length_ = 0;
+  next_block_index_ = 0;
+  next_block_address_ = 0;
+  return OkStatus();
+}
+
+StatusWithSize CompressedBlobReader::DoRead(ByteSpan dest) {
+  PW_DASSERT(reader_.IsOpen());
+  if (position_ >= size_bytes_) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  if (!compressed_) {
+    const size_t bytes_to_read = std::min(dest.size(), size_bytes_ - position_);
+    PW_TRY_WITH_SIZE(ReadStored(position_, dest.first(bytes_to_read)));
+    position_ += bytes_to_read;
+    return StatusWithSize(bytes_to_read);
+  }
+
+  size_t bytes_read = 0;
+  while (bytes_read < dest.size() && position_ < size_bytes_) {
+    const size_t index = position_ / block_size_bytes_;
+    if (index != block_index_) {
+      if (const Status status = LoadBlock(index); !status.ok()) {
+        return StatusWithSize(status, bytes_read);
+      }
+    }
+
+    const size_t block_offset = position_ - index * block_size_bytes_;
+    const size_t bytes_to_copy =
+        std::min(dest.size() - bytes_read, block_length_ - block_offset);
+    std::memcpy(dest.data() + bytes_read,
+                block_buffer_.data() + block_offset,
+                bytes_to_copy);
+    bytes_read += bytes_to_copy;
+    position_ += bytes_to_copy;
+  }
+  return StatusWithSize(bytes_read);
+}
+
+Status CompressedBlobReader::DoSeek(ssize_t offset, Whence origin) {
+  PW_DASSERT(reader_.IsOpen());
+  // Open ensures that size_bytes_ > 0.
+  return CalculateSeek(offset, origin, size_bytes_ - 1, position_);
+}
+
+Status CompressedBlobReader::LoadBlock(size_t index) {
+  // Block headers are only linked forwards, so go back to the first block.
+  if (index < next_block_index_) {
+    next_block_index_ = 0;
+    next_block_address_ = 0;
+  }
+
+  std::array<std::byte, kBlockHeaderSize> header_bytes;
+  uint16_t header;
+  while (true) {
+    PW_TRY(ReadStored(next_block_address_, header_bytes));
+    header = bytes::ReadInOrder<uint16_t>(std::endian::little, header_bytes);
+    if (next_block_index_ == index) {
+      break;
+    }
+    next_block_address_ +=
+        kBlockHeaderSize + (header & static_cast<uint16_t>(~kStoredBlockFlag));
+    next_block_index_ += 1;
+  }
+
+  const size_t data_address = next_block_address_ + kBlockHeaderSize;
+  const size_t data_size = header & static_cast<uint16_t>(~kStoredBlockFlag);
+  block_index_ = kNoBlock;
+  block_length_ =
+      std::min(block_size_bytes_, size_bytes_ - index * block_size_bytes_);
+  const ByteSpan block = block_buffer_.first(block_length_);
+
+  if ((header & kStoredBlockFlag) != 0) {
+    if (data_size != block.size()) {
+      return Status::DataLoss();
+    }
+    PW_TRY(ReadStored(data_address, block));
+  } else {
+    PW_TRY(reader_.Seek(data_address));
+    BlockInput input(reader_, data_size);
+    PW_TRY(DecompressBlock(input, block));
+  }
+
+  block_index_ = index;
+  next_block_index_ = index + 1;
+  next_block_address_ = data_address + data_size;
+  return OkStatus();
+}
+
+Status CompressedBlobReader::ReadStored(size_t address, ByteSpan dest) {
+  if (dest.empty()) {
+    return OkStatus();
+  }
+  if (address >= store_.ReadableDataBytes() ||
+      dest.size() > store_.ReadableDataBytes() - address) {
+    return Status::DataLoss();
+  }
+  PW_TRY(reader_.Seek(address));
+  const Result<ByteSpan> result = reader_.Read(dest);
+  if (!result.ok()) {
+    return result.status();
+  }
+  return result.value().size() == dest.size() ? OkStatus()
+                                              : Status::DataLoss();
+}
+
+}  // namespace pw::blob_store
@@ -0,0 +1,239 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_blob_store/compressed_blob.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_blob_store/blob_store.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/test_key_value_store.h"
+#include "pw_random/xor_shift.h"
+
+namespace pw::blob_store {
+namespace {
+
+constexpr std::string_view kBlobTitle = "CompressedBlob";
+constexpr size_t kBlockSize = 256;
+
+class CompressedBlobTest : public ::testing::Test {
+ protected:
+  CompressedBlobTest()
+      : flash_(kFlashAlignment),
+        partition_(&flash_),
+        blob_(kBlobTitle,
+              partition_,
+              &checksum_,
+              kvs::TestKvs(),
+              kFlashWriteSize) {}
+
+  void SetUp() override {
+    partition_.Erase().IgnoreError();
+    kvs::TestKvs().acquire()->Delete(kBlobTitle).IgnoreError();
+    ASSERT_EQ(OkStatus(), blob_.Init());
+  }
+
+  // Log-like text, which compresses well.
+  void InitSourceToText() {
+    for (size_t i = 0; i < source_.size();) {
+      char line[64];
+      const int length = std::snprintf(line,
+                                       sizeof(line),
+                                       "[%06u] INF sensor: temp=%u mV=%u\n",
+                                       static_cast<unsigned>(i),
+                                       static_cast<unsigned>(i % 37),
+                                       static_cast<unsigned>(3300 - i % 11));
+      const size_t to_copy =
+          std::min(static_cast<size_t>(length), source_.size() - i);
+      std::memcpy(&source_[i], line, to_copy);
+      i += to_copy;
+    }
+  }
+
+  void InitSourceToRandom(uint64_t seed) {
+    random::XorShiftStarRng64 rng(seed);
+    rng.Get(source_).IgnoreError();
+  }
+
+  void WriteCompressed(ConstByteSpan data) {
+    BlobStore::BlobWriterWithBuffer<16> blob_writer(blob_);
+    CompressedBlobWriter writer(blob_writer, block_buffer_);
+    ASSERT_EQ(OkStatus(), writer.Open());
+    ASSERT_EQ(OkStatus(), writer.SetFileName("archive.log"));
+
+    // Write in pieces which do not line up with the blocks.
+    while (!data.empty()) {
+      const size_t write_size = std::min(data.size(), size_t{300});
+      ASSERT_EQ(OkStatus(), writer.Write(data.first(write_size)));
+      data = data.subspan(write_size);
+    }
+    EXPECT_EQ(source_.size(), writer.CurrentSizeBytes());
+    ASSERT_EQ(OkStatus(), writer.Close());
+  }
+
+  size_t StoredSizeBytes() {
+    BlobStore::BlobReader reader(blob_);
+    EXPECT_EQ(OkStatus(), reader.Open());
+    return reader.ConservativeReadLimit();
+  }
+
+  void VerifyRead(CompressedBlobReader& reader, size_t offset, size_t size) {
+    std::array<std::byte, 400> buffer;
+    ASSERT_LE(size, buffer.size());
+    ASSERT_EQ(offset, reader.Tell());
+    const Result<ByteSpan> result = reader.Read(std::span(buffer).first(size));
+    ASSERT_EQ(OkStatus(), result.status());
+    ASSERT_EQ(size, result.value().size());
+    EXPECT_EQ(0, std::memcmp(&source_[offset], buffer.data(), size));
+  }
+
+  static constexpr size_t kFlashAlignment = 16;
+  static constexpr size_t kFlashWriteSize = 64;
+  static constexpr size_t kSectorSize = 1024;
+  static constexpr size_t kSectorCount = 4;
+
+  kvs::FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash_;
+  kvs::FlashPartition partition_;
+  kvs::ChecksumCrc16 checksum_;
+  BlobStoreBuffer<kFlashWriteSize> blob_;
+  std::array<std::byte, kBlockSize> block_buffer_;
+  std::array<std::byte, 3000> source_;
+};
+
+TEST_F(CompressedBlobTest, CompressibleData_RoundTrips) {
+  InitSourceToText();
+  WriteCompressed(source_);
+
+  // The text should take well under half of its size.
+  EXPECT_LT(StoredSizeBytes(), source_.size() / 2);
+
+  CompressedBlobReader reader(blob_, block_buffer_);
+  ASSERT_EQ(OkStatus(), reader.Open());
+  EXPECT_TRUE(reader.IsCompressed());
+  EXPECT_EQ(source_.size(), reader.UncompressedSizeBytes());
+  EXPECT_EQ(source_.size(), reader.ConservativeReadLimit());
+
+  for (size_t offset = 0; offset < source_.size(); offset += 400) {
+    VerifyRead(reader, offset, std::min(size_t{400}, source_.size() - offset));
+  }
+  EXPECT_EQ(0u, reader.ConservativeReadLimit());
+  std::byte extra;
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(&extra, 1).status());
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+TEST_F(CompressedBlobTest, IncompressibleData_StoredWithBlockHeaders) {
+  InitSourceToRandom(0x5eed);
+  WriteCompressed(source_);
+
+  // Each block is stored as it is, after its 2-byte header.
+  constexpr size_t kBlocks = (sizeof(source_) + kBlockSize - 1) / kBlockSize;
+  EXPECT_EQ(source_.size() + 2 * kBlocks, StoredSizeBytes());
+
+  CompressedBlobReader reader(blob_, block_buffer_);
+  ASSERT_EQ(OkStatus(), reader.Open());
+  for (size_t offset = 0; offset < source_.size(); offset += 400) {
+    VerifyRead(reader, offset, std::min(size_t{400}, source_.size() - offset));
+  }
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+TEST_F(CompressedBlobTest, Seek_ForwardAndBack) {
+  InitSourceToText();
+  WriteCompressed(source_);
+
+  CompressedBlobReader reader(blob_, block_buffer_);
+  ASSERT_EQ(OkStatus(), reader.Open(1000));
+  VerifyRead(reader, 1000, 100);
+
+  constexpr size_t kOffsets[] = {2990, 0, 255, 1280, 511, 1100};
+  for (size_t offset : kOffsets) {
+    ASSERT_EQ(OkStatus(), reader.Seek(offset));
+    VerifyRead(reader, offset, std::min(size_t{10}, source_.size() - offset));
+  }
+
+  ASSERT_EQ(OkStatus(), reader.Seek(-20, stream::Stream::kCurrent));
+  VerifyRead(reader, 1090, 20);
+  EXPECT_EQ(Status::OutOfRange(), reader.Seek(source_.size()));
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+TEST_F(CompressedBlobTest, FileName_Stored) {
+  InitSourceToText();
+  WriteCompressed(source_);
+
+  CompressedBlobReader reader(blob_, block_buffer_);
+  ASSERT_EQ(OkStatus(), reader.Open());
+  char name[16] = {};
+  const StatusWithSize sws = reader.GetFileName(name);
+  ASSERT_EQ(OkStatus(), sws.status());
+  EXPECT_EQ("archive.log", std::string_view(name, sws.size()));
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+TEST_F(CompressedBlobTest, BlockBufferTooSmall_ReadFails) {
+  InitSourceToText();
+  WriteCompressed(source_);
+
+  std::array<std::byte, kBlockSize - 1> small_buffer;
+  CompressedBlobReader reader(blob_, small_buffer);
+  EXPECT_EQ(Status::ResourceExhausted(), reader.Open());
+  EXPECT_FALSE(reader.IsOpen());
+}
+
+TEST_F(CompressedBlobTest, UncompressedBlob_ReadAsIs) {
+  InitSourceToRandom(0xabcd);
+  {
+    BlobStore::BlobWriterWithBuffer<> writer(blob_);
+    ASSERT_EQ(OkStatus(), writer.Open());
+    ASSERT_EQ(OkStatus(), writer.Write(source_));
+    ASSERT_EQ(OkStatus(), writer.Close());
+  }
+
+  CompressedBlobReader reader(blob_, block_buffer_);
+  ASSERT_EQ(OkStatus(), reader.Open(100));
+  EXPECT_FALSE(reader.IsCompressed());
+  EXPECT_EQ(source_.size(), reader.UncompressedSizeBytes());
+  VerifyRead(reader, 100, 400);
+  ASSERT_EQ(OkStatus(), reader.Seek(2600));
+  VerifyRead(reader, 2600, 400);
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+TEST_F(CompressedBlobTest, Reinit_KeepsCompression) {
+  InitSourceToText();
+  WriteCompressed(source_);
+
+  BlobStoreBuffer<kFlashWriteSize> blob(
+      kBlobTitle, partition_, &checksum_, kvs::TestKvs(), kFlashWriteSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  CompressedBlobReader reader(blob, block_buffer_);
+  ASSERT_EQ(OkStatus(), reader.Open(2000));
+  EXPECT_TRUE(reader.IsCompressed());
+  EXPECT_EQ(source_.size(), reader.UncompressedSizeBytes());
+  VerifyRead(reader, 2000, 400);
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+}  // namespace
+}  // namespace pw::blob_store
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <span>
 
@@ -31,6 +32,9 @@
 
 namespace pw::blob_store {
 
+class CompressedBlobReader;
+class CompressedBlobWriter;
+
 // BlobStore is a storage container for a single blob of data. BlobStore is
 // a FlashPartition-backed persistent storage system with integrated data
 // integrity checking that serves as a lightweight alternative to a file
@@ -55,6 +59,17 @@ namespace pw::blob_store {
 //  3) BlobReader::Close().
 class BlobStore {
  public:
+  // When the blob partition is erased for a new blob.
+  enum class EraseMode {
+    // Erase the whole partition before the first write of a blob, unless it is
+    // already erased.
+    kFull,
+
+    // Erase each sector just before data is first written to it, so the first
+    // write does not wait for the whole partition to erase.
+    kIncremental,
+  };
+
   // Implement the stream::Writer and erase interface for a BlobStore. If not
   // already erased, the Write will do any needed erase.
   //
@@ -98,6 +113,8 @@ class BlobStore {
     // Returns:
     //
     // OK - success.
+    // UNAVAILABLE - A background erase is in progress. The writer remains
+    //     open; call Close again once the erase completes.
     // DATA_LOSS - Error writing data or fail to verify written data.
     Status Close();
 
@@ -105,6 +122,10 @@ class BlobStore {
 
     // Erase the blob partition and reset state for a new blob. Explicit calls
     // to Erase are optional, beginning a write will do any needed Erase.
+    //
+    // The erased state is stored in the blob's metadata, so a partition erased
+    // ahead of time (e.g. Open(), Erase(), Close()) is not erased again when
+    // the next blob is written, even after a reboot.
     // Returns:
     //
     // OK - success.
@@ -112,9 +133,30 @@ class BlobStore {
     // [error status] - flash erase failed.
     Status Erase() {
       PW_DASSERT(open_);
-      return store_.Erase();
+      PW_TRY(store_.Erase());
+      store_.StoreErasedState();
+      return OkStatus();
+    }
+
+    // Starts erasing the blob partition in the background, so that the erase
+    // can overlap with other work, such as receiving the data to write. Writes
+    // and Close() return UNAVAILABLE until the erase completes; call them
+    // again later. Requires a flash driver that supports asynchronous erases.
+    // The BlobStore must not be destroyed while an erase is in progress.
+    // Returns:
+    //
+    // OK - erase started, in progress, or the partition is already erased.
+    // UNIMPLEMENTED - the flash does not support asynchronous erases; use
+    //     Erase() instead.
+    // [error status] - the erase could not be started.
+    Status StartErase() {
+      PW_DASSERT(open_);
+      return store_.StartErase();
     }
 
+    // True if an erase started by StartErase() has not yet completed.
+    bool IsErasing() const { return store_.erase_in_progress_; }
+
     // Discard the current blob. Any written bytes to this point are considered
     // invalid. Returns:
     //
@@ -171,6 +213,8 @@ class BlobStore {
     bool open_;
 
    private:
+    friend class CompressedBlobWriter;
+
     // Probable (not guaranteed) minimum number of bytes at this time that can
     // be written. This is not necessarily the full number of bytes remaining in
     // the blob. Returns zero if, in the current state, Write would return
@@ -338,6 +382,19 @@ class BlobStore {
       return store_.GetMemoryMappedBlob();
     }
 
+    // Reads up to max_bytes from the current position without copying when
+    // possible, and advances the position past the returned data. If the
+    // blob's flash is memory mapped, the returned span points directly at the
+    // data in flash and fallback_buffer is not used. Otherwise, the data is
+    // copied into fallback_buffer, so at most fallback_buffer.size() bytes are
+    // returned. Returns:
+    //
+    // OK with span - The data read, which may be shorter than requested.
+    // OUT_OF_RANGE - The reader is at the end of the blob.
+    // Other errors from Read().
+    Result<ConstByteSpan> ReadInPlace(size_t max_bytes,
+                                      ByteSpan fallback_buffer);
+
     size_t DoTell() const override {
       PW_DASSERT(open_);
       return offset_;
@@ -384,26 +441,38 @@ class BlobStore {
   //     This should be chosen to balance optimal write size and required buffer
   //     size. Must be greater than or equal to flash write alignment, less than
   //     or equal to flash sector size.
+  // erase_mode - When the partition is erased for a new blob.
   BlobStore(std::string_view name,
             kvs::FlashPartition& partition,
             kvs::ChecksumAlgorithm* checksum_algo,
             sync::Borrowable<kvs::KeyValueStore>& kvs,
             ByteSpan write_buffer,
-            size_t flash_write_size_bytes)
+            size_t flash_write_size_bytes,
+            EraseMode erase_mode = EraseMode::kFull)
       : name_(name),
         partition_(partition),
         checksum_algo_(checksum_algo),
         kvs_(kvs),
         write_buffer_(write_buffer),
         flash_write_size_bytes_(flash_write_size_bytes),
+        erase_mode_(erase_mode),
         initialized_(false),
         valid_data_(false),
         flash_erased_(false),
+        erased_state_stored_(false),
+        erased_bytes_(0),
+        async_erase_started_(false),
+        erase_in_progress_(false),
+        async_erase_status_(OkStatus()),
         writer_open_(false),
         readers_open_(0),
         write_address_(0),
         flash_address_(0),
-        file_name_length_(0) {}
+        file_name_length_(0),
+        metadata_version_(internal::MetadataVersion::kLatest),
+        compression_(internal::Compression::kNone),
+        compression_block_size_(0),
+        uncompressed_size_bytes_(0) {}
 
   BlobStore(const BlobStore&) = delete;
   BlobStore& operator=(const BlobStore&) = delete;
@@ -418,6 +487,9 @@ class BlobStore {
   size_t MaxDataSizeBytes() const;
 
  private:
+  friend class CompressedBlobReader;
+  friend class CompressedBlobWriter;
+
   Status LoadMetadata();
 
   // Open to do a blob write. Returns:
@@ -450,6 +522,7 @@ class BlobStore {
   //     data written.
   // OUT_OF_RANGE - Writer has been exhausted, similar to EOF. No data written,
   //     no more will be written.
+  // UNAVAILABLE - a background erase is in progress. No data written.
   // DATA_LOSS - Error during write (this write or previous write/flush). No
   //     more will be written by following Write calls for current blob (until
   //     erase/new blob started).
@@ -477,6 +550,7 @@ class BlobStore {
   // flush with flash_write_size_bytes buffered or the writer is closed.
   //
   // OK - successful write/enqueue of data.
+  // UNAVAILABLE - a background erase is in progress. No data written.
   // DATA_LOSS - Error during write (this flush or previous write/flush). No
   //     more will be written by following Write calls for current blob (until
   //     erase/new blob started).
@@ -496,9 +570,15 @@ class BlobStore {
   // Commit data to flash and update flash_address_ with data bytes written. The
   // only time data_bytes should be manually specified is for a CloseWrite with
   // an unaligned-size chunk remaining in the buffer that has been zero padded
-  // to alignment.
+  // to alignment. The written data is read back and verified, returning
+  // DATA_LOSS if it does not match.
   Status CommitToFlash(ConstByteSpan source, size_t data_bytes = 0);
 
+  // Prepares flash up to end_address to be written: erases any sectors in the
+  // range that are not known to be erased, and removes the stored erased
+  // state, which is no longer accurate once data is written.
+  Status PrepareToWrite(kvs::FlashPartition::Address end_address);
+
   // Blob is valid/OK to write to. Blob is considered valid to write if no data
   // has been written due to the auto/implicit erase on write start.
   //
@@ -545,8 +625,17 @@ class BlobStore {
     return MaxDataSizeBytes() - write_address_;
   }
 
+  // Erases the partition if needed. Returns UNAVAILABLE if an asynchronous
+  // erase is in progress, or the result of a completed asynchronous erase.
   Status Erase();
 
+  Status StartErase();
+
+  // Stores that the partition is erased in the blob's metadata, so it is not
+  // erased again after a reboot. Failing to store it is not an error, since
+  // the partition is then only erased again.
+  void StoreErasedState();
+
   Status Invalidate();
 
   void ResetChecksum() {
@@ -560,6 +649,14 @@ class BlobStore {
 
   Status CalculateChecksumFromFlash(size_t bytes_to_check);
 
+  // Reads back data that was just written to flash and compares it with the
+  // data that was written. Returns DATA_LOSS on a mismatch.
+  Status VerifyCommittedData(kvs::FlashPartition::Address address,
+                             ConstByteSpan expected);
+
+  // Size of the stack buffer used to read data back from flash.
+  static constexpr size_t kReadBufferSizeBytes = 32;
+
   const std::string_view MetadataKey() const { return name_; }
 
   // Copies the file name of the stored data to `dest`, and returns the number
@@ -586,6 +683,8 @@ class BlobStore {
   // alignment, LE flash sector size.
   const size_t flash_write_size_bytes_;
 
+  const EraseMode erase_mode_;
+
   //
   // Internal state for Blob store
   //
@@ -601,6 +700,26 @@ class BlobStore {
   // Blob partition is currently erased and ready to write a new blob.
   bool flash_erased_;
 
+  // The metadata entry records that the partition is erased, rather than
+  // describing a stored blob.
+  bool erased_state_stored_;
+
+  // Bytes from the start of the partition known to be erased and unwritten.
+  // Always a multiple of the sector size.
+  kvs::FlashPartition::Address erased_bytes_;
+
+  // An erase was started with StartErase() and its result has not been
+  // handled by Erase().
+  bool async_erase_started_;
+
+  // Set by StartErase() and cleared by the erase's completion callback, which
+  // may run in another context.
+  std::atomic<bool> erase_in_progress_;
+
+  // Result of the last asynchronous erase. Written before erase_in_progress_
+  // is cleared.
+  Status async_erase_status_;
+
   // BlobWriter instance is currently open
   bool writer_open_;
 
@@ -617,6 +736,14 @@ class BlobStore {
 
   // Length of the stored blob's filename.
   size_t file_name_length_;
+
+  // Version of the stored metadata, which determines where the file name is.
+  internal::MetadataVersion metadata_version_;
+
+  // Compression of the blob data, set by a CompressedBlobWriter before Close.
+  internal::Compression compression_;
+  uint16_t compression_block_size_;
+  size_t uncompressed_size_bytes_;
 };
 
 // Creates a BlobStore with the buffer of kBufferSizeBytes.
@@ -634,6 +761,7 @@ class BlobStore {
 //     This should be chosen to balance optimal write size and required buffer
 //     size. Must be greater than or equal to flash write alignment, less than
 //     or equal to flash sector size.
+// erase_mode - When the partition is erased for a new blob.
 
 template <size_t kBufferSizeBytes>
 class BlobStoreBuffer : public BlobStore {
@@ -642,13 +770,15 @@ class BlobStoreBuffer : public BlobStore {
                            kvs::FlashPartition& partition,
                            kvs::ChecksumAlgorithm* checksum_algo,
                            sync::Borrowable<kvs::KeyValueStore>& kvs,
-                           size_t flash_write_size_bytes)
+                           size_t flash_write_size_bytes,
+                           EraseMode erase_mode = EraseMode::kFull)
       : BlobStore(name,
                   partition,
                   checksum_algo,
                   kvs,
                   buffer_,
-                  flash_write_size_bytes) {}
+                  flash_write_size_bytes,
+                  erase_mode) {}
 
  private:
   std::array<std::byte, kBufferSizeBytes> buffer_;
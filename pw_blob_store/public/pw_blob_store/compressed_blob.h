@@ -0,0 +1,204 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "pw_blob_store/blob_store.h"
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/seek.h"
+#include "pw_stream/stream.h"
+
+namespace pw::blob_store {
+
+// Compressed blobs are stored as a series of blocks, each holding a fixed
+// number of uncompressed bytes (the block size, except for the last block).
+// Each block is compressed on its own with a small LZ77 codec, so the block is
+// the codec's window and each block start is a restart point for seeks.
+//
+// In flash, each block is a 2-byte little-endian header followed by its data.
+// The header holds the size of the data, with the top bit set if the block is
+// stored uncompressed because it did not compress.
+inline constexpr size_t kMaxCompressionBlockSizeBytes = 4096;
+
+// Writes a compressed blob to a BlobStore through a BlobWriter. The blob's
+// metadata records the compressed and uncompressed sizes, which are read by
+// CompressedBlobReader.
+//
+// Data is buffered one block at a time in block_buffer, whose size is the
+// block size, so larger blocks compress better at the cost of RAM and of
+// slower seeks. The BlobStore must have a write buffer, since blocks are
+// written in pieces that are not multiples of the flash write size.
+//
+//   BlobStore::BlobWriterWithBuffer blob_writer(blob_store);
+//   std::array<std::byte, 1024> block_buffer;
+//   CompressedBlobWriter writer(blob_writer, block_buffer);
+//
+//   PW_TRY(writer.Open());
+//   PW_TRY(writer.Write(data));
+//   PW_TRY(writer.Close());
+//
+class CompressedBlobWriter final : public stream::NonSeekableWriter {
+ public:
+  // block_buffer must be 1 to kMaxCompressionBlockSizeBytes bytes.
+  CompressedBlobWriter(BlobStore::BlobWriter& writer, ByteSpan block_buffer);
+
+  CompressedBlobWriter(const CompressedBlobWriter&) = delete;
+  CompressedBlobWriter& operator=(const CompressedBlobWriter&) = delete;
+
+  ~CompressedBlobWriter() {
+    if (writer_.IsOpen()) {
+      Close().IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    }
+  }
+
+  // Opens the BlobWriter to write a new blob. See BlobWriter::Open().
+  Status Open();
+
+  // Compresses and writes the buffered data, records the sizes in the blob's
+  // metadata, and closes the BlobWriter. See BlobWriter::Close().
+  Status Close();
+
+  bool IsOpen() { return writer_.IsOpen(); }
+
+  // Discards the blob and any buffered data. See BlobWriter::Discard().
+  Status Discard();
+
+  // See BlobWriter::SetFileName().
+  Status SetFileName(std::string_view file_name) {
+    return writer_.SetFileName(file_name);
+  }
+
+  // Uncompressed bytes written so far.
+  size_t CurrentSizeBytes() const { return uncompressed_size_bytes_; }
+
+ private:
+  // Writes fail with UNAVAILABLE, without taking any data, while a background
+  // erase is in progress.
+  Status DoWrite(ConstByteSpan data) override;
+
+  // Uncompressed bytes that fit even if none of the data compresses.
+  size_t ConservativeLimit(LimitType limit) const override;
+
+  Status WriteBlock();
+
+  BlobStore::BlobWriter& writer_;
+  const ByteSpan block_buffer_;
+  size_t block_bytes_;
+  size_t uncompressed_size_bytes_;
+
+  // Last position of each hash of 3 bytes in the block, plus 1.
+  std::array<uint16_t, 256> hash_table_;
+};
+
+// Reads a blob written by CompressedBlobWriter, decompressing it as it is read.
+// Blobs that are not compressed are read as they are, so this may be used for
+// any blob.
+//
+// block_buffer holds one decompressed block, so it must be at least the block
+// size used to write the blob. Seeking within the current block, or forward to
+// a later block, reads only the headers of the blocks in between. Seeking
+// backwards to an earlier block starts from the beginning of the blob.
+class CompressedBlobReader final : public stream::SeekableReader {
+ public:
+  CompressedBlobReader(BlobStore& store, ByteSpan block_buffer)
+      : store_(store),
+        reader_(store),
+        block_buffer_(block_buffer),
+        compressed_(false),
+        size_bytes_(0),
+        block_size_bytes_(0),
+        position_(0),
+        block_index_(kNoBlock),
+        block_length_(0),
+        next_block_index_(0),
+        next_block_address_(0) {}
+
+  CompressedBlobReader(const CompressedBlobReader&) = delete;
+  CompressedBlobReader& operator=(const CompressedBlobReader&) = delete;
+
+  // Opens to read at the given uncompressed offset. Returns:
+  //
+  // OK - success.
+  // FAILED_PRECONDITION - No readable blob available.
+  // INVALID_ARGUMENT - Invalid offset.
+  // RESOURCE_EXHAUSTED - block_buffer is smaller than the blob's block size.
+  // UNAVAILABLE - Unable to open, already open.
+  Status Open(size_t offset = 0);
+
+  // See BlobReader::Close().
+  Status Close() { return reader_.Close(); }
+
+  bool IsOpen() { return reader_.IsOpen(); }
+
+  // See BlobReader::GetFileName().
+  StatusWithSize GetFileName(std::span<char> dest) {
+    return reader_.GetFileName(dest);
+  }
+
+  // Size of the blob's data after decompression.
+  size_t UncompressedSizeBytes() const { return size_bytes_; }
+
+  // True if the blob was written compressed.
+  bool IsCompressed() const { return compressed_; }
+
+ private:
+  static constexpr size_t kNoBlock = SIZE_MAX;
+
+  size_t ConservativeLimit(LimitType limit) const override {
+    if (limit == LimitType::kRead) {
+      return size_bytes_ - position_;
+    }
+    return 0;
+  }
+
+  StatusWithSize DoRead(ByteSpan dest) override;
+
+  Status DoSeek(ssize_t offset, Whence origin) override;
+
+  size_t DoTell() const override { return position_; }
+
+  // Decompresses the block into block_buffer_.
+  Status LoadBlock(size_t index);
+
+  // Reads exactly dest.size() bytes as they are stored at the address.
+  Status ReadStored(size_t address, ByteSpan dest);
+
+  BlobStore& store_;
+  BlobStore::BlobReader reader_;
+  const ByteSpan block_buffer_;
+  bool compressed_;
+  size_t size_bytes_;
+  size_t block_size_bytes_;
+
+  // Uncompressed read position.
+  size_t position_;
+
+  // Block in block_buffer_, and its length.
+  size_t block_index_;
+  size_t block_length_;
+
+  // Compressed address of the block after the last one found, so sequential
+  // reads do not rescan the block headers.
+  size_t next_block_index_;
+  size_t next_block_address_;
+};
+
+}  // namespace pw::blob_store
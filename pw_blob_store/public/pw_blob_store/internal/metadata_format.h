@@ -14,6 +14,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 #include "pw_preprocessor/compiler.h"
 
@@ -23,7 +24,16 @@ enum MetadataVersion : uint32_t {
   // Original metadata format does not include a version.
   kVersion1 = 0,
   kVersion2 = 0x1197851D,
-  kLatest = kVersion2
+  kVersion3 = 0x3C7F2A91,
+  kLatest = kVersion3
+};
+
+// How the blob data is stored in flash.
+enum class Compression : uint8_t {
+  kNone = 0,
+
+  // Blocks of LZ77 compressed data, written by a CompressedBlobWriter.
+  kBlockLz = 1,
 };
 
 // Technically the original BlobMetadataV1 was not packed.
@@ -53,6 +63,41 @@ PW_PACKED(struct) BlobMetadataHeaderV2 {
   // Following this struct is file_name_length chars of file name. Note that
   // the string of characters is NOT null terminated.
 
+  constexpr void reset() {
+    *this = {
+        .v1_metadata =
+            {
+                .checksum = 0,
+                .data_size_bytes = 0,
+            },
+        .version = MetadataVersion::kVersion2,
+        .file_name_length = 0,
+    };
+  }
+};
+
+PW_PACKED(struct) BlobMetadataHeaderV3 {
+  BlobMetadataV1 v1_metadata;
+
+  // Metadata encoding version stored in flash.
+  MetadataVersion version;
+
+  // Length of the file name stored in the metadata entry.
+  uint8_t file_name_length;
+
+  // Encoding of the blob data. When compressed, v1_metadata.data_size_bytes is
+  // the compressed size.
+  Compression compression;
+
+  // Uncompressed bytes per compressed block, or 0 if not compressed.
+  uint16_t compression_block_size;
+
+  // Number of blob data bytes before compression.
+  uint32_t uncompressed_size_bytes;
+
+  // Following this struct is file_name_length chars of file name. Note that
+  // the string of characters is NOT null terminated.
+
   constexpr void reset() {
     *this = {
         .v1_metadata =
@@ -62,11 +107,20 @@ PW_PACKED(struct) BlobMetadataHeaderV2 {
             },
         .version = MetadataVersion::kLatest,
         .file_name_length = 0,
+        .compression = Compression::kNone,
+        .compression_block_size = 0,
+        .uncompressed_size_bytes = 0,
     };
   }
 };
 
-using BlobMetadataHeader = BlobMetadataHeaderV2;
+// Offset of the file name in a metadata entry of the given version.
+constexpr size_t FileNameOffset(MetadataVersion version) {
+  return version == MetadataVersion::kVersion2 ? sizeof(BlobMetadataHeaderV2)
+                                               : sizeof(BlobMetadataHeaderV3);
+}
+
+using BlobMetadataHeader = BlobMetadataHeaderV3;
 using ChecksumValue = BlobMetadataV1::ChecksumValue;
 
 }  // namespace pw::blob_store::internal
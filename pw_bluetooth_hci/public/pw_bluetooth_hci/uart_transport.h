@@ -14,10 +14,12 @@
 #pragma once
 
 #include <bit>
+#include <cstddef>
 
 #include "pw_bluetooth_hci/packet.h"
 #include "pw_bytes/span.h"
 #include "pw_function/function.h"
+#include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
 
 namespace pw::bluetooth_hci {
@@ -60,4 +62,61 @@ using DecodedPacketCallback = Function<void(const Packet& packet)>;
 StatusWithSize DecodeHciUartData(ConstByteSpan data,
                                  const DecodedPacketCallback& packet_callback);
 
+// Incrementally decodes a HCI UART Transport Layer byte stream that arrives in
+// chunks with arbitrary boundaries, such as the regions of a DMA ring buffer.
+//
+// Packets that are entirely within a chunk are passed to the callback without
+// copying; their spans point into the chunk. Only a packet that is split
+// across chunks is copied, into the reassembly buffer, and it is passed to the
+// callback once its last byte arrives. Packet spans are only valid for the
+// duration of the callback.
+//
+// When reading a ring buffer, pass the region up to the end of the buffer and
+// the region from its start as two separate calls, so that only packets which
+// span the wrap are copied.
+class HciUartDecoder {
+ public:
+  // The smallest reassembly buffer: a packet indicator and the largest packet
+  // header.
+  static constexpr size_t kMinReassemblyBufferSizeBytes =
+      1 + AsyncDataPacket::kHeaderSizeBytes;
+
+  // The reassembly buffer must hold the largest packet that may be split
+  // across chunks, including its packet indicator byte.
+  explicit HciUartDecoder(ByteSpan reassembly_buffer);
+
+  HciUartDecoder(const HciUartDecoder&) = delete;
+  HciUartDecoder& operator=(const HciUartDecoder&) = delete;
+
+  // Decodes the chunk, invoking the callback for each complete packet. All of
+  // the data is consumed; a trailing partial packet is kept until the next
+  // call.
+  //
+  // Returns:
+  // OK - The data was decoded.
+  // DATA_LOSS - An invalid packet indicator was detected. Synchronization has
+  //     been lost and the rest of the chunk was discarded. The caller is
+  //     responsible for regaining synchronization, then should call Reset().
+  // RESOURCE_EXHAUSTED - A partial packet did not fit in the reassembly
+  //     buffer. The packet was dropped and decoding continues after it.
+  Status Decode(ConstByteSpan data,
+                const DecodedPacketCallback& packet_callback);
+
+  // Discards any partial packet.
+  void Reset() {
+    buffered_bytes_ = 0;
+    discard_bytes_ = 0;
+  }
+
+  // The number of bytes of a partial packet held in the reassembly buffer.
+  size_t buffered_bytes() const { return buffered_bytes_; }
+
+ private:
+  ByteSpan reassembly_buffer_;
+  size_t buffered_bytes_;
+
+  // Bytes remaining in a packet that was too large to reassemble.
+  size_t discard_bytes_;
+};
+
 }  // namespace pw::bluetooth_hci
@@ -13,7 +13,56 @@
 // the License.
 #include "pw_bluetooth_hci/uart_transport.h"
 
+#include <algorithm>
+
+#include "pw_assert/check.h"
+#include "pw_bytes/endian.h"
+
 namespace pw::bluetooth_hci {
+namespace {
+
+// Returns the number of bytes needed to decode more of a packet that starts
+// with a valid packet indicator: the size of the header if it is incomplete,
+// or the size of the whole packet. Includes the packet indicator.
+size_t RequiredSizeBytes(ConstByteSpan packet) {
+  size_t header_size_bytes;
+  size_t length_offset;  // Offset of the length field in the header.
+  switch (packet[0]) {
+    case kUartCommandPacketIndicator:
+      header_size_bytes = CommandPacket::kHeaderSizeBytes;
+      length_offset = 2;
+      break;
+    case kUartAsyncDataPacketIndicator:
+      header_size_bytes = AsyncDataPacket::kHeaderSizeBytes;
+      length_offset = 2;
+      break;
+    case kUartSyncDataPacketIndicator:
+      header_size_bytes = SyncDataPacket::kHeaderSizeBytes;
+      length_offset = 2;
+      break;
+    case kUartEventPacketIndicator:
+      header_size_bytes = EventPacket::kHeaderSizeBytes;
+      length_offset = 1;
+      break;
+    default:
+      PW_CRASH("Partial packet has an invalid packet indicator");
+  }
+
+  const ConstByteSpan header = packet.subspan(1);
+  if (header.size() < header_size_bytes) {
+    return 1 + header_size_bytes;
+  }
+
+  // Only ACL data packets have a 16-bit length.
+  const size_t length =
+      packet[0] == kUartAsyncDataPacketIndicator
+          ? bytes::ReadInOrder<uint16_t>(std::endian::little,
+                                         &header[length_offset])
+          : static_cast<uint8_t>(header[length_offset]);
+  return 1 + header_size_bytes + length;
+}
+
+}  // namespace
 
 StatusWithSize DecodeHciUartData(ConstByteSpan data,
                                  const DecodedPacketCallback& packet_callback) {
@@ -95,4 +144,69 @@ StatusWithSize DecodeHciUartData(ConstByteSpan data,
   return StatusWithSize(bytes_consumed);
 }
 
+HciUartDecoder::HciUartDecoder(ByteSpan reassembly_buffer)
+    : reassembly_buffer_(reassembly_buffer),
+      buffered_bytes_(0),
+      discard_bytes_(0) {
+  PW_CHECK_UINT_GE(reassembly_buffer.size(), kMinReassemblyBufferSizeBytes);
+}
+
+Status HciUartDecoder::Decode(ConstByteSpan data,
+                              const DecodedPacketCallback& packet_callback) {
+  Status status;
+
+  while (!data.empty()) {
+    if (discard_bytes_ > 0u) {
+      const size_t discarded = std::min(discard_bytes_, data.size());
+      discard_bytes_ -= discarded;
+      data = data.subspan(discarded);
+      continue;
+    }
+
+    if (buffered_bytes_ == 0u) {
+      // Decode complete packets in place.
+      const StatusWithSize result = DecodeHciUartData(data, packet_callback);
+      data = data.subspan(result.size());
+      if (!result.ok()) {
+        return result.status();
+      }
+      if (data.empty()) {
+        break;
+      }
+    }
+
+    // Copy only as much of the partial packet as is needed to find its size
+    // and then to complete it.
+    if (buffered_bytes_ == 0u) {
+      reassembly_buffer_[0] = data[0];
+      buffered_bytes_ = 1;
+      data = data.subspan(1);
+    }
+
+    const size_t required = RequiredSizeBytes(
+        reassembly_buffer_.first(buffered_bytes_));
+    if (required > reassembly_buffer_.size()) {
+      discard_bytes_ = required - buffered_bytes_;
+      buffered_bytes_ = 0;
+      status = Status::ResourceExhausted();
+      continue;
+    }
+
+    const size_t copied = std::min(required - buffered_bytes_, data.size());
+    std::copy(data.begin(),
+              data.begin() + copied,
+              reassembly_buffer_.begin() + buffered_bytes_);
+    buffered_bytes_ += copied;
+    data = data.subspan(copied);
+
+    const ConstByteSpan packet = reassembly_buffer_.first(buffered_bytes_);
+    if (RequiredSizeBytes(packet) == buffered_bytes_) {
+      DecodeHciUartData(packet, packet_callback).IgnoreError();
+      buffered_bytes_ = 0;
+    }
+  }
+
+  return status;
+}
+
 }  // namespace pw::bluetooth_hci
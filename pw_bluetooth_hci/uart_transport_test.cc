@@ -14,6 +14,9 @@
 
 #include "pw_bluetooth_hci/uart_transport.h"
 
+#include <algorithm>
+#include <array>
+
 #include "gtest/gtest.h"
 #include "pw_bluetooth_hci/packet.h"
 #include "pw_bytes/byte_builder.h"
@@ -405,5 +408,155 @@ TEST_F(UartTransportTest, LotsOfEventPackets) {
   EXPECT_EQ(event_packet_count, expected_packet_count);
 }
 
+class HciUartDecoderTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kAclDataSizeBytes = 300;  // Needs a 16-bit length.
+
+  HciUartDecoderTest() : decoder_(reassembly_buffer_) {
+    for (size_t i = 0; i < acl_data_.size(); ++i) {
+      acl_data_[i] = std::byte(i);
+    }
+
+    // A command packet, an ACL data packet and an event packet.
+    Append(kUartCommandPacketIndicator,
+           CommandPacket(0x0c03, kCommandParameters));
+    Append(kUartAsyncDataPacketIndicator, AsyncDataPacket(0x0001, acl_data_));
+    Append(kUartEventPacketIndicator, EventPacket(0x0e, kEventParameters));
+  }
+
+  template <typename PacketType>
+  void Append(std::byte packet_indicator, const PacketType& packet) {
+    stream_.push_back(packet_indicator);
+    std::array<std::byte, 512> packet_buffer;
+    const Result<ConstByteSpan> result = packet.Encode(packet_buffer);
+    ASSERT_EQ(result.status(), OkStatus());
+    stream_.append(result.value());
+    ASSERT_EQ(stream_.status(), OkStatus());
+  }
+
+  // Records the decoded packets and where their payloads were.
+  DecodedPacketCallback Record() {
+    return [this](const Packet& packet) {
+      ConstByteSpan payload;
+      switch (packet.type()) {
+        case Packet::Type::kCommandPacket:
+          payload = packet.command_packet().parameters();
+          EXPECT_TRUE(std::equal(payload.begin(),
+                                 payload.end(),
+                                 kCommandParameters.begin(),
+                                 kCommandParameters.end()));
+          break;
+        case Packet::Type::kAsyncDataPacket:
+          payload = packet.async_data_packet().data();
+          EXPECT_TRUE(std::equal(payload.begin(),
+                                 payload.end(),
+                                 acl_data_.begin(),
+                                 acl_data_.end()));
+          break;
+        case Packet::Type::kEventPacket:
+          payload = packet.event_packet().parameters();
+          EXPECT_TRUE(std::equal(payload.begin(),
+                                 payload.end(),
+                                 kEventParameters.begin(),
+                                 kEventParameters.end()));
+          break;
+        case Packet::Type::kSyncDataPacket:
+          FAIL();
+      }
+      types_[packet_count_] = packet.type();
+      copied_[packet_count_] = IsIn(payload, reassembly_buffer_);
+      packet_count_ += 1;
+    };
+  }
+
+  static bool IsIn(ConstByteSpan inner, ConstByteSpan outer) {
+    return inner.data() >= outer.data() &&
+           inner.data() + inner.size() <= outer.data() + outer.size();
+  }
+
+  static constexpr std::array<std::byte, 2> kCommandParameters = {
+      std::byte{0xaa}, std::byte{0xbb}};
+  static constexpr std::array<std::byte, 3> kEventParameters = {
+      std::byte{1}, std::byte{2}, std::byte{3}};
+
+  std::array<std::byte, kAclDataSizeBytes> acl_data_;
+  ByteBuffer<512> stream_;
+
+  std::array<std::byte, 512> reassembly_buffer_ = {};
+  HciUartDecoder decoder_;
+
+  size_t packet_count_ = 0;
+  std::array<Packet::Type, 3> types_ = {};
+  std::array<bool, 3> copied_ = {};
+};
+
+TEST_F(HciUartDecoderTest, WholeStream_ZeroCopy) {
+  ASSERT_EQ(OkStatus(), decoder_.Decode(stream_, Record()));
+  ASSERT_EQ(packet_count_, 3u);
+  EXPECT_EQ(types_[0], Packet::Type::kCommandPacket);
+  EXPECT_EQ(types_[1], Packet::Type::kAsyncDataPacket);
+  EXPECT_EQ(types_[2], Packet::Type::kEventPacket);
+  EXPECT_FALSE(copied_[0]);
+  EXPECT_FALSE(copied_[1]);
+  EXPECT_FALSE(copied_[2]);
+  EXPECT_EQ(decoder_.buffered_bytes(), 0u);
+}
+
+TEST_F(HciUartDecoderTest, AnyChunkSize) {
+  const ConstByteSpan stream(stream_);
+  for (size_t chunk_size = 1; chunk_size <= stream.size(); ++chunk_size) {
+    packet_count_ = 0;
+    for (size_t i = 0; i < stream.size(); i += chunk_size) {
+      const size_t size = std::min(chunk_size, stream.size() - i);
+      ASSERT_EQ(OkStatus(),
+                decoder_.Decode(stream.subspan(i, size), Record()));
+    }
+    ASSERT_EQ(packet_count_, 3u);
+    EXPECT_EQ(types_[2], Packet::Type::kEventPacket);
+    EXPECT_EQ(decoder_.buffered_bytes(), 0u);
+  }
+}
+
+TEST_F(HciUartDecoderTest, RingBufferWrap_OnlySplitPacketIsCopied) {
+  // Split the stream inside the ACL data packet, as at a ring buffer wrap.
+  const ConstByteSpan stream(stream_);
+  const size_t split = 1 + CommandPacket::kHeaderSizeBytes + 2 + 100;
+
+  ASSERT_EQ(OkStatus(), decoder_.Decode(stream.first(split), Record()));
+  EXPECT_EQ(packet_count_, 1u);
+  EXPECT_EQ(decoder_.buffered_bytes(), 100u);
+
+  ASSERT_EQ(OkStatus(), decoder_.Decode(stream.subspan(split), Record()));
+  ASSERT_EQ(packet_count_, 3u);
+  EXPECT_FALSE(copied_[0]);
+  EXPECT_TRUE(copied_[1]);
+  EXPECT_FALSE(copied_[2]);
+}
+
+TEST_F(HciUartDecoderTest, SplitPacketTooLarge_ResourceExhausted) {
+  std::array<std::byte, 64> small_buffer;
+  HciUartDecoder decoder(small_buffer);
+
+  const ConstByteSpan stream(stream_);
+  const size_t split = 1 + CommandPacket::kHeaderSizeBytes + 2 + 10;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            decoder.Decode(stream.first(split), Record()));
+  EXPECT_EQ(OkStatus(), decoder.Decode(stream.subspan(split), Record()));
+
+  // The ACL data packet is dropped and the event packet is still decoded.
+  ASSERT_EQ(packet_count_, 2u);
+  EXPECT_EQ(types_[0], Packet::Type::kCommandPacket);
+  EXPECT_EQ(types_[1], Packet::Type::kEventPacket);
+}
+
+TEST_F(HciUartDecoderTest, InvalidPacketIndicator_DataLoss) {
+  const std::array<std::byte, 1> invalid = {std::byte{0}};
+  EXPECT_EQ(Status::DataLoss(), decoder_.Decode(invalid, Record()));
+  decoder_.Reset();
+
+  ASSERT_EQ(OkStatus(), decoder_.Decode(stream_, Record()));
+  EXPECT_EQ(packet_count_, 3u);
+}
+
 }  // namespace
 }  // namespace pw::bluetooth_hci
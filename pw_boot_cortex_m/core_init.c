@@ -53,37 +53,138 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-#include <string.h>
 
 #include "pw_boot/boot.h"
 #include "pw_boot_cortex_m/boot.h"
+#include "pw_boot_cortex_m/config.h"
 #include "pw_preprocessor/compiler.h"
 
 // Extern symbols provided by linker script.
 // These symbols tell us where various memory sections start and end.
-extern uint8_t _pw_static_init_ram_start;
-extern uint8_t _pw_static_init_ram_end;
-extern uint8_t _pw_static_init_flash_start;
-extern uint8_t _pw_zero_init_ram_start;
-extern uint8_t _pw_zero_init_ram_end;
+extern uint32_t _pw_static_init_ram_start;
+extern uint32_t _pw_static_init_ram_end;
+extern uint32_t _pw_static_init_flash_start;
+extern uint32_t _pw_zero_init_ram_start;
+extern uint32_t _pw_zero_init_ram_end;
+
+// The deferred regions are optional. If a linker script does not define them,
+// these weak references resolve to zero and the regions are empty.
+extern uint32_t _pw_deferred_static_init_ram_start PW_WEAK;
+extern uint32_t _pw_deferred_static_init_ram_end PW_WEAK;
+extern uint32_t _pw_deferred_static_init_flash_start PW_WEAK;
+extern uint32_t _pw_deferred_zero_init_ram_start PW_WEAK;
+extern uint32_t _pw_deferred_zero_init_ram_end PW_WEAK;
 
 // Functions called as part of firmware initialization.
 void __libc_init_array(void);
 
+// GCC may replace the loops below with calls to memcpy and memset, which in
+// size-optimized C libraries copy a byte at a time.
+#if defined(__GNUC__) && !defined(__clang__)
+#define PW_BOOT_NO_LIBC_CALLS \
+  __attribute__((optimize("no-tree-loop-distribute-patterns")))
+#else
+#define PW_BOOT_NO_LIBC_CALLS
+#endif  // defined(__GNUC__) && !defined(__clang__)
+
+// Copies and zeroes sections a word at a time, four words per iteration. The
+// linker script aligns the start and end of each section to 8 bytes, so every
+// section is a whole number of 8-byte blocks.
+PW_BOOT_NO_LIBC_CALLS static void CopyWords(uint32_t* destination,
+                                            uint32_t* destination_end,
+                                            const uint32_t* source) {
+  while (destination_end - destination >= 4) {
+    destination[0] = source[0];
+    destination[1] = source[1];
+    destination[2] = source[2];
+    destination[3] = source[3];
+    destination += 4;
+    source += 4;
+  }
+  while (destination < destination_end) {
+    *destination++ = *source++;
+  }
+}
+
+PW_BOOT_NO_LIBC_CALLS static void ZeroWords(uint32_t* destination,
+                                            uint32_t* destination_end) {
+  while (destination_end - destination >= 4) {
+    destination[0] = 0;
+    destination[1] = 0;
+    destination[2] = 0;
+    destination[3] = 0;
+    destination += 4;
+  }
+  while (destination < destination_end) {
+    *destination++ = 0;
+  }
+}
+
+#if PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS
+
+// Memory mapped registers. (ARMv7-M Section C1.6 and C1.8)
+#define CORTEX_M_DEMCR (*(volatile uint32_t*)0xE000EDFCu)
+#define CORTEX_M_DWT_CTRL (*(volatile uint32_t*)0xE0001000u)
+#define CORTEX_M_DWT_CYCCNT (*(volatile uint32_t*)0xE0001004u)
+
+// Software lock access register, which must be unlocked on some cores (such as
+// the Cortex-M7) before the DWT can be configured.
+#define CORTEX_M_DWT_LAR (*(volatile uint32_t*)0xE0001FB0u)
+
+#define DEMCR_TRACE_ENABLE_MASK (0x1u << 24)   // TRCENA
+#define DWT_CTRL_CYCLE_COUNT_ENABLE_MASK 0x1u  // CYCCNTENA
+#define DWT_LAR_UNLOCK_KEY 0xC5ACCE55u
+
+PW_PLACE_IN_SECTION(".pw_boot_persistent_ram")
+pw_boot_Timestamps pw_boot_timestamps;
+
+// Starts counting cycles from zero. This only writes registers, so it is safe
+// to run before static memory is initialized.
+static void StartCycleCounter(void) {
+  CORTEX_M_DEMCR |= DEMCR_TRACE_ENABLE_MASK;
+  CORTEX_M_DWT_LAR = DWT_LAR_UNLOCK_KEY;
+  CORTEX_M_DWT_CYCCNT = 0;
+  CORTEX_M_DWT_CTRL |= DWT_CTRL_CYCLE_COUNT_ENABLE_MASK;
+}
+
+#define RECORD_TIMESTAMP(phase) \
+  pw_boot_timestamps.phase = CORTEX_M_DWT_CYCCNT
+
+#else
+
+#define RECORD_TIMESTAMP(phase)
+
+#endif  // PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS
+
 // WARNING: Be EXTREMELY careful when running code before this function
 // completes. The context before this function violates the C spec
 // (Section 6.7.8, paragraph 10 for example, which requires uninitialized static
 // values to be zero-initialized).
 void StaticMemoryInit(void) {
   // Static-init RAM (load static values into ram, .data section init).
-  memcpy(&_pw_static_init_ram_start,
-         &_pw_static_init_flash_start,
-         &_pw_static_init_ram_end - &_pw_static_init_ram_start);
+  CopyWords(&_pw_static_init_ram_start,
+            &_pw_static_init_ram_end,
+            &_pw_static_init_flash_start);
 
   // Zero-init RAM (.bss section init).
-  memset(&_pw_zero_init_ram_start,
-         0,
-         &_pw_zero_init_ram_end - &_pw_zero_init_ram_start);
+  ZeroWords(&_pw_zero_init_ram_start, &_pw_zero_init_ram_end);
+}
+
+void pw_boot_DeferredStaticMemoryInit(void) {
+  // This flag is in .bss, so it is initialized before this can be called.
+  static bool initialized = false;
+  if (initialized) {
+    return;
+  }
+
+  CopyWords(&_pw_deferred_static_init_ram_start,
+            &_pw_deferred_static_init_ram_end,
+            &_pw_deferred_static_init_flash_start);
+  ZeroWords(&_pw_deferred_zero_init_ram_start,
+            &_pw_deferred_zero_init_ram_end);
+  initialized = true;
+
+  RECORD_TIMESTAMP(deferred_static_memory_init);
 }
 
 // WARNING: This code is run immediately upon boot, and performs initialization
@@ -122,17 +223,30 @@ void pw_boot_Entry() {
   );
 #endif
 
+#if PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS
+  StartCycleCounter();
+#endif  // PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS
+
   // Run any init that must be done before static init of RAM which preps the
   // .data (static values not yet loaded into ram) and .bss sections (not yet
   // zero-initialized).
   pw_boot_PreStaticMemoryInit();
 
+#if PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS
+  // The previous boot's timestamps are left intact until this point, so that
+  // pw_boot_PreStaticMemoryInit() can inspect them.
+  pw_boot_timestamps.complete = 0;
+  pw_boot_timestamps.deferred_static_memory_init = 0;
+#endif  // PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS
+  RECORD_TIMESTAMP(pre_static_memory_init);
+
   // Note that code running before this function finishes memory
   // initialization will violate the C spec (Section 6.7.8, paragraph 10 for
   // example, which requires uninitialized static values to be
   // zero-initialized). Be EXTREMELY careful when running code before this
   // function finishes static memory initialization.
   StaticMemoryInit();
+  RECORD_TIMESTAMP(static_memory_init);
 
   // Reenable interrupts.
   //
@@ -143,13 +257,19 @@ void pw_boot_Entry() {
 
   // Run any init that must be done before C++ static constructors.
   pw_boot_PreStaticConstructorInit();
+  RECORD_TIMESTAMP(pre_static_constructor_init);
 
   // Call static constructors.
   __libc_init_array();
+  RECORD_TIMESTAMP(static_constructors);
 
   // This function is not provided by pw_boot_cortex_m, a platform layer,
   // project, or application is expected to implement it.
   pw_boot_PreMainInit();
+  RECORD_TIMESTAMP(pre_main_init);
+#if PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS
+  pw_boot_timestamps.complete = PW_BOOT_TIMESTAMPS_COMPLETE;
+#endif  // PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS
 
   // Run main.
   main();
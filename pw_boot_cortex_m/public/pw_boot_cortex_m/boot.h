@@ -43,6 +43,7 @@
 
 #include <stdint.h>
 
+#include "pw_boot_cortex_m/config.h"
 #include "pw_preprocessor/compiler.h"
 #include "pw_preprocessor/util.h"
 
@@ -75,4 +76,58 @@ extern uint8_t pw_boot_heap_high_addr;
 // can be used to set VTOR (vector table offset register) by the bootloader.
 extern uint8_t pw_boot_vector_table_addr;
 
+// Places a variable in the deferred static or zero-initialized RAM regions.
+// These regions are not initialized by pw_boot_Entry(), which shortens boot;
+// they are initialized by pw_boot_DeferredStaticMemoryInit() instead. Data that
+// is not needed until after critical startup, such as large tables or buffers,
+// can be deferred.
+//
+// Deferred variables must be constant-initialized, since static constructors
+// run before the regions are initialized. They must not be accessed until
+// pw_boot_DeferredStaticMemoryInit() has returned.
+//
+// If the linker script does not provide the deferred regions, these variables
+// are placed in .data and .bss and initialized at boot as usual.
+//
+// Example:
+//
+//   PW_BOOT_DEFERRED_DATA uint8_t lookup_table[] = {1, 2, 3, 4};
+//   PW_BOOT_DEFERRED_ZERO_INIT uint8_t log_buffer[4096];
+//
+#define PW_BOOT_DEFERRED_DATA PW_PLACE_IN_SECTION(".data.pw_boot_deferred")
+#define PW_BOOT_DEFERRED_ZERO_INIT PW_PLACE_IN_SECTION(".bss.pw_boot_deferred")
+
+// Loads the deferred static RAM region from flash and zeroes the deferred
+// zero-initialized RAM region. Only the first call has any effect. This must
+// not be called concurrently, such as from an interrupt handler while a thread
+// is calling it.
+void pw_boot_DeferredStaticMemoryInit(void);
+
+#if PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS
+
+// pw_boot_timestamps.complete is set to this once main() is invoked.
+#define PW_BOOT_TIMESTAMPS_COMPLETE 0x544D4954u  // "TIMT"
+
+// Cycle counts at the end of each phase of pw_boot_Entry(), counted from its
+// start. These are in RAM that is not initialized at boot, so that the times
+// from a boot that hung or crashed can be read after a warm reset. They are
+// overwritten after pw_boot_PreStaticMemoryInit() returns.
+typedef struct {
+  // PW_BOOT_TIMESTAMPS_COMPLETE if the last boot reached main().
+  uint32_t complete;
+
+  uint32_t pre_static_memory_init;       // pw_boot_PreStaticMemoryInit()
+  uint32_t static_memory_init;           // .data and .bss initialization
+  uint32_t pre_static_constructor_init;  // pw_boot_PreStaticConstructorInit()
+  uint32_t static_constructors;          // C++ static constructors
+  uint32_t pre_main_init;                // pw_boot_PreMainInit()
+
+  // Set when pw_boot_DeferredStaticMemoryInit() finishes.
+  uint32_t deferred_static_memory_init;
+} pw_boot_Timestamps;
+
+extern pw_boot_Timestamps pw_boot_timestamps;
+
+#endif  // PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS
+
 PW_EXTERN_C_END
@@ -0,0 +1,22 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// When enabled, pw_boot_Entry() starts the DWT cycle counter and records the
+// cycle count at the end of each boot phase into pw_boot_timestamps, which is
+// in RAM that is not initialized at boot. This requires the DWT cycle counter,
+// which ARMv6-M and ARMv8-M Baseline cores do not have. Disabled by default.
+#ifndef PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS
+#define PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS 0
+#endif  // PW_BOOT_CORTEX_M_BOOT_TIMESTAMPS
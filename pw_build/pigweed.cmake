@@ -72,6 +72,7 @@ function(pw_auto_add_simple_module MODULE)
   list(FILTER sources EXCLUDE REGEX "_test(\\.cc|(_c)?\\.c)$")  # *_test.cc
   list(FILTER sources EXCLUDE REGEX "^test(\\.cc|(_c)?\\.c)$")  # test.cc
   list(FILTER sources EXCLUDE REGEX "_fuzzer\\.cc$")
+  list(FILTER sources EXCLUDE REGEX "_benchmark\\.cc$")
 
   file(GLOB_RECURSE headers *.h)
 
@@ -324,6 +325,37 @@ function(pw_add_test NAME)
   pw_add_test_to_groups("${NAME}" ${groups})
 endfunction(pw_add_test)
 
+# Declares a benchmark. Creates an executable target that runs the benchmarks
+# in SOURCES and reports their results as JSON, and a "${NAME}.run" target
+# that runs it.
+#
+# Args:
+#
+#   NAME: name to use for the target
+#   SOURCES: source files for this benchmark
+#   DEPS: libraries on which this benchmark depends
+#
+function(pw_add_benchmark NAME)
+  _pw_parse_argv_strict(pw_add_benchmark 1 "" "" "SOURCES;DEPS")
+
+  add_executable("${NAME}" EXCLUDE_FROM_ALL ${arg_SOURCES})
+  target_link_libraries("${NAME}"
+    PRIVATE
+      pw_benchmark
+      pw_benchmark.main
+      ${arg_DEPS}
+  )
+
+  # Benchmark results are only meaningful when run in isolation, so unlike
+  # tests, running a benchmark is never part of a group.
+  add_custom_target("${NAME}.run"
+    COMMAND
+      "$<TARGET_FILE:${NAME}>"
+    DEPENDS
+      "${NAME}"
+  )
+endfunction(pw_add_benchmark)
+
 # Adds a test target to the specified test groups. Test groups can be built with
 # the pw_tests_GROUP_NAME target or executed with the pw_run_tests_GROUP_NAME
 # target.
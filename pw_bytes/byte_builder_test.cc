@@ -16,6 +16,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstring>
 
 #include "gtest/gtest.h"
 
@@ -502,6 +503,43 @@ TEST(ByteBuffer, Putting64ByteInts_Exhausted_kBigEndian) {
   EXPECT_EQ(Status::ResourceExhausted(), bb.status());
 }
 
+TEST(ByteBuffer, PuttingIntArrays_kLittleEndian) {
+  constexpr std::array<uint16_t, 2> kUint16s = {0x0102, 0x0304};
+  constexpr std::array<int32_t, 1> kInt32s = {-2};
+  ByteBuffer<8> bb;
+  bb.PutUint16s(kUint16s).PutInt32s(kInt32s);
+
+  EXPECT_EQ(OkStatus(), bb.status());
+  ASSERT_EQ(8u, bb.size());
+  constexpr auto kExpected =
+      MakeBytes(0x02, 0x01, 0x04, 0x03, 0xFE, 0xFF, 0xFF, 0xFF);
+  EXPECT_EQ(0, std::memcmp(bb.data(), kExpected.data(), kExpected.size()));
+}
+
+TEST(ByteBuffer, PuttingIntArrays_kBigEndian) {
+  constexpr std::array<uint64_t, 1> kUint64s = {0x0102030405060708};
+  constexpr std::array<int16_t, 1> kInt16s = {-2};
+  ByteBuffer<10> bb;
+  bb.PutUint64s(kUint64s, std::endian::big)
+      .PutInt16s(kInt16s, std::endian::big);
+
+  EXPECT_EQ(OkStatus(), bb.status());
+  ASSERT_EQ(10u, bb.size());
+  constexpr auto kExpected =
+      MakeBytes(0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0xFF, 0xFE);
+  EXPECT_EQ(0, std::memcmp(bb.data(), kExpected.data(), kExpected.size()));
+}
+
+TEST(ByteBuffer, PuttingIntArrays_Exhausted_WritesNothing) {
+  constexpr std::array<uint32_t, 2> kUint32s = {1, 2};
+  ByteBuffer<7> bb;
+  bb.PutUint8(0xAB);
+  bb.PutUint32s(kUint32s);
+
+  EXPECT_EQ(Status::ResourceExhausted(), bb.status());
+  EXPECT_EQ(1u, bb.size());
+}
+
 TEST(ByteBuffer, PuttingInts_MixedTypes_MixedEndian) {
   ByteBuffer<16> bb;
   bb.PutUint8(0x03);
@@ -276,5 +276,50 @@ TEST(ReadInOrder, BoundsChecking_TooSmall) {
   EXPECT_EQ(0, value);
 }
 
+TEST(ReadInOrder, Span_Little) {
+  constexpr auto buffer = Array<1, 2, 3, 4, 5, 6, 99>();
+  std::array<uint16_t, 3> values = {};
+  ASSERT_TRUE(ReadInOrder(std::endian::little, buffer, std::span(values)));
+  EXPECT_EQ(values, (std::array<uint16_t, 3>{0x0201, 0x0403, 0x0605}));
+}
+
+TEST(ReadInOrder, Span_Big) {
+  constexpr auto buffer = Array<1, 2, 3, 4, 5, 6, 7, 8>();
+  std::array<int32_t, 2> values = {};
+  ASSERT_TRUE(ReadInOrder(std::endian::big, buffer, std::span(values)));
+  EXPECT_EQ(values, (std::array<int32_t, 2>{0x01020304, 0x05060708}));
+}
+
+TEST(ReadInOrder, Span_TooSmall) {
+  constexpr auto buffer = Array<1, 2, 3, 4, 5>();
+  std::array<uint16_t, 3> values = {};
+  EXPECT_FALSE(ReadInOrder(std::endian::big, buffer, std::span(values)));
+  EXPECT_EQ(values, (std::array<uint16_t, 3>{}));
+}
+
+TEST(WriteInOrder, Span_Little) {
+  constexpr std::array<uint16_t, 2> kValues = {0x0102, 0x0304};
+  std::array<std::byte, 5> buffer = {};
+  ASSERT_TRUE(WriteInOrder(std::endian::little, std::span(kValues), buffer));
+  EXPECT_EQ(buffer, (Array<0x02, 0x01, 0x04, 0x03, 0>()));
+}
+
+TEST(WriteInOrder, Span_Big) {
+  constexpr std::array<uint64_t, 2> kValues = {0x0102030405060708,
+                                               0x1112131415161718};
+  std::array<std::byte, 16> buffer = {};
+  ASSERT_TRUE(WriteInOrder(std::endian::big, std::span(kValues), buffer));
+  EXPECT_EQ(buffer,
+            (Array<0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x11, 0x12,
+                   0x13, 0x14, 0x15, 0x16, 0x17, 0x18>()));
+}
+
+TEST(WriteInOrder, Span_TooSmall) {
+  constexpr std::array<uint32_t, 2> kValues = {1, 2};
+  std::array<std::byte, 7> buffer = {};
+  EXPECT_FALSE(WriteInOrder(std::endian::big, std::span(kValues), buffer));
+  EXPECT_EQ(buffer, (std::array<std::byte, 7>{}));
+}
+
 }  // namespace
 }  // namespace pw::bytes
@@ -0,0 +1,136 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_bytes/packed_layout.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::bytes {
+namespace {
+
+enum class Kind : uint8_t { kAccel = 1, kGyro = 2 };
+
+struct Sample {
+  uint32_t timestamp;
+  Kind kind;
+  int16_t x;
+  uint64_t unpacked;  // Not part of the layout.
+  int16_t y;
+};
+
+using BigEndianSample = PackedLayout<std::endian::big,
+                                     &Sample::timestamp,
+                                     &Sample::kind,
+                                     &Sample::x,
+                                     &Sample::y>;
+
+using LittleEndianSample = PackedLayout<std::endian::little,
+                                        &Sample::timestamp,
+                                        &Sample::kind,
+                                        &Sample::x,
+                                        &Sample::y>;
+
+static_assert(BigEndianSample::kSizeBytes == 9);
+static_assert(std::is_same_v<BigEndianSample::Struct, Sample>);
+
+constexpr Sample kSample = {.timestamp = 0x01020304,
+                            .kind = Kind::kGyro,
+                            .x = -2,
+                            .unpacked = 99,
+                            .y = 0x0a0b};
+
+constexpr auto kBigEndianSample =
+    Array<0x01, 0x02, 0x03, 0x04, 0x02, 0xff, 0xfe, 0x0a, 0x0b>();
+constexpr auto kLittleEndianSample =
+    Array<0x04, 0x03, 0x02, 0x01, 0x02, 0xfe, 0xff, 0x0b, 0x0a>();
+
+void ExpectSampleEq(const Sample& expected, const Sample& actual) {
+  EXPECT_EQ(expected.timestamp, actual.timestamp);
+  EXPECT_EQ(expected.kind, actual.kind);
+  EXPECT_EQ(expected.x, actual.x);
+  EXPECT_EQ(expected.y, actual.y);
+}
+
+TEST(PackedLayout, Write_BigEndian) {
+  std::array<std::byte, BigEndianSample::kSizeBytes> buffer = {};
+  ASSERT_TRUE(BigEndianSample::Write(kSample, buffer));
+  EXPECT_EQ(0, std::memcmp(buffer.data(), kBigEndianSample.data(), 9));
+}
+
+TEST(PackedLayout, Write_LittleEndian) {
+  std::array<std::byte, LittleEndianSample::kSizeBytes> buffer = {};
+  ASSERT_TRUE(LittleEndianSample::Write(kSample, buffer));
+  EXPECT_EQ(0, std::memcmp(buffer.data(), kLittleEndianSample.data(), 9));
+}
+
+TEST(PackedLayout, Write_BufferTooSmall) {
+  std::array<std::byte, BigEndianSample::kSizeBytes> buffer = {};
+  EXPECT_FALSE(BigEndianSample::Write(kSample, std::span(buffer).first(8)));
+  EXPECT_EQ(buffer, (std::array<std::byte, 9>{}));
+}
+
+TEST(PackedLayout, Read_BigEndian) {
+  Sample sample = {};
+  ASSERT_TRUE(BigEndianSample::Read(kBigEndianSample, sample));
+  ExpectSampleEq(kSample, sample);
+  EXPECT_EQ(0u, sample.unpacked);
+}
+
+TEST(PackedLayout, Read_LittleEndian) {
+  Sample sample = {};
+  ASSERT_TRUE(LittleEndianSample::Read(kLittleEndianSample, sample));
+  ExpectSampleEq(kSample, sample);
+}
+
+TEST(PackedLayout, Read_BufferTooSmall) {
+  Sample sample = {};
+  EXPECT_FALSE(
+      BigEndianSample::Read(std::span(kBigEndianSample).first(8), sample));
+  EXPECT_EQ(0u, sample.timestamp);
+}
+
+TEST(PackedLayout, MultipleRecords_RoundTrip) {
+  std::array<Sample, 3> samples = {kSample, kSample, kSample};
+  samples[1].timestamp = 0xaabbccdd;
+  samples[2].kind = Kind::kAccel;
+
+  std::array<std::byte, 3 * BigEndianSample::kSizeBytes> buffer = {};
+  ASSERT_TRUE(BigEndianSample::Write(std::span(samples), buffer));
+  EXPECT_EQ(0, std::memcmp(buffer.data(), kBigEndianSample.data(), 9));
+
+  std::array<Sample, 3> decoded = {};
+  ASSERT_TRUE(BigEndianSample::Read(buffer, std::span(decoded)));
+  for (size_t i = 0; i < samples.size(); ++i) {
+    ExpectSampleEq(samples[i], decoded[i]);
+  }
+}
+
+TEST(PackedLayout, MultipleRecords_BufferTooSmall) {
+  std::array<Sample, 2> samples = {kSample, kSample};
+  std::array<std::byte, 2 * BigEndianSample::kSizeBytes - 1> buffer = {};
+
+  EXPECT_FALSE(BigEndianSample::Write(std::span(samples), buffer));
+  EXPECT_EQ(buffer, (std::array<std::byte, buffer.size()>{}));
+
+  std::array<Sample, 2> decoded = {};
+  EXPECT_FALSE(BigEndianSample::Read(buffer, std::span(decoded)));
+}
+
+}  // namespace
+}  // namespace pw::bytes
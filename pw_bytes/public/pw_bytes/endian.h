@@ -187,4 +187,56 @@ template <typename T>
   return true;
 }
 
+// Reads values.size() values with the specified endianness from the buffer.
+// The buffer size is checked once for all values, after which the values are
+// copied and byte swapped in a single loop that compilers can vectorize.
+// Returns true if successful, false if the buffer is too small for the values.
+template <typename T, size_t kExtent>
+[[nodiscard]] bool ReadInOrder(std::endian order,
+                               ConstByteSpan buffer,
+                               std::span<T, kExtent> values) {
+  static_assert(std::is_integral_v<T>);
+
+  if (buffer.size() < values.size_bytes()) {
+    return false;
+  }
+
+  std::memcpy(values.data(), buffer.data(), values.size_bytes());
+
+  if (order != std::endian::native) {
+    for (T& value : values) {
+      value = internal::ReverseBytes(value);
+    }
+  }
+  return true;
+}
+
+// Writes the values to the buffer with the specified endianness. Like the bulk
+// ReadInOrder, the buffer size is checked once for all values. Returns true if
+// successful, false if the buffer is too small for the values, in which case
+// nothing is written.
+template <typename T, size_t kExtent>
+[[nodiscard]] bool WriteInOrder(std::endian order,
+                                std::span<T, kExtent> values,
+                                ByteSpan buffer) {
+  static_assert(std::is_integral_v<T>);
+
+  if (buffer.size() < values.size_bytes()) {
+    return false;
+  }
+
+  if (order == std::endian::native) {
+    std::memcpy(buffer.data(), values.data(), values.size_bytes());
+    return true;
+  }
+
+  std::byte* destination = buffer.data();
+  for (const T& value : values) {
+    const T reversed = internal::ReverseBytes(value);
+    std::memcpy(destination, &reversed, sizeof(reversed));
+    destination += sizeof(reversed);
+  }
+  return true;
+}
+
 }  // namespace pw::bytes
@@ -0,0 +1,184 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "pw_bytes/endian.h"
+#include "pw_bytes/span.h"
+
+namespace pw::bytes {
+namespace internal {
+
+template <typename T>
+struct MemberPointer;
+
+template <typename Class, typename Field>
+struct MemberPointer<Field Class::*> {
+  using class_type = Class;
+  using field_type = Field;
+};
+
+template <auto kMember>
+using MemberClass = typename MemberPointer<decltype(kMember)>::class_type;
+
+template <auto kMember>
+using MemberField = typename MemberPointer<decltype(kMember)>::field_type;
+
+// The integer type a packed field is stored as. Enums are stored as their
+// underlying type.
+template <typename T, bool = std::is_enum_v<T>>
+struct PackedStorage {
+  using type = T;
+};
+
+template <typename T>
+struct PackedStorage<T, true> {
+  using type = std::underlying_type_t<T>;
+};
+
+template <auto kMember>
+using PackedStorageOf = typename PackedStorage<MemberField<kMember>>::type;
+
+}  // namespace internal
+
+// Describes how a struct is packed into bytes: the listed members, in order,
+// each stored in sizeof(member) bytes with the specified byte order and no
+// padding between them. Members must be integers or enums.
+//
+// The layout is fixed at compile time, so each record is written or read in a
+// single pass, with one bounds check for all of its fields. Arrays of records
+// are likewise checked once.
+//
+//   struct Sample {
+//     uint32_t timestamp;
+//     int16_t x;
+//     int16_t y;
+//   };
+//
+//   using SampleLayout = pw::bytes::PackedLayout<std::endian::big,
+//                                                &Sample::timestamp,
+//                                                &Sample::x,
+//                                                &Sample::y>;
+//
+//   std::array<std::byte, SampleLayout::kSizeBytes> buffer;
+//   if (!SampleLayout::Write(sample, buffer)) { /* buffer too small */ }
+//
+template <std::endian kOrder, auto kFirstMember, auto... kMembers>
+class PackedLayout {
+ public:
+  using Struct = internal::MemberClass<kFirstMember>;
+
+  static_assert((std::is_same_v<Struct, internal::MemberClass<kMembers>> &&
+                 ...),
+                "All members of a PackedLayout must belong to the same struct");
+  static_assert(std::is_integral_v<internal::PackedStorageOf<kFirstMember>> &&
+                    (std::is_integral_v<internal::PackedStorageOf<kMembers>> &&
+                     ...),
+                "PackedLayout members must be integers or enums");
+
+  // The size of one packed record.
+  static constexpr size_t kSizeBytes =
+      (sizeof(internal::PackedStorageOf<kFirstMember>) + ... +
+       sizeof(internal::PackedStorageOf<kMembers>));
+
+  PackedLayout() = delete;
+
+  // Packs a record into the buffer. Returns false if the buffer is smaller than
+  // kSizeBytes, in which case nothing is written.
+  [[nodiscard]] static bool Write(const Struct& record, ByteSpan buffer) {
+    if (buffer.size() < kSizeBytes) {
+      return false;
+    }
+    WriteRecord(record, buffer.data());
+    return true;
+  }
+
+  // Packs the records back to back into the buffer. Returns false if the buffer
+  // is too small for all of them, in which case nothing is written.
+  [[nodiscard]] static bool Write(std::span<const Struct> records,
+                                  ByteSpan buffer) {
+    if (buffer.size() / kSizeBytes < records.size()) {
+      return false;
+    }
+
+    std::byte* destination = buffer.data();
+    for (const Struct& record : records) {
+      WriteRecord(record, destination);
+      destination += kSizeBytes;
+    }
+    return true;
+  }
+
+  // Unpacks a record from the buffer. Returns false if the buffer is smaller
+  // than kSizeBytes, in which case the record is not modified.
+  [[nodiscard]] static bool Read(ConstByteSpan buffer, Struct& record) {
+    if (buffer.size() < kSizeBytes) {
+      return false;
+    }
+    ReadRecord(buffer.data(), record);
+    return true;
+  }
+
+  // Unpacks records.size() records from the buffer. Returns false if the
+  // buffer is too small for all of them, in which case no records are
+  // modified.
+  [[nodiscard]] static bool Read(ConstByteSpan buffer,
+                                 std::span<Struct> records) {
+    if (buffer.size() / kSizeBytes < records.size()) {
+      return false;
+    }
+
+    const std::byte* source = buffer.data();
+    for (Struct& record : records) {
+      ReadRecord(source, record);
+      source += kSizeBytes;
+    }
+    return true;
+  }
+
+ private:
+  static void WriteRecord(const Struct& record, std::byte* destination) {
+    WriteField<kFirstMember>(record, destination);
+    (WriteField<kMembers>(record, destination), ...);
+  }
+
+  static void ReadRecord(const std::byte* source, Struct& record) {
+    ReadField<kFirstMember>(source, record);
+    (ReadField<kMembers>(source, record), ...);
+  }
+
+  template <auto kMember>
+  static void WriteField(const Struct& record, std::byte*& destination) {
+    using Storage = internal::PackedStorageOf<kMember>;
+    const Storage value =
+        ConvertOrderTo(kOrder, static_cast<Storage>(record.*kMember));
+    std::memcpy(destination, &value, sizeof(value));
+    destination += sizeof(value);
+  }
+
+  template <auto kMember>
+  static void ReadField(const std::byte*& source, Struct& record) {
+    using Storage = internal::PackedStorageOf<kMember>;
+    record.*kMember = static_cast<internal::MemberField<kMember>>(
+        ReadInOrder<Storage>(kOrder, source));
+    source += sizeof(Storage);
+  }
+};
+
+}  // namespace pw::bytes
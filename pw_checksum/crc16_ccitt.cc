@@ -14,6 +14,11 @@
 
 #include "pw_checksum/crc16_ccitt.h"
 
+#include <array>
+#include <cstdint>
+
+#include "pw_checksum_private/config.h"
+
 namespace pw::checksum {
 namespace {
 
@@ -52,18 +57,101 @@ constexpr uint16_t kCrc16CcittTable[256]{
     0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0,  // 256
 };
 
-}  // namespace
+// Builds the tables for slice-by-N CRC-16-CCITT. Table 0 is the bytewise
+// table; table k gives the CRC of a byte followed by k zero bytes.
+template <size_t kSlices>
+constexpr std::array<std::array<uint16_t, 256>, kSlices> MakeSliceTables() {
+  std::array<std::array<uint16_t, 256>, kSlices> tables{};
 
-extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
-                                           size_t size_bytes,
-                                           uint16_t value) {
-  const uint8_t* const array = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < 256; ++i) {
+    tables[0][i] = kCrc16CcittTable[i];
+  }
+  for (size_t slice = 1; slice < kSlices; ++slice) {
+    for (size_t i = 0; i < 256; ++i) {
+      const uint16_t previous = tables[slice - 1][i];
+      tables[slice][i] = static_cast<uint16_t>(
+          kCrc16CcittTable[previous >> 8] ^ (previous << 8));
+    }
+  }
+  return tables;
+}
+
+constexpr auto kSliceBy4Tables = MakeSliceTables<4>();
+constexpr auto kSliceBy8Tables = MakeSliceTables<8>();
 
+// Updates the CRC one byte at a time with the provided 256-entry table.
+inline uint16_t UpdateBytewise(const uint16_t* table,
+                               const uint8_t* array,
+                               size_t size_bytes,
+                               uint16_t value) {
   for (size_t i = 0; i < size_bytes; ++i) {
-    value = kCrc16CcittTable[((value >> 8) ^ array[i]) & 0xffu] ^ (value << 8);
+    value = static_cast<uint16_t>(table[((value >> 8) ^ array[i]) & 0xffu] ^
+                                  (value << 8));
   }
-
   return value;
 }
 
+// The CRC is only 16 bits, so it combines with the first two bytes of each
+// step. The remaining bytes are looked up directly.
+inline uint16_t FirstTwoBytes(const uint8_t* array, uint16_t value) {
+  return static_cast<uint16_t>(value ^ ((array[0] << 8) | array[1]));
+}
+
+}  // namespace
+
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittBytewise(const void* data,
+                                                            size_t size_bytes,
+                                                            uint16_t value) {
+  return UpdateBytewise(
+      kCrc16CcittTable, static_cast<const uint8_t*>(data), size_bytes, value);
+}
+
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittSliceBy4(const void* data,
+                                                            size_t size_bytes,
+                                                            uint16_t value) {
+  const auto& t = kSliceBy4Tables;
+  const uint8_t* array = static_cast<const uint8_t*>(data);
+
+  for (; size_bytes >= 4; size_bytes -= 4, array += 4) {
+    const uint16_t first = FirstTwoBytes(array, value);
+    value = t[3][first >> 8] ^ t[2][first & 0xffu] ^ t[1][array[2]] ^
+            t[0][array[3]];
+  }
+
+  // Table 0 is the bytewise table, so kCrc16CcittTable need not be linked in.
+  return UpdateBytewise(t[0].data(), array, size_bytes, value);
+}
+
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittSliceBy8(const void* data,
+                                                            size_t size_bytes,
+                                                            uint16_t value) {
+  const auto& t = kSliceBy8Tables;
+  const uint8_t* array = static_cast<const uint8_t*>(data);
+
+  for (; size_bytes >= 8; size_bytes -= 8, array += 8) {
+    const uint16_t first = FirstTwoBytes(array, value);
+    value = t[7][first >> 8] ^ t[6][first & 0xffu] ^ t[5][array[2]] ^
+            t[4][array[3]] ^ t[3][array[4]] ^ t[2][array[5]] ^
+            t[1][array[6]] ^ t[0][array[7]];
+  }
+
+  return UpdateBytewise(t[0].data(), array, size_bytes, value);
+}
+
+extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
+                                           size_t size_bytes,
+                                           uint16_t value) {
+#if PW_CHECKSUM_CRC16_CCITT_IMPL == PW_CHECKSUM_CRC16_CCITT_IMPL_BYTEWISE
+  return _pw_checksum_InternalCrc16CcittBytewise(data, size_bytes, value);
+#elif PW_CHECKSUM_CRC16_CCITT_IMPL == PW_CHECKSUM_CRC16_CCITT_IMPL_SLICE_BY_4
+  return _pw_checksum_InternalCrc16CcittSliceBy4(data, size_bytes, value);
+#elif PW_CHECKSUM_CRC16_CCITT_IMPL == PW_CHECKSUM_CRC16_CCITT_IMPL_SLICE_BY_8
+  return _pw_checksum_InternalCrc16CcittSliceBy8(data, size_bytes, value);
+#elif PW_CHECKSUM_CRC16_CCITT_IMPL == PW_CHECKSUM_CRC16_CCITT_IMPL_STM32
+  return _pw_checksum_InternalCrc16CcittStm32(data, size_bytes, value);
+#else
+#error "Unsupported PW_CHECKSUM_CRC16_CCITT_IMPL value"
+#endif  // PW_CHECKSUM_CRC16_CCITT_IMPL
+}
+
 }  // namespace pw::checksum
@@ -0,0 +1,67 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+// Compares the CRC-16-CCITT implementations. The selected implementation is
+// what pw_kvs uses for its default entry checksum.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_benchmark/benchmark.h"
+#include "pw_checksum/crc16_ccitt.h"
+
+namespace pw::checksum {
+namespace {
+
+using Crc16CcittFunction = uint16_t (*)(const void*, size_t, uint16_t);
+
+std::array<std::byte, 1024> data = {};
+
+void Run(benchmark::State& state, Crc16CcittFunction function) {
+  const size_t size = size_t(state.argument());
+  state.set_bytes_per_iteration(size);
+
+  while (state.KeepRunning()) {
+    uint16_t crc = function(data.data(), size, Crc16Ccitt::kInitialValue);
+    benchmark::DoNotOptimize(crc);
+  }
+}
+
+void BM_Crc16CcittBytewise(benchmark::State& state) {
+  Run(state, _pw_checksum_InternalCrc16CcittBytewise);
+}
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc16CcittBytewise, 16);
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc16CcittBytewise, 1024);
+
+void BM_Crc16CcittSliceBy4(benchmark::State& state) {
+  Run(state, _pw_checksum_InternalCrc16CcittSliceBy4);
+}
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc16CcittSliceBy4, 16);
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc16CcittSliceBy4, 1024);
+
+void BM_Crc16CcittSliceBy8(benchmark::State& state) {
+  Run(state, _pw_checksum_InternalCrc16CcittSliceBy8);
+}
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc16CcittSliceBy8, 16);
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc16CcittSliceBy8, 1024);
+
+// The implementation selected by PW_CHECKSUM_CRC16_CCITT_IMPL.
+void BM_Crc16Ccitt(benchmark::State& state) {
+  Run(state, pw_checksum_Crc16Ccitt);
+}
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc16Ccitt, 16);
+PW_BENCHMARK_WITH_ARGUMENT(BM_Crc16Ccitt, 1024);
+
+}  // namespace
+}  // namespace pw::checksum
@@ -14,6 +14,7 @@
 
 #include "pw_checksum/crc16_ccitt.h"
 
+#include <array>
 #include <string_view>
 
 #include "gtest/gtest.h"
@@ -69,6 +70,57 @@ TEST(Crc16Class, String) {
   EXPECT_EQ(crc16.value(), kStringCrc);
 }
 
+using Crc16CcittFunction = uint16_t (*)(const void*, size_t, uint16_t);
+
+// Fills a buffer with a pseudorandom sequence for comparing implementations.
+constexpr std::array<uint8_t, 512> MakeTestData() {
+  std::array<uint8_t, 512> data{};
+  uint32_t value = 0x12345678;
+  for (uint8_t& byte : data) {
+    value = value * 1103515245u + 12345u;
+    byte = static_cast<uint8_t>(value >> 16);
+  }
+  return data;
+}
+
+constexpr std::array<uint8_t, 512> kTestData = MakeTestData();
+
+// Checks an implementation against known values and against the bytewise
+// implementation for every length and alignment offset of the test data.
+void ExpectMatchesBytewise(Crc16CcittFunction function) {
+  constexpr uint16_t kInitial = Crc16Ccitt::kInitialValue;
+  EXPECT_EQ(function(kBytes, sizeof(kBytes), kInitial), kBufferCrc);
+  EXPECT_EQ(function(kString.data(), kString.size(), kInitial), kStringCrc);
+  EXPECT_EQ(function(nullptr, 0, kInitial), kInitial);
+
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t size = 0; size <= kTestData.size() - offset; ++size) {
+      const uint8_t* data = kTestData.data() + offset;
+      ASSERT_EQ(function(data, size, kInitial),
+                _pw_checksum_InternalCrc16CcittBytewise(data, size, kInitial));
+    }
+  }
+
+  // Appending must give the same result as a single calculation.
+  uint16_t value = function(kTestData.data(), 100, kInitial);
+  value = function(kTestData.data() + 100, kTestData.size() - 100, value);
+  EXPECT_EQ(value,
+            _pw_checksum_InternalCrc16CcittBytewise(
+                kTestData.data(), kTestData.size(), kInitial));
+}
+
+TEST(Crc16Implementation, Bytewise) {
+  ExpectMatchesBytewise(_pw_checksum_InternalCrc16CcittBytewise);
+}
+
+TEST(Crc16Implementation, SliceBy4) {
+  ExpectMatchesBytewise(_pw_checksum_InternalCrc16CcittSliceBy4);
+}
+
+TEST(Crc16Implementation, SliceBy8) {
+  ExpectMatchesBytewise(_pw_checksum_InternalCrc16CcittSliceBy8);
+}
+
 extern "C" uint16_t CallChecksumCrc16Ccitt(const void* data, size_t size_bytes);
 
 TEST(Crc16FromC, Buffer) {
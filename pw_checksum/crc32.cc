@@ -14,6 +14,19 @@
 
 #include "pw_checksum/crc32.h"
 
+#include <array>
+#include <cstdint>
+
+#include "pw_checksum_private/config.h"
+
+#if _PW_CHECKSUM_CRC32_HAS_ARMV8
+#include <arm_acle.h>
+#endif  // _PW_CHECKSUM_CRC32_HAS_ARMV8
+
+#if _PW_CHECKSUM_CRC32_HAS_PCLMUL
+#include <immintrin.h>
+#endif  // _PW_CHECKSUM_CRC32_HAS_PCLMUL
+
 namespace pw::checksum {
 namespace {
 
@@ -62,18 +75,231 @@ constexpr uint32_t kCrc32Table[] = {
     0x54de5729, 0x23d967bf, 0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
     0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d};
 
+// Builds the tables for slice-by-N CRC32. Table 0 is the bytewise table; table
+// k gives the CRC of a byte followed by k zero bytes.
+template <size_t kSlices>
+constexpr std::array<std::array<uint32_t, 256>, kSlices> MakeSliceTables() {
+  std::array<std::array<uint32_t, 256>, kSlices> tables{};
+
+  for (size_t i = 0; i < 256; ++i) {
+    tables[0][i] = kCrc32Table[i];
+  }
+  for (size_t slice = 1; slice < kSlices; ++slice) {
+    for (size_t i = 0; i < 256; ++i) {
+      const uint32_t previous = tables[slice - 1][i];
+      tables[slice][i] = (previous >> 8) ^ kCrc32Table[previous & 0xFFu];
+    }
+  }
+  return tables;
+}
+
+constexpr auto kSliceBy4Tables = MakeSliceTables<4>();
+constexpr auto kSliceBy8Tables = MakeSliceTables<8>();
+
+// Loads a little-endian uint32_t from an arbitrarily aligned address.
+inline uint32_t LoadLittleEndian32(const uint8_t* bytes) {
+  return uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8) |
+         (uint32_t(bytes[2]) << 16) | (uint32_t(bytes[3]) << 24);
+}
+
+// Updates the CRC one byte at a time with the provided 256-entry table.
+inline uint32_t UpdateBytewise(const uint32_t* table,
+                               const uint8_t* array,
+                               size_t size_bytes,
+                               uint32_t state) {
+  for (size_t i = 0; i < size_bytes; ++i) {
+    state = table[(state ^ array[i]) & 0xFFu] ^ (state >> 8);
+  }
+  return state;
+}
+
 }  // namespace
 
-extern "C" uint32_t _pw_checksum_InternalCrc32(const void* data,
-                                               size_t size_bytes,
-                                               uint32_t state) {
+extern "C" uint32_t _pw_checksum_InternalCrc32Bytewise(const void* data,
+                                                       size_t size_bytes,
+                                                       uint32_t state) {
+  return UpdateBytewise(
+      kCrc32Table, static_cast<const uint8_t*>(data), size_bytes, state);
+}
+
+extern "C" uint32_t _pw_checksum_InternalCrc32SliceBy4(const void* data,
+                                                       size_t size_bytes,
+                                                       uint32_t state) {
+  const auto& t = kSliceBy4Tables;
   const uint8_t* array = static_cast<const uint8_t*>(data);
 
-  for (size_t i = 0; i < size_bytes; ++i) {
-    state = kCrc32Table[(state ^ array[i]) & 0xFFu] ^ (state >> 8);
+  for (; size_bytes >= 4; size_bytes -= 4, array += 4) {
+    const uint32_t word = LoadLittleEndian32(array) ^ state;
+    state = t[3][word & 0xFFu] ^ t[2][(word >> 8) & 0xFFu] ^
+            t[1][(word >> 16) & 0xFFu] ^ t[0][word >> 24];
+  }
+
+  // Table 0 is the bytewise table, so kCrc32Table need not be linked in.
+  return UpdateBytewise(t[0].data(), array, size_bytes, state);
+}
+
+extern "C" uint32_t _pw_checksum_InternalCrc32SliceBy8(const void* data,
+                                                       size_t size_bytes,
+                                                       uint32_t state) {
+  const auto& t = kSliceBy8Tables;
+  const uint8_t* array = static_cast<const uint8_t*>(data);
+
+  for (; size_bytes >= 8; size_bytes -= 8, array += 8) {
+    const uint32_t low = LoadLittleEndian32(array) ^ state;
+    const uint32_t high = LoadLittleEndian32(array + 4);
+    state = t[7][low & 0xFFu] ^ t[6][(low >> 8) & 0xFFu] ^
+            t[5][(low >> 16) & 0xFFu] ^ t[4][low >> 24] ^
+            t[3][high & 0xFFu] ^ t[2][(high >> 8) & 0xFFu] ^
+            t[1][(high >> 16) & 0xFFu] ^ t[0][high >> 24];
+  }
+
+  return UpdateBytewise(t[0].data(), array, size_bytes, state);
+}
+
+#if _PW_CHECKSUM_CRC32_HAS_ARMV8
+
+extern "C" uint32_t _pw_checksum_InternalCrc32Armv8(const void* data,
+                                                    size_t size_bytes,
+                                                    uint32_t state) {
+  const uint8_t* array = static_cast<const uint8_t*>(data);
+
+  for (; size_bytes >= 4; size_bytes -= 4, array += 4) {
+    state = __crc32w(state, LoadLittleEndian32(array));
+  }
+  for (; size_bytes > 0; --size_bytes, ++array) {
+    state = __crc32b(state, *array);
   }
 
   return state;
 }
 
+#endif  // _PW_CHECKSUM_CRC32_HAS_ARMV8
+
+#if _PW_CHECKSUM_CRC32_HAS_PCLMUL
+
+#define _PW_CHECKSUM_PCLMUL_TARGET __attribute__((target("pclmul,sse4.1")))
+
+namespace {
+
+_PW_CHECKSUM_PCLMUL_TARGET inline __m128i Load128(const uint8_t* bytes) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+}
+
+// Folds a 128-bit value forward by the distance encoded in k and combines it
+// with the next 128 bits of input.
+_PW_CHECKSUM_PCLMUL_TARGET inline __m128i Fold128(__m128i value,
+                                                   __m128i next,
+                                                   __m128i k) {
+  const __m128i low = _mm_clmulepi64_si128(value, k, 0x00);
+  value = _mm_clmulepi64_si128(value, k, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(value, next), low);
+}
+
+}  // namespace
+
+// Folds the input 64 bytes at a time with carry-less multiplication, as
+// described in "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+// Instruction" (Gopal et al., Intel, 2009). The constants are for the
+// bit-reflected CRC32 polynomial. Inputs shorter than 64 bytes and any trailing
+// bytes use the bytewise implementation.
+extern "C" _PW_CHECKSUM_PCLMUL_TARGET uint32_t
+_pw_checksum_InternalCrc32Pclmul(const void* data,
+                                 size_t size_bytes,
+                                 uint32_t state) {
+  const uint8_t* array = static_cast<const uint8_t*>(data);
+
+  if (size_bytes < 64) {
+    return _pw_checksum_InternalCrc32Bytewise(array, size_bytes, state);
+  }
+
+  alignas(16) static constexpr uint64_t kK1K2[] = {0x0154442bd4, 0x01c6e41596};
+  alignas(16) static constexpr uint64_t kK3K4[] = {0x01751997d0, 0x00ccaa009e};
+  alignas(16) static constexpr uint64_t kK5K0[] = {0x0163cd6124, 0x0000000000};
+  alignas(16) static constexpr uint64_t kPoly[] = {0x01db710641, 0x01f7011641};
+
+  __m128i x1 = Load128(array);
+  __m128i x2 = Load128(array + 16);
+  __m128i x3 = Load128(array + 32);
+  __m128i x4 = Load128(array + 48);
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(state)));
+
+  __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(kK1K2));
+  array += 64;
+  size_bytes -= 64;
+
+  // Fold four 128-bit lanes in parallel.
+  for (; size_bytes >= 64; size_bytes -= 64, array += 64) {
+    const __m128i x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+    const __m128i x6 = _mm_clmulepi64_si128(x2, k, 0x00);
+    const __m128i x7 = _mm_clmulepi64_si128(x3, k, 0x00);
+    const __m128i x8 = _mm_clmulepi64_si128(x4, k, 0x00);
+
+    x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, k, 0x11);
+
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), Load128(array));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), Load128(array + 16));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), Load128(array + 32));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), Load128(array + 48));
+  }
+
+  // Fold the four lanes into one.
+  k = _mm_load_si128(reinterpret_cast<const __m128i*>(kK3K4));
+  x1 = Fold128(x1, x2, k);
+  x1 = Fold128(x1, x3, k);
+  x1 = Fold128(x1, x4, k);
+
+  // Fold any remaining 16-byte blocks.
+  for (; size_bytes >= 16; size_bytes -= 16, array += 16) {
+    x1 = Fold128(x1, Load128(array), k);
+  }
+
+  // Reduce 128 bits to 64 bits.
+  const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+  x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+  k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(kK5K0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits.
+  k = _mm_load_si128(reinterpret_cast<const __m128i*>(kPoly));
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  state = static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+  return _pw_checksum_InternalCrc32Bytewise(array, size_bytes, state);
+}
+
+#endif  // _PW_CHECKSUM_CRC32_HAS_PCLMUL
+
+extern "C" uint32_t _pw_checksum_InternalCrc32(const void* data,
+                                               size_t size_bytes,
+                                               uint32_t state) {
+#if PW_CHECKSUM_CRC32_IMPL == PW_CHECKSUM_CRC32_IMPL_BYTEWISE
+  return _pw_checksum_InternalCrc32Bytewise(data, size_bytes, state);
+#elif PW_CHECKSUM_CRC32_IMPL == PW_CHECKSUM_CRC32_IMPL_SLICE_BY_4
+  return _pw_checksum_InternalCrc32SliceBy4(data, size_bytes, state);
+#elif PW_CHECKSUM_CRC32_IMPL == PW_CHECKSUM_CRC32_IMPL_SLICE_BY_8
+  return _pw_checksum_InternalCrc32SliceBy8(data, size_bytes, state);
+#elif PW_CHECKSUM_CRC32_IMPL == PW_CHECKSUM_CRC32_IMPL_ARMV8
+#if !_PW_CHECKSUM_CRC32_HAS_ARMV8
+#error "PW_CHECKSUM_CRC32_IMPL_ARMV8 requires __ARM_FEATURE_CRC32"
+#endif  // !_PW_CHECKSUM_CRC32_HAS_ARMV8
+  return _pw_checksum_InternalCrc32Armv8(data, size_bytes, state);
+#elif PW_CHECKSUM_CRC32_IMPL == PW_CHECKSUM_CRC32_IMPL_PCLMUL
+#if !_PW_CHECKSUM_CRC32_HAS_PCLMUL
+#error "PW_CHECKSUM_CRC32_IMPL_PCLMUL requires an x86 target"
+#endif  // !_PW_CHECKSUM_CRC32_HAS_PCLMUL
+  return _pw_checksum_InternalCrc32Pclmul(data, size_bytes, state);
+#else
+#error "Unsupported PW_CHECKSUM_CRC32_IMPL value"
+#endif  // PW_CHECKSUM_CRC32_IMPL
+}
+
 }  // namespace pw::checksum
@@ -13,6 +13,7 @@
 // the License.
 #include "pw_checksum/crc32.h"
 
+#include <array>
 #include <span>
 #include <string_view>
 
@@ -77,6 +78,73 @@ TEST(Crc32Class, String) {
   EXPECT_EQ(crc32.value(), kStringCrc);
 }
 
+using Crc32Function = uint32_t (*)(const void*, size_t, uint32_t);
+
+uint32_t Finalize(Crc32Function function, const void* data, size_t size) {
+  return ~function(data, size, _PW_CHECKSUM_CRC32_INITIAL_STATE);
+}
+
+// Fills a buffer with a pseudorandom sequence for comparing implementations.
+constexpr std::array<uint8_t, 512> MakeTestData() {
+  std::array<uint8_t, 512> data{};
+  uint32_t value = 0x12345678;
+  for (uint8_t& byte : data) {
+    value = value * 1103515245u + 12345u;
+    byte = static_cast<uint8_t>(value >> 16);
+  }
+  return data;
+}
+
+constexpr std::array<uint8_t, 512> kTestData = MakeTestData();
+
+// Checks an implementation against known values and against the bytewise
+// implementation for every length and alignment offset of the test data.
+void ExpectMatchesBytewise(Crc32Function function) {
+  EXPECT_EQ(Finalize(function, kBytes.data(), kBytes.size()), kBufferCrc);
+  EXPECT_EQ(Finalize(function, kString.data(), kString.size()), kStringCrc);
+  EXPECT_EQ(Finalize(function, nullptr, 0), PW_CHECKSUM_EMPTY_CRC32);
+
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t size = 0; size <= kTestData.size() - offset; ++size) {
+      const uint8_t* data = kTestData.data() + offset;
+      ASSERT_EQ(Finalize(function, data, size),
+                Finalize(_pw_checksum_InternalCrc32Bytewise, data, size));
+    }
+  }
+
+  // Appending must give the same result as a single calculation.
+  uint32_t state = _PW_CHECKSUM_CRC32_INITIAL_STATE;
+  state = function(kTestData.data(), 100, state);
+  state = function(kTestData.data() + 100, kTestData.size() - 100, state);
+  EXPECT_EQ(~state,
+            Finalize(_pw_checksum_InternalCrc32Bytewise,
+                     kTestData.data(),
+                     kTestData.size()));
+}
+
+TEST(Crc32Implementation, SliceBy4) {
+  ExpectMatchesBytewise(_pw_checksum_InternalCrc32SliceBy4);
+}
+
+TEST(Crc32Implementation, SliceBy8) {
+  ExpectMatchesBytewise(_pw_checksum_InternalCrc32SliceBy8);
+}
+
+#if _PW_CHECKSUM_CRC32_HAS_ARMV8
+TEST(Crc32Implementation, Armv8) {
+  ExpectMatchesBytewise(_pw_checksum_InternalCrc32Armv8);
+}
+#endif  // _PW_CHECKSUM_CRC32_HAS_ARMV8
+
+#if _PW_CHECKSUM_CRC32_HAS_PCLMUL
+TEST(Crc32Implementation, Pclmul) {
+  if (!__builtin_cpu_supports("pclmul") || !__builtin_cpu_supports("sse4.1")) {
+    return;  // This CPU cannot run the PCLMULQDQ implementation.
+  }
+  ExpectMatchesBytewise(_pw_checksum_InternalCrc32Pclmul);
+}
+#endif  // _PW_CHECKSUM_CRC32_HAS_PCLMUL
+
 extern "C" uint32_t CallChecksumCrc32(const void* data, size_t size_bytes);
 extern "C" uint32_t CallChecksumCrc32Append(const void* data,
                                             size_t size_bytes,
@@ -32,6 +32,27 @@ uint16_t pw_checksum_Crc16Ccitt(const void* data,
                                 size_t size_bytes,
                                 uint16_t initial_value);
 
+// Internal CRC-16-CCITT implementations. pw_checksum_Crc16Ccitt calls the one
+// selected by the PW_CHECKSUM_CRC16_CCITT_IMPL configuration option. Do not
+// call these directly.
+uint16_t _pw_checksum_InternalCrc16CcittBytewise(const void* data,
+                                                 size_t size_bytes,
+                                                 uint16_t value);
+
+uint16_t _pw_checksum_InternalCrc16CcittSliceBy4(const void* data,
+                                                 size_t size_bytes,
+                                                 uint16_t value);
+
+uint16_t _pw_checksum_InternalCrc16CcittSliceBy8(const void* data,
+                                                 size_t size_bytes,
+                                                 uint16_t value);
+
+// Uses the STM32 CRC peripheral. Only defined if the
+// $dir_pw_checksum:stm32_crc16_ccitt target is linked in.
+uint16_t _pw_checksum_InternalCrc16CcittStm32(const void* data,
+                                              size_t size_bytes,
+                                              uint16_t value);
+
 #ifdef __cplusplus
 }  // extern "C"
 
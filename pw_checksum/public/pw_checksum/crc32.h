@@ -37,6 +37,41 @@ uint32_t _pw_checksum_InternalCrc32(const void* data,
                                     size_t size_bytes,
                                     uint32_t state);
 
+// Internal CRC32 implementations. _pw_checksum_InternalCrc32 calls the one
+// selected by the PW_CHECKSUM_CRC32_IMPL configuration option. Do not call
+// these directly.
+uint32_t _pw_checksum_InternalCrc32Bytewise(const void* data,
+                                            size_t size_bytes,
+                                            uint32_t state);
+
+uint32_t _pw_checksum_InternalCrc32SliceBy4(const void* data,
+                                            size_t size_bytes,
+                                            uint32_t state);
+
+uint32_t _pw_checksum_InternalCrc32SliceBy8(const void* data,
+                                            size_t size_bytes,
+                                            uint32_t state);
+
+#if defined(__ARM_FEATURE_CRC32)
+#define _PW_CHECKSUM_CRC32_HAS_ARMV8 1
+uint32_t _pw_checksum_InternalCrc32Armv8(const void* data,
+                                         size_t size_bytes,
+                                         uint32_t state);
+#else
+#define _PW_CHECKSUM_CRC32_HAS_ARMV8 0
+#endif  // defined(__ARM_FEATURE_CRC32)
+
+// The PCLMULQDQ implementation is compiled for any x86 target, but may only be
+// called if the CPU supports PCLMULQDQ and SSE4.1.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define _PW_CHECKSUM_CRC32_HAS_PCLMUL 1
+uint32_t _pw_checksum_InternalCrc32Pclmul(const void* data,
+                                          size_t size_bytes,
+                                          uint32_t state);
+#else
+#define _PW_CHECKSUM_CRC32_HAS_PCLMUL 0
+#endif  // x86 and GCC or Clang
+
 // Calculates the CRC32 for the provided data.
 static inline uint32_t pw_checksum_Crc32(const void* data, size_t size_bytes) {
   return ~_pw_checksum_InternalCrc32(
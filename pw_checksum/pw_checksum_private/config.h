@@ -0,0 +1,64 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Configuration macros for the pw_checksum module.
+#pragma once
+
+// CRC32 implementations that may be selected with PW_CHECKSUM_CRC32_IMPL.
+//
+// Byte-at-a-time lookup with a 256-entry (1 KiB) table.
+#define PW_CHECKSUM_CRC32_IMPL_BYTEWISE 1
+// Processes 4 bytes per step using four 256-entry (4 KiB total) tables.
+#define PW_CHECKSUM_CRC32_IMPL_SLICE_BY_4 4
+// Processes 8 bytes per step using eight 256-entry (8 KiB total) tables.
+#define PW_CHECKSUM_CRC32_IMPL_SLICE_BY_8 8
+// Uses the ARMv8 CRC32 instructions. Requires __ARM_FEATURE_CRC32 (e.g.
+// -march=armv8-a+crc).
+#define PW_CHECKSUM_CRC32_IMPL_ARMV8 100
+// Folds 64-byte blocks with the x86 PCLMULQDQ instruction. The target CPU must
+// support PCLMULQDQ and SSE4.1.
+#define PW_CHECKSUM_CRC32_IMPL_PCLMUL 101
+
+// Which implementation backs the CRC32 functions and the Crc32 class. Defaults
+// to the smallest implementation.
+#ifndef PW_CHECKSUM_CRC32_IMPL
+#define PW_CHECKSUM_CRC32_IMPL PW_CHECKSUM_CRC32_IMPL_BYTEWISE
+#endif  // PW_CHECKSUM_CRC32_IMPL
+
+// CRC-16-CCITT implementations that may be selected with
+// PW_CHECKSUM_CRC16_CCITT_IMPL.
+//
+// Byte-at-a-time lookup with a 256-entry (512 B) table.
+#define PW_CHECKSUM_CRC16_CCITT_IMPL_BYTEWISE 1
+// Processes 4 bytes per step using four 256-entry (2 KiB total) tables.
+#define PW_CHECKSUM_CRC16_CCITT_IMPL_SLICE_BY_4 4
+// Processes 8 bytes per step using eight 256-entry (4 KiB total) tables.
+#define PW_CHECKSUM_CRC16_CCITT_IMPL_SLICE_BY_8 8
+// Uses the CRC peripheral of STM32 parts with a programmable polynomial (e.g.
+// STM32F0, F3, F7, L4 and G4). The $dir_pw_checksum:stm32_crc16_ccitt target
+// must be linked in, and the peripheral clock must be enabled before use.
+#define PW_CHECKSUM_CRC16_CCITT_IMPL_STM32 200
+
+// Which implementation backs pw_checksum_Crc16Ccitt and the Crc16Ccitt class.
+// Defaults to the smallest implementation.
+#ifndef PW_CHECKSUM_CRC16_CCITT_IMPL
+#define PW_CHECKSUM_CRC16_CCITT_IMPL PW_CHECKSUM_CRC16_CCITT_IMPL_BYTEWISE
+#endif  // PW_CHECKSUM_CRC16_CCITT_IMPL
+
+// The base address of the STM32 CRC peripheral, used by
+// PW_CHECKSUM_CRC16_CCITT_IMPL_STM32. The default is correct for the STM32F0,
+// F3, F7, L4 and G4 families.
+#ifndef PW_CHECKSUM_STM32_CRC_BASE
+#define PW_CHECKSUM_STM32_CRC_BASE 0x40023000u
+#endif  // PW_CHECKSUM_STM32_CRC_BASE
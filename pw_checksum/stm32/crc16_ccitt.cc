@@ -0,0 +1,81 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+// CRC-16-CCITT using the CRC peripheral of STM32 parts with a programmable
+// polynomial. The peripheral is reprogrammed on every call, so it may be shared
+// with other users, such as a CRC-32 calculation, as long as they also
+// configure it before use.
+
+#include <cstdint>
+#include <mutex>
+
+#include "pw_checksum/crc16_ccitt.h"
+#include "pw_checksum_private/config.h"
+#include "pw_sync/interrupt_spin_lock.h"
+
+namespace pw::checksum {
+namespace {
+
+struct CrcRegisters {
+  volatile uint32_t data;
+  volatile uint32_t independent_data;
+  volatile uint32_t control;
+  uint32_t reserved;
+  volatile uint32_t initial_value;
+  volatile uint32_t polynomial;
+};
+
+constexpr uint32_t kControlReset = 1u << 0;
+constexpr uint32_t kControlPolynomialSize16 = 0b01u << 3;
+
+constexpr uint32_t kCrc16CcittPolynomial = 0x1021;
+
+CrcRegisters& crc_registers =
+    *reinterpret_cast<CrcRegisters*>(PW_CHECKSUM_STM32_CRC_BASE);
+
+// The peripheral holds the state of one calculation at a time.
+sync::InterruptSpinLock crc_lock;
+
+}  // namespace
+
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittStm32(const void* data,
+                                                         size_t size_bytes,
+                                                         uint16_t value) {
+  const uint8_t* array = static_cast<const uint8_t*>(data);
+
+  std::lock_guard lock(crc_lock);
+
+  // Input and output are not bit-reversed, which matches CRC-16-CCITT. The
+  // reset bit loads the initial value into the data register.
+  crc_registers.polynomial = kCrc16CcittPolynomial;
+  crc_registers.initial_value = value;
+  crc_registers.control = kControlPolynomialSize16 | kControlReset;
+
+  // Word writes are processed most significant byte first, so load the bytes
+  // in big-endian order. This also avoids unaligned accesses.
+  for (; size_bytes >= 4; size_bytes -= 4, array += 4) {
+    crc_registers.data = (uint32_t(array[0]) << 24) |
+                         (uint32_t(array[1]) << 16) |
+                         (uint32_t(array[2]) << 8) | uint32_t(array[3]);
+  }
+
+  volatile uint8_t& data_byte =
+      *reinterpret_cast<volatile uint8_t*>(&crc_registers.data);
+  for (; size_bytes > 0; --size_bytes, ++array) {
+    data_byte = *array;
+  }
+
+  return static_cast<uint16_t>(crc_registers.data);
+}
+
+}  // namespace pw::checksum
@@ -0,0 +1,96 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/profiling_clock.h"
+
+#include <chrono>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_chrono/internal/counter_extender.h"
+
+namespace pw::chrono {
+namespace {
+
+TEST(ProfilingClock, Now_IsMonotonic) {
+  ProfilingClock::time_point previous = ProfilingClock::now();
+  for (int i = 0; i < 1000; ++i) {
+    const ProfilingClock::time_point now = ProfilingClock::now();
+    ASSERT_GE(now, previous);
+    previous = now;
+  }
+}
+
+TEST(ProfilingClock, Counter_Advances) {
+  const ProfilingClock::Counter start = ProfilingClock::counter();
+  ProfilingClock::Counter end;
+  do {
+    end = ProfilingClock::counter();
+  } while (end == start);
+  EXPECT_GT(ProfilingClock::Elapsed(start, end).count(), 0);
+}
+
+TEST(ProfilingClock, Elapsed_AcrossWraparound) {
+  constexpr ProfilingClock::Counter kMax = ~ProfilingClock::Counter{0};
+  static_assert(ProfilingClock::Elapsed(kMax - 1, 3).count() == 5);
+  static_assert(ProfilingClock::Elapsed(10, 10).count() == 0);
+}
+
+TEST(ProfilingClock, TicksPerSecond_MatchesPeriod) {
+  EXPECT_EQ(
+      ProfilingClock::kTicksPerSecond,
+      static_cast<uint64_t>(
+          std::chrono::duration_cast<ProfilingClock::duration>(
+              std::chrono::seconds(1))
+              .count()));
+}
+
+TEST(CounterExtender, NoWraparound) {
+  internal::CounterExtender extender;
+  EXPECT_EQ(extender.Extend([] { return 0u; }), 0);
+  EXPECT_EQ(extender.Extend([] { return 0x7fffffffu; }), 0x7fffffff);
+  EXPECT_EQ(extender.Extend([] { return 0xfffffff0u; }), 0xfffffff0);
+}
+
+TEST(CounterExtender, CountsWraparounds) {
+  internal::CounterExtender extender;
+  uint32_t counter = 0;
+  auto read = [&counter] { return counter; };
+
+  counter = 0xc0000000u;
+  EXPECT_EQ(extender.Extend(read), 0xc0000000);
+  counter = 0x10u;
+  EXPECT_EQ(extender.Extend(read), 0x100000010);
+  counter = 0x90000000u;
+  EXPECT_EQ(extender.Extend(read), 0x190000000);
+  counter = 0x5u;
+  EXPECT_EQ(extender.Extend(read), 0x200000005);
+}
+
+TEST(CounterExtender, RepeatedReadsWithinHalfPeriod_StaySteady) {
+  internal::CounterExtender extender;
+  uint32_t counter = 0;
+  auto read = [&counter] { return counter; };
+
+  int64_t previous = 0;
+  for (int i = 0; i < 64; ++i) {
+    counter += 0x20000000u;  // An eighth of the wrap period.
+    const int64_t extended = extender.Extend(read);
+    EXPECT_EQ(extended - previous, 0x20000000);
+    previous = extended;
+  }
+}
+
+}  // namespace
+}  // namespace pw::chrono
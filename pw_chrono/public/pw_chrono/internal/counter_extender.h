@@ -0,0 +1,64 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace pw::chrono::internal {
+
+// Extends a free-running 32-bit counter to 63 bits by counting wraparounds.
+// The counter must be read at least once per half of its wrap period, since a
+// wrap is detected by the counter's most significant bit going from 1 to 0.
+//
+// Extend() is lock free, so it may be called from threads and interrupts
+// concurrently. The state is updated with a compare-and-swap after reading
+// the counter, and the counter is read again if another caller updated the
+// state in between.
+class CounterExtender {
+ public:
+  constexpr CounterExtender() : state_(0) {}
+
+  CounterExtender(const CounterExtender&) = delete;
+  CounterExtender& operator=(const CounterExtender&) = delete;
+
+  // Reads the counter with read_counter() and returns the extended value.
+  template <typename ReadCounter>
+  int64_t Extend(ReadCounter&& read_counter) {
+    uint32_t state = state_.load(std::memory_order_acquire);
+    while (true) {
+      const uint32_t count = read_counter();
+      const uint32_t high_bit = count >> 31;
+
+      // The state is the wrap count shifted left by one, with the most
+      // significant bit of the previous reading in bit 0.
+      uint32_t wraps = state >> 1;
+      if ((state & 1u) != 0u && high_bit == 0u) {
+        wraps += 1;
+      }
+
+      if (state_.compare_exchange_weak(state,
+                                       (wraps << 1) | high_bit,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+        return static_cast<int64_t>((uint64_t{wraps} << 32) | count);
+      }
+    }
+  }
+
+ private:
+  std::atomic<uint32_t> state_;
+};
+
+}  // namespace pw::chrono::internal
@@ -0,0 +1,123 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <stdint.h>
+
+// The backend implements this header to provide the following ProfilingClock
+// parameters, for more detail on the parameters see the ProfilingClock usage
+// of them below:
+//   PW_CHRONO_PROFILING_CLOCK_PERIOD_SECONDS_NUMERATOR
+//   PW_CHRONO_PROFILING_CLOCK_PERIOD_SECONDS_DENOMINATOR
+//   using pw::chrono::backend::ProfilingClockCounter = uint32_t or uint64_t;
+#include "pw_chrono_backend/profiling_clock_config.h"
+
+#include <chrono>
+#include <ratio>
+#include <type_traits>
+
+namespace pw::chrono {
+namespace backend {
+
+// Returns the raw value of the profiling counter, which counts up by one every
+// ProfilingClock::period and wraps at the width of ProfilingClockCounter. This
+// must be thread, IRQ and NMI safe, and is provided by the backend.
+ProfilingClockCounter GetProfilingClockCounter();
+
+}  // namespace backend
+
+// The ProfilingClock is a high-resolution, steady clock for measuring short
+// durations, such as the latency of a function or the time between trace
+// events. Typical backends read a CPU cycle counter or the host's raw
+// monotonic clock, so a tick is often a single cycle or nanosecond.
+//
+// Unlike SystemClock, the ProfilingClock is not used to wait or sleep, and its
+// period is usually far shorter than the RTOS tick. It meets the requirements
+// of C++'s TrivialClock.
+//
+// The raw counter may be only 32 bits wide, which wraps in seconds at CPU
+// clock rates. Two ways of reading the clock are provided:
+//
+// - counter() returns the raw counter. It is a single register read on most
+//   targets. Elapsed() gives the duration between two readings, which is
+//   correct across a wraparound as long as the duration is shorter than the
+//   wrap period. This suits instrumentation in hot paths.
+//
+// - now() returns a 64-bit time_point. For 32-bit counters, wraparounds are
+//   counted in software, so now() must be called at least once per half wrap
+//   period (about 13 seconds for a 168 MHz cycle counter) to stay correct.
+//
+// Example:
+//
+//   const ProfilingClock::Counter start = ProfilingClock::counter();
+//   Encode(message);
+//   latency_histogram.Record(
+//       std::chrono::duration_cast<std::chrono::nanoseconds>(
+//           ProfilingClock::Elapsed(start, ProfilingClock::counter()))
+//           .count());
+//
+// This is thread, IRQ and NMI safe.
+struct ProfilingClock {
+  using rep = int64_t;
+  // The period must be provided by the backend.
+  using period =
+      std::ratio<PW_CHRONO_PROFILING_CLOCK_PERIOD_SECONDS_NUMERATOR,
+                 PW_CHRONO_PROFILING_CLOCK_PERIOD_SECONDS_DENOMINATOR>;
+  using duration = std::chrono::duration<rep, period>;
+  using time_point = std::chrono::time_point<ProfilingClock>;
+
+  // The type of a raw counter reading.
+  using Counter = backend::ProfilingClockCounter;
+  static_assert(std::is_same_v<Counter, uint32_t> ||
+                    std::is_same_v<Counter, uint64_t>,
+                "The profiling counter must be uint32_t or uint64_t");
+
+  static constexpr bool is_monotonic = true;
+  static constexpr bool is_steady = true;
+
+  // The number of ticks per second, rounded down.
+  static constexpr uint64_t kTicksPerSecond = period::den / period::num;
+
+  // Returns the raw counter. This is thread, IRQ and NMI safe.
+  static Counter counter() noexcept {
+    return backend::GetProfilingClockCounter();
+  }
+
+  // Returns the duration from the start counter reading to the end reading,
+  // accounting for at most one wraparound in between.
+  static constexpr duration Elapsed(Counter start, Counter end) {
+    return duration(static_cast<rep>(static_cast<Counter>(end - start)));
+  }
+
+  // Returns the current time, extended to 64 bits if the counter is narrower.
+  // This is thread, IRQ and NMI safe.
+  static time_point now() noexcept {
+    if constexpr (std::is_same_v<Counter, uint64_t>) {
+      return time_point(duration(static_cast<rep>(counter())));
+    } else {
+      return time_point(duration(ExtendedCount()));
+    }
+  }
+
+ private:
+  static rep ExtendedCount();
+};
+
+}  // namespace pw::chrono
+
+// The backend can opt to include an inlined implementation of the following:
+//   ProfilingClockCounter GetProfilingClockCounter();
+#if __has_include("pw_chrono_backend/profiling_clock_inline.h")
+#include "pw_chrono_backend/profiling_clock_inline.h"
+#endif  // __has_include("pw_chrono_backend/profiling_clock_inline.h")
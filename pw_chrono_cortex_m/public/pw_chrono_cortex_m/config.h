@@ -0,0 +1,22 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// The frequency of the Cortex-M core clock, which the DWT cycle counter counts,
+// in Hz. The profiling clock's period is derived from this, so it must match
+// the frequency the core runs at after clock initialization. Defaults to the
+// 16 MHz reset clock of the STM32F4.
+#ifndef PW_CHRONO_CORTEX_M_CPU_CLOCK_HZ
+#define PW_CHRONO_CORTEX_M_CPU_CLOCK_HZ 16'000'000
+#endif  // PW_CHRONO_CORTEX_M_CPU_CLOCK_HZ
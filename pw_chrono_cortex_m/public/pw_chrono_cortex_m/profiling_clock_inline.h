@@ -0,0 +1,38 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <stdint.h>
+
+#include "pw_chrono/profiling_clock.h"
+
+namespace pw::chrono {
+namespace cortex_m {
+
+// Starts the DWT cycle counter. This must be called once, before the
+// ProfilingClock is first read; until then, the counter does not advance.
+// Typically this is called from pw_boot_PreMainInit().
+void StartProfilingClock();
+
+}  // namespace cortex_m
+
+namespace backend {
+
+inline ProfilingClockCounter GetProfilingClockCounter() {
+  // DWT_CYCCNT (ARMv7-M Section C1.8.8)
+  return *reinterpret_cast<volatile uint32_t*>(0xE0001004u);
+}
+
+}  // namespace backend
+}  // namespace pw::chrono
@@ -0,0 +1,26 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <stdint.h>
+
+// The profiling clock counts nanoseconds of the host's raw monotonic clock.
+#define PW_CHRONO_PROFILING_CLOCK_PERIOD_SECONDS_NUMERATOR 1
+#define PW_CHRONO_PROFILING_CLOCK_PERIOD_SECONDS_DENOMINATOR 1'000'000'000
+
+namespace pw::chrono::backend {
+
+using ProfilingClockCounter = uint64_t;
+
+}  // namespace pw::chrono::backend
@@ -0,0 +1,41 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <chrono>
+
+#if __has_include(<time.h>)
+#include <time.h>
+#endif  // __has_include(<time.h>)
+
+#include "pw_chrono/profiling_clock.h"
+
+namespace pw::chrono::backend {
+
+inline ProfilingClockCounter GetProfilingClockCounter() {
+#if defined(CLOCK_MONOTONIC_RAW)
+  // The raw monotonic clock is not slewed by NTP, so short intervals are not
+  // stretched or shrunk while the system time is being adjusted.
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+  return static_cast<ProfilingClockCounter>(now.tv_sec) * 1'000'000'000u +
+         static_cast<ProfilingClockCounter>(now.tv_nsec);
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif  // defined(CLOCK_MONOTONIC_RAW)
+}
+
+}  // namespace pw::chrono::backend
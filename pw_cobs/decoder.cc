@@ -0,0 +1,179 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_cobs/decoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_bytes/endian.h"
+#include "pw_cobs/internal/protocol.h"
+#include "pw_varint/varint.h"
+
+namespace pw::cobs {
+
+Result<Frame> Frame::Parse(ConstByteSpan frame) {
+  uint64_t address;
+  size_t address_size = varint::Decode(frame, &address, kAddressFormat);
+  int data_size = frame.size() - address_size - kFcsSize;
+
+  if (address_size == 0 || data_size < 0) {
+    return Status::DataLoss();
+  }
+
+  return Frame(address, frame.subspan(address_size, data_size));
+}
+
+Result<Frame> Decoder::Process(const std::byte new_byte) {
+  if (new_byte == kDelimiter) {
+    return FinishFrame();
+  }
+
+  if (run_remaining_ != 0u) {
+    AppendByte(new_byte);
+    run_remaining_ -= 1;
+    return Status::Unavailable();
+  }
+
+  // The byte is a code byte, which starts a new block.
+  if (zero_pending_) {
+    AppendByte(kDelimiter);
+  }
+  run_remaining_ = static_cast<size_t>(new_byte) - 1;
+  zero_pending_ = new_byte != kMaxRunCode;
+  return Status::Unavailable();
+}
+
+Result<Frame> Decoder::FinishFrame() {
+  // Repeated delimiters are not an error; they separate empty frames.
+  if (current_frame_size_ == 0u && run_remaining_ == 0u && !zero_pending_) {
+    return Status::Unavailable();
+  }
+
+  // The frame ended partway through a block, so some data is missing.
+  const Status status =
+      run_remaining_ != 0u ? Status::DataLoss() : CheckFrame();
+
+  const size_t completed_frame_size = current_frame_size_;
+  Reset();
+
+  if (status.ok()) {
+    return Frame::Parse(buffer_.first(completed_frame_size));
+  }
+  return status;
+}
+
+void Decoder::AppendByte(std::byte new_byte) {
+  if (current_frame_size_ < max_size()) {
+    buffer_[current_frame_size_] = new_byte;
+  }
+
+  if (current_frame_size_ >= last_read_bytes_.size()) {
+    // A byte will be ejected. Add it to the running checksum.
+    fcs_.Update(last_read_bytes_[last_read_bytes_index_]);
+  }
+
+  last_read_bytes_[last_read_bytes_index_] = new_byte;
+  last_read_bytes_index_ =
+      (last_read_bytes_index_ + 1) % last_read_bytes_.size();
+
+  // Always increase size: if it is larger than the buffer, overflow occurred.
+  current_frame_size_ += 1;
+}
+
+void Decoder::AppendBytes(ConstByteSpan data) {
+  // Short runs are not worth special handling.
+  if (data.size() < last_read_bytes_.size()) {
+    for (std::byte b : data) {
+      AppendByte(b);
+    }
+    return;
+  }
+
+  if (current_frame_size_ < max_size()) {
+    std::memcpy(&buffer_[current_frame_size_],
+                data.data(),
+                std::min(data.size(), max_size() - current_frame_size_));
+  }
+
+  // The run evicts every byte in the last read bytes ring buffer. Add them to
+  // the running checksum, oldest first, followed by all but the last four bytes
+  // of the run, which take their place in the ring buffer.
+  const size_t buffered =
+      std::min(current_frame_size_, last_read_bytes_.size());
+  size_t index = (last_read_bytes_index_ + last_read_bytes_.size() - buffered) %
+                 last_read_bytes_.size();
+  for (size_t i = 0; i < buffered; ++i) {
+    fcs_.Update(last_read_bytes_[index]);
+    index = (index + 1) % last_read_bytes_.size();
+  }
+
+  const size_t fcs_bytes = data.size() - last_read_bytes_.size();
+  fcs_.Update(data.first(fcs_bytes));
+  std::memcpy(last_read_bytes_.data(),
+              &data[fcs_bytes],
+              last_read_bytes_.size());
+  last_read_bytes_index_ = 0;
+
+  current_frame_size_ += data.size();
+}
+
+size_t Decoder::ProcessRun(ConstByteSpan data) {
+  if (run_remaining_ == 0u) {
+    return 0;
+  }
+
+  // A delimiter within the run ends the frame early, so stop before it.
+  const size_t run_size =
+      FindDelimiter(data.first(std::min(run_remaining_, data.size())));
+  AppendBytes(data.first(run_size));
+  run_remaining_ -= run_size;
+  return run_size;
+}
+
+Status Decoder::CheckFrame() const {
+  if (current_frame_size_ < Frame::kMinSizeBytes) {
+    return Status::DataLoss();
+  }
+
+  if (!VerifyFrameCheckSequence()) {
+    return Status::DataLoss();
+  }
+
+  if (current_frame_size_ > max_size()) {
+    // Frame does not fit into the provided buffer; indicate this to the caller.
+    // This may not be considered an error if the caller is doing a partial
+    // decode.
+    return Status::ResourceExhausted();
+  }
+
+  return OkStatus();
+}
+
+bool Decoder::VerifyFrameCheckSequence() const {
+  // De-ring the last four bytes read, which at this point contain the FCS.
+  std::array<std::byte, sizeof(uint32_t)> fcs_buffer;
+  size_t index = last_read_bytes_index_;
+
+  for (size_t i = 0; i < fcs_buffer.size(); ++i) {
+    fcs_buffer[i] = last_read_bytes_[index];
+    index = (index + 1) % last_read_bytes_.size();
+  }
+
+  uint32_t actual_fcs =
+      bytes::ReadInOrder<uint32_t>(std::endian::little, fcs_buffer);
+  return actual_fcs == fcs_.value();
+}
+
+}  // namespace pw::cobs
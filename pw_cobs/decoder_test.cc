@@ -0,0 +1,178 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_cobs/decoder.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::cobs {
+namespace {
+
+constexpr uint8_t kAddress = 0x7b;  // 123
+constexpr uint8_t kEncodedAddress = (kAddress << 1) | 1;
+
+// Frame with the payload "A".
+constexpr auto kFrameA = bytes::Concat(
+    uint8_t{7}, kEncodedAddress, 'A', uint32_t{0x1bff1483}, uint8_t{0});
+
+// Frame with the payload "a\0b\0\0".
+constexpr auto kFrameWithZeros = bytes::Concat(uint8_t{3},
+                                               kEncodedAddress,
+                                               'a',
+                                               uint8_t{2},
+                                               'b',
+                                               uint8_t{1},
+                                               uint8_t{5},
+                                               uint32_t{0x5654c9b1},
+                                               uint8_t{0});
+
+TEST(Frame, Fields) {
+  static constexpr auto kFrameData =
+      bytes::String("\x05"
+                    "ABC"
+                    "\x12\x34\x56\x78");
+
+  Result<Frame> result = Frame::Parse(kFrameData);
+  ASSERT_TRUE(result.ok());
+  Frame& frame = result.value();
+
+  EXPECT_EQ(frame.address(), 2u);
+  EXPECT_EQ(frame.data().data(), &kFrameData[1]);
+  EXPECT_EQ(frame.data().size(), 3u);
+}
+
+TEST(Decoder, Process_OneByteAtATime) {
+  DecoderBuffer<64> decoder;
+
+  for (size_t i = 0; i < kFrameA.size() - 1; ++i) {
+    EXPECT_EQ(Status::Unavailable(), decoder.Process(kFrameA[i]).status());
+  }
+
+  Result<Frame> result = decoder.Process(kFrameA.back());
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(kAddress, result.value().address());
+  ASSERT_EQ(1u, result.value().data().size());
+  EXPECT_EQ(std::byte{'A'}, result.value().data()[0]);
+}
+
+TEST(Decoder, Process_RestoresZeros) {
+  DecoderBuffer<64> decoder;
+  Result<Frame> result = Status::Unknown();
+
+  decoder.Process(kFrameWithZeros,
+                  [&result](const Result<Frame>& frame) { result = frame; });
+
+  ASSERT_EQ(OkStatus(), result.status());
+  constexpr auto kExpected = bytes::Array<'a', 0, 'b', 0, 0>();
+  ASSERT_EQ(kExpected.size(), result.value().data().size());
+  EXPECT_EQ(0,
+            std::memcmp(kExpected.data(),
+                        result.value().data().data(),
+                        kExpected.size()));
+}
+
+TEST(Decoder, Process_MultipleFrames) {
+  DecoderBuffer<64> decoder;
+  int frames = 0;
+
+  decoder.Process(bytes::Concat(kFrameA, uint8_t{0}, kFrameWithZeros, kFrameA),
+                  [&frames](const Result<Frame>& result) {
+                    EXPECT_EQ(OkStatus(), result.status());
+                    frames += 1;
+                  });
+
+  EXPECT_EQ(3, frames);
+}
+
+TEST(Decoder, Process_EmptyFramesIgnored) {
+  DecoderBuffer<64> decoder;
+  int callbacks = 0;
+
+  decoder.Process(bytes::Array<0, 0, 0>(),
+                  [&callbacks](const Result<Frame>&) { callbacks += 1; });
+
+  EXPECT_EQ(0, callbacks);
+}
+
+TEST(Decoder, Process_BadFcs_DataLoss) {
+  auto frame = kFrameA;
+  frame[2] = std::byte{'B'};
+
+  DecoderBuffer<64> decoder;
+  Status status = Status::Unknown();
+  decoder.Process(frame, [&status](const Result<Frame>& result) {
+    status = result.status();
+  });
+  EXPECT_EQ(Status::DataLoss(), status);
+}
+
+TEST(Decoder, Process_TruncatedBlock_DataLoss) {
+  DecoderBuffer<64> decoder;
+  Status status = Status::Unknown();
+
+  // The first frame is cut off in the middle of its first block, after which
+  // decoding resumes with the next frame.
+  constexpr auto kTruncated = bytes::Concat(
+      uint8_t{7}, kEncodedAddress, 'A', uint8_t{0x83}, uint8_t{0});
+  decoder.Process(kTruncated, [&status](const Result<Frame>& result) {
+    status = result.status();
+  });
+  EXPECT_EQ(Status::DataLoss(), status);
+
+  decoder.Process(kFrameA, [&status](const Result<Frame>& result) {
+    status = result.status();
+  });
+  EXPECT_EQ(OkStatus(), status);
+}
+
+TEST(Decoder, Process_TooShort_DataLoss) {
+  DecoderBuffer<64> decoder;
+  Status status = Status::Unknown();
+  decoder.Process(bytes::Array<3, 1, 2, 0>(),
+                  [&status](const Result<Frame>& result) {
+                    status = result.status();
+                  });
+  EXPECT_EQ(Status::DataLoss(), status);
+}
+
+TEST(Decoder, Process_FrameTooLarge_ResourceExhausted) {
+  DecoderBuffer<Frame::kMinSizeBytes> decoder;
+  Status status = Status::Unknown();
+  decoder.Process(kFrameWithZeros, [&status](const Result<Frame>& result) {
+    status = result.status();
+  });
+  EXPECT_EQ(Status::ResourceExhausted(), status);
+}
+
+TEST(Decoder, Clear_DiscardsPartialFrame) {
+  DecoderBuffer<64> decoder;
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(Status::Unavailable(), decoder.Process(kFrameA[i]).status());
+  }
+  decoder.Clear();
+
+  Status status = Status::Unknown();
+  decoder.Process(kFrameA, [&status](const Result<Frame>& result) {
+    status = result.status();
+  });
+  EXPECT_EQ(OkStatus(), status);
+}
+
+}  // namespace
+}  // namespace pw::cobs
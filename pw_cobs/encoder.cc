@@ -0,0 +1,131 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_cobs/encoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <span>
+
+#include "pw_bytes/endian.h"
+#include "pw_cobs/internal/encoder.h"
+
+namespace pw::cobs {
+namespace internal {
+
+Status Encoder::StartFrame(uint64_t address) {
+  fcs_.clear();
+  block_size_ = 0;
+
+  std::array<std::byte, varint::kMaxVarint64SizeBytes> address_buffer;
+  const size_t address_size =
+      varint::Encode(address, address_buffer, kAddressFormat);
+  if (address_size == 0) {
+    return Status::InvalidArgument();
+  }
+  return WriteData(std::span(address_buffer).first(address_size));
+}
+
+Status Encoder::WriteData(ConstByteSpan data) {
+  fcs_.Update(data);
+  return Encode(data);
+}
+
+Status Encoder::FinishFrame() {
+  if (Status status =
+          Encode(bytes::CopyInOrder(std::endian::little, fcs_.value()));
+      !status.ok()) {
+    return status;
+  }
+
+  // The last block always ends with the frame; the decoder drops its zero.
+  if (Status status = WriteBlock(std::byte(block_size_ + 1), ConstByteSpan());
+      !status.ok()) {
+    return status;
+  }
+  return writer_.Write(kDelimiter);
+}
+
+Status Encoder::Encode(ConstByteSpan data) {
+  while (!data.empty()) {
+    const ConstByteSpan block =
+        data.first(std::min(data.size(), kMaxRunSize - block_size_));
+    const size_t run_size = FindDelimiter(block);
+
+    // The data ran out before the block was complete. Keep it for the next
+    // write.
+    if (run_size == data.size() && block_size_ + run_size < kMaxRunSize) {
+      std::memcpy(&block_[1 + block_size_], data.data(), run_size);
+      block_size_ += run_size;
+      return OkStatus();
+    }
+
+    // The block ends at a zero, which the code byte replaces, or is full.
+    if (run_size < block.size()) {
+      if (Status status = WriteBlock(std::byte(block_size_ + run_size + 1),
+                                     block.first(run_size));
+          !status.ok()) {
+        return status;
+      }
+      data = data.subspan(run_size + 1);
+    } else {
+      if (Status status = WriteBlock(kMaxRunCode, block); !status.ok()) {
+        return status;
+      }
+      data = data.subspan(run_size);
+    }
+  }
+  return OkStatus();
+}
+
+Status Encoder::WriteBlock(std::byte code, ConstByteSpan tail) {
+  if (block_size_ == 0u && tail.size() >= kMinDirectWriteSize) {
+    if (Status status = writer_.Write(code); !status.ok()) {
+      return status;
+    }
+    return writer_.Write(tail);
+  }
+
+  block_[0] = code;
+  if (!tail.empty()) {
+    std::memcpy(&block_[1 + block_size_], tail.data(), tail.size());
+  }
+  const size_t size = 1 + block_size_ + tail.size();
+  block_size_ = 0;
+  return writer_.Write(std::span(block_).first(size));
+}
+
+}  // namespace internal
+
+Status WriteFrame(uint64_t address,
+                  ConstByteSpan payload,
+                  stream::Writer& writer) {
+  if (MaxEncodedFrameSize(address, payload.size()) >
+      writer.ConservativeWriteLimit()) {
+    return Status::ResourceExhausted();
+  }
+
+  internal::Encoder encoder(writer);
+
+  if (Status status = encoder.StartFrame(address); !status.ok()) {
+    return status;
+  }
+  if (Status status = encoder.WriteData(payload); !status.ok()) {
+    return status;
+  }
+  return encoder.FinishFrame();
+}
+
+}  // namespace pw::cobs
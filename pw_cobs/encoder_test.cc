@@ -0,0 +1,171 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_cobs/encoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_cobs/decoder.h"
+#include "pw_cobs/internal/encoder.h"
+#include "pw_stream/memory_stream.h"
+
+using std::byte;
+
+namespace pw::cobs {
+namespace {
+
+constexpr uint8_t kAddress = 0x7b;  // 123
+constexpr uint8_t kEncodedAddress = (kAddress << 1) | 1;
+
+static_assert(MaxEncodedFrameSize(kAddress, 0) == 7);
+static_assert(MaxEncodedFrameSize(kAddress, 248) == 255);
+static_assert(MaxEncodedFrameSize(kAddress, 249) == 257);
+static_assert(MaxEncodedFrameSize(kAddress, 250) == 258);
+static_assert(MaxEncodedFrameSize(0x3fff, 1024) == 1036);
+
+class WriteFrameTest : public ::testing::Test {
+ protected:
+  // Checks that the written frame decodes to the given address and payload.
+  void ExpectDecodesTo(uint64_t address, ConstByteSpan payload) {
+    DecoderBuffer<kMaxPayloadSize + 16> decoder;
+    int frames = 0;
+    decoder.Process(writer_.WrittenData(), [&](const Result<Frame>& result) {
+      frames += 1;
+      ASSERT_EQ(OkStatus(), result.status());
+      EXPECT_EQ(address, result.value().address());
+      ASSERT_EQ(payload.size(), result.value().data().size());
+      EXPECT_EQ(0,
+                std::memcmp(payload.data(),
+                            result.value().data().data(),
+                            payload.size()));
+    });
+    EXPECT_EQ(1, frames);
+  }
+
+  static constexpr size_t kMaxPayloadSize = 1024;
+
+  stream::MemoryWriterBuffer<MaxEncodedFrameSize(0x3fff, kMaxPayloadSize)>
+      writer_;
+};
+
+#define EXPECT_ENCODER_WROTE(...)                                           \
+  do {                                                                      \
+    constexpr auto expected_data = (__VA_ARGS__);                           \
+    EXPECT_EQ(writer_.bytes_written(), expected_data.size());               \
+    EXPECT_EQ(                                                              \
+        std::memcmp(                                                        \
+            writer_.data(), expected_data.data(), writer_.bytes_written()), \
+        0);                                                                 \
+  } while (0)
+
+TEST_F(WriteFrameTest, EmptyPayload) {
+  ASSERT_EQ(OkStatus(), WriteFrame(kAddress, ConstByteSpan(), writer_));
+  EXPECT_ENCODER_WROTE(bytes::Concat(
+      uint8_t{6}, kEncodedAddress, uint32_t{0xf1db8832}, uint8_t{0}));
+}
+
+TEST_F(WriteFrameTest, OneBytePayload) {
+  ASSERT_EQ(OkStatus(), WriteFrame(kAddress, bytes::String("A"), writer_));
+  EXPECT_ENCODER_WROTE(bytes::Concat(
+      uint8_t{7}, kEncodedAddress, 'A', uint32_t{0x1bff1483}, uint8_t{0}));
+}
+
+TEST_F(WriteFrameTest, ZeroPayload) {
+  ASSERT_EQ(OkStatus(), WriteFrame(kAddress, bytes::Array<0x00>(), writer_));
+  EXPECT_ENCODER_WROTE(bytes::Concat(uint8_t{2},
+                                     kEncodedAddress,
+                                     uint8_t{5},
+                                     uint32_t{0x1a246585},
+                                     uint8_t{0}));
+}
+
+TEST_F(WriteFrameTest, MultipleZeros) {
+  ASSERT_EQ(
+      OkStatus(),
+      WriteFrame(kAddress, bytes::Array<'a', 0, 'b', 0, 0>(), writer_));
+  EXPECT_ENCODER_WROTE(bytes::Concat(uint8_t{3},
+                                     kEncodedAddress,
+                                     'a',
+                                     uint8_t{2},
+                                     'b',
+                                     uint8_t{1},
+                                     uint8_t{5},
+                                     uint32_t{0x5654c9b1},
+                                     uint8_t{0}));
+}
+
+TEST_F(WriteFrameTest, LongRun_UsesMaxEncodedSize) {
+  std::array<byte, kMaxPayloadSize> payload;
+  std::fill(payload.begin(), payload.end(), byte{0x55});
+
+  ASSERT_EQ(OkStatus(), WriteFrame(kAddress, payload, writer_));
+  EXPECT_EQ(MaxEncodedFrameSize(kAddress, payload.size()),
+            writer_.bytes_written());
+  ExpectDecodesTo(kAddress, payload);
+}
+
+TEST_F(WriteFrameTest, RunsOfEverySize) {
+  std::array<byte, kMaxPayloadSize> payload;
+  for (size_t i = 0; i < payload.size(); ++i) {
+    payload[i] = byte(i % 251 == 0 || i % 257 == 0 ? 0 : i % 256);
+  }
+
+  ASSERT_EQ(OkStatus(), WriteFrame(0x3fff, payload, writer_));
+  EXPECT_LE(writer_.bytes_written(), MaxEncodedFrameSize(0x3fff, 1024));
+  ExpectDecodesTo(0x3fff, payload);
+}
+
+TEST_F(WriteFrameTest, WriterTooSmall_ResourceExhausted) {
+  stream::MemoryWriterBuffer<MaxEncodedFrameSize(kAddress, 5) - 1> writer;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            WriteFrame(kAddress, bytes::String("hello"), writer));
+  EXPECT_EQ(0u, writer.bytes_written());
+}
+
+TEST_F(WriteFrameTest, Encoder_WriteDataInChunks) {
+  std::array<byte, kMaxPayloadSize> payload;
+  for (size_t i = 0; i < payload.size(); ++i) {
+    payload[i] = byte(i % 100 == 0 ? 0 : 0x80);
+  }
+
+  stream::MemoryWriterBuffer<MaxEncodedFrameSize(kAddress, kMaxPayloadSize)>
+      expected;
+  ASSERT_EQ(OkStatus(), WriteFrame(kAddress, payload, expected));
+
+  for (size_t chunk_size : {1, 7, 253, 254, 255, 600}) {
+    stream::MemoryWriterBuffer<MaxEncodedFrameSize(kAddress, kMaxPayloadSize)>
+        writer;
+    internal::Encoder encoder(writer);
+    ASSERT_EQ(OkStatus(), encoder.StartFrame(kAddress));
+    for (size_t i = 0; i < payload.size(); i += chunk_size) {
+      ASSERT_EQ(OkStatus(),
+                encoder.WriteData(std::span(payload).subspan(
+                    i, std::min(chunk_size, payload.size() - i))));
+    }
+    ASSERT_EQ(OkStatus(), encoder.FinishFrame());
+
+    ASSERT_EQ(expected.bytes_written(), writer.bytes_written());
+    EXPECT_EQ(
+        0,
+        std::memcmp(expected.data(), writer.data(), writer.bytes_written()));
+  }
+}
+
+}  // namespace
+}  // namespace pw::cobs
@@ -0,0 +1,174 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>  // std::invoke
+
+#include "pw_bytes/span.h"
+#include "pw_checksum/crc32.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+
+namespace pw::cobs {
+
+// A decoded COBS frame.
+class Frame {
+ private:
+  static constexpr size_t kMinimumAddressSize = 1;
+  static constexpr size_t kFcsSize = sizeof(uint32_t);
+
+ public:
+  // The minimum size of a decoded frame.
+  static constexpr size_t kMinSizeBytes = kMinimumAddressSize + kFcsSize;
+
+  static Result<Frame> Parse(ConstByteSpan frame);
+
+  constexpr uint64_t address() const { return address_; }
+
+  constexpr ConstByteSpan data() const { return data_; }
+
+ private:
+  // Creates a Frame with the specified data. The data MUST be valid frame data
+  // with a verified frame check sequence.
+  constexpr Frame(uint64_t address, ConstByteSpan data)
+      : data_(data), address_(address) {}
+
+  ConstByteSpan data_;
+  uint64_t address_;
+};
+
+// Decodes COBS frames from a stream of bytes.
+//
+// Each code byte gives the length of the run of data that follows it, so the
+// decoder copies whole runs at a time. Frames are always terminated by a zero,
+// which cannot occur within an encoded frame. Errors in a frame are reported
+// when the frame ends, and decoding resumes with the next frame.
+class Decoder {
+ public:
+  constexpr Decoder(ByteSpan buffer)
+      : buffer_(buffer),
+        last_read_bytes_({}),
+        last_read_bytes_index_(0),
+        current_frame_size_(0),
+        run_remaining_(0),
+        zero_pending_(false) {}
+
+  Decoder(const Decoder&) = delete;
+  Decoder& operator=(const Decoder&) = delete;
+
+  // Parses a single byte of a COBS stream. Returns a Result with the complete
+  // frame if the byte completes a frame. The status is the following:
+  //
+  //     OK - A frame was successfully decoded. The Result contains the Frame,
+  //         which is invalidated by the next Process call.
+  //     UNAVAILABLE - No frame is available.
+  //     RESOURCE_EXHAUSTED - A frame completed, but it was too large to fit in
+  //         the decoder's buffer.
+  //     DATA_LOSS - A frame completed, but it was invalid. The frame was
+  //         incomplete or the frame check sequence verification failed.
+  //
+  Result<Frame> Process(std::byte new_byte);
+
+  // Processes a span of data and calls the provided callback with each frame or
+  // error. The data following each code byte is copied into the frame as a
+  // single run.
+  template <typename F, typename... Args>
+  void Process(ConstByteSpan data, F&& callback, Args&&... args) {
+    while (!data.empty()) {
+      data = data.subspan(ProcessRun(data));
+      if (data.empty()) {
+        return;
+      }
+
+      auto result = Process(data.front());
+      data = data.subspan(1);
+      if (result.status() != Status::Unavailable()) {
+        std::invoke(
+            std::forward<F>(callback), std::forward<Args>(args)..., result);
+      }
+    }
+  }
+
+  // Returns the maximum size of the Decoder's frame buffer.
+  size_t max_size() const { return buffer_.size(); }
+
+  // Clears and resets the decoder.
+  void Clear() { Reset(); }
+
+ private:
+  void Reset() {
+    current_frame_size_ = 0;
+    last_read_bytes_index_ = 0;
+    run_remaining_ = 0;
+    zero_pending_ = false;
+    fcs_.clear();
+  }
+
+  // Handles the delimiter at the end of a frame.
+  Result<Frame> FinishFrame();
+
+  void AppendByte(std::byte new_byte);
+
+  // Appends a run of data bytes to the current frame.
+  void AppendBytes(ConstByteSpan data);
+
+  // Consumes the data bytes at the start of data that belong to the current
+  // block and returns how many bytes were consumed. The next byte, if any,
+  // must be passed to Process(std::byte).
+  size_t ProcessRun(ConstByteSpan data);
+
+  Status CheckFrame() const;
+
+  bool VerifyFrameCheckSequence() const;
+
+  const ByteSpan buffer_;
+
+  // Ring buffer of the last four bytes read into the current frame, to allow
+  // calculating the frame's CRC incrementally. As data is evicted from this
+  // buffer, it is added to the running CRC. Once a frame is complete, the
+  // buffer contains the frame's FCS.
+  std::array<std::byte, sizeof(uint32_t)> last_read_bytes_;
+  size_t last_read_bytes_index_;
+
+  // Incremental checksum of the current frame.
+  checksum::Crc32 fcs_;
+
+  size_t current_frame_size_;
+
+  // Data bytes left in the current block.
+  size_t run_remaining_;
+
+  // Whether the current block ends with a zero. The zero is added when the next
+  // block starts, since the last block's zero is not part of the frame.
+  bool zero_pending_;
+};
+
+template <size_t kSizeBytes>
+class DecoderBuffer : public Decoder {
+ public:
+  DecoderBuffer() : Decoder(frame_buffer_) {}
+
+  // Returns the maximum length of the bytes that can be inserted in the bytes
+  // buffer.
+  static constexpr size_t max_size() { return kSizeBytes; }
+
+ private:
+  static_assert(kSizeBytes >= Frame::kMinSizeBytes);
+
+  std::array<std::byte, kSizeBytes> frame_buffer_;
+};
+
+}  // namespace pw::cobs
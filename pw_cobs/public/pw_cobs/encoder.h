@@ -0,0 +1,48 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_cobs/internal/protocol.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+#include "pw_varint/varint.h"
+
+namespace pw::cobs {
+
+// Returns the largest number of bytes that writing a frame with the given
+// address and payload size can take, including the delimiter. Unlike HDLC, the
+// bound does not depend on the payload contents.
+constexpr size_t MaxEncodedFrameSize(uint64_t address, size_t payload_size) {
+  return MaxEncodedSize(varint::EncodedSize(address) + payload_size +
+                        sizeof(uint32_t)) +
+         sizeof(kDelimiter);
+}
+
+// Writes a COBS frame to the stream::Writer with the given address and payload.
+// The frame is the COBS encoding of the address, the payload, and a CRC-32
+// frame check sequence, followed by a zero delimiter.
+//
+// Returns:
+//   OK - The frame was written.
+//   RESOURCE_EXHAUSTED - The writer cannot fit the frame in the worst case.
+//   Any error from stream::Writer::Write.
+Status WriteFrame(uint64_t address,
+                  ConstByteSpan payload,
+                  stream::Writer& writer);
+
+}  // namespace pw::cobs
@@ -0,0 +1,63 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_checksum/crc32.h"
+#include "pw_cobs/internal/protocol.h"
+#include "pw_stream/stream.h"
+
+namespace pw::cobs::internal {
+
+// Encodes a COBS frame as it is written. Up to one block of data is buffered,
+// since each block's code byte is only known once the block is complete.
+class Encoder {
+ public:
+  constexpr Encoder(stream::Writer& output)
+      : writer_(output), block_{}, block_size_(0) {}
+
+  // Starts a frame and writes its address. After successfully calling
+  // StartFrame, WriteData may be called any number of times.
+  Status StartFrame(uint64_t address);
+
+  // Writes data for an ongoing frame. Must only be called after a successful
+  // StartFrame call, and prior to a FinishFrame() call.
+  Status WriteData(ConstByteSpan data);
+
+  // Finishes a frame. Writes the frame check sequence, the final block, and the
+  // delimiter.
+  Status FinishFrame();
+
+ private:
+  // Blocks that are empty and at least this long are written directly from the
+  // data instead of being copied into the block buffer first.
+  static constexpr size_t kMinDirectWriteSize = 16;
+
+  // COBS encodes data, without updating the frame check sequence.
+  Status Encode(ConstByteSpan data);
+
+  // Writes the buffered block followed by tail with the given code byte.
+  Status WriteBlock(std::byte code, ConstByteSpan tail);
+
+  stream::Writer& writer_;
+  checksum::Crc32 fcs_;
+
+  // The code byte followed by the data bytes of the block being encoded.
+  std::array<std::byte, 1 + kMaxRunSize> block_;
+  size_t block_size_;
+};
+
+}  // namespace pw::cobs::internal
@@ -0,0 +1,57 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_bytes/span.h"
+#include "pw_varint/varint.h"
+
+namespace pw::cobs {
+
+// Terminates every frame. COBS encoding removes it from the frame contents.
+inline constexpr std::byte kDelimiter = std::byte{0};
+
+// The largest number of data bytes that follow a single code byte.
+inline constexpr size_t kMaxRunSize = 254;
+
+// Code byte for a run of kMaxRunSize data bytes that is not followed by a zero.
+inline constexpr std::byte kMaxRunCode = std::byte{kMaxRunSize + 1};
+
+// Addresses are encoded the same way as in pw_hdlc.
+inline constexpr varint::Format kAddressFormat =
+    varint::Format::kOneTerminatedLeastSignificant;
+
+// Returns the size of the COBS encoding of size_bytes of data, in the worst
+// case, excluding the delimiter. Each run of up to kMaxRunSize bytes costs one
+// code byte, so the overhead is bounded by about 0.4%.
+constexpr size_t MaxEncodedSize(size_t size_bytes) {
+  return size_bytes + size_bytes / kMaxRunSize + 1;
+}
+
+// Returns the offset of the first delimiter in data, or data.size() if there is
+// none.
+inline size_t FindDelimiter(ConstByteSpan data) {
+  if (data.empty()) {
+    return 0;
+  }
+  const void* delimiter = std::memchr(data.data(), 0, data.size());
+  return delimiter == nullptr ? data.size()
+                              : static_cast<const std::byte*>(delimiter) -
+                                    data.data();
+}
+
+}  // namespace pw::cobs
@@ -0,0 +1,154 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <span>
+
+#include "pw_assert/assert.h"
+#include "pw_cobs/encoder.h"
+#include "pw_cobs/internal/encoder.h"
+#include "pw_rpc/channel.h"
+#include "pw_stream/stream.h"
+
+namespace pw::cobs {
+namespace internal {
+
+// Encodes RPC packets into COBS frames as they are written, so packets are
+// framed without first being encoded into a separate buffer.
+class FrameWriter final : public stream::NonSeekableWriter {
+ public:
+  constexpr FrameWriter(stream::Writer& writer, uint64_t address)
+      : encoder_(writer), address_(address), status_(OkStatus()) {}
+
+  // Writes the frame address. Writes fail if the address could not be written.
+  stream::Writer* StartFrame() {
+    status_ = encoder_.StartFrame(address_);
+    return this;
+  }
+
+  // Writes the frame check sequence and the delimiter. If writing the frame
+  // failed, the frame is left unterminated so it will be discarded by the
+  // receiver.
+  Status FinishFrame(Status write_status) {
+    if (!status_.ok()) {
+      return status_;
+    }
+    if (!write_status.ok()) {
+      return write_status;
+    }
+    return encoder_.FinishFrame();
+  }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    if (!status_.ok()) {
+      return status_;
+    }
+    return status_ = encoder_.WriteData(data);
+  }
+
+  Encoder encoder_;
+  const uint64_t address_;
+  Status status_;
+};
+
+}  // namespace internal
+
+// ChannelOutput that writes RPC packets as COBS frames. Channels may use this
+// or pw::hdlc::RpcChannelOutput independently of each other.
+//
+// WARNING: This ChannelOutput is not thread-safe. If thread-safety is required,
+// wrap this in a pw::rpc::SynchronizedChannelOutput.
+class RpcChannelOutput : public rpc::ChannelOutput {
+ public:
+  // The RpcChannelOutput class does not own the buffer it uses to store the
+  // protobuf bytes. This buffer is specified at the time of creation along with
+  // a writer object to which will be used to write and send the bytes.
+  constexpr RpcChannelOutput(stream::Writer& writer,
+                             std::span<std::byte> buffer,
+                             uint64_t address,
+                             const char* channel_name)
+      : ChannelOutput(channel_name),
+        writer_(writer),
+        buffer_(buffer),
+        address_(address),
+        frame_writer_(writer, address) {}
+
+  std::span<std::byte> AcquireBuffer() override { return buffer_; }
+
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) override {
+    PW_DASSERT(buffer.data() == buffer_.data());
+    if (buffer.empty()) {
+      return OkStatus();
+    }
+    return cobs::WriteFrame(address_, buffer, writer_);
+  }
+
+  // Packets are encoded directly into the COBS frame rather than into the
+  // buffer, which then only holds the payload.
+  stream::Writer* StartPacket() override { return frame_writer_.StartFrame(); }
+
+  Status FinishPacket(Status write_status) override {
+    return frame_writer_.FinishFrame(write_status);
+  }
+
+ private:
+  stream::Writer& writer_;
+  const std::span<std::byte> buffer_;
+  const uint64_t address_;
+  internal::FrameWriter frame_writer_;
+};
+
+// RpcChannelOutput with its own buffer.
+//
+// WARNING: This ChannelOutput is not thread-safe. If thread-safety is required,
+// wrap this in a pw::rpc::SynchronizedChannelOutput.
+template <size_t kBufferSize>
+class RpcChannelOutputBuffer : public rpc::ChannelOutput {
+ public:
+  constexpr RpcChannelOutputBuffer(stream::Writer& writer,
+                                   uint64_t address,
+                                   const char* channel_name)
+      : ChannelOutput(channel_name),
+        writer_(writer),
+        address_(address),
+        frame_writer_(writer, address) {}
+
+  std::span<std::byte> AcquireBuffer() override { return buffer_; }
+
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) override {
+    PW_DASSERT(buffer.data() == buffer_.data());
+    if (buffer.empty()) {
+      return OkStatus();
+    }
+    return cobs::WriteFrame(address_, buffer, writer_);
+  }
+
+  // Packets are encoded directly into the COBS frame rather than into the
+  // buffer, which then only holds the payload.
+  stream::Writer* StartPacket() override { return frame_writer_.StartFrame(); }
+
+  Status FinishPacket(Status write_status) override {
+    return frame_writer_.FinishFrame(write_status);
+  }
+
+ private:
+  stream::Writer& writer_;
+  std::array<std::byte, kBufferSize> buffer_;
+  const uint64_t address_;
+  internal::FrameWriter frame_writer_;
+};
+
+}  // namespace pw::cobs
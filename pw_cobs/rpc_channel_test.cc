@@ -0,0 +1,134 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_cobs/rpc_channel.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_stream/memory_stream.h"
+
+using std::byte;
+
+namespace pw::cobs {
+namespace {
+
+constexpr uint8_t kAddress = 0x7b;  // 123
+constexpr uint8_t kEncodedAddress = (kAddress << 1) | 1;
+
+// Size of the in-memory buffer to use for this test.
+constexpr size_t kSinkBufferSize = 15;
+
+TEST(RpcChannelOutput, 1BytePayload) {
+  std::array<byte, kSinkBufferSize> channel_output_buffer;
+  stream::MemoryWriterBuffer<kSinkBufferSize> memory_writer;
+
+  RpcChannelOutput output(
+      memory_writer, channel_output_buffer, kAddress, "RpcChannelOutput");
+
+  constexpr byte test_data = byte{'A'};
+  auto buffer = output.AcquireBuffer();
+  std::memcpy(buffer.data(), &test_data, sizeof(test_data));
+
+  constexpr auto expected = bytes::Concat(
+      uint8_t{7}, kEncodedAddress, 'A', uint32_t{0x1bff1483}, uint8_t{0});
+
+  EXPECT_EQ(OkStatus(),
+            output.SendAndReleaseBuffer(buffer.first(sizeof(test_data))));
+
+  ASSERT_EQ(memory_writer.bytes_written(), expected.size());
+  EXPECT_EQ(
+      std::memcmp(
+          memory_writer.data(), expected.data(), memory_writer.bytes_written()),
+      0);
+}
+
+TEST(RpcChannelOutputBuffer, ZeroInPayload) {
+  stream::MemoryWriterBuffer<kSinkBufferSize> memory_writer;
+
+  RpcChannelOutputBuffer<kSinkBufferSize> output(
+      memory_writer, kAddress, "RpcChannelOutput");
+
+  constexpr auto test_data = bytes::Array<'A', 0>();
+  auto buffer = output.AcquireBuffer();
+  std::memcpy(buffer.data(), test_data.data(), test_data.size());
+
+  constexpr auto expected = bytes::Concat(uint8_t{3},
+                                          kEncodedAddress,
+                                          'A',
+                                          uint8_t{5},
+                                          uint32_t{0xa6a8c203},
+                                          uint8_t{0});
+
+  EXPECT_EQ(OkStatus(),
+            output.SendAndReleaseBuffer(buffer.first(test_data.size())));
+
+  ASSERT_EQ(memory_writer.bytes_written(), expected.size());
+  EXPECT_EQ(
+      std::memcmp(
+          memory_writer.data(), expected.data(), memory_writer.bytes_written()),
+      0);
+}
+
+TEST(RpcChannelOutput, StartPacket_WritesSameFrameAsBuffer) {
+  std::array<byte, kSinkBufferSize> channel_output_buffer;
+  stream::MemoryWriterBuffer<kSinkBufferSize> memory_writer;
+
+  RpcChannelOutput output(
+      memory_writer, channel_output_buffer, kAddress, "RpcChannelOutput");
+
+  auto buffer = output.AcquireBuffer();
+  stream::Writer* writer = output.StartPacket();
+  ASSERT_NE(writer, nullptr);
+  EXPECT_EQ(OkStatus(), writer->Write(bytes::String("A")));
+  EXPECT_EQ(OkStatus(), writer->Write(bytes::Array<0x00>()));
+  EXPECT_EQ(OkStatus(), output.FinishPacket(OkStatus()));
+  EXPECT_EQ(OkStatus(), output.SendAndReleaseBuffer(buffer.first(0)));
+
+  stream::MemoryWriterBuffer<kSinkBufferSize> expected;
+  ASSERT_EQ(OkStatus(), WriteFrame(kAddress, bytes::Array<'A', 0>(), expected));
+
+  ASSERT_EQ(memory_writer.bytes_written(), expected.bytes_written());
+  EXPECT_EQ(
+      std::memcmp(
+          memory_writer.data(), expected.data(), memory_writer.bytes_written()),
+      0);
+}
+
+TEST(RpcChannelOutputBuffer, FinishPacket_WriteFailed_FrameNotTerminated) {
+  stream::MemoryWriterBuffer<kSinkBufferSize> memory_writer;
+
+  RpcChannelOutputBuffer<kSinkBufferSize> output(
+      memory_writer, kAddress, "RpcChannelOutput");
+
+  auto buffer = output.AcquireBuffer();
+  stream::Writer* writer = output.StartPacket();
+  ASSERT_NE(writer, nullptr);
+  EXPECT_EQ(OkStatus(), writer->Write(bytes::Array<'A', 0, 'B'>()));
+  EXPECT_EQ(Status::DataLoss(), output.FinishPacket(Status::DataLoss()));
+  EXPECT_EQ(OkStatus(), output.SendAndReleaseBuffer(buffer.first(0)));
+
+  // Only the block completed by the zero was written, without a delimiter.
+  ASSERT_EQ(memory_writer.bytes_written(), 3u);
+  EXPECT_EQ(memory_writer.data()[0], byte{3});
+  EXPECT_TRUE(std::none_of(memory_writer.data(),
+                           memory_writer.data() + 3,
+                           [](byte b) { return b == byte{0}; }));
+}
+
+}  // namespace
+}  // namespace pw::cobs
@@ -0,0 +1,96 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_cobs/wire_packet_parser.h"
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::cobs {
+namespace {
+
+constexpr uint8_t kAddress = 0x6a;
+constexpr uint8_t kEncodedAddress = (kAddress << 1) | 0x1;
+
+TEST(WirePacketParser, Parse_ValidPacket) {
+  WirePacketParser parser;
+  EXPECT_TRUE(parser.Parse(bytes::Concat(uint8_t{0x0b},
+                                         kEncodedAddress,
+                                         bytes::String("hello"),
+                                         0x03037da4,
+                                         uint8_t{0})));
+  auto maybe_address = parser.GetDestinationAddress();
+  EXPECT_TRUE(maybe_address.has_value());
+  EXPECT_EQ(maybe_address.value(), kAddress);
+}
+
+TEST(WirePacketParser, Parse_MultibyteAddress) {
+  WirePacketParser parser;
+  EXPECT_TRUE(parser.Parse(bytes::Concat(uint8_t{0x0c},
+                                         bytes::String("\xfe\xff"),
+                                         bytes::String("hello"),
+                                         0xbddb64ad,
+                                         uint8_t{0})));
+  auto maybe_address = parser.GetDestinationAddress();
+  EXPECT_TRUE(maybe_address.has_value());
+  EXPECT_EQ(maybe_address.value(), 0x3fffu);
+}
+
+TEST(WirePacketParser, Parse_ZerosInPayload) {
+  WirePacketParser parser;
+  EXPECT_TRUE(parser.Parse(bytes::Concat(uint8_t{0x02},
+                                         kEncodedAddress,
+                                         uint8_t{0x01},
+                                         uint8_t{0x0a},
+                                         bytes::String("hello"),
+                                         0xdbedf68a,
+                                         uint8_t{0})));
+  auto maybe_address = parser.GetDestinationAddress();
+  EXPECT_TRUE(maybe_address.has_value());
+  EXPECT_EQ(maybe_address.value(), kAddress);
+}
+
+TEST(WirePacketParser, Parse_BadFcs) {
+  WirePacketParser parser;
+  EXPECT_FALSE(parser.Parse(bytes::Concat(uint8_t{0x0b},
+                                          kEncodedAddress,
+                                          bytes::String("hello"),
+                                          0x1badda7a,
+                                          uint8_t{0})));
+}
+
+TEST(WirePacketParser, Parse_TruncatedBlock) {
+  WirePacketParser parser;
+  EXPECT_FALSE(parser.Parse(bytes::Concat(uint8_t{0x0c},
+                                          kEncodedAddress,
+                                          bytes::String("hello"),
+                                          0x03037da4,
+                                          uint8_t{0})));
+}
+
+TEST(WirePacketParser, Parse_MissingDelimiter) {
+  WirePacketParser parser;
+  EXPECT_FALSE(parser.Parse(bytes::Concat(uint8_t{0x0b},
+                                          kEncodedAddress,
+                                          bytes::String("hello"),
+                                          0x03037da4)));
+}
+
+TEST(WirePacketParser, Parse_EmptyPacket) {
+  WirePacketParser parser;
+  EXPECT_FALSE(parser.Parse({}));
+}
+
+}  // namespace
+}  // namespace pw::cobs
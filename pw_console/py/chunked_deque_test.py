@@ -0,0 +1,88 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for pw_console.chunked_deque"""
+
+import collections
+import unittest
+
+from pw_console.chunked_deque import ChunkedDeque
+
+
+class TestChunkedDeque(unittest.TestCase):
+    """Tests for ChunkedDeque."""
+    def test_append_and_index(self) -> None:
+        items: ChunkedDeque[int] = ChunkedDeque()
+        for i in range(10000):
+            items.append(i)
+
+        self.assertEqual(len(items), 10000)
+        self.assertEqual(items[0], 0)
+        self.assertEqual(items[5000], 5000)
+        self.assertEqual(items[-1], 9999)
+        self.assertEqual(list(items), list(range(10000)))
+        with self.assertRaises(IndexError):
+            _ = items[10000]
+
+    def test_popleft_keeps_sequence_numbers(self) -> None:
+        items = ChunkedDeque(range(10000))
+        for i in range(5000):
+            self.assertEqual(items.popleft(), i)
+
+        self.assertEqual(len(items), 5000)
+        self.assertEqual(items[0], 5000)
+        self.assertEqual(items.first_sequence_number, 5000)
+        self.assertEqual(items.end_sequence_number, 10000)
+        self.assertEqual(items.get_by_sequence_number(7000), 7000)
+
+    def test_appendleft(self) -> None:
+        items = ChunkedDeque(range(100))
+        for i in range(-1, -5000, -1):
+            items.appendleft(i)
+
+        self.assertEqual(list(items), list(range(-4999, 100)))
+        self.assertEqual(items.first_sequence_number, -4999)
+        self.assertEqual(items.get_by_sequence_number(-10), -10)
+
+    def test_clear_continues_sequence_numbers(self) -> None:
+        items = ChunkedDeque(range(10))
+        items.clear()
+
+        self.assertFalse(items)
+        self.assertEqual(items.first_sequence_number, 10)
+        items.append(123)
+        self.assertEqual(items.get_by_sequence_number(10), 123)
+
+    def test_matches_deque(self) -> None:
+        items: ChunkedDeque[int] = ChunkedDeque()
+        expected: collections.deque = collections.deque()
+        for i in range(30000):
+            if i % 3 == 2:
+                self.assertEqual(items.popleft(), expected.popleft())
+            elif i % 7 == 0:
+                items.appendleft(i)
+                expected.appendleft(i)
+            else:
+                items.append(i)
+                expected.append(i)
+
+        self.assertEqual(list(items), list(expected))
+        self.assertEqual(items[len(items) // 2], expected[len(expected) // 2])
+
+    def test_popleft_empty(self) -> None:
+        with self.assertRaises(IndexError):
+            ChunkedDeque().popleft()
+
+
+if __name__ == '__main__':
+    unittest.main()
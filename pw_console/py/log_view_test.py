@@ -456,6 +456,49 @@ if _PYTHON_3_8:
             log_view.clear_filters()
             self.assertEqual(log_view.get_total_count(), len(input_lines))
 
+        async def test_log_filtering_new_and_deleted_lines(self) -> None:
+            """Test that the filtered lines follow the log store history."""
+            log_view, _log_pane = self._create_log_view_from_list([
+                (f'{"even" if i % 2 == 0 else "odd"} {i}', dict())
+                for i in range(5)
+            ])
+            log_view.log_store.max_history_size = 6
+
+            log_view.new_search('even')
+            log_view.apply_filter()
+            await log_view.filter_existing_logs_task
+            self.assertEqual(
+                [log.record.message for log in log_view.filtered_logs],
+                ['even 0', 'even 2', 'even 4'])
+
+            test_log = logging.getLogger('log_view.test')
+            with self.assertLogs(test_log, level='DEBUG') as _log_context:
+                test_log.addHandler(log_view.log_store)
+                for i in range(5, 9):
+                    test_log.debug('%s', f'{"even" if i % 2 == 0 else "odd"} '
+                                   f'{i}')
+
+            # Lines 0 to 2 were deleted from the history.
+            self.assertEqual(
+                [log.record.message for log in log_view.filtered_logs],
+                ['even 4', 'even 6', 'even 8'])
+            self.assertEqual(log_view.get_total_count(), 3)
+
+        async def test_search_in_background(self) -> None:
+            """Test that searching many lines does not block."""
+            log_view, log_pane = self._create_log_view_from_list([
+                (f'Log {i}', dict()) for i in range(2500)
+            ])
+            log_view.new_search('Log 5$')
+
+            # The search runs as a task, so no match has been found yet.
+            self.assertIsNotNone(log_view.search_task)
+            self.assertEqual(log_view.get_current_line(), 2499)
+            await log_view.search_task
+
+            self.assertEqual(log_view.get_current_line(), 5)
+            log_pane.application.redraw_ui.assert_called()
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,131 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Deque with constant time random access for large log histories."""
+
+from typing import Generic, Iterable, Iterator, List, Optional, TypeVar
+
+T = TypeVar('T')
+
+# Number of items in each chunk. Chunks are small enough that adding or
+# dropping a chunk is cheap, and large enough that the chunk list stays short
+# for millions of items.
+_CHUNK_SIZE = 4096
+
+
+class ChunkedDeque(Generic[T]):
+    """Sequence of items stored in fixed size chunks.
+
+    Unlike collections.deque, which takes linear time to index into the middle,
+    ChunkedDeque supports constant time indexing as well as appending and
+    removing items at either end. This makes it suitable for scanning and
+    rendering from histories of millions of log lines.
+
+    Each item has a sequence number, which is its position counting every item
+    ever removed from the front. Sequence numbers stay the same as old items are
+    removed with popleft(), so they can be used to refer to items in the deque
+    from other data structures.
+    """
+    def __init__(self, items: Iterable[T] = ()):
+        self._chunks: List[List[Optional[T]]] = []
+        # Index of the first item in self._chunks[0].
+        self._head = 0
+        self._length = 0
+        # Sequence number of the first item.
+        self._first_sequence_number = 0
+        self.extend(items)
+
+    def __len__(self) -> int:
+        return self._length
+
+    def __bool__(self) -> bool:
+        return self._length != 0
+
+    def __getitem__(self, index: int) -> T:
+        if index < 0:
+            index += self._length
+        if not 0 <= index < self._length:
+            raise IndexError('ChunkedDeque index out of range')
+
+        position = self._head + index
+        return self._chunks[position // _CHUNK_SIZE][
+            position % _CHUNK_SIZE]  # type: ignore
+
+    def __iter__(self) -> Iterator[T]:
+        return self.iter_from(0)
+
+    def iter_from(self, start: int) -> Iterator[T]:
+        """Iterates over items starting from the given index."""
+        for index in range(max(start, 0), self._length):
+            yield self[index]
+
+    @property
+    def first_sequence_number(self) -> int:
+        """Sequence number of the first item; the count of items popped."""
+        return self._first_sequence_number
+
+    @property
+    def end_sequence_number(self) -> int:
+        """Sequence number that the next appended item will have."""
+        return self._first_sequence_number + self._length
+
+    def get_by_sequence_number(self, sequence_number: int) -> T:
+        return self[sequence_number - self._first_sequence_number]
+
+    def append(self, item: T) -> None:
+        # The last chunk is only shorter than _CHUNK_SIZE if it has room.
+        chunks = self._chunks
+        if not chunks or len(chunks[-1]) == _CHUNK_SIZE:
+            chunks.append([])
+        chunks[-1].append(item)
+        self._length += 1
+
+    def extend(self, items: Iterable[T]) -> None:
+        for item in items:
+            self.append(item)
+
+    def appendleft(self, item: T) -> None:
+        """Adds an item to the front; its sequence number is one less."""
+        if self._head == 0:
+            self._chunks.insert(0, [None] * _CHUNK_SIZE)
+            self._head = _CHUNK_SIZE
+        self._head -= 1
+        self._chunks[0][self._head] = item
+        self._length += 1
+        self._first_sequence_number -= 1
+
+    def popleft(self) -> T:
+        """Removes and returns the first item."""
+        if not self._length:
+            raise IndexError('pop from an empty ChunkedDeque')
+
+        item = self._chunks[0][self._head]
+        self._chunks[0][self._head] = None
+        self._head += 1
+        self._length -= 1
+        self._first_sequence_number += 1
+
+        if self._head == _CHUNK_SIZE:
+            del self._chunks[0]
+            self._head = 0
+        if not self._length:
+            self._chunks.clear()
+            self._head = 0
+        return item  # type: ignore
+
+    def clear(self) -> None:
+        """Removes all items. Sequence numbers continue from the last item."""
+        self._chunks.clear()
+        self._head = 0
+        self._first_sequence_number += self._length
+        self._length = 0
@@ -14,7 +14,6 @@
 """LogStore saves logs and acts as a Python logging handler."""
 
 from __future__ import annotations
-import collections
 import logging
 import sys
 from datetime import datetime
@@ -22,6 +21,7 @@ from typing import Dict, List, TYPE_CHECKING
 
 import pw_cli.color
 
+from pw_console.chunked_deque import ChunkedDeque
 from pw_console.console_prefs import ConsolePrefs
 from pw_console.log_line import LogLine
 import pw_console.text_formatting
@@ -35,9 +35,11 @@ class LogStore(logging.Handler):
     """Class to hold many log events."""
     def __init__(self, prefs: ConsolePrefs):
         self.prefs = prefs
-        # Log storage deque for fast addition and deletion from the beginning
-        # and end of the iterable.
-        self.logs: collections.deque = collections.deque()
+        # Log storage with fast addition and deletion from the beginning and
+        # end, and constant time indexing for rendering and searching. Each
+        # line's sequence number identifies it even after older lines are
+        # deleted.
+        self.logs: ChunkedDeque[LogLine] = ChunkedDeque()
 
         # Estimate of the logs in memory.
         self.byte_size: int = 0
@@ -87,7 +89,9 @@ class LogStore(logging.Handler):
 
     def clear_logs(self):
         """Erase all stored pane lines."""
-        self.logs = collections.deque()
+        # Clear rather than replace the deque so that sequence numbers are not
+        # reused. Viewers use them to refer to lines.
+        self.logs.clear()
         self.byte_size = 0
         self.channel_counts = {}
         self.channel_formatted_prefix_widths = {}
@@ -145,10 +149,10 @@ class LogStore(logging.Handler):
         ansi_stripped_log = pw_console.text_formatting.strip_ansi(
             formatted_log)
         # Save this log.
-        self.logs.append(
-            LogLine(record=record,
-                    formatted_log=formatted_log,
-                    ansi_stripped_log=ansi_stripped_log))
+        log_line = LogLine(record=record,
+                           formatted_log=formatted_log,
+                           ansi_stripped_log=ansi_stripped_log)
+        self.logs.append(log_line)
         # Increment this logger count
         self.channel_counts[record.name] = self.channel_counts.get(
             record.name, 0) + 1
@@ -157,13 +161,13 @@ class LogStore(logging.Handler):
         self._update_log_prefix_width(record)
 
         # Parse metadata fields
-        self.logs[-1].update_metadata()
+        log_line.update_metadata()
 
         # Check for bigger column widths.
-        self.table.update_metadata_column_widths(self.logs[-1])
+        self.table.update_metadata_column_widths(log_line)
 
         # Update estimated byte_size.
-        self.byte_size += sys.getsizeof(self.logs[-1])
+        self.byte_size += sys.getsizeof(log_line)
         # If the total log lines is > max_history_size, delete the oldest line.
         if self.get_total_count() > self.max_history_size:
             self.byte_size -= sys.getsizeof(self.logs.popleft())
@@ -21,7 +21,7 @@ import itertools
 import logging
 import re
 import time
-from typing import List, Optional, TYPE_CHECKING
+from typing import Iterable, Iterator, List, Optional, TYPE_CHECKING
 
 from prompt_toolkit.data_structures import Point
 from prompt_toolkit.formatted_text import (
@@ -31,6 +31,7 @@ from prompt_toolkit.formatted_text import (
     StyleAndTextTuples,
 )
 
+from pw_console.chunked_deque import ChunkedDeque
 from pw_console.log_filter import (
     DEFAULT_SEARCH_MATCHER,
     LogFilter,
@@ -48,6 +49,50 @@ if TYPE_CHECKING:
 
 _LOG = logging.getLogger(__package__)
 
+# Number of log lines to check between yielding to the event loop when
+# filtering or searching existing logs. Checking a line takes a few
+# microseconds, so a batch takes a few milliseconds and the UI stays responsive.
+_SCAN_BATCH_SIZE = 1000
+
+
+class FilteredLogLines:
+    """The lines of a LogStore that match a LogView's filters.
+
+    Matching lines are stored by sequence number rather than copied, so
+    indexing maps straight back into the LogStore. Lines are added as they
+    arrive and as past logs are scanned, rather than by rescanning the store.
+    """
+    def __init__(self, log_store: LogStore):
+        self._log_store = log_store
+        self.sequence_numbers: ChunkedDeque[int] = ChunkedDeque()
+
+    def __len__(self) -> int:
+        return len(self.sequence_numbers)
+
+    def __getitem__(self, index: int) -> 'LogLine':
+        return self._log_store.logs.get_by_sequence_number(
+            self.sequence_numbers[index])
+
+    def __iter__(self) -> Iterator['LogLine']:
+        for index in range(len(self)):
+            yield self[index]
+
+    def append(self, sequence_number: int) -> None:
+        self.sequence_numbers.append(sequence_number)
+
+    def appendleft(self, sequence_number: int) -> None:
+        self.sequence_numbers.appendleft(sequence_number)
+
+    def clear(self) -> None:
+        self.sequence_numbers = ChunkedDeque()
+
+    def drop_deleted_lines(self) -> None:
+        """Forgets lines the LogStore deleted to stay within its history size.
+        """
+        oldest = self._log_store.logs.first_sequence_number
+        while self.sequence_numbers and self.sequence_numbers[0] < oldest:
+            self.sequence_numbers.popleft()
+
 
 class LogView:
     """Viewing window into a LogStore."""
@@ -77,8 +122,11 @@ class LogView:
         self.filtering_on: bool = False
         self.filters: 'collections.OrderedDict[str, LogFilter]' = (
             collections.OrderedDict())
-        self.filtered_logs: collections.deque = collections.deque()
-        self.filter_existing_logs_task = None
+        self.filtered_logs = FilteredLogLines(self.log_store)
+        self.filter_existing_logs_task: Optional[asyncio.Task] = None
+
+        # Background task that moves to the next search match.
+        self.search_task: Optional[asyncio.Task] = None
 
         # Current log line index state variables:
         self._line_index = 0
@@ -97,7 +145,8 @@ class LogView:
         # log lines.
         self._ui_update_frequency = 0.1
         self._last_ui_update_time = time.time()
-        self._last_log_store_index = 0
+        # Sequence number of the first LogStore line not yet filtered.
+        self._next_unfiltered_sequence_number = 0
 
         # Should new log lines be tailed?
         self.follow: bool = True
@@ -143,19 +192,12 @@ class LogView:
         if starting_index > self.get_last_log_line_index():
             starting_index = log_beginning_index
 
-        logs = self._get_log_lines()
-
-        # From current position +1 and down
-        for i in range(starting_index, self.get_last_log_line_index() + 1):
-            if self.search_filter.matches(logs[i]):
-                self._set_match_position(i)
-                return
-
-        # From the beginning to the original start
-        for i in range(log_beginning_index, starting_index):
-            if self.search_filter.matches(logs[i]):
-                self._set_match_position(i)
-                return
+        # From current position +1 and down, then from the beginning to the
+        # original start.
+        self._start_search(
+            itertools.chain(
+                range(starting_index, self.get_last_log_line_index() + 1),
+                range(log_beginning_index, starting_index)))
 
     def search_backwards(self):
         if not self.search_filter:
@@ -168,19 +210,51 @@ class LogView:
         if starting_index < 0:
             starting_index = self.get_last_log_line_index()
 
-        logs = self._get_log_lines()
+        # From current position - 1 and up, then from the end to the original
+        # start.
+        self._start_search(
+            itertools.chain(
+                range(starting_index, log_beginning_index - 1, -1),
+                range(self.get_last_log_line_index(), starting_index, -1)))
 
-        # From current position - 1 and up
-        for i in range(starting_index, log_beginning_index - 1, -1):
-            if self.search_filter.matches(logs[i]):
-                self._set_match_position(i)
-                return
+    def _start_search(self, indices: Iterable[int]) -> None:
+        """Moves to the first of the given lines that matches the search.
 
-        # From the end to the original start
-        for i in range(self.get_last_log_line_index(), starting_index, -1):
-            if self.search_filter.matches(logs[i]):
+        Searching millions of lines takes a while, so when an event loop is
+        running the lines are checked in a background task that yields between
+        batches. Starting a new search cancels the previous one.
+        """
+        if self.search_task is not None:
+            self.search_task.cancel()
+            self.search_task = None
+
+        scan = self._scan_for_match(indices)
+        try:
+            self.search_task = asyncio.get_running_loop().create_task(
+                self._search_in_background(scan))
+        except RuntimeError:
+            # No event loop is running, so search synchronously.
+            for _ in scan:
+                pass
+
+    async def _search_in_background(self, scan: Iterator[None]) -> None:
+        for _ in scan:
+            await asyncio.sleep(0)
+
+    def _scan_for_match(self, indices: Iterable[int]) -> Iterator[None]:
+        """Generator that searches lines, yielding after each batch."""
+        search_filter = self.search_filter
+        logs = self._get_log_lines()
+        for count, i in enumerate(indices, 1):
+            # Stop if the logs changed in a way that invalidates the indices.
+            if (search_filter is not self.search_filter
+                    or logs is not self._get_log_lines() or i >= len(logs)):
+                return
+            if search_filter.matches(logs[i]):
                 self._set_match_position(i)
                 return
+            if count % _SCAN_BATCH_SIZE == 0:
+                yield
 
     def _set_search_regex(self,
                           text,
@@ -233,13 +307,22 @@ class LogView:
     def disable_search_highlighting(self):
         self.log_pane.log_view.search_highlight = False
 
+    def _cancel_filtering(self):
+        if self.filter_existing_logs_task is not None:
+            self.filter_existing_logs_task.cancel()
+            self.filter_existing_logs_task = None
+
     def _restart_filtering(self):
         # Turn on follow
         if not self.follow:
             self.toggle_follow()
 
         # Reset filtered logs.
+        self._cancel_filtering()
         self.filtered_logs.clear()
+        # Lines that arrive from now on are filtered by new_logs_arrived.
+        self._next_unfiltered_sequence_number = (
+            self.log_store.logs.end_sequence_number)
         # Reset scrollback start
         self._scrollback_start_index = 0
 
@@ -308,6 +391,7 @@ class LogView:
         self.filtering_on = False
         self.filters: 'collections.OrderedDict[str, re.Pattern]' = (
             collections.OrderedDict())
+        self._cancel_filtering()
         self.filtered_logs.clear()
         # Reset scrollback start
         self._scrollback_start_index = 0
@@ -315,20 +399,26 @@ class LogView:
             self.toggle_follow()
 
     async def filter_past_logs(self):
-        """Filter past log lines."""
-        starting_index = self.log_store.get_last_log_line_index()
-        ending_index = -1
-
-        # From the end of the log store to the beginning.
-        for i in range(starting_index, ending_index, -1):
-            # Is this log a match?
-            if self.filter_scan(self.log_store.logs[i]):
-                # Add to the beginning of the deque.
-                self.filtered_logs.appendleft(self.log_store.logs[i])
-            # TODO(tonymd): Tune these values.
-            # Pause every 100 lines or so
-            if i % 100 == 0:
-                await asyncio.sleep(.1)
+        """Filter past log lines.
+
+        Lines are scanned from the newest to the oldest, so the most recent
+        matches are shown first, yielding to the event loop between batches.
+        """
+        logs = self.log_store.logs
+        sequence_number = self._next_unfiltered_sequence_number - 1
+
+        while sequence_number >= logs.first_sequence_number:
+            batch_end = max(sequence_number - _SCAN_BATCH_SIZE,
+                            logs.first_sequence_number - 1)
+            for i in range(sequence_number, batch_end, -1):
+                if self.filter_scan(logs.get_by_sequence_number(i)):
+                    self.filtered_logs.appendleft(i)
+            sequence_number = batch_end
+
+            self._update_prompt_toolkit_ui()
+            # Let the UI and log handlers run. Lines may be deleted from the
+            # store meanwhile, which ends the loop early.
+            await asyncio.sleep(0)
 
     def set_log_pane(self, log_pane: 'LogPane'):
         """Set the parent LogPane instance."""
@@ -397,15 +487,19 @@ class LogView:
 
     def new_logs_arrived(self):
         # If follow is on, scroll to the last line.
-        latest_total = self.log_store.get_total_count()
+        logs = self.log_store.logs
 
         if self.filtering_on:
+            self.filtered_logs.drop_deleted_lines()
             # Scan newly arived log lines
-            for i in range(self._last_log_store_index, latest_total):
-                if self.filter_scan(self.log_store.logs[i]):
-                    self.filtered_logs.append(self.log_store.logs[i])
-
-        self._last_log_store_index = latest_total
+            for i in range(
+                    max(self._next_unfiltered_sequence_number,
+                        logs.first_sequence_number),
+                    logs.end_sequence_number):
+                if self.filter_scan(logs.get_by_sequence_number(i)):
+                    self.filtered_logs.append(i)
+
+        self._next_unfiltered_sequence_number = logs.end_sequence_number
 
         if self.follow:
             self.scroll_to_bottom()
@@ -14,6 +14,8 @@
 
 #include "pw_containers/flat_map.h"
 
+#include <array>
+#include <cstddef>
 #include <limits>
 
 #include "gtest/gtest.h"
@@ -178,4 +180,111 @@ TEST(FlatMap, MapsWithUnsortedKeys) {
   EXPECT_EQ(too_short.begin()->first, 0);
 }
 
+// Returns kSize items with the keys kSize - 1 down to 0 and each value set to
+// its key modulo 7.
+template <size_t kSize>
+constexpr std::array<typename FlatMap<int, int, kSize>::value_type, kSize>
+ReversedItems() {
+  std::array<typename FlatMap<int, int, kSize>::value_type, kSize> items{};
+  for (size_t i = 0; i < kSize; ++i) {
+    const int key = static_cast<int>(kSize - 1 - i);
+    items[i] = {key, key % 7};
+  }
+  return items;
+}
+
+TEST(FlatMap, LargeUnsortedMap_Sorted) {
+  constexpr FlatMap<int, int, 300> kLarge(ReversedItems<300>());
+  static_assert(kLarge.begin()->first == 0);
+  EXPECT_EQ(299 % 7, kLarge.find(299)->second);
+
+  int expected = 0;
+  for (const auto& item : kLarge) {
+    EXPECT_EQ(expected++, item.first);
+  }
+}
+
+TEST(FlatMap, Sort_IsStable) {
+  // Items with equal keys are spread across runs that are merged; they must
+  // keep their relative order.
+  std::array<FlatMap<int, int, 100>::value_type, 100> items{};
+  for (int i = 0; i < 100; ++i) {
+    items[i] = {(99 - i) % 5, i};
+  }
+  const FlatMap<int, int, 100> map(items);
+
+  for (auto it = map.begin() + 1; it != map.end(); ++it) {
+    ASSERT_LE((it - 1)->first, it->first);
+    if ((it - 1)->first == it->first) {
+      EXPECT_LT((it - 1)->second, it->second);
+    }
+  }
+}
+
+TEST(FlatMap, FromSorted) {
+  constexpr auto kMap = FlatMap<int, char, 3>::FromSorted({{
+      {1, 'a'},
+      {5, 'b'},
+      {9, 'c'},
+  }});
+  EXPECT_TRUE(kMap.contains(5));
+  EXPECT_EQ('c', kMap.find(9)->second);
+  EXPECT_EQ(kMap.end(), kMap.find(2));
+}
+
+template <size_t kSize>
+void CheckEytzingerLookups() {
+  const EytzingerFlatMap<int, int, kSize> map(ReversedItems<kSize>());
+  EXPECT_EQ(kSize, map.size());
+  for (int key = 0; key < static_cast<int>(kSize); ++key) {
+    const auto it = map.find(key);
+    ASSERT_NE(map.end(), it);
+    EXPECT_EQ(key, it->first);
+    EXPECT_EQ(key % 7, it->second);
+  }
+  EXPECT_FALSE(map.contains(-1));
+  EXPECT_FALSE(map.contains(static_cast<int>(kSize)));
+}
+
+TEST(EytzingerFlatMap, FindEveryKey) {
+  CheckEytzingerLookups<1>();
+  CheckEytzingerLookups<2>();
+  CheckEytzingerLookups<7>();
+  CheckEytzingerLookups<8>();
+  CheckEytzingerLookups<100>();
+  CheckEytzingerLookups<1000>();
+}
+
+TEST(EytzingerFlatMap, Empty) {
+  constexpr EytzingerFlatMap<int, char, 0> kEmpty({{}});
+  EXPECT_TRUE(kEmpty.empty());
+  EXPECT_EQ(kEmpty.end(), kEmpty.find(0));
+}
+
+TEST(EytzingerFlatMap, MissingKeysBetweenItems) {
+  constexpr EytzingerFlatMap<int, char, 5> kMap({{
+      {40, 'd'},
+      {10, 'a'},
+      {50, 'e'},
+      {20, 'b'},
+      {30, 'c'},
+  }});
+  static_assert(kMap.find(30)->second == 'c');
+  for (int key = 5; key <= 55; key += 10) {
+    EXPECT_FALSE(kMap.contains(key));
+  }
+  EXPECT_EQ('a', kMap.find(10)->second);
+  EXPECT_EQ('e', kMap.find(50)->second);
+}
+
+TEST(EytzingerFlatMap, DuplicateKeys_FindsFirst) {
+  constexpr EytzingerFlatMap<int, char, 4> kMap({{
+      {2, 'x'},
+      {1, 'a'},
+      {2, 'y'},
+      {3, 'b'},
+  }});
+  EXPECT_EQ('x', kMap.find(2)->second);
+}
+
 }  // namespace pw::containers
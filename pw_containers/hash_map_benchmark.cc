@@ -0,0 +1,129 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compares lookup latency of HashMap, FlatMap, EytzingerFlatMap, and a linear
+// scan of a Vector for several map sizes. Run on the host or on a device with a
+// pw_chrono:system_clock backend; results are logged.
+
+#define PW_LOG_MODULE_NAME "CONTAINERS"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_containers/flat_map.h"
+#include "pw_containers/hash_map.h"
+#include "pw_containers/vector.h"
+#include "pw_log/log.h"
+
+namespace pw::containers {
+namespace {
+
+constexpr size_t kRounds = 20;
+
+// Lookup results are stored here so the lookups are not optimized out.
+volatile uint32_t lookup_sink;
+
+// Spreads the keys out so that they are not sequential.
+constexpr uint32_t MakeKey(size_t i) {
+  return static_cast<uint32_t>(i) * 2654435761u;
+}
+
+// Looks up every key kRounds times and returns the average latency in
+// nanoseconds, or -1 if a key is missing.
+template <size_t kEntries, typename Lookup>
+int64_t MeasureLookupLatency(Lookup&& lookup) {
+  uint32_t sum = 0;
+  const auto start = chrono::SystemClock::now();
+  for (size_t round = 0; round < kRounds; ++round) {
+    for (size_t i = 0; i < kEntries; ++i) {
+      const uint32_t* value = lookup(MakeKey(i));
+      if (value == nullptr) {
+        return -1;
+      }
+      sum += *value;
+    }
+  }
+  const auto elapsed = chrono::SystemClock::now() - start;
+
+  lookup_sink = sum;
+
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() /
+         static_cast<int64_t>(kRounds * kEntries);
+}
+
+template <size_t kEntries>
+void CompareLookups() {
+  using FlatMapType = FlatMap<uint32_t, uint32_t, kEntries>;
+
+  // Keep the hash map at most half full.
+  static HashMap<uint32_t, uint32_t, 2 * kEntries> hash_map;
+  static Vector<std::pair<uint32_t, uint32_t>, kEntries> vector;
+  static std::array<typename FlatMapType::value_type, kEntries> items;
+
+  for (size_t i = 0; i < kEntries; ++i) {
+    const uint32_t value = static_cast<uint32_t>(i);
+    hash_map.emplace(MakeKey(i), value);
+    vector.emplace_back(MakeKey(i), value);
+    items[i] = {MakeKey(i), value};
+  }
+  static const FlatMapType flat_map(items);
+  static const EytzingerFlatMap<uint32_t, uint32_t, kEntries> eytzinger(items);
+
+  const int64_t hash_map_ns =
+      MeasureLookupLatency<kEntries>([](uint32_t key) -> const uint32_t* {
+        const auto it = hash_map.find(key);
+        return it == hash_map.end() ? nullptr : &it->second;
+      });
+  const int64_t flat_map_ns =
+      MeasureLookupLatency<kEntries>([](uint32_t key) -> const uint32_t* {
+        const auto it = flat_map.find(key);
+        return it == flat_map.end() ? nullptr : &it->second;
+      });
+  const int64_t eytzinger_ns =
+      MeasureLookupLatency<kEntries>([](uint32_t key) -> const uint32_t* {
+        const auto it = eytzinger.find(key);
+        return it == eytzinger.end() ? nullptr : &it->second;
+      });
+  const int64_t vector_ns =
+      MeasureLookupLatency<kEntries>([](uint32_t key) -> const uint32_t* {
+        for (const auto& [entry_key, value] : vector) {
+          if (entry_key == key) {
+            return &value;
+          }
+        }
+        return nullptr;
+      });
+
+  PW_LOG_INFO(
+      "%4u entries: HashMap %4ld ns, FlatMap %4ld ns, Eytzinger %4ld ns, "
+      "Vector scan %5ld ns",
+      static_cast<unsigned>(kEntries),
+      static_cast<long>(hash_map_ns),
+      static_cast<long>(flat_map_ns),
+      static_cast<long>(eytzinger_ns),
+      static_cast<long>(vector_ns));
+}
+
+}  // namespace
+}  // namespace pw::containers
+
+int main() {
+  pw::containers::CompareLookups<16>();
+  pw::containers::CompareLookups<128>();
+  pw::containers::CompareLookups<1024>();
+  pw::containers::CompareLookups<4096>();
+  return 0;
+}
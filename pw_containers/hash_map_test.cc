@@ -0,0 +1,256 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/hash_map.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+namespace pw::containers {
+namespace {
+
+// Sends every key to the same home slot to exercise probing.
+struct CollidingHash {
+  size_t operator()(int) const { return 0; }
+};
+
+// Tracks the number of live objects to check that entries are destroyed.
+class Counted {
+ public:
+  Counted(int value = 0) : value_(value) { live += 1; }
+  Counted(const Counted& other) : value_(other.value_) { live += 1; }
+  Counted(Counted&& other) : value_(other.value_) { live += 1; }
+  ~Counted() { live -= 1; }
+
+  Counted& operator=(const Counted&) = default;
+
+  int value() const { return value_; }
+
+  static int live;
+
+ private:
+  int value_;
+};
+
+int Counted::live = 0;
+
+TEST(HashMap, Empty) {
+  HashMap<int, int, 8> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(0u, map.size());
+  EXPECT_EQ(8u, map.max_size());
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(map.end(), map.find(1));
+  EXPECT_FALSE(map.contains(1));
+}
+
+TEST(HashMap, Emplace_Find) {
+  HashMap<int, char, 16> map;
+  for (int i = 0; i < 10; ++i) {
+    const auto [it, inserted] = map.emplace(i, static_cast<char>('a' + i));
+    ASSERT_TRUE(inserted);
+    EXPECT_EQ(i, it->first);
+  }
+  EXPECT_EQ(10u, map.size());
+
+  for (int i = 0; i < 10; ++i) {
+    const auto it = map.find(i);
+    ASSERT_NE(map.end(), it);
+    EXPECT_EQ(static_cast<char>('a' + i), it->second);
+  }
+  EXPECT_FALSE(map.contains(10));
+  EXPECT_EQ(0u, map.count(-1));
+}
+
+TEST(HashMap, Emplace_ExistingKey_NotReplaced) {
+  HashMap<int, char, 4> map;
+  ASSERT_TRUE(map.emplace(1, 'a').second);
+
+  const auto [it, inserted] = map.emplace(1, 'b');
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ('a', it->second);
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(HashMap, Insert) {
+  HashMap<std::string_view, int, 4> map;
+  EXPECT_TRUE(map.insert({"one", 1}).second);
+  EXPECT_TRUE(map.insert({"two", 2}).second);
+  EXPECT_FALSE(map.insert({"one", 3}).second);
+  EXPECT_EQ(1, map.find("one")->second);
+  EXPECT_EQ(2, map.find("two")->second);
+}
+
+TEST(HashMap, Full_InsertFails) {
+  HashMap<int, int, 4> map;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(map.emplace(i, i).second);
+  }
+  EXPECT_TRUE(map.full());
+
+  const auto [it, inserted] = map.emplace(4, 4);
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(map.end(), it);
+
+  // Existing keys are still found in a full map.
+  EXPECT_EQ(map.find(3), map.emplace(3, 0).first);
+  EXPECT_FALSE(map.contains(4));
+}
+
+TEST(HashMap, Subscript) {
+  HashMap<int, int, 8> map;
+  map[5] = 50;
+  map[6] += 1;
+  map[6] += 1;
+  EXPECT_EQ(50, map[5]);
+  EXPECT_EQ(2, map[6]);
+  EXPECT_EQ(2u, map.size());
+}
+
+TEST(HashMap, Erase) {
+  HashMap<int, int, 16> map;
+  for (int i = 0; i < 12; ++i) {
+    ASSERT_TRUE(map.emplace(i, i * 10).second);
+  }
+
+  EXPECT_EQ(1u, map.erase(4));
+  EXPECT_EQ(0u, map.erase(4));
+  EXPECT_EQ(0u, map.erase(100));
+  EXPECT_EQ(11u, map.size());
+
+  for (int i = 0; i < 12; ++i) {
+    if (i == 4) {
+      EXPECT_FALSE(map.contains(i));
+    } else {
+      ASSERT_TRUE(map.contains(i));
+      EXPECT_EQ(i * 10, map.find(i)->second);
+    }
+  }
+}
+
+TEST(HashMap, Collisions_InsertFindErase) {
+  HashMap<int, int, 8, CollidingHash> map;
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(map.emplace(i, i).second);
+  }
+
+  // Erase from the middle of the probe sequence; the rest remain reachable.
+  EXPECT_EQ(1u, map.erase(2));
+  EXPECT_EQ(1u, map.erase(0));
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(i != 0 && i != 2, map.contains(i));
+  }
+
+  ASSERT_TRUE(map.emplace(100, 100).second);
+  ASSERT_TRUE(map.emplace(200, 200).second);
+  EXPECT_EQ(100, map.find(100)->second);
+  EXPECT_EQ(200, map.find(200)->second);
+  EXPECT_EQ(7, map.find(7)->second);
+}
+
+TEST(HashMap, ManyInsertsAndErases_MatchesReference) {
+  constexpr uint32_t kKeys = 200;
+  HashMap<uint32_t, uint32_t, 64> map;
+  std::array<bool, kKeys> present = {};
+  size_t expected_size = 0;
+
+  // Toggle pseudorandom keys, keeping a record of which should be present.
+  uint32_t random = 1;
+  for (int i = 0; i < 5000; ++i) {
+    random = random * 1103515245u + 12345u;
+    const uint32_t key = (random >> 16) % kKeys;
+
+    if (present[key]) {
+      ASSERT_EQ(1u, map.erase(key));
+      present[key] = false;
+      expected_size -= 1;
+    } else if (!map.full()) {
+      ASSERT_TRUE(map.emplace(key, key * 3).second);
+      present[key] = true;
+      expected_size += 1;
+    }
+    ASSERT_EQ(expected_size, map.size());
+  }
+
+  for (uint32_t key = 0; key < kKeys; ++key) {
+    ASSERT_EQ(present[key], map.contains(key));
+  }
+  for (const auto& [key, value] : map) {
+    ASSERT_EQ(key * 3, value);
+  }
+}
+
+TEST(HashMap, Iteration_VisitsEveryEntry) {
+  HashMap<int, int, 32> map;
+  for (int i = 1; i <= 20; ++i) {
+    map[i] = i;
+  }
+
+  int sum = 0;
+  size_t visited = 0;
+  for (auto& [key, value] : map) {
+    value *= 2;
+    sum += key;
+    visited += 1;
+  }
+  EXPECT_EQ(20u, visited);
+  EXPECT_EQ(210, sum);
+
+  const auto& const_map = map;
+  int doubled = 0;
+  for (HashMap<int, int, 32>::const_iterator it = const_map.begin();
+       it != const_map.end();
+       ++it) {
+    doubled += it->second;
+  }
+  EXPECT_EQ(420, doubled);
+}
+
+TEST(HashMap, SingleSlot) {
+  HashMap<int, int, 1> map;
+  ASSERT_TRUE(map.emplace(7, 1).second);
+  EXPECT_FALSE(map.emplace(8, 2).second);
+  EXPECT_EQ(1u, map.erase(7));
+  EXPECT_TRUE(map.emplace(8, 2).second);
+  EXPECT_EQ(2, map.find(8)->second);
+}
+
+TEST(HashMap, DestroysEntries) {
+  {
+    HashMap<int, Counted, 8, CollidingHash> map;
+    for (int i = 0; i < 6; ++i) {
+      map.emplace(i, i);
+    }
+    EXPECT_EQ(6, Counted::live);
+
+    // Moving entries around keeps one live object per entry.
+    map.erase(0);
+    map.emplace(10, 10);
+    EXPECT_EQ(6, Counted::live);
+
+    map.clear();
+    EXPECT_EQ(0, Counted::live);
+    EXPECT_TRUE(map.empty());
+
+    map.emplace(1, 1);
+  }
+  EXPECT_EQ(0, Counted::live);
+}
+
+}  // namespace
+}  // namespace pw::containers
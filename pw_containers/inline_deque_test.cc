@@ -0,0 +1,236 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/inline_deque.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace {
+
+// Tracks the number of live objects to check that elements are destroyed.
+class Counted {
+ public:
+  Counted(int value = 0) : value_(value) { live += 1; }
+  Counted(const Counted& other) : value_(other.value_) { live += 1; }
+  Counted(Counted&& other) : value_(other.value_) { live += 1; }
+  ~Counted() { live -= 1; }
+
+  Counted& operator=(const Counted&) = default;
+
+  int value() const { return value_; }
+
+  static int live;
+
+ private:
+  int value_;
+};
+
+int Counted::live = 0;
+
+// Fills the deque so that its elements wrap around the end of the buffer.
+template <size_t kCapacity>
+void FillWrapped(InlineDeque<int, kCapacity>& deque, size_t offset) {
+  for (size_t i = 0; i < offset; ++i) {
+    deque.push_back(-1);
+  }
+  for (size_t i = 0; i < kCapacity - offset; ++i) {
+    deque.push_back(static_cast<int>(i));
+  }
+  for (size_t i = 0; i < offset; ++i) {
+    deque.pop_front();
+    deque.push_back(static_cast<int>(kCapacity - offset + i));
+  }
+}
+
+TEST(InlineDeque, Empty) {
+  InlineDeque<int, 4> deque;
+  EXPECT_TRUE(deque.empty());
+  EXPECT_FALSE(deque.full());
+  EXPECT_EQ(0u, deque.size());
+  EXPECT_EQ(4u, deque.capacity());
+  EXPECT_EQ(deque.begin(), deque.end());
+  EXPECT_TRUE(deque.front_segment().empty());
+}
+
+TEST(InlineDeque, PushBack_PopFront) {
+  InlineDeque<int, 4> deque;
+  deque.push_back(1);
+  deque.push_back(2);
+  deque.emplace_back(3);
+  EXPECT_EQ(3u, deque.size());
+  EXPECT_EQ(1, deque.front());
+  EXPECT_EQ(3, deque.back());
+
+  deque.pop_front();
+  EXPECT_EQ(2, deque.front());
+  deque.pop_back();
+  EXPECT_EQ(2, deque.back());
+  EXPECT_EQ(1u, deque.size());
+}
+
+TEST(InlineDeque, PushFront) {
+  InlineDeque<int, 4> deque;
+  deque.push_front(1);
+  deque.push_front(2);
+  deque.emplace_front(3);
+  deque.push_back(0);
+  EXPECT_TRUE(deque.full());
+
+  const std::array<int, 4> kExpected = {3, 2, 1, 0};
+  size_t i = 0;
+  for (int value : deque) {
+    EXPECT_EQ(kExpected[i++], value);
+  }
+  EXPECT_EQ(4u, i);
+  EXPECT_EQ(2, deque[1]);
+  EXPECT_EQ(1, deque.at(2));
+}
+
+TEST(InlineDeque, Wrapped_IndexAndIterate) {
+  InlineDeque<int, 5> deque;
+  FillWrapped(deque, 3);
+  ASSERT_TRUE(deque.full());
+
+  for (size_t i = 0; i < deque.size(); ++i) {
+    EXPECT_EQ(static_cast<int>(i), deque[static_cast<unsigned short>(i)]);
+  }
+
+  int expected = 4;
+  for (auto it = deque.end(); it != deque.begin();) {
+    --it;
+    EXPECT_EQ(expected--, *it);
+  }
+}
+
+TEST(InlineDeque, GenericReference) {
+  InlineDeque<int, 8> deque;
+  InlineDeque<int>& generic = deque;
+  generic.push_back(5);
+  EXPECT_EQ(8u, generic.capacity());
+  EXPECT_EQ(5, deque.front());
+}
+
+TEST(InlineDeque, BatchPushBack_CopiesWhatFits) {
+  InlineDeque<int, 6> deque;
+  deque.push_back(0);
+
+  constexpr std::array<int, 8> kValues = {1, 2, 3, 4, 5, 6, 7, 8};
+  EXPECT_EQ(5u, deque.push_back(std::span(kValues)));
+  EXPECT_TRUE(deque.full());
+  EXPECT_EQ(5, deque.back());
+  EXPECT_EQ(0u, deque.push_back(std::span(kValues)));
+}
+
+TEST(InlineDeque, BatchPopFront) {
+  InlineDeque<int, 6> deque;
+  FillWrapped(deque, 4);
+
+  EXPECT_EQ(4u, deque.pop_front(4));
+  EXPECT_EQ(4, deque.front());
+  EXPECT_EQ(2u, deque.pop_front(10));
+  EXPECT_TRUE(deque.empty());
+  EXPECT_EQ(0u, deque.pop_front(1));
+}
+
+TEST(InlineDeque, FrontSegment_Wrapped) {
+  InlineDeque<int, 6> deque;
+  FillWrapped(deque, 4);
+
+  // The first two elements are at the end of the buffer.
+  std::span<int> segment = deque.front_segment();
+  ASSERT_EQ(2u, segment.size());
+  EXPECT_EQ(0, segment[0]);
+  EXPECT_EQ(1, segment[1]);
+
+  deque.pop_front(static_cast<unsigned short>(segment.size()));
+  segment = deque.front_segment();
+  ASSERT_EQ(4u, segment.size());
+  EXPECT_EQ(2, segment[0]);
+  EXPECT_EQ(5, segment[3]);
+}
+
+TEST(InlineDeque, FreeSegment_CommitBack) {
+  InlineDeque<std::byte, 8> deque;
+  std::span<std::byte> free = deque.free_segment();
+  ASSERT_EQ(8u, free.size());
+
+  constexpr std::array<std::byte, 5> kData = {
+      std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}, std::byte{5}};
+  std::memcpy(free.data(), kData.data(), kData.size());
+  deque.commit_back(kData.size());
+  EXPECT_EQ(5u, deque.size());
+  EXPECT_EQ(std::byte{5}, deque.back());
+
+  // After popping from the front, the free space wraps around the end.
+  deque.pop_front(4);
+  free = deque.free_segment();
+  ASSERT_EQ(3u, free.size());
+  std::memset(free.data(), 0x7f, free.size());
+  deque.commit_back(static_cast<unsigned short>(free.size()));
+
+  free = deque.free_segment();
+  EXPECT_EQ(4u, free.size());
+  EXPECT_EQ(4u, deque.size());
+  EXPECT_EQ(std::byte{5}, deque.front());
+  EXPECT_EQ(std::byte{0x7f}, deque.back());
+}
+
+TEST(InlineDeque, Copy_Move) {
+  InlineDeque<int, 4> deque;
+  FillWrapped(deque, 2);
+
+  InlineDeque<int, 8> copy(deque);
+  EXPECT_EQ(deque, copy);
+
+  InlineDeque<int, 4> moved(std::move(copy));
+  EXPECT_EQ(deque, moved);
+  EXPECT_TRUE(copy.empty());  // NOLINT(bugprone-use-after-move)
+
+  moved.pop_back();
+  EXPECT_NE(deque, moved);
+  moved = deque;
+  EXPECT_EQ(deque, moved);
+}
+
+TEST(InlineDeque, DestroysElements) {
+  {
+    InlineDeque<Counted, 4> deque;
+    deque.emplace_back(1);
+    deque.emplace_back(2);
+    deque.emplace_front(0);
+    EXPECT_EQ(3, Counted::live);
+
+    deque.pop_front();
+    deque.pop_back();
+    EXPECT_EQ(1, Counted::live);
+
+    deque.emplace_back(3);
+    deque.emplace_back(4);
+    EXPECT_EQ(2u, deque.pop_front(2));
+    EXPECT_EQ(1, Counted::live);
+    EXPECT_EQ(4, deque.front().value());
+  }
+  EXPECT_EQ(0, Counted::live);
+}
+
+static_assert(std::is_trivially_destructible_v<InlineDeque<int, 4>>);
+static_assert(!std::is_trivially_destructible_v<InlineDeque<Counted, 4>>);
+
+}  // namespace
+}  // namespace pw
@@ -0,0 +1,134 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/inline_spsc_queue.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace {
+
+// Tracks the number of live objects to check that values are destroyed.
+class Counted {
+ public:
+  Counted(int value = 0) : value_(value) { live += 1; }
+  Counted(const Counted& other) : value_(other.value_) { live += 1; }
+  Counted(Counted&& other) : value_(other.value_) { live += 1; }
+  ~Counted() { live -= 1; }
+
+  Counted& operator=(const Counted&) = default;
+  Counted& operator=(Counted&&) = default;
+
+  int value() const { return value_; }
+
+  static int live;
+
+ private:
+  int value_;
+};
+
+int Counted::live = 0;
+
+TEST(InlineSpscQueue, Empty) {
+  InlineSpscQueue<int, 4> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(0u, queue.size());
+  EXPECT_EQ(4u, queue.capacity());
+  EXPECT_EQ(std::nullopt, queue.try_pop());
+}
+
+TEST(InlineSpscQueue, PushPop_InOrder) {
+  InlineSpscQueue<int, 4> queue;
+  EXPECT_TRUE(queue.try_push(1));
+  EXPECT_TRUE(queue.try_push(2));
+  EXPECT_TRUE(queue.try_emplace(3));
+  EXPECT_EQ(3u, queue.size());
+
+  EXPECT_EQ(1, queue.try_pop());
+  EXPECT_EQ(2, queue.try_pop());
+  EXPECT_EQ(3, queue.try_pop());
+  EXPECT_EQ(std::nullopt, queue.try_pop());
+}
+
+TEST(InlineSpscQueue, Full_PushFails) {
+  InlineSpscQueue<int, 2> queue;
+  EXPECT_TRUE(queue.try_push(1));
+  EXPECT_TRUE(queue.try_push(2));
+  EXPECT_TRUE(queue.full());
+  EXPECT_FALSE(queue.try_push(3));
+
+  EXPECT_EQ(1, queue.try_pop());
+  EXPECT_TRUE(queue.try_push(3));
+  EXPECT_EQ(2, queue.try_pop());
+  EXPECT_EQ(3, queue.try_pop());
+}
+
+TEST(InlineSpscQueue, BatchPushPop_Wrapped) {
+  InlineSpscQueue<uint8_t, 8> queue;
+  constexpr std::array<uint8_t, 6> kFirst = {1, 2, 3, 4, 5, 6};
+  ASSERT_EQ(6u, queue.push(kFirst));
+
+  std::array<uint8_t, 4> out = {};
+  ASSERT_EQ(4u, queue.pop(out));
+  EXPECT_EQ(4, out[3]);
+
+  // Only six more values fit; they wrap around the end of the buffer.
+  constexpr std::array<uint8_t, 8> kSecond = {7, 8, 9, 10, 11, 12, 13, 14};
+  EXPECT_EQ(6u, queue.push(kSecond));
+  EXPECT_TRUE(queue.full());
+
+  std::array<uint8_t, 10> all = {};
+  ASSERT_EQ(8u, queue.pop(all));
+  for (size_t i = 0; i < 8u; ++i) {
+    EXPECT_EQ(i + 5, all[i]);
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(InlineSpscQueue, IndicesWrap) {
+  InlineSpscQueue<uint32_t, 4> queue;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(queue.try_push(i));
+    ASSERT_TRUE(queue.try_push(i + 1));
+    ASSERT_EQ(i, queue.try_pop());
+    ASSERT_EQ(i + 1, queue.try_pop());
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(InlineSpscQueue, DestroysValues) {
+  {
+    InlineSpscQueue<Counted, 4> queue;
+    queue.try_emplace(1);
+    queue.try_emplace(2);
+    queue.try_emplace(3);
+    EXPECT_EQ(3, Counted::live);
+
+    EXPECT_EQ(1, queue.try_pop()->value());
+    EXPECT_EQ(2, Counted::live);
+
+    std::array<Counted, 1> out;
+    EXPECT_EQ(1u, queue.pop(out));
+    EXPECT_EQ(2, out[0].value());
+    EXPECT_EQ(2, Counted::live);
+  }
+  EXPECT_EQ(0, Counted::live);
+}
+
+}  // namespace
+}  // namespace pw
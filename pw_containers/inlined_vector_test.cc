@@ -0,0 +1,217 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/inlined_vector.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace {
+
+// Allocates from the system heap, counting allocations and optionally
+// failing them.
+class TestAllocator {
+ public:
+  void* Allocate(size_t size) {
+    if (fail_) {
+      return nullptr;
+    }
+    allocations += 1;
+    outstanding += 1;
+    last_size = size;
+    return std::malloc(size);
+  }
+
+  void Free(void* ptr) {
+    outstanding -= 1;
+    std::free(ptr);
+  }
+
+  void set_fail(bool fail) { fail_ = fail; }
+
+  int allocations = 0;
+  int outstanding = 0;
+  size_t last_size = 0;
+
+ private:
+  bool fail_ = false;
+};
+
+// Tracks the number of live objects to check that elements are destroyed.
+class Counted {
+ public:
+  Counted(int value = 0) : value_(value) { live += 1; }
+  Counted(const Counted& other) : value_(other.value_) { live += 1; }
+  Counted(Counted&& other) : value_(other.value_) { live += 1; }
+  ~Counted() { live -= 1; }
+
+  int value() const { return value_; }
+
+  static int live;
+
+ private:
+  int value_;
+};
+
+int Counted::live = 0;
+
+template <typename T, size_t kInlineCapacity>
+using TestVector = InlinedVector<T, kInlineCapacity, TestAllocator>;
+
+class InlinedVectorTest : public ::testing::Test {
+ protected:
+  ~InlinedVectorTest() { EXPECT_EQ(0, allocator_.outstanding); }
+
+  TestAllocator allocator_;
+};
+
+TEST_F(InlinedVectorTest, StaysInline) {
+  TestVector<int, 4> vector(allocator_);
+  EXPECT_TRUE(vector.empty());
+  EXPECT_EQ(4u, vector.capacity());
+
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(OkStatus(), vector.push_back(i));
+  }
+  EXPECT_TRUE(vector.is_inline());
+  EXPECT_EQ(0, allocator_.allocations);
+  EXPECT_EQ(3, vector.back());
+}
+
+TEST_F(InlinedVectorTest, SpillsToAllocator) {
+  TestVector<int, 4> vector(allocator_);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(OkStatus(), vector.push_back(i));
+  }
+  EXPECT_FALSE(vector.is_inline());
+  EXPECT_EQ(10u, vector.size());
+  EXPECT_GE(vector.capacity(), 10u);
+  EXPECT_EQ(2, allocator_.allocations);  // Grew from 4 to 8 to 16.
+  EXPECT_EQ(1, allocator_.outstanding);
+
+  int expected = 0;
+  for (int value : vector) {
+    EXPECT_EQ(expected++, value);
+  }
+}
+
+TEST_F(InlinedVectorTest, AllocationFails_ResourceExhausted) {
+  TestVector<int, 2> vector(allocator_);
+  ASSERT_EQ(OkStatus(), vector.push_back(1));
+  ASSERT_EQ(OkStatus(), vector.push_back(2));
+
+  allocator_.set_fail(true);
+  EXPECT_EQ(Status::ResourceExhausted(), vector.push_back(3));
+  EXPECT_EQ(Status::ResourceExhausted(), vector.reserve(100));
+  EXPECT_EQ(Status::ResourceExhausted(), vector.resize(3));
+
+  // The vector is unchanged.
+  EXPECT_EQ(2u, vector.size());
+  EXPECT_TRUE(vector.is_inline());
+  EXPECT_EQ(2, vector[1]);
+}
+
+TEST_F(InlinedVectorTest, Reserve_AllocatesOnce) {
+  TestVector<int, 2> vector(allocator_);
+  ASSERT_EQ(OkStatus(), vector.reserve(50));
+  EXPECT_EQ(50 * sizeof(int), allocator_.last_size);
+  for (int i = 0; i < 50; ++i) {
+    ASSERT_EQ(OkStatus(), vector.push_back(i));
+  }
+  EXPECT_EQ(1, allocator_.allocations);
+}
+
+TEST_F(InlinedVectorTest, Resize) {
+  TestVector<int, 4> vector(allocator_);
+  ASSERT_EQ(OkStatus(), vector.resize(6));
+  EXPECT_EQ(6u, vector.size());
+  EXPECT_EQ(0, vector[5]);
+
+  ASSERT_EQ(OkStatus(), vector.resize(1));
+  EXPECT_EQ(1u, vector.size());
+}
+
+TEST_F(InlinedVectorTest, ShrinkToFit_ReturnsInline) {
+  TestVector<int, 4> vector(allocator_);
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_EQ(OkStatus(), vector.push_back(i));
+  }
+  while (vector.size() > 3u) {
+    vector.pop_back();
+  }
+
+  ASSERT_EQ(OkStatus(), vector.shrink_to_fit());
+  EXPECT_TRUE(vector.is_inline());
+  EXPECT_EQ(0, allocator_.outstanding);
+  EXPECT_EQ(2, vector.back());
+}
+
+TEST_F(InlinedVectorTest, Move_Spilled_TransfersAllocation) {
+  TestVector<Counted, 2> vector(allocator_);
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_EQ(OkStatus(), vector.emplace_back(i));
+  }
+  const Counted* const elements = vector.data();
+
+  TestVector<Counted, 2> moved(std::move(vector));
+  EXPECT_EQ(elements, moved.data());
+  EXPECT_EQ(5u, moved.size());
+  EXPECT_TRUE(vector.empty());  // NOLINT(bugprone-use-after-move)
+  EXPECT_TRUE(vector.is_inline());
+  EXPECT_EQ(5, Counted::live);
+  EXPECT_EQ(1, allocator_.outstanding);
+}
+
+TEST_F(InlinedVectorTest, Move_Inline_MovesElements) {
+  TestVector<Counted, 4> vector(allocator_);
+  ASSERT_EQ(OkStatus(), vector.emplace_back(1));
+  ASSERT_EQ(OkStatus(), vector.emplace_back(2));
+
+  TestVector<Counted, 4> moved(allocator_);
+  ASSERT_EQ(OkStatus(), moved.emplace_back(9));
+  moved = std::move(vector);
+  EXPECT_TRUE(moved.is_inline());
+  ASSERT_EQ(2u, moved.size());
+  EXPECT_EQ(2, moved[1].value());
+  EXPECT_TRUE(vector.empty());  // NOLINT(bugprone-use-after-move)
+  EXPECT_EQ(2, Counted::live);
+}
+
+TEST_F(InlinedVectorTest, DestroysElementsAndFreesMemory) {
+  {
+    TestVector<Counted, 2> vector(allocator_);
+    for (int i = 0; i < 7; ++i) {
+      ASSERT_EQ(OkStatus(), vector.emplace_back(i));
+    }
+    EXPECT_EQ(7, Counted::live);
+    vector.pop_back();
+    EXPECT_EQ(6, Counted::live);
+  }
+  EXPECT_EQ(0, Counted::live);
+}
+
+TEST_F(InlinedVectorTest, NoInlineCapacity) {
+  TestVector<int, 0> vector(allocator_);
+  EXPECT_EQ(0u, vector.capacity());
+  ASSERT_EQ(OkStatus(), vector.push_back(1));
+  EXPECT_FALSE(vector.is_inline());
+  EXPECT_EQ(1, vector.front());
+}
+
+}  // namespace
+}  // namespace pw
@@ -0,0 +1,45 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_dlist.h"
+
+#include "pw_assert/check.h"
+
+namespace pw::intrusive_dlist_impl {
+
+void List::insert(Item* pos, Item& item) {
+  PW_CHECK(
+      item.unlisted(),
+      "Cannot add an item to a pw::IntrusiveDList that is already in a list");
+  item.next_ = pos;
+  item.previous_ = pos->previous_;
+  pos->previous_->next_ = &item;
+  pos->previous_ = &item;
+}
+
+void List::clear() {
+  while (!empty()) {
+    erase(*begin());
+  }
+}
+
+size_t List::size() const {
+  size_t total = 0;
+  for (const Item* item = begin(); item != end(); item = item->next_) {
+    total += 1;
+  }
+  return total;
+}
+
+}  // namespace pw::intrusive_dlist_impl
@@ -0,0 +1,294 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_dlist.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace {
+
+class TestItem : public IntrusiveDList<TestItem>::Item {
+ public:
+  TestItem() : number_(0) {}
+  TestItem(int number) : number_(number) {}
+
+  int GetNumber() const { return number_; }
+
+  // Add equality comparison to ensure comparisons are done by identity rather
+  // than equality for the remove function.
+  bool operator==(const TestItem& other) const {
+    return number_ == other.number_;
+  }
+
+ private:
+  int number_;
+};
+
+using SizedList = IntrusiveDList<TestItem, /*kCacheSize=*/true>;
+
+TEST(IntrusiveDList, Construct_InitializerList) {
+  TestItem one(1);
+  TestItem two(2);
+  TestItem thr(3);
+
+  IntrusiveDList<TestItem> list({&one, &two, &thr});
+  auto it = list.begin();
+  EXPECT_EQ(&one, &(*it++));
+  EXPECT_EQ(&two, &(*it++));
+  EXPECT_EQ(&thr, &(*it++));
+  EXPECT_EQ(list.end(), it);
+}
+
+TEST(IntrusiveDList, Construct_ObjectIterator) {
+  std::array<TestItem, 3> array{{{1}, {2}, {3}}};
+  IntrusiveDList<TestItem> list(array.begin(), array.end());
+
+  auto it = list.begin();
+  EXPECT_EQ(&array[0], &(*it++));
+  EXPECT_EQ(&array[1], &(*it++));
+  EXPECT_EQ(&array[2], &(*it++));
+  EXPECT_EQ(list.end(), it);
+}
+
+TEST(IntrusiveDList, Assign_ReplacesPriorContents) {
+  TestItem one(1);
+  TestItem two(2);
+  SizedList list({&one});
+
+  list.assign({&two});
+  EXPECT_EQ(&two, &list.front());
+  EXPECT_EQ(1u, list.size());
+}
+
+TEST(IntrusiveDList, PushBackAndFront) {
+  TestItem one(1);
+  TestItem two(2);
+  TestItem thr(3);
+  IntrusiveDList<TestItem> list;
+  EXPECT_TRUE(list.empty());
+
+  list.push_back(two);
+  list.push_back(thr);
+  list.push_front(one);
+  EXPECT_FALSE(list.empty());
+
+  EXPECT_EQ(&one, &list.front());
+  EXPECT_EQ(&thr, &list.back());
+  EXPECT_EQ(3u, list.size());
+}
+
+TEST(IntrusiveDList, Insert) {
+  TestItem one(1);
+  TestItem two(2);
+  TestItem thr(3);
+  IntrusiveDList<TestItem> list({&one, &thr});
+
+  auto it = list.insert(std::next(list.begin()), two);
+  EXPECT_EQ(&two, &(*it));
+
+  int expected = 1;
+  for (const TestItem& item : list) {
+    EXPECT_EQ(expected++, item.GetNumber());
+  }
+  EXPECT_EQ(4, expected);
+}
+
+TEST(IntrusiveDList, Insert_AtEnd) {
+  TestItem one(1);
+  TestItem two(2);
+  IntrusiveDList<TestItem> list({&one});
+
+  list.insert(list.end(), two);
+  EXPECT_EQ(&two, &list.back());
+}
+
+TEST(IntrusiveDList, PopFrontAndBack) {
+  TestItem one(1);
+  TestItem two(2);
+  TestItem thr(3);
+  SizedList list({&one, &two, &thr});
+
+  list.pop_front();
+  EXPECT_EQ(&two, &list.front());
+  list.pop_back();
+  EXPECT_EQ(&two, &list.back());
+  EXPECT_EQ(1u, list.size());
+
+  list.pop_back();
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ(0u, list.size());
+
+  // Popped items can be inserted again.
+  list.push_back(one);
+  EXPECT_EQ(&one, &list.front());
+}
+
+TEST(IntrusiveDList, Erase) {
+  TestItem one(1);
+  TestItem two(2);
+  TestItem thr(3);
+  SizedList list({&one, &two, &thr});
+
+  auto it = list.erase(std::next(list.begin()));
+  EXPECT_EQ(&thr, &(*it));
+  EXPECT_EQ(2u, list.size());
+
+  it = list.erase(it);
+  EXPECT_EQ(list.end(), it);
+  EXPECT_EQ(&one, &list.back());
+}
+
+TEST(IntrusiveDList, Remove) {
+  TestItem one(1);
+  TestItem two(2);
+  TestItem thr(3);
+  SizedList list({&one, &two, &thr});
+
+  EXPECT_TRUE(list.remove(two));
+  EXPECT_EQ(2u, list.size());
+  EXPECT_EQ(&one, &list.front());
+  EXPECT_EQ(&thr, &list.back());
+
+  // The item is not in the list anymore, so this does nothing.
+  EXPECT_FALSE(list.remove(two));
+  EXPECT_EQ(2u, list.size());
+
+  EXPECT_TRUE(list.remove(thr));
+  EXPECT_TRUE(list.remove(one));
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ(0u, list.size());
+}
+
+TEST(IntrusiveDList, Remove_ComparesByIdentity) {
+  TestItem item_1(1);
+  TestItem item_1_copy(1);
+  IntrusiveDList<TestItem> list({&item_1});
+
+  EXPECT_FALSE(list.remove(item_1_copy));
+  EXPECT_EQ(&item_1, &list.front());
+}
+
+TEST(IntrusiveDList, Remove_ConstItem) {
+  TestItem one(1);
+  const TestItem& const_one = one;
+  IntrusiveDList<TestItem> list({&one});
+
+  EXPECT_TRUE(list.remove(const_one));
+  EXPECT_TRUE(list.empty());
+}
+
+TEST(IntrusiveDList, Clear) {
+  TestItem one(1);
+  TestItem two(2);
+  SizedList list({&one, &two});
+
+  list.clear();
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ(0u, list.size());
+
+  // Cleared items can be added to a list again.
+  list.push_back(two);
+  list.push_back(one);
+  EXPECT_EQ(&two, &list.front());
+}
+
+TEST(IntrusiveDList, ReverseIteration) {
+  std::array<TestItem, 3> array{{{1}, {2}, {3}}};
+  IntrusiveDList<TestItem> list(array.begin(), array.end());
+
+  int expected = 3;
+  for (auto it = list.rbegin(); it != list.rend(); ++it) {
+    EXPECT_EQ(expected--, it->GetNumber());
+  }
+  EXPECT_EQ(0, expected);
+}
+
+TEST(IntrusiveDList, IteratorDecrement) {
+  TestItem one(1);
+  TestItem two(2);
+  IntrusiveDList<TestItem> list({&one, &two});
+
+  auto it = list.end();
+  EXPECT_EQ(&two, &(*--it));
+  EXPECT_EQ(&two, &(*it--));
+  EXPECT_EQ(&one, &(*it));
+  EXPECT_EQ(list.begin(), it);
+}
+
+TEST(IntrusiveDList, ConstIterator) {
+  TestItem one(1);
+  TestItem two(2);
+  IntrusiveDList<TestItem> list({&one, &two});
+  const IntrusiveDList<TestItem>& const_list = list;
+
+  IntrusiveDList<TestItem>::const_iterator it = list.begin();
+  EXPECT_EQ(it, const_list.begin());
+  EXPECT_EQ(1, it->GetNumber());
+  EXPECT_EQ(2, const_list.back().GetNumber());
+}
+
+TEST(IntrusiveDList, ItemsRemoveThemselvesFromListsWhenDestructed) {
+  TestItem one(1);
+  IntrusiveDList<TestItem> list({&one});
+  {
+    TestItem two(2);
+    TestItem thr(3);
+    list.push_back(two);
+    list.push_back(thr);
+    EXPECT_EQ(3u, list.size());
+  }
+  EXPECT_EQ(1u, list.size());
+  EXPECT_EQ(&one, &list.front());
+  EXPECT_EQ(&one, &list.back());
+}
+
+TEST(IntrusiveDList, SameItemsInSizedAndUnsizedLists) {
+  TestItem one(1);
+  TestItem two(2);
+  {
+    SizedList sized({&one, &two});
+    EXPECT_EQ(2u, sized.size());
+    sized.clear();
+  }
+
+  IntrusiveDList<TestItem> unsized({&two, &one});
+  EXPECT_EQ(2u, unsized.size());
+  EXPECT_EQ(&two, &unsized.front());
+}
+
+TEST(IntrusiveDList, CachedSizeTakesOneWord) {
+  static_assert(sizeof(SizedList) ==
+                sizeof(IntrusiveDList<TestItem>) + sizeof(size_t));
+  static_assert(sizeof(IntrusiveDList<TestItem>) == 2 * sizeof(void*));
+}
+
+class BaseItem : public IntrusiveDList<BaseItem>::Item {};
+class DerivedItem : public BaseItem {};
+
+TEST(IntrusiveDList, ListOfDerivedClassItems) {
+  DerivedItem item;
+  IntrusiveDList<BaseItem> list;
+  list.push_back(item);
+  EXPECT_EQ(static_cast<BaseItem*>(&item), &list.front());
+  EXPECT_TRUE(list.remove(item));
+}
+
+}  // namespace
+}  // namespace pw
@@ -20,6 +20,85 @@
 #include <type_traits>
 
 namespace pw::containers {
+namespace internal {
+
+// Sorts a short range by key with a stable insertion sort.
+template <typename T>
+constexpr void InsertionSortByKey(T* data, size_t size) {
+  for (size_t i = 1; i < size; ++i) {
+    if (data[i].first < data[i - 1].first) {
+      // Rotate the value into place.
+      T temp = std::move(data[i]);
+      size_t j = i;
+      do {
+        data[j] = std::move(data[j - 1]);
+        --j;
+      } while (j > 0 && temp.first < data[j - 1].first);
+      data[j] = std::move(temp);
+    }
+  }
+}
+
+// Sorts an array by key with a stable O(n log n) merge sort that works in
+// constant expressions, unlike std::stable_sort. Short runs are insertion
+// sorted, then merged bottom-up through a second array. The second array is
+// a copy of the input, so elements need not be default constructible.
+template <typename T, size_t kSize>
+constexpr void StableSortByKey(std::array<T, kSize>& items) {
+  constexpr size_t kRunLength = 16;
+
+  bool sorted = true;
+  for (size_t i = 1; i < kSize && sorted; ++i) {
+    sorted = !(items[i].first < items[i - 1].first);
+  }
+  if (sorted) {
+    return;
+  }
+
+  for (size_t start = 0; start < kSize; start += kRunLength) {
+    InsertionSortByKey(&items[start], std::min(kRunLength, kSize - start));
+  }
+  if (kSize <= kRunLength) {
+    return;
+  }
+
+  std::array<T, kSize> buffer = items;
+  std::array<T, kSize>* from = &items;
+  std::array<T, kSize>* to = &buffer;
+
+  for (size_t width = kRunLength; width < kSize; width *= 2) {
+    for (size_t left = 0; left < kSize; left += 2 * width) {
+      const size_t middle = std::min(left + width, kSize);
+      const size_t right = std::min(left + 2 * width, kSize);
+
+      // Merge [left, middle) and [middle, right), preferring the left run on
+      // ties to keep the sort stable.
+      size_t i = left;
+      size_t j = middle;
+      for (size_t out = left; out < right; ++out) {
+        const bool take_left =
+            i < middle &&
+            (j == right || !((*from)[j].first < (*from)[i].first));
+        if (take_left) {
+          (*to)[out] = std::move((*from)[i++]);
+        } else {
+          (*to)[out] = std::move((*from)[j++]);
+        }
+      }
+    }
+    std::array<T, kSize>* const merged = to;
+    to = from;
+    from = merged;
+  }
+
+  if (from != &items) {
+    for (size_t i = 0; i < kSize; ++i) {
+      items[i] = std::move((*from)[i]);
+    }
+  }
+}
+
+}  // namespace internal
 
 // A simple, fixed-size associative array with lookup by key or value.
 //
@@ -27,7 +106,9 @@ namespace pw::containers {
 //   FlatMap<int, int> map({{{1, 2}, {3, 4}}});
 //
 // The keys do not need to be sorted as the constructor will sort the items
-// if need be.
+// if need be. The sort is O(n log n), and O(n) for items that are already
+// sorted. Use FromSorted() to skip it entirely for items known to be sorted,
+// such as generated tables.
 template <typename Key, typename Value, size_t kArraySize>
 class FlatMap {
  public:
@@ -51,7 +132,17 @@ class FlatMap {
 
   constexpr FlatMap(const std::array<value_type, kArraySize>& items)
       : items_(items) {
-    ConstexprSort(items_.data(), kArraySize);
+    internal::StableSortByKey(items_);
+  }
+
+  // Creates a FlatMap from items that are already sorted by key, without
+  // checking or sorting them.
+  //
+  // Precondition: The items are sorted by key. Lookups in a FlatMap created
+  // from unsorted items return incorrect results.
+  static constexpr FlatMap FromSorted(
+      const std::array<value_type, kArraySize>& items) {
+    return FlatMap(items, kSorted);
   }
 
   FlatMap(FlatMap&) = delete;
@@ -106,28 +197,93 @@ class FlatMap {
   constexpr const_iterator cend() const { return items_.cend(); }
 
  private:
-  // Simple stable insertion sort function for constexpr support.
-  // std::stable_sort is not constexpr. Should not be a problem with performance
-  // in regards to the sizes that are typically dealt with.
-  static constexpr void ConstexprSort(iterator data, size_type size) {
-    if (size < 2) {
-      return;
+  enum SortedTag { kSorted };
+
+  constexpr FlatMap(const std::array<value_type, kArraySize>& items, SortedTag)
+      : items_(items) {}
+
+  std::array<value_type, kArraySize> items_;
+};
+
+// A fixed-size associative array like FlatMap, with the items stored in
+// Eytzinger (breadth-first binary tree) order rather than sorted order.
+//
+// Lookups descend the implicit tree without branching on the comparison, and
+// the first levels of the tree share a few cache lines that stay hot across
+// lookups. On large maps this is typically faster than FlatMap's binary search;
+// on small maps there is little difference. The map is constructed from the
+// same items as a FlatMap, sorted or not.
+//
+// Only lookup by key is supported. Iteration visits the items in tree order,
+// not key order. If several items have the same key, find() returns the first
+// of them in the order a stable sort would produce.
+template <typename Key, typename Value, size_t kArraySize>
+class EytzingerFlatMap {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = typename FlatMap<Key, Value, kArraySize>::value_type;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using container_type = typename std::array<value_type, kArraySize>;
+  using const_iterator = typename container_type::const_iterator;
+
+  constexpr EytzingerFlatMap(const std::array<value_type, kArraySize>& items)
+      : items_(items) {
+    std::array<value_type, kArraySize> sorted = items;
+    internal::StableSortByKey(sorted);
+    size_t next = 0;
+    Place(sorted, next, 1);
+  }
+
+  EytzingerFlatMap(EytzingerFlatMap&) = delete;
+  EytzingerFlatMap& operator=(EytzingerFlatMap&) = delete;
+
+  // Capacity.
+  constexpr size_type size() const { return kArraySize; }
+  constexpr size_type empty() const { return size() == 0; }
+  constexpr size_type max_size() const { return kArraySize; }
+
+  // Lookup.
+  constexpr bool contains(const key_type& key) const {
+    return find(key) != end();
+  }
+
+  constexpr const_iterator find(const key_type& key) const {
+    // Tree nodes are numbered from 1; node k's children are 2k and 2k + 1.
+    size_t node = 1;
+    while (node <= kArraySize) {
+      node = 2 * node + static_cast<size_t>(items_[node - 1].first < key);
     }
 
-    for (iterator it = data + 1, end = data + size; it < end; ++it) {
-      if (it->first < it[-1].first) {
-        // Rotate the value into place.
-        value_type temp = std::move(*it);
-        iterator it2 = it - 1;
-        while (true) {
-          *(it2 + 1) = std::move(*it2);
-          if (it2 == data || !(temp.first < it2[-1].first)) {
-            break;
-          }
-          --it2;
-        }
-        *it2 = std::move(temp);
-      }
+    // The last node at which the search went left holds the lower bound.
+    // Going right appends a 1 bit, so strip the trailing 1s and the final 0.
+    while ((node & 1u) != 0u) {
+      node >>= 1;
+    }
+    node >>= 1;
+
+    if (node == 0u || key < items_[node - 1].first) {
+      return end();
+    }
+    return begin() + static_cast<difference_type>(node - 1);
+  }
+
+  // Iterators, in tree order.
+  constexpr const_iterator begin() const { return cbegin(); }
+  constexpr const_iterator cbegin() const { return items_.cbegin(); }
+  constexpr const_iterator end() const { return cend(); }
+  constexpr const_iterator cend() const { return items_.cend(); }
+
+ private:
+  // Places the sorted items into the tree with an in-order traversal.
+  constexpr void Place(const std::array<value_type, kArraySize>& sorted,
+                       size_t& next,
+                       size_t node) {
+    if (node <= kArraySize) {
+      Place(sorted, next, 2 * node);
+      items_[node - 1] = sorted[next++];
+      Place(sorted, next, 2 * node + 1);
     }
   }
 
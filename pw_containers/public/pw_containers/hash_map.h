@@ -0,0 +1,362 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "pw_assert/assert.h"
+
+namespace pw::containers {
+
+// A fixed-capacity hash map that never allocates. Entries are stored in place
+// in an array of kCapacity slots, which must be a power of two.
+//
+// Collisions are resolved with Robin Hood linear probing: an entry may take
+// the slot of an entry that is closer to its home slot, which keeps every
+// entry within a short, predictable distance of where its hash places it.
+// Each slot has a separate metadata word holding the entry's probe distance,
+// so a lookup scans the small, contiguous metadata array and only compares
+// the keys of entries whose distance matches. Erasing shifts the following
+// entries back instead of leaving tombstones, so lookups do not slow down as
+// entries come and go.
+//
+// The map may be filled to capacity, though probe sequences grow quickly once
+// it is more than about 80% full. Inserting into a full map fails. Inserting
+// or erasing an entry may move other entries, which invalidates iterators,
+// pointers, and references.
+template <typename Key,
+          typename Value,
+          size_t kCapacity,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class HashMap {
+ private:
+  template <bool kIsConst>
+  class Iterator;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  static_assert(kCapacity > 0u && (kCapacity & (kCapacity - 1)) == 0u,
+                "The capacity of a HashMap must be a power of two");
+  static_assert(kCapacity <= 32768u, "HashMaps are limited to 32768 entries");
+
+  HashMap() : metadata_{}, size_(0) {}
+
+  HashMap(const HashMap&) = delete;
+  HashMap& operator=(const HashMap&) = delete;
+
+  ~HashMap() { clear(); }
+
+  // Iterators. Entries are visited in slot order, not insertion order.
+  iterator begin() { return iterator(this, FirstOccupied(0)); }
+  const_iterator begin() const { return cbegin(); }
+  const_iterator cbegin() const {
+    return const_iterator(this, FirstOccupied(0));
+  }
+
+  iterator end() { return iterator(this, kCapacity); }
+  const_iterator end() const { return cend(); }
+  const_iterator cend() const { return const_iterator(this, kCapacity); }
+
+  // Capacity.
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0u; }
+  bool full() const { return size_ == kCapacity; }
+  static constexpr size_type max_size() { return kCapacity; }
+
+  // Lookup.
+  iterator find(const key_type& key) { return iterator(this, Find(key)); }
+  const_iterator find(const key_type& key) const {
+    return const_iterator(this, Find(key));
+  }
+
+  bool contains(const key_type& key) const { return Find(key) != kCapacity; }
+
+  size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+  // Returns the value for the key, inserting a value-initialized one if the
+  // key is not present. Crashes if the key must be inserted and the map is
+  // full.
+  mapped_type& operator[](const key_type& key) {
+    const std::pair<iterator, bool> result = emplace(key);
+    PW_ASSERT(result.first != end());
+    return result.first->second;
+  }
+
+  // Modifiers.
+
+  // Inserts an entry constructed from the arguments if the key is not already
+  // present. Returns an iterator to the entry with the key and whether it was
+  // inserted. If the key is not present and the map is full, returns end() and
+  // false.
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(const key_type& key, Args&&... args) {
+    size_type index = HomeSlot(key);
+    Metadata distance = 1;
+
+    // Stop at the key, or at the first slot that is empty or held by an entry
+    // closer to its home slot than this key would be.
+    while (metadata_[index] >= distance) {
+      if (metadata_[index] == distance &&
+          key_equal()(entry(index).first, key)) {
+        return {iterator(this, index), false};
+      }
+      index = Next(index);
+      distance += 1;
+    }
+
+    if (full()) {
+      return {end(), false};
+    }
+
+    // Make room by moving the run of entries that starts here forward one
+    // slot, up to the next empty slot. Each of them moves one slot further
+    // from its home slot.
+    size_type empty_slot = index;
+    while (metadata_[empty_slot] != 0u) {
+      empty_slot = Next(empty_slot);
+    }
+    while (empty_slot != index) {
+      const size_type previous = Previous(empty_slot);
+      Move(previous, empty_slot);
+      metadata_[empty_slot] = static_cast<Metadata>(metadata_[previous] + 1);
+      empty_slot = previous;
+    }
+
+    new (&storage_[index])
+        value_type(std::piecewise_construct,
+                   std::forward_as_tuple(key),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+    metadata_[index] = distance;
+    size_ += 1;
+    return {iterator(this, index), true};
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return emplace(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return emplace(value.first, std::move(value.second));
+  }
+
+  // Removes the entry with the key, if present. Returns the number of entries
+  // removed.
+  size_type erase(const key_type& key) {
+    size_type index = Find(key);
+    if (index == kCapacity) {
+      return 0;
+    }
+
+    entry(index).~value_type();
+
+    // Shift the following entries that are not in their home slots back by
+    // one, so that no lookup passes through an empty slot.
+    for (size_type next = Next(index); metadata_[next] > 1u;
+         next = Next(next)) {
+      Move(next, index);
+      metadata_[index] = static_cast<Metadata>(metadata_[next] - 1);
+      index = next;
+    }
+
+    metadata_[index] = 0;
+    size_ -= 1;
+    return 1;
+  }
+
+  void clear() {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      for (size_type i = 0; i < kCapacity; ++i) {
+        if (metadata_[i] != 0u) {
+          entry(i).~value_type();
+        }
+      }
+    }
+    metadata_.fill(0);
+    size_ = 0;
+  }
+
+ private:
+  // An entry's distance from its home slot plus one, or 0 for an empty slot.
+  // Distances never exceed the capacity.
+  using Metadata = std::conditional_t<(kCapacity < 255u), uint8_t, uint16_t>;
+
+  static constexpr size_type kMask = kCapacity - 1;
+
+  static constexpr unsigned Log2(size_type value) {
+    unsigned bits = 0;
+    while (value > 1u) {
+      value >>= 1;
+      bits += 1;
+    }
+    return bits;
+  }
+
+  static constexpr unsigned kSlotBits = Log2(kCapacity);
+
+  // Chooses the home slot from the upper bits of the hash multiplied by the
+  // golden ratio, since std::hash for integers is often the identity and the
+  // low bits alone would cluster sequential keys.
+  static size_type HomeSlot(const key_type& key) {
+    if constexpr (kSlotBits == 0u) {
+      static_cast<void>(key);
+      return 0;
+    } else {
+      const uint32_t hash =
+          static_cast<uint32_t>(hasher()(key)) * UINT32_C(0x9E3779B9);
+      return hash >> (32u - kSlotBits);
+    }
+  }
+
+  static constexpr size_type Next(size_type index) {
+    return (index + 1) & kMask;
+  }
+
+  static constexpr size_type Previous(size_type index) {
+    return (index - 1) & kMask;
+  }
+
+  // Returns the slot of the key, or kCapacity if it is not present.
+  size_type Find(const key_type& key) const {
+    size_type index = HomeSlot(key);
+    for (Metadata distance = 1; metadata_[index] >= distance; ++distance) {
+      if (metadata_[index] == distance &&
+          key_equal()(entry(index).first, key)) {
+        return index;
+      }
+      index = Next(index);
+    }
+    return kCapacity;
+  }
+
+  size_type FirstOccupied(size_type index) const {
+    while (index < kCapacity && metadata_[index] == 0u) {
+      index += 1;
+    }
+    return index;
+  }
+
+  // Moves the entry in one slot to an empty slot. The metadata is not changed.
+  void Move(size_type from, size_type to) {
+    new (&storage_[to]) value_type(std::move(entry(from)));
+    entry(from).~value_type();
+  }
+
+#ifdef __cpp_lib_launder
+  value_type& entry(size_type index) {
+    return *std::launder(reinterpret_cast<value_type*>(&storage_[index]));
+  }
+  const value_type& entry(size_type index) const {
+    return *std::launder(
+        reinterpret_cast<const value_type*>(&storage_[index]));
+  }
+#else
+  value_type& entry(size_type index) {
+    return *reinterpret_cast<value_type*>(&storage_[index]);
+  }
+  const value_type& entry(size_type index) const {
+    return *reinterpret_cast<const value_type*>(&storage_[index]);
+  }
+#endif  // __cpp_lib_launder
+
+  std::array<Metadata, kCapacity> metadata_;
+  size_type size_;
+
+  // Entries are initialized on demand with placement new.
+  std::array<std::aligned_storage_t<sizeof(value_type), alignof(value_type)>,
+             kCapacity>
+      storage_;
+};
+
+template <typename Key,
+          typename Value,
+          size_t kCapacity,
+          typename Hash,
+          typename KeyEqual>
+template <bool kIsConst>
+class HashMap<Key, Value, kCapacity, Hash, KeyEqual>::Iterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename HashMap::value_type;
+  using difference_type = ptrdiff_t;
+  using pointer = std::conditional_t<kIsConst, const value_type*, value_type*>;
+  using reference =
+      std::conditional_t<kIsConst, const value_type&, value_type&>;
+
+  constexpr Iterator() : map_(nullptr), index_(0) {}
+
+  // Allows converting an iterator to a const_iterator.
+  template <bool kOtherIsConst,
+            typename = std::enable_if_t<kIsConst && !kOtherIsConst>>
+  constexpr Iterator(const Iterator<kOtherIsConst>& other)
+      : map_(other.map_), index_(other.index_) {}
+
+  reference operator*() const { return map_->entry(index_); }
+  pointer operator->() const { return &map_->entry(index_); }
+
+  Iterator& operator++() {
+    index_ = map_->FirstOccupied(index_ + 1);
+    return *this;
+  }
+
+  Iterator operator++(int) {
+    Iterator original = *this;
+    operator++();
+    return original;
+  }
+
+  constexpr bool operator==(const Iterator& other) const {
+    return index_ == other.index_;
+  }
+
+  constexpr bool operator!=(const Iterator& other) const {
+    return index_ != other.index_;
+  }
+
+ private:
+  friend class HashMap;
+
+  template <bool>
+  friend class Iterator;
+
+  using Map = std::conditional_t<kIsConst, const HashMap, HashMap>;
+
+  constexpr Iterator(Map* map, size_type index) : map_(map), index_(index) {}
+
+  Map* map_;
+  size_type index_;
+};
+
+}  // namespace pw::containers
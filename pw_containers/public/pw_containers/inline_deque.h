@@ -0,0 +1,515 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "pw_assert/assert.h"
+#include "pw_polyfill/language_feature_macros.h"
+
+namespace pw {
+namespace inline_deque_impl {
+
+// Used as the capacity in the generic-size InlineDeque<T> interface.
+PW_INLINE_VARIABLE constexpr size_t kGeneric = size_t(-1);
+
+// Makes InlineDeque<T> trivially destructible if T is, as for pw::Vector.
+template <typename DequeClass, bool kIsTriviallyDestructible>
+class DestructorHelper;
+
+template <typename DequeClass>
+class DestructorHelper<DequeClass, true> {
+ public:
+  ~DestructorHelper() = default;
+};
+
+template <typename DequeClass>
+class DestructorHelper<DequeClass, false> {
+ public:
+  ~DestructorHelper() { static_cast<DequeClass*>(this)->clear(); }
+};
+
+}  // namespace inline_deque_impl
+
+// A double-ended queue backed by a fixed-size ring buffer. Elements are
+// pushed and popped at either end in constant time without moving the other
+// elements.
+//
+// As with pw::Vector, deques are declared with their capacity
+// (InlineDeque<int, 10>) but can be used without it (InlineDeque<int>&), so
+// functions that take a deque are shared across all capacities.
+//
+// Pushing to a full deque or popping from an empty one crashes. The batch
+// operations, push_back(std::span) and pop_front(count), instead transfer as
+// many elements as they can.
+//
+// The elements occupy at most two contiguous segments of the ring buffer.
+// front_segment() exposes the first one, so elements can be copied out in
+// bulk and then removed with pop_front(count). For trivially copyable types,
+// free_segment() and commit_back() allow writing elements in bulk as well.
+template <typename T, size_t kCapacity = inline_deque_impl::kGeneric>
+class InlineDeque : public InlineDeque<T, inline_deque_impl::kGeneric> {
+ private:
+  using Base = InlineDeque<T, inline_deque_impl::kGeneric>;
+
+ public:
+  using typename Base::const_iterator;
+  using typename Base::const_pointer;
+  using typename Base::const_reference;
+  using typename Base::difference_type;
+  using typename Base::iterator;
+  using typename Base::pointer;
+  using typename Base::reference;
+  using typename Base::size_type;
+  using typename Base::value_type;
+
+  InlineDeque() noexcept : Base(kCapacity) {}
+
+  InlineDeque(const InlineDeque& other) : Base(kCapacity) { *this = other; }
+
+  template <size_t kOtherCapacity>
+  InlineDeque(const InlineDeque<T, kOtherCapacity>& other) : Base(kCapacity) {
+    *this = other;
+  }
+
+  InlineDeque(InlineDeque&& other) noexcept : Base(kCapacity) {
+    *this = std::move(other);
+  }
+
+  template <size_t kOtherCapacity>
+  InlineDeque(InlineDeque<T, kOtherCapacity>&& other) noexcept
+      : Base(kCapacity) {
+    *this = std::move(other);
+  }
+
+  InlineDeque& operator=(const InlineDeque& other) {
+    Base::operator=(other);
+    return *this;
+  }
+
+  template <size_t kOtherCapacity>
+  InlineDeque& operator=(const InlineDeque<T, kOtherCapacity>& other) {
+    Base::operator=(other);
+    return *this;
+  }
+
+  InlineDeque& operator=(InlineDeque&& other) noexcept {
+    Base::operator=(std::move(other));
+    return *this;
+  }
+
+  template <size_t kOtherCapacity>
+  InlineDeque& operator=(InlineDeque<T, kOtherCapacity>&& other) noexcept {
+    Base::operator=(std::move(other));
+    return *this;
+  }
+
+  // All other deque methods are implemented on the InlineDeque<T> base class.
+
+ private:
+  friend class InlineDeque<T, inline_deque_impl::kGeneric>;
+
+  static_assert(kCapacity <= std::numeric_limits<size_type>::max());
+
+  // Provides access to the underlying array as an array of T.
+#ifdef __cpp_lib_launder
+  pointer array() { return std::launder(reinterpret_cast<T*>(&array_)); }
+  const_pointer array() const {
+    return std::launder(reinterpret_cast<const T*>(&array_));
+  }
+#else
+  pointer array() { return reinterpret_cast<T*>(&array_); }
+  const_pointer array() const { return reinterpret_cast<const T*>(&array_); }
+#endif  // __cpp_lib_launder
+
+  // Elements are stored as uninitialized memory blocks aligned correctly for
+  // the type and initialized on demand with placement new. As in pw::Vector,
+  // the alignas specifier keeps zero-capacity deques aligned the same as
+  // others.
+  alignas(T) std::array<std::aligned_storage_t<sizeof(T), alignof(T)>,
+                        kCapacity> array_;
+};
+
+// Defines the generic-sized InlineDeque<T> specialization, which serves as the
+// base class for InlineDeque<T> of any capacity. Except for constructors, all
+// InlineDeque methods are implemented on this class.
+template <typename T>
+class InlineDeque<T, inline_deque_impl::kGeneric>
+    : public inline_deque_impl::DestructorHelper<
+          InlineDeque<T, inline_deque_impl::kGeneric>,
+          std::is_trivially_destructible<T>::value> {
+ private:
+  template <bool kIsConst>
+  class Iterator;
+
+ public:
+  using value_type = T;
+
+  // As in pw::Vector, 65535 entries is a reasonable upper limit for a
+  // statically allocated container.
+  using size_type = unsigned short;
+
+  using difference_type = ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  // A deque without an explicit capacity (InlineDeque<T>) cannot be
+  // constructed directly. Instead, construct an InlineDeque<T, kCapacity>.
+
+  // Assign
+
+  InlineDeque& operator=(const InlineDeque& other) {
+    if (&other != this) {
+      clear();
+      for (const T& value : other) {
+        push_back(value);
+      }
+    }
+    return *this;
+  }
+
+  InlineDeque& operator=(InlineDeque&& other) noexcept {
+    if (&other != this) {
+      clear();
+      for (T& value : other) {
+        push_back(std::move(value));
+      }
+      other.clear();
+    }
+    return *this;
+  }
+
+  // Access
+
+  reference at(size_type index) {
+    PW_ASSERT(index < size());
+    return (*this)[index];
+  }
+  const_reference at(size_type index) const {
+    PW_ASSERT(index < size());
+    return (*this)[index];
+  }
+
+  reference operator[](size_type index) { return data()[Physical(index)]; }
+  const_reference operator[](size_type index) const {
+    return data()[Physical(index)];
+  }
+
+  reference front() { return data()[head_]; }
+  const_reference front() const { return data()[head_]; }
+
+  reference back() { return (*this)[size_ - 1]; }
+  const_reference back() const { return (*this)[size_ - 1]; }
+
+  // Iterate
+
+  iterator begin() noexcept { return iterator(this, 0); }
+  const_iterator begin() const noexcept { return cbegin(); }
+  const_iterator cbegin() const noexcept { return const_iterator(this, 0); }
+
+  iterator end() noexcept { return iterator(this, size_); }
+  const_iterator end() const noexcept { return cend(); }
+  const_iterator cend() const noexcept { return const_iterator(this, size_); }
+
+  // Capacity
+
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0u; }
+
+  // True if there is no free space in the deque.
+  bool full() const noexcept { return size_ == capacity_; }
+
+  size_type size() const noexcept { return size_; }
+
+  size_type max_size() const noexcept { return capacity(); }
+
+  size_type capacity() const noexcept { return capacity_; }
+
+  // Modify
+
+  void clear() noexcept;
+
+  void push_back(const T& value) { emplace_back(value); }
+
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  // Copies as many of the values to the back of the deque as fit. Returns the
+  // number of values copied.
+  size_type push_back(std::span<const T> values);
+
+  void push_front(const T& value) { emplace_front(value); }
+
+  void push_front(T&& value) { emplace_front(std::move(value)); }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args);
+
+  template <typename... Args>
+  void emplace_front(Args&&... args);
+
+  void pop_back();
+
+  void pop_front();
+
+  // Removes up to count elements from the front of the deque. Returns the
+  // number of elements removed.
+  size_type pop_front(size_type count);
+
+  // Bulk access
+
+  // Returns the elements at the front of the deque that are contiguous in
+  // memory. This is every element unless the elements wrap around the end of
+  // the ring buffer.
+  std::span<T> front_segment() noexcept {
+    return std::span(&data()[head_], FrontSegmentSize());
+  }
+  std::span<const T> front_segment() const noexcept {
+    return std::span(&data()[head_], FrontSegmentSize());
+  }
+
+  // Returns the contiguous free space after the back of the deque. Values
+  // written to it are added to the deque by commit_back(). An empty deque
+  // starts over at the beginning of its buffer, so all of its free space is
+  // contiguous. Only available for trivially copyable types.
+  std::span<T> free_segment() noexcept {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "free_segment() requires a trivially copyable type");
+    const size_t tail = Physical(size_);
+    const size_t free = capacity_ - size_;
+    return std::span(&data()[tail],
+                     empty() || tail >= head_
+                         ? std::min(free, capacity_ - tail)
+                         : free);
+  }
+
+  // Adds count values written to free_segment() to the back of the deque.
+  //
+  // Precondition: count is no larger than free_segment().size().
+  void commit_back(size_type count) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "commit_back() requires a trivially copyable type");
+    PW_ASSERT(count <= free_segment().size());
+    size_ = static_cast<size_type>(size_ + count);
+  }
+
+ protected:
+  explicit constexpr InlineDeque(size_type capacity) noexcept
+      : capacity_(capacity), head_(0), size_(0) {}
+
+  // InlineDeque<T> may not be used with unique_ptr or delete. delete could be
+  // supported by making ~InlineDeque() virtual, but this would add unnecessary
+  // overhead.
+  ~InlineDeque() = default;
+
+ private:
+  T* data() noexcept {
+    return static_cast<InlineDeque<T, 0>*>(this)->array();
+  }
+  const T* data() const noexcept {
+    return static_cast<const InlineDeque<T, 0>*>(this)->array();
+  }
+
+  // Converts an index relative to the front into an index into the array.
+  size_t Physical(size_t index) const {
+    const size_t offset = head_ + index;
+    // Note: branch is faster than mod (%) on common embedded architectures.
+    return offset < capacity_ ? offset : offset - capacity_;
+  }
+
+  size_t FrontSegmentSize() const {
+    return std::min<size_t>(size_, capacity_ - head_);
+  }
+
+  const size_type capacity_;
+  size_type head_;
+  size_type size_;
+};
+
+template <typename T>
+template <bool kIsConst>
+class InlineDeque<T, inline_deque_impl::kGeneric>::Iterator {
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = T;
+  using difference_type = ptrdiff_t;
+  using pointer = std::conditional_t<kIsConst, const T*, T*>;
+  using reference = std::conditional_t<kIsConst, const T&, T&>;
+
+  constexpr Iterator() : deque_(nullptr), index_(0) {}
+
+  // Allows converting an iterator to a const_iterator.
+  template <bool kOtherIsConst,
+            typename = std::enable_if_t<kIsConst && !kOtherIsConst>>
+  constexpr Iterator(const Iterator<kOtherIsConst>& other)
+      : deque_(other.deque_), index_(other.index_) {}
+
+  reference operator*() const { return (*deque_)[index_]; }
+  pointer operator->() const { return &(*deque_)[index_]; }
+
+  Iterator& operator++() {
+    index_ += 1;
+    return *this;
+  }
+
+  Iterator operator++(int) {
+    Iterator original = *this;
+    operator++();
+    return original;
+  }
+
+  Iterator& operator--() {
+    index_ -= 1;
+    return *this;
+  }
+
+  Iterator operator--(int) {
+    Iterator original = *this;
+    operator--();
+    return original;
+  }
+
+  constexpr bool operator==(const Iterator& other) const {
+    return index_ == other.index_;
+  }
+
+  constexpr bool operator!=(const Iterator& other) const {
+    return index_ != other.index_;
+  }
+
+ private:
+  friend class InlineDeque;
+
+  template <bool>
+  friend class Iterator;
+
+  using Deque = std::conditional_t<kIsConst, const InlineDeque, InlineDeque>;
+
+  constexpr Iterator(Deque* deque, size_type index)
+      : deque_(deque), index_(index) {}
+
+  Deque* deque_;
+  size_type index_;
+};
+
+// Compare
+
+template <typename T, size_t kLhsCapacity, size_t kRhsCapacity>
+bool operator==(const InlineDeque<T, kLhsCapacity>& lhs,
+                const InlineDeque<T, kRhsCapacity>& rhs) {
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, size_t kLhsCapacity, size_t kRhsCapacity>
+bool operator!=(const InlineDeque<T, kLhsCapacity>& lhs,
+                const InlineDeque<T, kRhsCapacity>& rhs) {
+  return !(lhs == rhs);
+}
+
+// Function implementations
+
+template <typename T>
+void InlineDeque<T, inline_deque_impl::kGeneric>::clear() noexcept {
+  if constexpr (!std::is_trivially_destructible_v<T>) {
+    for (T& value : *this) {
+      value.~T();
+    }
+  }
+  head_ = 0;
+  size_ = 0;
+}
+
+template <typename T>
+typename InlineDeque<T, inline_deque_impl::kGeneric>::size_type
+InlineDeque<T, inline_deque_impl::kGeneric>::push_back(
+    std::span<const T> values) {
+  const size_type count = static_cast<size_type>(
+      std::min<size_t>(values.size(), capacity_ - size_));
+  for (size_type i = 0; i < count; ++i) {
+    new (&data()[Physical(size_)]) T(values[i]);
+    size_ += 1;
+  }
+  return count;
+}
+
+template <typename T>
+template <typename... Args>
+void InlineDeque<T, inline_deque_impl::kGeneric>::emplace_back(
+    Args&&... args) {
+  PW_ASSERT(!full());
+  new (&data()[Physical(size_)]) T(std::forward<Args>(args)...);
+  size_ += 1;
+}
+
+template <typename T>
+template <typename... Args>
+void InlineDeque<T, inline_deque_impl::kGeneric>::emplace_front(
+    Args&&... args) {
+  PW_ASSERT(!full());
+  const size_type new_head =
+      static_cast<size_type>(head_ == 0u ? capacity_ - 1 : head_ - 1);
+  new (&data()[new_head]) T(std::forward<Args>(args)...);
+  head_ = new_head;
+  size_ += 1;
+}
+
+template <typename T>
+void InlineDeque<T, inline_deque_impl::kGeneric>::pop_back() {
+  PW_ASSERT(!empty());
+  back().~T();
+  size_ -= 1;
+  if (size_ == 0u) {
+    head_ = 0;
+  }
+}
+
+template <typename T>
+void InlineDeque<T, inline_deque_impl::kGeneric>::pop_front() {
+  PW_ASSERT(!empty());
+  front().~T();
+  head_ = static_cast<size_type>(Physical(1));
+  size_ -= 1;
+  if (size_ == 0u) {
+    head_ = 0;
+  }
+}
+
+template <typename T>
+typename InlineDeque<T, inline_deque_impl::kGeneric>::size_type
+InlineDeque<T, inline_deque_impl::kGeneric>::pop_front(size_type count) {
+  count = std::min(count, size_);
+  if constexpr (!std::is_trivially_destructible_v<T>) {
+    for (size_type i = 0; i < count; ++i) {
+      (*this)[i].~T();
+    }
+  }
+  head_ = static_cast<size_type>(Physical(count));
+  size_ = static_cast<size_type>(size_ - count);
+  if (size_ == 0u) {
+    head_ = 0;
+  }
+  return count;
+}
+
+}  // namespace pw
@@ -0,0 +1,165 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace pw {
+
+// A single-producer, single-consumer queue backed by a fixed-size ring buffer.
+// One thread or interrupt may push while another pops without a lock; the two
+// sides only share a pair of atomic indices, which are loaded and stored but
+// never read-modify-written, so this works on cores without atomic
+// read-modify-write instructions as well.
+//
+// Only one context may call the producer functions and only one context may
+// call the consumer functions at a time. size(), empty(), and full() may be
+// called from either side, but the result may be stale by the time it is
+// used.
+//
+// kCapacity must be a power of two.
+template <typename T, size_t kCapacity>
+class InlineSpscQueue {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  static_assert(kCapacity > 0u && (kCapacity & (kCapacity - 1)) == 0u,
+                "The capacity of an InlineSpscQueue must be a power of two");
+  static_assert(kCapacity <= (uint32_t(1) << 31),
+                "InlineSpscQueue indices are 32 bits");
+
+  constexpr InlineSpscQueue() : head_(0), tail_(0), array_{} {}
+
+  InlineSpscQueue(const InlineSpscQueue&) = delete;
+  InlineSpscQueue& operator=(const InlineSpscQueue&) = delete;
+
+  ~InlineSpscQueue() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      const uint32_t tail = tail_.load(std::memory_order_acquire);
+      for (uint32_t i = head_.load(std::memory_order_relaxed); i != tail;
+           ++i) {
+        slot(i).~T();
+      }
+    }
+  }
+
+  // Producer
+
+  bool try_push(const T& value) { return try_emplace(value); }
+
+  bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+  // Constructs a value at the back of the queue. Returns false if the queue is
+  // full.
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == kCapacity) {
+      return false;
+    }
+    new (&slot(tail)) T(std::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Copies as many of the values to the back of the queue as fit and makes
+  // them visible to the consumer at once. Returns the number of values copied.
+  size_type push(std::span<const T> values) {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    const uint32_t count = static_cast<uint32_t>(std::min<size_t>(
+        values.size(),
+        kCapacity - (tail - head_.load(std::memory_order_acquire))));
+    for (uint32_t i = 0; i < count; ++i) {
+      new (&slot(tail + i)) T(values[i]);
+    }
+    tail_.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  // Consumer
+
+  // Removes the value at the front of the queue, if there is one.
+  std::optional<T> try_pop() {
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    std::optional<T> value(std::move(slot(head)));
+    slot(head).~T();
+    head_.store(head + 1, std::memory_order_release);
+    return value;
+  }
+
+  // Moves as many values from the front of the queue into the destination as
+  // are available and fit. Returns the number of values moved.
+  size_type pop(std::span<T> destination) {
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    const uint32_t count = static_cast<uint32_t>(std::min<size_t>(
+        destination.size(), tail_.load(std::memory_order_acquire) - head));
+    for (uint32_t i = 0; i < count; ++i) {
+      destination[i] = std::move(slot(head + i));
+      slot(head + i).~T();
+    }
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  // Either side
+
+  size_type size() const {
+    // Load the head first: it only moves towards the tail, so this never
+    // reports more values than the queue held at some point.
+    const uint32_t head = head_.load(std::memory_order_acquire);
+    return tail_.load(std::memory_order_acquire) - head;
+  }
+
+  bool empty() const { return size() == 0u; }
+  bool full() const { return size() == kCapacity; }
+
+  static constexpr size_type capacity() { return kCapacity; }
+  static constexpr size_type max_size() { return kCapacity; }
+
+ private:
+  static constexpr uint32_t kMask = kCapacity - 1;
+
+  // The indices run freely and wrap at 2^32. Their difference is the number
+  // of values in the queue.
+#ifdef __cpp_lib_launder
+  T& slot(uint32_t index) {
+    return *std::launder(reinterpret_cast<T*>(&array_[index & kMask]));
+  }
+#else
+  T& slot(uint32_t index) {
+    return *reinterpret_cast<T*>(&array_[index & kMask]);
+  }
+#endif  // __cpp_lib_launder
+
+  std::atomic<uint32_t> head_;  // Only stored by the consumer.
+  std::atomic<uint32_t> tail_;  // Only stored by the producer.
+
+  // Values are initialized on demand with placement new.
+  std::array<std::aligned_storage_t<sizeof(T), alignof(T)>, kCapacity> array_;
+};
+
+}  // namespace pw
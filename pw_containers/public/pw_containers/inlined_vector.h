@@ -0,0 +1,334 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "pw_assert/assert.h"
+#include "pw_status/status.h"
+
+namespace pw {
+
+// A vector that stores up to kInlineCapacity elements inline and moves them
+// to memory from an allocator when it grows beyond that. Use it instead of a
+// pw::Vector sized for the worst case when most instances stay small.
+//
+// The Allocator is any type with these functions, such as
+// pw::allocator::FreeListHeap, FreeListHeapBuffer, or TlsfHeap:
+//
+//   void* Allocate(size_t size);  // Returns nullptr on failure.
+//   void Free(void* ptr);
+//
+// Allocated memory must be aligned for T. The allocator must outlive the
+// vector.
+//
+// Operations that may grow the vector return RESOURCE_EXHAUSTED if the
+// allocator cannot provide the memory, and leave the vector unchanged.
+//
+// Moving a vector whose elements are in allocated memory transfers the memory
+// without moving the elements. Since the storage may move between inline
+// memory and the allocator, any operation that grows or moves the vector
+// invalidates pointers to its elements.
+template <typename T, size_t kInlineCapacity, typename Allocator>
+class InlinedVector {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+  using allocator_type = Allocator;
+
+  explicit InlinedVector(Allocator& allocator) noexcept
+      : allocator_(&allocator),
+        data_(inline_data()),
+        size_(0),
+        capacity_(kInlineCapacity) {}
+
+  InlinedVector(const InlinedVector&) = delete;
+  InlinedVector& operator=(const InlinedVector&) = delete;
+
+  // The new vector uses the other vector's allocator. The other vector is
+  // left empty.
+  InlinedVector(InlinedVector&& other) noexcept
+      : allocator_(other.allocator_),
+        data_(inline_data()),
+        size_(0),
+        capacity_(kInlineCapacity) {
+    MoveFrom(other);
+  }
+
+  // Both vectors must use the same allocator. The other vector is left empty.
+  InlinedVector& operator=(InlinedVector&& other) noexcept {
+    if (&other != this) {
+      PW_ASSERT(allocator_ == other.allocator_);
+      clear();
+      ReleaseAllocation();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  ~InlinedVector() {
+    clear();
+    ReleaseAllocation();
+  }
+
+  // Access
+
+  reference at(size_type index) {
+    PW_ASSERT(index < size());
+    return data_[index];
+  }
+  const_reference at(size_type index) const {
+    PW_ASSERT(index < size());
+    return data_[index];
+  }
+
+  reference operator[](size_type index) { return data_[index]; }
+  const_reference operator[](size_type index) const { return data_[index]; }
+
+  reference front() { return data_[0]; }
+  const_reference front() const { return data_[0]; }
+
+  reference back() { return data_[size_ - 1]; }
+  const_reference back() const { return data_[size_ - 1]; }
+
+  T* data() noexcept { return data_; }
+  const T* data() const noexcept { return data_; }
+
+  // Iterate
+
+  iterator begin() noexcept { return data_; }
+  const_iterator begin() const noexcept { return data_; }
+  const_iterator cbegin() const noexcept { return data_; }
+
+  iterator end() noexcept { return data_ + size_; }
+  const_iterator end() const noexcept { return data_ + size_; }
+  const_iterator cend() const noexcept { return data_ + size_; }
+
+  // Capacity
+
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0u; }
+
+  size_type size() const noexcept { return size_; }
+
+  // The number of elements that fit without allocating more memory.
+  size_type capacity() const noexcept { return capacity_; }
+
+  static constexpr size_type inline_capacity() { return kInlineCapacity; }
+
+  // True if the elements are stored inline rather than in allocated memory.
+  bool is_inline() const noexcept { return data_ == inline_data(); }
+
+  // Ensures that the vector can hold new_capacity elements without
+  // allocating.
+  //
+  // Returns:
+  //   OK - the vector has at least new_capacity capacity.
+  //   RESOURCE_EXHAUSTED - the memory could not be allocated.
+  Status reserve(size_type new_capacity);
+
+  // Modify
+
+  void clear() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (T& value : *this) {
+        value.~T();
+      }
+    }
+    size_ = 0;
+  }
+
+  Status push_back(const T& value) { return emplace_back(value); }
+
+  Status push_back(T&& value) { return emplace_back(std::move(value)); }
+
+  template <typename... Args>
+  Status emplace_back(Args&&... args);
+
+  void pop_back() {
+    PW_ASSERT(!empty());
+    back().~T();
+    size_ -= 1;
+  }
+
+  // Resizes the vector, value-initializing any new elements.
+  Status resize(size_type new_size);
+
+  // Moves the elements back inline if they fit there, and otherwise into an
+  // allocation of exactly size() elements. Returns RESOURCE_EXHAUSTED if a
+  // smaller allocation is needed but cannot be made, leaving the vector
+  // unchanged.
+  Status shrink_to_fit();
+
+ private:
+  T* inline_data() noexcept {
+#ifdef __cpp_lib_launder
+    return std::launder(reinterpret_cast<T*>(&inline_storage_));
+#else
+    return reinterpret_cast<T*>(&inline_storage_);
+#endif  // __cpp_lib_launder
+  }
+  const T* inline_data() const noexcept {
+#ifdef __cpp_lib_launder
+    return std::launder(reinterpret_cast<const T*>(&inline_storage_));
+#else
+    return reinterpret_cast<const T*>(&inline_storage_);
+#endif  // __cpp_lib_launder
+  }
+
+  // Moves the elements to new storage with the given capacity, which must be
+  // at least size(). Storage for kInlineCapacity or fewer elements is inline.
+  Status Reallocate(size_type new_capacity);
+
+  // Takes the other vector's elements. This vector must be empty and inline.
+  void MoveFrom(InlinedVector& other) noexcept;
+
+  void ReleaseAllocation() noexcept {
+    if (!is_inline()) {
+      allocator_->Free(data_);
+      data_ = inline_data();
+      capacity_ = kInlineCapacity;
+    }
+  }
+
+  Allocator* allocator_;
+  T* data_;
+  size_type size_;
+  size_type capacity_;
+
+  // Inline elements are initialized on demand with placement new. As in
+  // pw::Vector, the alignas specifier keeps a zero-length array aligned.
+  alignas(T) std::array<std::aligned_storage_t<sizeof(T), alignof(T)>,
+                        kInlineCapacity> inline_storage_;
+};
+
+// Function implementations
+
+template <typename T, size_t kInlineCapacity, typename Allocator>
+Status InlinedVector<T, kInlineCapacity, Allocator>::reserve(
+    size_type new_capacity) {
+  if (new_capacity <= capacity_) {
+    return OkStatus();
+  }
+  return Reallocate(new_capacity);
+}
+
+template <typename T, size_t kInlineCapacity, typename Allocator>
+template <typename... Args>
+Status InlinedVector<T, kInlineCapacity, Allocator>::emplace_back(
+    Args&&... args) {
+  if (size_ == capacity_) {
+    // Grow geometrically so that repeated pushes take amortized constant time.
+    if (Status status = Reallocate(std::max<size_type>(2 * capacity_, 4));
+        !status.ok()) {
+      return status;
+    }
+  }
+  new (&data_[size_]) T(std::forward<Args>(args)...);
+  size_ += 1;
+  return OkStatus();
+}
+
+template <typename T, size_t kInlineCapacity, typename Allocator>
+Status InlinedVector<T, kInlineCapacity, Allocator>::resize(
+    size_type new_size) {
+  if (Status status = reserve(new_size); !status.ok()) {
+    return status;
+  }
+  while (size_ > new_size) {
+    pop_back();
+  }
+  while (size_ < new_size) {
+    new (&data_[size_]) T();
+    size_ += 1;
+  }
+  return OkStatus();
+}
+
+template <typename T, size_t kInlineCapacity, typename Allocator>
+Status InlinedVector<T, kInlineCapacity, Allocator>::shrink_to_fit() {
+  if (is_inline() || size_ == capacity_) {
+    return OkStatus();
+  }
+  return Reallocate(size_);
+}
+
+template <typename T, size_t kInlineCapacity, typename Allocator>
+Status InlinedVector<T, kInlineCapacity, Allocator>::Reallocate(
+    size_type new_capacity) {
+  T* new_data;
+  if (new_capacity <= kInlineCapacity) {
+    if (is_inline()) {
+      return OkStatus();
+    }
+    new_data = inline_data();
+    new_capacity = kInlineCapacity;
+  } else {
+    if (new_capacity > SIZE_MAX / sizeof(T)) {
+      return Status::ResourceExhausted();
+    }
+    new_data = static_cast<T*>(allocator_->Allocate(new_capacity * sizeof(T)));
+    if (new_data == nullptr) {
+      return Status::ResourceExhausted();
+    }
+    PW_ASSERT(reinterpret_cast<uintptr_t>(new_data) % alignof(T) == 0u);
+  }
+
+  for (size_type i = 0; i < size_; ++i) {
+    new (&new_data[i]) T(std::move(data_[i]));
+    data_[i].~T();
+  }
+
+  if (!is_inline()) {
+    allocator_->Free(data_);
+  }
+  data_ = new_data;
+  capacity_ = new_capacity;
+  return OkStatus();
+}
+
+template <typename T, size_t kInlineCapacity, typename Allocator>
+void InlinedVector<T, kInlineCapacity, Allocator>::MoveFrom(
+    InlinedVector& other) noexcept {
+  if (other.is_inline()) {
+    for (size_type i = 0; i < other.size_; ++i) {
+      new (&data_[i]) T(std::move(other.data_[i]));
+    }
+    size_ = other.size_;
+    other.clear();
+    return;
+  }
+
+  // Take the allocation without touching the elements.
+  data_ = other.data_;
+  size_ = other.size_;
+  capacity_ = other.capacity_;
+  other.data_ = other.inline_data();
+  other.size_ = 0;
+  other.capacity_ = kInlineCapacity;
+}
+
+}  // namespace pw
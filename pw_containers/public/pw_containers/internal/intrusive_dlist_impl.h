@@ -0,0 +1,203 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace pw {
+
+template <typename, bool>
+class IntrusiveDList;
+
+namespace intrusive_dlist_impl {
+
+template <typename T, typename I>
+class Iterator {
+ public:
+  using difference_type = std::ptrdiff_t;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T*;
+  using reference = T&;
+  using iterator_category = std::bidirectional_iterator_tag;
+
+  constexpr explicit Iterator() : item_(nullptr) {}
+
+  // Allow converting an iterator to a const_iterator.
+  template <typename U,
+            typename J,
+            typename = std::enable_if_t<std::is_convertible_v<J*, I*>>>
+  constexpr Iterator(const Iterator<U, J>& other) : item_(other.item_) {}
+
+  constexpr Iterator& operator++() {
+    item_ = static_cast<I*>(item_->next_);
+    return *this;
+  }
+
+  constexpr Iterator operator++(int) {
+    Iterator previous_value(item_);
+    operator++();
+    return previous_value;
+  }
+
+  constexpr Iterator& operator--() {
+    item_ = static_cast<I*>(item_->previous_);
+    return *this;
+  }
+
+  constexpr Iterator operator--(int) {
+    Iterator previous_value(item_);
+    operator--();
+    return previous_value;
+  }
+
+  constexpr const T& operator*() const { return *static_cast<T*>(item_); }
+  constexpr T& operator*() { return *static_cast<T*>(item_); }
+
+  constexpr const T* operator->() const { return static_cast<T*>(item_); }
+  constexpr T* operator->() { return static_cast<T*>(item_); }
+
+  template <typename U, typename J>
+  constexpr bool operator==(const Iterator<U, J>& rhs) const {
+    return item_ == rhs.item_;
+  }
+
+  template <typename U, typename J>
+  constexpr bool operator!=(const Iterator<U, J>& rhs) const {
+    return item_ != rhs.item_;
+  }
+
+ private:
+  template <typename, typename>
+  friend class Iterator;
+
+  template <typename, bool>
+  friend class ::pw::IntrusiveDList;
+
+  // Only allow IntrusiveDList to create iterators that point to something.
+  constexpr explicit Iterator(I* item) : item_{item} {}
+
+  I* item_;
+};
+
+class List {
+ public:
+  class Item {
+   protected:
+    constexpr Item() : Item(this) {}
+
+    ~Item() { unlist(); }
+
+   private:
+    friend class List;
+
+    template <typename T, typename I>
+    friend class Iterator;
+
+    constexpr Item(Item* self) : next_(self), previous_(self) {}
+
+    bool unlisted() const { return this == next_; }
+
+    // Unlinks this from the list it is a part of, if any. O(1).
+    void unlist() {
+      previous_->next_ = next_;
+      next_->previous_ = previous_;
+      next_ = this;
+      previous_ = this;
+    }
+
+    // Unlisted items must be self-cycles (next_ == previous_ == this).
+    Item* next_;
+    Item* previous_;
+  };
+
+  constexpr List() : head_() {}
+
+  // Intrusive lists cannot be copied, since each Item can only be in one list.
+  List(const List&) = delete;
+  List& operator=(const List&) = delete;
+
+  bool empty() const noexcept { return begin() == end(); }
+
+  // Inserts item before pos.
+  static void insert(Item* pos, Item& item);
+
+  static void erase(Item& item) { item.unlist(); }
+
+  void clear();
+
+  constexpr Item* begin() noexcept { return head_.next_; }
+  constexpr const Item* begin() const noexcept { return head_.next_; }
+
+  constexpr Item* end() noexcept { return &head_; }
+  constexpr const Item* end() const noexcept { return &head_; }
+
+  // The last item, or end() if the list is empty.
+  constexpr Item* last() noexcept { return head_.previous_; }
+  constexpr const Item* last() const noexcept { return head_.previous_; }
+
+  static bool unlisted(const Item& item) { return item.unlisted(); }
+
+  size_t size() const;
+
+ private:
+  // Use an Item for the head, so that the list is a cycle and inserting and
+  // removing items needs no special cases. &head_ is end().
+  Item head_;
+};
+
+// Counts the items in an IntrusiveDList with a cached size. The
+// specialization for lists without a cached size is empty, so it takes no
+// space as a base class.
+template <bool kCacheSize>
+class SizeCounter {
+ protected:
+  constexpr SizeCounter() : cached_size_(0) {}
+
+  void ItemAdded() { cached_size_ += 1; }
+  void ItemRemoved() { cached_size_ -= 1; }
+  void Reset() { cached_size_ = 0; }
+
+  size_t cached_size_;
+};
+
+template <>
+class SizeCounter<false> {
+ protected:
+  constexpr SizeCounter() = default;
+
+  void ItemAdded() {}
+  void ItemRemoved() {}
+  void Reset() {}
+};
+
+// Gets the element type from an Item. This is used to check that an
+// IntrusiveDList element class inherits from Item, either directly or through
+// another class.
+template <typename T, bool kIsItem = std::is_base_of<List::Item, T>()>
+struct GetListElementTypeFromItem {
+  using Type = void;
+};
+
+template <typename T>
+struct GetListElementTypeFromItem<T, true> {
+  using Type = typename T::PwIntrusiveDListElementType;
+};
+
+template <typename T>
+using ElementTypeFromItem = typename GetListElementTypeFromItem<T>::Type;
+
+}  // namespace intrusive_dlist_impl
+}  // namespace pw
@@ -0,0 +1,221 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+#include "pw_containers/internal/intrusive_dlist_impl.h"
+
+namespace pw {
+
+// IntrusiveDList is a doubly-linked version of IntrusiveList. Items can be
+// removed from the list in O(1) time, without searching for them, and the list
+// can be iterated in both directions. Each item takes two pointers instead of
+// one.
+//
+// If kCacheSize is true, the list counts its items so that size() is O(1).
+// Items in such a list must be removed from it before they are destroyed;
+// otherwise the cached size is left stale. Without a cached size, size() is
+// O(n), and items unlink themselves when they are destroyed.
+//
+// As with IntrusiveList, items must derive from IntrusiveDList<T>::Item and
+// can only be in one list at a time. The same items may be used with lists
+// that do and do not cache their size.
+//
+// Usage:
+//
+//   class TestItem : public IntrusiveDList<TestItem>::Item {}
+//
+//   IntrusiveDList<TestItem> test_items;
+//
+//   TestItem item;
+//   test_items.push_back(item);
+//   test_items.remove(item);  // O(1)
+//
+template <typename T, bool kCacheSize = false>
+class IntrusiveDList : private intrusive_dlist_impl::SizeCounter<kCacheSize> {
+ public:
+  class Item : public intrusive_dlist_impl::List::Item {
+   public:
+    Item(const Item&) = delete;
+    Item& operator=(const Item&) = delete;
+
+   protected:
+    constexpr Item() = default;
+
+   private:
+    // GetListElementTypeFromItem is used to find the element type from an item.
+    // It is used to ensure list items inherit from the correct Item type.
+    template <typename, bool>
+    friend struct intrusive_dlist_impl::GetListElementTypeFromItem;
+
+    using PwIntrusiveDListElementType = T;
+  };
+
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T*;
+  using reference = T&;
+  using iterator =
+      intrusive_dlist_impl::Iterator<T, intrusive_dlist_impl::List::Item>;
+  using const_iterator =
+      intrusive_dlist_impl::Iterator<std::add_const_t<T>,
+                                     const intrusive_dlist_impl::List::Item>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  constexpr IntrusiveDList() { CheckItemType(); }
+
+  // Constructs an IntrusiveDList from an iterator over Items. The iterator may
+  // dereference as either Item& (e.g. from std::array<Item>) or Item* (e.g.
+  // from std::initializer_list<Item*>).
+  template <typename Iterator>
+  IntrusiveDList(Iterator first, Iterator last) {
+    CheckItemType();
+    AssignFromIterator(first, last);
+  }
+
+  // Constructs an IntrusiveDList from a std::initializer_list of pointers to
+  // items.
+  IntrusiveDList(std::initializer_list<T*> items)
+      : IntrusiveDList(items.begin(), items.end()) {}
+
+  template <typename Iterator>
+  void assign(Iterator first, Iterator last) {
+    clear();
+    AssignFromIterator(first, last);
+  }
+
+  void assign(std::initializer_list<T*> items) {
+    assign(items.begin(), items.end());
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return list_.empty(); }
+
+  void push_front(T& item) { insert(begin(), item); }
+
+  void push_back(T& item) { insert(end(), item); }
+
+  // Inserts item before pos and returns an iterator to it.
+  iterator insert(iterator pos, T& item) {
+    list_.insert(pos.item_, item);
+    this->ItemAdded();
+    return iterator(&item);
+  }
+
+  // Removes the first item in the list. The list must not be empty.
+  void pop_front() { erase(begin()); }
+
+  // Removes the last item in the list. The list must not be empty.
+  void pop_back() { erase(iterator(list_.last())); }
+
+  // Removes the item at pos from the list and returns an iterator to the item
+  // that followed it. The item is not destructed.
+  iterator erase(iterator pos) {
+    iterator next = std::next(pos);
+    list_.erase(*pos.item_);
+    this->ItemRemoved();
+    return next;
+  }
+
+  // Removes all items from the list. The items themselves are not destructed.
+  void clear() {
+    list_.clear();
+    this->Reset();
+  }
+
+  // Removes an item from the list in O(1) time, without searching for it.
+  // Returns false if the item was not in a list. The item must not be in a
+  // different list.
+  //
+  // The item's links belong to the list rather than to its value, so const
+  // items may be removed.
+  bool remove(const T& item) {
+    auto& list_item = const_cast<intrusive_dlist_impl::List::Item&>(
+        static_cast<const intrusive_dlist_impl::List::Item&>(item));
+    if (intrusive_dlist_impl::List::unlisted(list_item)) {
+      return false;
+    }
+    list_.erase(list_item);
+    this->ItemRemoved();
+    return true;
+  }
+
+  // Reference to the first element in the list. Undefined behavior if empty().
+  T& front() { return *begin(); }
+  const T& front() const { return *begin(); }
+
+  // Reference to the last element in the list. Undefined behavior if empty().
+  T& back() { return *iterator(list_.last()); }
+  const T& back() const { return *const_iterator(list_.last()); }
+
+  iterator begin() noexcept { return iterator(list_.begin()); }
+  const_iterator begin() const noexcept {
+    return const_iterator(list_.begin());
+  }
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(list_.end()); }
+  const_iterator end() const noexcept { return const_iterator(list_.end()); }
+  const_iterator cend() const noexcept { return end(); }
+
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+  const_reverse_iterator crend() const noexcept { return rend(); }
+
+  // O(1) if kCacheSize is true; O(size) otherwise.
+  size_t size() const {
+    if constexpr (kCacheSize) {
+      return this->cached_size_;
+    } else {
+      return list_.size();
+    }
+  }
+
+ private:
+  // Check that T is an Item in a function, since the class T will not be fully
+  // defined when the IntrusiveDList<T> class is instantiated.
+  static constexpr void CheckItemType() {
+    static_assert(
+        std::is_base_of<intrusive_dlist_impl::ElementTypeFromItem<T>, T>(),
+        "IntrusiveDList items must be derived from IntrusiveDList<T>::Item, "
+        "where T is the item or one of its bases.");
+  }
+
+  template <typename Iterator>
+  void AssignFromIterator(Iterator first, Iterator last) {
+    for (Iterator it = first; it != last; ++it) {
+      if constexpr (std::is_pointer<std::remove_reference_t<decltype(*it)>>()) {
+        push_back(**it);
+      } else {
+        push_back(*it);
+      }
+    }
+  }
+
+  intrusive_dlist_impl::List list_;
+};
+
+}  // namespace pw
@@ -0,0 +1,74 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_cpu_exception_cortex_m/fault_record.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_cpu_exception_cortex_m_private/cortex_m_constants.h"
+
+namespace pw::cpu_exception_cortex_m::internal {
+namespace {
+
+// A rotate and XOR per word keeps the checksum to a couple of cycles per word,
+// which matters more in a fault handler than the strength of a CRC.
+constexpr uint32_t kChecksumSeed = 0x811C9DC5;
+
+uint32_t UpdateChecksum(uint32_t checksum, uint32_t word) {
+  return ((checksum << 5) | (checksum >> 27)) ^ word;
+}
+
+}  // namespace
+
+size_t CopyFaultStack(const pw_cpu_exception_State& cpu_state,
+                      uintptr_t stack_high_addr,
+                      std::span<uint32_t> stack) {
+  // The stack pointers were patched on exception entry to reflect the state
+  // at the time of the fault.
+  const uintptr_t stack_pointer =
+      (cpu_state.extended.exc_return & cpu_exception::kExcReturnStackMask)
+          ? cpu_state.extended.psp
+          : cpu_state.extended.msp;
+
+  if (stack_pointer >= stack_high_addr) {
+    return 0;
+  }
+
+  const size_t words =
+      std::min(stack.size(), (stack_high_addr - stack_pointer) / 4);
+  std::memcpy(stack.data(),
+              reinterpret_cast<const void*>(stack_pointer),
+              words * sizeof(uint32_t));
+  return words;
+}
+
+uint32_t FaultRecordChecksum(uint32_t stack_words,
+                             const pw_cpu_exception_State& cpu_state,
+                             std::span<const uint32_t> stack) {
+  uint32_t checksum = UpdateChecksum(kChecksumSeed, stack_words);
+
+  uint32_t state_words[sizeof(cpu_state) / sizeof(uint32_t)];
+  std::memcpy(state_words, &cpu_state, sizeof(state_words));
+  for (uint32_t word : state_words) {
+    checksum = UpdateChecksum(checksum, word);
+  }
+
+  for (uint32_t word : stack) {
+    checksum = UpdateChecksum(checksum, word);
+  }
+  return checksum;
+}
+
+}  // namespace pw::cpu_exception_cortex_m::internal
@@ -0,0 +1,110 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_cpu_exception_cortex_m/fault_record.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw::cpu_exception_cortex_m {
+namespace {
+
+constexpr uint32_t kExcReturnPsp = 0xFFFFFFFD;
+constexpr uint32_t kExcReturnMsp = 0xFFFFFFF9;
+
+class FaultRecordTest : public ::testing::Test {
+ protected:
+  FaultRecordTest() {
+    for (size_t i = 0; i < stack_.size(); ++i) {
+      stack_[i] = 0x1000 + i;
+    }
+    std::memset(&state_, 0, sizeof(state_));
+    state_.extended.exc_return = kExcReturnMsp;
+    state_.extended.msp = Address(0);
+    state_.extended.psp = Address(4);
+    state_.base.pc = 0x08001234;
+    state_.extended.cfsr = 0x8200;
+  }
+
+  uintptr_t Address(size_t word) {
+    return reinterpret_cast<uintptr_t>(&stack_[word]);
+  }
+
+  std::array<uint32_t, 16> stack_;
+  pw_cpu_exception_State state_;
+  FaultRecord<8> record_;
+};
+
+TEST_F(FaultRecordTest, Capture_CopiesStateAndStack) {
+  record_.clear();
+  EXPECT_FALSE(record_.has_value());
+
+  record_.Capture(state_, Address(stack_.size()));
+  ASSERT_TRUE(record_.has_value());
+  EXPECT_EQ(0x08001234u, record_.cpu_state().base.pc);
+  EXPECT_EQ(0x8200u, record_.cpu_state().extended.cfsr);
+
+  ASSERT_EQ(8u, record_.stack().size());
+  for (size_t i = 0; i < record_.stack().size(); ++i) {
+    EXPECT_EQ(stack_[i], record_.stack()[i]);
+  }
+}
+
+TEST_F(FaultRecordTest, Capture_UsesProcessStackIfActive) {
+  state_.extended.exc_return = kExcReturnPsp;
+  record_.Capture(state_, Address(stack_.size()));
+  ASSERT_TRUE(record_.has_value());
+  EXPECT_EQ(stack_[4], record_.stack()[0]);
+}
+
+TEST_F(FaultRecordTest, Capture_StopsAtStackEnd) {
+  record_.Capture(state_, Address(3));
+  ASSERT_TRUE(record_.has_value());
+  EXPECT_EQ(3u, record_.stack().size());
+}
+
+TEST_F(FaultRecordTest, Capture_NoStackEnd_CapturesNoStack) {
+  record_.Capture(state_, 0);
+  ASSERT_TRUE(record_.has_value());
+  EXPECT_TRUE(record_.stack().empty());
+}
+
+TEST_F(FaultRecordTest, Corruption_IsDetected) {
+  record_.Capture(state_, Address(stack_.size()));
+  ASSERT_TRUE(record_.has_value());
+
+  std::byte* bytes = const_cast<std::byte*>(record_.bytes().data());
+  bytes[40] ^= std::byte{0x01};
+  EXPECT_FALSE(record_.has_value());
+}
+
+TEST_F(FaultRecordTest, Bytes_MatchesDocumentedLayout) {
+  record_.Capture(state_, Address(2));
+  ConstByteSpan bytes = record_.bytes();
+  ASSERT_EQ((3 + sizeof(state_) / 4 + 2) * 4, bytes.size());
+
+  uint32_t words[3];
+  std::memcpy(words, bytes.data(), sizeof(words));
+  EXPECT_EQ(0x52465750u, words[0]);  // "PWFR"
+  EXPECT_EQ(2u, words[2]);
+  EXPECT_EQ(0, std::memcmp(bytes.data() + 12, &state_, sizeof(state_)));
+  EXPECT_EQ(0,
+            std::memcmp(bytes.data() + 12 + sizeof(state_), stack_.data(), 8));
+}
+
+}  // namespace
+}  // namespace pw::cpu_exception_cortex_m
@@ -0,0 +1,131 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_cpu_exception_cortex_m/cpu_state.h"
+#include "pw_preprocessor/compiler.h"
+
+namespace pw::cpu_exception_cortex_m {
+namespace internal {
+
+inline constexpr uint32_t kFaultRecordMagic = 0x52465750;  // "PWFR"
+
+// Copies up to stack.size() words from the stack pointer that was active when
+// the fault occurred, stopping before stack_high_addr. Returns the number of
+// words copied.
+size_t CopyFaultStack(const pw_cpu_exception_State& cpu_state,
+                      uintptr_t stack_high_addr,
+                      std::span<uint32_t> stack);
+
+// Computes the checksum of a fault record's stack word count, CPU state, and
+// captured stack words.
+uint32_t FaultRecordChecksum(uint32_t stack_words,
+                             const pw_cpu_exception_State& cpu_state,
+                             std::span<const uint32_t> stack);
+
+}  // namespace internal
+
+// A compact record of a CPU exception for fault handlers that must reset
+// quickly, such as on watchdog-critical devices. Capture() copies the core
+// registers and a small window of the faulting stack with plain word copies
+// and a cheap checksum, in a few hundred cycles. Nothing is logged or
+// formatted; the record is meant to be placed in persistent RAM and decoded
+// after the reboot, either on the device with cpu_state() or on the host with
+// pw_cpu_exception_cortex_m.fault_record.
+//
+// Like pw::persistent_ram::Persistent, the constructor intentionally does not
+// initialize anything, so a record in a .noinit section survives resets.
+//
+//   PW_KEEP_IN_SECTION(".noinit")
+//   pw::cpu_exception_cortex_m::FaultRecord<32> fault_record;
+//
+//   extern "C" void pw_cpu_exception_DefaultHandler(
+//       pw_cpu_exception_State* state) {
+//     fault_record.Capture(*state, kMainStackHighAddr);
+//     Reset();
+//   }
+//
+// The layout is all little-endian uint32_t words: the magic, the checksum,
+// the number of stack words captured, the pw_cpu_exception_State, then
+// kMaxStackWords stack words. The checksum covers the words from the stack
+// word count through the last captured stack word.
+template <size_t kMaxStackWords>
+class FaultRecord {
+ public:
+  static_assert(kMaxStackWords > 0u);
+
+  FaultRecord() {}
+  FaultRecord(const FaultRecord&) = delete;
+  FaultRecord& operator=(const FaultRecord&) = delete;
+
+  // Captures cpu_state and the faulting stack, from the stack pointer up to at
+  // most kMaxStackWords words or stack_high_addr, whichever comes first.
+  // stack_high_addr is one past the highest address of the stack that was in
+  // use; if it is 0, no stack is captured.
+  void Capture(const pw_cpu_exception_State& cpu_state,
+               uintptr_t stack_high_addr) {
+    magic_ = 0;
+    cpu_state_ = cpu_state;
+    stack_words_ = internal::CopyFaultStack(cpu_state, stack_high_addr, stack_);
+    checksum_ =
+        internal::FaultRecordChecksum(stack_words_, cpu_state_, stack());
+    magic_ = internal::kFaultRecordMagic;
+  }
+
+  // True if a complete record was captured and not cleared since.
+  bool has_value() const {
+    return magic_ == internal::kFaultRecordMagic &&
+           stack_words_ <= kMaxStackWords &&
+           checksum_ ==
+               internal::FaultRecordChecksum(stack_words_, cpu_state_, stack());
+  }
+
+  void clear() { magic_ = 0; }
+
+  // The captured CPU state. Only valid if has_value() is true.
+  const pw_cpu_exception_State& cpu_state() const { return cpu_state_; }
+
+  // The captured stack words, starting at the stack pointer. Only valid if
+  // has_value() is true.
+  std::span<const uint32_t> stack() const {
+    return std::span(stack_, stack_words_);
+  }
+
+  // The record in the format decoded by the host tools.
+  ConstByteSpan bytes() const {
+    static_assert(sizeof(FaultRecord) ==
+                  (kFixedWords + kMaxStackWords) * sizeof(uint32_t));
+    return std::as_bytes(std::span(this, 1))
+        .first(kFixedWords * sizeof(uint32_t) +
+               stack_words_ * sizeof(uint32_t));
+  }
+
+ private:
+  static constexpr size_t kFixedWords =
+      3 + sizeof(pw_cpu_exception_State) / sizeof(uint32_t);
+
+  // None of these members are initialized by the constructor by design.
+  uint32_t magic_;
+  uint32_t checksum_;
+  uint32_t stack_words_;
+  pw_cpu_exception_State cpu_state_;
+  uint32_t stack_[kMaxStackWords];
+};
+
+}  // namespace pw::cpu_exception_cortex_m
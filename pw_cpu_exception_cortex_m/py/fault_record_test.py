@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# Copyright 2020 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+"""Tests decoding fault records."""
+
+import struct
+import unittest
+
+from pw_cpu_exception_cortex_m import fault_record
+
+# Index of each pw_cpu_exception_State field in the record's CPU state words.
+_PC = 24
+_MSP = 7
+_CFSR = 0
+
+
+def _encode(state, stack, magic=0x52465750) -> bytes:
+    words = [len(stack), *state, *stack]
+    return struct.pack(f'<{2 + len(words)}I', magic,
+                       fault_record.checksum(words), *words)
+
+
+class FaultRecordTest(unittest.TestCase):
+    """Tests fault_record.decode()."""
+    def setUp(self):
+        self._state = [0] * 26
+        self._state[_PC] = 0x08001234
+        self._state[_MSP] = 0x20001000
+        self._state[_CFSR] = 0x8200
+
+    def test_decode(self):
+        record = fault_record.decode(_encode(self._state, [1, 2, 3]))
+        assert record is not None
+        self.assertEqual(record.cpu_state.pc, 0x08001234)
+        self.assertEqual(record.cpu_state.msp, 0x20001000)
+        self.assertEqual(record.cpu_state.cfsr, 0x8200)
+        self.assertEqual(record.stack, (1, 2, 3))
+        self.assertEqual(record.stack_pointer(), 0x20001000)
+        self.assertIn('0x20001008: 0x00000003', record.dump_stack())
+
+    def test_decode_ignores_unused_stack_words(self):
+        data = _encode(self._state, [1, 2]) + bytes(8)
+        record = fault_record.decode(data)
+        assert record is not None
+        self.assertEqual(record.stack, (1, 2))
+
+    def test_bad_magic(self):
+        self.assertIsNone(
+            fault_record.decode(_encode(self._state, [], magic=0)))
+
+    def test_corrupted(self):
+        data = bytearray(_encode(self._state, [1, 2, 3]))
+        data[20] ^= 1
+        self.assertIsNone(fault_record.decode(bytes(data)))
+
+    def test_truncated(self):
+        data = _encode(self._state, [1, 2, 3])
+        self.assertIsNone(fault_record.decode(data[:-4]))
+        self.assertIsNone(fault_record.decode(data[:8]))
+
+
+if __name__ == '__main__':
+    unittest.main()
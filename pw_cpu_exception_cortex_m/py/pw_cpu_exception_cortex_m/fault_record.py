@@ -0,0 +1,113 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Decodes fault records captured by pw::cpu_exception_cortex_m::FaultRecord."""
+
+import argparse
+import dataclasses
+from pathlib import Path
+import struct
+import sys
+from typing import Optional, Tuple
+
+from pw_cpu_exception_cortex_m.exception_analyzer import (
+    CortexMExceptionAnalyzer)
+from pw_cpu_exception_cortex_m_protos import cpu_state_pb2
+
+_MAGIC = 0x52465750  # "PWFR"
+_CHECKSUM_SEED = 0x811C9DC5
+
+# The fields of pw_cpu_exception_State, in order.
+_CPU_STATE_FIELDS = ('cfsr', 'mmfar', 'bfar', 'icsr', 'hfsr', 'shcsr',
+                     'exc_return', 'msp', 'psp', 'control', 'r4', 'r5', 'r6',
+                     'r7', 'r8', 'r9', 'r10', 'r11', 'r0', 'r1', 'r2', 'r3',
+                     'r12', 'lr', 'pc', 'psr')
+
+# The magic, checksum, and number of captured stack words.
+_HEADER_WORDS = 3
+
+_EXC_RETURN_STACK_MASK = 1 << 2
+
+
+def checksum(words) -> int:
+    """Computes the checksum used by FaultRecord."""
+    value = _CHECKSUM_SEED
+    for word in words:
+        value = (((value << 5) | (value >> 27)) & 0xFFFFFFFF) ^ word
+    return value
+
+
+@dataclasses.dataclass(frozen=True)
+class FaultRecord:
+    """A decoded FaultRecord."""
+    cpu_state: cpu_state_pb2.ArmV7mCpuState
+    stack: Tuple[int, ...]
+
+    def stack_pointer(self) -> int:
+        """The stack pointer that was in use when the fault occurred."""
+        if self.cpu_state.exc_return & _EXC_RETURN_STACK_MASK:
+            return self.cpu_state.psp
+        return self.cpu_state.msp
+
+    def dump_stack(self) -> str:
+        """Dumps the captured stack words with their addresses."""
+        return '\n'.join(f'0x{self.stack_pointer() + 4 * i:08x}: 0x{word:08x}'
+                         for i, word in enumerate(self.stack))
+
+    def __str__(self) -> str:
+        dump = [str(CortexMExceptionAnalyzer(self.cpu_state))]
+        if self.stack:
+            dump.extend(('', 'Stack:', self.dump_stack()))
+        return '\n'.join(dump)
+
+
+def decode(data: bytes) -> Optional[FaultRecord]:
+    """Decodes a fault record, or returns None if it is not valid."""
+    fixed_words = _HEADER_WORDS + len(_CPU_STATE_FIELDS)
+    if len(data) < fixed_words * 4:
+        return None
+
+    magic, expected_checksum, stack_words = struct.unpack_from('<3I', data)
+    if magic != _MAGIC or len(data) < (fixed_words + stack_words) * 4:
+        return None
+
+    words = struct.unpack_from(f'<{fixed_words - 2 + stack_words}I', data, 8)
+    if checksum(words) != expected_checksum:
+        return None
+
+    cpu_state = cpu_state_pb2.ArmV7mCpuState(
+        **dict(zip(_CPU_STATE_FIELDS, words[1:])))
+    return FaultRecord(cpu_state, tuple(words[1 + len(_CPU_STATE_FIELDS):]))
+
+
+def _parse_args():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('record',
+                        type=Path,
+                        help='File containing the raw fault record')
+    return parser.parse_args()
+
+
+def _main(record: Path) -> int:
+    fault_record = decode(record.read_bytes())
+    if fault_record is None:
+        print(f'{record} does not contain a valid fault record',
+              file=sys.stderr)
+        return 1
+
+    print(fault_record)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(_main(**vars(_parse_args())))
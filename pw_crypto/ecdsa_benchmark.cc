@@ -0,0 +1,84 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compares verifying with VerifyP256Signature(), which parses the public key
+// on each call, to verifying with a P256PublicKey that was loaded once. Build
+// it with each pw_crypto_ECDSA_BACKEND to compare the backends.
+
+#include "pw_assert/check.h"
+#include "pw_benchmark/benchmark.h"
+#include "pw_crypto/ecdsa.h"
+
+namespace pw::crypto::ecdsa {
+namespace {
+
+#define AS_BYTES(s) std::as_bytes(std::span(s, sizeof(s) - 1))
+
+// The SHA256 digest of "Hello, Pigweed!", 32 bytes.
+#define TEST_DIGEST                                                  \
+  "\x8D\xCE\x14\xEE\x2C\xD9\xFD\x9B\xBD\x8C\x8D\x57\x68\x50\x2C\x2F" \
+  "\xFB\xB3\x52\x36\xCE\x93\x47\x1B\x80\xFC\xA4\x7D\xB5\xF8\x41\x9D"
+
+// The public key in uncompressed form, 65 bytes.
+#define TEST_PUBKEY                                                  \
+  "\x04"                                                             \
+  "\xD1\x82\x2E\x6A\xD2\x4B\x2A\x80\x2E\x8F\xBC\x03\x00\x95\x11\xF9" \
+  "\x81\x24\xA7\x3C\x45\xC8\xBA\xDD\x5F\x77\x1C\xC3\x71\x8B\xB2\xE9" \
+  "\x3A\x0A\x84\xFF\xEA\x13\xC2\x27\xD2\xCF\x42\x7D\xA5\x95\xD6\x88" \
+  "\xCD\x23\x00\x3F\xF9\xD9\x75\x46\xFF\x58\xE9\xBE\xC3\x74\x13\xB8"
+
+// The ECDSA P256 signature of `DIGEST`.
+#define TEST_SIGNATURE                                               \
+  "\x16\x54\x43\xD4\x00\x07\xC4\xD7\x26\x2E\x3C\xB1\x65\x54\x00\x6A" \
+  "\x6A\x5B\x4A\xBB\x16\x6F\x44\xD0\x91\x3F\xD3\xC2\x50\xAC\x1A\x87" \
+  "\x86\x41\xEE\x56\xDA\x31\xF2\xFF\x38\x3C\xBB\x32\x3E\x2D\xDB\x98" \
+  "\xEA\x05\x9E\x8F\x91\x8E\x0E\x99\xE5\x4F\x32\x13\x92\x7F\x17\x68"
+
+void BM_VerifyP256Signature(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    bool ok = VerifyP256Signature(AS_BYTES(TEST_PUBKEY),
+                                  AS_BYTES(TEST_DIGEST),
+                                  AS_BYTES(TEST_SIGNATURE))
+                  .ok();
+    benchmark::DoNotOptimize(ok);
+  }
+}
+PW_BENCHMARK(BM_VerifyP256Signature);
+
+void BM_P256PublicKeyInit(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    P256PublicKey key;
+    bool ok = key.Init(AS_BYTES(TEST_PUBKEY)).ok();
+    benchmark::DoNotOptimize(ok);
+  }
+}
+PW_BENCHMARK(BM_P256PublicKeyInit);
+
+void BM_P256PublicKeyVerify(benchmark::State& state) {
+  P256PublicKey key;
+  PW_CHECK_OK(key.Init(AS_BYTES(TEST_PUBKEY)));
+
+  // Verify once outside of the measurement, so that state the backend builds
+  // on first use is not counted.
+  PW_CHECK_OK(key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+
+  while (state.KeepRunning()) {
+    bool ok = key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)).ok();
+    benchmark::DoNotOptimize(ok);
+  }
+}
+PW_BENCHMARK(BM_P256PublicKeyVerify);
+
+}  // namespace
+}  // namespace pw::crypto::ecdsa
@@ -14,6 +14,8 @@
 #define PW_LOG_MODULE_NAME "ECDSA"
 #define PW_LOG_LEVEL PW_LOG_LEVEL_WARN
 
+#include <utility>
+
 #include "openssl/bn.h"
 #include "openssl/ec.h"
 #include "openssl/ecdsa.h"
@@ -21,58 +23,55 @@
 #include "pw_crypto/ecdsa.h"
 #include "pw_log/log.h"
 
-namespace pw::crypto::ecdsa {
-
-constexpr size_t kP256CurveOrderBytes = 32;
+namespace pw::crypto::ecdsa::backend {
 
-Status VerifyP256Signature(ConstByteSpan public_key,
-                           ConstByteSpan digest,
-                           ConstByteSpan signature) {
+Status DoInitP256PublicKey(NativeP256PublicKey& key, ConstByteSpan public_key) {
   const uint8_t* public_key_bytes =
       reinterpret_cast<const uint8_t*>(public_key.data());
-  const uint8_t* digest_bytes = reinterpret_cast<const uint8_t*>(digest.data());
-  const uint8_t* signature_bytes =
-      reinterpret_cast<const uint8_t*>(signature.data());
 
-  // Allocate objects needed for ECDSA verification. BoringSSL relies on
-  // dynamic allocation.
-  bssl::UniquePtr<EC_GROUP> group(
-      EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1));
-  if (!group) {
+  // Allocate objects needed for the key. BoringSSL relies on dynamic
+  // allocation. The P256 group is static, so it is not allocated.
+  bssl::UniquePtr<EC_KEY> ec_key(
+      EC_KEY_new_by_curve_name(NID_X9_62_prime256v1));
+  if (!ec_key) {
     return Status::ResourceExhausted();
   }
 
-  bssl::UniquePtr<EC_POINT> pub_key(EC_POINT_new(group.get()));
-  bssl::UniquePtr<EC_KEY> key(EC_KEY_new());
-  bssl::UniquePtr<ECDSA_SIG> sig(ECDSA_SIG_new());
-  if (!(pub_key && key && sig)) {
+  const EC_GROUP* group = EC_KEY_get0_group(ec_key.get());
+  bssl::UniquePtr<EC_POINT> pub_key(EC_POINT_new(group));
+  if (!pub_key) {
     return Status::ResourceExhausted();
   }
 
   // Load the public key.
-  if (!EC_POINT_oct2point(group.get(),
-                          pub_key.get(),
-                          public_key_bytes,
-                          public_key.size(),
-                          nullptr)) {
+  if (!EC_POINT_oct2point(
+          group, pub_key.get(), public_key_bytes, public_key.size(), nullptr)) {
     PW_LOG_DEBUG("Bad public key format");
     return Status::InvalidArgument();
   }
 
-  if (!EC_KEY_set_group(key.get(), group.get())) {
+  // This also checks that the public key is on the curve.
+  if (!EC_KEY_set_public_key(ec_key.get(), pub_key.get())) {
     return Status::InvalidArgument();
   }
 
-  if (!EC_KEY_set_public_key(key.get(), pub_key.get())) {
-    return Status::InvalidArgument();
-  }
+  key.key = std::move(ec_key);
+  return OkStatus();
+}
 
-  // Load the signature.
-  if (signature.size() != kP256CurveOrderBytes * 2) {
-    PW_LOG_DEBUG("Bad signature format");
-    return Status::InvalidArgument();
+Status DoVerifyP256Signature(NativeP256PublicKey& key,
+                             ConstByteSpan digest,
+                             ConstByteSpan signature) {
+  const uint8_t* digest_bytes = reinterpret_cast<const uint8_t*>(digest.data());
+  const uint8_t* signature_bytes =
+      reinterpret_cast<const uint8_t*>(signature.data());
+
+  bssl::UniquePtr<ECDSA_SIG> sig(ECDSA_SIG_new());
+  if (!sig) {
+    return Status::ResourceExhausted();
   }
 
+  // Load the signature.
   if (!(BN_bin2bn(signature_bytes, kP256CurveOrderBytes, sig->r) &&
         BN_bin2bn(signature_bytes + kP256CurveOrderBytes,
                   kP256CurveOrderBytes,
@@ -80,14 +79,8 @@ Status VerifyP256Signature(ConstByteSpan public_key,
     return Status::Internal();
   }
 
-  // Digest must be 32 bytes or longer (and will be truncated).
-  if (digest.size() < kP256CurveOrderBytes) {
-    PW_LOG_DEBUG("Digest is too short");
-    return Status::InvalidArgument();
-  }
-
   // Verify the signature.
-  if (!ECDSA_do_verify(digest_bytes, digest.size(), sig.get(), key.get())) {
+  if (!ECDSA_do_verify(digest_bytes, digest.size(), sig.get(), key.key.get())) {
     PW_LOG_DEBUG("Signature verification failed");
     return Status::Unauthenticated();
   }
@@ -95,4 +88,4 @@ Status VerifyP256Signature(ConstByteSpan public_key,
   return OkStatus();
 }
 
-}  // namespace pw::crypto::ecdsa
+}  // namespace pw::crypto::ecdsa::backend
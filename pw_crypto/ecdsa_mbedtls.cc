@@ -16,95 +16,72 @@
 
 #include "mbedtls/ecdsa.h"
 #include "pw_crypto/ecdsa.h"
-#include "pw_function/function.h"
 #include "pw_log/log.h"
 
-namespace pw::crypto::ecdsa {
-
+namespace pw::crypto::ecdsa::backend {
 namespace {
 
-// Defer calls a given function upon exiting a scope.
-class Defer {
- public:
-  Defer(Function<void()>&& callback) : callback_(std::move(callback)) {}
-  ~Defer() { callback_(); }
+// The signature (r, s), freed on exiting its scope.
+struct Signature {
+  Signature() {
+    mbedtls_mpi_init(&r);
+    mbedtls_mpi_init(&s);
+  }
+
+  ~Signature() {
+    mbedtls_mpi_free(&r);
+    mbedtls_mpi_free(&s);
+  }
 
- private:
-  Function<void()> callback_;
+  mbedtls_mpi r, s;
 };
 
 }  // namespace
 
-constexpr size_t kP256CurveOrderBytes = 32;
-
-Status VerifyP256Signature(ConstByteSpan public_key,
-                           ConstByteSpan digest,
-                           ConstByteSpan signature) {
-  // Use a local structure to avoid going over the default inline storage
-  // for the `cleanup` callable used below.
-  struct {
-    // The elliptic curve group.
-    mbedtls_ecp_group grp;
-    // The public key point.
-    mbedtls_ecp_point Q;
-    // The signature (r, s).
-    mbedtls_mpi r, s;
-  } ctx;
-
+Status DoInitP256PublicKey(NativeP256PublicKey& key, ConstByteSpan public_key) {
   const uint8_t* public_key_data =
       reinterpret_cast<const uint8_t*>(public_key.data());
-  const uint8_t* digest_data = reinterpret_cast<const uint8_t*>(digest.data());
-  const uint8_t* signature_data =
-      reinterpret_cast<const uint8_t*>(signature.data());
-
-  // These init functions never fail.
-  mbedtls_ecp_group_init(&ctx.grp);
-  mbedtls_ecp_point_init(&ctx.Q);
-  mbedtls_mpi_init(&ctx.r);
-  mbedtls_mpi_init(&ctx.s);
-
-  // Auto clean up on exit.
-  Defer cleanup([&ctx](void) {
-    mbedtls_ecp_group_free(&ctx.grp);
-    mbedtls_ecp_point_free(&ctx.Q);
-    mbedtls_mpi_free(&ctx.r);
-    mbedtls_mpi_free(&ctx.s);
-  });
 
   // Load the curve parameters.
-  if (mbedtls_ecp_group_load(&ctx.grp, MBEDTLS_ECP_DP_SECP256R1)) {
+  if (mbedtls_ecp_group_load(&key.group, MBEDTLS_ECP_DP_SECP256R1)) {
     return Status::Internal();
   }
 
   // Load the public key.
   if (mbedtls_ecp_point_read_binary(
-          &ctx.grp, &ctx.Q, public_key_data, public_key.size())) {
+          &key.group, &key.point, public_key_data, public_key.size())) {
     PW_LOG_DEBUG("Bad public key format");
     return Status::InvalidArgument();
   }
 
-  // Load the signature.
-  if (signature.size() != kP256CurveOrderBytes * 2) {
-    PW_LOG_DEBUG("Bad signature format");
+  // Make sure the public key is on the curve.
+  if (mbedtls_ecp_check_pubkey(&key.group, &key.point)) {
+    PW_LOG_DEBUG("Public key is not on the curve");
     return Status::InvalidArgument();
   }
 
-  if (mbedtls_mpi_read_binary(&ctx.r, signature_data, kP256CurveOrderBytes) ||
-      mbedtls_mpi_read_binary(&ctx.s,
+  return OkStatus();
+}
+
+Status DoVerifyP256Signature(NativeP256PublicKey& key,
+                             ConstByteSpan digest,
+                             ConstByteSpan signature) {
+  const uint8_t* digest_data = reinterpret_cast<const uint8_t*>(digest.data());
+  const uint8_t* signature_data =
+      reinterpret_cast<const uint8_t*>(signature.data());
+
+  // Load the signature.
+  Signature sig;
+  if (mbedtls_mpi_read_binary(&sig.r, signature_data, kP256CurveOrderBytes) ||
+      mbedtls_mpi_read_binary(&sig.s,
                               signature_data + kP256CurveOrderBytes,
                               kP256CurveOrderBytes)) {
     return Status::Internal();
   }
 
-  // Digest must be 32 bytes or longer (and be truncated).
-  if (digest.size() < kP256CurveOrderBytes) {
-    PW_LOG_DEBUG("Digest is too short");
-    return Status::InvalidArgument();
-  }
-
   // Verify the signature.
   if (mbedtls_ecdsa_verify(
-          &ctx.grp, digest_data, digest.size(), &ctx.Q, &ctx.r, &ctx.s)) {
+          &key.group, digest_data, digest.size(), &key.point, &sig.r, &sig.s)) {
     PW_LOG_DEBUG("Signature verification failed");
     return Status::Unauthenticated();
   }
@@ -112,4 +89,4 @@ Status VerifyP256Signature(ConstByteSpan public_key,
   return OkStatus();
 }
 
-}  // namespace pw::crypto::ecdsa
+}  // namespace pw::crypto::ecdsa::backend
@@ -159,5 +159,53 @@ TEST(EcdsaP256, TamperedPubkey) {
                                   AS_BYTES(TEST_SIGNATURE)));
 }
 
+TEST(P256PublicKey, VerifiesMultipleSignatures) {
+  P256PublicKey key;
+  ASSERT_OK(key.Init(AS_BYTES(TEST_PUBKEY)));
+
+  // The key's cached state must not be affected by failed verifications.
+  ASSERT_OK(key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+  ASSERT_EQ(Status::Unauthenticated(),
+            key.Verify(AS_BYTES(TAMPERED_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+  ASSERT_EQ(Status::Unauthenticated(),
+            key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(TAMPERED_SIGNATURE)));
+  ASSERT_EQ(Status::InvalidArgument(),
+            key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(SHORT_SIGNATURE)));
+  ASSERT_EQ(Status::InvalidArgument(),
+            key.Verify(AS_BYTES(SHORT_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+  ASSERT_OK(key.Verify(AS_BYTES(TEST_DIGEST "extra stuff"),
+                       AS_BYTES(TEST_SIGNATURE)));
+}
+
+TEST(P256PublicKey, VerifyWithoutInit) {
+  P256PublicKey key;
+  ASSERT_EQ(Status::FailedPrecondition(),
+            key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+}
+
+TEST(P256PublicKey, InitTwice) {
+  P256PublicKey key;
+  ASSERT_OK(key.Init(AS_BYTES(TEST_PUBKEY)));
+  ASSERT_EQ(Status::FailedPrecondition(), key.Init(AS_BYTES(TEST_PUBKEY)));
+  ASSERT_OK(key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+}
+
+TEST(P256PublicKey, MalformedPublicKey) {
+  P256PublicKey key;
+  ASSERT_EQ(Status::InvalidArgument(),
+            key.Init(AS_BYTES(MALFORMED_PUBKEY_MISSING_HEADER)));
+  ASSERT_EQ(Status::FailedPrecondition(),
+            key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+
+  // A failed Init() may be retried.
+  ASSERT_OK(key.Init(AS_BYTES(TEST_PUBKEY)));
+  ASSERT_OK(key.Verify(AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+}
+
+TEST(P256PublicKey, TamperedPubkey) {
+  P256PublicKey key;
+  ASSERT_FAIL(key.Init(AS_BYTES(TAMPERED_PUBKEY)));
+}
+
 }  // namespace
 }  // namespace pw::crypto::ecdsa
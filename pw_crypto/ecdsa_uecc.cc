@@ -14,56 +14,47 @@
 #define PW_LOG_MODULE_NAME "ECDSA"
 #define PW_LOG_LEVEL PW_LOG_LEVEL_WARN
 
+#include <cstring>
+
 #include "pw_crypto/ecdsa.h"
 #include "pw_log/log.h"
 #include "uECC.h"
 
-namespace pw::crypto::ecdsa {
-
-constexpr size_t kP256CurveOrderBytes = 32;
+namespace pw::crypto::ecdsa::backend {
 
-Status VerifyP256Signature(ConstByteSpan public_key,
-                           ConstByteSpan digest,
-                           ConstByteSpan signature) {
+Status DoInitP256PublicKey(NativeP256PublicKey& key, ConstByteSpan public_key) {
   const uint8_t* public_key_bytes =
       reinterpret_cast<const uint8_t*>(public_key.data());
-  const uint8_t* digest_bytes = reinterpret_cast<const uint8_t*>(digest.data());
-  const uint8_t* signature_bytes =
-      reinterpret_cast<const uint8_t*>(signature.data());
-
-  uECC_Curve curve = uECC_secp256r1();
 
   // Supports SEC 1 uncompressed form (04||X||Y) only.
-  if (public_key.size() != (2 * kP256CurveOrderBytes + 1) ||
+  if (public_key.size() != (sizeof(key.point) + 1) ||
       public_key_bytes[0] != 0x04) {
     PW_LOG_DEBUG("Bad public key format");
     return Status::InvalidArgument();
   }
 
   // Make sure the public key is on the curve.
-  if (!uECC_valid_public_key(public_key_bytes + 1, curve)) {
+  if (!uECC_valid_public_key(public_key_bytes + 1, uECC_secp256r1())) {
     return Status::InvalidArgument();
   }
 
-  // Signature expected in raw format (r||s)
-  if (signature.size() != kP256CurveOrderBytes * 2) {
-    PW_LOG_DEBUG("Bad signature format");
-    return Status::InvalidArgument();
-  }
+  std::memcpy(key.point, public_key_bytes + 1, sizeof(key.point));
+  return OkStatus();
+}
 
-  // Digests must be at least 32 bytes. Digests longer than 32
-  // bytes are truncated to 32 bytes.
-  if (digest.size() < kP256CurveOrderBytes) {
-    PW_LOG_DEBUG("Digest is too short");
-    return Status::InvalidArgument();
-  }
+Status DoVerifyP256Signature(NativeP256PublicKey& key,
+                             ConstByteSpan digest,
+                             ConstByteSpan signature) {
+  const uint8_t* digest_bytes = reinterpret_cast<const uint8_t*>(digest.data());
+  const uint8_t* signature_bytes =
+      reinterpret_cast<const uint8_t*>(signature.data());
 
   // Verify the signature.
-  if (!uECC_verify(public_key_bytes + 1,
+  if (!uECC_verify(key.point,
                    digest_bytes,
                    digest.size(),
                    signature_bytes,
-                   curve)) {
+                   uECC_secp256r1())) {
     PW_LOG_DEBUG("Signature verification failed");
     return Status::Unauthenticated();
   }
@@ -71,4 +62,4 @@ Status VerifyP256Signature(ConstByteSpan public_key,
   return OkStatus();
 }
 
-}  // namespace pw::crypto::ecdsa
+}  // namespace pw::crypto::ecdsa::backend
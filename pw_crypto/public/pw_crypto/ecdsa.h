@@ -14,11 +14,107 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "pw_bytes/span.h"
+#include "pw_crypto/ecdsa_backend.h"
+#include "pw_log/log.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
 
 namespace pw::crypto::ecdsa {
 
+// Size in bytes of the P256 curve order, and so of a digest and of each of the
+// two halves of a signature.
+constexpr size_t kP256CurveOrderBytes = 32;
+
+namespace backend {
+
+// Primitive operations to be implemented by backends. The front end checks
+// the sizes of the digest and the signature before calling DoVerify.
+Status DoInitP256PublicKey(NativeP256PublicKey& key, ConstByteSpan public_key);
+Status DoVerifyP256Signature(NativeP256PublicKey& key,
+                             ConstByteSpan digest,
+                             ConstByteSpan signature);
+
+}  // namespace backend
+
+// P256PublicKey verifies any number of signatures with one public key. The key
+// is parsed and checked to be on the curve once, in Init(), and the backend
+// keeps whatever state it can reuse across verifications. Use it to verify
+// several signatures with the same key, such as the root keys of an update
+// bundle, instead of calling VerifyP256Signature() for each.
+//
+// Usage:
+//
+// P256PublicKey key;
+// if (!key.Init(public_key).ok()) {
+//   // Error handling.
+// }
+// if (!key.Verify(digest, signature).ok()) {
+//   // Error handling.
+// }
+class P256PublicKey {
+ public:
+  P256PublicKey() : initialized_(false) {}
+
+  P256PublicKey(const P256PublicKey&) = delete;
+  P256PublicKey& operator=(const P256PublicKey&) = delete;
+
+  // Init loads `public_key`, a byte string in SEC 1 uncompressed form
+  // (0x04||X||Y), which is exactly 65 bytes. Compressed forms (02/03||X) *may*
+  // not be supported by some backends, e.g. Mbed TLS.
+  //
+  // Returns:
+  // OK - The key is loaded.
+  // INVALID_ARGUMENT - The key is malformed or not on the curve.
+  // FAILED_PRECONDITION - A key was already loaded.
+  // Other errors from the backend, e.g. RESOURCE_EXHAUSTED.
+  Status Init(ConstByteSpan public_key) {
+    if (initialized_) {
+      return Status::FailedPrecondition();
+    }
+    PW_TRY(backend::DoInitP256PublicKey(native_key_, public_key));
+    initialized_ = true;
+    return OkStatus();
+  }
+
+  // Verify verifies the `signature` of `digest`, as VerifyP256Signature()
+  // does. Verifying may update state cached by the backend, so it is not
+  // const, and one key may not be used by several threads at once.
+  //
+  // Returns:
+  // OK - The signature is valid.
+  // UNAUTHENTICATED - The signature does not match the digest and the key.
+  // INVALID_ARGUMENT - The digest or the signature is malformed.
+  // FAILED_PRECONDITION - No key is loaded.
+  Status Verify(ConstByteSpan digest, ConstByteSpan signature) {
+    if (!initialized_) {
+      return Status::FailedPrecondition();
+    }
+
+    // Signature expected in raw format (r||s).
+    if (signature.size() != kP256CurveOrderBytes * 2) {
+      PW_LOG_DEBUG("Bad signature format");
+      return Status::InvalidArgument();
+    }
+
+    // Digests must be at least 32 bytes. Digests longer than 32 bytes are
+    // truncated to 32 bytes.
+    if (digest.size() < kP256CurveOrderBytes) {
+      PW_LOG_DEBUG("Digest is too short");
+      return Status::InvalidArgument();
+    }
+
+    return backend::DoVerifyP256Signature(native_key_, digest, signature);
+  }
+
+ private:
+  bool initialized_;
+  // Backend-specific key and curve state.
+  backend::NativeP256PublicKey native_key_;
+};
+
 // VerifyP256Signature verifies the `signature` of `digest` using `public_key`.
 //
 // `public_key` is a byte string in SEC 1 uncompressed form (0x04||X||Y), which
@@ -29,10 +125,17 @@ namespace pw::crypto::ecdsa {
 //
 // `signature` is a raw byte string (r||s) of exactly 64 bytes.
 //
+// The key is parsed on each call. To verify several signatures with the same
+// key, use a P256PublicKey.
+//
 // Returns Status::OkStatus() for a successful verification, or an error Status
 // otherwise.
-Status VerifyP256Signature(ConstByteSpan public_key,
-                           ConstByteSpan digest,
-                           ConstByteSpan signature);
+inline Status VerifyP256Signature(ConstByteSpan public_key,
+                                  ConstByteSpan digest,
+                                  ConstByteSpan signature) {
+  P256PublicKey key;
+  PW_TRY(key.Init(public_key));
+  return key.Verify(digest, signature);
+}
 
 }  // namespace pw::crypto::ecdsa
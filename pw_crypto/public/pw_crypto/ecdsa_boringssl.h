@@ -0,0 +1,26 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "openssl/ec_key.h"
+
+namespace pw::crypto::ecdsa::backend {
+
+// BoringSSL's built-in P256 group has precomputed tables for the base point,
+// so only the parsed key needs to be kept.
+struct NativeP256PublicKey {
+  bssl::UniquePtr<EC_KEY> key;
+};
+
+}  // namespace pw::crypto::ecdsa::backend
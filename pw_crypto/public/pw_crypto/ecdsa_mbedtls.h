@@ -0,0 +1,41 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "mbedtls/ecp.h"
+
+namespace pw::crypto::ecdsa::backend {
+
+// The curve group is kept with the key. With MBEDTLS_ECP_FIXED_POINT_OPTIM,
+// Mbed TLS caches the precomputed comb table for the curve's base point in the
+// group, so the table is built by the first verification and reused after.
+struct NativeP256PublicKey {
+  NativeP256PublicKey() {
+    mbedtls_ecp_group_init(&group);
+    mbedtls_ecp_point_init(&point);
+  }
+
+  NativeP256PublicKey(const NativeP256PublicKey&) = delete;
+  NativeP256PublicKey& operator=(const NativeP256PublicKey&) = delete;
+
+  ~NativeP256PublicKey() {
+    mbedtls_ecp_group_free(&group);
+    mbedtls_ecp_point_free(&point);
+  }
+
+  mbedtls_ecp_group group;
+  mbedtls_ecp_point point;
+};
+
+}  // namespace pw::crypto::ecdsa::backend
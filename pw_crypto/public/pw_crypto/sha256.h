@@ -14,9 +14,6 @@
 
 #pragma once
 
-#define PW_LOG_MODULE_NAME "SHA256"
-#define PW_LOG_LEVEL PW_LOG_LEVEL_WARN
-
 #include <cstdint>
 
 #include "pw_bytes/span.h"
@@ -26,6 +23,15 @@
 #include "pw_status/try.h"
 #include "pw_stream/stream.h"
 
+// Backends for hash engines that consume input asynchronously, for example by
+// DMA, define this to 1 in their sha256_backend.h. Such a backend may return
+// from DoUpdate() before it has finished reading the data, so callers must
+// leave the data passed to Update() unchanged until the next Update() or
+// Final() call. See the pw_crypto docs for details.
+#ifndef PW_CRYPTO_SHA256_ASYNC_UPDATE
+#define PW_CRYPTO_SHA256_ASYNC_UPDATE 0
+#endif  // PW_CRYPTO_SHA256_ASYNC_UPDATE
+
 namespace pw::crypto::sha256 {
 
 // Size in bytes of a SHA256 digest.
@@ -134,14 +140,29 @@ inline Status Hash(ConstByteSpan message, ByteSpan out_digest) {
   return Sha256().Update(message).Final(out_digest);
 }
 
-inline Status Hash(stream::Reader& reader, ByteSpan out_digest) {
-  if (out_digest.size() < kDigestSizeBytes) {
+// Hash calculates the SHA256 digest of the data from `reader`, reading it into
+// `read_buffer`. Larger buffers mean fewer, larger reads and updates, which
+// matters for long messages such as firmware images.
+//
+// If the backend hashes asynchronously (PW_CRYPTO_SHA256_ASYNC_UPDATE), the
+// buffer is used as two halves that are filled in turn, so that the backend
+// hashes one half while the next is read.
+inline Status Hash(stream::Reader& reader,
+                   ByteSpan out_digest,
+                   ByteSpan read_buffer) {
+  const size_t chunk_size = PW_CRYPTO_SHA256_ASYNC_UPDATE
+                                ? read_buffer.size() / 2
+                                : read_buffer.size();
+  if (out_digest.size() < kDigestSizeBytes || chunk_size == 0u) {
     return Status::InvalidArgument();
   }
 
+  // Offset of the half to read into after the first; 0 if not alternating.
+  const size_t second_offset = PW_CRYPTO_SHA256_ASYNC_UPDATE ? chunk_size : 0;
+
   Sha256 sha256;
-  while (true) {
-    Result<ByteSpan> res = reader.Read(out_digest);
+  for (size_t offset = 0;; offset = second_offset - offset) {
+    Result<ByteSpan> res = reader.Read(read_buffer.subspan(offset, chunk_size));
     if (res.status().IsOutOfRange()) {
       break;
     }
@@ -153,4 +174,14 @@ inline Status Hash(stream::Reader& reader, ByteSpan out_digest) {
   return sha256.Final(out_digest);
 }
 
+// Hash calculates the SHA256 digest of the data from `reader`, using
+// `out_digest` as the read buffer. For long messages, prefer the overload that
+// takes a larger read buffer.
+inline Status Hash(stream::Reader& reader, ByteSpan out_digest) {
+  if (out_digest.size() < kDigestSizeBytes) {
+    return Status::InvalidArgument();
+  }
+  return Hash(reader, out_digest, out_digest.first(kDigestSizeBytes));
+}
+
 }  // namespace pw::crypto::sha256
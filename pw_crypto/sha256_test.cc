@@ -14,6 +14,7 @@
 
 #include "pw_crypto/sha256.h"
 
+#include <array>
 #include <cstring>
 
 #include "gtest/gtest.h"
@@ -56,6 +57,25 @@ TEST(Hash, ComputesCorrectDigestFromReader) {
             std::memcmp(digest, SHA256_HASH_OF_HELLO_PIGWEED, sizeof(digest)));
 }
 
+TEST(Hash, ComputesCorrectDigestFromReaderWithReadBuffer) {
+  std::byte digest[kDigestSizeBytes];
+  ConstByteSpan message = AS_BYTES("Hello, Pigweed!");
+
+  // The message is read in several chunks.
+  std::array<std::byte, 4> read_buffer;
+  stream::MemoryReader reader(message);
+  ASSERT_OK(Hash(reader, digest, read_buffer));
+  ASSERT_EQ(0,
+            std::memcmp(digest, SHA256_HASH_OF_HELLO_PIGWEED, sizeof(digest)));
+}
+
+TEST(Hash, ReadBufferTooSmall) {
+  std::byte digest[kDigestSizeBytes];
+  ConstByteSpan empty;
+  stream::MemoryReader reader(empty);
+  ASSERT_FAIL(Hash(reader, digest, ByteSpan()));
+}
+
 TEST(Hash, ComputesCorrectDigestOnEmptyMessage) {
   std::byte digest[kDigestSizeBytes];
 
@@ -16,8 +16,10 @@
 
 #include "pw_file/flat_file_system.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <span>
 #include <string_view>
 
@@ -31,45 +33,194 @@
 #include "pw_rpc/raw/server_reader_writer.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
 
 namespace pw::file {
 
 using Entry = FlatFileSystemService::Entry;
 
-Status FlatFileSystemService::EnumerateFile(
-    Entry& entry, pw::file::ListResponse::StreamEncoder& output_encoder) {
-  StatusWithSize sws = entry.Name(file_name_buffer_);
-  if (!sws.ok()) {
-    return sws.status();
+namespace {
+
+constexpr size_t SizeOfVarintField(uint32_t field_number, uint64_t value) {
+  return protobuf::SizeOfField(
+      field_number, protobuf::WireType::kVarint, varint::EncodedSize(value));
+}
+
+// Room for the next_cursor field that ends a page.
+constexpr size_t kNextCursorSizeBytes = SizeOfVarintField(
+    static_cast<uint32_t>(pw::file::ListResponse::Fields::NEXT_CURSOR),
+    std::numeric_limits<uint32_t>::max());
+
+}  // namespace
+
+void FlatFileSystemService::InvalidateCache(Entry::Id file_id) {
+  const size_t cached = std::min(entries_.size(), entry_cache_.size());
+  for (size_t i = 0; i < cached; ++i) {
+    if (entries_[i]->FileId() == file_id) {
+      entry_cache_[i].state = CachedEntry::State::kUnknown;
+      entry_cache_[i].has_size = false;
+    }
+  }
+}
+
+void FlatFileSystemService::InvalidateCache() {
+  for (CachedEntry& cached : entry_cache_) {
+    cached.state = CachedEntry::State::kUnknown;
+    cached.has_size = false;
+  }
+}
+
+Result<std::string_view> FlatFileSystemService::EntryName(size_t index) {
+  Entry& entry = *entries_[index];
+
+  if (index >= entry_cache_.size()) {
+    StatusWithSize sws = entry.Name(file_name_buffer_);
+    PW_TRY(sws.status());
+    return std::string_view(file_name_buffer_.data(), sws.size());
   }
-  {
-    pw::file::Path::StreamEncoder encoder = output_encoder.GetPathsEncoder();
 
-    encoder.WritePath(reinterpret_cast<const char*>(file_name_buffer_.data()),
-                      sws.size());
-    encoder.WriteSizeBytes(entry.SizeBytes());
-    encoder.WritePermissions(entry.Permissions());
-    encoder.WriteFileId(entry.FileId());
+  CachedEntry& cached = entry_cache_[index];
+  std::span<char> name_slot = name_cache_.subspan(
+      index * file_name_buffer_.size(), file_name_buffer_.size());
+
+  if (cached.state == CachedEntry::State::kUnknown) {
+    StatusWithSize sws = entry.Name(name_slot);
+    if (sws.IsNotFound()) {
+      cached.state = CachedEntry::State::kNotFound;
+    } else {
+      PW_TRY(sws.status());  // Other errors are not cached.
+      cached.state = CachedEntry::State::kNamed;
+      cached.name_size = static_cast<uint16_t>(sws.size());
+    }
+  }
+
+  if (cached.state == CachedEntry::State::kNotFound) {
+    return Status::NotFound();
   }
-  return output_encoder.status();
+  return std::string_view(name_slot.data(), cached.name_size);
 }
 
-void FlatFileSystemService::EnumerateAllFiles(RawServerWriter& writer) {
-  for (Entry* entry : entries_) {
-    PW_DCHECK_NOTNULL(entry);
-    // For now, don't try to pack entries.
-    pw::file::ListResponse::MemoryEncoder encoder(writer.PayloadBuffer());
-    if (Status status = EnumerateFile(*entry, encoder); !status.ok()) {
+size_t FlatFileSystemService::EntrySizeBytes(size_t index) {
+  if (index >= entry_cache_.size()) {
+    return entries_[index]->SizeBytes();
+  }
+
+  CachedEntry& cached = entry_cache_[index];
+  if (!cached.has_size) {
+    cached.size_bytes = static_cast<uint32_t>(entries_[index]->SizeBytes());
+    cached.has_size = true;
+  }
+  return cached.size_bytes;
+}
+
+Status FlatFileSystemService::EnumerateFile(
+    size_t index,
+    std::string_view prefix,
+    size_t max_size,
+    pw::file::ListResponse::MemoryEncoder& encoder) {
+  PW_DCHECK_NOTNULL(entries_[index]);
+  Entry& entry = *entries_[index];
+
+  Result<std::string_view> name = EntryName(index);
+  if (!name.ok()) {
+    if (!name.status().IsNotFound()) {
       PW_LOG_ERROR("Failed to enumerate file (id: %u) with status %d",
-                   static_cast<unsigned>(entry->FileId()),
-                   static_cast<int>(status.code()));
-      continue;
+                   static_cast<unsigned>(entry.FileId()),
+                   static_cast<int>(name.status().code()));
     }
+    return Status::NotFound();
+  }
+
+  // Check the prefix before reading anything else from the entry.
+  if (name->substr(0, prefix.size()) != prefix) {
+    return Status::NotFound();
+  }
 
-    Status write_status = writer.Write(encoder);
-    if (!write_status.ok()) {
-      writer.Finish(write_status);
-      return;
+  const size_t size_bytes = EntrySizeBytes(index);
+  const Entry::FilePermissions permissions = entry.Permissions();
+  const Entry::Id file_id = entry.FileId();
+
+  const size_t path_size =
+      protobuf::SizeOfField(static_cast<uint32_t>(Path::Fields::PATH),
+                            protobuf::WireType::kDelimited,
+                            name->size()) +
+      SizeOfVarintField(static_cast<uint32_t>(Path::Fields::SIZE_BYTES),
+                        size_bytes) +
+      SizeOfVarintField(static_cast<uint32_t>(Path::Fields::PERMISSIONS),
+                        static_cast<uint64_t>(permissions)) +
+      SizeOfVarintField(static_cast<uint32_t>(Path::Fields::FILE_ID), file_id);
+  if (encoder.size() +
+          protobuf::SizeOfField(
+              static_cast<uint32_t>(pw::file::ListResponse::Fields::PATHS),
+              protobuf::WireType::kDelimited,
+              path_size) >
+      max_size) {
+    return Status::ResourceExhausted();
+  }
+
+  {
+    pw::file::Path::StreamEncoder path_encoder =
+        encoder.GetPathsEncoder(path_size);
+    path_encoder.WritePath(name->data(), name->size());
+    path_encoder.WriteSizeBytes(size_bytes);
+    path_encoder.WritePermissions(permissions);
+    path_encoder.WriteFileId(file_id);
+  }
+  return encoder.status();
+}
+
+void FlatFileSystemService::EnumerateFiles(std::string_view prefix,
+                                           size_t cursor,
+                                           size_t max_paths,
+                                           RawServerWriter& writer) {
+  size_t index = cursor;
+  size_t listed = 0;
+
+  // Pack as many paths as fit into each response.
+  while (index < entries_.size()) {
+    const ByteSpan payload = writer.PayloadBuffer();
+    const size_t max_size =
+        payload.size() - (max_paths == 0 ? 0 : kNextCursorSizeBytes);
+    pw::file::ListResponse::MemoryEncoder encoder(payload);
+    size_t paths_in_response = 0;
+
+    for (; index < entries_.size(); ++index) {
+      if (max_paths != 0 && listed == max_paths) {
+        break;
+      }
+
+      const Status status = EnumerateFile(index, prefix, max_size, encoder);
+      if (status.IsResourceExhausted()) {
+        if (paths_in_response != 0) {
+          break;  // Send this response and continue in the next one.
+        }
+        PW_LOG_ERROR("File (id: %u) does not fit in a response",
+                     static_cast<unsigned>(entries_[index]->FileId()));
+        continue;
+      }
+      if (!status.ok()) {
+        continue;
+      }
+      paths_in_response += 1;
+      listed += 1;
+    }
+
+    const bool page_full =
+        max_paths != 0 && listed == max_paths && index < entries_.size();
+    if (page_full) {
+      encoder.WriteNextCursor(static_cast<uint32_t>(index));
+    }
+
+    if (paths_in_response != 0 || page_full) {
+      if (Status status = writer.Write(encoder); !status.ok()) {
+        writer.Finish(status);
+        return;
+      }
+    }
+
+    if (page_full) {
+      break;
     }
   }
   writer.Finish(OkStatus());
@@ -78,41 +229,62 @@ void FlatFileSystemService::EnumerateAllFiles(RawServerWriter& writer) {
 void FlatFileSystemService::List(ServerContext&,
                                  ConstByteSpan request,
                                  RawServerWriter& writer) {
+  std::string_view prefix;
+  uint32_t max_paths = 0;
+  uint32_t cursor = 0;
+
   protobuf::Decoder decoder(request);
-  // If a file name was provided, try and find and enumerate the file.
   while (decoder.Next().ok()) {
-    if (decoder.FieldNumber() !=
-        static_cast<uint32_t>(pw::file::ListRequest::Fields::PATH)) {
-      continue;
-    }
+    switch (static_cast<pw::file::ListRequest::Fields>(decoder.FieldNumber())) {
+      case pw::file::ListRequest::Fields::PATH: {
+        std::string_view file_name_view;
+        if (!decoder.ReadString(&file_name_view).ok() ||
+            file_name_view.length() == 0) {
+          writer.Finish(Status::DataLoss());
+          return;
+        }
 
-    std::string_view file_name_view;
-    if (!decoder.ReadString(&file_name_view).ok() ||
-        file_name_view.length() == 0) {
-      writer.Finish(Status::DataLoss());
-      return;
-    }
+        // Find and enumerate the file requested.
+        Result<size_t> result = FindFile(file_name_view);
+        if (!result.ok()) {
+          writer.Finish(result.status());
+          return;
+        }
 
-    // Find and enumerate the file requested.
-    Result<Entry*> result = FindFile(file_name_view);
-    if (!result.ok()) {
-      writer.Finish(result.status());
-      return;
-    }
+        pw::file::ListResponse::MemoryEncoder encoder(writer.PayloadBuffer());
+        Status proto_encode_status = EnumerateFile(
+            result.value(), "", writer.PayloadBuffer().size(), encoder);
+        if (!proto_encode_status.ok()) {
+          writer.Finish(proto_encode_status);
+          return;
+        }
 
-    pw::file::ListResponse::MemoryEncoder encoder(writer.PayloadBuffer());
-    Status proto_encode_status = EnumerateFile(*result.value(), encoder);
-    if (!proto_encode_status.ok()) {
-      writer.Finish(proto_encode_status);
-      return;
+        writer.Finish(writer.Write(encoder));
+        return;
+      }
+      case pw::file::ListRequest::Fields::PREFIX:
+        if (!decoder.ReadString(&prefix).ok()) {
+          writer.Finish(Status::DataLoss());
+          return;
+        }
+        break;
+      case pw::file::ListRequest::Fields::MAX_PATHS:
+        if (!decoder.ReadUint32(&max_paths).ok()) {
+          writer.Finish(Status::DataLoss());
+          return;
+        }
+        break;
+      case pw::file::ListRequest::Fields::CURSOR:
+        if (!decoder.ReadUint32(&cursor).ok()) {
+          writer.Finish(Status::DataLoss());
+          return;
+        }
+        break;
     }
-
-    writer.Finish(writer.Write(encoder));
-    return;
   }
 
-  // If no path was provided in the ListRequest, just enumerate everything.
-  EnumerateAllFiles(writer);
+  // If no path was provided in the ListRequest, list every matching file.
+  EnumerateFiles(prefix, cursor, max_paths, writer);
 }
 
 StatusWithSize FlatFileSystemService::Delete(ServerContext&,
@@ -134,40 +306,38 @@ StatusWithSize FlatFileSystemService::Delete(ServerContext&,
   return StatusWithSize(Status::InvalidArgument(), 0);
 }
 
-Result<Entry*> FlatFileSystemService::FindFile(std::string_view file_name) {
-  Status search_status;
-  for (Entry* entry : entries_) {
-    PW_DCHECK_NOTNULL(entry);
-    StatusWithSize sws = entry->Name(file_name_buffer_);
+Result<size_t> FlatFileSystemService::FindFile(std::string_view file_name) {
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    PW_DCHECK_NOTNULL(entries_[i]);
+    Result<std::string_view> name = EntryName(i);
 
-    // If there not an exact file name length match, don't try and check against
-    // a prefix.
-    if (!sws.ok() || file_name.length() != sws.size()) {
-      if (sws.status() != Status::NotFound()) {
+    if (!name.ok()) {
+      if (!name.status().IsNotFound()) {
         PW_LOG_ERROR("Failed to read file name (id: %u) with status %d",
-                     static_cast<unsigned>(entry->FileId()),
-                     static_cast<int>(sws.status().code()));
+                     static_cast<unsigned>(entries_[i]->FileId()),
+                     static_cast<int>(name.status().code()));
       }
       continue;
     }
 
-    if (memcmp(file_name.data(), file_name_buffer_.data(), file_name.size()) ==
-        0) {
-      return entry;
+    if (name.value() == file_name) {
+      return i;
     }
   }
 
-  search_status.Update(Status::NotFound());
-  return search_status;
+  return Status::NotFound();
 }
 
 Status FlatFileSystemService::FindAndDeleteFile(std::string_view file_name) {
-  Result<Entry*> result = FindFile(file_name);
+  Result<size_t> result = FindFile(file_name);
   if (!result.ok()) {
     return result.status();
   }
 
-  return result.value()->Delete();
+  Entry& entry = *entries_[result.value()];
+  Status status = entry.Delete();
+  InvalidateCache(entry.FileId());
+  return status;
 }
 
 }  // namespace pw::file
@@ -17,6 +17,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <span>
 #include <string_view>
 
@@ -224,5 +225,182 @@ TEST(FlatFileSystem, List_FileMissingName) {
   EXPECT_EQ(2u, ValidateExpectedPaths(static_file_system, ctx.responses()));
 }
 
+// Counts calls to read entry metadata.
+class CountingFile : public FakeFile {
+ public:
+  using FakeFile::FakeFile;
+
+  StatusWithSize Name(std::span<char> dest) override {
+    name_reads += 1;
+    return FakeFile::Name(dest);
+  }
+
+  size_t SizeBytes() override {
+    size_reads += 1;
+    return FakeFile::SizeBytes();
+  }
+
+  size_t name_reads = 0;
+  size_t size_reads = 0;
+};
+
+size_t CountPaths(const rpc::PayloadsView& results) {
+  size_t count = 0;
+  for (ConstByteSpan response : results) {
+    protobuf::Decoder decoder(response);
+    while (decoder.Next().ok()) {
+      if (decoder.FieldNumber() ==
+          static_cast<uint32_t>(pw::file::ListResponse::Fields::PATHS)) {
+        count += 1;
+      }
+    }
+  }
+  return count;
+}
+
+std::optional<uint32_t> NextCursor(const rpc::PayloadsView& results) {
+  std::optional<uint32_t> cursor;
+  for (ConstByteSpan response : results) {
+    protobuf::Decoder decoder(response);
+    while (decoder.Next().ok()) {
+      if (decoder.FieldNumber() ==
+          static_cast<uint32_t>(pw::file::ListResponse::Fields::NEXT_CURSOR)) {
+        uint32_t value;
+        EXPECT_EQ(OkStatus(), decoder.ReadUint32(&value));
+        cursor = value;
+      }
+    }
+  }
+  return cursor;
+}
+
+TEST(FlatFileSystem, List_PathsPackedIntoOneResponse) {
+  std::array<char, 10> file_name_buffer;
+  std::array<FakeFile, 3> files{
+      {{"SNAP_001", 372, 9}, {"tokens.csv", 808, 15038202}, {"a.txt", 0, 2}}};
+  std::array<FlatFileSystemService::Entry*, 3> static_file_system{
+      &files[0], &files[1], &files[2]};
+
+  PW_RAW_TEST_METHOD_CONTEXT(FlatFileSystemService, List)
+  ctx(static_file_system, file_name_buffer);
+  ctx.call(ConstByteSpan());
+
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(1u, ctx.responses().size());
+  EXPECT_EQ(3u, ValidateExpectedPaths(static_file_system, ctx.responses()));
+}
+
+TEST(FlatFileSystem, List_Prefix) {
+  std::array<char, 10> file_name_buffer;
+  std::array<CountingFile, 4> files{{{"SNAP_001", 372, 9},
+                                     {"tokens.csv", 808, 10},
+                                     {"SNAP_002", 12, 11},
+                                     {"", 0, 12}}};
+  std::array<FlatFileSystemService::Entry*, 4> static_file_system{
+      &files[0], &files[1], &files[2], &files[3]};
+
+  std::array<std::byte, 32> request;
+  pw::file::ListRequest::MemoryEncoder encoder(request);
+  ASSERT_EQ(OkStatus(), encoder.WritePrefix("SNAP_"));
+
+  PW_RAW_TEST_METHOD_CONTEXT(FlatFileSystemService, List)
+  ctx(static_file_system, file_name_buffer);
+  ctx.call(encoder);
+
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(2u, CountPaths(ctx.responses()));
+
+  // The sizes of files that do not match are not read.
+  EXPECT_EQ(1u, files[0].size_reads);
+  EXPECT_EQ(0u, files[1].size_reads);
+  EXPECT_EQ(1u, files[2].size_reads);
+}
+
+TEST(FlatFileSystem, List_Pages) {
+  std::array<char, 10> file_name_buffer;
+  std::array<FakeFile, 4> files{{{"a", 1, 1},
+                                 {"", 0, 2},
+                                 {"b", 2, 3},
+                                 {"c", 3, 4}}};
+  std::array<FlatFileSystemService::Entry*, 4> static_file_system{
+      &files[0], &files[1], &files[2], &files[3]};
+
+  std::array<std::byte, 32> request;
+  {
+    pw::file::ListRequest::MemoryEncoder encoder(request);
+    ASSERT_EQ(OkStatus(), encoder.WriteMaxPaths(2));
+
+    PW_RAW_TEST_METHOD_CONTEXT(FlatFileSystemService, List)
+    ctx(static_file_system, file_name_buffer);
+    ctx.call(encoder);
+
+    EXPECT_EQ(OkStatus(), ctx.status());
+    EXPECT_EQ(2u, CountPaths(ctx.responses()));
+    ASSERT_TRUE(NextCursor(ctx.responses()).has_value());
+    EXPECT_EQ(3u, NextCursor(ctx.responses()).value());
+  }
+  {
+    pw::file::ListRequest::MemoryEncoder encoder(request);
+    ASSERT_EQ(OkStatus(), encoder.WriteMaxPaths(2));
+    ASSERT_EQ(OkStatus(), encoder.WriteCursor(3));
+
+    PW_RAW_TEST_METHOD_CONTEXT(FlatFileSystemService, List)
+    ctx(static_file_system, file_name_buffer);
+    ctx.call(encoder);
+
+    EXPECT_EQ(OkStatus(), ctx.status());
+    EXPECT_EQ(1u, CountPaths(ctx.responses()));
+    EXPECT_FALSE(NextCursor(ctx.responses()).has_value());
+  }
+}
+
+using CachedFileSystem = FlatFileSystemServiceWithCache<4, 10>;
+
+TEST(FlatFileSystem, CachedList_ReadsEntriesOnce) {
+  std::array<CountingFile, 3> files{
+      {{"SNAP_001", 372, 9}, {"tokens.csv", 808, 10}, {"", 0, 11}}};
+  std::array<FlatFileSystemService::Entry*, 3> static_file_system{
+      &files[0], &files[1], &files[2]};
+
+  PW_RAW_TEST_METHOD_CONTEXT(CachedFileSystem, List)
+  ctx(static_file_system);
+  ctx.call(ConstByteSpan());
+  ctx.call(ConstByteSpan());
+
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(2u, CountPaths(ctx.responses()));
+  for (const CountingFile& file : files) {
+    EXPECT_EQ(1u, file.name_reads);
+  }
+  EXPECT_EQ(1u, files[0].size_reads);
+  EXPECT_EQ(1u, files[1].size_reads);
+
+  ctx.service().InvalidateCache(10);
+  ctx.call(ConstByteSpan());
+  EXPECT_EQ(1u, files[0].name_reads);
+  EXPECT_EQ(2u, files[1].name_reads);
+  EXPECT_EQ(2u, files[1].size_reads);
+
+  EXPECT_EQ(2u, ValidateExpectedPaths(static_file_system, ctx.responses()));
+}
+
+TEST(FlatFileSystem, CachedList_MoreEntriesThanCache) {
+  std::array<CountingFile, 3> files{{{"a", 1, 1}, {"b", 2, 2}, {"c", 3, 3}}};
+  std::array<FlatFileSystemService::Entry*, 3> static_file_system{
+      &files[0], &files[1], &files[2]};
+
+  using SmallCache = FlatFileSystemServiceWithCache<2, 10>;
+  PW_RAW_TEST_METHOD_CONTEXT(SmallCache, List)
+  ctx(static_file_system);
+  ctx.call(ConstByteSpan());
+  ctx.call(ConstByteSpan());
+
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(3u, CountPaths(ctx.responses()));
+  EXPECT_EQ(1u, files[0].name_reads);
+  EXPECT_EQ(1u, files[1].name_reads);
+  EXPECT_EQ(2u, files[2].name_reads);
+}
+
 }  // namespace
 }  // namespace pw::file
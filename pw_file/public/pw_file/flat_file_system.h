@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <span>
@@ -32,6 +33,11 @@ namespace pw::file {
 // has a strict limitation that everything is treated as if the file system
 // was "flat" (i.e. no directories). This means there's no concept of logical
 // directories, despite any "path like" naming that may be employed by a user.
+//
+// Listings are packed into as few responses as fit the RPC payload buffer, and
+// may be filtered by name prefix and split into pages with a cursor. To avoid
+// reading every entry on every request, use FlatFileSystemServiceWithCache,
+// which caches each entry's name and size.
 class FlatFileSystemService
     : public generated::FileSystem<FlatFileSystemService> {
  public:
@@ -83,7 +89,7 @@ class FlatFileSystemService
   //     The span's underlying buffer must outlive this object.
   FlatFileSystemService(std::span<Entry*> entry_list,
                         std::span<char> file_name_buffer)
-      : file_name_buffer_(file_name_buffer), entries_(entry_list) {}
+      : FlatFileSystemService(entry_list, file_name_buffer, {}, {}) {}
 
   // Method definitions for pw.file.FileSystem.
   void List(ServerContext&, ConstByteSpan request, RawServerWriter& writer);
@@ -93,16 +99,88 @@ class FlatFileSystemService
   //   NOT_FOUND - Could not find
   StatusWithSize Delete(ServerContext&, ConstByteSpan request, ByteSpan);
 
+  // Drops the cached name and size of the entry with this file ID, or of all
+  // entries. Must be called when a file is written or deleted other than
+  // through this service, such as by a pw_transfer write handler. Does nothing
+  // if the service has no cache.
+  void InvalidateCache(Entry::Id file_id);
+  void InvalidateCache();
+
+ protected:
+  // The cached name and size of an entry.
+  struct CachedEntry {
+    enum class State : uint8_t {
+      kUnknown,   // Not read yet.
+      kNamed,     // The name is cached.
+      kNotFound,  // The entry has no file.
+    };
+
+    State state;
+    bool has_size;
+    uint16_t name_size;
+    uint32_t size_bytes;
+  };
+
+  // The entries are cached in entry_cache, which must be value-initialized and
+  // may be smaller than entry_list; the remaining entries are not cached. Entry
+  // i's name is cached at file_name_buffer.size() * i in name_cache.
+  FlatFileSystemService(std::span<Entry*> entry_list,
+                        std::span<char> file_name_buffer,
+                        std::span<CachedEntry> entry_cache,
+                        std::span<char> name_cache)
+      : file_name_buffer_(file_name_buffer),
+        entries_(entry_list),
+        entry_cache_(entry_cache),
+        name_cache_(name_cache) {}
+
  private:
-  Result<Entry*> FindFile(std::string_view file_name);
+  Result<size_t> FindFile(std::string_view file_name);
   Status FindAndDeleteFile(std::string_view file_name);
 
-  Status EnumerateFile(Entry& entry,
-                       pw::file::ListResponse::StreamEncoder& output_encoder);
-  void EnumerateAllFiles(RawServerWriter& writer);
+  // Reads the name of an entry, from the cache if possible.
+  Result<std::string_view> EntryName(size_t index);
+  size_t EntrySizeBytes(size_t index);
+
+  // Appends a Path for the entry to the response, if it is named, matches the
+  // prefix, and fits in max_size bytes.
+  //
+  // Returns:
+  //   OK - The Path was written.
+  //   NOT_FOUND - The entry was skipped.
+  //   RESOURCE_EXHAUSTED - The Path did not fit; nothing was written.
+  Status EnumerateFile(size_t index,
+                       std::string_view prefix,
+                       size_t max_size,
+                       pw::file::ListResponse::MemoryEncoder& encoder);
+
+  // Lists up to max_paths entries from the cursor; 0 lists all entries.
+  void EnumerateFiles(std::string_view prefix,
+                      size_t cursor,
+                      size_t max_paths,
+                      RawServerWriter& writer);
 
   std::span<char> file_name_buffer_;
   std::span<Entry*> entries_;
+  std::span<CachedEntry> entry_cache_;
+  std::span<char> name_cache_;
+};
+
+// A FlatFileSystemService with buffers for file names, which caches the name
+// and size of up to kMaxEntries entries. Listings then only read entries that
+// changed. Cached entries use kMaxFileNameLength + 8 bytes each.
+template <size_t kMaxEntries, size_t kMaxFileNameLength>
+class FlatFileSystemServiceWithCache : public FlatFileSystemService {
+ public:
+  static_assert(kMaxFileNameLength <= UINT16_MAX);
+
+  explicit FlatFileSystemServiceWithCache(std::span<Entry*> entry_list)
+      : FlatFileSystemService(
+            entry_list, file_name_buffer_, entry_cache_, name_cache_) {}
+
+ private:
+  std::array<char, kMaxFileNameLength> file_name_buffer_;
+  std::array<CachedEntry, kMaxEntries> entry_cache_ = {};
+  std::array<char, kMaxEntries * kMaxFileNameLength> name_cache_;
 };
 
 }  // namespace pw::file
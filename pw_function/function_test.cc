@@ -14,6 +14,9 @@
 
 #include "pw_function/function.h"
 
+#include <cstddef>
+#include <type_traits>
+
 #include "gtest/gtest.h"
 #include "pw_polyfill/language_feature_macros.h"
 
@@ -247,6 +250,106 @@ TEST(Function, MoveAssign_CustomObject) {
 #endif  // __clang_analyzer__
 }
 
+TEST(InlineFunction, SizeIsInlineSize) {
+  static_assert(sizeof(InlineFunction<void(), 8 * sizeof(void*)>) ==
+                8 * sizeof(void*));
+  static_assert(std::is_same_v<InlineFunction<void(), sizeof(Closure)>,
+                               Closure>);
+}
+
+TEST(InlineFunction, StoresCallableLargerThanDefault) {
+  int a = 1, b = 2, c = 3, d = 4;
+  InlineFunction<int(), 8 * sizeof(void*)> sum(
+      [&a, &b, &c, &d]() { return a + b + c + d; });
+  EXPECT_EQ(sum(), 10);
+
+  InlineFunction<int(), 8 * sizeof(void*)> moved = std::move(sum);
+  EXPECT_EQ(moved(), 10);
+  EXPECT_TRUE(moved != nullptr);
+#ifndef __clang_analyzer__
+  EXPECT_TRUE(sum == nullptr);
+#endif  // __clang_analyzer__
+}
+
+// Satisfies the allocator interface Function expects from a fixed buffer and
+// tracks how many allocations are outstanding.
+class TestAllocator {
+ public:
+  void* Allocate(size_t size, size_t alignment) {
+    if (in_use_ || size > sizeof(buffer_) || alignment > alignof(Buffer)) {
+      return nullptr;
+    }
+    in_use_ = true;
+    allocations_ += 1;
+    return &buffer_;
+  }
+
+  void Free(void* ptr) {
+    EXPECT_EQ(ptr, &buffer_);
+    in_use_ = false;
+  }
+
+  bool in_use() const { return in_use_; }
+  int allocations() const { return allocations_; }
+
+ private:
+  using Buffer = std::aligned_storage_t<64, alignof(std::max_align_t)>;
+
+  Buffer buffer_;
+  bool in_use_ = false;
+  int allocations_ = 0;
+};
+
+class LargeCallable {
+ public:
+  int operator()() const { return data_[0] + data_[7]; }
+
+ private:
+  int data_[8] = {1, 0, 0, 0, 0, 0, 0, 2};
+};
+
+TEST(Function, Allocator_SmallCallableStoredInline) {
+  TestAllocator allocator;
+  int value = 5;
+  Function<int()> function([&value]() { return value; }, allocator);
+  EXPECT_EQ(function(), 5);
+  EXPECT_EQ(allocator.allocations(), 0);
+}
+
+TEST(Function, Allocator_NullCallable) {
+  TestAllocator allocator;
+  Function<int()> function(static_cast<int (*)()>(nullptr), allocator);
+  EXPECT_EQ(function, nullptr);
+  EXPECT_EQ(allocator.allocations(), 0);
+}
+
+TEST(Function, Allocator_LargeCallableAllocated) {
+  TestAllocator allocator;
+  {
+    Function<int()> function(LargeCallable(), allocator);
+    EXPECT_TRUE(allocator.in_use());
+    EXPECT_EQ(function(), 3);
+  }
+  EXPECT_FALSE(allocator.in_use());
+  EXPECT_EQ(allocator.allocations(), 1);
+}
+
+TEST(Function, Allocator_MoveTransfersAllocation) {
+  TestAllocator allocator;
+  Function<int()> function(LargeCallable(), allocator);
+  Function<int()> moved(std::move(function));
+  EXPECT_TRUE(allocator.in_use());
+  EXPECT_EQ(moved(), 3);
+
+  function = std::move(moved);
+  EXPECT_TRUE(allocator.in_use());
+  EXPECT_EQ(function(), 3);
+
+  function = nullptr;
+  EXPECT_FALSE(allocator.in_use());
+  EXPECT_EQ(allocator.allocations(), 1);
+}
+
 }  // namespace
 }  // namespace pw
 
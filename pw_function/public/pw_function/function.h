@@ -43,7 +43,12 @@ namespace pw {
 //     return All(items, IsEven);
 //   }
 //
-template <typename Callable>
+// The size of a Function, and so the largest callable it can store inline,
+// defaults to PW_FUNCTION_INLINE_CALLABLE_SIZE. Use pw::InlineFunction to
+// select a different size for a particular function.
+template <typename Callable,
+          size_t kInlineCallableBytes =
+              function_internal::config::kInlineCallableSize>
 class Function {
   static_assert(std::is_function_v<Callable>,
                 "pw::Function may only be instantianted for a function type, "
@@ -52,8 +57,22 @@ class Function {
 
 using Closure = Function<void()>;
 
-template <typename Return, typename... Args>
-class Function<Return(Args...)> {
+// A pw::Function that is kInlineCallableBytes in size instead of the
+// configured default. This allows the few functions that store large callables
+// to do so without raising the size of every other function in the program.
+//
+//   pw::InlineFunction<void(), 8 * sizeof(void*)> callback(
+//       [a, b, c, d]() { Process(a, b, c, d); });
+//
+template <typename Callable, size_t kInlineCallableBytes>
+using InlineFunction = Function<Callable, kInlineCallableBytes>;
+
+template <size_t kInlineCallableBytes, typename Return, typename... Args>
+class Function<Return(Args...), kInlineCallableBytes> {
+  static_assert(kInlineCallableBytes > 0 &&
+                    kInlineCallableBytes % alignof(void*) == 0,
+                "The inline size must be a multiple of the pointer alignment");
+
  public:
   constexpr Function() = default;
   constexpr Function(std::nullptr_t) : Function() {}
@@ -67,6 +86,24 @@ class Function<Return(Args...)> {
     }
   }
 
+  // Constructs a function that stores the callable inline if it fits, or in
+  // memory from the allocator if it does not. This allows rarely used large
+  // callables without raising the inline size and without the system heap.
+  //
+  // The allocator is any type with Allocate(size, alignment) and Free(pointer)
+  // members, such as a pw::allocator::PoolAllocator, and must outlive the
+  // function. Crashes if an allocation is needed and fails.
+  template <typename Callable, typename Allocator>
+  Function(Callable callable, Allocator& allocator) {
+    if (function_internal::IsNull(callable)) {
+      holder_.InitializeNullTarget();
+    } else if constexpr (Holder::template kFitsInline<Callable>) {
+      holder_.InitializeInlineTarget(std::move(callable));
+    } else {
+      holder_.InitializeAllocatedTarget(std::move(callable), allocator);
+    }
+  }
+
   Function(Function&& other) {
     holder_.MoveInitializeTargetFrom(other.holder_);
     other.holder_.InitializeNullTarget();
@@ -120,31 +157,30 @@ class Function<Return(Args...)> {
     }
   }
 
-  function_internal::FunctionTargetHolder<
-      function_internal::config::kInlineCallableSize,
-      Return,
-      Args...>
-      holder_;
+  using Holder = function_internal::
+      FunctionTargetHolder<kInlineCallableBytes, Return, Args...>;
+
+  Holder holder_;
 };
 
 // nullptr comparisions for functions.
-template <typename T>
-bool operator==(const Function<T>& f, std::nullptr_t) {
+template <typename T, size_t kSize>
+bool operator==(const Function<T, kSize>& f, std::nullptr_t) {
   return !static_cast<bool>(f);
 }
 
-template <typename T>
-bool operator!=(const Function<T>& f, std::nullptr_t) {
+template <typename T, size_t kSize>
+bool operator!=(const Function<T, kSize>& f, std::nullptr_t) {
   return static_cast<bool>(f);
 }
 
-template <typename T>
-bool operator==(std::nullptr_t, const Function<T>& f) {
+template <typename T, size_t kSize>
+bool operator==(std::nullptr_t, const Function<T, kSize>& f) {
   return !static_cast<bool>(f);
 }
 
-template <typename T>
-bool operator!=(std::nullptr_t, const Function<T>& f) {
+template <typename T, size_t kSize>
+bool operator!=(std::nullptr_t, const Function<T, kSize>& f) {
   return static_cast<bool>(f);
 }
 
@@ -173,6 +173,59 @@ class MemoryFunctionTarget final : public FunctionTarget<Return, Args...> {
   void* address_;
 };
 
+// Function target which stores a callable in memory obtained from an
+// allocator, which is returned to the allocator when the target is destroyed.
+// The allocator is any type with Allocate(size, alignment) and Free(pointer)
+// members, such as pw::allocator::Allocator. A pointer to the allocator is
+// kept in the allocation alongside the callable, so this target is no larger
+// than a MemoryFunctionTarget.
+template <typename Allocator,
+          typename Callable,
+          typename Return,
+          typename... Args>
+class AllocatedFunctionTarget final : public FunctionTarget<Return, Args...> {
+ public:
+  struct Allocation {
+    Allocator* allocator;
+    mutable Callable callable;
+  };
+
+  explicit AllocatedFunctionTarget(Allocation* allocation)
+      : allocation_(allocation) {}
+
+  void Destroy() final {
+    // As with MemoryFunctionTarget, only the most recently moved-to target
+    // owns the allocation.
+    if (allocation_ != nullptr) {
+      Allocator& allocator = *allocation_->allocator;
+      allocation_->~Allocation();
+      allocator.Free(allocation_);
+    }
+  }
+
+  AllocatedFunctionTarget(const AllocatedFunctionTarget&) = delete;
+  AllocatedFunctionTarget& operator=(const AllocatedFunctionTarget&) = delete;
+
+  AllocatedFunctionTarget(AllocatedFunctionTarget&& other)
+      : allocation_(other.allocation_) {
+    other.allocation_ = nullptr;
+  }
+  AllocatedFunctionTarget& operator=(AllocatedFunctionTarget&&) = default;
+
+  bool IsNull() const final { return false; }
+
+  Return operator()(Args... args) const final {
+    return allocation_->callable(args...);
+  }
+
+  void MoveInitializeTo(void* ptr) final {
+    new (ptr) AllocatedFunctionTarget(std::move(*this));
+  }
+
+ private:
+  Allocation* allocation_;
+};
+
 template <size_t kSizeBytes>
 using FunctionStorage =
     std::aligned_storage_t<kSizeBytes, alignof(std::max_align_t)>;
@@ -199,6 +252,11 @@ class FunctionTargetHolder {
     new (&null_function_) NullFunctionTarget;
   }
 
+  // Whether an InlineFunctionTarget for the callable fits in the holder.
+  template <typename Callable>
+  static constexpr bool kFitsInline =
+      sizeof(InlineFunctionTarget<Callable, Return, Args...>) <= kSizeBytes;
+
   // Initializes an InlineFunctionTarget with the callable, failing if it is too
   // large.
   template <typename Callable>
@@ -221,6 +279,23 @@ class FunctionTargetHolder {
     new (&bits_) MemoryFunctionTarget(storage, std::move(callable));
   }
 
+  // Initializes an AllocatedFunctionTarget that stores the callable in memory
+  // from the allocator. Crashes if the allocation fails.
+  template <typename Callable, typename Allocator>
+  void InitializeAllocatedTarget(Callable callable, Allocator& allocator) {
+    using AllocatedFunctionTarget =
+        AllocatedFunctionTarget<Allocator, Callable, Return, Args...>;
+    using Allocation = typename AllocatedFunctionTarget::Allocation;
+    static_assert(
+        sizeof(AllocatedFunctionTarget) <= kSizeBytes,
+        "AllocatedFunctionTarget must fit within FunctionTargetHolder");
+
+    void* memory = allocator.Allocate(sizeof(Allocation), alignof(Allocation));
+    PW_ASSERT(memory != nullptr);
+    new (&bits_) AllocatedFunctionTarget(
+        new (memory) Allocation{&allocator, std::move(callable)});
+  }
+
   void DestructTarget() { target().Destroy(); }
 
   // Initializes the function target within this callable from another target
@@ -14,6 +14,9 @@
 
 #include "pw_hdlc/decoder.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "pw_assert/check.h"
 #include "pw_bytes/endian.h"
 #include "pw_hdlc/internal/protocol.h"
@@ -117,6 +120,62 @@ void Decoder::AppendByte(byte new_byte) {
   current_frame_size_ += 1;
 }
 
+void Decoder::AppendBytes(ConstByteSpan data) {
+  // Short runs are not worth special handling.
+  if (data.size() < last_read_bytes_.size()) {
+    for (byte b : data) {
+      AppendByte(b);
+    }
+    return;
+  }
+
+  if (current_frame_size_ < max_size()) {
+    std::memcpy(&buffer_[current_frame_size_],
+                data.data(),
+                std::min(data.size(), max_size() - current_frame_size_));
+  }
+
+  // The run evicts every byte in the last read bytes ring buffer. Add them to
+  // the running checksum, oldest first, followed by all but the last four bytes
+  // of the run, which take their place in the ring buffer.
+  const size_t buffered =
+      std::min(current_frame_size_, last_read_bytes_.size());
+  size_t index = (last_read_bytes_index_ + last_read_bytes_.size() - buffered) %
+                 last_read_bytes_.size();
+  for (size_t i = 0; i < buffered; ++i) {
+    fcs_.Update(last_read_bytes_[index]);
+    index = (index + 1) % last_read_bytes_.size();
+  }
+
+  const size_t fcs_bytes = data.size() - last_read_bytes_.size();
+  fcs_.Update(data.first(fcs_bytes));
+  std::memcpy(last_read_bytes_.data(),
+              &data[fcs_bytes],
+              last_read_bytes_.size());
+  last_read_bytes_index_ = 0;
+
+  current_frame_size_ += data.size();
+}
+
+size_t Decoder::ProcessRun(ConstByteSpan data) {
+  switch (state_) {
+    case State::kInterFrame: {
+      // Bytes before the next flag are discarded, but counted.
+      const size_t discarded = FindFlag(data);
+      current_frame_size_ += discarded;
+      return discarded;
+    }
+    case State::kFrame: {
+      const size_t run_size = FindByteToEscape(data);
+      AppendBytes(data.first(run_size));
+      return run_size;
+    }
+    case State::kFrameEscape:
+      return 0;
+  }
+  PW_CRASH("Bad decoder state");
+}
+
 Status Decoder::CheckFrame() const {
   // Empty frames are not an error; repeated flag characters are okay.
   if (current_frame_size_ == 0u) {
@@ -19,7 +19,9 @@
 
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
+#include "pw_hdlc/encoder.h"
 #include "pw_hdlc/internal/protocol.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::hdlc {
 namespace {
@@ -152,5 +154,175 @@ TEST(Decoder, TooLargeForBuffer_DecodesNextFrame) {
   EXPECT_EQ(OkStatus(), decoder.Process(kFlag).status());
 }
 
+// Records the results reported by a Decoder for comparisons.
+class DecodedFrames {
+ public:
+  void Add(const Result<Frame>& result) {
+    ASSERT_LT(count_, results_.size());
+    Decoded& decoded = results_[count_++];
+    decoded.status = result.status();
+    if (result.ok()) {
+      decoded.address = result.value().address();
+      decoded.size = result.value().data().size();
+      std::copy(result.value().data().begin(),
+                result.value().data().end(),
+                decoded.data.begin());
+    }
+  }
+
+  void ExpectEqual(const DecodedFrames& other) const {
+    ASSERT_EQ(count_, other.count_);
+    for (size_t i = 0; i < count_; ++i) {
+      const Decoded& actual = results_[i];
+      const Decoded& expected = other.results_[i];
+      EXPECT_EQ(actual.status, expected.status);
+      EXPECT_EQ(actual.address, expected.address);
+      ASSERT_EQ(actual.size, expected.size);
+      EXPECT_TRUE(std::equal(actual.data.begin(),
+                             actual.data.begin() + actual.size,
+                             expected.data.begin()));
+    }
+  }
+
+  size_t count() const { return count_; }
+
+  size_t ok_count() const {
+    return std::count_if(results_.begin(),
+                         results_.begin() + count_,
+                         [](const Decoded& d) { return d.status.ok(); });
+  }
+
+ private:
+  struct Decoded {
+    Status status;
+    uint64_t address = 0;
+    size_t size = 0;
+    std::array<byte, 64> data;
+  };
+
+  std::array<Decoded, 128> results_;
+  size_t count_ = 0;
+};
+
+class BulkDecode : public ::testing::Test {
+ protected:
+  static constexpr size_t kDecoderSize = 48;
+
+  BulkDecode() : writer_(stream_buffer_) {
+    // Frames with payloads of every length from 0 to 64 bytes, which include
+    // runs of bytes that must be escaped. Frames longer than the decoder's
+    // buffer are reported as RESOURCE_EXHAUSTED.
+    for (size_t size = 0; size <= 64; ++size) {
+      std::array<byte, 64> payload;
+      for (size_t i = 0; i < size; ++i) {
+        payload[i] = (i % 7 == 3 || i % 11 > 8) ? (i % 2 == 0 ? kFlag : kEscape)
+                                                : byte(i * 37);
+      }
+      EXPECT_EQ(
+          OkStatus(),
+          WriteUIFrame(size * 3, std::span(payload).first(size), writer_));
+
+      // Add garbage between some frames and corrupt others.
+      if (size % 5 == 0) {
+        EXPECT_EQ(OkStatus(), writer_.Write(bytes::String("garbage")));
+      }
+      if (size % 9 == 0) {
+        stream_buffer_[writer_.bytes_written() - 3] ^= byte{0x01};
+      }
+    }
+  }
+
+  ConstByteSpan stream() const {
+    return std::span(stream_buffer_).first(writer_.bytes_written());
+  }
+
+  DecodedFrames DecodeByteByByte() {
+    DecoderBuffer<kDecoderSize> decoder;
+    DecodedFrames frames;
+    for (byte b : stream()) {
+      auto result = decoder.Process(b);
+      if (result.status() != Status::Unavailable()) {
+        frames.Add(result);
+      }
+    }
+    return frames;
+  }
+
+  std::array<byte, 8192> stream_buffer_ = {};
+  stream::MemoryWriter writer_;
+};
+
+TEST_F(BulkDecode, SingleSpan_MatchesByteByByte) {
+  const DecodedFrames expected = DecodeByteByByte();
+  ASSERT_GT(expected.ok_count(), 30u);
+
+  DecoderBuffer<kDecoderSize> decoder;
+  DecodedFrames frames;
+  decoder.Process(stream(), [&frames](const Result<Frame>& result) {
+    frames.Add(result);
+  });
+
+  frames.ExpectEqual(expected);
+}
+
+TEST_F(BulkDecode, Chunks_MatchesByteByByte) {
+  const DecodedFrames expected = DecodeByteByByte();
+
+  // Split the stream into chunks of varying sizes so that runs, escapes, and
+  // frame check sequences span Process calls.
+  for (size_t max_chunk = 1; max_chunk < 14; ++max_chunk) {
+    DecoderBuffer<kDecoderSize> decoder;
+    DecodedFrames frames;
+
+    ConstByteSpan data = stream();
+    for (size_t chunk = 1; !data.empty(); chunk = chunk % max_chunk + 1) {
+      const size_t size = std::min(chunk, data.size());
+      decoder.Process(
+          data.first(size),
+          [&frames](const Result<Frame>& result) { frames.Add(result); });
+      data = data.subspan(size);
+    }
+
+    frames.ExpectEqual(expected);
+  }
+}
+
+TEST(Decoder, BulkProcess_TooLargeForBuffer_StaysWithinBufferBoundaries) {
+  std::array<byte, 16> buffer = bytes::Initialized<16>('?');
+
+  Decoder decoder(std::span(buffer.data(), 8));
+
+  Status status = Status::Unknown();
+  decoder.Process(
+      bytes::String("~12345678901234567890\xf2\x19\x63\x90~"),
+      [&status](const Result<Frame>& result) { status = result.status(); });
+
+  for (size_t i = 8; i < buffer.size(); ++i) {
+    ASSERT_EQ(byte{'?'}, buffer[i]);
+  }
+  EXPECT_EQ(Status::ResourceExhausted(), status);
+}
+
+TEST(FindByteToEscape, FindsFirstFlagOrEscape) {
+  std::array<byte, 40> data = bytes::Initialized<40>('a');
+  EXPECT_EQ(data.size(), FindByteToEscape(data));
+  EXPECT_EQ(data.size(), FindFlag(data));
+
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = kEscape;
+    EXPECT_EQ(i, FindByteToEscape(data));
+    EXPECT_EQ(data.size(), FindFlag(data));
+
+    data[i] = kFlag;
+    EXPECT_EQ(i, FindByteToEscape(data));
+    EXPECT_EQ(i, FindFlag(data));
+
+    // Bytes that differ from the control bytes by one bit do not match.
+    data[i] = kFlag ^ byte{0x80};
+    EXPECT_EQ(data.size(), FindByteToEscape(data));
+    data[i] = byte{'a'};
+  }
+}
+
 }  // namespace
 }  // namespace pw::hdlc
@@ -29,32 +29,36 @@ using std::byte;
 namespace pw::hdlc {
 namespace internal {
 
-Status EscapeAndWrite(const byte b, stream::Writer& writer) {
-  if (b == kFlag) {
-    return writer.Write(kEscapedFlag);
-  }
-  if (b == kEscape) {
-    return writer.Write(kEscapedEscape);
-  }
-  return writer.Write(b);
-}
-
 Status Encoder::WriteData(ConstByteSpan data) {
-  auto begin = data.begin();
-  while (true) {
-    auto end = std::find_if(begin, data.end(), NeedsEscaping);
+  fcs_.Update(data);
 
-    if (Status status = writer_.Write(std::span(begin, end)); !status.ok()) {
-      return status;
+  while (true) {
+    // Write the run of bytes that do not need escaping with a single write.
+    const size_t run_size = FindByteToEscape(data);
+    if (run_size != 0u) {
+      if (Status status = writer_.Write(data.first(run_size)); !status.ok()) {
+        return status;
+      }
     }
-    if (end == data.end()) {
-      fcs_.Update(data);
+    if (run_size == data.size()) {
       return OkStatus();
     }
-    if (Status status = EscapeAndWrite(*end, writer_); !status.ok()) {
+    data = data.subspan(run_size);
+
+    // Escape consecutive bytes that need escaping into a small buffer and
+    // write them together.
+    std::array<byte, 16> escaped;
+    size_t escaped_size = 0;
+    while (escaped_size < escaped.size() && !data.empty() &&
+           NeedsEscaping(data.front())) {
+      escaped[escaped_size++] = kEscape;
+      escaped[escaped_size++] = Escape(data.front());
+      data = data.subspan(1);
+    }
+    if (Status status = writer_.Write(std::span(escaped).first(escaped_size));
+        !status.ok()) {
       return status;
     }
-    begin = end + 1;
   }
 }
 
@@ -70,9 +74,11 @@ Status Encoder::FinishFrame() {
 size_t Encoder::MaxEncodedSize(uint64_t address, ConstByteSpan payload) {
   constexpr size_t kFcsMaxSize = 8;  // Worst case FCS: 0x7e7e7e7e.
   size_t max_encoded_address_size = varint::EncodedSize(address) * 2;
-  size_t encoded_payload_size =
-      payload.size() +
-      std::count_if(payload.begin(), payload.end(), NeedsEscaping);
+  size_t encoded_payload_size = payload.size();
+  for (size_t i = FindByteToEscape(payload); i < payload.size();
+       i += 1 + FindByteToEscape(payload.subspan(i + 1))) {
+    encoded_payload_size += 1;
+  }
 
   return max_encoded_address_size + sizeof(kUnusedControl) +
          encoded_payload_size + kFcsMaxSize;
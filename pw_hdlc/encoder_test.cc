@@ -46,8 +46,8 @@ class WriteUnnumberedFrame : public ::testing::Test {
  protected:
   WriteUnnumberedFrame() : writer_(buffer_) {}
 
+  std::array<byte, 32> buffer_ = {};
   stream::MemoryWriter writer_;
-  std::array<byte, 32> buffer_;
 };
 
 constexpr byte kUnnumberedControl = byte{0x3};
@@ -118,6 +118,21 @@ TEST_F(WriteUnnumberedFrame, Crc32NeedsEscaping) {
                                      kFlag));
 }
 
+TEST_F(WriteUnnumberedFrame, ManyConsecutiveEscapes) {
+  // More consecutive escapes than the encoder escapes in a single write.
+  constexpr auto kPayload = bytes::Initialized<10>(0x7e);
+  ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, kPayload, writer_));
+
+  // The FCS (0xc6bb6323) does not need escaping.
+  ASSERT_EQ(writer_.bytes_written(), 3u + 2 * kPayload.size() + 4u + 1u);
+  EXPECT_EQ(writer_.data()[0], kFlag);
+  for (size_t i = 0; i < kPayload.size(); ++i) {
+    EXPECT_EQ(writer_.data()[3 + 2 * i], kEscape);
+    EXPECT_EQ(writer_.data()[3 + 2 * i + 1], byte{0x5e});
+  }
+  EXPECT_EQ(writer_.data()[writer_.bytes_written() - 1], kFlag);
+}
+
 TEST_F(WriteUnnumberedFrame, MultiplePayloads) {
   ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, bytes::String("ABC"), writer_));
   ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, bytes::String("DEF"), writer_));
@@ -0,0 +1,39 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_hdlc/frame_dispatcher.h"
+
+namespace pw::hdlc {
+
+void FrameDispatcher::Process(Decoder& decoder, ConstByteSpan data) {
+  decoder.Process(data, [this](Result<Frame>& result) {
+    if (!result.ok()) {
+      invalid_frames_ += 1;
+      return;
+    }
+    // Handler errors are the handler's to report; the stream continues.
+    Dispatch(result.value()).IgnoreError();
+  });
+}
+
+Status FrameDispatcher::Dispatch(const Frame& frame) {
+  const FrameRoute* route = FindRoute(frame.address());
+  if (route == nullptr) {
+    unrouted_frames_ += 1;
+    return Status::NotFound();
+  }
+  return route->handler.HandleFrame(frame);
+}
+
+}  // namespace pw::hdlc
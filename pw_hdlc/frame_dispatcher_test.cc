@@ -0,0 +1,147 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_hdlc/frame_dispatcher.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::hdlc {
+namespace {
+
+constexpr uint64_t kRpcAddress = 'R';
+constexpr uint64_t kLogAddress = 'L';
+constexpr uint64_t kDebugAddress = 0x7f;
+
+constexpr auto kPayload = bytes::String("hello");
+
+class RecordingHandler final : public FrameHandler {
+ public:
+  Status HandleFrame(const Frame& frame) override {
+    frames += 1;
+    last_data = frame.data();
+    return status;
+  }
+
+  size_t frames = 0;
+  ConstByteSpan last_data;
+  Status status;
+};
+
+RecordingHandler log_handler;
+RecordingHandler debug_handler;
+
+constexpr FrameRoute kRoutes[] = {
+    {kLogAddress, log_handler},
+    {kDebugAddress, debug_handler},
+};
+
+static_assert(FrameDispatcher(kRoutes).FindRoute(kDebugAddress) == &kRoutes[1]);
+static_assert(FrameDispatcher(kRoutes).FindRoute(kRpcAddress) == nullptr);
+
+class FrameDispatcherTest : public ::testing::Test {
+ protected:
+  FrameDispatcherTest() : writer_(stream_buffer_), dispatcher_(kRoutes) {
+    log_handler = RecordingHandler();
+    debug_handler = RecordingHandler();
+  }
+
+  void WriteFrame(uint64_t address, ConstByteSpan data) {
+    ASSERT_EQ(OkStatus(), WriteUIFrame(address, data, writer_));
+  }
+
+  void Process() { dispatcher_.Process(decoder_, writer_.WrittenData()); }
+
+  std::array<std::byte, 256> stream_buffer_ = {};
+  stream::MemoryWriter writer_;
+  DecoderBuffer<64> decoder_;
+  FrameDispatcher dispatcher_;
+};
+
+TEST_F(FrameDispatcherTest, RoutesFramesByAddress) {
+  WriteFrame(kLogAddress, kPayload);
+  WriteFrame(kDebugAddress, kPayload);
+  WriteFrame(kDebugAddress, kPayload);
+  Process();
+
+  EXPECT_EQ(1u, log_handler.frames);
+  EXPECT_EQ(2u, debug_handler.frames);
+  EXPECT_EQ(0u, dispatcher_.unrouted_frames());
+  EXPECT_EQ(0u, dispatcher_.invalid_frames());
+}
+
+TEST_F(FrameDispatcherTest, FrameDataIsInDecoderBuffer) {
+  WriteFrame(kLogAddress, kPayload);
+  Process();
+
+  ASSERT_EQ(kPayload.size(), log_handler.last_data.size());
+  EXPECT_EQ(0, std::memcmp(kPayload.data(),
+                           log_handler.last_data.data(),
+                           kPayload.size()));
+
+  // The data was not copied out of the decoder's buffer.
+  ConstByteSpan decoder_buffer(
+      reinterpret_cast<const std::byte*>(&decoder_), sizeof(decoder_));
+  EXPECT_GE(log_handler.last_data.data(), decoder_buffer.data());
+  EXPECT_LE(log_handler.last_data.data() + log_handler.last_data.size(),
+            decoder_buffer.data() + decoder_buffer.size());
+}
+
+TEST_F(FrameDispatcherTest, UnroutedFrame_Counted) {
+  WriteFrame(kRpcAddress, kPayload);
+  WriteFrame(kLogAddress, kPayload);
+  Process();
+
+  EXPECT_EQ(1u, dispatcher_.unrouted_frames());
+  EXPECT_EQ(1u, log_handler.frames);
+}
+
+TEST_F(FrameDispatcherTest, InvalidFrame_CountedAndSkipped) {
+  WriteFrame(kLogAddress, kPayload);
+  writer_.Write(bytes::Array<'~', 'x', 'y', 'z', 'z', 'y', 'x', '~'>())
+      .IgnoreError();
+  WriteFrame(kDebugAddress, kPayload);
+  Process();
+
+  EXPECT_EQ(1u, dispatcher_.invalid_frames());
+  EXPECT_EQ(1u, log_handler.frames);
+  EXPECT_EQ(1u, debug_handler.frames);
+}
+
+TEST_F(FrameDispatcherTest, Dispatch_ReturnsHandlerStatus) {
+  debug_handler.status = Status::Unavailable();
+  WriteFrame(kDebugAddress, kPayload);
+  WriteFrame(kRpcAddress, kPayload);
+
+  ConstByteSpan data = writer_.WrittenData();
+  std::array<Status, 2> statuses;
+  size_t frames = 0;
+  decoder_.Process(data, [&](Result<Frame>& result) {
+    ASSERT_EQ(OkStatus(), result.status());
+    statuses[frames++] = dispatcher_.Dispatch(result.value());
+  });
+
+  ASSERT_EQ(2u, frames);
+  EXPECT_EQ(Status::Unavailable(), statuses[0]);
+  EXPECT_EQ(Status::NotFound(), statuses[1]);
+}
+
+}  // namespace
+}  // namespace pw::hdlc
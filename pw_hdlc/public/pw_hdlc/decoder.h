@@ -97,10 +97,20 @@ class Decoder {
 
   // Processes a span of data and calls the provided callback with each frame or
   // error.
+  //
+  // Runs of bytes that do not affect the decoder state (unescaped frame data
+  // and discarded bytes between frames) are handled in bulk: frame data is
+  // copied with memcpy and added to the frame check sequence a run at a time.
   template <typename F, typename... Args>
   void Process(ConstByteSpan data, F&& callback, Args&&... args) {
-    for (std::byte b : data) {
-      auto result = Process(b);
+    while (!data.empty()) {
+      data = data.subspan(ProcessRun(data));
+      if (data.empty()) {
+        return;
+      }
+
+      auto result = Process(data.front());
+      data = data.subspan(1);
       if (result.status() != Status::Unavailable()) {
         std::invoke(
             std::forward<F>(callback), std::forward<Args>(args)..., result);
@@ -133,6 +143,14 @@ class Decoder {
 
   void AppendByte(std::byte new_byte);
 
+  // Appends a run of unescaped bytes to the current frame.
+  void AppendBytes(ConstByteSpan data);
+
+  // Consumes the leading bytes of data that cannot change the decoder's state
+  // and returns how many bytes were consumed. The next byte, if any, must be
+  // passed to Process(std::byte).
+  size_t ProcessRun(ConstByteSpan data);
+
   Status CheckFrame() const;
 
   bool VerifyFrameCheckSequence() const;
@@ -0,0 +1,120 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/server.h"
+#include "pw_status/status.h"
+
+namespace pw::hdlc {
+
+// Receives the frames sent to one address. The frame's data is in the
+// decoder's buffer and is only valid until HandleFrame returns.
+class FrameHandler {
+ public:
+  virtual ~FrameHandler() = default;
+
+  virtual Status HandleFrame(const Frame& frame) = 0;
+};
+
+// Passes frames to an RPC server, which sends responses through output.
+class RpcFrameHandler final : public FrameHandler {
+ public:
+  constexpr RpcFrameHandler(rpc::Server& server, rpc::ChannelOutput& output)
+      : server_(server), output_(output) {}
+
+  Status HandleFrame(const Frame& frame) override {
+    return server_.ProcessPacket(frame.data(), output_);
+  }
+
+ private:
+  rpc::Server& server_;
+  rpc::ChannelOutput& output_;
+};
+
+// Maps an HDLC address to the handler for its frames.
+struct FrameRoute {
+  uint64_t address;
+  FrameHandler& handler;
+};
+
+// Decodes an HDLC stream that carries several channels, such as RPC, logs, and
+// a raw debug channel, on different addresses. Each frame is decoded once into
+// the decoder's buffer and passed by reference to the handler for its address,
+// so no frame is copied per consumer.
+//
+// The routes are usually a constexpr table, which is searched in order; if an
+// address is listed more than once, the first route is used. Frames may also
+// be written to a MultiSink with MultiSinkFrameHandler, from
+// pw_hdlc/multisink_frame_handler.h.
+//
+//   pw::hdlc::RpcFrameHandler rpc_handler(server, rpc_output);
+//   pw::hdlc::MultiSinkFrameHandler debug_handler(debug_multisink);
+//
+//   constexpr pw::hdlc::FrameRoute kRoutes[] = {
+//       {pw::hdlc::kDefaultRpcAddress, rpc_handler},
+//       {kDebugAddress, debug_handler},
+//   };
+//
+//   pw::hdlc::FrameDispatcher dispatcher(kRoutes);
+//   pw::hdlc::DecoderBuffer<512> decoder;
+//
+//   dispatcher.Process(decoder, received_data);
+//
+// FrameDispatcher is not thread safe.
+class FrameDispatcher {
+ public:
+  constexpr FrameDispatcher(std::span<const FrameRoute> routes)
+      : routes_(routes), unrouted_frames_(0), invalid_frames_(0) {}
+
+  FrameDispatcher(const FrameDispatcher&) = delete;
+  FrameDispatcher& operator=(const FrameDispatcher&) = delete;
+
+  // Decodes data with the decoder and dispatches each complete frame. Frames
+  // that are invalid or too large for the decoder are counted and discarded.
+  void Process(Decoder& decoder, ConstByteSpan data);
+
+  // Passes a decoded frame to the handler for its address. Returns the
+  // handler's status, or NOT_FOUND if no route has the frame's address.
+  Status Dispatch(const Frame& frame);
+
+  // Returns the route for an address, or nullptr if there is none.
+  constexpr const FrameRoute* FindRoute(uint64_t address) const {
+    for (const FrameRoute& route : routes_) {
+      if (route.address == address) {
+        return &route;
+      }
+    }
+    return nullptr;
+  }
+
+  // The number of valid frames whose address has no route.
+  size_t unrouted_frames() const { return unrouted_frames_; }
+
+  // The number of frames discarded because they were invalid or too large.
+  size_t invalid_frames() const { return invalid_frames_; }
+
+ private:
+  const std::span<const FrameRoute> routes_;
+  size_t unrouted_frames_;
+  size_t invalid_frames_;
+};
+
+}  // namespace pw::hdlc
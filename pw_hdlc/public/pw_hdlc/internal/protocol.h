@@ -13,8 +13,12 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 
+#include "pw_bytes/span.h"
 #include "pw_varint/varint.h"
 
 namespace pw::hdlc {
@@ -37,6 +41,57 @@ constexpr bool NeedsEscaping(std::byte b) {
 
 constexpr std::byte Escape(std::byte b) { return b ^ kEscapeConstant; }
 
+namespace internal {
+
+inline constexpr uint64_t kLowBits = 0x0101010101010101u;
+inline constexpr uint64_t kHighBits = 0x8080808080808080u;
+
+// True if any of the eight bytes in the word is zero.
+constexpr bool HasZeroByte(uint64_t word) {
+  return ((word - kLowBits) & ~word & kHighBits) != 0u;
+}
+
+// Returns the index of the first flag byte (or escape byte, if kMatchEscape is
+// true) in data, or data.size() if there is none. Most of the data is examined
+// eight bytes at a time.
+template <bool kMatchEscape>
+size_t FindControlByte(ConstByteSpan data) {
+  constexpr uint64_t kFlagWord = kLowBits * uint8_t(kFlag);
+  constexpr uint64_t kEscapeWord = kLowBits * uint8_t(kEscape);
+
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= data.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, &data[i], sizeof(word));
+
+    if (HasZeroByte(word ^ kFlagWord) ||
+        (kMatchEscape && HasZeroByte(word ^ kEscapeWord))) {
+      break;
+    }
+  }
+
+  for (; i < data.size(); ++i) {
+    if (data[i] == kFlag || (kMatchEscape && data[i] == kEscape)) {
+      return i;
+    }
+  }
+  return data.size();
+}
+
+}  // namespace internal
+
+// Returns the index of the first byte in data that needs escaping, or
+// data.size() if no bytes need escaping.
+inline size_t FindByteToEscape(ConstByteSpan data) {
+  return internal::FindControlByte<true>(data);
+}
+
+// Returns the index of the first flag byte in data, or data.size() if there is
+// no flag byte.
+inline size_t FindFlag(ConstByteSpan data) {
+  return internal::FindControlByte<false>(data);
+}
+
 // Class that manages the 1-byte control field of an HDLC U-frame.
 class UFrameControl {
  public:
@@ -0,0 +1,37 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_hdlc/frame_dispatcher.h"
+#include "pw_multisink/multisink.h"
+#include "pw_status/status.h"
+
+namespace pw::hdlc {
+
+// Writes the data of each frame to a MultiSink as an entry.
+class MultiSinkFrameHandler final : public FrameHandler {
+ public:
+  constexpr MultiSinkFrameHandler(multisink::MultiSink& multisink)
+      : multisink_(multisink) {}
+
+  Status HandleFrame(const Frame& frame) override {
+    multisink_.HandleEntry(frame.data());
+    return OkStatus();
+  }
+
+ private:
+  multisink::MultiSink& multisink_;
+};
+
+}  // namespace pw::hdlc
@@ -18,10 +18,53 @@
 
 #include "pw_assert/assert.h"
 #include "pw_hdlc/encoder.h"
+#include "pw_hdlc/internal/encoder.h"
 #include "pw_rpc/channel.h"
 #include "pw_stream/stream.h"
 
 namespace pw::hdlc {
+namespace internal {
+
+// Encodes RPC packets into HDLC UI-frames as they are written, so packets are
+// framed without first being encoded into a separate buffer.
+class UIFrameWriter final : public stream::NonSeekableWriter {
+ public:
+  constexpr UIFrameWriter(stream::Writer& writer, uint64_t address)
+      : encoder_(writer), address_(address), status_(OkStatus()) {}
+
+  // Writes the frame header. Writes fail if the header could not be written.
+  stream::Writer* StartFrame() {
+    status_ = encoder_.StartUnnumberedFrame(address_);
+    return this;
+  }
+
+  // Writes the frame check sequence and the terminating flag. If writing the
+  // frame failed, the frame is left unterminated so it will be discarded by
+  // the receiver.
+  Status FinishFrame(Status write_status) {
+    if (!status_.ok()) {
+      return status_;
+    }
+    if (!write_status.ok()) {
+      return write_status;
+    }
+    return encoder_.FinishFrame();
+  }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    if (!status_.ok()) {
+      return status_;
+    }
+    return status_ = encoder_.WriteData(data);
+  }
+
+  Encoder encoder_;
+  const uint64_t address_;
+  Status status_;
+};
+
+}  // namespace internal
 
 // Custom HDLC ChannelOutput class to write and read data through serial using
 // the HDLC protocol.
@@ -40,7 +83,8 @@ class RpcChannelOutput : public rpc::ChannelOutput {
       : ChannelOutput(channel_name),
         writer_(writer),
         buffer_(buffer),
-        address_(address) {}
+        address_(address),
+        frame_writer_(writer, address) {}
 
   std::span<std::byte> AcquireBuffer() override { return buffer_; }
 
@@ -52,10 +96,19 @@ class RpcChannelOutput : public rpc::ChannelOutput {
     return hdlc::WriteUIFrame(address_, buffer, writer_);
   }
 
+  // Packets are encoded directly into the HDLC frame rather than into the
+  // buffer, which then only holds the payload.
+  stream::Writer* StartPacket() override { return frame_writer_.StartFrame(); }
+
+  Status FinishPacket(Status write_status) override {
+    return frame_writer_.FinishFrame(write_status);
+  }
+
  private:
   stream::Writer& writer_;
   const std::span<std::byte> buffer_;
   const uint64_t address_;
+  internal::UIFrameWriter frame_writer_;
 };
 
 // RpcChannelOutput with its own buffer.
@@ -68,7 +121,10 @@ class RpcChannelOutputBuffer : public rpc::ChannelOutput {
   constexpr RpcChannelOutputBuffer(stream::Writer& writer,
                                    uint64_t address,
                                    const char* channel_name)
-      : ChannelOutput(channel_name), writer_(writer), address_(address) {}
+      : ChannelOutput(channel_name),
+        writer_(writer),
+        address_(address),
+        frame_writer_(writer, address) {}
 
   std::span<std::byte> AcquireBuffer() override { return buffer_; }
 
@@ -80,10 +136,19 @@ class RpcChannelOutputBuffer : public rpc::ChannelOutput {
     return hdlc::WriteUIFrame(address_, buffer, writer_);
   }
 
+  // Packets are encoded directly into the HDLC frame rather than into the
+  // buffer, which then only holds the payload.
+  stream::Writer* StartPacket() override { return frame_writer_.StartFrame(); }
+
+  Status FinishPacket(Status write_status) override {
+    return frame_writer_.FinishFrame(write_status);
+  }
+
  private:
   stream::Writer& writer_;
   std::array<std::byte, kBufferSize> buffer_;
   const uint64_t address_;
+  internal::UIFrameWriter frame_writer_;
 };
 
 }  // namespace pw::hdlc
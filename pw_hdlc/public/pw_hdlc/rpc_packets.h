@@ -31,4 +31,15 @@ Status ReadAndProcessPackets(rpc::Server& server,
                              std::span<std::byte> decode_buffer,
                              unsigned rpc_address = kDefaultRpcAddress);
 
+// Reads HDLC frames with sys_io::StartReadAsync, which the sys_io backend may
+// implement with DMA. receive_buffer is split in half for double-buffered
+// reception; received data is decoded while the backend fills the other half.
+// Falls back to sys_io::ReadByte if the backend does not support asynchronous
+// reads.
+Status ReadAndProcessPackets(rpc::Server& server,
+                             rpc::ChannelOutput& output,
+                             std::span<std::byte> decode_buffer,
+                             std::span<std::byte> receive_buffer,
+                             unsigned rpc_address = kDefaultRpcAddress);
+
 }  // namespace pw::hdlc
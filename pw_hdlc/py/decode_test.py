@@ -20,6 +20,7 @@ import unittest
 from pw_build.generated_tests import Context, PyTest, TestGenerator, GroupOrTest
 from pw_build.generated_tests import parse_test_generation_args
 from pw_hdlc.decode import Frame, FrameDecoder, FrameStatus, NO_ADDRESS
+from pw_hdlc.decode import NATIVE_DECODER_AVAILABLE
 from pw_hdlc.protocol import frame_check_sequence as fcs
 from pw_hdlc.protocol import encode_address
 
@@ -327,23 +328,32 @@ def _cpp_test(ctx: Context) -> Iterator[str]:
 }}"""
 
 
+# Test the pure-Python decoder, and the native decoder if it was built.
+_DECODER_TYPES = (False, True) if NATIVE_DECODER_AVAILABLE else (False, )
+
+
 def _define_py_test(ctx: Context) -> PyTest:
     data, expected_frames = ctx.test_case
 
     def test(self) -> None:
-        # Decode in one call
-        self.assertEqual(expected_frames,
-                         list(FrameDecoder().process(data)),
-                         msg=f'{ctx.group}: {data!r}')
-        # Decode byte-by-byte
-        decoder = FrameDecoder()
-        decoded_frames: List[Frame] = []
-        for i in range(len(data)):
-            decoded_frames += decoder.process(data[i:i + 1])
-
-        self.assertEqual(expected_frames,
-                         decoded_frames,
-                         msg=f'{ctx.group} (byte-by-byte): {data!r}')
+        for native in _DECODER_TYPES:
+            # Decode in one call
+            self.assertEqual(expected_frames,
+                             list(FrameDecoder(native).process(data)),
+                             msg=f'{ctx.group} (native={native}): {data!r}')
+            self.assertEqual(expected_frames,
+                             FrameDecoder(native).process_all(data),
+                             msg=f'{ctx.group} (native={native}): {data!r}')
+            # Decode byte-by-byte
+            decoder = FrameDecoder(native)
+            decoded_frames: List[Frame] = []
+            for i in range(len(data)):
+                decoded_frames += decoder.process(data[i:i + 1])
+
+            self.assertEqual(
+                expected_frames,
+                decoded_frames,
+                msg=f'{ctx.group} (native={native}, byte-by-byte): {data!r}')
 
     return test
 
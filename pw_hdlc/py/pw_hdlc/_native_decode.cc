@@ -0,0 +1,258 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Native implementation of the HDLC frame scanning state machine used by
+// pw_hdlc.decode.FrameDecoder. Scanning byte by byte in Python dominates the
+// cost of decoding, so this module splits a byte stream into raw and unescaped
+// frames in C++ and leaves frame check sequence verification and field parsing
+// to Python.
+//
+// pw::hdlc::Decoder is not used directly because it decodes into a fixed-size
+// buffer and does not report the raw encoded bytes or distinguish framing
+// errors from FCS mismatches, all of which FrameDecoder provides.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+
+namespace {
+
+constexpr uint8_t kFlag = 0x7E;
+constexpr uint8_t kEscape = 0x7D;
+constexpr uint8_t kEscapeConstant = 0x20;
+
+class FrameScanner {
+ public:
+  // Scans data, appending a (raw_encoded, raw_decoded, complete) tuple to
+  // frames for each frame that ends in data. complete is false if the frame
+  // had a framing error. Returns false if a Python exception was raised.
+  bool Process(const uint8_t* data, size_t size, PyObject* frames);
+
+ private:
+  enum class State {
+    kInterFrame,
+    kFrame,
+    kFrameEscape,
+  };
+
+  bool FinishFrame(bool complete, PyObject* frames);
+
+  std::string raw_;
+  std::string decoded_;
+  State state_ = State::kInterFrame;
+};
+
+bool FrameScanner::Process(const uint8_t* data, size_t size, PyObject* frames) {
+  const uint8_t* const end = data + size;
+
+  while (data != end) {
+    switch (state_) {
+      case State::kInterFrame: {
+        // Everything up to the next flag is discarded, but recorded as raw
+        // data so that it can be reported with the framing error.
+        const void* flag = std::memchr(data, kFlag, end - data);
+        const uint8_t* run_end =
+            flag == nullptr ? end : static_cast<const uint8_t*>(flag);
+        raw_.append(reinterpret_cast<const char*>(data), run_end - data);
+        data = run_end;
+        if (data == end) {
+          break;
+        }
+
+        data += 1;
+        if (!raw_.empty() && !FinishFrame(false, frames)) {
+          return false;
+        }
+        state_ = State::kFrame;
+        break;
+      }
+      case State::kFrame: {
+        // Runs of unescaped data are copied in bulk.
+        const uint8_t* run_end = data;
+        while (run_end != end && *run_end != kFlag && *run_end != kEscape) {
+          ++run_end;
+        }
+        raw_.append(reinterpret_cast<const char*>(data), run_end - data);
+        decoded_.append(reinterpret_cast<const char*>(data), run_end - data);
+        data = run_end;
+        if (data == end) {
+          break;
+        }
+
+        const uint8_t byte = *data++;
+        if (byte == kFlag) {
+          if (!raw_.empty() && !FinishFrame(true, frames)) {
+            return false;
+          }
+        } else {
+          raw_.push_back(char(byte));
+          state_ = State::kFrameEscape;
+        }
+        break;
+      }
+      case State::kFrameEscape: {
+        const uint8_t byte = *data++;
+        if (byte == kFlag) {
+          if (!FinishFrame(false, frames)) {
+            return false;
+          }
+          state_ = State::kFrame;
+          break;
+        }
+
+        raw_.push_back(char(byte));
+        if (byte == (kFlag ^ kEscapeConstant) ||
+            byte == (kEscape ^ kEscapeConstant)) {
+          decoded_.push_back(char(byte ^ kEscapeConstant));
+          state_ = State::kFrame;
+        } else {
+          // Only flag and escape characters may be escaped. Discard the rest
+          // of the frame.
+          state_ = State::kInterFrame;
+        }
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+bool FrameScanner::FinishFrame(bool complete, PyObject* frames) {
+  PyObject* frame = Py_BuildValue("(y#y#O)",
+                                  raw_.data(),
+                                  Py_ssize_t(raw_.size()),
+                                  decoded_.data(),
+                                  Py_ssize_t(decoded_.size()),
+                                  complete ? Py_True : Py_False);
+  raw_.clear();
+  decoded_.clear();
+  if (frame == nullptr) {
+    return false;
+  }
+
+  const int result = PyList_Append(frames, frame);
+  Py_DECREF(frame);
+  return result == 0;
+}
+
+// Python wrapper for FrameScanner.
+
+struct FrameScannerObject {
+  PyObject_HEAD FrameScanner* scanner;
+};
+
+PyObject* FrameScanner_new(PyTypeObject* type, PyObject*, PyObject*) {
+  FrameScannerObject* self =
+      reinterpret_cast<FrameScannerObject*>(type->tp_alloc(type, 0));
+  if (self == nullptr) {
+    return nullptr;
+  }
+
+  self->scanner = new (std::nothrow) FrameScanner();
+  if (self->scanner == nullptr) {
+    Py_DECREF(self);
+    return PyErr_NoMemory();
+  }
+  return reinterpret_cast<PyObject*>(self);
+}
+
+void FrameScanner_dealloc(PyObject* object) {
+  FrameScannerObject* self = reinterpret_cast<FrameScannerObject*>(object);
+  PyTypeObject* type = Py_TYPE(object);
+  delete self->scanner;
+  type->tp_free(object);
+  Py_DECREF(type);  // Instances of heap types hold a reference to the type.
+}
+
+PyObject* FrameScanner_process(PyObject* object, PyObject* arg) {
+  FrameScannerObject* self = reinterpret_cast<FrameScannerObject*>(object);
+
+  Py_buffer buffer;
+  if (PyObject_GetBuffer(arg, &buffer, PyBUF_SIMPLE) != 0) {
+    return nullptr;
+  }
+
+  PyObject* frames = PyList_New(0);
+  if (frames != nullptr &&
+      !self->scanner->Process(static_cast<const uint8_t*>(buffer.buf),
+                              size_t(buffer.len),
+                              frames)) {
+    Py_CLEAR(frames);
+  }
+
+  PyBuffer_Release(&buffer);
+  return frames;
+}
+
+PyMethodDef frame_scanner_methods[] = {
+    {"process",
+     FrameScanner_process,
+     METH_O,
+     "process(data) -> list[tuple[bytes, bytes, bool]]\n\n"
+     "Scans a bytes-like object for HDLC frames. Returns a list of\n"
+     "(raw_encoded, raw_decoded, complete) tuples, one per frame that ended\n"
+     "in the data. complete is False if the frame had a framing error."},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+PyType_Slot frame_scanner_slots[] = {
+    {Py_tp_doc, const_cast<char*>("Splits a stream of HDLC data into frames.")},
+    {Py_tp_new, reinterpret_cast<void*>(FrameScanner_new)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(FrameScanner_dealloc)},
+    {Py_tp_methods, frame_scanner_methods},
+    {0, nullptr},
+};
+
+PyType_Spec frame_scanner_spec = {
+    "pw_hdlc._native_decode.FrameScanner",
+    sizeof(FrameScannerObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    frame_scanner_slots,
+};
+
+PyModuleDef native_decode_module = {
+    PyModuleDef_HEAD_INIT,
+    "pw_hdlc._native_decode",
+    "Native HDLC frame scanning for pw_hdlc.decode.",
+    -1,
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+};
+
+}  // namespace
+
+PyMODINIT_FUNC PyInit__native_decode() {
+  PyObject* module = PyModule_Create(&native_decode_module);
+  if (module == nullptr) {
+    return nullptr;
+  }
+
+  PyObject* frame_scanner_type = PyType_FromSpec(&frame_scanner_spec);
+  if (frame_scanner_type == nullptr ||
+      PyModule_AddObject(module, "FrameScanner", frame_scanner_type) != 0) {
+    Py_XDECREF(frame_scanner_type);
+    Py_DECREF(module);
+    return nullptr;
+  }
+  return module;
+}
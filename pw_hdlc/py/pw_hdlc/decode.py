@@ -15,13 +15,22 @@
 
 import enum
 import logging
-from typing import Iterator, Optional
+from typing import Iterator, List, Optional
 import zlib
 
 from pw_hdlc import protocol
 
+try:
+    from pw_hdlc import _native_decode  # type: ignore
+except ImportError:
+    _native_decode = None
+
 _LOG = logging.getLogger('pw_hdlc')
 
+# True if the native frame scanner extension was built. If it is not
+# available, FrameDecoder uses a pure-Python implementation.
+NATIVE_DECODER_AVAILABLE = _native_decode is not None
+
 NO_ADDRESS = -1
 _MIN_FRAME_SIZE = 6  # 1 B address + 1 B control + 4 B CRC-32
 
@@ -105,7 +114,22 @@ def _check_frame(frame_data: bytes) -> FrameStatus:
 
 class FrameDecoder:
     """Decodes one or more HDLC frames from a stream of data."""
-    def __init__(self):
+    def __init__(self, native: Optional[bool] = None):
+        """Creates a decoder.
+
+        Arguments:
+            native: Whether to scan data with the native extension, which is
+                much faster than the pure-Python implementation. By default,
+                the extension is used if it is available. Raises ImportError
+                if True and the extension is not available.
+        """
+        if native is None:
+            native = NATIVE_DECODER_AVAILABLE
+        elif native and not NATIVE_DECODER_AVAILABLE:
+            raise ImportError('The pw_hdlc native decoder was not built')
+
+        self._native = _native_decode.FrameScanner() if native else None
+
         self._decoded_data = bytearray()
         self._raw_data = bytearray()
         self._state = _State.INTERFRAME
@@ -119,11 +143,31 @@ class FrameDecoder:
         Yields:
           Frames, which may be valid (frame.ok()) or corrupt (!frame.ok())
         """
+        if self._native is not None:
+            yield from self.process_all(data)
+            return
+
         for byte in data:
             frame = self._process_byte(byte)
             if frame:
                 yield frame
 
+    def process_all(self, data: bytes) -> List[Frame]:
+        """Decodes all of data at once and returns the frames that ended in it.
+
+        This is equivalent to list(process(data)), but avoids the overhead of
+        a generator when decoding large reads.
+        """
+        if self._native is None:
+            return list(self.process(data))
+
+        return [
+            Frame(raw, decoded,
+                  _check_frame(decoded) if complete else
+                  FrameStatus.FRAMING_ERROR)
+            for raw, decoded, complete in self._native.process(data)
+        ]
+
     def process_valid_frames(self, data: bytes) -> Iterator[Frame]:
         """Decodes and yields valid HDLC frames, logging any errors."""
         for frame in self.process(data):
@@ -0,0 +1,159 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Runs pw_rpc benchmarks against a device over HDLC.
+
+The device must register the pw.rpc.Benchmark service on each channel used.
+Connect with a serial port or a socket, and results are written as JSON:
+
+  python -m pw_hdlc.rpc_benchmark --device /dev/ttyUSB0 \\
+      --payload-sizes 16 64 --iterations 500
+
+  python -m pw_hdlc.rpc_benchmark --socket-addr localhost:33000 \\
+      --channels 1 2 3 4 --concurrency 4 --benchmarks unary_echo
+"""
+
+import argparse
+import json
+import logging
+import socket
+import sys
+from typing import Any, Callable, List, Sequence, Tuple
+
+import serial  # type: ignore
+
+import pw_cli.log
+import pw_rpc
+from pw_rpc import benchmark, benchmark_pb2, callback_client
+
+from pw_hdlc.rpc import HdlcRpcClient, channel_output
+
+_LOG = logging.getLogger(__name__)
+
+BENCHMARKS = ('unary_echo', 'bidirectional_echo', 'server_stream',
+              'client_stream')
+
+
+def _parse_args():
+    """Parses and returns the command line arguments."""
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    group = parser.add_mutually_exclusive_group(required=True)
+    group.add_argument('-d', '--device', help='the serial port to use')
+    group.add_argument('-s',
+                       '--socket-addr',
+                       help='the server address as host:port')
+    parser.add_argument('-b',
+                        '--baudrate',
+                        type=int,
+                        default=115200,
+                        help='the baud rate to use')
+    parser.add_argument('--channels',
+                        type=int,
+                        nargs='+',
+                        default=[1],
+                        help='the RPC channel IDs to use')
+    parser.add_argument('--benchmarks',
+                        nargs='+',
+                        choices=BENCHMARKS,
+                        default=BENCHMARKS,
+                        help='the benchmarks to run')
+    parser.add_argument('--payload-sizes',
+                        type=int,
+                        nargs='+',
+                        default=[16, 64, 128],
+                        help='the payload sizes to test, in bytes')
+    parser.add_argument('--iterations',
+                        type=int,
+                        default=100,
+                        help='payloads to send or receive per channel')
+    parser.add_argument('--concurrency',
+                        type=int,
+                        default=1,
+                        help='calls to run at once; at most one per channel')
+    parser.add_argument('--timeout',
+                        type=float,
+                        default=benchmark.DEFAULT_TIMEOUT_S,
+                        help='seconds to wait for each response')
+    parser.add_argument('-o',
+                        '--output',
+                        type=argparse.FileType('w'),
+                        default=sys.stdout,
+                        help='the file to which to write the JSON results')
+    return parser.parse_args()
+
+
+def _connect(device: str, baudrate: int, socket_addr: str
+             ) -> Tuple[Callable[[], bytes], Callable[[bytes], Any]]:
+    """Returns read and write functions for the serial port or socket."""
+    if socket_addr is None:
+        serial_device = serial.Serial(device, baudrate, timeout=1)
+        return lambda: serial_device.read(8192), serial_device.write
+
+    host, port = socket_addr.rsplit(':', 1)
+    sock = socket.create_connection((host, int(port)))
+    return lambda: sock.recv(4096), sock.sendall
+
+
+def run_benchmarks(bench: benchmark.Benchmark, benchmarks: Sequence[str],
+                   payload_sizes: Sequence[int], iterations: int,
+                   concurrency: int) -> List[benchmark.BenchmarkResult]:
+    """Runs each benchmark with each payload size."""
+    results = []
+
+    for name in benchmarks:
+        for payload_size in payload_sizes:
+            _LOG.info('Running %s with %d B payloads', name, payload_size)
+            result = getattr(bench, name)(payload_size, iterations,
+                                          concurrency)
+            if result.failures:
+                _LOG.warning('%s had %d failures', name, result.failures)
+            results.append(result)
+
+    return results
+
+
+def main(device: str, socket_addr: str, baudrate: int, channels: List[int],
+         benchmarks: Sequence[str], payload_sizes: Sequence[int],
+         iterations: int, concurrency: int, timeout: float, output) -> int:
+    """Connects to the device, runs the benchmarks, and reports results."""
+    pw_cli.log.install()
+
+    read, write = _connect(device, baudrate, socket_addr)
+    client = HdlcRpcClient(
+        read, [benchmark_pb2],
+        [pw_rpc.Channel(i, channel_output(write)) for i in channels],
+        lambda data: _LOG.info('%s', data.decode(errors='replace')),
+        callback_client.Impl(default_unary_timeout_s=timeout,
+                             default_stream_timeout_s=timeout))
+
+    try:
+        bench = benchmark.Benchmark.from_client(client.client, channels,
+                                                timeout)
+        results = run_benchmarks(bench, benchmarks, payload_sizes, iterations,
+                                 concurrency)
+    except ValueError as err:
+        _LOG.error('%s', err)
+        return 1
+
+    json.dump({'benchmarks': [r.summary() for r in results]},
+              output,
+              indent=2)
+    output.write('\n')
+
+    return 0 if all(not r.failures for r in results) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main(**vars(_parse_args())))
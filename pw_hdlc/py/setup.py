@@ -15,4 +15,11 @@
 
 import setuptools  # type: ignore
 
-setuptools.setup()  # Package definition in setup.cfg
+# Package definition in setup.cfg. The native decoder is optional; if it cannot
+# be built, pw_hdlc.decode falls back to its pure-Python implementation.
+setuptools.setup(ext_modules=[
+    setuptools.Extension('pw_hdlc._native_decode',
+                         sources=['pw_hdlc/_native_decode.cc'],
+                         extra_compile_args=['-std=c++17'],
+                         optional=True),
+])
@@ -151,5 +151,50 @@ TEST(RpcChannelOutputBuffer, MultibyteAddress) {
       0);
 }
 
+TEST(RpcChannelOutput, StartPacket_WritesSameFrameAsBuffer) {
+  std::array<byte, kSinkBufferSize> channel_output_buffer;
+  stream::MemoryWriterBuffer<kSinkBufferSize> memory_writer;
+
+  RpcChannelOutput output(
+      memory_writer, channel_output_buffer, kAddress, "RpcChannelOutput");
+
+  auto buffer = output.AcquireBuffer();
+  stream::Writer* writer = output.StartPacket();
+  ASSERT_NE(writer, nullptr);
+  EXPECT_EQ(OkStatus(), writer->Write(bytes::String("A")));
+  EXPECT_EQ(OkStatus(), writer->Write(bytes::Array<0x7D>()));
+  EXPECT_EQ(OkStatus(), output.FinishPacket(OkStatus()));
+  EXPECT_EQ(OkStatus(), output.SendAndReleaseBuffer(buffer.first(0)));
+
+  stream::MemoryWriterBuffer<kSinkBufferSize> expected;
+  ASSERT_EQ(OkStatus(),
+            WriteUIFrame(kAddress, bytes::String("A\x7d"), expected));
+
+  ASSERT_EQ(memory_writer.bytes_written(), expected.bytes_written());
+  EXPECT_EQ(
+      std::memcmp(
+          memory_writer.data(), expected.data(), memory_writer.bytes_written()),
+      0);
+}
+
+TEST(RpcChannelOutputBuffer, FinishPacket_WriteFailed_FrameNotTerminated) {
+  stream::MemoryWriterBuffer<kSinkBufferSize> memory_writer;
+
+  RpcChannelOutputBuffer<kSinkBufferSize> output(
+      memory_writer, kAddress, "RpcChannelOutput");
+
+  auto buffer = output.AcquireBuffer();
+  stream::Writer* writer = output.StartPacket();
+  ASSERT_NE(writer, nullptr);
+  EXPECT_EQ(OkStatus(), writer->Write(bytes::String("A")));
+  EXPECT_EQ(Status::DataLoss(), output.FinishPacket(Status::DataLoss()));
+  EXPECT_EQ(OkStatus(), output.SendAndReleaseBuffer(buffer.first(0)));
+
+  // Only the frame header and data were written, without an FCS or flag.
+  EXPECT_EQ(memory_writer.bytes_written(), 4u);
+  EXPECT_EQ(memory_writer.data()[0], kFlag);
+  EXPECT_NE(memory_writer.data()[3], kFlag);
+}
+
 }  // namespace
 }  // namespace pw::hdlc
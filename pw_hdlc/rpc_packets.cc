@@ -14,10 +14,64 @@
 
 #include "pw_hdlc/rpc_packets.h"
 
+#include <array>
+#include <atomic>
+
 #include "pw_status/try.h"
+#include "pw_sys_io/async.h"
 #include "pw_sys_io/sys_io.h"
 
 namespace pw::hdlc {
+namespace {
+
+void ProcessByte(rpc::Server& server,
+                 rpc::ChannelOutput& output,
+                 Decoder& decoder,
+                 unsigned rpc_address,
+                 std::byte data) {
+  if (auto result = decoder.Process(data); result.ok()) {
+    Frame& frame = result.value();
+    if (frame.address() == rpc_address) {
+      server.ProcessPacket(frame.data(), output)
+          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    }
+  }
+}
+
+// Passes received data from the sys_io read callback, which may run in an
+// interrupt, to the decoding loop. Only one thread may push and one may pop.
+class ReceivedDataQueue {
+ public:
+  // Returns false if the queue is full, in which case the data is dropped.
+  bool Push(std::span<const std::byte> data) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == entries_.size()) {
+      return false;
+    }
+    entries_[tail % entries_.size()] = data;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Pop(std::span<const std::byte>& data) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    data = entries_[head % entries_.size()];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  // Each half of the receive buffer may be delivered in several parts if the
+  // line goes idle before it fills.
+  std::array<std::span<const std::byte>, 8> entries_;
+  std::atomic<size_t> head_ = 0;
+  std::atomic<size_t> tail_ = 0;
+};
+
+}  // namespace
 
 Status ReadAndProcessPackets(rpc::Server& server,
                              rpc::ChannelOutput& output,
@@ -28,13 +82,38 @@ Status ReadAndProcessPackets(rpc::Server& server,
   while (true) {
     std::byte data;
     PW_TRY(sys_io::ReadByte(&data));
+    ProcessByte(server, output, decoder, rpc_address, data);
+  }
+}
+
+Status ReadAndProcessPackets(rpc::Server& server,
+                             rpc::ChannelOutput& output,
+                             std::span<std::byte> decode_buffer,
+                             std::span<std::byte> receive_buffer,
+                             unsigned rpc_address) {
+  ReceivedDataQueue queue;
+  const size_t half_size = receive_buffer.size() / 2;
 
-    if (auto result = decoder.Process(data); result.ok()) {
-      Frame& frame = result.value();
-      if (frame.address() == rpc_address) {
-        server.ProcessPacket(frame.data(), output)
-            .IgnoreError();  // TODO(pwbug/387): Handle Status properly
-      }
+  // Dropped data corrupts the frame being received, which the decoder detects
+  // and discards.
+  const Status status = sys_io::StartReadAsync(
+      receive_buffer.first(half_size),
+      receive_buffer.subspan(half_size, half_size),
+      [&queue](std::span<const std::byte> data) { queue.Push(data); });
+  if (status.IsUnimplemented()) {
+    return ReadAndProcessPackets(server, output, decode_buffer, rpc_address);
+  }
+  PW_TRY(status);
+
+  Decoder decoder(decode_buffer);
+  std::span<const std::byte> data;
+
+  while (true) {
+    if (!queue.Pop(data)) {
+      continue;
+    }
+    for (std::byte byte : data) {
+      ProcessByte(server, output, decoder, rpc_address, byte);
     }
   }
 }
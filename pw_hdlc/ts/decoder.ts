@@ -15,7 +15,6 @@
 /** Decoder class for decoding bytes using HDLC protocol */
 
 import * as protocol from './protocol';
-import * as util from './util';
 
 const _MIN_FRAME_SIZE = 6; // 1 B address + 1 B control + 4 B CRC-32
 
@@ -72,6 +71,36 @@ export class Frame {
   }
 }
 
+/**
+ * A growable byte buffer. Appending a byte copies the buffer only when it is
+ * full, and the capacity doubles each time, so decoding a frame is linear in
+ * its length.
+ */
+class ByteBuffer {
+  private buffer = new Uint8Array(64);
+  private size = 0;
+
+  get length(): number {
+    return this.size;
+  }
+
+  push(byte: number): void {
+    if (this.size === this.buffer.length) {
+      const grown = new Uint8Array(this.buffer.length * 2);
+      grown.set(this.buffer);
+      this.buffer = grown;
+    }
+    this.buffer[this.size++] = byte;
+  }
+
+  /** Returns a copy of the buffered bytes and empties the buffer. */
+  take(): Uint8Array {
+    const bytes = this.buffer.slice(0, this.size);
+    this.size = 0;
+    return bytes;
+  }
+}
+
 enum DecoderState {
   INTERFRAME,
   FRAME,
@@ -80,8 +109,8 @@ enum DecoderState {
 
 /** Decodes one or more HDLC frames from a stream of data. */
 export class Decoder {
-  private decodedData = new Uint8Array();
-  private rawData = new Uint8Array();
+  private decodedData = new ByteBuffer();
+  private rawData = new ByteBuffer();
   private state = DecoderState.INTERFRAME;
 
   constructor() {}
@@ -139,14 +168,11 @@ export class Decoder {
   }
 
   private finishFrame(status: FrameStatus): Frame {
-    const frame = new Frame(
-      new Uint8Array(this.rawData),
-      new Uint8Array(this.decodedData),
-      status
-    );
-    this.rawData = new Uint8Array();
-    this.decodedData = new Uint8Array();
-    return frame;
+    const decoded = this.decodedData.take();
+    if (status === FrameStatus.OK) {
+      status = this.checkFrame(decoded);
+    }
+    return new Frame(this.rawData.take(), decoded, status);
   }
 
   private processByte(byte: number): Frame | undefined {
@@ -154,7 +180,7 @@ export class Decoder {
 
     // Record every byte except the flag character.
     if (byte != protocol.FLAG) {
-      this.rawData = util.concatenate(this.rawData, Uint8Array.of(byte));
+      this.rawData.push(byte);
     }
 
     switch (this.state) {
@@ -170,15 +196,12 @@ export class Decoder {
       case DecoderState.FRAME:
         if (byte == protocol.FLAG) {
           if (this.rawData.length > 0) {
-            frame = this.finishFrame(this.checkFrame(this.decodedData));
+            frame = this.finishFrame(FrameStatus.OK);
           }
         } else if (byte == protocol.ESCAPE) {
           this.state = DecoderState.FRAME_ESCAPE;
         } else {
-          this.decodedData = util.concatenate(
-            this.decodedData,
-            Uint8Array.of(byte)
-          );
+          this.decodedData.push(byte);
         }
         break;
 
@@ -188,10 +211,7 @@ export class Decoder {
           this.state = DecoderState.FRAME;
         } else if (protocol.VALID_ESCAPED_BYTES.includes(byte)) {
           this.state = DecoderState.FRAME;
-          this.decodedData = util.concatenate(
-            this.decodedData,
-            Uint8Array.of(protocol.escape(byte))
-          );
+          this.decodedData.push(protocol.escape(byte));
         } else {
           this.state = DecoderState.INTERFRAME;
         }
@@ -16,6 +16,7 @@
 import 'jasmine';
 
 import {Decoder} from './decoder';
+import {Encoder} from './encoder';
 import * as protocol from './protocol';
 import * as util from './util';
 
@@ -53,4 +54,20 @@ describe('Decoder', () => {
     expect(frames[0].data).toEqual(expectedData);
     expect(frames[0].ok()).toBe(true);
   });
+
+  it('parses a large frame delivered in several chunks', () => {
+    const payload = new Uint8Array(1000).map((_, i) => i);
+    const frameData = new Encoder().uiFrame(1, payload);
+
+    const frames = [
+      ...decoder.process(frameData.slice(0, 300)),
+      ...decoder.process(frameData.slice(300, 700)),
+      ...decoder.process(frameData.slice(700)),
+    ];
+
+    expect(frames.length).toEqual(1);
+    expect(frames[0].ok()).toBe(true);
+    expect(frames[0].address).toEqual(1);
+    expect(frames[0].data).toEqual(payload);
+  });
 });
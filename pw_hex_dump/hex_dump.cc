@@ -14,11 +14,14 @@
 
 #include "pw_hex_dump/hex_dump.h"
 
-#include <cctype>
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstring>
 #include <string_view>
 
 #include "pw_status/status_with_size.h"
+#include "pw_status/try.h"
 #include "pw_string/string_builder.h"
 #include "pw_string/type_to_string.h"
 
@@ -37,11 +40,45 @@ constexpr const std::string_view kAsciiHeader("Text");
 // Minimum number of hex characters to use when displaying dump offset.
 constexpr const size_t kMinOffsetChars = 4;
 
+// The two hex digits for each byte value. Looking up both digits at once
+// avoids formatting each nibble separately.
+constexpr std::array<std::array<char, 2>, 256> kHexPairs = [] {
+  constexpr char kDigits[] = "0123456789abcdef";
+  std::array<std::array<char, 2>, 256> pairs{};
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    pairs[i][0] = kDigits[i >> 4];
+    pairs[i][1] = kDigits[i & 0xF];
+  }
+  return pairs;
+}();
+
 char PrintableChar(std::byte b) {
-  if (std::isprint(std::to_integer<char>(b)) == 0) {
-    return '.';
+  const char c = std::to_integer<char>(b);
+  return (c >= ' ' && c <= '~') ? c : '.';
+}
+
+const char* HexPair(std::byte b) {
+  return kHexPairs[std::to_integer<uint8_t>(b)].data();
+}
+
+// Writes each byte as two hex digits, four bytes per iteration, and returns
+// the position after the last character written.
+char* WriteHex(const std::byte* data, size_t size, char* out) {
+  for (; size >= 4u; size -= 4, data += 4, out += 8) {
+    std::memcpy(out, HexPair(data[0]), 2);
+    std::memcpy(out + 2, HexPair(data[1]), 2);
+    std::memcpy(out + 4, HexPair(data[2]), 2);
+    std::memcpy(out + 6, HexPair(data[3]), 2);
   }
-  return std::to_integer<char>(b);
+  for (; size > 0u; --size, ++data, out += 2) {
+    std::memcpy(out, HexPair(*data), 2);
+  }
+  return out;
+}
+
+char* WriteString(std::string_view str, char* out) {
+  std::memcpy(out, str.data(), str.size());
+  return out + str.size();
 }
 
 void AddGroupingByte(size_t byte_index,
@@ -80,7 +117,7 @@ Status DumpAddr(std::span<char> dest, uintptr_t addr) {
   return IntToHexString(addr, dest.subspan(2), sizeof(uintptr_t) * 2).status();
 }
 
-Status FormattedHexDumper::PrintFormatHeader() {
+StatusWithSize FormattedHexDumper::PrintFormatHeader() {
   StringBuilder builder(dest_);
 
   if (flags.prefix_mode != AddressMode::kDisabled) {
@@ -88,14 +125,9 @@ Status FormattedHexDumper::PrintFormatHeader() {
                                 ? kOffsetHeader
                                 : kAddressHeader);
     // Pad to align to address width.
-    size_t padding = 0;
-    if (flags.prefix_mode == AddressMode::kOffset) {
-      size_t offs_width =
-          HexDigitCount(source_data_.size_bytes() + current_offset_);
-      padding = std::max(offs_width, kMinOffsetChars);
-    } else {
-      padding = kHexAddrStringSize;
-    }
+    size_t padding = flags.prefix_mode == AddressMode::kOffset
+                         ? OffsetWidth()
+                         : kHexAddrStringSize;
 
     padding += kAddressSeparator.length();
     padding -= header.size();
@@ -128,16 +160,32 @@ Status FormattedHexDumper::PrintFormatHeader() {
     builder << kAsciiHeader;
   }
 
-  return builder.status();
+  return builder.status_with_size();
 }
 
-Status FormattedHexDumper::DumpLine() {
+Status FormattedHexDumper::DumpLine() { return WriteLine().status(); }
+
+Status FormattedHexDumper::DumpTo(stream::Writer& writer) {
+  while (!source_data_.empty()) {
+    const StatusWithSize line = WriteLine();
+    PW_TRY(line.status());
+
+    // Replace the null terminator with a newline and write the whole line at
+    // once.
+    dest_[line.size()] = '\n';
+    PW_TRY(writer.Write(dest_.data(), line.size() + 1));
+  }
+  return OkStatus();
+}
+
+StatusWithSize FormattedHexDumper::WriteLine() {
   if (source_data_.empty()) {
-    return Status::ResourceExhausted();
+    return StatusWithSize::ResourceExhausted();
   }
 
-  if (!ValidateBufferSize().ok() || dest_.data() == nullptr) {
-    return Status::FailedPrecondition();
+  if (!ValidateBufferSize().ok() || dest_.data() == nullptr ||
+      flags.bytes_per_line == 0) {
+    return StatusWithSize::FailedPrecondition();
   }
 
   if (dest_[0] == 0 && flags.show_header) {
@@ -145,67 +193,57 @@ Status FormattedHexDumper::DumpLine() {
     return PrintFormatHeader();
   }
 
-  StringBuilder builder(dest_);
+  // ValidateBufferSize() guarantees that the longest possible line fits, so
+  // the line is written directly to the buffer.
+  char* out = dest_.data();
+
   // Dump address/offset prefix.
-  // TODO(amontanez): This block can be much nicer if StringBuilder exposed an
-  // easy way to control zero padding for hex address.
-  if (flags.prefix_mode != AddressMode::kDisabled) {
-    uintptr_t val;
-    if (flags.prefix_mode == AddressMode::kAbsolute) {
-      val = reinterpret_cast<uintptr_t>(source_data_.data());
-      builder << "0x";
-      uint8_t significant = HexDigitCount(val);
-      builder.append(sizeof(uintptr_t) * 2 - significant, '0');
-    } else {
-      val = current_offset_;
-      size_t significant =
-          HexDigitCount(source_data_.size_bytes() + current_offset_);
-      if (significant < kMinOffsetChars) {
-        builder.append(kMinOffsetChars - significant, '0');
-      }
-    }
-    if (val != 0) {
-      builder << reinterpret_cast<void*>(val);
-    } else {
-      builder.append(2, '0');
-    }
-    builder << kAddressSeparator;
+  if (flags.prefix_mode == AddressMode::kAbsolute) {
+    DumpAddr(dest_, source_data_.data()).IgnoreError();
+    out += kHexAddrStringSize;
+    out = WriteString(kAddressSeparator, out);
+  } else if (flags.prefix_mode == AddressMode::kOffset) {
+    out += IntToHexString(current_offset_, dest_, OffsetWidth()).size();
+    out = WriteString(kAddressSeparator, out);
   }
 
-  size_t bytes_in_line = std::min(source_data_.size_bytes(),
-                                  static_cast<size_t>(flags.bytes_per_line));
-  // Convert raw bytes to hex characters.
-  for (size_t i = 0; i < bytes_in_line; ++i) {
-    // Early loop termination for when bytes_remaining <
-    // bytes_per_line.
-    uint8_t c = std::to_integer<uint8_t>(source_data_[i]);
-    // TODO(amontanez): Maybe StringBuilder can be augmented to support full-
-    // width bytes? (`04` instead of `4`, for example)
-    builder << std::byte(c >> 4);
-    builder << std::byte(c & 0xF);
-    AddGroupingByte(i, flags, builder);
+  const size_t bytes_in_line = std::min(
+      source_data_.size_bytes(), static_cast<size_t>(flags.bytes_per_line));
+  const size_t group_size =
+      flags.group_every == 0 ? flags.bytes_per_line : flags.group_every;
+
+  // Convert raw bytes to hex characters, one group at a time.
+  for (size_t i = 0; i < bytes_in_line; i += group_size) {
+    if (i != 0u) {
+      *out++ = ' ';
+    }
+    const size_t group_bytes = std::min(group_size, bytes_in_line - i);
+    out = WriteHex(&source_data_[i], group_bytes, out);
   }
-  // Add padding spaces to ensure lines are aligned.
+
   if (flags.show_ascii) {
+    // Add padding spaces to ensure lines are aligned.
     for (size_t i = bytes_in_line;
          i < static_cast<size_t>(flags.bytes_per_line);
          ++i) {
-      builder.append(2, ' ');
-      AddGroupingByte(i, flags, builder);
+      if (i != 0u && i % group_size == 0u) {
+        *out++ = ' ';
+      }
+      *out++ = ' ';
+      *out++ = ' ';
     }
-  }
 
-  // Interpret bytes as characters.
-  if (flags.show_ascii) {
-    builder << kSectionSeparator;
+    // Interpret bytes as characters.
+    out = WriteString(kSectionSeparator, out);
     for (size_t i = 0; i < bytes_in_line; ++i) {
-      builder << PrintableChar(source_data_[i]);
+      *out++ = PrintableChar(source_data_[i]);
     }
   }
+  *out = '\0';
 
   source_data_ = source_data_.subspan(bytes_in_line);
   current_offset_ += bytes_in_line;
-  return builder.status();
+  return StatusWithSize(out - dest_.data());
 }
 
 Status FormattedHexDumper::SetLineBuffer(std::span<char> dest) {
@@ -228,6 +266,14 @@ Status FormattedHexDumper::BeginDump(ConstByteSpan data) {
   return ValidateBufferSize().ok() ? OkStatus() : Status::FailedPrecondition();
 }
 
+size_t FormattedHexDumper::OffsetWidth() const {
+  // The total size of the dump does not change as lines are dumped, so every
+  // offset in the dump has the same width.
+  return std::max<size_t>(
+      HexDigitCount(source_data_.size_bytes() + current_offset_),
+      kMinOffsetChars);
+}
+
 Status FormattedHexDumper::ValidateBufferSize() {
   // Minimum size is number of bytes per line as hex pairs plus the null
   // terminator.
@@ -239,8 +285,7 @@ Status FormattedHexDumper::ValidateBufferSize() {
     required_size += kHexAddrStringSize;
     required_size += kAddressSeparator.length();
   } else if (flags.prefix_mode == AddressMode::kOffset) {
-    required_size +=
-        HexDigitCount(std::max(source_data_.size_bytes(), kMinOffsetChars));
+    required_size += OffsetWidth();
     required_size += kAddressSeparator.length();
   }
   if (flags.group_every != 0) {
@@ -23,6 +23,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_log/log.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::dump {
 namespace {
@@ -356,6 +357,67 @@ TEST_F(HexDump, FormattedHexDump_AbsolutePrefix) {
   EXPECT_STREQ(expected2.data(), dest_.data());
 }
 
+TEST_F(HexDump, FormattedHexDump_ShortLastLine_NoTrailingSpace) {
+  constexpr const char* expected = "18";
+
+  dumper_ = FormattedHexDumper(dest_, default_flags_);
+  EXPECT_TRUE(dumper_.BeginDump(source_data).ok());
+  EXPECT_TRUE(dumper_.DumpLine().ok());
+  EXPECT_TRUE(dumper_.DumpLine().ok());
+  EXPECT_TRUE(dumper_.DumpLine().ok());
+  EXPECT_STREQ(expected, dest_.data());
+}
+
+TEST_F(HexDump, FormattedHexDump_OffsetPrefix_WidthMatchesDumpSize) {
+  static std::array<std::byte, 0x10010> large_data = {};
+
+  default_flags_.bytes_per_line = 16;
+  default_flags_.prefix_mode = FormattedHexDumper::AddressMode::kOffset;
+  dumper_ = FormattedHexDumper(dest_, default_flags_);
+
+  EXPECT_TRUE(dumper_.BeginDump(large_data).ok());
+  EXPECT_TRUE(dumper_.DumpLine().ok());
+  dest_[5] = '\0';
+  EXPECT_STREQ("00000", dest_.data());
+
+  for (size_t i = 1; i < large_data.size() / 16; ++i) {
+    ASSERT_TRUE(dumper_.DumpLine().ok());
+  }
+  dest_[5] = '\0';
+  EXPECT_STREQ("10000", dest_.data());
+}
+
+TEST_F(HexDump, FormattedHexDump_DumpTo) {
+  constexpr std::string_view expected =
+      " 0        4        Text\n"
+      "6d792074 65737420  my test \n"
+      "73747269 6e670a    string.\n";
+
+  default_flags_.bytes_per_line = 8;
+  default_flags_.group_every = 4;
+  default_flags_.show_ascii = true;
+  default_flags_.show_header = true;
+  dumper_ = FormattedHexDumper(dest_, default_flags_);
+
+  std::array<std::byte, 128> output;
+  stream::MemoryWriter writer(output);
+  EXPECT_TRUE(dumper_.BeginDump(short_string).ok());
+  EXPECT_EQ(OkStatus(), dumper_.DumpTo(writer));
+  EXPECT_EQ(expected,
+            std::string_view(reinterpret_cast<const char*>(writer.data()),
+                             writer.bytes_written()));
+  EXPECT_EQ(Status::ResourceExhausted(), dumper_.DumpLine());
+}
+
+TEST_F(HexDump, FormattedHexDump_DumpTo_WriterError) {
+  dumper_ = FormattedHexDumper(dest_, default_flags_);
+
+  std::array<std::byte, 40> output;
+  stream::MemoryWriter writer(output);
+  EXPECT_TRUE(dumper_.BeginDump(source_data).ok());
+  EXPECT_EQ(Status::ResourceExhausted(), dumper_.DumpTo(writer));
+}
+
 TEST_F(SmallBuffer, TinyHexDump) {
   constexpr const char* expected = "a4cc32";
 
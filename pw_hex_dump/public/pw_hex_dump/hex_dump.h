@@ -19,6 +19,8 @@
 
 #include "pw_bytes/span.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
 
 namespace pw::dump {
 
@@ -146,9 +148,31 @@ class FormattedHexDumper {
   //     formatting configuration.
   Status DumpLine();
 
+  // Dumps all remaining lines to the writer, including the header if it has
+  // not been dumped yet. Each line is followed by a newline. The line buffer
+  // is used as scratch space, so each line is written with a single Write()
+  // call.
+  //
+  // Example usage:
+  //
+  //   std::array<char, 80> temp;
+  //   FormattedHexDumper hex_dumper(temp);
+  //   hex_dumper.BeginDump(my_data);
+  //   hex_dumper.DumpTo(uart_writer);
+  //
+  // Returns:
+  //   OK - All the data has been dumped.
+  //   FAILED_PRECONDITION - Destination line buffer is too small to fit current
+  //     formatting configuration.
+  //   Any error returned by the writer.
+  Status DumpTo(stream::Writer& writer);
+
  private:
+  // Writes the next line to the line buffer and returns its length.
+  StatusWithSize WriteLine();
   Status ValidateBufferSize();
-  Status PrintFormatHeader();
+  StatusWithSize PrintFormatHeader();
+  size_t OffsetWidth() const;
 
   size_t current_offset_;
   std::span<char> dest_;
@@ -0,0 +1,200 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/cached_register_device.h"
+
+#include <algorithm>
+
+#include "pw_assert/check.h"
+#include "pw_status/try.h"
+
+namespace pw::i2c {
+
+CachedRegisterDevice::CachedRegisterDevice(RegisterDevice& device,
+                                           uint32_t first_register,
+                                           ByteSpan values,
+                                           std::span<uint8_t> flags,
+                                           ByteSpan write_buffer)
+    : device_(device),
+      first_register_(first_register),
+      values_(values),
+      flags_(flags),
+      write_buffer_(write_buffer) {
+  PW_CHECK_UINT_EQ(values.size(), flags.size());
+  PW_CHECK_UINT_GE(write_buffer.size(), values.size() + sizeof(uint32_t));
+  std::fill(flags_.begin(), flags_.end(), uint8_t(0));
+}
+
+Status CachedRegisterDevice::SetVolatile(uint32_t register_address,
+                                         size_t count) {
+  PW_TRY_ASSIGN(const size_t index, Index(register_address, count));
+  for (size_t i = index; i < index + count; ++i) {
+    flags_[i] = kVolatile;
+  }
+  return OkStatus();
+}
+
+Result<std::byte> CachedRegisterDevice::ReadRegister(
+    uint32_t register_address, chrono::SystemClock::duration timeout) {
+  std::byte value;
+  PW_TRY(ReadRegisters(register_address, std::span(&value, 1), timeout));
+  return value;
+}
+
+Status CachedRegisterDevice::ReadRegisters(
+    uint32_t register_address,
+    ByteSpan return_data,
+    chrono::SystemClock::duration timeout) {
+  PW_TRY_ASSIGN(const size_t index,
+                Index(register_address, return_data.size()));
+  const size_t end = index + return_data.size();
+  if (return_data.empty()) {
+    return OkStatus();
+  }
+
+  bool cached = true;
+  for (size_t i = index; i < end; ++i) {
+    if (Has(i, kVolatile) || !Has(i, kValid)) {
+      cached = false;
+      break;
+    }
+  }
+
+  if (cached) {
+    std::copy(values_.begin() + index,
+              values_.begin() + end,
+              return_data.begin());
+    cache_hits_.Increment();
+    return OkStatus();
+  }
+
+  bus_reads_.Increment();
+  PW_TRY(device_.ReadRegisters(register_address, return_data, timeout));
+
+  for (size_t i = index; i < end; ++i) {
+    std::byte& value = return_data[i - index];
+    if (Has(i, kDirty)) {
+      value = values_[i];  // The device has not seen the pending write yet.
+    } else if (!Has(i, kVolatile)) {
+      values_[i] = value;
+      flags_[i] |= kValid;
+    }
+  }
+  return OkStatus();
+}
+
+Status CachedRegisterDevice::WriteRegister(
+    uint32_t register_address,
+    std::byte register_data,
+    chrono::SystemClock::duration timeout) {
+  return WriteRegisters(
+      register_address, std::span(&register_data, 1), timeout);
+}
+
+Status CachedRegisterDevice::WriteRegisters(
+    uint32_t register_address,
+    ConstByteSpan register_data,
+    chrono::SystemClock::duration timeout) {
+  PW_TRY_ASSIGN(const size_t index,
+                Index(register_address, register_data.size()));
+  const size_t end = index + register_data.size();
+
+  const bool any_volatile = std::any_of(
+      flags_.begin() + index, flags_.begin() + end, [](uint8_t flags) {
+        return (flags & kVolatile) != 0u;
+      });
+  if (any_volatile) {
+    PW_TRY(Flush(timeout));
+    return WriteThrough(index, register_data, timeout);
+  }
+
+  for (size_t i = index; i < end; ++i) {
+    const std::byte value = register_data[i - index];
+    if (Has(i, kDirty) || (Has(i, kValid) && values_[i] == value)) {
+      // Overwrites a pending write, or leaves the register unchanged.
+      writes_coalesced_.Increment();
+    } else {
+      flags_[i] |= kValid | kDirty;
+    }
+    values_[i] = value;
+  }
+  return OkStatus();
+}
+
+Status CachedRegisterDevice::Flush(chrono::SystemClock::duration timeout) {
+  size_t start = 0;
+  while (start < values_.size()) {
+    if (!Has(start, kDirty)) {
+      start += 1;
+      continue;
+    }
+
+    size_t end = start + 1;
+    while (end < values_.size() && Has(end, kDirty)) {
+      end += 1;
+    }
+
+    PW_TRY(WriteThrough(
+        start, values_.subspan(start, end - start), timeout));
+    writes_coalesced_.Increment(end - start - 1);
+    start = end;
+  }
+  return OkStatus();
+}
+
+void CachedRegisterDevice::Invalidate() {
+  for (uint8_t& flags : flags_) {
+    flags &= kVolatile;
+  }
+}
+
+bool CachedRegisterDevice::has_pending_writes() const {
+  return std::any_of(flags_.begin(), flags_.end(), [](uint8_t flags) {
+    return (flags & kDirty) != 0u;
+  });
+}
+
+Result<size_t> CachedRegisterDevice::Index(uint32_t register_address,
+                                           size_t count) const {
+  if (register_address < first_register_) {
+    return Status::OutOfRange();
+  }
+  const size_t index = register_address - first_register_;
+  if (index > values_.size() || count > values_.size() - index) {
+    return Status::OutOfRange();
+  }
+  return index;
+}
+
+Status CachedRegisterDevice::WriteThrough(
+    size_t index, ConstByteSpan data, chrono::SystemClock::duration timeout) {
+  bus_writes_.Increment();
+  PW_TRY(device_.WriteRegisters(first_register_ + static_cast<uint32_t>(index),
+                                data,
+                                write_buffer_,
+                                timeout));
+
+  for (size_t i = 0; i < data.size(); ++i) {
+    const size_t register_index = index + i;
+    if (Has(register_index, kVolatile)) {
+      continue;
+    }
+    values_[register_index] = data[i];
+    flags_[register_index] |= kValid;
+    flags_[register_index] &= static_cast<uint8_t>(~kDirty);
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::i2c
@@ -0,0 +1,183 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/cached_register_device.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_i2c/address.h"
+#include "pw_i2c/initiator_mock.h"
+#include "pw_tokenizer/hash.h"
+
+using namespace std::literals::chrono_literals;
+
+namespace pw::i2c {
+namespace {
+
+constexpr Address kAddress = Address::SevenBit<0x42>();
+constexpr uint32_t kFirstRegister = 0x10;
+constexpr size_t kRegisters = 8;
+
+// Sets up a register device whose bus expects the given transactions.
+template <size_t kTransactions>
+class CachedRegisterDeviceTest {
+ public:
+  CachedRegisterDeviceTest(std::array<Transaction, kTransactions> transactions)
+      : transactions_(transactions),
+        initiator_(transactions_),
+        device_(initiator_,
+                kAddress,
+                std::endian::little,
+                RegisterAddressSize::k1Byte),
+        cache_(device_, kFirstRegister) {}
+
+  CachedRegisterDeviceBuffer<kRegisters>& cache() { return cache_; }
+
+  // Returns the value of the cache's metric with the given name.
+  uint32_t metric(const char* name) {
+    const metric::Token token = tokenizer::Hash(name) & _PW_METRIC_TOKEN_MASK;
+    for (const metric::Metric& m : cache_.metrics().metrics()) {
+      if (m.name() == token) {
+        return m.as_int();
+      }
+    }
+    ADD_FAILURE();
+    return 0;
+  }
+
+ private:
+  std::array<Transaction, kTransactions> transactions_;
+  MockInitiator initiator_;
+  RegisterDevice device_;
+  CachedRegisterDeviceBuffer<kRegisters> cache_;
+};
+
+TEST(CachedRegisterDevice, Read_CachesNonVolatileRegisters) {
+  static constexpr auto kRegister = bytes::Array<0x12>();
+  static constexpr auto kValues = bytes::Array<3, 4>();
+  CachedRegisterDeviceTest test(MakeExpectedTransactionArray(
+      {Transaction(OkStatus(), kAddress, kRegister, kValues)}));
+
+  std::array<std::byte, 2> data;
+  ASSERT_EQ(OkStatus(), test.cache().ReadRegisters(0x12, data, 1ms));
+  EXPECT_EQ(kValues, data);
+
+  // Served from the cache; the mock fails if another transaction occurs.
+  Result<std::byte> result = test.cache().ReadRegister(0x13, 1ms);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(std::byte{4}, result.value());
+
+  EXPECT_EQ(1u, test.metric("bus_reads"));
+  EXPECT_EQ(1u, test.metric("cache_hits"));
+}
+
+TEST(CachedRegisterDevice, Read_VolatileAlwaysReadsDevice) {
+  static constexpr auto kRegister = bytes::Array<0x10>();
+  static constexpr auto kFirstValue = bytes::Array<1>();
+  static constexpr auto kSecondValue = bytes::Array<2>();
+  CachedRegisterDeviceTest test(MakeExpectedTransactionArray(
+      {Transaction(OkStatus(), kAddress, kRegister, kFirstValue),
+       Transaction(OkStatus(), kAddress, kRegister, kSecondValue)}));
+  ASSERT_EQ(OkStatus(), test.cache().SetVolatile(0x10));
+
+  EXPECT_EQ(std::byte{1}, test.cache().ReadRegister(0x10, 1ms).value());
+  EXPECT_EQ(std::byte{2}, test.cache().ReadRegister(0x10, 1ms).value());
+  EXPECT_EQ(0u, test.metric("cache_hits"));
+}
+
+TEST(CachedRegisterDevice, Flush_CoalescesAdjacentWrites) {
+  static constexpr auto kFirstBurst = bytes::Array<0x10, 1, 2, 3>();
+  static constexpr auto kSecondBurst = bytes::Array<0x15, 9>();
+  CachedRegisterDeviceTest test(MakeExpectedTransactionArray(
+      {WriteTransaction(OkStatus(), kAddress, kFirstBurst),
+       WriteTransaction(OkStatus(), kAddress, kSecondBurst)}));
+
+  ASSERT_EQ(OkStatus(), test.cache().WriteRegister(0x12, std::byte{3}, 1ms));
+  ASSERT_EQ(OkStatus(), test.cache().WriteRegister(0x10, std::byte{1}, 1ms));
+  ASSERT_EQ(OkStatus(), test.cache().WriteRegister(0x11, std::byte{2}, 1ms));
+  ASSERT_EQ(OkStatus(), test.cache().WriteRegister(0x15, std::byte{7}, 1ms));
+  ASSERT_EQ(OkStatus(), test.cache().WriteRegister(0x15, std::byte{9}, 1ms));
+  EXPECT_TRUE(test.cache().has_pending_writes());
+  EXPECT_EQ(0u, test.metric("bus_writes"));
+
+  ASSERT_EQ(OkStatus(), test.cache().Flush(1ms));
+  EXPECT_FALSE(test.cache().has_pending_writes());
+  EXPECT_EQ(2u, test.metric("bus_writes"));
+  EXPECT_EQ(3u, test.metric("writes_coalesced"));
+
+  // Written registers are read from the cache after the flush.
+  EXPECT_EQ(std::byte{2}, test.cache().ReadRegister(0x11, 1ms).value());
+}
+
+TEST(CachedRegisterDevice, Write_UnchangedValueIsDropped) {
+  static constexpr auto kRegister = bytes::Array<0x10>();
+  static constexpr auto kValue = bytes::Array<5>();
+  CachedRegisterDeviceTest test(MakeExpectedTransactionArray(
+      {Transaction(OkStatus(), kAddress, kRegister, kValue)}));
+
+  EXPECT_EQ(std::byte{5}, test.cache().ReadRegister(0x10, 1ms).value());
+  ASSERT_EQ(OkStatus(), test.cache().WriteRegister(0x10, std::byte{5}, 1ms));
+  EXPECT_FALSE(test.cache().has_pending_writes());
+  ASSERT_EQ(OkStatus(), test.cache().Flush(1ms));
+  EXPECT_EQ(1u, test.metric("writes_coalesced"));
+}
+
+TEST(CachedRegisterDevice, Read_PendingWriteOverlaysDeviceData) {
+  static constexpr auto kRegister = bytes::Array<0x10>();
+  static constexpr auto kDeviceValues = bytes::Array<1, 2, 3>();
+  static constexpr auto kExpected = bytes::Array<1, 8, 3>();
+  CachedRegisterDeviceTest test(MakeExpectedTransactionArray(
+      {Transaction(OkStatus(), kAddress, kRegister, kDeviceValues)}));
+
+  ASSERT_EQ(OkStatus(), test.cache().WriteRegister(0x11, std::byte{8}, 1ms));
+
+  std::array<std::byte, 3> data;
+  ASSERT_EQ(OkStatus(), test.cache().ReadRegisters(0x10, data, 1ms));
+  EXPECT_EQ(kExpected, data);
+
+  test.cache().Invalidate();
+  EXPECT_FALSE(test.cache().has_pending_writes());
+}
+
+TEST(CachedRegisterDevice, WriteVolatile_FlushesPendingWritesFirst) {
+  static constexpr auto kConfigWrite = bytes::Array<0x10, 1>();
+  static constexpr auto kControlWrite = bytes::Array<0x17, 0x80>();
+  CachedRegisterDeviceTest test(MakeExpectedTransactionArray(
+      {WriteTransaction(OkStatus(), kAddress, kConfigWrite),
+       WriteTransaction(OkStatus(), kAddress, kControlWrite)}));
+  ASSERT_EQ(OkStatus(), test.cache().SetVolatile(0x17));
+
+  ASSERT_EQ(OkStatus(), test.cache().WriteRegister(0x10, std::byte{1}, 1ms));
+  ASSERT_EQ(OkStatus(),
+            test.cache().WriteRegister(0x17, std::byte{0x80}, 1ms));
+  EXPECT_FALSE(test.cache().has_pending_writes());
+}
+
+TEST(CachedRegisterDevice, OutsideCachedBlock_OutOfRange) {
+  CachedRegisterDeviceTest test(std::array<Transaction, 0>{});
+
+  std::array<std::byte, 2> data;
+  EXPECT_EQ(Status::OutOfRange(), test.cache().ReadRegisters(0x0f, data, 1ms));
+  EXPECT_EQ(Status::OutOfRange(), test.cache().ReadRegisters(0x17, data, 1ms));
+  EXPECT_EQ(Status::OutOfRange(),
+            test.cache().WriteRegister(0x18, std::byte{0}, 1ms));
+  EXPECT_EQ(Status::OutOfRange(), test.cache().SetVolatile(0x16, 3));
+}
+
+}  // namespace
+}  // namespace pw::i2c
@@ -0,0 +1,58 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/initiator.h"
+
+#include <algorithm>
+
+namespace pw::i2c {
+
+Status Initiator::DoWriteReadBatchFor(std::span<Operation> operations,
+                                      chrono::SystemClock::duration timeout) {
+  const chrono::SystemClock::time_point deadline =
+      chrono::SystemClock::TimePointAfterAtLeast(timeout);
+  Status result;
+
+  for (size_t i = 0; i < operations.size(); ++i) {
+    Operation& operation = operations[i];
+    const chrono::SystemClock::duration remaining =
+        deadline - chrono::SystemClock::now();
+
+    // The first operation is always attempted, like a single WriteReadFor()
+    // with a zero timeout.
+    if (i != 0u && remaining <= chrono::SystemClock::duration::zero()) {
+      operation.status = Status::DeadlineExceeded();
+    } else {
+      operation.status = DoWriteReadFor(
+          operation.device_address,
+          operation.write_buffer,
+          operation.read_buffer,
+          std::max(remaining, chrono::SystemClock::duration::zero()));
+    }
+    result.Update(operation.status);
+  }
+  return result;
+}
+
+Status Initiator::DoStartWriteReadBatch(std::span<Operation> operations,
+                                        chrono::SystemClock::duration timeout,
+                                        BatchCallback&& on_complete) {
+  const Status result = DoWriteReadBatchFor(operations, timeout);
+  if (on_complete != nullptr) {
+    on_complete(result);
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::i2c
@@ -0,0 +1,121 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/initiator.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_i2c/address.h"
+#include "pw_i2c/initiator_mock.h"
+
+using namespace std::literals::chrono_literals;
+
+namespace pw::i2c {
+namespace {
+
+constexpr Address kAddress1 = Address::SevenBit<0x01>();
+constexpr Address kAddress2 = Address::SevenBit<0x02>();
+constexpr Address kAddress3 = Address::SevenBit<0x03>();
+
+constexpr auto kRegister = bytes::Array<0x10>();
+constexpr auto kRead1 = bytes::Array<1, 2>();
+constexpr auto kRead3 = bytes::Array<3, 4, 5>();
+
+TEST(Initiator, WriteReadBatchFor_PerformsOperationsInOrder) {
+  auto expected_transactions = MakeExpectedTransactionArray(
+      {Transaction(OkStatus(), kAddress1, kRegister, kRead1),
+       WriteTransaction(OkStatus(), kAddress2, kRegister),
+       ReadTransaction(OkStatus(), kAddress3, kRead3)});
+  MockInitiator initiator(expected_transactions);
+
+  std::array<std::byte, kRead1.size()> read1;
+  std::array<std::byte, kRead3.size()> read3;
+  std::array<Initiator::Operation, 3> operations = {
+      Initiator::Operation(kAddress1, kRegister, read1),
+      Initiator::Operation(kAddress2, kRegister),
+      Initiator::Operation(kAddress3, ConstByteSpan(), read3),
+  };
+
+  EXPECT_EQ(OkStatus(), initiator.WriteReadBatchFor(operations, 10ms));
+  for (const Initiator::Operation& operation : operations) {
+    EXPECT_EQ(OkStatus(), operation.status);
+  }
+  EXPECT_EQ(kRead1, read1);
+  EXPECT_EQ(kRead3, read3);
+}
+
+TEST(Initiator, WriteReadBatchFor_ContinuesAfterFailure) {
+  auto expected_transactions = MakeExpectedTransactionArray(
+      {ReadTransaction(OkStatus(), kAddress1, kRead1),
+       ReadTransaction(Status::Unavailable(), kAddress2, kRead1),
+       ReadTransaction(Status::Unavailable(), kAddress3, kRead3)});
+  MockInitiator initiator(expected_transactions);
+
+  std::array<std::byte, kRead1.size()> read1;
+  std::array<std::byte, kRead1.size()> read2;
+  std::array<std::byte, kRead3.size()> read3;
+  std::array<Initiator::Operation, 3> operations = {
+      Initiator::Operation(kAddress1, ConstByteSpan(), read1),
+      Initiator::Operation(kAddress2, ConstByteSpan(), read2),
+      Initiator::Operation(kAddress3, ConstByteSpan(), read3),
+  };
+
+  EXPECT_EQ(Status::Unavailable(),
+            initiator.WriteReadBatchFor(operations, 10ms));
+  EXPECT_EQ(OkStatus(), operations[0].status);
+  EXPECT_EQ(Status::Unavailable(), operations[1].status);
+  EXPECT_EQ(Status::Unavailable(), operations[2].status);
+}
+
+TEST(Initiator, WriteReadBatchFor_Empty) {
+  std::array<Transaction, 0> expected_transactions;
+  MockInitiator initiator(expected_transactions);
+  std::span<Initiator::Operation> operations;
+  EXPECT_EQ(OkStatus(), initiator.WriteReadBatchFor(operations, 0ms));
+}
+
+TEST(Initiator, StartWriteReadBatch_InvokesCallback) {
+  auto expected_transactions = MakeExpectedTransactionArray(
+      {ReadTransaction(Status::Unavailable(), kAddress1, kRead1),
+       ReadTransaction(OkStatus(), kAddress3, kRead3)});
+  MockInitiator initiator(expected_transactions);
+
+  std::array<std::byte, kRead1.size()> read1;
+  std::array<std::byte, kRead3.size()> read3;
+  std::array<Initiator::Operation, 2> operations = {
+      Initiator::Operation(kAddress1, ConstByteSpan(), read1),
+      Initiator::Operation(kAddress3, ConstByteSpan(), read3),
+  };
+
+  struct {
+    int calls = 0;
+    Status status;
+  } result;
+  EXPECT_EQ(OkStatus(),
+            initiator.StartWriteReadBatch(
+                operations, 10ms, [&result](Status status) {
+                  result.calls += 1;
+                  result.status = status;
+                }));
+  EXPECT_EQ(1, result.calls);
+  EXPECT_EQ(Status::Unavailable(), result.status);
+  EXPECT_EQ(kRead3, read3);
+}
+
+}  // namespace
+}  // namespace pw::i2c
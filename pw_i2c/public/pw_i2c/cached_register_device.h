@@ -0,0 +1,159 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_i2c/register_device.h"
+#include "pw_metric/metric.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+
+namespace pw::i2c {
+
+// Shadows a contiguous block of 8-bit registers of a RegisterDevice, so that
+// registers that do not change on their own, such as configuration registers,
+// are only read from the device once.
+//
+// Registers are non-volatile by default. Reads of non-volatile registers are
+// served from the cache after the first read. Writes to non-volatile
+// registers are deferred until Flush(), which writes each run of adjacent
+// modified registers as one burst with RegisterDevice::WriteRegisters().
+// Writing a value that the register already holds is dropped.
+//
+// Registers marked volatile with SetVolatile(), such as status or data
+// registers, are always read from the device and written immediately.
+// Pending writes are flushed before a volatile register is written, so writes
+// reach the device in the order they were made relative to volatile writes.
+//
+// The metrics() group counts the bus traffic:
+//
+//   cache_hits: reads served from the cache without a transaction.
+//   bus_reads: read transactions.
+//   bus_writes: write transactions.
+//   writes_coalesced: register writes that did not need their own
+//       transaction, because they were merged into a burst or dropped.
+//
+// Registers outside the cached block return OUT_OF_RANGE; access them through
+// the RegisterDevice. This class is not thread safe.
+class CachedRegisterDevice {
+ public:
+  // Caches the registers first_register to first_register + values.size() -
+  // 1. flags must be the same size as values. write_buffer is used to build
+  // bursts and must be at least values.size() + 4 bytes.
+  CachedRegisterDevice(RegisterDevice& device,
+                       uint32_t first_register,
+                       ByteSpan values,
+                       std::span<uint8_t> flags,
+                       ByteSpan write_buffer);
+
+  CachedRegisterDevice(const CachedRegisterDevice&) = delete;
+  CachedRegisterDevice& operator=(const CachedRegisterDevice&) = delete;
+
+  // Marks count registers starting at register_address as volatile, discarding
+  // any cached values for them. Call this before the registers are accessed.
+  Status SetVolatile(uint32_t register_address, size_t count = 1);
+
+  Result<std::byte> ReadRegister(uint32_t register_address,
+                                 chrono::SystemClock::duration timeout);
+
+  // Reads the registers from the cache if they are all cached and
+  // non-volatile. Otherwise, reads them from the device in one burst and
+  // updates the cache. Registers with pending writes read as the pending value.
+  Status ReadRegisters(uint32_t register_address,
+                       ByteSpan return_data,
+                       chrono::SystemClock::duration timeout);
+
+  Status WriteRegister(uint32_t register_address,
+                       std::byte register_data,
+                       chrono::SystemClock::duration timeout);
+
+  // Stages the writes, or writes the registers through in one burst if any of
+  // them are volatile.
+  Status WriteRegisters(uint32_t register_address,
+                        ConstByteSpan register_data,
+                        chrono::SystemClock::duration timeout);
+
+  // Writes all pending register writes to the device, one burst per run of
+  // adjacent registers. The timeout applies to each burst. On failure, the
+  // registers that were not written remain pending.
+  Status Flush(chrono::SystemClock::duration timeout);
+
+  // Discards all cached values and pending writes, e.g. after the device is
+  // reset.
+  void Invalidate();
+
+  bool has_pending_writes() const;
+
+  uint32_t first_register() const { return first_register_; }
+  size_t size() const { return values_.size(); }
+
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  enum Flags : uint8_t {
+    kValid = 1 << 0,
+    kDirty = 1 << 1,
+    kVolatile = 1 << 2,
+  };
+
+  // Returns the index of register_address in the cache, or OUT_OF_RANGE if
+  // count registers starting there are not all cached.
+  Result<size_t> Index(uint32_t register_address, size_t count) const;
+
+  bool Has(size_t index, uint8_t flags) const {
+    return (flags_[index] & flags) != 0u;
+  }
+
+  // Writes registers [index, index + data.size()) to the device and marks
+  // them clean.
+  Status WriteThrough(size_t index,
+                      ConstByteSpan data,
+                      chrono::SystemClock::duration timeout);
+
+  RegisterDevice& device_;
+  const uint32_t first_register_;
+  ByteSpan values_;
+  std::span<uint8_t> flags_;
+  ByteSpan write_buffer_;
+
+  PW_METRIC_GROUP(metrics_, "i2c_register_cache");
+  PW_METRIC(metrics_, cache_hits_, "cache_hits", 0u);
+  PW_METRIC(metrics_, bus_reads_, "bus_reads", 0u);
+  PW_METRIC(metrics_, bus_writes_, "bus_writes", 0u);
+  PW_METRIC(metrics_, writes_coalesced_, "writes_coalesced", 0u);
+};
+
+// CachedRegisterDevice with storage for kNumRegisters registers.
+template <size_t kNumRegisters>
+class CachedRegisterDeviceBuffer : public CachedRegisterDevice {
+ public:
+  CachedRegisterDeviceBuffer(RegisterDevice& device, uint32_t first_register)
+      : CachedRegisterDevice(
+            device, first_register, values_, flags_, write_buffer_) {}
+
+ private:
+  static_assert(kNumRegisters > 0u);
+
+  std::array<std::byte, kNumRegisters> values_ = {};
+  std::array<uint8_t, kNumRegisters> flags_ = {};
+  std::array<std::byte, kNumRegisters + sizeof(uint32_t)> write_buffer_ = {};
+};
+
+}  // namespace pw::i2c
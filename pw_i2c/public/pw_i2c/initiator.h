@@ -14,9 +14,12 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
+#include <utility>
 
 #include "pw_bytes/span.h"
 #include "pw_chrono/system_clock.h"
+#include "pw_function/function.h"
 #include "pw_i2c/address.h"
 #include "pw_status/status.h"
 
@@ -36,6 +39,28 @@ namespace pw::i2c {
 // address registration collisions.
 class Initiator {
  public:
+  // One write and/or read in a batch submitted with WriteReadBatchFor() or
+  // StartWriteReadBatch(). Each operation appears on the bus as a
+  // WriteReadFor() call with the same arguments. Its result is stored in
+  // status.
+  struct Operation {
+    constexpr Operation(Address address,
+                        ConstByteSpan write = ConstByteSpan(),
+                        ByteSpan read = ByteSpan())
+        : device_address(address),
+          write_buffer(write),
+          read_buffer(read),
+          status(OkStatus()) {}
+
+    Address device_address;
+    ConstByteSpan write_buffer;
+    ByteSpan read_buffer;
+    Status status;
+  };
+
+  // Called with the result of a batch started with StartWriteReadBatch().
+  using BatchCallback = Function<void(Status)>;
+
   virtual ~Initiator() = default;
 
   // Write bytes and then read bytes as either one atomic or two independent I2C
@@ -88,6 +113,46 @@ class Initiator {
         timeout);
   }
 
+  // Performs a sequence of operations as one batch, in order. Backends may
+  // chain the operations in hardware, for example with DMA, so that polling
+  // several devices costs one bus acquisition instead of one per device.
+  //
+  // Every operation is attempted, even if an earlier one fails, so a device
+  // that does not respond does not prevent the rest from being polled. Each
+  // operation's status is set to the result of its transaction, using the
+  // same codes as WriteReadFor(). Operations that are not started before the
+  // timeout expires are set to DeadlineExceeded.
+  //
+  // The timeout applies to the whole batch, not to each operation.
+  //
+  // Returns:
+  // Ok - All operations succeeded.
+  // The status of the first operation that failed, otherwise.
+  Status WriteReadBatchFor(std::span<Operation> operations,
+                           chrono::SystemClock::duration timeout) {
+    return DoWriteReadBatchFor(operations, timeout);
+  }
+
+  // Starts a batch of operations and returns without waiting for it to
+  // finish, so a polling loop can service many devices from one thread. The
+  // callback is invoked with the result of the batch, as returned by
+  // WriteReadBatchFor(), once every operation's status is set. It may be
+  // invoked from an interrupt, or before this function returns.
+  //
+  // The operations and their buffers must remain valid until the callback is
+  // invoked. The default implementation performs the batch with
+  // WriteReadBatchFor() and invokes the callback before returning; backends
+  // that support asynchronous transfers override it.
+  //
+  // Returns:
+  // Ok - The batch was started and the callback will be invoked.
+  // Unavailable - Another batch is in progress. The callback is not invoked.
+  Status StartWriteReadBatch(std::span<Operation> operations,
+                             chrono::SystemClock::duration timeout,
+                             BatchCallback&& on_complete) {
+    return DoStartWriteReadBatch(operations, timeout, std::move(on_complete));
+  }
+
   // Write bytes. The signal on the bus should appear as follows:
   //   START + I2C Address + WRITE(0) + TX_BUFFER_BYTES + STOP
   //
@@ -186,6 +251,15 @@ class Initiator {
                                 ConstByteSpan tx_buffer,
                                 ByteSpan rx_buffer,
                                 chrono::SystemClock::duration timeout) = 0;
+
+  // Performs the operations one at a time with DoWriteReadFor(). Backends
+  // that can chain transactions override this.
+  virtual Status DoWriteReadBatchFor(std::span<Operation> operations,
+                                     chrono::SystemClock::duration timeout);
+
+  virtual Status DoStartWriteReadBatch(std::span<Operation> operations,
+                                       chrono::SystemClock::duration timeout,
+                                       BatchCallback&& on_complete);
 };
 
 }  // namespace pw::i2c
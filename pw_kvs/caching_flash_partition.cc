@@ -0,0 +1,157 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/caching_flash_partition.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "pw_assert/check.h"
+#include "pw_status/try.h"
+
+namespace pw::kvs {
+
+using std::byte;
+
+CachingFlashPartition::CachingFlashPartition(std::span<CacheLine> lines,
+                                             std::span<byte> line_data,
+                                             FlashMemory* flash,
+                                             uint32_t start_sector_index,
+                                             uint32_t sector_count,
+                                             uint32_t alignment_bytes,
+                                             PartitionPermission permission)
+    : FlashPartition(
+          flash, start_sector_index, sector_count, alignment_bytes, permission),
+      lines_(lines),
+      line_data_(line_data),
+      line_size_bytes_(line_data.size() / lines.size()),
+      use_counter_(0),
+      cache_hits_(0),
+      cache_misses_(0) {
+  const size_t line_sector_offset = sector_size_bytes() % line_size_bytes_;
+  PW_CHECK_UINT_EQ(line_sector_offset,
+                   0u,
+                   "The cache line size must evenly divide the sector size");
+  InvalidateCache();
+}
+
+StatusWithSize CachingFlashPartition::Read(Address address,
+                                           std::span<byte> output) {
+  PW_TRY_WITH_SIZE(CheckBounds(address, output.size()));
+
+  if (output.size() > line_data_.size()) {
+    cache_misses_ += 1;
+    return FlashPartition::Read(address, output);
+  }
+
+  size_t bytes_read = 0;
+  while (bytes_read < output.size()) {
+    const Address offset = address % line_size_bytes_;
+    CacheLine* line;
+    if (StatusWithSize result = GetLine(address - offset, &line);
+        !result.ok()) {
+      return StatusWithSize(result.status(), bytes_read);
+    }
+
+    const size_t to_copy =
+        std::min(line_size_bytes_ - offset, output.size() - bytes_read);
+    std::memcpy(&output[bytes_read], LineData(*line) + offset, to_copy);
+
+    bytes_read += to_copy;
+    address += to_copy;
+  }
+
+  return StatusWithSize(bytes_read);
+}
+
+StatusWithSize CachingFlashPartition::Write(Address address,
+                                            std::span<const byte> data) {
+  // Invalidate even if the write fails, since it may have been partially
+  // written.
+  InvalidateRange(address, data.size());
+  return FlashPartition::Write(address, data);
+}
+
+Status CachingFlashPartition::Erase(Address address, size_t num_sectors) {
+  InvalidateRange(address, num_sectors * sector_size_bytes());
+  return FlashPartition::Erase(address, num_sectors);
+}
+
+Status CachingFlashPartition::StartErase(Address address,
+                                         size_t num_sectors,
+                                         FlashMemory::Callback&& on_complete) {
+  InvalidateRange(address, num_sectors * sector_size_bytes());
+  return FlashPartition::StartErase(
+      address, num_sectors, std::move(on_complete));
+}
+
+Status CachingFlashPartition::StartWrite(Address address,
+                                         std::span<const byte> data,
+                                         FlashMemory::Callback&& on_complete) {
+  InvalidateRange(address, data.size());
+  return FlashPartition::StartWrite(address, data, std::move(on_complete));
+}
+
+void CachingFlashPartition::InvalidateCache() {
+  for (CacheLine& line : lines_) {
+    line.valid = false;
+  }
+}
+
+StatusWithSize CachingFlashPartition::GetLine(Address line_address,
+                                              CacheLine** line) {
+  CacheLine* replace = &lines_[0];
+
+  for (CacheLine& candidate : lines_) {
+    if (candidate.valid && candidate.address == line_address) {
+      cache_hits_ += 1;
+      candidate.last_used = ++use_counter_;
+      *line = &candidate;
+      return StatusWithSize(line_size_bytes_);
+    }
+
+    // Prefer an unused line; otherwise, replace the least recently used line.
+    if (replace->valid &&
+        (!candidate.valid || candidate.last_used < replace->last_used)) {
+      replace = &candidate;
+    }
+  }
+
+  cache_misses_ += 1;
+  replace->valid = false;
+
+  StatusWithSize result = FlashPartition::Read(
+      line_address, std::span(LineData(*replace), line_size_bytes_));
+  if (!result.ok()) {
+    return result;
+  }
+
+  replace->address = line_address;
+  replace->last_used = ++use_counter_;
+  replace->valid = true;
+  *line = replace;
+  return result;
+}
+
+void CachingFlashPartition::InvalidateRange(Address address, size_t size) {
+  for (CacheLine& line : lines_) {
+    if (line.valid && line.address < address + size &&
+        address < line.address + line_size_bytes_) {
+      line.valid = false;
+    }
+  }
+}
+
+}  // namespace pw::kvs
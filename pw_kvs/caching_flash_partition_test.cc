@@ -0,0 +1,161 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/caching_flash_partition.h"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+
+constexpr size_t kLineSize = 32;
+constexpr size_t kLines = 4;
+
+class CachingFlashPartitionTest : public ::testing::Test {
+ protected:
+  CachingFlashPartitionTest() : flash_(16), partition_(&flash_) {
+    for (size_t i = 0; i < flash_.buffer().size(); ++i) {
+      flash_.buffer()[i] = byte(i);
+    }
+  }
+
+  // Changes the flash contents without going through the partition.
+  void Corrupt(size_t address) { flash_.buffer()[address] = byte{0x5A}; }
+
+  FakeFlashMemoryBuffer<256, 4> flash_;
+  CachingFlashPartitionBuffer<kLineSize, kLines> partition_;
+};
+
+TEST_F(CachingFlashPartitionTest, Read_MissThenHit) {
+  std::array<byte, 8> data;
+  ASSERT_EQ(OkStatus(), partition_.Read(4, data).status());
+  EXPECT_EQ(byte{4}, data[0]);
+  EXPECT_EQ(0u, partition_.cache_hits());
+  EXPECT_EQ(1u, partition_.cache_misses());
+
+  // The second read is served from the cached line, not from flash.
+  Corrupt(4);
+  ASSERT_EQ(OkStatus(), partition_.Read(4, data).status());
+  EXPECT_EQ(byte{4}, data[0]);
+  EXPECT_EQ(1u, partition_.cache_hits());
+  EXPECT_EQ(1u, partition_.cache_misses());
+
+  partition_.InvalidateCache();
+  ASSERT_EQ(OkStatus(), partition_.Read(4, data).status());
+  EXPECT_EQ(byte{0x5A}, data[0]);
+}
+
+TEST_F(CachingFlashPartitionTest, Read_SpansLines) {
+  std::array<byte, kLineSize> data;
+  ASSERT_EQ(OkStatus(), partition_.Read(kLineSize - 4, data).status());
+  for (size_t i = 0; i < data.size(); ++i) {
+    EXPECT_EQ(byte(kLineSize - 4 + i), data[i]);
+  }
+  EXPECT_EQ(2u, partition_.cache_misses());
+}
+
+TEST_F(CachingFlashPartitionTest, Read_LargerThanCache_Bypasses) {
+  std::array<byte, kLineSize * kLines + 1> data;
+  ASSERT_EQ(OkStatus(), partition_.Read(0, data).status());
+  EXPECT_EQ(1u, partition_.cache_misses());
+
+  // Nothing was cached.
+  ASSERT_EQ(OkStatus(), partition_.Read(0, std::span(data).first(1)).status());
+  EXPECT_EQ(2u, partition_.cache_misses());
+}
+
+TEST_F(CachingFlashPartitionTest, Read_EvictsLeastRecentlyUsed) {
+  byte value;
+  for (size_t line = 0; line < kLines; ++line) {
+    ASSERT_EQ(OkStatus(),
+              partition_.Read(line * kLineSize, 1, &value).status());
+  }
+
+  // Use line 0 again so that line 1 is the least recently used.
+  ASSERT_EQ(OkStatus(), partition_.Read(0, 1, &value).status());
+  ASSERT_EQ(OkStatus(),
+            partition_.Read(kLines * kLineSize, 1, &value).status());
+  partition_.ResetCacheCounters();
+
+  ASSERT_EQ(OkStatus(), partition_.Read(0, 1, &value).status());
+  EXPECT_EQ(1u, partition_.cache_hits());
+  ASSERT_EQ(OkStatus(), partition_.Read(kLineSize, 1, &value).status());
+  EXPECT_EQ(1u, partition_.cache_misses());
+}
+
+TEST_F(CachingFlashPartitionTest, Read_OutOfBounds) {
+  byte value;
+  EXPECT_EQ(Status::OutOfRange(),
+            partition_.Read(partition_.size_bytes(), 1, &value).status());
+  EXPECT_EQ(0u, partition_.cache_misses());
+}
+
+TEST_F(CachingFlashPartitionTest, Write_InvalidatesLine) {
+  ASSERT_EQ(OkStatus(), partition_.Erase(0, 1));
+
+  std::array<byte, 16> data;
+  ASSERT_EQ(OkStatus(), partition_.Read(0, data).status());
+  EXPECT_EQ(byte{0xff}, data[0]);
+
+  constexpr std::array<byte, 16> kWritten = {byte{1}, byte{2}, byte{3}};
+  ASSERT_EQ(OkStatus(), partition_.Write(0, kWritten).status());
+  partition_.ResetCacheCounters();
+
+  ASSERT_EQ(OkStatus(), partition_.Read(0, data).status());
+  EXPECT_EQ(kWritten, data);
+  EXPECT_EQ(1u, partition_.cache_misses());
+}
+
+TEST_F(CachingFlashPartitionTest, Erase_InvalidatesSector) {
+  byte value;
+  ASSERT_EQ(OkStatus(), partition_.Read(256 + 1, 1, &value).status());
+  EXPECT_EQ(byte{1}, value);
+
+  ASSERT_EQ(OkStatus(), partition_.Erase(256, 1));
+  ASSERT_EQ(OkStatus(), partition_.Read(256 + 1, 1, &value).status());
+  EXPECT_EQ(byte{0xff}, value);
+}
+
+TEST(CachingFlashPartition, KeyValueStore_GetHitsCache) {
+  FakeFlashMemoryBuffer<512, 4> flash(16);
+  CachingFlashPartitionBuffer<64, 8> partition(&flash);
+  ASSERT_EQ(OkStatus(), partition.Erase());
+
+  ChecksumCrc16 checksum;
+  KeyValueStoreBuffer<8, 4> kvs(&partition,
+                                {.magic = 0x5eed1e55, .checksum = &checksum});
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  ASSERT_EQ(OkStatus(), kvs.Put("key", uint32_t(0xfeedbeef)));
+
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs.Get("key", &value));
+  partition.ResetCacheCounters();
+
+  ASSERT_EQ(OkStatus(), kvs.Get("key", &value));
+  EXPECT_EQ(0xfeedbeefu, value);
+  EXPECT_GT(partition.cache_hits(), 0u);
+  EXPECT_EQ(0u, partition.cache_misses());
+}
+
+}  // namespace
+}  // namespace pw::kvs
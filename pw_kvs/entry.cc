@@ -107,6 +107,23 @@ StatusWithSize Entry::Write(Key key, std::span<const byte> value) const {
                                          value});
 }
 
+StatusWithSize Entry::Write(AlignedWriter& writer,
+                            Key key,
+                            std::span<const byte> value) const {
+  PW_TRY_WITH_SIZE(writer.Write(std::as_bytes(std::span(&header_, 1))));
+  PW_TRY_WITH_SIZE(writer.Write(std::as_bytes(std::span(key))));
+  PW_TRY_WITH_SIZE(writer.Write(value));
+
+  // Pad with zeros, which matches the padding that AlignedWrite adds.
+  constexpr byte kPadding[kMinAlignmentBytes] = {};
+  for (size_t padding = size() - content_size(); padding > 0u;) {
+    const size_t chunk = std::min(padding, sizeof(kPadding));
+    PW_TRY_WITH_SIZE(writer.Write(kPadding, chunk));
+    padding -= chunk;
+  }
+  return StatusWithSize(size());
+}
+
 Status Entry::Update(const EntryFormat& new_format,
                      uint32_t new_transaction_id) {
   checksum_algo_ = new_format.checksum;
@@ -245,6 +262,39 @@ Status Entry::VerifyChecksumInFlash() const {
   return checksum_algo_->Verify(checksum_bytes());
 }
 
+StatusWithSize Entry::ReadValueAndVerifyChecksum(
+    Key key, std::span<byte> buffer) const {
+  if (buffer.size() < value_size()) {
+    return ReadValue(buffer);
+  }
+
+  if (checksum_algo_ == nullptr) {
+    PW_TRY_WITH_SIZE(ReadValue(buffer));
+    return header_.checksum == 0 ? StatusWithSize(value_size())
+                                 : StatusWithSize::DataLoss();
+  }
+
+  StartChecksum(key);
+
+  // Checksum the value in chunks as it is read, while each chunk is still in
+  // the cache if there is one.
+  constexpr size_t kChunkSizeBytes = 256;
+  const Address value_address = address_ + sizeof(EntryHeader) + key_length();
+
+  for (size_t offset = 0; offset < value_size(); offset += kChunkSizeBytes) {
+    const std::span<byte> chunk = buffer.subspan(
+        offset, std::min(kChunkSizeBytes, value_size() - offset));
+    PW_TRY_WITH_SIZE(partition().Read(value_address + offset, chunk));
+    checksum_algo_->Update(chunk);
+  }
+
+  AddPaddingBytesToChecksum();
+  checksum_algo_->Finish();
+
+  PW_TRY_WITH_SIZE(checksum_algo_->Verify(checksum_bytes()));
+  return StatusWithSize(value_size());
+}
+
 void Entry::DebugLog() const {
   PW_LOG_DEBUG("Entry [%s]: ", deleted() ? "tombstone" : "present");
   PW_LOG_DEBUG("   Address      = 0x%x", unsigned(address_));
@@ -259,22 +309,24 @@ void Entry::DebugLog() const {
 
 std::span<const byte> Entry::CalculateChecksum(
     const Key key, std::span<const byte> value) const {
-  checksum_algo_->Reset();
-
-  {
-    EntryHeader header_for_checksum = header_;
-    header_for_checksum.checksum = 0;
-
-    checksum_algo_->Update(&header_for_checksum, sizeof(header_for_checksum));
-    checksum_algo_->Update(std::as_bytes(std::span(key)));
-    checksum_algo_->Update(value);
-  }
+  StartChecksum(key);
+  checksum_algo_->Update(value);
 
   AddPaddingBytesToChecksum();
 
   return checksum_algo_->Finish();
 }
 
+void Entry::StartChecksum(const Key key) const {
+  checksum_algo_->Reset();
+
+  EntryHeader header_for_checksum = header_;
+  header_for_checksum.checksum = 0;
+
+  checksum_algo_->Update(&header_for_checksum, sizeof(header_for_checksum));
+  checksum_algo_->Update(std::as_bytes(std::span(key)));
+}
+
 Status Entry::CalculateChecksumFromFlash() {
   header_.checksum = 0;
 
@@ -17,6 +17,7 @@
 
 #include "pw_kvs/internal/entry_cache.h"
 
+#include <algorithm>
 #include <cinttypes>
 
 #include "pw_kvs/flash_memory.h"
@@ -30,6 +31,12 @@ namespace {
 
 constexpr FlashPartition::Address kNoAddress = FlashPartition::Address(-1);
 
+constexpr KeyDetails DetailsOf(const KeyDescriptor& descriptor) {
+  return {.transaction_id = descriptor.transaction_id,
+          .state = descriptor.state,
+          .namespace_tag = descriptor.namespace_tag};
+}
+
 }  // namespace
 
 void EntryMetadata::RemoveAddress(Address address_to_remove) {
@@ -50,7 +57,8 @@ void EntryMetadata::RemoveAddress(Address address_to_remove) {
 }
 
 void EntryMetadata::Reset(const KeyDescriptor& descriptor, Address address) {
-  *descriptor_ = descriptor;
+  *key_hash_ = descriptor.key_hash;
+  *details_ = DetailsOf(descriptor);
 
   addresses_[0] = address;
   for (size_t i = 1; i < addresses_.size(); ++i) {
@@ -59,76 +67,84 @@ void EntryMetadata::Reset(const KeyDescriptor& descriptor, Address address) {
   addresses_ = addresses_.first(1);
 }
 
+void EntryCache::Reset() const {
+  key_hashes_.clear();
+  std::fill(index_.begin(), index_.end(), IndexSlot(0));
+}
+
 StatusWithSize EntryCache::Find(FlashPartition& partition,
                                 const Sectors& sectors,
                                 const EntryFormats& formats,
                                 Key key,
                                 EntryMetadata* metadata) const {
   const uint32_t hash = internal::Hash(key);
+  const int index = FindIndex(hash);
+
+  if (index == -1) {
+    return StatusWithSize::NotFound();
+  }
+
+  const size_t i = index;
   Entry::KeyBuffer key_buffer;
   bool error_detected = false;
+  bool key_found = false;
+  Key read_key;
 
-  for (size_t i = 0; i < descriptors_.size(); ++i) {
-    if (descriptors_[i].key_hash == hash) {
-      bool key_found = false;
-      Key read_key;
-
-      for (Address address : addresses(i)) {
-        Status read_result =
-            Entry::ReadKey(partition, address, key.size(), key_buffer.data());
-
-        read_key = Key(key_buffer.data(), key.size());
-
-        if (read_result.ok() && hash == internal::Hash(read_key)) {
-          key_found = true;
-          break;
-        } else {
-          // A hash mismatch can be caused by reading invalid data or a key hash
-          // collision of keys with differing size. To verify the data read from
-          // flash is good, validate the entry.
-          Entry entry;
-          read_result = Entry::Read(partition, address, formats, &entry);
-          if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
-            key_found = true;
-            break;
-          }
-
-          PW_LOG_WARN(
-              "   Found corrupt entry, invalidating this copy of the key");
-          error_detected = true;
-          sectors.FromAddress(address).mark_corrupt();
-        }
-      }
-      size_t error_val = error_detected ? 1 : 0;
-
-      if (!key_found) {
-        PW_LOG_ERROR("No valid entries for key. Data has been lost!");
-        return StatusWithSize::DataLoss(error_val);
-      } else if (key == read_key) {
-        PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
-        *metadata = EntryMetadata(descriptors_[i], addresses(i));
-        return StatusWithSize(error_val);
-      } else {
-        PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
-        return StatusWithSize::AlreadyExists(error_val);
+  for (Address address : addresses(i)) {
+    Status read_result =
+        Entry::ReadKey(partition, address, key.size(), key_buffer.data());
+
+    read_key = Key(key_buffer.data(), key.size());
+
+    if (read_result.ok() && hash == internal::Hash(read_key)) {
+      key_found = true;
+      break;
+    } else {
+      // A hash mismatch can be caused by reading invalid data or a key hash
+      // collision of keys with differing size. To verify the data read from
+      // flash is good, validate the entry.
+      Entry entry;
+      read_result = Entry::Read(partition, address, formats, &entry);
+      if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
+        key_found = true;
+        break;
       }
+
+      PW_LOG_WARN("   Found corrupt entry, invalidating this copy of the key");
+      error_detected = true;
+      sectors.mark_corrupt(sectors.FromAddress(address));
     }
   }
-  return StatusWithSize::NotFound();
+  size_t error_val = error_detected ? 1 : 0;
+
+  if (!key_found) {
+    PW_LOG_ERROR("No valid entries for key. Data has been lost!");
+    return StatusWithSize::DataLoss(error_val);
+  } else if (key == read_key) {
+    PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
+    *metadata = EntryMetadata(&key_hashes_[i], &details_[i], addresses(i));
+    return StatusWithSize(error_val);
+  } else {
+    PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
+    return StatusWithSize::AlreadyExists(error_val);
+  }
 }
 
 EntryMetadata EntryCache::AddNew(const KeyDescriptor& descriptor,
                                  Address address) const {
   // TODO(hepler): DCHECK(!full());
-  Address* first_address = ResetAddresses(descriptors_.size(), address);
-  descriptors_.push_back(descriptor);
-  return EntryMetadata(descriptors_.back(), std::span(first_address, 1));
+  const size_t index = key_hashes_.size();
+  Address* first_address = ResetAddresses(index, address);
+  key_hashes_.push_back(descriptor.key_hash);
+  details_[index] = DetailsOf(descriptor);
+  AddToIndex(index);
+  return EntryMetadata(
+      &key_hashes_[index], &details_[index], std::span(first_address, 1));
 }
 
-// TODO: This method is the trigger of the O(valid_entries * all_entries) time
-// complexity for reading. At some cost to memory, this could be optimized by
-// using a hash table instead of scanning, but in practice this should be fine
-// for a small number of keys
+// Without a hash index, this method is the trigger of the
+// O(valid_entries * all_entries) time complexity for reading. This is fine for
+// a small number of keys; larger KVSs should provide an index.
 Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
                                           Address address,
                                           size_t sector_size_bytes) const {
@@ -146,16 +162,16 @@ Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
   }
 
   // Existing entry is old; replace the existing entry with the new one.
-  if (descriptor.transaction_id > descriptors_[index].transaction_id) {
-    descriptors_[index] = descriptor;
+  if (descriptor.transaction_id > details_[index].transaction_id) {
+    details_[index] = DetailsOf(descriptor);
     ResetAddresses(index, address);
     return OkStatus();
   }
 
   // If the entries have a duplicate transaction ID, add the new (redundant)
   // entry to the existing descriptor.
-  if (descriptors_[index].transaction_id == descriptor.transaction_id) {
-    if (descriptors_[index].key_hash != descriptor.key_hash) {
+  if (details_[index].transaction_id == descriptor.transaction_id) {
+    if (key_hashes_[index] != descriptor.key_hash) {
       PW_LOG_ERROR("Duplicate entry for key 0x%08" PRIx32
                    " with transaction ID %" PRIu32 " has non-matching hash",
                    descriptor.key_hash,
@@ -183,8 +199,8 @@ Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
 size_t EntryCache::present_entries() const {
   size_t present_entries = 0;
 
-  for (const KeyDescriptor& descriptor : descriptors_) {
-    if (descriptor.state != EntryState::kDeleted) {
+  for (size_t i = 0; i < key_hashes_.size(); ++i) {
+    if (details_[i].state != EntryState::kDeleted) {
       present_entries += 1;
     }
   }
@@ -193,12 +209,42 @@ size_t EntryCache::present_entries() const {
 }
 
 int EntryCache::FindIndex(uint32_t key_hash) const {
-  for (size_t i = 0; i < descriptors_.size(); ++i) {
-    if (descriptors_[i].key_hash == key_hash) {
-      return i;
+  if (has_index()) {
+    // Probe linearly from the hash's home slot. Descriptors are never removed,
+    // so an empty slot terminates the search.
+    for (size_t probes = 0, slot = key_hash & index_mask();
+         probes < index_.size();
+         ++probes, slot = (slot + 1) & index_mask()) {
+      if (index_[slot] == 0u) {
+        return -1;
+      }
+      if (key_hashes_[index_[slot] - 1] == key_hash) {
+        return index_[slot] - 1;
+      }
+    }
+    return -1;
+  }
+
+  // The hashes are contiguous, so this scan reads only the hashes and the
+  // compiler may vectorize it.
+  const auto found =
+      std::find(key_hashes_.begin(), key_hashes_.end(), key_hash);
+  return found == key_hashes_.end() ? -1 : found - key_hashes_.begin();
+}
+
+void EntryCache::AddToIndex(size_t descriptor_index) const {
+  if (!has_index()) {
+    return;
+  }
+
+  const uint32_t key_hash = key_hashes_[descriptor_index];
+  for (size_t slot = key_hash & index_mask();;
+       slot = (slot + 1) & index_mask()) {
+    if (index_[slot] == 0u) {
+      index_[slot] = static_cast<IndexSlot>(descriptor_index + 1);
+      return;
     }
   }
-  return -1;
 }
 
 void EntryCache::AddAddressIfRoom(size_t descriptor_index,
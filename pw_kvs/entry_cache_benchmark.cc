@@ -0,0 +1,110 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compares KeyValueStore::Get latency with and without the EntryCache hash
+// index for several KVS sizes. Run on the host or on a device with a
+// pw_chrono:system_clock backend; results are logged.
+
+#define PW_LOG_MODULE_NAME "KVS"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_log/log.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kSectorSize = 4096;
+constexpr size_t kSectors = 16;
+constexpr size_t kRounds = 20;
+
+// For KVS magic value always use a random 32 bit integer rather than a
+// human readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x5b4cb3e2, .checksum = nullptr};
+
+FakeFlashMemoryBuffer<kSectorSize, kSectors> flash(16);
+FlashPartition partition(&flash);
+
+using KeyBuffer = std::array<char, 16>;
+
+KeyBuffer MakeKey(size_t i) {
+  KeyBuffer key;
+  std::snprintf(key.data(), key.size(), "key_%04u", static_cast<unsigned>(i));
+  return key;
+}
+
+// Fills a KVS with kEntries keys and measures the average time to Get each of
+// them. Returns the average latency in nanoseconds, or -1 on failure.
+template <size_t kEntries, size_t kIndexSlots>
+int64_t MeasureGetLatency() {
+  static KeyValueStoreBuffer<kEntries, kSectors, 1, 1, kIndexSlots> kvs(
+      &partition, kFormat);
+
+  if (!partition.Erase().ok() || !kvs.Init().ok()) {
+    return -1;
+  }
+
+  for (size_t i = 0; i < kEntries; ++i) {
+    if (!kvs.Put(MakeKey(i).data(), static_cast<uint32_t>(i)).ok()) {
+      return -1;
+    }
+  }
+
+  // Build the keys up front so only the lookups are timed.
+  static std::array<KeyBuffer, kEntries> keys;
+  for (size_t i = 0; i < kEntries; ++i) {
+    keys[i] = MakeKey(i);
+  }
+
+  uint32_t value;
+  const auto start = chrono::SystemClock::now();
+  for (size_t round = 0; round < kRounds; ++round) {
+    for (const KeyBuffer& key : keys) {
+      if (!kvs.Get(key.data(), &value).ok()) {
+        return -1;
+      }
+    }
+  }
+  const auto elapsed = chrono::SystemClock::now() - start;
+
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() /
+         static_cast<int64_t>(kRounds * kEntries);
+}
+
+template <size_t kEntries>
+void CompareLookups() {
+  const int64_t linear_ns = MeasureGetLatency<kEntries, 0>();
+  const int64_t indexed_ns = MeasureGetLatency<kEntries, 2 * kEntries>();
+
+  PW_LOG_INFO("%4u entries: linear scan %6ld ns/Get, hash index %6ld ns/Get",
+              static_cast<unsigned>(kEntries),
+              static_cast<long>(linear_ns),
+              static_cast<long>(indexed_ns));
+}
+
+}  // namespace
+}  // namespace pw::kvs
+
+int main() {
+  pw::kvs::CompareLookups<16>();
+  pw::kvs::CompareLookups<128>();
+  pw::kvs::CompareLookups<1024>();
+  return 0;
+}
@@ -31,9 +31,11 @@ class EmptyEntryCache : public ::testing::Test {
   static constexpr size_t kMaxEntries = 32;
   static constexpr size_t kRedundancy = 3;
 
-  EmptyEntryCache() : entries_(descriptors_, addresses_, kRedundancy) {}
+  EmptyEntryCache()
+      : entries_(key_hashes_, key_details_, addresses_, kRedundancy) {}
 
-  Vector<KeyDescriptor, kMaxEntries> descriptors_;
+  EntryCache::KeyHashList<kMaxEntries> key_hashes_;
+  EntryCache::KeyDetailsList<kMaxEntries> key_details_;
   EntryCache::AddressList<kMaxEntries, kRedundancy> addresses_;
 
   EntryCache entries_;
@@ -166,6 +168,84 @@ TEST_F(EmptyEntryCache, AddNewOrUpdateExisting_AddDuplicateEntryInSameSector) {
   }
 }
 
+class IndexedEntryCache : public ::testing::Test {
+ protected:
+  static constexpr size_t kMaxEntries = 32;
+  static constexpr size_t kRedundancy = 2;
+  static constexpr uint32_t kIndexSlots = 64;
+
+  IndexedEntryCache()
+      : entries_(
+            key_hashes_, key_details_, addresses_, kRedundancy, index_) {}
+
+  EntryCache::KeyHashList<kMaxEntries> key_hashes_;
+  EntryCache::KeyDetailsList<kMaxEntries> key_details_;
+  EntryCache::AddressList<kMaxEntries, kRedundancy> addresses_;
+  EntryCache::HashIndex<kIndexSlots> index_ = {};
+
+  EntryCache entries_;
+};
+
+TEST_F(EmptyEntryCache, HasIndex_False) { EXPECT_FALSE(entries_.has_index()); }
+
+TEST_F(IndexedEntryCache, HasIndex_True) { EXPECT_TRUE(entries_.has_index()); }
+
+TEST_F(IndexedEntryCache, AddNewOrUpdateExisting_Full) {
+  // Each of these hashes maps to the same home slot, so every lookup probes.
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(
+                  {i * kIndexSlots, i, EntryState::kValid}, i, 1));
+  }
+  ASSERT_TRUE(entries_.full());
+
+  EXPECT_EQ(Status::ResourceExhausted(),
+            entries_.AddNewOrUpdateExisting(kDescriptor, 1000, 1));
+  EXPECT_EQ(kMaxEntries, entries_.total_entries());
+}
+
+TEST_F(IndexedEntryCache, AddNewOrUpdateExisting_UpdatesCollidingSlots) {
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(
+                  {i * kIndexSlots + 1, 10, EntryState::kValid}, i, 1));
+  }
+
+  // Newer transaction IDs replace existing descriptors rather than adding new
+  // ones, so each key must be found through the index.
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(
+                  {i * kIndexSlots + 1, 20, EntryState::kValid}, 100 + i, 1));
+  }
+
+  EXPECT_EQ(kMaxEntries, entries_.total_entries());
+  uint32_t i = 0;
+  for (const EntryMetadata& entry : entries_) {
+    EXPECT_EQ(i * kIndexSlots + 1, entry.hash());
+    EXPECT_EQ(20u, entry.transaction_id());
+    EXPECT_EQ(100 + i, entry.first_address());
+    i += 1;
+  }
+}
+
+TEST_F(IndexedEntryCache, Reset_ClearsIndex) {
+  ASSERT_EQ(OkStatus(),
+            entries_.AddNewOrUpdateExisting(kDescriptor, 1000, 2000));
+  entries_.Reset();
+
+  for (EntryCache::IndexSlot slot : index_) {
+    EXPECT_EQ(0u, slot);
+  }
+
+  // After a reset, the same hash is added as a new descriptor.
+  KeyDescriptor older = kDescriptor;
+  older.transaction_id -= 1;
+  ASSERT_EQ(OkStatus(), entries_.AddNewOrUpdateExisting(older, 3000, 2000));
+  EXPECT_EQ(1u, entries_.total_entries());
+  EXPECT_EQ(3000u, entries_.begin()->first_address());
+}
+
 TEST_F(EmptyEntryCache, Iterator_MutableFromConst_CanModify) {
   entries_.AddNew(kDescriptor, 1);
   EntryCache::iterator it = static_cast<const EntryCache&>(entries_).begin();
@@ -194,6 +274,30 @@ TEST_F(EmptyEntryCache, Iterator_Const_CanBeAssignedFromMutable) {
   EXPECT_EQ(99u, it->first_address());
 }
 
+TEST_F(EmptyEntryCache, Iterator_VisitsEachEntryInOrder) {
+  entries_.AddNew(kDescriptor, 10);
+  entries_.AddNew({.key_hash = 1,
+                   .transaction_id = 7,
+                   .state = EntryState::kDeleted,
+                   .namespace_tag = 3},
+                  20);
+
+  EntryCache::const_iterator it = entries_.cbegin();
+  EXPECT_EQ(kDescriptor.key_hash, it->hash());
+  EXPECT_EQ(kDescriptor.transaction_id, it->transaction_id());
+  EXPECT_EQ(10u, it->first_address());
+
+  ++it;
+  EXPECT_EQ(1u, it->hash());
+  EXPECT_EQ(7u, it->transaction_id());
+  EXPECT_EQ(EntryState::kDeleted, it->state());
+  EXPECT_EQ(3u, it->namespace_tag());
+  EXPECT_EQ(20u, it->first_address());
+
+  ++it;
+  EXPECT_EQ(entries_.cend(), it);
+}
+
 constexpr size_t kSectorSize = 64;
 constexpr uint32_t kMagic = 0xa14ae726;
 // For KVS entry magic value always use a random 32 bit integer rather than a
@@ -259,25 +363,35 @@ class InitializedEntryCache : public EmptyEntryCache {
                              kPadding3)),
         partition_(&flash_),
         sectors_(sector_descriptors_, partition_, nullptr),
-        format_(kFormat) {
+        format_(kFormat),
+        indexed_entries_(indexed_key_hashes_,
+                         indexed_key_details_,
+                         indexed_addresses_,
+                         kRedundancy,
+                         index_) {
     sectors_.Reset();
+    AddEntries(entries_);
+    AddEntries(indexed_entries_);
+  }
+
+  static void AddEntries(EntryCache& entries) {
     size_t address = 0;
-    auto entry = entries_.AddNew(kDescriptor, address);
+    auto entry = entries.AddNew(kDescriptor, address);
 
     address += kSize1;
     entry.AddNewAddress(kSize1);
 
     address += kSize1;
-    entries_.AddNew({.key_hash = Hash(kCollision1),
-                     .transaction_id = 125,
-                     .state = EntryState::kDeleted},
-                    address);
+    entries.AddNew({.key_hash = Hash(kCollision1),
+                    .transaction_id = 125,
+                    .state = EntryState::kDeleted},
+                   address);
 
     address += kSize2;
-    entries_.AddNew({.key_hash = Hash("delorted"),
-                     .transaction_id = 256,
-                     .state = EntryState::kDeleted},
-                    address);
+    entries.AddNew({.key_hash = Hash("delorted"),
+                    .transaction_id = 256,
+                    .state = EntryState::kDeleted},
+                   address);
   }
 
   void CheckForCorruptSectors(SectorDescriptor* sector1 = nullptr,
@@ -297,6 +411,12 @@ class InitializedEntryCache : public EmptyEntryCache {
   Sectors sectors_;
 
   EntryFormats format_;
+
+  EntryCache::KeyHashList<kMaxEntries> indexed_key_hashes_;
+  EntryCache::KeyDetailsList<kMaxEntries> indexed_key_details_;
+  EntryCache::AddressList<kMaxEntries, kRedundancy> indexed_addresses_;
+  EntryCache::HashIndex<2 * kMaxEntries> index_ = {};
+  EntryCache indexed_entries_;
 };
 
 TEST_F(InitializedEntryCache, EntryCounts) {
@@ -391,5 +511,52 @@ TEST_F(InitializedEntryCache, Find_Collision) {
   CheckForCorruptSectors();
 }
 
+TEST_F(InitializedEntryCache, Find_Indexed_PresentEntry) {
+  EntryMetadata metadata;
+
+  StatusWithSize result =
+      indexed_entries_.Find(partition_, sectors_, format_, kTheKey, &metadata);
+
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.size());
+  EXPECT_EQ(Hash(kTheKey), metadata.hash());
+  EXPECT_EQ(EntryState::kValid, metadata.state());
+  EXPECT_EQ(2u, metadata.addresses().size());
+  CheckForCorruptSectors();
+}
+
+TEST_F(InitializedEntryCache, Find_Indexed_DeletedEntry) {
+  EntryMetadata metadata;
+
+  StatusWithSize result = indexed_entries_.Find(
+      partition_, sectors_, format_, "delorted", &metadata);
+
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(Hash("delorted"), metadata.hash());
+  EXPECT_EQ(EntryState::kDeleted, metadata.state());
+  CheckForCorruptSectors();
+}
+
+TEST_F(InitializedEntryCache, Find_Indexed_MissingEntry) {
+  EntryMetadata metadata;
+
+  StatusWithSize result =
+      indexed_entries_.Find(partition_, sectors_, format_, "3.141", &metadata);
+
+  ASSERT_EQ(Status::NotFound(), result.status());
+  EXPECT_EQ(0u, result.size());
+  CheckForCorruptSectors();
+}
+
+TEST_F(InitializedEntryCache, Find_Indexed_Collision) {
+  EntryMetadata metadata;
+
+  StatusWithSize result = indexed_entries_.Find(
+      partition_, sectors_, format_, kCollision2, &metadata);
+  EXPECT_EQ(Status::AlreadyExists(), result.status());
+  EXPECT_EQ(0u, result.size());
+  CheckForCorruptSectors();
+}
+
 }  // namespace
 }  // namespace pw::kvs::internal
@@ -14,6 +14,8 @@
 
 #include "pw_kvs/internal/entry.h"
 
+#include <array>
+#include <cstring>
 #include <span>
 #include <string_view>
 
@@ -203,6 +205,63 @@ TEST_F(ValidEntryInFlash, ReadValue_WithOffset_PastEnd) {
   EXPECT_EQ(0u, result.size());
 }
 
+TEST_F(ValidEntryInFlash, ReadValueAndVerifyChecksum) {
+  char value[16] = {};
+  auto result = entry_.ReadValueAndVerifyChecksum(
+      "key45", std::as_writable_bytes(std::span(value)));
+
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(result.size(), kValue1.size());
+  EXPECT_STREQ(value, "VALUE!");
+}
+
+TEST_F(ValidEntryInFlash, ReadValueAndVerifyChecksum_BufferTooSmall) {
+  char value[3] = {};
+  auto result = entry_.ReadValueAndVerifyChecksum(
+      "key45", std::as_writable_bytes(std::span(value)));
+
+  ASSERT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(3u, result.size());
+  EXPECT_EQ(value[0], 'V');
+}
+
+TEST_F(ValidEntryInFlash, ReadValueAndVerifyChecksum_CorruptValue) {
+  flash_.buffer()[kHeader1.size() + kKey1.size()] = byte{'v'};
+
+  char value[16] = {};
+  auto result = entry_.ReadValueAndVerifyChecksum(
+      "key45", std::as_writable_bytes(std::span(value)));
+
+  EXPECT_EQ(Status::DataLoss(), result.status());
+  EXPECT_EQ(0u, result.size());
+}
+
+TEST(ValidEntry, ReadValueAndVerifyChecksum_LargeValue) {
+  FakeFlashMemoryBuffer<1024, 4> flash;
+  FlashPartition partition(&flash, 0, flash.sector_count(), 32);
+
+  std::array<byte, 700> value;
+  for (size_t i = 0; i < value.size(); ++i) {
+    value[i] = byte(i * 7);
+  }
+
+  Entry entry = Entry::Valid(
+      partition, 0, kFormatWithChecksum, "key45", value, kTransactionId1);
+  ASSERT_EQ(OkStatus(), entry.Write("key45", value).status());
+  ASSERT_EQ(OkStatus(), Entry::Read(partition, 0, kFormats, &entry));
+
+  std::array<byte, 1024> read_value = {};
+  auto result = entry.ReadValueAndVerifyChecksum("key45", read_value);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(value.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(value.data(), read_value.data(), value.size()));
+
+  // Corrupt a byte past the first chunk of the value.
+  flash.buffer()[sizeof(EntryHeader) + 5 + 600] ^= byte{1};
+  EXPECT_EQ(Status::DataLoss(),
+            entry.ReadValueAndVerifyChecksum("key45", read_value).status());
+}
+
 TEST(ValidEntry, Write) {
   FakeFlashMemoryBuffer<1024, 4> flash;
   FlashPartition partition(&flash, 0, flash.sector_count(), 32);
@@ -17,8 +17,11 @@
 
 #include "pw_kvs/fake_flash_memory.h"
 
+#include <utility>
+
 #include "pw_kvs_private/config.h"
 #include "pw_log/log.h"
+#include "pw_status/try.h"
 
 namespace pw::kvs {
 
@@ -58,6 +61,83 @@ Status FlashError::Check(FlashMemory::Address start_address, size_t size) {
 }
 
 Status FakeFlashMemory::Erase(Address address, size_t num_sectors) {
+  CompletePendingOperation();
+  return EraseNow(address, num_sectors);
+}
+
+StatusWithSize FakeFlashMemory::Read(Address address,
+                                     std::span<std::byte> output) {
+  CompletePendingOperation();
+
+  if (address + output.size() >= sector_count() * size_bytes()) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  // Check for injected read errors
+  Status status = FlashError::Check(read_errors_, address, output.size());
+  std::memcpy(output.data(), &buffer_[address], output.size());
+  return StatusWithSize(status, output.size());
+}
+
+StatusWithSize FakeFlashMemory::Write(Address address,
+                                      std::span<const std::byte> data) {
+  CompletePendingOperation();
+  return WriteNow(address, data);
+}
+
+Status FakeFlashMemory::StartErase(Address address,
+                                   size_t num_sectors,
+                                   Callback&& on_complete) {
+  if (pending_.type != PendingOperation::kNone) {
+    return Status::Unavailable();
+  }
+  PW_TRY(CheckErase(address, num_sectors));
+
+  pending_.type = PendingOperation::kErase;
+  pending_.address = address;
+  pending_.num_sectors = num_sectors;
+  pending_.on_complete = std::move(on_complete);
+  return OkStatus();
+}
+
+Status FakeFlashMemory::StartWrite(Address address,
+                                   std::span<const std::byte> data,
+                                   Callback&& on_complete) {
+  if (pending_.type != PendingOperation::kNone) {
+    return Status::Unavailable();
+  }
+  PW_TRY(CheckWrite(address, data.size()));
+
+  pending_.type = PendingOperation::kWrite;
+  pending_.address = address;
+  pending_.data = data;
+  pending_.on_complete = std::move(on_complete);
+  return OkStatus();
+}
+
+bool FakeFlashMemory::CompletePendingOperation() {
+  Status status;
+
+  switch (pending_.type) {
+    case PendingOperation::kNone:
+      return false;
+    case PendingOperation::kErase:
+      status = EraseNow(pending_.address, pending_.num_sectors);
+      break;
+    case PendingOperation::kWrite:
+      status = WriteNow(pending_.address, pending_.data).status();
+      break;
+  }
+
+  // Clear the pending operation before calling the callback, which may start
+  // another one.
+  Callback on_complete = std::move(pending_.on_complete);
+  pending_.type = PendingOperation::kNone;
+  on_complete(status);
+  return true;
+}
+
+Status FakeFlashMemory::CheckErase(Address address, size_t num_sectors) const {
   if (address % sector_size_bytes() != 0) {
     PW_LOG_ERROR(
         "Attempted to erase sector at non-sector aligned boundary; address %x",
@@ -73,51 +153,46 @@ Status FakeFlashMemory::Erase(Address address, size_t num_sectors) {
         unsigned(sector_id));
     return Status::OutOfRange();
   }
-
-  std::memset(
-      &buffer_[address], int(kErasedValue), sector_size_bytes() * num_sectors);
   return OkStatus();
 }
 
-StatusWithSize FakeFlashMemory::Read(Address address,
-                                     std::span<std::byte> output) {
-  if (address + output.size() >= sector_count() * size_bytes()) {
-    return StatusWithSize::OutOfRange();
-  }
-
-  // Check for injected read errors
-  Status status = FlashError::Check(read_errors_, address, output.size());
-  std::memcpy(output.data(), &buffer_[address], output.size());
-  return StatusWithSize(status, output.size());
-}
-
-StatusWithSize FakeFlashMemory::Write(Address address,
-                                      std::span<const std::byte> data) {
-  if (address % alignment_bytes() != 0 ||
-      data.size() % alignment_bytes() != 0) {
+Status FakeFlashMemory::CheckWrite(Address address, size_t size) const {
+  if (address % alignment_bytes() != 0 || size % alignment_bytes() != 0) {
     PW_LOG_ERROR("Unaligned write; address %x, size %u B, alignment %u",
                  unsigned(address),
-                 unsigned(data.size()),
+                 unsigned(size),
                  unsigned(alignment_bytes()));
-    return StatusWithSize::InvalidArgument();
+    return Status::InvalidArgument();
   }
 
-  if (address + data.size() > sector_count() * sector_size_bytes()) {
+  if (address + size > sector_count() * sector_size_bytes()) {
     PW_LOG_ERROR(
         "Write beyond end of memory; address %x, size %u B, max address %x",
         unsigned(address),
-        unsigned(data.size()),
+        unsigned(size),
         unsigned(sector_count() * sector_size_bytes()));
-    return StatusWithSize::OutOfRange();
+    return Status::OutOfRange();
   }
+  return OkStatus();
+}
+
+Status FakeFlashMemory::EraseNow(Address address, size_t num_sectors) {
+  PW_TRY(CheckErase(address, num_sectors));
+
+  std::memset(
+      &buffer_[address], int(kErasedValue), sector_size_bytes() * num_sectors);
+  return OkStatus();
+}
+
+StatusWithSize FakeFlashMemory::WriteNow(Address address,
+                                         std::span<const std::byte> data) {
+  PW_TRY_WITH_SIZE(CheckWrite(address, data.size()));
 
   // Check in erased state
-  for (unsigned i = 0; i < data.size(); i++) {
-    if (buffer_[address + i] != kErasedValue) {
-      PW_LOG_ERROR("Writing to previously written address: %x",
-                   unsigned(address));
-      return StatusWithSize::Unknown();
-    }
+  if (!AppearsErased(buffer_.subspan(address, data.size()))) {
+    PW_LOG_ERROR("Writing to previously written address: %x",
+                 unsigned(address));
+    return StatusWithSize::Unknown();
   }
 
   // Check for any injected write errors
@@ -0,0 +1,137 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_kvs/fake_flash_memory.h"
+
+#include <array>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/caching_flash_partition.h"
+#include "pw_kvs/flash_memory.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr std::byte kErased = FakeFlashMemory::kErasedValue;
+
+class AsyncFlashTest : public ::testing::Test {
+ protected:
+  AsyncFlashTest() : flash_(4), partition_(&flash_) {}
+
+  // Returns a callback that records the result of the operation.
+  FlashMemory::Callback RecordResult() {
+    return [this](Status status) {
+      completed_ += 1;
+      result_ = status;
+    };
+  }
+
+  FakeFlashMemoryBuffer<64, 4> flash_;
+  FlashPartition partition_;
+  int completed_ = 0;
+  Status result_;
+};
+
+constexpr std::array<std::byte, 8> kData = {
+    std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4},
+    std::byte{5}, std::byte{6}, std::byte{7}, std::byte{8}};
+
+TEST_F(AsyncFlashTest, StartWrite_CompletesLater) {
+  ASSERT_EQ(OkStatus(), partition_.StartWrite(64, kData, RecordResult()));
+  EXPECT_TRUE(flash_.operation_pending());
+  EXPECT_EQ(0, completed_);
+  EXPECT_EQ(kErased, flash_.buffer()[64]);
+
+  EXPECT_TRUE(flash_.CompletePendingOperation());
+  EXPECT_EQ(1, completed_);
+  EXPECT_EQ(OkStatus(), result_);
+  EXPECT_EQ(std::byte{1}, flash_.buffer()[64]);
+  EXPECT_FALSE(flash_.CompletePendingOperation());
+}
+
+TEST_F(AsyncFlashTest, StartErase_CompletesLater) {
+  ASSERT_EQ(OkStatus(), partition_.Write(64, kData).status());
+  ASSERT_EQ(OkStatus(), partition_.StartErase(64, 1, RecordResult()));
+  EXPECT_EQ(std::byte{1}, flash_.buffer()[64]);
+
+  EXPECT_TRUE(flash_.CompletePendingOperation());
+  EXPECT_EQ(1, completed_);
+  EXPECT_EQ(OkStatus(), result_);
+  EXPECT_EQ(kErased, flash_.buffer()[64]);
+}
+
+TEST_F(AsyncFlashTest, OneOperationAtATime) {
+  ASSERT_EQ(OkStatus(), partition_.StartErase(0, 1, RecordResult()));
+  EXPECT_EQ(Status::Unavailable(),
+            partition_.StartWrite(64, kData, RecordResult()));
+  EXPECT_EQ(Status::Unavailable(),
+            partition_.StartErase(64, 1, RecordResult()));
+
+  EXPECT_TRUE(flash_.CompletePendingOperation());
+  EXPECT_EQ(1, completed_);
+  EXPECT_EQ(OkStatus(), partition_.StartWrite(64, kData, RecordResult()));
+}
+
+TEST_F(AsyncFlashTest, BlockingCallWaitsForPendingOperation) {
+  ASSERT_EQ(OkStatus(), partition_.StartWrite(64, kData, RecordResult()));
+
+  std::array<std::byte, 8> read = {};
+  ASSERT_EQ(OkStatus(), partition_.Read(64, read).status());
+  EXPECT_EQ(1, completed_);
+  EXPECT_EQ(std::byte{8}, read[7]);
+}
+
+TEST_F(AsyncFlashTest, InvalidArguments_NotStarted) {
+  EXPECT_EQ(Status::InvalidArgument(),
+            flash_.StartWrite(2, kData, RecordResult()));
+  EXPECT_FALSE(flash_.operation_pending());
+  EXPECT_EQ(Status::OutOfRange(),
+            partition_.StartErase(0, 5, RecordResult()));
+  EXPECT_FALSE(flash_.operation_pending());
+  EXPECT_EQ(0, completed_);
+}
+
+TEST_F(AsyncFlashTest, WriteError_ReportedToCallback) {
+  ASSERT_EQ(OkStatus(), partition_.Write(64, kData).status());
+  ASSERT_EQ(OkStatus(), partition_.StartWrite(64, kData, RecordResult()));
+
+  EXPECT_TRUE(flash_.CompletePendingOperation());
+  EXPECT_EQ(1, completed_);
+  EXPECT_EQ(Status::Unknown(), result_);  // Already written.
+}
+
+TEST_F(AsyncFlashTest, ReadOnlyPartition_PermissionDenied) {
+  FlashPartition read_only(
+      &flash_, 0, flash_.sector_count(), 4, PartitionPermission::kReadOnly);
+  EXPECT_EQ(Status::PermissionDenied(),
+            read_only.StartErase(0, 1, RecordResult()));
+  EXPECT_EQ(Status::PermissionDenied(),
+            read_only.StartWrite(0, kData, RecordResult()));
+}
+
+TEST_F(AsyncFlashTest, CachingPartition_StartWriteInvalidatesCache) {
+  CachingFlashPartitionBuffer<16, 2> caching(&flash_, 0, flash_.sector_count());
+
+  std::array<std::byte, 8> read = {};
+  ASSERT_EQ(OkStatus(), caching.Read(64, read).status());
+  EXPECT_EQ(kErased, read[0]);
+
+  ASSERT_EQ(OkStatus(), caching.StartWrite(64, kData, RecordResult()));
+  ASSERT_EQ(OkStatus(), caching.Read(64, read).status());
+  EXPECT_EQ(1, completed_);
+  EXPECT_EQ(std::byte{1}, read[0]);
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cstring>
+#include <utility>
 
 #include "pw_assert/check.h"
 #include "pw_kvs_private/config.h"
@@ -31,6 +32,30 @@ namespace pw::kvs {
 
 using std::byte;
 
+bool FlashMemory::AppearsErased(std::span<const byte> data) const {
+  size_t i = 0;
+
+  if (data.size() >= sizeof(uintptr_t)) {
+    uintptr_t erased_word;
+    std::memset(&erased_word, int(erased_memory_content_), sizeof(erased_word));
+
+    for (; i + sizeof(uintptr_t) <= data.size(); i += sizeof(uintptr_t)) {
+      uintptr_t word;
+      std::memcpy(&word, &data[i], sizeof(word));
+      if (word != erased_word) {
+        return false;
+      }
+    }
+  }
+
+  for (; i < data.size(); ++i) {
+    if (data[i] != erased_memory_content_) {
+      return false;
+    }
+  }
+  return true;
+}
+
 StatusWithSize FlashPartition::Output::DoWrite(std::span<const byte> data) {
   PW_TRY_WITH_SIZE(flash_.Write(address_, data));
   address_ += data.size();
@@ -95,6 +120,36 @@ StatusWithSize FlashPartition::Write(Address address,
   return flash_.Write(PartitionToFlashAddress(address), data);
 }
 
+Status FlashPartition::StartErase(Address address,
+                                  size_t num_sectors,
+                                  FlashMemory::Callback&& on_complete) {
+  if (permission_ == PartitionPermission::kReadOnly) {
+    return Status::PermissionDenied();
+  }
+
+  PW_TRY(CheckBounds(address, num_sectors * sector_size_bytes()));
+  const size_t address_sector_offset = address % sector_size_bytes();
+  PW_CHECK_UINT_EQ(address_sector_offset, 0u);
+
+  return flash_.StartErase(
+      PartitionToFlashAddress(address), num_sectors, std::move(on_complete));
+}
+
+Status FlashPartition::StartWrite(Address address,
+                                  std::span<const byte> data,
+                                  FlashMemory::Callback&& on_complete) {
+  if (permission_ == PartitionPermission::kReadOnly) {
+    return Status::PermissionDenied();
+  }
+  PW_TRY(CheckBounds(address, data.size()));
+  const size_t address_alignment_offset = address % alignment_bytes();
+  PW_CHECK_UINT_EQ(address_alignment_offset, 0u);
+  const size_t size_alignment_offset = data.size() % alignment_bytes();
+  PW_CHECK_UINT_EQ(size_alignment_offset, 0u);
+  return flash_.StartWrite(
+      PartitionToFlashAddress(address), data, std::move(on_complete));
+}
+
 Status FlashPartition::IsRegionErased(Address source_flash_address,
                                       size_t length,
                                       bool* is_erased) {
@@ -114,7 +169,6 @@ Status FlashPartition::IsRegionErased(Address source_flash_address,
   }
 
   byte read_buffer[kMaxFlashAlignment];
-  const byte erased_byte = flash_.erased_memory_content();
   size_t offset = 0;
   *is_erased = false;
   while (length > 0u) {
@@ -123,11 +177,9 @@ Status FlashPartition::IsRegionErased(Address source_flash_address,
     PW_TRY(
         Read(source_flash_address + offset, read_size, read_buffer).status());
 
-    for (byte b : std::span(read_buffer, read_size)) {
-      if (b != erased_byte) {
-        // Detected memory chunk is not entirely erased
-        return OkStatus();
-      }
+    if (!flash_.AppearsErased(std::span(read_buffer, read_size))) {
+      // Detected memory chunk is not entirely erased
+      return OkStatus();
     }
 
     offset += read_size;
@@ -138,13 +190,7 @@ Status FlashPartition::IsRegionErased(Address source_flash_address,
 }
 
 bool FlashPartition::AppearsErased(std::span<const byte> data) const {
-  byte erased_content = flash_.erased_memory_content();
-  for (byte b : data) {
-    if (b != erased_content) {
-      return false;
-    }
-  }
-  return true;
+  return flash_.AppearsErased(data);
 }
 
 Status FlashPartition::CheckBounds(Address address, size_t length) const {
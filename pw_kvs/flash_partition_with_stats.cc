@@ -18,6 +18,7 @@
 #include "pw_kvs/flash_partition_with_stats.h"
 
 #include <cstdio>
+#include <utility>
 
 #include "pw_kvs/flash_memory.h"
 #include "pw_kvs_private/config.h"
@@ -71,6 +72,19 @@ Status FlashPartitionWithStats::SaveStorageStats(const KeyValueStore& kvs,
 }
 
 Status FlashPartitionWithStats::Erase(Address address, size_t num_sectors) {
+  CountErases(address, num_sectors);
+  return FlashPartition::Erase(address, num_sectors);
+}
+
+Status FlashPartitionWithStats::StartErase(
+    Address address, size_t num_sectors, FlashMemory::Callback&& on_complete) {
+  CountErases(address, num_sectors);
+  return FlashPartition::StartErase(
+      address, num_sectors, std::move(on_complete));
+}
+
+void FlashPartitionWithStats::CountErases(Address address,
+                                          size_t num_sectors) {
   size_t base_index = address / FlashPartition::sector_size_bytes();
   if (base_index < sector_counters_.size()) {
     num_sectors = std::min(num_sectors, (sector_counters_.size() - base_index));
@@ -78,8 +92,23 @@ Status FlashPartitionWithStats::Erase(Address address, size_t num_sectors) {
       sector_counters_[base_index + i]++;
     }
   }
+}
 
-  return FlashPartition::Erase(address, num_sectors);
+void FlashPartitionWithStats::RecordWriteLatency(
+    std::chrono::microseconds latency) {
+  const uint64_t micros =
+      latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0u;
+
+  // Bucket i holds latencies of [2^(i-1), 2^i) us, so the bucket is the number
+  // of bits needed to represent the latency.
+  size_t bucket = 0;
+  for (uint64_t remaining = micros; remaining != 0u; remaining >>= 1) {
+    bucket += 1;
+  }
+  bucket = std::min(bucket, kWriteLatencyBuckets - 1);
+
+  write_latency_histogram_[bucket] += 1;
+  max_write_latency_ = std::max(max_write_latency_, latency);
 }
 
 }  // namespace pw::kvs
@@ -18,11 +18,14 @@
 #include "pw_kvs/key_value_store.h"
 
 #include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <cstring>
 #include <type_traits>
 
 #include "pw_assert/check.h"
+#include "pw_checksum/crc32.h"
+#include "pw_kvs/alignment.h"
 #include "pw_kvs_private/config.h"
 #include "pw_log/shorter.h"
 #include "pw_status/try.h"
@@ -36,25 +39,93 @@ constexpr bool InvalidKey(Key key) {
   return key.empty() || (key.size() > internal::Entry::kMaxKeyLength);
 }
 
+// Metadata checkpoints are stored in the checkpoint partition as follows:
+//
+//   [invalidation marker][CheckpointHeader][sector records][entry records]
+//
+// The invalidation marker is left erased when a checkpoint is written, and is
+// overwritten to invalidate the checkpoint without an erase. The header is
+// written last, so an interrupted write never leaves a valid checkpoint. Each
+// region starts on a partition alignment boundary.
+//
+// Each sector record is a uint32_t with the number of bytes written to the
+// sector. Each entry record is a CheckpointEntry followed by its addresses.
+constexpr uint32_t kCheckpointMagic = 0x91d2c35e;
+
+struct CheckpointHeader {
+  uint32_t magic;
+  uint32_t crc;  // CRC32 of the sector and entry records.
+  uint32_t sector_size_bytes;
+  uint32_t sector_count;
+  uint32_t entry_count;
+  uint32_t redundancy;
+};
+
+struct CheckpointEntry {
+  uint32_t key_hash;
+  uint32_t transaction_id;
+  uint16_t deleted;
+  uint16_t address_count;
+  uint16_t namespace_tag;
+  uint16_t reserved;
+};
+
+static_assert(sizeof(CheckpointHeader) == 24u);
+static_assert(sizeof(CheckpointEntry) == 16u);
+
+// If erase counts are tracked, each sector starts with a SectorHeader, padded
+// with zeros to the entry alignment. The header is written after the sector is
+// erased. A sector with an erased header has not been erased by the KVS since
+// the partition was formatted, so its erase count is 0.
+constexpr uint32_t kSectorHeaderMagic = 0x2c9e57b1;
+
+struct SectorHeader {
+  uint32_t magic;
+  uint32_t erase_count;
+  uint32_t erase_count_inverted;  // ~erase_count, to validate the header
+  uint32_t reserved;
+};
+
+static_assert(sizeof(SectorHeader) == internal::Entry::kMinAlignmentBytes);
+
+constexpr size_t CheckpointHeaderAddress(size_t alignment_bytes) {
+  return AlignUp(sizeof(uint32_t), alignment_bytes);
+}
+
+constexpr size_t CheckpointRecordsAddress(size_t alignment_bytes) {
+  return CheckpointHeaderAddress(alignment_bytes) +
+         AlignUp(sizeof(CheckpointHeader), alignment_bytes);
+}
+
 }  // namespace
 
-KeyValueStore::KeyValueStore(FlashPartition* partition,
-                             std::span<const EntryFormat> formats,
-                             const Options& options,
-                             size_t redundancy,
-                             Vector<SectorDescriptor>& sector_descriptor_list,
-                             const SectorDescriptor** temp_sectors_to_skip,
-                             Vector<KeyDescriptor>& key_descriptor_list,
-                             Address* addresses)
+KeyValueStore::KeyValueStore(
+    FlashPartition* partition,
+    std::span<const EntryFormat> formats,
+    const Options& options,
+    size_t redundancy,
+    Vector<SectorDescriptor>& sector_descriptor_list,
+    const SectorDescriptor** temp_sectors_to_skip,
+    Vector<uint32_t>& key_hash_list,
+    internal::KeyDetails* key_details,
+    Address* addresses,
+    std::span<internal::EntryCache::IndexSlot> key_index,
+    std::span<internal::Sectors::IndexNode> sector_index)
     : partition_(*partition),
       formats_(formats),
-      sectors_(sector_descriptor_list, *partition, temp_sectors_to_skip),
-      entry_cache_(key_descriptor_list, addresses, redundancy),
+      sectors_(sector_descriptor_list,
+               *partition,
+               temp_sectors_to_skip,
+               sector_index),
+      entry_cache_(
+          key_hash_list, key_details, addresses, redundancy, key_index),
       options_(options),
       initialized_(InitializationState::kNotInitialized),
       error_detected_(false),
       internal_stats_({}),
-      last_transaction_id_(0) {}
+      last_transaction_id_(0),
+      incremental_gc_sector_(nullptr),
+      checkpoint_valid_(false) {}
 
 Status KeyValueStore::Init() {
   initialized_ = InitializationState::kNotInitialized;
@@ -88,7 +159,7 @@ Status KeyValueStore::Init() {
     return Status::FailedPrecondition();
   }
 
-  Status metadata_result = InitializeMetadata();
+  Status metadata_result = InitializeMetadataFromCheckpoint();
 
   if (!error_detected_) {
     initialized_ = InitializationState::kReady;
@@ -136,12 +207,58 @@ Status KeyValueStore::Init() {
   return OkStatus();
 }
 
-Status KeyValueStore::InitializeMetadata() {
-  const size_t sector_size_bytes = partition_.sector_size_bytes();
+size_t KeyValueStore::SectorHeaderBytes() const {
+  if (!options_.track_erase_counts) {
+    return 0;
+  }
+  return AlignUp(sizeof(SectorHeader),
+                 std::max(partition_.alignment_bytes(),
+                          internal::Entry::kMinAlignmentBytes));
+}
 
-  sectors_.Reset();
+Status KeyValueStore::InitializeMetadata() {
+  sectors_.Reset(SectorHeaderBytes());
   entry_cache_.Reset();
+  incremental_gc_sector_ = nullptr;
+
+  return ScanMetadata(/*from_checkpoint=*/false);
+}
+
+Status KeyValueStore::InitializeMetadataFromCheckpoint() {
+  checkpoint_valid_ = false;
+
+  if (options_.checkpoint_partition == nullptr) {
+    return InitializeMetadata();
+  }
+
+  incremental_gc_sector_ = nullptr;
+  if (!LoadCheckpoint().ok()) {
+    DBG("No valid checkpoint; reading all entries");
+    return InitializeMetadata();
+  }
 
+  INF("Loaded KVS checkpoint; reading entries written after it");
+  const Status status = ScanMetadata(/*from_checkpoint=*/true);
+  checkpoint_valid_ = true;
+  if (!status.IsAborted()) {
+    return status;
+  }
+
+  // The checkpoint does not match flash, which may be erased or rewritten.
+  // Invalidate it so that it is not loaded again.
+  WRN("KVS checkpoint does not match flash; reading all entries");
+  if (!InvalidateCheckpoint().ok()) {
+    ERR("Failed to invalidate KVS checkpoint");
+  }
+  error_detected_ = false;
+  return InitializeMetadata();
+}
+
+Status KeyValueStore::ScanMetadata(bool from_checkpoint) {
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+
+  // When loading from a checkpoint, the sectors' writable bytes were restored
+  // from the checkpoint, so only entries written after it are read.
   DBG("First pass: Read all entries from all sectors");
   Address sector_address = 0;
 
@@ -151,10 +268,19 @@ Status KeyValueStore::InitializeMetadata() {
   size_t entry_copies_missing = 0;
 
   for (SectorDescriptor& sector : sectors_) {
-    Address entry_address = sector_address;
+    Address entry_address =
+        sector_address + (sector_size_bytes - sector.writable_bytes());
 
     size_t sector_corrupt_bytes = 0;
 
+    if (sectors_.tracks_erase_counts() && !ReadSectorHeader(sector).ok()) {
+      // The sector cannot be trusted without a valid header. Garbage
+      // collecting it writes a new header.
+      WRN("Sector %u has an invalid header", sectors_.Index(sector));
+      error_detected_ = true;
+      sector_corrupt_bytes += sectors_.sector_header_bytes();
+    }
+
     for (int num_entries_in_sector = 0; true; num_entries_in_sector++) {
       DBG("Load entry: sector=%u, entry#=%d, address=%u",
           unsigned(sector_address),
@@ -198,8 +324,8 @@ Status KeyValueStore::InitializeMetadata() {
       entry_address = next_entry_address;
 
       // Update of the number of writable bytes in this sector.
-      sector.set_writable_bytes(sector_size_bytes -
-                                (entry_address - sector_address));
+      sectors_.set_writable_bytes(
+          sector, sector_size_bytes - (entry_address - sector_address));
     }
 
     if (sector_corrupt_bytes > 0) {
@@ -207,7 +333,7 @@ Status KeyValueStore::InitializeMetadata() {
       // being written to it by indicating that it has no space. This should
       // also make it a decent GC candidate. Valid keys in the sector are still
       // readable as normal.
-      sector.mark_corrupt();
+      sectors_.mark_corrupt(sector);
       error_detected_ = true;
 
       WRN("Sector %u contains %uB of corrupt data",
@@ -215,7 +341,7 @@ Status KeyValueStore::InitializeMetadata() {
           unsigned(sector_corrupt_bytes));
     }
 
-    if (sector.Empty(sector_size_bytes)) {
+    if (sector.Empty(sectors_.sector_data_bytes())) {
       empty_sector_found = true;
     }
     sector_address += sector_size_bytes;
@@ -244,16 +370,24 @@ Status KeyValueStore::InitializeMetadata() {
 
       Status read_result = Entry::Read(partition_, address, formats_, &entry);
 
+      // Flash that does not match the checkpoint is not corruption; the
+      // checkpoint is stale.
+      if (from_checkpoint &&
+          (!read_result.ok() ||
+           entry.transaction_id() != metadata.transaction_id())) {
+        return Status::Aborted();
+      }
+
       SectorDescriptor& sector = sectors_.FromAddress(address);
 
       if (read_result.ok()) {
-        sector.AddValidBytes(entry.size());
+        sectors_.AddValidBytes(sector, entry.size());
         index++;
       } else {
         corrupt_entries++;
         total_corrupt_bytes += sector.writable_bytes();
         error_detected_ = true;
-        sector.mark_corrupt();
+        sectors_.mark_corrupt(sector);
 
         // Remove the bad address and stay at this index. The removal
         // replaces out the removed address with the back address so
@@ -299,14 +433,21 @@ Status KeyValueStore::InitializeMetadata() {
 
 KeyValueStore::StorageStats KeyValueStore::GetStorageStats() const {
   StorageStats stats{};
-  const size_t sector_size = partition_.sector_size_bytes();
+  const size_t sector_size = sectors_.sector_data_bytes();
   bool found_empty_sector = false;
   stats.sector_erase_count = internal_stats_.sector_erase_count;
   stats.corrupt_sectors_recovered = internal_stats_.corrupt_sectors_recovered;
   stats.missing_redundant_entries_recovered =
       internal_stats_.missing_redundant_entries_recovered;
+  stats.min_sector_erase_count = sectors_.size() > 0u ? SIZE_MAX : 0u;
+  stats.max_sector_erase_count = 0;
 
   for (const SectorDescriptor& sector : sectors_) {
+    stats.min_sector_erase_count =
+        std::min<size_t>(stats.min_sector_erase_count, sector.erase_count());
+    stats.max_sector_erase_count =
+        std::max<size_t>(stats.max_sector_erase_count, sector.erase_count());
+
     stats.in_use_bytes += sector.valid_bytes();
     stats.reclaimable_bytes += sector.RecoverableBytes(sector_size);
 
@@ -400,6 +541,47 @@ Status KeyValueStore::ScanForEntry(const SectorDescriptor& sector,
   return Status::NotFound();
 }
 
+Status KeyValueStore::ReadSectorHeader(SectorDescriptor& sector) {
+  SectorHeader header;
+  PW_TRY(partition_
+             .Read(sectors_.BaseAddress(sector),
+                   std::as_writable_bytes(std::span(&header, 1)))
+             .status());
+
+  if (partition_.AppearsErased(std::as_bytes(std::span(&header, 1)))) {
+    sectors_.set_erase_count(sector, 0);
+    return OkStatus();
+  }
+
+  if (header.magic != kSectorHeaderMagic ||
+      header.erase_count != ~header.erase_count_inverted) {
+    return Status::DataLoss();
+  }
+
+  sectors_.set_erase_count(sector, header.erase_count);
+  return OkStatus();
+}
+
+Status KeyValueStore::WriteSectorHeader(SectorDescriptor& sector,
+                                        uint32_t erase_count) {
+  const SectorHeader header = {
+      .magic = kSectorHeaderMagic,
+      .erase_count = erase_count,
+      .erase_count_inverted = ~erase_count,
+      .reserved = 0,
+  };
+
+  FlashPartition::Output output(partition_, sectors_.BaseAddress(sector));
+  PW_TRY(AlignedWrite<kMaxFlashAlignment>(
+             output,
+             sectors_.sector_header_bytes(),
+             {std::as_bytes(std::span(&header, 1))})
+             .status());
+
+  sectors_.set_erase_count(sector, erase_count);
+  return OkStatus();
+}
+
 StatusWithSize KeyValueStore::Get(Key key,
                                   std::span<byte> value_buffer,
                                   size_t offset_bytes) const {
@@ -417,7 +599,7 @@ Status KeyValueStore::PutBytes(Key key, std::span<const byte> value) {
       unsigned(key.size()),
       unsigned(value.size()));
 
-  if (Entry::size(partition_, key, value) > partition_.sector_size_bytes()) {
+  if (Entry::size(partition_, key, value) > sectors_.sector_data_bytes()) {
     DBG("%u B value with %u B key cannot fit in one sector",
         unsigned(value.size()),
         unsigned(key.size()));
@@ -457,7 +639,139 @@ Status KeyValueStore::Delete(Key key) {
   return WriteEntryForExistingKey(metadata, EntryState::kDeleted, key, {});
 }
 
+Status KeyValueStore::PutBatch(std::span<const BatchItem> items) {
+  // Validate the whole batch before writing anything.
+  size_t batch_size = 0;
+  size_t new_keys = 0;
+  for (size_t i = 0; i < items.size(); ++i) {
+    const BatchItem& item = items[i];
+    PW_TRY(CheckWriteOperation(item.key));
+
+    for (size_t j = 0; j < i; ++j) {
+      if (items[j].key == item.key) {
+        DBG("Key 0x%08x appears more than once in batch",
+            unsigned(internal::Hash(item.key)));
+        return Status::InvalidArgument();
+      }
+    }
+
+    batch_size += Entry::size(partition_, item.key, item.value);
+
+    EntryMetadata metadata;
+    const Status status = FindEntry(item.key, &metadata);
+    if (status.IsNotFound()) {
+      new_keys += 1;
+    } else if (!status.ok()) {
+      return status;
+    }
+  }
+
+  DBG("Writing batch of %u items, %u B",
+      unsigned(items.size()),
+      unsigned(batch_size));
+
+  if (batch_size > sectors_.sector_data_bytes()) {
+    DBG("%u B batch cannot fit in one sector", unsigned(batch_size));
+    return Status::InvalidArgument();
+  }
+
+  if (entry_cache_.total_entries() + new_keys > entry_cache_.max_entries()) {
+    WRN("KVS full: batch has %u new entries, but only %u fit",
+        unsigned(new_keys),
+        unsigned(entry_cache_.max_entries() - entry_cache_.total_entries()));
+    return Status::ResourceExhausted();
+  }
+
+  // Find space for the entire batch. Any garbage collection happens here,
+  // before any entries are written.
+  Address* reserved_addresses = entry_cache_.TempReservedAddressesForWrite();
+  PW_TRY(GetAddressesForWrite(reserved_addresses, batch_size));
+
+  // Entries with transaction IDs after this were written by this batch.
+  const uint32_t batch_start_id = last_transaction_id_;
+
+  for (size_t copy = 0; copy < redundancy(); ++copy) {
+    SectorDescriptor& sector = sectors_.FromAddress(reserved_addresses[copy]);
+    const Address start_address = sectors_.NextWritableAddress(sector);
+    Address address = start_address;
+
+    FlashPartition::Output output(partition_, start_address);
+    AlignedWriterBuffer<kMaxFlashAlignment> writer(partition_.alignment_bytes(),
+                                                   output);
+
+    for (const BatchItem& item : items) {
+      EntryMetadata metadata;
+      const bool found = FindEntry(item.key, &metadata).ok();
+      Entry entry;
+
+      if (copy == 0u) {
+        Entry prior_entry;
+        if (found) {
+          PW_TRY(ReadEntry(metadata, prior_entry));
+
+          // As with Put, skip writing values that have not changed.
+          if (prior_entry.value_size() == item.value.size() &&
+              metadata.state() == EntryState::kValid &&
+              prior_entry.ValueMatches(item.value).ok()) {
+            DBG("Write for key 0x%08x with matching value skipped",
+                unsigned(metadata.hash()));
+            continue;
+          }
+        }
+
+        entry = CreateEntry(address, item.key, item.value, EntryState::kValid);
+        PW_TRY(MarkSectorCorruptIfNotOk(
+            entry.Write(writer, item.key, item.value).status(), &sector));
+        CreateOrUpdateKeyDescriptor(entry,
+                                    item.key,
+                                    found ? &metadata : nullptr,
+                                    found ? prior_entry.size() : 0);
+      } else {
+        // Redundant copies are only written for items that were written to
+        // the first copy.
+        if (!found || metadata.transaction_id() <= batch_start_id) {
+          continue;
+        }
+        entry = Entry::Valid(partition_,
+                             address,
+                             formats_.primary(),
+                             item.key,
+                             item.value,
+                             metadata.transaction_id());
+        PW_TRY(MarkSectorCorruptIfNotOk(
+            entry.Write(writer, item.key, item.value).status(), &sector));
+        metadata.AddNewAddress(address);
+      }
+
+      address = entry.next_address();
+    }
+
+    PW_TRY(MarkSectorCorruptIfNotOk(writer.Flush().status(), &sector));
+
+    if (options_.verify_on_write) {
+      for (Address entry_address = start_address; entry_address < address;) {
+        Entry entry;
+        PW_TRY(MarkSectorCorruptIfNotOk(
+            Entry::Read(partition_, entry_address, formats_, &entry),
+            &sector));
+        PW_TRY(
+            MarkSectorCorruptIfNotOk(entry.VerifyChecksumInFlash(), &sector));
+        entry_address = entry.next_address();
+      }
+    }
+
+    sectors_.RemoveWritableBytes(sector, address - start_address);
+    sectors_.AddValidBytes(sector, address - start_address);
+  }
+
+  return OkStatus();
+}
+
 void KeyValueStore::Item::ReadKey() {
+  if (key_read_) {
+    return;
+  }
+  key_read_ = true;
   key_buffer_.fill('\0');
 
   Entry entry;
@@ -468,21 +782,42 @@ void KeyValueStore::Item::ReadKey() {
 }
 
 KeyValueStore::iterator& KeyValueStore::iterator::operator++() {
-  // Skip to the next entry that is valid (not deleted).
-  while (++item_.iterator_ != item_.kvs_.entry_cache_.end() &&
-         item_.iterator_->state() != EntryState::kValid) {
-  }
+  // Skip to the next entry that is valid (not deleted) and matches the prefix.
+  do {
+    ++item_.iterator_;
+    item_.key_read_ = false;
+  } while (item_.iterator_ != item_.kvs_.entry_cache_.end() && !Matches());
   return *this;
 }
 
-KeyValueStore::iterator KeyValueStore::begin() const {
-  internal::EntryCache::const_iterator cache_iterator = entry_cache_.begin();
-  // Skip over any deleted entries at the start of the descriptor list.
-  while (cache_iterator != entry_cache_.end() &&
-         cache_iterator->state() != EntryState::kValid) {
-    ++cache_iterator;
+bool KeyValueStore::iterator::Matches() {
+  if (item_.iterator_->state() != EntryState::kValid) {
+    return false;
+  }
+  if (prefix_.empty()) {
+    return true;
   }
-  return iterator(*this, cache_iterator);
+
+  // Entries in other namespaces cannot match, so skip them without reading
+  // their keys from flash.
+  if (match_namespace_ && item_.iterator_->namespace_tag() != namespace_tag_) {
+    return false;
+  }
+
+  item_.ReadKey();
+  const Key key(item_.key());
+  return key.size() >= prefix_.size() &&
+         std::memcmp(key.data(), prefix_.data(), prefix_.size()) == 0;
+}
+
+KeyValueStore::iterator KeyValueStore::BeginWithPrefix(Key prefix) const {
+  iterator it(*this, entry_cache_.begin(), prefix);
+  // Skip over any deleted or non-matching entries at the start of the
+  // descriptor list.
+  if (it != end() && !it.Matches()) {
+    ++it;
+  }
+  return it;
 }
 
 StatusWithSize KeyValueStore::ValueSize(Key key) const {
@@ -506,7 +841,7 @@ Status KeyValueStore::ReadEntry(const EntryMetadata& metadata,
 
     // Found a bad address. Set the sector as corrupt.
     error_detected_ = true;
-    sectors_.FromAddress(address).mark_corrupt();
+    sectors_.mark_corrupt(sectors_.FromAddress(address));
   }
 
   ERR("No valid entries for key. Data has been lost!");
@@ -543,16 +878,16 @@ StatusWithSize KeyValueStore::Get(Key key,
 
   PW_TRY_WITH_SIZE(ReadEntry(metadata, entry));
 
-  StatusWithSize result = entry.ReadValue(value_buffer, offset_bytes);
-  if (result.ok() && options_.verify_on_read && offset_bytes == 0u) {
-    Status verify_result =
-        entry.VerifyChecksum(key, value_buffer.first(result.size()));
-    if (!verify_result.ok()) {
-      std::memset(value_buffer.data(), 0, result.size());
-      return StatusWithSize(verify_result, 0);
-    }
+  if (!options_.verify_on_read || offset_bytes != 0u) {
+    return entry.ReadValue(value_buffer, offset_bytes);
+  }
 
-    return StatusWithSize(verify_result, result.size());
+  // Verify while reading so that the value is only read from flash once.
+  StatusWithSize result = entry.ReadValueAndVerifyChecksum(key, value_buffer);
+  if (result.IsDataLoss()) {
+    std::memset(value_buffer.data(),
+                0,
+                std::min(value_buffer.size(), size_t(entry.value_size())));
   }
   return result;
 }
@@ -710,10 +1045,12 @@ KeyValueStore::EntryMetadata KeyValueStore::UpdateKeyDescriptor(
     size_t prior_size) {
   // Remove valid bytes for the old entry and its copies, which are now stale.
   for (Address address : prior_metadata->addresses()) {
-    sectors_.FromAddress(address).RemoveValidBytes(prior_size);
+    sectors_.RemoveValidBytes(sectors_.FromAddress(address), prior_size);
   }
 
-  prior_metadata->Reset(entry.descriptor(prior_metadata->hash()), new_address);
+  prior_metadata->Reset(
+      entry.descriptor(prior_metadata->hash(), prior_metadata->namespace_tag()),
+      new_address);
   return *prior_metadata;
 }
 
@@ -787,7 +1124,7 @@ Status KeyValueStore::MarkSectorCorruptIfNotOk(Status status,
                                                SectorDescriptor* sector) {
   if (!status.ok()) {
     DBG("  Sector %u corrupt", sectors_.Index(sector));
-    sector->mark_corrupt();
+    sectors_.mark_corrupt(*sector);
     error_detected_ = true;
   }
   return status;
@@ -812,8 +1149,8 @@ Status KeyValueStore::AppendEntry(const Entry& entry,
     PW_TRY(MarkSectorCorruptIfNotOk(entry.VerifyChecksumInFlash(), &sector));
   }
 
-  sector.RemoveWritableBytes(result.size());
-  sector.AddValidBytes(result.size());
+  sectors_.RemoveWritableBytes(sector, result.size());
+  sectors_.AddValidBytes(sector, result.size());
   return OkStatus();
 }
 
@@ -835,8 +1172,8 @@ StatusWithSize KeyValueStore::CopyEntryToSector(Entry& entry,
   }
   // Entry was written successfully; update descriptor's address and the sector
   // descriptors to reflect the new entry.
-  new_sector->RemoveWritableBytes(result.size());
-  new_sector->AddValidBytes(result.size());
+  sectors_.RemoveWritableBytes(*new_sector, result.size());
+  sectors_.AddValidBytes(*new_sector, result.size());
 
   return result;
 }
@@ -862,7 +1199,7 @@ Status KeyValueStore::RelocateEntry(
   Address new_address = sectors_.NextWritableAddress(*new_sector);
   PW_TRY_ASSIGN(const size_t result_size,
                 CopyEntryToSector(entry, new_sector, new_address));
-  sectors_.FromAddress(address).RemoveValidBytes(result_size);
+  sectors_.RemoveValidBytes(sectors_.FromAddress(address), result_size);
   address = new_address;
 
   return OkStatus();
@@ -910,7 +1247,7 @@ Status KeyValueStore::FullMaintenanceHelper(MaintenanceType maintenance_type) {
       sector = sectors_.begin();
     }
 
-    if (sector->RecoverableBytes(partition_.sector_size_bytes()) > 0 &&
+    if (sector->RecoverableBytes(sectors_.sector_data_bytes()) > 0 &&
         (force_gc || sector->valid_bytes() == 0)) {
       gc_status = GarbageCollectSector(*sector, {});
       if (!gc_status.ok()) {
@@ -923,6 +1260,26 @@ Status KeyValueStore::FullMaintenanceHelper(MaintenanceType maintenance_type) {
     overall_status = gc_status;
   }
 
+  // Move data that rarely changes out of sectors that have fallen behind in
+  // erases, so that they share the wear.
+  for (size_t i = 0; overall_status.ok() && i < sectors_.size(); ++i) {
+    const Status wear_level_status = WearLevel();
+    if (!wear_level_status.ok()) {
+      if (!wear_level_status.IsNotFound()) {
+        WRN("Failed to wear level a sector");
+      }
+      break;
+    }
+  }
+
+  if (overall_status.ok() && options_.checkpoint_partition != nullptr) {
+    // A checkpoint is most useful right after maintenance, since Init only
+    // reads entries written after it.
+    if (!WriteCheckpoint().ok()) {
+      WRN("Failed to write KVS checkpoint");
+    }
+  }
+
   if (overall_status.ok()) {
     INF("Full maintenance complete");
   } else {
@@ -941,9 +1298,96 @@ Status KeyValueStore::PartialMaintenance() {
   if (error_detected_ && options_.recovery != ErrorRecovery::kManual) {
     PW_TRY(Repair());
   }
+  if (options_.partial_maintenance_step_bytes != 0u) {
+    return GarbageCollectStep(options_.partial_maintenance_step_bytes);
+  }
+  if (WearLevel().ok()) {
+    return OkStatus();
+  }
   return GarbageCollect(std::span<const Address>());
 }
 
+Status KeyValueStore::WearLevel() {
+  SectorDescriptor* sector = FindSectorToWearLevel();
+  if (sector == nullptr) {
+    return Status::NotFound();
+  }
+
+  // If the sector's data cannot be relocated right now, garbage collection
+  // continues as usual and the sector is tried again later.
+  return GarbageCollectSector(*sector, std::span<const Address>());
+}
+
+KeyValueStore::SectorDescriptor* KeyValueStore::FindSectorToWearLevel() const {
+  if (options_.wear_leveling_threshold == 0u) {
+    return nullptr;
+  }
+  return sectors_.FindSectorToWearLevel(options_.wear_leveling_threshold,
+                                        std::span<const Address>());
+}
+
+Status KeyValueStore::GarbageCollectStep(size_t max_relocate_bytes) {
+  if (initialized_ == InitializationState::kNotInitialized) {
+    return Status::FailedPrecondition();
+  }
+
+  if (incremental_gc_sector_ == nullptr) {
+    SectorDescriptor* sector = FindSectorToWearLevel();
+    if (sector == nullptr) {
+      sector = sectors_.FindSectorToGarbageCollect(std::span<const Address>());
+      if (sector == nullptr ||
+          sector->RecoverableBytes(sectors_.sector_data_bytes()) == 0u) {
+        return Status::NotFound();  // Nothing to GC.
+      }
+    }
+    incremental_gc_sector_ = sector;
+    DBG("Incremental garbage collect sector %u",
+        sectors_.Index(incremental_gc_sector_));
+  }
+
+  SectorDescriptor& sector = *incremental_gc_sector_;
+
+  // Once all valid entries are relocated, erasing the sector is its own step.
+  // GarbageCollectSector ends the incremental garbage collection.
+  if (sector.valid_bytes() == 0u) {
+    return GarbageCollectSector(sector, std::span<const Address>());
+  }
+
+  size_t relocated_bytes = 0;
+  for (EntryMetadata& metadata : entry_cache_) {
+    for (Address& address : metadata.addresses()) {
+      if (!sectors_.AddressInSector(sector, address)) {
+        continue;
+      }
+
+      const size_t valid_bytes = sector.valid_bytes();
+      if (Status status =
+              RelocateEntry(metadata, address, std::span<const Address>());
+          !status.ok()) {
+        // Select a sector again on the next step, since this one may not be
+        // collectable right now.
+        incremental_gc_sector_ = nullptr;
+        return status;
+      }
+
+      relocated_bytes += valid_bytes - sector.valid_bytes();
+      if (relocated_bytes >= max_relocate_bytes) {
+        return OkStatus();
+      }
+    }
+  }
+
+  if (relocated_bytes == 0u) {
+    // The sector's valid bytes do not match any entries. Let
+    // GarbageCollectSector report the error, and start over next step.
+    const Status status =
+        GarbageCollectSector(sector, std::span<const Address>());
+    incremental_gc_sector_ = nullptr;
+    return status;
+  }
+  return OkStatus();
+}
+
 Status KeyValueStore::GarbageCollect(
     std::span<const Address> reserved_addresses) {
   DBG("Garbage Collect a single sector");
@@ -1001,11 +1445,21 @@ Status KeyValueStore::GarbageCollectSector(
   }
 
   // Step 2: Reinitialize the sector
-  if (!sector_to_gc.Empty(partition_.sector_size_bytes())) {
-    sector_to_gc.mark_corrupt();
+  if (!sector_to_gc.Empty(sectors_.sector_data_bytes())) {
+    // A checkpoint cannot describe a sector once it has been erased.
+    PW_TRY(InvalidateCheckpoint());
+
+    sectors_.mark_corrupt(sector_to_gc);
     internal_stats_.sector_erase_count++;
     PW_TRY(partition_.Erase(sectors_.BaseAddress(sector_to_gc), 1));
-    sector_to_gc.set_writable_bytes(partition_.sector_size_bytes());
+    if (sectors_.tracks_erase_counts()) {
+      PW_TRY(WriteSectorHeader(sector_to_gc, sector_to_gc.erase_count() + 1));
+    }
+    sectors_.set_writable_bytes(sector_to_gc, sectors_.sector_data_bytes());
+  }
+
+  if (&sector_to_gc == incremental_gc_sector_) {
+    incremental_gc_sector_ = nullptr;
   }
 
   DBG("  Garbage Collect sector %u complete", sectors_.Index(sector_to_gc));
@@ -1122,7 +1576,7 @@ Status KeyValueStore::EnsureFreeSectorExists() {
 
   DBG("   Find empty sector");
   for (SectorDescriptor& sector : sectors_) {
-    if (sector.Empty(partition_.sector_size_bytes())) {
+    if (sector.Empty(sectors_.sector_data_bytes())) {
       empty_sector_found = true;
       DBG("   Empty sector found");
       break;
@@ -1203,6 +1657,210 @@ Status KeyValueStore::FixErrors() {
   return overall_status;
 }
 
+Status KeyValueStore::WriteCheckpoint() {
+  FlashPartition* const checkpoint = options_.checkpoint_partition;
+  if (checkpoint == nullptr || initialized_ != InitializationState::kReady ||
+      error_detected_) {
+    return Status::FailedPrecondition();
+  }
+
+  const size_t alignment = checkpoint->alignment_bytes();
+  if (alignment > kMaxFlashAlignment) {
+    ERR("Checkpoint partition alignment (=%u) is larger than the maximum "
+        "supported flash alignment (=%u)",
+        unsigned(alignment),
+        unsigned(kMaxFlashAlignment));
+    return Status::InvalidArgument();
+  }
+
+  size_t records_size = sectors_.size() * sizeof(uint32_t);
+  for (const EntryMetadata& metadata : entry_cache_) {
+    records_size += sizeof(CheckpointEntry) +
+                    metadata.addresses().size() * sizeof(Address);
+  }
+
+  const size_t records_address = CheckpointRecordsAddress(alignment);
+  const size_t checkpoint_size =
+      records_address + AlignUp(records_size, alignment);
+  if (checkpoint_size > checkpoint->size_bytes()) {
+    ERR("KVS checkpoint (%u B) does not fit in the checkpoint partition (%u B)",
+        unsigned(checkpoint_size),
+        unsigned(checkpoint->size_bytes()));
+    return Status::ResourceExhausted();
+  }
+
+  DBG("Writing %u B KVS checkpoint", unsigned(checkpoint_size));
+
+  // Erasing the checkpoint partition invalidates any previous checkpoint.
+  checkpoint_valid_ = false;
+  const size_t sector_size = checkpoint->sector_size_bytes();
+  const size_t sectors_to_erase =
+      AlignUp(checkpoint_size, sector_size) / sector_size;
+  PW_TRY(checkpoint->Erase(0, sectors_to_erase));
+
+  FlashPartition::Output records_output(*checkpoint, records_address);
+  AlignedWriterBuffer<kMaxFlashAlignment> records_writer(alignment,
+                                                         records_output);
+  checksum::Crc32 crc;
+
+  const auto write_record = [&](const void* data, size_t size) {
+    crc.Update(std::span(static_cast<const byte*>(data), size));
+    return records_writer.Write(data, size).status();
+  };
+
+  for (const SectorDescriptor& sector : sectors_) {
+    const uint32_t bytes_written =
+        partition_.sector_size_bytes() - sector.writable_bytes();
+    PW_TRY(write_record(&bytes_written, sizeof(bytes_written)));
+  }
+
+  for (const EntryMetadata& metadata : entry_cache_) {
+    const CheckpointEntry entry = {
+        .key_hash = metadata.hash(),
+        .transaction_id = metadata.transaction_id(),
+        .deleted = metadata.state() == EntryState::kDeleted,
+        .address_count = static_cast<uint16_t>(metadata.addresses().size()),
+        .namespace_tag = metadata.namespace_tag(),
+        .reserved = 0,
+    };
+    PW_TRY(write_record(&entry, sizeof(entry)));
+
+    for (const Address address : metadata.addresses()) {
+      PW_TRY(write_record(&address, sizeof(address)));
+    }
+  }
+  PW_TRY(records_writer.Flush().status());
+
+  const CheckpointHeader header = {
+      .magic = kCheckpointMagic,
+      .crc = crc.value(),
+      .sector_size_bytes = uint32_t(partition_.sector_size_bytes()),
+      .sector_count = uint32_t(sectors_.size()),
+      .entry_count = uint32_t(entry_cache_.total_entries()),
+      .redundancy = uint32_t(redundancy()),
+  };
+
+  FlashPartition::Output header_output(*checkpoint,
+                                       CheckpointHeaderAddress(alignment));
+  AlignedWriterBuffer<kMaxFlashAlignment> header_writer(alignment,
+                                                        header_output);
+  PW_TRY(header_writer.Write(&header, sizeof(header)).status());
+  PW_TRY(header_writer.Flush().status());
+
+  checkpoint_valid_ = true;
+  return OkStatus();
+}
+
+Status KeyValueStore::LoadCheckpoint() {
+  FlashPartition& checkpoint = *options_.checkpoint_partition;
+  const size_t alignment = checkpoint.alignment_bytes();
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+
+  uint32_t marker;
+  PW_TRY(checkpoint.Read(0, sizeof(marker), &marker).status());
+  if (!checkpoint.AppearsErased(std::as_bytes(std::span(&marker, 1)))) {
+    DBG("KVS checkpoint was invalidated");
+    return Status::NotFound();
+  }
+
+  CheckpointHeader header;
+  PW_TRY(checkpoint
+             .Read(CheckpointHeaderAddress(alignment), sizeof(header), &header)
+             .status());
+  if (header.magic != kCheckpointMagic) {
+    return Status::NotFound();
+  }
+
+  if (header.sector_size_bytes != sector_size_bytes ||
+      header.sector_count != partition_.sector_count() ||
+      header.redundancy != redundancy() ||
+      header.entry_count > entry_cache_.max_entries()) {
+    WRN("KVS checkpoint does not match the KVS configuration");
+    return Status::FailedPrecondition();
+  }
+
+  sectors_.Reset(SectorHeaderBytes());
+  entry_cache_.Reset();
+
+  Address address = CheckpointRecordsAddress(alignment);
+  checksum::Crc32 crc;
+
+  const auto read_record = [&](void* data, size_t size) {
+    PW_TRY(checkpoint.Read(address, size, data).status());
+    crc.Update(std::span(static_cast<const byte*>(data), size));
+    address += size;
+    return OkStatus();
+  };
+
+  for (SectorDescriptor& sector : sectors_) {
+    uint32_t bytes_written;
+    PW_TRY(read_record(&bytes_written, sizeof(bytes_written)));
+    if (bytes_written > sector_size_bytes) {
+      return Status::DataLoss();
+    }
+    sectors_.set_writable_bytes(sector, sector_size_bytes - bytes_written);
+  }
+
+  for (size_t i = 0; i < header.entry_count; ++i) {
+    CheckpointEntry entry;
+    PW_TRY(read_record(&entry, sizeof(entry)));
+    if (entry.address_count == 0u || entry.address_count > redundancy()) {
+      return Status::DataLoss();
+    }
+
+    const KeyDescriptor descriptor = {
+        .key_hash = entry.key_hash,
+        .transaction_id = entry.transaction_id,
+        .state = entry.deleted ? EntryState::kDeleted : EntryState::kValid,
+        .namespace_tag = entry.namespace_tag,
+    };
+
+    for (size_t j = 0; j < entry.address_count; ++j) {
+      Address entry_address;
+      PW_TRY(read_record(&entry_address, sizeof(entry_address)));
+      if (entry_address >= partition_.size_bytes()) {
+        return Status::DataLoss();
+      }
+      PW_TRY(entry_cache_.AddNewOrUpdateExisting(
+          descriptor, entry_address, sector_size_bytes));
+    }
+  }
+
+  if (crc.value() != header.crc) {
+    WRN("KVS checkpoint checksum mismatch");
+    return Status::DataLoss();
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::InvalidateCheckpoint() {
+  if (!checkpoint_valid_) {
+    return OkStatus();
+  }
+
+  // Overwrite the erased invalidation marker. This is faster than erasing the
+  // checkpoint, since this is done before garbage collecting a sector.
+  FlashPartition& checkpoint = *options_.checkpoint_partition;
+  std::array<byte, sizeof(uint32_t)> marker;
+  marker.fill(~checkpoint.erased_memory_content());
+
+  FlashPartition::Output output(checkpoint, 0);
+  AlignedWriterBuffer<kMaxFlashAlignment> writer(checkpoint.alignment_bytes(),
+                                                 output);
+  Status status = writer.Write(marker).status();
+  if (status.ok()) {
+    status = writer.Flush().status();
+  }
+
+  if (!status.ok()) {
+    WRN("Failed to overwrite KVS checkpoint marker; erasing checkpoint");
+    PW_TRY(checkpoint.Erase(0, 1));
+  }
+
+  checkpoint_valid_ = false;
+  return OkStatus();
+}
+
 Status KeyValueStore::Repair() {
   // If errors have been detected, just reinit the KVS metadata. This does a
   // full deep error check and any needed repairs. Then repair any errors.
@@ -1326,7 +1984,7 @@ void KeyValueStore::LogSectors() const {
     DBG("  - Sector %u: valid %u, recoverable %u, free %u",
         sectors_.Index(sector),
         unsigned(sector.valid_bytes()),
-        unsigned(sector.RecoverableBytes(partition_.sector_size_bytes())),
+        unsigned(sector.RecoverableBytes(sectors_.sector_data_bytes())),
         unsigned(sector.writable_bytes()));
   }
 }
@@ -0,0 +1,91 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures KeyValueStore Put and Get with the default CRC-16 entry checksum on
+// a RAM-backed flash. Repeated Puts fill the partition, so the Put results
+// include the amortized cost of garbage collection.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/check.h"
+#include "pw_benchmark/benchmark.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kSectorSize = 4096;
+constexpr size_t kSectors = 4;
+constexpr size_t kMaxEntries = 16;
+constexpr size_t kMaxValueSize = 256;
+
+ChecksumCrc16 checksum;
+
+// For KVS magic value always use a random 32 bit integer rather than a
+// human readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x6b2a10c3, .checksum = &checksum};
+
+FakeFlashMemoryBuffer<kSectorSize, kSectors> flash(16);
+FlashPartition partition(&flash);
+KeyValueStoreBuffer<kMaxEntries, kSectors> kvs(&partition, kFormat);
+
+std::array<std::byte, kMaxValueSize> value = {};
+
+// Starts each sample with an empty KVS holding a few unrelated keys.
+void ResetKvs() {
+  PW_CHECK_OK(partition.Erase());
+  PW_CHECK_OK(kvs.Init());
+  PW_CHECK_OK(kvs.Put("other_1", 1u));
+  PW_CHECK_OK(kvs.Put("other_2", 2u));
+}
+
+void BM_KvsPut(benchmark::State& state) {
+  const std::span<const std::byte> data =
+      std::span(value).first(size_t(state.argument()));
+  state.set_bytes_per_iteration(data.size());
+  ResetKvs();
+
+  // Puts of an unchanged value are skipped, so change the value every time.
+  uint8_t counter = 0;
+  while (state.KeepRunning()) {
+    value[0] = std::byte{++counter};
+    Status status = kvs.Put("benchmark", data);
+    benchmark::DoNotOptimize(status);
+  }
+}
+PW_BENCHMARK_WITH_ARGUMENT(BM_KvsPut, 16);
+PW_BENCHMARK_WITH_ARGUMENT(BM_KvsPut, 256);
+
+void BM_KvsGet(benchmark::State& state) {
+  const size_t size = size_t(state.argument());
+  state.set_bytes_per_iteration(size);
+  ResetKvs();
+  PW_CHECK_OK(kvs.Put("benchmark", std::span(value).first(size)));
+
+  std::array<std::byte, kMaxValueSize> buffer;
+  while (state.KeepRunning()) {
+    StatusWithSize result = kvs.Get("benchmark", buffer);
+    benchmark::DoNotOptimize(result);
+  }
+}
+PW_BENCHMARK_WITH_ARGUMENT(BM_KvsGet, 16);
+PW_BENCHMARK_WITH_ARGUMENT(BM_KvsGet, 256);
+
+}  // namespace
+}  // namespace pw::kvs
@@ -12,6 +12,7 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <algorithm>
 #include <array>
 #include <cstdio>
 #include <cstring>
@@ -409,6 +410,61 @@ TEST_F(EmptyInitializedKvs, Iteration_EmptyAfterDeletion) {
   }
 }
 
+TEST_F(EmptyInitializedKvs, Iteration_WithPrefix) {
+  for (const char* key :
+       {"net/ip", "net/mask", "network", "nets/a", "ne", "log/level"}) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(key, uint8_t(1)));
+  }
+  ASSERT_EQ(OkStatus(), kvs_.Delete("net/mask"));
+
+  const auto keys_with_prefix = [this](const char* prefix) {
+    std::array<bool, 6> found = {};
+    size_t count = 0;
+    for (const KeyValueStore::Item& item : kvs_.WithPrefix(prefix)) {
+      ++count;
+      const Key key(item.key());
+      found[0] |= key == "net/ip";
+      found[1] |= key == "net/mask";
+      found[2] |= key == "network";
+      found[3] |= key == "nets/a";
+      found[4] |= key == "ne";
+      found[5] |= key == "log/level";
+    }
+    EXPECT_EQ(count, size_t(std::count(found.begin(), found.end(), true)));
+    return found;
+  };
+
+  using Found = std::array<bool, 6>;
+  EXPECT_EQ((Found{true, false, false, false, false, false}),
+            keys_with_prefix("net/"));
+  EXPECT_EQ((Found{true, false, false, false, false, false}),
+            keys_with_prefix("net/i"));
+  EXPECT_EQ((Found{false, false, false, false, false, false}),
+            keys_with_prefix("net/ipv6"));
+  EXPECT_EQ((Found{true, false, true, true, false, false}),
+            keys_with_prefix("net"));
+  EXPECT_EQ((Found{true, false, true, true, true, false}),
+            keys_with_prefix("ne"));
+  EXPECT_EQ((Found{false, false, false, false, false, true}),
+            keys_with_prefix("log/"));
+  EXPECT_EQ((Found{true, false, true, true, true, true}), keys_with_prefix(""));
+}
+
+TEST_F(EmptyInitializedKvs, Iteration_WithPrefix_GetValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("a/key", uint32_t(1)));
+  ASSERT_EQ(OkStatus(), kvs_.Put("b/key", uint32_t(2)));
+
+  size_t count = 0;
+  for (const KeyValueStore::Item& item : kvs_.WithPrefix("b/")) {
+    EXPECT_STREQ("b/key", item.key());
+    uint32_t value = 0;
+    EXPECT_EQ(OkStatus(), item.Get(&value));
+    EXPECT_EQ(2u, value);
+    ++count;
+  }
+  EXPECT_EQ(1u, count);
+}
+
 TEST_F(EmptyInitializedKvs, Basic) {
   // Add some data
   uint8_t value1 = 0xDA;
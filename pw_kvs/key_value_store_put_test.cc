@@ -73,5 +73,31 @@ TEST_F(EmptyInitializedKvs, Put_VaryingKeysAndValues) {
       .IgnoreError();  // TODO(pwbug/387): Handle Status properly
 }
 
+TEST(FlashPartitionWithStats, RecordWriteLatency_Log2Buckets) {
+  test_partition.ResetCounters();
+
+  using std::chrono::microseconds;
+  test_partition.RecordWriteLatency(microseconds(0));
+  test_partition.RecordWriteLatency(microseconds(1));
+  test_partition.RecordWriteLatency(microseconds(2));
+  test_partition.RecordWriteLatency(microseconds(3));
+  test_partition.RecordWriteLatency(microseconds(1000));
+  test_partition.RecordWriteLatency(microseconds(int64_t{1} << 40));
+
+  auto histogram = test_partition.write_latency_histogram();
+  EXPECT_EQ(1u, histogram[0]);
+  EXPECT_EQ(1u, histogram[1]);
+  EXPECT_EQ(2u, histogram[2]);
+  EXPECT_EQ(1u, histogram[10]);  // [512, 1024) us
+  EXPECT_EQ(1u, histogram[histogram.size() - 1]);
+  EXPECT_EQ(microseconds(int64_t{1} << 40), test_partition.max_write_latency());
+
+  test_partition.ResetCounters();
+  for (uint32_t count : test_partition.write_latency_histogram()) {
+    EXPECT_EQ(0u, count);
+  }
+  EXPECT_EQ(microseconds(0), test_partition.max_write_latency());
+}
+
 }  // namespace
 }  // namespace pw::kvs
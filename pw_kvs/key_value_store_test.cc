@@ -412,6 +412,513 @@ TEST_F(LargeEmptyInitializedKvs, FullMaintenance) {
   EXPECT_EQ(stats.reclaimable_bytes, 0u);
 }
 
+TEST_F(LargeEmptyInitializedKvs, GarbageCollectStep_NothingToCollect) {
+  EXPECT_EQ(Status::NotFound(), kvs_.GarbageCollectStep(16));
+
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(0xDA)));
+  EXPECT_EQ(Status::NotFound(), kvs_.GarbageCollectStep(16));
+  EXPECT_FALSE(kvs_.garbage_collection_in_progress());
+}
+
+TEST_F(LargeEmptyInitializedKvs, GarbageCollectStep_RelocatesThenErases) {
+  // Write three keys to the same sector, then make one of them stale.
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(0xDA)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint8_t(0x12)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[2], uint8_t(0x34)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(0x56)));
+
+  KeyValueStore::StorageStats stats = kvs_.GetStorageStats();
+  const size_t reclaimable_bytes = stats.reclaimable_bytes;
+  ASSERT_GT(reclaimable_bytes, 0u);
+
+  // Each step relocates a single entry.
+  size_t relocating_steps = 0;
+  while (true) {
+    ASSERT_EQ(OkStatus(), kvs_.GarbageCollectStep(1));
+    stats = kvs_.GetStorageStats();
+    if (stats.sector_erase_count != 0u) {
+      break;
+    }
+    EXPECT_TRUE(kvs_.garbage_collection_in_progress());
+    relocating_steps += 1;
+    ASSERT_LE(relocating_steps, 4u);
+  }
+
+  EXPECT_EQ(3u, relocating_steps);
+  EXPECT_FALSE(kvs_.garbage_collection_in_progress());
+  EXPECT_EQ(1u, stats.sector_erase_count);
+  EXPECT_EQ(0u, stats.reclaimable_bytes);
+
+  uint8_t value;
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[0], &value));
+  EXPECT_EQ(0x56u, value);
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[1], &value));
+  EXPECT_EQ(0x12u, value);
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[2], &value));
+  EXPECT_EQ(0x34u, value);
+  EXPECT_EQ(3u, kvs_.size());
+}
+
+TEST_F(LargeEmptyInitializedKvs, GarbageCollectStep_LargeStepRelocatesAll) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(0xDA)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint8_t(0x12)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(0x56)));
+
+  ASSERT_EQ(OkStatus(), kvs_.GarbageCollectStep(1024));
+  EXPECT_TRUE(kvs_.garbage_collection_in_progress());
+  EXPECT_EQ(0u, kvs_.GetStorageStats().sector_erase_count);
+
+  ASSERT_EQ(OkStatus(), kvs_.GarbageCollectStep(1024));
+  EXPECT_FALSE(kvs_.garbage_collection_in_progress());
+  EXPECT_EQ(1u, kvs_.GetStorageStats().sector_erase_count);
+  EXPECT_EQ(Status::NotFound(), kvs_.GarbageCollectStep(1024));
+}
+
+TEST(InMemoryKvs, PartialMaintenance_GarbageCollectsInSteps) {
+  ASSERT_EQ(OkStatus(), large_test_partition.Erase());
+
+  Options options;
+  options.partial_maintenance_step_bytes = 1;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &large_test_partition, default_format, options);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  ASSERT_EQ(OkStatus(), kvs.Put(keys[0], uint8_t(0xDA)));
+  ASSERT_EQ(OkStatus(), kvs.Put(keys[1], uint8_t(0x12)));
+  ASSERT_EQ(OkStatus(), kvs.Put(keys[0], uint8_t(0x56)));
+
+  ASSERT_EQ(OkStatus(), kvs.PartialMaintenance());
+  EXPECT_TRUE(kvs.garbage_collection_in_progress());
+  ASSERT_EQ(OkStatus(), kvs.PartialMaintenance());
+  EXPECT_TRUE(kvs.garbage_collection_in_progress());
+  EXPECT_EQ(0u, kvs.GetStorageStats().sector_erase_count);
+
+  ASSERT_EQ(OkStatus(), kvs.PartialMaintenance());
+  EXPECT_FALSE(kvs.garbage_collection_in_progress());
+  EXPECT_EQ(1u, kvs.GetStorageStats().sector_erase_count);
+}
+
+class CheckpointTest : public ::testing::Test {
+ protected:
+  CheckpointTest()
+      : flash_(16),
+        partition_(&flash_),
+        checkpoint_flash_(16),
+        checkpoint_partition_(&checkpoint_flash_),
+        options_{.checkpoint_partition = &checkpoint_partition_},
+        kvs_(&partition_, default_format, options_) {
+    EXPECT_EQ(OkStatus(), partition_.Erase());
+    EXPECT_EQ(OkStatus(), checkpoint_partition_.Erase());
+    EXPECT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  using Kvs = KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors>;
+
+  FakeFlashMemoryBuffer<512, 4> flash_;
+  FlashPartition partition_;
+  FakeFlashMemoryBuffer<512, 2> checkpoint_flash_;
+  FlashPartition checkpoint_partition_;
+  Options options_;
+  Kvs kvs_;
+};
+
+TEST_F(CheckpointTest, WriteCheckpoint_NoPartition) {
+  Kvs kvs(&partition_, default_format);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_EQ(Status::FailedPrecondition(), kvs.WriteCheckpoint());
+}
+
+TEST_F(CheckpointTest, NoCheckpoint_InitReadsAllEntries) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(1)));
+  EXPECT_FALSE(kvs_.checkpoint_valid());
+
+  Kvs kvs(&partition_, default_format, options_);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_FALSE(kvs.checkpoint_valid());
+
+  uint8_t value;
+  ASSERT_EQ(OkStatus(), kvs.Get(keys[0], &value));
+  EXPECT_EQ(1u, value);
+}
+
+TEST_F(CheckpointTest, Init_ReplaysEntriesWrittenAfterCheckpoint) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(1)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint8_t(2)));
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint());
+  EXPECT_TRUE(kvs_.checkpoint_valid());
+
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint8_t(3)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[2], uint8_t(4)));
+  ASSERT_EQ(OkStatus(), kvs_.Delete(keys[0]));
+
+  Kvs kvs(&partition_, default_format, options_);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_TRUE(kvs.checkpoint_valid());
+
+  uint8_t value;
+  EXPECT_EQ(Status::NotFound(), kvs.Get(keys[0], &value));
+  ASSERT_EQ(OkStatus(), kvs.Get(keys[1], &value));
+  EXPECT_EQ(3u, value);
+  ASSERT_EQ(OkStatus(), kvs.Get(keys[2], &value));
+  EXPECT_EQ(4u, value);
+  EXPECT_EQ(2u, kvs.size());
+
+  const KeyValueStore::StorageStats expected = kvs_.GetStorageStats();
+  const KeyValueStore::StorageStats actual = kvs.GetStorageStats();
+  EXPECT_EQ(expected.writable_bytes, actual.writable_bytes);
+  EXPECT_EQ(expected.in_use_bytes, actual.in_use_bytes);
+  EXPECT_EQ(expected.reclaimable_bytes, actual.reclaimable_bytes);
+
+  // New entries continue from the restored transaction ID.
+  ASSERT_EQ(OkStatus(), kvs.Put(keys[1], uint8_t(5)));
+  Kvs reloaded(&partition_, default_format, options_);
+  ASSERT_EQ(OkStatus(), reloaded.Init());
+  ASSERT_EQ(OkStatus(), reloaded.Get(keys[1], &value));
+  EXPECT_EQ(5u, value);
+}
+
+TEST_F(CheckpointTest, Init_RestoresNamespaceTags) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("a/1", uint8_t(1)));
+  ASSERT_EQ(OkStatus(), kvs_.Put("b/1", uint8_t(2)));
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint());
+
+  Kvs kvs(&partition_, default_format, options_);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  ASSERT_TRUE(kvs.checkpoint_valid());
+
+  size_t count = 0;
+  for (const KeyValueStore::Item& item : kvs.WithPrefix("b/")) {
+    EXPECT_STREQ("b/1", item.key());
+    ++count;
+  }
+  EXPECT_EQ(1u, count);
+}
+
+TEST_F(CheckpointTest, SectorErase_InvalidatesCheckpoint) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(1)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(2)));
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint());
+
+  while (kvs_.GetStorageStats().sector_erase_count == 0u) {
+    ASSERT_EQ(OkStatus(), kvs_.GarbageCollectStep(1));
+  }
+  EXPECT_FALSE(kvs_.checkpoint_valid());
+
+  Kvs kvs(&partition_, default_format, options_);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_FALSE(kvs.checkpoint_valid());
+
+  uint8_t value;
+  ASSERT_EQ(OkStatus(), kvs.Get(keys[0], &value));
+  EXPECT_EQ(2u, value);
+}
+
+TEST_F(CheckpointTest, StaleCheckpoint_FallsBackToFullScan) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(1)));
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint());
+
+  // Erase the KVS without going through it, so the checkpoint is stale.
+  ASSERT_EQ(OkStatus(), partition_.Erase());
+
+  Kvs kvs(&partition_, default_format, options_);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_FALSE(kvs.checkpoint_valid());
+  EXPECT_EQ(0u, kvs.size());
+
+  // The stale checkpoint was invalidated, so it is not loaded again.
+  Kvs reloaded(&partition_, default_format, options_);
+  ASSERT_EQ(OkStatus(), reloaded.Init());
+  EXPECT_FALSE(reloaded.checkpoint_valid());
+}
+
+TEST_F(CheckpointTest, FullMaintenance_WritesCheckpoint) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(1)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(2)));
+  ASSERT_EQ(OkStatus(), kvs_.HeavyMaintenance());
+  EXPECT_TRUE(kvs_.checkpoint_valid());
+
+  Kvs kvs(&partition_, default_format, options_);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_TRUE(kvs.checkpoint_valid());
+
+  uint8_t value;
+  ASSERT_EQ(OkStatus(), kvs.Get(keys[0], &value));
+  EXPECT_EQ(2u, value);
+}
+
+class PutBatchTest : public ::testing::Test {
+ protected:
+  PutBatchTest() : flash_(16), partition_(&flash_), kvs_(&partition_, format) {
+    EXPECT_EQ(OkStatus(), partition_.Erase());
+    EXPECT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  static constexpr EntryFormat format{.magic = 0x1ba7c4e5,
+                                      .checksum = &checksum};
+
+  FakeFlashMemoryBuffer<512, 4> flash_;
+  FlashPartition partition_;
+  KeyValueStoreBuffer<3, 4> kvs_;
+};
+
+TEST_F(PutBatchTest, Empty) {
+  EXPECT_EQ(OkStatus(), kvs_.PutBatch({}));
+  EXPECT_EQ(0u, kvs_.size());
+}
+
+TEST_F(PutBatchTest, WritesAllItems) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint32_t(1)));
+
+  constexpr uint32_t kValues[] = {10, 20, 30};
+  const KeyValueStore::BatchItem items[] = {
+      {keys[0], std::as_bytes(std::span(&kValues[0], 1))},
+      {keys[1], std::as_bytes(std::span(&kValues[1], 1))},
+      {keys[2], std::as_bytes(std::span(&kValues[2], 1))},
+  };
+  ASSERT_EQ(OkStatus(), kvs_.PutBatch(items));
+  EXPECT_EQ(3u, kvs_.size());
+
+  KeyValueStoreBuffer<3, 4> kvs(&partition_, format);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    uint32_t value = 0;
+    ASSERT_EQ(OkStatus(), kvs.Get(keys[i], &value));
+    EXPECT_EQ(kValues[i], value);
+  }
+}
+
+TEST_F(PutBatchTest, DuplicateKey_NothingWritten) {
+  constexpr uint32_t kValue = 1;
+  const KeyValueStore::BatchItem items[] = {
+      {keys[0], std::as_bytes(std::span(&kValue, 1))},
+      {keys[0], std::as_bytes(std::span(&kValue, 1))},
+  };
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.PutBatch(items));
+  EXPECT_EQ(0u, kvs_.size());
+  EXPECT_EQ(0u, kvs_.GetStorageStats().in_use_bytes);
+}
+
+TEST_F(PutBatchTest, LargerThanSector_NothingWritten) {
+  std::array<std::byte, 200> value{};
+  const KeyValueStore::BatchItem items[] = {
+      {keys[0], value},
+      {keys[1], value},
+      {keys[2], value},
+  };
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.PutBatch(items));
+  EXPECT_EQ(0u, kvs_.size());
+  EXPECT_EQ(0u, kvs_.GetStorageStats().in_use_bytes);
+}
+
+TEST_F(PutBatchTest, TooManyNewKeys_NothingWritten) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(1)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint32_t(2)));
+  const size_t in_use_bytes = kvs_.GetStorageStats().in_use_bytes;
+
+  constexpr uint32_t kValue = 3;
+  const KeyValueStore::BatchItem items[] = {
+      {keys[2], std::as_bytes(std::span(&kValue, 1))},
+      {"NewKey", std::as_bytes(std::span(&kValue, 1))},
+  };
+  EXPECT_EQ(Status::ResourceExhausted(), kvs_.PutBatch(items));
+  EXPECT_EQ(2u, kvs_.size());
+  EXPECT_EQ(in_use_bytes, kvs_.GetStorageStats().in_use_bytes);
+}
+
+TEST_F(PutBatchTest, UnchangedValue_Skipped) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(1)));
+  const size_t in_use_bytes = kvs_.GetStorageStats().in_use_bytes;
+
+  constexpr uint32_t kSame = 1;
+  constexpr uint32_t kNew = 2;
+  const KeyValueStore::BatchItem items[] = {
+      {keys[0], std::as_bytes(std::span(&kSame, 1))},
+      {keys[1], std::as_bytes(std::span(&kNew, 1))},
+  };
+  ASSERT_EQ(OkStatus(), kvs_.PutBatch(items));
+  EXPECT_EQ(2 * in_use_bytes, kvs_.GetStorageStats().in_use_bytes);
+  EXPECT_EQ(0u, kvs_.GetStorageStats().reclaimable_bytes);
+}
+
+TEST(InMemoryKvs, PutBatch_Redundancy) {
+  FakeFlashMemoryBuffer<512, 4> flash(16);
+  FlashPartition partition(&flash);
+  ASSERT_EQ(OkStatus(), partition.Erase());
+
+  KeyValueStoreBuffer<4, 4, 2> kvs(&partition, default_format);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  constexpr uint32_t kValues[] = {10, 20};
+  const KeyValueStore::BatchItem items[] = {
+      {keys[0], std::as_bytes(std::span(&kValues[0], 1))},
+      {keys[1], std::as_bytes(std::span(&kValues[1], 1))},
+  };
+  ASSERT_EQ(OkStatus(), kvs.PutBatch(items));
+
+  // Both copies of each entry are found when the KVS is reinitialized.
+  KeyValueStoreBuffer<4, 4, 2> reinit(&partition, default_format);
+  ASSERT_EQ(OkStatus(), reinit.Init());
+  EXPECT_FALSE(reinit.error_detected());
+  EXPECT_EQ(2u, reinit.size());
+  EXPECT_EQ(kvs.GetStorageStats().in_use_bytes,
+            reinit.GetStorageStats().in_use_bytes);
+  for (size_t i = 0; i < 2; ++i) {
+    uint32_t value = 0;
+    ASSERT_EQ(OkStatus(), reinit.Get(keys[i], &value));
+    EXPECT_EQ(kValues[i], value);
+  }
+}
+
+TEST(InMemoryKvs, HashIndex_PutGetDeleteAndReinit) {
+  constexpr size_t kKeys = 64;
+  constexpr size_t kIndexSlots = 128;
+
+  ASSERT_EQ(OkStatus(), large_test_partition.Erase());
+
+  KeyValueStoreBuffer<kKeys, kMaxUsableSectors, 1, 1, kIndexSlots> kvs(
+      &large_test_partition, default_format);
+  ASSERT_OK(kvs.Init());
+
+  std::array<char, 16> key;
+  for (uint32_t i = 0; i < kKeys; ++i) {
+    std::snprintf(key.data(), key.size(), "key_%03u", unsigned(i));
+    ASSERT_OK(kvs.Put(key.data(), i));
+  }
+  EXPECT_EQ(kKeys, kvs.size());
+
+  // Overwrite every other key and delete every fourth key.
+  for (uint32_t i = 0; i < kKeys; i += 2) {
+    std::snprintf(key.data(), key.size(), "key_%03u", unsigned(i));
+    ASSERT_OK(kvs.Put(key.data(), i + 1000));
+  }
+  for (uint32_t i = 0; i < kKeys; i += 4) {
+    std::snprintf(key.data(), key.size(), "key_%03u", unsigned(i));
+    ASSERT_OK(kvs.Delete(key.data()));
+  }
+
+  // The index is rebuilt from flash when the KVS is initialized again.
+  for (int pass = 0; pass < 2; ++pass) {
+    uint32_t value;
+    for (uint32_t i = 0; i < kKeys; ++i) {
+      std::snprintf(key.data(), key.size(), "key_%03u", unsigned(i));
+      if (i % 4 == 0) {
+        EXPECT_EQ(Status::NotFound(), kvs.Get(key.data(), &value));
+      } else {
+        ASSERT_OK(kvs.Get(key.data(), &value));
+        EXPECT_EQ(i % 2 == 0 ? i + 1000 : i, value);
+      }
+    }
+    EXPECT_EQ(Status::NotFound(), kvs.Get("not a key", &value));
+    EXPECT_EQ(kKeys - kKeys / 4, kvs.size());
+
+    ASSERT_OK(kvs.Init());
+  }
+}
+
+TEST(InMemoryKvs, SectorIndex_SelectsSameSectorsAsScan) {
+  constexpr size_t kKeys = 16;
+
+  static FakeFlashMemoryBuffer<1024, 60> flash(8);
+  FlashPartition partition(&flash, 0, flash.sector_count());
+  ASSERT_EQ(OkStatus(), partition.Erase());
+  ASSERT_EQ(OkStatus(), large_test_partition.Erase());
+
+  KeyValueStoreBuffer<kKeys, kMaxUsableSectors> kvs(&partition,
+                                                    default_format);
+  KeyValueStoreBuffer<kKeys, kMaxUsableSectors, 1, 1, 0, true> indexed_kvs(
+      &large_test_partition, default_format);
+  ASSERT_OK(kvs.Init());
+  ASSERT_OK(indexed_kvs.Init());
+
+  // Write enough data to garbage collect every sector several times.
+  std::array<char, 16> key;
+  std::array<std::byte, 200> value;
+  for (uint32_t i = 0; i < 2000; ++i) {
+    std::snprintf(key.data(), key.size(), "key_%02u", unsigned(i % kKeys));
+    std::memset(value.data(), int(i), value.size());
+    const size_t size = 1 + (i * 37) % value.size();
+    ASSERT_OK(kvs.Put(key.data(), std::span(value).first(size)));
+    ASSERT_OK(indexed_kvs.Put(key.data(), std::span(value).first(size)));
+  }
+
+  const KeyValueStore::StorageStats stats = kvs.GetStorageStats();
+  const KeyValueStore::StorageStats indexed_stats =
+      indexed_kvs.GetStorageStats();
+  EXPECT_EQ(stats.in_use_bytes, indexed_stats.in_use_bytes);
+  EXPECT_EQ(stats.reclaimable_bytes, indexed_stats.reclaimable_bytes);
+  EXPECT_EQ(stats.writable_bytes, indexed_stats.writable_bytes);
+  EXPECT_GT(indexed_stats.sector_erase_count, 60u);
+  EXPECT_EQ(stats.sector_erase_count, indexed_stats.sector_erase_count);
+
+  // The index is rebuilt when the KVS is initialized again.
+  ASSERT_OK(indexed_kvs.Init());
+  for (uint32_t i = 2000 - kKeys; i < 2000; ++i) {
+    std::snprintf(key.data(), key.size(), "key_%02u", unsigned(i % kKeys));
+    std::array<std::byte, 200> read;
+    const StatusWithSize result = indexed_kvs.Get(key.data(), read);
+    ASSERT_OK(result.status());
+    EXPECT_EQ(1 + (i * 37) % value.size(), result.size());
+    EXPECT_EQ(std::byte(i), read[0]);
+  }
+  ASSERT_OK(indexed_kvs.Put("key_00", std::span(value).first(10)));
+}
+
+// Counts reads, to check which entries the KVS reads from flash.
+class ReadCountingPartition : public FlashPartition {
+ public:
+  using FlashPartition::FlashPartition;
+
+  StatusWithSize Read(Address address, std::span<std::byte> output) override {
+    ++reads_;
+    return FlashPartition::Read(address, output);
+  }
+
+  size_t reads() const { return reads_; }
+  void ResetReads() { reads_ = 0; }
+
+ private:
+  size_t reads_ = 0;
+};
+
+TEST(InMemoryKvs, WithPrefix_SkipsOtherNamespacesWithoutReadingKeys) {
+  FakeFlashMemoryBuffer<1024, 8> flash(16);
+  ReadCountingPartition partition(&flash, 0, flash.sector_count());
+  ASSERT_OK(partition.Erase());
+  KeyValueStoreBuffer<64, kMaxUsableSectors> kvs(&partition, default_format);
+  ASSERT_OK(kvs.Init());
+
+  std::array<char, 16> key;
+  for (unsigned i = 0; i < 40; ++i) {
+    std::snprintf(key.data(), key.size(), "app/%02u", i);
+    ASSERT_OK(kvs.Put(key.data(), uint8_t(i)));
+  }
+  for (unsigned i = 0; i < 4; ++i) {
+    std::snprintf(key.data(), key.size(), "net/%02u", i);
+    ASSERT_OK(kvs.Put(key.data(), uint8_t(i)));
+  }
+
+  partition.ResetReads();
+  size_t count = 0;
+  for (const KeyValueStore::Item& item : kvs.WithPrefix("net/")) {
+    EXPECT_EQ(0, std::strncmp("net/", item.key(), 4));
+    ++count;
+  }
+  EXPECT_EQ(4u, count);
+  const size_t namespace_reads = partition.reads();
+
+  partition.ResetReads();
+  count = 0;
+  for (const KeyValueStore::Item& item : kvs.WithPrefix("ne")) {
+    static_cast<void>(item);
+    ++count;
+  }
+  EXPECT_EQ(4u, count);
+
+  // Without a namespace, every key is read to compare it to the prefix.
+  EXPECT_GE(partition.reads(), 44u);
+  EXPECT_LT(namespace_reads, 44u);
+}
+
 TEST(InMemoryKvs, Put_MaxValueSize) {
   // Create and erase the fake flash.
   Flash flash;
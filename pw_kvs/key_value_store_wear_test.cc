@@ -114,5 +114,92 @@ TEST_F(WearTest, TwoPassFillWithLargeAndLarger) {
             2u * partition_.average_erase_count());
 }
 
+Options EraseCountOptions() {
+  Options options;
+  options.track_erase_counts = true;
+  options.wear_leveling_threshold = 4;
+  return options;
+}
+
+class EraseCountTest : public ::testing::Test {
+ protected:
+  EraseCountTest()
+      : flash_(internal::Entry::kMinAlignmentBytes),
+        partition_(&flash_, 0, flash_.sector_count()),
+        kvs_(&partition_, format, EraseCountOptions()) {
+    EXPECT_EQ(OkStatus(), kvs_.Init());
+    partition_.ResetCounters();
+  }
+
+  // Writes values that are never updated to about half of the sectors, then
+  // repeatedly updates a single entry that takes most of a sector.
+  void WriteColdAndHotData(size_t hot_updates) {
+    for (size_t i = 0; i < kColdKeys; ++i) {
+      const char key[] = {'c', char('a' + i), '\0'};
+      ASSERT_EQ(OkStatus(),
+                kvs_.Put(key, std::as_bytes(std::span(test_data, 400))));
+    }
+
+    for (size_t i = 0; i < hot_updates; ++i) {
+      test_data[0]++;
+      ASSERT_EQ(OkStatus(), kvs_.Put("hot", test_data));
+      kvs_.PartialMaintenance().IgnoreError();
+    }
+  }
+
+  static constexpr size_t kSectors = 16;
+  static constexpr size_t kMaxEntries = 256;
+  static constexpr size_t kTestPartitionSectorSize = 512;
+  static constexpr size_t kColdKeys = kSectors / 2;
+
+  FakeFlashMemoryBuffer<kTestPartitionSectorSize, kSectors> flash_;
+  FlashPartitionWithStatsBuffer<kSectors> partition_;
+
+  KeyValueStoreBuffer<kMaxEntries, kSectors> kvs_;
+};
+
+TEST_F(EraseCountTest, TracksPartitionEraseCounts) {
+  WriteColdAndHotData(kSectors * 10);
+
+  const KeyValueStore::StorageStats stats = kvs_.GetStorageStats();
+  EXPECT_EQ(partition_.min_erase_count(), stats.min_sector_erase_count);
+  EXPECT_EQ(partition_.max_erase_count(), stats.max_sector_erase_count);
+}
+
+TEST_F(EraseCountTest, ColdDataIsMovedToSpreadWear) {
+  WriteColdAndHotData(kSectors * 20);
+
+  // Without wear leveling, the sectors holding the cold values would never be
+  // erased.
+  EXPECT_GE(partition_.min_erase_count(), 5u);
+  EXPECT_LE(partition_.max_erase_count(), partition_.min_erase_count() + 6u);
+
+  for (size_t i = 0; i < kColdKeys; ++i) {
+    const char key[] = {'c', char('a' + i), '\0'};
+    EXPECT_EQ(OkStatus(),
+              kvs_.Get(key, std::as_writable_bytes(std::span(test_data)))
+                  .status());
+  }
+
+  partition_.SaveStorageStats(kvs_, "EraseCountTest ColdDataIsMoved")
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+}
+
+TEST_F(EraseCountTest, EraseCountsPersistAcrossInit) {
+  WriteColdAndHotData(kSectors * 5);
+  const KeyValueStore::StorageStats before = kvs_.GetStorageStats();
+  ASSERT_GT(before.max_sector_erase_count, 0u);
+
+  KeyValueStoreBuffer<kMaxEntries, kSectors> kvs(
+      &partition_, format, EraseCountOptions());
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  const KeyValueStore::StorageStats after = kvs.GetStorageStats();
+
+  EXPECT_EQ(before.min_sector_erase_count, after.min_sector_erase_count);
+  EXPECT_EQ(before.max_sector_erase_count, after.max_sector_erase_count);
+  EXPECT_EQ(0u, after.corrupt_sectors_recovered);
+  EXPECT_EQ(kvs_.size(), kvs.size());
+}
+
 }  // namespace
 }  // namespace pw::kvs
@@ -0,0 +1,144 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_kvs/flash_memory.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::kvs {
+
+// A FlashPartition that caches reads in fixed-size lines of RAM. Lines are
+// aligned to line-size boundaries within the partition, and the line size
+// must evenly divide the sector size, so lines never span sectors. When all
+// lines are in use, the least recently used line is replaced.
+//
+// Writes go straight to flash and invalidate any lines they overlap, so data
+// read after a write, such as the KVS's verify-on-write check, comes from
+// flash. Erases invalidate the lines in the erased sectors. Asynchronous writes
+// and erases invalidate lines when they are started; this is sufficient since
+// reads wait for in-progress asynchronous operations.
+//
+// Reads larger than the entire cache bypass it, so that reading a large value
+// does not evict every cached line.
+class CachingFlashPartition : public FlashPartition {
+ public:
+  struct CacheLine {
+    Address address;
+    uint32_t last_used;
+    bool valid;
+  };
+
+  using FlashPartition::Erase;
+  using FlashPartition::Read;
+
+  StatusWithSize Read(Address address, std::span<std::byte> output) override;
+
+  StatusWithSize Write(Address address,
+                       std::span<const std::byte> data) override;
+
+  Status Erase(Address address, size_t num_sectors) override;
+
+  Status StartErase(Address address,
+                    size_t num_sectors,
+                    FlashMemory::Callback&& on_complete) override;
+
+  Status StartWrite(Address address,
+                    std::span<const std::byte> data,
+                    FlashMemory::Callback&& on_complete) override;
+
+  // Discards all cached data. Call this if the flash is modified other than
+  // through this partition.
+  void InvalidateCache();
+
+  size_t line_size_bytes() const { return line_size_bytes_; }
+
+  size_t line_count() const { return lines_.size(); }
+
+  // Number of line lookups that were served from the cache.
+  uint32_t cache_hits() const { return cache_hits_; }
+
+  // Number of line lookups that read from flash, including reads that bypass
+  // the cache.
+  uint32_t cache_misses() const { return cache_misses_; }
+
+  void ResetCacheCounters() {
+    cache_hits_ = 0;
+    cache_misses_ = 0;
+  }
+
+ protected:
+  CachingFlashPartition(
+      std::span<CacheLine> lines,
+      std::span<std::byte> line_data,
+      FlashMemory* flash,
+      uint32_t start_sector_index,
+      uint32_t sector_count,
+      uint32_t alignment_bytes = 0,  // Defaults to flash alignment
+      PartitionPermission permission = PartitionPermission::kReadAndWrite);
+
+ private:
+  // Returns the line caching the given line-aligned address, loading it from
+  // flash if needed.
+  StatusWithSize GetLine(Address line_address, CacheLine** line);
+
+  std::byte* LineData(const CacheLine& line) {
+    return &line_data_[size_t(&line - lines_.data()) * line_size_bytes_];
+  }
+
+  void InvalidateRange(Address address, size_t size);
+
+  const std::span<CacheLine> lines_;
+  const std::span<std::byte> line_data_;
+  const size_t line_size_bytes_;
+
+  uint32_t use_counter_;
+  uint32_t cache_hits_;
+  uint32_t cache_misses_;
+};
+
+template <size_t kLineSizeBytes, size_t kLineCount>
+class CachingFlashPartitionBuffer : public CachingFlashPartition {
+ public:
+  static_assert(kLineSizeBytes > 0u && kLineCount > 0u);
+
+  CachingFlashPartitionBuffer(
+      FlashMemory* flash,
+      uint32_t start_sector_index,
+      uint32_t sector_count,
+      uint32_t alignment_bytes = 0,  // Defaults to flash alignment
+      PartitionPermission permission = PartitionPermission::kReadAndWrite)
+      : CachingFlashPartition(lines_,
+                              line_data_,
+                              flash,
+                              start_sector_index,
+                              sector_count,
+                              alignment_bytes,
+                              permission) {}
+
+  CachingFlashPartitionBuffer(FlashMemory* flash)
+      : CachingFlashPartitionBuffer(
+            flash, 0, flash->sector_count(), flash->alignment_bytes()) {}
+
+ private:
+  std::array<CacheLine, kLineCount> lines_;
+  std::array<std::byte, kLineSizeBytes * kLineCount> line_data_;
+};
+
+}  // namespace pw::kvs
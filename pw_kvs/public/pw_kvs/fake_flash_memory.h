@@ -115,8 +115,26 @@ class FakeFlashMemory : public FlashMemory {
 
   std::byte* FlashAddressToMcuAddress(Address) const override;
 
+  // Asynchronous operations are held until CompletePendingOperation() is
+  // called or another operation completes them.
+  Status StartErase(Address address,
+                    size_t num_sectors,
+                    Callback&& on_complete) override;
+
+  Status StartWrite(Address address,
+                    std::span<const std::byte> data,
+                    Callback&& on_complete) override;
+
   // Testing API
 
+  // Performs the in-progress asynchronous operation, if any, and calls its
+  // callback. Returns false if no operation was in progress.
+  bool CompletePendingOperation();
+
+  bool operation_pending() const {
+    return pending_.type != PendingOperation::kNone;
+  }
+
   // Access the underlying buffer for testing purposes. Not part of the
   // FlashMemory API.
   std::span<std::byte> buffer() const { return buffer_; }
@@ -138,11 +156,26 @@ class FakeFlashMemory : public FlashMemory {
   }
 
  private:
+  struct PendingOperation {
+    enum Type { kNone, kErase, kWrite } type = kNone;
+    Address address = 0;
+    size_t num_sectors = 0;
+    std::span<const std::byte> data;
+    Callback on_complete;
+  };
+
+  Status CheckErase(Address address, size_t num_sectors) const;
+  Status CheckWrite(Address address, size_t size) const;
+
+  Status EraseNow(Address address, size_t num_sectors);
+  StatusWithSize WriteNow(Address address, std::span<const std::byte> data);
+
   static inline Vector<FlashError, 0> no_errors_;
 
   const std::span<std::byte> buffer_;
   Vector<FlashError>& read_errors_;
   Vector<FlashError>& write_errors_;
+  PendingOperation pending_;
 };
 
 // Creates an FakeFlashMemory backed by a std::array. The array is initialized
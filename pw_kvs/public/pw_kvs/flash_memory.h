@@ -19,6 +19,7 @@
 #include <span>
 
 #include "pw_assert/assert.h"
+#include "pw_function/function.h"
 #include "pw_kvs/alignment.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
@@ -36,6 +37,12 @@ class FlashMemory {
   // The flash address is in the range of: 0 to FlashSize.
   typedef uint32_t Address;
 
+  // Called once when an asynchronous operation completes, with the status the
+  // equivalent blocking call would have returned. May be called from an
+  // interrupt or driver thread, so it should only record the result or signal
+  // a waiting thread.
+  using Callback = Function<void(Status)>;
+
   // TODO(pwbug/246): This can be constexpr when tokenized asserts are fixed.
   FlashMemory(size_t sector_size,
               size_t sector_count,
@@ -104,6 +111,34 @@ class FlashMemory {
   // mapped reads. Return NULL if the memory is not memory mapped.
   virtual std::byte* FlashAddressToMcuAddress(Address) const { return nullptr; }
 
+  // Optional asynchronous operations, for flash parts whose erases or writes
+  // take long enough that blocking on them is a problem. At most one
+  // asynchronous operation is in progress at a time. The blocking Erase, Read
+  // and Write calls wait for an in-progress asynchronous operation to complete
+  // before starting.
+  //
+  // Starts erasing num_sectors starting at a given address and returns without
+  // waiting for the erase to complete. Returns:
+  //
+  // OK - the erase was started; on_complete is called with its result
+  // UNAVAILABLE - an asynchronous operation is already in progress
+  // UNIMPLEMENTED - this flash does not support asynchronous operations
+  // INVALID_ARGUMENT - address is not sector-aligned
+  // OUT_OF_RANGE - erases past the end of the memory
+  //
+  // on_complete is not called unless OK is returned.
+  virtual Status StartErase(Address, size_t, Callback&&) {
+    return Status::Unimplemented();
+  }
+
+  // Starts writing bytes to flash and returns without waiting for the write to
+  // complete. The data must remain valid until on_complete is called. Returns
+  // the same errors as StartErase; INVALID_ARGUMENT indicates that the address
+  // or data size are not aligned.
+  virtual Status StartWrite(Address, std::span<const std::byte>, Callback&&) {
+    return Status::Unimplemented();
+  }
+
   // start_sector() is useful for FlashMemory instances where the
   // sector start is not 0. (ex.: cases where there are portions of flash
   // that should be handled independently).
@@ -126,6 +161,10 @@ class FlashMemory {
     return erased_memory_content_;
   }
 
+  // Checks whether the data is entirely erased_memory_content(). Compares a
+  // word at a time, so it is cheap enough to use on large buffers.
+  bool AppearsErased(std::span<const std::byte> data) const;
+
  private:
   const uint32_t sector_size_;
   const uint32_t flash_sector_count_;
@@ -223,6 +262,21 @@ class FlashPartition {
   virtual StatusWithSize Write(Address address,
                                std::span<const std::byte> data);
 
+  // Starts an erase without blocking, if the underlying FlashMemory supports
+  // asynchronous operations. See FlashMemory::StartErase. Returns the same
+  // errors as Erase, plus UNAVAILABLE if an asynchronous operation is already
+  // in progress and UNIMPLEMENTED if the flash does not support asynchronous
+  // operations.
+  virtual Status StartErase(Address address,
+                            size_t num_sectors,
+                            FlashMemory::Callback&& on_complete);
+
+  // Starts a write without blocking. The data must remain valid until
+  // on_complete is called. Returns the same errors as StartErase.
+  virtual Status StartWrite(Address address,
+                            std::span<const std::byte> data,
+                            FlashMemory::Callback&& on_complete);
+
   // Check to see if chunk of flash partition is erased. Address and len need to
   // be aligned with FlashMemory. Returns:
   //
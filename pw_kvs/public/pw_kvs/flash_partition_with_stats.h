@@ -14,6 +14,9 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <numeric>
 
 #include "pw_containers/vector.h"
@@ -38,6 +41,10 @@ class FlashPartitionWithStats : public FlashPartition {
 
   Status Erase(Address address, size_t num_sectors) override;
 
+  Status StartErase(Address address,
+                    size_t num_sectors,
+                    FlashMemory::Callback&& on_complete) override;
+
   std::span<size_t> sector_erase_counters() {
     return std::span(sector_counters_.data(), sector_counters_.size());
   }
@@ -67,7 +74,31 @@ class FlashPartitionWithStats : public FlashPartition {
         sector_counters_.begin(), sector_counters_.end(), 0ul);
   }
 
-  void ResetCounters() { sector_counters_.assign(sector_count(), 0); }
+  void ResetCounters() {
+    sector_counters_.assign(sector_count(), 0);
+    write_latency_histogram_.fill(0);
+    max_write_latency_ = std::chrono::microseconds(0);
+  }
+
+  // Number of buckets in the write latency histogram. Bucket 0 counts
+  // latencies under 1 us and bucket i counts latencies from 2^(i-1) us up to
+  // 2^i us. The last bucket also counts all longer latencies.
+  static constexpr size_t kWriteLatencyBuckets = 24;
+
+  // Records the duration of a KVS write operation, such as a Put, Delete, or
+  // maintenance step, in the write latency histogram. The caller measures the
+  // duration with a clock of its choice. Comparing histograms shows how much
+  // time is spent in garbage collection during writes.
+  void RecordWriteLatency(std::chrono::microseconds latency);
+
+  std::span<const uint32_t, kWriteLatencyBuckets> write_latency_histogram()
+      const {
+    return write_latency_histogram_;
+  }
+
+  std::chrono::microseconds max_write_latency() const {
+    return max_write_latency_;
+  }
 
  protected:
   FlashPartitionWithStats(
@@ -82,12 +113,18 @@ class FlashPartitionWithStats : public FlashPartition {
                        sector_count,
                        alignment_bytes,
                        permission),
-        sector_counters_(sector_counters) {
+        sector_counters_(sector_counters),
+        write_latency_histogram_{},
+        max_write_latency_(0) {
     sector_counters_.assign(FlashPartition::sector_count(), 0);
   }
 
  private:
+  void CountErases(Address address, size_t num_sectors);
+
   Vector<size_t>& sector_counters_;
+  std::array<uint32_t, kWriteLatencyBuckets> write_latency_histogram_;
+  std::chrono::microseconds max_write_latency_;
 };
 
 template <size_t kMaxSectors>
@@ -89,16 +89,26 @@ class Entry {
 
   Entry() = default;
 
-  KeyDescriptor descriptor(Key key) const { return descriptor(Hash(key)); }
+  KeyDescriptor descriptor(Key key) const {
+    return descriptor(Hash(key), NamespaceTag(key));
+  }
 
-  KeyDescriptor descriptor(uint32_t key_hash) const {
+  KeyDescriptor descriptor(uint32_t key_hash, uint16_t namespace_tag) const {
     return KeyDescriptor{key_hash,
                          transaction_id(),
-                         deleted() ? EntryState::kDeleted : EntryState::kValid};
+                         deleted() ? EntryState::kDeleted : EntryState::kValid,
+                         namespace_tag};
   }
 
   StatusWithSize Write(Key key, std::span<const std::byte> value) const;
 
+  // Writes this entry, including its padding, to an AlignedWriter. This allows
+  // several consecutive entries to be combined into fewer flash writes. The
+  // entry must be at the AlignedWriter's current output address.
+  StatusWithSize Write(AlignedWriter& writer,
+                       Key key,
+                       std::span<const std::byte> value) const;
+
   // Changes the format and transcation ID for this entry. In order to calculate
   // the new checksum, the entire entry is read into a small stack-allocated
   // buffer. The updated entry may be written to flash using the Copy function.
@@ -128,6 +138,14 @@ class Entry {
 
   Status VerifyChecksumInFlash() const;
 
+  // Reads the value into the buffer and verifies the entry's checksum in a
+  // single pass over the value, so the value is only read from flash once.
+  // Returns DATA_LOSS if verification fails, in which case the buffer contents
+  // are unspecified. If the buffer is too small for the value, this behaves
+  // like ReadValue and the checksum is not verified.
+  StatusWithSize ReadValueAndVerifyChecksum(Key key,
+                                            std::span<std::byte> buffer) const;
+
   // Calculates the total size of an entry, including padding.
   static size_t size(const FlashPartition& partition,
                      Key key,
@@ -206,6 +224,9 @@ class Entry {
   std::span<const std::byte> CalculateChecksum(
       Key key, std::span<const std::byte> value) const;
 
+  // Resets the checksum and adds the header, with a 0 checksum field, and key.
+  void StartChecksum(Key key) const;
+
   Status CalculateChecksumFromFlash();
 
   // Update the checksum with 0s to pad the entry to its alignment boundary.
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <span>
@@ -37,11 +38,13 @@ class EntryMetadata {
 
   EntryMetadata() = default;
 
-  uint32_t hash() const { return descriptor_->key_hash; }
+  uint32_t hash() const { return *key_hash_; }
 
-  uint32_t transaction_id() const { return descriptor_->transaction_id; }
+  uint32_t transaction_id() const { return details_->transaction_id; }
 
-  EntryState state() const { return descriptor_->state; }
+  EntryState state() const { return details_->state; }
+
+  uint16_t namespace_tag() const { return details_->namespace_tag; }
 
   // The first known address of this entry.
   uint32_t first_address() const { return addresses_[0]; }
@@ -66,22 +69,32 @@ class EntryMetadata {
   void RemoveAddress(Address address_to_remove);
 
   // Resets the KeyDescrtiptor and addresses to refer to the provided
-  // KeyDescriptor and address.
+  // KeyDescriptor and address. If the EntryCache has a hash index, the key hash
+  // MUST NOT change.
   void Reset(const KeyDescriptor& descriptor, Address address);
 
  private:
   friend class EntryCache;
 
-  constexpr EntryMetadata(KeyDescriptor& descriptor,
+  constexpr EntryMetadata(uint32_t* key_hash,
+                          KeyDetails* details,
                           std::span<Address> addresses)
-      : descriptor_(&descriptor), addresses_(addresses) {}
+      : key_hash_(key_hash), details_(details), addresses_(addresses) {}
 
-  KeyDescriptor* descriptor_;
+  // The entry's key hash and details, which the EntryCache stores in separate
+  // arrays.
+  uint32_t* key_hash_;
+  KeyDetails* details_;
   std::span<Address> addresses_;
 };
 
 // Tracks entry metadata. Combines KeyDescriptors and with their associated
 // addresses.
+//
+// The parts of each KeyDescriptor are stored as a struct of arrays: the key
+// hashes in one dense array, and their KeyDetails and addresses in parallel
+// arrays. Lookups without a hash index only scan the key hashes, which fit
+// several times more entries per cache line than whole descriptors.
 class EntryCache {
  private:
   enum Constness : bool { kMutable = false, kConst = true };
@@ -94,36 +107,41 @@ class EntryCache {
         std::conditional_t<kIsConst, const EntryMetadata, EntryMetadata>;
 
     Iterator& operator++() {
-      ++metadata_.descriptor_;
+      ++metadata_.key_hash_;
+      ++metadata_.details_;
       return *this;
     }
     Iterator& operator++(int) { return operator++(); }
 
     // Updates the internal EntryMetadata object.
     value_type& operator*() const {
-      metadata_.addresses_ = entry_cache_->addresses(
-          metadata_.descriptor_ - entry_cache_->descriptors_.begin());
+      metadata_.addresses_ = entry_cache_->addresses(index());
       return metadata_;
     }
     value_type* operator->() const { return &operator*(); }
 
     constexpr bool operator==(const Iterator& rhs) const {
-      return metadata_.descriptor_ == rhs.metadata_.descriptor_;
+      return metadata_.key_hash_ == rhs.metadata_.key_hash_;
     }
     constexpr bool operator!=(const Iterator& rhs) const {
-      return metadata_.descriptor_ != rhs.metadata_.descriptor_;
+      return metadata_.key_hash_ != rhs.metadata_.key_hash_;
     }
 
     // Allow non-const to convert to const.
-    operator Iterator<kConst>() const {
-      return {entry_cache_, metadata_.descriptor_};
-    }
+    operator Iterator<kConst>() const { return {entry_cache_, index()}; }
 
    private:
     friend class EntryCache;
 
-    constexpr Iterator(const EntryCache* entry_cache, KeyDescriptor* descriptor)
-        : entry_cache_(entry_cache), metadata_(*descriptor, {}) {}
+    Iterator(const EntryCache* entry_cache, size_t index)
+        : entry_cache_(entry_cache),
+          metadata_(entry_cache->key_hashes_.data() + index,
+                    entry_cache->details_ + index,
+                    {}) {}
+
+    size_t index() const {
+      return metadata_.key_hash_ - entry_cache_->key_hashes_.data();
+    }
 
     const EntryCache* entry_cache_;
 
@@ -144,15 +162,44 @@ class EntryCache {
   template <size_t kMaxEntries, size_t kRedundancy>
   using AddressList = Address[kMaxEntries * kRedundancy + kRedundancy];
 
-  constexpr EntryCache(Vector<KeyDescriptor>& descriptors,
+  // The types to use for the key hashes and KeyDetails of an EntryCache with
+  // the specified number of entries.
+  template <size_t kMaxEntries>
+  using KeyHashList = Vector<uint32_t, kMaxEntries>;
+
+  template <size_t kMaxEntries>
+  using KeyDetailsList = KeyDetails[kMaxEntries];
+
+  // Slots in the optional key hash index. Each slot holds the index of a
+  // descriptor plus one; zero marks an empty slot, so a zero-initialized index
+  // is empty.
+  using IndexSlot = uint16_t;
+
+  // The type to use for a hash index with the specified number of slots. The
+  // slot count must be a power of two and at least the maximum number of
+  // entries. Sizing the index at twice the maximum entries keeps probe
+  // sequences short.
+  template <size_t kIndexSlots>
+  using HashIndex = std::array<IndexSlot, kIndexSlots>;
+
+  // Creates an EntryCache. key_details must have room for
+  // key_hashes.max_size() entries. If index is non-empty, it is used as an
+  // open-addressed hash table keyed on KeyDescriptor::key_hash, which makes
+  // lookups O(1) on average. The descriptors remain the source of truth; the
+  // index only accelerates finding them.
+  constexpr EntryCache(Vector<uint32_t>& key_hashes,
+                       KeyDetails* key_details,
                        Address* addresses,
-                       size_t redundancy)
-      : descriptors_(descriptors),
+                       size_t redundancy,
+                       std::span<IndexSlot> index = {})
+      : key_hashes_(key_hashes),
+        details_(key_details),
         addresses_(addresses),
-        redundancy_(redundancy) {}
+        redundancy_(redundancy),
+        index_(index) {}
 
   // Clears all KeyDescriptors.
-  void Reset() const { descriptors_.clear(); }
+  void Reset() const;
 
   // Finds the metadata for an entry matching a particular key. Searches for a
   // KeyDescriptor that matches this key and sets *metadata to point to it if
@@ -187,33 +234,43 @@ class EntryCache {
   // This is used by the KeyValueStore to track reserved addresses when finding
   // space for a new entry.
   Address* TempReservedAddressesForWrite() const {
-    return &addresses_[descriptors_.max_size() * redundancy_];
+    return &addresses_[key_hashes_.max_size() * redundancy_];
   }
 
   // The number of copies of each entry.
   size_t redundancy() const { return redundancy_; }
 
   // True if no more entries can be added to the cache.
-  bool full() const { return descriptors_.full(); }
+  bool full() const { return key_hashes_.full(); }
 
   // The total number of entries, including tombstone entries.
-  size_t total_entries() const { return descriptors_.size(); }
+  size_t total_entries() const { return key_hashes_.size(); }
 
   // The total number of present (non-tombstone) entries.
   size_t present_entries() const;
 
   // The maximum number of entries supported by this EntryCache.
-  size_t max_entries() const { return descriptors_.max_size(); }
+  size_t max_entries() const { return key_hashes_.max_size(); }
+
+  iterator begin() const { return {this, 0}; }
+  const_iterator cbegin() const { return {this, 0}; }
 
-  iterator begin() const { return {this, descriptors_.begin()}; }
-  const_iterator cbegin() const { return {this, descriptors_.begin()}; }
+  iterator end() const { return {this, key_hashes_.size()}; }
+  const_iterator cend() const { return {this, key_hashes_.size()}; }
 
-  iterator end() const { return {this, descriptors_.end()}; }
-  const_iterator cend() const { return {this, descriptors_.end()}; }
+  // True if this EntryCache uses a hash index for lookups.
+  bool has_index() const { return !index_.empty(); }
 
  private:
+  // Returns the index of the descriptor with the given hash, or -1 if there is
+  // none. Uses the hash index if there is one; otherwise scans key_hashes_.
   int FindIndex(uint32_t key_hash) const;
 
+  // Records the descriptor at descriptor_index in the hash index, if any.
+  void AddToIndex(size_t descriptor_index) const;
+
+  size_t index_mask() const { return index_.size() - 1; }
+
   // Adds the address to the descriptor at the specified index if there is an
   // address slot available.
   void AddAddressIfRoom(size_t descriptor_index, Address address) const;
@@ -227,9 +284,13 @@ class EntryCache {
 
   Address* ResetAddresses(size_t descriptor_index, Address address) const;
 
-  Vector<KeyDescriptor>& descriptors_;
+  // Each entry's key hash, KeyDetails, and addresses are at the same index in
+  // these arrays. key_hashes_ holds the entry count.
+  Vector<uint32_t>& key_hashes_;
+  KeyDetails* const details_;
   FlashPartition::Address* const addresses_;
   const size_t redundancy_;
+  const std::span<IndexSlot> index_;
 };
 
 }  // namespace internal
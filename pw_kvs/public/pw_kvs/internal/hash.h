@@ -14,6 +14,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 #include "pw_kvs/key.h"
 
@@ -34,6 +35,28 @@ constexpr uint32_t Hash(Key string) {
   return hash;
 }
 
+// Keys are grouped into namespaces by their first kNamespaceSeparator. A key's
+// namespace is the key up to and including the separator, or empty if the key
+// has no separator.
+constexpr char kNamespaceSeparator = '/';
+
+// Returns the length of the key's namespace.
+constexpr size_t NamespaceLength(Key key) {
+  for (size_t i = 0; i < key.size(); ++i) {
+    if (key[i] == kNamespaceSeparator) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+// A 16-bit hash of the key's namespace. Keys that start with the same
+// namespace have the same tag.
+constexpr uint16_t NamespaceTag(Key key) {
+  const uint32_t hash = Hash(Key(key.data(), NamespaceLength(key)));
+  return static_cast<uint16_t>(hash ^ (hash >> 16));
+}
+
 }  // namespace internal
 }  // namespace kvs
 }  // namespace pw
@@ -28,6 +28,18 @@ struct KeyDescriptor {
   uint32_t transaction_id;
 
   EntryState state;  // TODO: Pack into transaction ID? or something?
+
+  // NamespaceTag() of the key. Fits in padding, so it takes no extra space.
+  uint16_t namespace_tag = 0;
+};
+
+// The fields of a KeyDescriptor other than its key hash. The EntryCache stores
+// these apart from the key hashes, so that searching the hashes reads a dense
+// array rather than striding over whole descriptors.
+struct KeyDetails {
+  uint32_t transaction_id;
+  EntryState state;
+  uint16_t namespace_tag = 0;
 };
 
 }  // namespace internal
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <climits>
 #include <cstddef>
 #include <cstdint>
@@ -34,38 +36,14 @@ class SectorDescriptor {
     return (tail_free_bytes_ == kCorruptSector) ? 0 : tail_free_bytes_;
   }
 
-  void set_writable_bytes(uint16_t writable_bytes) {
-    tail_free_bytes_ = writable_bytes;
-  }
-
-  void mark_corrupt() { tail_free_bytes_ = kCorruptSector; }
   bool corrupt() const { return tail_free_bytes_ == kCorruptSector; }
 
   // The number of bytes of valid data in this sector.
   size_t valid_bytes() const { return valid_bytes_; }
 
-  // Adds valid bytes without updating the writable bytes.
-  void AddValidBytes(uint16_t bytes) { valid_bytes_ += bytes; }
-
-  // Removes valid bytes without updating the writable bytes.
-  void RemoveValidBytes(uint16_t bytes) {
-    if (bytes > valid_bytes()) {
-      // TODO: use a DCHECK instead -- this is a programming error
-      valid_bytes_ = 0;
-    } else {
-      valid_bytes_ -= bytes;
-    }
-  }
-
-  // Removes writable bytes without updating the valid bytes.
-  void RemoveWritableBytes(uint16_t bytes) {
-    if (bytes > writable_bytes()) {
-      // TODO: use a DCHECK instead -- this is a programming error
-      tail_free_bytes_ = 0;
-    } else {
-      tail_free_bytes_ -= bytes;
-    }
-  }
+  // The number of times the KVS has erased this sector. Only tracked if the
+  // sectors have headers; otherwise 0.
+  uint32_t erase_count() const { return erase_count_; }
 
   bool HasSpace(size_t required_space) const {
     return writable_bytes() >= required_space;
@@ -84,16 +62,48 @@ class SectorDescriptor {
   static constexpr size_t max_sector_size() { return kMaxSectorSize; }
 
  private:
+  // The descriptors are modified through Sectors, which keeps its optional
+  // index up to date.
   friend class Sectors;
 
   static constexpr uint16_t kCorruptSector = UINT16_MAX;
   static constexpr size_t kMaxSectorSize = UINT16_MAX - 1;
 
   explicit constexpr SectorDescriptor(uint16_t sector_size_bytes)
-      : tail_free_bytes_(sector_size_bytes), valid_bytes_(0) {}
+      : tail_free_bytes_(sector_size_bytes), valid_bytes_(0), erase_count_(0) {}
+
+  void set_writable_bytes(uint16_t writable_bytes) {
+    tail_free_bytes_ = writable_bytes;
+  }
+
+  void mark_corrupt() { tail_free_bytes_ = kCorruptSector; }
+
+  // Adds valid bytes without updating the writable bytes.
+  void AddValidBytes(uint16_t bytes) { valid_bytes_ += bytes; }
+
+  // Removes valid bytes without updating the writable bytes.
+  void RemoveValidBytes(uint16_t bytes) {
+    if (bytes > valid_bytes()) {
+      // TODO: use a DCHECK instead -- this is a programming error
+      valid_bytes_ = 0;
+    } else {
+      valid_bytes_ -= bytes;
+    }
+  }
+
+  // Removes writable bytes without updating the valid bytes.
+  void RemoveWritableBytes(uint16_t bytes) {
+    if (bytes > writable_bytes()) {
+      // TODO: use a DCHECK instead -- this is a programming error
+      tail_free_bytes_ = 0;
+    } else {
+      tail_free_bytes_ -= bytes;
+    }
+  }
 
   uint16_t tail_free_bytes_;  // writable bytes at the end of the sector
   uint16_t valid_bytes_;      // sum of sizes of valid entries
+  uint32_t erase_count_;
 };
 
 // Represents a list of sectors usable by the KVS.
@@ -101,19 +111,109 @@ class Sectors {
  public:
   using Address = FlashPartition::Address;
 
+  // Nodes in the optional sector index. The index is a set of max segment
+  // trees over values derived from each SectorDescriptor, such as its writable
+  // or recoverable bytes, with one leaf per sector.
+  using IndexNode = uint16_t;
+
+  // The number of segment trees in the index.
+  static constexpr size_t kIndexTrees = 6;
+
+  // The number of leaves in each segment tree: max_sectors rounded up to a
+  // power of two.
+  static constexpr size_t IndexLeaves(size_t max_sectors) {
+    size_t leaves = 1;
+    while (leaves < max_sectors) {
+      leaves *= 2;
+    }
+    return leaves;
+  }
+
+  // The type to use for a sector index for kMaxSectors sectors. A zero-sized
+  // index disables indexing.
+  template <size_t kMaxSectors>
+  using IndexBuffer = std::array<
+      IndexNode,
+      kMaxSectors == 0u ? 0u : kIndexTrees * 2 * IndexLeaves(kMaxSectors)>;
+
+  // Creates a Sectors list. If index is non-empty, it is used to find sectors
+  // in O(log n) time instead of scanning every descriptor. The index must be
+  // an IndexBuffer<N> with N at least the maximum number of sectors.
   constexpr Sectors(Vector<SectorDescriptor>& sectors,
                     FlashPartition& partition,
-                    const SectorDescriptor** temp_sectors_to_skip)
+                    const SectorDescriptor** temp_sectors_to_skip,
+                    std::span<IndexNode> index = {})
       : descriptors_(sectors),
         partition_(partition),
         last_new_(nullptr),
-        temp_sectors_to_skip_(temp_sectors_to_skip) {}
+        temp_sectors_to_skip_(temp_sectors_to_skip),
+        index_(index),
+        index_leaves_(index.size() / (2 * kIndexTrees)),
+        header_bytes_(0),
+        max_erase_count_(0) {}
 
   // Resets the Sectors list. Must be called before using the object.
-  void Reset() {
+  //
+  // If header_bytes is nonzero, each sector starts with a header of that size
+  // that records the sector's erase count. Entries are stored after the header,
+  // and selecting sectors to write to or garbage collect takes the erase counts
+  // into account to spread wear.
+  void Reset(size_t header_bytes = 0) {
+    header_bytes_ = header_bytes;
+    max_erase_count_ = 0;
     last_new_ = descriptors_.begin();
     descriptors_.assign(partition_.sector_count(),
-                        SectorDescriptor(partition_.sector_size_bytes()));
+                        SectorDescriptor(uint16_t(sector_data_bytes())));
+    RebuildIndex();
+  }
+
+  // The size of the header at the start of each sector, if any.
+  size_t sector_header_bytes() const { return header_bytes_; }
+
+  // The number of bytes in each sector that are available for entries. Pass
+  // this to SectorDescriptor::Empty() and SectorDescriptor::RecoverableBytes().
+  size_t sector_data_bytes() const {
+    return partition_.sector_size_bytes() - header_bytes_;
+  }
+
+  // True if the sectors have headers with erase counts.
+  bool tracks_erase_counts() const { return header_bytes_ != 0u; }
+
+  // The largest erase count of any sector.
+  uint32_t max_erase_count() const { return max_erase_count_; }
+
+  void set_erase_count(SectorDescriptor& sector, uint32_t erase_count) {
+    sector.erase_count_ = erase_count;
+    max_erase_count_ = std::max(max_erase_count_, erase_count);
+  }
+
+  // Functions for updating a sector's descriptor. These match the
+  // SectorDescriptor functions of the same names and update the index.
+  void set_writable_bytes(SectorDescriptor& sector, uint16_t writable_bytes) {
+    sector.set_writable_bytes(writable_bytes);
+    UpdateIndex(sector);
+  }
+
+  void AddValidBytes(SectorDescriptor& sector, uint16_t bytes) {
+    sector.AddValidBytes(bytes);
+    UpdateIndex(sector);
+  }
+
+  void RemoveValidBytes(SectorDescriptor& sector, uint16_t bytes) {
+    sector.RemoveValidBytes(bytes);
+    UpdateIndex(sector);
+  }
+
+  void RemoveWritableBytes(SectorDescriptor& sector, uint16_t bytes) {
+    sector.RemoveWritableBytes(bytes);
+    UpdateIndex(sector);
+  }
+
+  // Like FromAddress(), this is const so that corruption found while reading
+  // can be recorded.
+  void mark_corrupt(SectorDescriptor& sector) const {
+    sector.mark_corrupt();
+    UpdateIndex(sector);
   }
 
   // The last sector that was selected as the "new empty sector" to write to.
@@ -184,12 +284,23 @@ class Sectors {
   SectorDescriptor* FindSectorToGarbageCollect(
       std::span<const Address> reserved_addresses) const;
 
+  // Finds the least erased sector with data if it has been erased more than
+  // threshold times fewer than the most erased sector. Garbage collecting it
+  // moves rarely updated data out of it, so that it shares the wear with the
+  // other sectors. Returns nullptr if erase counts are not tracked or no
+  // sector lags behind.
+  SectorDescriptor* FindSectorToWearLevel(
+      uint32_t threshold, std::span<const Address> reserved_addresses) const;
+
   // The number of sectors in use.
   size_t size() const { return descriptors_.size(); }
 
   // The maximum number of sectors supported.
   size_t max_size() const { return descriptors_.max_size(); }
 
+  // True if this Sectors list uses an index to find sectors.
+  bool has_index() const { return !index_.empty(); }
+
   // Returns the index of the provided sector. Used for logging.
   unsigned Index(const SectorDescriptor& sector) const {
     return &sector - descriptors_.begin();
@@ -209,14 +320,76 @@ class Sectors {
  private:
   enum FindMode { kAppendEntry, kGarbageCollect };
 
+  // The segment trees in the index. Each leaf holds a value derived from one
+  // sector. Leaves for sectors that do not match are 0.
+  enum IndexTree : size_t {
+    kPartialSpace,       // writable bytes + 1 of a non-empty sector
+    kCleanPartialSpace,  // same, for sectors with no recoverable bytes
+    kEmptySector,        // 1 for an empty sector
+    kStaleSector,        // 1 for a sector with only recoverable bytes
+    kRecoverable,        // recoverable bytes
+    kValid,              // valid bytes
+  };
+
+  static constexpr size_t kNotFound = SIZE_MAX;
+
   Status Find(FindMode find_mode,
               SectorDescriptor** found_sector,
               size_t size,
               std::span<const Address> addresses_to_skip,
               std::span<const Address> reserved_addresses);
 
+  // Find() and FindSectorToGarbageCollect() using the index. The sectors to
+  // skip must already be in temp_sectors_to_skip_.
+  Status FindWithIndex(FindMode find_mode,
+                       SectorDescriptor** found_sector,
+                       size_t size,
+                       size_t sectors_to_skip);
+  SectorDescriptor* FindSectorToGarbageCollectWithIndex(
+      size_t sectors_to_skip) const;
+
   SectorDescriptor& WearLeveledSectorFromIndex(size_t idx) const;
 
+  // The index of the sector after last_new_, where wear leveled searches
+  // start.
+  size_t WearLeveledStart() const {
+    return (Index(last_new_) + 1) % descriptors_.size();
+  }
+
+  IndexNode* IndexTreeNodes(IndexTree tree) const {
+    return &index_[tree * 2 * index_leaves_];
+  }
+
+  // Sets the leaves for the sector from its descriptor. Does nothing if there
+  // is no index.
+  void UpdateIndex(const SectorDescriptor& sector) const;
+
+  // Sets the leaves for the sector to 0 so searches skip it. UpdateIndex()
+  // restores them.
+  void ExcludeFromIndex(const SectorDescriptor& sector) const;
+
+  // Rebuilds the whole index from the descriptors.
+  void RebuildIndex() const;
+
+  void SetIndexLeaf(IndexTree tree, size_t sector, IndexNode value) const;
+
+  // Returns the first sector at or after start, wrapping around to the first
+  // sector, with a leaf value of at least min_value, or kNotFound.
+  size_t FindInIndex(IndexTree tree, size_t start, size_t min_value) const;
+
+  // Of the sectors with a nonzero leaf value, returns the one with the lowest
+  // erase count, the first at or after start on ties, or kNotFound.
+  size_t FindLeastErasedInIndex(IndexTree tree, size_t start) const;
+
+  // Returns the first sector at or after first with a leaf value of at least
+  // min_value, without wrapping around, or kNotFound.
+  size_t FindFirstInIndex(IndexTree tree,
+                          size_t first,
+                          size_t min_value) const;
+
+  // The largest leaf value in the tree.
+  IndexNode IndexMax(IndexTree tree) const { return IndexTreeNodes(tree)[1]; }
+
   Vector<SectorDescriptor>& descriptors_;
   FlashPartition& partition_;
 
@@ -225,6 +398,14 @@ class Sectors {
   // Temp buffer with space for redundancy * 2 - 1 sector pointers. This list is
   // used to track sectors that should be excluded from Find functions.
   const SectorDescriptor** const temp_sectors_to_skip_;
+
+  // Optional sector index. Each tree uses 2 * index_leaves_ nodes; node 1 is
+  // the root and the leaves start at index_leaves_.
+  const std::span<IndexNode> index_;
+  const size_t index_leaves_;
+
+  size_t header_bytes_;
+  uint32_t max_erase_count_;
 };
 
 }  // namespace internal
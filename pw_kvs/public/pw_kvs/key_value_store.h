@@ -16,6 +16,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <span>
 #include <type_traits>
 
@@ -25,6 +26,7 @@
 #include "pw_kvs/format.h"
 #include "pw_kvs/internal/entry.h"
 #include "pw_kvs/internal/entry_cache.h"
+#include "pw_kvs/internal/hash.h"
 #include "pw_kvs/internal/key_descriptor.h"
 #include "pw_kvs/internal/sectors.h"
 #include "pw_kvs/internal/span_traits.h"
@@ -72,11 +74,37 @@ struct Options {
   // not enough redundant copys of an entry, etc.
   ErrorRecovery recovery = ErrorRecovery::kLazy;
 
-  // Verify an entry's checksum after reading it from flash.
+  // Verify an entry's checksum when reading it from flash. Gets of a whole
+  // value are verified as the value is read, so it is only read once.
   bool verify_on_read = true;
 
   // Verify an in-flash entry's checksum after writing it.
   bool verify_on_write = true;
+
+  // If nonzero, PartialMaintenance() garbage collects incrementally. Each call
+  // performs one GarbageCollectStep() that relocates about this many bytes of
+  // valid entries, rather than garbage collecting an entire sector.
+  size_t partial_maintenance_step_bytes = 0;
+
+  // Optional partition for metadata checkpoints, which speed up Init(). If
+  // set, successful full maintenance writes a snapshot of the KVS metadata to
+  // this partition. Init() then loads the snapshot and only reads entries that
+  // were written after it, rather than reading every entry in every sector.
+  // The partition must not be used for anything else.
+  FlashPartition* checkpoint_partition = nullptr;
+
+  // Store an erase count in a header at the start of each sector, and use the
+  // erase counts to spread wear: new sectors and sectors to garbage collect
+  // are chosen by the fewest erases. The header takes 16 bytes, or the flash
+  // alignment if larger, of each sector. This changes the flash format, so it
+  // must be set when the partition is erased and never changed after.
+  bool track_erase_counts = false;
+
+  // If erase counts are tracked, maintenance garbage collects sectors with
+  // data that have been erased more than this many times fewer than the most
+  // erased sector. This moves data that rarely changes out of sectors that
+  // would otherwise never be erased. 0 disables this.
+  uint32_t wear_leveling_threshold = 16;
 };
 
 class KeyValueStore {
@@ -173,6 +201,31 @@ class KeyValueStore {
   //
   Status Delete(Key key);
 
+  // A key and value to write with PutBatch().
+  struct BatchItem {
+    Key key;
+    std::span<const std::byte> value;
+  };
+
+  // Writes several key-value pairs together. Space for the whole batch is
+  // found, garbage collecting if needed, before anything is written. The
+  // entries are then written back to back in one sector (one sector per copy
+  // for redundant KVSs), which combines them into fewer, larger flash writes.
+  // As with Put, items whose value is unchanged are not rewritten.
+  //
+  // If the batch fails validation or space cannot be found, nothing is
+  // written. The entry format has no commit marker, so a flash error or power
+  // loss while the batch is written can leave some of its items updated.
+  //
+  //                    OK: all items were added or updated
+  //             DATA_LOSS: checksum validation failed after writing
+  //    RESOURCE_EXHAUSTED: there is not enough space for the batch
+  //   FAILED_PRECONDITION: the KVS is not initialized
+  //      INVALID_ARGUMENT: a key is empty, too long, or repeated, or the
+  //                        batch is too large to fit in one sector
+  //
+  Status PutBatch(std::span<const BatchItem> items);
+
   // Returns the size of the value corresponding to the key.
   //
   //                    OK: the size was returned successfully
@@ -211,6 +264,61 @@ class KeyValueStore {
   // that makes sense for the KVS implementation.
   Status PartialMaintenance();
 
+  // Performs one bounded step of incremental garbage collection. Garbage
+  // collecting a sector relocates all of its valid entries and then erases it,
+  // which may take a long time. GarbageCollectStep() instead spreads this work
+  // across calls, so it can be run in small increments from PartialMaintenance
+  // or a low priority thread. Each step does one of the following:
+  //
+  //   - Relocates valid entries from the sector being garbage collected until
+  //     at least max_relocate_bytes have been moved. At least one entry is
+  //     relocated, even if it is larger than max_relocate_bytes.
+  //   - Erases the sector once it has no valid entries, completing its garbage
+  //     collection.
+  //
+  // The first step selects a sector in the same way as PartialMaintenance.
+  // Puts and Deletes may occur between steps. A Put that needs garbage
+  // collection still garbage collects a full sector; stepping ahead of time
+  // keeps reclaimable space available so that this is rare.
+  //
+  // Return values:
+  //
+  //                    OK: a step was completed
+  //             NOT_FOUND: there is no reclaimable space to garbage collect
+  //   FAILED_PRECONDITION: the KVS is not initialized
+  //    RESOURCE_EXHAUSTED: there is no space to relocate an entry
+  //
+  // Other errors are returned from flash operations, as with
+  // PartialMaintenance.
+  Status GarbageCollectStep(size_t max_relocate_bytes);
+
+  // True if a sector's garbage collection was started by GarbageCollectStep()
+  // and has not yet completed.
+  bool garbage_collection_in_progress() const {
+    return incremental_gc_sector_ != nullptr;
+  }
+
+  // Writes a snapshot of the KVS metadata to Options::checkpoint_partition.
+  // The snapshot holds each key's descriptor and addresses, plus how far each
+  // sector has been written. A checkpoint remains valid until a sector is
+  // erased; KeyValueStore overwrites part of the checkpoint to invalidate it
+  // before erasing any sector. Full maintenance writes a checkpoint
+  // automatically. Returns:
+  //
+  //                    OK: the checkpoint was written
+  //   FAILED_PRECONDITION: there is no checkpoint partition, or the KVS is not
+  //                        initialized or has unrepaired errors
+  //    RESOURCE_EXHAUSTED: the checkpoint does not fit in the partition
+  //      INVALID_ARGUMENT: the checkpoint partition's alignment is larger than
+  //                        PW_KVS_MAX_FLASH_ALIGNMENT
+  //
+  // Other errors are returned from flash operations.
+  Status WriteCheckpoint();
+
+  // True if the checkpoint partition holds a checkpoint that has not been
+  // invalidated since it was written or loaded by Init().
+  bool checkpoint_valid() const { return checkpoint_valid_; }
+
   void LogDebugInfo() const;
 
   // Classes and functions to support STL-style iteration.
@@ -245,12 +353,17 @@ class KeyValueStore {
 
     constexpr Item(const KeyValueStore& kvs,
                    const internal::EntryCache::const_iterator& item_iterator)
-        : kvs_(kvs), iterator_(item_iterator), key_buffer_{} {}
+        : kvs_(kvs),
+          iterator_(item_iterator),
+          key_read_(false),
+          key_buffer_{} {}
 
+    // Reads the key from flash, unless it was already read for this entry.
     void ReadKey();
 
     const KeyValueStore& kvs_;
     internal::EntryCache::const_iterator iterator_;
+    bool key_read_;
 
     // Buffer large enough for a null-terminated version of any valid key.
     std::array<char, internal::Entry::kMaxKeyLength + 1> key_buffer_;
@@ -285,17 +398,59 @@ class KeyValueStore {
 
     constexpr iterator(
         const KeyValueStore& kvs,
-        const internal::EntryCache::const_iterator& item_iterator)
-        : item_(kvs, item_iterator) {}
+        const internal::EntryCache::const_iterator& item_iterator,
+        Key prefix = {})
+        : item_(kvs, item_iterator),
+          prefix_(prefix),
+          namespace_tag_(internal::NamespaceTag(prefix)),
+          match_namespace_(internal::NamespaceLength(prefix) != 0u) {}
+
+    // True if the entry is valid and its key starts with prefix_.
+    bool Matches();
 
     Item item_;
+    Key prefix_;
+    uint16_t namespace_tag_;
+    bool match_namespace_;
   };
 
   using const_iterator = iterator;  // Standard alias for iterable types.
 
-  iterator begin() const;
+  iterator begin() const { return BeginWithPrefix({}); }
   iterator end() const { return iterator(*this, entry_cache_.end()); }
 
+  // The entries with keys that start with a prefix. Returned by WithPrefix().
+  class PrefixRange {
+   public:
+    iterator begin() const { return kvs_.BeginWithPrefix(prefix_); }
+    iterator end() const { return kvs_.end(); }
+
+   private:
+    friend class KeyValueStore;
+
+    constexpr PrefixRange(const KeyValueStore& kvs, Key prefix)
+        : kvs_(kvs), prefix_(prefix) {}
+
+    const KeyValueStore& kvs_;
+    Key prefix_;
+  };
+
+  // Iterates over the entries with keys that start with prefix. The prefix is
+  // not copied, so it must outlive the range.
+  //
+  // Keys are grouped into namespaces by their first '/'; for example, "net/ip"
+  // is in the "net/" namespace. Each key's namespace is tagged in RAM, so if
+  // the prefix contains a '/', entries in other namespaces are skipped without
+  // reading their keys from flash. Other prefixes read every key.
+  //
+  //   for (const auto& item : kvs.WithPrefix("net/")) {
+  //     ...
+  //   }
+  //
+  PrefixRange WithPrefix(Key prefix) const {
+    return PrefixRange(*this, prefix);
+  }
+
   // Returns the number of valid entries in the KeyValueStore.
   size_t size() const { return entry_cache_.present_entries(); }
 
@@ -315,6 +470,11 @@ class KeyValueStore {
     size_t sector_erase_count;
     size_t corrupt_sectors_recovered;
     size_t missing_redundant_entries_recovered;
+
+    // The fewest and most times any sector has been erased. Only tracked if
+    // Options::track_erase_counts is set; otherwise both are 0.
+    size_t min_sector_erase_count;
+    size_t max_sector_erase_count;
   };
 
   StorageStats GetStorageStats() const;
@@ -326,7 +486,7 @@ class KeyValueStore {
 
   // Maximum number of bytes allowed for a key-value combination.
   size_t max_key_value_size_bytes() const {
-    return max_key_value_size_bytes(partition_.sector_size_bytes());
+    return max_key_value_size_bytes(sectors_.sector_data_bytes());
   }
 
   // Maximum number of bytes allowed for a given sector size for a key-value
@@ -354,8 +514,11 @@ class KeyValueStore {
                 size_t redundancy,
                 Vector<SectorDescriptor>& sector_descriptor_list,
                 const SectorDescriptor** temp_sectors_to_skip,
-                Vector<KeyDescriptor>& key_descriptor_list,
-                Address* addresses);
+                Vector<uint32_t>& key_hash_list,
+                internal::KeyDetails* key_details,
+                Address* addresses,
+                std::span<internal::EntryCache::IndexSlot> key_index = {},
+                std::span<internal::Sectors::IndexNode> sector_index = {});
 
  private:
   using EntryMetadata = internal::EntryMetadata;
@@ -372,11 +535,24 @@ class KeyValueStore {
   }
 
   Status InitializeMetadata();
+  Status InitializeMetadataFromCheckpoint();
+  Status ScanMetadata(bool from_checkpoint);
+  Status LoadCheckpoint();
+  Status InvalidateCheckpoint();
   Status LoadEntry(Address entry_address, Address* next_entry_address);
   Status ScanForEntry(const SectorDescriptor& sector,
                       Address start_address,
                       Address* next_entry_address);
 
+  // The size of the header at the start of each sector, if any.
+  size_t SectorHeaderBytes() const;
+
+  // Reads the sector's erase count from its header.
+  Status ReadSectorHeader(SectorDescriptor& sector);
+
+  // Writes the header to an erased sector.
+  Status WriteSectorHeader(SectorDescriptor& sector, uint32_t erase_count);
+
   Status PutBytes(Key key, std::span<const std::byte> value);
 
   StatusWithSize ValueSize(const EntryMetadata& metadata) const;
@@ -482,6 +658,12 @@ class KeyValueStore {
   // address.
   Status GarbageCollect(std::span<const Address> reserved_addresses);
 
+  // Garbage collects a sector that has fallen behind in erases, if erase counts
+  // are tracked. Returns NOT_FOUND if there is no such sector.
+  Status WearLevel();
+
+  SectorDescriptor* FindSectorToWearLevel() const;
+
   Status RelocateKeyAddressesInSector(
       SectorDescriptor& sector_to_gc,
       const EntryMetadata& metadata,
@@ -516,14 +698,19 @@ class KeyValueStore {
   void LogSectors() const;
   void LogKeyDescriptor() const;
 
+  // Returns an iterator to the first valid entry with a key that starts with
+  // prefix.
+  iterator BeginWithPrefix(Key prefix) const;
+
   FlashPartition& partition_;
   const internal::EntryFormats formats_;
 
   // List of sectors used by this KVS.
   internal::Sectors sectors_;
 
-  // Unordered list of KeyDescriptors. Finding a key requires scanning and
-  // verifying a match by reading the actual entry.
+  // Unordered list of KeyDescriptors. Finding a key requires scanning (or
+  // probing the optional hash index) and verifying a match by reading the
+  // actual entry.
   internal::EntryCache entry_cache_;
 
   Options options_;
@@ -560,12 +747,31 @@ class KeyValueStore {
   InternalStats internal_stats_;
 
   uint32_t last_transaction_id_;
+
+  // The sector being garbage collected by GarbageCollectStep(), if any.
+  SectorDescriptor* incremental_gc_sector_;
+
+  // Whether the checkpoint partition holds a checkpoint that matches flash.
+  bool checkpoint_valid_;
 };
 
+// kIndexSlots sets the size of an optional hash index over the key hashes,
+// which makes key lookups O(1) on average instead of a linear scan of all
+// entries. kIndexSlots must be 0 (no index) or a power of two that is at least
+// kMaxEntries; 2 * kMaxEntries rounded up to a power of two is a good choice.
+// The index costs 2 bytes of RAM per slot.
+//
+// kSectorIndex enables an index over the sectors' free, valid, and recoverable
+// bytes, which makes finding a sector to write to or garbage collect
+// O(log kMaxUsableSectors) instead of a scan of all sectors. The index costs
+// 24 bytes of RAM per sector, with kMaxUsableSectors rounded up to a power of
+// two.
 template <size_t kMaxEntries,
           size_t kMaxUsableSectors,
           size_t kRedundancy = 1,
-          size_t kEntryFormats = 1>
+          size_t kEntryFormats = 1,
+          size_t kIndexSlots = 0,
+          bool kSectorIndex = false>
 class KeyValueStoreBuffer : public KeyValueStore {
  public:
   // Constructs a KeyValueStore on the partition, with support for one
@@ -593,8 +799,11 @@ class KeyValueStoreBuffer : public KeyValueStore {
                       kRedundancy,
                       sectors_,
                       temp_sectors_to_skip_,
-                      key_descriptors_,
-                      addresses_) {
+                      key_hashes_,
+                      key_details_,
+                      addresses_,
+                      key_index_,
+                      sector_index_) {
     std::copy(formats.begin(), formats.end(), formats_.begin());
   }
 
@@ -603,6 +812,14 @@ class KeyValueStoreBuffer : public KeyValueStore {
   static_assert(kMaxUsableSectors > 0u);
   static_assert(kRedundancy > 0u);
   static_assert(kEntryFormats > 0u);
+  static_assert(kIndexSlots == 0u ||
+                    (kIndexSlots >= kMaxEntries &&
+                     (kIndexSlots & (kIndexSlots - 1)) == 0u),
+                "kIndexSlots must be 0 or a power of two >= kMaxEntries");
+  static_assert(kIndexSlots == 0u ||
+                    kMaxEntries < std::numeric_limits<
+                                      internal::EntryCache::IndexSlot>::max(),
+                "kMaxEntries is too large for the hash index");
 
   Vector<SectorDescriptor, kMaxUsableSectors> sectors_;
 
@@ -614,8 +831,10 @@ class KeyValueStoreBuffer : public KeyValueStore {
   // maximum of 2 * kRedundancy - 1 sectors to avoid.
   const SectorDescriptor* temp_sectors_to_skip_[2 * kRedundancy - 1];
 
-  // KeyDescriptors for use by the KVS's EntryCache.
-  Vector<KeyDescriptor, kMaxEntries> key_descriptors_;
+  // KeyDescriptors for use by the KVS's EntryCache, split into their key
+  // hashes and the remaining details so that lookups scan only the hashes.
+  internal::EntryCache::KeyHashList<kMaxEntries> key_hashes_;
+  internal::EntryCache::KeyDetailsList<kMaxEntries> key_details_;
 
   // An array of addresses associated with the KeyDescriptors for use with the
   // EntryCache. To support having KeyValueStores with different redundancies,
@@ -623,6 +842,14 @@ class KeyValueStoreBuffer : public KeyValueStore {
   // KeyDescriptors.
   internal::EntryCache::AddressList<kRedundancy, kMaxEntries> addresses_;
 
+  // Optional hash index for finding KeyDescriptors by key hash. This is
+  // zero-initialized, which marks every slot empty.
+  internal::EntryCache::HashIndex<kIndexSlots> key_index_ = {};
+
+  // Optional index for finding sectors with space or to garbage collect.
+  internal::Sectors::IndexBuffer<kSectorIndex ? kMaxUsableSectors : 0>
+      sector_index_;
+
   // EntryFormats that can be read by this KeyValueStore.
   std::array<EntryFormat, kEntryFormats> formats_;
 };
@@ -0,0 +1,94 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "pw_kvs/flash_memory.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::kvs {
+
+// A fast, host-only FlashMemory for simulations that run many KVS instances
+// over large flashes, such as fuzzers and fleet simulations.
+//
+// Sectors are allocated on the heap when first written and freed when erased,
+// so erasing is O(1) per sector and untouched sectors use no memory. Snapshot()
+// creates a copy of the whole flash that shares sectors with the original until
+// one of them writes to a shared sector, so forking a flash image costs one
+// pointer per sector.
+//
+// Writes must be aligned and go to erased memory, as with FakeFlashMemory, but
+// there is no error injection and the checks are done a word at a time.
+//
+// An instance and its snapshots may be used from different threads, but each
+// instance must only be used from one thread at a time.
+class SimulatedFlashMemory final : public FlashMemory {
+ public:
+  static constexpr std::byte kErasedValue = std::byte{0xff};
+
+  SimulatedFlashMemory(size_t sector_size,
+                       size_t sector_count,
+                       size_t alignment_bytes = 1)
+      : FlashMemory(sector_size, sector_count, alignment_bytes),
+        sectors_(sector_count) {}
+
+  SimulatedFlashMemory(SimulatedFlashMemory&&) = default;
+  SimulatedFlashMemory& operator=(SimulatedFlashMemory&&) = delete;
+
+  // Returns a copy of the flash contents that shares sectors with this flash.
+  // Writes to either copy do not affect the other.
+  SimulatedFlashMemory Snapshot() const { return SimulatedFlashMemory(*this); }
+
+  // The simulated flash is always enabled.
+  Status Enable() override { return OkStatus(); }
+
+  Status Disable() override { return OkStatus(); }
+
+  bool IsEnabled() const override { return true; }
+
+  Status Erase(Address address, size_t num_sectors) override;
+
+  StatusWithSize Read(Address address, std::span<std::byte> output) override;
+
+  StatusWithSize Write(Address address,
+                       std::span<const std::byte> data) override;
+
+  // Testing API
+
+  // The number of sectors that hold data, including sectors shared with
+  // snapshots.
+  size_t allocated_sectors() const;
+
+ private:
+  using Sector = std::shared_ptr<std::byte[]>;
+
+  SimulatedFlashMemory(const SimulatedFlashMemory&) = default;
+
+  // Returns a sector that may be written, allocating or copying it if needed.
+  std::byte* WritableSector(size_t index);
+
+  // Calls visitor(sector_index, offset_in_sector, size) for each sector
+  // overlapped by the range.
+  template <typename Visitor>
+  void ForEachSector(Address address, size_t size, Visitor&& visitor) const;
+
+  std::vector<Sector> sectors_;  // nullptr if erased
+};
+
+}  // namespace pw::kvs
@@ -17,6 +17,8 @@
 
 #include "pw_kvs/internal/sectors.h"
 
+#include <algorithm>
+
 #include "pw_kvs_private/config.h"
 #include "pw_log/shorter.h"
 
@@ -43,7 +45,7 @@ Status Sectors::Find(FindMode find_mode,
 
   // Used for the GC reclaimable bytes check
   SectorDescriptor* non_empty_least_reclaimable_sector = nullptr;
-  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  const size_t sector_size_bytes = sector_data_bytes();
 
   // Build a list of sectors to avoid.
   //
@@ -71,6 +73,10 @@ Status Sectors::Find(FindMode find_mode,
     DBG("  Skip sector %u", Index(temp_sectors_to_skip_[i]));
   }
 
+  if (has_index()) {
+    return FindWithIndex(find_mode, found_sector, size, sectors_to_skip);
+  }
+
   // last_new_ is the sector that was last selected as the "new empty sector" to
   // write to. This last new sector is used as the starting point for the next
   // "find a new empty sector to write to" operation. By using the last new
@@ -90,6 +96,8 @@ Status Sectors::Find(FindMode find_mode,
   // Tier 2 is find sectors that are empty/erased. While scanning for a partial
   // sector, keep track of the first empty sector and if a second empty sector
   // was seen. If during GC then count the second empty sector as always seen.
+  // If erase counts are tracked, keep the least erased empty sector instead of
+  // the first.
   //
   // Tier 3 is during garbage collection, find sectors with enough space that
   // are not empty but have recoverable bytes. Pick the sector with the least
@@ -126,6 +134,10 @@ Status Sectors::Find(FindMode find_mode,
         first_empty_sector = sector;
       } else {
         at_least_two_empty_sectors = true;
+        if (tracks_erase_counts() &&
+            sector->erase_count() < first_empty_sector->erase_count()) {
+          first_empty_sector = sector;
+        }
       }
     }
   }
@@ -165,7 +177,7 @@ SectorDescriptor& Sectors::WearLeveledSectorFromIndex(size_t idx) const {
 // TODO: Consider breaking this function into smaller sub-chunks.
 SectorDescriptor* Sectors::FindSectorToGarbageCollect(
     std::span<const Address> reserved_addresses) const {
-  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  const size_t sector_size_bytes = sector_data_bytes();
   SectorDescriptor* sector_candidate = nullptr;
   size_t candidate_bytes = 0;
 
@@ -177,18 +189,28 @@ SectorDescriptor* Sectors::FindSectorToGarbageCollect(
   const std::span sectors_to_skip(temp_sectors_to_skip_,
                                   reserved_addresses.size());
 
+  if (has_index()) {
+    return FindSectorToGarbageCollectWithIndex(reserved_addresses.size());
+  }
+
   // Step 1: Try to find a sectors with stale keys and no valid keys (no
   // relocation needed). Use the first such sector found, as that will help the
   // KVS "rotate" around the partition. Initially this would select the sector
   // with the most reclaimable space, but that can cause GC sector selection to
-  // "ping-pong" between two sectors when updating large keys.
+  // "ping-pong" between two sectors when updating large keys. If erase counts
+  // are tracked, use the least erased such sector, which also rotates, since
+  // erasing a sector increases its count.
   for (size_t i = 0; i < descriptors_.size(); ++i) {
     SectorDescriptor& sector = WearLeveledSectorFromIndex(i);
     if ((sector.valid_bytes() == 0) &&
         (sector.RecoverableBytes(sector_size_bytes) > 0) &&
-        !Contains(sectors_to_skip, &sector)) {
+        !Contains(sectors_to_skip, &sector) &&
+        (sector_candidate == nullptr ||
+         sector.erase_count() < sector_candidate->erase_count())) {
       sector_candidate = &sector;
-      break;
+      if (!tracks_erase_counts()) {
+        break;
+      }
     }
   }
 
@@ -231,4 +253,270 @@ SectorDescriptor* Sectors::FindSectorToGarbageCollect(
   return sector_candidate;
 }
 
+SectorDescriptor* Sectors::FindSectorToWearLevel(
+    uint32_t threshold, std::span<const Address> reserved_addresses) const {
+  if (!tracks_erase_counts()) {
+    return nullptr;
+  }
+
+  const size_t sector_size_bytes = sector_data_bytes();
+  SectorDescriptor* least_erased = nullptr;
+
+  for (size_t i = 0; i < descriptors_.size(); ++i) {
+    SectorDescriptor& sector = WearLeveledSectorFromIndex(i);
+    if (sector.Empty(sector_size_bytes) ||
+        std::any_of(reserved_addresses.begin(),
+                    reserved_addresses.end(),
+                    [&](Address address) {
+                      return AddressInSector(sector, address);
+                    })) {
+      continue;
+    }
+    if (least_erased == nullptr ||
+        sector.erase_count() < least_erased->erase_count()) {
+      least_erased = &sector;
+    }
+  }
+
+  if (least_erased == nullptr ||
+      max_erase_count_ - least_erased->erase_count() <= threshold) {
+    return nullptr;
+  }
+
+  DBG("Found sector %u to wear level, %u erases behind",
+      Index(least_erased),
+      unsigned(max_erase_count_ - least_erased->erase_count()));
+  return least_erased;
+}
+
+// The indexed searches follow the same tiers and, by starting each search
+// after last_new_ and wrapping around, select the same sectors as the scans
+// above.
+Status Sectors::FindWithIndex(FindMode find_mode,
+                              SectorDescriptor** found_sector,
+                              size_t size,
+                              size_t sectors_to_skip) {
+  const size_t sector_size_bytes = sector_data_bytes();
+  const size_t start = WearLeveledStart();
+
+  for (size_t i = 0; i < sectors_to_skip; ++i) {
+    ExcludeFromIndex(*temp_sectors_to_skip_[i]);
+  }
+
+  // Tier 1: the first partially written sector with enough space. During GC,
+  // only sectors with no recoverable bytes are used.
+  size_t found = FindInIndex(
+      find_mode == kAppendEntry ? kPartialSpace : kCleanPartialSpace,
+      start,
+      size + 1);
+
+  // Tier 2: the first empty sector. Outside of GC, there must be a second
+  // empty sector, so that 1 remains after this one is used.
+  if (found == kNotFound) {
+    const size_t empty = tracks_erase_counts()
+                             ? FindLeastErasedInIndex(kEmptySector, start)
+                             : FindInIndex(kEmptySector, start, 1);
+    if (empty != kNotFound &&
+        (find_mode == kGarbageCollect ||
+         FindInIndex(kEmptySector, (empty + 1) % descriptors_.size(), 1) !=
+             empty)) {
+      DBG("  Found a usable empty sector; returning the first found (%u)",
+          unsigned(empty));
+      last_new_ = &descriptors_[empty];
+      found = empty;
+    }
+  }
+
+  for (size_t i = 0; i < sectors_to_skip; ++i) {
+    UpdateIndex(*temp_sectors_to_skip_[i]);
+  }
+
+  if (found != kNotFound) {
+    *found_sector = &descriptors_[found];
+    return OkStatus();
+  }
+
+  // Tier 3: during GC, the sector with enough space and the most recoverable
+  // bytes. This combines two values, which the index does not support, so the
+  // sectors are scanned. It is only reached during GC when no sector is
+  // clean or empty.
+  if (find_mode == kGarbageCollect) {
+    const std::span skip(temp_sectors_to_skip_, sectors_to_skip);
+    SectorDescriptor* candidate = nullptr;
+    for (size_t i = 0; i < descriptors_.size(); ++i) {
+      SectorDescriptor& sector = WearLeveledSectorFromIndex(i);
+      if (!sector.Empty(sector_size_bytes) && sector.HasSpace(size) &&
+          !Contains(skip, &sector) &&
+          (candidate == nullptr ||
+           candidate->RecoverableBytes(sector_size_bytes) <
+               sector.RecoverableBytes(sector_size_bytes))) {
+        candidate = &sector;
+      }
+    }
+
+    if (candidate != nullptr) {
+      *found_sector = candidate;
+      DBG("  Found a usable sector %u, with %u B recoverable, in GC",
+          Index(candidate),
+          unsigned(candidate->RecoverableBytes(sector_size_bytes)));
+      return OkStatus();
+    }
+  }
+
+  DBG("  Unable to find a usable sector");
+  *found_sector = nullptr;
+  return Status::ResourceExhausted();
+}
+
+SectorDescriptor* Sectors::FindSectorToGarbageCollectWithIndex(
+    size_t sectors_to_skip) const {
+  const size_t start = WearLeveledStart();
+
+  for (size_t i = 0; i < sectors_to_skip; ++i) {
+    ExcludeFromIndex(*temp_sectors_to_skip_[i]);
+  }
+
+  // Step 1: the first (or least erased) sector with stale entries and no valid
+  // entries.
+  size_t found = tracks_erase_counts()
+                     ? FindLeastErasedInIndex(kStaleSector, start)
+                     : FindInIndex(kStaleSector, start, 1);
+
+  // Step 2: the first sector with the most recoverable bytes.
+  if (found == kNotFound && IndexMax(kRecoverable) > 0u) {
+    found = FindInIndex(kRecoverable, start, IndexMax(kRecoverable));
+  }
+
+  // Step 3: the first sector with the most valid bytes.
+  if (found == kNotFound && IndexMax(kValid) > 0u) {
+    DBG("    Doing GC on sector with no reclaimable bytes!");
+    found = FindInIndex(kValid, start, IndexMax(kValid));
+  }
+
+  for (size_t i = 0; i < sectors_to_skip; ++i) {
+    UpdateIndex(*temp_sectors_to_skip_[i]);
+  }
+
+  if (found == kNotFound) {
+    DBG("Unable to find sector to garbage collect!");
+    return nullptr;
+  }
+
+  DBG("Found sector %u to Garbage Collect, %u recoverable bytes",
+      unsigned(found),
+      unsigned(descriptors_[found].RecoverableBytes(
+          sector_data_bytes())));
+  return &descriptors_[found];
+}
+
+void Sectors::UpdateIndex(const SectorDescriptor& sector) const {
+  if (!has_index()) {
+    return;
+  }
+
+  const size_t sector_size_bytes = sector_data_bytes();
+  const size_t i = Index(sector);
+  const bool empty = sector.Empty(sector_size_bytes);
+  const size_t recoverable = sector.RecoverableBytes(sector_size_bytes);
+  const IndexNode space = empty ? 0 : IndexNode(sector.writable_bytes() + 1);
+
+  SetIndexLeaf(kPartialSpace, i, space);
+  SetIndexLeaf(kCleanPartialSpace, i, recoverable == 0u ? space : 0);
+  SetIndexLeaf(kEmptySector, i, empty ? 1 : 0);
+  SetIndexLeaf(kStaleSector,
+               i,
+               sector.valid_bytes() == 0u && recoverable > 0u ? 1 : 0);
+  SetIndexLeaf(kRecoverable, i, IndexNode(recoverable));
+  SetIndexLeaf(kValid, i, IndexNode(sector.valid_bytes()));
+}
+
+void Sectors::ExcludeFromIndex(const SectorDescriptor& sector) const {
+  for (size_t tree = 0; tree < kIndexTrees; ++tree) {
+    SetIndexLeaf(IndexTree(tree), Index(sector), 0);
+  }
+}
+
+void Sectors::RebuildIndex() const {
+  static_assert(kValid + 1 == kIndexTrees);
+
+  if (!has_index()) {
+    return;
+  }
+
+  std::fill(index_.begin(), index_.end(), IndexNode(0));
+  for (const SectorDescriptor& sector : descriptors_) {
+    UpdateIndex(sector);
+  }
+}
+
+void Sectors::SetIndexLeaf(IndexTree tree,
+                           size_t sector,
+                           IndexNode value) const {
+  IndexNode* const nodes = IndexTreeNodes(tree);
+  size_t node = index_leaves_ + sector;
+  nodes[node] = value;
+
+  for (node /= 2; node > 0u; node /= 2) {
+    nodes[node] = std::max(nodes[2 * node], nodes[2 * node + 1]);
+  }
+}
+
+size_t Sectors::FindInIndex(IndexTree tree,
+                            size_t start,
+                            size_t min_value) const {
+  const size_t found = FindFirstInIndex(tree, start, min_value);
+  if (found != kNotFound || start == 0u) {
+    return found;
+  }
+  return FindFirstInIndex(tree, 0, min_value);
+}
+
+size_t Sectors::FindLeastErasedInIndex(IndexTree tree, size_t start) const {
+  // Visit each sector in the tree in wear leveling order, ending with the first
+  // one again.
+  const size_t first = FindInIndex(tree, start, 1);
+  size_t least_erased = first;
+
+  size_t sector = first;
+  while (sector != kNotFound) {
+    sector = FindInIndex(tree, (sector + 1) % descriptors_.size(), 1);
+    if (sector == first) {
+      break;
+    }
+    if (descriptors_[sector].erase_count() <
+        descriptors_[least_erased].erase_count()) {
+      least_erased = sector;
+    }
+  }
+  return least_erased;
+}
+
+size_t Sectors::FindFirstInIndex(IndexTree tree,
+                                 size_t first,
+                                 size_t min_value) const {
+  const IndexNode* const nodes = IndexTreeNodes(tree);
+  size_t node = index_leaves_ + first;
+
+  // Move up and right until reaching a subtree with a large enough value.
+  while (nodes[node] < min_value) {
+    // A right child's parent has no more subtrees to the right to check.
+    while (node % 2 == 1u) {
+      node /= 2;
+      if (node == 0u) {
+        return kNotFound;
+      }
+    }
+    node += 1;
+  }
+
+  // Descend to the leftmost leaf in the subtree with a large enough value.
+  while (node < index_leaves_) {
+    node *= 2;
+    if (nodes[node] < min_value) {
+      node += 1;
+    }
+  }
+  return node - index_leaves_;
+}
+
 }  // namespace pw::kvs::internal
@@ -75,12 +75,383 @@ TEST_F(SectorsTest, NextWritableAddress_EmptySector) {
 }
 
 TEST_F(SectorsTest, NextWritableAddress_PartiallyWrittenSector) {
-  sectors_.begin()->RemoveWritableBytes(123);
+  sectors_.RemoveWritableBytes(*sectors_.begin(), 123);
   EXPECT_EQ(123u, sectors_.NextWritableAddress(*sectors_.begin()));
 }
 
-// TODO: Add tests for FindSpace, FindSpaceDuringGarbageCollection, and
-// FindSectorToGarbageCollect.
+// Runs each find operation on two Sectors lists, one with an index and one
+// without, and checks that both select the same sector.
+class SectorsFindTest : public ::testing::Test {
+ protected:
+  using Address = Sectors::Address;
+
+  static constexpr size_t kSectorSize = 128;
+  static constexpr size_t kSectorCount = 16;
+  static constexpr size_t kHeaderBytes = 16;
+
+  SectorsFindTest()
+      : partition_(&flash_),
+        sectors_(descriptors_, partition_, skip_),
+        indexed_sectors_(
+            indexed_descriptors_, partition_, indexed_skip_, index_) {
+    sectors_.Reset();
+    indexed_sectors_.Reset();
+  }
+
+  SectorDescriptor& Sector(Sectors& sectors, size_t sector) {
+    return *(sectors.begin() + sector);
+  }
+
+  const SectorDescriptor& Sector(size_t sector) {
+    return Sector(sectors_, sector);
+  }
+
+  // Writes an entry of the given size to the sector.
+  void Write(size_t sector, uint16_t size) {
+    for (Sectors* sectors : {&sectors_, &indexed_sectors_}) {
+      sectors->RemoveWritableBytes(Sector(*sectors, sector), size);
+      sectors->AddValidBytes(Sector(*sectors, sector), size);
+    }
+  }
+
+  // Marks bytes of valid entries in the sector as stale.
+  void Invalidate(size_t sector, uint16_t size) {
+    for (Sectors* sectors : {&sectors_, &indexed_sectors_}) {
+      sectors->RemoveValidBytes(Sector(*sectors, sector), size);
+    }
+  }
+
+  void Erase(size_t sector) {
+    for (Sectors* sectors : {&sectors_, &indexed_sectors_}) {
+      SectorDescriptor& descriptor = Sector(*sectors, sector);
+      sectors->RemoveValidBytes(descriptor, kSectorSize);
+      sectors->set_writable_bytes(descriptor,
+                                  uint16_t(sectors->sector_data_bytes()));
+      if (sectors->tracks_erase_counts()) {
+        sectors->set_erase_count(descriptor, descriptor.erase_count() + 1);
+      }
+    }
+  }
+
+  void SetEraseCount(size_t sector, uint32_t erase_count) {
+    for (Sectors* sectors : {&sectors_, &indexed_sectors_}) {
+      sectors->set_erase_count(Sector(*sectors, sector), erase_count);
+    }
+  }
+
+  void ResetWithHeaders() {
+    sectors_.Reset(kHeaderBytes);
+    indexed_sectors_.Reset(kHeaderBytes);
+  }
+
+  void MarkCorrupt(size_t sector) {
+    for (Sectors* sectors : {&sectors_, &indexed_sectors_}) {
+      sectors->mark_corrupt(Sector(*sectors, sector));
+    }
+  }
+
+  void SetLastNew(size_t sector) {
+    sectors_.set_last_new_sector(sector * kSectorSize);
+    indexed_sectors_.set_last_new_sector(sector * kSectorSize);
+  }
+
+  // Returns the index of the sector found, or -1 if no sector was found.
+  int FindSpace(size_t size, std::span<const Address> reserved = {}) {
+    SectorDescriptor* found;
+    SectorDescriptor* indexed_found;
+    const Status status = sectors_.FindSpace(&found, size, reserved);
+    EXPECT_EQ(status,
+              indexed_sectors_.FindSpace(&indexed_found, size, reserved));
+    return Result(status, found, indexed_found);
+  }
+
+  int FindSpaceDuringGarbageCollection(
+      size_t size,
+      std::span<const Address> addresses_to_skip,
+      std::span<const Address> reserved = {}) {
+    SectorDescriptor* found;
+    SectorDescriptor* indexed_found;
+    const Status status = sectors_.FindSpaceDuringGarbageCollection(
+        &found, size, addresses_to_skip, reserved);
+    EXPECT_EQ(status,
+              indexed_sectors_.FindSpaceDuringGarbageCollection(
+                  &indexed_found, size, addresses_to_skip, reserved));
+    return Result(status, found, indexed_found);
+  }
+
+  int FindSectorToWearLevel(uint32_t threshold) {
+    const SectorDescriptor* found =
+        sectors_.FindSectorToWearLevel(threshold, {});
+    return found == nullptr ? -1 : int(sectors_.Index(found));
+  }
+
+  void RandomOperations(int iterations) {
+    uint32_t state = 0x12345678;
+    auto random = [&state](uint32_t range) {
+      state = state * 1664525u + 1013904223u;
+      return (state >> 8) % range;
+    };
+
+    for (int i = 0; i < iterations; ++i) {
+      const size_t sector = random(kSectorCount);
+      const SectorDescriptor& descriptor = Sector(sector);
+
+      switch (random(8)) {
+        case 0:
+        case 1:
+        case 2:
+          if (descriptor.writable_bytes() > 0u) {
+            Write(sector,
+                  uint16_t(1 + random(uint32_t(descriptor.writable_bytes()))));
+          }
+          break;
+        case 3:
+        case 4:
+          if (descriptor.valid_bytes() > 0u) {
+            Invalidate(
+                sector,
+                uint16_t(1 + random(uint32_t(descriptor.valid_bytes()))));
+          }
+          break;
+        case 5:
+          Erase(sector);
+          break;
+        case 6:
+          if (random(16) == 0u) {
+            MarkCorrupt(sector);
+          }
+          break;
+        case 7:
+          SetLastNew(sector);
+          break;
+      }
+
+      const size_t size = random(kSectorSize + 1);
+      const Address reserved[] = {Address(random(kSectorCount) * kSectorSize)};
+      const Address skip[] = {Address(random(kSectorCount) * kSectorSize),
+                              Address(random(kSectorCount) * kSectorSize)};
+
+      FindSpace(size);
+      FindSpace(size, reserved);
+      FindSpaceDuringGarbageCollection(size, skip);
+      FindSpaceDuringGarbageCollection(size, skip, reserved);
+      FindSectorToGarbageCollect();
+      FindSectorToGarbageCollect(reserved);
+    }
+  }
+
+  int FindSectorToGarbageCollect(std::span<const Address> reserved = {}) {
+    const SectorDescriptor* found =
+        sectors_.FindSectorToGarbageCollect(reserved);
+    const SectorDescriptor* indexed_found =
+        indexed_sectors_.FindSectorToGarbageCollect(reserved);
+    return Result(found == nullptr ? Status::NotFound() : OkStatus(),
+                  found,
+                  indexed_found);
+  }
+
+  FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash_;
+  FlashPartition partition_;
+
+  Vector<SectorDescriptor, kSectorCount> descriptors_;
+  const SectorDescriptor* skip_[3];
+  Sectors sectors_;
+
+  Vector<SectorDescriptor, kSectorCount> indexed_descriptors_;
+  const SectorDescriptor* indexed_skip_[3];
+  Sectors::IndexBuffer<kSectorCount> index_;
+  Sectors indexed_sectors_;
+
+ private:
+  int Result(Status status,
+             const SectorDescriptor* found,
+             const SectorDescriptor* indexed_found) {
+    EXPECT_EQ(sectors_.Index(sectors_.last_new()),
+              indexed_sectors_.Index(indexed_sectors_.last_new()));
+    if (!status.ok()) {
+      return -1;
+    }
+    EXPECT_EQ(sectors_.Index(found), indexed_sectors_.Index(indexed_found));
+    return sectors_.Index(found);
+  }
+};
+
+TEST_F(SectorsFindTest, HasIndex) {
+  EXPECT_FALSE(sectors_.has_index());
+  EXPECT_TRUE(indexed_sectors_.has_index());
+}
+
+TEST_F(SectorsFindTest, FindSpace_PrefersPartiallyWrittenSector) {
+  Write(3, 100);
+  Write(9, 10);
+
+  EXPECT_EQ(9, FindSpace(64));
+  EXPECT_EQ(3, FindSpace(28));
+}
+
+TEST_F(SectorsFindTest, FindSpace_RotatesThroughEmptySectors) {
+  SetLastNew(5);
+
+  EXPECT_EQ(6, FindSpace(32));
+  EXPECT_EQ(6u, sectors_.Index(sectors_.last_new()));
+  EXPECT_EQ(7, FindSpace(32));
+
+  SetLastNew(kSectorCount - 1);
+  EXPECT_EQ(0, FindSpace(32));
+}
+
+TEST_F(SectorsFindTest, FindSpace_KeepsOneEmptySector) {
+  for (size_t i = 0; i < kSectorCount; ++i) {
+    if (i != 9) {
+      Write(i, kSectorSize);
+    }
+  }
+
+  EXPECT_EQ(-1, FindSpace(16));
+  EXPECT_EQ(9, FindSpaceDuringGarbageCollection(16, {}));
+}
+
+TEST_F(SectorsFindTest, FindSpace_AvoidsReservedSectors) {
+  Write(2, 10);
+  Write(4, 10);
+  const Address reserved[] = {2 * kSectorSize + 10};
+
+  EXPECT_EQ(4, FindSpace(16, reserved));
+  EXPECT_EQ(2, FindSpace(16));
+}
+
+TEST_F(SectorsFindTest, FindSpaceDuringGarbageCollection_AvoidsStaleSectors) {
+  Write(2, 100);
+  Invalidate(2, 50);
+  Write(4, 100);
+
+  EXPECT_EQ(2, FindSpace(16));
+  EXPECT_EQ(4, FindSpaceDuringGarbageCollection(16, {}));
+
+  const Address skip[] = {4 * kSectorSize};
+  EXPECT_EQ(1, FindSpaceDuringGarbageCollection(16, skip));
+}
+
+TEST_F(SectorsFindTest,
+       FindSpaceDuringGarbageCollection_NoEmptySectorsUsesStaleSector) {
+  for (size_t i = 0; i < kSectorCount; ++i) {
+    Write(i, 64);
+    Invalidate(i, uint16_t(i + 1));
+  }
+
+  EXPECT_EQ(1, FindSpace(16));
+  EXPECT_NE(-1, FindSpaceDuringGarbageCollection(16, {}));
+  EXPECT_EQ(-1, FindSpaceDuringGarbageCollection(100, {}));
+}
+
+TEST_F(SectorsFindTest, FindSectorToGarbageCollect) {
+  EXPECT_EQ(-1, FindSectorToGarbageCollect());
+
+  // A sector with only valid bytes is selected if there is nothing better.
+  Write(2, 10);
+  Write(7, 30);
+  EXPECT_EQ(7, FindSectorToGarbageCollect());
+
+  // A sector with recoverable bytes is preferred.
+  Write(3, 100);
+  Invalidate(3, 20);
+  Write(5, 100);
+  Invalidate(5, 90);
+  EXPECT_EQ(5, FindSectorToGarbageCollect());
+
+  // A sector with recoverable bytes and no valid bytes is preferred.
+  Write(11, 10);
+  Invalidate(11, 10);
+  EXPECT_EQ(11, FindSectorToGarbageCollect());
+
+  const Address reserved[] = {11 * kSectorSize};
+  EXPECT_EQ(5, FindSectorToGarbageCollect(reserved));
+}
+
+TEST_F(SectorsFindTest, FindSectorToGarbageCollect_RotatesFromLastNew) {
+  Write(3, 10);
+  Invalidate(3, 10);
+  Write(12, 10);
+  Invalidate(12, 10);
+
+  SetLastNew(0);
+  EXPECT_EQ(3, FindSectorToGarbageCollect());
+  SetLastNew(3);
+  EXPECT_EQ(12, FindSectorToGarbageCollect());
+}
+
+TEST_F(SectorsFindTest, IndexMatchesScan_RandomOperations) {
+  RandomOperations(5000);
+}
+
+TEST_F(SectorsFindTest, EraseCounts_SectorDataBytes) {
+  EXPECT_FALSE(sectors_.tracks_erase_counts());
+  EXPECT_EQ(kSectorSize, sectors_.sector_data_bytes());
+
+  ResetWithHeaders();
+  EXPECT_TRUE(sectors_.tracks_erase_counts());
+  EXPECT_EQ(kHeaderBytes, sectors_.sector_header_bytes());
+  EXPECT_EQ(kSectorSize - kHeaderBytes, sectors_.sector_data_bytes());
+  EXPECT_TRUE(Sector(0).Empty(sectors_.sector_data_bytes()));
+  EXPECT_EQ(kHeaderBytes, sectors_.NextWritableAddress(Sector(0)));
+}
+
+TEST_F(SectorsFindTest, EraseCounts_FindSpacePrefersLeastErasedEmptySector) {
+  ResetWithHeaders();
+  for (size_t i = 0; i < kSectorCount; ++i) {
+    SetEraseCount(i, 10);
+  }
+  SetEraseCount(4, 3);
+  SetEraseCount(12, 3);
+
+  EXPECT_EQ(4, FindSpace(32));
+  EXPECT_EQ(12, FindSpace(32));
+
+  // Partially written sectors are still preferred over empty sectors.
+  Write(7, 16);
+  EXPECT_EQ(7, FindSpace(32));
+}
+
+TEST_F(SectorsFindTest, EraseCounts_GarbageCollectsLeastErasedStaleSector) {
+  ResetWithHeaders();
+  for (size_t i : {2, 6, 9}) {
+    Write(i, 16);
+    Invalidate(i, 16);
+    SetEraseCount(i, 5);
+  }
+  SetEraseCount(9, 1);
+
+  EXPECT_EQ(9, FindSectorToGarbageCollect());
+  Erase(9);
+  Erase(9);
+  Erase(9);
+  EXPECT_EQ(2, FindSectorToGarbageCollect());
+}
+
+TEST_F(SectorsFindTest, EraseCounts_FindSectorToWearLevel) {
+  EXPECT_EQ(-1, FindSectorToWearLevel(0));
+
+  ResetWithHeaders();
+  EXPECT_EQ(-1, FindSectorToWearLevel(0));
+
+  Write(3, 64);
+  Write(8, 64);
+  SetEraseCount(3, 2);
+  SetEraseCount(8, 4);
+  SetEraseCount(10, 20);  // empty sectors are not wear leveled
+
+  EXPECT_EQ(3, FindSectorToWearLevel(17));
+  EXPECT_EQ(-1, FindSectorToWearLevel(18));
+  EXPECT_EQ(20u, sectors_.max_erase_count());
+
+  const Address reserved[] = {3 * kSectorSize};
+  EXPECT_EQ(8u, sectors_.Index(sectors_.FindSectorToWearLevel(0, reserved)));
+}
+
+TEST_F(SectorsFindTest, EraseCounts_IndexMatchesScan_RandomOperations) {
+  ResetWithHeaders();
+  RandomOperations(5000);
+}
 
 }  // namespace
 }  // namespace pw::kvs::internal
@@ -0,0 +1,146 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "PW_FLASH"
+#define PW_LOG_LEVEL PW_KVS_LOG_LEVEL
+
+#include "pw_kvs/simulated_flash_memory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "pw_kvs_private/config.h"
+#include "pw_log/log.h"
+
+namespace pw::kvs {
+
+template <typename Visitor>
+void SimulatedFlashMemory::ForEachSector(Address address,
+                                         size_t size,
+                                         Visitor&& visitor) const {
+  while (size > 0u) {
+    const size_t index = address / sector_size_bytes();
+    const size_t offset = address % sector_size_bytes();
+    const size_t chunk = std::min(size, sector_size_bytes() - offset);
+
+    visitor(index, offset, chunk);
+
+    address += chunk;
+    size -= chunk;
+  }
+}
+
+Status SimulatedFlashMemory::Erase(Address address, size_t num_sectors) {
+  if (address % sector_size_bytes() != 0) {
+    PW_LOG_ERROR(
+        "Attempted to erase sector at non-sector aligned boundary; address %x",
+        unsigned(address));
+    return Status::InvalidArgument();
+  }
+  const size_t first_sector = address / sector_size_bytes();
+  if (first_sector + num_sectors > sector_count()) {
+    PW_LOG_ERROR(
+        "Tried to erase a sector at an address past flash end; address %x",
+        unsigned(address));
+    return Status::OutOfRange();
+  }
+
+  // Erased sectors are not stored. Snapshots that share a sector keep it.
+  std::fill_n(sectors_.begin() + first_sector, num_sectors, nullptr);
+  return OkStatus();
+}
+
+StatusWithSize SimulatedFlashMemory::Read(Address address,
+                                          std::span<std::byte> output) {
+  if (address + output.size() > size_bytes()) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  std::byte* destination = output.data();
+  ForEachSector(
+      address, output.size(), [&](size_t index, size_t offset, size_t size) {
+        if (sectors_[index] == nullptr) {
+          std::memset(destination, int(kErasedValue), size);
+        } else {
+          std::memcpy(destination, &sectors_[index][offset], size);
+        }
+        destination += size;
+      });
+  return StatusWithSize(output.size());
+}
+
+StatusWithSize SimulatedFlashMemory::Write(Address address,
+                                           std::span<const std::byte> data) {
+  if (address % alignment_bytes() != 0 ||
+      data.size() % alignment_bytes() != 0) {
+    PW_LOG_ERROR("Unaligned write; address %x, size %u B, alignment %u",
+                 unsigned(address),
+                 unsigned(data.size()),
+                 unsigned(alignment_bytes()));
+    return StatusWithSize::InvalidArgument();
+  }
+
+  if (address + data.size() > size_bytes()) {
+    PW_LOG_ERROR("Write beyond end of memory; address %x, size %u B",
+                 unsigned(address),
+                 unsigned(data.size()));
+    return StatusWithSize::OutOfRange();
+  }
+
+  // Check the whole range before writing so that a failed write has no effect.
+  bool erased = true;
+  ForEachSector(
+      address, data.size(), [&](size_t index, size_t offset, size_t size) {
+        if (erased && sectors_[index] != nullptr) {
+          erased = AppearsErased(std::span(&sectors_[index][offset], size));
+        }
+      });
+  if (!erased) {
+    PW_LOG_ERROR("Writing to previously written address: %x",
+                 unsigned(address));
+    return StatusWithSize::Unknown();
+  }
+
+  const std::byte* source = data.data();
+  ForEachSector(
+      address, data.size(), [&](size_t index, size_t offset, size_t size) {
+        std::memcpy(WritableSector(index) + offset, source, size);
+        source += size;
+      });
+  return StatusWithSize(data.size());
+}
+
+size_t SimulatedFlashMemory::allocated_sectors() const {
+  return std::count_if(sectors_.begin(),
+                       sectors_.end(),
+                       [](const Sector& sector) { return sector != nullptr; });
+}
+
+std::byte* SimulatedFlashMemory::WritableSector(size_t index) {
+  Sector& sector = sectors_[index];
+
+  if (sector == nullptr) {
+    sector.reset(new std::byte[sector_size_bytes()]);
+    std::memset(sector.get(), int(kErasedValue), sector_size_bytes());
+  } else if (sector.use_count() > 1) {
+    // Shared with a snapshot; copy it before writing.
+    Sector copy(new std::byte[sector_size_bytes()]);
+    std::memcpy(copy.get(), sector.get(), sector_size_bytes());
+    sector = std::move(copy);
+  }
+  return sector.get();
+}
+
+}  // namespace pw::kvs
@@ -0,0 +1,140 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_kvs/simulated_flash_memory.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr std::byte kErased = SimulatedFlashMemory::kErasedValue;
+constexpr size_t kSectorSize = 64;
+
+constexpr std::array<std::byte, 8> kData = {
+    std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4},
+    std::byte{5}, std::byte{6}, std::byte{7}, std::byte{8}};
+
+class SimulatedFlashTest : public ::testing::Test {
+ protected:
+  SimulatedFlashTest() : flash_(kSectorSize, 4, 4) {}
+
+  std::array<std::byte, kData.size()> ReadData(SimulatedFlashMemory& flash,
+                                               FlashMemory::Address address) {
+    std::array<std::byte, kData.size()> data;
+    EXPECT_EQ(OkStatus(), flash.Read(address, data).status());
+    return data;
+  }
+
+  SimulatedFlashMemory flash_;
+};
+
+TEST_F(SimulatedFlashTest, StartsErased) {
+  std::array<std::byte, 4 * kSectorSize> contents;
+  ASSERT_EQ(OkStatus(), flash_.Read(0, contents).status());
+  EXPECT_TRUE(flash_.AppearsErased(contents));
+  EXPECT_EQ(0u, flash_.allocated_sectors());
+}
+
+TEST_F(SimulatedFlashTest, Write_AcrossSectors) {
+  ASSERT_EQ(OkStatus(), flash_.Write(kSectorSize - 4, kData).status());
+  EXPECT_EQ(kData, ReadData(flash_, kSectorSize - 4));
+  EXPECT_EQ(2u, flash_.allocated_sectors());
+}
+
+TEST_F(SimulatedFlashTest, Write_NotErased_Fails) {
+  ASSERT_EQ(OkStatus(), flash_.Write(kSectorSize, kData).status());
+
+  std::array<std::byte, 2 * kData.size()> overlapping;
+  overlapping.fill(std::byte{0});
+  EXPECT_EQ(Status::Unknown(),
+            flash_.Write(kSectorSize - kData.size(), overlapping).status());
+
+  // A failed write has no effect.
+  EXPECT_EQ(kData, ReadData(flash_, kSectorSize));
+  std::array<std::byte, kData.size()> erased;
+  erased.fill(kErased);
+  EXPECT_EQ(erased, ReadData(flash_, kSectorSize - kData.size()));
+}
+
+TEST_F(SimulatedFlashTest, Write_Invalid) {
+  EXPECT_EQ(Status::InvalidArgument(), flash_.Write(2, kData).status());
+  EXPECT_EQ(Status::InvalidArgument(),
+            flash_.Write(0, std::span(kData).first(3)).status());
+  EXPECT_EQ(Status::OutOfRange(),
+            flash_.Write(4 * kSectorSize - 4, kData).status());
+}
+
+TEST_F(SimulatedFlashTest, Erase_FreesSectors) {
+  ASSERT_EQ(OkStatus(), flash_.Write(0, kData).status());
+  ASSERT_EQ(OkStatus(), flash_.Write(3 * kSectorSize, kData).status());
+  EXPECT_EQ(2u, flash_.allocated_sectors());
+
+  ASSERT_EQ(OkStatus(), flash_.Erase(0, 1));
+  EXPECT_EQ(1u, flash_.allocated_sectors());
+  EXPECT_EQ(OkStatus(), flash_.Write(0, kData).status());
+
+  EXPECT_EQ(Status::InvalidArgument(), flash_.Erase(1, 1));
+  EXPECT_EQ(Status::OutOfRange(), flash_.Erase(3 * kSectorSize, 2));
+}
+
+TEST_F(SimulatedFlashTest, Snapshot_CopyOnWrite) {
+  ASSERT_EQ(OkStatus(), flash_.Write(0, kData).status());
+
+  SimulatedFlashMemory snapshot = flash_.Snapshot();
+  EXPECT_EQ(kData, ReadData(snapshot, 0));
+
+  // Writing to a shared sector copies it.
+  ASSERT_EQ(OkStatus(), snapshot.Write(kData.size(), kData).status());
+  EXPECT_EQ(kData, ReadData(snapshot, kData.size()));
+  std::array<std::byte, kData.size()> erased;
+  erased.fill(kErased);
+  EXPECT_EQ(erased, ReadData(flash_, kData.size()));
+
+  // Erasing the original does not affect the snapshot.
+  ASSERT_EQ(OkStatus(), flash_.Erase(0, 1));
+  EXPECT_EQ(erased, ReadData(flash_, 0));
+  EXPECT_EQ(kData, ReadData(snapshot, 0));
+}
+
+TEST_F(SimulatedFlashTest, Snapshot_ForksKeyValueStore) {
+  ChecksumCrc16 checksum;
+  const EntryFormat kFormat{.magic = 0x2925d4a1, .checksum = &checksum};
+
+  FlashPartition partition(&flash_);
+  KeyValueStoreBuffer<8, 4> kvs(&partition, kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  ASSERT_EQ(OkStatus(), kvs.Put("key", uint32_t(1)));
+
+  SimulatedFlashMemory snapshot = flash_.Snapshot();
+  FlashPartition snapshot_partition(&snapshot);
+  KeyValueStoreBuffer<8, 4> forked_kvs(&snapshot_partition, kFormat);
+  ASSERT_EQ(OkStatus(), forked_kvs.Init());
+  ASSERT_EQ(OkStatus(), forked_kvs.Put("key", uint32_t(2)));
+
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), forked_kvs.Get("key", &value));
+  EXPECT_EQ(2u, value);
+  ASSERT_EQ(OkStatus(), kvs.Get("key", &value));
+  EXPECT_EQ(1u, value);
+}
+
+}  // namespace
+}  // namespace pw::kvs
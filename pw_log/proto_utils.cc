@@ -14,10 +14,16 @@
 
 #include "pw_log/proto_utils.h"
 
+#include <cstring>
+
+#include "pw_bytes/endian.h"
 #include "pw_log/levels.h"
 #include "pw_log/proto/log.pwpb.h"
+#include "pw_log_tokenized/config.h"
 #include "pw_log_tokenized/metadata.h"
 #include "pw_protobuf/wire_format.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
 
 namespace pw::log {
 
@@ -46,4 +52,75 @@ Result<ConstByteSpan> EncodeTokenizedLog(pw::log_tokenized::Metadata metadata,
   return ConstByteSpan(encoder);
 }
 
+static_assert(PW_LOG_TOKENIZED_LEVEL_BITS + PW_LOG_TOKENIZED_LINE_BITS +
+                      PW_LOG_TOKENIZED_FLAG_BITS +
+                      PW_LOG_TOKENIZED_MODULE_BITS <=
+                  32,
+              "Compact log records store the metadata in 32 bits");
+
+Result<ConstByteSpan> EncodeCompactTokenizedLog(
+    log_tokenized::Metadata metadata,
+    ConstByteSpan tokenized_data,
+    int64_t ticks_since_epoch,
+    ByteSpan encode_buffer) {
+  constexpr size_t kMetadataSize = sizeof(uint32_t);
+  if (encode_buffer.size() < 1 + kMetadataSize) {
+    return Status::ResourceExhausted();
+  }
+
+  encode_buffer[0] = kCompactTokenizedLogMarker;
+  const auto metadata_bytes = bytes::CopyInOrder(
+      std::endian::little, static_cast<uint32_t>(metadata.value()));
+  std::memcpy(&encode_buffer[1], metadata_bytes.data(), kMetadataSize);
+  size_t size = 1 + kMetadataSize;
+
+  const size_t timestamp_size =
+      varint::Encode(ticks_since_epoch, encode_buffer.subspan(size));
+  if (timestamp_size == 0u ||
+      tokenized_data.size() > encode_buffer.size() - size - timestamp_size) {
+    return Status::ResourceExhausted();
+  }
+  size += timestamp_size;
+
+  std::memcpy(
+      &encode_buffer[size], tokenized_data.data(), tokenized_data.size());
+  return ConstByteSpan(encode_buffer.first(size + tokenized_data.size()));
+}
+
+Result<CompactTokenizedLog> DecodeCompactTokenizedLog(ConstByteSpan entry) {
+  if (!IsCompactTokenizedLog(entry)) {
+    return Status::InvalidArgument();
+  }
+
+  constexpr size_t kMetadataSize = sizeof(uint32_t);
+  if (entry.size() < 1 + kMetadataSize) {
+    return Status::DataLoss();
+  }
+  const uint32_t metadata =
+      bytes::ReadInOrder<uint32_t>(std::endian::little, &entry[1]);
+
+  int64_t ticks_since_epoch;
+  const size_t timestamp_size =
+      varint::Decode(entry.subspan(1 + kMetadataSize), &ticks_since_epoch);
+  if (timestamp_size == 0u) {
+    return Status::DataLoss();
+  }
+
+  return CompactTokenizedLog{
+      .metadata = log_tokenized::Metadata(metadata),
+      .ticks_since_epoch = ticks_since_epoch,
+      .tokenized_data = entry.subspan(1 + kMetadataSize + timestamp_size),
+  };
+}
+
+Result<ConstByteSpan> ExpandCompactTokenizedLog(ConstByteSpan entry,
+                                                ByteSpan encode_buffer) {
+  PW_TRY_ASSIGN(const CompactTokenizedLog log,
+                DecodeCompactTokenizedLog(entry));
+  return EncodeTokenizedLog(log.metadata,
+                            log.tokenized_data,
+                            log.ticks_since_epoch,
+                            encode_buffer);
+}
+
 }  // namespace pw::log
@@ -110,4 +110,99 @@ TEST(UtilsTest, EncodeTokenizedLog_InsufficientSpace) {
   EXPECT_TRUE(result.status().IsResourceExhausted());
 }
 
+TEST(UtilsTest, CompactTokenizedLog_RoundTrips) {
+  constexpr std::byte kTokenizedData[] = {
+      std::byte{0x01}, std::byte{0x02}, std::byte{0x03}};
+  constexpr int64_t kExpectedTimestamp = -12345;
+  std::byte encode_buffer[32];
+
+  pw::log_tokenized::Metadata metadata =
+      pw::log_tokenized::Metadata::Set<1, 2, 3, 4>();
+
+  Result<ConstByteSpan> result = EncodeCompactTokenizedLog(
+      metadata, kTokenizedData, kExpectedTimestamp, encode_buffer);
+  ASSERT_TRUE(result.ok());
+  EXPECT_TRUE(IsCompactTokenizedLog(result.value()));
+  EXPECT_LE(result.value().size(),
+            kMaxCompactTokenizedLogHeaderSize + sizeof(kTokenizedData));
+
+  Result<CompactTokenizedLog> log = DecodeCompactTokenizedLog(result.value());
+  ASSERT_TRUE(log.ok());
+  EXPECT_EQ(metadata.value(), log.value().metadata.value());
+  EXPECT_EQ(kExpectedTimestamp, log.value().ticks_since_epoch);
+  ASSERT_EQ(sizeof(kTokenizedData), log.value().tokenized_data.size());
+  EXPECT_EQ(0,
+            std::memcmp(kTokenizedData,
+                        log.value().tokenized_data.data(),
+                        sizeof(kTokenizedData)));
+}
+
+TEST(UtilsTest, ExpandCompactTokenizedLog_MatchesEncodeTokenizedLog) {
+  constexpr std::byte kTokenizedData[1] = {(std::byte)0x01};
+  constexpr int64_t kExpectedTimestamp = 1;
+  std::byte compact_buffer[32];
+  std::byte expanded_buffer[32];
+  std::byte encode_buffer[32];
+
+  pw::log_tokenized::Metadata metadata =
+      pw::log_tokenized::Metadata::Set<1, 2, 3, 4>();
+
+  Result<ConstByteSpan> compact = EncodeCompactTokenizedLog(
+      metadata, kTokenizedData, kExpectedTimestamp, compact_buffer);
+  ASSERT_TRUE(compact.ok());
+  Result<ConstByteSpan> expanded =
+      ExpandCompactTokenizedLog(compact.value(), expanded_buffer);
+  ASSERT_TRUE(expanded.ok());
+  EXPECT_FALSE(IsCompactTokenizedLog(expanded.value()));
+
+  Result<ConstByteSpan> encoded = EncodeTokenizedLog(
+      metadata, kTokenizedData, kExpectedTimestamp, encode_buffer);
+  ASSERT_TRUE(encoded.ok());
+  ASSERT_EQ(encoded.value().size(), expanded.value().size());
+  EXPECT_EQ(0,
+            std::memcmp(encoded.value().data(),
+                        expanded.value().data(),
+                        encoded.value().size()));
+
+  pw::protobuf::Decoder log_decoder(expanded.value());
+  VerifyLogEntry(log_decoder, metadata, kTokenizedData, kExpectedTimestamp);
+}
+
+TEST(UtilsTest, EncodeCompactTokenizedLog_InsufficientSpace) {
+  constexpr std::byte kTokenizedData[4] = {};
+  std::byte encode_buffer[8];
+
+  pw::log_tokenized::Metadata metadata =
+      pw::log_tokenized::Metadata::Set<1, 2, 3, 4>();
+
+  EXPECT_TRUE(EncodeCompactTokenizedLog(metadata, kTokenizedData, 1, {})
+                  .status()
+                  .IsResourceExhausted());
+  EXPECT_TRUE(
+      EncodeCompactTokenizedLog(metadata, kTokenizedData, 1, encode_buffer)
+          .status()
+          .IsResourceExhausted());
+}
+
+TEST(UtilsTest, DecodeCompactTokenizedLog_Invalid) {
+  std::byte encode_buffer[32];
+  pw::log_tokenized::Metadata metadata =
+      pw::log_tokenized::Metadata::Set<1, 2, 3, 4>();
+
+  Result<ConstByteSpan> encoded =
+      EncodeTokenizedLog(metadata, ConstByteSpan(), 1, encode_buffer);
+  ASSERT_TRUE(encoded.ok());
+  EXPECT_TRUE(DecodeCompactTokenizedLog(encoded.value())
+                  .status()
+                  .IsInvalidArgument());
+  EXPECT_TRUE(DecodeCompactTokenizedLog({}).status().IsInvalidArgument());
+
+  Result<ConstByteSpan> compact =
+      EncodeCompactTokenizedLog(metadata, ConstByteSpan(), 1, encode_buffer);
+  ASSERT_TRUE(compact.ok());
+  EXPECT_TRUE(DecodeCompactTokenizedLog(compact.value().first(3))
+                  .status()
+                  .IsDataLoss());
+}
+
 }  // namespace pw::log
@@ -13,6 +13,9 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "pw_bytes/span.h"
 #include "pw_log_tokenized/metadata.h"
 #include "pw_result/result.h"
@@ -44,4 +47,79 @@ inline Result<ConstByteSpan> EncodeTokenizedLog(
       encode_buffer);
 }
 
+// Compact tokenized log records carry the packed log_tokenized::Metadata word
+// as it is, instead of a LogEntry proto. They are cheaper to encode on each
+// log, and consumers such as RpcLogDrain expand them to LogEntry protos when
+// they are sent. A MultiSink may hold both compact records and LogEntry
+// protos. A compact record is:
+//
+//   kCompactTokenizedLogMarker
+//   metadata: uint32_t, little endian
+//   ticks_since_epoch: ZigZag varint
+//   tokenized data: the rest of the record
+//
+// The marker is a field key with field number 0 and wire type 7, which no
+// encoded LogEntry starts with.
+inline constexpr std::byte kCompactTokenizedLogMarker{0x07};
+
+// Largest size of a compact record, excluding its tokenized data.
+inline constexpr size_t kMaxCompactTokenizedLogHeaderSize =
+    1 + sizeof(uint32_t) + 10;
+
+struct CompactTokenizedLog {
+  log_tokenized::Metadata metadata;
+  int64_t ticks_since_epoch;
+  ConstByteSpan tokenized_data;
+};
+
+// Encodes a compact tokenized log record.
+//
+// Return values:
+// Ok - A byte span containing the encoded record.
+// ResourceExhausted - The provided buffer was not large enough to store the
+// record.
+Result<ConstByteSpan> EncodeCompactTokenizedLog(
+    log_tokenized::Metadata metadata,
+    ConstByteSpan tokenized_data,
+    int64_t ticks_since_epoch,
+    ByteSpan encode_buffer);
+
+inline Result<ConstByteSpan> EncodeCompactTokenizedLog(
+    log_tokenized::Metadata metadata,
+    const uint8_t* tokenized_data,
+    size_t tokenized_data_size,
+    int64_t ticks_since_epoch,
+    ByteSpan encode_buffer) {
+  return EncodeCompactTokenizedLog(
+      metadata,
+      std::as_bytes(std::span(tokenized_data, tokenized_data_size)),
+      ticks_since_epoch,
+      encode_buffer);
+}
+
+// True if the entry is a compact record rather than a LogEntry proto.
+constexpr bool IsCompactTokenizedLog(ConstByteSpan entry) {
+  return !entry.empty() && entry[0] == kCompactTokenizedLogMarker;
+}
+
+// Decodes a compact tokenized log record. The tokenized data refers to the
+// record.
+//
+// Return values:
+// Ok - The decoded record.
+// InvalidArgument - The entry is not a compact record.
+// DataLoss - The record is truncated.
+Result<CompactTokenizedLog> DecodeCompactTokenizedLog(ConstByteSpan entry);
+
+// Expands a compact tokenized log record to the LogEntry proto that
+// EncodeTokenizedLog would have produced for it.
+//
+// Return values:
+// Ok - A byte span containing the encoded log proto.
+// InvalidArgument, DataLoss - See DecodeCompactTokenizedLog.
+// ResourceExhausted - The provided buffer was not large enough to store the
+// proto.
+Result<ConstByteSpan> ExpandCompactTokenizedLog(ConstByteSpan entry,
+                                                ByteSpan encode_buffer);
+
 }  // namespace pw::log
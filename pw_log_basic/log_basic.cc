@@ -12,14 +12,19 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
-// This is a very basic direct output log implementation with no buffering.
+// This is a very basic direct output log implementation with optional
+// buffering.
 
 #include "pw_log_basic/log_basic.h"
 
+#include <cstdarg>
+#include <cstdlib>
 #include <cstring>
+#include <span>
 
 #include "pw_log/levels.h"
 #include "pw_log_basic_private/config.h"
+#include "pw_string/fast_format.h"
 #include "pw_string/string_builder.h"
 #include "pw_sys_io/sys_io.h"
 
@@ -83,32 +88,60 @@ const char* GetFileBasename(const char* filename) {
 }
 #endif  // PW_LOG_SHOW_FILENAME
 
-void (*write_log)(std::string_view) = [](std::string_view log) {
+// Each log line is formatted into a buffer of this size, including the null
+// terminator. Longer lines are truncated.
+constexpr size_t kLineBufferSize = 150;
+
+void WriteToSysIo(std::string_view log) {
   sys_io::WriteLine(log)
       .IgnoreError();  // TODO(pwbug/387): Handle Status properly
-};
+}
 
-}  // namespace
+void (*write_log)(std::string_view) = WriteToSysIo;
 
-// This is a fully loaded, inefficient-at-the-callsite, log implementation.
-extern "C" void pw_Log(int level,
-                       unsigned int flags,
-                       const char* module_name,
-                       const char* file_name,
-                       int line_number,
-                       const char* function_name,
-                       const char* message,
-                       ...) {
-  // Accumulate the log message in this buffer, then output it.
-  pw::StringBuffer<150> buffer;
+#if PW_LOG_BASIC_BUFFERED_OUTPUT
 
+static_assert(PW_LOG_BASIC_OUTPUT_BUFFER_SIZE >= kLineBufferSize,
+              "PW_LOG_BASIC_OUTPUT_BUFFER_SIZE must fit at least one line");
+static_assert(sizeof(PW_LOG_BASIC_LINE_ENDING) == 2u,
+              "PW_LOG_BASIC_LINE_ENDING must be one character, since it "
+              "replaces each line's null terminator");
+
+// Lines are formatted directly into this buffer, which is written to pw_sys_io
+// when a line might not fit.
+char output_buffer[PW_LOG_BASIC_OUTPUT_BUFFER_SIZE];
+size_t output_size = 0;
+bool flush_at_exit_registered = false;
+
+void FlushOutput() {
+  if (output_size != 0u) {
+    sys_io::WriteBytes(std::as_bytes(std::span(output_buffer, output_size)))
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    output_size = 0;
+  }
+}
+
+#endif  // PW_LOG_BASIC_BUFFERED_OUTPUT
+
+void FormatLog(StringBuilder& buffer,
+               int level,
+               unsigned int flags,
+               const char* module_name,
+               const char* file_name,
+               int line_number,
+               const char* function_name,
+               const char* message,
+               va_list args) {
   // Column: Timestamp
   // Note that this macro method defaults to a no-op.
   PW_LOG_APPEND_TIMESTAMP(buffer);
 
   // Column: Filename
 #if PW_LOG_SHOW_FILENAME
-  buffer.Format(" %-30s:%4d |", GetFileBasename(file_name), line_number);
+  pw::string::FastFormat(buffer,
+                         PW_FORMAT_STRING(" %-30s:%4d |"),
+                         GetFileBasename(file_name),
+                         line_number);
 #else
   static_cast<void>(file_name);
   static_cast<void>(line_number);
@@ -116,7 +149,8 @@ extern "C" void pw_Log(int level,
 
   // Column: Function
 #if PW_LOG_SHOW_FUNCTION
-  buffer.Format(" %20s |", function_name);
+  pw::string::FastFormat(
+      buffer, PW_FORMAT_STRING(" %20s |"), function_name);
 #else
   static_cast<void>(function_name);
 #endif
@@ -124,7 +158,7 @@ extern "C" void pw_Log(int level,
   // Column: Module
 #if PW_LOG_SHOW_MODULE
   buffer << " " BOLD;
-  buffer.Format("%3s", module_name);
+  pw::string::FastFormat(buffer, PW_FORMAT_STRING("%3s"), module_name);
   buffer << RESET " ";
 #else
   static_cast<void>(module_name);
@@ -146,9 +180,93 @@ extern "C" void pw_Log(int level,
   buffer << LogLevelToLogLevelName(level) << "  ";
 
   // Column: Message
+  buffer.FormatVaList(message, args);
+}
+
+#if PW_LOG_BASIC_BUFFERED_OUTPUT
+
+// Formats a log line at the end of the output buffer, so that it is only
+// formatted and copied once.
+void BufferLog(int level,
+               unsigned int flags,
+               const char* module_name,
+               const char* file_name,
+               int line_number,
+               const char* function_name,
+               const char* message,
+               va_list args) {
+  if (!flush_at_exit_registered) {
+    flush_at_exit_registered = true;
+    std::atexit(FlushOutput);
+  }
+
+  if (sizeof(output_buffer) - output_size < kLineBufferSize) {
+    FlushOutput();
+  }
+
+  StringBuilder buffer(
+      std::span<char>(output_buffer).subspan(output_size, kLineBufferSize));
+  FormatLog(buffer,
+            level,
+            flags,
+            module_name,
+            file_name,
+            line_number,
+            function_name,
+            message,
+            args);
+
+  // Replace the null terminator with the line ending.
+  output_buffer[output_size + buffer.size()] = PW_LOG_BASIC_LINE_ENDING[0];
+  output_size += buffer.size() + 1;
+
+  if (level >= PW_LOG_LEVEL_ERROR) {
+    FlushOutput();
+  }
+}
+
+#endif  // PW_LOG_BASIC_BUFFERED_OUTPUT
+
+}  // namespace
+
+// This is a fully loaded, inefficient-at-the-callsite, log implementation.
+extern "C" void pw_Log(int level,
+                       unsigned int flags,
+                       const char* module_name,
+                       const char* file_name,
+                       int line_number,
+                       const char* function_name,
+                       const char* message,
+                       ...) {
   va_list args;
   va_start(args, message);
-  buffer.FormatVaList(message, args);
+
+#if PW_LOG_BASIC_BUFFERED_OUTPUT
+  if (write_log == WriteToSysIo) {
+    BufferLog(level,
+              flags,
+              module_name,
+              file_name,
+              line_number,
+              function_name,
+              message,
+              args);
+    va_end(args);
+    return;
+  }
+#endif  // PW_LOG_BASIC_BUFFERED_OUTPUT
+
+  // Accumulate the log message in this buffer, then output it.
+  pw::StringBuffer<kLineBufferSize> buffer;
+  FormatLog(buffer,
+            level,
+            flags,
+            module_name,
+            file_name,
+            line_number,
+            function_name,
+            message,
+            args);
   va_end(args);
 
   // All done; flush the log.
@@ -156,7 +274,14 @@ extern "C" void pw_Log(int level,
 }
 
 void SetOutput(void (*log_output)(std::string_view log)) {
+  Flush();
   write_log = log_output;
 }
 
+void Flush() {
+#if PW_LOG_BASIC_BUFFERED_OUTPUT
+  FlushOutput();
+#endif  // PW_LOG_BASIC_BUFFERED_OUTPUT
+}
+
 }  // namespace pw::log_basic
@@ -60,6 +60,10 @@ namespace pw::log_basic {
 // pw::sys_io::WriteLine.
 void SetOutput(void (*log_output)(std::string_view log));
 
+// Writes any log lines buffered by PW_LOG_BASIC_BUFFERED_OUTPUT to pw_sys_io.
+// Does nothing if buffered output is disabled.
+void Flush();
+
 }  // namespace pw::log_basic
 
 #endif  // __cplusplus
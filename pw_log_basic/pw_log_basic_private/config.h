@@ -67,3 +67,29 @@
   do {                                  \
   } while (0)
 #endif  // PW_LOG_APPEND_TIMESTAMP
+
+// If enabled, log lines are formatted directly into an output buffer and
+// written to pw_sys_io in batches, rather than one pw_sys_io::WriteLine call
+// per message. This greatly reduces the cost of logging when writes to
+// pw_sys_io are expensive, such as in host simulations that log heavily.
+//
+// Buffered lines are written when the buffer is full, when a message at
+// PW_LOG_LEVEL_ERROR or above is logged, when pw::log_basic::Flush() is
+// called, and at exit. Buffered output is not synchronized, so it should only
+// be used in single-threaded programs. It only applies to the default output;
+// logs sent to a function set with pw::log_basic::SetOutput are not buffered.
+#ifndef PW_LOG_BASIC_BUFFERED_OUTPUT
+#define PW_LOG_BASIC_BUFFERED_OUTPUT 0
+#endif  // PW_LOG_BASIC_BUFFERED_OUTPUT
+
+// The size of the buffer used by PW_LOG_BASIC_BUFFERED_OUTPUT, in bytes. This
+// must be large enough for at least one full log line (150 bytes).
+#ifndef PW_LOG_BASIC_OUTPUT_BUFFER_SIZE
+#define PW_LOG_BASIC_OUTPUT_BUFFER_SIZE 4096
+#endif  // PW_LOG_BASIC_OUTPUT_BUFFER_SIZE
+
+// The line ending written after each buffered log line. This must be a single
+// character. Unbuffered output uses the line ending of pw_sys_io::WriteLine.
+#ifndef PW_LOG_BASIC_LINE_ENDING
+#define PW_LOG_BASIC_LINE_ENDING "\n"
+#endif  // PW_LOG_BASIC_LINE_ENDING
@@ -0,0 +1,150 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/filter_service.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "pw_log/proto/log.pwpb.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_status/try.h"
+
+namespace pw::log_rpc {
+namespace {
+
+uint8_t ClampLevel(uint32_t level) {
+  return static_cast<uint8_t>(
+      std::min<uint32_t>(level, std::numeric_limits<uint8_t>::max()));
+}
+
+Status DecodeRule(ConstByteSpan encoded_rule, LogFilter::Rule& rule) {
+  rule = LogFilter::Rule{};
+  protobuf::Decoder decoder(encoded_rule);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    uint32_t value;
+    switch (static_cast<log::FilterRule::Fields>(decoder.FieldNumber())) {
+      case log::FilterRule::Fields::MODULE:
+        PW_TRY(decoder.ReadUint32(&value));
+        rule.module = value;
+        break;
+      case log::FilterRule::Fields::TOKEN:
+        PW_TRY(decoder.ReadUint32(&value));
+        rule.token = value;
+        break;
+      case log::FilterRule::Fields::MIN_LEVEL:
+        PW_TRY(decoder.ReadUint32(&value));
+        rule.min_level = ClampLevel(value);
+        break;
+    }
+  }
+  return status.IsOutOfRange() ? OkStatus() : Status::DataLoss();
+}
+
+// Decodes a log::Filter, calling on_rule(const LogFilter::Rule&) for each rule.
+template <typename OnRule>
+Status DecodeFilter(ConstByteSpan request,
+                    uint8_t& default_min_level,
+                    OnRule&& on_rule) {
+  default_min_level = 0;
+  protobuf::Decoder decoder(request);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (static_cast<log::Filter::Fields>(decoder.FieldNumber())) {
+      case log::Filter::Fields::DEFAULT_MIN_LEVEL: {
+        uint32_t level;
+        PW_TRY(decoder.ReadUint32(&level));
+        default_min_level = ClampLevel(level);
+        break;
+      }
+      case log::Filter::Fields::RULES: {
+        ConstByteSpan encoded_rule;
+        PW_TRY(decoder.ReadBytes(&encoded_rule));
+        LogFilter::Rule rule;
+        PW_TRY(DecodeRule(encoded_rule, rule));
+        PW_TRY(on_rule(rule));
+        break;
+      }
+    }
+  }
+  return status.IsOutOfRange() ? OkStatus() : Status::DataLoss();
+}
+
+// Decodes the rules of an already validated log::Filter.
+void DecodeRulesInto(ConstByteSpan request,
+                     std::span<LogFilter::Rule> rules) {
+  uint8_t default_min_level;
+  size_t index = 0;
+  DecodeFilter(request,
+               default_min_level,
+               [&rules, &index](const LogFilter::Rule& rule) {
+                 rules[index++] = rule;
+                 return OkStatus();
+               })
+      .IgnoreError();
+}
+
+}  // namespace
+
+StatusWithSize FilterService::SetFilter(ServerContext&,
+                                        ConstByteSpan request,
+                                        ByteSpan) {
+  // Validate the request and count the rules before changing anything, so
+  // that the rules can then be decoded straight into the filter.
+  uint8_t default_min_level;
+  size_t rule_count = 0;
+  const Status status = DecodeFilter(
+      request, default_min_level, [&rule_count](const LogFilter::Rule& rule) {
+        ++rule_count;
+        return rule.module.has_value() || rule.token.has_value()
+                   ? OkStatus()
+                   : Status::InvalidArgument();
+      });
+  if (!status.ok()) {
+    return StatusWithSize(
+        status.IsInvalidArgument() ? status : Status::DataLoss(), 0);
+  }
+
+  return StatusWithSize(
+      filter_.Update(default_min_level,
+                     rule_count,
+                     [request](std::span<LogFilter::Rule> rules) {
+                       DecodeRulesInto(request, rules);
+                     }),
+      0);
+}
+
+StatusWithSize FilterService::GetFilter(ServerContext&,
+                                        ConstByteSpan,
+                                        ByteSpan response) {
+  log::Filter::MemoryEncoder encoder(response);
+  filter_.Visit([&encoder](uint8_t default_min_level,
+                           std::span<const LogFilter::Rule> rules) {
+    encoder.WriteDefaultMinLevel(default_min_level).IgnoreError();
+    for (const LogFilter::Rule& rule : rules) {
+      log::FilterRule::StreamEncoder rule_encoder = encoder.GetRulesEncoder();
+      if (rule.module.has_value()) {
+        rule_encoder.WriteModule(*rule.module).IgnoreError();
+      }
+      if (rule.token.has_value()) {
+        rule_encoder.WriteToken(*rule.token).IgnoreError();
+      }
+      rule_encoder.WriteMinLevel(rule.min_level).IgnoreError();
+    }
+  });
+  return StatusWithSize(encoder.status(), encoder.size());
+}
+
+}  // namespace pw::log_rpc
@@ -0,0 +1,125 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/filter_service.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+#include "pw_log/levels.h"
+#include "pw_log/proto/log.pwpb.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_rpc/raw/test_method_context.h"
+
+namespace pw::log_rpc {
+namespace {
+
+constexpr uint32_t kModule = 0x1234;
+constexpr uint32_t kToken = 0xabcd1234;
+constexpr auto kInfo =
+    log_tokenized::Metadata::Set<PW_LOG_LEVEL_INFO, kModule, 0, 1>();
+
+class FilterServiceTest : public ::testing::Test {
+ protected:
+  // Encodes a filter with a module rule and, optionally, a token rule.
+  ConstByteSpan EncodeFilter(uint32_t default_min_level, bool token_rule) {
+    log::Filter::MemoryEncoder encoder(request_buffer_);
+    encoder.WriteDefaultMinLevel(default_min_level).IgnoreError();
+    {
+      log::FilterRule::StreamEncoder rule = encoder.GetRulesEncoder();
+      rule.WriteModule(kModule).IgnoreError();
+      rule.WriteMinLevel(PW_LOG_LEVEL_ERROR).IgnoreError();
+    }
+    if (token_rule) {
+      log::FilterRule::StreamEncoder rule = encoder.GetRulesEncoder();
+      rule.WriteToken(kToken).IgnoreError();
+      rule.WriteMinLevel(PW_LOG_LEVEL_DEBUG).IgnoreError();
+    }
+    EXPECT_EQ(OkStatus(), encoder.status());
+    return ConstByteSpan(encoder);
+  }
+
+  LogFilterBuffer<2> filter_;
+  std::array<std::byte, 64> request_buffer_;
+};
+
+TEST_F(FilterServiceTest, SetFilter_UpdatesFilter) {
+  PW_RAW_TEST_METHOD_CONTEXT(FilterService, SetFilter) context(filter_);
+  ASSERT_EQ(OkStatus(),
+            context.call(EncodeFilter(PW_LOG_LEVEL_DEBUG, true)).status());
+
+  EXPECT_FALSE(filter_.ShouldLog(kInfo, kToken + 1));
+  EXPECT_TRUE(filter_.ShouldLog(kInfo, kToken));
+}
+
+TEST_F(FilterServiceTest, SetFilter_TooManyRules_Unchanged) {
+  LogFilterBuffer<1> small_filter;
+  PW_RAW_TEST_METHOD_CONTEXT(FilterService, SetFilter) context(small_filter);
+  EXPECT_EQ(Status::ResourceExhausted(),
+            context.call(EncodeFilter(PW_LOG_LEVEL_DEBUG, true)).status());
+  EXPECT_TRUE(small_filter.ShouldLog(kInfo, kToken + 1));
+}
+
+TEST_F(FilterServiceTest, SetFilter_InvalidRule) {
+  log::Filter::MemoryEncoder encoder(request_buffer_);
+  {
+    log::FilterRule::StreamEncoder rule = encoder.GetRulesEncoder();
+    rule.WriteMinLevel(PW_LOG_LEVEL_ERROR).IgnoreError();
+  }
+  ASSERT_EQ(OkStatus(), encoder.status());
+
+  PW_RAW_TEST_METHOD_CONTEXT(FilterService, SetFilter) context(filter_);
+  EXPECT_EQ(Status::InvalidArgument(), context.call(encoder).status());
+}
+
+TEST_F(FilterServiceTest, SetFilter_Malformed_DataLoss) {
+  constexpr std::array<std::byte, 2> kMalformed = {std::byte{0x12},
+                                                   std::byte{0x05}};
+  PW_RAW_TEST_METHOD_CONTEXT(FilterService, SetFilter) context(filter_);
+  EXPECT_EQ(Status::DataLoss(), context.call(kMalformed).status());
+  EXPECT_TRUE(filter_.ShouldLog(kInfo, kToken));
+}
+
+TEST_F(FilterServiceTest, GetFilter_ReturnsRules) {
+  PW_RAW_TEST_METHOD_CONTEXT(FilterService, SetFilter) set_context(filter_);
+  ASSERT_EQ(OkStatus(),
+            set_context.call(EncodeFilter(PW_LOG_LEVEL_WARN, false)).status());
+
+  PW_RAW_TEST_METHOD_CONTEXT(FilterService, GetFilter) context(filter_);
+  ASSERT_EQ(OkStatus(), context.call({}).status());
+
+  protobuf::Decoder decoder(context.response());
+  uint32_t default_min_level = 0;
+  size_t rules = 0;
+  while (decoder.Next().ok()) {
+    if (decoder.FieldNumber() ==
+        static_cast<uint32_t>(log::Filter::Fields::DEFAULT_MIN_LEVEL)) {
+      ASSERT_EQ(OkStatus(), decoder.ReadUint32(&default_min_level));
+      continue;
+    }
+    ConstByteSpan rule;
+    ASSERT_EQ(OkStatus(), decoder.ReadBytes(&rule));
+    protobuf::Decoder rule_decoder(rule);
+    ASSERT_EQ(OkStatus(), rule_decoder.Next());
+    uint32_t module;
+    ASSERT_EQ(OkStatus(), rule_decoder.ReadUint32(&module));
+    EXPECT_EQ(kModule, module);
+    ++rules;
+  }
+  EXPECT_EQ(default_min_level, uint32_t(PW_LOG_LEVEL_WARN));
+  EXPECT_EQ(rules, 1u);
+}
+
+}  // namespace
+}  // namespace pw::log_rpc
@@ -0,0 +1,73 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/log_filter.h"
+
+#include "pw_bytes/endian.h"
+
+namespace pw::log_rpc {
+
+bool LogFilter::ShouldLog(log_tokenized::Metadata metadata,
+                          uint32_t token) const {
+  const uint32_t level = metadata.level();
+  const uint32_t module = metadata.module();
+
+  std::lock_guard lock(lock_);
+  if (!IsBitSet(module_bitmap_, module) && !IsBitSet(token_bitmap_, token)) {
+    return level >= default_min_level_;
+  }
+  return level >= MinLevel(module, token);
+}
+
+bool LogFilter::ShouldLog(log_tokenized::Metadata metadata,
+                          ConstByteSpan message) const {
+  uint32_t token = 0;
+  if (message.size() >= sizeof(token)) {
+    token = bytes::ReadInOrder<uint32_t>(std::endian::little, message.data());
+  }
+  return ShouldLog(metadata, token);
+}
+
+void LogFilter::UpdateBitmaps() {
+  module_bitmap_ = {};
+  token_bitmap_ = {};
+  for (const Rule& rule : rules_.first(rule_count_)) {
+    // Rules with a token only apply to that token, so only the token bit is
+    // needed to find them.
+    if (rule.token.has_value()) {
+      SetBit(token_bitmap_, *rule.token);
+    } else if (rule.module.has_value()) {
+      SetBit(module_bitmap_, *rule.module);
+    }
+  }
+}
+
+uint8_t LogFilter::MinLevel(uint32_t module, uint32_t token) const {
+  const Rule* module_rule = nullptr;
+  for (const Rule& rule : rules_.first(rule_count_)) {
+    if (rule.module.has_value() && *rule.module != module) {
+      continue;
+    }
+    if (rule.token.has_value()) {
+      if (*rule.token == token) {
+        return rule.min_level;
+      }
+    } else if (rule.module.has_value() && module_rule == nullptr) {
+      module_rule = &rule;
+    }
+  }
+  return module_rule != nullptr ? module_rule->min_level : default_min_level_;
+}
+
+}  // namespace pw::log_rpc
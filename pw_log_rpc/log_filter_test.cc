@@ -0,0 +1,127 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/log_filter.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_log/levels.h"
+
+namespace pw::log_rpc {
+namespace {
+
+using Rule = LogFilter::Rule;
+
+constexpr uint32_t kModule = 0x1234;
+constexpr uint32_t kOtherModule = 0x4321;
+// Shares the low bits of kModule, so it is looked up in the rules.
+constexpr uint32_t kCollidingModule = kModule + 256;
+constexpr uint32_t kToken = 0xabcd1234;
+
+template <uint32_t kLevel, uint32_t kModuleToken>
+constexpr log_tokenized::Metadata kLog =
+    log_tokenized::Metadata::Set<kLevel, kModuleToken, 0, 1>();
+
+TEST(LogFilter, NoRules_KeepsEverything) {
+  LogFilterBuffer<4> filter;
+  EXPECT_TRUE((filter.ShouldLog(kLog<PW_LOG_LEVEL_DEBUG, kModule>, kToken)));
+  EXPECT_TRUE((filter.ShouldLog(kLog<PW_LOG_LEVEL_ERROR, 0>, 0)));
+}
+
+TEST(LogFilter, DefaultMinLevel) {
+  LogFilterBuffer<4> filter;
+  ASSERT_EQ(OkStatus(), filter.Update(PW_LOG_LEVEL_WARN, {}));
+  EXPECT_FALSE((filter.ShouldLog(kLog<PW_LOG_LEVEL_INFO, kModule>, kToken)));
+  EXPECT_TRUE((filter.ShouldLog(kLog<PW_LOG_LEVEL_WARN, kModule>, kToken)));
+  EXPECT_TRUE((filter.ShouldLog(kLog<PW_LOG_LEVEL_ERROR, kModule>, kToken)));
+}
+
+TEST(LogFilter, ModuleRule) {
+  LogFilterBuffer<4> filter;
+  const Rule rules[] = {{.module = kModule, .min_level = PW_LOG_LEVEL_ERROR}};
+  ASSERT_EQ(OkStatus(), filter.Update(PW_LOG_LEVEL_DEBUG, rules));
+
+  EXPECT_FALSE((filter.ShouldLog(kLog<PW_LOG_LEVEL_WARN, kModule>, kToken)));
+  EXPECT_TRUE((filter.ShouldLog(kLog<PW_LOG_LEVEL_ERROR, kModule>, kToken)));
+  EXPECT_TRUE(
+      (filter.ShouldLog(kLog<PW_LOG_LEVEL_DEBUG, kOtherModule>, kToken)));
+  EXPECT_TRUE(
+      (filter.ShouldLog(kLog<PW_LOG_LEVEL_DEBUG, kCollidingModule>, kToken)));
+}
+
+TEST(LogFilter, TokenRule_TakesPrecedence) {
+  LogFilterBuffer<4> filter;
+  const Rule rules[] = {
+      {.module = kModule, .min_level = PW_LOG_LEVEL_ERROR},
+      {.token = kToken, .min_level = PW_LOG_LEVEL_DEBUG},
+  };
+  ASSERT_EQ(OkStatus(), filter.Update(PW_LOG_LEVEL_WARN, rules));
+
+  EXPECT_TRUE((filter.ShouldLog(kLog<PW_LOG_LEVEL_DEBUG, kModule>, kToken)));
+  EXPECT_FALSE(
+      (filter.ShouldLog(kLog<PW_LOG_LEVEL_WARN, kModule>, kToken + 1)));
+  EXPECT_TRUE(
+      (filter.ShouldLog(kLog<PW_LOG_LEVEL_DEBUG, kOtherModule>, kToken)));
+}
+
+TEST(LogFilter, ModuleAndTokenRule_MatchesBoth) {
+  LogFilterBuffer<4> filter;
+  const Rule rules[] = {{.module = kModule, .token = kToken, .min_level = 8}};
+  ASSERT_EQ(OkStatus(), filter.Update(0, rules));
+
+  EXPECT_FALSE((filter.ShouldLog(kLog<PW_LOG_LEVEL_FATAL, kModule>, kToken)));
+  EXPECT_TRUE(
+      (filter.ShouldLog(kLog<PW_LOG_LEVEL_DEBUG, kOtherModule>, kToken)));
+}
+
+TEST(LogFilter, ShouldLog_ReadsTokenFromMessage) {
+  LogFilterBuffer<4> filter;
+  const Rule rules[] = {{.token = kToken, .min_level = 8}};
+  ASSERT_EQ(OkStatus(), filter.Update(0, rules));
+
+  constexpr auto kMessage = bytes::Concat(kToken, uint8_t(1), uint8_t(2));
+  EXPECT_FALSE((filter.ShouldLog(kLog<PW_LOG_LEVEL_INFO, kModule>, kMessage)));
+  EXPECT_TRUE((filter.ShouldLog(kLog<PW_LOG_LEVEL_INFO, kModule>,
+                                std::span(kMessage).first(3))));
+}
+
+TEST(LogFilter, Update_Errors_LeaveFilterUnchanged) {
+  LogFilterBuffer<1> filter;
+  const Rule too_many[] = {{.module = kModule}, {.module = kOtherModule}};
+  EXPECT_EQ(Status::ResourceExhausted(), filter.Update(8, too_many));
+
+  const Rule matches_nothing[] = {{.min_level = 8}};
+  EXPECT_EQ(Status::InvalidArgument(), filter.Update(8, matches_nothing));
+
+  EXPECT_TRUE((filter.ShouldLog(kLog<PW_LOG_LEVEL_DEBUG, kModule>, kToken)));
+}
+
+TEST(LogFilter, Visit) {
+  LogFilterBuffer<4> filter;
+  const Rule rules[] = {{.module = kModule, .min_level = PW_LOG_LEVEL_ERROR}};
+  ASSERT_EQ(OkStatus(), filter.Update(PW_LOG_LEVEL_INFO, rules));
+
+  filter.Visit([](uint8_t default_min_level, std::span<const Rule> visited) {
+    EXPECT_EQ(default_min_level, PW_LOG_LEVEL_INFO);
+    ASSERT_EQ(visited.size(), 1u);
+    EXPECT_EQ(visited[0].module, kModule);
+    EXPECT_FALSE(visited[0].token.has_value());
+    EXPECT_EQ(visited[0].min_level, PW_LOG_LEVEL_ERROR);
+  });
+}
+
+}  // namespace
+}  // namespace pw::log_rpc
@@ -0,0 +1,135 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures the device-to-host log pipeline from end to end. Each iteration
+// encodes tokenized log entries, buffers them in a MultiSink, and flushes them
+// with an RpcLogDrain as Listen stream responses on an HDLC channel. The frames
+// are written to memory in place of a UART and then decoded as the host would.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_assert/check.h"
+#include "pw_benchmark/benchmark.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_hdlc/rpc_channel.h"
+#include "pw_hdlc/rpc_packets.h"
+#include "pw_log/levels.h"
+#include "pw_log/proto_utils.h"
+#include "pw_log_rpc/log_service.h"
+#include "pw_log_rpc/rpc_log_drain.h"
+#include "pw_log_rpc/rpc_log_drain_map.h"
+#include "pw_log_tokenized/metadata.h"
+#include "pw_multisink/multisink.h"
+#include "pw_result/result.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_rpc/server.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::log_rpc {
+namespace {
+
+constexpr uint32_t kChannelId = 1;
+constexpr size_t kPacketSize = 256;
+
+constexpr auto kMetadata =
+    log_tokenized::Metadata::Set<PW_LOG_LEVEL_INFO, 0, 0, 123>();
+
+// A token followed by two varint-encoded arguments, as a tokenized log with a
+// couple of integer arguments would produce.
+constexpr std::array<std::byte, 8> kTokenizedMessage = {
+    std::byte{0x12},
+    std::byte{0x34},
+    std::byte{0x56},
+    std::byte{0x78},
+    std::byte{0x02},
+    std::byte{0xf4},
+    std::byte{0x03},
+    std::byte{0x2a}};
+
+// The transport. Frames are written to memory instead of a UART.
+stream::MemoryWriterBuffer<4096> uart;
+hdlc::RpcChannelOutputBuffer<kPacketSize> output(uart,
+                                                 hdlc::kDefaultRpcAddress,
+                                                 "UART");
+std::array<rpc::Channel, 1> channels = {
+    rpc::Channel::Create<kChannelId>(&output)};
+rpc::Server server(channels);
+
+// The device's log pipeline.
+std::array<std::byte, 2048> multisink_buffer;
+multisink::MultiSink multisink(multisink_buffer);
+
+sync::Mutex drain_mutex;
+std::array<std::byte, RpcLogDrain::kMinEntrySizeWithoutPayload + 32>
+    drain_buffer;
+std::array<RpcLogDrain, 1> drains = {
+    RpcLogDrain(kChannelId,
+                drain_buffer,
+                drain_mutex,
+                RpcLogDrain::LogDrainErrorHandling::kIgnoreWriterErrors)};
+RpcLogDrainMap drain_map(drains);
+LogService log_service(drain_map);
+rpc::RawServerWriter listen_writer;
+
+// The host's frame decoder.
+hdlc::DecoderBuffer<2 * kPacketSize> decoder;
+
+void OpenLogStream() {
+  if (listen_writer.active()) {
+    return;
+  }
+  multisink.AttachDrain(drains[0]);
+  listen_writer = rpc::RawServerWriter::Open<log::pw_rpc::raw::Logs::Listen>(
+      server, kChannelId, log_service);
+  PW_CHECK_OK(drains[0].Open(listen_writer));
+}
+
+void BM_LogPipeline(benchmark::State& state) {
+  const size_t entries = size_t(state.argument());
+  state.set_bytes_per_iteration(entries * kTokenizedMessage.size());
+  OpenLogStream();
+
+  std::array<std::byte, 64> entry_buffer;
+  int64_t timestamp = 0;
+  size_t frames = 0;
+
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < entries; ++i) {
+      const Result<ConstByteSpan> entry = log::EncodeTokenizedLog(
+          kMetadata, kTokenizedMessage, ++timestamp, entry_buffer);
+      multisink.HandleEntry(entry.value());
+    }
+
+    PW_CHECK_OK(drains[0].Flush());
+
+    decoder.Process(uart.WrittenData(),
+                    [&frames](const Result<hdlc::Frame>& frame) {
+                      if (frame.ok()) {
+                        frames += 1;
+                      }
+                    });
+    PW_CHECK_OK(uart.Seek(0));
+  }
+
+  benchmark::DoNotOptimize(frames);
+}
+PW_BENCHMARK_WITH_ARGUMENT(BM_LogPipeline, 1);
+PW_BENCHMARK_WITH_ARGUMENT(BM_LogPipeline, 16);
+
+}  // namespace
+}  // namespace pw::log_rpc
@@ -16,11 +16,33 @@
 
 #include "pw_log/log.h"
 #include "pw_log/proto/log.pwpb.h"
+#include "pw_protobuf/decoder.h"
 
 namespace pw::log_rpc {
+namespace {
+
+// Reads the requested encoding from a log::LogRequest. Unknown and malformed
+// fields are ignored, so older clients get the default encoding.
+RpcLogDrain::EncodingOptions DecodeEncodingOptions(ConstByteSpan request) {
+  RpcLogDrain::EncodingOptions options;
+  protobuf::Decoder decoder(request);
+  while (decoder.Next().ok()) {
+    switch (static_cast<log::LogRequest::Fields>(decoder.FieldNumber())) {
+      case log::LogRequest::Fields::DELTA_ENCODING:
+        decoder.ReadBool(&options.delta_encoding).IgnoreError();
+        break;
+      case log::LogRequest::Fields::COMPRESSION:
+        decoder.ReadBool(&options.compression).IgnoreError();
+        break;
+    }
+  }
+  return options;
+}
+
+}  // namespace
 
 void LogService::Listen(ServerContext&,
-                        ConstByteSpan,
+                        ConstByteSpan request,
                         rpc::RawServerWriter& writer) {
   uint32_t channel_id = writer.channel_id();
   Result<RpcLogDrain*> drain = drains_.GetDrainFromChannelId(channel_id);
@@ -28,7 +50,9 @@ void LogService::Listen(ServerContext&,
     return;
   }
 
-  if (const Status status = drain.value()->Open(writer); !status.ok()) {
+  if (const Status status =
+          drain.value()->Open(writer, DecodeEncodingOptions(request));
+      !status.ok()) {
     PW_LOG_ERROR("Could not start new log stream. %d",
                  static_cast<int>(status.code()));
   }
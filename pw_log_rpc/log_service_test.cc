@@ -24,6 +24,7 @@
 #include "pw_log/log.h"
 #include "pw_log/proto/log.pwpb.h"
 #include "pw_log/proto_utils.h"
+#include "pw_log_rpc/lz4_block.h"
 #include "pw_log_tokenized/metadata.h"
 #include "pw_protobuf/decoder.h"
 #include "pw_result/result.h"
@@ -95,6 +96,38 @@ class LogServiceTest : public ::testing::Test {
     return StatusWithSize(encoded_log_result.value().size());
   }
 
+  StatusWithSize AddCompactLogEntry(std::string_view message,
+                                    log_tokenized::Metadata metadata,
+                                    int64_t timestamp) {
+    Result<ConstByteSpan> encoded_log_result =
+        log::EncodeCompactTokenizedLog(metadata,
+                                       std::as_bytes(std::span(message)),
+                                       timestamp,
+                                       entry_encode_buffer_);
+    PW_TRY_WITH_SIZE(encoded_log_result.status());
+    multisink_.HandleEntry(encoded_log_result.value());
+    return StatusWithSize(encoded_log_result.value().size());
+  }
+
+  // Adds the same entries as LogEntry protos, flushes, then adds them as
+  // compact records and flushes again, so the two responses can be compared.
+  void FlushProtoAndCompactEntries(RpcLogDrain& drain,
+                                   RpcLogDrain::FlushLimits limits = {}) {
+    constexpr auto kErrorMetadata =
+        log_tokenized::Metadata::Set<PW_LOG_LEVEL_ERROR, 45, 0, __LINE__>();
+    for (bool compact : {false, true}) {
+      auto add = compact ? &LogServiceTest::AddCompactLogEntry
+                         : &LogServiceTest::AddLogEntry;
+      ASSERT_TRUE(
+          (this->*add)(kMessage, kSampleMetadata, kSampleTimestamp).ok());
+      ASSERT_TRUE(
+          (this->*add)(kMessage, kSampleMetadata, kSampleTimestamp + 10).ok());
+      ASSERT_TRUE(
+          (this->*add)(kMessage, kErrorMetadata, kSampleTimestamp + 5).ok());
+      ASSERT_EQ(drain.Flush(limits).status(), OkStatus());
+    }
+  }
+
  protected:
   std::array<std::byte, kMultiSinkBufferSize> multisink_buffer_;
   multisink::MultiSink multisink_;
@@ -105,6 +138,7 @@ class LogServiceTest : public ::testing::Test {
   std::array<std::byte, kMaxLogEntrySize> drain_buffer1_;
   std::array<std::byte, kMaxLogEntrySize> drain_buffer2_;
   std::array<std::byte, RpcLogDrain::kMinEntryBufferSize> small_buffer_;
+  std::array<std::byte, 128> compression_buffer_;
   static constexpr uint32_t kIgnoreWriterErrorsDrainId = 1;
   static constexpr uint32_t kCloseWriterOnErrorDrainId = 2;
   static constexpr uint32_t kSmallBufferDrainId = 3;
@@ -113,7 +147,8 @@ class LogServiceTest : public ::testing::Test {
       RpcLogDrain(kIgnoreWriterErrorsDrainId,
                   drain_buffer1_,
                   shared_mutex_,
-                  RpcLogDrain::LogDrainErrorHandling::kIgnoreWriterErrors),
+                  RpcLogDrain::LogDrainErrorHandling::kIgnoreWriterErrors,
+                  compression_buffer_),
       RpcLogDrain(
           kCloseWriterOnErrorDrainId,
           drain_buffer2_,
@@ -332,6 +367,308 @@ TEST_F(LogServiceTest, HandleDropped) {
   EXPECT_EQ(entries_found, total_entries + 1);
 }
 
+TEST_F(LogServiceTest, DeltaEncodedStream) {
+  RpcLogDrain& active_drain = drains_[1];
+  LOG_SERVICE_METHOD_CONTEXT context(drain_map_);
+  context.set_channel_id(active_drain.channel_id());
+
+  AddLogEntries(1, kMessage, kSampleMetadata, kSampleTimestamp);
+  AddLogEntries(1, kMessage, kSampleMetadata, kSampleTimestamp + 10);
+  constexpr auto kOtherLineMetadata =
+      log_tokenized::Metadata::Set<PW_LOG_LEVEL_INFO, 123, 0x03, __LINE__>();
+  AddLogEntries(1, kMessage, kOtherLineMetadata, kSampleTimestamp + 5);
+
+  context.call(std::as_bytes(std::span("\x08\x01", 2)));  // delta_encoding
+  EXPECT_EQ(active_drain.Flush(), OkStatus());
+  ASSERT_EQ(context.responses().size(), 1u);
+
+  protobuf::Decoder decoder(context.responses()[0]);
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber(), 2u);  // delta_encoded
+  bool delta_encoded = false;
+  ASSERT_EQ(decoder.ReadBool(&delta_encoded), OkStatus());
+  EXPECT_TRUE(delta_encoded);
+
+  // The first entry is complete. The second only differs in time, so it is
+  // the message and a delta. The third goes back in time and has a different
+  // line but the same flags, so it has an absolute timestamp and line_level.
+  const ConstByteSpan message = std::as_bytes(std::span(kMessage, 7));
+  struct {
+    uint32_t field;
+    int64_t time;
+    bool has_line_level;
+    bool has_flags;
+  } kExpected[] = {{4, kSampleTimestamp, true, true},
+                   {5, 10, false, false},
+                   {4, kSampleTimestamp + 5, true, false}};
+  for (const auto& expected : kExpected) {
+    ASSERT_EQ(decoder.Next(), OkStatus());
+    ConstByteSpan entry;
+    ASSERT_EQ(decoder.ReadBytes(&entry), OkStatus());
+    protobuf::Decoder entry_decoder(entry);
+
+    ConstByteSpan entry_message;
+    ASSERT_EQ(entry_decoder.Next(), OkStatus());
+    ASSERT_EQ(entry_decoder.FieldNumber(), 1u);  // message
+    ASSERT_EQ(entry_decoder.ReadBytes(&entry_message), OkStatus());
+    EXPECT_EQ(entry_message.size(), message.size());
+
+    ASSERT_EQ(entry_decoder.Next(), OkStatus());
+    if (expected.has_line_level) {
+      EXPECT_EQ(entry_decoder.FieldNumber(), 2u);  // line_level
+      ASSERT_EQ(entry_decoder.Next(), OkStatus());
+    }
+    if (expected.has_flags) {
+      EXPECT_EQ(entry_decoder.FieldNumber(), 3u);  // flags
+      ASSERT_EQ(entry_decoder.Next(), OkStatus());
+    }
+    int64_t time;
+    EXPECT_EQ(entry_decoder.FieldNumber(), expected.field);
+    ASSERT_EQ(entry_decoder.ReadInt64(&time), OkStatus());
+    EXPECT_EQ(time, expected.time);
+    EXPECT_EQ(entry_decoder.Next(), Status::OutOfRange());
+  }
+  EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+}
+
+TEST_F(LogServiceTest, CompressedStream) {
+  RpcLogDrain& active_drain = drains_[0];
+  LOG_SERVICE_METHOD_CONTEXT context(drain_map_);
+  context.set_channel_id(active_drain.channel_id());
+
+  const size_t total_entries = 4;
+  AddLogEntries(total_entries, kMessage, kSampleMetadata, kSampleTimestamp);
+  context.call(std::as_bytes(std::span("\x10\x01", 2)));  // compression
+  EXPECT_EQ(active_drain.Flush(), OkStatus());
+  ASSERT_EQ(context.responses().size(), 1u);
+
+  protobuf::Decoder decoder(context.responses()[0]);
+  uint32_t uncompressed_size = 0;
+  ConstByteSpan compressed;
+  while (decoder.Next().ok()) {
+    if (decoder.FieldNumber() == 3u) {
+      ASSERT_EQ(decoder.ReadBytes(&compressed), OkStatus());
+    } else {
+      ASSERT_EQ(decoder.FieldNumber(), 4u);
+      ASSERT_EQ(decoder.ReadUint32(&uncompressed_size), OkStatus());
+    }
+  }
+  ASSERT_FALSE(compressed.empty());
+  EXPECT_LT(context.responses()[0].size(), uncompressed_size);
+
+  std::array<std::byte, 128> entries;
+  const StatusWithSize result = Lz4BlockDecompress(compressed, entries);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), uncompressed_size);
+
+  Vector<TestLogEntry, total_entries> message_stack;
+  for (size_t i = 0; i < total_entries; ++i) {
+    message_stack.push_back({.timestamp = kSampleTimestamp,
+                             .tokenized_data = std::as_bytes(
+                                 std::span(std::string_view(kMessage)))});
+  }
+  protobuf::Decoder entries_decoder(
+      ConstByteSpan(entries).first(result.size()));
+  EXPECT_EQ(VerifyLogEntries(entries_decoder, message_stack), total_entries);
+}
+
+TEST_F(LogServiceTest, CompressionNotSupported_SendsUncompressed) {
+  RpcLogDrain& active_drain = drains_[1];
+  LOG_SERVICE_METHOD_CONTEXT context(drain_map_);
+  context.set_channel_id(active_drain.channel_id());
+
+  const size_t total_entries = 4;
+  AddLogEntries(total_entries, kMessage, kSampleMetadata, kSampleTimestamp);
+  context.call(std::as_bytes(std::span("\x10\x01", 2)));  // compression
+  EXPECT_EQ(active_drain.Flush(), OkStatus());
+  ASSERT_EQ(context.responses().size(), 1u);
+
+  protobuf::Decoder decoder(context.responses()[0]);
+  EXPECT_EQ(CountLogEntries(decoder), total_entries);
+}
+
+TEST_F(LogServiceTest, PacketCache_SharedBetweenDrains) {
+  std::array<std::byte, 128> cache_buffer;
+  LogPacketCache cache(cache_buffer);
+  std::array<std::array<std::byte, kMaxLogEntrySize>, 3> buffers;
+  std::array<RpcLogDrain, 3> drains{
+      RpcLogDrain(1,
+                  buffers[0],
+                  shared_mutex_,
+                  RpcLogDrain::LogDrainErrorHandling::kIgnoreWriterErrors,
+                  {},
+                  &cache),
+      RpcLogDrain(2,
+                  buffers[1],
+                  shared_mutex_,
+                  RpcLogDrain::LogDrainErrorHandling::kIgnoreWriterErrors,
+                  {},
+                  &cache),
+      RpcLogDrain(3,
+                  buffers[2],
+                  shared_mutex_,
+                  RpcLogDrain::LogDrainErrorHandling::kIgnoreWriterErrors,
+                  {},
+                  &cache),
+  };
+  RpcLogDrainMap drain_map(drains);
+  for (auto& drain : drains) {
+    multisink_.AttachDrain(drain);
+  }
+
+  LOG_SERVICE_METHOD_CONTEXT context1(drain_map);
+  context1.set_channel_id(1);
+  context1.call(rpc_request_buffer);
+  LOG_SERVICE_METHOD_CONTEXT context2(drain_map);
+  context2.set_channel_id(2);
+  context2.call(rpc_request_buffer);
+  LOG_SERVICE_METHOD_CONTEXT context3(drain_map);
+  context3.set_channel_id(3);
+  context3.call(std::as_bytes(std::span("\x08\x01", 2)));  // delta_encoding
+
+  AddLogEntries(3, kMessage, kSampleMetadata, kSampleTimestamp);
+  EXPECT_EQ(drains[0].Flush(), OkStatus());
+  EXPECT_EQ(drains[1].Flush(), OkStatus());
+  ASSERT_EQ(context1.responses().size(), 1u);
+  ASSERT_EQ(context2.responses().size(), 1u);
+  ASSERT_EQ(context1.responses()[0].size(), context2.responses()[0].size());
+  EXPECT_EQ(std::memcmp(context1.responses()[0].data(),
+                        context2.responses()[0].data(),
+                        context1.responses()[0].size()),
+            0);
+  protobuf::Decoder decoder(context2.responses()[0]);
+  EXPECT_EQ(CountLogEntries(decoder), 3u);
+
+  // A drain that reads ahead replaces the cached packet. A drain at another
+  // position or with other options encodes its own packets.
+  AddLogEntries(1, kMessage, kSampleMetadata, kSampleTimestamp);
+  EXPECT_EQ(drains[0].Flush(), OkStatus());
+  EXPECT_EQ(drains[2].Flush(), OkStatus());
+  EXPECT_EQ(drains[1].Flush(), OkStatus());
+  ASSERT_EQ(context1.responses().size(), 2u);
+  ASSERT_EQ(context2.responses().size(), 2u);
+  ASSERT_EQ(context3.responses().size(), 1u);
+
+  protobuf::Decoder second_decoder(context2.responses()[1]);
+  EXPECT_EQ(CountLogEntries(second_decoder), 1u);
+  protobuf::Decoder delta_decoder(context3.responses()[0]);
+  ASSERT_EQ(delta_decoder.Next(), OkStatus());
+  EXPECT_EQ(delta_decoder.FieldNumber(), 2u);  // delta_encoded
+  EXPECT_EQ(CountLogEntries(delta_decoder), 4u);
+
+  for (auto& drain : drains) {
+    multisink_.DetachDrain(drain);
+  }
+}
+
+TEST_F(LogServiceTest, FlushLimits_MinLevelDropsLessSevereEntries) {
+  RpcLogDrain& active_drain = drains_[1];
+  LOG_SERVICE_METHOD_CONTEXT context(drain_map_);
+  context.set_channel_id(active_drain.channel_id());
+
+  constexpr auto kErrorMetadata =
+      log_tokenized::Metadata::Set<PW_LOG_LEVEL_ERROR, 123, 0x03, __LINE__>();
+  AddLogEntries(2, kMessage, kSampleMetadata, kSampleTimestamp);
+  AddLogEntries(1, kMessage, kErrorMetadata, kSampleTimestamp);
+
+  context.call(rpc_request_buffer);
+  const StatusWithSize result =
+      active_drain.Flush({.min_level = PW_LOG_LEVEL_ERROR});
+  EXPECT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(context.responses().size(), 1u);
+  EXPECT_EQ(result.size(), context.responses()[0].size());
+
+  // The less severe entries are reported as drops ahead of the error.
+  Vector<TestLogEntry, 2> message_stack;
+  message_stack.push_back({.metadata = kErrorMetadata,
+                           .timestamp = kSampleTimestamp,
+                           .tokenized_data = std::as_bytes(
+                               std::span(std::string_view(kMessage)))});
+  message_stack.push_back({.metadata = kDropMessageMetadata, .dropped = 2});
+  protobuf::Decoder entry_decoder(context.responses()[0]);
+  EXPECT_EQ(VerifyLogEntries(entry_decoder, message_stack), 2u);
+}
+
+TEST_F(LogServiceTest, CompactEntries_SentAsLogEntries) {
+  RpcLogDrain& active_drain = drains_[1];
+  LOG_SERVICE_METHOD_CONTEXT context(drain_map_);
+  context.set_channel_id(active_drain.channel_id());
+
+  context.call(rpc_request_buffer);
+  FlushProtoAndCompactEntries(active_drain);
+  ASSERT_EQ(context.responses().size(), 2u);
+  ASSERT_EQ(context.responses()[0].size(), context.responses()[1].size());
+  EXPECT_EQ(std::memcmp(context.responses()[0].data(),
+                        context.responses()[1].data(),
+                        context.responses()[0].size()),
+            0);
+
+  protobuf::Decoder entries_decoder(context.responses()[1]);
+  EXPECT_EQ(CountLogEntries(entries_decoder), 3u);
+}
+
+TEST_F(LogServiceTest, CompactEntries_DeltaEncoded) {
+  RpcLogDrain& active_drain = drains_[1];
+  LOG_SERVICE_METHOD_CONTEXT context(drain_map_);
+  context.set_channel_id(active_drain.channel_id());
+
+  context.call(std::as_bytes(std::span("\x08\x01", 2)));  // delta_encoding
+  FlushProtoAndCompactEntries(active_drain);
+  ASSERT_EQ(context.responses().size(), 2u);
+  ASSERT_EQ(context.responses()[0].size(), context.responses()[1].size());
+  EXPECT_EQ(std::memcmp(context.responses()[0].data(),
+                        context.responses()[1].data(),
+                        context.responses()[0].size()),
+            0);
+}
+
+TEST_F(LogServiceTest, CompactEntries_MinLevelDropsLessSevereEntries) {
+  RpcLogDrain& active_drain = drains_[1];
+  LOG_SERVICE_METHOD_CONTEXT context(drain_map_);
+  context.set_channel_id(active_drain.channel_id());
+
+  context.call(rpc_request_buffer);
+  FlushProtoAndCompactEntries(active_drain,
+                              {.min_level = PW_LOG_LEVEL_ERROR});
+  ASSERT_EQ(context.responses().size(), 2u);
+  ASSERT_EQ(context.responses()[0].size(), context.responses()[1].size());
+  EXPECT_EQ(std::memcmp(context.responses()[0].data(),
+                        context.responses()[1].data(),
+                        context.responses()[0].size()),
+            0);
+
+  // The two info entries are reported as drops ahead of the error.
+  protobuf::Decoder entries_decoder(context.responses()[1]);
+  EXPECT_EQ(CountLogEntries(entries_decoder), 2u);
+}
+
+TEST_F(LogServiceTest, FlushLimits_MaxBytesStopsAfterPacket) {
+  RpcLogDrain& active_drain = drains_[1];
+  LOG_SERVICE_METHOD_CONTEXT context(drain_map_);
+  context.set_channel_id(active_drain.channel_id());
+
+  const size_t total_entries = 10;
+  AddLogEntries(total_entries, kMessage, kSampleMetadata, kSampleTimestamp);
+  context.call(rpc_request_buffer);
+
+  // The first packet is sent in full, even though it exceeds the limit.
+  StatusWithSize result = active_drain.Flush({.max_bytes = 1});
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+  ASSERT_EQ(context.responses().size(), 1u);
+  EXPECT_EQ(result.size(), context.responses()[0].size());
+
+  result = active_drain.Flush({});
+  EXPECT_EQ(result.status(), OkStatus());
+  ASSERT_GE(context.responses().size(), 2u);
+
+  size_t entries_found = 0;
+  for (auto& response : context.responses()) {
+    protobuf::Decoder entry_decoder(response);
+    entries_found += CountLogEntries(entry_decoder);
+  }
+  EXPECT_EQ(entries_found, total_entries);
+}
+
 TEST_F(LogServiceTest, HandleSmallBuffer) {
   LOG_SERVICE_METHOD_CONTEXT context(drain_map_);
   context.set_channel_id(kSmallBufferDrainId);
@@ -0,0 +1,237 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/lz4_block.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace pw::log_rpc {
+namespace {
+
+constexpr size_t kMinMatch = 4;
+// The last match must start at least this many bytes before the end of the
+// block.
+constexpr size_t kMatchFindLimit = 12;
+// The last bytes of the block are always literals.
+constexpr size_t kLastLiterals = 5;
+constexpr size_t kMaxOffset = 0xffff;
+
+constexpr size_t kHashBits = 7;
+constexpr size_t kHashTableSize = size_t(1) << kHashBits;
+
+constexpr uint8_t kTokenNibbleMax = 15;
+constexpr uint8_t kLengthByteMax = 255;
+
+uint32_t Read32(const uint8_t* data) {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+size_t Hash(uint32_t value) {
+  return (value * 2654435761u) >> (32 - kHashBits);
+}
+
+// Writes to the output buffer, remembering if any write did not fit.
+class BlockWriter {
+ public:
+  BlockWriter(ByteSpan output)
+      : data_(reinterpret_cast<uint8_t*>(output.data())),
+        size_(output.size()),
+        written_(0) {}
+
+  void Byte(uint8_t value) {
+    if (written_ < size_) {
+      data_[written_] = value;
+    }
+    ++written_;
+  }
+
+  // Writes the extra bytes of a length that does not fit in a token nibble.
+  void LengthBytes(size_t length) {
+    length -= kTokenNibbleMax;
+    for (; length >= kLengthByteMax; length -= kLengthByteMax) {
+      Byte(kLengthByteMax);
+    }
+    Byte(static_cast<uint8_t>(length));
+  }
+
+  void Copy(const uint8_t* source, size_t length) {
+    if (length <= size_ && written_ <= size_ - length) {
+      std::memcpy(&data_[written_], source, length);
+    }
+    written_ += length;
+  }
+
+  // Writes a sequence of literals, optionally followed by a match.
+  void Sequence(const uint8_t* literals,
+                size_t literal_length,
+                size_t offset,
+                size_t match_length) {
+    const size_t match_code = match_length == 0 ? 0 : match_length - kMinMatch;
+    Byte(static_cast<uint8_t>(
+        std::min<size_t>(literal_length, kTokenNibbleMax) << 4 |
+        std::min<size_t>(match_code, kTokenNibbleMax)));
+    if (literal_length >= kTokenNibbleMax) {
+      LengthBytes(literal_length);
+    }
+    Copy(literals, literal_length);
+    if (match_length == 0) {
+      return;  // The last sequence has no match.
+    }
+    Byte(static_cast<uint8_t>(offset));
+    Byte(static_cast<uint8_t>(offset >> 8));
+    if (match_code >= kTokenNibbleMax) {
+      LengthBytes(match_code);
+    }
+  }
+
+  StatusWithSize status() const {
+    return written_ <= size_ ? StatusWithSize(written_)
+                             : StatusWithSize::ResourceExhausted();
+  }
+
+ private:
+  uint8_t* const data_;
+  const size_t size_;
+  size_t written_;
+};
+
+// Reads the extra bytes of a length whose token nibble is at its maximum.
+bool ReadLengthBytes(const uint8_t*& in, const uint8_t* end, size_t& length) {
+  uint8_t value;
+  do {
+    if (in == end) {
+      return false;
+    }
+    value = *in++;
+    length += value;
+  } while (value == kLengthByteMax);
+  return true;
+}
+
+}  // namespace
+
+StatusWithSize Lz4BlockCompress(ConstByteSpan input, ByteSpan output) {
+  if (input.size() > kLz4BlockMaxInputSize) {
+    return StatusWithSize::InvalidArgument();
+  }
+
+  const uint8_t* const in = reinterpret_cast<const uint8_t*>(input.data());
+  const size_t size = input.size();
+  BlockWriter writer(output);
+  size_t anchor = 0;
+
+  // Inputs too short to hold a match are stored as literals.
+  if (size > kMatchFindLimit) {
+    // Positions fit in 16 bits since the input is at most 64 KiB.
+    uint16_t table[kHashTableSize] = {};
+    const size_t match_start_limit = size - kMatchFindLimit;
+    const size_t match_end_limit = size - kLastLiterals;
+
+    size_t position = 0;
+    while (position <= match_start_limit) {
+      const uint32_t sequence = Read32(&in[position]);
+      const size_t hash = Hash(sequence);
+      const size_t candidate = table[hash];
+      table[hash] = static_cast<uint16_t>(position);
+
+      if (candidate >= position || position - candidate > kMaxOffset ||
+          Read32(&in[candidate]) != sequence) {
+        ++position;
+        continue;
+      }
+
+      size_t match_length = kMinMatch;
+      while (position + match_length < match_end_limit &&
+             in[candidate + match_length] == in[position + match_length]) {
+        ++match_length;
+      }
+      writer.Sequence(&in[anchor],
+                      position - anchor,
+                      position - candidate,
+                      match_length);
+      position += match_length;
+      anchor = position;
+    }
+  }
+
+  writer.Sequence(&in[anchor], size - anchor, 0, 0);
+  return writer.status();
+}
+
+StatusWithSize Lz4BlockDecompress(ConstByteSpan block, ByteSpan output) {
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(block.data());
+  const uint8_t* const in_end = in + block.size();
+  uint8_t* const out_begin = reinterpret_cast<uint8_t*>(output.data());
+  uint8_t* out = out_begin;
+  uint8_t* const out_end = out_begin + output.size();
+
+  while (true) {
+    if (in == in_end) {
+      return StatusWithSize::DataLoss();
+    }
+    const uint8_t token = *in++;
+
+    size_t literal_length = token >> 4;
+    if (literal_length == kTokenNibbleMax &&
+        !ReadLengthBytes(in, in_end, literal_length)) {
+      return StatusWithSize::DataLoss();
+    }
+    if (literal_length > static_cast<size_t>(in_end - in)) {
+      return StatusWithSize::DataLoss();
+    }
+    if (literal_length > static_cast<size_t>(out_end - out)) {
+      return StatusWithSize::ResourceExhausted();
+    }
+    std::memcpy(out, in, literal_length);
+    in += literal_length;
+    out += literal_length;
+
+    if (in == in_end) {
+      break;  // The last sequence has no match.
+    }
+
+    if (in_end - in < 2) {
+      return StatusWithSize::DataLoss();
+    }
+    const size_t offset = size_t(in[0]) | size_t(in[1]) << 8;
+    in += 2;
+    if (offset == 0u || offset > static_cast<size_t>(out - out_begin)) {
+      return StatusWithSize::DataLoss();
+    }
+
+    size_t match_length = token & kTokenNibbleMax;
+    if (match_length == kTokenNibbleMax &&
+        !ReadLengthBytes(in, in_end, match_length)) {
+      return StatusWithSize::DataLoss();
+    }
+    match_length += kMinMatch;
+    if (match_length > static_cast<size_t>(out_end - out)) {
+      return StatusWithSize::ResourceExhausted();
+    }
+
+    // Matches may overlap the bytes they produce, so copy one at a time.
+    const uint8_t* match = out - offset;
+    for (size_t i = 0; i < match_length; ++i) {
+      *out++ = *match++;
+    }
+  }
+
+  return StatusWithSize(static_cast<size_t>(out - out_begin));
+}
+
+}  // namespace pw::log_rpc
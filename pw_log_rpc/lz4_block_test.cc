@@ -0,0 +1,137 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/lz4_block.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::log_rpc {
+namespace {
+
+constexpr auto kRepetitive = bytes::String(
+    "pw_log_rpc pw_log_rpc pw_log_rpc pw_log_rpc pw_log_rpc pw_log_rpc");
+
+// Compresses and decompresses the input, checking the round trip.
+size_t RoundTrip(ConstByteSpan input) {
+  std::array<std::byte, Lz4BlockMaxCompressedSize(256)> compressed;
+  std::array<std::byte, 256> decompressed;
+
+  const StatusWithSize compress_result = Lz4BlockCompress(input, compressed);
+  EXPECT_EQ(OkStatus(), compress_result.status());
+  EXPECT_LE(compress_result.size(), Lz4BlockMaxCompressedSize(input.size()));
+
+  const StatusWithSize decompress_result = Lz4BlockDecompress(
+      std::span(compressed).first(compress_result.size()), decompressed);
+  EXPECT_EQ(OkStatus(), decompress_result.status());
+  EXPECT_EQ(input.size(), decompress_result.size());
+  EXPECT_EQ(0,
+            std::memcmp(input.data(), decompressed.data(), input.size()));
+  return compress_result.size();
+}
+
+TEST(Lz4Block, RoundTrip_Repetitive_Shrinks) {
+  EXPECT_LT(RoundTrip(kRepetitive), kRepetitive.size() / 2);
+}
+
+TEST(Lz4Block, RoundTrip_LongRuns) {
+  std::array<std::byte, 256> input;
+  for (size_t i = 0; i < input.size(); ++i) {
+    // Long runs need extra length bytes for both literals and matches.
+    input[i] = i < 40 ? std::byte(i) : std::byte{0x55};
+  }
+  EXPECT_LT(RoundTrip(input), 64u);
+}
+
+TEST(Lz4Block, RoundTrip_Incompressible) {
+  std::array<std::byte, 200> input;
+  uint32_t state = 1;
+  for (std::byte& b : input) {
+    state = state * 1103515245u + 12345u;
+    b = std::byte(state >> 24);
+  }
+  EXPECT_LE(RoundTrip(input), Lz4BlockMaxCompressedSize(input.size()));
+}
+
+TEST(Lz4Block, RoundTrip_ShortAndEmpty) {
+  EXPECT_EQ(1u, RoundTrip(ConstByteSpan()));
+  EXPECT_EQ(13u, RoundTrip(std::span(kRepetitive).first(12)));
+}
+
+TEST(Lz4Block, Decompress_KnownBlock) {
+  // "abcabcabcabcabcab" from a literal run of 3 and a match of 9 at offset 3,
+  // followed by 5 literals.
+  constexpr auto kBlock = bytes::Concat(uint8_t(0x35),
+                                        bytes::String("abc"),
+                                        uint16_t(3),
+                                        uint8_t(0x50),
+                                        bytes::String("abcab"));
+  std::array<std::byte, 32> output;
+  const StatusWithSize result = Lz4BlockDecompress(kBlock, output);
+  ASSERT_EQ(OkStatus(), result.status());
+  constexpr auto kExpected = bytes::String("abcabcabcabcabcab");
+  ASSERT_EQ(kExpected.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(kExpected.data(), output.data(), result.size()));
+}
+
+TEST(Lz4Block, Compress_OutputTooSmall) {
+  std::array<std::byte, 8> output;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            Lz4BlockCompress(kRepetitive, output).status());
+}
+
+TEST(Lz4Block, Decompress_OutputTooSmall) {
+  std::array<std::byte, Lz4BlockMaxCompressedSize(kRepetitive.size())>
+      compressed;
+  const StatusWithSize result = Lz4BlockCompress(kRepetitive, compressed);
+  ASSERT_EQ(OkStatus(), result.status());
+
+  std::array<std::byte, 16> output;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            Lz4BlockDecompress(std::span(compressed).first(result.size()),
+                               output)
+                .status());
+}
+
+TEST(Lz4Block, Decompress_Malformed_DataLoss) {
+  std::array<std::byte, 32> output;
+
+  // Empty block.
+  EXPECT_EQ(Status::DataLoss(),
+            Lz4BlockDecompress(ConstByteSpan(), output).status());
+
+  // Literals run past the end of the block.
+  constexpr auto kTruncated = bytes::Concat(uint8_t(0x50), bytes::String("ab"));
+  EXPECT_EQ(Status::DataLoss(),
+            Lz4BlockDecompress(kTruncated, output).status());
+
+  // Match offset points before the start of the output.
+  constexpr auto kBadOffset =
+      bytes::Concat(uint8_t(0x10), bytes::String("a"), uint16_t(2));
+  EXPECT_EQ(Status::DataLoss(),
+            Lz4BlockDecompress(kBadOffset, output).status());
+
+  // Zero match offset.
+  constexpr auto kZeroOffset =
+      bytes::Concat(uint8_t(0x10), bytes::String("a"), uint16_t(0));
+  EXPECT_EQ(Status::DataLoss(),
+            Lz4BlockDecompress(kZeroOffset, output).status());
+}
+
+}  // namespace
+}  // namespace pw::log_rpc
@@ -0,0 +1,47 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_bytes/span.h"
+#include "pw_log/proto/log.raw_rpc.pb.h"
+#include "pw_log_rpc/log_filter.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::log_rpc {
+
+// Configures a LogFilter over RPC with the pw.log.Filters service.
+class FilterService final
+    : public log::pw_rpc::raw::Filters::Service<FilterService> {
+ public:
+  constexpr FilterService(LogFilter& filter) : filter_(filter) {}
+
+  // Replaces the filter with the one in the request.
+  //
+  // Returns:
+  //   OK - the filter was replaced.
+  //   DATA_LOSS - the request is malformed; the filter is unchanged.
+  //   INVALID_ARGUMENT - a rule has neither a module nor a token; the filter
+  //       is unchanged.
+  //   RESOURCE_EXHAUSTED - the request has more rules than the filter holds;
+  //       the filter is unchanged.
+  StatusWithSize SetFilter(ServerContext&, ConstByteSpan request, ByteSpan);
+
+  // Returns the current filter.
+  StatusWithSize GetFilter(ServerContext&, ConstByteSpan, ByteSpan response);
+
+ private:
+  LogFilter& filter_;
+};
+
+}  // namespace pw::log_rpc
@@ -0,0 +1,163 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_log_tokenized/metadata.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::log_rpc {
+
+// LogFilter decides which logs are kept before they are encoded and added to
+// the MultiSink, so that verbose modules do not evict important entries. It
+// holds a default minimum level and rules that set the minimum level of a
+// module, of a single log (by format string token), or of both. Rules with a
+// token take precedence over rules with only a module.
+//
+// Most logs match no rule. Those are resolved with two bitmap lookups and a
+// compare: the module and token are hashed into bitmaps that mark the values
+// used by rules, and the rules are only searched when a bit is set.
+//
+// LogFilter may be used from any context, including interrupts. Updates are
+// typically made over RPC with FilterService.
+class LogFilter {
+ public:
+  struct Rule {
+    std::optional<uint32_t> module = std::nullopt;
+    std::optional<uint32_t> token = std::nullopt;
+    uint8_t min_level = 0;
+  };
+
+  // Not copyable or movable.
+  LogFilter(const LogFilter&) = delete;
+  LogFilter& operator=(const LogFilter&) = delete;
+
+  // Returns true if a log with this metadata and format string token should
+  // be kept.
+  bool ShouldLog(log_tokenized::Metadata metadata, uint32_t token) const
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Reads the token from the start of a tokenized message. Messages shorter
+  // than a token are checked with a token of 0.
+  bool ShouldLog(log_tokenized::Metadata metadata, ConstByteSpan message) const
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Replaces the default level and rules. Every rule must have a module, a
+  // token, or both.
+  //
+  // Returns:
+  //   OK - the filter was updated.
+  //   INVALID_ARGUMENT - a rule has neither a module nor a token; nothing
+  //       changed.
+  //   RESOURCE_EXHAUSTED - there are more rules than fit; nothing changed.
+  Status Update(uint8_t default_min_level, std::span<const Rule> rules)
+      PW_LOCKS_EXCLUDED(lock_) {
+    for (const Rule& rule : rules) {
+      if (!rule.module.has_value() && !rule.token.has_value()) {
+        return Status::InvalidArgument();
+      }
+    }
+    return Update(default_min_level,
+                  rules.size(),
+                  [rules](std::span<Rule> out) {
+                    std::copy(rules.begin(), rules.end(), out.begin());
+                  });
+  }
+
+  // Replaces the default level and rules, with fill(std::span<Rule>) writing
+  // the rule_count rules in place with the lock held. This avoids a second
+  // copy of the rules, for example when decoding them from a request. Rules
+  // with neither a module nor a token are ignored.
+  template <typename Fill>
+  Status Update(uint8_t default_min_level, size_t rule_count, Fill&& fill)
+      PW_LOCKS_EXCLUDED(lock_) {
+    if (rule_count > rules_.size()) {
+      return Status::ResourceExhausted();
+    }
+    std::lock_guard lock(lock_);
+    fill(rules_.first(rule_count));
+    rule_count_ = rule_count;
+    default_min_level_ = default_min_level;
+    UpdateBitmaps();
+    return OkStatus();
+  }
+
+  // Calls visitor(default_min_level, rules) with the lock held. The visitor
+  // must be quick and must not use the filter.
+  template <typename Visitor>
+  void Visit(Visitor&& visitor) const PW_LOCKS_EXCLUDED(lock_) {
+    std::lock_guard lock(lock_);
+    visitor(default_min_level_,
+            std::span<const Rule>(rules_.data(), rule_count_));
+  }
+
+  size_t max_rules() const { return rules_.size(); }
+
+ protected:
+  constexpr LogFilter(std::span<Rule> rule_storage)
+      : rules_(rule_storage),
+        rule_count_(0),
+        default_min_level_(0),
+        module_bitmap_{},
+        token_bitmap_{} {}
+
+ private:
+  static constexpr size_t kBitmapBits = 256;
+  using Bitmap = std::array<uint32_t, kBitmapBits / 32>;
+
+  static void SetBit(Bitmap& bitmap, uint32_t value) {
+    const uint32_t bit = value % kBitmapBits;
+    bitmap[bit / 32] |= uint32_t(1) << (bit % 32);
+  }
+
+  static bool IsBitSet(const Bitmap& bitmap, uint32_t value) {
+    const uint32_t bit = value % kBitmapBits;
+    return (bitmap[bit / 32] >> (bit % 32)) & 1u;
+  }
+
+  void UpdateBitmaps() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Searches the rules for the minimum level of a module and token.
+  uint8_t MinLevel(uint32_t module, uint32_t token) const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  mutable sync::InterruptSpinLock lock_;
+  const std::span<Rule> rules_ PW_GUARDED_BY(lock_);
+  size_t rule_count_ PW_GUARDED_BY(lock_);
+  uint8_t default_min_level_ PW_GUARDED_BY(lock_);
+  Bitmap module_bitmap_ PW_GUARDED_BY(lock_);
+  Bitmap token_bitmap_ PW_GUARDED_BY(lock_);
+};
+
+// A LogFilter that holds up to kMaxRules rules.
+template <size_t kMaxRules>
+class LogFilterBuffer : public LogFilter {
+ public:
+  constexpr LogFilterBuffer() : LogFilter(rule_storage_), rule_storage_{} {}
+
+ private:
+  std::array<Rule, kMaxRules> rule_storage_;
+};
+
+}  // namespace pw::log_rpc
@@ -0,0 +1,56 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::log_rpc {
+
+// A minimal codec for the LZ4 block format, used to compress LogEntries
+// packets. Only raw blocks are produced and consumed; there is no LZ4 frame
+// header or checksum, so blocks can be decoded on the host with any LZ4 block
+// decoder, such as LZ4_decompress_safe() or lz4.block.decompress() in Python.
+//
+// The compressor is a single-pass greedy matcher with a small hash table on
+// the stack. It trades compression ratio for a fixed, small amount of RAM and
+// no heap use.
+
+// The largest input Lz4BlockCompress accepts.
+inline constexpr size_t kLz4BlockMaxInputSize = 0xffff;
+
+// The largest possible compressed size for an input of the given size.
+constexpr size_t Lz4BlockMaxCompressedSize(size_t input_size) {
+  return input_size + input_size / 255 + 16;
+}
+
+// Compresses input into output as an LZ4 block.
+//
+// Returns:
+//   OK - input was compressed; size() is the size of the block.
+//   INVALID_ARGUMENT - input is larger than kLz4BlockMaxInputSize.
+//   RESOURCE_EXHAUSTED - the block does not fit in output.
+StatusWithSize Lz4BlockCompress(ConstByteSpan input, ByteSpan output);
+
+// Decompresses an LZ4 block into output.
+//
+// Returns:
+//   OK - the block was decompressed; size() is the decompressed size.
+//   DATA_LOSS - the block is malformed.
+//   RESOURCE_EXHAUSTED - the decompressed data does not fit in output.
+StatusWithSize Lz4BlockDecompress(ConstByteSpan block, ByteSpan output);
+
+}  // namespace pw::log_rpc
@@ -16,6 +16,7 @@
 
 #include <array>
 #include <cstdint>
+#include <limits>
 
 #include "pw_assert/assert.h"
 #include "pw_bytes/span.h"
@@ -25,11 +26,81 @@
 #include "pw_result/result.h"
 #include "pw_rpc/raw/server_reader_writer.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 #include "pw_sync/lock_annotations.h"
 #include "pw_sync/mutex.h"
 
 namespace pw::log_rpc {
 
+// Holds the last packet encoded by an RpcLogDrain. A drain given a cache sends
+// the cached packet, instead of encoding the same entries again, if it was
+// encoded by a drain at the same position in the same MultiSink with the same
+// encoding options, flush limits and buffer sizes. When several drains stream
+// the same logs, each batch of entries is then encoded once rather than once
+// per drain.
+//
+// A cache holds a single packet, so it is most effective for drains that are
+// flushed one after another. It must only be shared between drains that share
+// a mutex.
+class LogPacketCache {
+ public:
+  // The buffer should be as large as the drains' payload buffers. Packets that
+  // do not fit are not cached.
+  constexpr explicit LogPacketCache(ByteSpan buffer)
+      : buffer_(buffer),
+        key_{},
+        start_{},
+        end_{},
+        drop_count_(0),
+        entry_count_(0),
+        packet_size_(0),
+        valid_(false) {}
+
+  // Not copyable.
+  LogPacketCache(const LogPacketCache&) = delete;
+  LogPacketCache& operator=(const LogPacketCache&) = delete;
+
+ private:
+  friend class RpcLogDrain;
+
+  // The drain settings that determine the packet encoded from a position.
+  struct Key {
+    const multisink::MultiSink* multisink;
+    uint32_t drop_count;
+    size_t entry_buffer_size;
+    size_t encode_buffer_size;
+    size_t payload_size;
+    uint8_t min_level;
+    bool delta_encoding;
+    bool compression;
+
+    constexpr bool operator==(const Key& other) const {
+      return multisink == other.multisink && drop_count == other.drop_count &&
+             entry_buffer_size == other.entry_buffer_size &&
+             encode_buffer_size == other.encode_buffer_size &&
+             payload_size == other.payload_size &&
+             min_level == other.min_level &&
+             delta_encoding == other.delta_encoding &&
+             compression == other.compression;
+    }
+  };
+
+  const ByteSpan buffer_;
+  Key key_;
+
+  // The positions of the drain that encoded the packet before and after it
+  // read the packet's entries.
+  multisink::MultiSink::Drain::Position start_;
+  multisink::MultiSink::Drain::Position end_;
+
+  // The drain's drop count and packed entries after encoding the packet.
+  uint32_t drop_count_;
+  uint32_t entry_count_;
+
+  size_t packet_size_;
+  bool valid_;
+};
+
 // RpcLogDrain matches a MultiSink::Drain with with an RPC channel's writer. A
 // RPC channel ID identifies this drain. The user must attach this drain
 // to a MultiSink that returns a log::LogEntry, and provide a buffer large
@@ -42,6 +113,14 @@ namespace pw::log_rpc {
 // will continue to retrieve log entries out of the MultiSink and attempt to
 // send them out ignoring the writer errors without sending a drop count.
 // Note: this behavior might change or be removed in the future.
+//
+// A listener can ask for delta-encoded and compressed LogEntries through
+// EncodingOptions, typically from its LogRequest. Compression is only
+// available if the drain was given a compression buffer; otherwise packets
+// are sent uncompressed.
+//
+// Drains that stream the same logs can share a LogPacketCache, so that a
+// packet encoded by one is reused by the others.
 class RpcLogDrain : public multisink::MultiSink::Drain {
  public:
   // Dictates how to handle server writer errors.
@@ -50,6 +129,29 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
     kCloseStreamOnWriterError,
   };
 
+  // How outgoing log::LogEntries messages are encoded. See log.proto.
+  struct EncodingOptions {
+    // Encode times as deltas and omit line_level and flags when they match the
+    // previous entry in the packet.
+    bool delta_encoding = false;
+
+    // Compress each LogEntries message into an LZ4 block. Packets that do not
+    // shrink are sent uncompressed.
+    bool compression = false;
+  };
+
+  // Limits for a single Flush() call, used to share a link's bandwidth. See
+  // RpcLogDrainThread for a scheduler that derives them from token buckets.
+  struct FlushLimits {
+    // No more packets are sent once this many bytes were sent. The packet
+    // that crosses the limit is sent in full.
+    size_t max_bytes = std::numeric_limits<size_t>::max();
+
+    // Entries with a lower log level are dropped and reported in the drop
+    // count, so that more severe entries get through a saturated link.
+    uint8_t min_level = 0;
+  };
+
   // The minimum buffer size, without the message payload, needed to retrieve a
   // log::LogEntry from the attached MultiSink. The user must account for the
   // max message size to avoid log entry drops. The dropped field is not
@@ -82,15 +184,25 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
   // log::LogEntry or a drop count message at the very least. The user can
   // choose to provide a unique mutex for the drain, or share it to save RAM as
   // long as they are aware of contengency issues.
+  //
+  // The optional compression buffer holds each packet before it is compressed.
+  // It should be as large as the writer's payload buffer, and may be shared
+  // between drains that share a mutex. The optional packet cache may likewise
+  // be shared between drains that share a mutex.
   RpcLogDrain(uint32_t channel_id,
               ByteSpan log_entry_buffer,
               rpc::RawServerWriter writer,
               sync::Mutex& mutex,
-              LogDrainErrorHandling error_handling)
+              LogDrainErrorHandling error_handling,
+              ByteSpan compression_buffer = {},
+              LogPacketCache* packet_cache = nullptr)
       : channel_id_(channel_id),
         error_handling_(error_handling),
         server_writer_(std::move(writer)),
         log_entry_buffer_(log_entry_buffer),
+        compression_buffer_(compression_buffer),
+        packet_cache_(packet_cache),
+        encoding_options_{},
         committed_entry_drop_count_(0),
         mutex_(mutex) {
     PW_ASSERT(log_entry_buffer.size_bytes() >= kMinEntryBufferSize);
@@ -101,15 +213,21 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
   // The provided buffer must be large enough to hold the largest transmittable
   // log::LogEntry or a drop count message at the very least. The user can
   // choose to provide a unique mutex for the drain, or share it to save RAM as
-  // long as they are aware of contengency issues.
+  // long as they are aware of contengency issues. The compression buffer and
+  // packet cache are as described above.
   RpcLogDrain(uint32_t channel_id,
               ByteSpan log_entry_buffer,
               sync::Mutex& mutex,
-              LogDrainErrorHandling error_handling)
+              LogDrainErrorHandling error_handling,
+              ByteSpan compression_buffer = {},
+              LogPacketCache* packet_cache = nullptr)
       : channel_id_(channel_id),
         error_handling_(error_handling),
         server_writer_(),
         log_entry_buffer_(log_entry_buffer),
+        compression_buffer_(compression_buffer),
+        packet_cache_(packet_cache),
+        encoding_options_{},
         committed_entry_drop_count_(0),
         mutex_(mutex) {
     PW_ASSERT(log_entry_buffer.size_bytes() >= kMinEntryBufferSize);
@@ -120,13 +238,20 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
   RpcLogDrain& operator=(const RpcLogDrain&) = delete;
 
   // Configures the drain with a new open server writer if the current one is
-  // not open.
+  // not open. The packets sent to the writer are encoded as requested in
+  // options, except that compression is ignored if the drain has no
+  // compression buffer.
   //
   // Return values:
   // OK - Successfully set the new open writer.
   // FAILED_PRECONDITION - The given writer is not open.
   // ALREADY_EXISTS - an open writer is already set.
-  Status Open(rpc::RawServerWriter& writer) PW_LOCKS_EXCLUDED(mutex_);
+  Status Open(rpc::RawServerWriter& writer, EncodingOptions options)
+      PW_LOCKS_EXCLUDED(mutex_);
+
+  Status Open(rpc::RawServerWriter& writer) PW_LOCKS_EXCLUDED(mutex_) {
+    return Open(writer, EncodingOptions());
+  }
 
   // Accesses log entries and sends them via the writer. Expected to be called
   // frequently to avoid log drops. If the writer fails to send a packet with
@@ -140,7 +265,19 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
   // OK - all entries were consumed.
   // ABORTED - there was an error writing the packet, and error_handling equals
   // `kCloseStreamOnWriterError`.
-  Status Flush() PW_LOCKS_EXCLUDED(mutex_);
+  Status Flush() PW_LOCKS_EXCLUDED(mutex_) {
+    return Flush(FlushLimits()).status();
+  }
+
+  // Flushes within the given limits. The size is the number of bytes sent.
+  //
+  // Return values:
+  // OK - all entries were consumed.
+  // RESOURCE_EXHAUSTED - max_bytes was reached, or the flow controlled stream
+  // ran out of credits, before all entries were consumed.
+  // ABORTED - as for Flush().
+  // UNAVAILABLE - the drain has no open writer.
+  StatusWithSize Flush(const FlushLimits& limits) PW_LOCKS_EXCLUDED(mutex_);
 
   // Ends RPC log stream without flushing.
   //
@@ -158,15 +295,43 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
     kMoreEntriesRemaining,
   };
 
-  // Fills the outgoing buffer with as many entries as possible.
+  // Fills the outgoing buffer with as many entries as possible, and reports
+  // the drain's positions before and after reading them.
   LogDrainState EncodeOutgoingPacket(log::LogEntries::MemoryEncoder& encoder,
-                                     uint32_t& packed_entry_count_out)
+                                     uint8_t min_level,
+                                     uint32_t& packed_entry_count_out,
+                                     Position& start_out,
+                                     Position& end_out)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Copies the cached packet to the payload buffer and skips its entries if
+  // it was encoded with the given key from this drain's position. Returns
+  // NOT_FOUND if there is no such packet.
+  Result<LogDrainState> ReadCachedPacket(const LogPacketCache::Key& key,
+                                         ByteSpan payload,
+                                         ConstByteSpan& packet_out,
+                                         uint32_t& packed_entry_count_out)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Stores an encoded packet in the packet cache, if it fits.
+  void CachePacket(const LogPacketCache::Key& key,
+                   ConstByteSpan packet,
+                   uint32_t packed_entry_count,
+                   const Position& start,
+                   const Position& end) PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Compresses the packet into the payload buffer, returning the message to
+  // send. Returns the packet itself if compression does not shrink it.
+  ConstByteSpan CompressPacket(ConstByteSpan packet, ByteSpan payload)
       PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   const uint32_t channel_id_;
   const LogDrainErrorHandling error_handling_;
   rpc::RawServerWriter server_writer_ PW_GUARDED_BY(mutex_);
   const ByteSpan log_entry_buffer_ PW_GUARDED_BY(mutex_);
+  const ByteSpan compression_buffer_ PW_GUARDED_BY(mutex_);
+  LogPacketCache* const packet_cache_ PW_GUARDED_BY(mutex_);
+  EncodingOptions encoding_options_ PW_GUARDED_BY(mutex_);
   uint32_t committed_entry_drop_count_ PW_GUARDED_BY(mutex_);
   sync::Mutex& mutex_;
 };
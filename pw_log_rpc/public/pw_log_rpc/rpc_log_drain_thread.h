@@ -14,16 +14,23 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <span>
 
+#include "pw_assert/assert.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_log/levels.h"
 #include "pw_log_rpc/log_service.h"
 #include "pw_log_rpc/rpc_log_drain_map.h"
+#include "pw_log_rpc/token_bucket.h"
 #include "pw_multisink/multisink.h"
 #include "pw_result/result.h"
 #include "pw_rpc/raw/server_reader_writer.h"
 #include "pw_status/status.h"
 #include "pw_status/try.h"
-#include "pw_sync/thread_notification.h"
+#include "pw_sync/timed_thread_notification.h"
 #include "pw_thread/thread_core.h"
 
 namespace pw::log_rpc {
@@ -32,27 +39,62 @@ namespace pw::log_rpc {
 // manages multiple log streams. It is a suitable option when a minimal
 // thread count is desired but comes with the cost of individual log streams
 // blocking each other's flushing.
+//
+// Each drain can be given a bandwidth budget, so that a log storm cannot take
+// over the link. A drain that has used up its budget keeps its entries in the
+// MultiSink until the budget refills. While a drain's budget is low, only
+// severe entries are sent and the rest are reported as drops, so errors still
+// get through a saturated link.
 class RpcLogDrainThread final : public thread::ThreadCore,
                                 public multisink::MultiSink::Listener {
  public:
+  struct Options {
+    // One token bucket per drain, in the order of RpcLogDrainMap::drains(). If
+    // empty, drains are flushed without limits.
+    std::span<TokenBucket> budgets;
+
+    // While a budget holds fewer than reserve_bytes tokens, only entries at or
+    // above priority_level are sent, keeping the reserve for them.
+    uint8_t priority_level = PW_LOG_LEVEL_ERROR;
+    size_t reserve_bytes = 0;
+
+    // Once a budget runs dry, its drain is not flushed again until the budget
+    // holds this many tokens. Entries pile up meanwhile, so a saturated drain
+    // sends fewer, fuller packets. Typically the RPC payload size.
+    size_t min_batch_bytes = 0;
+  };
+
   RpcLogDrainThread(multisink::MultiSink& multisink, RpcLogDrainMap& drain_map)
-      : drain_map_(drain_map), multisink_(multisink) {}
+      : RpcLogDrainThread(multisink, drain_map, Options()) {}
+
+  RpcLogDrainThread(multisink::MultiSink& multisink,
+                    RpcLogDrainMap& drain_map,
+                    const Options& options)
+      : drain_map_(drain_map), multisink_(multisink), options_(options) {
+    PW_ASSERT(options_.budgets.empty() ||
+              options_.budgets.size() == drain_map_.drains().size());
+  }
 
   void OnNewEntryAvailable() override {
     new_log_available_notification_.release();
   }
 
-  // Sequentially flushes each log stream.
+  // Sequentially flushes each log stream. When a drain is held back by its
+  // budget, the thread also wakes up once the budget is ready again.
   void Run() override {
     for (auto& drain : drain_map_.drains()) {
       multisink_.AttachDrain(drain);
     }
     multisink_.AttachListener(*this);
+    last_flush_ = chrono::SystemClock::now();
+    std::optional<chrono::SystemClock::duration> retry_after;
     while (true) {
-      new_log_available_notification_.acquire();
-      for (auto& drain : drain_map_.drains()) {
-        drain.Flush().IgnoreError();
+      if (retry_after.has_value()) {
+        new_log_available_notification_.try_acquire_for(*retry_after);
+      } else {
+        new_log_available_notification_.acquire();
       }
+      retry_after = FlushDrains();
     }
   }
 
@@ -70,9 +112,50 @@ class RpcLogDrainThread final : public thread::ThreadCore,
   }
 
  private:
-  sync::ThreadNotification new_log_available_notification_;
+  // Flushes every drain within its budget. Returns how long to wait before
+  // retrying drains that were held back, if any.
+  std::optional<chrono::SystemClock::duration> FlushDrains() {
+    const chrono::SystemClock::time_point now = chrono::SystemClock::now();
+    const chrono::SystemClock::duration elapsed = now - last_flush_;
+    last_flush_ = now;
+
+    std::optional<chrono::SystemClock::duration> retry_after;
+    for (size_t i = 0; i < drain_map_.drains().size(); ++i) {
+      RpcLogDrain& drain = drain_map_.drains()[i];
+      if (options_.budgets.empty()) {
+        drain.Flush().IgnoreError();
+        continue;
+      }
+
+      TokenBucket& budget = options_.budgets[i];
+      budget.Refill(elapsed);
+      if (budget.Ready(options_.min_batch_bytes)) {
+        RpcLogDrain::FlushLimits limits;
+        limits.max_bytes = static_cast<size_t>(budget.tokens());
+        if (budget.tokens() < static_cast<int64_t>(options_.reserve_bytes)) {
+          limits.min_level = options_.priority_level;
+        }
+        const StatusWithSize result = drain.Flush(limits);
+        budget.Consume(result.size());
+        if (!result.IsResourceExhausted()) {
+          continue;
+        }
+      }
+
+      const chrono::SystemClock::duration wait =
+          budget.TimeUntilReady(options_.min_batch_bytes);
+      if (!retry_after.has_value() || wait < *retry_after) {
+        retry_after = wait;
+      }
+    }
+    return retry_after;
+  }
+
+  sync::TimedThreadNotification new_log_available_notification_;
   RpcLogDrainMap& drain_map_;
   multisink::MultiSink& multisink_;
+  const Options options_;
+  chrono::SystemClock::time_point last_flush_;
 };
 
 }  // namespace pw::log_rpc
@@ -0,0 +1,115 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_chrono/system_clock.h"
+
+namespace pw::log_rpc {
+
+// A token bucket that limits the bandwidth of a log stream. Tokens are bytes.
+// They are added at a fixed rate, up to the burst size, and consumed by the
+// bytes sent. Sends may overdraw the bucket, since a packet cannot be split;
+// the debt is paid back by later refills.
+//
+// TokenBucket is not thread safe. It is meant to be owned by the thread that
+// flushes the stream, such as RpcLogDrainThread.
+class TokenBucket {
+ public:
+  // Allows bytes_per_second on average and bursts of up to burst_bytes. The
+  // bucket starts full. bytes_per_second must not be 0.
+  constexpr TokenBucket(uint32_t bytes_per_second, uint32_t burst_bytes)
+      : bytes_per_second_(bytes_per_second),
+        burst_bytes_(burst_bytes),
+        tokens_(burst_bytes),
+        partial_token_us_(0),
+        ran_dry_(false) {}
+
+  // Adds the tokens earned over the elapsed time.
+  void Refill(chrono::SystemClock::duration elapsed) {
+    if (tokens_ >= burst_bytes_ || elapsed.count() <= 0) {
+      return;
+    }
+    // Long gaps only have to fill the bucket, which also keeps the product
+    // below from overflowing.
+    const int64_t elapsed_us = std::min<int64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(),
+        kMaxRefillUs);
+    const int64_t earned_us =
+        elapsed_us * bytes_per_second_ + partial_token_us_;
+    tokens_ += earned_us / kUsPerSecond;
+    partial_token_us_ = earned_us % kUsPerSecond;
+    if (tokens_ >= burst_bytes_) {
+      tokens_ = burst_bytes_;
+      partial_token_us_ = 0;
+    }
+  }
+
+  // Removes the tokens for bytes that were sent.
+  void Consume(size_t bytes) {
+    tokens_ -= static_cast<int64_t>(bytes);
+    ran_dry_ = ran_dry_ || tokens_ <= 0;
+  }
+
+  // Returns true if the stream may send. Once the bucket has run dry, it is
+  // only ready again when it holds resume_bytes tokens, so that refills are
+  // sent in batches instead of a trickle of small packets.
+  bool Ready(size_t resume_bytes) {
+    const int64_t needed =
+        ran_dry_ ? std::max<int64_t>(ResumeLevel(resume_bytes), 1) : 1;
+    if (tokens_ < needed) {
+      return false;
+    }
+    ran_dry_ = false;
+    return true;
+  }
+
+  // The time until Ready(resume_bytes) returns true, assuming nothing is sent.
+  chrono::SystemClock::duration TimeUntilReady(size_t resume_bytes) const {
+    const int64_t needed =
+        ran_dry_ ? std::max<int64_t>(ResumeLevel(resume_bytes), 1) : 1;
+    if (tokens_ >= needed) {
+      return chrono::SystemClock::duration(0);
+    }
+    const int64_t missing_us =
+        (needed - tokens_) * kUsPerSecond - partial_token_us_;
+    return chrono::SystemClock::for_at_least(std::chrono::microseconds(
+        (missing_us + bytes_per_second_ - 1) / bytes_per_second_));
+  }
+
+  // Available tokens; negative while the bucket is overdrawn.
+  int64_t tokens() const { return tokens_; }
+
+  uint32_t burst_bytes() const { return burst_bytes_; }
+
+ private:
+  static constexpr int64_t kUsPerSecond = 1'000'000;
+  static constexpr int64_t kMaxRefillUs = 1000 * kUsPerSecond;
+
+  int64_t ResumeLevel(size_t resume_bytes) const {
+    return std::min<int64_t>(resume_bytes, burst_bytes_);
+  }
+
+  const uint32_t bytes_per_second_;
+  const uint32_t burst_bytes_;
+  int64_t tokens_;
+  int64_t partial_token_us_;
+  bool ran_dry_;
+};
+
+}  // namespace pw::log_rpc
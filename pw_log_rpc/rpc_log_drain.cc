@@ -14,13 +14,29 @@
 
 #include "pw_log_rpc/rpc_log_drain.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
 #include <mutex>
+#include <optional>
 
 #include "pw_assert/check.h"
+#include "pw_log/levels.h"
+#include "pw_log/proto_utils.h"
+#include "pw_log_rpc/lz4_block.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
 
 namespace pw::log_rpc {
 namespace {
 
+// Maximum encoded size of a log::LogEntry that only holds a drop count.
+constexpr size_t kMaxDropMessageSize =
+    protobuf::SizeOfFieldKey(6)  // dropped
+    + protobuf::kMaxSizeBytesUint32;
+
 // Creates an encoded drop message on the provided buffer.
 Result<ConstByteSpan> CreateEncodedDropMessage(
     uint32_t drop_count, ByteSpan encoded_drop_message_buffer) {
@@ -30,9 +46,331 @@ Result<ConstByteSpan> CreateEncodedDropMessage(
   PW_TRY(encoder.status());
   return ConstByteSpan(encoder);
 }
+
+// Returns the log level of an encoded log::LogEntry or compact tokenized log
+// record, or 0 if it has none.
+uint8_t EntryLevel(ConstByteSpan entry) {
+  if (log::IsCompactTokenizedLog(entry)) {
+    const Result<log::CompactTokenizedLog> log =
+        log::DecodeCompactTokenizedLog(entry);
+    return log.ok() ? static_cast<uint8_t>(log.value().metadata.level() &
+                                           PW_LOG_LEVEL_BITMASK)
+                    : 0;
+  }
+  protobuf::Decoder decoder(entry);
+  while (decoder.Next().ok()) {
+    uint32_t line_level;
+    if (decoder.FieldNumber() ==
+            static_cast<uint32_t>(log::LogEntry::Fields::LINE_LEVEL) &&
+        decoder.ReadUint32(&line_level).ok()) {
+      return static_cast<uint8_t>(line_level & PW_LOG_LEVEL_BITMASK);
+    }
+  }
+  return 0;
+}
+
+// Re-encodes log::LogEntry messages relative to the previous entry in the
+// packet, as described for LogEntries.delta_encoded in log.proto. Entries are
+// staged first, so that an entry that does not fit in the packet leaves the
+// state untouched. Fields unknown to this encoder are not copied. Compact
+// tokenized log records are staged as the log::LogEntry they expand to.
+class EntryDeltaEncoder {
+ public:
+  constexpr EntryDeltaEncoder()
+      : line_level_(0), flags_(0), last_time_(), staged_{} {}
+
+  // Decodes an entry and computes its delta-encoded size.
+  Result<size_t> Stage(ConstByteSpan entry) {
+    staged_ = Staged{};
+    staged_.line_level = line_level_;
+    staged_.flags = flags_;
+    staged_.last_time = last_time_;
+    if (log::IsCompactTokenizedLog(entry)) {
+      PW_TRY(StageCompact(entry));
+    } else {
+      PW_TRY(StageProto(entry));
+    }
+
+    // Convert absolute timestamps to deltas when the previous time in this
+    // packet is known and the timestamp does not go backwards. Deltas from
+    // the source pass through, since the previous time may not be known.
+    if (staged_.time_field == Field(log::LogEntry::Fields::TIMESTAMP)) {
+      if (last_time_.has_value() && staged_.time >= *last_time_) {
+        staged_.time_field =
+            Field(log::LogEntry::Fields::TIME_SINCE_LAST_ENTRY);
+        staged_.time -= *last_time_;
+        staged_.last_time = *last_time_ + staged_.time;
+      } else {
+        staged_.last_time = staged_.time;
+      }
+    } else if (staged_.time_field != 0u && last_time_.has_value()) {
+      staged_.last_time = *last_time_ + staged_.time;
+    }
+
+    size_t size = 0;
+    if (!staged_.message.empty()) {
+      size += protobuf::SizeOfField(Field(log::LogEntry::Fields::MESSAGE),
+                                    protobuf::WireType::kDelimited,
+                                    staged_.message.size());
+    }
+    if (staged_.line_level != line_level_) {
+      size += SizeOfVarintField(log::LogEntry::Fields::LINE_LEVEL,
+                                staged_.line_level);
+    }
+    if (staged_.flags != flags_) {
+      size += SizeOfVarintField(log::LogEntry::Fields::FLAGS, staged_.flags);
+    }
+    if (staged_.time_field != 0u) {
+      size += protobuf::SizeOfFieldKey(staged_.time_field) +
+              varint::EncodedSize(static_cast<uint64_t>(staged_.time));
+    }
+    if (staged_.dropped.has_value()) {
+      size += SizeOfVarintField(log::LogEntry::Fields::DROPPED,
+                                *staged_.dropped);
+    }
+    staged_.size = size;
+    return size;
+  }
+
+  // Writes the staged entry to the packet and makes it the previous entry.
+  void Commit(log::LogEntries::MemoryEncoder& encoder) {
+    {
+      log::LogEntry::StreamEncoder entry_encoder =
+          encoder.GetEntriesEncoder(staged_.size);
+      if (!staged_.message.empty()) {
+        entry_encoder.WriteMessage(staged_.message).IgnoreError();
+      }
+      if (staged_.line_level != line_level_) {
+        entry_encoder.WriteLineLevel(staged_.line_level).IgnoreError();
+      }
+      if (staged_.flags != flags_) {
+        entry_encoder.WriteFlags(staged_.flags).IgnoreError();
+      }
+      if (staged_.time_field != 0u) {
+        entry_encoder.WriteInt64(staged_.time_field, staged_.time)
+            .IgnoreError();
+      }
+      if (staged_.dropped.has_value()) {
+        entry_encoder.WriteDropped(*staged_.dropped).IgnoreError();
+      }
+    }
+    PW_CHECK_OK(encoder.status());
+
+    line_level_ = staged_.line_level;
+    flags_ = staged_.flags;
+    last_time_ = staged_.last_time;
+  }
+
+ private:
+  Status StageProto(ConstByteSpan entry) {
+    protobuf::Decoder decoder(entry);
+    Status status;
+    while ((status = decoder.Next()).ok()) {
+      switch (static_cast<log::LogEntry::Fields>(decoder.FieldNumber())) {
+        case log::LogEntry::Fields::MESSAGE:
+          PW_TRY(decoder.ReadBytes(&staged_.message));
+          break;
+        case log::LogEntry::Fields::LINE_LEVEL:
+          PW_TRY(decoder.ReadUint32(&staged_.line_level));
+          break;
+        case log::LogEntry::Fields::FLAGS:
+          PW_TRY(decoder.ReadUint32(&staged_.flags));
+          break;
+        case log::LogEntry::Fields::TIMESTAMP:
+        case log::LogEntry::Fields::TIME_SINCE_LAST_ENTRY:
+          staged_.time_field = decoder.FieldNumber();
+          PW_TRY(decoder.ReadInt64(&staged_.time));
+          break;
+        case log::LogEntry::Fields::DROPPED:
+          uint32_t dropped;
+          PW_TRY(decoder.ReadUint32(&dropped));
+          staged_.dropped = dropped;
+          break;
+        default:
+          break;  // Unread fields are skipped by Next().
+      }
+    }
+    return status.IsOutOfRange() ? OkStatus() : status;
+  }
+
+  // Stages the fields that log::EncodeTokenizedLog would encode.
+  Status StageCompact(ConstByteSpan entry) {
+    PW_TRY_ASSIGN(const log::CompactTokenizedLog log,
+                  log::DecodeCompactTokenizedLog(entry));
+    const log_tokenized::Metadata& metadata = log.metadata;
+    staged_.message = log.tokenized_data;
+    staged_.line_level =
+        (metadata.level() & PW_LOG_LEVEL_BITMASK) |
+        ((metadata.line_number() << PW_LOG_LEVEL_BITS) & ~PW_LOG_LEVEL_BITMASK);
+    if (metadata.flags() != 0) {
+      staged_.flags = metadata.flags();
+    }
+    staged_.time_field = Field(log::LogEntry::Fields::TIMESTAMP);
+    staged_.time = log.ticks_since_epoch;
+    return OkStatus();
+  }
+
+  struct Staged {
+    ConstByteSpan message;
+    uint32_t line_level = 0;
+    uint32_t flags = 0;
+    uint32_t time_field = 0;  // 0 if the entry has no time.
+    int64_t time = 0;
+    std::optional<uint32_t> dropped;
+    std::optional<int64_t> last_time;
+    size_t size = 0;
+  };
+
+  static constexpr uint32_t Field(log::LogEntry::Fields field) {
+    return static_cast<uint32_t>(field);
+  }
+
+  static size_t SizeOfVarintField(log::LogEntry::Fields field,
+                                  uint32_t value) {
+    return protobuf::SizeOfFieldKey(Field(field)) + varint::EncodedSize(value);
+  }
+
+  uint32_t line_level_;
+  uint32_t flags_;
+  std::optional<int64_t> last_time_;
+  Staged staged_;
+};
+
+// Packs log entries, and drop messages for the entries missing between them,
+// into a log::LogEntries message. PackEntry is called while the multisink lock
+// is held, so the packer only works on state it owns.
+class LogEntriesPacker {
+ public:
+  LogEntriesPacker(log::LogEntries::MemoryEncoder& encoder,
+                   uint32_t drop_count,
+                   bool delta_encoding,
+                   uint8_t min_level)
+      : encoder_(encoder),
+        total_buffer_size_(encoder.ConservativeWriteLimit()),
+        drop_count_(drop_count),
+        entry_count_(0),
+        empty_(true),
+        delta_encoding_(delta_encoding),
+        min_level_(min_level) {}
+
+  // Packs an entry, preceded by a drop message if entries were dropped.
+  // Returns RESOURCE_EXHAUSTED if the entry must wait for the next packet, in
+  // which case `drop_count` is not consumed.
+  Status PackEntry(ConstByteSpan entry, uint32_t drop_count) {
+    uint32_t total_drop_count = drop_count_ + drop_count;
+
+    if (min_level_ > 0u && EntryLevel(entry) < min_level_) {
+      // Entry is not severe enough to be sent.
+      drop_count_ = total_drop_count + 1;
+      return OkStatus();
+    }
+
+    // Delta-encoded entries and compact tokenized log records are re-encoded.
+    // Compact records are expanded on their own, as if they were the first
+    // entry in a packet.
+    EntryDeltaEncoder* reencoder = nullptr;
+    if (delta_encoding_) {
+      reencoder = &delta_encoder_;
+    } else if (log::IsCompactTokenizedLog(entry)) {
+      expander_ = EntryDeltaEncoder();
+      reencoder = &expander_;
+    }
+
+    size_t entry_size = entry.size();
+    if (reencoder != nullptr) {
+      const Result<size_t> reencoded_size = reencoder->Stage(entry);
+      if (!reencoded_size.ok()) {
+        // Malformed entries are dropped.
+        drop_count_ = total_drop_count + 1;
+        return OkStatus();
+      }
+      entry_size = reencoded_size.value();
+    }
+
+    const size_t encoded_entry_size =
+        entry_size + RpcLogDrain::kLogEntryEncodeFrameSize;
+    if (encoded_entry_size + RpcLogDrain::kLogEntryEncodeFrameSize >
+        total_buffer_size_) {
+      // Entry is larger than the entire available buffer.
+      drop_count_ = total_drop_count + 1;
+      return OkStatus();
+    }
+    if (encoded_entry_size > encoder_.ConservativeWriteLimit()) {
+      // Entry does not fit in the partially filled encoder buffer.
+      return Status::ResourceExhausted();
+    }
+
+    if (total_drop_count > 0) {
+      if (PackDropMessage(total_drop_count, encoded_entry_size)) {
+        total_drop_count = 0;
+      } else if (!empty_) {
+        // Send the drop message ahead of the entry in the next packet. If that
+        // does not fit either, the drop message follows the entry instead.
+        return Status::ResourceExhausted();
+      }
+    }
+
+    if (reencoder != nullptr) {
+      reencoder->Commit(encoder_);
+    } else {
+      PW_CHECK_OK(encoder_.WriteBytes(
+          static_cast<uint32_t>(log::LogEntries::Fields::ENTRIES), entry));
+    }
+    drop_count_ = total_drop_count;
+    ++entry_count_;
+    empty_ = false;
+    return OkStatus();
+  }
+
+  // Packs a drop message with the remaining drop count, if there is one and
+  // it fits.
+  void PackRemainingDrops(uint32_t drop_count) {
+    drop_count_ += drop_count;
+    if (drop_count_ > 0 && PackDropMessage(drop_count_, 0)) {
+      drop_count_ = 0;
+    }
+  }
+
+  // Drops that still have to be reported in a later packet.
+  uint32_t drop_count() const { return drop_count_; }
+
+  // Log entries packed, excluding drop messages.
+  uint32_t entry_count() const { return entry_count_; }
+
+ private:
+  // Packs a drop message if it fits along with `reserved_bytes` more bytes.
+  bool PackDropMessage(uint32_t drop_count, size_t reserved_bytes) {
+    std::array<std::byte, kMaxDropMessageSize> buffer;
+    const Result<ConstByteSpan> drop_message =
+        CreateEncodedDropMessage(drop_count, buffer);
+    if (!drop_message.ok() ||
+        drop_message.value().size() + RpcLogDrain::kLogEntryEncodeFrameSize +
+                reserved_bytes >
+            encoder_.ConservativeWriteLimit()) {
+      return false;
+    }
+    PW_CHECK_OK(encoder_.WriteBytes(
+        static_cast<uint32_t>(log::LogEntries::Fields::ENTRIES),
+        drop_message.value()));
+    empty_ = false;
+    return true;
+  }
+
+  log::LogEntries::MemoryEncoder& encoder_;
+  const size_t total_buffer_size_;
+  uint32_t drop_count_;
+  uint32_t entry_count_;
+  bool empty_;
+  const bool delta_encoding_;
+  const uint8_t min_level_;
+  EntryDeltaEncoder delta_encoder_;
+  EntryDeltaEncoder expander_;
+};
+
 }  // namespace
 
-Status RpcLogDrain::Open(rpc::RawServerWriter& writer) {
+Status RpcLogDrain::Open(rpc::RawServerWriter& writer,
+                         EncodingOptions options) {
   if (!writer.active()) {
     return Status::FailedPrecondition();
   }
@@ -41,92 +379,198 @@ Status RpcLogDrain::Open(rpc::RawServerWriter& writer) {
     return Status::AlreadyExists();
   }
   server_writer_ = std::move(writer);
+  encoding_options_ = options;
+  encoding_options_.compression &= !compression_buffer_.empty();
   return OkStatus();
 }
 
-Status RpcLogDrain::Flush() {
+StatusWithSize RpcLogDrain::Flush(const FlushLimits& limits) {
   PW_CHECK_NOTNULL(multisink_);
 
   LogDrainState log_sink_state = LogDrainState::kMoreEntriesRemaining;
+  size_t bytes_sent = 0;
   std::lock_guard lock(mutex_);
   do {
     if (!server_writer_.active()) {
-      return Status::Unavailable();
+      return StatusWithSize::Unavailable(bytes_sent);
     }
-    log::LogEntries::MemoryEncoder encoder(server_writer_.PayloadBuffer());
+    // Leave entries in the MultiSink until the client can accept them, rather
+    // than dropping them in a failed write.
+    if (bytes_sent >= limits.max_bytes ||
+        server_writer_.available_credits() == 0u) {
+      return StatusWithSize::ResourceExhausted(bytes_sent);
+    }
+    const ByteSpan payload = server_writer_.PayloadBuffer();
+    // Compressed packets are packed in the compression buffer, but never
+    // larger than the payload, so they can be sent as is if they don't
+    // compress.
+    const ByteSpan encode_buffer =
+        encoding_options_.compression
+            ? compression_buffer_.first(
+                  std::min(compression_buffer_.size(), payload.size()))
+            : payload;
+    const LogPacketCache::Key key = {
+        .multisink = multisink_,
+        .drop_count = committed_entry_drop_count_,
+        .entry_buffer_size = log_entry_buffer_.size(),
+        .encode_buffer_size = encode_buffer.size(),
+        .payload_size = payload.size(),
+        .min_level = limits.min_level,
+        .delta_encoding = encoding_options_.delta_encoding,
+        .compression = encoding_options_.compression,
+    };
+
+    ConstByteSpan packet;
     uint32_t packed_entry_count = 0;
-    log_sink_state = EncodeOutgoingPacket(encoder, packed_entry_count);
-    if (const Status status = server_writer_.Write(encoder); !status.ok()) {
+    if (const Result<LogDrainState> cached_state =
+            ReadCachedPacket(key, payload, packet, packed_entry_count);
+        cached_state.ok()) {
+      log_sink_state = cached_state.value();
+    } else {
+      log::LogEntries::MemoryEncoder encoder(encode_buffer);
+      Position start;
+      Position end;
+      log_sink_state = EncodeOutgoingPacket(
+          encoder, limits.min_level, packed_entry_count, start, end);
+      packet = encoding_options_.compression ? CompressPacket(encoder, payload)
+                                             : ConstByteSpan(encoder);
+      CachePacket(key, packet, packed_entry_count, start, end);
+    }
+
+    if (const Status status = server_writer_.Write(packet); !status.ok()) {
       if (error_handling_ == LogDrainErrorHandling::kCloseStreamOnWriterError) {
         // Only update this drop count when writer errors are not ignored.
         committed_entry_drop_count_ += packed_entry_count;
         server_writer_.Finish().IgnoreError();
-        return Status::Aborted();
+        return StatusWithSize::Aborted(bytes_sent);
       }
+    } else {
+      bytes_sent += packet.size();
     }
   } while (log_sink_state == LogDrainState::kMoreEntriesRemaining);
-  return OkStatus();
+  return StatusWithSize(bytes_sent);
 }
 
 RpcLogDrain::LogDrainState RpcLogDrain::EncodeOutgoingPacket(
-    log::LogEntries::MemoryEncoder& encoder, uint32_t& packed_entry_count_out) {
-  const size_t total_buffer_size = encoder.ConservativeWriteLimit();
-  do {
-    // Get entry and drop count from drain.
-    uint32_t drop_count = 0;
-    Result<multisink::MultiSink::Drain::PeekedEntry> possible_entry =
-        PeekEntry(log_entry_buffer_, drop_count);
-    if (possible_entry.status().IsResourceExhausted()) {
-      continue;
-    }
-
-    // Report drop count if messages were dropped.
-    if (committed_entry_drop_count_ > 0 || drop_count > 0) {
-      // Reuse the log_entry_buffer_ to send a drop message.
-      const Result<ConstByteSpan> drop_message_result =
-          CreateEncodedDropMessage(committed_entry_drop_count_ + drop_count,
-                                   log_entry_buffer_);
-      // Add encoded drop messsage if fits in buffer.
-      if (drop_message_result.ok() &&
-          drop_message_result.value().size() + kLogEntryEncodeFrameSize <
-              encoder.ConservativeWriteLimit()) {
-        PW_CHECK_OK(encoder.WriteBytes(
-            static_cast<uint32_t>(log::LogEntries::Fields::ENTRIES),
-            drop_message_result.value()));
-        committed_entry_drop_count_ = 0;
-      }
-      if (possible_entry.ok()) {
-        PW_CHECK_OK(PeekEntry(log_entry_buffer_, drop_count).status());
-      }
-    }
+    log::LogEntries::MemoryEncoder& encoder,
+    uint8_t min_level,
+    uint32_t& packed_entry_count_out,
+    Position& start_out,
+    Position& end_out) {
+  if (encoding_options_.delta_encoding) {
+    PW_CHECK_OK(encoder.WriteDeltaEncoded(true));
+  }
+  LogEntriesPacker packer(encoder,
+                          committed_entry_drop_count_,
+                          encoding_options_.delta_encoding,
+                          min_level);
 
-    if (possible_entry.status().IsOutOfRange()) {
-      return LogDrainState::kCaughtUp;  // There are no more entries.
-    }
-    // At this point all expected error modes have been handled.
-    PW_CHECK_OK(possible_entry.status());
+  // Pack as many entries as fit with a single multisink lock acquisition.
+  uint32_t drop_count = 0;
+  const Status status = PeekEntries(
+      log_entry_buffer_,
+      [&packer](ConstByteSpan entry, uint32_t entry_drop_count) {
+        return packer.PackEntry(entry, entry_drop_count);
+      },
+      encoder.ConservativeWriteLimit(),
+      drop_count,
+      start_out,
+      end_out);
+  PW_CHECK(status.ok() || status.IsOutOfRange());
 
-    // Check if the entry fits in encoder buffer.
-    const size_t encoded_entry_size =
-        possible_entry.value().entry().size() + kLogEntryEncodeFrameSize;
-    if (encoded_entry_size + kLogEntryEncodeFrameSize > total_buffer_size) {
-      // Entry is larger than the entire available buffer.
-      ++committed_entry_drop_count_;
-      PW_CHECK_OK(PopEntry(possible_entry.value()));
-      continue;
-    } else if (encoded_entry_size > encoder.ConservativeWriteLimit()) {
-      // Entry does not fit in the partially filled encoder buffer. Notify the
-      // caller there are more entries to send.
-      return LogDrainState::kMoreEntriesRemaining;
-    }
+  if (status.IsOutOfRange()) {
+    // Report drops after the last entry if they fit in this packet.
+    packer.PackRemainingDrops(drop_count);
+  }
+  committed_entry_drop_count_ = packer.drop_count();
+  packed_entry_count_out = packer.entry_count();
+  return status.IsOutOfRange() ? LogDrainState::kCaughtUp
+                               : LogDrainState::kMoreEntriesRemaining;
+}
 
-    // Encode log entry and remove it from multisink.
-    PW_CHECK_OK(encoder.WriteBytes(
-        static_cast<uint32_t>(log::LogEntries::Fields::ENTRIES),
-        possible_entry.value().entry()));
-    PW_CHECK_OK(PopEntry(possible_entry.value()));
-    ++packed_entry_count_out;
-  } while (true);
+Result<RpcLogDrain::LogDrainState> RpcLogDrain::ReadCachedPacket(
+    const LogPacketCache::Key& key,
+    ByteSpan payload,
+    ConstByteSpan& packet_out,
+    uint32_t& packed_entry_count_out) {
+  if (packet_cache_ == nullptr || !packet_cache_->valid_ ||
+      !(packet_cache_->key_ == key)) {
+    return Status::NotFound();
+  }
+
+  // Skipping fails if this drain is not where the cached packet was read, in
+  // which case the packet must be encoded.
+  const Status status = SkipTo(packet_cache_->start_, packet_cache_->end_);
+  if (!status.ok() && !status.IsOutOfRange()) {
+    return Status::NotFound();
+  }
+
+  std::memcpy(payload.data(),
+              packet_cache_->buffer_.data(),
+              packet_cache_->packet_size_);
+  packet_out = payload.first(packet_cache_->packet_size_);
+  committed_entry_drop_count_ = packet_cache_->drop_count_;
+  packed_entry_count_out = packet_cache_->entry_count_;
+  return status.IsOutOfRange() ? LogDrainState::kCaughtUp
+                               : LogDrainState::kMoreEntriesRemaining;
+}
+
+void RpcLogDrain::CachePacket(const LogPacketCache::Key& key,
+                              ConstByteSpan packet,
+                              uint32_t packed_entry_count,
+                              const Position& start,
+                              const Position& end) {
+  if (packet_cache_ == nullptr ||
+      packet.size() > packet_cache_->buffer_.size()) {
+    return;
+  }
+  std::memcpy(packet_cache_->buffer_.data(), packet.data(), packet.size());
+  packet_cache_->key_ = key;
+  packet_cache_->start_ = start;
+  packet_cache_->end_ = end;
+  packet_cache_->drop_count_ = committed_entry_drop_count_;
+  packet_cache_->entry_count_ = packed_entry_count;
+  packet_cache_->packet_size_ = packet.size();
+  packet_cache_->valid_ = true;
+}
+
+ConstByteSpan RpcLogDrain::CompressPacket(ConstByteSpan packet,
+                                          ByteSpan payload) {
+  const uint32_t compressed_key = protobuf::FieldKey(
+      static_cast<uint32_t>(log::LogEntries::Fields::COMPRESSED),
+      protobuf::WireType::kDelimited);
+  const uint32_t size_key = protobuf::FieldKey(
+      static_cast<uint32_t>(log::LogEntries::Fields::UNCOMPRESSED_SIZE),
+      protobuf::WireType::kVarint);
+  const size_t max_header_size =
+      varint::EncodedSize(size_key) + varint::EncodedSize(packet.size()) +
+      varint::EncodedSize(compressed_key) + varint::EncodedSize(payload.size());
+  if (packet.empty() || max_header_size >= payload.size()) {
+    return packet;
+  }
+
+  // Compress past the space reserved for the header, then move the block
+  // next to the header once its length is known.
+  const StatusWithSize compressed =
+      Lz4BlockCompress(packet, payload.subspan(max_header_size));
+  if (!compressed.ok()) {
+    return packet;
+  }
+
+  size_t header_size = 0;
+  for (const uint64_t value : {uint64_t(size_key),
+                               uint64_t(packet.size()),
+                               uint64_t(compressed_key),
+                               uint64_t(compressed.size())}) {
+    header_size += varint::Encode(value, payload.subspan(header_size));
+  }
+  if (header_size + compressed.size() >= packet.size()) {
+    return packet;
+  }
+  std::memmove(&payload[header_size],
+               &payload[max_header_size],
+               compressed.size());
+  return payload.first(header_size + compressed.size());
 }
 
 Status RpcLogDrain::Close() {
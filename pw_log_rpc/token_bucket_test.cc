@@ -0,0 +1,100 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/token_bucket.h"
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+namespace pw::log_rpc {
+namespace {
+
+using std::chrono::milliseconds;
+
+chrono::SystemClock::duration Ms(int64_t ms) {
+  return chrono::SystemClock::for_at_least(milliseconds(ms));
+}
+
+TEST(TokenBucket, StartsFull) {
+  TokenBucket bucket(1000, 256);
+  EXPECT_EQ(bucket.tokens(), 256);
+  EXPECT_TRUE(bucket.Ready(0));
+}
+
+TEST(TokenBucket, Refill_AtRateUpToBurst) {
+  TokenBucket bucket(1000, 256);
+  bucket.Consume(200);
+  EXPECT_EQ(bucket.tokens(), 56);
+
+  bucket.Refill(Ms(100));
+  EXPECT_GE(bucket.tokens(), 156);
+  EXPECT_LE(bucket.tokens(), 157);
+
+  bucket.Refill(Ms(10'000));
+  EXPECT_EQ(bucket.tokens(), 256);
+}
+
+TEST(TokenBucket, Refill_KeepsPartialTokens) {
+  TokenBucket bucket(10, 100);
+  bucket.Consume(100);
+
+  // 10 bytes per second is 1 byte every 100 ms.
+  for (int i = 0; i < 10; ++i) {
+    bucket.Refill(Ms(50));
+  }
+  EXPECT_GE(bucket.tokens(), 5);
+}
+
+TEST(TokenBucket, Consume_Overdraws) {
+  TokenBucket bucket(1000, 100);
+  bucket.Consume(150);
+  EXPECT_EQ(bucket.tokens(), -50);
+  EXPECT_FALSE(bucket.Ready(0));
+
+  bucket.Refill(Ms(60));
+  EXPECT_TRUE(bucket.Ready(0));
+}
+
+TEST(TokenBucket, Ready_WaitsForResumeBytesAfterRunningDry) {
+  TokenBucket bucket(1000, 100);
+  bucket.Consume(100);
+
+  bucket.Refill(Ms(10));
+  EXPECT_FALSE(bucket.Ready(50));  // About 10 tokens.
+  EXPECT_GT(bucket.TimeUntilReady(50), chrono::SystemClock::duration(0));
+
+  bucket.Refill(Ms(50));
+  EXPECT_TRUE(bucket.Ready(50));
+
+  // Ready again until the bucket runs dry.
+  bucket.Consume(40);
+  EXPECT_TRUE(bucket.Ready(50));
+}
+
+TEST(TokenBucket, TimeUntilReady) {
+  TokenBucket bucket(1000, 100);
+  EXPECT_EQ(bucket.TimeUntilReady(10), chrono::SystemClock::duration(0));
+
+  bucket.Consume(100);
+  const chrono::SystemClock::duration wait = bucket.TimeUntilReady(10);
+  EXPECT_GE(wait, Ms(10) - chrono::SystemClock::duration(1));
+  EXPECT_LE(wait, Ms(11));
+
+  // Resume bytes are capped at the burst size.
+  EXPECT_LE(bucket.TimeUntilReady(1000), Ms(101));
+}
+
+}  // namespace
+}  // namespace pw::log_rpc
@@ -0,0 +1,102 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This function serves as a backend for pw_tokenizer / pw_log_tokenized that
+// queues tokenized logs and Base64 and HDLC encodes them in a separate thread.
+
+#define PW_LOG_MODULE_NAME "PW_LOG_TOKENIZED"
+
+#include "pw_log_tokenized/deferred_base64_over_hdlc.h"
+
+#include <array>
+#include <span>
+
+#include "pw_hdlc/encoder.h"
+#include "pw_log_tokenized/config.h"
+#include "pw_log_tokenized/deferred_log_queue.h"
+#include "pw_stream/sys_io_stream.h"
+#include "pw_tokenizer/base64.h"
+#include "pw_tokenizer/tokenize.h"
+#include "pw_tokenizer/tokenize_to_global_handler_with_payload.h"
+
+namespace pw::log_tokenized {
+namespace {
+
+std::array<std::byte, PW_LOG_TOKENIZED_DEFERRED_BUFFER_SIZE_BYTES> buffer;
+DeferredLogQueue queue(buffer);
+
+void WriteLog(ConstByteSpan log) {
+  static stream::SysIoWriter writer;
+
+  char base64_buffer[tokenizer::kDefaultBase64EncodedBufferSize];
+  const size_t base64_bytes =
+      tokenizer::PrefixedBase64Encode(log, base64_buffer);
+
+  hdlc::WriteUIFrame(PW_LOG_TOKENIZED_BASE64_LOG_HDLC_ADDRESS,
+                     std::as_bytes(std::span(base64_buffer, base64_bytes)),
+                     writer);
+}
+
+class Base64OverHdlcThread final : public thread::ThreadCore {
+ public:
+  constexpr Base64OverHdlcThread() : dropped_reported_(0) {}
+
+ private:
+  void Run() final {
+    while (true) {
+      queue.Wait();
+      ReportDrops();
+      queue.Drain([](pw_tokenizer_Payload, ConstByteSpan message) {
+        WriteLog(message);
+      });
+    }
+  }
+
+  void ReportDrops() {
+    const uint32_t dropped = queue.drop_count() - dropped_reported_;
+    if (dropped == 0u) {
+      return;
+    }
+    dropped_reported_ += dropped;
+
+    std::array<std::byte, DeferredLogQueue::kMaxMessageSizeBytes> message;
+    size_t size = message.size();
+    PW_TOKENIZE_TO_BUFFER(message.data(),
+                          &size,
+                          PW_LOG_TOKENIZED_FORMAT_STRING("Dropped %u logs"),
+                          static_cast<unsigned>(dropped));
+    WriteLog(std::span(message).first(size));
+  }
+
+  uint32_t dropped_reported_;
+};
+
+Base64OverHdlcThread output_thread;
+
+}  // namespace
+
+thread::ThreadCore& DeferredBase64OverHdlcThread() {
+  return output_thread;
+}
+
+// Copies tokenized logs into the queue for the output thread. This never
+// blocks on the output.
+extern "C" void pw_tokenizer_HandleEncodedMessageWithPayload(
+    pw_tokenizer_Payload metadata,
+    const uint8_t log_buffer[],
+    size_t size_bytes) {
+  queue.Push(metadata, std::as_bytes(std::span(log_buffer, size_bytes)));
+}
+
+}  // namespace pw::log_tokenized
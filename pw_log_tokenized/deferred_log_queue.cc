@@ -0,0 +1,52 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_tokenized/deferred_log_queue.h"
+
+#include <array>
+#include <mutex>
+
+namespace pw::log_tokenized {
+
+Status DeferredLogQueue::Push(pw_tokenizer_Payload metadata,
+                              ConstByteSpan message) {
+  if (message.size() > kMaxMessageSizeBytes) {
+    oversized_drop_count_.fetch_add(1, std::memory_order_relaxed);
+    return Status::InvalidArgument();
+  }
+
+  // Assemble the entry on the stack so the lock is only held for the copy.
+  std::array<std::byte, sizeof(uint32_t) + kMaxMessageSizeBytes> entry;
+  const uint32_t metadata_bits = static_cast<uint32_t>(metadata);
+  std::memcpy(entry.data(), &metadata_bits, sizeof(metadata_bits));
+  std::memcpy(entry.data() + sizeof(metadata_bits),
+              message.data(),
+              message.size());
+
+  Status status;
+  {
+    // The queue allows a single producer, so serialize producers from
+    // different threads and interrupts.
+    std::lock_guard lock(producer_lock_);
+    status = queue_.PushBack(
+        std::span(entry).first(sizeof(metadata_bits) + message.size()));
+  }
+
+  if (status.ok()) {
+    notification_.release();
+  }
+  return status;
+}
+
+}  // namespace pw::log_tokenized
@@ -0,0 +1,103 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_tokenized/deferred_log_queue.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::log_tokenized {
+namespace {
+
+constexpr auto kMessage1 = bytes::Array<0x01, 0x02, 0x03, 0x04, 0x05>();
+constexpr auto kMessage2 = bytes::Array<0xaa, 0xbb, 0xcc, 0xdd>();
+
+class DeferredLogQueueTest : public ::testing::Test {
+ protected:
+  DeferredLogQueueTest() : queue_(buffer_) {}
+
+  std::array<std::byte, 64> buffer_ = {};
+  DeferredLogQueue queue_;
+};
+
+TEST_F(DeferredLogQueueTest, Drain_Empty) {
+  EXPECT_EQ(0u, queue_.Drain([](pw_tokenizer_Payload, ConstByteSpan) {
+    FAIL();
+  }));
+}
+
+TEST_F(DeferredLogQueueTest, Drain_ReturnsLogsInOrder) {
+  ASSERT_EQ(OkStatus(), queue_.Push(123, kMessage1));
+  ASSERT_EQ(OkStatus(), queue_.Push(0xfedcba98, kMessage2));
+
+  constexpr ConstByteSpan kExpected[] = {kMessage1, kMessage2};
+  constexpr pw_tokenizer_Payload kExpectedMetadata[] = {123, 0xfedcba98};
+
+  size_t index = 0;
+  auto check = [&](pw_tokenizer_Payload metadata, ConstByteSpan message) {
+    ASSERT_LT(index, 2u);
+    EXPECT_EQ(kExpectedMetadata[index], metadata);
+    ASSERT_EQ(kExpected[index].size(), message.size());
+    EXPECT_EQ(0,
+              std::memcmp(
+                  kExpected[index].data(), message.data(), message.size()));
+    index += 1;
+  };
+  EXPECT_EQ(2u, queue_.Drain(check));
+  EXPECT_EQ(2u, index);
+
+  EXPECT_EQ(0u, queue_.Drain([](pw_tokenizer_Payload, ConstByteSpan) {}));
+  EXPECT_EQ(0u, queue_.drop_count());
+}
+
+TEST_F(DeferredLogQueueTest, Push_Full_CountsDrops) {
+  Status status;
+  int pushed = 0;
+  while ((status = queue_.Push(1, kMessage1)).ok()) {
+    pushed += 1;
+  }
+  EXPECT_EQ(Status::ResourceExhausted(), status);
+  EXPECT_GT(pushed, 0);
+  EXPECT_EQ(1u, queue_.drop_count());
+
+  // Draining frees space for new logs.
+  EXPECT_EQ(static_cast<size_t>(pushed),
+            queue_.Drain([](pw_tokenizer_Payload, ConstByteSpan) {}));
+  EXPECT_EQ(OkStatus(), queue_.Push(1, kMessage1));
+  EXPECT_EQ(1u, queue_.drop_count());
+}
+
+TEST_F(DeferredLogQueueTest, Push_TooLarge_Dropped) {
+  std::array<std::byte, DeferredLogQueue::kMaxMessageSizeBytes + 1> message{};
+  EXPECT_EQ(Status::InvalidArgument(), queue_.Push(1, message));
+  EXPECT_EQ(1u, queue_.drop_count());
+  EXPECT_EQ(0u, queue_.Drain([](pw_tokenizer_Payload, ConstByteSpan) {}));
+}
+
+TEST(DeferredLogQueue, Push_NotInitialized) {
+  DeferredLogQueue queue;
+  EXPECT_EQ(Status::FailedPrecondition(), queue.Push(1, kMessage1));
+}
+
+TEST_F(DeferredLogQueueTest, Push_WakesConsumer) {
+  ASSERT_EQ(OkStatus(), queue_.Push(1, kMessage1));
+  queue_.Wait();  // Returns immediately since a log was pushed.
+  EXPECT_EQ(1u, queue_.Drain([](pw_tokenizer_Payload, ConstByteSpan) {}));
+}
+
+}  // namespace
+}  // namespace pw::log_tokenized
@@ -0,0 +1,39 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_log_tokenized/base64_over_hdlc.h"
+#include "pw_thread/thread_core.h"
+
+// The size of the buffer that holds tokenized logs until the output thread
+// writes them. Logs are dropped when it is full.
+#ifndef PW_LOG_TOKENIZED_DEFERRED_BUFFER_SIZE_BYTES
+#define PW_LOG_TOKENIZED_DEFERRED_BUFFER_SIZE_BYTES 1024
+#endif  // PW_LOG_TOKENIZED_DEFERRED_BUFFER_SIZE_BYTES
+
+namespace pw::log_tokenized {
+
+// Returns the thread body for the deferred Base64 over HDLC backend. The
+// backend's handler only queues logs; this thread Base64-encodes them and
+// writes them to pw::sys_io as HDLC frames. Logs are queued but not written
+// until a thread is started with this ThreadCore.
+//
+//   pw::thread::DetachedThread(
+//       options, pw::log_tokenized::DeferredBase64OverHdlcThread());
+//
+// When logs are dropped because the buffer is full, the thread writes a
+// tokenized "Dropped %u logs" message before the next queued log.
+thread::ThreadCore& DeferredBase64OverHdlcThread();
+
+}  // namespace pw::log_tokenized
@@ -0,0 +1,101 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_ring_buffer/single_producer_entry_queue.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_tokenizer/config.h"
+#include "pw_tokenizer/tokenize_to_global_handler_with_payload.h"
+
+namespace pw::log_tokenized {
+
+// Queues encoded tokenized logs so that they can be processed outside of the
+// logging context. Each entry holds the 32-bit log metadata followed by the
+// encoded message (the token and its arguments), exactly as they were passed
+// to the global handler.
+//
+// Push may be called from any thread or interrupt. Producers only hold an
+// interrupt spin lock while copying the entry into the queue; they never wait
+// for the consumer. If the queue is full, the log is dropped and counted.
+//
+// Drain and Wait must only be called from a single consumer thread, which does
+// not take the lock.
+class DeferredLogQueue {
+ public:
+  // The largest encoded message that can be queued.
+  static constexpr size_t kMaxMessageSizeBytes =
+      PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES;
+
+  DeferredLogQueue() = default;
+
+  explicit DeferredLogQueue(ByteSpan buffer) { Init(buffer); }
+
+  // Sets the buffer that backs the queue. Must be called before any logs are
+  // pushed and must not be called while the queue is in use.
+  Status Init(ByteSpan buffer) { return queue_.SetBuffer(buffer); }
+
+  // Copies a log into the queue and wakes the consumer.
+  //
+  // Return values:
+  // OK - The log was queued.
+  // INVALID_ARGUMENT - The message is larger than kMaxMessageSizeBytes.
+  // RESOURCE_EXHAUSTED - The queue is full; the log was dropped and counted.
+  // FAILED_PRECONDITION - Init has not been called.
+  Status Push(pw_tokenizer_Payload metadata, ConstByteSpan message);
+
+  // Passes each queued log to handler(pw_tokenizer_Payload metadata,
+  // ConstByteSpan message), oldest first, and removes it from the queue. The
+  // message is only valid during the call. Returns the number of logs handled.
+  template <typename Handler>
+  size_t Drain(Handler&& handler) {
+    size_t handled = 0;
+    for (auto entry = queue_.PeekFront(); entry.ok();
+         entry = queue_.PeekFront()) {
+      uint32_t metadata;
+      std::memcpy(&metadata, entry.value().data(), sizeof(metadata));
+      handler(static_cast<pw_tokenizer_Payload>(metadata),
+              entry.value().subspan(sizeof(metadata)));
+      queue_.PopFront();
+      handled += 1;
+    }
+    return handled;
+  }
+
+  // Blocks until a log has been pushed since the last call to Wait.
+  void Wait() { notification_.acquire(); }
+
+  // Number of logs dropped because the queue was full or the message was too
+  // large. Wraps at UINT32_MAX.
+  uint32_t drop_count() const {
+    return queue_.drop_count() +
+           oversized_drop_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  sync::InterruptSpinLock producer_lock_;
+  ring_buffer::SingleProducerEntryQueue queue_;
+  sync::ThreadNotification notification_;
+  std::atomic<uint32_t> oversized_drop_count_ = 0;
+};
+
+}  // namespace pw::log_tokenized
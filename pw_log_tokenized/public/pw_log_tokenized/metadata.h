@@ -76,6 +76,9 @@ class GenericMetadata {
   // The 16 bit tokenized version of the module name (PW_LOG_MODULE_NAME).
   constexpr T module() const { return Module::Get(bits_); }
 
+  // The packed metadata, as passed in the tokenizer's payload argument.
+  constexpr T value() const { return bits_; }
+
  private:
   using Level = BitField<T, kLevelBits, 0>;
   using Line = BitField<T, kLineBits, kLevelBits>;
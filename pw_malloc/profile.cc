@@ -0,0 +1,175 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_malloc/profile.h"
+
+#include <algorithm>
+
+namespace pw::malloc_profile {
+
+void AllocationProfile::RecordAllocation(const void* ptr,
+                                         size_t size,
+                                         const void* call_site) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  const uint32_t allocated_at = allocations_++;
+  size_histogram_[Bucket(size)] += 1;
+
+  const size_t index =
+      FindOrAddCallSite(reinterpret_cast<uintptr_t>(call_site));
+  if (index == call_sites_.size()) {
+    dropped_allocations_ += 1;
+    return;
+  }
+
+  CallSite& site = call_sites_[index];
+  site.allocations += 1;
+  site.bytes += size;
+
+  LiveAllocation* slot = FindSlot(ptr);
+  if (slot == nullptr) {
+    untracked_allocations_ += 1;
+    return;
+  }
+
+  // If ptr is already tracked, it was freed without being recorded, so its
+  // entry is reused. Otherwise, keep one slot empty so that lookups always
+  // terminate.
+  if (slot->ptr == nullptr) {
+    if (live_allocation_count_ + 1 >= live_allocations_.size()) {
+      untracked_allocations_ += 1;
+      return;
+    }
+    live_allocation_count_ += 1;
+  }
+
+  *slot = {.ptr = ptr,
+           .call_site_index = static_cast<uint32_t>(index),
+           .allocated_at = allocated_at};
+}
+
+void AllocationProfile::RecordFree(const void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  LiveAllocation* slot = FindSlot(ptr);
+  if (slot == nullptr || slot->ptr == nullptr) {
+    return;
+  }
+
+  const uint32_t lifetime = allocations_ - slot->allocated_at;
+  lifetime_histogram_[Bucket(lifetime)] += 1;
+
+  CallSite& site = call_sites_[slot->call_site_index];
+  site.frees += 1;
+  site.lifetime += lifetime;
+
+  RemoveSlot(*slot);
+}
+
+void AllocationProfile::RecordReallocation(const void* old_ptr,
+                                           const void* new_ptr,
+                                           size_t size,
+                                           const void* call_site) {
+  // A failed reallocation leaves the original allocation in place, unless the
+  // new size is zero, in which case it is freed.
+  if (new_ptr == nullptr && size != 0u) {
+    return;
+  }
+  RecordFree(old_ptr);
+  RecordAllocation(new_ptr, size, call_site);
+}
+
+void AllocationProfile::Reset() {
+  std::fill(call_sites_.begin(), call_sites_.end(), CallSite{});
+  std::fill(
+      live_allocations_.begin(), live_allocations_.end(), LiveAllocation{});
+  call_site_count_ = 0;
+  live_allocation_count_ = 0;
+  allocations_ = 0;
+  dropped_allocations_ = 0;
+  untracked_allocations_ = 0;
+  size_histogram_ = {};
+  lifetime_histogram_ = {};
+}
+
+size_t AllocationProfile::FindOrAddCallSite(uintptr_t address) {
+  for (size_t i = 0; i < call_site_count_; ++i) {
+    if (call_sites_[i].address == address) {
+      return i;
+    }
+  }
+
+  if (call_site_count_ == call_sites_.size()) {
+    return call_sites_.size();
+  }
+
+  call_sites_[call_site_count_].address = address;
+  return call_site_count_++;
+}
+
+AllocationProfile::LiveAllocation* AllocationProfile::FindSlot(
+    const void* ptr) {
+  if (live_allocations_.empty()) {
+    return nullptr;
+  }
+
+  size_t index = HomeSlot(ptr);
+  while (live_allocations_[index].ptr != nullptr &&
+         live_allocations_[index].ptr != ptr) {
+    index = (index + 1) % live_allocations_.size();
+  }
+  return &live_allocations_[index];
+}
+
+size_t AllocationProfile::HomeSlot(const void* ptr) const {
+  // Allocations are aligned, so discard the low bits before hashing.
+  return (reinterpret_cast<uintptr_t>(ptr) >> 3) % live_allocations_.size();
+}
+
+void AllocationProfile::RemoveSlot(LiveAllocation& slot) {
+  const size_t size = live_allocations_.size();
+  size_t empty = static_cast<size_t>(&slot - live_allocations_.data());
+
+  for (size_t index = (empty + 1) % size;
+       live_allocations_[index].ptr != nullptr;
+       index = (index + 1) % size) {
+    const size_t home = HomeSlot(live_allocations_[index].ptr);
+    // Move the entry into the empty slot if the empty slot is between the
+    // entry's home slot and its current slot, accounting for wraparound.
+    const bool movable = empty <= index ? (home <= empty || home > index)
+                                        : (home <= empty && home > index);
+    if (movable) {
+      live_allocations_[empty] = live_allocations_[index];
+      empty = index;
+    }
+  }
+
+  live_allocations_[empty] = LiveAllocation{};
+  live_allocation_count_ -= 1;
+}
+
+namespace {
+
+AllocationProfileBuffer<PW_MALLOC_CONFIG_PROFILE_CALL_SITES,
+                        PW_MALLOC_CONFIG_PROFILE_LIVE_ALLOCATIONS>
+    global_profile;
+
+}  // namespace
+
+AllocationProfile& GlobalProfile() { return global_profile; }
+
+}  // namespace pw::malloc_profile
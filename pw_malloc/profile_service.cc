@@ -0,0 +1,187 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_malloc/profile_service.h"
+
+#include <optional>
+
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_protobuf/serialized_size.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
+
+namespace pw::malloc_profile {
+namespace {
+
+// Field numbers from profile_service.proto. The generated pw_protobuf code
+// declares a pw::malloc_profile::CallSite namespace, which collides with the
+// CallSite struct, so the messages are encoded directly.
+namespace CallSiteField {
+constexpr uint32_t kAddress = 1;
+constexpr uint32_t kAllocations = 2;
+constexpr uint32_t kFrees = 3;
+constexpr uint32_t kBytes = 4;
+constexpr uint32_t kLifetime = 5;
+}  // namespace CallSiteField
+
+namespace RequestField {
+constexpr uint32_t kReset = 1;
+}  // namespace RequestField
+
+namespace ResponseField {
+constexpr uint32_t kCallSites = 1;
+constexpr uint32_t kSizeHistogram = 2;
+constexpr uint32_t kLifetimeHistogram = 3;
+constexpr uint32_t kAllocations = 4;
+constexpr uint32_t kDroppedAllocations = 5;
+constexpr uint32_t kUntrackedAllocations = 6;
+}  // namespace ResponseField
+
+Status DecodeRequest(ConstByteSpan request, bool& reset) {
+  reset = false;
+
+  protobuf::Decoder decoder(request);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    if (decoder.FieldNumber() == RequestField::kReset) {
+      PW_TRY(decoder.ReadBool(&reset));
+    }
+  }
+  return status.IsOutOfRange() ? OkStatus() : Status::DataLoss();
+}
+
+size_t CallSiteSize(const CallSite& site) {
+  using protobuf::SizeOfField;
+  using protobuf::WireType;
+
+  return SizeOfField(CallSiteField::kAddress,
+                     WireType::kVarint,
+                     varint::EncodedSize(site.address)) +
+         SizeOfField(CallSiteField::kAllocations,
+                     WireType::kVarint,
+                     varint::EncodedSize(site.allocations)) +
+         SizeOfField(CallSiteField::kFrees,
+                     WireType::kVarint,
+                     varint::EncodedSize(site.frees)) +
+         SizeOfField(CallSiteField::kBytes,
+                     WireType::kVarint,
+                     varint::EncodedSize(site.bytes)) +
+         SizeOfField(CallSiteField::kLifetime,
+                     WireType::kVarint,
+                     varint::EncodedSize(site.lifetime));
+}
+
+// Encodes a profile into as few responses as possible.
+class ProfileEncoder {
+ public:
+  explicit ProfileEncoder(rpc::RawServerWriter& writer) : writer_(writer) {}
+
+  Status Encode(const AllocationProfile& profile) {
+    const Status status = EncodeResponses(profile);
+    if (!status.ok() && response_.has_value()) {
+      response_.reset();
+      writer_.ReleaseBuffer();
+    }
+    return status;
+  }
+
+ private:
+  Status EncodeResponses(const AllocationProfile& profile) {
+    Start();
+    response_->WritePackedUint32(ResponseField::kSizeHistogram,
+                                 profile.size_histogram());
+    response_->WritePackedUint32(ResponseField::kLifetimeHistogram,
+                                 profile.lifetime_histogram());
+    response_->WriteUint32(ResponseField::kAllocations, profile.allocations());
+    response_->WriteUint32(ResponseField::kDroppedAllocations,
+                           profile.dropped_allocations());
+    response_->WriteUint32(ResponseField::kUntrackedAllocations,
+                           profile.untracked_allocations());
+    PW_TRY(response_->status());
+
+    for (const CallSite& site : profile.call_sites()) {
+      PW_TRY(EncodeCallSite(site));
+    }
+    return Send();
+  }
+
+  void Start() {
+    const ByteSpan buffer = writer_.PayloadBuffer();
+    buffer_size_ = buffer.size();
+    response_.emplace(buffer);
+  }
+
+  Status EncodeCallSite(const CallSite& site) {
+    const size_t payload_size = CallSiteSize(site);
+    const size_t field_size =
+        protobuf::SizeOfField(ResponseField::kCallSites,
+                              protobuf::WireType::kDelimited,
+                              payload_size);
+
+    if (response_->size() + field_size > buffer_size_) {
+      PW_TRY(Send());
+      Start();
+      if (field_size > buffer_size_) {
+        return Status::ResourceExhausted();
+      }
+    }
+
+    {
+      protobuf::StreamEncoder encoder =
+          response_->GetNestedEncoder(ResponseField::kCallSites, payload_size);
+      encoder.WriteUint64(CallSiteField::kAddress, site.address);
+      encoder.WriteUint32(CallSiteField::kAllocations, site.allocations);
+      encoder.WriteUint32(CallSiteField::kFrees, site.frees);
+      encoder.WriteUint64(CallSiteField::kBytes, site.bytes);
+      encoder.WriteUint64(CallSiteField::kLifetime, site.lifetime);
+    }
+    return response_->status();
+  }
+
+  Status Send() {
+    Status status = response_->status();
+    if (status.ok()) {
+      status = writer_.Write(*response_);
+    } else {
+      writer_.ReleaseBuffer();
+    }
+    response_.reset();
+    return status;
+  }
+
+  rpc::RawServerWriter& writer_;
+  std::optional<protobuf::MemoryEncoder> response_;
+  size_t buffer_size_ = 0;
+};
+
+}  // namespace
+
+void AllocationProfileService::Get(ServerContext&,
+                                   ConstByteSpan request,
+                                   RawServerWriter& writer) {
+  bool reset;
+  if (Status status = DecodeRequest(request, reset); !status.ok()) {
+    writer.Finish(status);
+    return;
+  }
+
+  const Status status = ProfileEncoder(writer).Encode(profile_);
+  if (status.ok() && reset) {
+    profile_.Reset();
+  }
+  writer.Finish(status);
+}
+
+}  // namespace pw::malloc_profile
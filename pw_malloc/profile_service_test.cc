@@ -0,0 +1,161 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_malloc/profile_service.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_rpc/raw/test_method_context.h"
+
+namespace pw::malloc_profile {
+namespace {
+
+// Field numbers from profile_service.proto.
+constexpr uint32_t kRequestReset = 1;
+constexpr uint32_t kResponseCallSites = 1;
+constexpr uint32_t kResponseSizeHistogram = 2;
+constexpr uint32_t kResponseAllocations = 4;
+constexpr uint32_t kCallSiteAddress = 1;
+constexpr uint32_t kCallSiteAllocations = 2;
+
+struct DecodedResponse {
+  size_t call_sites = 0;
+  bool has_histograms = false;
+  uint32_t allocations = 0;
+};
+
+DecodedResponse Decode(ConstByteSpan response) {
+  DecodedResponse decoded;
+  protobuf::Decoder decoder(response);
+  while (decoder.Next().ok()) {
+    switch (decoder.FieldNumber()) {
+      case kResponseCallSites:
+        decoded.call_sites += 1;
+        break;
+      case kResponseSizeHistogram:
+        decoded.has_histograms = true;
+        break;
+      case kResponseAllocations:
+        EXPECT_EQ(OkStatus(), decoder.ReadUint32(&decoded.allocations));
+        break;
+    }
+  }
+  return decoded;
+}
+
+const void* Site(uintptr_t address) {
+  return reinterpret_cast<const void*>(address);
+}
+
+class AllocationProfileServiceTest : public ::testing::Test {
+ protected:
+  void Allocate(size_t call_sites) {
+    for (size_t i = 0; i < call_sites; ++i) {
+      profile_.RecordAllocation(&heap_[i], 8, Site(0x1000 + i));
+    }
+  }
+
+  AllocationProfileBuffer<16, 32> profile_;
+  std::array<std::max_align_t, 16> heap_;
+};
+
+TEST_F(AllocationProfileServiceTest, Get_SendsProfile) {
+  Allocate(2);
+
+  PW_RAW_TEST_METHOD_CONTEXT(AllocationProfileService, Get) ctx(profile_);
+  ctx.call({});
+
+  EXPECT_TRUE(ctx.done());
+  EXPECT_EQ(OkStatus(), ctx.status());
+  ASSERT_EQ(1u, ctx.responses().size());
+
+  const DecodedResponse response = Decode(ctx.responses()[0]);
+  EXPECT_EQ(2u, response.call_sites);
+  EXPECT_TRUE(response.has_histograms);
+  EXPECT_EQ(2u, response.allocations);
+
+  // The first call site is encoded with its address and allocation count.
+  protobuf::Decoder decoder(ctx.responses()[0]);
+  while (decoder.Next().ok() && decoder.FieldNumber() != kResponseCallSites) {
+  }
+  ConstByteSpan call_site;
+  ASSERT_EQ(OkStatus(), decoder.ReadBytes(&call_site));
+
+  protobuf::Decoder site_decoder(call_site);
+  uint64_t address = 0;
+  uint32_t allocations = 0;
+  while (site_decoder.Next().ok()) {
+    if (site_decoder.FieldNumber() == kCallSiteAddress) {
+      EXPECT_EQ(OkStatus(), site_decoder.ReadUint64(&address));
+    } else if (site_decoder.FieldNumber() == kCallSiteAllocations) {
+      EXPECT_EQ(OkStatus(), site_decoder.ReadUint32(&allocations));
+    }
+  }
+  EXPECT_EQ(0x1000u, address);
+  EXPECT_EQ(1u, allocations);
+}
+
+TEST_F(AllocationProfileServiceTest, Get_FillsPacketsBeforeSending) {
+  Allocate(16);
+
+  // A 128-byte packet cannot hold 16 encoded call sites along with the
+  // histograms, so the call sites are spread over several packets.
+  PW_RAW_TEST_METHOD_CONTEXT(AllocationProfileService, Get, 6, 128)
+  ctx(profile_);
+  ctx.call({});
+
+  EXPECT_EQ(OkStatus(), ctx.status());
+  ASSERT_GT(ctx.responses().size(), 2u);
+
+  size_t call_sites = 0;
+  for (size_t i = 0; i < ctx.responses().size(); ++i) {
+    const DecodedResponse response = Decode(ctx.responses()[i]);
+    EXPECT_EQ(i == 0u, response.has_histograms);
+    call_sites += response.call_sites;
+  }
+  EXPECT_EQ(16u, call_sites);
+}
+
+TEST_F(AllocationProfileServiceTest, Get_Reset_ClearsProfileAfterSending) {
+  Allocate(2);
+
+  std::array<std::byte, 8> request_buffer;
+  protobuf::MemoryEncoder request(request_buffer);
+  request.WriteBool(kRequestReset, true);
+  ASSERT_EQ(OkStatus(), request.status());
+
+  PW_RAW_TEST_METHOD_CONTEXT(AllocationProfileService, Get) ctx(profile_);
+  ctx.call(std::span(request_buffer).first(request.size()));
+
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(2u, Decode(ctx.responses()[0]).call_sites);
+  EXPECT_TRUE(profile_.call_sites().empty());
+}
+
+TEST_F(AllocationProfileServiceTest, Get_MalformedRequest_DataLoss) {
+  constexpr std::byte kMalformed[] = {std::byte{0x08}};
+
+  PW_RAW_TEST_METHOD_CONTEXT(AllocationProfileService, Get) ctx(profile_);
+  ctx.call(kMalformed);
+
+  EXPECT_TRUE(ctx.done());
+  EXPECT_EQ(Status::DataLoss(), ctx.status());
+}
+
+}  // namespace
+}  // namespace pw::malloc_profile
@@ -0,0 +1,185 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_malloc/profile.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::malloc_profile {
+namespace {
+
+// Fake call sites and allocations. The profile only compares the addresses.
+const void* Site(uintptr_t address) {
+  return reinterpret_cast<const void*>(address);
+}
+
+std::array<std::max_align_t, 64> heap;
+
+const void* Allocation(size_t index) { return &heap[index]; }
+
+TEST(AllocationProfile, Bucket) {
+  EXPECT_EQ(0u, AllocationProfile::Bucket(0));
+  EXPECT_EQ(1u, AllocationProfile::Bucket(1));
+  EXPECT_EQ(2u, AllocationProfile::Bucket(2));
+  EXPECT_EQ(2u, AllocationProfile::Bucket(3));
+  EXPECT_EQ(3u, AllocationProfile::Bucket(4));
+  EXPECT_EQ(11u, AllocationProfile::Bucket(1024));
+  EXPECT_EQ(kHistogramBuckets - 1, AllocationProfile::Bucket(1u << 20));
+  EXPECT_EQ(kHistogramBuckets - 1, AllocationProfile::Bucket(UINT64_MAX));
+}
+
+TEST(AllocationProfile, RecordAllocation_GroupsByCallSite) {
+  AllocationProfileBuffer<4, 8> profile;
+  profile.RecordAllocation(Allocation(0), 16, Site(0x100));
+  profile.RecordAllocation(Allocation(1), 100, Site(0x200));
+  profile.RecordAllocation(Allocation(2), 16, Site(0x100));
+
+  ASSERT_EQ(2u, profile.call_sites().size());
+  EXPECT_EQ(0x100u, profile.call_sites()[0].address);
+  EXPECT_EQ(2u, profile.call_sites()[0].allocations);
+  EXPECT_EQ(32u, profile.call_sites()[0].bytes);
+  EXPECT_EQ(0x200u, profile.call_sites()[1].address);
+  EXPECT_EQ(1u, profile.call_sites()[1].allocations);
+  EXPECT_EQ(100u, profile.call_sites()[1].bytes);
+
+  EXPECT_EQ(3u, profile.allocations());
+  EXPECT_EQ(2u, profile.size_histogram()[AllocationProfile::Bucket(16)]);
+  EXPECT_EQ(1u, profile.size_histogram()[AllocationProfile::Bucket(100)]);
+}
+
+TEST(AllocationProfile, RecordAllocation_FailedAllocationIgnored) {
+  AllocationProfileBuffer<4, 8> profile;
+  profile.RecordAllocation(nullptr, 16, Site(0x100));
+  EXPECT_EQ(0u, profile.allocations());
+  EXPECT_TRUE(profile.call_sites().empty());
+}
+
+TEST(AllocationProfile, RecordFree_RecordsLifetimeAtAllocatingSite) {
+  AllocationProfileBuffer<4, 8> profile;
+  profile.RecordAllocation(Allocation(0), 8, Site(0x100));
+  profile.RecordAllocation(Allocation(1), 8, Site(0x200));
+  profile.RecordAllocation(Allocation(2), 8, Site(0x200));
+  profile.RecordFree(Allocation(0));  // Lived for 3 allocations.
+  profile.RecordFree(Allocation(2));  // Lived for 1 allocation.
+
+  const CallSite& first = profile.call_sites()[0];
+  EXPECT_EQ(1u, first.frees);
+  EXPECT_EQ(3u, first.lifetime);
+
+  const CallSite& second = profile.call_sites()[1];
+  EXPECT_EQ(1u, second.frees);
+  EXPECT_EQ(1u, second.lifetime);
+
+  EXPECT_EQ(1u, profile.lifetime_histogram()[AllocationProfile::Bucket(3)]);
+  EXPECT_EQ(1u, profile.lifetime_histogram()[AllocationProfile::Bucket(1)]);
+}
+
+TEST(AllocationProfile, RecordFree_UnknownPointerIgnored) {
+  AllocationProfileBuffer<4, 8> profile;
+  profile.RecordAllocation(Allocation(0), 8, Site(0x100));
+  profile.RecordFree(Allocation(1));
+  profile.RecordFree(nullptr);
+  EXPECT_EQ(0u, profile.call_sites()[0].frees);
+
+  profile.RecordFree(Allocation(0));
+  EXPECT_EQ(1u, profile.call_sites()[0].frees);
+  profile.RecordFree(Allocation(0));  // Double free is not counted twice.
+  EXPECT_EQ(1u, profile.call_sites()[0].frees);
+}
+
+TEST(AllocationProfile, RecordReallocation) {
+  AllocationProfileBuffer<4, 8> profile;
+  profile.RecordAllocation(Allocation(0), 8, Site(0x100));
+  profile.RecordReallocation(Allocation(0), Allocation(1), 32, Site(0x200));
+
+  ASSERT_EQ(2u, profile.call_sites().size());
+  EXPECT_EQ(1u, profile.call_sites()[0].frees);
+  EXPECT_EQ(1u, profile.call_sites()[1].allocations);
+  EXPECT_EQ(32u, profile.call_sites()[1].bytes);
+
+  // A failed reallocation leaves the allocation in place.
+  profile.RecordReallocation(Allocation(1), nullptr, 64, Site(0x200));
+  EXPECT_EQ(0u, profile.call_sites()[1].frees);
+
+  profile.RecordFree(Allocation(1));
+  EXPECT_EQ(1u, profile.call_sites()[1].frees);
+}
+
+TEST(AllocationProfile, FullCallSiteTable_CountsDroppedAllocations) {
+  AllocationProfileBuffer<2, 8> profile;
+  profile.RecordAllocation(Allocation(0), 8, Site(0x100));
+  profile.RecordAllocation(Allocation(1), 8, Site(0x200));
+  profile.RecordAllocation(Allocation(2), 8, Site(0x300));
+  profile.RecordAllocation(Allocation(3), 8, Site(0x100));
+
+  EXPECT_EQ(2u, profile.call_sites().size());
+  EXPECT_EQ(2u, profile.call_sites()[0].allocations);
+  EXPECT_EQ(1u, profile.dropped_allocations());
+  EXPECT_EQ(4u, profile.allocations());
+}
+
+TEST(AllocationProfile, FullLiveTable_CountsUntrackedAllocations) {
+  AllocationProfileBuffer<2, 4> profile;
+  for (size_t i = 0; i < 5; ++i) {
+    profile.RecordAllocation(Allocation(i), 8, Site(0x100));
+  }
+  // One slot is always kept empty.
+  EXPECT_EQ(2u, profile.untracked_allocations());
+  EXPECT_EQ(5u, profile.call_sites()[0].allocations);
+
+  for (size_t i = 0; i < 5; ++i) {
+    profile.RecordFree(Allocation(i));
+  }
+  EXPECT_EQ(3u, profile.call_sites()[0].frees);
+}
+
+TEST(AllocationProfile, ManyAllocationsAndFrees_TracksEveryLifetime) {
+  AllocationProfileBuffer<1, 17> profile;
+
+  // Allocate and free in an interleaved order to exercise collisions and
+  // removal from the middle of probe sequences.
+  for (size_t round = 0; round < 8; ++round) {
+    for (size_t i = 0; i < 16; ++i) {
+      profile.RecordAllocation(Allocation((i * 7 + round) % 64), 8, Site(1));
+    }
+    for (size_t i = 0; i < 16; ++i) {
+      profile.RecordFree(Allocation((i * 5 + round) % 64));
+      profile.RecordFree(Allocation((i * 7 + round) % 64));
+    }
+  }
+
+  EXPECT_EQ(0u, profile.untracked_allocations());
+  EXPECT_EQ(128u, profile.call_sites()[0].allocations);
+  EXPECT_EQ(128u, profile.call_sites()[0].frees);
+}
+
+TEST(AllocationProfile, Reset_ClearsEverything) {
+  AllocationProfileBuffer<4, 8> profile;
+  profile.RecordAllocation(Allocation(0), 8, Site(0x100));
+  profile.Reset();
+
+  EXPECT_TRUE(profile.call_sites().empty());
+  EXPECT_EQ(0u, profile.allocations());
+  EXPECT_EQ(0u, profile.size_histogram()[AllocationProfile::Bucket(8)]);
+
+  // Allocations from before the reset are no longer tracked.
+  profile.RecordFree(Allocation(0));
+  EXPECT_EQ(0u, profile.lifetime_histogram()[AllocationProfile::Bucket(1)]);
+}
+
+}  // namespace
+}  // namespace pw::malloc_profile
@@ -0,0 +1,33 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// PW_MALLOC_CONFIG_PROFILE enables recording of heap allocations by the
+// pw_malloc backend into the global allocation profile. Profiling is disabled
+// by default.
+#if !defined(PW_MALLOC_CONFIG_PROFILE)
+#define PW_MALLOC_CONFIG_PROFILE 0
+#endif  // !defined(PW_MALLOC_CONFIG_PROFILE)
+
+// The number of distinct call sites the global allocation profile can record.
+// Allocations from further call sites are only counted as dropped.
+#if !defined(PW_MALLOC_CONFIG_PROFILE_CALL_SITES)
+#define PW_MALLOC_CONFIG_PROFILE_CALL_SITES 32
+#endif  // !defined(PW_MALLOC_CONFIG_PROFILE_CALL_SITES)
+
+// The number of live allocations whose lifetimes the global allocation profile
+// can track at once. Lifetimes of further allocations are not recorded.
+#if !defined(PW_MALLOC_CONFIG_PROFILE_LIVE_ALLOCATIONS)
+#define PW_MALLOC_CONFIG_PROFILE_LIVE_ALLOCATIONS 128
+#endif  // !defined(PW_MALLOC_CONFIG_PROFILE_LIVE_ALLOCATIONS)
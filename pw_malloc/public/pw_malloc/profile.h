@@ -0,0 +1,217 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_malloc/config.h"
+
+namespace pw::malloc_profile {
+
+// The number of buckets in the size and lifetime histograms. Bucket 0 counts
+// zeros, and bucket i counts values in [2^(i-1), 2^i). The last bucket also
+// counts all larger values.
+inline constexpr size_t kHistogramBuckets = 16;
+
+using Histogram = std::array<uint32_t, kHistogramBuckets>;
+
+// Allocation statistics for one call site.
+struct CallSite {
+  // The return address of the call to malloc, within the calling function.
+  // This identifies the call site without storing any strings on the device;
+  // resolve it to a function and line with the firmware's ELF file.
+  uintptr_t address;
+
+  // The number of allocations made from this call site.
+  uint32_t allocations;
+
+  // The number of allocations from this call site that were freed while their
+  // lifetimes were tracked.
+  uint32_t frees;
+
+  // The total number of bytes requested from this call site.
+  uint64_t bytes;
+
+  // The total lifetime of the freed allocations, so lifetime / frees is the
+  // mean lifetime of an allocation from this call site.
+  uint64_t lifetime;
+};
+
+// Records heap allocations by call site in fixed-size tables, along with
+// histograms of allocation sizes and lifetimes. Allocators call
+// RecordAllocation and RecordFree; see also the PW_MALLOC_PROFILE_* macros.
+//
+// Lifetimes are measured in allocations: an allocation's lifetime is the
+// number of allocations made from when it is allocated until it is freed. This
+// requires no clock, which may not be running when the heap is first used, and
+// does not vary from run to run. Call sites that allocate often and have short
+// lifetimes are the ones that churn the heap.
+//
+// Call sites are found with a linear search, so the cost of recording grows
+// with the number of call sites. Lifetimes are tracked in a hash table of live
+// allocations.
+//
+// AllocationProfile is not synchronized. It must be called with the same
+// serialization as the allocator it profiles.
+class AllocationProfile {
+ public:
+  struct LiveAllocation {
+    const void* ptr;
+    uint32_t call_site_index;
+    uint32_t allocated_at;
+  };
+
+  AllocationProfile(const AllocationProfile&) = delete;
+  AllocationProfile& operator=(const AllocationProfile&) = delete;
+
+  // Records an allocation of size bytes at ptr made from call_site. Failed
+  // allocations, for which ptr is null, are not recorded.
+  void RecordAllocation(const void* ptr, size_t size, const void* call_site);
+
+  // Records that ptr was freed. Pointers that are not tracked are ignored.
+  void RecordFree(const void* ptr);
+
+  // Records a reallocation of old_ptr to size bytes at new_ptr, which is
+  // treated as a free followed by an allocation from call_site.
+  void RecordReallocation(const void* old_ptr,
+                          const void* new_ptr,
+                          size_t size,
+                          const void* call_site);
+
+  // Clears all statistics and stops tracking the allocations that are live.
+  void Reset();
+
+  // The call sites recorded, in the order in which they first allocated.
+  std::span<const CallSite> call_sites() const {
+    return call_sites_.first(call_site_count_);
+  }
+
+  const Histogram& size_histogram() const { return size_histogram_; }
+  const Histogram& lifetime_histogram() const { return lifetime_histogram_; }
+
+  // The total number of allocations recorded.
+  uint32_t allocations() const { return allocations_; }
+
+  // The number of allocations not recorded by call site because the call site
+  // table was full.
+  uint32_t dropped_allocations() const { return dropped_allocations_; }
+
+  // The number of allocations whose lifetimes were not tracked because the
+  // live allocation table was full.
+  uint32_t untracked_allocations() const { return untracked_allocations_; }
+
+  // Returns the histogram bucket for a value.
+  static constexpr size_t Bucket(uint64_t value) {
+    size_t bucket = 0;
+    for (; value != 0u && bucket < kHistogramBuckets - 1; value >>= 1) {
+      bucket += 1;
+    }
+    return bucket;
+  }
+
+ protected:
+  constexpr AllocationProfile(std::span<CallSite> call_sites,
+                              std::span<LiveAllocation> live_allocations)
+      : call_sites_(call_sites),
+        live_allocations_(live_allocations),
+        call_site_count_(0),
+        live_allocation_count_(0),
+        allocations_(0),
+        dropped_allocations_(0),
+        untracked_allocations_(0),
+        size_histogram_{},
+        lifetime_histogram_{} {}
+
+ private:
+  // Returns the index of a call site, adding it if necessary, or
+  // call_sites_.size() if the table is full.
+  size_t FindOrAddCallSite(uintptr_t address);
+
+  // Returns the live allocation slot for ptr, or the empty slot in which to
+  // insert it. Returns nullptr if there is no live allocation table.
+  LiveAllocation* FindSlot(const void* ptr);
+
+  // The slot at which to start searching for ptr.
+  size_t HomeSlot(const void* ptr) const;
+
+  // Removes a live allocation, moving later entries in its probe sequence back
+  // so that lookups do not need tombstones.
+  void RemoveSlot(LiveAllocation& slot);
+
+  std::span<CallSite> call_sites_;
+  std::span<LiveAllocation> live_allocations_;
+  size_t call_site_count_;
+  size_t live_allocation_count_;
+
+  uint32_t allocations_;
+  uint32_t dropped_allocations_;
+  uint32_t untracked_allocations_;
+
+  Histogram size_histogram_;
+  Histogram lifetime_histogram_;
+};
+
+// An AllocationProfile with storage for kCallSites call sites and
+// kLiveAllocations live allocations. Its constructor is constexpr so that a
+// global profile is ready before static initialization, when the heap may
+// first be used.
+template <size_t kCallSites, size_t kLiveAllocations>
+class AllocationProfileBuffer : public AllocationProfile {
+ public:
+  constexpr AllocationProfileBuffer()
+      : AllocationProfile(call_site_storage_, live_allocation_storage_),
+        call_site_storage_{},
+        live_allocation_storage_{} {}
+
+ private:
+  static_assert(kCallSites > 0u, "A profile requires at least one call site");
+
+  std::array<CallSite, kCallSites> call_site_storage_;
+  std::array<LiveAllocation, kLiveAllocations> live_allocation_storage_;
+};
+
+// Returns the profile that pw_malloc backends record to when
+// PW_MALLOC_CONFIG_PROFILE is enabled.
+AllocationProfile& GlobalProfile();
+
+}  // namespace pw::malloc_profile
+
+// Macros for pw_malloc backends to record allocations to the global profile.
+// They must be used directly in the functions that wrap malloc, free, and
+// realloc, since they take the wrapper's return address as the call site. If
+// PW_MALLOC_CONFIG_PROFILE is disabled, they do nothing.
+#if PW_MALLOC_CONFIG_PROFILE
+
+#define PW_MALLOC_PROFILE_ALLOCATION(ptr, size)           \
+  ::pw::malloc_profile::GlobalProfile().RecordAllocation( \
+      ptr, size, __builtin_return_address(0))
+
+#define PW_MALLOC_PROFILE_FREE(ptr) \
+  ::pw::malloc_profile::GlobalProfile().RecordFree(ptr)
+
+#define PW_MALLOC_PROFILE_REALLOCATION(old_ptr, new_ptr, size) \
+  ::pw::malloc_profile::GlobalProfile().RecordReallocation(    \
+      old_ptr, new_ptr, size, __builtin_return_address(0))
+
+#else
+
+#define PW_MALLOC_PROFILE_ALLOCATION(ptr, size) static_cast<void>(0)
+#define PW_MALLOC_PROFILE_FREE(ptr) static_cast<void>(0)
+#define PW_MALLOC_PROFILE_REALLOCATION(old_ptr, new_ptr, size) \
+  static_cast<void>(0)
+
+#endif  // PW_MALLOC_CONFIG_PROFILE
@@ -0,0 +1,39 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_bytes/span.h"
+#include "pw_malloc/profile.h"
+#include "pw_malloc_proto/profile_service.raw_rpc.pb.h"
+
+namespace pw::malloc_profile {
+
+// Sends an AllocationProfile as a stream of ProfileResponses, filling each
+// packet before sending it. The profile is read without synchronization, so if
+// other threads allocate while it is sent, its statistics may be inconsistent
+// by those allocations. Only serve one Get() at a time per service.
+class AllocationProfileService final
+    : public pw_rpc::raw::AllocationProfileService::Service<
+          AllocationProfileService> {
+ public:
+  AllocationProfileService(AllocationProfile& profile)
+      : profile_(profile) {}
+
+  void Get(ServerContext&, ConstByteSpan request, RawServerWriter& writer);
+
+ private:
+  AllocationProfile& profile_;
+};
+
+}  // namespace pw::malloc_profile
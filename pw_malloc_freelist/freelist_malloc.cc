@@ -16,6 +16,7 @@
 
 #include "pw_allocator/freelist_heap.h"
 #include "pw_malloc/malloc.h"
+#include "pw_malloc/profile.h"
 #include "pw_preprocessor/compiler.h"
 #include "pw_preprocessor/util.h"
 
@@ -43,30 +44,53 @@ void pw_MallocInit(uint8_t* heap_low_addr, uint8_t* heap_high_addr) {
 // "__wrap_<function name>" with "<function_name>", and calling
 // "<function name>" will call "__wrap_<function name>" instead
 // Linker options are set in a config in "pw_malloc:pw_malloc_config".
-void* __wrap_malloc(size_t size) { return pw_freelist_heap->Allocate(size); }
+//
+// Each wrapper records its allocations to the pw_malloc allocation profile, if
+// profiling is enabled.
+void* __wrap_malloc(size_t size) {
+  void* ptr = pw_freelist_heap->Allocate(size);
+  PW_MALLOC_PROFILE_ALLOCATION(ptr, size);
+  return ptr;
+}
 
-void __wrap_free(void* ptr) { pw_freelist_heap->Free(ptr); }
+void __wrap_free(void* ptr) {
+  PW_MALLOC_PROFILE_FREE(ptr);
+  pw_freelist_heap->Free(ptr);
+}
 
 void* __wrap_realloc(void* ptr, size_t size) {
-  return pw_freelist_heap->Realloc(ptr, size);
+  void* new_ptr = pw_freelist_heap->Realloc(ptr, size);
+  PW_MALLOC_PROFILE_REALLOCATION(ptr, new_ptr, size);
+  return new_ptr;
 }
 
 void* __wrap_calloc(size_t num, size_t size) {
-  return pw_freelist_heap->Calloc(num, size);
+  void* ptr = pw_freelist_heap->Calloc(num, size);
+  PW_MALLOC_PROFILE_ALLOCATION(ptr, num * size);
+  return ptr;
 }
 
 void* __wrap__malloc_r(struct _reent*, size_t size) {
-  return pw_freelist_heap->Allocate(size);
+  void* ptr = pw_freelist_heap->Allocate(size);
+  PW_MALLOC_PROFILE_ALLOCATION(ptr, size);
+  return ptr;
 }
 
-void __wrap__free_r(struct _reent*, void* ptr) { pw_freelist_heap->Free(ptr); }
+void __wrap__free_r(struct _reent*, void* ptr) {
+  PW_MALLOC_PROFILE_FREE(ptr);
+  pw_freelist_heap->Free(ptr);
+}
 
 void* __wrap__realloc_r(struct _reent*, void* ptr, size_t size) {
-  return pw_freelist_heap->Realloc(ptr, size);
+  void* new_ptr = pw_freelist_heap->Realloc(ptr, size);
+  PW_MALLOC_PROFILE_REALLOCATION(ptr, new_ptr, size);
+  return new_ptr;
 }
 
 void* __wrap__calloc_r(struct _reent*, size_t num, size_t size) {
-  return pw_freelist_heap->Calloc(num, size);
+  void* ptr = pw_freelist_heap->Calloc(num, size);
+  PW_MALLOC_PROFILE_ALLOCATION(ptr, num * size);
+  return ptr;
 }
 #if __cplusplus
 }
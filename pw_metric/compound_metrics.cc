@@ -0,0 +1,157 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/compound_metrics.h"
+
+#include <iterator>
+#include <limits>
+
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::metric {
+namespace internal {
+namespace {
+
+#define _PW_METRIC_BUCKET_TOKEN(index)                      \
+  constexpr Token kBucket##index = PW_TOKENIZE_STRING_MASK( \
+      "metrics", _PW_METRIC_TOKEN_MASK, "bucket_" #index)
+
+_PW_METRIC_BUCKET_TOKEN(0);
+_PW_METRIC_BUCKET_TOKEN(1);
+_PW_METRIC_BUCKET_TOKEN(2);
+_PW_METRIC_BUCKET_TOKEN(3);
+_PW_METRIC_BUCKET_TOKEN(4);
+_PW_METRIC_BUCKET_TOKEN(5);
+_PW_METRIC_BUCKET_TOKEN(6);
+_PW_METRIC_BUCKET_TOKEN(7);
+_PW_METRIC_BUCKET_TOKEN(8);
+_PW_METRIC_BUCKET_TOKEN(9);
+_PW_METRIC_BUCKET_TOKEN(10);
+_PW_METRIC_BUCKET_TOKEN(11);
+_PW_METRIC_BUCKET_TOKEN(12);
+_PW_METRIC_BUCKET_TOKEN(13);
+_PW_METRIC_BUCKET_TOKEN(14);
+_PW_METRIC_BUCKET_TOKEN(15);
+_PW_METRIC_BUCKET_TOKEN(16);
+_PW_METRIC_BUCKET_TOKEN(17);
+_PW_METRIC_BUCKET_TOKEN(18);
+_PW_METRIC_BUCKET_TOKEN(19);
+_PW_METRIC_BUCKET_TOKEN(20);
+_PW_METRIC_BUCKET_TOKEN(21);
+_PW_METRIC_BUCKET_TOKEN(22);
+_PW_METRIC_BUCKET_TOKEN(23);
+_PW_METRIC_BUCKET_TOKEN(24);
+_PW_METRIC_BUCKET_TOKEN(25);
+_PW_METRIC_BUCKET_TOKEN(26);
+_PW_METRIC_BUCKET_TOKEN(27);
+_PW_METRIC_BUCKET_TOKEN(28);
+_PW_METRIC_BUCKET_TOKEN(29);
+_PW_METRIC_BUCKET_TOKEN(30);
+_PW_METRIC_BUCKET_TOKEN(31);
+_PW_METRIC_BUCKET_TOKEN(32);
+
+#undef _PW_METRIC_BUCKET_TOKEN
+
+constexpr Token kBucketNames[] = {
+    kBucket0,
+    kBucket1,
+    kBucket2,
+    kBucket3,
+    kBucket4,
+    kBucket5,
+    kBucket6,
+    kBucket7,
+    kBucket8,
+    kBucket9,
+    kBucket10,
+    kBucket11,
+    kBucket12,
+    kBucket13,
+    kBucket14,
+    kBucket15,
+    kBucket16,
+    kBucket17,
+    kBucket18,
+    kBucket19,
+    kBucket20,
+    kBucket21,
+    kBucket22,
+    kBucket23,
+    kBucket24,
+    kBucket25,
+    kBucket26,
+    kBucket27,
+    kBucket28,
+    kBucket29,
+    kBucket30,
+    kBucket31,
+    kBucket32,
+};
+
+static_assert(std::size(kBucketNames) == kMaxHistogramBuckets);
+
+}  // namespace
+
+Token HistogramBucketName(size_t index) { return kBucketNames[index]; }
+
+}  // namespace internal
+
+void Accumulator::Record(uint32_t value) {
+  count_.Increment();
+
+  constexpr uint32_t kMaxSum = std::numeric_limits<uint32_t>::max();
+  sum_.Set(value > kMaxSum - sum_.value() ? kMaxSum : sum_.value() + value);
+
+  if (value < min_.value()) {
+    min_.Set(value);
+  }
+  if (value > max_.value()) {
+    max_.Set(value);
+  }
+}
+
+void RateCounter::Increment(uint32_t now_ms, uint32_t amount) {
+  AdvanceWindow(now_ms);
+  current_window_ += amount;
+  total_.Increment(amount);
+}
+
+void RateCounter::AdvanceWindow(uint32_t now_ms) {
+  if (!started_) {
+    started_ = true;
+    window_start_ms_ = now_ms;
+    return;
+  }
+
+  // Unsigned subtraction handles timestamps that wrap.
+  const uint32_t elapsed_ms = now_ms - window_start_ms_;
+  const uint32_t window_ms = window_ms_.value();
+  if (elapsed_ms < window_ms) {
+    return;
+  }
+
+  // If more than one window passed, the windows after the current one had no
+  // events.
+  const uint32_t completed =
+      elapsed_ms - window_ms < window_ms ? current_window_ : 0u;
+  last_window_.Set(completed);
+  if (current_window_ > max_window_.value()) {
+    max_window_.Set(current_window_);
+  }
+
+  current_window_ = 0;
+  window_start_ms_ = now_ms - elapsed_ms % window_ms;
+}
+
+}  // namespace pw::metric
@@ -0,0 +1,171 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/compound_metrics.h"
+
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "pw_tokenizer/hash.h"
+
+namespace pw::metric {
+namespace {
+
+constexpr Token kName = 0x1234;
+
+// Returns the value of the metric in the group with the given name.
+uint32_t Get(Group& group, const char* name) {
+  const Token token = tokenizer::Hash(name) & _PW_METRIC_TOKEN_MASK;
+  for (const Metric& metric : group.metrics()) {
+    if (metric.name() == token) {
+      return metric.as_int();
+    }
+  }
+  ADD_FAILURE();
+  return 0;
+}
+
+TEST(Log2Histogram, Record_CountsPowerOfTwoBuckets) {
+  Log2Histogram<> histogram(kName);
+  EXPECT_EQ(histogram.bucket_count(), 33u);
+
+  histogram.Record(0);
+  histogram.Record(1);
+  histogram.Record(2);
+  histogram.Record(3);
+  histogram.Record(4);
+  histogram.Record(1000);
+  histogram.Record(std::numeric_limits<uint32_t>::max());
+
+  EXPECT_EQ(histogram.bucket(0), 1u);
+  EXPECT_EQ(histogram.bucket(1), 1u);
+  EXPECT_EQ(histogram.bucket(2), 2u);
+  EXPECT_EQ(histogram.bucket(3), 1u);
+  EXPECT_EQ(histogram.bucket(10), 1u);  // [512, 1024)
+  EXPECT_EQ(histogram.bucket(32), 1u);
+}
+
+TEST(Log2Histogram, Record_ClampsToLastBucket) {
+  Log2Histogram<4> histogram(kName);
+  histogram.Record(4);
+  histogram.Record(8);
+  histogram.Record(1u << 20);
+  EXPECT_EQ(histogram.bucket(3), 3u);
+}
+
+TEST(Log2Histogram, Reset_ClearsBuckets) {
+  Log2Histogram<4> histogram(kName);
+  histogram.Record(1);
+  histogram.Record(5);
+  histogram.Reset();
+  for (size_t i = 0; i < histogram.bucket_count(); ++i) {
+    EXPECT_EQ(histogram.bucket(i), 0u);
+  }
+}
+
+TEST(Log2Histogram, BucketsAreMetricsInTheGroup) {
+  Group parent(0x5555);
+  Log2Histogram<4> histogram(kName, parent);
+  histogram.Record(2);
+  histogram.Record(3);
+
+  EXPECT_EQ(parent.children().size(), 1u);
+  EXPECT_EQ(histogram.group().name(), kName);
+  EXPECT_EQ(histogram.group().metrics().size(), 4u);
+  EXPECT_EQ(Get(histogram.group(), "bucket_0"), 0u);
+  EXPECT_EQ(Get(histogram.group(), "bucket_2"), 2u);
+}
+
+TEST(LinearHistogram, Record_CountsEqualBuckets) {
+  LinearHistogram<4> histogram(kName, 100, 10);
+  histogram.Record(0);    // Below the first bucket.
+  histogram.Record(100);
+  histogram.Record(109);
+  histogram.Record(110);
+  histogram.Record(139);
+  histogram.Record(500);  // Past the last bucket.
+
+  EXPECT_EQ(histogram.bucket(0), 3u);
+  EXPECT_EQ(histogram.bucket(1), 1u);
+  EXPECT_EQ(histogram.bucket(2), 0u);
+  EXPECT_EQ(histogram.bucket(3), 2u);
+
+  EXPECT_EQ(Get(histogram.group(), "first_bucket_min"), 100u);
+  EXPECT_EQ(Get(histogram.group(), "bucket_width"), 10u);
+  EXPECT_EQ(histogram.group().metrics().size(), 6u);
+}
+
+TEST(Accumulator, Record_TracksCountSumMinMax) {
+  Accumulator accumulator(kName);
+  EXPECT_EQ(accumulator.count(), 0u);
+  EXPECT_EQ(accumulator.mean(), 0u);
+
+  accumulator.Record(10);
+  accumulator.Record(30);
+  accumulator.Record(5);
+
+  EXPECT_EQ(accumulator.count(), 3u);
+  EXPECT_EQ(accumulator.sum(), 45u);
+  EXPECT_EQ(accumulator.min(), 5u);
+  EXPECT_EQ(accumulator.max(), 30u);
+  EXPECT_EQ(accumulator.mean(), 15u);
+  EXPECT_EQ(Get(accumulator.group(), "sum"), 45u);
+}
+
+TEST(Accumulator, Record_SumSaturates) {
+  Accumulator accumulator(kName);
+  accumulator.Record(std::numeric_limits<uint32_t>::max() - 1);
+  accumulator.Record(10);
+  EXPECT_EQ(accumulator.sum(), std::numeric_limits<uint32_t>::max());
+}
+
+TEST(RateCounter, Increment_CountsPerWindow) {
+  RateCounter rate(kName, 1000);
+  EXPECT_EQ(Get(rate.group(), "window_ms"), 1000u);
+
+  rate.Increment(0);
+  rate.Increment(500, 2);
+  EXPECT_EQ(rate.last_window(), 0u);
+
+  rate.Increment(1000);
+  EXPECT_EQ(rate.last_window(), 3u);
+
+  rate.Increment(1999, 5);
+  rate.Increment(2500);
+  EXPECT_EQ(rate.last_window(), 6u);
+  EXPECT_EQ(rate.max_window(), 6u);
+  EXPECT_EQ(rate.total(), 10u);
+}
+
+TEST(RateCounter, Increment_IdleWindowsCountZero) {
+  RateCounter rate(kName, 100);
+  rate.Increment(0, 4);
+  rate.Increment(350);
+  EXPECT_EQ(rate.last_window(), 0u);
+  EXPECT_EQ(rate.max_window(), 4u);
+
+  // The window containing 350 started at 300.
+  rate.Increment(400);
+  EXPECT_EQ(rate.last_window(), 1u);
+}
+
+TEST(RateCounter, Increment_TimestampsWrap) {
+  RateCounter rate(kName, 100);
+  rate.Increment(std::numeric_limits<uint32_t>::max() - 49, 2);
+  rate.Increment(50);
+  EXPECT_EQ(rate.last_window(), 2u);
+}
+
+}  // namespace
+}  // namespace pw::metric
@@ -15,6 +15,8 @@
 #include "pw_metric/metric.h"
 
 #include <array>
+#include <atomic>
+#include <cstring>
 #include <span>
 
 #include "pw_assert/check.h"
@@ -62,27 +64,30 @@ Metric::Metric(Token name, uint32_t value, IntrusiveList<Metric>& metrics)
 
 float Metric::as_float() const {
   PW_DCHECK(is_float());
-  return float_;
+  const uint32_t bits = value_.load(std::memory_order_relaxed);
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
 }
 
 uint32_t Metric::as_int() const {
   PW_DCHECK(is_int());
-  return uint_;
+  return value_.load(std::memory_order_relaxed);
 }
 
 void Metric::Increment(uint32_t amount) {
   PW_DCHECK(is_int());
-  uint_ += amount;
+  value_.fetch_add(amount, std::memory_order_relaxed);
 }
 
 void Metric::SetInt(uint32_t value) {
   PW_DCHECK(is_int());
-  uint_ = value;
+  value_.store(value, std::memory_order_relaxed);
 }
 
 void Metric::SetFloat(float value) {
   PW_DCHECK(is_float());
-  float_ = value;
+  value_.store(FloatToBits(value), std::memory_order_relaxed);
 }
 
 void Metric::Dump(int level) {
@@ -0,0 +1,290 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/metric_service_raw.h"
+
+#include <cstring>
+#include <optional>
+#include <span>
+
+#include "pw_assert/check.h"
+#include "pw_containers/vector.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_protobuf/serialized_size.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
+
+namespace pw::metric {
+namespace {
+
+// Field numbers from metric_service.proto. The generated pw_protobuf code for
+// the pw.metric package declares a pw::metric::Metric namespace, which
+// collides with the Metric class, so the messages are encoded directly.
+namespace MetricField {
+constexpr uint32_t kTokenPath = 1;
+constexpr uint32_t kAsFloat = 3;
+constexpr uint32_t kAsInt = 4;
+}  // namespace MetricField
+
+namespace RequestField {
+constexpr uint32_t kCursor = 2;
+constexpr uint32_t kMaxMetrics = 3;
+constexpr uint32_t kChangedOnly = 4;
+}  // namespace RequestField
+
+namespace ResponseField {
+constexpr uint32_t kMetrics = 1;
+constexpr uint32_t kCursor = 2;
+}  // namespace ResponseField
+
+// Bytes reserved in each response for the cursor field.
+constexpr size_t kCursorFieldSizeBytes =
+    protobuf::SizeOfFieldKey(ResponseField::kCursor) +
+    protobuf::kMaxSizeBytesUint32;
+
+struct DumpOptions {
+  uint32_t cursor = 0;
+  uint32_t max_metrics = 0;
+  bool changed_only = false;
+};
+
+Status DecodeRequest(ConstByteSpan request, DumpOptions& options) {
+  protobuf::Decoder decoder(request);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (decoder.FieldNumber()) {
+      case RequestField::kCursor:
+        PW_TRY(decoder.ReadUint32(&options.cursor));
+        break;
+      case RequestField::kMaxMetrics:
+        PW_TRY(decoder.ReadUint32(&options.max_metrics));
+        break;
+      case RequestField::kChangedOnly:
+        PW_TRY(decoder.ReadBool(&options.changed_only));
+        break;
+      default:
+        break;
+    }
+  }
+  return status.IsOutOfRange() ? OkStatus() : Status::DataLoss();
+}
+
+// Returns the bits of a metric's value, for comparison with the last value
+// sent and for encoding integers.
+uint32_t ValueBits(const Metric& metric) {
+  if (metric.is_int()) {
+    return metric.as_int();
+  }
+  const float value = metric.as_float();
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+// Walks a metric tree and encodes the selected metrics into as few responses
+// as possible. Each metric's position in the walk is its cursor.
+class MetricEncoder {
+ public:
+  MetricEncoder(rpc::RawServerWriter& writer,
+                const DumpOptions& options,
+                std::span<uint32_t> last_sent_values)
+      : writer_(writer),
+        options_(options),
+        last_sent_values_(last_sent_values),
+        position_(0),
+        next_cursor_(0),
+        metrics_sent_(0),
+        done_(false) {}
+
+  void Walk(const IntrusiveList<Metric>& metrics) {
+    for (const Metric& metric : metrics) {
+      if (done_) {
+        return;
+      }
+      ScopedName scoped_name(metric.name(), *this);
+      Encode(metric);
+    }
+  }
+
+  void Walk(const IntrusiveList<Group>& groups) {
+    for (const Group& group : groups) {
+      Walk(group);
+    }
+  }
+
+  void Walk(const Group& group) {
+    if (done_) {
+      return;
+    }
+    ScopedName scoped_name(group.name(), *this);
+    Walk(group.children());
+    Walk(group.metrics());
+  }
+
+  // Sends the final response, if any, and returns the status of the dump.
+  Status Finish() {
+    if (status_.ok() && response_.has_value()) {
+      status_ = Send(next_cursor_);
+    } else if (response_.has_value()) {
+      response_.reset();
+      writer_.ReleaseBuffer();
+    }
+    return status_;
+  }
+
+ private:
+  // Exists to safely push/pop parent groups from the explicit stack.
+  struct ScopedName {
+    ScopedName(Token name, MetricEncoder& rhs) : encoder(rhs) {
+      PW_CHECK_INT_LT(encoder.path_.size(),
+                      encoder.path_.capacity(),
+                      "Metrics are too deep; bump path_ capacity");
+      encoder.path_.push_back(name);
+    }
+    ~ScopedName() { encoder.path_.pop_back(); }
+    MetricEncoder& encoder;
+  };
+
+  void Encode(const Metric& metric) {
+    const uint32_t position = position_++;
+    if (position < options_.cursor) {
+      return;
+    }
+
+    const uint32_t bits = ValueBits(metric);
+    const bool tracked = position < last_sent_values_.size();
+    if (options_.changed_only && tracked &&
+        last_sent_values_[position] == bits) {
+      return;
+    }
+
+    // Stop at the first metric past the limit, so the cursor is only nonzero
+    // if there is more to send.
+    if (options_.max_metrics != 0u && metrics_sent_ == options_.max_metrics) {
+      next_cursor_ = position;
+      done_ = true;
+      return;
+    }
+
+    if (Status status = EncodeMetric(metric, bits, position); !status.ok()) {
+      status_ = status;
+      done_ = true;
+      return;
+    }
+
+    if (tracked) {
+      last_sent_values_[position] = bits;
+    }
+    metrics_sent_ += 1;
+  }
+
+  Status EncodeMetric(const Metric& metric, uint32_t bits, uint32_t position) {
+    using protobuf::SizeOfField;
+    using protobuf::WireType;
+
+    const size_t value_size =
+        metric.is_float()
+            ? SizeOfField(
+                  MetricField::kAsFloat, WireType::kFixed32, sizeof(float))
+            : SizeOfField(MetricField::kAsInt,
+                          WireType::kVarint,
+                          varint::EncodedSize(bits));
+    const size_t payload_size =
+        SizeOfField(MetricField::kTokenPath,
+                    WireType::kDelimited,
+                    path_.size() * sizeof(Token)) +
+        value_size;
+    const size_t field_size = SizeOfField(ResponseField::kMetrics,
+                                          WireType::kDelimited,
+                                          payload_size) +
+                              kCursorFieldSizeBytes;
+
+    if (response_.has_value() &&
+        response_->size() + field_size > buffer_size_) {
+      PW_TRY(Send(position));
+    }
+
+    if (!response_.has_value()) {
+      const ByteSpan buffer = writer_.PayloadBuffer();
+      buffer_size_ = buffer.size();
+      response_.emplace(buffer);
+      if (field_size > buffer_size_) {
+        return Status::ResourceExhausted();
+      }
+    }
+
+    {
+      protobuf::StreamEncoder encoder =
+          response_->GetNestedEncoder(ResponseField::kMetrics, payload_size);
+      encoder.WritePackedFixed32(
+          MetricField::kTokenPath,
+          std::span<const uint32_t>(path_.data(), path_.size()));
+      if (metric.is_float()) {
+        encoder.WriteFloat(MetricField::kAsFloat, metric.as_float());
+      } else {
+        encoder.WriteUint32(MetricField::kAsInt, bits);
+      }
+    }
+    return response_->status();
+  }
+
+  Status Send(uint32_t cursor) {
+    if (cursor != 0u) {
+      response_->WriteUint32(ResponseField::kCursor, cursor);
+    }
+    Status status = response_->status();
+    if (status.ok()) {
+      status = writer_.Write(*response_);
+    } else {
+      writer_.ReleaseBuffer();
+    }
+    response_.reset();
+    return status;
+  }
+
+  rpc::RawServerWriter& writer_;
+  const DumpOptions& options_;
+  const std::span<uint32_t> last_sent_values_;
+
+  std::optional<protobuf::MemoryEncoder> response_;
+  size_t buffer_size_ = 0;
+
+  Vector<Token, 4 /* max depth */> path_;
+  uint32_t position_;
+  uint32_t next_cursor_;
+  uint32_t metrics_sent_;
+  bool done_;
+  Status status_;
+};
+
+}  // namespace
+
+void RawMetricService::Get(ServerContext&,
+                           ConstByteSpan request,
+                           RawServerWriter& writer) {
+  DumpOptions options;
+  if (Status status = DecodeRequest(request, options); !status.ok()) {
+    writer.Finish(status);
+    return;
+  }
+
+  MetricEncoder encoder(writer, options, last_sent_values_);
+  encoder.Walk(metrics_);
+  encoder.Walk(groups_);
+  writer.Finish(encoder.Finish());
+}
+
+}  // namespace pw::metric
@@ -0,0 +1,229 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/metric_service_raw.h"
+
+#include <array>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_rpc/raw/test_method_context.h"
+
+namespace pw::metric {
+namespace {
+
+// Field numbers from metric_service.proto.
+constexpr uint32_t kRequestCursor = 2;
+constexpr uint32_t kRequestMaxMetrics = 3;
+constexpr uint32_t kRequestChangedOnly = 4;
+constexpr uint32_t kResponseMetrics = 1;
+constexpr uint32_t kResponseCursor = 2;
+
+struct DecodedResponse {
+  size_t metrics = 0;
+  uint32_t cursor = 0;
+};
+
+DecodedResponse Decode(ConstByteSpan response) {
+  DecodedResponse decoded;
+  protobuf::Decoder decoder(response);
+  while (decoder.Next().ok()) {
+    if (decoder.FieldNumber() == kResponseMetrics) {
+      decoded.metrics += 1;
+    } else if (decoder.FieldNumber() == kResponseCursor) {
+      EXPECT_EQ(OkStatus(), decoder.ReadUint32(&decoded.cursor));
+    }
+  }
+  return decoded;
+}
+
+template <typename Responses>
+size_t CountMetrics(const Responses& responses) {
+  size_t count = 0;
+  for (const ConstByteSpan& response : responses) {
+    count += Decode(response).metrics;
+  }
+  return count;
+}
+
+class RawMetricServiceTest : public ::testing::Test {
+ protected:
+  ConstByteSpan Request(uint32_t cursor,
+                        uint32_t max_metrics,
+                        bool changed_only = false) {
+    protobuf::MemoryEncoder encoder(request_buffer_);
+    encoder.WriteUint32(kRequestCursor, cursor);
+    encoder.WriteUint32(kRequestMaxMetrics, max_metrics);
+    encoder.WriteBool(kRequestChangedOnly, changed_only);
+    EXPECT_EQ(OkStatus(), encoder.status());
+    return std::span(request_buffer_).first(encoder.size());
+  }
+
+  PW_METRIC_GROUP(root_, "/");
+  PW_METRIC(root_, a_, "a", 1u);
+  PW_METRIC(root_, b_, "b", 2.f);
+  PW_METRIC(root_, c_, "c", 3u);
+
+  PW_METRIC_GROUP(inner_, "inner");
+  PW_METRIC(inner_, x_, "x", 4u);
+  PW_METRIC(inner_, y_, "y", 5u);
+
+  std::array<std::byte, 32> request_buffer_;
+};
+
+TEST_F(RawMetricServiceTest, Get_EmptyRequest_SendsAllMetrics) {
+  root_.Add(inner_);
+
+  PW_RAW_TEST_METHOD_CONTEXT(RawMetricService, Get)
+  ctx(root_.metrics(), root_.children());
+  ctx.call({});
+
+  EXPECT_TRUE(ctx.done());
+  EXPECT_EQ(OkStatus(), ctx.status());
+  ASSERT_EQ(1u, ctx.responses().size());
+  const DecodedResponse response = Decode(ctx.responses()[0]);
+  EXPECT_EQ(5u, response.metrics);
+  EXPECT_EQ(0u, response.cursor);
+}
+
+TEST_F(RawMetricServiceTest, Get_FillsPacketsBeforeSending) {
+  PW_METRIC_GROUP(group, "many");
+  std::array<TypedMetric<uint32_t>, 12> metrics = {{{1, 1u},
+                                                    {2, 2u},
+                                                    {3, 3u},
+                                                    {4, 4u},
+                                                    {5, 5u},
+                                                    {6, 6u},
+                                                    {7, 7u},
+                                                    {8, 8u},
+                                                    {9, 9u},
+                                                    {10, 10u},
+                                                    {11, 11u},
+                                                    {12, 12u}}};
+  for (auto& metric : metrics) {
+    group.Add(metric);
+  }
+  IntrusiveList<Group> groups = {&group};
+
+  // Each metric is 14 bytes encoded, so a 128-byte packet cannot hold all 12.
+  PW_RAW_TEST_METHOD_CONTEXT(RawMetricService, Get, 6, 128)
+  ctx(root_.metrics(), groups);
+  ctx.call({});
+
+  EXPECT_EQ(OkStatus(), ctx.status());
+  ASSERT_GT(ctx.responses().size(), 1u);
+  EXPECT_LT(ctx.responses().size(), 5u);
+  EXPECT_EQ(15u, CountMetrics(ctx.responses()));
+
+  // Every response but the last has the cursor of the next response.
+  uint32_t expected_cursor = 0;
+  for (size_t i = 0; i < ctx.responses().size(); ++i) {
+    const DecodedResponse response = Decode(ctx.responses()[i]);
+    expected_cursor += response.metrics;
+    if (i + 1 < ctx.responses().size()) {
+      EXPECT_EQ(expected_cursor, response.cursor);
+    } else {
+      EXPECT_EQ(0u, response.cursor);
+    }
+  }
+  groups.clear();
+}
+
+TEST_F(RawMetricServiceTest, Get_MaxMetrics_Paginates) {
+  root_.Add(inner_);
+
+  PW_RAW_TEST_METHOD_CONTEXT(RawMetricService, Get)
+  ctx(root_.metrics(), root_.children());
+
+  ctx.call(Request(0, 2));
+  ASSERT_EQ(1u, ctx.responses().size());
+  DecodedResponse response = Decode(ctx.responses().back());
+  EXPECT_EQ(2u, response.metrics);
+  EXPECT_EQ(2u, response.cursor);
+
+  ctx.call(Request(response.cursor, 2));
+  response = Decode(ctx.responses().back());
+  EXPECT_EQ(2u, response.metrics);
+  EXPECT_EQ(4u, response.cursor);
+
+  ctx.call(Request(response.cursor, 2));
+  response = Decode(ctx.responses().back());
+  EXPECT_EQ(1u, response.metrics);
+  EXPECT_EQ(0u, response.cursor);
+}
+
+TEST_F(RawMetricServiceTest, Get_MaxMetricsAtEnd_CursorIsZero) {
+  PW_RAW_TEST_METHOD_CONTEXT(RawMetricService, Get)
+  ctx(root_.metrics(), root_.children());
+
+  ctx.call(Request(0, 3));
+  const DecodedResponse response = Decode(ctx.responses().back());
+  EXPECT_EQ(3u, response.metrics);
+  EXPECT_EQ(0u, response.cursor);
+}
+
+TEST_F(RawMetricServiceTest, Get_ChangedOnly_SendsChangedMetrics) {
+  root_.Add(inner_);
+  std::array<uint32_t, 5> last_sent{};
+
+  PW_RAW_TEST_METHOD_CONTEXT(RawMetricService, Get)
+  ctx(root_.metrics(), root_.children(), last_sent);
+
+  // All metrics are nonzero, so they all differ from the initial values.
+  ctx.call(Request(0, 0, true));
+  EXPECT_EQ(5u, Decode(ctx.responses().back()).metrics);
+
+  // Nothing changed, so nothing is sent.
+  ctx.call(Request(0, 0, true));
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(0u, ctx.responses().size());
+
+  x_.Increment();
+  b_.Set(2.5f);
+  ctx.call(Request(0, 0, true));
+  EXPECT_EQ(2u, Decode(ctx.responses().back()).metrics);
+
+  // A full dump is unaffected by change tracking.
+  ctx.call(Request(0, 0));
+  EXPECT_EQ(5u, Decode(ctx.responses().back()).metrics);
+}
+
+TEST_F(RawMetricServiceTest, Get_ChangedOnly_UntrackedMetricsAlwaysSent) {
+  std::array<uint32_t, 1> last_sent{};
+
+  PW_RAW_TEST_METHOD_CONTEXT(RawMetricService, Get)
+  ctx(root_.metrics(), root_.children(), last_sent);
+
+  ctx.call(Request(0, 0, true));
+  EXPECT_EQ(3u, Decode(ctx.responses().back()).metrics);
+  ctx.call(Request(0, 0, true));
+  EXPECT_EQ(2u, Decode(ctx.responses().back()).metrics);
+}
+
+TEST_F(RawMetricServiceTest, Get_MalformedRequest_DataLoss) {
+  constexpr std::array<std::byte, 2> kMalformed = {std::byte{0x10},
+                                                   std::byte{0xff}};
+  PW_RAW_TEST_METHOD_CONTEXT(RawMetricService, Get)
+  ctx(root_.metrics(), root_.children());
+  ctx.call(kMalformed);
+
+  EXPECT_TRUE(ctx.done());
+  EXPECT_EQ(Status::DataLoss(), ctx.status());
+  EXPECT_EQ(0u, ctx.responses().size());
+}
+
+}  // namespace
+}  // namespace pw::metric
@@ -0,0 +1,241 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "pw_assert/assert.h"
+#include "pw_metric/metric.h"
+
+// Compound metrics are metric groups whose metrics together track a
+// distribution or rate. Each compound metric is a Group, so it is dumped and
+// served by MetricService like any other group, and host tools reconstruct it
+// from the names of its metrics.
+//
+// Compound metrics are updated without locks. Each update may change several
+// metrics, so updates to the same compound metric from multiple threads or
+// interrupts must be synchronized by the caller.
+namespace pw::metric {
+namespace internal {
+
+// Returns the token for "bucket_<index>", the name of a histogram bucket.
+Token HistogramBucketName(size_t index);
+
+}  // namespace internal
+
+inline constexpr size_t kMaxHistogramBuckets = 33;
+
+// A histogram with a fixed number of buckets, each counting recorded values.
+// Use one of the derived Log2Histogram or LinearHistogram classes.
+template <size_t kBuckets>
+class Histogram {
+ public:
+  static_assert(kBuckets > 0u && kBuckets <= kMaxHistogramBuckets);
+
+  static constexpr size_t bucket_count() { return kBuckets; }
+
+  uint32_t bucket(size_t index) const { return buckets_[index].value(); }
+
+  // Sets every bucket to zero, e.g. before recording a new snapshot.
+  void Reset() {
+    for (TypedMetric<uint32_t>& bucket : buckets_) {
+      bucket.Set(0u);
+    }
+  }
+
+  Group& group() { return group_; }
+
+  Histogram(const Histogram&) = delete;
+  Histogram& operator=(const Histogram&) = delete;
+
+ protected:
+  explicit Histogram(Token name)
+      : Histogram(name, std::make_index_sequence<kBuckets>()) {}
+
+  Histogram(Token name, Group& parent)
+      : Histogram(name, parent, std::make_index_sequence<kBuckets>()) {}
+
+  // Counts a value in the given bucket, or the last bucket if it is past the
+  // end.
+  void IncrementBucket(size_t index) {
+    buckets_[std::min(index, kBuckets - 1)].Increment();
+  }
+
+  Group group_;
+
+ private:
+  template <size_t... kIndices>
+  Histogram(Token name, std::index_sequence<kIndices...>)
+      : group_(name),
+        buckets_{{{internal::HistogramBucketName(kIndices),
+                   0u,
+                   group_.metrics()}...}} {}
+
+  template <size_t... kIndices>
+  Histogram(Token name, Group& parent, std::index_sequence<kIndices...>)
+      : group_(name, parent.children()),
+        buckets_{{{internal::HistogramBucketName(kIndices),
+                   0u,
+                   group_.metrics()}...}} {}
+
+  std::array<TypedMetric<uint32_t>, kBuckets> buckets_;
+};
+
+// A histogram with power-of-two bucket sizes. Bucket 0 counts zeroes, and
+// bucket N counts values in [2^(N-1), 2^N). Values past the last bucket are
+// counted in the last bucket. The default of 33 buckets covers every uint32_t.
+template <size_t kBuckets = kMaxHistogramBuckets>
+class Log2Histogram : public Histogram<kBuckets> {
+ public:
+  explicit Log2Histogram(Token name) : Histogram<kBuckets>(name) {}
+  Log2Histogram(Token name, Group& parent)
+      : Histogram<kBuckets>(name, parent) {}
+
+  void Record(uint32_t value) {
+    this->IncrementBucket(value == 0u ? 0u : 64 - __builtin_clzll(value));
+  }
+};
+
+// A histogram with equally sized buckets. Bucket N counts values in
+// [first_bucket_min + N * bucket_width, first_bucket_min + (N + 1) *
+// bucket_width). Values below the first bucket are counted in the first
+// bucket, and values past the last bucket in the last.
+//
+// The group also records the first bucket's minimum and the bucket width, so
+// that host tools can recover the bucket boundaries.
+template <size_t kBuckets>
+class LinearHistogram : public Histogram<kBuckets> {
+ public:
+  // Precondition: bucket_width is not 0.
+  LinearHistogram(Token name, uint32_t first_bucket_min, uint32_t bucket_width)
+      : Histogram<kBuckets>(name) {
+    Init(first_bucket_min, bucket_width);
+  }
+
+  LinearHistogram(Token name,
+                  Group& parent,
+                  uint32_t first_bucket_min,
+                  uint32_t bucket_width)
+      : Histogram<kBuckets>(name, parent) {
+    Init(first_bucket_min, bucket_width);
+  }
+
+  void Record(uint32_t value) {
+    const uint32_t min = first_bucket_min_.value();
+    this->IncrementBucket(value < min ? 0u
+                                      : (value - min) / bucket_width_.value());
+  }
+
+ private:
+  void Init(uint32_t first_bucket_min, uint32_t bucket_width) {
+    PW_ASSERT(bucket_width != 0u);
+    first_bucket_min_.Set(first_bucket_min);
+    bucket_width_.Set(bucket_width);
+  }
+
+  PW_METRIC(this->group_, first_bucket_min_, "first_bucket_min", 0u);
+  PW_METRIC(this->group_, bucket_width_, "bucket_width", 1u);
+};
+
+// Tracks the count, sum, minimum and maximum of recorded values, from which
+// the mean is derived. The sum saturates at the largest uint32_t.
+class Accumulator {
+ public:
+  explicit Accumulator(Token name) : group_(name) {}
+  Accumulator(Token name, Group& parent) : group_(name, parent.children()) {}
+
+  Accumulator(const Accumulator&) = delete;
+  Accumulator& operator=(const Accumulator&) = delete;
+
+  void Record(uint32_t value);
+
+  uint32_t count() const { return count_.value(); }
+  uint32_t sum() const { return sum_.value(); }
+
+  // The minimum is the largest uint32_t until a value is recorded.
+  uint32_t min() const { return min_.value(); }
+  uint32_t max() const { return max_.value(); }
+
+  // Returns 0 if no values have been recorded.
+  uint32_t mean() const { return count() == 0u ? 0u : sum() / count(); }
+
+  Group& group() { return group_; }
+
+ private:
+  Group group_;
+  PW_METRIC(group_, count_, "count", 0u);
+  PW_METRIC(group_, sum_, "sum", 0u);
+  PW_METRIC(group_, min_, "min", std::numeric_limits<uint32_t>::max());
+  PW_METRIC(group_, max_, "max", 0u);
+};
+
+// Counts events in fixed time windows. Timestamps are provided by the caller,
+// in milliseconds from any monotonic source; they may wrap.
+//
+// The group records the window length, the count in the last completed
+// window, the largest count in any completed window, and the total count.
+class RateCounter {
+ public:
+  // Precondition: window_ms is not 0.
+  RateCounter(Token name, uint32_t window_ms)
+      : group_(name), window_start_ms_(0), current_window_(0), started_(false) {
+    Init(window_ms);
+  }
+
+  RateCounter(Token name, Group& parent, uint32_t window_ms)
+      : group_(name, parent.children()),
+        window_start_ms_(0),
+        current_window_(0),
+        started_(false) {
+    Init(window_ms);
+  }
+
+  RateCounter(const RateCounter&) = delete;
+  RateCounter& operator=(const RateCounter&) = delete;
+
+  void Increment(uint32_t now_ms, uint32_t amount = 1u);
+
+  uint32_t window_ms() const { return window_ms_.value(); }
+  uint32_t last_window() const { return last_window_.value(); }
+  uint32_t max_window() const { return max_window_.value(); }
+  uint32_t total() const { return total_.value(); }
+
+  Group& group() { return group_; }
+
+ private:
+  void Init(uint32_t window_ms) {
+    PW_ASSERT(window_ms != 0u);
+    window_ms_.Set(window_ms);
+  }
+
+  // Completes any windows that ended before now_ms.
+  void AdvanceWindow(uint32_t now_ms);
+
+  Group group_;
+  PW_METRIC(group_, window_ms_, "window_ms", 1u);
+  PW_METRIC(group_, last_window_, "last_window", 0u);
+  PW_METRIC(group_, max_window_, "max_window", 0u);
+  PW_METRIC(group_, total_, "total", 0u);
+
+  uint32_t window_start_ms_;
+  uint32_t current_window_;
+  bool started_;
+};
+
+}  // namespace pw::metric
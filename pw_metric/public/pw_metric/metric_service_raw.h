@@ -0,0 +1,59 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_metric/metric.h"
+#include "pw_metric_proto/metric_service.raw_rpc.pb.h"
+
+namespace pw::metric {
+
+// A MetricService that encodes metrics directly into outgoing RPC packets,
+// filling each packet before sending it. Unlike the nanopb MetricService, it
+// supports the paging and delta fields of MetricRequest:
+//
+//   cursor       - resumes a dump from the cursor of a previous response
+//   max_metrics  - limits the number of metrics sent by one request
+//   changed_only - only sends metrics whose values changed since last sent
+//
+// Every response carries the cursor at which to resume after it, so a client
+// can page through a large metric tree with bounded requests, or resume a dump
+// whose stream was interrupted.
+//
+// Delta mode requires storage for the last value sent of each metric, indexed
+// by the metric's position in the tree. Metrics beyond the end of the storage
+// are always sent. The service is not synchronized; only serve one Get() at a
+// time per service, which is the case with a single RPC thread.
+class RawMetricService final
+    : public pw_rpc::raw::MetricService::Service<RawMetricService> {
+ public:
+  RawMetricService(const IntrusiveList<Metric>& metrics,
+                   const IntrusiveList<Group>& groups,
+                   std::span<uint32_t> last_sent_values = {})
+      : metrics_(metrics),
+        groups_(groups),
+        last_sent_values_(last_sent_values) {}
+
+  void Get(ServerContext&, ConstByteSpan request, RawServerWriter& writer);
+
+ private:
+  const IntrusiveList<Metric>& metrics_;
+  const IntrusiveList<Group>& groups_;
+  const std::span<uint32_t> last_sent_values_;
+};
+
+}  // namespace pw::metric
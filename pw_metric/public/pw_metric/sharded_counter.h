@@ -0,0 +1,115 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/assert.h"
+#include "pw_metric/metric.h"
+#include "pw_preprocessor/arguments.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::metric {
+
+// A counter that is incremented concurrently from several CPU cores.
+//
+// Each core increments its own shard, which is aligned to its own cache line,
+// so increments from different cores never contend for the same line. The
+// shard is chosen by the caller, typically the index of the current core.
+//
+// The counter's metric, which is what Dump() and MetricService report, only
+// changes when Publish() moves the shards' counts into it. Call Publish()
+// before dumping or exporting metrics. value() always includes unpublished
+// counts.
+//
+// Like Metric, the API is safe to use from any thread or interrupt.
+template <size_t kShards, size_t kShardAlignment = 64>
+class ShardedCounter {
+ public:
+  static_assert(kShards > 0u);
+
+  ShardedCounter(Token name) : metric_(name, 0u) {}
+  ShardedCounter(Token name, IntrusiveList<Metric>& metrics)
+      : metric_(name, 0u, metrics) {}
+
+  ShardedCounter(const ShardedCounter&) = delete;
+  ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+  // Precondition: shard < kShards.
+  void Increment(size_t shard, uint32_t amount = 1u) {
+    PW_DASSERT(shard < kShards);
+    shards_[shard].count.fetch_add(amount, std::memory_order_relaxed);
+  }
+
+  // Returns the published count plus the counts in all shards.
+  uint32_t value() const {
+    uint32_t total = metric_.value();
+    for (const Shard& shard : shards_) {
+      total += shard.count.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  // Moves the counts in all shards into the metric.
+  void Publish() {
+    for (Shard& shard : shards_) {
+      metric_.Increment(shard.count.exchange(0, std::memory_order_relaxed));
+    }
+  }
+
+  const TypedMetric<uint32_t>& metric() const { return metric_; }
+
+  static constexpr size_t shard_count() { return kShards; }
+
+ private:
+  struct alignas(kShardAlignment) Shard {
+    std::atomic<uint32_t> count{0};
+  };
+
+  TypedMetric<uint32_t> metric_;
+  std::array<Shard, kShards> shards_;
+};
+
+// Declares a ShardedCounter, optionally adding its metric to a group. Use:
+//
+//   PW_METRIC_SHARDED_COUNTER(variable_name, metric_name, shards)
+//   PW_METRIC_SHARDED_COUNTER(group, variable_name, metric_name, shards)
+//
+// For example:
+//
+//   class RpcServer {
+//     ...
+//    private:
+//     PW_METRIC_GROUP(metrics_, "rpc_server");
+//     PW_METRIC_SHARDED_COUNTER(metrics_, packets_, "packets", kNumCores);
+//   };
+//
+#define PW_METRIC_SHARDED_COUNTER(...) \
+  PW_DELEGATE_BY_ARG_COUNT(_PW_METRIC_SHARDED_COUNTER_, __VA_ARGS__)
+
+#define _PW_METRIC_SHARDED_COUNTER_3(variable_name, metric_name, shards)      \
+  static constexpr uint32_t variable_name##_token =                           \
+      PW_TOKENIZE_STRING_MASK("metrics", _PW_METRIC_TOKEN_MASK, metric_name); \
+  ::pw::metric::ShardedCounter<shards> variable_name = {variable_name##_token}
+
+#define _PW_METRIC_SHARDED_COUNTER_4(group, variable_name, metric_name, count) \
+  static constexpr uint32_t variable_name##_token =                           \
+      PW_TOKENIZE_STRING_MASK("metrics", _PW_METRIC_TOKEN_MASK, metric_name); \
+  ::pw::metric::ShardedCounter<count> variable_name = {                       \
+      variable_name##_token, group.metrics()}
+
+}  // namespace pw::metric
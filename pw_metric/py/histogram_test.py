@@ -0,0 +1,80 @@
+
+"""Tests for the pw_metric histogram tools."""
+
+import unittest
+
+from pw_metric.histogram import Bucket, Histogram, find_histograms
+
+
+def _buckets(*counts: int) -> dict:
+    return {f'bucket_{i}': count for i, count in enumerate(counts)}
+
+
+class TestHistogram(unittest.TestCase):
+    """Tests reconstructing histograms and computing their percentiles."""
+    def test_log2_bounds(self) -> None:
+        histogram = Histogram.from_metrics(_buckets(1, 2, 3, 4))
+        self.assertEqual(histogram.buckets, [
+            Bucket(0, 1, 1),
+            Bucket(1, 2, 2),
+            Bucket(2, 4, 3),
+            Bucket(4, None, 4),
+        ])
+
+    def test_log2_all_buckets_bounded(self) -> None:
+        histogram = Histogram.from_metrics(_buckets(*[0] * 33))
+        self.assertEqual(histogram.buckets[-1], Bucket(1 << 31, 1 << 32, 0))
+
+    def test_linear_bounds(self) -> None:
+        metrics = _buckets(1, 0, 2)
+        metrics.update(first_bucket_min=100, bucket_width=10)
+        histogram = Histogram.from_metrics(metrics)
+        self.assertEqual(histogram.buckets, [
+            Bucket(100, 110, 1),
+            Bucket(110, 120, 0),
+            Bucket(120, None, 2),
+        ])
+
+    def test_missing_bucket(self) -> None:
+        with self.assertRaises(ValueError):
+            Histogram.from_metrics({'bucket_0': 1, 'bucket_2': 1})
+
+    def test_percentile_interpolates_within_bucket(self) -> None:
+        histogram = Histogram([Bucket(0, 10, 5), Bucket(10, 20, 5)])
+        self.assertEqual(histogram.percentile(0), 0)
+        self.assertEqual(histogram.percentile(20), 4)
+        self.assertEqual(histogram.percentile(50), 10)
+        self.assertEqual(histogram.percentile(90), 18)
+        self.assertEqual(histogram.percentile(100), 20)
+
+    def test_percentile_skips_empty_buckets(self) -> None:
+        histogram = Histogram([Bucket(0, 10, 0), Bucket(10, 20, 4)])
+        self.assertEqual(histogram.percentile(0), 10)
+
+    def test_percentile_unbounded_bucket(self) -> None:
+        histogram = Histogram([Bucket(0, 10, 1), Bucket(10, None, 1)])
+        self.assertEqual(histogram.percentile(99), 10)
+
+    def test_percentile_empty(self) -> None:
+        with self.assertRaises(ValueError):
+            Histogram([Bucket(0, 10, 0)]).percentile(50)
+
+    def test_render(self) -> None:
+        histogram = Histogram([Bucket(0, 10, 5), Bucket(10, 20, 5)])
+        self.assertEqual(histogram.render(),
+                         'count=10 p50=10.0 p90=18.0 p99=19.8')
+        self.assertEqual(Histogram([Bucket(0, 1, 0)]).render(), 'count=0')
+
+    def test_find_histograms(self) -> None:
+        metrics = {
+            ('rpc', 'latency_us', 'bucket_0'): 1,
+            ('rpc', 'latency_us', 'bucket_1'): 3,
+            ('rpc', 'calls'): 4,
+        }
+        histograms = find_histograms(metrics)
+        self.assertEqual(list(histograms), [('rpc', 'latency_us')])
+        self.assertEqual(histograms['rpc', 'latency_us'].total(), 4)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,137 @@
+
+"""Reconstructs pw_metric histograms and computes their percentiles.
+
+Histograms are metric groups whose metrics are named bucket_0, bucket_1, and so
+on. Linear histograms also have first_bucket_min and bucket_width metrics;
+histograms without them have power-of-two buckets.
+"""
+
+from dataclasses import dataclass
+import re
+from typing import Dict, Iterable, List, Mapping, Optional, Sequence, Tuple
+
+_BUCKET_NAME = re.compile(r'bucket_(\d+)')
+
+
+@dataclass(frozen=True)
+class Bucket:
+    """A histogram bucket counting values in [low, high).
+
+    high is None for an unbounded last bucket.
+    """
+    low: int
+    high: Optional[int]
+    count: int
+
+
+class Histogram:
+    """A histogram read from a pw_metric histogram group."""
+    def __init__(self, buckets: Sequence[Bucket]):
+        if not buckets:
+            raise ValueError('A histogram must have at least one bucket')
+        self.buckets: List[Bucket] = list(buckets)
+
+    @classmethod
+    def from_metrics(cls, metrics: Mapping[str, int]) -> 'Histogram':
+        """Creates a histogram from the named metrics in its group."""
+        counts: Dict[int, int] = {}
+        for name, value in metrics.items():
+            match = _BUCKET_NAME.fullmatch(name)
+            if match:
+                counts[int(match.group(1))] = value
+
+        if sorted(counts) != list(range(len(counts))) or not counts:
+            raise ValueError(f'Missing histogram buckets in {sorted(metrics)}')
+
+        if 'bucket_width' in metrics:
+            bounds = _linear_bounds(len(counts),
+                                    metrics.get('first_bucket_min', 0),
+                                    metrics['bucket_width'])
+        else:
+            bounds = _log2_bounds(len(counts))
+
+        return cls([
+            Bucket(low, high, counts[index])
+            for index, (low, high) in enumerate(bounds)
+        ])
+
+    def total(self) -> int:
+        return sum(bucket.count for bucket in self.buckets)
+
+    def percentile(self, percent: float) -> float:
+        """Estimates a percentile of the recorded values.
+
+        Values are assumed to be spread evenly within each bucket. Percentiles
+        that fall in an unbounded bucket are reported as the bucket's lower
+        bound.
+        """
+        if not 0 <= percent <= 100:
+            raise ValueError(f'Invalid percentile {percent}')
+
+        total = self.total()
+        if total == 0:
+            raise ValueError('The histogram is empty')
+
+        rank = percent / 100 * total
+        below = 0
+        for bucket in self.buckets:
+            if bucket.count and below + bucket.count >= rank:
+                if bucket.high is None:
+                    return float(bucket.low)
+                fraction = (rank - below) / bucket.count
+                return bucket.low + fraction * (bucket.high - bucket.low)
+            below += bucket.count
+
+        raise AssertionError('unreachable')
+
+    def render(self, percents: Iterable[float] = (50, 90, 99)) -> str:
+        """Summarizes the histogram, e.g. "count=12 p50=3.0 p90=7.5"."""
+        total = self.total()
+        if total == 0:
+            return 'count=0'
+
+        parts = [f'count={total}']
+        parts += [f'p{p:g}={self.percentile(p):.1f}' for p in percents]
+        return ' '.join(parts)
+
+
+def find_histograms(
+    metrics: Mapping[Tuple[str, ...], int]
+) -> Dict[Tuple[str, ...], Histogram]:
+    """Finds the histograms in a set of metrics, keyed by detokenized path.
+
+    Returns a dictionary from each histogram group's path to its histogram.
+    """
+    groups: Dict[Tuple[str, ...], Dict[str, int]] = {}
+    for path, value in metrics.items():
+        if path:
+            groups.setdefault(path[:-1], {})[path[-1]] = value
+
+    return {
+        path: Histogram.from_metrics(group)
+        for path, group in groups.items() if 'bucket_0' in group
+    }
+
+
+def _log2_bounds(count: int) -> List[Tuple[int, Optional[int]]]:
+    bounds: List[Tuple[int, Optional[int]]] = [(0, 1)]
+    bounds += [(1 << (i - 1), 1 << i) for i in range(1, count)]
+    return _unbounded_last(bounds, count == 33)
+
+
+def _linear_bounds(count: int, first_min: int,
+                   width: int) -> List[Tuple[int, Optional[int]]]:
+    bounds: List[Tuple[int, Optional[int]]] = [
+        (first_min + i * width, first_min + (i + 1) * width)
+        for i in range(count)
+    ]
+    return _unbounded_last(bounds, False)
+
+
+def _unbounded_last(bounds: List[Tuple[int, Optional[int]]],
+                    covers_all: bool) -> List[Tuple[int, Optional[int]]]:
+    # The last bucket also counts every value past its end, unless it already
+    # reaches the largest uint32_t.
+    if not covers_all:
+        bounds[-1] = (bounds[-1][0], None)
+    return bounds
@@ -0,0 +1,72 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/sharded_counter.h"
+
+#include "gtest/gtest.h"
+
+namespace pw::metric {
+namespace {
+
+TEST(ShardedCounter, Increment_SumsShards) {
+  PW_METRIC_SHARDED_COUNTER(counter, "counter", 4);
+
+  counter.Increment(0);
+  counter.Increment(1, 10);
+  counter.Increment(3, 100);
+  counter.Increment(3);
+
+  EXPECT_EQ(112u, counter.value());
+  EXPECT_EQ(4u, counter.shard_count());
+}
+
+TEST(ShardedCounter, Publish_MovesShardsIntoMetric) {
+  PW_METRIC_SHARDED_COUNTER(counter, "counter", 2);
+
+  counter.Increment(0, 3);
+  counter.Increment(1, 4);
+  EXPECT_EQ(0u, counter.metric().value());
+
+  counter.Publish();
+  EXPECT_EQ(7u, counter.metric().value());
+  EXPECT_EQ(7u, counter.value());
+
+  counter.Increment(1);
+  EXPECT_EQ(7u, counter.metric().value());
+  EXPECT_EQ(8u, counter.value());
+
+  counter.Publish();
+  EXPECT_EQ(8u, counter.metric().value());
+}
+
+TEST(ShardedCounter, Shards_OnSeparateCacheLines) {
+  ShardedCounter<2, 64> counter(0);
+  EXPECT_GE(sizeof(counter), 3u * 64u);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(&counter) % 64u);
+}
+
+TEST(ShardedCounter, Group_ContainsMetric) {
+  PW_METRIC_GROUP(group, "group");
+  PW_METRIC_SHARDED_COUNTER(group, counter, "counter", 2);
+
+  ASSERT_EQ(1u, group.metrics().size());
+  EXPECT_EQ(&group.metrics().front(), &counter.metric());
+
+  counter.Increment(1, 5);
+  counter.Publish();
+  EXPECT_EQ(5u, group.metrics().front().as_int());
+}
+
+}  // namespace
+}  // namespace pw::metric
@@ -27,16 +27,88 @@
 namespace pw {
 namespace multisink {
 
+MultiSink::MultiSink(
+    ByteSpan buffer,
+    persistent_ram::Persistent<PersistentState>& persistent_state)
+    : ring_buffer_(true),
+      sequence_id_(0),
+      persistent_state_(&persistent_state) {
+  ring_buffer_.SetBuffer(buffer)
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  AttachDrain(oldest_entry_drain_);
+
+  std::lock_guard lock(lock_);
+  if (!persistent_state.has_value() ||
+      !ring_buffer_.RestorePosition(persistent_state.value().position).ok()) {
+    SavePersistentState();
+    return;
+  }
+  sequence_id_ = persistent_state.value().sequence_id;
+
+  // Drains report drops relative to the oldest restored entry.
+  uint32_t first_sequence_id;
+  if (!oldest_entry_drain_.reader_.PeekFrontPreamble(first_sequence_id).ok()) {
+    first_sequence_id = sequence_id_;
+  }
+  oldest_entry_drain_.last_handled_sequence_id_ = first_sequence_id - 1;
+  oldest_entry_drain_.last_peek_sequence_id_ = first_sequence_id - 1;
+}
+
 void MultiSink::HandleEntry(ConstByteSpan entry) {
   std::lock_guard lock(lock_);
+  TransferLockFreeEntries();
   PW_DCHECK_OK(ring_buffer_.PushBack(entry, sequence_id_++));
-  NotifyListeners();
+  SavePersistentState();
+  AddPendingEntries(1, entry.size());
+}
+
+void MultiSink::FlushLockFreeEntries() {
+  std::lock_guard lock(lock_);
+  if (TransferLockFreeEntries()) {
+    AddPendingEntries(0, 0);
+  }
+}
+
+void MultiSink::SavePersistentState() {
+  if (persistent_state_ != nullptr) {
+    persistent_state_->emplace(
+        PersistentState{ring_buffer_.GetPosition(), sequence_id_});
+  }
+}
+
+bool MultiSink::TransferLockFreeEntries() {
+  bool transferred = false;
+  for (Result<ConstByteSpan> entry = lock_free_queue_.PeekFront(); entry.ok();
+       entry = lock_free_queue_.PeekFront()) {
+    PW_DCHECK_OK(ring_buffer_.PushBack(entry.value(), sequence_id_++));
+    pending_entries_ += 1;
+    pending_bytes_ += entry.value().size();
+    PW_CHECK_OK(lock_free_queue_.PopFront());
+    transferred = true;
+  }
+
+  // The producer only drops entries when the queue is full, so report the
+  // drops after the entries that filled it.
+  const uint32_t drop_count =
+      lock_free_queue_.drop_count() - lock_free_drop_count_;
+  if (drop_count != 0) {
+    lock_free_drop_count_ += drop_count;
+    sequence_id_ += drop_count;
+    pending_entries_ += drop_count;
+    transferred = true;
+  }
+
+  if (transferred) {
+    SavePersistentState();
+  }
+  return transferred;
 }
 
 void MultiSink::HandleDropped(uint32_t drop_count) {
   std::lock_guard lock(lock_);
   sequence_id_ += drop_count;
-  NotifyListeners();
+  SavePersistentState();
+  AddPendingEntries(drop_count, 0);
 }
 
 Status MultiSink::PopEntry(Drain& drain, const Drain::PeekedEntry& entry) {
@@ -79,6 +151,7 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
 
   std::lock_guard lock(lock_);
   PW_DCHECK_PTR_EQ(drain.multisink_, this);
+  TransferLockFreeEntries();
 
   const Status peek_status = drain.reader_.PeekFrontWithPreamble(
       buffer, entry_sequence_id_out, bytes_read);
@@ -87,6 +160,7 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
     // If the drain has caught up, report the last handled sequence ID so that
     // it can still process any dropped entries.
     entry_sequence_id_out = sequence_id_ - 1;
+    drain_caught_up_ = true;
   } else if (!peek_status.ok()) {
     // Discard the entry if the result isn't OK or OUT_OF_RANGE and exit, as the
     // entry_sequence_id_out cannot be used for computation. Later invocations
@@ -119,6 +193,113 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
   return std::as_bytes(buffer.first(bytes_read));
 }
 
+Status MultiSink::PeekEntries(
+    Drain& drain,
+    ByteSpan buffer,
+    const Function<Status(ConstByteSpan, uint32_t)>& callback,
+    size_t max_bytes,
+    uint32_t& drop_count_out,
+    Drain::Position* start_out,
+    Drain::Position* end_out) {
+  std::lock_guard lock(lock_);
+  PW_DCHECK_PTR_EQ(drain.multisink_, this);
+  TransferLockFreeEntries();
+
+  if (start_out != nullptr) {
+    *start_out = GetPosition(drain);
+  }
+  const Status status =
+      PeekEntriesLocked(drain, buffer, callback, max_bytes, drop_count_out);
+  if (end_out != nullptr) {
+    *end_out = GetPosition(drain);
+  }
+  return status;
+}
+
+Status MultiSink::SkipTo(Drain& drain,
+                         const Drain::Position& start,
+                         const Drain::Position& end) {
+  std::lock_guard lock(lock_);
+  PW_DCHECK_PTR_EQ(drain.multisink_, this);
+  TransferLockFreeEntries();
+
+  if (GetPosition(drain) != start) {
+    return Status::FailedPrecondition();
+  }
+
+  // Entries are never removed from the middle of the ring buffer, so every
+  // entry between the two positions is still available to this drain.
+  const uint32_t skipped_ids = end.next_sequence_id - start.next_sequence_id;
+  uint32_t entry_sequence_id = 0;
+  while (drain.reader_.PeekFrontPreamble(entry_sequence_id).ok() &&
+         entry_sequence_id - start.next_sequence_id < skipped_ids) {
+    PW_CHECK(drain.reader_.PopFront().ok());
+  }
+  drain.last_handled_sequence_id_ = end.last_handled_sequence_id;
+
+  if (drain.reader_.EntryCount() != 0u) {
+    return OkStatus();
+  }
+  drain_caught_up_ = true;
+  return Status::OutOfRange();
+}
+
+MultiSink::Drain::Position MultiSink::GetPosition(Drain& drain) {
+  uint32_t next_sequence_id;
+  if (!drain.reader_.PeekFrontPreamble(next_sequence_id).ok()) {
+    next_sequence_id = sequence_id_;
+  }
+  return {drain.last_handled_sequence_id_, next_sequence_id};
+}
+
+Status MultiSink::PeekEntriesLocked(
+    Drain& drain,
+    ByteSpan buffer,
+    const Function<Status(ConstByteSpan, uint32_t)>& callback,
+    size_t max_bytes,
+    uint32_t& drop_count_out) {
+  drop_count_out = 0;
+  size_t accepted_bytes = 0;
+
+  while (true) {
+    size_t bytes_read = 0;
+    uint32_t entry_sequence_id = 0;
+    const Status peek_status = drain.reader_.PeekFrontWithPreamble(
+        buffer, entry_sequence_id, bytes_read);
+
+    if (peek_status.IsOutOfRange()) {
+      // Report drops after the last entry, as PopEntry does when caught up.
+      entry_sequence_id = sequence_id_ - 1;
+      drop_count_out = entry_sequence_id - drain.last_handled_sequence_id_;
+      drain.last_handled_sequence_id_ = entry_sequence_id;
+      drain_caught_up_ = true;
+      return peek_status;
+    }
+    if (!peek_status.ok()) {
+      // The entry did not fit in the buffer. Discard it; the gap in sequence
+      // IDs reports it as a drop with the next entry.
+      PW_CHECK(drain.reader_.PopFront().ok());
+      continue;
+    }
+
+    if (bytes_read > max_bytes - accepted_bytes && accepted_bytes != 0) {
+      return OkStatus();
+    }
+
+    const uint32_t drop_count =
+        entry_sequence_id - drain.last_handled_sequence_id_ - 1;
+    if (!callback(buffer.first(bytes_read), drop_count).ok()) {
+      return OkStatus();
+    }
+    PW_CHECK(drain.reader_.PopFront().ok());
+    drain.last_handled_sequence_id_ = entry_sequence_id;
+    accepted_bytes += bytes_read;
+    if (accepted_bytes >= max_bytes) {
+      return OkStatus();
+    }
+  }
+}
+
 void MultiSink::AttachDrain(Drain& drain) {
   std::lock_guard lock(lock_);
   PW_DCHECK_PTR_EQ(drain.multisink_, nullptr);
@@ -155,12 +336,46 @@ void MultiSink::DetachListener(Listener& listener) {
   PW_DCHECK(was_detached, "The listener was already attached.");
 }
 
+void MultiSink::SetNotificationPolicy(const NotificationPolicy& policy) {
+  std::lock_guard lock(lock_);
+  notification_policy_ = policy;
+  AddPendingEntries(0, 0);
+}
+
+void MultiSink::NotifyPendingListeners() {
+  std::lock_guard lock(lock_);
+  TransferLockFreeEntries();
+  if (pending_entries_ != 0u) {
+    NotifyListeners();
+  }
+}
+
 void MultiSink::Clear() {
   std::lock_guard lock(lock_);
   ring_buffer_.Clear();
+  while (lock_free_queue_.PopFront().ok()) {
+  }
+  SavePersistentState();
+}
+
+void MultiSink::AddPendingEntries(uint32_t entries, size_t bytes) {
+  pending_entries_ += entries;
+  pending_bytes_ += bytes;
+
+  if (pending_entries_ == 0u) {
+    return;
+  }
+  if (drain_caught_up_ ||
+      pending_entries_ >= notification_policy_.max_pending_entries ||
+      pending_bytes_ >= notification_policy_.max_pending_bytes) {
+    NotifyListeners();
+  }
 }
 
 void MultiSink::NotifyListeners() {
+  pending_entries_ = 0;
+  pending_bytes_ = 0;
+  drain_caught_up_ = false;
   for (auto& listener : listeners_) {
     listener.OnNewEntryAvailable();
   }
@@ -195,11 +410,77 @@ Status MultiSink::UnsafeForEachEntry(
   return OkStatus();
 }
 
+Status MultiSink::UnsafeForEachWrappedEntry(
+    const Function<void(ConstByteSpan, ConstByteSpan)>& callback,
+    size_t max_num_entries) {
+  using ring_buffer::PrefixedEntryRingBufferMulti;
+  const PrefixedEntryRingBufferMulti::WrappedEntries entries =
+      PrefixedEntryRingBufferMulti::wrapped_entries(oldest_entry_drain_.reader_);
+
+  // First count the number of entries.
+  size_t num_entries = 0;
+  for (PrefixedEntryRingBufferMulti::wrapped_iterator it = entries.begin();
+       it != entries.end();
+       ++it) {
+    num_entries++;
+  }
+
+  // Log up to the max number of logs to avoid overflowing the crash log
+  // writer.
+  const size_t first_logged_offset =
+      max_num_entries > num_entries ? 0 : num_entries - max_num_entries;
+  PrefixedEntryRingBufferMulti::wrapped_iterator it = entries.begin();
+  for (size_t offset = 0; it != entries.end(); ++it, ++offset) {
+    if (offset < first_logged_offset) {
+      continue;  // Skip this log.
+    }
+    callback(it->first, it->second);
+  }
+  if (!it.status().ok()) {
+    PW_LOG_WARN("Multisink corruption detected, some entries may be missing");
+    return Status::DataLoss();
+  }
+
+  return OkStatus();
+}
+
 Status MultiSink::Drain::PopEntry(const PeekedEntry& entry) {
   PW_DCHECK_NOTNULL(multisink_);
   return multisink_->PopEntry(*this, entry);
 }
 
+Status MultiSink::Drain::PeekEntries(
+    ByteSpan buffer,
+    const Function<Status(ConstByteSpan, uint32_t)>& callback,
+    size_t max_bytes,
+    uint32_t& drop_count_out) {
+  PW_DCHECK_NOTNULL(multisink_);
+  return multisink_->PeekEntries(
+      *this, buffer, callback, max_bytes, drop_count_out, nullptr, nullptr);
+}
+
+Status MultiSink::Drain::PeekEntries(
+    ByteSpan buffer,
+    const Function<Status(ConstByteSpan, uint32_t)>& callback,
+    size_t max_bytes,
+    uint32_t& drop_count_out,
+    Position& start_out,
+    Position& end_out) {
+  PW_DCHECK_NOTNULL(multisink_);
+  return multisink_->PeekEntries(*this,
+                                 buffer,
+                                 callback,
+                                 max_bytes,
+                                 drop_count_out,
+                                 &start_out,
+                                 &end_out);
+}
+
+Status MultiSink::Drain::SkipTo(const Position& start, const Position& end) {
+  PW_DCHECK_NOTNULL(multisink_);
+  return multisink_->SkipTo(*this, start, end);
+}
+
 Result<MultiSink::Drain::PeekedEntry> MultiSink::Drain::PeekEntry(
     ByteSpan buffer, uint32_t& drop_count_out) {
   PW_DCHECK_NOTNULL(multisink_);
@@ -16,8 +16,12 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
+#include <new>
 #include <optional>
+#include <string>
 #include <string_view>
+#include <type_traits>
 
 #include "gtest/gtest.h"
 #include "pw_function/function.h"
@@ -351,6 +355,495 @@ TEST_F(MultiSinkTest, PeekAndPop) {
   VerifyPeekResult(peek_other_drain_unchanged, drop_count, kMessage, 0);
 }
 
+TEST_F(MultiSinkTest, PeekEntriesNoEntries) {
+  multisink_.AttachDrain(drains_[0]);
+
+  size_t entry_count = 0;
+  uint32_t drop_count = 0;
+  EXPECT_EQ(drains_[0].PeekEntries(
+                entry_buffer_,
+                [&entry_count](ConstByteSpan, uint32_t) {
+                  ++entry_count;
+                  return OkStatus();
+                },
+                kEntryBufferSize,
+                drop_count),
+            Status::OutOfRange());
+  EXPECT_EQ(entry_count, 0u);
+  EXPECT_EQ(drop_count, 0u);
+}
+
+TEST_F(MultiSinkTest, PeekEntriesPopsAcceptedEntries) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachDrain(drains_[1]);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleDropped(2);
+  multisink_.HandleEntry(kMessageOther);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleDropped();
+
+  struct {
+    std::array<uint32_t, 4> drop_counts;
+    size_t entry_count;
+  } ctx{};
+  auto accept_all = [&ctx](ConstByteSpan entry, uint32_t drop_count) {
+    EXPECT_EQ(entry.size(), sizeof(kMessage));
+    ctx.drop_counts[ctx.entry_count++] = drop_count;
+    return OkStatus();
+  };
+
+  uint32_t drop_count = 0;
+  EXPECT_EQ(drains_[0].PeekEntries(
+                entry_buffer_, accept_all, kEntryBufferSize, drop_count),
+            Status::OutOfRange());
+  ASSERT_EQ(ctx.entry_count, 3u);
+  EXPECT_EQ(ctx.drop_counts[0], 0u);
+  EXPECT_EQ(ctx.drop_counts[1], 2u);
+  EXPECT_EQ(ctx.drop_counts[2], 0u);
+  EXPECT_EQ(drop_count, 1u);
+  VerifyPopEntry(drains_[0], std::nullopt, 0u);
+
+  // The other drain is unaffected.
+  VerifyPopEntry(drains_[1], kMessage, 0u);
+}
+
+TEST_F(MultiSinkTest, PeekEntriesStopsAtMaxBytes) {
+  multisink_.AttachDrain(drains_[0]);
+  for (size_t i = 0; i < 3; ++i) {
+    multisink_.HandleEntry(kMessage);
+  }
+
+  size_t entry_count = 0;
+  auto accept_all = [&entry_count](ConstByteSpan, uint32_t) {
+    ++entry_count;
+    return OkStatus();
+  };
+
+  // Room for one and a half entries.
+  uint32_t drop_count = 0;
+  EXPECT_EQ(drains_[0].PeekEntries(entry_buffer_,
+                                   accept_all,
+                                   sizeof(kMessage) + sizeof(kMessage) / 2,
+                                   drop_count),
+            OkStatus());
+  EXPECT_EQ(entry_count, 1u);
+
+  // An entry larger than max_bytes is still passed to the callback.
+  EXPECT_EQ(drains_[0].PeekEntries(entry_buffer_, accept_all, 1, drop_count),
+            OkStatus());
+  EXPECT_EQ(entry_count, 2u);
+
+  VerifyPopEntry(drains_[0], kMessage, 0u);
+  VerifyPopEntry(drains_[0], std::nullopt, 0u);
+}
+
+TEST_F(MultiSinkTest, PeekEntriesCallbackStops) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleDropped();
+  multisink_.HandleEntry(kMessageOther);
+
+  size_t entry_count = 0;
+  auto accept_one = [&entry_count](ConstByteSpan, uint32_t) {
+    if (entry_count == 1) {
+      return Status::ResourceExhausted();
+    }
+    ++entry_count;
+    return OkStatus();
+  };
+
+  uint32_t drop_count = 0;
+  EXPECT_EQ(drains_[0].PeekEntries(
+                entry_buffer_, accept_one, kEntryBufferSize, drop_count),
+            OkStatus());
+  EXPECT_EQ(entry_count, 1u);
+  EXPECT_EQ(drop_count, 0u);
+
+  // The rejected entry and its drop count are reported again.
+  VerifyPopEntry(drains_[0], kMessageOther, 1u);
+}
+
+TEST_F(MultiSinkTest, PeekEntriesDiscardsEntriesLargerThanBuffer) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleEntry(kMessage);
+
+  size_t entry_count = 0;
+  uint32_t drop_count = 0;
+  EXPECT_EQ(drains_[0].PeekEntries(
+                std::span(entry_buffer_, sizeof(kMessage) - 1),
+                [&entry_count](ConstByteSpan, uint32_t) {
+                  ++entry_count;
+                  return OkStatus();
+                },
+                kEntryBufferSize,
+                drop_count),
+            Status::OutOfRange());
+  EXPECT_EQ(entry_count, 0u);
+  EXPECT_EQ(drop_count, 2u);
+}
+
+TEST_F(MultiSinkTest, SkipToAppliesOtherDrainsWalk) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachDrain(drains_[1]);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleDropped(2);
+  multisink_.HandleEntry(kMessageOther);
+  multisink_.HandleEntry(kMessage);
+
+  // Walk the first two entries with one drain.
+  size_t entry_count = 0;
+  auto accept_two = [&entry_count](ConstByteSpan, uint32_t) {
+    return ++entry_count <= 2 ? OkStatus() : Status::ResourceExhausted();
+  };
+  uint32_t drop_count = 0;
+  Drain::Position start;
+  Drain::Position end;
+  EXPECT_EQ(drains_[0].PeekEntries(entry_buffer_,
+                                   accept_two,
+                                   kEntryBufferSize,
+                                   drop_count,
+                                   start,
+                                   end),
+            OkStatus());
+
+  // The other drain skips the same entries and continues after them.
+  EXPECT_EQ(drains_[1].SkipTo(start, end), OkStatus());
+  VerifyPopEntry(drains_[1], kMessage, 0u);
+  VerifyPopEntry(drains_[1], std::nullopt, 0u);
+
+  // The drain is no longer at the start position.
+  EXPECT_EQ(drains_[1].SkipTo(start, end), Status::FailedPrecondition());
+}
+
+TEST_F(MultiSinkTest, SkipToCaughtUp) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachDrain(drains_[1]);
+  multisink_.HandleEntry(kMessage);
+
+  uint32_t drop_count = 0;
+  Drain::Position start;
+  Drain::Position end;
+  EXPECT_EQ(drains_[0].PeekEntries(
+                entry_buffer_,
+                [](ConstByteSpan, uint32_t) { return OkStatus(); },
+                kEntryBufferSize,
+                drop_count,
+                start,
+                end),
+            Status::OutOfRange());
+
+  // Entries added after the walk remain for the drain that skips it.
+  multisink_.HandleDropped();
+  multisink_.HandleEntry(kMessageOther);
+  EXPECT_EQ(drains_[1].SkipTo(start, end), OkStatus());
+  VerifyPopEntry(drains_[1], kMessageOther, 1u);
+}
+
+TEST_F(MultiSinkTest, SkipToFailsAfterEntriesEvicted) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachDrain(drains_[1]);
+  multisink_.HandleEntry(kMessage);
+
+  uint32_t drop_count = 0;
+  Drain::Position start;
+  Drain::Position end;
+  EXPECT_EQ(drains_[0].PeekEntries(
+                entry_buffer_,
+                [](ConstByteSpan, uint32_t) { return OkStatus(); },
+                kEntryBufferSize,
+                drop_count,
+                start,
+                end),
+            Status::OutOfRange());
+
+  // Fill the buffer until the entry the other drain has not read is evicted.
+  for (size_t i = 0; i < kBufferSize; ++i) {
+    multisink_.HandleEntry(kMessageOther);
+  }
+  EXPECT_EQ(drains_[1].SkipTo(start, end), Status::FailedPrecondition());
+}
+
+TEST_F(MultiSinkTest, NotificationPolicy_FirstEntryAfterDrainCaughtUp) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachListener(listeners_[0]);
+  ExpectNotificationCount(listeners_[0], 1u);
+  multisink_.SetNotificationPolicy({.max_pending_entries = 100});
+
+  // No drain has read anything yet, so the first entry notifies immediately.
+  multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 1u);
+
+  // The drain was notified, so the following entries are coalesced.
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleDropped();
+  ExpectNotificationCount(listeners_[0], 0u);
+
+  // Once the drain catches up, the next entry notifies immediately again.
+  VerifyPopEntry(drains_[0], kMessage, 0u);
+  VerifyPopEntry(drains_[0], kMessage, 0u);
+  VerifyPopEntry(drains_[0], std::nullopt, 1u);
+  multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 1u);
+}
+
+TEST_F(MultiSinkTest, NotificationPolicy_EntryThreshold) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachListener(listeners_[0]);
+  multisink_.SetNotificationPolicy({.max_pending_entries = 3});
+  multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 2u);
+
+  for (int i = 0; i < 2; ++i) {
+    multisink_.HandleEntry(kMessage);
+    multisink_.HandleEntry(kMessage);
+    ExpectNotificationCount(listeners_[0], 0u);
+    multisink_.HandleDropped();
+    ExpectNotificationCount(listeners_[0], 1u);
+  }
+}
+
+TEST_F(MultiSinkTest, NotificationPolicy_ByteThreshold) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachListener(listeners_[0]);
+  multisink_.SetNotificationPolicy({.max_pending_entries = 100,
+                                    .max_pending_bytes = 2 * sizeof(kMessage)});
+  multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 2u);
+
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleDropped(5);
+  ExpectNotificationCount(listeners_[0], 0u);
+  multisink_.HandleEntry(kMessageOther);
+  ExpectNotificationCount(listeners_[0], 1u);
+}
+
+TEST_F(MultiSinkTest, NotificationPolicy_NotifyPendingListeners) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachListener(listeners_[0]);
+  multisink_.SetNotificationPolicy({.max_pending_entries = 100});
+  multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 2u);
+
+  // Nothing is pending.
+  multisink_.NotifyPendingListeners();
+  ExpectNotificationCount(listeners_[0], 0u);
+
+  multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 0u);
+  multisink_.NotifyPendingListeners();
+  ExpectNotificationCount(listeners_[0], 1u);
+  multisink_.NotifyPendingListeners();
+  ExpectNotificationCount(listeners_[0], 0u);
+}
+
+TEST_F(MultiSinkTest, NotificationPolicy_PeekEntriesCatchesUp) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachListener(listeners_[0]);
+  multisink_.SetNotificationPolicy({.max_pending_entries = 100});
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 2u);
+
+  uint32_t drop_count = 0;
+  EXPECT_EQ(drains_[0].PeekEntries(
+                entry_buffer_,
+                [](ConstByteSpan, uint32_t) { return OkStatus(); },
+                kEntryBufferSize,
+                drop_count),
+            Status::OutOfRange());
+
+  multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 1u);
+}
+
+class MultiSinkLockFreeTest : public MultiSinkTest {
+ protected:
+  static constexpr size_t kLockFreeBufferSize = 32;
+
+  MultiSinkLockFreeTest() : lock_free_multisink_(buffer_, lock_free_buffer_) {}
+
+  std::byte lock_free_buffer_[kLockFreeBufferSize];
+  MultiSink lock_free_multisink_;
+};
+
+TEST_F(MultiSinkLockFreeTest, NoLockFreeBuffer) {
+  EXPECT_EQ(multisink_.HandleEntryLockFree(kMessage),
+            Status::FailedPrecondition());
+}
+
+TEST_F(MultiSinkLockFreeTest, EntriesVisibleToDrains) {
+  lock_free_multisink_.AttachDrain(drains_[0]);
+  lock_free_multisink_.AttachListener(listeners_[0]);
+  ExpectNotificationCount(listeners_[0], 1u);
+
+  ASSERT_EQ(lock_free_multisink_.HandleEntryLockFree(kMessage), OkStatus());
+  ASSERT_EQ(lock_free_multisink_.HandleEntryLockFree(kMessageOther),
+            OkStatus());
+
+  // Lock-free producers do not notify listeners.
+  ExpectNotificationCount(listeners_[0], 0u);
+
+  // Drains move staged entries into the ring buffer when reading.
+  VerifyPopEntry(drains_[0], kMessage, 0u);
+  VerifyPopEntry(drains_[0], kMessageOther, 0u);
+  VerifyPopEntry(drains_[0], std::nullopt, 0u);
+}
+
+TEST_F(MultiSinkLockFreeTest, OrderedBeforeLockedEntries) {
+  lock_free_multisink_.AttachDrain(drains_[0]);
+
+  ASSERT_EQ(lock_free_multisink_.HandleEntryLockFree(kMessage), OkStatus());
+  lock_free_multisink_.HandleEntry(kMessageOther);
+  ASSERT_EQ(lock_free_multisink_.HandleEntryLockFree(kMessage), OkStatus());
+
+  VerifyPopEntry(drains_[0], kMessage, 0u);
+  VerifyPopEntry(drains_[0], kMessageOther, 0u);
+  VerifyPopEntry(drains_[0], kMessage, 0u);
+  VerifyPopEntry(drains_[0], std::nullopt, 0u);
+}
+
+TEST_F(MultiSinkLockFreeTest, FlushNotifiesListeners) {
+  lock_free_multisink_.AttachDrain(drains_[0]);
+  lock_free_multisink_.AttachListener(listeners_[0]);
+  ExpectNotificationCount(listeners_[0], 1u);
+
+  // Nothing staged, so there is nothing to notify.
+  lock_free_multisink_.FlushLockFreeEntries();
+  ExpectNotificationCount(listeners_[0], 0u);
+
+  ASSERT_EQ(lock_free_multisink_.HandleEntryLockFree(kMessage), OkStatus());
+  lock_free_multisink_.FlushLockFreeEntries();
+  ExpectNotificationCount(listeners_[0], 1u);
+  VerifyPopEntry(drains_[0], kMessage, 0u);
+}
+
+TEST_F(MultiSinkLockFreeTest, OverflowReportedAsDrops) {
+  lock_free_multisink_.AttachDrain(drains_[0]);
+  lock_free_multisink_.AttachDrain(drains_[1]);
+
+  // Each 4-byte entry takes 8 bytes of the lock-free buffer, which holds three
+  // entries since one byte is always left unused.
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(lock_free_multisink_.HandleEntryLockFree(kMessage), OkStatus());
+  }
+  EXPECT_EQ(lock_free_multisink_.HandleEntryLockFree(kMessage),
+            Status::ResourceExhausted());
+  EXPECT_EQ(lock_free_multisink_.HandleEntryLockFree(kMessage),
+            Status::ResourceExhausted());
+
+  for (Drain& drain : std::span(drains_, 2)) {
+    VerifyPopEntry(drain, kMessage, 0u);
+    VerifyPopEntry(drain, kMessage, 0u);
+    VerifyPopEntry(drain, kMessage, 0u);
+    VerifyPopEntry(drain, std::nullopt, 2u);
+  }
+
+  // Space is released once the entries are transferred.
+  ASSERT_EQ(lock_free_multisink_.HandleEntryLockFree(kMessageOther),
+            OkStatus());
+  VerifyPopEntry(drains_[0], kMessageOther, 0u);
+}
+
+TEST_F(MultiSinkLockFreeTest, ClearDiscardsStagedEntries) {
+  lock_free_multisink_.AttachDrain(drains_[0]);
+
+  ASSERT_EQ(lock_free_multisink_.HandleEntryLockFree(kMessage), OkStatus());
+  lock_free_multisink_.Clear();
+  VerifyPopEntry(drains_[0], std::nullopt, 0u);
+}
+
+class MultiSinkPersistentTest : public ::testing::Test {
+ protected:
+  using PersistentState =
+      persistent_ram::Persistent<MultiSink::PersistentState>;
+
+  static constexpr std::byte kMessage[] = {
+      (std::byte)0xDE, (std::byte)0xAD, (std::byte)0xBE, (std::byte)0xEF};
+  static constexpr std::byte kMessageOther[] = {
+      (std::byte)0x12, (std::byte)0x34, (std::byte)0x56, (std::byte)0x78};
+
+  MultiSinkPersistentTest() {
+    std::memset(&state_storage_, 0, sizeof(state_storage_));
+  }
+
+  // Emulates a boot, constructing the persistent state over whatever the
+  // memory holds.
+  PersistentState& Boot() { return *new (&state_storage_) PersistentState(); }
+
+  void ExpectPop(Drain& drain,
+                 std::optional<ConstByteSpan> expected_message,
+                 uint32_t expected_drop_count) {
+    uint32_t drop_count = 0;
+    Result<ConstByteSpan> result = drain.PopEntry(entry_buffer_, drop_count);
+    if (expected_message.has_value()) {
+      ASSERT_EQ(result.status(), OkStatus());
+      ASSERT_EQ(result.value().size(), expected_message.value().size());
+      EXPECT_EQ(std::memcmp(result.value().data(),
+                            expected_message.value().data(),
+                            expected_message.value().size()),
+                0);
+    } else {
+      EXPECT_EQ(result.status(), Status::OutOfRange());
+    }
+    EXPECT_EQ(drop_count, expected_drop_count);
+  }
+
+  std::aligned_storage_t<sizeof(PersistentState), alignof(PersistentState)>
+      state_storage_;
+  PersistentState& state_ =
+      *reinterpret_cast<PersistentState*>(&state_storage_);
+  std::byte buffer_[64];
+  std::byte entry_buffer_[16];
+};
+
+TEST_F(MultiSinkPersistentTest, EntriesSurviveReset) {
+  {
+    MultiSink multisink(buffer_, Boot());
+    multisink.HandleEntry(kMessage);
+    multisink.HandleDropped(2);
+    multisink.HandleEntry(kMessageOther);
+  }
+
+  MultiSink multisink(buffer_, Boot());
+  Drain drain;
+  multisink.AttachDrain(drain);
+  ExpectPop(drain, kMessage, 0u);
+  ExpectPop(drain, kMessageOther, 2u);
+  ExpectPop(drain, std::nullopt, 0u);
+
+  // Sequence IDs continue from before the reset.
+  multisink.HandleEntry(kMessage);
+  ExpectPop(drain, kMessage, 0u);
+}
+
+TEST_F(MultiSinkPersistentTest, InvalidState_StartsEmpty) {
+  MultiSink multisink(buffer_, Boot());
+  EXPECT_TRUE(state_.has_value());
+
+  Drain drain;
+  multisink.AttachDrain(drain);
+  ExpectPop(drain, std::nullopt, 0u);
+  multisink.HandleEntry(kMessage);
+  ExpectPop(drain, kMessage, 0u);
+}
+
+TEST_F(MultiSinkPersistentTest, CorruptBuffer_StartsEmpty) {
+  {
+    MultiSink multisink(buffer_, Boot());
+    multisink.HandleEntry(kMessage);
+    multisink.HandleEntry(kMessageOther);
+  }
+  std::memset(buffer_, 0xff, sizeof(buffer_));
+
+  MultiSink multisink(buffer_, Boot());
+  Drain drain;
+  multisink.AttachDrain(drain);
+  ExpectPop(drain, std::nullopt, 0u);
+  multisink.HandleEntry(kMessage);
+  ExpectPop(drain, kMessage, 0u);
+}
+
 TEST(UnsafeIteration, NoLimit) {
   constexpr std::array<std::string_view, 5> kExpectedEntries{
       "one", "two", "three", "four", "five"};
@@ -413,4 +906,45 @@ TEST(UnsafeIteration, Subset) {
   EXPECT_EQ(kExpectedEntriesMaxEntries, entry_count);
 }
 
+TEST(UnsafeIteration, WrappedEntries_LeavesBufferInPlace) {
+  constexpr std::array<std::string_view, 6> kEntries{
+      "first", "second", "third", "four", "fifth", "sixth"};
+  std::array<std::byte, 32> buffer;
+  MultiSink multisink(buffer);
+
+  // Only the newest entries fit, and one wraps around the end of the buffer.
+  for (std::string_view entry : kEntries) {
+    multisink.HandleEntry(std::as_bytes(std::span(entry)));
+  }
+  const std::array<std::byte, 32> original_buffer = buffer;
+
+  struct {
+    std::array<std::string, kEntries.size()> entries;
+    size_t entry_count = 0;
+    size_t wrapped_count = 0;
+  } ctx;
+  auto cb = [&ctx](ConstByteSpan first, ConstByteSpan second) {
+    std::string& entry = ctx.entries[ctx.entry_count++];
+    entry.append(reinterpret_cast<const char*>(first.data()), first.size());
+    entry.append(reinterpret_cast<const char*>(second.data()), second.size());
+    ctx.wrapped_count += second.empty() ? 0 : 1;
+  };
+
+  EXPECT_EQ(OkStatus(), multisink.UnsafeForEachWrappedEntry(cb));
+  ASSERT_EQ(4u, ctx.entry_count);
+  EXPECT_EQ(1u, ctx.wrapped_count);
+  EXPECT_EQ("third", ctx.entries[0]);
+  EXPECT_EQ("four", ctx.entries[1]);
+  EXPECT_EQ("fifth", ctx.entries[2]);
+  EXPECT_EQ("sixth", ctx.entries[3]);
+  EXPECT_EQ(original_buffer, buffer);
+
+  // Limit to the newest entry.
+  ctx.entries = {};
+  ctx.entry_count = 0;
+  EXPECT_EQ(OkStatus(), multisink.UnsafeForEachWrappedEntry(cb, 1));
+  EXPECT_EQ(1u, ctx.entry_count);
+  EXPECT_EQ("sixth", ctx.entries[0]);
+}
+
 }  // namespace pw::multisink
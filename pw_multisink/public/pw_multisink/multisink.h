@@ -19,8 +19,10 @@
 #include "pw_bytes/span.h"
 #include "pw_function/function.h"
 #include "pw_multisink/config.h"
+#include "pw_persistent_ram/persistent.h"
 #include "pw_result/result.h"
 #include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
+#include "pw_ring_buffer/single_producer_entry_queue.h"
 #include "pw_status/status.h"
 #include "pw_sync/lock_annotations.h"
 
@@ -32,7 +34,10 @@ namespace multisink {
 // scenarios where readers need to be aware of the input message sequence.
 //
 // This class is thread-safe but NOT IRQ-safe when
-// PW_MULTISINK_LOCK_INTERRUPT_SAFE is disabled.
+// PW_MULTISINK_LOCK_INTERRUPT_SAFE is disabled. A multisink constructed with a
+// lock-free buffer additionally accepts entries from one producer context
+// through HandleEntryLockFree, which never takes the multisink lock and is
+// safe to call from interrupts regardless of the lock type.
 class MultiSink {
  public:
   // An asynchronous reader which is attached to a MultiSink via AttachDrain.
@@ -177,6 +182,79 @@ class MultiSink {
     Result<PeekedEntry> PeekEntry(ByteSpan buffer, uint32_t& drop_count_out)
         PW_LOCKS_EXCLUDED(multisink_->lock_);
 
+    // Walks consecutive entries under a single acquisition of the multisink
+    // lock, copying each one into `buffer` and passing it to `callback` along
+    // with the number of entries dropped since the previous entry. Entries for
+    // which the callback returns OK are popped before the lock is released, so
+    // a batch of entries is consumed atomically; any other status stops the
+    // walk and leaves that entry in the multisink.
+    //
+    // The walk also stops before an entry that would bring the total size of
+    // the accepted entries over `max_bytes`. An entry larger than `max_bytes`
+    // on its own is still passed to the callback, which may accept it to
+    // discard it.
+    //
+    // The `drop_count_out` is set to the number of entries dropped after the
+    // last accepted entry if the drain caught up, and zero otherwise.
+    //
+    // The multisink lock is held while the callback runs, so the callback must
+    // not use the multisink or its drains.
+    //
+    // Precondition: the buffer data must not be corrupt, otherwise there will
+    // be a crash.
+    //
+    // Return values:
+    // OK - The walk stopped early; more entries may be available.
+    // OUT_OF_RANGE - All available entries were walked.
+    // FAILED_PRECONDITION - The drain must be attached to a sink.
+    Status PeekEntries(
+        ByteSpan buffer,
+        const Function<Status(ConstByteSpan entry, uint32_t drop_count)>&
+            callback,
+        size_t max_bytes,
+        uint32_t& drop_count_out) PW_LOCKS_EXCLUDED(multisink_->lock_);
+
+    // A drain's read position. Drains at the same position read the same
+    // entries and drop counts, so the outcome of a walk by one drain can be
+    // applied to another with SkipTo().
+    struct Position {
+      uint32_t last_handled_sequence_id;
+
+      // The sequence ID of the drain's next entry, or of the next entry to be
+      // added if the drain has read every entry.
+      uint32_t next_sequence_id;
+
+      constexpr bool operator==(const Position& other) const {
+        return last_handled_sequence_id == other.last_handled_sequence_id &&
+               next_sequence_id == other.next_sequence_id;
+      }
+      constexpr bool operator!=(const Position& other) const {
+        return !(*this == other);
+      }
+    };
+
+    // Same as above, and also reports the drain's position before and after
+    // the walk.
+    Status PeekEntries(
+        ByteSpan buffer,
+        const Function<Status(ConstByteSpan entry, uint32_t drop_count)>&
+            callback,
+        size_t max_bytes,
+        uint32_t& drop_count_out,
+        Position& start_out,
+        Position& end_out) PW_LOCKS_EXCLUDED(multisink_->lock_);
+
+    // Moves the drain from `start` to `end`, as reported by another drain's
+    // PeekEntries, discarding the entries in between without reading them.
+    // This lets drains that process entries the same way share the result.
+    //
+    // Return values:
+    // OK - The drain was moved; more entries may be available.
+    // OUT_OF_RANGE - The drain was moved and has read all available entries.
+    // FAILED_PRECONDITION - The drain is not at `start`.
+    Status SkipTo(const Position& start, const Position& end)
+        PW_LOCKS_EXCLUDED(multisink_->lock_);
+
     // Drains are not copyable or movable.
     Drain(const Drain&) = delete;
     Drain& operator=(const Drain&) = delete;
@@ -217,6 +295,23 @@ class MultiSink {
     virtual void OnNewEntryAvailable() = 0;
   };
 
+  // Controls how often listeners are notified of new entries. Notifying on
+  // every entry typically wakes a drain thread for each one, so a burst of
+  // entries can be coalesced into fewer notifications.
+  //
+  // Listeners are always notified of the first entry or drop after a drain
+  // reads every available entry, since that drain may be waiting for it.
+  // While no drain has caught up, notifications are deferred until the
+  // pending entries reach either threshold, or NotifyPendingListeners is
+  // called. The default policy notifies listeners of every entry.
+  struct NotificationPolicy {
+    // Notify once this many entries or drops are pending.
+    uint32_t max_pending_entries = 1;
+
+    // Notify once the pending entries hold at least this many bytes.
+    size_t max_pending_bytes = std::numeric_limits<size_t>::max();
+  };
+
   class iterator {
    public:
     iterator& operator++() {
@@ -288,13 +383,43 @@ class MultiSink {
     return UnsafeIterationWrapper(oldest_entry_drain_.reader_);
   }
 
+  // The position of a multisink's entries in its buffer. A multisink whose
+  // buffer is in persistent memory keeps this alongside the buffer, so that
+  // its entries survive a reset.
+  struct PersistentState {
+    ring_buffer::PrefixedEntryRingBufferMulti::Position position;
+    uint32_t sequence_id;
+  };
+
   // Constructs a multisink using a ring buffer backed by the provided buffer.
-  MultiSink(ByteSpan buffer) : ring_buffer_(true), sequence_id_(0) {
+  MultiSink(ByteSpan buffer)
+      : ring_buffer_(true), sequence_id_(0), persistent_state_(nullptr) {
     ring_buffer_.SetBuffer(buffer)
         .IgnoreError();  // TODO(pwbug/387): Handle Status properly
     AttachDrain(oldest_entry_drain_);
   }
 
+  // Constructs a multisink that also accepts lock-free entries. Entries passed
+  // to HandleEntryLockFree are staged in `lock_free_buffer` until a reader or
+  // writer holding the multisink lock moves them into the ring buffer.
+  MultiSink(ByteSpan buffer, ByteSpan lock_free_buffer) : MultiSink(buffer) {
+    lock_free_queue_.SetBuffer(lock_free_buffer)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  }
+
+  // Constructs a multisink whose buffer and state are in persistent memory,
+  // e.g. a section that is not initialized on boot. Entries written before a
+  // reset are restored if the state is valid and matches the contents of the
+  // buffer, and are then available to drains as if they had been attached
+  // late. Otherwise the multisink starts empty.
+  //
+  // The state is updated after every write, so entries written before a crash
+  // can be drained after the reset without copying them out in the fault
+  // handler. If the reset interrupts a write, the check normally fails and the
+  // old entries are discarded.
+  MultiSink(ByteSpan buffer,
+            persistent_ram::Persistent<PersistentState>& persistent_state);
+
   // Write an entry to the multisink. If available space is less than the
   // size of the entry, the internal ring buffer will push the oldest entries
   // out to make space, so long as the entry is not larger than the buffer.
@@ -306,6 +431,31 @@ class MultiSink {
   // Precondition: entry.size() <= `ring_buffer_` size
   void HandleEntry(ConstByteSpan entry) PW_LOCKS_EXCLUDED(lock_);
 
+  // Writes an entry to the multisink without taking the multisink lock, so it
+  // may be called from any context, including interrupts. The entry is staged
+  // in the lock-free buffer and is assigned its sequence ID when it is moved
+  // into the ring buffer, which happens on the next HandleEntry, drain peek or
+  // pop, or FlushLockFreeEntries call. Entries that do not fit in the
+  // lock-free buffer are reported to readers as dropped.
+  //
+  // Listeners are NOT notified, since that requires the lock. Producers
+  // should arrange for FlushLockFreeEntries to be called from a thread, e.g. by
+  // waking a logging thread.
+  //
+  // Precondition: Only one context may call HandleEntryLockFree at a time.
+  //
+  // Return values:
+  // OK - The entry was staged.
+  // FAILED_PRECONDITION - The multisink has no lock-free buffer.
+  // RESOURCE_EXHAUSTED - The lock-free buffer is full; the entry was dropped.
+  Status HandleEntryLockFree(ConstByteSpan entry) {
+    return lock_free_queue_.PushBack(entry);
+  }
+
+  // Moves entries staged by HandleEntryLockFree into the ring buffer and
+  // notifies listeners if there were any new entries or drops.
+  void FlushLockFreeEntries() PW_LOCKS_EXCLUDED(lock_);
+
   // Notifies the multisink of messages dropped before ingress. The writer
   // may use this to signal to readers that an entry (or entries) failed
   // before being sent to the multisink (e.g. the writer failed to encode
@@ -331,8 +481,8 @@ class MultiSink {
   // immediately when attached, to allow late drain users to consume existing
   // entries. If draining in response to the notification, ensure that the drain
   // is attached prior to registering the listener; attempting to drain when
-  // unattached will crash. Once attached, listeners are invoked on all new
-  // messages.
+  // unattached will crash. Once attached, listeners are invoked on new
+  // messages, as allowed by the notification policy.
   //
   // Precondition: The listener must not be attached to a multisink.
   void AttachListener(Listener& listener) PW_LOCKS_EXCLUDED(lock_);
@@ -342,6 +492,15 @@ class MultiSink {
   // Precondition: The listener must be attached to this multisink.
   void DetachListener(Listener& listener) PW_LOCKS_EXCLUDED(lock_);
 
+  // Sets when listeners are notified of new entries. See NotificationPolicy.
+  void SetNotificationPolicy(const NotificationPolicy& policy)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Notifies listeners of entries or drops for which notification was deferred
+  // by the notification policy. The multisink has no clock, so to bound the
+  // notification latency, call this periodically, e.g. from a timer.
+  void NotifyPendingListeners() PW_LOCKS_EXCLUDED(lock_);
+
   // Removes all data from the internal buffer. The multisink's sequence ID is
   // not modified, so readers may interpret this event as droppping entries.
   void Clear() PW_LOCKS_EXCLUDED(lock_);
@@ -357,6 +516,20 @@ class MultiSink {
       const Function<void(ConstByteSpan)>& callback,
       size_t max_num_entries = std::numeric_limits<size_t>::max());
 
+  // Same as UnsafeForEachEntry(), but leaves the entries in place instead of
+  // deringing the buffer, so the time taken does not depend on the buffer
+  // size. The callback receives each entry in two parts; the entry continues
+  // from the first into the second if it wraps around the end of the buffer,
+  // otherwise the second is empty.
+  //
+  // Returns:
+  //   OK - Successfully dumped entire multisink.
+  //   DATA_LOSS - Corruption detected, some entries may have been lost.
+  Status UnsafeForEachWrappedEntry(
+      const Function<void(ConstByteSpan, ConstByteSpan)>& callback,
+      size_t max_num_entries = std::numeric_limits<size_t>::max())
+      PW_NO_LOCK_SAFETY_ANALYSIS;
+
  protected:
   friend Drain;
 
@@ -388,14 +561,69 @@ class MultiSink {
                                        uint32_t& entry_sequence_id_out)
       PW_LOCKS_EXCLUDED(lock_);
 
+  // Walks entries from the provided drain under a single lock acquisition and
+  // pops the entries accepted by `callback`. The drain's positions before and
+  // after the walk are reported if requested. See Drain::PeekEntries.
+  Status PeekEntries(
+      Drain& drain,
+      ByteSpan buffer,
+      const Function<Status(ConstByteSpan entry, uint32_t drop_count)>&
+          callback,
+      size_t max_bytes,
+      uint32_t& drop_count_out,
+      Drain::Position* start_out,
+      Drain::Position* end_out) PW_LOCKS_EXCLUDED(lock_);
+
+  // Moves the drain between positions. See Drain::SkipTo.
+  Status SkipTo(Drain& drain,
+                const Drain::Position& start,
+                const Drain::Position& end) PW_LOCKS_EXCLUDED(lock_);
+
  private:
+  Status PeekEntriesLocked(
+      Drain& drain,
+      ByteSpan buffer,
+      const Function<Status(ConstByteSpan entry, uint32_t drop_count)>&
+          callback,
+      size_t max_bytes,
+      uint32_t& drop_count_out) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  Drain::Position GetPosition(Drain& drain) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Notifies attached listeners of new entries or an updated drop count.
   void NotifyListeners() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Adds to the pending entries and notifies listeners if required by the
+  // notification policy.
+  void AddPendingEntries(uint32_t entries, size_t bytes)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Records the ring buffer position in the persistent state, if any.
+  void SavePersistentState() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Moves entries staged by HandleEntryLockFree into the ring buffer, ahead of
+  // any entry written under the lock, and adds them to the pending entries.
+  // Returns true if any entries were moved or dropped.
+  bool TransferLockFreeEntries() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   IntrusiveList<Listener> listeners_ PW_GUARDED_BY(lock_);
   ring_buffer::PrefixedEntryRingBufferMulti ring_buffer_ PW_GUARDED_BY(lock_);
   Drain oldest_entry_drain_ PW_GUARDED_BY(lock_);
   uint32_t sequence_id_ PW_GUARDED_BY(lock_);
+  persistent_ram::Persistent<PersistentState>* const persistent_state_
+      PW_GUARDED_BY(lock_);
+
+  // Entries and drops not yet notified to listeners, and whether a drain has
+  // read every entry since listeners were last notified.
+  NotificationPolicy notification_policy_ PW_GUARDED_BY(lock_);
+  uint32_t pending_entries_ PW_GUARDED_BY(lock_) = 0;
+  size_t pending_bytes_ PW_GUARDED_BY(lock_) = 0;
+  bool drain_caught_up_ PW_GUARDED_BY(lock_) = true;
+
+  // Only the producer in HandleEntryLockFree pushes to the queue; the consumer
+  // side is serialized by `lock_`.
+  ring_buffer::SingleProducerEntryQueue lock_free_queue_;
+  uint32_t lock_free_drop_count_ PW_GUARDED_BY(lock_) = 0;
   LockType lock_;
 };
 
@@ -14,21 +14,64 @@
 
 #include "pw_multisink/util.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "pw_bytes/span.h"
 #include "pw_function/function.h"
 #include "pw_multisink/multisink.h"
 #include "pw_status/status.h"
+#include "pw_stream/stream.h"
 
 namespace pw::multisink {
+namespace {
+
+// Reads an entry that wraps around the end of the multisink's buffer.
+class WrappedEntryReader : public stream::NonSeekableReader {
+ public:
+  WrappedEntryReader(ConstByteSpan first, ConstByteSpan second)
+      : first_(first), second_(second) {}
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    size_t bytes_read = 0;
+    for (ConstByteSpan* part : {&first_, &second_}) {
+      const size_t size =
+          std::min(part->size(), destination.size() - bytes_read);
+      std::memcpy(destination.data() + bytes_read, part->data(), size);
+      *part = part->subspan(size);
+      bytes_read += size;
+    }
+    return bytes_read == 0u ? StatusWithSize::OutOfRange()
+                            : StatusWithSize(bytes_read);
+  }
+
+  ConstByteSpan first_;
+  ConstByteSpan second_;
+};
+
+}  // namespace
 
 Status UnsafeDumpMultiSinkLogs(MultiSink& sink,
                                pw::log::LogEntries::StreamEncoder& encoder,
                                size_t max_num_entries) {
-  auto callback = [&encoder](ConstByteSpan entry) {
-    encoder.WriteBytes(
-        static_cast<uint32_t>(pw::log::LogEntries::Fields::ENTRIES), entry);
+  // Entries are written in place, so the buffer is not deringed. At most one
+  // entry wraps around the end of the buffer, which is copied in pieces.
+  auto callback = [&encoder](ConstByteSpan first, ConstByteSpan second) {
+    constexpr uint32_t kEntries =
+        static_cast<uint32_t>(pw::log::LogEntries::Fields::ENTRIES);
+    if (second.empty()) {
+      encoder.WriteBytes(kEntries, first).IgnoreError();
+      return;
+    }
+    std::byte pipe_buffer[32];
+    WrappedEntryReader reader(first, second);
+    encoder
+        .WriteBytesFromStream(
+            kEntries, reader, first.size() + second.size(), pipe_buffer)
+        .IgnoreError();
   };
-  return sink.UnsafeForEachEntry(callback, max_num_entries);
+  return sink.UnsafeForEachWrappedEntry(callback, max_num_entries);
 }
 
 }  // namespace pw::multisink
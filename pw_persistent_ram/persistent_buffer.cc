@@ -13,6 +13,9 @@
 // the License.
 #include "pw_persistent_ram/persistent_buffer.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "pw_bytes/span.h"
 #include "pw_checksum/crc16_ccitt.h"
 #include "pw_status/status.h"
@@ -40,4 +43,54 @@ Status PersistentBufferWriter::DoWrite(ConstByteSpan data) {
   return OkStatus();
 }
 
+Status ChunkedPersistentBufferWriter::DoWrite(ConstByteSpan data) {
+  if (ConservativeWriteLimit() == 0) {
+    return Status::OutOfRange();
+  }
+  if (ConservativeWriteLimit() < data.size_bytes()) {
+    return Status::ResourceExhausted();
+  }
+
+  while (!data.empty()) {
+    const size_t chunk = size_ / chunk_size_bytes_;
+    const size_t offset_in_chunk = size_ % chunk_size_bytes_;
+    const ConstByteSpan piece =
+        data.first(std::min(data.size_bytes(),
+                            chunk_size_bytes_ - offset_in_chunk));
+
+    std::memcpy(buffer_.data() + size_, piece.data(), piece.size_bytes());
+
+    // Only the chunk that was written to needs a new checksum. A chunk's
+    // checksum is updated before the size, so a reset in between only
+    // invalidates that chunk.
+    checksums_[chunk] = checksum::Crc16Ccitt::Calculate(
+        ByteSpan(buffer_.data() + size_, piece.size_bytes()),
+        offset_in_chunk == 0u ? checksum::Crc16Ccitt::kInitialValue
+                              : checksums_[chunk]);
+    size_ += piece.size_bytes();
+
+    data = data.subspan(piece.size_bytes());
+  }
+
+  return OkStatus();
+}
+
+namespace internal {
+
+size_t ValidChunkedPrefixSize(ConstByteSpan buffer,
+                              size_t chunk_size_bytes,
+                              size_t size,
+                              const volatile uint16_t* checksums) {
+  for (size_t start = 0; start < size; start += chunk_size_bytes) {
+    const size_t chunk_size = std::min(chunk_size_bytes, size - start);
+    if (checksums[start / chunk_size_bytes] !=
+        checksum::Crc16Ccitt::Calculate(buffer.subspan(start, chunk_size))) {
+      return start;
+    }
+  }
+  return size;
+}
+
+}  // namespace internal
+
 }  // namespace pw::persistent_ram
@@ -14,7 +14,9 @@
 #include "pw_persistent_ram/persistent_buffer.h"
 
 #include <cstddef>
+#include <cstring>
 #include <span>
+#include <string_view>
 #include <type_traits>
 
 #include "gtest/gtest.h"
@@ -160,5 +162,101 @@ TEST_F(PersistentTest, AppendingData) {
   }
 }
 
+class ChunkedPersistentBufferTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kBufferSize = 64;
+  static constexpr size_t kChunkSize = 16;
+  using Buffer = ChunkedPersistentBuffer<kBufferSize, kChunkSize>;
+
+  ChunkedPersistentBufferTest() { memset(buffer_, 0, sizeof(buffer_)); }
+
+  // Returns the buffer as it would be found after a reboot.
+  Buffer& Reboot() { return *(new (buffer_) Buffer()); }
+
+  // Modifies one byte of the data, as a torn write or bit flip would.
+  void CorruptByte(size_t index) {
+    std::byte* data = const_cast<std::byte*>(Reboot().data());
+    data[index] ^= std::byte{0xff};
+  }
+
+  void WriteBytes(size_t count) {
+    auto writer = Reboot().GetWriter();
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_EQ(OkStatus(), writer.Write(std::byte(i)));
+    }
+  }
+
+  alignas(Buffer) std::byte buffer_[sizeof(Buffer)];
+};
+
+TEST_F(ChunkedPersistentBufferTest, ZeroDataIsNoValue) {
+  EXPECT_FALSE(Reboot().has_value());
+  EXPECT_EQ(0u, Reboot().size());
+}
+
+TEST_F(ChunkedPersistentBufferTest, RandomDataIsInvalid) {
+  random::XorShiftStarRng64 rng(0x9ad75);
+  ASSERT_TRUE(rng.Get(buffer_).ok());
+  EXPECT_FALSE(Reboot().has_value());
+}
+
+TEST_F(ChunkedPersistentBufferTest, AppendsAcrossChunks) {
+  WriteBytes(20);
+  WriteBytes(30);  // Appends to the data from the previous boot.
+
+  Buffer& persistent = Reboot();
+  ASSERT_EQ(50u, persistent.size());
+  for (size_t i = 0; i < 20; ++i) {
+    EXPECT_EQ(std::byte(i), persistent.data()[i]);
+  }
+  for (size_t i = 0; i < 30; ++i) {
+    EXPECT_EQ(std::byte(i), persistent.data()[20 + i]);
+  }
+}
+
+TEST_F(ChunkedPersistentBufferTest, SingleWriteSpanningChunks) {
+  constexpr std::string_view kData("A string longer than one chunk of data");
+  ASSERT_EQ(OkStatus(),
+            Reboot().GetWriter().Write(kData.data(), kData.size()));
+
+  Buffer& persistent = Reboot();
+  ASSERT_EQ(kData.size(), persistent.size());
+  EXPECT_EQ(0, memcmp(kData.data(), persistent.data(), kData.size()));
+}
+
+TEST_F(ChunkedPersistentBufferTest, Corruption_KeepsValidPrefix) {
+  WriteBytes(40);
+  CorruptByte(2 * kChunkSize + 3);
+
+  EXPECT_EQ(2 * kChunkSize, Reboot().size());
+}
+
+TEST_F(ChunkedPersistentBufferTest, GetWriter_AppendsAfterValidPrefix) {
+  WriteBytes(40);
+  CorruptByte(kChunkSize + 1);
+
+  auto writer = Reboot().GetWriter();
+  ASSERT_EQ(OkStatus(), writer.Write(std::byte{0x42}));
+
+  Buffer& persistent = Reboot();
+  ASSERT_EQ(kChunkSize + 1, persistent.size());
+  EXPECT_EQ(std::byte{0x42}, persistent.data()[kChunkSize]);
+}
+
+TEST_F(ChunkedPersistentBufferTest, Full) {
+  WriteBytes(kBufferSize);
+
+  auto writer = Reboot().GetWriter();
+  EXPECT_EQ(0u, writer.ConservativeWriteLimit());
+  EXPECT_EQ(Status::OutOfRange(), writer.Write(std::byte{0}));
+  EXPECT_EQ(kBufferSize, Reboot().size());
+}
+
+TEST_F(ChunkedPersistentBufferTest, Clear) {
+  WriteBytes(20);
+  Reboot().clear();
+  EXPECT_FALSE(Reboot().has_value());
+}
+
 }  // namespace
 }  // namespace pw::persistent_ram
@@ -60,6 +60,54 @@ class PersistentBufferWriter : public stream::NonSeekableWriter {
   volatile uint16_t& checksum_;
 };
 
+// A ChunkedPersistentBufferWriter appends to a ChunkedPersistentBuffer,
+// updating only the checksum of the chunk being written. This object should
+// NOT be stored in persistent RAM.
+//
+// Only one writer should be open at a given time.
+class ChunkedPersistentBufferWriter : public stream::NonSeekableWriter {
+ public:
+  ChunkedPersistentBufferWriter() = delete;
+
+ private:
+  template <size_t, size_t>
+  friend class ChunkedPersistentBuffer;
+
+  ChunkedPersistentBufferWriter(ByteSpan buffer,
+                                size_t chunk_size_bytes,
+                                volatile size_t& size,
+                                volatile uint16_t* checksums)
+      : buffer_(buffer),
+        chunk_size_bytes_(chunk_size_bytes),
+        size_(size),
+        checksums_(checksums) {}
+
+  Status DoWrite(ConstByteSpan data) override;
+
+  size_t ConservativeLimit(LimitType limit) const override {
+    if (limit == LimitType::kWrite) {
+      return buffer_.size_bytes() - size_;
+    }
+    return 0;
+  }
+
+  ByteSpan buffer_;
+  size_t chunk_size_bytes_;
+  volatile size_t& size_;
+  volatile uint16_t* checksums_;
+};
+
+namespace internal {
+
+// Returns the size of the longest prefix of a chunked buffer whose chunks all
+// match their checksums.
+size_t ValidChunkedPrefixSize(ConstByteSpan buffer,
+                              size_t chunk_size_bytes,
+                              size_t size,
+                              const volatile uint16_t* checksums);
+
+}  // namespace internal
+
 // The PersistentBuffer class intentionally uses uninitialized memory, which
 // triggers compiler warnings. Disable those warnings for this file.
 PW_MODIFY_DIAGNOSTICS_PUSH();
@@ -143,6 +191,67 @@ class PersistentBuffer {
   volatile std::byte buffer_[kMaxSizeBytes];
 };
 
+// A ChunkedPersistentBuffer is a PersistentBuffer for append-only data, such
+// as crash breadcrumbs, that keeps a separate CRC16 for each kChunkSizeBytes
+// chunk of the buffer.
+//
+// If the device resets partway through a write, or part of the buffer is
+// corrupted, only the data from the first bad chunk onwards is lost; the
+// chunks before it remain valid. A PersistentBuffer, with one checksum for
+// all of its data, loses everything in that case.
+//
+// Validating the buffer reads all of the data, as for a PersistentBuffer.
+// GetWriter() validates once and truncates the buffer to the valid prefix,
+// after which appends only checksum the chunk they are written to.
+template <size_t kMaxSizeBytes, size_t kChunkSizeBytes>
+class ChunkedPersistentBuffer {
+ public:
+  static_assert(kChunkSizeBytes > 0u, "Chunks must not be empty");
+
+  static constexpr size_t kChunkCount =
+      (kMaxSizeBytes + kChunkSizeBytes - 1) / kChunkSizeBytes;
+
+  // Like PersistentBuffer, the constructor intentionally does not initialize
+  // anything.
+  ChunkedPersistentBuffer() {}
+  ChunkedPersistentBuffer(const ChunkedPersistentBuffer&) = delete;
+  ChunkedPersistentBuffer(ChunkedPersistentBuffer&&) = delete;
+  ~ChunkedPersistentBuffer() {}
+
+  // Discards any data after the valid prefix and returns a writer that appends
+  // to it.
+  ChunkedPersistentBufferWriter GetWriter() {
+    size_ = size();
+    return ChunkedPersistentBufferWriter(ByteSpan(buffer(), kMaxSizeBytes),
+                                         kChunkSizeBytes,
+                                         size_,
+                                         checksums_);
+  }
+
+  // Returns the size of the valid prefix of the data.
+  size_t size() const {
+    return internal::ValidChunkedPrefixSize(
+        ConstByteSpan(data(), kMaxSizeBytes),
+        kChunkSizeBytes,
+        size_ < kMaxSizeBytes ? size_ : kMaxSizeBytes,
+        checksums_);
+  }
+
+  const std::byte* data() const { return const_cast<std::byte*>(buffer_); }
+
+  void clear() { size_ = 0; }
+
+  bool has_value() const { return size() != 0u; }
+
+ private:
+  std::byte* buffer() { return const_cast<std::byte*>(buffer_); }
+
+  // None of these members are initialized by the constructor by design.
+  volatile size_t size_;
+  volatile uint16_t checksums_[kChunkCount];
+  volatile std::byte buffer_[kMaxSizeBytes];
+};
+
 PW_MODIFY_DIAGNOSTICS_POP();
 
 }  // namespace pw::persistent_ram
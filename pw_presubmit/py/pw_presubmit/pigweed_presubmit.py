@@ -293,6 +293,7 @@ _MODULES_THAT_BUILD_WITH_BAZEL = [
     '//pw_bloat/...',
     '//pw_build/...',
     '//pw_checksum/...',
+    '//pw_chrono_cortex_m/...',
     '//pw_chrono_embos/...',
     '//pw_chrono_freertos/...',
     '//pw_chrono_stl/...',
@@ -331,6 +331,33 @@ TEST(CodegenRepeated, Message) {
             0);
 }
 
+TEST(CodegenRepeated, SizedMessage) {
+  std::byte encode_buffer[64];
+  stream::MemoryWriter writer(encode_buffer);
+
+  // No scratch buffer is needed since each submessage size is known.
+  RepeatedTest::StreamEncoder repeated_test(writer, ByteSpan());
+  for (int i = 0; i < 3; ++i) {
+    auto structs = repeated_test.GetStructsEncoder(4);
+    structs.WriteOne(i * 1)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    structs.WriteTwo(i * 2)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  }
+
+  // clang-format off
+  constexpr uint8_t expected_proto[] = {
+    0x2a, 0x04, 0x08, 0x00, 0x10, 0x00, 0x2a, 0x04, 0x08,
+    0x01, 0x10, 0x02, 0x2a, 0x04, 0x08, 0x02, 0x10, 0x04};
+  // clang-format on
+
+  ConstByteSpan result = writer.WrittenData();
+  ASSERT_EQ(repeated_test.status(), OkStatus());
+  EXPECT_EQ(result.size(), sizeof(expected_proto));
+  EXPECT_EQ(std::memcmp(result.data(), expected_proto, sizeof(expected_proto)),
+            0);
+}
+
 TEST(Codegen, Proto2) {
   std::byte encode_buffer[64];
 
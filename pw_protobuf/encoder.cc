@@ -60,6 +60,30 @@ StreamEncoder StreamEncoder::GetNestedEncoder(uint32_t field_number) {
   return StreamEncoder(*this, nested_buffer);
 }
 
+StreamEncoder StreamEncoder::GetNestedEncoder(uint32_t field_number,
+                                              size_t payload_size) {
+  PW_CHECK(!nested_encoder_open());
+  PW_CHECK(ValidFieldNumber(field_number));
+
+  // Write the key and length up front so that the submessage can be written
+  // directly to the writer. If this fails, the nested encoder starts with the
+  // same error so that its writes are blocked.
+  if (payload_size <= std::numeric_limits<uint32_t>::max() &&
+      UpdateStatusForWrite(field_number, WireType::kDelimited, payload_size)
+          .ok()) {
+    status_.Update(WriteLengthDelimitedKeyAndLengthPrefix(
+        field_number, payload_size, writer_));
+  } else {
+    status_.Update(Status::OutOfRange());
+  }
+
+  // UpdateStatusForWrite() requires that no nested encoder is open, so the
+  // field number is only set once the key and length are written.
+  nested_field_number_ = field_number;
+
+  return StreamEncoder(*this, writer_, payload_size);
+}
+
 StreamEncoder::~StreamEncoder() {
   // If this was an invalidated StreamEncoder which cannot be used, permit the
   // object to be cleanly destructed by doing nothing.
@@ -98,6 +122,15 @@ void StreamEncoder::CloseNestedMessage(StreamEncoder& nested) {
     return;
   }
 
+  // Nested encoders with a known size have already written their data; they
+  // only need to have written all of the bytes in the length prefix.
+  if (nested.payload_bytes_remaining_ != kUnknownPayloadSize) {
+    if (nested.payload_bytes_remaining_ != 0u) {
+      status_ = Status::DataLoss();
+    }
+    return;
+  }
+
   if (varint::EncodedSize(nested.memory_writer_.bytes_written()) >
       config::kMaxVarintSize) {
     status_ = Status::OutOfRange();
@@ -222,10 +255,19 @@ Status StreamEncoder::UpdateStatusForWrite(uint32_t field_number,
   status_.Update(field_size.status());
   PW_TRY(status_);
 
+  if (field_size.value() > payload_bytes_remaining_) {
+    status_ = Status::OutOfRange();
+    return status_;
+  }
+
   if (field_size.value() > writer_.ConservativeWriteLimit()) {
     status_ = Status::ResourceExhausted();
+    return status_;
   }
 
+  if (payload_bytes_remaining_ != kUnknownPayloadSize) {
+    payload_bytes_remaining_ -= field_size.value();
+  }
   return status_;
 }
 
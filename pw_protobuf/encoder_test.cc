@@ -14,11 +14,13 @@
 
 #include "pw_protobuf/encoder.h"
 
+#include <cstring>
 #include <span>
 
 #include "gtest/gtest.h"
 #include "pw_bytes/span.h"
 #include "pw_stream/memory_stream.h"
+#include "pw_stream/null_stream.h"
 
 namespace pw::protobuf {
 namespace {
@@ -407,5 +409,118 @@ TEST(StreamEncoder, NestedStatusPropagates) {
   ASSERT_EQ(parent.status(), Status::InvalidArgument());
 }
 
+// Writes a NestedProto with a single DoubleNestedProto pair.
+Status WriteNestedProto(StreamEncoder& nested, size_t pair_size) {
+  nested.WriteString(kNestedProtoHelloField, "world")
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  nested.WriteUint32(kNestedProtoIdField, 999)
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  {
+    StreamEncoder pair =
+        nested.GetNestedEncoder(kNestedProtoPairField, pair_size);
+    pair.WriteString(kDoubleNestedProtoKeyField, "version")
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    pair.WriteString(kDoubleNestedProtoValueField, "2.9.1")
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  }
+  return nested.status();
+}
+
+constexpr size_t kPairSize = 16;  // Two 7- and 5-character strings.
+constexpr size_t kNestedSize = 7 + 3 + 2 + kPairSize;
+
+TEST(StreamEncoder, SizedNestedMatchesBufferedNested) {
+  std::byte buffered_buffer[64];
+  std::byte scratch_buffer[64];
+  MemoryWriter buffered_writer(buffered_buffer);
+  StreamEncoder buffered(buffered_writer, scratch_buffer);
+  {
+    StreamEncoder nested = buffered.GetNestedEncoder(kTestProtoNestedField);
+    nested.WriteString(kNestedProtoHelloField, "world")
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    nested.WriteUint32(kNestedProtoIdField, 999)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    StreamEncoder pair = nested.GetNestedEncoder(kNestedProtoPairField);
+    pair.WriteString(kDoubleNestedProtoKeyField, "version")
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    pair.WriteString(kDoubleNestedProtoValueField, "2.9.1")
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  }
+  ASSERT_EQ(buffered.status(), OkStatus());
+
+  // The sized encoder streams directly to the writer without a scratch buffer.
+  std::byte sized_buffer[64];
+  MemoryWriter sized_writer(sized_buffer);
+  StreamEncoder sized(sized_writer, ByteSpan());
+  {
+    StreamEncoder nested =
+        sized.GetNestedEncoder(kTestProtoNestedField, kNestedSize);
+    EXPECT_EQ(WriteNestedProto(nested, kPairSize), OkStatus());
+  }
+  ASSERT_EQ(sized.status(), OkStatus());
+
+  ASSERT_EQ(sized_writer.bytes_written(), buffered_writer.bytes_written());
+  EXPECT_EQ(std::memcmp(buffered_buffer,
+                        sized_buffer,
+                        buffered_writer.bytes_written()),
+            0);
+}
+
+TEST(StreamEncoder, SizedNestedTwoPass) {
+  // First pass: measure the submessage by encoding it to a counting stream.
+  stream::CountingNullStream counter;
+  StreamEncoder counting_encoder(counter, ByteSpan());
+  ASSERT_EQ(WriteNestedProto(counting_encoder, kPairSize), OkStatus());
+  ASSERT_EQ(counter.bytes_written(), kNestedSize);
+
+  // Second pass: encode it for real with the measured size.
+  std::byte buffer[64];
+  MemoryWriter writer(buffer);
+  StreamEncoder encoder(writer, ByteSpan());
+  {
+    StreamEncoder nested = encoder.GetNestedEncoder(kTestProtoNestedField,
+                                                    counter.bytes_written());
+    EXPECT_EQ(WriteNestedProto(nested, kPairSize), OkStatus());
+  }
+  EXPECT_EQ(encoder.status(), OkStatus());
+  EXPECT_EQ(writer.bytes_written(), 2 + kNestedSize);
+}
+
+TEST(StreamEncoder, SizedNestedOverflow) {
+  std::byte buffer[64];
+  MemoryWriter writer(buffer);
+  StreamEncoder encoder(writer, ByteSpan());
+  {
+    StreamEncoder nested = encoder.GetNestedEncoder(kTestProtoNestedField, 4);
+    EXPECT_EQ(nested.WriteUint32(kNestedProtoIdField, 1), OkStatus());
+    EXPECT_EQ(nested.WriteUint32(kNestedProtoIdField, 999),
+              Status::OutOfRange());
+  }
+  EXPECT_EQ(encoder.status(), Status::OutOfRange());
+}
+
+TEST(StreamEncoder, SizedNestedUnderflow) {
+  std::byte buffer[64];
+  MemoryWriter writer(buffer);
+  StreamEncoder encoder(writer, ByteSpan());
+  {
+    StreamEncoder nested = encoder.GetNestedEncoder(kTestProtoNestedField, 4);
+    EXPECT_EQ(nested.WriteUint32(kNestedProtoIdField, 1), OkStatus());
+  }
+  EXPECT_EQ(encoder.status(), Status::DataLoss());
+}
+
+TEST(StreamEncoder, SizedNestedDoesNotFitWriter) {
+  std::byte buffer[8];
+  MemoryWriter writer(buffer);
+  StreamEncoder encoder(writer, ByteSpan());
+  {
+    StreamEncoder nested = encoder.GetNestedEncoder(kTestProtoNestedField, 16);
+    EXPECT_EQ(nested.status(), Status::ResourceExhausted());
+  }
+  EXPECT_EQ(encoder.status(), Status::ResourceExhausted());
+  EXPECT_EQ(writer.bytes_written(), 0u);
+}
+
 }  // namespace
 }  // namespace pw::protobuf
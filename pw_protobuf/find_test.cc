@@ -14,7 +14,10 @@
 
 #include "pw_protobuf/find.h"
 
+#include <string_view>
+
 #include "gtest/gtest.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::protobuf {
 namespace {
@@ -92,5 +95,155 @@ TEST(FindDecodeHandler, MultiLevel_DoesntFindNonExistingNestedField) {
   EXPECT_FALSE(decoder.cancelled());
 }
 
+ConstByteSpan EncodedProto() {
+  return std::as_bytes(std::span(encoded_proto));
+}
+
+Status ReadUint32(StreamDecoder& field, uint32_t& value) {
+  Result<uint32_t> result = field.ReadUint32();
+  value = result.value_or(0);
+  return result.status();
+}
+
+TEST(Find, SingleLevel_FindsExistingField) {
+  uint32_t value = 0;
+  Status status = Find<1>(EncodedProto(), [&value](Decoder& field) {
+    return field.ReadUint32(&value);
+  });
+  EXPECT_EQ(OkStatus(), status);
+  EXPECT_EQ(42u, value);
+
+  std::string_view str;
+  status = Find<6>(EncodedProto(),
+                   [&str](Decoder& field) { return field.ReadString(&str); });
+  EXPECT_EQ(OkStatus(), status);
+  EXPECT_EQ("Hello world", str);
+}
+
+TEST(Find, SingleLevel_DoesntFindNonExistingField) {
+  bool called = false;
+  const Status status = Find<8>(EncodedProto(), [&called](Decoder&) {
+    called = true;
+    return OkStatus();
+  });
+  EXPECT_EQ(Status::NotFound(), status);
+  EXPECT_FALSE(called);
+}
+
+TEST(Find, MultiLevel_FindsExistingNestedField) {
+  uint32_t value = 0;
+  const Status status = Find<7, 1>(EncodedProto(), [&value](Decoder& field) {
+    return field.ReadUint32(&value);
+  });
+  EXPECT_EQ(OkStatus(), status);
+  EXPECT_EQ(3u, value);
+}
+
+TEST(Find, MultiLevel_DoesntFindNonExistingNestedField) {
+  const Status status =
+      Find<7, 3>(EncodedProto(), [](Decoder&) { return OkStatus(); });
+  EXPECT_EQ(Status::NotFound(), status);
+}
+
+TEST(Find, MultiLevel_NonMessageOnPath_FailedPrecondition) {
+  const Status status =
+      Find<1, 1>(EncodedProto(), [](Decoder&) { return OkStatus(); });
+  EXPECT_EQ(Status::FailedPrecondition(), status);
+}
+
+TEST(Find, ReturnsFunctionStatus) {
+  const Status status =
+      Find<5>(EncodedProto(), [](Decoder&) { return Status::Cancelled(); });
+  EXPECT_EQ(Status::Cancelled(), status);
+}
+
+// clang-format off
+constexpr uint8_t kTruncatedAfterMatch[] = {
+  // type=string, k=1, v="hi"
+  0x0a, 0x02, 'h', 'i',
+  // type=message, k=2, len=2
+  0x12, 0x02,
+  // (nested) type=uint32, k=1, v=7
+  0x08, 0x07,
+  // type=bytes, k=3, len=100, truncated
+  0x1a, 0x64, 0x00,
+};
+// clang-format on
+
+TEST(Find, StopsAtFirstMatch) {
+  const ConstByteSpan message = std::as_bytes(std::span(kTruncatedAfterMatch));
+
+  uint32_t value = 0;
+  Status status = Find<2, 1>(message, [&value](Decoder& field) {
+    return field.ReadUint32(&value);
+  });
+  EXPECT_EQ(OkStatus(), status);
+  EXPECT_EQ(7u, value);
+
+  // Searching past the truncated field reaches the corruption.
+  status = Find<4>(message, [](Decoder&) { return OkStatus(); });
+  EXPECT_EQ(Status::DataLoss(), status);
+}
+
+TEST(FindStream, SingleLevel_FindsExistingField) {
+  stream::MemoryReader reader(EncodedProto());
+  StreamDecoder decoder(reader);
+
+  uint32_t value = 0;
+  const Status status = Find<5>(decoder, [&value](StreamDecoder& field) {
+    Result<uint32_t> result = field.ReadFixed32();
+    value = result.value_or(0);
+    return result.status();
+  });
+  EXPECT_EQ(OkStatus(), status);
+  EXPECT_EQ(0xdeadbeef, value);
+
+  // The decoder continues after the found field.
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  EXPECT_EQ(6u, decoder.FieldNumber().value());
+}
+
+TEST(FindStream, SingleLevel_DoesntFindNonExistingField) {
+  stream::MemoryReader reader(EncodedProto());
+  StreamDecoder decoder(reader);
+
+  const Status status =
+      Find<8>(decoder, [](StreamDecoder&) { return OkStatus(); });
+  EXPECT_EQ(Status::NotFound(), status);
+}
+
+TEST(FindStream, MultiLevel_FindsExistingNestedField) {
+  stream::MemoryReader reader(EncodedProto());
+  StreamDecoder decoder(reader);
+
+  uint32_t value = 0;
+  const Status status = Find<7, 1>(decoder, [&value](StreamDecoder& field) {
+    return ReadUint32(field, value);
+  });
+  EXPECT_EQ(OkStatus(), status);
+  EXPECT_EQ(3u, value);
+}
+
+TEST(FindStream, MultiLevel_DoesntFindNonExistingNestedField) {
+  stream::MemoryReader reader(EncodedProto());
+  StreamDecoder decoder(reader);
+
+  const Status status =
+      Find<7, 3>(decoder, [](StreamDecoder&) { return OkStatus(); });
+  EXPECT_EQ(Status::NotFound(), status);
+}
+
+TEST(FindStream, StopsAtFirstMatch) {
+  stream::MemoryReader reader(std::as_bytes(std::span(kTruncatedAfterMatch)));
+  StreamDecoder decoder(reader);
+
+  uint32_t value = 0;
+  const Status status = Find<2, 1>(decoder, [&value](StreamDecoder& field) {
+    return ReadUint32(field, value);
+  });
+  EXPECT_EQ(OkStatus(), status);
+  EXPECT_EQ(7u, value);
+}
+
 }  // namespace
 }  // namespace pw::protobuf
@@ -0,0 +1,946 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_protobuf/json_transcoder.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "pw_base64/base64.h"
+#include "pw_bytes/endian.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
+
+namespace pw::protobuf {
+namespace {
+
+using FieldType = DescriptorPool::FieldType;
+
+// Field numbers from google/protobuf/descriptor.proto.
+namespace descriptor {
+
+inline constexpr uint32_t kFileDescriptorSetFile = 1;
+
+inline constexpr uint32_t kFilePackage = 2;
+inline constexpr uint32_t kFileMessageType = 4;
+inline constexpr uint32_t kFileEnumType = 5;
+
+inline constexpr uint32_t kMessageName = 1;
+inline constexpr uint32_t kMessageField = 2;
+inline constexpr uint32_t kMessageNestedType = 3;
+inline constexpr uint32_t kMessageEnumType = 4;
+inline constexpr uint32_t kMessageOptions = 7;
+inline constexpr uint32_t kMessageOptionsMapEntry = 7;
+
+inline constexpr uint32_t kFieldName = 1;
+inline constexpr uint32_t kFieldNumber = 3;
+inline constexpr uint32_t kFieldLabel = 4;
+inline constexpr uint32_t kFieldType = 5;
+inline constexpr uint32_t kFieldTypeName = 6;
+inline constexpr uint32_t kFieldJsonName = 10;
+inline constexpr uint32_t kFieldLabelRepeated = 3;
+
+inline constexpr uint32_t kEnumName = 1;
+inline constexpr uint32_t kEnumValue = 2;
+inline constexpr uint32_t kEnumValueName = 1;
+inline constexpr uint32_t kEnumValueNumber = 2;
+
+}  // namespace descriptor
+
+// Map entry messages have the key in field 1 and the value in field 2.
+constexpr uint32_t kMapKeyField = 1;
+constexpr uint32_t kMapValueField = 2;
+
+// Iterates over a message's fields, calling function for each one. Returns
+// DATA_LOSS if the message is malformed.
+template <typename Function>
+Status ForEachField(ConstByteSpan message, Function&& function) {
+  Decoder decoder(message);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    PW_TRY(function(decoder));
+  }
+  return status.IsOutOfRange() ? OkStatus() : Status::DataLoss();
+}
+
+std::string Qualify(const std::string& scope, std::string_view name) {
+  if (scope.empty()) {
+    return std::string(name);
+  }
+  std::string full_name = scope;
+  full_name += '.';
+  full_name += name;
+  return full_name;
+}
+
+// Converts a field name to its lowerCamelCase JSON name, as protoc does.
+std::string ToJsonName(std::string_view name) {
+  std::string json_name;
+  bool capitalize = false;
+  for (char c : name) {
+    if (c == '_') {
+      capitalize = true;
+    } else if (capitalize && c >= 'a' && c <= 'z') {
+      json_name += static_cast<char>(c - 'a' + 'A');
+      capitalize = false;
+    } else {
+      json_name += c;
+      capitalize = false;
+    }
+  }
+  return json_name;
+}
+
+constexpr bool IsScalar(FieldType type) {
+  return type != FieldType::kString && type != FieldType::kBytes &&
+         type != FieldType::kMessage && type != FieldType::kGroup;
+}
+
+// The wire type of a scalar field's unpacked values.
+constexpr WireType ScalarWireType(FieldType type) {
+  switch (type) {
+    case FieldType::kDouble:
+    case FieldType::kFixed64:
+    case FieldType::kSfixed64:
+      return WireType::kFixed64;
+    case FieldType::kFloat:
+    case FieldType::kFixed32:
+    case FieldType::kSfixed32:
+      return WireType::kFixed32;
+    default:
+      return WireType::kVarint;
+  }
+}
+
+// Reads the current field's value as its unsigned wire representation.
+Result<uint64_t> ReadRawScalar(FieldType type, StreamDecoder& decoder) {
+  Result<uint64_t> raw = Status::DataLoss();
+  switch (ScalarWireType(type)) {
+    case WireType::kFixed64:
+      raw = decoder.ReadFixed64();
+      break;
+    case WireType::kFixed32:
+      if (Result<uint32_t> value = decoder.ReadFixed32(); value.ok()) {
+        raw = value.value();
+      }
+      break;
+    default:
+      raw = decoder.ReadUint64();
+      break;
+  }
+  return raw.ok() ? raw : Status::DataLoss();
+}
+
+// Buffers the JSON text and writes it to the output in large chunks. The first
+// write error is kept and later writes are dropped.
+class JsonWriter {
+ public:
+  constexpr JsonWriter(stream::Writer& output)
+      : output_(output), buffer_{}, size_(0), status_(OkStatus()) {}
+
+  void Write(char c) {
+    if (size_ == buffer_.size()) {
+      WriteBuffer();
+    }
+    buffer_[size_++] = c;
+  }
+
+  void Write(std::string_view text) {
+    while (!text.empty()) {
+      if (size_ == buffer_.size()) {
+        WriteBuffer();
+      }
+      const size_t size = std::min(text.size(), buffer_.size() - size_);
+      std::memcpy(&buffer_[size_], text.data(), size);
+      size_ += size;
+      text.remove_prefix(size);
+    }
+  }
+
+  // Writes a string's characters, escaped for a JSON string.
+  void WriteEscaped(std::string_view text) {
+    static constexpr char kHexDigits[] = "0123456789abcdef";
+
+    for (char c : text) {
+      switch (c) {
+        case '"':
+          Write("\\\"");
+          break;
+        case '\\':
+          Write("\\\\");
+          break;
+        case '\b':
+          Write("\\b");
+          break;
+        case '\f':
+          Write("\\f");
+          break;
+        case '\n':
+          Write("\\n");
+          break;
+        case '\r':
+          Write("\\r");
+          break;
+        case '\t':
+          Write("\\t");
+          break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20) {
+            const char escape[] = {'\\',
+                                   'u',
+                                   '0',
+                                   '0',
+                                   kHexDigits[(c >> 4) & 0xf],
+                                   kHexDigits[c & 0xf]};
+            Write(std::string_view(escape, sizeof(escape)));
+          } else {
+            Write(c);
+          }
+      }
+    }
+  }
+
+  template <typename Integer>
+  void WriteInteger(Integer value) {
+    std::array<char, 24> text;
+    const auto result =
+        std::to_chars(text.data(), text.data() + text.size(), value);
+    Write(std::string_view(text.data(), result.ptr - text.data()));
+  }
+
+  // Writes the shortest decimal text that reads back as the same value.
+  template <typename Float>
+  void WriteFloat(Float value) {
+    if (std::isnan(value)) {
+      Write("\"NaN\"");
+      return;
+    }
+    if (std::isinf(value)) {
+      Write(value > 0 ? "\"Infinity\"" : "\"-Infinity\"");
+      return;
+    }
+
+    constexpr int kMaxDigits = std::is_same_v<Float, float> ? 9 : 17;
+    std::array<char, 32> text;
+    int size = 0;
+    for (int digits = 6; digits <= kMaxDigits; ++digits) {
+      size = std::snprintf(
+          text.data(), text.size(), "%.*g", digits, static_cast<double>(value));
+      if (static_cast<Float>(std::strtod(text.data(), nullptr)) == value) {
+        break;
+      }
+    }
+    Write(std::string_view(text.data(), static_cast<size_t>(size)));
+  }
+
+  Status Flush() {
+    WriteBuffer();
+    return status_;
+  }
+
+  Status status() const { return status_; }
+
+ private:
+  void WriteBuffer() {
+    if (status_.ok() && size_ > 0u) {
+      status_ = output_.Write(std::as_bytes(std::span(buffer_.data(), size_)));
+    }
+    size_ = 0;
+  }
+
+  stream::Writer& output_;
+  std::array<char, 4096> buffer_;
+  size_t size_;
+  Status status_;
+};
+
+// Writes one message as JSON. Each Transcode call creates one of these.
+class MessageWriter {
+ public:
+  constexpr MessageWriter(JsonWriter& json, const JsonOptions& options)
+      : json_(json), options_(options) {}
+
+  Status WriteMessage(const DescriptorPool::Message& type,
+                      StreamDecoder& decoder);
+
+ private:
+  using Field = DescriptorPool::Field;
+
+  void WriteKey(const Field& field) {
+    json_.Write('"');
+    json_.Write(options_.preserve_field_names ? field.name : field.json_name);
+    json_.Write("\":");
+  }
+
+  // Writes a value of the field's type from the decoder's current field.
+  Status WriteValue(const Field& field, StreamDecoder& decoder);
+
+  Status WriteScalar(const Field& field, uint64_t raw);
+  void WriteDefaultValue(const Field& field);
+  Status WriteString(StreamDecoder& decoder);
+  Status WriteBytes(StreamDecoder& decoder);
+
+  // Writes each value in a packed field, separated by commas.
+  Status WritePacked(const Field& field, StreamDecoder& decoder, bool first);
+
+  // Writes a map entry's key and value as an object member.
+  Status WriteMapEntry(const DescriptorPool::Message& entry,
+                       StreamDecoder& decoder);
+
+  JsonWriter& json_;
+  const JsonOptions& options_;
+};
+
+Status MessageWriter::WriteMessage(const DescriptorPool::Message& type,
+                                   StreamDecoder& decoder) {
+  json_.Write('{');
+
+  bool first_field = true;
+  bool first_value = true;
+  const Field* open_repeated = nullptr;
+  std::vector<uint32_t> closed_repeated;
+
+  auto close_repeated = [&]() {
+    json_.Write(open_repeated->message != nullptr &&
+                        open_repeated->message->map_entry
+                    ? '}'
+                    : ']');
+    closed_repeated.push_back(open_repeated->number);
+    open_repeated = nullptr;
+  };
+
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    const Field* field = type.FindField(decoder.FieldNumber().value());
+
+    // Skip unknown fields and fields whose message type is not known.
+    if (field == nullptr || field->type == FieldType::kGroup ||
+        (field->type == FieldType::kMessage && field->message == nullptr)) {
+      continue;
+    }
+
+    if (open_repeated != nullptr && open_repeated != field) {
+      close_repeated();
+    }
+
+    if (open_repeated == nullptr) {
+      if (field->repeated &&
+          std::find(closed_repeated.begin(),
+                    closed_repeated.end(),
+                    field->number) != closed_repeated.end()) {
+        return Status::DataLoss();  // Non-contiguous repeated field
+      }
+      if (!first_field) {
+        json_.Write(',');
+      }
+      first_field = false;
+      WriteKey(*field);
+    }
+
+    if (!field->repeated) {
+      PW_TRY(WriteValue(*field, decoder));
+      continue;
+    }
+
+    if (open_repeated == nullptr) {
+      open_repeated = field;
+      first_value = true;
+      json_.Write(field->message != nullptr && field->message->map_entry ? '{'
+                                                                         : '[');
+    }
+
+    if (IsScalar(field->type) &&
+        decoder.FieldWireType().value() == WireType::kDelimited) {
+      PW_TRY(WritePacked(*field, decoder, first_value));
+    } else {
+      if (!first_value) {
+        json_.Write(',');
+      }
+      if (field->message != nullptr && field->message->map_entry) {
+        StreamDecoder nested = decoder.GetNestedDecoder();
+        PW_TRY(WriteMapEntry(*field->message, nested));
+      } else {
+        PW_TRY(WriteValue(*field, decoder));
+      }
+    }
+    first_value = false;
+  }
+
+  if (!status.IsOutOfRange()) {
+    return Status::DataLoss();
+  }
+
+  if (open_repeated != nullptr) {
+    close_repeated();
+  }
+  json_.Write('}');
+  return json_.status();
+}
+
+Status MessageWriter::WriteValue(const Field& field, StreamDecoder& decoder) {
+  switch (field.type) {
+    case FieldType::kString:
+      return WriteString(decoder);
+    case FieldType::kBytes:
+      return WriteBytes(decoder);
+    case FieldType::kMessage: {
+      StreamDecoder nested = decoder.GetNestedDecoder();
+      return WriteMessage(*field.message, nested);
+    }
+    default:
+      break;
+  }
+
+  PW_TRY_ASSIGN(const uint64_t raw, ReadRawScalar(field.type, decoder));
+  return WriteScalar(field, raw);
+}
+
+Status MessageWriter::WriteScalar(const Field& field, uint64_t raw) {
+  switch (field.type) {
+    case FieldType::kDouble: {
+      double value;
+      std::memcpy(&value, &raw, sizeof(value));
+      json_.WriteFloat(value);
+      break;
+    }
+    case FieldType::kFloat: {
+      const uint32_t bits = static_cast<uint32_t>(raw);
+      float value;
+      std::memcpy(&value, &bits, sizeof(value));
+      json_.WriteFloat(value);
+      break;
+    }
+    // 64-bit integers are strings in JSON, since they may not fit in a double.
+    case FieldType::kInt64:
+    case FieldType::kSfixed64:
+      json_.Write('"');
+      json_.WriteInteger(static_cast<int64_t>(raw));
+      json_.Write('"');
+      break;
+    case FieldType::kSint64:
+      json_.Write('"');
+      json_.WriteInteger(varint::ZigZagDecode(raw));
+      json_.Write('"');
+      break;
+    case FieldType::kUint64:
+    case FieldType::kFixed64:
+      json_.Write('"');
+      json_.WriteInteger(raw);
+      json_.Write('"');
+      break;
+    case FieldType::kInt32:
+    case FieldType::kSfixed32:
+      json_.WriteInteger(static_cast<int32_t>(raw));
+      break;
+    case FieldType::kSint32:
+      json_.WriteInteger(
+          varint::ZigZagDecode(static_cast<uint32_t>(raw)));
+      break;
+    case FieldType::kUint32:
+    case FieldType::kFixed32:
+      json_.WriteInteger(static_cast<uint32_t>(raw));
+      break;
+    case FieldType::kBool:
+      json_.Write(raw != 0u ? "true" : "false");
+      break;
+    case FieldType::kEnum: {
+      const int32_t value = static_cast<int32_t>(raw);
+      if (field.enum_type != nullptr) {
+        if (auto name = field.enum_type->names.find(value);
+            name != field.enum_type->names.end()) {
+          json_.Write('"');
+          json_.Write(name->second);
+          json_.Write('"');
+          break;
+        }
+      }
+      json_.WriteInteger(value);
+      break;
+    }
+    default:
+      return Status::DataLoss();
+  }
+  return OkStatus();
+}
+
+void MessageWriter::WriteDefaultValue(const Field& field) {
+  switch (field.type) {
+    case FieldType::kString:
+    case FieldType::kBytes:
+      json_.Write("\"\"");
+      break;
+    case FieldType::kMessage:
+      json_.Write("{}");
+      break;
+    default:
+      WriteScalar(field, 0).IgnoreError();  // Always OK for scalar types
+      break;
+  }
+}
+
+Status MessageWriter::WriteString(StreamDecoder& decoder) {
+  StreamDecoder::BytesReader reader = decoder.GetBytesReader();
+  std::array<std::byte, 256> buffer;
+
+  json_.Write('"');
+  for (size_t remaining = reader.field_size(); remaining > 0u;) {
+    Result<ByteSpan> chunk = reader.Read(
+        std::span(buffer).first(std::min(remaining, buffer.size())));
+    if (!chunk.ok()) {
+      return Status::DataLoss();
+    }
+    json_.WriteEscaped(std::string_view(
+        reinterpret_cast<const char*>(chunk.value().data()),
+        chunk.value().size()));
+    remaining -= chunk.value().size();
+  }
+  json_.Write('"');
+  return OkStatus();
+}
+
+Status MessageWriter::WriteBytes(StreamDecoder& decoder) {
+  StreamDecoder::BytesReader reader = decoder.GetBytesReader();
+
+  // Bytes are encoded in chunks that are a multiple of 3 bytes, so that only
+  // the last chunk is padded.
+  std::array<std::byte, 192> buffer;
+  std::array<char, base64::EncodedSize(sizeof(buffer))> text;
+
+  json_.Write('"');
+  for (size_t remaining = reader.field_size(); remaining > 0u;) {
+    const size_t chunk_size = std::min(remaining, buffer.size());
+    size_t read = 0;
+    while (read < chunk_size) {
+      Result<ByteSpan> chunk =
+          reader.Read(std::span(buffer).subspan(read, chunk_size - read));
+      if (!chunk.ok()) {
+        return Status::DataLoss();
+      }
+      read += chunk.value().size();
+    }
+    base64::Encode(std::span(buffer).first(chunk_size), text.data());
+    json_.Write(std::string_view(text.data(), base64::EncodedSize(chunk_size)));
+    remaining -= chunk_size;
+  }
+  json_.Write('"');
+  return OkStatus();
+}
+
+Status MessageWriter::WritePacked(const Field& field,
+                                  StreamDecoder& decoder,
+                                  bool first) {
+  StreamDecoder::BytesReader reader = decoder.GetBytesReader();
+  const WireType wire_type = ScalarWireType(field.type);
+  const size_t fixed_size = wire_type == WireType::kFixed32 ? sizeof(uint32_t)
+                                                            : sizeof(uint64_t);
+
+  // Values are decoded from a buffer that is refilled as it is consumed. A
+  // value may straddle two reads, so unconsumed bytes are moved to the front.
+  std::array<std::byte, 256> buffer;
+  size_t buffered = 0;
+  size_t remaining = reader.field_size();
+
+  while (remaining > 0u || buffered > 0u) {
+    if (remaining > 0u) {
+      Result<ByteSpan> chunk = reader.Read(std::span(buffer).subspan(
+          buffered, std::min(remaining, buffer.size() - buffered)));
+      if (!chunk.ok()) {
+        return Status::DataLoss();
+      }
+      buffered += chunk.value().size();
+      remaining -= chunk.value().size();
+    }
+
+    size_t consumed = 0;
+    while (consumed < buffered) {
+      const ConstByteSpan data =
+          std::span(buffer).subspan(consumed, buffered - consumed);
+      uint64_t raw = 0;
+      size_t size = 0;
+
+      if (wire_type == WireType::kVarint) {
+        size = varint::Decode(data, &raw);
+      } else if (data.size() >= fixed_size) {
+        size = fixed_size;
+        raw = fixed_size == sizeof(uint32_t)
+                  ? bytes::ReadInOrder<uint32_t>(std::endian::little,
+                                                 data.data())
+                  : bytes::ReadInOrder<uint64_t>(std::endian::little,
+                                                 data.data());
+      }
+
+      if (size == 0u) {  // Incomplete value
+        if (remaining == 0u) {
+          return Status::DataLoss();
+        }
+        break;
+      }
+
+      if (!first) {
+        json_.Write(',');
+      }
+      first = false;
+      PW_TRY(WriteScalar(field, raw));
+      consumed += size;
+    }
+
+    std::memmove(buffer.data(), buffer.data() + consumed, buffered - consumed);
+    buffered -= consumed;
+  }
+  return OkStatus();
+}
+
+Status MessageWriter::WriteMapEntry(const DescriptorPool::Message& entry,
+                                    StreamDecoder& decoder) {
+  const Field* key = entry.FindField(kMapKeyField);
+  const Field* value = entry.FindField(kMapValueField);
+  if (key == nullptr || value == nullptr) {
+    return Status::DataLoss();
+  }
+
+  auto write_key = [&](StreamDecoder* key_decoder) -> Status {
+    if (key->type == FieldType::kString) {
+      if (key_decoder == nullptr) {
+        json_.Write("\"\"");
+        return OkStatus();
+      }
+      return WriteString(*key_decoder);
+    }
+
+    // Map keys are always strings in JSON.
+    json_.Write('"');
+    if (key_decoder == nullptr) {
+      json_.Write(key->type == FieldType::kBool ? "false" : "0");
+    } else {
+      PW_TRY_ASSIGN(const uint64_t raw,
+                    ReadRawScalar(key->type, *key_decoder));
+      // WriteScalar quotes 64-bit integers, so write their digits directly.
+      switch (key->type) {
+        case FieldType::kInt64:
+        case FieldType::kSfixed64:
+          json_.WriteInteger(static_cast<int64_t>(raw));
+          break;
+        case FieldType::kSint64:
+          json_.WriteInteger(varint::ZigZagDecode(raw));
+          break;
+        case FieldType::kUint64:
+        case FieldType::kFixed64:
+          json_.WriteInteger(raw);
+          break;
+        default:
+          PW_TRY(WriteScalar(*key, raw));
+          break;
+      }
+    }
+    json_.Write('"');
+    return OkStatus();
+  };
+
+  bool key_written = false;
+  bool value_written = false;
+
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    const uint32_t number = decoder.FieldNumber().value();
+    if (number == kMapKeyField && !key_written) {
+      PW_TRY(write_key(&decoder));
+      key_written = true;
+    } else if (number == kMapValueField && !value_written) {
+      if (!key_written) {
+        PW_TRY(write_key(nullptr));
+        key_written = true;
+      }
+      json_.Write(':');
+      if (value->type == FieldType::kMessage && value->message == nullptr) {
+        json_.Write("{}");
+      } else {
+        PW_TRY(WriteValue(*value, decoder));
+      }
+      value_written = true;
+    }
+  }
+
+  if (!status.IsOutOfRange()) {
+    return Status::DataLoss();
+  }
+
+  if (!key_written) {
+    PW_TRY(write_key(nullptr));
+  }
+  if (!value_written) {
+    json_.Write(':');
+    WriteDefaultValue(*value);
+  }
+  return OkStatus();
+}
+
+}  // namespace
+
+const DescriptorPool::Field* DescriptorPool::Message::FindField(
+    uint32_t number) const {
+  auto field = std::lower_bound(
+      fields.begin(), fields.end(), number, [](const Field& f, uint32_t n) {
+        return f.number < n;
+      });
+  return field != fields.end() && field->number == number ? &*field : nullptr;
+}
+
+Status DescriptorPool::Load(ConstByteSpan file_descriptor_set) {
+  PW_TRY(ForEachField(file_descriptor_set, [this](Decoder& decoder) {
+    if (decoder.FieldNumber() != descriptor::kFileDescriptorSetFile) {
+      return OkStatus();
+    }
+    ConstByteSpan file;
+    PW_TRY(decoder.ReadBytes(&file));
+    return LoadFile(file);
+  }));
+
+  Link();
+  return OkStatus();
+}
+
+const DescriptorPool::Message* DescriptorPool::FindMessage(
+    std::string_view name) const {
+  auto message = messages_.find(std::string(name));
+  return message != messages_.end() ? &message->second : nullptr;
+}
+
+const DescriptorPool::Enum* DescriptorPool::FindEnum(
+    std::string_view name) const {
+  auto enum_type = enums_.find(std::string(name));
+  return enum_type != enums_.end() ? &enum_type->second : nullptr;
+}
+
+Status DescriptorPool::LoadFile(ConstByteSpan file) {
+  std::string package;
+  std::vector<ConstByteSpan> messages;
+  std::vector<ConstByteSpan> enums;
+
+  PW_TRY(ForEachField(file, [&](Decoder& decoder) -> Status {
+    ConstByteSpan data;
+    switch (decoder.FieldNumber()) {
+      case descriptor::kFilePackage: {
+        std::string_view name;
+        PW_TRY(decoder.ReadString(&name));
+        package = name;
+        break;
+      }
+      case descriptor::kFileMessageType:
+        PW_TRY(decoder.ReadBytes(&data));
+        messages.push_back(data);
+        break;
+      case descriptor::kFileEnumType:
+        PW_TRY(decoder.ReadBytes(&data));
+        enums.push_back(data);
+        break;
+    }
+    return OkStatus();
+  }));
+
+  for (ConstByteSpan message : messages) {
+    PW_TRY(LoadMessage(message, package));
+  }
+  for (ConstByteSpan enum_type : enums) {
+    PW_TRY(LoadEnum(enum_type, package));
+  }
+  return OkStatus();
+}
+
+Status DescriptorPool::LoadMessage(ConstByteSpan descriptor,
+                                   const std::string& scope) {
+  std::string_view name;
+  Message message = {};
+  std::vector<ConstByteSpan> nested_messages;
+  std::vector<ConstByteSpan> nested_enums;
+
+  PW_TRY(ForEachField(descriptor, [&](Decoder& decoder) -> Status {
+    ConstByteSpan data;
+    switch (decoder.FieldNumber()) {
+      case descriptor::kMessageName:
+        PW_TRY(decoder.ReadString(&name));
+        break;
+      case descriptor::kMessageField:
+        PW_TRY(decoder.ReadBytes(&data));
+        PW_TRY(LoadField(data, message.fields.emplace_back()));
+        break;
+      case descriptor::kMessageNestedType:
+        PW_TRY(decoder.ReadBytes(&data));
+        nested_messages.push_back(data);
+        break;
+      case descriptor::kMessageEnumType:
+        PW_TRY(decoder.ReadBytes(&data));
+        nested_enums.push_back(data);
+        break;
+      case descriptor::kMessageOptions:
+        PW_TRY(decoder.ReadBytes(&data));
+        return ForEachField(data, [&](Decoder& options) -> Status {
+          if (options.FieldNumber() == descriptor::kMessageOptionsMapEntry) {
+            return options.ReadBool(&message.map_entry);
+          }
+          return OkStatus();
+        });
+    }
+    return OkStatus();
+  }));
+
+  std::sort(message.fields.begin(),
+            message.fields.end(),
+            [](const Field& lhs, const Field& rhs) {
+              return lhs.number < rhs.number;
+            });
+
+  const std::string full_name = Qualify(scope, name);
+  for (ConstByteSpan nested : nested_messages) {
+    PW_TRY(LoadMessage(nested, full_name));
+  }
+  for (ConstByteSpan nested : nested_enums) {
+    PW_TRY(LoadEnum(nested, full_name));
+  }
+
+  // If a type is loaded more than once, such as from a file included by
+  // several descriptor sets, the first definition is kept.
+  messages_.emplace(full_name, std::move(message));
+  return OkStatus();
+}
+
+Status DescriptorPool::LoadField(ConstByteSpan descriptor, Field& field) {
+  field.number = 0;
+  field.type = FieldType::kInt32;
+  field.repeated = false;
+  field.message = nullptr;
+  field.enum_type = nullptr;
+
+  PW_TRY(ForEachField(descriptor, [&](Decoder& decoder) -> Status {
+    std::string_view text;
+    uint32_t value;
+    switch (decoder.FieldNumber()) {
+      case descriptor::kFieldName:
+        PW_TRY(decoder.ReadString(&text));
+        field.name = text;
+        break;
+      case descriptor::kFieldNumber:
+        PW_TRY(decoder.ReadUint32(&field.number));
+        break;
+      case descriptor::kFieldLabel:
+        PW_TRY(decoder.ReadUint32(&value));
+        field.repeated = value == descriptor::kFieldLabelRepeated;
+        break;
+      case descriptor::kFieldType:
+        PW_TRY(decoder.ReadUint32(&value));
+        if (value < static_cast<uint32_t>(FieldType::kDouble) ||
+            value > static_cast<uint32_t>(FieldType::kSint64)) {
+          return Status::DataLoss();
+        }
+        field.type = static_cast<FieldType>(value);
+        break;
+      case descriptor::kFieldTypeName:
+        PW_TRY(decoder.ReadString(&text));
+        // protoc writes fully qualified names with a leading '.'.
+        if (!text.empty() && text.front() == '.') {
+          text.remove_prefix(1);
+        }
+        field.type_name = text;
+        break;
+      case descriptor::kFieldJsonName:
+        PW_TRY(decoder.ReadString(&text));
+        field.json_name = text;
+        break;
+    }
+    return OkStatus();
+  }));
+
+  if (field.json_name.empty()) {
+    field.json_name = ToJsonName(field.name);
+  }
+  return OkStatus();
+}
+
+Status DescriptorPool::LoadEnum(ConstByteSpan descriptor,
+                                const std::string& scope) {
+  std::string_view name;
+  Enum enum_type;
+
+  PW_TRY(ForEachField(descriptor, [&](Decoder& decoder) -> Status {
+    if (decoder.FieldNumber() == descriptor::kEnumName) {
+      return decoder.ReadString(&name);
+    }
+    if (decoder.FieldNumber() != descriptor::kEnumValue) {
+      return OkStatus();
+    }
+
+    ConstByteSpan value;
+    PW_TRY(decoder.ReadBytes(&value));
+
+    std::string_view value_name;
+    int32_t number = 0;
+    PW_TRY(ForEachField(value, [&](Decoder& value_decoder) -> Status {
+      switch (value_decoder.FieldNumber()) {
+        case descriptor::kEnumValueName:
+          return value_decoder.ReadString(&value_name);
+        case descriptor::kEnumValueNumber:
+          return value_decoder.ReadInt32(&number);
+      }
+      return OkStatus();
+    }));
+    enum_type.names.emplace(number, value_name);
+    return OkStatus();
+  }));
+
+  enums_.emplace(Qualify(scope, name), std::move(enum_type));
+  return OkStatus();
+}
+
+void DescriptorPool::Link() {
+  for (auto& [name, message] : messages_) {
+    for (Field& field : message.fields) {
+      if (field.type == FieldType::kMessage) {
+        field.message = FindMessage(field.type_name);
+      } else if (field.type == FieldType::kEnum) {
+        field.enum_type = FindEnum(field.type_name);
+      }
+    }
+  }
+}
+
+Status JsonTranscoder::Transcode(std::string_view type,
+                                 stream::SeekableReader& input,
+                                 stream::Writer& output) const {
+  const DescriptorPool::Message* message = pool_.FindMessage(type);
+  if (message == nullptr) {
+    return Status::NotFound();
+  }
+  return Transcode(*message, input, output);
+}
+
+Status JsonTranscoder::Transcode(const DescriptorPool::Message& type,
+                                 stream::SeekableReader& input,
+                                 stream::Writer& output) const {
+  JsonWriter json(output);
+  StreamDecoder decoder(input);
+
+  const Status status =
+      MessageWriter(json, options_).WriteMessage(type, decoder);
+  const Status write_status = json.Flush();
+  return status.ok() ? write_status : status;
+}
+
+}  // namespace pw::protobuf
@@ -0,0 +1,298 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_protobuf/json_transcoder.h"
+
+#include <array>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::protobuf {
+namespace {
+
+using FieldType = DescriptorPool::FieldType;
+
+// Writes a FieldDescriptorProto to a DescriptorProto.
+void AddField(StreamEncoder& message,
+              std::string_view name,
+              uint32_t number,
+              FieldType type,
+              bool repeated = false,
+              std::string_view type_name = "") {
+  StreamEncoder field = message.GetNestedEncoder(2);
+  field.WriteString(1, name).IgnoreError();
+  field.WriteUint32(3, number).IgnoreError();
+  field.WriteUint32(4, repeated ? 3 : 1).IgnoreError();
+  field.WriteUint32(5, static_cast<uint32_t>(type)).IgnoreError();
+  if (!type_name.empty()) {
+    field.WriteString(6, type_name).IgnoreError();
+  }
+}
+
+// Builds a FileDescriptorSet equivalent to:
+//
+//   package pw.test;
+//
+//   enum Level {
+//     LEVEL_UNKNOWN = 0;
+//     LEVEL_INFO = 1;
+//   }
+//
+//   message Entry {
+//     string message = 1;
+//     int64 timestamp_ms = 2;
+//     Level level = 3;
+//     bytes data = 4;
+//     repeated uint32 values = 5;
+//     repeated Entry children = 6;
+//     map<string, int32> counts = 7;
+//     double ratio = 8;
+//     sint32 delta = 9;
+//   }
+//
+class JsonTranscoderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    MemoryEncoder set(descriptor_buffer_);
+    {
+      StreamEncoder file = set.GetNestedEncoder(1);
+      file.WriteString(1, "pw_test/entry.proto").IgnoreError();
+      file.WriteString(2, "pw.test").IgnoreError();
+      {
+        StreamEncoder message = file.GetNestedEncoder(4);
+        message.WriteString(1, "Entry").IgnoreError();
+        AddField(message, "message", 1, FieldType::kString);
+        AddField(message, "timestamp_ms", 2, FieldType::kInt64);
+        AddField(message,
+                 "level",
+                 3,
+                 FieldType::kEnum,
+                 false,
+                 ".pw.test.Level");
+        AddField(message, "data", 4, FieldType::kBytes);
+        AddField(message, "values", 5, FieldType::kUint32, true);
+        AddField(message,
+                 "children",
+                 6,
+                 FieldType::kMessage,
+                 true,
+                 ".pw.test.Entry");
+        AddField(message,
+                 "counts",
+                 7,
+                 FieldType::kMessage,
+                 true,
+                 ".pw.test.Entry.CountsEntry");
+        AddField(message, "ratio", 8, FieldType::kDouble);
+        AddField(message, "delta", 9, FieldType::kSint32);
+        {
+          StreamEncoder entry = message.GetNestedEncoder(3);
+          entry.WriteString(1, "CountsEntry").IgnoreError();
+          AddField(entry, "key", 1, FieldType::kString);
+          AddField(entry, "value", 2, FieldType::kInt32);
+          StreamEncoder options = entry.GetNestedEncoder(7);
+          options.WriteBool(7, true).IgnoreError();
+        }
+      }
+      {
+        StreamEncoder level = file.GetNestedEncoder(5);
+        level.WriteString(1, "Level").IgnoreError();
+        {
+          StreamEncoder value = level.GetNestedEncoder(2);
+          value.WriteString(1, "LEVEL_UNKNOWN").IgnoreError();
+          value.WriteInt32(2, 0).IgnoreError();
+        }
+        {
+          StreamEncoder value = level.GetNestedEncoder(2);
+          value.WriteString(1, "LEVEL_INFO").IgnoreError();
+          value.WriteInt32(2, 1).IgnoreError();
+        }
+      }
+    }
+    ASSERT_EQ(OkStatus(), set.status());
+    ASSERT_EQ(OkStatus(), pool_.Load(set));
+  }
+
+  // Transcodes the message and returns the JSON, or "" if it failed.
+  std::string_view Transcode(ConstByteSpan message, JsonOptions options = {}) {
+    stream::MemoryReader reader(message);
+    stream::MemoryWriter writer(json_buffer_);
+    last_status_ = JsonTranscoder(pool_, options)
+                       .Transcode("pw.test.Entry", reader, writer);
+    if (!last_status_.ok()) {
+      return "";
+    }
+    return std::string_view(
+        reinterpret_cast<const char*>(writer.WrittenData().data()),
+        writer.WrittenData().size());
+  }
+
+  std::array<std::byte, 1024> descriptor_buffer_;
+  std::array<std::byte, 256> message_buffer_;
+  std::array<std::byte, 512> json_buffer_;
+  DescriptorPool pool_;
+  Status last_status_;
+};
+
+TEST_F(JsonTranscoderTest, Load_FindsTypes) {
+  const DescriptorPool::Message* entry = pool_.FindMessage("pw.test.Entry");
+  ASSERT_NE(nullptr, entry);
+  EXPECT_FALSE(entry->map_entry);
+
+  const DescriptorPool::Field* field = entry->FindField(2);
+  ASSERT_NE(nullptr, field);
+  EXPECT_EQ("timestamp_ms", field->name);
+  EXPECT_EQ("timestampMs", field->json_name);
+
+  EXPECT_EQ(entry, entry->FindField(6)->message);
+  EXPECT_EQ(pool_.FindEnum("pw.test.Level"), entry->FindField(3)->enum_type);
+
+  const DescriptorPool::Message* counts =
+      pool_.FindMessage("pw.test.Entry.CountsEntry");
+  ASSERT_NE(nullptr, counts);
+  EXPECT_TRUE(counts->map_entry);
+  EXPECT_EQ(nullptr, pool_.FindMessage("pw.test.Missing"));
+}
+
+TEST_F(JsonTranscoderTest, Scalars) {
+  MemoryEncoder message(message_buffer_);
+  message.WriteString(1, "hi \"there\"\n").IgnoreError();
+  message.WriteInt64(2, -1234567890123).IgnoreError();
+  message.WriteUint32(3, 1).IgnoreError();
+  message.WriteBytes(4, bytes::String("\x01\x02\x03\x04")).IgnoreError();
+  message.WriteDouble(8, 0.25).IgnoreError();
+  message.WriteSint32(9, -5).IgnoreError();
+  ASSERT_EQ(OkStatus(), message.status());
+
+  EXPECT_EQ(
+      R"({"message":"hi \"there\"\n","timestampMs":"-1234567890123",)"
+      R"("level":"LEVEL_INFO","data":"AQIDBA==","ratio":0.25,"delta":-5})",
+      Transcode(message));
+}
+
+TEST_F(JsonTranscoderTest, PreserveFieldNames) {
+  MemoryEncoder message(message_buffer_);
+  message.WriteInt64(2, 7).IgnoreError();
+
+  EXPECT_EQ(R"({"timestamp_ms":"7"})",
+            Transcode(message, {.preserve_field_names = true}));
+}
+
+TEST_F(JsonTranscoderTest, UnknownEnumValue_WrittenAsNumber) {
+  MemoryEncoder message(message_buffer_);
+  message.WriteUint32(3, 99).IgnoreError();
+
+  EXPECT_EQ(R"({"level":99})", Transcode(message));
+}
+
+TEST_F(JsonTranscoderTest, RepeatedFields_PackedAndUnpacked) {
+  constexpr uint32_t kValues[] = {1, 300, 70000};
+
+  MemoryEncoder packed(message_buffer_);
+  packed.WritePackedUint32(5, kValues).IgnoreError();
+  EXPECT_EQ(R"({"values":[1,300,70000]})", Transcode(packed));
+
+  MemoryEncoder unpacked(message_buffer_);
+  for (uint32_t value : kValues) {
+    unpacked.WriteUint32(5, value).IgnoreError();
+  }
+  EXPECT_EQ(R"({"values":[1,300,70000]})", Transcode(unpacked));
+}
+
+TEST_F(JsonTranscoderTest, NestedMessages) {
+  MemoryEncoder message(message_buffer_);
+  {
+    StreamEncoder child = message.GetNestedEncoder(6);
+    child.WriteString(1, "a").IgnoreError();
+  }
+  {
+    StreamEncoder child = message.GetNestedEncoder(6);
+    StreamEncoder grandchild = child.GetNestedEncoder(6);
+    grandchild.WriteString(1, "b").IgnoreError();
+  }
+  message.WriteSint32(9, 1).IgnoreError();
+  ASSERT_EQ(OkStatus(), message.status());
+
+  EXPECT_EQ(
+      R"({"children":[{"message":"a"},{"children":[{"message":"b"}]}],)"
+      R"("delta":1})",
+      Transcode(message));
+}
+
+TEST_F(JsonTranscoderTest, Map_WrittenAsObject) {
+  MemoryEncoder message(message_buffer_);
+  {
+    StreamEncoder entry = message.GetNestedEncoder(7);
+    entry.WriteString(1, "errors").IgnoreError();
+    entry.WriteInt32(2, 3).IgnoreError();
+  }
+  {
+    StreamEncoder entry = message.GetNestedEncoder(7);
+    entry.WriteString(1, "empty").IgnoreError();
+  }
+  ASSERT_EQ(OkStatus(), message.status());
+
+  EXPECT_EQ(R"({"counts":{"errors":3,"empty":0}})", Transcode(message));
+}
+
+TEST_F(JsonTranscoderTest, UnknownFields_Skipped) {
+  MemoryEncoder message(message_buffer_);
+  message.WriteUint32(100, 1).IgnoreError();
+  message.WriteString(1, "known").IgnoreError();
+  message.WriteString(101, "unknown").IgnoreError();
+
+  EXPECT_EQ(R"({"message":"known"})", Transcode(message));
+}
+
+TEST_F(JsonTranscoderTest, NonContiguousRepeatedField_DataLoss) {
+  MemoryEncoder message(message_buffer_);
+  message.WriteUint32(5, 1).IgnoreError();
+  message.WriteString(1, "between").IgnoreError();
+  message.WriteUint32(5, 2).IgnoreError();
+
+  Transcode(message);
+  EXPECT_EQ(Status::DataLoss(), last_status_);
+}
+
+TEST_F(JsonTranscoderTest, Malformed_DataLoss) {
+  constexpr auto kTruncated = bytes::Array<0x0a, 0x05, 'a', 'b'>();
+
+  Transcode(kTruncated);
+  EXPECT_EQ(Status::DataLoss(), last_status_);
+}
+
+TEST_F(JsonTranscoderTest, UnknownType_NotFound) {
+  stream::MemoryReader reader(ConstByteSpan{});
+  stream::MemoryWriter writer(json_buffer_);
+  EXPECT_EQ(Status::NotFound(),
+            JsonTranscoder(pool_).Transcode("pw.test.Missing", reader, writer));
+}
+
+TEST_F(JsonTranscoderTest, OutputFull_ReturnsWriteError) {
+  MemoryEncoder message(message_buffer_);
+  message.WriteString(1, "this message does not fit").IgnoreError();
+
+  stream::MemoryReader reader(message);
+  std::array<std::byte, 8> small_buffer;
+  stream::MemoryWriter writer(small_buffer);
+  EXPECT_EQ(Status::ResourceExhausted(),
+            JsonTranscoder(pool_).Transcode("pw.test.Entry", reader, writer));
+}
+
+}  // namespace
+}  // namespace pw::protobuf
@@ -14,6 +14,7 @@
 
 #include "pw_protobuf/message.h"
 
+#include <array>
 #include <cstddef>
 
 #include "pw_protobuf/serialized_size.h"
@@ -118,6 +119,44 @@ Result<bool> String::Equal(std::string_view str) {
   return Bytes::Equal(std::as_bytes(std::span{str}));
 }
 
+namespace internal {
+namespace {
+
+// 32-bit FNV-1a.
+constexpr uint32_t kFnvOffsetBasis = 2166136261u;
+constexpr uint32_t kFnvPrime = 16777619u;
+
+constexpr uint32_t HashMapKeyByte(uint32_t hash, std::byte byte) {
+  return (hash ^ static_cast<uint8_t>(byte)) * kFnvPrime;
+}
+
+}  // namespace
+
+uint32_t HashMapKey(std::string_view key) {
+  uint32_t hash = kFnvOffsetBasis;
+  for (char ch : key) {
+    hash = HashMapKeyByte(hash, static_cast<std::byte>(ch));
+  }
+  return hash;
+}
+
+Result<uint32_t> HashMapKey(stream::IntervalReader key) {
+  uint32_t hash = kFnvOffsetBasis;
+  std::array<std::byte, 16> buffer;
+  while (true) {
+    Result<ByteSpan> result = key.Read(buffer);
+    if (result.status().IsOutOfRange()) {
+      return hash;
+    }
+    PW_TRY(result.status());
+    for (std::byte byte : result.value()) {
+      hash = HashMapKeyByte(hash, byte);
+    }
+  }
+}
+
+}  // namespace internal
+
 Message::iterator& Message::iterator::operator++() {
   // Store the starting offset of the field.
   size_t field_start = reader_.current();
@@ -156,6 +195,65 @@ Message::iterator Message::end() {
   return iterator(reader_end);
 }
 
+Status Message::BuildIndex(std::span<IndexEntry> index) {
+  PW_TRY(status());
+  index_ = index;
+  index_size_ = 0;
+  index_end_ = reader_.start();
+
+  for (Field field : *this) {
+    bool indexed = false;
+    for (size_t i = 0; i < index_size_; ++i) {
+      if (index_[i].field_number == field.field_number()) {
+        indexed = true;
+        break;
+      }
+    }
+    if (indexed) {
+      continue;
+    }
+
+    if (index_size_ == index_.size()) {
+      index_end_ = field.field_reader().start();
+      return Status::ResourceExhausted();
+    }
+    index_[index_size_++] = {
+        field.field_number(),
+        field.field_reader().start(),
+        field.field_reader().end(),
+    };
+  }
+
+  index_end_ = reader_.end();
+  return OkStatus();
+}
+
+Status Message::FindField(uint32_t field_number, Field& field) {
+  PW_CHECK(ok());
+
+  for (size_t i = 0; i < index_size_; ++i) {
+    if (index_[i].field_number == field_number) {
+      field = Field(stream::IntervalReader(reader_.source_reader(),
+                                           index_[i].start,
+                                           index_[i].end),
+                    field_number);
+      return OkStatus();
+    }
+  }
+
+  // Fields before index_end_ are all in the index, so only search after it.
+  const size_t search_start = index_.empty() ? reader_.start() : index_end_;
+  iterator it(stream::IntervalReader(
+      reader_.source_reader(), search_start, reader_.end()));
+  for (; !it.eof_; ++it) {
+    if (it->field_number() == field_number) {
+      field = *it;
+      return OkStatus();
+    }
+  }
+  return Status::NotFound();
+}
+
 RepeatedBytes Message::AsRepeatedBytes(uint32_t field_number) {
   return AsRepeated<Bytes>(field_number);
 }
@@ -14,12 +14,41 @@
 
 #include "pw_protobuf/message.h"
 
+#include <array>
+
 #include "gtest/gtest.h"
 #include "pw_stream/memory_stream.h"
 
 #define ASSERT_OK(status) ASSERT_EQ(OkStatus(), status)
 
 namespace pw::protobuf {
+namespace {
+
+// Counts the reads of the wrapped MemoryReader.
+class CountingReader : public stream::SeekableReader {
+ public:
+  CountingReader(ConstByteSpan data) : reader_(data) {}
+
+  size_t reads() const { return reads_; }
+  void ResetReads() { reads_ = 0; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    ++reads_;
+    const Result<ByteSpan> result = reader_.Read(destination);
+    return StatusWithSize(result.status(),
+                          result.ok() ? result.value().size() : 0);
+  }
+
+  Status DoSeek(ssize_t offset, Whence origin) override {
+    return reader_.Seek(offset, origin);
+  }
+
+  stream::MemoryReader reader_;
+  size_t reads_ = 0;
+};
+
+}  // namespace
 
 TEST(ProtoHelper, IterateMessage) {
   // clang-format off
@@ -570,4 +599,225 @@ TEST(ProtoHelper, AsStringToMessageMap) {
   ASSERT_TRUE(bar_email_cmp.value());
 }
 
+// clang-format off
+constexpr uint8_t kIndexedProto[] = {
+  // type=uint32, k=1, v=1
+  0x08, 0x01,
+  // key = 2, str = "two"
+  0x12, 0x03, 't', 'w', 'o',
+  // type=uint32, k=1, v=5 (repeated field number)
+  0x08, 0x05,
+  // key = 4, nested message { type=uint32, k=1, v=4 }
+  0x22, 0x02, 0x08, 0x04,
+  // type=uint32, k=3, v=3
+  0x18, 0x03,
+};
+// clang-format on
+
+TEST(ProtoHelper, BuildIndex_FieldsFoundWithoutReading) {
+  CountingReader reader(std::as_bytes(std::span(kIndexedProto)));
+  Message message(reader, sizeof(kIndexedProto));
+
+  std::array<Message::IndexEntry, 4> index;
+  ASSERT_OK(message.BuildIndex(index));
+
+  reader.ResetReads();
+  EXPECT_EQ(Status::NotFound(), message.AsUint32(5).status());
+  EXPECT_EQ(0u, reader.reads());
+
+  Uint32 first = message.AsUint32(1);
+  ASSERT_OK(first.status());
+  EXPECT_EQ(1u, first.value());  // The first occurrence is returned.
+
+  Uint32 third = message.AsUint32(3);
+  ASSERT_OK(third.status());
+  EXPECT_EQ(3u, third.value());
+
+  String str = message.AsString(2);
+  ASSERT_OK(str.status());
+  Result<bool> cmp = str.Equal("two");
+  ASSERT_OK(cmp.status());
+  EXPECT_TRUE(cmp.value());
+
+  Message nested = message.AsMessage(4);
+  ASSERT_OK(nested.status());
+  Uint32 nested_value = nested.AsUint32(1);
+  ASSERT_OK(nested_value.status());
+  EXPECT_EQ(4u, nested_value.value());
+
+  // An indexed lookup reads only the field, while an unindexed lookup reads
+  // each field before it.
+  reader.ResetReads();
+  ASSERT_OK(message.AsUint32(3).status());
+  const size_t indexed_reads = reader.reads();
+
+  Message unindexed(reader, sizeof(kIndexedProto));
+  reader.ResetReads();
+  ASSERT_OK(unindexed.AsUint32(3).status());
+  EXPECT_LT(indexed_reads, reader.reads());
+}
+
+TEST(ProtoHelper, BuildIndex_CopiesShareIndex) {
+  CountingReader reader(std::as_bytes(std::span(kIndexedProto)));
+  Message message(reader, sizeof(kIndexedProto));
+
+  std::array<Message::IndexEntry, 4> index;
+  ASSERT_OK(message.BuildIndex(index));
+
+  Message copy = message;
+  reader.ResetReads();
+  EXPECT_EQ(Status::NotFound(), copy.AsUint32(7).status());
+  EXPECT_EQ(0u, reader.reads());
+}
+
+TEST(ProtoHelper, BuildIndex_TooSmall_LookupsStillCorrect) {
+  CountingReader reader(std::as_bytes(std::span(kIndexedProto)));
+  Message message(reader, sizeof(kIndexedProto));
+
+  std::array<Message::IndexEntry, 2> index;
+  EXPECT_EQ(Status::ResourceExhausted(), message.BuildIndex(index));
+
+  // Fields 1 and 2 are indexed; 4 and 3 are found by searching after them.
+  Uint32 first = message.AsUint32(1);
+  ASSERT_OK(first.status());
+  EXPECT_EQ(1u, first.value());
+
+  Uint32 third = message.AsUint32(3);
+  ASSERT_OK(third.status());
+  EXPECT_EQ(3u, third.value());
+
+  Message nested = message.AsMessage(4);
+  ASSERT_OK(nested.status());
+  EXPECT_EQ(4u, nested.AsUint32(1).value());
+
+  EXPECT_EQ(Status::NotFound(), message.AsUint32(5).status());
+}
+
+TEST(ProtoHelper, BuildIndex_RepeatedFieldsStillIterated) {
+  stream::MemoryReader reader(std::as_bytes(std::span(kIndexedProto)));
+  Message message(reader, sizeof(kIndexedProto));
+
+  std::array<Message::IndexEntry, 4> index;
+  ASSERT_OK(message.BuildIndex(index));
+
+  std::array<uint32_t, 2> values = {};
+  size_t count = 0;
+  for (Message::Field field : message) {
+    if (field.field_number() == 1) {
+      ASSERT_LT(count, values.size());
+      values[count++] = field.As<Uint32>().value();
+    }
+  }
+  EXPECT_EQ(2u, count);
+  EXPECT_EQ(1u, values[0]);
+  EXPECT_EQ(5u, values[1]);
+}
+
+// Encodes map<string, string> entries "keyNN" -> "valNN" for NN in
+// [0, kMapEntries), with field number 1, followed by a duplicate of "key00".
+constexpr size_t kMapEntries = 16;
+constexpr size_t kMapEntrySize = 16;
+
+constexpr std::array<uint8_t, (kMapEntries + 1) * kMapEntrySize>
+EncodeStringMap() {
+  std::array<uint8_t, (kMapEntries + 1) * kMapEntrySize> data = {};
+  for (size_t i = 0; i <= kMapEntries; ++i) {
+    const size_t n = i == kMapEntries ? 0 : i;
+    const char tens = static_cast<char>('0' + n / 10);
+    const char ones = static_cast<char>('0' + n % 10);
+    const char value_last = i == kMapEntries ? 'x' : ones;
+    const uint8_t entry[kMapEntrySize] = {
+        0x0a, 14,
+        0x0a, 5, 'k', 'e', 'y', uint8_t(tens), uint8_t(ones),
+        0x12, 5, 'v', 'a', 'l', uint8_t(tens), uint8_t(value_last),
+    };
+    for (size_t j = 0; j < kMapEntrySize; ++j) {
+      data[i * kMapEntrySize + j] = entry[j];
+    }
+  }
+  return data;
+}
+
+constexpr auto kStringMap = EncodeStringMap();
+
+void ExpectAllKeysFound(StringToStringMap& map) {
+  for (size_t i = 0; i < kMapEntries; ++i) {
+    const char key[] = {'k', 'e', 'y', char('0' + i / 10), char('0' + i % 10)};
+    const char expected[] = {
+        'v', 'a', 'l', char('0' + i / 10), char('0' + i % 10)};
+    String value = map[std::string_view(key, sizeof(key))];
+    ASSERT_OK(value.status());
+    Result<bool> cmp =
+        value.Equal(std::string_view(expected, sizeof(expected)));
+    ASSERT_OK(cmp.status());
+    EXPECT_TRUE(cmp.value());
+  }
+  EXPECT_EQ(Status::NotFound(), map["key99"].status());
+  EXPECT_EQ(Status::NotFound(), map[""].status());
+}
+
+TEST(ProtoHelper, StringMap_BuildIndex_LookupsReadOnlyMatchingEntries) {
+  CountingReader reader(std::as_bytes(std::span(kStringMap)));
+  Message message(reader, kStringMap.size());
+
+  StringToStringMap map = message.AsStringToStringMap(1);
+  std::array<StringMapIndexSlot, 2 * (kMapEntries + 1)> index;
+  ASSERT_OK(map.BuildIndex(index));
+  ExpectAllKeysFound(map);
+
+  reader.ResetReads();
+  ASSERT_OK(map["key15"].status());
+  const size_t indexed_reads = reader.reads();
+
+  StringToStringMap unindexed = message.AsStringToStringMap(1);
+  reader.ResetReads();
+  ASSERT_OK(unindexed["key15"].status());
+  EXPECT_LT(4 * indexed_reads, reader.reads());
+}
+
+TEST(ProtoHelper, StringMap_BuildIndex_DuplicateKeyReturnsFirstEntry) {
+  stream::MemoryReader reader(std::as_bytes(std::span(kStringMap)));
+  Message message(reader, kStringMap.size());
+
+  // With a slot per entry, every slot is used and most entries collide.
+  StringToStringMap map = message.AsStringToStringMap(1);
+  std::array<StringMapIndexSlot, kMapEntries + 1> index;
+  ASSERT_OK(map.BuildIndex(index));
+  ExpectAllKeysFound(map);
+
+  Result<bool> cmp = map["key00"].Equal("val00");
+  ASSERT_OK(cmp.status());
+  EXPECT_TRUE(cmp.value());
+}
+
+TEST(ProtoHelper, StringMap_BuildIndex_TooSmall_ScansMap) {
+  stream::MemoryReader reader(std::as_bytes(std::span(kStringMap)));
+  Message message(reader, kStringMap.size());
+
+  StringToStringMap map = message.AsStringToStringMap(1);
+  std::array<StringMapIndexSlot, kMapEntries> index;
+  EXPECT_EQ(Status::ResourceExhausted(), map.BuildIndex(index));
+  ExpectAllKeysFound(map);
+}
+
+TEST(ProtoHelper, StringMap_BuildIndex_EmptyMap) {
+  stream::MemoryReader reader(std::as_bytes(std::span(kStringMap)));
+  Message message(reader, kStringMap.size());
+
+  StringToStringMap map = message.AsStringToStringMap(2);
+  std::array<StringMapIndexSlot, 4> index;
+  ASSERT_OK(map.BuildIndex(index));
+  EXPECT_EQ(Status::NotFound(), map["key00"].status());
+}
+
+TEST(ProtoHelper, HashMapKey_StreamMatchesString) {
+  constexpr std::string_view kKey = "a key longer than the hash's read buffer";
+  stream::MemoryReader reader(std::as_bytes(std::span(kKey)));
+  Result<uint32_t> hash =
+      internal::HashMapKey(stream::IntervalReader(reader, 0, kKey.size()));
+  ASSERT_OK(hash.status());
+  EXPECT_EQ(internal::HashMapKey(kKey), hash.value());
+  EXPECT_NE(internal::HashMapKey("a"), internal::HashMapKey("b"));
+}
+
 }  // namespace pw::protobuf
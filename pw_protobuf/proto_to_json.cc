@@ -0,0 +1,173 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Converts files of encoded protobuf messages to JSON on a pool of threads.
+// This tool should only be built for the host.
+//
+//   proto_to_json --descriptor-set logs.desc --type pw.log.LogEntries
+//       [--jobs N] [--delimited] [--preserve-field-names] FILE...
+//
+// Each FILE is written to FILE.json. With --delimited, a file holds a sequence
+// of varint length-prefixed messages, which are written as JSON Lines.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "pw_protobuf/json_transcoder.h"
+#include "pw_status/try.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_stream/mmap_file_stream.h"
+#include "pw_stream/std_file_stream.h"
+#include "pw_varint/varint.h"
+
+namespace pw::protobuf {
+namespace {
+
+struct Arguments {
+  std::vector<const char*> descriptor_sets;
+  const char* type = nullptr;
+  unsigned jobs = std::thread::hardware_concurrency();
+  bool delimited = false;
+  JsonOptions options;
+  std::vector<const char*> inputs;
+};
+
+bool ParseArguments(int argc, char* argv[], Arguments& args) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const bool has_value = i + 1 < argc;
+
+    if (arg == "--descriptor-set" && has_value) {
+      args.descriptor_sets.push_back(argv[++i]);
+    } else if (arg == "--type" && has_value) {
+      args.type = argv[++i];
+    } else if (arg == "--jobs" && has_value) {
+      args.jobs = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--delimited") {
+      args.delimited = true;
+    } else if (arg == "--preserve-field-names") {
+      args.options.preserve_field_names = true;
+    } else if (!arg.empty() && arg.front() == '-') {
+      return false;
+    } else {
+      args.inputs.push_back(argv[i]);
+    }
+  }
+  return !args.descriptor_sets.empty() && args.type != nullptr &&
+         !args.inputs.empty();
+}
+
+Status TranscodeFile(const JsonTranscoder& transcoder,
+                     const DescriptorPool::Message& type,
+                     bool delimited,
+                     const char* path) {
+  stream::MmapFileReader input;
+  PW_TRY(input.Open(path));
+
+  stream::StdFileWriter output((std::string(path) + ".json").c_str());
+
+  if (!delimited) {
+    PW_TRY(transcoder.Transcode(type, input, output));
+    return output.Write(std::as_bytes(std::span("\n", 1)));
+  }
+
+  // Each message is read in place from the mapped file.
+  for (ConstByteSpan data = input.data(); !data.empty();) {
+    uint64_t size = 0;
+    const size_t prefix_size = varint::Decode(data, &size);
+    if (prefix_size == 0u || size > data.size() - prefix_size) {
+      return Status::DataLoss();
+    }
+
+    stream::MemoryReader message(data.subspan(prefix_size, size));
+    PW_TRY(transcoder.Transcode(type, message, output));
+    PW_TRY(output.Write(std::as_bytes(std::span("\n", 1))));
+    data = data.subspan(prefix_size + size);
+  }
+  return OkStatus();
+}
+
+int Main(int argc, char* argv[]) {
+  Arguments args;
+  if (!ParseArguments(argc, argv, args)) {
+    std::fprintf(stderr,
+                 "Usage: %s --descriptor-set FILE --type MESSAGE [--jobs N] "
+                 "[--delimited] [--preserve-field-names] FILE...\n",
+                 argv[0]);
+    return 2;
+  }
+
+  // The descriptor sets stay mapped while the pool is loaded.
+  DescriptorPool pool;
+  for (const char* path : args.descriptor_sets) {
+    stream::MmapFileReader descriptor_set;
+    if (Status status = descriptor_set.Open(path); !status.ok()) {
+      std::fprintf(stderr, "Failed to open %s: %s\n", path, status.str());
+      return 1;
+    }
+    if (Status status = pool.Load(descriptor_set.data()); !status.ok()) {
+      std::fprintf(stderr, "Failed to load %s: %s\n", path, status.str());
+      return 1;
+    }
+  }
+
+  const DescriptorPool::Message* type = pool.FindMessage(args.type);
+  if (type == nullptr) {
+    std::fprintf(stderr, "Message type %s not found\n", args.type);
+    return 1;
+  }
+
+  const JsonTranscoder transcoder(pool, args.options);
+  std::atomic<size_t> next_input = 0;
+  std::atomic<bool> failed = false;
+
+  // Files are claimed one at a time, so large files do not hold up a thread's
+  // share of the others.
+  auto worker = [&]() {
+    for (size_t i = next_input++; i < args.inputs.size(); i = next_input++) {
+      const char* path = args.inputs[i];
+      if (Status status =
+              TranscodeFile(transcoder, *type, args.delimited, path);
+          !status.ok()) {
+        std::fprintf(stderr, "Failed to convert %s: %s\n", path, status.str());
+        failed = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const size_t thread_count =
+      std::min<size_t>(std::max(args.jobs, 1u), args.inputs.size());
+  for (size_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  return failed ? 1 : 0;
+}
+
+}  // namespace
+}  // namespace pw::protobuf
+
+int main(int argc, char* argv[]) { return pw::protobuf::Main(argc, argv); }
@@ -37,8 +37,26 @@
 static_assert(PW_PROTOBUF_CFG_MAX_VARINT_SIZE > 0 &&
               PW_PROTOBUF_CFG_MAX_VARINT_SIZE <= 5);
 
+// The capacity of each string and bytes field in generated message structs.
+// Decoding a longer string or bytes field fails with RESOURCE_EXHAUSTED.
+#ifndef PW_PROTOBUF_CFG_STRUCT_MAX_BYTES_SIZE
+#define PW_PROTOBUF_CFG_STRUCT_MAX_BYTES_SIZE 32
+#endif  // PW_PROTOBUF_CFG_STRUCT_MAX_BYTES_SIZE
+
+// The capacity of each repeated field in generated message structs. Decoding
+// more values than this fails with RESOURCE_EXHAUSTED.
+#ifndef PW_PROTOBUF_CFG_STRUCT_MAX_REPEATED_COUNT
+#define PW_PROTOBUF_CFG_STRUCT_MAX_REPEATED_COUNT 8
+#endif  // PW_PROTOBUF_CFG_STRUCT_MAX_REPEATED_COUNT
+
 namespace pw::protobuf::config {
 
 inline constexpr size_t kMaxVarintSize = PW_PROTOBUF_CFG_MAX_VARINT_SIZE;
 
+inline constexpr size_t kStructMaxBytesSize =
+    PW_PROTOBUF_CFG_STRUCT_MAX_BYTES_SIZE;
+
+inline constexpr size_t kStructMaxRepeatedCount =
+    PW_PROTOBUF_CFG_STRUCT_MAX_REPEATED_COUNT;
+
 }  // namespace pw::protobuf::config
@@ -18,6 +18,7 @@
 #include <bit>
 #include <cstddef>
 #include <cstring>
+#include <limits>
 #include <span>
 #include <string_view>
 
@@ -119,7 +120,8 @@ class StreamEncoder {
         parent_(nullptr),
         nested_field_number_(0),
         memory_writer_(scratch_buffer),
-        writer_(writer) {}
+        writer_(writer),
+        payload_bytes_remaining_(kUnknownPayloadSize) {}
 
   // Precondition: Encoder has no active child encoder.
   //
@@ -141,7 +143,7 @@ class StreamEncoder {
   // Precondition: Encoder has no active child encoder.
   size_t ConservativeWriteLimit() const {
     PW_ASSERT(!nested_encoder_open());
-    return writer_.ConservativeWriteLimit();
+    return std::min(writer_.ConservativeWriteLimit(), payload_bytes_remaining_);
   }
 
   // Creates a nested encoder with the provided field number. Once this is
@@ -154,6 +156,27 @@ class StreamEncoder {
   //     encoder cannot be used.
   StreamEncoder GetNestedEncoder(uint32_t field_number);
 
+  // Creates a nested encoder for a submessage whose serialized size is known
+  // in advance. The field key and length prefix are written immediately and
+  // the nested encoder writes straight to this encoder's writer, so no scratch
+  // buffer is used and the submessage is not copied.
+  //
+  // The size can be computed with the helpers in serialized_size.h, or with a
+  // first encoding pass to a stream::CountingNullStream. See the two-pass
+  // encoding section of the docs.
+  //
+  // The nested encoder must write exactly payload_size bytes. Writes beyond
+  // payload_size fail with OUT_OF_RANGE, and if fewer bytes are written, this
+  // encoder's status becomes DATA_LOSS when the nested encoder is closed. A
+  // nested encoder created this way has no scratch buffer, so its own
+  // submessages must also be created with a payload size.
+  //
+  // Precondition: Encoder has no active child encoder.
+  //
+  // Postcondition: Until the nested child encoder has been destroyed, this
+  //     encoder cannot be used.
+  StreamEncoder GetNestedEncoder(uint32_t field_number, size_t payload_size);
+
   // Returns the current encoder's status.
   //
   // Precondition: Encoder has no active child encoder.
@@ -468,7 +491,8 @@ class StreamEncoder {
         nested_field_number_(other.nested_field_number_),
         memory_writer_(std::move(other.memory_writer_)),
         writer_(&other.writer_ == &other.memory_writer_ ? memory_writer_
-                                                        : other.writer_) {
+                                                        : other.writer_),
+        payload_bytes_remaining_(other.payload_bytes_remaining_) {
     PW_ASSERT(nested_field_number_ == 0);
     // Make the nested encoder look like it has an open child to block writes
     // for the remainder of the object's life.
@@ -484,13 +508,30 @@ class StreamEncoder {
     kZigZag,
   };
 
+  // Marks encoders that don't have a fixed payload size.
+  static constexpr size_t kUnknownPayloadSize =
+      std::numeric_limits<size_t>::max();
+
   constexpr StreamEncoder(StreamEncoder& parent, ByteSpan scratch_buffer)
       : status_(scratch_buffer.empty() ? Status::ResourceExhausted()
                                        : OkStatus()),
         parent_(&parent),
         nested_field_number_(0),
         memory_writer_(scratch_buffer),
-        writer_(memory_writer_) {}
+        writer_(memory_writer_),
+        payload_bytes_remaining_(kUnknownPayloadSize) {}
+
+  // Creates a nested encoder that writes payload_size bytes directly to the
+  // parent's writer. The nested encoder starts with the parent's status.
+  constexpr StreamEncoder(StreamEncoder& parent,
+                          stream::Writer& writer,
+                          size_t payload_size)
+      : status_(parent.status_),
+        parent_(&parent),
+        nested_field_number_(0),
+        memory_writer_(ByteSpan()),
+        writer_(writer),
+        payload_bytes_remaining_(payload_size) {}
 
   bool nested_encoder_open() const { return nested_field_number_ != 0; }
 
@@ -589,6 +630,8 @@ class StreamEncoder {
   //   InvalidArgument: The field number provided was invalid.
   //   ResourceExhausted: The requested write would have exceeded the
   //     stream::Writer's conservative write limit.
+  //   OutOfRange: The requested write would have exceeded the payload size of
+  //     a nested encoder created with a known size.
   //   Other: If any Write() operations on the stream::Writer caused an error,
   //     that error will be repeated here.
   Status UpdateStatusForWrite(uint32_t field_number,
@@ -616,6 +659,10 @@ class StreamEncoder {
 
   // All proto encode operations are directly written to this writer.
   stream::Writer& writer_;
+
+  // For nested encoders created with a known payload size, the number of bytes
+  // that have yet to be written. kUnknownPayloadSize for other encoders.
+  size_t payload_bytes_remaining_;
 };
 
 // A protobuf encoder that writes directly to a provided buffer.
@@ -13,7 +13,14 @@
 // the License.
 #pragma once
 
+#include <cstdint>
+#include <utility>
+
+#include "pw_bytes/span.h"
 #include "pw_protobuf/decoder.h"
+#include "pw_protobuf/stream_decoder.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_status/status.h"
 
 namespace pw::protobuf {
 
@@ -43,4 +50,97 @@ class FindDecodeHandler final : public DecodeHandler {
   FindDecodeHandler* nested_handler_;
 };
 
+namespace internal {
+
+template <uint32_t... kFieldPath>
+constexpr bool ValidFieldPath() {
+  return sizeof...(kFieldPath) > 0u && (ValidFieldNumber(kFieldPath) && ...);
+}
+
+template <uint32_t kFieldNumber, uint32_t... kRest, typename Function>
+Status FindInDecoder(Decoder& decoder, Function& function) {
+  while (true) {
+    if (Status status = decoder.Next(); !status.ok()) {
+      return status.IsOutOfRange() ? Status::NotFound() : status;
+    }
+    if (decoder.FieldNumber() != kFieldNumber) {
+      continue;  // Next() skips over the field without decoding it.
+    }
+
+    if constexpr (sizeof...(kRest) == 0u) {
+      return function(decoder);
+    } else {
+      ConstByteSpan submessage;
+      if (Status status = decoder.ReadBytes(&submessage); !status.ok()) {
+        return status;
+      }
+      Decoder nested(submessage);
+      return FindInDecoder<kRest...>(nested, function);
+    }
+  }
+}
+
+template <uint32_t kFieldNumber, uint32_t... kRest, typename Function>
+Status FindInStreamDecoder(StreamDecoder& decoder, Function& function) {
+  while (true) {
+    if (Status status = decoder.Next(); !status.ok()) {
+      return status.IsOutOfRange() ? Status::NotFound() : status;
+    }
+    if (decoder.FieldNumber().value() != kFieldNumber) {
+      continue;  // Next() seeks past the field without reading it.
+    }
+
+    if constexpr (sizeof...(kRest) == 0u) {
+      return function(decoder);
+    } else {
+      StreamDecoder nested = decoder.GetNestedDecoder();
+      return FindInStreamDecoder<kRest...>(nested, function);
+    }
+  }
+}
+
+}  // namespace internal
+
+// Finds the first field at a path of field numbers known at compile time and
+// calls function with a decoder positioned on it. For example, Find<7, 1>
+// finds field 1 of the submessage in field 7. The function reads the field and
+// returns a Status, which Find returns.
+//
+// Only the first occurrence of each field on the path is considered. Fields
+// before it are skipped without being decoded and decoding stops at the match,
+// so the cost is proportional to the position of the field rather than to the
+// size of the message.
+//
+//   uint32_t value;
+//   Status status = Find<7, 1>(message, [&value](Decoder& field) {
+//     return field.ReadUint32(&value);
+//   });
+//
+// Returns:
+//   NOT_FOUND - a field on the path is not present
+//   DATA_LOSS - the message is malformed
+//   FAILED_PRECONDITION - a field on the path is not a submessage
+//   any status returned by function
+//
+template <uint32_t... kFieldPath, typename Function>
+Status Find(ConstByteSpan message, Function&& function) {
+  static_assert(internal::ValidFieldPath<kFieldPath...>(),
+                "The field path must contain at least one field number and "
+                "every field number must be valid");
+  Decoder decoder(message);
+  return internal::FindInDecoder<kFieldPath...>(decoder, function);
+}
+
+// Finds a field in a StreamDecoder, as above. Skipped fields are seeked past,
+// so their contents are never read from the stream. The function is called
+// while any nested decoders on the path are open; when Find returns, the
+// decoder is positioned after the top-level field on the path.
+template <uint32_t... kFieldPath, typename Function>
+Status Find(StreamDecoder& decoder, Function&& function) {
+  static_assert(internal::ValidFieldPath<kFieldPath...>(),
+                "The field path must contain at least one field number and "
+                "every field number must be valid");
+  return internal::FindInStreamDecoder<kFieldPath...>(decoder, function);
+}
+
 }  // namespace pw::protobuf
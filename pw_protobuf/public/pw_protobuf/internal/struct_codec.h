@@ -0,0 +1,142 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+// This header defines the field tables and table-driven codec used by the
+// message structs generated by pw_protobuf's codegen. It is not intended to be
+// used directly.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::protobuf::internal {
+
+// The protobuf type of a field in a generated message struct. Each type has a
+// fixed C++ representation in the struct and implies the field's wire type.
+enum class StructFieldType : uint8_t {
+  kUint32,    // uint32_t
+  kInt32,     // int32_t
+  kSint32,    // int32_t
+  kFixed32,   // uint32_t
+  kSfixed32,  // int32_t
+  kUint64,    // uint64_t
+  kInt64,     // int64_t
+  kSint64,    // int64_t
+  kFixed64,   // uint64_t
+  kSfixed64,  // int64_t
+  kFloat,     // float
+  kDouble,    // double
+  kBool,      // bool
+  kEnum,      // A generated enum class, which is the size of an int32_t
+  kString,    // pw::Vector<char, N>
+  kBytes,     // pw::Vector<std::byte, N>
+  kMessage,   // A generated message struct
+};
+
+// Type-erased operations on a pw::Vector<T, kMaxSize>. These let the generic
+// codec work with vectors of any element type and capacity.
+struct VectorOps {
+  size_t (*size)(const void* vector);
+  std::byte* (*data)(void* vector);
+
+  // Resizes the vector, default-constructing any new elements. Returns false
+  // without modifying the vector if new_size exceeds its capacity.
+  bool (*resize)(void* vector, size_t new_size);
+
+  size_t element_size;
+};
+
+template <typename VectorType>
+inline constexpr VectorOps kVectorOps = {
+    [](const void* vector) -> size_t {
+      return static_cast<const VectorType*>(vector)->size();
+    },
+    [](void* vector) -> std::byte* {
+      return reinterpret_cast<std::byte*>(
+          static_cast<VectorType*>(vector)->data());
+    },
+    [](void* vector, size_t new_size) -> bool {
+      VectorType& values = *static_cast<VectorType*>(vector);
+      if (new_size > values.max_size()) {
+        return false;
+      }
+      values.resize(
+          static_cast<typename VectorType::size_type>(new_size));
+      return true;
+    },
+    sizeof(typename VectorType::value_type),
+};
+
+struct MessageDescriptor;
+
+// Describes one field of a generated message struct.
+struct StructField {
+  uint32_t field_number;
+  StructFieldType type;
+  bool repeated;
+
+  // Whether a repeated scalar field is encoded packed. Both encodings are
+  // accepted when decoding.
+  bool packed;
+
+  // Offset of the field's member in the struct.
+  size_t offset;
+
+  // For repeated fields, the pw::Vector holding the values.
+  const VectorOps* values;
+
+  // For string and bytes fields, the pw::Vector holding the characters or
+  // bytes. For repeated fields, this is the element type of values.
+  const VectorOps* bytes;
+
+  // For message fields, the submessage's fields.
+  const MessageDescriptor* message;
+};
+
+// Describes a generated message struct. Fields are sorted by field number.
+struct MessageDescriptor {
+  std::span<const StructField> fields;
+};
+
+// Returns the size of the message struct when encoded.
+size_t StructEncodedSize(const MessageDescriptor& descriptor,
+                         const void* message);
+
+// Encodes the message struct to the buffer. Fields with zero or empty values
+// are not written. Returns RESOURCE_EXHAUSTED if the buffer is too small.
+StatusWithSize EncodeStruct(const MessageDescriptor& descriptor,
+                            const void* message,
+                            ByteSpan buffer);
+
+// Resets the message struct and decodes a serialized message into it. Unknown
+// fields are skipped.
+//
+// Returns:
+//   OK - the message was decoded
+//   RESOURCE_EXHAUSTED - a string, bytes, or repeated field exceeded its
+//       vector's capacity
+//   OUT_OF_RANGE - a value did not fit in its field's type
+//   DATA_LOSS - the message is malformed
+//
+Status DecodeStruct(const MessageDescriptor& descriptor,
+                    ConstByteSpan data,
+                    void* message);
+
+}  // namespace pw::protobuf::internal
@@ -0,0 +1,168 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This file provides a host-side transcoder from the protobuf wire format to
+// JSON. Message types are described by a serialized FileDescriptorSet, such as
+// the one generated by a pw_proto_library's .descriptor_set subtarget:
+//
+//   DescriptorPool pool;
+//   PW_TRY(pool.Load(descriptor_set_data));
+//
+//   JsonTranscoder transcoder(pool);
+//   PW_TRY(transcoder.Transcode("pw.log.LogEntries", proto_reader, writer));
+//
+// Messages are decoded with a StreamDecoder and written as they are read, so
+// no message objects are built and memory use does not depend on message size.
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "pw_bytes/span.h"
+#include "pw_protobuf/stream_decoder.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::protobuf {
+
+// The message and enum types described by one or more FileDescriptorSets.
+class DescriptorPool {
+ public:
+  // Values of FieldDescriptorProto.Type.
+  enum class FieldType : uint8_t {
+    kDouble = 1,
+    kFloat = 2,
+    kInt64 = 3,
+    kUint64 = 4,
+    kInt32 = 5,
+    kFixed64 = 6,
+    kFixed32 = 7,
+    kBool = 8,
+    kString = 9,
+    kGroup = 10,
+    kMessage = 11,
+    kBytes = 12,
+    kUint32 = 13,
+    kEnum = 14,
+    kSfixed32 = 15,
+    kSfixed64 = 16,
+    kSint32 = 17,
+    kSint64 = 18,
+  };
+
+  struct Enum {
+    // Only the first name of each value is kept if values are aliased.
+    std::unordered_map<int32_t, std::string> names;
+  };
+
+  struct Message;
+
+  struct Field {
+    uint32_t number;
+    FieldType type;
+    bool repeated;
+    std::string name;
+    std::string json_name;
+
+    // The fully qualified name of a message or enum field's type, and the type
+    // it refers to once the pool is loaded. Either may be null if the type is
+    // not in the pool; unknown enums are written as numbers.
+    std::string type_name;
+    const Message* message;
+    const Enum* enum_type;
+  };
+
+  struct Message {
+    // Returns the field with the given number, or nullptr.
+    const Field* FindField(uint32_t number) const;
+
+    std::vector<Field> fields;  // Sorted by field number.
+    bool map_entry;
+  };
+
+  DescriptorPool() = default;
+
+  DescriptorPool(const DescriptorPool&) = delete;
+  DescriptorPool& operator=(const DescriptorPool&) = delete;
+
+  // Adds the types in a serialized google.protobuf.FileDescriptorSet to the
+  // pool. Types in earlier sets may refer to types in later ones. Returns
+  // DATA_LOSS if the descriptor set is malformed.
+  Status Load(ConstByteSpan file_descriptor_set);
+
+  // Finds a type by its fully qualified name, such as "pw.log.LogEntry".
+  // Returns nullptr if the type is not in the pool.
+  const Message* FindMessage(std::string_view name) const;
+  const Enum* FindEnum(std::string_view name) const;
+
+ private:
+  Status LoadFile(ConstByteSpan file);
+  Status LoadMessage(ConstByteSpan descriptor, const std::string& scope);
+  Status LoadField(ConstByteSpan descriptor, Field& field);
+  Status LoadEnum(ConstByteSpan descriptor, const std::string& scope);
+
+  // Points message and enum fields at their types.
+  void Link();
+
+  std::unordered_map<std::string, Message> messages_;
+  std::unordered_map<std::string, Enum> enums_;
+};
+
+struct JsonOptions {
+  // Use the fields' names from the .proto file instead of their lowerCamelCase
+  // JSON names.
+  bool preserve_field_names = false;
+};
+
+// Writes protobuf messages as JSON, following the proto3 JSON mapping with a
+// few exceptions:
+//
+//   - Fields are written in the order they appear in the encoded message.
+//     Since all fields present are written, default values are included if
+//     they were encoded.
+//   - Unpacked repeated fields must be encoded contiguously, as every encoder
+//     does. A repeated field that reappears after other fields is DATA_LOSS.
+//   - Map entries must encode their key before their value. A missing key is
+//     written as the key type's default value.
+//   - Unknown fields and groups are skipped. Well-known types, such as
+//     google.protobuf.Timestamp, are written as ordinary messages.
+//   - Strings are written as they are, without validating their UTF-8.
+//
+// A JsonTranscoder is immutable, so one may be shared by many threads.
+class JsonTranscoder {
+ public:
+  constexpr JsonTranscoder(const DescriptorPool& pool,
+                           JsonOptions options = {})
+      : pool_(pool), options_(options) {}
+
+  // Reads one message from input and writes it to output as a JSON object.
+  // Returns NOT_FOUND if the type is not in the pool, DATA_LOSS if the message
+  // is malformed, or the output's status if a write fails.
+  Status Transcode(std::string_view type,
+                   stream::SeekableReader& input,
+                   stream::Writer& output) const;
+
+  Status Transcode(const DescriptorPool::Message& type,
+                   stream::SeekableReader& input,
+                   stream::Writer& output) const;
+
+ private:
+  const DescriptorPool& pool_;
+  const JsonOptions options_;
+};
+
+}  // namespace pw::protobuf
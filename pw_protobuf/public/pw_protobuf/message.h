@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <span>
 #include <string_view>
 
 #include "pw_assert/check.h"
@@ -201,6 +203,8 @@ using StringToMessageMap = StringMapParser<Message>;
 //   // the one with the give field number. This can be expensive if called
 //   // multiple times. Therefore, whenever possible, it is recommended to use
 //   // the following iteration to iterate and process each field directly.
+//   // Alternatively, BuildIndex() records where each field is in a single
+//   // pass, after which the `AsXXX()` methods seek to the field directly.
 //   for (Message::Field field : message) {
 //     if (field.field_number() == 1) {
 //       String str = field.As<String>();
@@ -285,6 +289,14 @@ class Message {
     friend class Message;
   };
 
+  // The location of a field, as recorded by BuildIndex(). Offsets are in the
+  // source reader.
+  struct IndexEntry {
+    uint32_t field_number;
+    size_t start;
+    size_t end;
+  };
+
   Message() = default;
   Message(Status status) : reader_(status) {}
   Message(stream::IntervalReader reader) : reader_(reader) {}
@@ -357,6 +369,20 @@ class Message {
   iterator begin();
   iterator end();
 
+  // Reads the message once and records where the first occurrence of each
+  // field number is in the caller-provided `index`. Afterwards, As() and the
+  // `AsXXX()` methods find indexed fields without reading the message, and
+  // fail fields that are not in the message with NOT_FOUND without reading it.
+  // Copies of this Message share the index; it must outlive them.
+  //
+  // If the message has more distinct field numbers than fit in `index`, the
+  // fields up to the first one that did not fit are indexed and
+  // RESOURCE_EXHAUSTED is returned. Lookups remain correct: fields that are
+  // not indexed are searched for starting after the indexed fields.
+  //
+  // Repeated fields and maps are still found by iterating over the message.
+  Status BuildIndex(std::span<IndexEntry> index);
+
   // Parse a field given by `field_number` as the target parser type
   // `FieldType`.
   //
@@ -366,16 +392,13 @@ class Message {
   // <field_number>.
   //
   // Since the method needs to traverse all fields, it can be inefficient if
-  // called multiple times exepcially on slow reader.
+  // called multiple times exepcially on slow reader, unless the message is
+  // indexed with BuildIndex().
   template <typename FieldType>
   FieldType As(uint32_t field_number) {
-    for (Field field : *this) {
-      if (field.field_number() == field_number) {
-        return field.As<FieldType>();
-      }
-    }
-
-    return FieldType(Status::NotFound());
+    Field field;
+    PW_TRY(FindField(field_number, field));
+    return field.As<FieldType>();
   }
 
   template <typename FieldType>
@@ -389,8 +412,19 @@ class Message {
   }
 
  private:
+  // Finds the first field with the given field number, using the index if
+  // there is one.
+  Status FindField(uint32_t field_number, Field& field);
+
   stream::IntervalReader reader_;
 
+  // The index built by BuildIndex(). The first index_size_ entries are valid.
+  // Every field before index_end_, an offset in the source reader, is in the
+  // index.
+  std::span<IndexEntry> index_;
+  size_t index_size_ = 0;
+  size_t index_end_ = 0;
+
   // Consume the current field. If the field has already been processed, i.e.
   // by calling one of the Read..() method, nothing is done. After calling this
   // method, the reader will be pointing either to the start of the next
@@ -500,8 +534,10 @@ class RepeatedFieldParser {
   iterator begin() { return iterator(*this, message_.begin()); }
   iterator end() { return iterator(*this, message_.end()); }
 
- private:
+ protected:
   Message message_;
+
+ private:
   uint32_t field_number_ = 0;
 };
 
@@ -525,11 +561,31 @@ class StringMapEntryParser {
   ValueParser Value() { return entry_.As<ValueParser>(kMapValueFieldNumber); }
 
  private:
+  friend class StringMapParser<ValueParser>;
+
   static constexpr uint32_t kMapKeyFieldNumber = 1;
   static constexpr uint32_t kMapValueFieldNumber = 2;
   Message entry_;
 };
 
+// A slot in the key hash index built by StringMapParser::BuildIndex(). The
+// offsets of the map entry are in the source reader. A slot is empty if `end`
+// is 0, which no entry can have since entries follow a field key.
+struct StringMapIndexSlot {
+  uint32_t key_hash;
+  size_t start;
+  size_t end;
+};
+
+namespace internal {
+
+// The hash of a map key used by StringMapParser indexes. Both overloads return
+// the same hash for the same key.
+uint32_t HashMapKey(std::string_view key);
+Result<uint32_t> HashMapKey(stream::IntervalReader key);
+
+}  // namespace internal
+
 // A helper class for parsing a string-keyed map field. i.e. map<string,
 // <value>>. The template argument `ValueParser` indicates the type the value
 // will be parsed as, i.e. String, Bytes, Uint32, Message etc.
@@ -540,11 +596,58 @@ template <typename ValueParser>
 class StringMapParser
     : public RepeatedFieldParser<StringMapEntryParser<ValueParser>> {
  public:
+  using IndexSlot = StringMapIndexSlot;
+
   using RepeatedFieldParser<
       StringMapEntryParser<ValueParser>>::RepeatedFieldParser;
 
+  // Reads the map once and builds an index from key hashes to entries in the
+  // caller-provided `index`. Afterwards, operator[] reads only the entries
+  // whose key hash matches, instead of comparing the key of every entry.
+  // Copies of this parser share the index; it must outlive them.
+  //
+  // The index needs a slot per map entry; about twice as many slots as entries
+  // keeps collisions rare. If the map has more entries than `index` has slots,
+  // RESOURCE_EXHAUSTED is returned and lookups continue to scan the map.
+  Status BuildIndex(std::span<IndexSlot> index) {
+    index_ = {};
+    PW_TRY(this->status());
+    std::fill(index.begin(), index.end(), IndexSlot{0, 0, 0});
+
+    size_t entries = 0;
+    for (StringMapEntryParser<ValueParser> entry : *this) {
+      if (entries == index.size()) {
+        return Status::ResourceExhausted();
+      }
+
+      String key = entry.Key();
+      PW_TRY(key.status());
+      Result<uint32_t> key_hash = internal::HashMapKey(key.GetBytesReader());
+      PW_TRY(key_hash.status());
+
+      // Linear probing keeps entries with the same hash in map order, so
+      // duplicate keys resolve to the first entry, as without an index.
+      size_t slot = key_hash.value() % index.size();
+      while (index[slot].end != 0u) {
+        slot = (slot + 1) % index.size();
+      }
+      const stream::IntervalReader entry_reader =
+          entry.entry_.ToBytes().GetBytesReader();
+      index[slot] = {
+          key_hash.value(), entry_reader.start(), entry_reader.end()};
+      entries += 1;
+    }
+
+    index_ = index;
+    return OkStatus();
+  }
+
   // Operator overload for value access of a given key.
   ValueParser operator[](std::string_view target) {
+    if (!index_.empty()) {
+      return FindIndexed(target);
+    }
+
     // Iterate over all entries and find the one whose key matches `target`
     for (StringMapEntryParser<ValueParser> entry : *this) {
       String key = entry.Key();
@@ -560,6 +663,39 @@ class StringMapParser
 
     return ValueParser(Status::NotFound());
   }
+
+ private:
+  ValueParser FindIndexed(std::string_view target) {
+    const uint32_t key_hash = internal::HashMapKey(target);
+    stream::SeekableReader& source =
+        this->message_.ToBytes().GetBytesReader().source_reader();
+
+    size_t slot = key_hash % index_.size();
+    for (size_t probes = 0; probes < index_.size(); ++probes) {
+      const IndexSlot& entry_slot = index_[slot];
+      if (entry_slot.end == 0u) {
+        break;
+      }
+      slot = (slot + 1) % index_.size();
+      if (entry_slot.key_hash != key_hash) {
+        continue;
+      }
+
+      StringMapEntryParser<ValueParser> entry(
+          stream::IntervalReader(source, entry_slot.start, entry_slot.end));
+      String key = entry.Key();
+      PW_TRY(key.status());
+      Result<bool> cmp_res = key.Equal(target);
+      PW_TRY(cmp_res.status());
+      if (cmp_res.value()) {
+        return entry.Value();
+      }
+    }
+
+    return ValueParser(Status::NotFound());
+  }
+
+  std::span<const IndexSlot> index_;
 };
 
 }  // namespace pw::protobuf
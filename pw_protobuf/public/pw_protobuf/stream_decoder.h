@@ -139,6 +139,18 @@ class StreamDecoder {
                         : Result<uint32_t>(status_);
   }
 
+  // Returns the wire type of the current field, such as to tell a packed
+  // repeated field from an unpacked one. Valid under the same conditions as
+  // FieldNumber().
+  constexpr Result<WireType> FieldWireType() const {
+    if (field_consumed_) {
+      return Status::FailedPrecondition();
+    }
+
+    return status_.ok() ? current_field_.wire_type()
+                        : Result<WireType>(status_);
+  }
+
   //
   // TODO(frolv): Add Status Read*(T& value) APIs alongside the Result<T> ones.
   //
@@ -220,6 +232,80 @@ class StreamDecoder {
     return d;
   }
 
+  // Reads a packed repeated field from the current position into out and
+  // returns the number of values read. Packed fields are read from the stream
+  // in blocks instead of one value at a time. A field encoded as a single
+  // unpacked value is also accepted and reads one value.
+  //
+  // If out is too small to fit all of the values, RESOURCE_EXHAUSTED is
+  // returned and the decoder's position remains on the field, as in
+  // ReadBytes(). For 32-bit varint types, OUT_OF_RANGE is returned if a value
+  // doesn't fit; the field is consumed and the size is the number of values
+  // read before it.
+  StatusWithSize ReadPackedUint32(std::span<uint32_t> out) {
+    return ReadPackedVarintField(std::as_writable_bytes(out),
+                                 sizeof(uint32_t),
+                                 VarintDecodeType::kUnsigned);
+  }
+
+  StatusWithSize ReadPackedInt32(std::span<int32_t> out) {
+    return ReadPackedVarintField(std::as_writable_bytes(out),
+                                 sizeof(int32_t),
+                                 VarintDecodeType::kNormal);
+  }
+
+  StatusWithSize ReadPackedSint32(std::span<int32_t> out) {
+    return ReadPackedVarintField(std::as_writable_bytes(out),
+                                 sizeof(int32_t),
+                                 VarintDecodeType::kZigZag);
+  }
+
+  StatusWithSize ReadPackedUint64(std::span<uint64_t> out) {
+    return ReadPackedVarintField(std::as_writable_bytes(out),
+                                 sizeof(uint64_t),
+                                 VarintDecodeType::kUnsigned);
+  }
+
+  StatusWithSize ReadPackedInt64(std::span<int64_t> out) {
+    return ReadPackedVarintField(std::as_writable_bytes(out),
+                                 sizeof(int64_t),
+                                 VarintDecodeType::kNormal);
+  }
+
+  StatusWithSize ReadPackedSint64(std::span<int64_t> out) {
+    return ReadPackedVarintField(std::as_writable_bytes(out),
+                                 sizeof(int64_t),
+                                 VarintDecodeType::kZigZag);
+  }
+
+  StatusWithSize ReadPackedFixed32(std::span<uint32_t> out) {
+    return ReadPackedFixedField(std::as_writable_bytes(out), sizeof(uint32_t));
+  }
+
+  StatusWithSize ReadPackedFixed64(std::span<uint64_t> out) {
+    return ReadPackedFixedField(std::as_writable_bytes(out), sizeof(uint64_t));
+  }
+
+  StatusWithSize ReadPackedSfixed32(std::span<int32_t> out) {
+    return ReadPackedFixedField(std::as_writable_bytes(out), sizeof(int32_t));
+  }
+
+  StatusWithSize ReadPackedSfixed64(std::span<int64_t> out) {
+    return ReadPackedFixedField(std::as_writable_bytes(out), sizeof(int64_t));
+  }
+
+  StatusWithSize ReadPackedFloat(std::span<float> out) {
+    static_assert(sizeof(float) == sizeof(uint32_t),
+                  "Float and uint32_t must be the same size for protobufs");
+    return ReadPackedFixedField(std::as_writable_bytes(out), sizeof(float));
+  }
+
+  StatusWithSize ReadPackedDouble(std::span<double> out) {
+    static_assert(sizeof(double) == sizeof(uint64_t),
+                  "Double and uint64_t must be the same size for protobufs");
+    return ReadPackedFixedField(std::as_writable_bytes(out), sizeof(double));
+  }
+
   // Reads a proto string value from the current position. The string is copied
   // into the provided buffer and the read size is returned. The copied string
   // will NOT be null terminated; this should be done manually if desired.
@@ -304,6 +390,13 @@ class StreamDecoder {
   static constexpr FieldKey kInitialFieldKey =
       FieldKey(20000, WireType::kVarint);
 
+  // How the varints in a packed field map to their values.
+  enum class VarintDecodeType {
+    kUnsigned,
+    kNormal,
+    kZigZag,
+  };
+
   constexpr StreamDecoder(stream::SeekableReader& reader,
                           StreamDecoder* parent,
                           size_t low,
@@ -360,6 +453,13 @@ class StreamDecoder {
 
   StatusWithSize ReadDelimitedField(std::span<std::byte> out);
 
+  StatusWithSize ReadPackedFixedField(std::span<std::byte> out,
+                                      size_t elem_size);
+
+  StatusWithSize ReadPackedVarintField(std::span<std::byte> out,
+                                       size_t elem_size,
+                                       VarintDecodeType decode_type);
+
   StatusWithSize ReadVarint(uint64_t* output);
 
   Status CheckOkToRead(WireType type);
@@ -175,6 +175,22 @@ class SubMessageMethod(ProtoMethod):
         return False
 
 
+class SizedSubMessageMethod(SubMessageMethod):
+    """Method which returns a sub-message encoder for a known payload size.
+
+    The sub-message is written directly to the parent's writer rather than
+    staged in a scratch buffer.
+    """
+    def params(self) -> List[Tuple[str, str]]:
+        return [('size_t', 'payload_size')]
+
+    def body(self) -> List[str]:
+        line = ('return {}::StreamEncoder('
+                'GetNestedEncoder({}, payload_size));').format(
+                    self._relative_type_namespace(), self.field_cast())
+        return [line]
+
+
 class WriteMethod(ProtoMethod):
     """Base class representing an encoder write method.
 
@@ -532,11 +548,277 @@ PROTO_FIELD_METHODS: Dict[int, List] = {
     descriptor_pb2.FieldDescriptorProto.TYPE_STRING: [
         StringLenMethod, StringMethod
     ],
-    descriptor_pb2.FieldDescriptorProto.TYPE_MESSAGE: [SubMessageMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_MESSAGE:
+    [SubMessageMethod, SizedSubMessageMethod],
     descriptor_pb2.FieldDescriptorProto.TYPE_ENUM: [EnumMethod],
 }
 
 
+# Struct field types for each protobuf field type, as used by the table-driven
+# codec in pw_protobuf/internal/struct_codec.h, and their C++ member types.
+# String, bytes, message, and enum member types depend on the field.
+_STRUCT_FIELD_TYPES: Dict[int, Tuple[str, str]] = {
+    descriptor_pb2.FieldDescriptorProto.TYPE_DOUBLE: ('kDouble', 'double'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_FLOAT: ('kFloat', 'float'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_INT32: ('kInt32', 'int32_t'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_SINT32: ('kSint32', 'int32_t'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_SFIXED32:
+    ('kSfixed32', 'int32_t'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_INT64: ('kInt64', 'int64_t'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_SINT64: ('kSint64', 'int64_t'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_SFIXED64:
+    ('kSfixed64', 'int64_t'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_UINT32: ('kUint32', 'uint32_t'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_FIXED32: ('kFixed32', 'uint32_t'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_UINT64: ('kUint64', 'uint64_t'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_FIXED64: ('kFixed64', 'uint64_t'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_BOOL: ('kBool', 'bool'),
+    descriptor_pb2.FieldDescriptorProto.TYPE_STRING: ('kString', ''),
+    descriptor_pb2.FieldDescriptorProto.TYPE_BYTES: ('kBytes', ''),
+    descriptor_pb2.FieldDescriptorProto.TYPE_MESSAGE: ('kMessage', ''),
+    descriptor_pb2.FieldDescriptorProto.TYPE_ENUM: ('kEnum', ''),
+}
+
+# Field names that cannot be used as struct members.
+_RESERVED_MEMBER_NAMES = frozenset([
+    'Decode', 'Encode', 'EncodedSize', 'output_buffer', 'serialized_message',
+    'alignas', 'alignof', 'and', 'asm',
+    'auto', 'bool', 'break', 'case', 'catch', 'char', 'class', 'const',
+    'constexpr', 'continue', 'default', 'delete', 'do', 'double', 'else',
+    'enum', 'explicit', 'export', 'extern', 'false', 'float', 'for', 'friend',
+    'goto', 'if', 'inline', 'int', 'long', 'mutable', 'namespace', 'new',
+    'noexcept', 'not', 'nullptr', 'operator', 'or', 'private', 'protected',
+    'public', 'register', 'return', 'short', 'signed', 'sizeof', 'static',
+    'struct', 'switch', 'template', 'this', 'throw', 'true', 'try', 'typedef',
+    'typeid', 'typename', 'union', 'unsigned', 'using', 'virtual', 'void',
+    'volatile', 'while', 'xor'
+])
+
+_STRUCT_CODEC_NAMESPACE = f'{PROTOBUF_NAMESPACE}::internal'
+
+
+def _struct_messages(package: ProtoNode) -> List[ProtoMessage]:
+    """Returns the messages in the package that get generated structs.
+
+    Structs contain their submessages by value, so messages which are
+    recursive, or which refer to messages from other files, do not get structs.
+    The messages are returned in dependency order, so that each struct is
+    defined after the structs of its submessages.
+    """
+    supported: Dict[ProtoMessage, bool] = {}
+    ordered: List[ProtoMessage] = []
+
+    def visit(message: ProtoMessage) -> bool:
+        if message in supported:
+            return supported[message]
+
+        # Mark the message as unsupported while visiting it, which rejects
+        # cycles.
+        supported[message] = False
+
+        result = message.find('Message') is None
+        for field in message.fields():
+            if (field.type() not in _STRUCT_FIELD_TYPES
+                    or field.field_name() in _RESERVED_MEMBER_NAMES):
+                result = False
+            elif (field.type() ==
+                  descriptor_pb2.FieldDescriptorProto.TYPE_MESSAGE):
+                type_node = field.type_node()
+                if (not isinstance(type_node, ProtoMessage)
+                        or not visit(type_node)):
+                    result = False
+
+        supported[message] = result
+        if result:
+            ordered.append(message)
+        return result
+
+    for node in package:
+        if node.type() == ProtoNode.Type.MESSAGE:
+            visit(cast(ProtoMessage, node))
+
+    return ordered
+
+
+def _struct_member_type(field: ProtoMessageField) -> str:
+    """Returns the C++ type of a field's member in a generated struct."""
+    field_type = _STRUCT_FIELD_TYPES[field.type()][1]
+
+    if field.type() == descriptor_pb2.FieldDescriptorProto.TYPE_STRING:
+        field_type = (f'::pw::Vector<char, '
+                      f'{PROTOBUF_NAMESPACE}::config::kStructMaxBytesSize>')
+    elif field.type() == descriptor_pb2.FieldDescriptorProto.TYPE_BYTES:
+        field_type = (f'::pw::Vector<std::byte, '
+                      f'{PROTOBUF_NAMESPACE}::config::kStructMaxBytesSize>')
+    elif field.type() == descriptor_pb2.FieldDescriptorProto.TYPE_MESSAGE:
+        type_node = field.type_node()
+        assert type_node is not None
+        field_type = f'::{type_node.cpp_namespace()}::Message'
+    elif field.type() == descriptor_pb2.FieldDescriptorProto.TYPE_ENUM:
+        type_node = field.type_node()
+        assert type_node is not None
+        field_type = f'::{type_node.cpp_namespace()}'
+
+    if field.is_repeated():
+        return (f'::pw::Vector<{field_type}, '
+                f'{PROTOBUF_NAMESPACE}::config::kStructMaxRepeatedCount>')
+    return field_type
+
+
+def generate_struct_for_message(message: ProtoMessage, root: ProtoNode,
+                                output: OutputFile) -> None:
+    """Defines a plain struct with a member for each field of a message."""
+    output.write_line(f'struct {message.cpp_namespace(root)}::Message {{')
+
+    with output.indent():
+        for field in message.fields():
+            member_type = _struct_member_type(field)
+            is_vector = member_type.startswith('::pw::Vector')
+            is_message = (field.type() ==
+                          descriptor_pb2.FieldDescriptorProto.TYPE_MESSAGE)
+            initializer = '' if is_vector or is_message else ' = {}'
+            output.write_line(
+                f'{member_type} {field.field_name()}{initializer};')
+
+        if message.fields():
+            output.write_line()
+        output.write_line('// Resets this struct and decodes a serialized '
+                          'message into it.')
+        output.write_line(
+            '::pw::Status Decode(::pw::ConstByteSpan serialized_message);')
+        output.write_line()
+        output.write_line('// Encodes this struct to the buffer, returning '
+                          'the encoded size.')
+        output.write_line(
+            '::pw::StatusWithSize Encode(::pw::ByteSpan output_buffer) const;')
+        output.write_line()
+        output.write_line('// Returns the size of this struct when encoded.')
+        output.write_line('size_t EncodedSize() const;')
+
+    output.write_line('};')
+
+
+def generate_struct_descriptor(message: ProtoMessage, root: ProtoNode,
+                               output: OutputFile) -> None:
+    """Defines the field table used to encode and decode a message struct."""
+    namespace = message.cpp_namespace(root)
+    struct_type = f'::{message.cpp_namespace()}::Message'
+
+    output.write_line(f'namespace {namespace} {{')
+
+    fields = sorted(message.fields(), key=lambda field: field.number())
+    if fields:
+        output.write_line(f'inline constexpr {_STRUCT_CODEC_NAMESPACE}::'
+                          'StructField kStructFields[] = {')
+        with output.indent():
+            for field in fields:
+                member_type = _struct_member_type(field)
+                struct_field_type = _STRUCT_FIELD_TYPES[field.type()][0]
+
+                values = 'nullptr'
+                element_type = member_type
+                if field.is_repeated():
+                    values = (f'&{_STRUCT_CODEC_NAMESPACE}::'
+                              f'kVectorOps<{member_type}>')
+                    element_type = f'{member_type}::value_type'
+
+                byte_vector = 'nullptr'
+                if struct_field_type in ('kString', 'kBytes'):
+                    byte_vector = (f'&{_STRUCT_CODEC_NAMESPACE}::'
+                                   f'kVectorOps<{element_type}>')
+
+                submessage = 'nullptr'
+                if struct_field_type == 'kMessage':
+                    type_node = field.type_node()
+                    assert type_node is not None
+                    submessage = (f'&::{type_node.cpp_namespace()}::'
+                                  'kStructDescriptor')
+
+                packed = 'true' if field.is_packed() else 'false'
+                repeated = 'true' if field.is_repeated() else 'false'
+                output.write_line('{')
+                with output.indent():
+                    output.write_line(f'{field.number()},')
+                    output.write_line(f'{_STRUCT_CODEC_NAMESPACE}::'
+                                      f'StructFieldType::{struct_field_type},')
+                    output.write_line(f'{repeated},')
+                    output.write_line(f'{packed},')
+                    output.write_line(
+                        f'offsetof({struct_type}, {field.field_name()}),')
+                    output.write_line(f'{values},')
+                    output.write_line(f'{byte_vector},')
+                    output.write_line(f'{submessage},')
+                output.write_line('},')
+        output.write_line('};')
+        output.write_line()
+        output.write_line(f'inline constexpr {_STRUCT_CODEC_NAMESPACE}::'
+                          'MessageDescriptor kStructDescriptor = '
+                          '{kStructFields};')
+    else:
+        output.write_line(f'inline constexpr {_STRUCT_CODEC_NAMESPACE}::'
+                          'MessageDescriptor kStructDescriptor = {};')
+
+    output.write_line(f'}}  // namespace {namespace}')
+
+
+def define_struct_methods(message: ProtoMessage, root: ProtoNode,
+                          output: OutputFile) -> None:
+    """Defines the Encode and Decode functions of a message struct."""
+    namespace = message.cpp_namespace(root)
+    descriptor = f'::{message.cpp_namespace()}::kStructDescriptor'
+
+    output.write_line()
+    output.write_line(f'inline ::pw::Status {namespace}::Message::Decode('
+                      '::pw::ConstByteSpan serialized_message) {')
+    with output.indent():
+        output.write_line(f'return {_STRUCT_CODEC_NAMESPACE}::DecodeStruct('
+                          f'{descriptor}, serialized_message, this);')
+    output.write_line('}')
+
+    output.write_line()
+    output.write_line(
+        f'inline ::pw::StatusWithSize {namespace}::Message::Encode('
+        '::pw::ByteSpan output_buffer) const {')
+    with output.indent():
+        output.write_line(f'return {_STRUCT_CODEC_NAMESPACE}::EncodeStruct('
+                          f'{descriptor}, this, output_buffer);')
+    output.write_line('}')
+
+    output.write_line()
+    output.write_line(
+        f'inline size_t {namespace}::Message::EncodedSize() const {{')
+    with output.indent():
+        output.write_line(f'return {_STRUCT_CODEC_NAMESPACE}::'
+                          f'StructEncodedSize({descriptor}, this);')
+    output.write_line('}')
+
+
+def generate_structs(package: ProtoNode, messages: List[ProtoMessage],
+                     output: OutputFile) -> None:
+    """Generates message structs and their field tables."""
+    if not messages:
+        return
+
+    for message in messages:
+        output.write_line()
+        generate_struct_for_message(message, package, output)
+
+    # The structs contain members which are not standard layout, so offsetof
+    # is conditionally supported. GCC and Clang support it for types without
+    # virtual bases, which is all that is needed here.
+    output.write_line()
+    output.write_line('PW_MODIFY_DIAGNOSTICS_PUSH();')
+    output.write_line('PW_MODIFY_DIAGNOSTIC(ignored, "-Winvalid-offsetof");')
+    for message in messages:
+        output.write_line()
+        generate_struct_descriptor(message, package, output)
+    output.write_line()
+    output.write_line('PW_MODIFY_DIAGNOSTICS_POP();')
+
+    for message in messages:
+        define_struct_methods(message, package, output)
+
+
 def generate_code_for_message(message: ProtoMessage, root: ProtoNode,
                               output: OutputFile,
                               encoder_type: EncoderType) -> None:
@@ -637,8 +919,8 @@ def generate_code_for_enum(proto_enum: ProtoEnum, root: ProtoNode,
     output.write_line('};')
 
 
-def forward_declare(node: ProtoMessage, root: ProtoNode,
-                    output: OutputFile) -> None:
+def forward_declare(node: ProtoMessage, root: ProtoNode, output: OutputFile,
+                    has_struct: bool) -> None:
     """Generates code forward-declaring entities in a message's namespace."""
     namespace = node.cpp_namespace(root)
     output.write_line()
@@ -655,6 +937,8 @@ def forward_declare(node: ProtoMessage, root: ProtoNode,
     output.write_line()
     output.write_line('class StreamEncoder;')
     output.write_line('class MemoryEncoder;')
+    if has_struct:
+        output.write_line('struct Message;')
 
     for child in node.children():
         if child.type() == ProtoNode.Type.ENUM:
@@ -700,7 +984,14 @@ def generate_code_for_package(file_descriptor_proto, package: ProtoNode,
     output.write_line('#include <cstdint>')
     output.write_line('#include <span>')
     output.write_line('#include <string_view>\n')
+    output.write_line('#include "pw_bytes/span.h"')
+    output.write_line('#include "pw_containers/vector.h"')
+    output.write_line('#include "pw_preprocessor/compiler.h"')
+    output.write_line('#include "pw_protobuf/config.h"')
     output.write_line('#include "pw_protobuf/encoder.h"')
+    output.write_line('#include "pw_protobuf/internal/struct_codec.h"')
+    output.write_line('#include "pw_status/status.h"')
+    output.write_line('#include "pw_status/status_with_size.h"')
 
     for imported_file in file_descriptor_proto.dependency:
         generated_header = _proto_filename_to_generated_header(imported_file)
@@ -713,9 +1004,12 @@ def generate_code_for_package(file_descriptor_proto, package: ProtoNode,
 
         output.write_line(f'\nnamespace {file_namespace} {{')
 
+    struct_messages = _struct_messages(package)
+
     for node in package:
         if node.type() == ProtoNode.Type.MESSAGE:
-            forward_declare(cast(ProtoMessage, node), package, output)
+            forward_declare(cast(ProtoMessage, node), package, output,
+                            node in struct_messages)
 
     # Define all top-level enums.
     for node in package.children():
@@ -725,6 +1019,7 @@ def generate_code_for_package(file_descriptor_proto, package: ProtoNode,
 
     generate_encoder_wrappers(package, EncoderType.STREAMING, output)
     generate_encoder_wrappers(package, EncoderType.MEMORY, output)
+    generate_structs(package, struct_messages, output)
 
     if package.cpp_namespace():
         output.write_line(f'\n}}  // namespace {package.cpp_namespace()}')
@@ -282,16 +282,21 @@ class ProtoMessageField:
                  field_number: int,
                  field_type: int,
                  type_node: Optional[ProtoNode] = None,
-                 repeated: bool = False):
+                 repeated: bool = False,
+                 packed: bool = False):
         self._field_name = field_name
         self._number: int = field_number
         self._type: int = field_type
         self._type_node: Optional[ProtoNode] = type_node
         self._repeated: bool = repeated
+        self._packed: bool = packed
 
     def name(self) -> str:
         return self.upper_camel_case(self._field_name)
 
+    def field_name(self) -> str:
+        return self._field_name
+
     def enum_name(self) -> str:
         return self.upper_snake_case(self._field_name)
 
@@ -307,6 +312,10 @@ class ProtoMessageField:
     def is_repeated(self) -> bool:
         return self._repeated
 
+    def is_packed(self) -> bool:
+        """Whether a repeated scalar field uses the packed encoding."""
+        return self._packed
+
     @staticmethod
     def upper_camel_case(field_name: str) -> str:
         """Converts a field name to UpperCamelCase."""
@@ -411,7 +420,8 @@ def _find_or_create_node(global_root: ProtoNode, package_root: ProtoNode,
 
 
 def _add_message_fields(global_root: ProtoNode, package_root: ProtoNode,
-                        message: ProtoNode, proto_message) -> None:
+                        message: ProtoNode, proto_message,
+                        proto3: bool) -> None:
     """Adds fields from a protobuf message descriptor to a message node."""
     assert message.type() == ProtoNode.Type.MESSAGE
     message = cast(ProtoMessage, message)
@@ -430,6 +440,19 @@ def _add_message_fields(global_root: ProtoNode, package_root: ProtoNode,
 
         repeated = \
             field.label == descriptor_pb2.FieldDescriptorProto.LABEL_REPEATED
+
+        # Repeated scalars are packed by default in proto3 but not in proto2.
+        # Other types cannot be packed.
+        if field.type in (descriptor_pb2.FieldDescriptorProto.TYPE_STRING,
+                          descriptor_pb2.FieldDescriptorProto.TYPE_BYTES,
+                          descriptor_pb2.FieldDescriptorProto.TYPE_MESSAGE,
+                          descriptor_pb2.FieldDescriptorProto.TYPE_GROUP):
+            packed = False
+        elif field.options.HasField('packed'):
+            packed = field.options.packed
+        else:
+            packed = proto3
+
         message.add_field(
             ProtoMessageField(
                 field.name,
@@ -437,6 +460,7 @@ def _add_message_fields(global_root: ProtoNode, package_root: ProtoNode,
                 field.type,
                 type_node,
                 repeated,
+                repeated and packed,
             ))
 
 
@@ -470,7 +494,8 @@ def _populate_fields(proto_file, global_root: ProtoNode,
     """Traverses a proto file, adding all message and enum fields to a tree."""
     def populate_message(node, message):
         """Recursively populates nested messages and enums."""
-        _add_message_fields(global_root, package_root, node, message)
+        _add_message_fields(global_root, package_root, node, message,
+                            proto_file.syntax == 'proto3')
 
         for proto_enum in message.enum_type:
             _add_enum_fields(node.find(proto_enum.name), proto_enum)
@@ -14,12 +14,26 @@
 
 #include "pw_protobuf/stream_decoder.h"
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
 #include "pw_assert/check.h"
 #include "pw_status/status_with_size.h"
 #include "pw_status/try.h"
 #include "pw_varint/varint.h"
 
 namespace pw::protobuf {
+namespace {
+
+// Packed varint fields are read from the stream in blocks of this size and
+// decoded from memory.
+constexpr size_t kPackedVarintBlockSize = 64;
+
+// Maximum number of values decoded from a block at once.
+constexpr size_t kPackedVarintBatchSize = 16;
+
+}  // namespace
 
 Status StreamDecoder::BytesReader::DoSeek(ssize_t offset, Whence origin) {
   PW_TRY(status_);
@@ -358,6 +372,191 @@ StatusWithSize StreamDecoder::ReadDelimitedField(std::span<std::byte> out) {
   return StatusWithSize(result.value().size());
 }
 
+StatusWithSize StreamDecoder::ReadPackedFixedField(std::span<std::byte> out,
+                                                   size_t elem_size) {
+  PW_DCHECK(elem_size == sizeof(uint32_t) || elem_size == sizeof(uint64_t));
+
+  // Unpacked fields hold a single value.
+  const WireType unpacked_type =
+      elem_size == sizeof(uint32_t) ? WireType::kFixed32 : WireType::kFixed64;
+  if (!field_consumed_ && current_field_.wire_type() == unpacked_type) {
+    if (out.size() < elem_size) {
+      return StatusWithSize::ResourceExhausted();
+    }
+    if (Status status = ReadFixedField(out.first(elem_size)); !status.ok()) {
+      return StatusWithSize(status, 0);
+    }
+    out = out.first(elem_size);
+  } else {
+    if (Status status = CheckOkToRead(WireType::kDelimited); !status.ok()) {
+      return StatusWithSize(status, 0);
+    }
+
+    if (delimited_field_size_ % elem_size != 0u ||
+        reader_.ConservativeReadLimit() < delimited_field_size_) {
+      status_ = Status::DataLoss();
+      return StatusWithSize(status_, 0);
+    }
+
+    if (out.size() < delimited_field_size_) {
+      return StatusWithSize::ResourceExhausted();
+    }
+
+    // Read the whole field directly into the output.
+    out = out.first(delimited_field_size_);
+    for (size_t read = 0; read < out.size();) {
+      Result<ByteSpan> result = reader_.Read(out.subspan(read));
+      if (!result.ok()) {
+        return StatusWithSize(result.status(), 0);
+      }
+      if (result.value().empty()) {
+        status_ = Status::DataLoss();
+        return StatusWithSize(status_, 0);
+      }
+      read += result.value().size();
+    }
+    field_consumed_ = true;
+  }
+
+  // The wire format is little endian; fix up the values in place if needed.
+  if constexpr (std::endian::native != std::endian::little) {
+    for (size_t i = 0; i < out.size(); i += elem_size) {
+      std::reverse(out.begin() + i, out.begin() + i + elem_size);
+    }
+  }
+
+  return StatusWithSize(out.size() / elem_size);
+}
+
+StatusWithSize StreamDecoder::ReadPackedVarintField(
+    std::span<std::byte> out, size_t elem_size, VarintDecodeType decode_type) {
+  PW_DCHECK(elem_size == sizeof(uint32_t) || elem_size == sizeof(uint64_t));
+
+  const size_t capacity = out.size() / elem_size;
+
+  // Converts a varint to the element type and stores it. Returns false if the
+  // value doesn't fit.
+  auto store = [&](size_t index, uint64_t value) {
+    std::byte* element = out.data() + index * elem_size;
+
+    if (elem_size == sizeof(uint64_t)) {
+      if (decode_type == VarintDecodeType::kZigZag) {
+        value = static_cast<uint64_t>(varint::ZigZagDecode(value));
+      }
+      std::memcpy(element, &value, sizeof(value));
+      return true;
+    }
+
+    if (decode_type == VarintDecodeType::kUnsigned) {
+      if (value > std::numeric_limits<uint32_t>::max()) {
+        return false;
+      }
+      const uint32_t narrowed = static_cast<uint32_t>(value);
+      std::memcpy(element, &narrowed, sizeof(narrowed));
+      return true;
+    }
+
+    const int64_t signed_value = decode_type == VarintDecodeType::kZigZag
+                                     ? varint::ZigZagDecode(value)
+                                     : static_cast<int64_t>(value);
+    if (signed_value > std::numeric_limits<int32_t>::max() ||
+        signed_value < std::numeric_limits<int32_t>::min()) {
+      return false;
+    }
+    const int32_t narrowed = static_cast<int32_t>(signed_value);
+    std::memcpy(element, &narrowed, sizeof(narrowed));
+    return true;
+  };
+
+  // Unpacked fields hold a single value.
+  if (!field_consumed_ && current_field_.wire_type() == WireType::kVarint) {
+    if (capacity == 0u) {
+      return StatusWithSize::ResourceExhausted();
+    }
+    uint64_t value = 0;
+    if (Status status = ReadVarintField(&value); !status.ok()) {
+      return StatusWithSize(status, 0);
+    }
+    return store(0, value) ? StatusWithSize(1) : StatusWithSize::OutOfRange();
+  }
+
+  if (Status status = CheckOkToRead(WireType::kDelimited); !status.ok()) {
+    return StatusWithSize(status, 0);
+  }
+
+  if (reader_.ConservativeReadLimit() < delimited_field_size_) {
+    status_ = Status::DataLoss();
+    return StatusWithSize(status_, 0);
+  }
+
+  std::array<std::byte, kPackedVarintBlockSize> block;
+  std::array<uint64_t, kPackedVarintBatchSize> values;
+  size_t block_size = 0;  // Bytes in the block that have not been decoded.
+  size_t field_remaining = delimited_field_size_;  // Bytes left in the stream.
+  size_t count = 0;
+
+  while (field_remaining > 0u || block_size > 0u) {
+    // Top up the block from the stream.
+    if (field_remaining > 0u && block_size < block.size()) {
+      Result<ByteSpan> result = reader_.Read(std::span(block).subspan(
+          block_size, std::min(field_remaining, block.size() - block_size)));
+      if (!result.ok()) {
+        return StatusWithSize(result.status(), count);
+      }
+      if (result.value().empty()) {
+        status_ = Status::DataLoss();
+        return StatusWithSize(status_, count);
+      }
+      block_size += result.value().size();
+      field_remaining -= result.value().size();
+    }
+
+    if (count == capacity) {
+      // The output is full but the field has more values. Return to the start
+      // of the field so that it can be read again with a larger buffer.
+      if (Status status = reader_.Seek(delimited_field_offset_); !status.ok()) {
+        status_ = status;
+        return StatusWithSize(status_, 0);
+      }
+      return StatusWithSize::ResourceExhausted();
+    }
+
+    size_t bytes_decoded = 0;
+    const size_t decoded = varint::DecodeMany(
+        std::span(block).first(block_size),
+        std::span(values).first(std::min(values.size(), capacity - count)),
+        &bytes_decoded);
+
+    // A varint that can't be decoded from a full block, or that runs past the
+    // end of the field, is invalid.
+    const bool block_full = block_size == block.size();
+    if (decoded == 0u && (field_remaining == 0u || block_full)) {
+      status_ = Status::DataLoss();
+      return StatusWithSize(status_, count);
+    }
+
+    for (size_t i = 0; i < decoded; ++i) {
+      if (!store(count, values[i])) {
+        // Like the single-value reads, consume the field on a range error.
+        status_ = reader_.Seek(delimited_field_offset_ + delimited_field_size_);
+        if (!status_.ok()) {
+          return StatusWithSize(status_, count);
+        }
+        field_consumed_ = true;
+        return StatusWithSize::OutOfRange(count);
+      }
+      count += 1;
+    }
+
+    // Keep any partial varint at the end of the block for the next read.
+    block_size -= bytes_decoded;
+    std::memmove(block.data(), block.data() + bytes_decoded, block_size);
+  }
+
+  field_consumed_ = true;
+  return StatusWithSize(count);
+}
+
 StatusWithSize StreamDecoder::ReadVarint(uint64_t* output) {
   uint64_t value = 0;
   size_t count = 0;
@@ -14,8 +14,12 @@
 
 #include "pw_protobuf/stream_decoder.h"
 
+#include <array>
+#include <cstring>
+
 #include "gtest/gtest.h"
 #include "pw_stream/memory_stream.h"
+#include "pw_varint/varint.h"
 
 namespace pw::protobuf {
 namespace {
@@ -546,5 +550,225 @@ TEST(StreamDecoder, GetLengthDelimitedPayloadBounds) {
             decoder.GetLengthDelimitedPayloadBounds().status());
 }
 
+TEST(StreamDecoder, PackedVarint) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=repeated uint32, k=1, v={0, 50, 100, 150, 200}
+    0x0a, 0x07, 0x00, 0x32, 0x64, 0x96, 0x01, 0xc8, 0x01,
+    // type=repeated sint32, k=2, v={-1, 1, -64}
+    0x12, 0x03, 0x01, 0x02, 0x7f,
+    // type=repeated int32, k=3, v={-1}
+    0x1a, 0x0a, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(std::as_bytes(std::span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  std::array<uint32_t, 8> uint32s;
+  StatusWithSize sws = decoder.ReadPackedUint32(uint32s);
+  ASSERT_EQ(sws.status(), OkStatus());
+  ASSERT_EQ(sws.size(), 5u);
+  EXPECT_EQ(uint32s[0], 0u);
+  EXPECT_EQ(uint32s[1], 50u);
+  EXPECT_EQ(uint32s[2], 100u);
+  EXPECT_EQ(uint32s[3], 150u);
+  EXPECT_EQ(uint32s[4], 200u);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  std::array<int32_t, 3> sint32s;
+  sws = decoder.ReadPackedSint32(sint32s);
+  ASSERT_EQ(sws.status(), OkStatus());
+  ASSERT_EQ(sws.size(), 3u);
+  EXPECT_EQ(sint32s[0], -1);
+  EXPECT_EQ(sint32s[1], 1);
+  EXPECT_EQ(sint32s[2], -64);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  std::array<int32_t, 1> int32s;
+  sws = decoder.ReadPackedInt32(int32s);
+  ASSERT_EQ(sws.status(), OkStatus());
+  ASSERT_EQ(sws.size(), 1u);
+  EXPECT_EQ(int32s[0], -1);
+
+  EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+}
+
+TEST(StreamDecoder, PackedVarint_SpansManyBlocks) {
+  // Values of varying sizes so that varints cross the block boundaries.
+  constexpr size_t kValues = 1000;
+  std::array<std::byte, 4 + kValues * varint::kMaxVarint64SizeBytes> buffer;
+  size_t size = 4;  // Leave room for the key and a 3-byte length.
+  for (size_t i = 0; i < kValues; ++i) {
+    size += varint::Encode(uint64_t(i) << (i % 64),
+                           std::span(buffer).subspan(size));
+  }
+  const size_t length = size - 4;
+  buffer[0] = std::byte{0x0a};  // k=1, delimited
+  buffer[1] = std::byte(0x80 | (length & 0x7f));
+  buffer[2] = std::byte(0x80 | ((length >> 7) & 0x7f));
+  buffer[3] = std::byte(length >> 14);
+
+  stream::MemoryReader reader{std::span(buffer).first(size)};
+  StreamDecoder decoder(reader);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  std::array<uint64_t, kValues> values;
+  StatusWithSize sws = decoder.ReadPackedUint64(values);
+  ASSERT_EQ(sws.status(), OkStatus());
+  ASSERT_EQ(sws.size(), kValues);
+  for (size_t i = 0; i < kValues; ++i) {
+    EXPECT_EQ(values[i], uint64_t(i) << (i % 64));
+  }
+
+  EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+}
+
+TEST(StreamDecoder, PackedVarint_BufferTooSmall_CanReadAgain) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=repeated uint32, k=1, v={1, 2, 3}
+    0x0a, 0x03, 0x01, 0x02, 0x03,
+    // type=uint32, k=2, v=4
+    0x10, 0x04,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(std::as_bytes(std::span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  std::array<uint32_t, 2> small;
+  EXPECT_EQ(decoder.ReadPackedUint32(small).status(),
+            Status::ResourceExhausted());
+
+  std::array<uint32_t, 3> values;
+  StatusWithSize sws = decoder.ReadPackedUint32(values);
+  ASSERT_EQ(sws.status(), OkStatus());
+  ASSERT_EQ(sws.size(), 3u);
+  EXPECT_EQ(values[2], 3u);
+
+  // Unpacked values are read as a single element.
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  sws = decoder.ReadPackedUint32(values);
+  ASSERT_EQ(sws.status(), OkStatus());
+  ASSERT_EQ(sws.size(), 1u);
+  EXPECT_EQ(values[0], 4u);
+
+  EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+}
+
+TEST(StreamDecoder, PackedVarint_ValueOutOfRange) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=repeated uint32, k=1, v={1, 2^32}
+    0x0a, 0x06, 0x01, 0x80, 0x80, 0x80, 0x80, 0x10,
+    // type=uint32, k=2, v=4
+    0x10, 0x04,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(std::as_bytes(std::span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  std::array<uint32_t, 2> values;
+  StatusWithSize sws = decoder.ReadPackedUint32(values);
+  EXPECT_EQ(sws.status(), Status::OutOfRange());
+  EXPECT_EQ(sws.size(), 1u);
+
+  // The field is consumed.
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.FieldNumber().value(), 2u);
+}
+
+TEST(StreamDecoder, PackedVarint_Truncated) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=repeated uint32, k=1, v={1, <truncated>}
+    0x0a, 0x02, 0x01, 0x80,
+    // type=uint32, k=2, v=4
+    0x10, 0x04,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(std::as_bytes(std::span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  std::array<uint32_t, 2> values;
+  EXPECT_EQ(decoder.ReadPackedUint32(values).status(), Status::DataLoss());
+  EXPECT_EQ(decoder.Next(), Status::DataLoss());
+}
+
+TEST(StreamDecoder, PackedFixed) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=repeated fixed32, k=1, v={0xdeadbeef, 1}
+    0x0a, 0x08, 0xef, 0xbe, 0xad, 0xde, 0x01, 0x00, 0x00, 0x00,
+    // type=repeated float, k=2, v={1.5, -2.0}
+    0x12, 0x08, 0x00, 0x00, 0xc0, 0x3f, 0x00, 0x00, 0x00, 0xc0,
+    // type=repeated double, k=3, v={3.14159}
+    0x1a, 0x08, 0x6e, 0x86, 0x1b, 0xf0, 0xf9, 0x21, 0x09, 0x40,
+    // type=fixed32, k=4, v=7
+    0x25, 0x07, 0x00, 0x00, 0x00,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(std::as_bytes(std::span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  std::array<uint32_t, 4> fixed32s;
+  StatusWithSize sws = decoder.ReadPackedFixed32(fixed32s);
+  ASSERT_EQ(sws.status(), OkStatus());
+  ASSERT_EQ(sws.size(), 2u);
+  EXPECT_EQ(fixed32s[0], 0xdeadbeef);
+  EXPECT_EQ(fixed32s[1], 1u);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  std::array<float, 2> floats;
+  sws = decoder.ReadPackedFloat(floats);
+  ASSERT_EQ(sws.status(), OkStatus());
+  ASSERT_EQ(sws.size(), 2u);
+  EXPECT_EQ(floats[0], 1.5f);
+  EXPECT_EQ(floats[1], -2.0f);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  std::array<double, 1> doubles;
+  EXPECT_EQ(decoder.ReadPackedDouble(std::span(doubles).first(0)).status(),
+            Status::ResourceExhausted());
+  sws = decoder.ReadPackedDouble(doubles);
+  ASSERT_EQ(sws.status(), OkStatus());
+  ASSERT_EQ(sws.size(), 1u);
+  EXPECT_EQ(doubles[0], 3.14159);
+
+  // Unpacked values are read as a single element.
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  sws = decoder.ReadPackedFixed32(fixed32s);
+  ASSERT_EQ(sws.status(), OkStatus());
+  ASSERT_EQ(sws.size(), 1u);
+  EXPECT_EQ(fixed32s[0], 7u);
+
+  EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+}
+
+TEST(StreamDecoder, PackedFixed_InvalidLength) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=repeated fixed32, k=1, length not a multiple of 4
+    0x0a, 0x03, 0x01, 0x02, 0x03,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(std::as_bytes(std::span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  std::array<uint32_t, 4> values;
+  EXPECT_EQ(decoder.ReadPackedFixed32(values).status(), Status::DataLoss());
+}
+
 }  // namespace
 }  // namespace pw::protobuf
@@ -0,0 +1,659 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_protobuf/internal/struct_codec.h"
+
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#include "pw_bytes/endian.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
+
+namespace pw::protobuf::internal {
+namespace {
+
+using Type = StructFieldType;
+
+WireType WireTypeOf(Type type) {
+  switch (type) {
+    case Type::kFixed32:
+    case Type::kSfixed32:
+    case Type::kFloat:
+      return WireType::kFixed32;
+    case Type::kFixed64:
+    case Type::kSfixed64:
+    case Type::kDouble:
+      return WireType::kFixed64;
+    case Type::kString:
+    case Type::kBytes:
+    case Type::kMessage:
+      return WireType::kDelimited;
+    default:
+      return WireType::kVarint;
+  }
+}
+
+bool IsScalar(Type type) { return WireTypeOf(type) != WireType::kDelimited; }
+
+// The size of a scalar value in its struct member.
+size_t ScalarSize(Type type) {
+  switch (type) {
+    case Type::kBool:
+      return sizeof(bool);
+    case Type::kUint64:
+    case Type::kInt64:
+    case Type::kSint64:
+    case Type::kFixed64:
+    case Type::kSfixed64:
+    case Type::kDouble:
+      return sizeof(uint64_t);
+    default:
+      return sizeof(uint32_t);
+  }
+}
+
+template <typename T>
+T Load(const std::byte* member) {
+  T value;
+  std::memcpy(&value, member, sizeof(value));
+  return value;
+}
+
+template <typename T>
+void Store(T value, std::byte* member) {
+  std::memcpy(member, &value, sizeof(value));
+}
+
+// Returns the wire value of a varint scalar member.
+uint64_t LoadVarint(Type type, const std::byte* member) {
+  switch (type) {
+    case Type::kUint32:
+      return Load<uint32_t>(member);
+    case Type::kInt32:
+    case Type::kEnum:
+      // Negative values are sign-extended to 64 bits, per the protobuf spec.
+      return static_cast<uint64_t>(int64_t{Load<int32_t>(member)});
+    case Type::kSint32:
+      return varint::ZigZagEncode(Load<int32_t>(member));
+    case Type::kInt64:
+      return static_cast<uint64_t>(Load<int64_t>(member));
+    case Type::kSint64:
+      return varint::ZigZagEncode(Load<int64_t>(member));
+    case Type::kBool:
+      return Load<bool>(member) ? 1 : 0;
+    default:
+      return Load<uint64_t>(member);
+  }
+}
+
+// Stores a decoded varint in a scalar member. Returns false if the value does
+// not fit in the member's type.
+bool StoreVarint(Type type, uint64_t value, std::byte* member) {
+  switch (type) {
+    case Type::kUint32:
+      if (value > std::numeric_limits<uint32_t>::max()) {
+        return false;
+      }
+      Store(static_cast<uint32_t>(value), member);
+      return true;
+    case Type::kInt32:
+    case Type::kEnum: {
+      const int64_t signed_value = static_cast<int64_t>(value);
+      if (signed_value > std::numeric_limits<int32_t>::max() ||
+          signed_value < std::numeric_limits<int32_t>::min()) {
+        return false;
+      }
+      Store(static_cast<int32_t>(signed_value), member);
+      return true;
+    }
+    case Type::kSint32: {
+      const int64_t signed_value = varint::ZigZagDecode(value);
+      if (signed_value > std::numeric_limits<int32_t>::max() ||
+          signed_value < std::numeric_limits<int32_t>::min()) {
+        return false;
+      }
+      Store(static_cast<int32_t>(signed_value), member);
+      return true;
+    }
+    case Type::kSint64:
+      Store(varint::ZigZagDecode(value), member);
+      return true;
+    case Type::kBool:
+      Store(value != 0u, member);
+      return true;
+    default:
+      Store(value, member);
+      return true;
+  }
+}
+
+// Fixed-size scalars are stored in the struct in native byte order and on the
+// wire in little-endian order.
+void LoadFixed(Type type, const std::byte* member, std::byte* out) {
+  if (ScalarSize(type) == sizeof(uint32_t)) {
+    const auto bytes =
+        bytes::CopyInOrder(std::endian::little, Load<uint32_t>(member));
+    std::memcpy(out, bytes.data(), bytes.size());
+  } else {
+    const auto bytes =
+        bytes::CopyInOrder(std::endian::little, Load<uint64_t>(member));
+    std::memcpy(out, bytes.data(), bytes.size());
+  }
+}
+
+void StoreFixed(Type type, const std::byte* in, std::byte* member) {
+  if (ScalarSize(type) == sizeof(uint32_t)) {
+    Store(bytes::ReadInOrder<uint32_t>(std::endian::little, in), member);
+  } else {
+    Store(bytes::ReadInOrder<uint64_t>(std::endian::little, in), member);
+  }
+}
+
+bool IsZero(Type type, const std::byte* member) {
+  const size_t size = ScalarSize(type);
+  for (size_t i = 0; i < size; ++i) {
+    if (member[i] != std::byte{0}) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t KeySize(const StructField& field, WireType wire_type) {
+  return varint::EncodedSize(FieldKey(field.field_number, wire_type));
+}
+
+// The size of one scalar value on the wire, without its key.
+size_t ScalarWireSize(Type type, const std::byte* member) {
+  switch (WireTypeOf(type)) {
+    case WireType::kFixed32:
+      return sizeof(uint32_t);
+    case WireType::kFixed64:
+      return sizeof(uint64_t);
+    default:
+      return varint::EncodedSize(LoadVarint(type, member));
+  }
+}
+
+// The size of a delimited value on the wire, without its key and length.
+size_t DelimitedPayloadSize(const StructField& field, const std::byte* value) {
+  if (field.type == Type::kMessage) {
+    return StructEncodedSize(*field.message, value);
+  }
+  return field.bytes->size(value);
+}
+
+size_t PackedPayloadSize(const StructField& field,
+                         const std::byte* values,
+                         size_t count) {
+  if (WireTypeOf(field.type) != WireType::kVarint) {
+    return count * ScalarWireSize(field.type, values);
+  }
+
+  const size_t element_size = field.values->element_size;
+  size_t size = 0;
+  for (size_t i = 0; i < count; ++i) {
+    size += ScalarWireSize(field.type, values + i * element_size);
+  }
+  return size;
+}
+
+// Writes to a buffer, tracking whether it has run out of space.
+class Output {
+ public:
+  constexpr Output(ByteSpan buffer) : buffer_(buffer), size_(0) {}
+
+  bool WriteVarint(uint64_t value) {
+    const size_t written = varint::Encode(value, buffer_.subspan(size_));
+    size_ += written;
+    return written != 0u;
+  }
+
+  bool WriteKey(uint32_t field_number, WireType wire_type) {
+    return WriteVarint(FieldKey(field_number, wire_type));
+  }
+
+  // Reserves space for a value, returning nullptr if it does not fit.
+  std::byte* Reserve(size_t size) {
+    if (size > buffer_.size() - size_) {
+      return nullptr;
+    }
+    std::byte* data = buffer_.data() + size_;
+    size_ += size;
+    return data;
+  }
+
+  ByteSpan remaining() const { return buffer_.subspan(size_); }
+  void Advance(size_t size) { size_ += size; }
+
+  size_t size() const { return size_; }
+
+ private:
+  ByteSpan buffer_;
+  size_t size_;
+};
+
+// Writes one scalar value without its key.
+bool WriteScalar(Type type, const std::byte* member, Output& output) {
+  const WireType wire_type = WireTypeOf(type);
+  if (wire_type == WireType::kVarint) {
+    return output.WriteVarint(LoadVarint(type, member));
+  }
+
+  std::byte* out = output.Reserve(wire_type == WireType::kFixed32
+                                      ? sizeof(uint32_t)
+                                      : sizeof(uint64_t));
+  if (out == nullptr) {
+    return false;
+  }
+  LoadFixed(type, member, out);
+  return true;
+}
+
+// Writes one string, bytes, or message value with its key and length.
+bool WriteDelimited(const StructField& field,
+                    const std::byte* value,
+                    Output& output) {
+  const size_t payload_size = DelimitedPayloadSize(field, value);
+  if (!output.WriteKey(field.field_number, WireType::kDelimited) ||
+      !output.WriteVarint(payload_size)) {
+    return false;
+  }
+
+  if (field.type == Type::kMessage) {
+    const StatusWithSize result =
+        EncodeStruct(*field.message, value, output.remaining());
+    output.Advance(result.size());
+    return result.ok();
+  }
+
+  std::byte* out = output.Reserve(payload_size);
+  if (out == nullptr) {
+    return false;
+  }
+  std::memcpy(out,
+              field.bytes->data(const_cast<std::byte*>(value)),
+              payload_size);
+  return true;
+}
+
+bool WriteField(const StructField& field,
+                const std::byte* member,
+                Output& output) {
+  if (!field.repeated) {
+    if (IsScalar(field.type)) {
+      return IsZero(field.type, member) ||
+             (output.WriteKey(field.field_number, WireTypeOf(field.type)) &&
+              WriteScalar(field.type, member, output));
+    }
+    return DelimitedPayloadSize(field, member) == 0u ||
+           WriteDelimited(field, member, output);
+  }
+
+  const size_t count = field.values->size(member);
+  const std::byte* values = field.values->data(const_cast<std::byte*>(member));
+  const size_t element_size = field.values->element_size;
+
+  if (count == 0u) {
+    return true;
+  }
+
+  if (IsScalar(field.type) && field.packed) {
+    if (!output.WriteKey(field.field_number, WireType::kDelimited) ||
+        !output.WriteVarint(PackedPayloadSize(field, values, count))) {
+      return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      if (!WriteScalar(field.type, values + i * element_size, output)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    const std::byte* value = values + i * element_size;
+    const bool written =
+        IsScalar(field.type)
+            ? output.WriteKey(field.field_number, WireTypeOf(field.type)) &&
+                  WriteScalar(field.type, value, output)
+            : WriteDelimited(field, value, output);
+    if (!written) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Finds a field by number. Fields are usually encoded in order, so the search
+// starts after the previously found field.
+const StructField* FindField(const MessageDescriptor& descriptor,
+                             uint32_t field_number,
+                             size_t& hint) {
+  const size_t count = descriptor.fields.size();
+  for (size_t i = 0; i < count; ++i) {
+    const size_t index = (hint + i) % count;
+    if (descriptor.fields[index].field_number == field_number) {
+      hint = index;
+      return &descriptor.fields[index];
+    }
+  }
+  return nullptr;
+}
+
+// Reads a varint from the front of data, advancing it.
+bool ReadVarint(ConstByteSpan& data, uint64_t* value) {
+  const size_t bytes_read = varint::Decode(data, value);
+  data = data.subspan(bytes_read);
+  return bytes_read != 0u;
+}
+
+// Reads a length-delimited payload from the front of data, advancing it.
+bool ReadDelimited(ConstByteSpan& data, ConstByteSpan* payload) {
+  uint64_t length;
+  if (!ReadVarint(data, &length) || length > data.size()) {
+    return false;
+  }
+  *payload = data.first(length);
+  data = data.subspan(length);
+  return true;
+}
+
+Status SkipField(WireType wire_type, ConstByteSpan& data) {
+  switch (wire_type) {
+    case WireType::kVarint: {
+      uint64_t value;
+      return ReadVarint(data, &value) ? OkStatus() : Status::DataLoss();
+    }
+    case WireType::kDelimited: {
+      ConstByteSpan payload;
+      return ReadDelimited(data, &payload) ? OkStatus() : Status::DataLoss();
+    }
+    case WireType::kFixed32:
+    case WireType::kFixed64: {
+      const size_t size = wire_type == WireType::kFixed32 ? sizeof(uint32_t)
+                                                          : sizeof(uint64_t);
+      if (data.size() < size) {
+        return Status::DataLoss();
+      }
+      data = data.subspan(size);
+      return OkStatus();
+    }
+  }
+  return Status::DataLoss();
+}
+
+// Reads one scalar value without its key from the front of data.
+Status ReadScalar(Type type, ConstByteSpan& data, std::byte* member) {
+  const WireType wire_type = WireTypeOf(type);
+  if (wire_type == WireType::kVarint) {
+    uint64_t value;
+    if (!ReadVarint(data, &value)) {
+      return Status::DataLoss();
+    }
+    return StoreVarint(type, value, member) ? OkStatus()
+                                            : Status::OutOfRange();
+  }
+
+  const size_t size =
+      wire_type == WireType::kFixed32 ? sizeof(uint32_t) : sizeof(uint64_t);
+  if (data.size() < size) {
+    return Status::DataLoss();
+  }
+  StoreFixed(type, data.data(), member);
+  data = data.subspan(size);
+  return OkStatus();
+}
+
+// Appends an element to a repeated field, returning nullptr if it is full.
+std::byte* Append(const StructField& field, std::byte* member) {
+  const size_t size = field.values->size(member);
+  if (!field.values->resize(member, size + 1)) {
+    return nullptr;
+  }
+  return field.values->data(member) + size * field.values->element_size;
+}
+
+// Decodes all values of a packed repeated scalar field.
+Status ReadPacked(const StructField& field,
+                  ConstByteSpan payload,
+                  std::byte* member) {
+  const WireType wire_type = WireTypeOf(field.type);
+
+  // Count the values first so that the vector is resized only once.
+  size_t count = 0;
+  if (wire_type == WireType::kVarint) {
+    for (std::byte b : payload) {
+      count += (b & std::byte{0x80}) == std::byte{0} ? 1 : 0;
+    }
+    if (!payload.empty() &&
+        (payload.back() & std::byte{0x80}) != std::byte{0}) {
+      return Status::DataLoss();
+    }
+  } else {
+    const size_t size =
+        wire_type == WireType::kFixed32 ? sizeof(uint32_t) : sizeof(uint64_t);
+    if (payload.size() % size != 0u) {
+      return Status::DataLoss();
+    }
+    count = payload.size() / size;
+  }
+
+  const size_t old_size = field.values->size(member);
+  if (!field.values->resize(member, old_size + count)) {
+    return Status::ResourceExhausted();
+  }
+
+  std::byte* values = field.values->data(member);
+  const size_t element_size = field.values->element_size;
+  for (size_t i = old_size; i < old_size + count; ++i) {
+    PW_TRY(ReadScalar(field.type, payload, values + i * element_size));
+  }
+  return OkStatus();
+}
+
+Status ReadBytes(const StructField& field,
+                 ConstByteSpan payload,
+                 std::byte* vector) {
+  if (!field.bytes->resize(vector, payload.size())) {
+    return Status::ResourceExhausted();
+  }
+  std::memcpy(field.bytes->data(vector), payload.data(), payload.size());
+  return OkStatus();
+}
+
+Status DecodeFields(const MessageDescriptor& descriptor,
+                    ConstByteSpan data,
+                    std::byte* message);
+
+Status ReadField(const StructField& field,
+                 WireType wire_type,
+                 ConstByteSpan& data,
+                 std::byte* member) {
+  if (IsScalar(field.type)) {
+    if (field.repeated && wire_type == WireType::kDelimited) {
+      ConstByteSpan payload;
+      if (!ReadDelimited(data, &payload)) {
+        return Status::DataLoss();
+      }
+      return ReadPacked(field, payload, member);
+    }
+
+    if (wire_type != WireTypeOf(field.type)) {
+      return Status::DataLoss();
+    }
+
+    if (!field.repeated) {
+      return ReadScalar(field.type, data, member);
+    }
+
+    // Read the value before appending it so that a failed read does not leave
+    // a default value in the vector.
+    std::byte value[sizeof(uint64_t)];
+    PW_TRY(ReadScalar(field.type, data, value));
+    std::byte* element = Append(field, member);
+    if (element == nullptr) {
+      return Status::ResourceExhausted();
+    }
+    std::memcpy(element, value, ScalarSize(field.type));
+    return OkStatus();
+  }
+
+  ConstByteSpan payload;
+  if (wire_type != WireType::kDelimited || !ReadDelimited(data, &payload)) {
+    return Status::DataLoss();
+  }
+
+  std::byte* value = member;
+  if (field.repeated) {
+    value = Append(field, member);
+    if (value == nullptr) {
+      return Status::ResourceExhausted();
+    }
+  }
+
+  if (field.type == Type::kMessage) {
+    return DecodeFields(*field.message, payload, value);
+  }
+  return ReadBytes(field, payload, value);
+}
+
+Status DecodeFields(const MessageDescriptor& descriptor,
+                    ConstByteSpan data,
+                    std::byte* message) {
+  size_t hint = 0;
+
+  while (!data.empty()) {
+    uint64_t key;
+    if (!ReadVarint(data, &key) || !FieldKey::IsValidKey(key)) {
+      return Status::DataLoss();
+    }
+
+    const FieldKey field_key(static_cast<uint32_t>(key));
+    const StructField* field =
+        FindField(descriptor, field_key.field_number(), hint);
+
+    if (field == nullptr) {
+      PW_TRY(SkipField(field_key.wire_type(), data));
+      continue;
+    }
+
+    PW_TRY(ReadField(
+        *field, field_key.wire_type(), data, message + field->offset));
+  }
+
+  return OkStatus();
+}
+
+void ClearFields(const MessageDescriptor& descriptor, std::byte* message) {
+  for (const StructField& field : descriptor.fields) {
+    std::byte* member = message + field.offset;
+
+    if (field.repeated) {
+      field.values->resize(member, 0);
+    } else if (IsScalar(field.type)) {
+      std::memset(member, 0, ScalarSize(field.type));
+    } else if (field.type == Type::kMessage) {
+      ClearFields(*field.message, member);
+    } else {
+      field.bytes->resize(member, 0);
+    }
+  }
+}
+
+}  // namespace
+
+size_t StructEncodedSize(const MessageDescriptor& descriptor,
+                         const void* message) {
+  const auto* base = static_cast<const std::byte*>(message);
+  size_t size = 0;
+
+  for (const StructField& field : descriptor.fields) {
+    const std::byte* member = base + field.offset;
+
+    if (!field.repeated) {
+      if (IsScalar(field.type)) {
+        if (!IsZero(field.type, member)) {
+          size += KeySize(field, WireTypeOf(field.type)) +
+                  ScalarWireSize(field.type, member);
+        }
+        continue;
+      }
+      const size_t payload_size = DelimitedPayloadSize(field, member);
+      if (payload_size != 0u) {
+        size += KeySize(field, WireType::kDelimited) +
+                varint::EncodedSize(payload_size) + payload_size;
+      }
+      continue;
+    }
+
+    const size_t count = field.values->size(member);
+    const std::byte* values =
+        field.values->data(const_cast<std::byte*>(member));
+    const size_t element_size = field.values->element_size;
+
+    if (count == 0u) {
+      continue;
+    }
+
+    if (IsScalar(field.type) && field.packed) {
+      const size_t payload_size = PackedPayloadSize(field, values, count);
+      size += KeySize(field, WireType::kDelimited) +
+              varint::EncodedSize(payload_size) + payload_size;
+      continue;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      const std::byte* value = values + i * element_size;
+      if (IsScalar(field.type)) {
+        size += KeySize(field, WireTypeOf(field.type)) +
+                ScalarWireSize(field.type, value);
+      } else {
+        const size_t payload_size = DelimitedPayloadSize(field, value);
+        size += KeySize(field, WireType::kDelimited) +
+                varint::EncodedSize(payload_size) + payload_size;
+      }
+    }
+  }
+
+  return size;
+}
+
+StatusWithSize EncodeStruct(const MessageDescriptor& descriptor,
+                            const void* message,
+                            ByteSpan buffer) {
+  const auto* base = static_cast<const std::byte*>(message);
+  Output output(buffer);
+
+  for (const StructField& field : descriptor.fields) {
+    if (!WriteField(field, base + field.offset, output)) {
+      return StatusWithSize::ResourceExhausted(output.size());
+    }
+  }
+
+  return StatusWithSize(output.size());
+}
+
+Status DecodeStruct(const MessageDescriptor& descriptor,
+                    ConstByteSpan data,
+                    void* message) {
+  auto* base = static_cast<std::byte*>(message);
+  ClearFields(descriptor, base);
+  return DecodeFields(descriptor, data, base);
+}
+
+}  // namespace pw::protobuf::internal
@@ -0,0 +1,315 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_stream/memory_stream.h"
+
+// The message structs tested here are generated by the pw_protobuf plugin.
+#include "pw_protobuf_test_protos/all_types.pwpb.h"
+#include "pw_protobuf_test_protos/full_test.pwpb.h"
+#include "pw_protobuf_test_protos/repeated.pwpb.h"
+
+namespace pw::protobuf {
+namespace {
+
+using namespace pw::protobuf::test;
+
+template <typename VectorType>
+void Assign(VectorType& vector, std::string_view value) {
+  vector.assign(value.begin(), value.end());
+}
+
+std::string_view AsString(const Vector<char>& vector) {
+  return std::string_view(vector.data(), vector.size());
+}
+
+bool Equal(ConstByteSpan lhs, ConstByteSpan rhs) {
+  return lhs.size() == rhs.size() &&
+         std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+TEST(StructCodec, EncodeMatchesEncoder) {
+  DeviceInfo::Message info;
+  Assign(info.device_name, "pixel");
+  info.device_id = 123;
+  info.status = DeviceInfo::DeviceStatus::PANIC;
+  info.attributes.emplace_back();
+  Assign(info.attributes.back().key, "version");
+  Assign(info.attributes.back().value, "5.3.1");
+  info.attributes.emplace_back();
+  Assign(info.attributes.back().key, "chip");
+  Assign(info.attributes.back().value, "left-soc");
+
+  std::byte struct_buffer[64];
+  const StatusWithSize result = info.Encode(struct_buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), info.EncodedSize());
+
+  std::byte encoder_buffer[64];
+  DeviceInfo::MemoryEncoder encoder(encoder_buffer);
+  encoder.WriteDeviceName("pixel")
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  encoder.WriteDeviceId(123)
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  encoder.WriteStatus(DeviceInfo::DeviceStatus::PANIC)
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  {
+    KeyValuePair::StreamEncoder attribute = encoder.GetAttributesEncoder();
+    attribute.WriteKey("version")
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    attribute.WriteValue("5.3.1")
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  }
+  {
+    KeyValuePair::StreamEncoder attribute = encoder.GetAttributesEncoder();
+    attribute.WriteKey("chip")
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    attribute.WriteValue("left-soc")
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  }
+  ASSERT_EQ(encoder.status(), OkStatus());
+
+  EXPECT_TRUE(Equal(std::span(struct_buffer, result.size()),
+                    ConstByteSpan(encoder)));
+}
+
+TEST(StructCodec, RepeatedMatchesEncoder) {
+  RepeatedTest::Message repeated;
+  repeated.uint32s = {0, 50, 100, 150};
+  repeated.sint32s = {-5, 0, 5};
+  repeated.strings.emplace_back();
+  Assign(repeated.strings.back(), "the");
+  repeated.strings.emplace_back();
+  Assign(repeated.strings.back(), "quick");
+  repeated.doubles = {1.5, -2.25};
+  repeated.structs.push_back({.one = 1, .two = 2});
+  repeated.structs.push_back({.one = 3, .two = 4});
+
+  std::byte struct_buffer[128];
+  const StatusWithSize result = repeated.Encode(struct_buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), repeated.EncodedSize());
+
+  constexpr uint32_t kUint32s[] = {0, 50, 100, 150};
+  constexpr int32_t kSint32s[] = {-5, 0, 5};
+  constexpr double kDoubles[] = {1.5, -2.25};
+
+  std::byte encoder_buffer[128];
+  stream::MemoryWriter writer(encoder_buffer);
+  RepeatedTest::StreamEncoder encoder(writer, ByteSpan());
+  encoder.WriteUint32s(kUint32s)
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  encoder.WriteSint32s(kSint32s)
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  encoder.WriteStrings("the")
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  encoder.WriteStrings("quick")
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  encoder.WriteDoubles(kDoubles)
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  for (uint32_t i = 1; i < 5; i += 2) {
+    Struct::StreamEncoder structs = encoder.GetStructsEncoder(4);
+    structs.WriteOne(i)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    structs.WriteTwo(i + 1)
+        .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+  }
+  ASSERT_EQ(encoder.status(), OkStatus());
+
+  EXPECT_TRUE(
+      Equal(std::span(struct_buffer, result.size()), writer.WrittenData()));
+}
+
+TEST(StructCodec, RoundTripsAllTypes) {
+  AllTypes::Message message;
+  message.double_value = -1.25;
+  message.float_value = 3.5f;
+  message.int32_value = -42;
+  message.int64_value = -(int64_t{1} << 40);
+  message.uint32_value = 0xfffffffe;
+  message.uint64_value = 0xfedcba9876543210;
+  message.sint32_value = -100000;
+  message.sint64_value = std::numeric_limits<int64_t>::min();
+  message.fixed32_value = 0x12345678;
+  message.fixed64_value = 0x0123456789abcdef;
+  message.sfixed32_value = -7;
+  message.sfixed64_value = -8;
+  message.bool_value = true;
+  Assign(message.string_value, "hello");
+  message.bytes_value = {std::byte{0}, std::byte{0xff}};
+  message.color = AllTypes::Color::BLUE;
+  Assign(message.inner.name, "inner");
+  message.unpacked_int32s = {-1, 0, 1};
+  message.packed_fixed32s = {1, 2, 3};
+  message.repeated_bytes.emplace_back();
+  message.repeated_bytes.back() = {std::byte{1}};
+  message.colors = {AllTypes::Color::RED, AllTypes::Color::BLUE};
+
+  std::byte buffer[256];
+  const StatusWithSize result = message.Encode(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), message.EncodedSize());
+
+  AllTypes::Message decoded;
+  ASSERT_EQ(decoded.Decode(std::span(buffer, result.size())), OkStatus());
+
+  EXPECT_EQ(decoded.double_value, -1.25);
+  EXPECT_EQ(decoded.float_value, 3.5f);
+  EXPECT_EQ(decoded.int32_value, -42);
+  EXPECT_EQ(decoded.int64_value, -(int64_t{1} << 40));
+  EXPECT_EQ(decoded.uint32_value, 0xfffffffeu);
+  EXPECT_EQ(decoded.uint64_value, 0xfedcba9876543210u);
+  EXPECT_EQ(decoded.sint32_value, -100000);
+  EXPECT_EQ(decoded.sint64_value, std::numeric_limits<int64_t>::min());
+  EXPECT_EQ(decoded.fixed32_value, 0x12345678u);
+  EXPECT_EQ(decoded.fixed64_value, 0x0123456789abcdefu);
+  EXPECT_EQ(decoded.sfixed32_value, -7);
+  EXPECT_EQ(decoded.sfixed64_value, -8);
+  EXPECT_TRUE(decoded.bool_value);
+  EXPECT_EQ(AsString(decoded.string_value), "hello");
+  ASSERT_EQ(decoded.bytes_value.size(), 2u);
+  EXPECT_EQ(decoded.bytes_value[1], std::byte{0xff});
+  EXPECT_EQ(decoded.color, AllTypes::Color::BLUE);
+  EXPECT_EQ(AsString(decoded.inner.name), "inner");
+  ASSERT_EQ(decoded.unpacked_int32s.size(), 3u);
+  EXPECT_EQ(decoded.unpacked_int32s[0], -1);
+  EXPECT_EQ(decoded.unpacked_int32s[2], 1);
+  ASSERT_EQ(decoded.packed_fixed32s.size(), 3u);
+  EXPECT_EQ(decoded.packed_fixed32s[2], 3u);
+  ASSERT_EQ(decoded.repeated_bytes.size(), 1u);
+  ASSERT_EQ(decoded.repeated_bytes[0].size(), 1u);
+  EXPECT_EQ(decoded.repeated_bytes[0][0], std::byte{1});
+  ASSERT_EQ(decoded.colors.size(), 2u);
+  EXPECT_EQ(decoded.colors[1], AllTypes::Color::BLUE);
+}
+
+TEST(StructCodec, ZeroValuesAreNotEncoded) {
+  AllTypes::Message message;
+  EXPECT_EQ(message.EncodedSize(), 0u);
+
+  std::byte buffer[1];
+  const StatusWithSize result = message.Encode(buffer);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 0u);
+}
+
+TEST(StructCodec, EncodeBufferTooSmall) {
+  KeyValuePair::Message pair;
+  Assign(pair.key, "key");
+  Assign(pair.value, "value");
+
+  std::byte buffer[8];
+  EXPECT_EQ(pair.Encode(buffer).status(), Status::ResourceExhausted());
+}
+
+TEST(StructCodec, DecodeResetsMessage) {
+  KeyValuePair::Message pair;
+  Assign(pair.key, "key");
+  Assign(pair.value, "value");
+
+  constexpr auto kData = bytes::Array<0x0a, 0x01, 'k'>();
+  ASSERT_EQ(pair.Decode(kData), OkStatus());
+  EXPECT_EQ(AsString(pair.key), "k");
+  EXPECT_TRUE(pair.value.empty());
+}
+
+TEST(StructCodec, DecodePackedAndUnpackedRepeated) {
+  // uint32s as two unpacked values followed by a packed run.
+  constexpr auto kData =
+      bytes::Array<0x08, 0x01, 0x08, 0x02, 0x0a, 0x02, 0x03, 0x04>();
+
+  RepeatedTest::Message repeated;
+  ASSERT_EQ(repeated.Decode(kData), OkStatus());
+  ASSERT_EQ(repeated.uint32s.size(), 4u);
+  for (uint32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(repeated.uint32s[i], i + 1);
+  }
+}
+
+TEST(StructCodec, DecodeSkipsUnknownFields) {
+  // clang-format off
+  constexpr auto kData = bytes::Array<
+      0x08, 0x07,                    // one = 7
+      0x48, 0x80, 0x01,              // field 9, varint
+      0x52, 0x02, 0xaa, 0xbb,        // field 10, delimited
+      0x5d, 0x01, 0x02, 0x03, 0x04,  // field 11, fixed32
+      0x61, 0, 0, 0, 0, 0, 0, 0, 0,  // field 12, fixed64
+      0x10, 0x08                     // two = 8
+  >();
+  // clang-format on
+
+  Struct::Message message;
+  ASSERT_EQ(message.Decode(kData), OkStatus());
+  EXPECT_EQ(message.one, 7u);
+  EXPECT_EQ(message.two, 8u);
+}
+
+TEST(StructCodec, DecodeStringTooLong) {
+  std::array<std::byte, 2 + config::kStructMaxBytesSize + 1> data{};
+  data[0] = std::byte{0x0a};
+  data[1] = std::byte{config::kStructMaxBytesSize + 1};
+
+  KeyValuePair::Message pair;
+  EXPECT_EQ(pair.Decode(data), Status::ResourceExhausted());
+}
+
+TEST(StructCodec, DecodeTooManyRepeatedValues) {
+  std::array<std::byte, 2 * (config::kStructMaxRepeatedCount + 1)> data{};
+  for (size_t i = 0; i < data.size(); i += 2) {
+    data[i] = std::byte{0x08};  // uint32s, unpacked
+    data[i + 1] = std::byte{0x01};
+  }
+
+  RepeatedTest::Message repeated;
+  EXPECT_EQ(repeated.Decode(data), Status::ResourceExhausted());
+}
+
+TEST(StructCodec, DecodeValueOutOfRange) {
+  // one = 2^32
+  constexpr auto kData = bytes::Array<0x08, 0x80, 0x80, 0x80, 0x80, 0x10>();
+
+  Struct::Message message;
+  EXPECT_EQ(message.Decode(kData), Status::OutOfRange());
+}
+
+TEST(StructCodec, DecodeMalformed) {
+  Struct::Message message;
+
+  // Truncated varint.
+  EXPECT_EQ(message.Decode(bytes::Array<0x08, 0x80>()), Status::DataLoss());
+
+  // Wrong wire type for field one.
+  EXPECT_EQ(message.Decode(bytes::Array<0x0d, 0x01, 0x02, 0x03, 0x04>()),
+            Status::DataLoss());
+
+  // Length-delimited field longer than the message.
+  KeyValuePair::Message pair;
+  EXPECT_EQ(pair.Decode(bytes::Array<0x0a, 0x05, 'a'>()), Status::DataLoss());
+
+  // Packed fixed-size values with a partial element.
+  AllTypes::Message all_types;
+  constexpr auto kPartialFixed32 =
+      bytes::Array<0x9a, 0x01, 0x03, 0x01, 0x02, 0x03>();
+  EXPECT_EQ(all_types.Decode(kPartialFixed32), Status::DataLoss());
+}
+
+}  // namespace
+}  // namespace pw::protobuf
@@ -122,6 +122,14 @@ def protoc_python_args(args: argparse.Namespace) -> Tuple[str, ...]:
     )
 
 
+def protoc_descriptor_set_args(args: argparse.Namespace) -> Tuple[str, ...]:
+    return _COMMON_FLAGS + (
+        '--include_imports',
+        '--descriptor_set_out',
+        args.out_dir / DESCRIPTOR_SET_NAME,
+    )
+
+
 _DefaultArgsFunction = Callable[[argparse.Namespace], Tuple[str, ...]]
 
 # Default additional protoc arguments for each supported language.
@@ -133,10 +141,14 @@ DEFAULT_PROTOC_ARGS: Dict[str, _DefaultArgsFunction] = {
     'nanopb_rpc': protoc_nanopb_rpc_args,
     'raw_rpc': protoc_raw_rpc_args,
     'python': protoc_python_args,
+    'descriptor_set': protoc_descriptor_set_args,
 }
 
 # Languages that protoc internally supports.
-BUILTIN_PROTOC_LANGS = ('go', 'python')
+BUILTIN_PROTOC_LANGS = ('go', 'python', 'descriptor_set')
+
+# The file the descriptor_set language writes to its output directory.
+DESCRIPTOR_SET_NAME = 'descriptor_set.pb'
 
 
 def main() -> int:
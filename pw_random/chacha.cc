@@ -0,0 +1,160 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_random/chacha.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "pw_bytes/endian.h"
+
+namespace pw::random {
+namespace {
+
+// "expand 32-byte k" as little-endian words.
+constexpr uint32_t kConstants[] = {
+    0x61707865u, 0x3320646eu, 0x79622d32u, 0x6b206574u};
+
+constexpr uint32_t RotateLeft(uint32_t value, int bits) {
+  return (value << bits) | (value >> (32 - bits));
+}
+
+constexpr void QuarterRound(
+    ChaCha20Rng::Block& x, size_t a, size_t b, size_t c, size_t d) {
+  x[a] += x[b];
+  x[d] = RotateLeft(x[d] ^ x[a], 16);
+  x[c] += x[d];
+  x[b] = RotateLeft(x[b] ^ x[c], 12);
+  x[a] += x[b];
+  x[d] = RotateLeft(x[d] ^ x[a], 8);
+  x[c] += x[d];
+  x[b] = RotateLeft(x[b] ^ x[c], 7);
+}
+
+// Copies words to bytes in little-endian order.
+void CopyWords(const uint32_t* words, std::byte* dest, size_t size_bytes) {
+  if constexpr (std::endian::native == std::endian::little) {
+    std::memcpy(dest, words, size_bytes);
+  } else {
+    for (size_t i = 0; i < size_bytes; i += sizeof(uint32_t)) {
+      const uint32_t word =
+          bytes::ConvertOrderTo(std::endian::little, words[i / 4]);
+      std::memcpy(dest + i, &word, std::min(sizeof(word), size_bytes - i));
+    }
+  }
+}
+
+}  // namespace
+
+ChaCha20Rng::ChaCha20Rng(std::span<const std::byte, kSeedSizeBytes> seed)
+    : nonce_{},
+      counter_(0),
+      entropy_word_(0),
+      entropy_pending_(false) {
+  for (size_t i = 0; i < key_.size(); ++i) {
+    key_[i] = bytes::ReadInOrder<uint32_t>(std::endian::little,
+                                           &seed[i * sizeof(uint32_t)]);
+  }
+}
+
+Status ChaCha20Rng::Reseed(RandomGenerator& seed_source) {
+  std::array<std::byte, kSeedSizeBytes> seed = {};
+  const StatusWithSize result = seed_source.Get(seed);
+
+  for (size_t i = 0; i < key_.size(); ++i) {
+    key_[i] ^= bytes::ReadInOrder<uint32_t>(std::endian::little,
+                                            &seed[i * sizeof(uint32_t)]);
+  }
+  std::memset(seed.data(), 0, seed.size());
+
+  Rekey();
+  return result.status();
+}
+
+StatusWithSize ChaCha20Rng::Get(ByteSpan dest) {
+  if (entropy_pending_) {
+    Rekey();
+  }
+
+  const size_t bytes_written = dest.size_bytes();
+  Block block;
+  while (!dest.empty()) {
+    Generate(key_, counter_++, nonce_, block);
+    const size_t copy_size = std::min(dest.size_bytes(), kBlockSizeBytes);
+    CopyWords(block.data(), dest.data(), copy_size);
+    dest = dest.subspan(copy_size);
+  }
+  std::memset(block.data(), 0, sizeof(block));
+
+  Rekey();
+  return StatusWithSize(bytes_written);
+}
+
+void ChaCha20Rng::InjectEntropyBits(uint32_t data, uint_fast8_t num_bits) {
+  if (num_bits == 0) {
+    return;
+  } else if (num_bits > 32) {
+    num_bits = 32;
+  }
+
+  // Rotate the word before mixing in the new bits, so that entropy injected a
+  // few bits at a time progressively fills the word.
+  const uint32_t mask = num_bits == 32 ? ~0u : (1u << num_bits) - 1;
+  uint32_t& word = nonce_[entropy_word_];
+  word = RotateLeft(word, num_bits) ^ (data & mask);
+  entropy_word_ = (entropy_word_ + 1) % nonce_.size();
+  entropy_pending_ = true;
+}
+
+void ChaCha20Rng::Generate(const Key& key,
+                           uint32_t counter,
+                           const Nonce& nonce,
+                           Block& output) {
+  Block state;
+  std::copy(std::begin(kConstants), std::end(kConstants), state.begin());
+  std::copy(key.begin(), key.end(), state.begin() + 4);
+  state[12] = counter;
+  std::copy(nonce.begin(), nonce.end(), state.begin() + 13);
+
+  output = state;
+  for (int i = 0; i < 10; ++i) {
+    QuarterRound(output, 0, 4, 8, 12);
+    QuarterRound(output, 1, 5, 9, 13);
+    QuarterRound(output, 2, 6, 10, 14);
+    QuarterRound(output, 3, 7, 11, 15);
+    QuarterRound(output, 0, 5, 10, 15);
+    QuarterRound(output, 1, 6, 11, 12);
+    QuarterRound(output, 2, 7, 8, 13);
+    QuarterRound(output, 3, 4, 9, 14);
+  }
+
+  for (size_t i = 0; i < output.size(); ++i) {
+    output[i] += state[i];
+  }
+}
+
+void ChaCha20Rng::Rekey() {
+  Block block;
+  Generate(key_, counter_, nonce_, block);
+  std::copy(block.begin(), block.begin() + key_.size(), key_.begin());
+  std::memset(block.data(), 0, sizeof(block));
+
+  nonce_ = {};
+  counter_ = 0;
+  entropy_word_ = 0;
+  entropy_pending_ = false;
+}
+
+}  // namespace pw::random
@@ -0,0 +1,165 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_random/chacha.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_random/xor_shift.h"
+
+namespace pw::random {
+namespace {
+
+constexpr std::array<std::byte, ChaCha20Rng::kSeedSizeBytes> MakeSeed() {
+  std::array<std::byte, ChaCha20Rng::kSeedSizeBytes> seed = {};
+  for (size_t i = 0; i < seed.size(); ++i) {
+    seed[i] = std::byte(i);
+  }
+  return seed;
+}
+
+constexpr auto kSeed = MakeSeed();
+
+// The seed as little-endian words.
+constexpr ChaCha20Rng::Key kKey = {0x03020100u,
+                                   0x07060504u,
+                                   0x0b0a0908u,
+                                   0x0f0e0d0cu,
+                                   0x13121110u,
+                                   0x17161514u,
+                                   0x1b1a1918u,
+                                   0x1f1e1d1cu};
+
+// Block function test vector from RFC 8439 section 2.3.2.
+TEST(ChaCha20Rng, Generate_MatchesRfc8439) {
+  constexpr ChaCha20Rng::Nonce kNonce = {0x09000000u, 0x4a000000u, 0u};
+  constexpr ChaCha20Rng::Block kExpected = {
+      0xe4e7f110u, 0x15593bd1u, 0x1fdd0f50u, 0xc47120a3u,
+      0xc7f4d1c7u, 0x0368c033u, 0x9aaa2204u, 0x4e6cd4c3u,
+      0x466482d2u, 0x09aa9f07u, 0x05d7c214u, 0xa2028bd9u,
+      0xd19c12b5u, 0xb94e16deu, 0xe883d0cbu, 0x4e3c50a2u,
+  };
+
+  ChaCha20Rng::Block block;
+  ChaCha20Rng::Generate(kKey, 1, kNonce, block);
+  EXPECT_EQ(kExpected, block);
+}
+
+TEST(ChaCha20Rng, Get_FirstBlockIsKeystream) {
+  ChaCha20Rng::Block expected;
+  ChaCha20Rng::Generate(kKey, 0, {}, expected);
+
+  // Output is little-endian, which matches the host's word order.
+  ChaCha20Rng rng(kSeed);
+  ChaCha20Rng::Block block;
+  ASSERT_EQ(OkStatus(),
+            rng.Get(std::as_writable_bytes(std::span(block))).status());
+  EXPECT_EQ(expected, block);
+}
+
+TEST(ChaCha20Rng, Get_PartialBlocks) {
+  std::array<std::byte, 100> full;
+  ChaCha20Rng rng_1(kSeed);
+  StatusWithSize result = rng_1.Get(full);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(full.size(), result.size());
+
+  std::array<std::byte, 67> partial;
+  ChaCha20Rng rng_2(kSeed);
+  result = rng_2.Get(partial);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(partial.size(), result.size());
+
+  EXPECT_EQ(0, std::memcmp(full.data(), partial.data(), partial.size()));
+}
+
+TEST(ChaCha20Rng, Get_RekeysAfterEachCall) {
+  ChaCha20Rng::Block second_block;
+  ChaCha20Rng::Generate(kKey, 1, {}, second_block);
+
+  ChaCha20Rng rng(kSeed);
+  uint32_t first = 0;
+  uint32_t second = 0;
+  ASSERT_EQ(OkStatus(), rng.GetInt(first).status());
+  ASSERT_EQ(OkStatus(), rng.GetInt(second).status());
+  EXPECT_NE(first, second);
+  EXPECT_NE(second_block[0], second);
+}
+
+TEST(ChaCha20Rng, SameSeed_SameOutput) {
+  ChaCha20Rng rng_1(kSeed);
+  ChaCha20Rng rng_2(kSeed);
+  for (int i = 0; i < 4; ++i) {
+    uint64_t value_1 = 0;
+    uint64_t value_2 = 0;
+    ASSERT_EQ(OkStatus(), rng_1.GetInt(value_1).status());
+    ASSERT_EQ(OkStatus(), rng_2.GetInt(value_2).status());
+    EXPECT_EQ(value_1, value_2);
+  }
+}
+
+TEST(ChaCha20Rng, InjectEntropyBits_ChangesOutput) {
+  ChaCha20Rng rng_1(kSeed);
+  ChaCha20Rng rng_2(kSeed);
+  rng_2.InjectEntropyBits(0x1, 1);
+
+  uint64_t value_1 = 0;
+  uint64_t value_2 = 0;
+  ASSERT_EQ(OkStatus(), rng_1.GetInt(value_1).status());
+  ASSERT_EQ(OkStatus(), rng_2.GetInt(value_2).status());
+  EXPECT_NE(value_1, value_2);
+}
+
+TEST(ChaCha20Rng, InjectEntropyBits_ZeroBitsIgnored) {
+  ChaCha20Rng rng_1(kSeed);
+  ChaCha20Rng rng_2(kSeed);
+  rng_2.InjectEntropyBits(0xffffffff, 0);
+
+  uint64_t value_1 = 0;
+  uint64_t value_2 = 0;
+  ASSERT_EQ(OkStatus(), rng_1.GetInt(value_1).status());
+  ASSERT_EQ(OkStatus(), rng_2.GetInt(value_2).status());
+  EXPECT_EQ(value_1, value_2);
+}
+
+TEST(ChaCha20Rng, Reseed_ChangesOutput) {
+  ChaCha20Rng rng_1(kSeed);
+  ChaCha20Rng rng_2(kSeed);
+  XorShiftStarRng64 seed_source(5);
+  ASSERT_EQ(OkStatus(), rng_2.Reseed(seed_source));
+
+  uint64_t value_1 = 0;
+  uint64_t value_2 = 0;
+  ASSERT_EQ(OkStatus(), rng_1.GetInt(value_1).status());
+  ASSERT_EQ(OkStatus(), rng_2.GetInt(value_2).status());
+  EXPECT_NE(value_1, value_2);
+}
+
+TEST(ChaCha20Rng, DefaultConstructed_ZeroKey) {
+  ChaCha20Rng::Block expected;
+  ChaCha20Rng::Generate({}, 0, {}, expected);
+
+  ChaCha20Rng rng;
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), rng.GetInt(value).status());
+  EXPECT_EQ(expected[0], value);
+}
+
+}  // namespace
+}  // namespace pw::random
@@ -0,0 +1,87 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_random/random.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::random {
+
+// A cryptographically secure pseudo-random generator built on the ChaCha20
+// block function from RFC 8439. The generator must be seeded with a 256-bit
+// key from a good entropy source, such as a hardware TRNG, either at
+// construction or with Reseed().
+//
+// Output is produced a whole 64-byte block at a time. After each call to
+// Get(), the generator replaces its key with the next block of its own output
+// ("fast key erasure"), so earlier output cannot be recovered from the state.
+// Injected entropy is mixed into the nonce and takes effect at the next Get().
+//
+// This generator never exhausts itself, but it is only as unpredictable as
+// the entropy used to seed it.
+class ChaCha20Rng : public RandomGenerator {
+ public:
+  static constexpr size_t kSeedSizeBytes = 32;
+  static constexpr size_t kBlockSizeBytes = 64;
+
+  using Key = std::array<uint32_t, kSeedSizeBytes / sizeof(uint32_t)>;
+  using Nonce = std::array<uint32_t, 3>;
+  using Block = std::array<uint32_t, kBlockSizeBytes / sizeof(uint32_t)>;
+
+  // Creates a generator with an all-zero key. Its output is predictable until
+  // it is seeded with Reseed().
+  constexpr ChaCha20Rng()
+      : key_{},
+        nonce_{},
+        counter_(0),
+        entropy_word_(0),
+        entropy_pending_(false) {}
+
+  // Seeds the generator with a key, interpreted as little-endian words.
+  explicit ChaCha20Rng(std::span<const std::byte, kSeedSizeBytes> seed);
+
+  // Mixes kSeedSizeBytes bytes from another generator into the key. Returns
+  // the status from seed_source. Any bytes that were produced are still mixed
+  // in if the source is exhausted.
+  Status Reseed(RandomGenerator& seed_source);
+
+  StatusWithSize Get(ByteSpan dest) final;
+
+  void InjectEntropyBits(uint32_t data, uint_fast8_t num_bits) final;
+
+  // The ChaCha20 block function from RFC 8439 section 2.3.
+  static void Generate(const Key& key,
+                       uint32_t counter,
+                       const Nonce& nonce,
+                       Block& output);
+
+ private:
+  // Derives a new key from the current state and resets the counter and nonce.
+  void Rekey();
+
+  Key key_;
+  Nonce nonce_;
+  uint32_t counter_;
+  uint_fast8_t entropy_word_;
+  bool entropy_pending_;
+};
+
+}  // namespace pw::random
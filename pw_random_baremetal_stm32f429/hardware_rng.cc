@@ -0,0 +1,153 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_random_baremetal_stm32f429/hardware_rng.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_preprocessor/compiler.h"
+
+namespace pw::random {
+namespace {
+
+// Base address for everything AHB1-related on the STM32F4xx.
+constexpr uint32_t kAhb1PeripheralBase = 0x40020000U;
+// Base address for everything AHB2-related on the STM32F4xx.
+constexpr uint32_t kAhb2PeripheralBase = 0x50000000U;
+
+// Reset/clock configuration block (RCC).
+// `reserved` fields are unimplemented features, and are present to ensure
+// proper alignment of registers that are in use.
+PW_PACKED(struct) RccBlock {
+  uint32_t clock_control;
+  uint32_t pll_config;
+  uint32_t reserved1[11];
+  uint32_t ahb2_config;
+};
+
+// Masks for clock_control (CR) to enable the main PLL and check it is locked.
+constexpr uint32_t kPllOn = 0x1u << 24;
+constexpr uint32_t kPllReady = 0x1u << 25;
+
+// Main PLL configuration (PLLCFGR) that produces the 48 MHz clock for the RNG
+// from the 16 MHz HSI: 16 MHz / M(16) * N(192) / Q(4). The system clock does
+// not use the PLL, so the P divider and source are set to their reset values
+// of /2 and HSI. Reserved bits outside kPllConfigMask are preserved.
+constexpr uint32_t kPllConfigMask = 0x0F437FFFu;
+constexpr uint32_t kPllM = 16;
+constexpr uint32_t kPllN = 192u << 6;
+constexpr uint32_t kPllQ = 4u << 24;
+
+// Mask for ahb2_config (AHB2ENR) to enable the RNG.
+constexpr uint32_t kRngClockEnable = 0x1u << 6;
+
+// Layout of memory mapped registers for the RNG.
+PW_PACKED(struct) RngBlock {
+  uint32_t control;
+  uint32_t status;
+  uint32_t data_register;
+};
+
+// RNG control flags.
+constexpr uint32_t kRngEnable = 0x1u << 2;
+
+// RNG status flags.
+constexpr uint32_t kDataReady = 0x1u;
+constexpr uint32_t kClockError = 0x1u << 1;
+constexpr uint32_t kSeedError = 0x1u << 2;
+constexpr uint32_t kClockErrorInterrupt = 0x1u << 5;
+constexpr uint32_t kSeedErrorInterrupt = 0x1u << 6;
+
+// A word takes 40 RNG clock periods, well under a microsecond. This bounds the
+// wait if the RNG clock is not running.
+constexpr int kMaxPolls = 10000;
+
+volatile RccBlock& platform_rcc =
+    *reinterpret_cast<volatile RccBlock*>(kAhb1PeripheralBase + 0x3800U);
+
+volatile RngBlock& rng =
+    *reinterpret_cast<volatile RngBlock*>(kAhb2PeripheralBase + 0x60800U);
+
+}  // namespace
+
+StatusWithSize Stm32f429HardwareRng::Get(ByteSpan dest) {
+  if (!enabled_ && !Enable().ok()) {
+    return StatusWithSize(Status::ResourceExhausted(), 0);
+  }
+
+  size_t bytes_written = 0;
+  while (bytes_written < dest.size()) {
+    uint32_t word;
+    if (!ReadWord(word).ok()) {
+      return StatusWithSize(Status::ResourceExhausted(), bytes_written);
+    }
+    const size_t copy_size =
+        std::min(sizeof(word), dest.size() - bytes_written);
+    std::memcpy(dest.data() + bytes_written, &word, copy_size);
+    bytes_written += copy_size;
+  }
+  return StatusWithSize(bytes_written);
+}
+
+Status Stm32f429HardwareRng::Enable() {
+  if ((platform_rcc.clock_control & kPllOn) == 0u) {
+    platform_rcc.pll_config =
+        (platform_rcc.pll_config & ~kPllConfigMask) | kPllM | kPllN | kPllQ;
+    platform_rcc.clock_control |= kPllOn;
+  }
+  while ((platform_rcc.clock_control & kPllReady) == 0u) {
+  }
+
+  platform_rcc.ahb2_config |= kRngClockEnable;
+  rng.control = kRngEnable;
+
+  // The first word after enabling the RNG may not be used. It is kept only to
+  // compare against the next word.
+  enabled_ = true;
+  return ReadWord(previous_);
+}
+
+Status Stm32f429HardwareRng::ReadWord(uint32_t& word) {
+  for (int i = 0; i < kMaxPolls; ++i) {
+    const uint32_t status = rng.status;
+
+    if ((status & kSeedError) != 0u) {
+      // Recover from a seed error by clearing the flag and restarting the RNG.
+      // The words generated before the error are discarded.
+      rng.status = ~kSeedErrorInterrupt;
+      rng.control = 0;
+      rng.control = kRngEnable;
+      enabled_ = false;
+      return Status::DataLoss();
+    }
+
+    if ((status & kClockError) != 0u) {
+      rng.status = ~kClockErrorInterrupt;
+      return Status::Unavailable();
+    }
+
+    if ((status & kDataReady) != 0u) {
+      word = rng.data_register;
+      if (word == previous_) {
+        return Status::DataLoss();
+      }
+      previous_ = word;
+      return OkStatus();
+    }
+  }
+  return Status::DeadlineExceeded();
+}
+
+}  // namespace pw::random
@@ -0,0 +1,54 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_random/random.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::random {
+
+// Reads true random numbers from the STM32F429 RNG peripheral. The peripheral
+// and its 48 MHz clock are enabled on the first call to Get(). Only one
+// instance should exist, since it tracks the peripheral's state.
+//
+// Get() fills the destination a 32-bit word at a time, straight from the data
+// register. It returns RESOURCE_EXHAUSTED with the number of bytes filled if
+// the peripheral reports a clock or seed error, or if two consecutive words
+// are identical (the FIPS 140-2 continuous test).
+//
+// This generator is slow compared to a PRNG, about 40 cycles of the 48 MHz
+// clock per word. For bulk random data, use it to seed a ChaCha20Rng.
+class Stm32f429HardwareRng final : public RandomGenerator {
+ public:
+  constexpr Stm32f429HardwareRng() : enabled_(false), previous_(0) {}
+
+  StatusWithSize Get(ByteSpan dest) final;
+
+  // The peripheral has no entropy input, so injected entropy is ignored.
+  void InjectEntropyBits(uint32_t, uint_fast8_t) final {}
+
+ private:
+  Status Enable();
+
+  Status ReadWord(uint32_t& word);
+
+  bool enabled_;
+  uint32_t previous_;
+};
+
+}  // namespace pw::random
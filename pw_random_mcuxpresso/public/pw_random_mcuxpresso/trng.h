@@ -0,0 +1,49 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "fsl_trng.h"
+#include "pw_bytes/span.h"
+#include "pw_random/random.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::random {
+
+// Reads true random numbers from the TRNG peripheral of an MCUXpresso device,
+// using the SDK's TRNG driver with its default configuration. The peripheral
+// is initialized on the first call to Get().
+//
+// Get() fills the destination directly from the TRNG's entropy registers, one
+// 512-bit entropy generation at a time. It returns RESOURCE_EXHAUSTED with the
+// number of bytes filled if the TRNG reports an error.
+//
+// For bulk random data, use this generator to seed a ChaCha20Rng.
+class McuxpressoTrng final : public RandomGenerator {
+ public:
+  constexpr McuxpressoTrng(TRNG_Type* base)
+      : base_(base), initialized_(false) {}
+
+  StatusWithSize Get(ByteSpan dest) final;
+
+  // The peripheral has no entropy input, so injected entropy is ignored.
+  void InjectEntropyBits(uint32_t, uint_fast8_t) final {}
+
+ private:
+  TRNG_Type* base_;
+  bool initialized_;
+};
+
+}  // namespace pw::random
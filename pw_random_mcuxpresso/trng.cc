@@ -0,0 +1,53 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_random_mcuxpresso/trng.h"
+
+#include <algorithm>
+
+#include "fsl_common.h"
+
+namespace pw::random {
+namespace {
+
+// The TRNG produces 512 bits of entropy per generation. Requesting one
+// generation at a time lets Get() report partial progress if the TRNG fails.
+constexpr size_t kEntropyGenerationBytes = 64;
+
+}  // namespace
+
+StatusWithSize McuxpressoTrng::Get(ByteSpan dest) {
+  if (!initialized_) {
+    trng_config_t config;
+    TRNG_GetDefaultConfig(&config);
+    if (TRNG_Init(base_, &config) != kStatus_Success) {
+      return StatusWithSize(Status::ResourceExhausted(), 0);
+    }
+    initialized_ = true;
+  }
+
+  size_t bytes_written = 0;
+  while (bytes_written < dest.size()) {
+    const size_t size =
+        std::min(kEntropyGenerationBytes, dest.size() - bytes_written);
+    if (TRNG_GetRandomData(base_, dest.data() + bytes_written, size) !=
+        kStatus_Success) {
+      return StatusWithSize(Status::ResourceExhausted(), bytes_written);
+    }
+    bytes_written += size;
+  }
+  return StatusWithSize(bytes_written);
+}
+
+}  // namespace pw::random
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <numeric>
 
 #include "pw_assert/assert.h"
 #include "pw_assert/check.h"
@@ -29,9 +30,27 @@ using std::byte;
 using Entry = PrefixedEntryRingBufferMulti::Entry;
 using Reader = PrefixedEntryRingBufferMulti::Reader;
 using iterator = PrefixedEntryRingBufferMulti::iterator;
+using wrapped_iterator = PrefixedEntryRingBufferMulti::wrapped_iterator;
+
+namespace {
+
+// Encodes value as a varint of exactly output.size() bytes, padding it with
+// continuation bytes. The value must fit in that many bytes.
+void EncodePaddedVarint(uint32_t value, std::span<byte> output) {
+  for (size_t i = 0; i + 1 < output.size(); ++i) {
+    output[i] = byte((value & 0x7fu) | 0x80u);
+    value >>= 7;
+  }
+  output.back() = byte(value & 0x7fu);
+}
+
+}  // namespace
 
 void PrefixedEntryRingBufferMulti::Clear() {
   write_idx_ = 0;
+  reserved_ = false;
+  dering_bytes_remaining_ = 0;
+  dering_shift_ = 0;
   for (Reader& reader : readers_) {
     reader.read_idx_ = 0;
     reader.entry_count_ = 0;
@@ -52,6 +71,66 @@ Status PrefixedEntryRingBufferMulti::SetBuffer(std::span<byte> buffer) {
   return OkStatus();
 }
 
+PrefixedEntryRingBufferMulti::Position
+PrefixedEntryRingBufferMulti::GetPosition() const {
+  Position position = {};
+  position.write_idx = static_cast<uint32_t>(write_idx_);
+  if (readers_.empty()) {
+    position.read_idx = position.write_idx;
+    return position;
+  }
+
+  const Reader& slowest_reader = GetSlowestReader();
+  position.read_idx = static_cast<uint32_t>(slowest_reader.read_idx_);
+  position.entry_count = static_cast<uint32_t>(slowest_reader.entry_count_);
+  return position;
+}
+
+Status PrefixedEntryRingBufferMulti::RestorePosition(const Position& position) {
+  if (buffer_ == nullptr || reserved_ || dering_in_progress()) {
+    return Status::FailedPrecondition();
+  }
+  if (position.read_idx > buffer_bytes_ || position.write_idx > buffer_bytes_) {
+    return Status::DataLoss();
+  }
+
+  // Indices equal to the buffer size alias the start of the buffer.
+  const size_t read_idx = position.read_idx % buffer_bytes_;
+  const size_t write_idx = position.write_idx % buffer_bytes_;
+  size_t used_bytes = write_idx >= read_idx
+                          ? write_idx - read_idx
+                          : buffer_bytes_ - (read_idx - write_idx);
+  if (used_bytes == 0u && position.entry_count != 0u) {
+    used_bytes = buffer_bytes_;  // Full.
+  }
+
+  // Walk the entries to check that they exactly fill the used space.
+  size_t idx = read_idx;
+  for (uint32_t i = 0; i < position.entry_count; ++i) {
+    const Result<EntryInfo> info = RawFrontEntryInfo(idx);
+    if (!info.ok()) {
+      return Status::DataLoss();
+    }
+    const size_t entry_bytes =
+        info.value().preamble_bytes + info.value().data_bytes;
+    if (entry_bytes > used_bytes) {
+      return Status::DataLoss();
+    }
+    used_bytes -= entry_bytes;
+    idx = IncrementIndex(idx, entry_bytes);
+  }
+  if (used_bytes != 0u) {
+    return Status::DataLoss();
+  }
+
+  write_idx_ = write_idx;
+  for (Reader& reader : readers_) {
+    reader.read_idx_ = read_idx;
+    reader.entry_count_ = position.entry_count;
+  }
+  return OkStatus();
+}
+
 Status PrefixedEntryRingBufferMulti::AttachReader(Reader& reader) {
   if (reader.buffer_ != nullptr) {
     return Status::InvalidArgument();
@@ -79,6 +158,7 @@ Status PrefixedEntryRingBufferMulti::DetachReader(Reader& reader) {
   reader.read_idx_ = 0;
   reader.entry_count_ = 0;
   readers_.remove(reader);
+  InvalidateSlowestReader(reader);
   return OkStatus();
 }
 
@@ -86,7 +166,7 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
     std::span<const byte> data,
     uint32_t user_preamble_data,
     bool pop_front_if_needed) {
-  if (buffer_ == nullptr) {
+  if (buffer_ == nullptr || reserved_ || dering_in_progress()) {
     return Status::FailedPrecondition();
   }
 
@@ -106,16 +186,7 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
     return Status::OutOfRange();
   }
 
-  if (pop_front_if_needed) {
-    // PushBack() case: evict items as needed.
-    // Drop old entries until we have space for the new entry.
-    while (RawAvailableBytes() < total_write_bytes) {
-      InternalPopFrontAll();
-    }
-  } else if (RawAvailableBytes() < total_write_bytes) {
-    // TryPushBack() case: don't evict items.
-    return Status::ResourceExhausted();
-  }
+  PW_TRY(MakeSpace(total_write_bytes, pop_front_if_needed));
 
   // Write the new entry into the ring buffer.
   RawWrite(std::span(preamble_buf, user_preamble_bytes + length_bytes));
@@ -128,6 +199,156 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
   return OkStatus();
 }
 
+Status PrefixedEntryRingBufferMulti::InternalPushBackMany(
+    std::span<const std::span<const byte>> entries,
+    uint32_t user_preamble_data,
+    bool pop_front_if_needed) {
+  if (buffer_ == nullptr || reserved_ || dering_in_progress()) {
+    return Status::FailedPrecondition();
+  }
+
+  // The user preamble is the same for every entry, so encode it once.
+  byte preamble_buf[varint::kMaxVarint32SizeBytes * 2];
+  size_t user_preamble_bytes = 0;
+  if (user_preamble_) {
+    user_preamble_bytes =
+        varint::Encode<uint32_t>(user_preamble_data, preamble_buf);
+  }
+
+  size_t total_write_bytes = 0;
+  for (std::span<const byte> data : entries) {
+    if (buffer_bytes_ < data.size_bytes()) {
+      return Status::OutOfRange();
+    }
+    total_write_bytes += user_preamble_bytes +
+                         varint::EncodedSize(data.size_bytes()) +
+                         data.size_bytes();
+    if (buffer_bytes_ < total_write_bytes) {
+      return Status::OutOfRange();
+    }
+  }
+
+  PW_TRY(MakeSpace(total_write_bytes, pop_front_if_needed));
+
+  for (std::span<const byte> data : entries) {
+    const size_t length_bytes = varint::Encode<uint32_t>(
+        data.size_bytes(),
+        std::span(preamble_buf).subspan(user_preamble_bytes));
+    RawWrite(std::span(preamble_buf, user_preamble_bytes + length_bytes));
+    RawWrite(data);
+  }
+
+  for (Reader& reader : readers_) {
+    reader.entry_count_ += entries.size();
+  }
+  return OkStatus();
+}
+
+Result<PrefixedEntryRingBufferMulti::ReservedSpans>
+PrefixedEntryRingBufferMulti::InternalReserve(size_t max_size,
+                                              uint32_t user_preamble_data,
+                                              bool pop_front_if_needed) {
+  if (buffer_ == nullptr || reserved_ || dering_in_progress()) {
+    return Status::FailedPrecondition();
+  }
+
+  size_t preamble_bytes = varint::EncodedSize(max_size);
+  if (user_preamble_) {
+    preamble_bytes += varint::EncodedSize(user_preamble_data);
+  }
+  if (buffer_bytes_ < max_size || buffer_bytes_ - max_size < preamble_bytes) {
+    return Status::OutOfRange();
+  }
+
+  PW_TRY(MakeSpace(preamble_bytes + max_size, pop_front_if_needed));
+
+  // The preamble is written on commit, once the size is known.
+  size_t data_idx = IncrementIndex(write_idx_, preamble_bytes);
+  if (data_idx == buffer_bytes_) {
+    data_idx = 0;
+  }
+
+  ReservedSpans spans;
+  spans.first = std::span(buffer_ + data_idx,
+                          std::min(max_size, buffer_bytes_ - data_idx));
+  spans.second = std::span(buffer_, max_size - spans.first.size());
+
+  reserved_ = true;
+  reserved_size_ = max_size;
+  reserved_user_preamble_ = user_preamble_data;
+  return spans;
+}
+
+Status PrefixedEntryRingBufferMulti::Commit(size_t size_bytes) {
+  if (!reserved_) {
+    return Status::FailedPrecondition();
+  }
+  if (size_bytes > reserved_size_) {
+    return Status::InvalidArgument();
+  }
+
+  byte preamble_buf[varint::kMaxVarint32SizeBytes * 2];
+  size_t user_preamble_bytes = 0;
+  if (user_preamble_) {
+    user_preamble_bytes =
+        varint::Encode<uint32_t>(reserved_user_preamble_, preamble_buf);
+  }
+
+  // The data was written after a length prefix sized for the reservation, so
+  // pad the actual length to that size rather than moving the data.
+  const size_t length_bytes = varint::EncodedSize(reserved_size_);
+  EncodePaddedVarint(
+      size_bytes,
+      std::span(preamble_buf).subspan(user_preamble_bytes, length_bytes));
+  RawWrite(std::span(preamble_buf, user_preamble_bytes + length_bytes));
+  write_idx_ = IncrementIndex(write_idx_, size_bytes);
+  reserved_ = false;
+
+  for (Reader& reader : readers_) {
+    reader.entry_count_++;
+  }
+  return OkStatus();
+}
+
+Status PrefixedEntryRingBufferMulti::MakeSpace(size_t bytes,
+                                               bool pop_front_if_needed) {
+  size_t available_bytes = RawAvailableBytes();
+  if (available_bytes >= bytes) {
+    return OkStatus();
+  }
+  if (!pop_front_if_needed) {
+    // TryPushBack() case: don't evict items.
+    return Status::ResourceExhausted();
+  }
+
+  // PushBack() case: evict items as needed. Entries are stored contiguously
+  // from the slowest reader, so walk forward from it until enough entries are
+  // dropped to make space for the new entry.
+  const Reader& slowest_reader = GetSlowestReader();
+  size_t read_idx = slowest_reader.read_idx_;
+  size_t entry_count = slowest_reader.entry_count_;
+  while (available_bytes < bytes) {
+    PW_DCHECK_INT_NE(entry_count, 0);
+    const Result<EntryInfo> info = RawFrontEntryInfo(read_idx);
+    PW_CHECK_OK(info.status());
+    const size_t entry_bytes =
+        info.value().preamble_bytes + info.value().data_bytes;
+    read_idx = IncrementIndex(read_idx, entry_bytes);
+    available_bytes += entry_bytes;
+    entry_count--;
+  }
+
+  // Move every reader that was on a dropped entry to the new oldest entry.
+  // The slowest reader is moved too, so it remains the slowest.
+  for (Reader& reader : readers_) {
+    if (reader.entry_count_ > entry_count) {
+      reader.read_idx_ = read_idx;
+      reader.entry_count_ = entry_count;
+    }
+  }
+  return OkStatus();
+}
+
 auto GetOutput(std::span<byte> data_out, size_t* write_index) {
   return [data_out, write_index](std::span<const byte> src) -> Status {
     size_t copy_size = std::min(data_out.size_bytes(), src.size_bytes());
@@ -164,6 +385,9 @@ Status PrefixedEntryRingBufferMulti::InternalPeekFrontWithPreamble(
 
 Status PrefixedEntryRingBufferMulti::InternalPeekFrontPreamble(
     const Reader& reader, uint32_t& user_preamble_out) const {
+  if (dering_in_progress()) {
+    return Status::FailedPrecondition();
+  }
   if (reader.entry_count_ == 0) {
     return Status::OutOfRange();
   }
@@ -182,7 +406,7 @@ Status PrefixedEntryRingBufferMulti::InternalRead(
     T read_output,
     bool include_preamble_in_output,
     uint32_t* user_preamble_out) const {
-  if (buffer_ == nullptr) {
+  if (buffer_ == nullptr || dering_in_progress()) {
     return Status::FailedPrecondition();
   }
   if (reader.entry_count_ == 0) {
@@ -215,37 +439,24 @@ Status PrefixedEntryRingBufferMulti::InternalRead(
   return status;
 }
 
-void PrefixedEntryRingBufferMulti::InternalPopFrontAll() {
-  // Forcefully pop all readers. Find the slowest reader, which must have
-  // the highest entry count, then pop all readers that have the same count.
-  //
-  // It is expected that InternalPopFrontAll is called only when there is
-  // something to pop from at least one reader. If no readers exist, or all
-  // readers are caught up, this function will assert.
-  size_t entry_count = GetSlowestReader().entry_count_;
-  PW_DCHECK_INT_NE(entry_count, 0);
-  // Otherwise, pop the readers that have the largest value.
-  for (Reader& reader : readers_) {
-    if (reader.entry_count_ == entry_count) {
-      reader.PopFront()
-          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
-    }
-  }
-}
-
 const Reader& PrefixedEntryRingBufferMulti::GetSlowestReader() const {
   PW_DCHECK_INT_GT(readers_.size(), 0);
+  if (slowest_reader_ != nullptr) {
+    return *slowest_reader_;
+  }
+
   const Reader* slowest_reader = &(*readers_.begin());
   for (const Reader& reader : readers_) {
     if (reader.entry_count_ > slowest_reader->entry_count_) {
       slowest_reader = &reader;
     }
   }
+  slowest_reader_ = slowest_reader;
   return *slowest_reader;
 }
 
 Status PrefixedEntryRingBufferMulti::Dering() {
-  if (buffer_ == nullptr || readers_.empty()) {
+  if (buffer_ == nullptr || readers_.empty() || reserved_) {
     return Status::FailedPrecondition();
   }
 
@@ -258,39 +469,101 @@ Status PrefixedEntryRingBufferMulti::Dering() {
   return InternalDering(slowest_reader);
 }
 
+StatusWithSize PrefixedEntryRingBufferMulti::DeringStep(size_t max_bytes) {
+  if (buffer_ == nullptr || readers_.empty() || reserved_) {
+    return StatusWithSize::FailedPrecondition();
+  }
+  if (max_bytes == 0u) {
+    return StatusWithSize::InvalidArgument();
+  }
+
+  if (!dering_in_progress()) {
+    StartDering();
+  }
+  ContinueDering(max_bytes);
+  return StatusWithSize(dering_bytes_remaining_);
+}
+
 Status PrefixedEntryRingBufferMulti::InternalDering(Reader& dering_reader) {
   if (buffer_ == nullptr || readers_.empty()) {
     return Status::FailedPrecondition();
   }
 
+  // Finish an incremental dering first, so the indices are up to date.
+  ContinueDering(std::numeric_limits<size_t>::max());
+
+  // Indices equal to the buffer size alias the start of the buffer.
+  const size_t shift = dering_reader.read_idx_ % buffer_bytes_;
   auto buffer_span = std::span(buffer_, buffer_bytes_);
-  std::rotate(buffer_span.begin(),
-              buffer_span.begin() + dering_reader.read_idx_,
-              buffer_span.end());
+  std::rotate(
+      buffer_span.begin(), buffer_span.begin() + shift, buffer_span.end());
+  ShiftIndices(shift);
+  return OkStatus();
+}
 
+void PrefixedEntryRingBufferMulti::StartDering() {
+  const size_t shift = GetSlowestReader().read_idx_ % buffer_bytes_;
+  if (shift == 0u) {
+    return;
+  }
+
+  // Rotating left by shift bytes splits the indices into gcd(size, shift)
+  // cycles, in which each byte is replaced by the one shift bytes after it.
+  dering_shift_ = shift;
+  dering_cycles_ = std::gcd(buffer_bytes_, shift);
+  dering_cycle_start_ = 0;
+  dering_idx_ = 0;
+  dering_carry_ = buffer_[0];
+  dering_bytes_remaining_ = buffer_bytes_;
+}
+
+void PrefixedEntryRingBufferMulti::ContinueDering(size_t max_bytes) {
+  for (; dering_in_progress() && max_bytes != 0u; --max_bytes) {
+    size_t next_idx = dering_idx_ + dering_shift_;
+    if (next_idx >= buffer_bytes_) {
+      next_idx -= buffer_bytes_;
+    }
+    dering_bytes_remaining_ -= 1;
+
+    if (next_idx != dering_cycle_start_) {
+      buffer_[dering_idx_] = buffer_[next_idx];
+      dering_idx_ = next_idx;
+      continue;
+    }
+
+    // The cycle is complete; its first byte belongs in the last index.
+    buffer_[dering_idx_] = dering_carry_;
+    dering_cycle_start_ += 1;
+    if (dering_cycle_start_ < dering_cycles_) {
+      dering_idx_ = dering_cycle_start_;
+      dering_carry_ = buffer_[dering_idx_];
+    }
+  }
+
+  if (dering_shift_ != 0u && !dering_in_progress()) {
+    ShiftIndices(dering_shift_);
+    dering_shift_ = 0;
+  }
+}
+
+void PrefixedEntryRingBufferMulti::ShiftIndices(size_t shift) {
   // If the new index is past the end of the buffer,
   // alias it back (wrap) to the start of the buffer.
-  if (write_idx_ < dering_reader.read_idx_) {
+  if (write_idx_ < shift) {
     write_idx_ += buffer_bytes_;
   }
-  write_idx_ -= dering_reader.read_idx_;
+  write_idx_ -= shift;
 
   for (Reader& reader : readers_) {
-    if (&reader == &dering_reader) {
-      continue;
-    }
-    if (reader.read_idx_ < dering_reader.read_idx_) {
+    if (reader.read_idx_ < shift) {
       reader.read_idx_ += buffer_bytes_;
     }
-    reader.read_idx_ -= dering_reader.read_idx_;
+    reader.read_idx_ -= shift;
   }
-
-  dering_reader.read_idx_ = 0;
-  return OkStatus();
 }
 
 Status PrefixedEntryRingBufferMulti::InternalPopFront(Reader& reader) {
-  if (buffer_ == nullptr) {
+  if (buffer_ == nullptr || dering_in_progress()) {
     return Status::FailedPrecondition();
   }
   if (reader.entry_count_ == 0) {
@@ -303,12 +576,79 @@ Status PrefixedEntryRingBufferMulti::InternalPopFront(Reader& reader) {
   size_t prev_read_idx = reader.read_idx_;
   reader.read_idx_ = IncrementIndex(prev_read_idx, entry_bytes);
   reader.entry_count_--;
+  InvalidateSlowestReader(reader);
+  return OkStatus();
+}
+
+Result<PrefixedEntryRingBufferMulti::EntrySpans>
+PrefixedEntryRingBufferMulti::InternalPeekFrontMany(const Reader& reader,
+                                                    size_t max_entries,
+                                                    size_t max_bytes) const {
+  if (buffer_ == nullptr || dering_in_progress()) {
+    return Status::FailedPrecondition();
+  }
+  if (reader.entry_count_ == 0 || max_entries == 0) {
+    return Status::OutOfRange();
+  }
+
+  // Walk the entry headers to find how many whole entries fit.
+  const size_t entries_to_read = std::min(max_entries, reader.entry_count_);
+  size_t total_bytes = 0;
+  size_t entry_count = 0;
+  size_t read_idx = reader.read_idx_;
+  while (entry_count < entries_to_read) {
+    Result<EntryInfo> info = RawFrontEntryInfo(read_idx);
+    PW_CHECK_OK(info.status());
+    const size_t entry_bytes = info.value().preamble_bytes +
+                               info.value().data_bytes;
+    if (entry_bytes > max_bytes - total_bytes) {
+      break;
+    }
+    total_bytes += entry_bytes;
+    read_idx = IncrementIndex(read_idx, entry_bytes);
+    entry_count += 1;
+  }
+
+  if (entry_count == 0) {
+    return Status::ResourceExhausted();
+  }
+
+  // The read index may alias the end of the buffer.
+  const size_t start_idx =
+      reader.read_idx_ == buffer_bytes_ ? 0 : reader.read_idx_;
+  const size_t bytes_until_wrap =
+      std::min(total_bytes, buffer_bytes_ - start_idx);
+  return EntrySpans{
+      .first = std::span<const byte>(buffer_ + start_idx, bytes_until_wrap),
+      .second = std::span<const byte>(buffer_, total_bytes - bytes_until_wrap),
+      .entry_count = entry_count,
+  };
+}
+
+Status PrefixedEntryRingBufferMulti::InternalPopFrontMany(Reader& reader,
+                                                          size_t entry_count) {
+  if (buffer_ == nullptr || dering_in_progress()) {
+    return Status::FailedPrecondition();
+  }
+  if (reader.entry_count_ < entry_count) {
+    return Status::OutOfRange();
+  }
+
+  for (size_t i = 0; i < entry_count; ++i) {
+    const EntryInfo info = FrontEntryInfo(reader);
+    reader.read_idx_ =
+        IncrementIndex(reader.read_idx_, info.preamble_bytes + info.data_bytes);
+  }
+  reader.entry_count_ -= entry_count;
+  if (entry_count != 0u) {
+    InvalidateSlowestReader(reader);
+  }
   return OkStatus();
 }
 
 size_t PrefixedEntryRingBufferMulti::InternalFrontEntryDataSizeBytes(
     const Reader& reader) const {
-  if (reader.entry_count_ == 0) {
+  if (reader.entry_count_ == 0 || dering_in_progress()) {
     return 0;
   }
   return FrontEntryInfo(reader).data_bytes;
@@ -316,7 +656,7 @@ size_t PrefixedEntryRingBufferMulti::InternalFrontEntryDataSizeBytes(
 
 size_t PrefixedEntryRingBufferMulti::InternalFrontEntryTotalSizeBytes(
     const Reader& reader) const {
-  if (reader.entry_count_ == 0) {
+  if (reader.entry_count_ == 0 || dering_in_progress()) {
     return 0;
   }
   EntryInfo info = FrontEntryInfo(reader);
@@ -373,7 +713,8 @@ size_t PrefixedEntryRingBufferMulti::RawAvailableBytes() const {
     return buffer_bytes_;
   }
 
-  size_t read_idx = GetSlowestReader().read_idx_;
+  const Reader& slowest_reader = GetSlowestReader();
+  size_t read_idx = slowest_reader.read_idx_;
   // Case: Not wrapped.
   if (read_idx < write_idx_) {
     return buffer_bytes_ - (write_idx_ - read_idx);
@@ -382,13 +723,9 @@ size_t PrefixedEntryRingBufferMulti::RawAvailableBytes() const {
   if (read_idx > write_idx_) {
     return read_idx - write_idx_;
   }
-  // Case: Matched read and write heads; empty or full.
-  for (const Reader& reader : readers_) {
-    if (reader.read_idx_ == read_idx && reader.entry_count_ != 0) {
-      return 0;
-    }
-  }
-  return buffer_bytes_;
+  // Case: Matched read and write heads; empty or full. The buffer is full if
+  // the slowest reader has any entries left.
+  return slowest_reader.entry_count_ != 0 ? 0 : buffer_bytes_;
 }
 
 void PrefixedEntryRingBufferMulti::RawWrite(std::span<const std::byte> source) {
@@ -439,50 +776,87 @@ Status PrefixedEntryRingBufferMulti::Reader::PeekFrontWithPreamble(
       *this, GetOutput(data, &entry_bytes_read_out), false, &user_preamble_out);
 }
 
-iterator& iterator::operator++() {
+size_t PrefixedEntryRingBufferMulti::UsedBytesFrom(size_t read_idx,
+                                                   size_t entry_count) const {
+  read_idx %= buffer_bytes_;
+  const size_t write_idx = write_idx_ % buffer_bytes_;
+  if (read_idx == write_idx) {
+    return entry_count != 0u ? buffer_bytes_ : 0;
+  }
+  return write_idx > read_idx ? write_idx - read_idx
+                              : buffer_bytes_ - (read_idx - write_idx);
+}
+
+wrapped_iterator::wrapped_iterator(const Reader& reader)
+    : ring_buffer_(reader.buffer_),
+      read_idx_(reader.read_idx_),
+      entry_count_(reader.entry_count_),
+      bytes_remaining_(0) {
+  if (ring_buffer_ == nullptr || ring_buffer_->dering_in_progress()) {
+    SkipToEnd(Status::FailedPrecondition());
+    return;
+  }
+  bytes_remaining_ = ring_buffer_->UsedBytesFrom(read_idx_, entry_count_);
+  ReadEntry();
+}
+
+wrapped_iterator& wrapped_iterator::operator++() {
   PW_DCHECK_OK(iteration_status_);
   PW_DCHECK_INT_NE(entry_count_, 0);
 
-  Result<EntryInfo> info = ring_buffer_->RawFrontEntryInfo(read_idx_);
-  if (!info.status().ok()) {
-    SkipToEnd(info.status());
-    return *this;
-  }
-
-  // It is guaranteed that the buffer is deringed at this point.
-  read_idx_ += info.value().preamble_bytes + info.value().data_bytes;
+  // ReadEntry() checked that the entry's header is valid and that the entry
+  // fits in the remaining bytes.
+  const EntryInfo info = ring_buffer_->RawFrontEntryInfo(read_idx_).value();
+  const size_t entry_bytes = info.preamble_bytes + info.data_bytes;
+  read_idx_ = ring_buffer_->IncrementIndex(read_idx_, entry_bytes);
+  bytes_remaining_ -= entry_bytes;
   entry_count_--;
 
-  if (entry_count_ == 0) {
+  ReadEntry();
+  return *this;
+}
+
+void wrapped_iterator::ReadEntry() {
+  if (entry_count_ == 0u) {
     SkipToEnd(OkStatus());
-    return *this;
+    return;
   }
 
-  if (read_idx_ >= ring_buffer_->TotalUsedBytes()) {
+  Result<EntryInfo> info = ring_buffer_->RawFrontEntryInfo(read_idx_);
+  if (!info.ok()) {
+    SkipToEnd(info.status());
+    return;
+  }
+  if (info.value().preamble_bytes > bytes_remaining_ ||
+      info.value().data_bytes >
+          bytes_remaining_ - info.value().preamble_bytes) {
     SkipToEnd(Status::DataLoss());
-    return *this;
+    return;
   }
 
-  info = ring_buffer_->RawFrontEntryInfo(read_idx_);
-  if (!info.status().ok()) {
-    SkipToEnd(info.status());
-    return *this;
-  }
-  return *this;
+  // The data index may alias the end of the buffer.
+  const size_t buffer_bytes = ring_buffer_->buffer_bytes_;
+  const size_t data_idx =
+      ring_buffer_->IncrementIndex(read_idx_, info.value().preamble_bytes) %
+      buffer_bytes;
+  const size_t bytes_until_wrap =
+      std::min(info.value().data_bytes, buffer_bytes - data_idx);
+  entry_ = {
+      .first = std::span<const byte>(ring_buffer_->buffer_ + data_idx,
+                                     bytes_until_wrap),
+      .second = std::span<const byte>(
+          ring_buffer_->buffer_, info.value().data_bytes - bytes_until_wrap),
+      .preamble = info.value().user_preamble,
+  };
 }
 
 const Entry& iterator::operator*() const {
-  PW_DCHECK_OK(iteration_status_);
-  PW_DCHECK_INT_NE(entry_count_, 0);
-
-  Result<EntryInfo> info = ring_buffer_->RawFrontEntryInfo(read_idx_);
-  PW_DCHECK_OK(info.status());
+  const WrappedEntry& entry = *it_;
+  PW_DCHECK(entry.second.empty());
 
   entry_ = {
-      .buffer = std::span<const byte>(
-          ring_buffer_->buffer_ + read_idx_ + info.value().preamble_bytes,
-          info.value().data_bytes),
-      .preamble = info.value().user_preamble,
+      .buffer = entry.first,
+      .preamble = entry.preamble,
   };
   return entry_;
 }
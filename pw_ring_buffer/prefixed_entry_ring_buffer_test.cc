@@ -14,8 +14,10 @@
 
 #include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include "pw_assert/check.h"
 #include "pw_containers/vector.h"
@@ -886,6 +888,587 @@ TEST(PrefixedEntryRingBufferMulti, IteratorBufferCorruption) {
   EXPECT_EQ(validated_entries, valid_entries);
 }
 
+// Concatenates the spans returned by PeekFrontMany.
+Vector<byte, 64> Concatenate(
+    const PrefixedEntryRingBufferMulti::EntrySpans& spans) {
+  Vector<byte, 64> bytes(spans.first.begin(), spans.first.end());
+  for (byte b : spans.second) {
+    bytes.push_back(b);
+  }
+  return bytes;
+}
+
+constexpr byte kEntryA[] = {byte(0xa1), byte(0xa2)};
+constexpr byte kEntryB[] = {byte(0xb1), byte(0xb2), byte(0xb3)};
+constexpr byte kEntryC[] = {byte(0xc1)};
+constexpr std::span<const byte> kEntries[] = {kEntryA, kEntryB, kEntryC};
+
+TEST(PrefixedEntryRingBuffer, PushBackMany_ReadEntriesBack) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[32];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  ASSERT_EQ(ring.PushBackMany(kEntries), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 3u);
+  EXPECT_EQ(ring.TotalUsedBytes(), 9u);
+
+  for (std::span<const byte> expected : kEntries) {
+    byte value[8];
+    size_t bytes_read = 0;
+    ASSERT_EQ(ring.PeekFront(value, &bytes_read), OkStatus());
+    ASSERT_EQ(bytes_read, expected.size());
+    EXPECT_EQ(std::memcmp(value, expected.data(), expected.size()), 0);
+    ASSERT_EQ(ring.PopFront(), OkStatus());
+  }
+}
+
+TEST(PrefixedEntryRingBuffer, PushBackMany_WithPreamble) {
+  PrefixedEntryRingBuffer ring(true);
+  byte test_buffer[32];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  ASSERT_EQ(ring.PushBackMany(kEntries, 7), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 3u);
+  for (size_t i = 0; i < 3; ++i) {
+    uint32_t preamble = 0;
+    ASSERT_EQ(ring.PeekFrontPreamble(preamble), OkStatus());
+    EXPECT_EQ(preamble, 7u);
+    ASSERT_EQ(ring.PopFront(), OkStatus());
+  }
+}
+
+TEST(PrefixedEntryRingBuffer, PushBackMany_TooLarge_NothingWritten) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[8];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  EXPECT_EQ(ring.PushBackMany(kEntries), Status::OutOfRange());
+  EXPECT_EQ(ring.EntryCount(), 0u);
+}
+
+TEST(PrefixedEntryRingBuffer, PushBackMany_EvictsOldEntries) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[12];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  ASSERT_EQ(ring.PushBack(kEntryB), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntryB), OkStatus());
+  EXPECT_EQ(ring.TryPushBackMany(kEntries), Status::ResourceExhausted());
+  EXPECT_EQ(ring.EntryCount(), 2u);
+
+  ASSERT_EQ(ring.PushBackMany(kEntries), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 3u);
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), sizeof(kEntryA));
+}
+
+TEST(PrefixedEntryRingBuffer, PeekFrontMany_Contiguous) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[32];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+  ASSERT_EQ(ring.PushBackMany(kEntries), OkStatus());
+
+  Result<PrefixedEntryRingBufferMulti::EntrySpans> spans =
+      ring.PeekFrontMany(2);
+  ASSERT_EQ(spans.status(), OkStatus());
+  EXPECT_EQ(spans.value().entry_count, 2u);
+  EXPECT_TRUE(spans.value().second.empty());
+
+  constexpr byte kExpected[] = {
+      byte(2), byte(0xa1), byte(0xa2), byte(3), byte(0xb1), byte(0xb2),
+      byte(0xb3)};
+  Vector<byte, 64> bytes = Concatenate(spans.value());
+  ASSERT_EQ(bytes.size(), sizeof(kExpected));
+  EXPECT_EQ(std::memcmp(bytes.data(), kExpected, sizeof(kExpected)), 0);
+
+  ASSERT_EQ(ring.PopFrontMany(2), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), sizeof(kEntryC));
+}
+
+TEST(PrefixedEntryRingBuffer, PeekFrontMany_Wrapped) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[10];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // Move the read and write positions near the end of the buffer.
+  ASSERT_EQ(ring.PushBack(kEntryB), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntryB), OkStatus());
+  ASSERT_EQ(ring.PopFrontMany(2), OkStatus());
+
+  ASSERT_EQ(ring.PushBackMany(kEntries), OkStatus());
+  Result<PrefixedEntryRingBufferMulti::EntrySpans> spans =
+      ring.PeekFrontMany(3);
+  ASSERT_EQ(spans.status(), OkStatus());
+  EXPECT_EQ(spans.value().entry_count, 3u);
+  EXPECT_EQ(spans.value().first.size(), 2u);
+  EXPECT_EQ(spans.value().second.size(), 7u);
+
+  constexpr byte kExpected[] = {byte(2),
+                                byte(0xa1),
+                                byte(0xa2),
+                                byte(3),
+                                byte(0xb1),
+                                byte(0xb2),
+                                byte(0xb3),
+                                byte(1),
+                                byte(0xc1)};
+  Vector<byte, 64> bytes = Concatenate(spans.value());
+  ASSERT_EQ(bytes.size(), sizeof(kExpected));
+  EXPECT_EQ(std::memcmp(bytes.data(), kExpected, sizeof(kExpected)), 0);
+}
+
+TEST(PrefixedEntryRingBuffer, PeekFrontMany_MaxBytes) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[32];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+  ASSERT_EQ(ring.PushBackMany(kEntries), OkStatus());
+
+  Result<PrefixedEntryRingBufferMulti::EntrySpans> spans =
+      ring.PeekFrontMany(3, 6);
+  ASSERT_EQ(spans.status(), OkStatus());
+  EXPECT_EQ(spans.value().entry_count, 1u);
+  EXPECT_EQ(spans.value().size_bytes(), 3u);
+
+  EXPECT_EQ(ring.PeekFrontMany(3, 2).status(), Status::ResourceExhausted());
+}
+
+TEST(PrefixedEntryRingBuffer, PeekAndPopFrontMany_Empty) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[32];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  EXPECT_EQ(ring.PeekFrontMany(1).status(), Status::OutOfRange());
+  ASSERT_EQ(ring.PushBack(kEntryA), OkStatus());
+  EXPECT_EQ(ring.PopFrontMany(2), Status::OutOfRange());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+}
+
+TEST(PrefixedEntryRingBufferMulti, PopFrontMany_OtherReadersUnaffected) {
+  PrefixedEntryRingBufferMulti ring;
+  byte test_buffer[32];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  PrefixedEntryRingBufferMulti::Reader fast_reader;
+  PrefixedEntryRingBufferMulti::Reader slow_reader;
+  ASSERT_EQ(ring.AttachReader(fast_reader), OkStatus());
+  ASSERT_EQ(ring.AttachReader(slow_reader), OkStatus());
+
+  ASSERT_EQ(ring.PushBackMany(kEntries), OkStatus());
+  ASSERT_EQ(fast_reader.PopFrontMany(3), OkStatus());
+  EXPECT_EQ(fast_reader.EntryCount(), 0u);
+  EXPECT_EQ(slow_reader.EntryCount(), 3u);
+  EXPECT_EQ(ring.TotalUsedBytes(), 9u);
+}
+
+TEST(PrefixedEntryRingBufferMulti, SlowestReaderChanges) {
+  PrefixedEntryRingBufferMulti ring;
+  byte test_buffer[9];  // Holds three one-byte entries of kEntryA.
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  PrefixedEntryRingBufferMulti::Reader reader_a;
+  PrefixedEntryRingBufferMulti::Reader reader_b;
+  ASSERT_EQ(ring.AttachReader(reader_a), OkStatus());
+  ASSERT_EQ(ring.AttachReader(reader_b), OkStatus());
+
+  ASSERT_EQ(ring.PushBack(kEntryA), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntryA), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntryA), OkStatus());
+
+  // Reader B is the slowest until it catches up with, then passes, reader A.
+  ASSERT_EQ(reader_a.PopFront(), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 9u);
+  ASSERT_EQ(reader_b.PopFrontMany(3), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 6u);
+
+  // Evicting for a new entry only drops reader A's oldest entry.
+  ASSERT_EQ(ring.PushBack(kEntryA), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntryA), OkStatus());
+  EXPECT_EQ(reader_a.EntryCount(), 3u);
+  EXPECT_EQ(reader_b.EntryCount(), 2u);
+
+  // Detaching the slowest reader frees its entries.
+  ASSERT_EQ(ring.DetachReader(reader_a), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 6u);
+  ASSERT_EQ(reader_b.PopFront(), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 3u);
+}
+
+// Copies data into the spans returned by Reserve, wrapping as needed.
+void CopyToReserved(const PrefixedEntryRingBufferMulti::ReservedSpans& spans,
+                    std::span<const byte> data) {
+  const size_t first_bytes = std::min(data.size(), spans.first.size());
+  std::memcpy(spans.first.data(), data.data(), first_bytes);
+  std::memcpy(spans.second.data(),
+              data.data() + first_bytes,
+              data.size() - first_bytes);
+}
+
+TEST(PrefixedEntryRingBuffer, Reserve_CommitReadsBack) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[32];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  Result<PrefixedEntryRingBufferMulti::ReservedSpans> spans = ring.Reserve(8);
+  ASSERT_EQ(spans.status(), OkStatus());
+  EXPECT_EQ(spans.value().size_bytes(), 8u);
+  EXPECT_TRUE(spans.value().second.empty());
+  EXPECT_EQ(ring.EntryCount(), 0u);
+
+  CopyToReserved(spans.value(), kEntryB);
+  ASSERT_EQ(ring.Commit(sizeof(kEntryB)), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+  EXPECT_EQ(ring.TotalUsedBytes(), 1u + sizeof(kEntryB));
+
+  byte value[8];
+  size_t bytes_read = 0;
+  ASSERT_EQ(ring.PeekFront(value, &bytes_read), OkStatus());
+  ASSERT_EQ(bytes_read, sizeof(kEntryB));
+  EXPECT_EQ(std::memcmp(value, kEntryB, sizeof(kEntryB)), 0);
+}
+
+TEST(PrefixedEntryRingBuffer, Reserve_Wrapped) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[10];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // Move the write index to the middle of the buffer.
+  constexpr byte kFourBytes[4] = {};
+  ASSERT_EQ(ring.PushBack(kFourBytes), OkStatus());
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+
+  constexpr byte kSixBytes[6] = {
+      byte(1), byte(2), byte(3), byte(4), byte(5), byte(6)};
+  Result<PrefixedEntryRingBufferMulti::ReservedSpans> spans =
+      ring.Reserve(sizeof(kSixBytes));
+  ASSERT_EQ(spans.status(), OkStatus());
+  EXPECT_EQ(spans.value().first.size(), 4u);
+  EXPECT_EQ(spans.value().second.size(), 2u);
+
+  CopyToReserved(spans.value(), kSixBytes);
+  ASSERT_EQ(ring.Commit(sizeof(kSixBytes)), OkStatus());
+
+  byte value[8];
+  size_t bytes_read = 0;
+  ASSERT_EQ(ring.PeekFront(value, &bytes_read), OkStatus());
+  ASSERT_EQ(bytes_read, sizeof(kSixBytes));
+  EXPECT_EQ(std::memcmp(value, kSixBytes, sizeof(kSixBytes)), 0);
+}
+
+TEST(PrefixedEntryRingBuffer, Reserve_CommitLessThanReserved) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[256];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // The length prefix is sized for the reservation.
+  Result<PrefixedEntryRingBufferMulti::ReservedSpans> spans = ring.Reserve(200);
+  ASSERT_EQ(spans.status(), OkStatus());
+  CopyToReserved(spans.value(), kEntryB);
+  ASSERT_EQ(ring.Commit(sizeof(kEntryB)), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntryA), OkStatus());
+
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), sizeof(kEntryB));
+  EXPECT_EQ(ring.FrontEntryTotalSizeBytes(), 2u + sizeof(kEntryB));
+  EXPECT_EQ(ring.TotalUsedBytes(),
+            2u + sizeof(kEntryB) + 1u + sizeof(kEntryA));
+
+  constexpr std::span<const byte> kExpected[] = {kEntryB, kEntryA};
+  for (std::span<const byte> expected : kExpected) {
+    byte value[8];
+    size_t bytes_read = 0;
+    ASSERT_EQ(ring.PeekFront(value, &bytes_read), OkStatus());
+    ASSERT_EQ(bytes_read, expected.size());
+    EXPECT_EQ(std::memcmp(value, expected.data(), expected.size()), 0);
+    ASSERT_EQ(ring.PopFront(), OkStatus());
+  }
+}
+
+TEST(PrefixedEntryRingBuffer, Reserve_WithPreamble) {
+  PrefixedEntryRingBuffer ring(true);
+  byte test_buffer[32];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  Result<PrefixedEntryRingBufferMulti::ReservedSpans> spans =
+      ring.Reserve(sizeof(kEntryA), 300);
+  ASSERT_EQ(spans.status(), OkStatus());
+  CopyToReserved(spans.value(), kEntryA);
+  ASSERT_EQ(ring.Commit(sizeof(kEntryA)), OkStatus());
+
+  uint32_t preamble = 0;
+  ASSERT_EQ(ring.PeekFrontPreamble(preamble), OkStatus());
+  EXPECT_EQ(preamble, 300u);
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), sizeof(kEntryA));
+}
+
+TEST(PrefixedEntryRingBuffer, Reserve_BlocksOtherWrites) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[32];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  EXPECT_EQ(ring.Commit(1), Status::FailedPrecondition());
+
+  ASSERT_EQ(ring.Reserve(4).status(), OkStatus());
+  EXPECT_EQ(ring.PushBack(kEntryA), Status::FailedPrecondition());
+  EXPECT_EQ(ring.PushBackMany(kEntries), Status::FailedPrecondition());
+  EXPECT_EQ(ring.Reserve(4).status(), Status::FailedPrecondition());
+  EXPECT_EQ(ring.Dering(), Status::FailedPrecondition());
+  EXPECT_EQ(ring.Commit(5), Status::InvalidArgument());
+
+  ring.CancelReservation();
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  EXPECT_EQ(ring.Commit(1), Status::FailedPrecondition());
+  EXPECT_EQ(ring.PushBack(kEntryA), OkStatus());
+}
+
+TEST(PrefixedEntryRingBuffer, Reserve_EvictsOldEntries) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[8];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  ASSERT_EQ(ring.PushBack(kEntryB), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntryB), OkStatus());
+  EXPECT_EQ(ring.TryReserve(3).status(), Status::ResourceExhausted());
+  EXPECT_EQ(ring.EntryCount(), 2u);
+
+  ASSERT_EQ(ring.Reserve(3).status(), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+  ASSERT_EQ(ring.Commit(3), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 2u);
+
+  EXPECT_EQ(ring.Reserve(8).status(), Status::OutOfRange());
+}
+
+TEST(PrefixedEntryRingBuffer, RestorePosition_RestoresEntries) {
+  byte test_buffer[16];
+  PrefixedEntryRingBufferMulti::Position position;
+  {
+    PrefixedEntryRingBuffer ring(true);
+    ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+    // Push enough entries to wrap around the end of the buffer.
+    for (uint32_t i = 0; i < 5; ++i) {
+      ASSERT_EQ(ring.PushBack(kEntryB, i), OkStatus());
+    }
+    position = ring.GetPosition();
+    EXPECT_EQ(position.entry_count, 3u);
+  }
+
+  // A new ring buffer over the same memory, as after a reset.
+  PrefixedEntryRingBuffer ring(true);
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  ASSERT_EQ(ring.RestorePosition(position), OkStatus());
+  ASSERT_EQ(ring.EntryCount(), 3u);
+
+  for (uint32_t i = 2; i < 5; ++i) {
+    uint32_t preamble = 0;
+    ASSERT_EQ(ring.PeekFrontPreamble(preamble), OkStatus());
+    EXPECT_EQ(preamble, i);
+    EXPECT_EQ(ring.FrontEntryDataSizeBytes(), sizeof(kEntryB));
+    ASSERT_EQ(ring.PopFront(), OkStatus());
+  }
+  EXPECT_EQ(ring.PushBack(kEntryA, 5), OkStatus());
+}
+
+TEST(PrefixedEntryRingBuffer, RestorePosition_Empty) {
+  byte test_buffer[16];
+  PrefixedEntryRingBuffer ring(false);
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  PrefixedEntryRingBufferMulti::Position position = ring.GetPosition();
+  EXPECT_EQ(ring.RestorePosition(position), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 0u);
+}
+
+TEST(PrefixedEntryRingBuffer, RestorePosition_Mismatch_DataLoss) {
+  byte test_buffer[16];
+  PrefixedEntryRingBuffer ring(false);
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntryA), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntryB), OkStatus());
+  const PrefixedEntryRingBufferMulti::Position position = ring.GetPosition();
+
+  PrefixedEntryRingBufferMulti::Position bad = position;
+  bad.entry_count += 1;
+  EXPECT_EQ(ring.RestorePosition(bad), Status::DataLoss());
+
+  bad = position;
+  bad.write_idx -= 1;
+  EXPECT_EQ(ring.RestorePosition(bad), Status::DataLoss());
+
+  bad = position;
+  bad.read_idx = sizeof(test_buffer) + 1;
+  EXPECT_EQ(ring.RestorePosition(bad), Status::DataLoss());
+
+  // Corrupt the first entry's length.
+  test_buffer[0] = byte(0x7f);
+  EXPECT_EQ(ring.RestorePosition(position), Status::DataLoss());
+  test_buffer[0] = byte(sizeof(kEntryA));
+
+  // Failed restores leave the ring buffer unchanged.
+  EXPECT_EQ(ring.EntryCount(), 2u);
+  EXPECT_EQ(ring.RestorePosition(position), OkStatus());
+}
+
+// Fills the ring buffer so that entries wrap around the end of test_buffer.
+void PushWrappedEntries(PrefixedEntryRingBuffer& ring) {
+  ASSERT_EQ(ring.PushBack(kEntryB), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntryB), OkStatus());
+  ASSERT_EQ(ring.PopFrontMany(2), OkStatus());
+  ASSERT_EQ(ring.PushBackMany(kEntries), OkStatus());
+}
+
+TEST(PrefixedEntryRingBuffer, WrappedIterator_DoesNotDering) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[10];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+  PushWrappedEntries(ring);
+
+  byte original_buffer[sizeof(test_buffer)];
+  std::memcpy(original_buffer, test_buffer, sizeof(test_buffer));
+
+  size_t entry_count = 0;
+  auto entries = ring.wrapped_entries();
+  PrefixedEntryRingBufferMulti::wrapped_iterator it = entries.begin();
+  for (; it != entries.end(); ++it) {
+    const std::span<const byte> expected = kEntries[entry_count];
+    Vector<byte, 8> data(it->first.begin(), it->first.end());
+    for (byte b : it->second) {
+      data.push_back(b);
+    }
+    ASSERT_EQ(data.size(), expected.size());
+    EXPECT_EQ(std::memcmp(data.data(), expected.data(), expected.size()), 0);
+    entry_count += 1;
+  }
+  EXPECT_EQ(it.status(), OkStatus());
+  EXPECT_EQ(entry_count, std::size(kEntries));
+
+  // The first entry wraps around the end of the buffer, which is unchanged.
+  EXPECT_EQ(ring.wrapped_entries().begin()->second.size(), 1u);
+  EXPECT_EQ(
+      std::memcmp(original_buffer, test_buffer, sizeof(test_buffer)), 0);
+}
+
+TEST(PrefixedEntryRingBuffer, WrappedIterator_Empty) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[10];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  auto entries = ring.wrapped_entries();
+  EXPECT_EQ(entries.begin(), entries.end());
+  EXPECT_EQ(entries.begin().status(), OkStatus());
+}
+
+TEST(PrefixedEntryRingBuffer, WrappedIterator_Corruption_DataLoss) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[10];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+  PushWrappedEntries(ring);
+
+  // Make the second entry's length run past the write index.
+  test_buffer[1] = byte(0x7f);
+
+  size_t entry_count = 0;
+  auto entries = ring.wrapped_entries();
+  PrefixedEntryRingBufferMulti::wrapped_iterator it = entries.begin();
+  for (; it != entries.end(); ++it) {
+    entry_count += 1;
+  }
+  EXPECT_EQ(it.status(), Status::DataLoss());
+  EXPECT_EQ(entry_count, 1u);
+}
+
+TEST(PrefixedEntryRingBuffer, DeringStep_MatchesDering) {
+  constexpr size_t kBufferSize = 64;
+  byte step_buffer[kBufferSize];
+  byte dering_buffer[kBufferSize];
+  PrefixedEntryRingBuffer stepped(true);
+  PrefixedEntryRingBuffer deringed(true);
+  ASSERT_EQ(stepped.SetBuffer(step_buffer), OkStatus());
+  ASSERT_EQ(deringed.SetBuffer(dering_buffer), OkStatus());
+
+  // Wrap the buffers with entries of varying sizes.
+  for (uint32_t i = 0; i < 40; ++i) {
+    const byte data[] = {byte(i), byte(i + 1), byte(i + 2)};
+    const std::span<const byte> entry = std::span(data).first(i % 3 + 1);
+    ASSERT_EQ(stepped.PushBack(entry, i), OkStatus());
+    ASSERT_EQ(deringed.PushBack(entry, i), OkStatus());
+  }
+  ASSERT_EQ(deringed.Dering(), OkStatus());
+
+  size_t steps = 0;
+  StatusWithSize result;
+  do {
+    result = stepped.DeringStep(5);
+    ASSERT_EQ(result.status(), OkStatus());
+    steps += 1;
+
+    if (result.size() != 0u) {
+      EXPECT_TRUE(stepped.dering_in_progress());
+      EXPECT_EQ(stepped.PushBack(std::as_bytes(std::span("x", 1))),
+                Status::FailedPrecondition());
+      EXPECT_EQ(stepped.PopFront(), Status::FailedPrecondition());
+      EXPECT_EQ(stepped.wrapped_entries().begin().status(),
+                Status::FailedPrecondition());
+    }
+  } while (result.size() != 0u);
+
+  EXPECT_FALSE(stepped.dering_in_progress());
+  EXPECT_EQ(steps, (kBufferSize + 4) / 5);
+  EXPECT_EQ(std::memcmp(step_buffer, dering_buffer, kBufferSize), 0);
+  EXPECT_EQ(stepped.GetPosition().read_idx, 0u);
+  EXPECT_EQ(stepped.GetPosition().write_idx,
+            deringed.GetPosition().write_idx);
+  EXPECT_EQ(stepped.EntryCount(), deringed.EntryCount());
+  EXPECT_EQ(stepped.CheckForCorruption(), OkStatus());
+}
+
+TEST(PrefixedEntryRingBuffer, DeringStep_AlreadyDeringed) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[10];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+  ASSERT_EQ(ring.PushBack(kEntryA), OkStatus());
+
+  const StatusWithSize result = ring.DeringStep(1);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 0u);
+  EXPECT_EQ(ring.DeringStep(0).status(), Status::InvalidArgument());
+}
+
+TEST(PrefixedEntryRingBuffer, Dering_FinishesDeringStep) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[10];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+  PushWrappedEntries(ring);
+
+  EXPECT_EQ(ring.DeringStep(3).size(), sizeof(test_buffer) - 3);
+  ASSERT_EQ(ring.Dering(), OkStatus());
+  EXPECT_FALSE(ring.dering_in_progress());
+
+  constexpr byte kExpected[] = {byte(2),
+                                byte(0xa1),
+                                byte(0xa2),
+                                byte(3),
+                                byte(0xb1),
+                                byte(0xb2),
+                                byte(0xb3),
+                                byte(1),
+                                byte(0xc1)};
+  EXPECT_EQ(std::memcmp(test_buffer, kExpected, sizeof(kExpected)), 0);
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), sizeof(kEntryA));
+}
+
+TEST(PrefixedEntryRingBuffer, Clear_AbandonsDeringStep) {
+  PrefixedEntryRingBuffer ring(false);
+  byte test_buffer[10];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+  PushWrappedEntries(ring);
+
+  EXPECT_NE(ring.DeringStep(3).size(), 0u);
+  ring.Clear();
+  EXPECT_FALSE(ring.dering_in_progress());
+  EXPECT_EQ(ring.PushBack(kEntryA), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+}
+
 }  // namespace
 }  // namespace ring_buffer
 }  // namespace pw
@@ -14,11 +14,13 @@
 #pragma once
 
 #include <cstddef>
+#include <limits>
 #include <span>
 
 #include "pw_containers/intrusive_list.h"
 #include "pw_result/result.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 
 namespace pw {
 namespace ring_buffer {
@@ -42,6 +44,37 @@ class PrefixedEntryRingBufferMulti {
  public:
   typedef Status (*ReadOutput)(std::span<const std::byte>);
 
+  // The raw contents of one or more consecutive entries, as stored in the ring
+  // buffer. Each entry is included with its preamble, in the same format as
+  // PeekFrontWithPreamble(). The entries continue from first into second if
+  // they wrap around the end of the buffer; otherwise second is empty.
+  struct EntrySpans {
+    std::span<const std::byte> first;
+    std::span<const std::byte> second;
+    size_t entry_count;
+
+    size_t size_bytes() const { return first.size() + second.size(); }
+  };
+
+  // Where the entries are in the buffer, from the oldest entry of the slowest
+  // reader to the write index. Saving the position alongside the buffer, e.g.
+  // in persistent memory, allows the entries to be restored after a reset.
+  struct Position {
+    uint32_t read_idx;
+    uint32_t write_idx;
+    uint32_t entry_count;
+  };
+
+  // Writable space for one entry, returned by Reserve(). The entry's data is
+  // written to first and continues into second if the space wraps around the
+  // end of the buffer; otherwise second is empty.
+  struct ReservedSpans {
+    std::span<std::byte> first;
+    std::span<std::byte> second;
+
+    size_t size_bytes() const { return first.size() + second.size(); }
+  };
+
   // A reader that provides a single-reader interface into the multi-reader ring
   // buffer it has been attached to via AttachReader(). Readers maintain their
   // read position in the ring buffer as well as the remaining count of entries
@@ -129,6 +162,41 @@ class PrefixedEntryRingBufferMulti {
     // OUT_OF_RANGE - No entries in ring buffer to pop.
     Status PopFront() { return buffer_->InternalPopFront(*this); }
 
+    // Returns up to max_entries of the oldest entries, including their
+    // preambles, as at most two spans into the ring buffer. Only whole entries
+    // are included, up to a total of max_bytes. Nothing is copied, so the
+    // entries can be drained with one or two large copies. The spans are valid
+    // until the entries are popped or the buffer is written to.
+    //
+    // Precondition: the buffer data must not be corrupt, otherwise there will
+    // be a crash.
+    //
+    // Return values:
+    // OK - The spans cover at least one entry.
+    // FAILED_PRECONDITION - Buffer not initialized.
+    // OUT_OF_RANGE - No entries in ring buffer to read.
+    // RESOURCE_EXHAUSTED - The front entry is larger than max_bytes.
+    Result<EntrySpans> PeekFrontMany(
+        size_t max_entries,
+        size_t max_bytes = std::numeric_limits<size_t>::max()) const {
+      return buffer_->InternalPeekFrontMany(*this, max_entries, max_bytes);
+    }
+
+    // Pop and discard the oldest entry_count entries, for example the entries
+    // returned by PeekFrontMany().
+    //
+    // Precondition: the buffer data must not be corrupt, otherwise there will
+    // be a crash.
+    //
+    // Return values:
+    // OK - Entries successfully popped.
+    // FAILED_PRECONDITION - Buffer not initialized.
+    // OUT_OF_RANGE - Fewer than entry_count entries in the ring buffer. No
+    // entries were popped.
+    Status PopFrontMany(size_t entry_count) {
+      return buffer_->InternalPopFrontMany(*this, entry_count);
+    }
+
     // Get the size in bytes of the next chunk, not including preamble, to be
     // read.
     //
@@ -178,22 +246,98 @@ class PrefixedEntryRingBufferMulti {
     uint32_t preamble;
   };
 
+  // An entry returned by the wrapped_iterator, which leaves entries where they
+  // are in the buffer. The entry's data continues from first into second if it
+  // wraps around the end of the buffer; otherwise second is empty.
+  struct WrappedEntry {
+    std::span<const std::byte> first;
+    std::span<const std::byte> second;
+    uint32_t preamble;
+
+    size_t size_bytes() const { return first.size() + second.size(); }
+  };
+
+  // An iterator that walks through all entries from a given Reader position
+  // without modifying the buffer, so it can be used where deringing would take
+  // too long or must not move data, such as while a lock is held in a crash
+  // handler. Entries that wrap around the end of the buffer are returned in
+  // two parts.
+  //
+  // The buffer must not be written to while the iterator is in use. Nothing is
+  // returned while an incremental dering is in progress; status() returns
+  // FAILED_PRECONDITION.
+  class wrapped_iterator {
+   public:
+    wrapped_iterator() : ring_buffer_(nullptr), read_idx_(0), entry_count_(0) {}
+    wrapped_iterator(const Reader& reader);
+
+    wrapped_iterator& operator++();
+    wrapped_iterator operator++(int) {
+      wrapped_iterator original = *this;
+      ++*this;
+      return original;
+    }
+
+    // Returns entry at current position.
+    const WrappedEntry& operator*() const { return entry_; }
+    const WrappedEntry* operator->() const { return &entry_; }
+
+    constexpr bool operator==(const wrapped_iterator& rhs) const {
+      return entry_count_ == rhs.entry_count_;
+    }
+
+    constexpr bool operator!=(const wrapped_iterator& rhs) const {
+      return entry_count_ != rhs.entry_count_;
+    }
+
+    // Returns the status of the last iteration operation. If the iterator
+    // fails to read an entry, it will move to wrapped_iterator::end() and
+    // indicate the failure reason here.
+    Status status() const { return iteration_status_; }
+
+   private:
+    // Reads the entry at read_idx_ into entry_, or moves to the end if there
+    // are no more entries or the entry is corrupt.
+    void ReadEntry();
+
+    void SkipToEnd(Status status) {
+      iteration_status_ = status;
+      entry_ = {};
+      entry_count_ = 0;
+    }
+
+    const PrefixedEntryRingBufferMulti* ring_buffer_;
+    size_t read_idx_;
+    size_t entry_count_;
+
+    // The bytes from read_idx_ to the write index, used to detect corruption.
+    size_t bytes_remaining_;
+
+    WrappedEntry entry_;
+    Status iteration_status_;
+  };
+
   // An iterator that can be used to walk through all entries from a given
   // Reader position, without mutating the underlying buffer. This is useful in
   // crash contexts where all available entries in the buffer must be acquired,
   // even those that have already been consumed by all attached readers.
+  //
+  // The iterator derings the buffer when it is created, so each entry is
+  // contiguous. This takes time proportional to the buffer size; use
+  // wrapped_iterator to avoid it.
   class iterator {
    public:
-    iterator() : ring_buffer_(nullptr), read_idx_(0), entry_count_(0) {}
-    iterator(Reader& reader)
-        : ring_buffer_(reader.buffer_),
-          read_idx_(0),
-          entry_count_(reader.entry_count_) {
-      Status dering_result = ring_buffer_->InternalDering(reader);
+    iterator() = default;
+    iterator(Reader& reader) {
+      Status dering_result = reader.buffer_->InternalDering(reader);
       PW_DASSERT(dering_result.ok());
+      it_ = wrapped_iterator(reader);
     }
 
-    iterator& operator++();
+    iterator& operator++() {
+      ++it_;
+      return *this;
+    }
     iterator operator++(int) {
       iterator original = *this;
       ++*this;
@@ -205,36 +349,35 @@ class PrefixedEntryRingBufferMulti {
     const Entry* operator->() const { return &operator*(); }
 
     constexpr bool operator==(const iterator& rhs) const {
-      return entry_count_ == rhs.entry_count_;
+      return it_ == rhs.it_;
     }
 
     constexpr bool operator!=(const iterator& rhs) const {
-      return entry_count_ != rhs.entry_count_;
+      return it_ != rhs.it_;
     }
 
     // Returns the status of the last iteration operation. If the iterator
     // fails to read an entry, it will move to iterator::end() and indicate
     // the failure reason here.
-    Status status() const { return iteration_status_; }
+    Status status() const { return it_.status(); }
 
    private:
-    static constexpr Entry kEndEntry = {
-        .buffer = std::span<const std::byte>(),
-        .preamble = 0,
-    };
+    wrapped_iterator it_;
+    mutable Entry entry_;
+  };
 
-    void SkipToEnd(Status status) {
-      iteration_status_ = status;
-      entry_ = kEndEntry;
-      entry_count_ = 0;
-    }
+  // Iterates over the entries from a reader's position with wrapped_iterator.
+  class WrappedEntries {
+   public:
+    wrapped_iterator begin() const { return wrapped_iterator(*reader_); }
+    wrapped_iterator end() const { return wrapped_iterator(); }
 
-    PrefixedEntryRingBufferMulti* ring_buffer_;
-    size_t read_idx_;
-    size_t entry_count_;
+   private:
+    friend class PrefixedEntryRingBufferMulti;
 
-    mutable Entry entry_;
-    Status iteration_status_;
+    constexpr WrappedEntries(const Reader& reader) : reader_(&reader) {}
+
+    const Reader* reader_;
   };
 
   using element_type = const Entry;
@@ -248,13 +391,36 @@ class PrefixedEntryRingBufferMulti {
   const_iterator cbegin() { return begin(); }
   const_iterator cend() { return end(); }
 
+  // Returns a range of all entries from the slowest reader's position, in
+  // place. Unlike begin(), this does not dering the buffer.
+  //
+  // Precondition: At least one reader must be attached to the ring buffer.
+  WrappedEntries wrapped_entries() const {
+    return WrappedEntries(GetSlowestReader());
+  }
+
+  // Returns a range of the entries from the given reader's position, in place.
+  static WrappedEntries wrapped_entries(const Reader& reader) {
+    return WrappedEntries(reader);
+  }
+
   // TODO(pwbug/340): Consider changing bool to an enum, to explicitly enumerate
   // what this variable means in clients.
   PrefixedEntryRingBufferMulti(bool user_preamble = false)
       : buffer_(nullptr),
         buffer_bytes_(0),
         write_idx_(0),
-        user_preamble_(user_preamble) {}
+        user_preamble_(user_preamble),
+        reserved_(false),
+        reserved_size_(0),
+        reserved_user_preamble_(0),
+        dering_bytes_remaining_(0),
+        dering_shift_(0),
+        dering_cycles_(0),
+        dering_cycle_start_(0),
+        dering_idx_(0),
+        dering_carry_(std::byte(0)),
+        slowest_reader_(nullptr) {}
 
   // Set the raw buffer to be used by the ring buffer.
   //
@@ -293,7 +459,24 @@ class PrefixedEntryRingBufferMulti {
   // buffer.
   Status DetachReader(Reader& reader);
 
-  // Removes all data from the ring buffer.
+  // Returns the position of the entries in the buffer. If no readers are
+  // attached, the position is empty.
+  Position GetPosition() const;
+
+  // Restores entries that are already in the buffer, e.g. because the buffer
+  // is in memory that is preserved across a reset. Every attached reader is
+  // moved to the oldest entry. The position is checked against the buffer
+  // first: each entry's preamble must be valid and the entries must exactly
+  // fill the space between the read and write indices.
+  //
+  // Return values:
+  // OK - The entries were restored.
+  // FAILED_PRECONDITION - Buffer not initialized, or a reservation is open.
+  // DATA_LOSS - The position does not match the contents of the buffer. The
+  // ring buffer is unchanged.
+  Status RestorePosition(const Position& position);
+
+  // Removes all data from the ring buffer and cancels any open reservation.
   void Clear();
 
   // Write a chunk of data to the ring buffer. If available space is less than
@@ -320,6 +503,21 @@ class PrefixedEntryRingBufferMulti {
     return PushBack(data, static_cast<uint32_t>(user_preamble_data));
   }
 
+  // Writes several entries to the ring buffer, in order. Space for all of the
+  // entries is made at once, by discarding the oldest entries as in
+  // PushBack(), so each entry costs only two copies. Every entry gets the same
+  // user preamble.
+  //
+  // Return values:
+  // OK - Data successfully written to the ring buffer.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - The entries do not fit in the buffer together. No entries
+  // were written.
+  Status PushBackMany(std::span<const std::span<const std::byte>> entries,
+                      uint32_t user_preamble_data = 0) {
+    return InternalPushBackMany(entries, user_preamble_data, true);
+  }
+
   // Write a chunk of data to the ring buffer if there is space available.
   //
   // Preamble argument is a caller-provided value prepended to the front of the
@@ -348,6 +546,65 @@ class PrefixedEntryRingBufferMulti {
     return TryPushBack(data, static_cast<uint32_t>(user_preamble_data));
   }
 
+  // Writes several entries to the ring buffer if there is space for all of
+  // them without discarding existing entries.
+  //
+  // Return values:
+  // OK - Data successfully written to the ring buffer.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - The entries do not fit in the buffer together.
+  // RESOURCE_EXHAUSTED - The ring buffer doesn't have space for the entries
+  // without popping off existing elements. No entries were written.
+  Status TryPushBackMany(std::span<const std::span<const std::byte>> entries,
+                         uint32_t user_preamble_data = 0) {
+    return InternalPushBackMany(entries, user_preamble_data, false);
+  }
+
+  // Reserves space for an entry of up to max_size bytes, so that the entry can
+  // be encoded directly into the ring buffer instead of into a separate buffer
+  // that is then copied in. Space is made by discarding the oldest entries, as
+  // in PushBack(). Call Commit() with the entry's actual size to add it, or
+  // CancelReservation() to drop it.
+  //
+  // The entry's length prefix is sized for max_size, so a committed entry
+  // that is much smaller than max_size may use a longer prefix than PushBack()
+  // would. The prefix is still a valid varint.
+  //
+  // While a reservation is open, the buffer may be read and popped, but
+  // pushes, reserves and Dering() return FAILED_PRECONDITION. The reserved
+  // spans are valid until the reservation is committed or cancelled.
+  //
+  // Return values:
+  // OK - Space was reserved.
+  // FAILED_PRECONDITION - Buffer not initialized, or a reservation is already
+  // open.
+  // OUT_OF_RANGE - An entry of max_size is larger than the buffer.
+  Result<ReservedSpans> Reserve(size_t max_size,
+                                uint32_t user_preamble_data = 0) {
+    return InternalReserve(max_size, user_preamble_data, true);
+  }
+
+  // Same as Reserve(), but fails with RESOURCE_EXHAUSTED instead of
+  // discarding existing entries.
+  Result<ReservedSpans> TryReserve(size_t max_size,
+                                   uint32_t user_preamble_data = 0) {
+    return InternalReserve(max_size, user_preamble_data, false);
+  }
+
+  // Adds the entry written to the open reservation to the buffer. The first
+  // size_bytes of the reserved spans are the entry's data.
+  //
+  // Return values:
+  // OK - The entry was added.
+  // FAILED_PRECONDITION - No reservation is open.
+  // INVALID_ARGUMENT - size_bytes is larger than the reserved size. The
+  // reservation remains open.
+  Status Commit(size_t size_bytes);
+
+  // Closes the open reservation, if any, without adding an entry. Entries that
+  // were discarded to make space are not restored.
+  void CancelReservation() { reserved_ = false; }
+
   // Get the size in bytes of all the current entries in the ring buffer,
   // including preamble and data chunk.
   size_t TotalUsedBytes() const { return buffer_bytes_ - RawAvailableBytes(); }
@@ -362,6 +619,27 @@ class PrefixedEntryRingBufferMulti {
   // FAILED_PRECONDITION - Buffer not initialized.
   Status Dering();
 
+  // Derings the buffer as Dering() does, but in steps that each move at most
+  // max_bytes bytes. This bounds the time for which a lock protecting the
+  // buffer must be held; release it between steps.
+  //
+  // Call DeringStep() until it returns OK with a size of 0. While a dering is
+  // in progress the buffer contents are being moved, so pushes, reserves,
+  // peeks, pops, and wrapped_iterators fail with FAILED_PRECONDITION, and
+  // entry sizes are reported as 0. Dering() or creating an iterator finish the
+  // dering in progress; Clear() and SetBuffer() abandon it.
+  //
+  // Return values:
+  // OK - The step completed. The size is the number of bytes left to move, or
+  // 0 if the buffer is deringed.
+  // FAILED_PRECONDITION - Buffer not initialized, no readers are attached, or
+  // a reservation is open.
+  // INVALID_ARGUMENT - max_bytes is 0.
+  StatusWithSize DeringStep(size_t max_bytes);
+
+  // True if an incremental dering started by DeringStep() is in progress.
+  bool dering_in_progress() const { return dering_bytes_remaining_ != 0u; }
+
  private:
   // Read the oldest stored data chunk of data from the ring buffer to
   // the provided destination std::span. The number of bytes read is written to
@@ -403,6 +681,12 @@ class PrefixedEntryRingBufferMulti {
   // OUT_OF_RANGE - No entries in ring buffer to pop.
   Status InternalPopFront(Reader& reader);
 
+  Result<EntrySpans> InternalPeekFrontMany(const Reader& reader,
+                                           size_t max_entries,
+                                           size_t max_bytes) const;
+
+  Status InternalPopFrontMany(Reader& reader, size_t entry_count);
+
   // Get the size in bytes of the next chunk, not including preamble, to be
   // read.
   size_t InternalFrontEntryDataSizeBytes(const Reader& reader) const;
@@ -429,6 +713,21 @@ class PrefixedEntryRingBufferMulti {
   // FAILED_PRECONDITION - Buffer not initialized.
   Status InternalDering(Reader& reader);
 
+  // Starts an incremental dering at the slowest reader, if it is not already
+  // at the start of the buffer.
+  void StartDering();
+
+  // Moves up to max_bytes bytes of the incremental dering in progress, and
+  // updates the indices once every byte is moved.
+  void ContinueDering(size_t max_bytes);
+
+  // Moves every index back by shift bytes, for a dering by that many bytes.
+  void ShiftIndices(size_t shift);
+
+  // Returns the number of bytes from read_idx to the write index, for a reader
+  // at read_idx with entry_count entries.
+  size_t UsedBytesFrom(size_t read_idx, size_t entry_count) const;
+
   struct EntryInfo {
     size_t preamble_bytes;
     uint32_t user_preamble;
@@ -441,15 +740,23 @@ class PrefixedEntryRingBufferMulti {
                           uint32_t user_preamble_data,
                           bool pop_front_if_needed);
 
-  // Internal function to pop all of the slowest readers. This function may pop
-  // multiple readers if multiple are slow.
-  //
-  // Precondition: This function requires that at least one reader is attached
-  // and has at least one entry to pop. There will be a crash if data is
-  // corrupted.
-  void InternalPopFrontAll();
+  Status InternalPushBackMany(
+      std::span<const std::span<const std::byte>> entries,
+      uint32_t user_preamble_data,
+      bool pop_front_if_needed);
+
+  Result<ReservedSpans> InternalReserve(size_t max_size,
+                                        uint32_t user_preamble_data,
+                                        bool pop_front_if_needed);
 
-  // Returns a the slowest reader in the list.
+  // Drops old entries until there are at least the given number of bytes
+  // available, or returns RESOURCE_EXHAUSTED if not allowed to drop entries.
+  // The entries to drop are found first, then every reader that is behind the
+  // new oldest entry is moved to it, so each reader is visited only once.
+  Status MakeSpace(size_t bytes, bool pop_front_if_needed);
+
+  // Returns a the slowest reader in the list. The result is cached until the
+  // slowest reader pops an entry or is detached.
   //
   // Precondition: This function requires that at least one reader is attached.
   const Reader& GetSlowestReader() const;
@@ -457,6 +764,14 @@ class PrefixedEntryRingBufferMulti {
     return const_cast<Reader&>(GetSlowestReader());
   }
 
+  // Called when a reader moves forward or is detached, since it may no longer
+  // be the slowest reader.
+  void InvalidateSlowestReader(const Reader& reader) {
+    if (slowest_reader_ == &reader) {
+      slowest_reader_ = nullptr;
+    }
+  }
+
   // Get info struct with the size of the preamble and data chunk for the next
   // entry to be read. Calls RawFrontEntryInfo and asserts on failure.
   //
@@ -497,9 +812,32 @@ class PrefixedEntryRingBufferMulti {
   size_t write_idx_;
   const bool user_preamble_;
 
+  // The open reservation, if any. The reserved entry starts at write_idx_.
+  bool reserved_;
+  size_t reserved_size_;
+  uint32_t reserved_user_preamble_;
+
+  // The incremental dering in progress, if any. The buffer is rotated left by
+  // dering_shift_ bytes with the cycle leader algorithm: each of the
+  // dering_cycles_ cycles starts at an index below dering_cycles_ and visits
+  // every dering_cycles_-th index. dering_idx_ is the next index to fill in the
+  // current cycle, which started at dering_cycle_start_ by saving its byte in
+  // dering_carry_.
+  size_t dering_bytes_remaining_;
+  size_t dering_shift_;
+  size_t dering_cycles_;
+  size_t dering_cycle_start_;
+  size_t dering_idx_;
+  std::byte dering_carry_;
+
   // List of attached readers.
   IntrusiveList<Reader> readers_;
 
+  // The reader with the most entries, or nullptr if it must be searched for.
+  // Pushing and evicting entries never changes which reader is the slowest, so
+  // this avoids a walk of all readers for every push.
+  mutable const Reader* slowest_reader_;
+
   // Maximum bufer size allowed. Restricted to this to allow index aliasing to
   // not overflow.
   static constexpr size_t kMaxBufferBytes =
@@ -0,0 +1,111 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+
+namespace pw {
+namespace ring_buffer {
+
+// A lock-free queue of variable-length entries with exactly one producer and
+// one consumer. The producer and the consumer may run concurrently in
+// different threads or interrupt contexts; they only communicate through an
+// atomic write index, which commits fully written entries, and an atomic read
+// index, which releases consumed space.
+//
+// Unlike PrefixedEntryRingBuffer, the producer never evicts entries: PushBack
+// fails if there is not enough contiguous space, and the failure is counted so
+// the consumer can report it. Entries are always stored contiguously, so the
+// consumer can access them in place with PeekFront.
+//
+// Multiple producers or consumers must be serialized externally. In
+// particular, a producer called from an interrupt must not be preempted by
+// another producer of the same queue.
+class SingleProducerEntryQueue {
+ public:
+  constexpr SingleProducerEntryQueue()
+      : buffer_(), write_idx_(0), read_idx_(0), drop_count_(0) {}
+
+  // Sets the buffer backing the queue and discards any entries. This must not
+  // be called while the producer or the consumer is using the queue.
+  //
+  // Return values:
+  // OK - Buffer set successfully.
+  // INVALID_ARGUMENT - The buffer cannot hold the smallest entry.
+  Status SetBuffer(std::span<std::byte> buffer);
+
+  // Producer API. Appends an entry to the back of the queue without blocking.
+  // The entry is visible to the consumer once this returns OK.
+  //
+  // Return values:
+  // OK - The entry was committed.
+  // FAILED_PRECONDITION - No buffer has been set.
+  // RESOURCE_EXHAUSTED - There is not enough contiguous space; the entry was
+  // dropped and counted in drop_count().
+  Status PushBack(std::span<const std::byte> data);
+
+  // Consumer API. Returns the oldest committed entry in place. The span stays
+  // valid until PopFront is called.
+  //
+  // Return values:
+  // OK - The front entry was returned.
+  // OUT_OF_RANGE - The queue is empty.
+  Result<std::span<const std::byte>> PeekFront() const;
+
+  // Consumer API. Releases the entry returned by the last PeekFront.
+  //
+  // Return values:
+  // OK - The front entry was released.
+  // OUT_OF_RANGE - The queue is empty.
+  Status PopFront();
+
+  // Number of entries dropped by PushBack since the buffer was set. The count
+  // is only written by the producer and wraps at UINT32_MAX; consumers should
+  // track the delta from the last value they observed.
+  uint32_t drop_count() const {
+    return drop_count_.load(std::memory_order_relaxed);
+  }
+
+  // Size of the backing buffer in bytes.
+  size_t buffer_size() const { return buffer_.size(); }
+
+ private:
+  // Each entry is a native-endian header holding the data size, followed by
+  // the data. A header of kWrapMarker tells the consumer to continue reading
+  // from the start of the buffer.
+  using Header = uint32_t;
+  static constexpr Header kWrapMarker = ~Header(0);
+
+  // Returns the offset of the next header at or after `read_idx`, following
+  // wrap markers and wrapping when no header fits before the end.
+  size_t HeaderOffset(size_t read_idx) const;
+
+  std::span<std::byte> buffer_;
+
+  // Only the producer writes write_idx_ and drop_count_; only the consumer
+  // writes read_idx_. write_idx_ == read_idx_ means the queue is empty, so the
+  // producer never lets write_idx_ catch up with read_idx_.
+  std::atomic<size_t> write_idx_;
+  std::atomic<size_t> read_idx_;
+  std::atomic<uint32_t> drop_count_;
+};
+
+}  // namespace ring_buffer
+}  // namespace pw
@@ -0,0 +1,129 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_ring_buffer/single_producer_entry_queue.h"
+
+#include <cstring>
+
+namespace pw {
+namespace ring_buffer {
+
+// The queue must be usable from interrupts, so its indices may not fall back
+// to a library lock. Only loads and stores are used, so targets without
+// atomic read-modify-write instructions (e.g. Cortex-M0) are supported too.
+static_assert(std::atomic<size_t>::is_always_lock_free,
+              "SingleProducerEntryQueue requires lock-free atomic indices");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "SingleProducerEntryQueue requires a lock-free drop count");
+
+Status SingleProducerEntryQueue::SetBuffer(std::span<std::byte> buffer) {
+  if (buffer.data() == nullptr || buffer.size() <= sizeof(Header)) {
+    return Status::InvalidArgument();
+  }
+  buffer_ = buffer;
+  write_idx_.store(0, std::memory_order_relaxed);
+  read_idx_.store(0, std::memory_order_relaxed);
+  drop_count_.store(0, std::memory_order_relaxed);
+  return OkStatus();
+}
+
+Status SingleProducerEntryQueue::PushBack(std::span<const std::byte> data) {
+  if (buffer_.empty()) {
+    return Status::FailedPrecondition();
+  }
+  const size_t needed = sizeof(Header) + data.size();
+  const size_t write_idx = write_idx_.load(std::memory_order_relaxed);
+  // Acquire the consumer's release of the space it has finished reading.
+  const size_t read_idx = read_idx_.load(std::memory_order_acquire);
+
+  // Entries are contiguous, so either the entry fits at write_idx or the
+  // producer wraps to the start of the buffer. The write index may never catch
+  // up with the read index, since that would make the queue look empty.
+  size_t start = write_idx;
+  bool wrap = false;
+  bool fits;
+  if (write_idx >= read_idx) {
+    const size_t tail = buffer_.size() - write_idx;
+    fits = needed < tail || (needed == tail && read_idx != 0);
+    if (!fits && needed < read_idx) {
+      start = 0;
+      wrap = true;
+      fits = true;
+    }
+  } else {
+    fits = needed < read_idx - write_idx;
+  }
+  if (!fits) {
+    drop_count_.store(drop_count_.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+    return Status::ResourceExhausted();
+  }
+
+  if (wrap && buffer_.size() - write_idx >= sizeof(Header)) {
+    std::memcpy(&buffer_[write_idx], &kWrapMarker, sizeof(Header));
+  }
+  const Header header = static_cast<Header>(data.size());
+  std::memcpy(&buffer_[start], &header, sizeof(header));
+  std::memcpy(&buffer_[start + sizeof(header)], data.data(), data.size());
+
+  const size_t end = start + needed;
+  // Release the entry to the consumer. This is the commit point.
+  write_idx_.store(end == buffer_.size() ? 0 : end, std::memory_order_release);
+  return OkStatus();
+}
+
+size_t SingleProducerEntryQueue::HeaderOffset(size_t read_idx) const {
+  if (buffer_.size() - read_idx < sizeof(Header)) {
+    return 0;
+  }
+  Header header;
+  std::memcpy(&header, &buffer_[read_idx], sizeof(header));
+  return header == kWrapMarker ? 0 : read_idx;
+}
+
+Result<std::span<const std::byte>> SingleProducerEntryQueue::PeekFront()
+    const {
+  const size_t read_idx = read_idx_.load(std::memory_order_relaxed);
+  // Acquire the entries committed by the producer.
+  if (buffer_.empty() ||
+      read_idx == write_idx_.load(std::memory_order_acquire)) {
+    return Status::OutOfRange();
+  }
+
+  const size_t offset = HeaderOffset(read_idx);
+  Header size;
+  std::memcpy(&size, &buffer_[offset], sizeof(size));
+  return std::span<const std::byte>(buffer_).subspan(offset + sizeof(size),
+                                                   size);
+}
+
+Status SingleProducerEntryQueue::PopFront() {
+  const size_t read_idx = read_idx_.load(std::memory_order_relaxed);
+  if (buffer_.empty() ||
+      read_idx == write_idx_.load(std::memory_order_acquire)) {
+    return Status::OutOfRange();
+  }
+
+  const size_t offset = HeaderOffset(read_idx);
+  Header size;
+  std::memcpy(&size, &buffer_[offset], sizeof(size));
+
+  const size_t end = offset + sizeof(size) + size;
+  // Release the space to the producer only after the entry has been read.
+  read_idx_.store(end == buffer_.size() ? 0 : end, std::memory_order_release);
+  return OkStatus();
+}
+
+}  // namespace ring_buffer
+}  // namespace pw
@@ -0,0 +1,198 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_ring_buffer/single_producer_entry_queue.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+using std::byte;
+
+namespace pw {
+namespace ring_buffer {
+namespace {
+
+// Fills an entry with bytes derived from its index so entries are distinct.
+template <size_t kSize>
+std::array<byte, kSize> MakeEntry(size_t index) {
+  std::array<byte, kSize> entry;
+  for (size_t i = 0; i < kSize; ++i) {
+    entry[i] = byte(index + i);
+  }
+  return entry;
+}
+
+template <size_t kSize>
+void ExpectFront(SingleProducerEntryQueue& queue, size_t index) {
+  const std::array<byte, kSize> expected = MakeEntry<kSize>(index);
+  Result<std::span<const byte>> front = queue.PeekFront();
+  ASSERT_EQ(front.status(), OkStatus());
+  ASSERT_EQ(front.value().size(), kSize);
+  EXPECT_EQ(std::memcmp(front.value().data(), expected.data(), kSize), 0);
+}
+
+TEST(SingleProducerEntryQueue, NoBuffer) {
+  SingleProducerEntryQueue queue;
+  byte buf[4] = {};
+
+  EXPECT_EQ(queue.SetBuffer(std::span<byte>(nullptr, 10u)),
+            Status::InvalidArgument());
+  EXPECT_EQ(queue.SetBuffer(std::span(buf, sizeof(uint32_t))),
+            Status::InvalidArgument());
+  EXPECT_EQ(queue.PushBack(buf), Status::FailedPrecondition());
+  EXPECT_EQ(queue.PeekFront().status(), Status::OutOfRange());
+  EXPECT_EQ(queue.PopFront(), Status::OutOfRange());
+  EXPECT_EQ(queue.drop_count(), 0u);
+}
+
+TEST(SingleProducerEntryQueue, PushPeekPop) {
+  std::array<byte, 64> buffer;
+  SingleProducerEntryQueue queue;
+  ASSERT_EQ(queue.SetBuffer(buffer), OkStatus());
+
+  EXPECT_EQ(queue.PeekFront().status(), Status::OutOfRange());
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(queue.PushBack(MakeEntry<8>(i)), OkStatus());
+  }
+  for (size_t i = 0; i < 3; ++i) {
+    ExpectFront<8>(queue, i);
+    ASSERT_EQ(queue.PopFront(), OkStatus());
+  }
+  EXPECT_EQ(queue.PeekFront().status(), Status::OutOfRange());
+  EXPECT_EQ(queue.PopFront(), Status::OutOfRange());
+}
+
+TEST(SingleProducerEntryQueue, EmptyEntry) {
+  std::array<byte, 16> buffer;
+  SingleProducerEntryQueue queue;
+  ASSERT_EQ(queue.SetBuffer(buffer), OkStatus());
+
+  ASSERT_EQ(queue.PushBack(std::span<const byte>()), OkStatus());
+  Result<std::span<const byte>> front = queue.PeekFront();
+  ASSERT_EQ(front.status(), OkStatus());
+  EXPECT_TRUE(front.value().empty());
+  EXPECT_EQ(queue.PopFront(), OkStatus());
+  EXPECT_EQ(queue.PeekFront().status(), Status::OutOfRange());
+}
+
+TEST(SingleProducerEntryQueue, FullQueueDropsEntries) {
+  // Each 8-byte entry takes 12 bytes. One byte is always left unused, so a
+  // 37-byte buffer holds exactly three entries.
+  std::array<byte, 37> buffer;
+  SingleProducerEntryQueue queue;
+  ASSERT_EQ(queue.SetBuffer(buffer), OkStatus());
+
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(queue.PushBack(MakeEntry<8>(i)), OkStatus());
+  }
+  EXPECT_EQ(queue.PushBack(MakeEntry<8>(3)), Status::ResourceExhausted());
+  EXPECT_EQ(queue.PushBack(MakeEntry<8>(4)), Status::ResourceExhausted());
+  EXPECT_EQ(queue.drop_count(), 2u);
+
+  // The committed entries are intact.
+  for (size_t i = 0; i < 3; ++i) {
+    ExpectFront<8>(queue, i);
+    ASSERT_EQ(queue.PopFront(), OkStatus());
+  }
+}
+
+TEST(SingleProducerEntryQueue, CannotFillEntireBuffer) {
+  std::array<byte, 12> buffer;
+  SingleProducerEntryQueue queue;
+  ASSERT_EQ(queue.SetBuffer(buffer), OkStatus());
+
+  // An entry that would use every byte would make the queue look empty.
+  EXPECT_EQ(queue.PushBack(MakeEntry<8>(0)), Status::ResourceExhausted());
+  EXPECT_EQ(queue.PushBack(MakeEntry<7>(0)), OkStatus());
+}
+
+// Pushes and pops entries of varying sizes so that the write index wraps with
+// a wrap marker, without one (less than a header left), and exactly at the end
+// of the buffer.
+TEST(SingleProducerEntryQueue, WrapsAround) {
+  std::array<byte, 50> buffer;
+  SingleProducerEntryQueue queue;
+  ASSERT_EQ(queue.SetBuffer(buffer), OkStatus());
+
+  size_t pushed = 0;
+  size_t popped = 0;
+  for (size_t round = 0; round < 100; ++round) {
+    // Keep two entries queued while the indices advance by 9, 10, or 11 bytes.
+    while (pushed - popped < 2) {
+      Status status;
+      switch (pushed % 3) {
+        case 0:
+          status = queue.PushBack(MakeEntry<5>(pushed));
+          break;
+        case 1:
+          status = queue.PushBack(MakeEntry<6>(pushed));
+          break;
+        default:
+          status = queue.PushBack(MakeEntry<7>(pushed));
+          break;
+      }
+      ASSERT_EQ(status, OkStatus());
+      ++pushed;
+    }
+
+    switch (popped % 3) {
+      case 0:
+        ExpectFront<5>(queue, popped);
+        break;
+      case 1:
+        ExpectFront<6>(queue, popped);
+        break;
+      default:
+        ExpectFront<7>(queue, popped);
+        break;
+    }
+    ASSERT_EQ(queue.PopFront(), OkStatus());
+    ++popped;
+  }
+  EXPECT_EQ(queue.drop_count(), 0u);
+}
+
+TEST(SingleProducerEntryQueue, EntryDoesNotFitAfterWrap) {
+  std::array<byte, 32> buffer;
+  SingleProducerEntryQueue queue;
+  ASSERT_EQ(queue.SetBuffer(buffer), OkStatus());
+
+  // Fill [0, 12) and [12, 24), then free [0, 12).
+  ASSERT_EQ(queue.PushBack(MakeEntry<8>(0)), OkStatus());
+  ASSERT_EQ(queue.PushBack(MakeEntry<8>(1)), OkStatus());
+  ASSERT_EQ(queue.PopFront(), OkStatus());
+
+  // 8 bytes are free at the end and 12 at the start, so a 16-byte entry fits
+  // in neither. Two 8-byte entries fill the end exactly and then wrap.
+  EXPECT_EQ(queue.PushBack(MakeEntry<12>(2)), Status::ResourceExhausted());
+  ASSERT_EQ(queue.PushBack(MakeEntry<4>(3)), OkStatus());
+  ASSERT_EQ(queue.PushBack(MakeEntry<4>(4)), OkStatus());
+  EXPECT_EQ(queue.drop_count(), 1u);
+
+  ExpectFront<8>(queue, 1);
+  ASSERT_EQ(queue.PopFront(), OkStatus());
+  ExpectFront<4>(queue, 3);
+  ASSERT_EQ(queue.PopFront(), OkStatus());
+  ExpectFront<4>(queue, 4);
+  ASSERT_EQ(queue.PopFront(), OkStatus());
+  EXPECT_EQ(queue.PeekFront().status(), Status::OutOfRange());
+}
+
+}  // namespace
+}  // namespace ring_buffer
+}  // namespace pw
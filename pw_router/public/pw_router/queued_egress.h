@@ -0,0 +1,223 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_metric/metric.h"
+#include "pw_router/egress.h"
+#include "pw_status/status.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::router {
+
+// An egress which queues packets that its output egress does not accept, so
+// they can be sent later instead of dropped.
+//
+// Packets are queued by priority. A packet's priority selects its queue:
+// priority N uses queue N, packets without a priority use queue 0, and
+// priorities past the last queue use the last queue. Higher queues are more
+// important. Each queue holds a bounded number of packets, and all queues share
+// a pool of packet buffers. When the pool is full, the oldest packet of the
+// lowest-priority nonempty queue below the new packet's is dropped to make room
+// for it; if there is none, the new packet is dropped.
+//
+// While nothing is queued, packets are passed straight to the output without
+// being copied. Once the output refuses a packet, packets are queued until
+// Flush() or a later SendPacket() drains the queues, in the order chosen by the
+// scheduling policy.
+//
+// Thread-safety:
+//   The egress is synchronized internally. The output egress is only called
+//   with the queued egress's lock held, so it is never called concurrently.
+//
+class QueuedEgress : public Egress {
+ public:
+  enum class Scheduling {
+    // Always sends from the highest-priority nonempty queue. Low-priority
+    // traffic waits for as long as higher-priority traffic is queued.
+    kStrict,
+
+    // Sends from each nonempty queue in turn, up to its weight in packets per
+    // round, highest priority first. Every queue makes progress.
+    kWeighted,
+  };
+
+  struct QueueConfig {
+    // Most packets this queue may hold at once.
+    uint16_t max_packets;
+
+    // Packets sent from this queue per round of weighted scheduling. Ignored
+    // for strict scheduling. A weight of 0 is treated as 1.
+    uint16_t weight = 1;
+  };
+
+  // Storage for one queued packet.
+  struct Packet {
+    ByteSpan buffer;
+    size_t size = 0;
+    PacketMetadata metadata;
+    Packet* next = nullptr;
+  };
+
+  // The state of a single priority's queue, added as a "queue" child group of
+  // the egress's metrics. The group records the queue's priority, how many
+  // packets are queued and the most that have been, and how many packets of
+  // this priority were dropped.
+  class Queue {
+   public:
+    Queue() = default;
+
+    Queue(const Queue&) = delete;
+    Queue& operator=(const Queue&) = delete;
+
+    uint32_t queued() const { return queued_.value(); }
+    uint32_t dropped() const { return dropped_.value(); }
+
+   private:
+    friend class QueuedEgress;
+
+    Packet* head_ = nullptr;
+    Packet* tail_ = nullptr;
+    uint16_t max_packets_ = 0;
+    uint16_t weight_ = 1;
+    uint16_t credit_ = 0;
+
+    PW_METRIC_GROUP(group_, "queue");
+    PW_METRIC(group_, priority_, "priority", 0u);
+    PW_METRIC(group_, queued_, "queued", 0u);
+    PW_METRIC(group_, max_queued_, "max_queued", 0u);
+    PW_METRIC(group_, dropped_, "dropped", 0u);
+  };
+
+  // config must have one entry per queue. Queued packets are copied into
+  // equal parts of packet_buffer, one per entry of packets, so the largest
+  // packet which can be queued is packet_buffer.size() / packets.size().
+  QueuedEgress(Egress& output,
+               Scheduling scheduling,
+               std::span<const QueueConfig> config,
+               std::span<Queue> queues,
+               std::span<Packet> packets,
+               ByteSpan packet_buffer);
+
+  QueuedEgress(const QueuedEgress&) = delete;
+  QueuedEgress(QueuedEgress&&) = delete;
+  QueuedEgress& operator=(const QueuedEgress&) = delete;
+  QueuedEgress& operator=(QueuedEgress&&) = delete;
+
+  // Sends the packet, or queues it if the output does not accept it or other
+  // packets are already queued. Queued packets are then sent until the output
+  // refuses one. Returns:
+  //
+  //   OK - Packet sent or queued.
+  //   RESOURCE_EXHAUSTED - Packet dropped. Its queue was full, it was too large
+  //       to queue, or the pool was full of packets of the same or higher
+  //       priority.
+  //
+  Status SendPacket(ConstByteSpan packet, const PacketMetadata& metadata) final
+      PW_LOCKS_EXCLUDED(mutex_);
+
+  // Sends queued packets until the queues are empty or the output refuses a
+  // packet. Call this when the output may accept packets again, such as when
+  // its transport has drained. Returns:
+  //
+  //   OK - All queued packets were sent.
+  //   UNAVAILABLE - The output refused a packet, which remains queued.
+  //
+  Status Flush() PW_LOCKS_EXCLUDED(mutex_);
+
+  // Total number of packets queued across all priorities.
+  size_t queued_packets() const PW_LOCKS_EXCLUDED(mutex_);
+
+  // The egress's metrics. Add them to a StaticRouter's metrics with
+  // StaticRouter::AddMetrics() to report them with the router's.
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  Status Transmit(ConstByteSpan packet, const PacketMetadata& metadata)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  Status Enqueue(ConstByteSpan packet, const PacketMetadata& metadata)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  Status FlushLocked() PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Drops the oldest packet from the lowest-priority nonempty queue below
+  // the given one. Returns false if all of those queues are empty.
+  bool DropBelow(size_t queue_index) PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns the index of the queue to send from next. At least one packet
+  // must be queued.
+  size_t NextQueue() PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Removes the packet at the head of the queue and frees its buffer.
+  void Pop(Queue& queue) PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  size_t QueueIndex(const PacketMetadata& metadata) const;
+
+  Egress& output_ PW_GUARDED_BY(mutex_);
+  const Scheduling scheduling_;
+  const std::span<Queue> queues_;
+  const size_t max_packet_size_;
+  Packet* free_packets_ PW_GUARDED_BY(mutex_);
+  size_t queued_packets_ PW_GUARDED_BY(mutex_);
+  mutable sync::Mutex mutex_;
+
+  PW_METRIC_GROUP(metrics_, "queued_egress");
+  PW_METRIC(metrics_, sent_, "sent", 0u);
+  PW_METRIC(metrics_, output_errors_, "output_errors", 0u);
+};
+
+namespace internal {
+
+template <size_t kQueues, size_t kPackets, size_t kMaxPacketSizeBytes>
+struct QueuedEgressStorage {
+  std::array<QueuedEgress::Queue, kQueues> queues;
+  std::array<QueuedEgress::Packet, kPackets> packets;
+  std::array<std::byte, kPackets * kMaxPacketSizeBytes> packet_buffer;
+};
+
+}  // namespace internal
+
+// A QueuedEgress with storage for kQueues priorities and kPackets queued
+// packets of up to kMaxPacketSizeBytes each.
+//
+//   constexpr std::array<pw::router::QueuedEgress::QueueConfig, 2> kConfig = {{
+//       {.max_packets = 4},  // Priority 0: telemetry
+//       {.max_packets = 8},  // Priority 1: control
+//   }};
+//   pw::router::QueuedEgressWithBuffer<2, 8, 256> queued_uart_egress(
+//       uart_egress, pw::router::QueuedEgress::Scheduling::kStrict, kConfig);
+//
+template <size_t kQueues, size_t kPackets, size_t kMaxPacketSizeBytes>
+class QueuedEgressWithBuffer
+    : private internal::
+          QueuedEgressStorage<kQueues, kPackets, kMaxPacketSizeBytes>,
+      public QueuedEgress {
+ public:
+  QueuedEgressWithBuffer(Egress& output,
+                         Scheduling scheduling,
+                         std::span<const QueueConfig, kQueues> config)
+      : QueuedEgress(output,
+                     scheduling,
+                     config,
+                     this->queues,
+                     this->packets,
+                     this->packet_buffer) {}
+};
+
+}  // namespace pw::router
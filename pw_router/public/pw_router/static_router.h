@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <span>
 
 #include "pw_bytes/span.h"
@@ -32,6 +34,9 @@ namespace pw::router {
 //   synchronized. Synchronization at the egress level must be implemented by
 //   derived egresses.
 //
+// Routes may be listed in any order, but a table sorted by address is searched
+// in logarithmic rather than linear time.
+//
 class StaticRouter {
  public:
   struct Route {
@@ -40,8 +45,33 @@ class StaticRouter {
     Egress& egress;
   };
 
-  StaticRouter(PacketParser& parser, std::span<const Route> routes)
-      : parser_(parser), routes_(routes) {}
+  // Traffic counters for a single route, added as a "route" child group of
+  // the router's metrics. The group records the route's address alongside the
+  // number of packets and bytes its egress accepted.
+  class RouteMetrics {
+   public:
+    RouteMetrics() = default;
+
+    RouteMetrics(const RouteMetrics&) = delete;
+    RouteMetrics& operator=(const RouteMetrics&) = delete;
+
+    uint32_t packets() const { return packets_.value(); }
+    uint32_t bytes() const { return bytes_.value(); }
+
+   private:
+    friend class StaticRouter;
+
+    PW_METRIC_GROUP(group_, "route");
+    PW_METRIC(group_, address_, "address", 0u);
+    PW_METRIC(group_, packets_, "packets", 0u);
+    PW_METRIC(group_, bytes_, "bytes", 0u);
+  };
+
+  // If provided, route_metrics must have one entry per route, in the same
+  // order as routes.
+  StaticRouter(PacketParser& parser,
+               std::span<const Route> routes,
+               std::span<RouteMetrics> route_metrics = {});
 
   StaticRouter(const StaticRouter&) = delete;
   StaticRouter(StaticRouter&&) = delete;
@@ -55,6 +85,11 @@ class StaticRouter {
 
   const metric::Group& metrics() { return metrics_; }
 
+  // Adds a group, such as a QueuedEgress's metrics, as a child of the router's
+  // metrics, so it is reported along with them. Add groups while setting up
+  // the router, before its metrics are read.
+  void AddMetrics(metric::Group& group) { metrics_.Add(group); }
+
   // Routes a single packet through the appropriate egress.
   // Returns one of the following to indicate a router-side error:
   //
@@ -65,9 +100,36 @@ class StaticRouter {
   //
   Status RoutePacket(ConstByteSpan packet) PW_LOCKS_EXCLUDED(mutex_);
 
+  // Routes a batch of packets, each as RoutePacket() would. The router's lock
+  // is acquired once for every kBatchSize packets rather than once per packet.
+  // As with RoutePacket(), egresses are called without the lock held.
+  //
+  // Returns the number of packets that were sent successfully. Failures are
+  // counted in the router's metrics.
+  size_t RoutePackets(std::span<const ConstByteSpan> packets)
+      PW_LOCKS_EXCLUDED(mutex_);
+
+  static constexpr size_t kBatchSize = 8;
+
  private:
+  struct ParsedPacket {
+    Status status;
+    uint32_t address = 0;
+    PacketMetadata metadata;
+  };
+
+  ParsedPacket Parse(ConstByteSpan packet) PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Sends a parsed packet through the route for its address.
+  Status Send(ConstByteSpan packet, const ParsedPacket& parsed);
+
+  // Returns the index of the route for the address, or routes_.size().
+  size_t FindRoute(uint32_t address) const;
+
   PacketParser& parser_ PW_GUARDED_BY(mutex_);
   const std::span<const Route> routes_;
+  const std::span<RouteMetrics> route_metrics_;
+  const bool routes_sorted_;
   sync::Mutex mutex_;
   PW_METRIC_GROUP(metrics_, "static_router");
   PW_METRIC(metrics_, parser_errors_, "parser_errors", 0u);
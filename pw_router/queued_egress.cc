@@ -0,0 +1,202 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_router/queued_egress.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+namespace pw::router {
+
+QueuedEgress::QueuedEgress(Egress& output,
+                           Scheduling scheduling,
+                           std::span<const QueueConfig> config,
+                           std::span<Queue> queues,
+                           std::span<Packet> packets,
+                           ByteSpan packet_buffer)
+    : output_(output),
+      scheduling_(scheduling),
+      queues_(queues),
+      max_packet_size_(packets.empty() ? 0
+                                       : packet_buffer.size() / packets.size()),
+      free_packets_(nullptr),
+      queued_packets_(0) {
+  PW_CHECK(!queues_.empty());
+  PW_CHECK_UINT_EQ(config.size(), queues_.size());
+
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    Queue& queue = queues_[i];
+    queue.max_packets_ = config[i].max_packets;
+    queue.weight_ = std::max<uint16_t>(config[i].weight, 1);
+    queue.credit_ = queue.weight_;
+    queue.priority_.Set(i);
+    metrics_.Add(queue.group_);
+  }
+
+  for (size_t i = 0; i < packets.size(); ++i) {
+    packets[i].buffer =
+        packet_buffer.subspan(i * max_packet_size_, max_packet_size_);
+    packets[i].next = free_packets_;
+    free_packets_ = &packets[i];
+  }
+}
+
+Status QueuedEgress::SendPacket(ConstByteSpan packet,
+                                const PacketMetadata& metadata) {
+  std::lock_guard lock(mutex_);
+
+  // Packets are only copied once the output applies backpressure.
+  if (queued_packets_ == 0) {
+    if (Transmit(packet, metadata).ok()) {
+      return OkStatus();
+    }
+    return Enqueue(packet, metadata);
+  }
+
+  // Queue behind the packets already waiting, then let the scheduler choose
+  // what to send.
+  const Status status = Enqueue(packet, metadata);
+  FlushLocked().IgnoreError();
+  return status;
+}
+
+Status QueuedEgress::Flush() {
+  std::lock_guard lock(mutex_);
+  return FlushLocked();
+}
+
+size_t QueuedEgress::queued_packets() const {
+  std::lock_guard lock(mutex_);
+  return queued_packets_;
+}
+
+Status QueuedEgress::Transmit(ConstByteSpan packet,
+                              const PacketMetadata& metadata) {
+  if (Status status = output_.SendPacket(packet, metadata); !status.ok()) {
+    output_errors_.Increment();
+    return status;
+  }
+  sent_.Increment();
+  return OkStatus();
+}
+
+Status QueuedEgress::Enqueue(ConstByteSpan packet,
+                             const PacketMetadata& metadata) {
+  const size_t index = QueueIndex(metadata);
+  Queue& queue = queues_[index];
+
+  if (packet.size() > max_packet_size_ ||
+      queue.queued_.value() >= queue.max_packets_ ||
+      (free_packets_ == nullptr && !DropBelow(index))) {
+    queue.dropped_.Increment();
+    return Status::ResourceExhausted();
+  }
+
+  Packet& entry = *free_packets_;
+  free_packets_ = entry.next;
+
+  std::memcpy(entry.buffer.data(), packet.data(), packet.size());
+  entry.size = packet.size();
+  entry.metadata = metadata;
+  entry.next = nullptr;
+
+  if (queue.tail_ == nullptr) {
+    queue.head_ = &entry;
+  } else {
+    queue.tail_->next = &entry;
+  }
+  queue.tail_ = &entry;
+
+  queue.queued_.Increment();
+  if (queue.queued_.value() > queue.max_queued_.value()) {
+    queue.max_queued_.Set(queue.queued_.value());
+  }
+  queued_packets_ += 1;
+  return OkStatus();
+}
+
+Status QueuedEgress::FlushLocked() {
+  while (queued_packets_ != 0) {
+    Queue& queue = queues_[NextQueue()];
+    const Packet& entry = *queue.head_;
+
+    if (!Transmit(entry.buffer.first(entry.size), entry.metadata).ok()) {
+      return Status::Unavailable();
+    }
+
+    Pop(queue);
+    if (scheduling_ == Scheduling::kWeighted) {
+      queue.credit_ -= 1;
+    }
+  }
+  return OkStatus();
+}
+
+bool QueuedEgress::DropBelow(size_t queue_index) {
+  for (size_t i = 0; i < queue_index; ++i) {
+    if (queues_[i].head_ != nullptr) {
+      queues_[i].dropped_.Increment();
+      Pop(queues_[i]);
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t QueuedEgress::NextQueue() {
+  if (scheduling_ == Scheduling::kStrict) {
+    for (size_t i = queues_.size(); i > 0; --i) {
+      if (queues_[i - 1].head_ != nullptr) {
+        return i - 1;
+      }
+    }
+    PW_CRASH("NextQueue() called with no packets queued");
+  }
+
+  while (true) {
+    for (size_t i = queues_.size(); i > 0; --i) {
+      if (queues_[i - 1].head_ != nullptr && queues_[i - 1].credit_ > 0) {
+        return i - 1;
+      }
+    }
+
+    // Every nonempty queue has sent its share of this round; start another.
+    for (Queue& queue : queues_) {
+      queue.credit_ = queue.weight_;
+    }
+  }
+}
+
+void QueuedEgress::Pop(Queue& queue) {
+  Packet& entry = *queue.head_;
+  queue.head_ = entry.next;
+  if (queue.head_ == nullptr) {
+    queue.tail_ = nullptr;
+  }
+
+  entry.next = free_packets_;
+  free_packets_ = &entry;
+
+  queue.queued_.Set(queue.queued_.value() - 1);
+  queued_packets_ -= 1;
+}
+
+size_t QueuedEgress::QueueIndex(const PacketMetadata& metadata) const {
+  return std::min<size_t>(metadata.priority.value_or(0), queues_.size() - 1);
+}
+
+}  // namespace pw::router
@@ -0,0 +1,255 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_router/queued_egress.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_router/static_router.h"
+
+namespace pw::router {
+namespace {
+
+using Scheduling = QueuedEgress::Scheduling;
+
+// An output which records the IDs of the packets it accepts, and refuses all
+// packets while blocked.
+class FakeOutput : public Egress {
+ public:
+  Status SendPacket(ConstByteSpan packet, const PacketMetadata&) override {
+    if (blocked_) {
+      return Status::Unavailable();
+    }
+    uint32_t id;
+    std::memcpy(&id, packet.data(), sizeof(id));
+    sent_[count_++] = id;
+    return OkStatus();
+  }
+
+  void set_blocked(bool blocked) { blocked_ = blocked; }
+
+  std::span<const uint32_t> sent() const {
+    return std::span(sent_).first(count_);
+  }
+
+ private:
+  bool blocked_ = false;
+  std::array<uint32_t, 16> sent_ = {};
+  size_t count_ = 0;
+};
+
+constexpr std::array<QueuedEgress::QueueConfig, 2> kTwoQueues = {{
+    {.max_packets = 4, .weight = 1},
+    {.max_packets = 4, .weight = 2},
+}};
+
+class QueuedEgressTest : public ::testing::Test {
+ protected:
+  QueuedEgressTest() : egress_(output_, Scheduling::kStrict, kTwoQueues) {}
+
+  Status Send(QueuedEgress& egress, uint32_t id, uint32_t priority) {
+    return egress.SendPacket(std::as_bytes(std::span(&id, 1)),
+                             PacketMetadata{.priority = priority});
+  }
+
+  Status Send(uint32_t id, uint32_t priority) {
+    return Send(egress_, id, priority);
+  }
+
+  void ExpectSent(std::span<const uint32_t> expected) {
+    ASSERT_EQ(output_.sent().size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_EQ(output_.sent()[i], expected[i]);
+    }
+  }
+
+  FakeOutput output_;
+  QueuedEgressWithBuffer<2, 6, sizeof(uint32_t)> egress_;
+};
+
+TEST_F(QueuedEgressTest, SendPacket_PassesThroughWhenNotBlocked) {
+  EXPECT_EQ(OkStatus(), Send(1, 0));
+  EXPECT_EQ(OkStatus(), Send(2, 1));
+  EXPECT_EQ(0u, egress_.queued_packets());
+  ExpectSent(std::array<uint32_t, 2>{1, 2});
+}
+
+TEST_F(QueuedEgressTest, SendPacket_QueuesWhenBlocked) {
+  output_.set_blocked(true);
+  EXPECT_EQ(OkStatus(), Send(1, 0));
+  EXPECT_EQ(OkStatus(), Send(2, 0));
+  EXPECT_EQ(2u, egress_.queued_packets());
+  EXPECT_EQ(Status::Unavailable(), egress_.Flush());
+
+  output_.set_blocked(false);
+  EXPECT_EQ(OkStatus(), egress_.Flush());
+  EXPECT_EQ(0u, egress_.queued_packets());
+  ExpectSent(std::array<uint32_t, 2>{1, 2});
+}
+
+TEST_F(QueuedEgressTest, SendPacket_DrainsQueueOnceUnblocked) {
+  output_.set_blocked(true);
+  ASSERT_EQ(OkStatus(), Send(1, 0));
+
+  // The queued packet is sent before the new one.
+  output_.set_blocked(false);
+  EXPECT_EQ(OkStatus(), Send(2, 0));
+  EXPECT_EQ(0u, egress_.queued_packets());
+  ExpectSent(std::array<uint32_t, 2>{1, 2});
+}
+
+TEST_F(QueuedEgressTest, Strict_SendsHighestPriorityFirst) {
+  output_.set_blocked(true);
+  ASSERT_EQ(OkStatus(), Send(1, 0));
+  ASSERT_EQ(OkStatus(), Send(2, 1));
+  ASSERT_EQ(OkStatus(), Send(3, 0));
+  ASSERT_EQ(OkStatus(), Send(4, 1));
+
+  output_.set_blocked(false);
+  EXPECT_EQ(OkStatus(), egress_.Flush());
+  ExpectSent(std::array<uint32_t, 4>{2, 4, 1, 3});
+}
+
+TEST_F(QueuedEgressTest, Weighted_SendsEachQueueItsShare) {
+  QueuedEgressWithBuffer<2, 8, sizeof(uint32_t)> weighted(
+      output_, Scheduling::kWeighted, kTwoQueues);
+
+  output_.set_blocked(true);
+  for (uint32_t id : {1, 2, 3}) {
+    ASSERT_EQ(OkStatus(), Send(weighted, id, 0));
+  }
+  for (uint32_t id : {11, 12, 13, 14}) {
+    ASSERT_EQ(OkStatus(), Send(weighted, id, 1));
+  }
+
+  output_.set_blocked(false);
+  EXPECT_EQ(OkStatus(), weighted.Flush());
+  ExpectSent(std::array<uint32_t, 7>{11, 12, 1, 13, 14, 2, 3});
+}
+
+TEST_F(QueuedEgressTest, UnknownPriorities_UseFirstAndLastQueues) {
+  output_.set_blocked(true);
+  const uint32_t id = 1;
+  ASSERT_EQ(OkStatus(),
+            egress_.SendPacket(std::as_bytes(std::span(&id, 1)), {}));
+  ASSERT_EQ(OkStatus(), Send(2, 99));
+
+  output_.set_blocked(false);
+  EXPECT_EQ(OkStatus(), egress_.Flush());
+  ExpectSent(std::array<uint32_t, 2>{2, 1});
+}
+
+TEST_F(QueuedEgressTest, QueueFull_DropsNewPacket) {
+  output_.set_blocked(true);
+  for (uint32_t id = 0; id < 4; ++id) {
+    ASSERT_EQ(OkStatus(), Send(id, 1));
+  }
+  EXPECT_EQ(Status::ResourceExhausted(), Send(4, 1));
+
+  // Other queues are unaffected.
+  EXPECT_EQ(OkStatus(), Send(5, 0));
+}
+
+TEST_F(QueuedEgressTest, PoolFull_DropsLowestPriorityFirst) {
+  output_.set_blocked(true);
+  ASSERT_EQ(OkStatus(), Send(1, 0));
+  ASSERT_EQ(OkStatus(), Send(2, 0));
+  for (uint32_t id = 11; id <= 14; ++id) {
+    ASSERT_EQ(OkStatus(), Send(id, 1));
+  }
+  ASSERT_EQ(6u, egress_.queued_packets());
+
+  // A low-priority packet may not displace high-priority packets.
+  EXPECT_EQ(Status::ResourceExhausted(), Send(3, 0));
+
+  output_.set_blocked(false);
+  EXPECT_EQ(OkStatus(), egress_.Flush());
+  ExpectSent(std::array<uint32_t, 6>{11, 12, 13, 14, 1, 2});
+}
+
+TEST_F(QueuedEgressTest, PoolFull_HighPriorityDisplacesOldestLowPriority) {
+  QueuedEgressWithBuffer<2, 4, sizeof(uint32_t)> small(
+      output_, Scheduling::kStrict, kTwoQueues);
+
+  output_.set_blocked(true);
+  for (uint32_t id : {1, 2, 3, 4}) {
+    ASSERT_EQ(OkStatus(), Send(small, id, 0));
+  }
+  EXPECT_EQ(OkStatus(), Send(small, 11, 1));
+  EXPECT_EQ(OkStatus(), Send(small, 12, 1));
+
+  output_.set_blocked(false);
+  EXPECT_EQ(OkStatus(), small.Flush());
+  ExpectSent(std::array<uint32_t, 4>{11, 12, 3, 4});
+}
+
+TEST_F(QueuedEgressTest, PacketTooLarge_Dropped) {
+  output_.set_blocked(true);
+  constexpr uint64_t kLargePacket = 0;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            egress_.SendPacket(std::as_bytes(std::span(&kLargePacket, 1)),
+                               PacketMetadata{.priority = 0}));
+  EXPECT_EQ(0u, egress_.queued_packets());
+}
+
+TEST_F(QueuedEgressTest, Metrics_CountQueueDepthAndDrops) {
+  std::array<QueuedEgress::Queue, 2> queues;
+  std::array<QueuedEgress::Packet, 2> packets;
+  std::array<std::byte, 2 * sizeof(uint32_t)> buffer;
+  QueuedEgress egress(
+      output_, Scheduling::kStrict, kTwoQueues, queues, packets, buffer);
+
+  output_.set_blocked(true);
+  ASSERT_EQ(OkStatus(), Send(egress, 1, 0));
+  ASSERT_EQ(OkStatus(), Send(egress, 2, 0));
+  ASSERT_EQ(OkStatus(), Send(egress, 11, 1));
+  EXPECT_EQ(Status::ResourceExhausted(), Send(egress, 3, 0));
+
+  EXPECT_EQ(1u, queues[0].queued());
+  EXPECT_EQ(2u, queues[0].dropped());
+  EXPECT_EQ(1u, queues[1].queued());
+  EXPECT_EQ(0u, queues[1].dropped());
+
+  output_.set_blocked(false);
+  ASSERT_EQ(OkStatus(), egress.Flush());
+  EXPECT_EQ(0u, queues[0].queued());
+  EXPECT_EQ(0u, queues[1].queued());
+}
+
+TEST_F(QueuedEgressTest, StaticRouter_ReportsEgressMetrics) {
+  struct Parser : PacketParser {
+    bool Parse(ConstByteSpan) override { return true; }
+    std::optional<uint32_t> GetDestinationAddress() const override {
+      return 1;
+    }
+  } parser;
+
+  const StaticRouter::Route routes[] = {{1, egress_}};
+  StaticRouter router(parser, routes);
+  router.AddMetrics(egress_.metrics());
+
+  ASSERT_EQ(1u, router.metrics().children().size());
+  EXPECT_EQ(&*router.metrics().children().begin(), &egress_.metrics());
+
+  // Packets queued by the egress are accepted by the router.
+  output_.set_blocked(true);
+  const uint32_t id = 1;
+  EXPECT_EQ(OkStatus(), router.RoutePacket(std::as_bytes(std::span(&id, 1))));
+  EXPECT_EQ(1u, egress_.queued_packets());
+}
+
+}  // namespace
+}  // namespace pw::router
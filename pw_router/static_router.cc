@@ -15,51 +15,136 @@
 #include "pw_router/static_router.h"
 
 #include <algorithm>
+#include <array>
 #include <mutex>
 
+#include "pw_assert/check.h"
+
 namespace pw::router {
 
+StaticRouter::StaticRouter(PacketParser& parser,
+                           std::span<const Route> routes,
+                           std::span<RouteMetrics> route_metrics)
+    : parser_(parser),
+      routes_(routes),
+      route_metrics_(route_metrics),
+      routes_sorted_(std::is_sorted(
+          routes.begin(), routes.end(), [](const Route& a, const Route& b) {
+            return a.address < b.address;
+          })) {
+  if (route_metrics_.empty()) {
+    return;
+  }
+
+  PW_CHECK_UINT_EQ(route_metrics_.size(), routes_.size());
+  for (size_t i = 0; i < routes_.size(); ++i) {
+    route_metrics_[i].address_.Set(routes_[i].address);
+    metrics_.Add(route_metrics_[i].group_);
+  }
+}
+
 Status StaticRouter::RoutePacket(ConstByteSpan packet) {
-  uint32_t address;
-  PacketMetadata metadata = {};
+  ParsedPacket parsed;
 
   {
     // Only packet parsing is synchronized within the router; egresses must be
     // synchronized externally.
     std::lock_guard lock(mutex_);
+    parsed = Parse(packet);
+  }
+
+  return Send(packet, parsed);
+}
 
-    if (!parser_.Parse(packet)) {
-      parser_errors_.Increment();
-      return Status::DataLoss();
+size_t StaticRouter::RoutePackets(std::span<const ConstByteSpan> packets) {
+  size_t sent = 0;
+  std::array<ParsedPacket, kBatchSize> parsed;
+
+  while (!packets.empty()) {
+    const std::span batch = packets.first(std::min(kBatchSize, packets.size()));
+    packets = packets.subspan(batch.size());
+
+    {
+      std::lock_guard lock(mutex_);
+      for (size_t i = 0; i < batch.size(); ++i) {
+        parsed[i] = Parse(batch[i]);
+      }
     }
 
-    std::optional<uint32_t> result = parser_.GetDestinationAddress();
-    if (!result.has_value()) {
-      parser_errors_.Increment();
-      return Status::DataLoss();
+    for (size_t i = 0; i < batch.size(); ++i) {
+      if (Send(batch[i], parsed[i]).ok()) {
+        sent += 1;
+      }
     }
+  }
+
+  return sent;
+}
 
-    address = result.value();
+StaticRouter::ParsedPacket StaticRouter::Parse(ConstByteSpan packet) {
+  ParsedPacket parsed;
+  parsed.status = Status::DataLoss();
 
-    // Populate the metadata with fields extracted from the packet.
-    metadata.priority = parser_.GetPriority();
+  if (!parser_.Parse(packet)) {
+    return parsed;
   }
 
-  auto route = std::find_if(routes_.begin(), routes_.end(), [&](auto r) {
-    return r.address == address;
-  });
-  if (route == routes_.end()) {
+  std::optional<uint32_t> result = parser_.GetDestinationAddress();
+  if (!result.has_value()) {
+    return parsed;
+  }
+
+  parsed.status = OkStatus();
+  parsed.address = result.value();
+
+  // Populate the metadata with fields extracted from the packet.
+  parsed.metadata.priority = parser_.GetPriority();
+  return parsed;
+}
+
+Status StaticRouter::Send(ConstByteSpan packet, const ParsedPacket& parsed) {
+  if (!parsed.status.ok()) {
+    parser_errors_.Increment();
+    return Status::DataLoss();
+  }
+
+  const size_t index = FindRoute(parsed.address);
+  if (index == routes_.size()) {
     route_errors_.Increment();
     return Status::NotFound();
   }
 
-  if (Status status = route->egress.SendPacket(packet, metadata);
+  if (Status status = routes_[index].egress.SendPacket(packet, parsed.metadata);
       !status.ok()) {
     egress_errors_.Increment();
     return Status::Unavailable();
   }
 
+  if (!route_metrics_.empty()) {
+    route_metrics_[index].packets_.Increment();
+    route_metrics_[index].bytes_.Increment(packet.size());
+  }
+
   return OkStatus();
 }
 
+size_t StaticRouter::FindRoute(uint32_t address) const {
+  if (routes_sorted_) {
+    auto route = std::lower_bound(
+        routes_.begin(),
+        routes_.end(),
+        address,
+        [](const Route& r, uint32_t value) { return r.address < value; });
+    if (route != routes_.end() && route->address == address) {
+      return route - routes_.begin();
+    }
+    return routes_.size();
+  }
+
+  auto route = std::find_if(routes_.begin(), routes_.end(), [&](auto r) {
+    return r.address == address;
+  });
+  return route - routes_.begin();
+}
+
 }  // namespace pw::router
@@ -14,6 +14,8 @@
 
 #include "pw_router/static_router.h"
 
+#include <array>
+
 #include "gtest/gtest.h"
 #include "pw_assert/check.h"
 #include "pw_router/egress_function.h"
@@ -141,5 +143,97 @@ TEST(StaticRouter, RoutePacket_TracksNumberOfDrops) {
   EXPECT_EQ(router.dropped_packets(), 3u);
 }
 
+TEST(StaticRouter, RoutePacket_SortedAndUnsortedRoutes) {
+  BasicPacketParser parser;
+  constexpr StaticRouter::Route sorted[] = {
+      {1, GoodEgress}, {3, BadEgress}, {5, GoodEgress}, {9, GoodEgress}};
+  constexpr StaticRouter::Route unsorted[] = {
+      {9, GoodEgress}, {3, BadEgress}, {1, GoodEgress}, {5, GoodEgress}};
+  StaticRouter sorted_router(parser, std::span(sorted));
+  StaticRouter unsorted_router(parser, std::span(unsorted));
+
+  for (StaticRouter* router : {&sorted_router, &unsorted_router}) {
+    EXPECT_EQ(router->RoutePacket(BasicPacket(1, 0xdddd).data()), OkStatus());
+    EXPECT_EQ(router->RoutePacket(BasicPacket(3, 0xdddd).data()),
+              Status::Unavailable());
+    EXPECT_EQ(router->RoutePacket(BasicPacket(9, 0xdddd).data()), OkStatus());
+    EXPECT_EQ(router->RoutePacket(BasicPacket(0, 0xdddd).data()),
+              Status::NotFound());
+    EXPECT_EQ(router->RoutePacket(BasicPacket(4, 0xdddd).data()),
+              Status::NotFound());
+    EXPECT_EQ(router->RoutePacket(BasicPacket(10, 0xdddd).data()),
+              Status::NotFound());
+  }
+}
+
+TEST(StaticRouter, RoutePackets_RoutesEachPacket) {
+  struct {
+    std::array<uint64_t, 12> payloads = {};
+    size_t count = 0;
+  } received;
+  EgressFunction recording_egress(
+      [&received](ConstByteSpan packet, const PacketMetadata&) {
+        received.payloads[received.count++] =
+            reinterpret_cast<const BasicPacket*>(packet.data())->payload;
+        return OkStatus();
+      });
+
+  BasicPacketParser parser;
+  StaticRouter::Route routes[] = {{1, recording_egress}, {2, BadEgress}};
+  StaticRouter router(parser, std::span(routes));
+
+  // Span more than one batch, with failures of each kind mixed in.
+  std::array<BasicPacket, StaticRouter::kBatchSize + 4> packets = {
+      BasicPacket(1, 0),  BasicPacket(1, 1),  BasicPacket(2, 2),
+      BasicPacket(1, 3),  BasicPacket(42, 4), BasicPacket(1, 5),
+      BasicPacket(1, 6),  BasicPacket(1, 7),  BasicPacket(1, 8),
+      BasicPacket(1, 9),  BasicPacket(1, 10), BasicPacket(1, 11),
+  };
+  packets[9].magic = 0x1badda7a;
+
+  std::array<ConstByteSpan, packets.size()> spans;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    spans[i] = packets[i].data();
+  }
+
+  EXPECT_EQ(router.RoutePackets(spans), 9u);
+  EXPECT_EQ(router.dropped_packets(), 3u);
+
+  ASSERT_EQ(received.count, 9u);
+  constexpr uint64_t kExpected[] = {0, 1, 3, 5, 6, 7, 8, 10, 11};
+  for (size_t i = 0; i < received.count; ++i) {
+    EXPECT_EQ(received.payloads[i], kExpected[i]);
+  }
+}
+
+TEST(StaticRouter, RoutePackets_Empty) {
+  BasicPacketParser parser;
+  constexpr StaticRouter::Route routes[] = {{1, GoodEgress}};
+  StaticRouter router(parser, std::span(routes));
+
+  EXPECT_EQ(router.RoutePackets({}), 0u);
+  EXPECT_EQ(router.dropped_packets(), 0u);
+}
+
+TEST(StaticRouter, RouteMetrics_CountsAcceptedTraffic) {
+  BasicPacketParser parser;
+  constexpr StaticRouter::Route routes[] = {{1, GoodEgress}, {2, BadEgress}};
+  std::array<StaticRouter::RouteMetrics, 2> route_metrics;
+  StaticRouter router(parser, std::span(routes), route_metrics);
+
+  EXPECT_EQ(router.RoutePacket(BasicPacket(1, 0xdddd).data()), OkStatus());
+  EXPECT_EQ(router.RoutePacket(BasicPacket(1, 0xdddd).data()), OkStatus());
+  EXPECT_EQ(router.RoutePacket(BasicPacket(2, 0xdddd).data()),
+            Status::Unavailable());
+
+  EXPECT_EQ(route_metrics[0].packets(), 2u);
+  EXPECT_EQ(route_metrics[0].bytes(), 2 * sizeof(BasicPacket));
+  EXPECT_EQ(route_metrics[1].packets(), 0u);
+  EXPECT_EQ(route_metrics[1].bytes(), 0u);
+
+  // The route groups are children of the router's metrics.
+  EXPECT_EQ(router.metrics().children().size(), 2u);
+}
+
 }  // namespace
 }  // namespace pw::router
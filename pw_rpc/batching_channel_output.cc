@@ -0,0 +1,136 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/batching_channel_output.h"
+
+#include <cstring>
+#include <mutex>
+
+#include "pw_assert/check.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_rpc/internal/packet_batch.h"
+#include "pw_varint/varint.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr uint32_t kPacketKey = protobuf::FieldKey(
+    internal::kPacketBatchField, protobuf::WireType::kDelimited);
+
+// The key is written as a single byte.
+static_assert(kPacketKey < 0x80u);
+
+}  // namespace
+
+BatchingChannelOutput::BatchingChannelOutput(
+    const char* name,
+    ChannelOutput& output,
+    ByteSpan buffer,
+    size_t max_packet_size,
+    chrono::SystemClock::duration max_latency)
+    : ChannelOutput(name),
+      output_(output),
+      buffer_(buffer),
+      max_packet_size_(max_packet_size),
+      max_latency_(max_latency),
+      max_prefix_size_(1 + varint::EncodedSize(max_packet_size)),
+      size_(0),
+      packet_count_(0),
+      first_packet_offset_(0) {
+  PW_CHECK_UINT_GE(buffer.size(), max_prefix_size_ + max_packet_size);
+}
+
+std::span<std::byte> BatchingChannelOutput::AcquireBuffer() {
+  mutex_.lock();
+  return buffer_.subspan(size_ + max_prefix_size_, max_packet_size_);
+}
+
+Status BatchingChannelOutput::SendAndReleaseBuffer(
+    std::span<const std::byte> packet) {
+  if (packet.empty()) {
+    mutex_.unlock();
+    return OkStatus();
+  }
+
+  PW_DCHECK_PTR_EQ(packet.data(), &buffer_[size_ + max_prefix_size_]);
+
+  // Write the packet's key and length, then move the packet after them.
+  std::byte* const start = &buffer_[size_];
+  start[0] = std::byte{kPacketKey};
+  const size_t prefix_size =
+      1 + varint::Encode(packet.size(), buffer_.subspan(size_ + 1));
+  std::memmove(start + prefix_size, packet.data(), packet.size());
+
+  if (packet_count_ == 0u) {
+    first_packet_offset_ = prefix_size;
+    oldest_packet_ = chrono::SystemClock::now();
+  }
+  size_ += prefix_size + packet.size();
+  packet_count_ += 1;
+
+  // Send the batch if the next packet might not fit, so that AcquireBuffer()
+  // always has room.
+  Status status = OkStatus();
+  if (buffer_.size() - size_ < max_prefix_size_ + max_packet_size_ ||
+      Expired()) {
+    status = SendBatch();
+  }
+
+  mutex_.unlock();
+  return status;
+}
+
+Status BatchingChannelOutput::Flush() {
+  std::lock_guard lock(mutex_);
+  return SendBatch();
+}
+
+Status BatchingChannelOutput::FlushIfExpired() {
+  std::lock_guard lock(mutex_);
+  if (packet_count_ == 0u || !Expired()) {
+    return OkStatus();
+  }
+  return SendBatch();
+}
+
+size_t BatchingChannelOutput::pending_packets() const {
+  std::lock_guard lock(mutex_);
+  return packet_count_;
+}
+
+Status BatchingChannelOutput::SendBatch() {
+  if (packet_count_ == 0u) {
+    return OkStatus();
+  }
+
+  // A single packet does not need the batch's framing.
+  const ConstByteSpan batch =
+      packet_count_ == 1u
+          ? ConstByteSpan(buffer_.data() + first_packet_offset_,
+                          size_ - first_packet_offset_)
+          : ConstByteSpan(buffer_.data(), size_);
+  size_ = 0;
+  packet_count_ = 0;
+
+  std::span<std::byte> destination = output_.AcquireBuffer();
+  if (destination.size() < batch.size()) {
+    output_.DiscardBuffer(destination);
+    return Status::ResourceExhausted();
+  }
+
+  std::memcpy(destination.data(), batch.data(), batch.size());
+  return output_.SendAndReleaseBuffer(destination.first(batch.size()));
+}
+
+}  // namespace pw::rpc
@@ -0,0 +1,203 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/batching_channel_output.h"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_containers/vector.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/internal/packet_batch.h"
+#include "pw_status/try.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::Packet;
+using internal::PacketType;
+using namespace std::chrono_literals;
+
+constexpr size_t kMaxPacketSize = 24;
+
+// Records each packet sent to it.
+class RecordingOutput final : public ChannelOutput {
+ public:
+  RecordingOutput() : ChannelOutput("recording") {}
+
+  std::span<std::byte> AcquireBuffer() override {
+    return std::span(buffer_).first(buffer_size);
+  }
+
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) override {
+    if (!buffer.empty()) {
+      sent.emplace_back();
+      sent.back().resize(buffer.size());
+      std::memcpy(sent.back().data(), buffer.data(), buffer.size());
+    }
+    return OkStatus();
+  }
+
+  Vector<Vector<std::byte, 128>, 8> sent;
+  size_t buffer_size = 128;
+
+ private:
+  std::array<std::byte, 128> buffer_;
+};
+
+class BatchingChannelOutputTest : public ::testing::Test {
+ protected:
+  // Sends an RPC packet for the given method through the output.
+  static Status Send(ChannelOutput& output, uint32_t method_id) {
+    std::span<std::byte> buffer = output.AcquireBuffer();
+    Result<ConstByteSpan> result =
+        Packet(PacketType::SERVER_STREAM, 1, 42, method_id).Encode(buffer);
+    EXPECT_EQ(OkStatus(), result.status());
+    return output.SendAndReleaseBuffer(result.value_or(ConstByteSpan()));
+  }
+
+  // Decodes the method IDs of the packets in a sent batch.
+  static Vector<uint32_t, 8> MethodIds(ConstByteSpan batch) {
+    Vector<uint32_t, 8> ids;
+    EXPECT_TRUE(internal::IsPacketBatch(batch));
+    EXPECT_EQ(OkStatus(),
+              internal::ForEachPacketInBatch(batch, [&ids](ConstByteSpan data) {
+                Result<Packet> packet = Packet::FromBuffer(data);
+                PW_TRY(packet.status());
+                ids.push_back(packet->method_id());
+                return OkStatus();
+              }));
+    return ids;
+  }
+
+  RecordingOutput output_;
+};
+
+TEST_F(BatchingChannelOutputTest, AcquireBuffer_ReturnsMaxPacketSize) {
+  BatchingChannelOutputWithBuffer<64> batching(
+      "batching", output_, kMaxPacketSize, 1h);
+
+  std::span<std::byte> buffer = batching.AcquireBuffer();
+  EXPECT_EQ(kMaxPacketSize, buffer.size());
+  batching.DiscardBuffer(buffer);
+}
+
+TEST_F(BatchingChannelOutputTest, Send_HoldsPacketsUntilFlushed) {
+  BatchingChannelOutputWithBuffer<96> batching(
+      "batching", output_, kMaxPacketSize, 1h);
+
+  ASSERT_EQ(OkStatus(), Send(batching, 100));
+  ASSERT_EQ(OkStatus(), Send(batching, 200));
+  EXPECT_EQ(2u, batching.pending_packets());
+  EXPECT_TRUE(output_.sent.empty());
+
+  ASSERT_EQ(OkStatus(), batching.Flush());
+  EXPECT_EQ(0u, batching.pending_packets());
+  ASSERT_EQ(1u, output_.sent.size());
+
+  const Vector<uint32_t, 8> ids = MethodIds(output_.sent[0]);
+  ASSERT_EQ(2u, ids.size());
+  EXPECT_EQ(100u, ids[0]);
+  EXPECT_EQ(200u, ids[1]);
+}
+
+TEST_F(BatchingChannelOutputTest, Flush_SinglePacket_SentWithoutBatch) {
+  BatchingChannelOutputWithBuffer<96> batching(
+      "batching", output_, kMaxPacketSize, 1h);
+
+  ASSERT_EQ(OkStatus(), Send(batching, 100));
+  ASSERT_EQ(OkStatus(), batching.Flush());
+
+  ASSERT_EQ(1u, output_.sent.size());
+  EXPECT_FALSE(internal::IsPacketBatch(output_.sent[0]));
+  Result<Packet> packet = Packet::FromBuffer(output_.sent[0]);
+  ASSERT_EQ(OkStatus(), packet.status());
+  EXPECT_EQ(100u, packet->method_id());
+}
+
+TEST_F(BatchingChannelOutputTest, Flush_NoPackets_SendsNothing) {
+  BatchingChannelOutputWithBuffer<64> batching(
+      "batching", output_, kMaxPacketSize, 1h);
+
+  EXPECT_EQ(OkStatus(), batching.Flush());
+  EXPECT_TRUE(output_.sent.empty());
+}
+
+TEST_F(BatchingChannelOutputTest, Send_BatchFull_SendsBatch) {
+  // Room for two packets of the maximum size, each with a 2-byte prefix. The
+  // test packets are smaller, so the first two leave room for less than one
+  // more.
+  BatchingChannelOutputWithBuffer<2 * (kMaxPacketSize + 2)> batching(
+      "batching", output_, kMaxPacketSize, 1h);
+
+  ASSERT_EQ(OkStatus(), Send(batching, 100));
+  EXPECT_TRUE(output_.sent.empty());
+  ASSERT_EQ(OkStatus(), Send(batching, 200));
+  ASSERT_EQ(1u, output_.sent.size());
+  EXPECT_EQ(0u, batching.pending_packets());
+  EXPECT_EQ(2u, MethodIds(output_.sent[0]).size());
+
+  // The space is reused for the next batch.
+  ASSERT_EQ(OkStatus(), Send(batching, 300));
+  EXPECT_EQ(1u, batching.pending_packets());
+}
+
+TEST_F(BatchingChannelOutputTest, Send_NoLatency_SendsImmediately) {
+  BatchingChannelOutputWithBuffer<96> batching(
+      "batching", output_, kMaxPacketSize, 0ms);
+
+  ASSERT_EQ(OkStatus(), Send(batching, 100));
+  ASSERT_EQ(OkStatus(), Send(batching, 200));
+
+  ASSERT_EQ(2u, output_.sent.size());
+  EXPECT_FALSE(internal::IsPacketBatch(output_.sent[0]));
+  EXPECT_FALSE(internal::IsPacketBatch(output_.sent[1]));
+}
+
+TEST_F(BatchingChannelOutputTest, FlushIfExpired_NotExpired_HoldsPackets) {
+  BatchingChannelOutputWithBuffer<96> batching(
+      "batching", output_, kMaxPacketSize, 1h);
+
+  ASSERT_EQ(OkStatus(), Send(batching, 100));
+  EXPECT_EQ(OkStatus(), batching.FlushIfExpired());
+
+  EXPECT_TRUE(output_.sent.empty());
+  EXPECT_EQ(1u, batching.pending_packets());
+}
+
+TEST_F(BatchingChannelOutputTest, Send_EmptyPacket_ReleasesBuffer) {
+  BatchingChannelOutputWithBuffer<64> batching(
+      "batching", output_, kMaxPacketSize, 1h);
+
+  batching.DiscardBuffer(batching.AcquireBuffer());
+  EXPECT_EQ(0u, batching.pending_packets());
+}
+
+TEST_F(BatchingChannelOutputTest, Flush_OutputBufferTooSmall_Fails) {
+  BatchingChannelOutputWithBuffer<96> batching(
+      "batching", output_, kMaxPacketSize, 1h);
+  output_.buffer_size = 8;
+
+  ASSERT_EQ(OkStatus(), Send(batching, 100));
+  ASSERT_EQ(OkStatus(), Send(batching, 200));
+
+  EXPECT_EQ(Status::ResourceExhausted(), batching.Flush());
+  EXPECT_TRUE(output_.sent.empty());
+  EXPECT_EQ(0u, batching.pending_packets());
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -16,7 +16,14 @@
 
 #include <algorithm>
 
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_rpc/benchmark.pwpb.h"
+#include "pw_result/result.h"
 #include "pw_rpc/internal/config.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
 
 namespace pw::rpc {
 namespace {
@@ -29,6 +36,72 @@ StatusWithSize CopyBuffer(ConstByteSpan input, ByteSpan output) {
   return pw::StatusWithSize(input.size());
 }
 
+Status DecodeStreamRequest(ConstByteSpan request,
+                           uint32_t& payload_size,
+                           uint32_t& count) {
+  payload_size = 0;
+  count = 0;
+
+  protobuf::Decoder decoder(request);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (static_cast<StreamRequest::Fields>(decoder.FieldNumber())) {
+      case StreamRequest::Fields::PAYLOAD_SIZE:
+        PW_TRY(decoder.ReadUint32(&payload_size));
+        break;
+      case StreamRequest::Fields::COUNT:
+        PW_TRY(decoder.ReadUint32(&count));
+        break;
+    }
+  }
+  return status.IsOutOfRange() ? OkStatus() : Status::DataLoss();
+}
+
+// Encodes a Payload with payload_size bytes in place, so that responses are
+// not copied from a separate buffer. The bytes count up from the index of the
+// response, so that clients may check them.
+StatusWithSize EncodePayload(ByteSpan buffer,
+                             uint32_t payload_size,
+                             uint32_t index) {
+  if (payload_size == 0u) {
+    return StatusWithSize(0);  // Empty fields are not encoded in proto3.
+  }
+
+  size_t size = varint::Encode(
+      uint32_t(protobuf::FieldKey(
+          static_cast<uint32_t>(Payload::Fields::PAYLOAD),
+          protobuf::WireType::kDelimited)),
+      buffer);
+  size += varint::Encode(payload_size, buffer.subspan(size));
+  if (size == 0u || buffer.size() - size < payload_size) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  for (uint32_t i = 0; i < payload_size; ++i) {
+    buffer[size + i] = static_cast<std::byte>(index + i);
+  }
+  return StatusWithSize(size + payload_size);
+}
+
+// Returns the size of a Payload's payload field.
+Result<size_t> PayloadSize(ConstByteSpan payload) {
+  protobuf::Decoder decoder(payload);
+  size_t size = 0;
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    if (decoder.FieldNumber() ==
+        static_cast<uint32_t>(Payload::Fields::PAYLOAD)) {
+      ConstByteSpan bytes;
+      PW_TRY(decoder.ReadBytes(&bytes));
+      size = bytes.size();
+    }
+  }
+  if (!status.IsOutOfRange()) {
+    return Status::DataLoss();
+  }
+  return size;
+}
+
 }  // namespace
 
 StatusWithSize BenchmarkService::UnaryEcho(ServerContext&,
@@ -50,4 +123,69 @@ void BenchmarkService::BidirectionalEcho(
   });
 }
 
+void BenchmarkService::ServerStream(ServerContext&,
+                                    ConstByteSpan request,
+                                    RawServerWriter& writer) {
+  uint32_t payload_size;
+  uint32_t count;
+  if (Status status = DecodeStreamRequest(request, payload_size, count);
+      !status.ok()) {
+    writer.Finish(status).IgnoreError();
+    return;
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    const ByteSpan buffer = writer.PayloadBuffer();
+    const StatusWithSize encoded = EncodePayload(buffer, payload_size, i);
+    if (!encoded.ok()) {
+      writer.ReleaseBuffer();
+      writer.Finish(encoded.status()).IgnoreError();
+      return;
+    }
+
+    if (Status status = writer.Write(buffer.first(encoded.size()));
+        !status.ok()) {
+      writer.Finish(status).IgnoreError();
+      return;
+    }
+  }
+
+  writer.Finish().IgnoreError();
+}
+
+void BenchmarkService::ClientStream(ServerContext&,
+                                    RawServerReader& new_reader) {
+  reader_ = std::move(new_reader);
+  payload_count_ = 0;
+  payload_bytes_ = 0;
+
+  reader_.set_on_next([this](ConstByteSpan request) {
+    const Result<size_t> size = PayloadSize(request);
+    if (!size.ok()) {
+      reader_.Finish({}, size.status()).IgnoreError();
+      return;
+    }
+    if (size.value() == 0u) {
+      FinishClientStream();
+      return;
+    }
+    payload_count_ += 1;
+    payload_bytes_ += size.value();
+  });
+
+#if PW_RPC_CLIENT_STREAM_END_CALLBACK
+  reader_.set_on_client_stream_end([this]() { FinishClientStream(); });
+#endif  // PW_RPC_CLIENT_STREAM_END_CALLBACK
+}
+
+void BenchmarkService::FinishClientStream() {
+  // Each field is a one-byte key and a varint.
+  std::byte buffer[2 * (1 + varint::kMaxVarint64SizeBytes)];
+  StreamStats::MemoryEncoder stats(buffer);
+  stats.WritePayloadCount(payload_count_).IgnoreError();
+  stats.WritePayloadBytes(payload_bytes_).IgnoreError();
+  reader_.Finish(ConstByteSpan(stats.data(), stats.size()), stats.status())
+      .IgnoreError();
+}
+
 }  // namespace pw::rpc
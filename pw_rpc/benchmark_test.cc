@@ -0,0 +1,156 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/benchmark.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_rpc/benchmark.pwpb.h"
+#include "pw_rpc/raw/test_method_context.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr uint32_t kPayloadField =
+    static_cast<uint32_t>(Payload::Fields::PAYLOAD);
+
+class StreamRequestBuffer {
+ public:
+  StreamRequestBuffer(uint32_t payload_size, uint32_t count)
+      : encoder_(buffer_) {
+    EXPECT_EQ(OkStatus(), encoder_.WritePayloadSize(payload_size));
+    EXPECT_EQ(OkStatus(), encoder_.WriteCount(count));
+  }
+
+  ConstByteSpan get() const {
+    return ConstByteSpan(encoder_.data(), encoder_.size());
+  }
+
+ private:
+  std::array<std::byte, 16> buffer_ = {};
+  StreamRequest::MemoryEncoder encoder_;
+};
+
+ConstByteSpan DecodePayload(ConstByteSpan payload) {
+  protobuf::Decoder decoder(payload);
+  ConstByteSpan bytes;
+  while (decoder.Next().ok()) {
+    if (decoder.FieldNumber() == kPayloadField) {
+      EXPECT_EQ(OkStatus(), decoder.ReadBytes(&bytes));
+    }
+  }
+  return bytes;
+}
+
+TEST(BenchmarkService, UnaryEcho_EchoesRequest) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, UnaryEcho) context;
+  constexpr std::byte kRequest[] = {
+      std::byte{0x0a}, std::byte{1}, std::byte{7}};
+
+  EXPECT_EQ(OkStatus(), context.call(kRequest).status());
+  ASSERT_EQ(sizeof(kRequest), context.response().size());
+  EXPECT_EQ(0, std::memcmp(kRequest, context.response().data(), 3));
+}
+
+TEST(BenchmarkService, ServerStream_SendsRequestedPayloads) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, ServerStream, 4) context;
+
+  context.call(StreamRequestBuffer(10, 3).get());
+
+  ASSERT_TRUE(context.done());
+  EXPECT_EQ(OkStatus(), context.status());
+  ASSERT_EQ(3u, context.responses().size());
+
+  uint32_t index = 0;
+  for (ConstByteSpan response : context.responses()) {
+    const ConstByteSpan payload = DecodePayload(response);
+    ASSERT_EQ(10u, payload.size());
+    for (size_t i = 0; i < payload.size(); ++i) {
+      EXPECT_EQ(static_cast<std::byte>(index + i), payload[i]);
+    }
+    index += 1;
+  }
+}
+
+TEST(BenchmarkService, ServerStream_ZeroCount_Completes) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, ServerStream) context;
+
+  context.call(StreamRequestBuffer(10, 0).get());
+
+  ASSERT_TRUE(context.done());
+  EXPECT_EQ(OkStatus(), context.status());
+  EXPECT_EQ(0u, context.responses().size());
+}
+
+TEST(BenchmarkService, ServerStream_PayloadTooLarge_ResourceExhausted) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, ServerStream) context;
+
+  context.call(StreamRequestBuffer(1024, 2).get());
+
+  ASSERT_TRUE(context.done());
+  EXPECT_EQ(Status::ResourceExhausted(), context.status());
+  EXPECT_EQ(0u, context.responses().size());
+}
+
+TEST(BenchmarkService, ClientStream_EmptyPayload_RespondsWithTotals) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, ClientStream) context;
+  context.call();
+
+  constexpr std::byte kPayloads[][5] = {
+      {std::byte{0x0a}, std::byte{1}, std::byte{0}},
+      {std::byte{0x0a}, std::byte{3}, std::byte{0}, std::byte{0}, std::byte{0}},
+  };
+  context.SendClientStream(std::span(kPayloads[0]).first(3));
+  context.SendClientStream(kPayloads[1]);
+  EXPECT_FALSE(context.done());
+
+  context.SendClientStream({});
+
+  ASSERT_TRUE(context.done());
+  EXPECT_EQ(OkStatus(), context.status());
+
+  uint32_t payload_count = 0;
+  uint64_t payload_bytes = 0;
+  protobuf::Decoder decoder(context.response());
+  while (decoder.Next().ok()) {
+    switch (static_cast<StreamStats::Fields>(decoder.FieldNumber())) {
+      case StreamStats::Fields::PAYLOAD_COUNT:
+        EXPECT_EQ(OkStatus(), decoder.ReadUint32(&payload_count));
+        break;
+      case StreamStats::Fields::PAYLOAD_BYTES:
+        EXPECT_EQ(OkStatus(), decoder.ReadUint64(&payload_bytes));
+        break;
+    }
+  }
+  EXPECT_EQ(2u, payload_count);
+  EXPECT_EQ(4u, payload_bytes);
+}
+
+TEST(BenchmarkService, ClientStream_InvalidPayload_DataLoss) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, ClientStream) context;
+  context.call();
+
+  constexpr std::byte kTruncated[] = {std::byte{0x0a}, std::byte{8}};
+  context.SendClientStream(kTruncated);
+
+  ASSERT_TRUE(context.done());
+  EXPECT_EQ(Status::DataLoss(), context.status());
+}
+
+}  // namespace
+}  // namespace pw::rpc
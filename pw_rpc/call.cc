@@ -14,6 +14,8 @@
 
 #include "pw_rpc/internal/call.h"
 
+#include <limits>
+
 #include "pw_assert/check.h"
 #include "pw_rpc/client.h"
 #include "pw_rpc/internal/endpoint.h"
@@ -34,7 +36,8 @@ Call::Call(Endpoint& client,
            service_id,
            method_id,
            type,
-           kClientCall) {}
+           kClientCall,
+           kUnlimitedCredits) {}
 
 Call::Call(Endpoint& endpoint_ref,
            uint32_t call_id,
@@ -42,7 +45,8 @@ Call::Call(Endpoint& endpoint_ref,
            uint32_t service_id,
            uint32_t method_id,
            MethodType type,
-           CallType call_type)
+           CallType call_type,
+           uint32_t credits)
     : endpoint_(&endpoint_ref),
       channel_(endpoint().GetInternalChannel(channel_id)),
       id_(call_id),
@@ -52,7 +56,8 @@ Call::Call(Endpoint& endpoint_ref,
       type_(type),
       call_type_(call_type),
       client_stream_state_(HasClientStream(type) ? kClientStreamActive
-                                                 : kClientStreamInactive) {
+                                                 : kClientStreamInactive),
+      credits_(credits) {
   // TODO(pwbug/505): Defer channel lookup until it's needed to support dynamic
   // registration/removal of channels.
   PW_CHECK_NOTNULL(channel_,
@@ -81,6 +86,7 @@ void Call::MoveFrom(Call& other) {
   type_ = other.type_;
   call_type_ = other.call_type_;
   client_stream_state_ = other.client_stream_state_;
+  credits_ = other.credits_;
 
   response_ = std::move(other.response_);
 
@@ -109,7 +115,15 @@ Status Call::CloseAndSendFinalPacket(PacketType type,
     return Status::FailedPrecondition();
   }
   Close();
-  return SendPacket(type, response, status);
+
+  // Copy the call's details, since it may be reused once the lock is released.
+  const bool server_call = call_type_ == kServerCall;
+  const uint32_t method_id = method_id_;
+  const Status send_status = SendPacket(type, response, status);
+  if (server_call) {
+    TraceCallEnd(method_id);
+  }
+  return send_status;
 }
 
 ByteSpan Call::AcquirePayloadBuffer() {
@@ -130,30 +144,76 @@ Status Call::Write(ConstByteSpan payload) {
     rpc_lock().unlock();
     return Status::FailedPrecondition();
   }
-  return SendPacket(call_type_ == kServerCall ? PacketType::SERVER_STREAM
-                                              : PacketType::CLIENT_STREAM,
-                    payload);
+
+  if (call_type_ == kClientCall) {
+    return SendPacket(PacketType::CLIENT_STREAM, payload);
+  }
+
+  if (credits_ == kUnlimitedCredits) {
+    return SendPacket(PacketType::SERVER_STREAM, payload);
+  }
+
+  if (credits_ == 0u) {
+    rpc_lock().unlock();
+    return Status::Unavailable();
+  }
+
+  credits_ -= 1;
+  const Status status = SendPacket(PacketType::SERVER_STREAM, payload);
+
+  // The client never sees a packet that failed to send, so return its credit.
+  if (!status.ok()) {
+    std::lock_guard lock(rpc_lock());
+    if (active() && credits_ != kUnlimitedCredits) {
+      credits_ += 1;
+    }
+  }
+  return status;
 }
 
-Status Call::SendPacket(PacketType type, ConstByteSpan payload, Status status) {
-  const Packet packet = MakePacket(type, payload, status);
+Status Call::SendPacket(const Packet& packet) {
+  const ConstByteSpan payload = packet.payload();
 
-  if (!buffer().Contains(payload)) {
-    ByteSpan buffer = AcquirePayloadBuffer();
+  if (response_.empty()) {
+    // The payload is in a standalone buffer. Acquire an output buffer after
+    // releasing the lock, since the ChannelOutput may block. The payload is
+    // encoded directly from the caller's buffer, so it is not copied here.
+    Channel& output_channel = channel();
+    rpc_lock().unlock();
 
-    if (payload.size() > buffer.size()) {
-      ReleasePayloadBuffer();
-      rpc_lock().unlock();
+    Channel::OutputBuffer output_buffer = output_channel.AcquireBuffer();
+    if (payload.size() > output_buffer.payload(packet).size()) {
+      output_channel.Release(output_buffer);
       return Status::OutOfRange();
     }
+    return output_channel.Send(output_buffer, packet);
+  }
 
-    std::memcpy(buffer.data(), payload.data(), payload.size());
+  // A payload buffer was previously acquired from the ChannelOutput, so use it
+  // to send the packet.
+  if (!buffer().Contains(payload) &&
+      payload.size() > response_.payload(packet).size()) {
+    ReleasePayloadBuffer();
+    rpc_lock().unlock();
+    return Status::OutOfRange();
   }
 
   rpc_lock().unlock();
   return channel().Send(response_, packet);
 }
 
+size_t Call::MaxWriteSizeBytes() const {
+  if (channel_ == nullptr) {
+    return 0;
+  }
+
+  const size_t mtu = channel().MaximumTransmissionUnit();
+  if (mtu == std::numeric_limits<size_t>::max()) {
+    return mtu;
+  }
+  return MakePacket(PacketType::CLIENT_STREAM, {}).MaxPayloadSizeBytes(mtu);
+}
+
 void Call::ReleasePayloadBuffer() {
   PW_DCHECK(active());
   channel().Release(response_);
@@ -0,0 +1,143 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/internal/call_index.h"
+
+#include <array>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "pw_rpc/internal/test_method.h"
+#include "pw_rpc/internal/test_utils.h"
+#include "pw_rpc/service.h"
+#include "pw_rpc_private/fake_server_reader_writer.h"
+
+namespace pw::rpc {
+
+class TestService : public Service {
+ public:
+  constexpr TestService(uint32_t id) : Service(id, method) {}
+
+  static constexpr internal::TestMethodUnion method = internal::TestMethod(8);
+};
+
+namespace internal {
+namespace {
+
+using test::FakeServerReaderWriter;
+
+constexpr uint32_t kServiceId = 16;
+constexpr size_t kCalls = 24;
+
+// Creates one call on each of kCalls channels.
+class CallIndexTest : public ::testing::Test {
+ protected:
+  CallIndexTest() : server_(std::span(channels_)), service_(kServiceId) {
+    for (size_t i = 0; i < kCalls; ++i) {
+      channels_[i].Configure(static_cast<uint32_t>(i + 1), output_);
+    }
+    server_.RegisterService(service_);
+
+    for (size_t i = 0; i < kCalls; ++i) {
+      calls_[i].emplace(CallContext(server_,
+                                    static_cast<Channel&>(channels_[i]),
+                                    service_,
+                                    TestService::method.method(),
+                                    0));
+    }
+  }
+
+  Call& call(size_t i) { return calls_[i]->as_server_call(); }
+
+  static constexpr uint32_t kMethodId = 8;
+
+  TestOutput<128> output_;
+  std::array<rpc::Channel, kCalls> channels_;
+  Server server_;
+  TestService service_;
+  std::array<std::optional<FakeServerReaderWriter>, kCalls> calls_;
+};
+
+TEST(CallIndex, Disabled_IndexesNothing) {
+  CallIndex<0> index;
+  EXPECT_EQ(nullptr, index.Find(1, kServiceId, 8));
+  EXPECT_EQ(0u, index.size());
+}
+
+TEST_F(CallIndexTest, Add_FindsAllCalls) {
+  CallIndex<64> index;
+  for (size_t i = 0; i < kCalls; ++i) {
+    ASSERT_TRUE(index.Add(call(i)));
+  }
+  EXPECT_EQ(kCalls, index.size());
+
+  for (size_t i = 0; i < kCalls; ++i) {
+    EXPECT_EQ(&call(i), index.Find(i + 1, kServiceId, kMethodId));
+  }
+
+  EXPECT_EQ(nullptr, index.Find(kCalls + 1, kServiceId, kMethodId));
+  EXPECT_EQ(nullptr, index.Find(1, kServiceId + 1, kMethodId));
+  EXPECT_EQ(nullptr, index.Find(1, kServiceId, kMethodId + 1));
+}
+
+TEST_F(CallIndexTest, Add_Full_ReturnsFalse) {
+  // One slot is always left empty.
+  CallIndex<16> index;
+  for (size_t i = 0; i < 15; ++i) {
+    ASSERT_TRUE(index.Add(call(i)));
+  }
+  EXPECT_FALSE(index.Add(call(15)));
+  EXPECT_EQ(15u, index.size());
+
+  for (size_t i = 0; i < 15; ++i) {
+    EXPECT_EQ(&call(i), index.Find(i + 1, kServiceId, kMethodId));
+  }
+  EXPECT_EQ(nullptr, index.Find(16, kServiceId, kMethodId));
+  EXPECT_FALSE(index.Remove(call(15)));
+}
+
+TEST_F(CallIndexTest, Remove_OtherCallsStillFound) {
+  // Use a full index so that removals shift entries in long probe sequences.
+  for (size_t step : {1u, 2u, 3u, 5u}) {
+    CallIndex<16> index;
+    for (size_t i = 0; i < 15; ++i) {
+      ASSERT_TRUE(index.Add(call(i)));
+    }
+
+    std::array<bool, 15> removed = {};
+    for (size_t i = 0; i < 15; i += step) {
+      ASSERT_TRUE(index.Remove(call(i)));
+      removed[i] = true;
+
+      for (size_t j = 0; j < 15; ++j) {
+        EXPECT_EQ(removed[j] ? nullptr : &call(j),
+                  index.Find(j + 1, kServiceId, kMethodId));
+      }
+    }
+  }
+}
+
+TEST_F(CallIndexTest, Remove_NotIndexed_ReturnsFalse) {
+  CallIndex<16> index;
+  ASSERT_TRUE(index.Add(call(0)));
+
+  EXPECT_FALSE(index.Remove(call(1)));
+  EXPECT_TRUE(index.Remove(call(0)));
+  EXPECT_FALSE(index.Remove(call(0)));
+  EXPECT_EQ(0u, index.size());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace pw::rpc
@@ -158,6 +158,38 @@ TEST(ServerWriter, Open_SendsPacketWithPayload) {
           encoded, context.output().sent_data().data(), result.value().size()));
 }
 
+TEST(ServerWriter, Write_StandalonePayload_DoesNotHoldBuffer) {
+  ServerContextForTest<TestService> context(TestService::method.method());
+  FakeServerWriter writer(context.get());
+
+  constexpr byte data[] = {byte{0xf0}, byte{0x0d}};
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  EXPECT_TRUE(writer.output_buffer().empty());
+
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  EXPECT_EQ(2u, context.output().packet_count());
+}
+
+TEST(ServerWriter, Write_StandalonePayloadWithAcquiredBuffer_Sends) {
+  ServerContextForTest<TestService> context(TestService::method.method());
+  FakeServerWriter writer(context.get());
+
+  ASSERT_FALSE(writer.PayloadBuffer().empty());
+
+  constexpr byte data[] = {byte{0xf0}, byte{0x0d}};
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  EXPECT_TRUE(writer.output_buffer().empty());
+
+  byte encoded[64];
+  auto result = context.server_stream(data).Encode(encoded);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(result.value().size(), context.output().sent_data().size());
+  EXPECT_EQ(
+      0,
+      std::memcmp(
+          encoded, context.output().sent_data().data(), result.value().size()));
+}
+
 TEST(ServerWriter, Closed_IgnoresFinish) {
   ServerContextForTest<TestService> context(TestService::method.method());
   FakeServerWriter writer(context.get());
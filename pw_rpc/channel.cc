@@ -18,6 +18,7 @@
 #include "pw_rpc/internal/channel.h"
 
 #include "pw_log/log.h"
+#include "pw_rpc/internal/instrumentation.h"
 #include "pw_rpc/internal/packet.h"
 
 namespace pw::rpc::internal {
@@ -25,13 +26,21 @@ namespace pw::rpc::internal {
 using std::byte;
 
 std::span<byte> Channel::OutputBuffer::payload(const Packet& packet) const {
-  const size_t reserved_size = packet.MinEncodedSizeBytes();
-  return reserved_size <= buffer_.size() ? buffer_.subspan(reserved_size)
-                                         : std::span<byte>();
+  return packet.PayloadBuffer(buffer_);
 }
 
 Status Channel::Send(OutputBuffer& buffer, const internal::Packet& packet) {
-  Result encoded = packet.Encode(buffer.buffer_);
+  if (stream::Writer* writer = output().StartPacket(); writer != nullptr) {
+    return SendToWriter(*writer, buffer, packet);
+  }
+
+  // A payload built in the buffer's payload area is already where it belongs
+  // in the encoded packet, so it is not copied.
+  const ConstByteSpan payload = packet.payload();
+  const bool in_place =
+      !payload.empty() && payload.data() == buffer.payload(packet).data();
+  Result encoded = in_place ? packet.EncodeInPlace(buffer.buffer_)
+                            : packet.Encode(buffer.buffer_);
 
   if (!encoded.ok()) {
     PW_LOG_ERROR(
@@ -41,11 +50,32 @@ Status Channel::Send(OutputBuffer& buffer, const internal::Packet& packet) {
         encoded.status().code());
     output().DiscardBuffer(buffer.buffer_);
     buffer.buffer_ = {};
+    RecordPacketSent(id(), 0, Status::Internal());
     return Status::Internal();
   }
 
   buffer.buffer_ = {};
-  Status status = output().SendAndReleaseBuffer(encoded.value());
+  const size_t size_bytes = encoded.value().size();
+  return HandleSendStatus(output().SendAndReleaseBuffer(encoded.value()),
+                          size_bytes);
+}
+
+Status Channel::SendToWriter(stream::Writer& writer,
+                             OutputBuffer& buffer,
+                             const internal::Packet& packet) {
+  // The packet is encoded directly to the output's writer. The payload may be
+  // stored in the buffer, so it is not released until the packet is written.
+  Status status = output().FinishPacket(packet.Encode(writer));
+  Release(buffer);
+
+  // The encoded size is not known here. The reserved header size plus the
+  // payload size is within a few bytes of it.
+  return HandleSendStatus(
+      status, packet.MinEncodedSizeBytes() + packet.payload().size());
+}
+
+Status Channel::HandleSendStatus(Status status, size_t size_bytes) const {
+  RecordPacketSent(id(), size_bytes, status);
 
   if (!status.ok()) {
     PW_LOG_DEBUG("Channel %u failed to send packet with status %u",
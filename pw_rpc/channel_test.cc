@@ -14,9 +14,12 @@
 
 #include "pw_rpc/channel.h"
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_rpc/internal/test_utils.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::rpc::internal {
 namespace {
@@ -43,6 +46,9 @@ const size_t kReservedSize = 2 /* type */ + 2 /* channel */ + 5 /* service */ +
                              5 /* method */ + 2 /* payload key */ +
                              2 /* status (if not OK) */;
 
+// The payload is encoded first, after its key and length.
+constexpr size_t kPayloadOffset = 2;
+
 enum class ChannelId {
   kOne = 1,
   kTwo = 2,
@@ -85,7 +91,7 @@ TEST(Channel, OutputBuffer_ExactFit) {
   const std::span payload = output_buffer.payload(kTestPacket);
 
   EXPECT_EQ(payload.size(), output.buffer().size() - kReservedSize);
-  EXPECT_EQ(output.buffer().data() + kReservedSize, payload.data());
+  EXPECT_EQ(output.buffer().data() + kPayloadOffset, payload.data());
 
   EXPECT_EQ(OkStatus(), channel.Send(output_buffer, kTestPacket));
 }
@@ -109,11 +115,45 @@ TEST(Channel, OutputBuffer_ExtraRoom) {
   const std::span payload = output_buffer.payload(kTestPacket);
 
   EXPECT_EQ(payload.size(), output.buffer().size() - kReservedSize);
-  EXPECT_EQ(output.buffer().data() + kReservedSize, payload.data());
+  EXPECT_EQ(output.buffer().data() + kPayloadOffset, payload.data());
 
   EXPECT_EQ(OkStatus(), channel.Send(output_buffer, kTestPacket));
 }
 
+TEST(Channel, OutputBuffer_LimitedToMtu) {
+  class MtuOutput : public TestOutput<kReservedSize * 3> {
+   public:
+    size_t MaximumTransmissionUnit() override { return kReservedSize + 4; }
+  } output;
+  internal::Channel channel(100, &output);
+
+  Channel::OutputBuffer output_buffer = channel.AcquireBuffer();
+  EXPECT_EQ(4u, output_buffer.payload(kTestPacket).size());
+
+  Packet packet = kTestPacket;
+  byte data[5] = {};
+  packet.set_payload(data);
+  EXPECT_EQ(Status::Internal(), channel.Send(output_buffer, packet));
+}
+
+TEST(Channel, OutputBuffer_PayloadInPlace_SentWithoutCopy) {
+  TestOutput<64> output;
+  internal::Channel channel(100, &output);
+
+  Channel::OutputBuffer output_buffer = channel.AcquireBuffer();
+  const std::span payload = output_buffer.payload(kTestPacket).first(5);
+  std::fill(payload.begin(), payload.end(), byte{0xab});
+
+  Packet packet = kTestPacket;
+  packet.set_payload(payload);
+  ASSERT_EQ(OkStatus(), channel.Send(output_buffer, packet));
+
+  EXPECT_EQ(payload.data(), output.sent_packet().payload().data());
+  EXPECT_EQ(5u, output.sent_packet().payload().size());
+  EXPECT_EQ(byte{0xab}, output.sent_packet().payload()[4]);
+  EXPECT_EQ(Status::NotFound(), output.sent_packet().status());
+}
+
 TEST(Channel, OutputBuffer_ReturnsStatusFromChannelOutputSend) {
   TestOutput<kReservedSize * 3> output;
   internal::Channel channel(100, &output);
@@ -156,5 +196,91 @@ TEST(Channel, OutputBuffer_Contains_FalseIfOutside) {
   channel.Release(buffer);
 }
 
+// ChannelOutput that encodes packets directly to a stream::Writer.
+class StreamingOutput : public ChannelOutput {
+ public:
+  StreamingOutput() : ChannelOutput("StreamingOutput") {}
+
+  std::span<std::byte> AcquireBuffer() override {
+    buffer_acquired_ = true;
+    return payload_buffer_;
+  }
+
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) override {
+    EXPECT_TRUE(buffer.empty());  // Packets are never sent from the buffer.
+    buffer_acquired_ = false;
+    return OkStatus();
+  }
+
+  stream::Writer* StartPacket() override {
+    EXPECT_TRUE(buffer_acquired_);
+    return &writer_;
+  }
+
+  Status FinishPacket(Status write_status) override {
+    EXPECT_TRUE(buffer_acquired_);
+    write_status_ = write_status;
+    return write_status.ok() ? finish_status_ : write_status;
+  }
+
+  std::span<std::byte> payload_buffer() { return payload_buffer_; }
+  const stream::MemoryWriter& writer() const { return writer_; }
+  Status write_status() const { return write_status_; }
+  bool buffer_acquired() const { return buffer_acquired_; }
+
+  void set_finish_status(Status status) { finish_status_ = status; }
+
+ private:
+  std::array<std::byte, 16> payload_buffer_ = {};
+  stream::MemoryWriterBuffer<kReservedSize + 8> writer_;
+  Status write_status_ = Status::Unknown();
+  Status finish_status_;
+  bool buffer_acquired_ = false;
+};
+
+TEST(Channel, StreamingOutput_EncodesPacketToWriter) {
+  StreamingOutput output;
+  internal::Channel channel(100, &output);
+
+  Channel::OutputBuffer buffer = channel.AcquireBuffer();
+  std::memcpy(output.payload_buffer().data(), "hello", 5);
+  Packet packet = kTestPacket;
+  packet.set_payload(output.payload_buffer().first(5));
+
+  EXPECT_EQ(OkStatus(), channel.Send(buffer, packet));
+  EXPECT_EQ(OkStatus(), output.write_status());
+  EXPECT_FALSE(output.buffer_acquired());
+  EXPECT_TRUE(buffer.empty());
+
+  std::array<std::byte, 64> expected;
+  Result<ConstByteSpan> encoded = packet.Encode(expected);
+  ASSERT_EQ(OkStatus(), encoded.status());
+  ASSERT_EQ(encoded.value().size(), output.writer().bytes_written());
+  EXPECT_EQ(0,
+            std::memcmp(encoded.value().data(),
+                        output.writer().data(),
+                        encoded.value().size()));
+}
+
+TEST(Channel, StreamingOutput_WriteFails_ReportsWriteStatus) {
+  StreamingOutput output;
+  internal::Channel channel(100, &output);
+
+  Packet packet = kTestPacket;
+  packet.set_payload(output.payload_buffer());  // Too large for the writer.
+
+  EXPECT_EQ(Status::ResourceExhausted(), channel.Send(packet));
+  EXPECT_EQ(Status::ResourceExhausted(), output.write_status());
+  EXPECT_FALSE(output.buffer_acquired());
+}
+
+TEST(Channel, StreamingOutput_ReturnsStatusFromFinishPacket) {
+  StreamingOutput output;
+  internal::Channel channel(100, &output);
+  output.set_finish_status(Status::Aborted());
+
+  EXPECT_EQ(Status::Aborted(), channel.Send(kTestPacket));
+}
+
 }  // namespace
 }  // namespace pw::rpc::internal
@@ -19,6 +19,7 @@
 #include "pw_log/log.h"
 #include "pw_rpc/internal/client_call.h"
 #include "pw_rpc/internal/packet.h"
+#include "pw_rpc/internal/packet_batch.h"
 #include "pw_status/try.h"
 
 namespace pw::rpc {
@@ -30,6 +31,15 @@ using internal::PacketType;
 }  // namespace
 
 Status Client::ProcessPacket(ConstByteSpan data) {
+  if (internal::IsPacketBatch(data)) {
+    return internal::ForEachPacketInBatch(data, [this](ConstByteSpan packet) {
+      return ProcessSinglePacket(packet);
+    });
+  }
+  return ProcessSinglePacket(data);
+}
+
+Status Client::ProcessSinglePacket(ConstByteSpan data) {
   PW_TRY_ASSIGN(Result<Packet> result,
                 Endpoint::ProcessPacket(data, Packet::kClient));
   Packet& packet = *result;
@@ -76,7 +86,20 @@ Status Client::ProcessPacket(ConstByteSpan data) {
       break;
     case PacketType::SERVER_STREAM:
       if (call->has_server_stream()) {
+        const uint32_t credits = call->ConsumeStreamCredit();
         call->HandlePayload(packet.payload());
+
+        // Credits are granted after the payload is handled, so the server
+        // cannot get ahead of a slow callback.
+        if (credits != 0u) {
+          Packet grant(PacketType::CLIENT_CREDIT,
+                       packet.channel_id(),
+                       packet.service_id(),
+                       packet.method_id(),
+                       packet.call_id());
+          grant.set_credits(credits);
+          channel->Send(grant).IgnoreError();  // Errors are logged in Send.
+        }
       } else {
         PW_LOG_DEBUG("Received SERVER_STREAM for RPC without a server stream");
         call->HandleError(Status::InvalidArgument());
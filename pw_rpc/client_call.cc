@@ -14,14 +14,46 @@
 
 #include "pw_rpc/internal/client_call.h"
 
+#include "pw_rpc/client.h"
+
 namespace pw::rpc::internal {
 
 void ClientCall::SendInitialRequestLocked(ConstByteSpan payload) {
-  if (const Status status = SendPacket(PacketType::REQUEST, payload);
-      !status.ok()) {
+  Packet request = MakePacket(PacketType::REQUEST, payload);
+  const Client& client = static_cast<const Client&>(endpoint());
+  request.set_timeout_ms(client.request_timeout_ms());
+
+  if (has_server_stream() && client.stream_credits() != 0u) {
+    request.set_credits(client.stream_credits());
+    set_credits(client.stream_credits());
+  }
+
+  if (const Status status = SendPacket(request); !status.ok()) {
     rpc_lock().lock();
     HandleError(status);
   }
 }
 
+uint32_t ClientCall::ConsumeStreamCredit() {
+  const uint32_t available = credits();
+  if (available == kUnlimitedCredits) {
+    return 0;
+  }
+
+  // A server that ignores flow control may send more packets than granted.
+  const uint32_t remaining = available == 0u ? 0 : available - 1;
+
+  // Top the server's credits back up once half of them have been used, to
+  // avoid both stalling the stream and sending a CLIENT_CREDIT per packet.
+  const uint32_t window =
+      static_cast<const Client&>(endpoint()).stream_credits();
+  if (remaining > window / 2) {
+    set_credits(remaining);
+    return 0;
+  }
+
+  set_credits(window);
+  return window - remaining;
+}
+
 }  // namespace pw::rpc::internal
@@ -14,10 +14,24 @@
 
 #include "pw_rpc/client_server.h"
 
+#include "pw_rpc/internal/packet_batch.h"
+
 namespace pw::rpc {
 
 Status ClientServer::ProcessPacket(std::span<const std::byte> packet,
                                    ChannelOutput& interface) {
+  // Batches may contain packets for both the client and the server.
+  if (internal::IsPacketBatch(packet)) {
+    return internal::ForEachPacketInBatch(
+        packet, [this, &interface](ConstByteSpan single_packet) {
+          return ProcessSinglePacket(single_packet, interface);
+        });
+  }
+  return ProcessSinglePacket(packet, interface);
+}
+
+Status ClientServer::ProcessSinglePacket(std::span<const std::byte> packet,
+                                         ChannelOutput& interface) {
   Status status = server_.ProcessPacket(packet, interface);
   if (status.IsInvalidArgument()) {
     // INVALID_ARGUMENT indicates the packet is intended for a client.
@@ -14,6 +14,8 @@
 
 #include "pw_rpc/client_server.h"
 
+#include <array>
+
 #include "gtest/gtest.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_rpc/internal/test_utils.h"
@@ -76,6 +78,31 @@ TEST(ClientServer, ProcessPacket_CallsClient) {
   EXPECT_EQ(client_server.ProcessPacket(result.value(), output), OkStatus());
 }
 
+TEST(ClientServer, ProcessPacket_Batch_CallsClientAndServer) {
+  ClientServer client_server(channels);
+  client_server.server().RegisterService(service);
+
+  std::array<std::byte, 32> request;
+  std::array<std::byte, 32> response;
+  std::array<std::byte, 80> buffer;
+  RpcPacketBatch::MemoryEncoder batch(buffer);
+  ASSERT_EQ(OkStatus(),
+            batch.WritePackets(*Packet(PacketType::REQUEST,
+                                       kFakeChannelId,
+                                       kFakeServiceId,
+                                       kFakeMethodId)
+                                    .Encode(request)));
+  ASSERT_EQ(OkStatus(),
+            batch.WritePackets(*Packet(PacketType::RESPONSE,
+                                       kFakeChannelId,
+                                       kFakeServiceId,
+                                       kFakeMethodId)
+                                    .Encode(response)));
+
+  EXPECT_EQ(client_server.ProcessPacket(ConstByteSpan(batch), output),
+            OkStatus());
+}
+
 TEST(ClientServer, ProcessPacket_BadData) {
   ClientServer client_server(channels);
   EXPECT_EQ(client_server.ProcessPacket({}, output), Status::DataLoss());
@@ -18,6 +18,7 @@
 
 #include "pw_log/log.h"
 #include "pw_rpc/internal/lock.h"
+#include "pw_rpc/lock_metrics.h"
 
 namespace pw::rpc::internal {
 
@@ -72,6 +73,16 @@ void Endpoint::RegisterCall(Call& call) {
   RegisterUniqueCall(call);
 }
 
+uint32_t Endpoint::CountCallsToService(uint32_t service_id) const {
+  uint32_t count = 0;
+  for (const Call& call : calls_) {
+    if (call.service_id() == service_id) {
+      count += 1;
+    }
+  }
+  return count;
+}
+
 Channel* Endpoint::GetInternalChannel(uint32_t id) const {
   for (Channel& c : channels_) {
     if (c.id() == id) {
@@ -95,6 +106,11 @@ Channel* Endpoint::AssignChannel(uint32_t id, ChannelOutput& interface) {
 Call* Endpoint::FindCallById(uint32_t channel_id,
                              uint32_t service_id,
                              uint32_t method_id) {
+  if (Call* call = call_index_.Find(channel_id, service_id, method_id);
+      call != nullptr || unindexed_calls_ == 0u) {
+    return call;
+  }
+
   for (Call& call : calls_) {
     if (channel_id == call.channel_id() && service_id == call.service_id() &&
         method_id == call.method_id()) {
@@ -105,3 +121,13 @@ Call* Endpoint::FindCallById(uint32_t channel_id,
 }
 
 }  // namespace pw::rpc::internal
+
+#if PW_RPC_USE_GLOBAL_MUTEX
+
+namespace pw::rpc {
+
+metric::Group& LockMetrics() { return internal::rpc_lock().metrics(); }
+
+}  // namespace pw::rpc
+
+#endif  // PW_RPC_USE_GLOBAL_MUTEX
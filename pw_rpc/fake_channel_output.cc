@@ -81,6 +81,7 @@ Status FakeChannelOutput::SendAndReleaseBuffer(
     case PacketType::DEPRECATED_CANCEL:
     case PacketType::SERVER_STREAM:
     case PacketType::CLIENT_STREAM_END:
+    case PacketType::CLIENT_CREDIT:
       return OkStatus();
   }
   PW_CRASH("Unhandled PacketType %d", static_cast<int>(result.value().type()));
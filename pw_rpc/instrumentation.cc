@@ -0,0 +1,276 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_TRACE_MODULE_NAME "pw_rpc"
+
+#include "pw_rpc/internal/instrumentation.h"
+
+#if PW_RPC_INSTRUMENTATION
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
+
+#include "pw_containers/vector.h"
+#include "pw_metric/compound_metrics.h"  // nogncheck
+#include "pw_rpc/instrumentation.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_tokenizer/tokenize.h"
+
+#if PW_RPC_USE_GLOBAL_MUTEX
+#include "pw_sync/mutex.h"  // nogncheck
+#endif  // PW_RPC_USE_GLOBAL_MUTEX
+
+#endif  // PW_RPC_INSTRUMENTATION
+
+#if PW_RPC_TRACE_CALLS
+#include "pw_trace/trace.h"  // nogncheck
+#endif  // PW_RPC_TRACE_CALLS
+
+namespace pw::rpc::internal {
+
+#if PW_RPC_INSTRUMENTATION
+
+namespace {
+
+#define _PW_RPC_METRIC_NAME(name) \
+  PW_TOKENIZE_STRING_MASK("metrics", _PW_METRIC_TOKEN_MASK, name)
+
+constexpr metric::Token kServiceIdName =
+    _PW_RPC_METRIC_NAME("service_id");
+constexpr metric::Token kRequestsName =
+    _PW_RPC_METRIC_NAME("requests");
+constexpr metric::Token kHandlerTimeUsName =
+    _PW_RPC_METRIC_NAME("handler_time_us");
+constexpr metric::Token kPacketsReceivedName =
+    _PW_RPC_METRIC_NAME("packets_received");
+constexpr metric::Token kBytesReceivedName =
+    _PW_RPC_METRIC_NAME("bytes_received");
+constexpr metric::Token kPacketsSentName =
+    _PW_RPC_METRIC_NAME("packets_sent");
+constexpr metric::Token kBytesSentName =
+    _PW_RPC_METRIC_NAME("bytes_sent");
+constexpr metric::Token kSendErrorsName =
+    _PW_RPC_METRIC_NAME("send_errors");
+
+#undef _PW_RPC_METRIC_NAME
+
+constexpr metric::Token kPwRpcGroup =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "pw_rpc");
+constexpr metric::Token kMethodsGroup =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "methods");
+constexpr metric::Token kChannelsGroup =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "channels");
+
+// Handler times are recorded in microseconds, so 24 buckets cover handlers of
+// up to about 8 seconds.
+constexpr size_t kHandlerTimeBuckets = 24;
+
+// The metrics are updated without the RPC lock held, since channels send
+// packets after releasing it, so they have a leaf lock of their own.
+#if PW_RPC_USE_GLOBAL_MUTEX
+
+using InstrumentationLock = sync::Mutex;
+
+#else
+
+class InstrumentationLock {
+ public:
+  constexpr void lock() {}
+  constexpr void unlock() {}
+};
+
+#endif  // PW_RPC_USE_GLOBAL_MUTEX
+
+class MethodMetrics {
+ public:
+  MethodMetrics(uint32_t service_id, uint32_t method_id, metric::Group& parent)
+      : group_(method_id, parent.children()),
+        service_id_(kServiceIdName, service_id, group_.metrics()),
+        requests_(kRequestsName, 0u, group_.metrics()),
+        handler_time_us_(kHandlerTimeUsName, group_) {}
+
+  bool Is(uint32_t service_id, uint32_t method_id) const {
+    return group_.name() == method_id && service_id_.value() == service_id;
+  }
+
+  void RecordHandler(uint32_t duration_us) {
+    requests_.Increment();
+    handler_time_us_.Record(duration_us);
+  }
+
+ private:
+  metric::Group group_;
+  metric::TypedMetric<uint32_t> service_id_;
+  metric::TypedMetric<uint32_t> requests_;
+  metric::Log2Histogram<kHandlerTimeBuckets> handler_time_us_;
+};
+
+class ChannelMetrics {
+ public:
+  ChannelMetrics(uint32_t channel_id, metric::Group& parent)
+      : group_(channel_id, parent.children()),
+        packets_received_(kPacketsReceivedName, 0u, group_.metrics()),
+        bytes_received_(kBytesReceivedName, 0u, group_.metrics()),
+        packets_sent_(kPacketsSentName, 0u, group_.metrics()),
+        bytes_sent_(kBytesSentName, 0u, group_.metrics()),
+        send_errors_(kSendErrorsName, 0u, group_.metrics()) {}
+
+  uint32_t id() const { return group_.name(); }
+
+  void RecordReceived(size_t size_bytes) {
+    packets_received_.Increment();
+    bytes_received_.Increment(static_cast<uint32_t>(size_bytes));
+  }
+
+  void RecordSent(size_t size_bytes, Status status) {
+    if (!status.ok()) {
+      send_errors_.Increment();
+      return;
+    }
+    packets_sent_.Increment();
+    bytes_sent_.Increment(static_cast<uint32_t>(size_bytes));
+  }
+
+ private:
+  metric::Group group_;
+  metric::TypedMetric<uint32_t> packets_received_;
+  metric::TypedMetric<uint32_t> bytes_received_;
+  metric::TypedMetric<uint32_t> packets_sent_;
+  metric::TypedMetric<uint32_t> bytes_sent_;
+  metric::TypedMetric<uint32_t> send_errors_;
+};
+
+class Instrumentation {
+ public:
+  Instrumentation()
+      : group_(kPwRpcGroup),
+        methods_group_(kMethodsGroup, group_.children()),
+        channels_group_(kChannelsGroup, group_.children()) {}
+
+  metric::Group& metrics() { return group_; }
+
+  // Returns the metrics for a method, or nullptr if no more methods can be
+  // tracked.
+  MethodMetrics* Method(uint32_t service_id, uint32_t method_id)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    for (MethodMetrics& method : methods_) {
+      if (method.Is(service_id, method_id)) {
+        return &method;
+      }
+    }
+    if (methods_.full()) {
+      return nullptr;
+    }
+    methods_.emplace_back(service_id, method_id, methods_group_);
+    return &methods_.back();
+  }
+
+  // Returns the metrics for a channel, or nullptr if no more channels can be
+  // tracked.
+  ChannelMetrics* Channel(uint32_t channel_id)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    for (ChannelMetrics& channel : channels_) {
+      if (channel.id() == channel_id) {
+        return &channel;
+      }
+    }
+    if (channels_.full()) {
+      return nullptr;
+    }
+    channels_.emplace_back(channel_id, channels_group_);
+    return &channels_.back();
+  }
+
+  InstrumentationLock& lock() PW_LOCK_RETURNED(lock_) { return lock_; }
+
+ private:
+  InstrumentationLock lock_;
+
+  metric::Group group_;
+  metric::Group methods_group_;
+  metric::Group channels_group_;
+
+  Vector<MethodMetrics, cfg::kInstrumentationMaxMethods> methods_
+      PW_GUARDED_BY(lock_);
+  Vector<ChannelMetrics, cfg::kInstrumentationMaxChannels> channels_
+      PW_GUARDED_BY(lock_);
+};
+
+Instrumentation& instrumentation() {
+  static Instrumentation instrumentation;
+  return instrumentation;
+}
+
+}  // namespace
+
+void RecordPacketReceived(uint32_t channel_id, size_t size_bytes) {
+  Instrumentation& instr = instrumentation();
+  std::lock_guard lock(instr.lock());
+  if (ChannelMetrics* channel = instr.Channel(channel_id); channel != nullptr) {
+    channel->RecordReceived(size_bytes);
+  }
+}
+
+void RecordPacketSent(uint32_t channel_id, size_t size_bytes, Status status) {
+  Instrumentation& instr = instrumentation();
+  std::lock_guard lock(instr.lock());
+  if (ChannelMetrics* channel = instr.Channel(channel_id); channel != nullptr) {
+    channel->RecordSent(size_bytes, status);
+  }
+}
+
+HandlerTimer::~HandlerTimer() {
+  const int64_t duration_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          chrono::SystemClock::now() - start_)
+          .count();
+
+  Instrumentation& instr = instrumentation();
+  std::lock_guard lock(instr.lock());
+  if (MethodMetrics* method = instr.Method(service_id_, method_id_);
+      method != nullptr) {
+    method->RecordHandler(static_cast<uint32_t>(std::min<int64_t>(
+        duration_us, std::numeric_limits<uint32_t>::max())));
+  }
+}
+
+#endif  // PW_RPC_INSTRUMENTATION
+
+#if PW_RPC_TRACE_CALLS
+
+void TraceCallStart([[maybe_unused]] uint32_t method_id) {
+  PW_TRACE_START("RpcCall", "pw_rpc", method_id);
+}
+
+void TraceCallEnd([[maybe_unused]] uint32_t method_id) {
+  PW_TRACE_END("RpcCall", "pw_rpc", method_id);
+}
+
+#endif  // PW_RPC_TRACE_CALLS
+
+}  // namespace pw::rpc::internal
+
+#if PW_RPC_INSTRUMENTATION
+
+namespace pw::rpc {
+
+metric::Group& InstrumentationMetrics() {
+  return internal::instrumentation().metrics();
+}
+
+}  // namespace pw::rpc
+
+#endif  // PW_RPC_INSTRUMENTATION
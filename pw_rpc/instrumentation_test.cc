@@ -0,0 +1,174 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/instrumentation.h"
+
+#include "gtest/gtest.h"
+#include "pw_rpc/internal/config.h"
+
+// The instrumentation is only built if PW_RPC_INSTRUMENTATION is enabled.
+#if PW_RPC_INSTRUMENTATION
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/internal/test_method.h"
+#include "pw_rpc/internal/test_utils.h"
+#include "pw_rpc/server.h"
+#include "pw_rpc/service.h"
+#include "pw_tokenizer/hash.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::Packet;
+using internal::PacketType;
+using internal::TestMethod;
+using internal::TestMethodUnion;
+
+constexpr uint32_t kServiceId = 42;
+constexpr uint32_t kMethodId = 100;
+constexpr uint32_t kChannelId = 7;
+
+class TestService : public Service {
+ public:
+  constexpr TestService() : Service(kServiceId, method_) {}
+
+ private:
+  static constexpr TestMethodUnion method_ = TestMethod(kMethodId);
+};
+
+const metric::Group* FindGroup(const metric::Group& parent,
+                               metric::Token name) {
+  for (const metric::Group& group : parent.children()) {
+    if (group.name() == name) {
+      return &group;
+    }
+  }
+  return nullptr;
+}
+
+// Returns the value of a metric in a group of the instrumentation metrics, or
+// 0 if the group or metric has not been created yet.
+uint32_t MetricValue(metric::Token category,
+                     uint32_t group_name,
+                     std::string_view metric_name) {
+  const metric::Group* category_group =
+      FindGroup(InstrumentationMetrics(), category);
+  if (category_group == nullptr) {
+    return 0;
+  }
+  const metric::Group* group = FindGroup(*category_group, group_name);
+  if (group == nullptr) {
+    return 0;
+  }
+
+  // Metric names are masked to leave room for the metric's type.
+  const metric::Token token = tokenizer::Hash(metric_name) & 0x7fffffff;
+  for (const metric::Metric& metric : group->metrics()) {
+    if (metric.name() == token) {
+      return metric.as_int();
+    }
+  }
+  return 0;
+}
+
+uint32_t MethodMetric(const char* name) {
+  return MetricValue(tokenizer::Hash("methods"), kMethodId, name);
+}
+
+uint32_t ChannelMetric(const char* name) {
+  return MetricValue(tokenizer::Hash("channels"), kChannelId, name);
+}
+
+class Instrumentation : public ::testing::Test {
+ protected:
+  static constexpr std::byte kPayload[] = {std::byte{1}, std::byte{2}};
+
+  Instrumentation()
+      : channels_{Channel::Create<kChannelId>(&output_)}, server_(channels_) {
+    server_.RegisterService(service_);
+  }
+
+  ConstByteSpan EncodeRequest(uint32_t method_id) {
+    Result<ConstByteSpan> result = Packet(PacketType::REQUEST,
+                                          kChannelId,
+                                          kServiceId,
+                                          method_id,
+                                          0,
+                                          kPayload,
+                                          OkStatus())
+                                       .Encode(buffer_);
+    EXPECT_EQ(OkStatus(), result.status());
+    return result.value_or(ConstByteSpan());
+  }
+
+  internal::TestOutput<128> output_;
+  std::array<Channel, 1> channels_;
+  Server server_;
+  TestService service_;
+
+ private:
+  std::array<std::byte, 64> buffer_;
+};
+
+TEST_F(Instrumentation, Request_CountsRequestAndHandlerTime) {
+  const uint32_t requests = MethodMetric("requests");
+
+  ASSERT_EQ(OkStatus(),
+            server_.ProcessPacket(EncodeRequest(kMethodId), output_));
+
+  EXPECT_EQ(requests + 1, MethodMetric("requests"));
+  EXPECT_EQ(kServiceId, MethodMetric("service_id"));
+}
+
+TEST_F(Instrumentation, ProcessPacket_CountsBytesReceived) {
+  const uint32_t packets = ChannelMetric("packets_received");
+  const uint32_t bytes = ChannelMetric("bytes_received");
+
+  const ConstByteSpan request = EncodeRequest(kMethodId);
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(request, output_));
+
+  EXPECT_EQ(packets + 1, ChannelMetric("packets_received"));
+  EXPECT_EQ(bytes + request.size(), ChannelMetric("bytes_received"));
+}
+
+TEST_F(Instrumentation, Send_CountsBytesSent) {
+  const uint32_t packets = ChannelMetric("packets_sent");
+  const uint32_t bytes = ChannelMetric("bytes_sent");
+
+  // A request for an unknown method is answered with an error packet.
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeRequest(999), output_));
+
+  EXPECT_EQ(packets + 1, ChannelMetric("packets_sent"));
+  EXPECT_LT(bytes, ChannelMetric("bytes_sent"));
+}
+
+TEST_F(Instrumentation, SendFailure_CountsSendError) {
+  const uint32_t errors = ChannelMetric("send_errors");
+  const uint32_t packets = ChannelMetric("packets_sent");
+
+  output_.set_send_status(Status::Unavailable());
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeRequest(999), output_));
+
+  EXPECT_EQ(errors + 1, ChannelMetric("send_errors"));
+  EXPECT_EQ(packets, ChannelMetric("packets_sent"));
+}
+
+}  // namespace
+}  // namespace pw::rpc
+
+#endif  // PW_RPC_INSTRUMENTATION
@@ -0,0 +1,77 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/benchmark_service_nanopb.h"
+
+#include "gtest/gtest.h"
+#include "pw_rpc/nanopb/test_method_context.h"
+
+namespace pw::rpc {
+namespace {
+
+TEST(NanopbBenchmarkService, UnaryEcho_EchoesRequest) {
+  PW_NANOPB_TEST_METHOD_CONTEXT(NanopbBenchmarkService, UnaryEcho) context;
+  pw_rpc_Payload request = {};
+  request.payload.size = 2;
+  request.payload.bytes[0] = 0x12;
+  request.payload.bytes[1] = 0x34;
+
+  ASSERT_EQ(OkStatus(), context.call(request));
+  ASSERT_EQ(2u, context.response().payload.size);
+  EXPECT_EQ(0x12, context.response().payload.bytes[0]);
+  EXPECT_EQ(0x34, context.response().payload.bytes[1]);
+}
+
+TEST(NanopbBenchmarkService, ServerStream_SendsRequestedPayloads) {
+  PW_NANOPB_TEST_METHOD_CONTEXT(NanopbBenchmarkService, ServerStream) context;
+
+  context.call({.payload_size = 8, .count = 3});
+
+  ASSERT_TRUE(context.done());
+  EXPECT_EQ(OkStatus(), context.status());
+  ASSERT_EQ(3u, context.responses().size());
+  EXPECT_EQ(8u, context.responses()[2].payload.size);
+  EXPECT_EQ(2 + 7, context.responses()[2].payload.bytes[7]);
+}
+
+TEST(NanopbBenchmarkService, ServerStream_PayloadTooLarge_ResourceExhausted) {
+  PW_NANOPB_TEST_METHOD_CONTEXT(NanopbBenchmarkService, ServerStream) context;
+
+  context.call({.payload_size = 65, .count = 1});
+
+  ASSERT_TRUE(context.done());
+  EXPECT_EQ(Status::ResourceExhausted(), context.status());
+}
+
+TEST(NanopbBenchmarkService, ClientStream_EmptyPayload_RespondsWithTotals) {
+  PW_NANOPB_TEST_METHOD_CONTEXT(NanopbBenchmarkService, ClientStream) context;
+  context.call();
+
+  pw_rpc_Payload request = {};
+  request.payload.size = 5;
+  context.SendClientStream(request);
+  request.payload.size = 7;
+  context.SendClientStream(request);
+  EXPECT_FALSE(context.done());
+
+  context.SendClientStream(pw_rpc_Payload{});
+
+  ASSERT_TRUE(context.done());
+  EXPECT_EQ(OkStatus(), context.status());
+  EXPECT_EQ(2u, context.response().payload_count);
+  EXPECT_EQ(12u, context.response().payload_bytes);
+}
+
+}  // namespace
+}  // namespace pw::rpc
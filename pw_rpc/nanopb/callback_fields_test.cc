@@ -0,0 +1,124 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/nanopb/callback_fields.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_rpc/nanopb/internal/common.h"
+#include "pw_rpc_test_protos/test.pb.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::NanopbSerde;
+
+constexpr NanopbSerde kSerde(pw_rpc_test_TestLargeRequest_fields);
+
+constexpr char kName[] = "upload";
+
+class NanopbCallbackFieldsTest : public ::testing::Test {
+ protected:
+  NanopbCallbackFieldsTest() : data_{}, buffer_{} {
+    for (size_t i = 0; i < data_.size(); ++i) {
+      data_[i] = std::byte(i);
+    }
+  }
+
+  // Encodes a TestLargeRequest with data_ and kName to buffer_.
+  ConstByteSpan Encode() {
+    const ConstByteSpan data(data_);
+    const ConstByteSpan name = std::as_bytes(std::span(kName, 6));
+
+    pw_rpc_test_TestLargeRequest request{};
+    SetNanopbBytesField(request.data, data);
+    SetNanopbBytesField(request.name, name);
+    request.number = 123;
+
+    StatusWithSize result = kSerde.Encode(&request, buffer_);
+    EXPECT_EQ(OkStatus(), result.status());
+    return std::span(buffer_).first(result.size());
+  }
+
+  std::array<std::byte, 300> data_;
+  std::array<std::byte, 512> buffer_;
+};
+
+TEST_F(NanopbCallbackFieldsTest, Decode_SpansPointIntoBuffer) {
+  const ConstByteSpan encoded = Encode();
+
+  pw_rpc_test_TestLargeRequest request{};
+  ASSERT_TRUE(kSerde.Decode(encoded, &request));
+
+  const ConstByteSpan data = GetNanopbBytesField(request.data);
+  ASSERT_EQ(data.size(), data_.size());
+  EXPECT_EQ(0, std::memcmp(data.data(), data_.data(), data.size()));
+  EXPECT_GE(data.data(), encoded.data());
+  EXPECT_LE(data.data() + data.size(), encoded.data() + encoded.size());
+
+  EXPECT_EQ(GetNanopbStringField(request.name), kName);
+  EXPECT_EQ(request.number, 123u);
+}
+
+TEST_F(NanopbCallbackFieldsTest, Decode_MissingFieldsAreEmpty) {
+  constexpr std::array<std::byte, 2> kOnlyNumber = {std::byte{0x18},
+                                                    std::byte{0x05}};
+
+  pw_rpc_test_TestLargeRequest request{};
+  ASSERT_TRUE(kSerde.Decode(kOnlyNumber, &request));
+
+  EXPECT_TRUE(GetNanopbBytesField(request.data).empty());
+  EXPECT_TRUE(GetNanopbStringField(request.name).empty());
+  EXPECT_EQ(request.number, 5u);
+}
+
+TEST_F(NanopbCallbackFieldsTest, Decode_ReusedStructClearsPreviousSpans) {
+  const ConstByteSpan encoded = Encode();
+
+  pw_rpc_test_TestLargeRequest request{};
+  ASSERT_TRUE(kSerde.Decode(encoded, &request));
+  ASSERT_FALSE(GetNanopbBytesField(request.data).empty());
+
+  ASSERT_TRUE(kSerde.Decode(ConstByteSpan(), &request));
+  EXPECT_TRUE(GetNanopbBytesField(request.data).empty());
+}
+
+TEST_F(NanopbCallbackFieldsTest, Decode_TruncatedField_Fails) {
+  const ConstByteSpan encoded = Encode();
+
+  pw_rpc_test_TestLargeRequest request{};
+  EXPECT_FALSE(kSerde.Decode(encoded.first(10), &request));
+}
+
+TEST(NanopbCallbackFields, UnsetField_IsEmpty) {
+  pw_rpc_test_TestLargeRequest request{};
+  EXPECT_TRUE(GetNanopbBytesField(request.data).empty());
+}
+
+TEST(NanopbCallbackFields, Set_ReturnsSetSpan) {
+  constexpr std::array<std::byte, 3> kData = {
+      std::byte{1}, std::byte{2}, std::byte{3}};
+  const ConstByteSpan data(kData);
+
+  pw_rpc_test_TestLargeRequest request{};
+  SetNanopbBytesField(request.data, data);
+
+  EXPECT_EQ(GetNanopbBytesField(request.data).data(), kData.data());
+  EXPECT_EQ(GetNanopbBytesField(request.data).size(), kData.size());
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -20,8 +20,10 @@
 #include "pw_log/log.h"
 #include "pw_result/result.h"
 #include "pw_rpc/internal/client_call.h"
+#include "pw_rpc/nanopb/callback_fields.h"
 #include "pw_rpc/nanopb/server_reader_writer.h"
 #include "pw_status/try.h"
+#include "pw_varint/varint.h"
 
 namespace pw::rpc::internal {
 namespace {
@@ -52,8 +54,82 @@ Result<ByteSpan> EncodeToPayloadBuffer(Call& call,
   return payload_buffer.first(result.size());
 }
 
+// Decode callback for bytes and string callback fields. Rather than copying
+// the value, stores a pointer to the field's length prefix in the packet in the
+// callback's arg. The span is reconstructed from the prefix when it is read.
+//
+// This relies on the stream being created with pb_istream_from_buffer, which
+// is always the case in NanopbSerde::Decode. The substream for a field's value
+// then points to the value in the original buffer.
+bool RecordFieldLocation(pb_istream_t* stream, const pb_field_t*, void** arg) {
+  const size_t size = stream->bytes_left;
+  const pb_byte_t* value = static_cast<const pb_byte_t*>(stream->state);
+
+  *arg = const_cast<pb_byte_t*>(value - varint::EncodedSize(size));
+  return pb_read(stream, nullptr, size);  // Skip the value.
+}
+
+bool EncodeSpan(pb_ostream_t* stream,
+                const pb_field_t* field,
+                void* const* arg) {
+  const ConstByteSpan& value = *static_cast<const ConstByteSpan*>(*arg);
+  return pb_encode_tag_for_field(stream, field) &&
+         pb_encode_string(stream,
+                          reinterpret_cast<const pb_byte_t*>(value.data()),
+                          value.size());
+}
+
+// Sets the decode callback for callback bytes and string fields. Fields in
+// nested messages are not set up.
+void SetUpCallbackFields(Fields fields, void* proto_struct) {
+  pb_field_iter_t field;
+  if (!pb_field_iter_begin(&field, fields, proto_struct)) {
+    return;  // The message has no fields.
+  }
+
+  do {
+    if (PB_ATYPE(field.type) != PB_ATYPE_CALLBACK ||
+        field.data_size != sizeof(pb_callback_t) ||
+        (PB_LTYPE(field.type) != PB_LTYPE_BYTES &&
+         PB_LTYPE(field.type) != PB_LTYPE_STRING)) {
+      continue;
+    }
+
+    // Replace spans from a previous decode or for encoding, but keep callbacks
+    // set by the user.
+    pb_callback_t& callback = *static_cast<pb_callback_t*>(field.pData);
+    if (callback.funcs.decode == nullptr ||
+        callback.funcs.decode == RecordFieldLocation ||
+        callback.funcs.encode == EncodeSpan) {
+      callback.funcs.decode = RecordFieldLocation;
+      callback.arg = nullptr;
+    }
+  } while (pb_field_iter_next(&field));
+}
+
 }  // namespace
 
+ConstByteSpan GetNanopbBytesField(const pb_callback_t& field) {
+  if (field.funcs.encode == EncodeSpan) {
+    return *static_cast<const ConstByteSpan*>(field.arg);
+  }
+  if (field.funcs.decode != RecordFieldLocation || field.arg == nullptr) {
+    return ConstByteSpan();
+  }
+
+  // The length prefix was validated when the message was decoded.
+  const std::byte* prefix = static_cast<const std::byte*>(field.arg);
+  uint64_t size;
+  const size_t prefix_size = varint::Decode(
+      std::span(prefix, varint::kMaxVarint64SizeBytes), &size);
+  return ConstByteSpan(prefix + prefix_size, static_cast<size_t>(size));
+}
+
+void SetNanopbBytesField(pb_callback_t& field, const ConstByteSpan& value) {
+  field.funcs.encode = EncodeSpan;
+  field.arg = const_cast<ConstByteSpan*>(&value);
+}
+
 // PB_NO_ERRMSG is used in pb_decode.h and pb_encode.h to enable or disable the
 // errmsg member of the istream and ostream structs. If errmsg is available, use
 // it to give more detailed log messages.
@@ -80,6 +156,8 @@ StatusWithSize NanopbSerde::Encode(const void* proto_struct,
 }
 
 bool NanopbSerde::Decode(ConstByteSpan buffer, void* proto_struct) const {
+  SetUpCallbackFields(static_cast<Fields>(fields_), proto_struct);
+
   auto input = pb_istream_from_buffer(
       reinterpret_cast<const pb_byte_t*>(buffer.data()), buffer.size());
   bool result = pb_decode(&input, static_cast<Fields>(fields_), proto_struct);
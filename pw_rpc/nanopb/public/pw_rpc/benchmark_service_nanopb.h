@@ -0,0 +1,99 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "pw_rpc/benchmark.rpc.pb.h"
+
+namespace pw::rpc {
+
+// Nanopb implementation of the pw.rpc.Benchmark service, for measuring the
+// Nanopb method path. It behaves like the raw BenchmarkService, except that
+// payloads are limited to the size set in benchmark.options.
+class NanopbBenchmarkService final
+    : public pw_rpc::nanopb::Benchmark::Service<NanopbBenchmarkService> {
+ public:
+  static Status UnaryEcho(ServerContext&,
+                          const pw_rpc_Payload& request,
+                          pw_rpc_Payload& response) {
+    response = request;
+    return OkStatus();
+  }
+
+  void BidirectionalEcho(
+      ServerContext&,
+      ServerReaderWriter<pw_rpc_Payload, pw_rpc_Payload>& new_reader_writer) {
+    reader_writer_ = std::move(new_reader_writer);
+
+    reader_writer_.set_on_next([this](const pw_rpc_Payload& request) {
+      if (Status status = reader_writer_.Write(request); !status.ok()) {
+        reader_writer_.Finish(status).IgnoreError();
+      }
+    });
+  }
+
+  static void ServerStream(ServerContext&,
+                           const pw_rpc_StreamRequest& request,
+                           ServerWriter<pw_rpc_Payload>& writer) {
+    pw_rpc_Payload response = {};
+    if (request.payload_size > sizeof(response.payload.bytes)) {
+      writer.Finish(Status::ResourceExhausted()).IgnoreError();
+      return;
+    }
+    response.payload.size = request.payload_size;
+
+    for (uint32_t i = 0; i < request.count; ++i) {
+      for (uint32_t j = 0; j < request.payload_size; ++j) {
+        response.payload.bytes[j] = static_cast<pb_byte_t>(i + j);
+      }
+      if (Status status = writer.Write(response); !status.ok()) {
+        writer.Finish(status).IgnoreError();
+        return;
+      }
+    }
+
+    writer.Finish().IgnoreError();
+  }
+
+  void ClientStream(
+      ServerContext&,
+      ServerReader<pw_rpc_Payload, pw_rpc_StreamStats>& new_reader) {
+    reader_ = std::move(new_reader);
+    stats_ = {};
+
+    reader_.set_on_next([this](const pw_rpc_Payload& request) {
+      if (request.payload.size == 0u) {
+        reader_.Finish(stats_).IgnoreError();
+        return;
+      }
+      stats_.payload_count += 1;
+      stats_.payload_bytes += request.payload.size;
+    });
+
+#if PW_RPC_CLIENT_STREAM_END_CALLBACK
+    reader_.set_on_client_stream_end(
+        [this]() { reader_.Finish(stats_).IgnoreError(); });
+#endif  // PW_RPC_CLIENT_STREAM_END_CALLBACK
+  }
+
+ private:
+  ServerReaderWriter<pw_rpc_Payload, pw_rpc_Payload> reader_writer_;
+
+  ServerReader<pw_rpc_Payload, pw_rpc_StreamStats> reader_;
+  pw_rpc_StreamStats stats_ = {};
+};
+
+}  // namespace pw::rpc
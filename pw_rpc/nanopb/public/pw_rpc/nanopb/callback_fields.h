@@ -0,0 +1,62 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Functions for reading and writing Nanopb callback (FT_CALLBACK) bytes and
+// string fields without copying them.
+//
+// When pw_rpc decodes a request or response, it records where the value of
+// each top-level callback bytes or string field is in the packet. Declaring
+// large fields as callbacks in the .options file keeps them out of the struct:
+//
+//   pw.example.UploadRequest.data type:FT_CALLBACK
+//
+// The RPC then reads the field as a span that points into the packet:
+//
+//   Status Upload(const pw_example_UploadRequest& request,
+//                 pw_example_UploadResponse& response) {
+//     ConstByteSpan data = GetNanopbBytesField(request.data);
+//     ...
+//   }
+//
+#pragma once
+
+#include <string_view>
+
+#include "pb.h"
+#include "pw_bytes/span.h"
+
+namespace pw::rpc {
+
+// Returns the value of a callback bytes field in a message decoded by pw_rpc,
+// or an empty span if the field was not present. If the field is repeated, the
+// last value is returned.
+//
+// The span points into the packet, which is only valid until the RPC function
+// or callback that received the message returns. Copy the data to keep it.
+ConstByteSpan GetNanopbBytesField(const pb_callback_t& field);
+
+// Returns the value of a callback string field in a message decoded by pw_rpc.
+// The same restrictions as GetNanopbBytesField apply.
+inline std::string_view GetNanopbStringField(const pb_callback_t& field) {
+  const ConstByteSpan value = GetNanopbBytesField(field);
+  return std::string_view(reinterpret_cast<const char*>(value.data()),
+                          value.size());
+}
+
+// Sets a callback bytes or string field of a message to encode to the provided
+// span. The span object, not only its data, must remain valid until the message
+// is encoded.
+void SetNanopbBytesField(pb_callback_t& field, const ConstByteSpan& value);
+
+}  // namespace pw::rpc
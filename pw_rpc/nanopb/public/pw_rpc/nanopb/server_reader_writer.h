@@ -174,6 +174,7 @@ class NanopbServerReaderWriter
   //   OK - the response was successfully sent
   //   FAILED_PRECONDITION - the writer is closed
   //   INTERNAL - pw_rpc was unable to encode the Nanopb protobuf
+  //   UNAVAILABLE - the stream is flow controlled and has no credits left
   //   other errors - the ChannelOutput failed to send the packet; the error
   //       codes are determined by the ChannelOutput implementation
   //
@@ -185,9 +186,15 @@ class NanopbServerReaderWriter
     return internal::Call::CloseAndSendResponse(status);
   }
 
+  // The number of responses that may be written before the client grants more
+  // credits, or kUnlimitedCredits if the stream is not flow controlled.
+  using internal::Call::available_credits;
+  using internal::Call::kUnlimitedCredits;
+
   // Functions for setting RPC event callbacks.
   using internal::Call::set_on_error;
   using internal::ServerCall::set_on_client_stream_end;
+  using internal::ServerCall::set_on_writable;
   using internal::BaseNanopbServerReader<Request>::set_on_next;
 
  private:
@@ -298,6 +305,7 @@ class NanopbServerWriter : private internal::NanopbServerCall {
   //   OK - the response was successfully sent
   //   FAILED_PRECONDITION - the writer is closed
   //   INTERNAL - pw_rpc was unable to encode the Nanopb protobuf
+  //   UNAVAILABLE - the stream is flow controlled and has no credits left
   //   other errors - the ChannelOutput failed to send the packet; the error
   //       codes are determined by the ChannelOutput implementation
   //
@@ -309,8 +317,14 @@ class NanopbServerWriter : private internal::NanopbServerCall {
     return internal::Call::CloseAndSendResponse(status);
   }
 
+  // The number of responses that may be written before the client grants more
+  // credits, or kUnlimitedCredits if the stream is not flow controlled.
+  using internal::Call::available_credits;
+  using internal::Call::kUnlimitedCredits;
+
   using internal::Call::set_on_error;
   using internal::ServerCall::set_on_client_stream_end;
+  using internal::ServerCall::set_on_writable;
 
  private:
   friend class internal::NanopbMethod;
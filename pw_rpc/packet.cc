@@ -15,6 +15,8 @@
 #include "pw_rpc/internal/packet.h"
 
 #include "pw_protobuf/decoder.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_status/try.h"
 
 namespace pw::rpc::internal {
 
@@ -68,6 +70,16 @@ Result<Packet> Packet::FromBuffer(ConstByteSpan data) {
         // A decode error will propagate from Next() and terminate the loop.
         decoder.ReadUint32(&packet.call_id_).IgnoreError();
         break;
+
+      case RpcPacket::Fields::TIMEOUT_MS:
+        // A decode error will propagate from Next() and terminate the loop.
+        decoder.ReadUint32(&packet.timeout_ms_).IgnoreError();
+        break;
+
+      case RpcPacket::Fields::CREDITS:
+        // A decode error will propagate from Next() and terminate the loop.
+        decoder.ReadUint32(&packet.credits_).IgnoreError();
+        break;
     }
   }
 
@@ -84,9 +96,8 @@ Result<Packet> Packet::FromBuffer(ConstByteSpan data) {
   return packet;
 }
 
-Result<ConstByteSpan> Packet::Encode(ByteSpan buffer) const {
-  RpcPacket::MemoryEncoder rpc_packet(buffer);
-
+template <typename Encoder>
+void Packet::EncodeFields(Encoder& rpc_packet) const {
   // The payload is encoded first, as it may share the encode buffer.
   if (!payload_.empty()) {
     rpc_packet.WritePayload(payload_)
@@ -113,12 +124,87 @@ Result<ConstByteSpan> Packet::Encode(ByteSpan buffer) const {
     rpc_packet.WriteCallId(call_id_);
   }
 
+  if (timeout_ms_ != 0) {
+    rpc_packet.WriteTimeoutMs(timeout_ms_);
+  }
+
+  if (credits_ != 0) {
+    rpc_packet.WriteCredits(credits_);
+  }
+}
+
+Result<ConstByteSpan> Packet::Encode(ByteSpan buffer) const {
+  RpcPacket::MemoryEncoder rpc_packet(buffer);
+  EncodeFields(rpc_packet);
+
   if (rpc_packet.status().ok()) {
     return ConstByteSpan(rpc_packet);
   }
   return rpc_packet.status();
 }
 
+ByteSpan Packet::PayloadBuffer(ByteSpan buffer) const {
+  const size_t reserved_size = MinEncodedSizeBytes();
+  if (buffer.size() < reserved_size) {
+    return ByteSpan();
+  }
+
+  // The reserved size includes the payload key and one byte of length. The
+  // rest of the buffer holds the length and the payload.
+  const size_t available = buffer.size() - reserved_size + 1;
+  const size_t length_size = varint::EncodedSize(available);
+  return buffer.subspan(1 + length_size, available - length_size);
+}
+
+size_t Packet::MaxPayloadSizeBytes(size_t buffer_size) const {
+  const size_t reserved_size = MinEncodedSizeBytes();
+  if (buffer_size < reserved_size) {
+    return 0;
+  }
+
+  const size_t available = buffer_size - reserved_size + 1;
+  return available - varint::EncodedSize(available);
+}
+
+Result<ConstByteSpan> Packet::EncodeInPlace(ByteSpan buffer) const {
+  const ByteSpan payload_buffer = PayloadBuffer(buffer);
+  if (payload_.data() != payload_buffer.data() ||
+      payload_.size() > payload_buffer.size()) {
+    return Status::InvalidArgument();
+  }
+
+  buffer[0] = static_cast<std::byte>(static_cast<uint32_t>(protobuf::FieldKey(
+      static_cast<uint32_t>(RpcPacket::Fields::PAYLOAD),
+      protobuf::WireType::kDelimited)));
+
+  // Write the length with continuation bits on each byte but the last, so that
+  // it fills the bytes reserved before the payload.
+  const size_t length_size = payload_buffer.data() - buffer.data() - 1;
+  size_t length = payload_.size();
+  for (size_t i = 1; i <= length_size; ++i) {
+    const uint8_t continuation = i < length_size ? 0x80 : 0;
+    buffer[i] = static_cast<std::byte>((length & 0x7f) | continuation);
+    length >>= 7;
+  }
+
+  const size_t payload_end = 1 + length_size + payload_.size();
+
+  Packet fields = *this;
+  fields.payload_ = {};
+  RpcPacket::MemoryEncoder rpc_packet(buffer.subspan(payload_end));
+  fields.EncodeFields(rpc_packet);
+  PW_TRY(rpc_packet.status());
+
+  return ConstByteSpan(buffer.first(payload_end + rpc_packet.size()));
+}
+
+Status Packet::Encode(stream::Writer& writer) const {
+  // RpcPacket has no nested messages, so no scratch buffer is needed.
+  RpcPacket::StreamEncoder rpc_packet(writer, ByteSpan());
+  EncodeFields(rpc_packet);
+  return rpc_packet.status();
+}
+
 size_t Packet::MinEncodedSizeBytes() const {
   size_t reserved_size = 0;
 
@@ -136,6 +222,18 @@ size_t Packet::MinEncodedSizeBytes() const {
   // Payload field takes at least two bytes to encode (varint key + length).
   reserved_size += 2;
 
+  if (call_id_ != 0) {
+    reserved_size += 1 + varint::EncodedSize(call_id_);  // call_id key and ID
+  }
+
+  if (timeout_ms_ != 0) {
+    reserved_size += 1 + varint::EncodedSize(timeout_ms_);
+  }
+
+  if (credits_ != 0) {
+    reserved_size += 1 + varint::EncodedSize(credits_);
+  }
+
   return reserved_size;
 }
 
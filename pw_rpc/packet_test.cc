@@ -17,6 +17,7 @@
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
 #include "pw_protobuf/wire_format.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::rpc::internal {
 namespace {
@@ -94,6 +95,24 @@ TEST(Packet, Encode_BufferTooSmall) {
   EXPECT_EQ(Status::ResourceExhausted(), result.status());
 }
 
+TEST(Packet, Encode_ToWriter) {
+  stream::MemoryWriterBuffer<64> writer;
+
+  Packet packet(PacketType::RESPONSE, 1, 42, 100, 7, kPayload);
+
+  ASSERT_EQ(OkStatus(), packet.Encode(writer));
+  ASSERT_EQ(kEncoded.size(), writer.bytes_written());
+  EXPECT_EQ(std::memcmp(kEncoded.data(), writer.data(), kEncoded.size()), 0);
+}
+
+TEST(Packet, Encode_ToWriter_WriterTooSmall) {
+  stream::MemoryWriterBuffer<2> writer;
+
+  Packet packet(PacketType::RESPONSE, 1, 42, 100, 0, kPayload);
+
+  EXPECT_EQ(Status::ResourceExhausted(), packet.Encode(writer));
+}
+
 TEST(Packet, Decode_ValidPacket) {
   auto result = Packet::FromBuffer(kEncoded);
   ASSERT_TRUE(result.ok());
@@ -148,6 +167,47 @@ TEST(Packet, EncodeDecode) {
   EXPECT_EQ(decoded.status(), Status::Unavailable());
 }
 
+TEST(Packet, EncodeDecode_Timeout) {
+  Packet packet(PacketType::REQUEST, 1, 42, 100, 7);
+  packet.set_timeout_ms(1500);
+
+  byte buffer[64];
+  Result<ConstByteSpan> encoded = packet.Encode(buffer);
+  ASSERT_EQ(OkStatus(), encoded.status());
+
+  Result<Packet> decoded = Packet::FromBuffer(encoded.value());
+  ASSERT_EQ(OkStatus(), decoded.status());
+  EXPECT_EQ(1500u, decoded.value().timeout_ms());
+  EXPECT_EQ(7u, decoded.value().call_id());
+}
+
+TEST(Packet, Decode_NoTimeout_IsZero) {
+  auto result = Packet::FromBuffer(kEncoded);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.value().timeout_ms());
+}
+
+TEST(Packet, EncodeDecode_Credits) {
+  Packet packet(PacketType::CLIENT_CREDIT, 1, 42, 100, 7);
+  packet.set_credits(16);
+
+  byte buffer[64];
+  Result<ConstByteSpan> encoded = packet.Encode(buffer);
+  ASSERT_EQ(OkStatus(), encoded.status());
+
+  Result<Packet> decoded = Packet::FromBuffer(encoded.value());
+  ASSERT_EQ(OkStatus(), decoded.status());
+  EXPECT_EQ(PacketType::CLIENT_CREDIT, decoded.value().type());
+  EXPECT_EQ(16u, decoded.value().credits());
+  EXPECT_EQ(7u, decoded.value().call_id());
+}
+
+TEST(Packet, Decode_NoCredits_IsZero) {
+  auto result = Packet::FromBuffer(kEncoded);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.value().credits());
+}
+
 constexpr size_t kReservedSize = 2 /* type */ + 2 /* channel */ +
                                  5 /* service */ + 5 /* method */ +
                                  2 /* payload key */ + 2 /* status */;
@@ -163,5 +223,105 @@ TEST(Packet, PayloadUsableSpace_LargerVarints) {
       Packet(PacketType::RESPONSE, 17000, 200, 200).MinEncodedSizeBytes());
 }
 
+TEST(Packet, PayloadUsableSpace_CallId) {
+  EXPECT_EQ(kReservedSize + 2 /* call ID */,
+            Packet(PacketType::RESPONSE, 1, 42, 100, 7).MinEncodedSizeBytes());
+}
+
+TEST(Packet, PayloadUsableSpace_Timeout) {
+  Packet packet(PacketType::REQUEST, 1, 42, 100);
+  packet.set_timeout_ms(1000);
+  EXPECT_EQ(kReservedSize + 3 /* timeout */, packet.MinEncodedSizeBytes());
+}
+
+TEST(Packet, PayloadUsableSpace_Credits) {
+  Packet packet(PacketType::REQUEST, 1, 42, 100);
+  packet.set_credits(8);
+  EXPECT_EQ(kReservedSize + 2 /* credits */, packet.MinEncodedSizeBytes());
+}
+
+TEST(Packet, PayloadBuffer_TooSmall) {
+  byte buffer[kReservedSize - 1];
+  EXPECT_TRUE(
+      Packet(PacketType::RESPONSE, 1, 42, 100).PayloadBuffer(buffer).empty());
+}
+
+TEST(Packet, PayloadBuffer_FollowsKeyAndLength) {
+  byte buffer[kReservedSize + 10];
+  const ByteSpan payload =
+      Packet(PacketType::RESPONSE, 1, 42, 100).PayloadBuffer(buffer);
+  EXPECT_EQ(buffer + 2, payload.data());
+  EXPECT_EQ(10u, payload.size());
+}
+
+TEST(Packet, PayloadBuffer_ReservesMultiByteLength) {
+  byte buffer[kReservedSize + 200];
+  const ByteSpan payload =
+      Packet(PacketType::RESPONSE, 1, 42, 100).PayloadBuffer(buffer);
+  EXPECT_EQ(buffer + 3, payload.data());
+  EXPECT_EQ(199u, payload.size());
+}
+
+TEST(Packet, MaxPayloadSizeBytes_MatchesPayloadBuffer) {
+  byte buffer[kReservedSize + 200];
+  const Packet packet(PacketType::RESPONSE, 1, 42, 100);
+  for (size_t size : {kReservedSize - 1, kReservedSize, kReservedSize + 10,
+                      kReservedSize + 129, sizeof(buffer)}) {
+    EXPECT_EQ(packet.PayloadBuffer(std::span(buffer).first(size)).size(),
+              packet.MaxPayloadSizeBytes(size));
+  }
+}
+
+// Builds a payload in place, encodes it, and checks that it decodes without
+// the payload having moved.
+void EncodeInPlaceAndDecode(ByteSpan buffer, size_t payload_size) {
+  Packet packet(PacketType::SERVER_STREAM, 12, 42, 100, 33);
+  const ByteSpan payload = packet.PayloadBuffer(buffer).first(payload_size);
+  for (size_t i = 0; i < payload.size(); ++i) {
+    payload[i] = static_cast<byte>(i);
+  }
+  packet.set_payload(payload);
+  packet.set_status(Status::Unavailable());
+
+  Result<ConstByteSpan> encoded = packet.EncodeInPlace(buffer);
+  ASSERT_EQ(OkStatus(), encoded.status());
+  ASSERT_EQ(buffer.data(), encoded.value().data());
+
+  Result<Packet> decoded = Packet::FromBuffer(encoded.value());
+  ASSERT_EQ(OkStatus(), decoded.status());
+  EXPECT_EQ(PacketType::SERVER_STREAM, decoded.value().type());
+  EXPECT_EQ(12u, decoded.value().channel_id());
+  EXPECT_EQ(42u, decoded.value().service_id());
+  EXPECT_EQ(100u, decoded.value().method_id());
+  EXPECT_EQ(33u, decoded.value().call_id());
+  EXPECT_EQ(Status::Unavailable(), decoded.value().status());
+  EXPECT_EQ(payload.data(), decoded.value().payload().data());
+  EXPECT_EQ(payload_size, decoded.value().payload().size());
+}
+
+TEST(Packet, EncodeInPlace_FullPayload) {
+  byte buffer[64];
+  const size_t capacity = Packet(PacketType::SERVER_STREAM, 12, 42, 100, 33)
+                              .PayloadBuffer(buffer)
+                              .size();
+  EncodeInPlaceAndDecode(buffer, capacity);
+}
+
+TEST(Packet, EncodeInPlace_PaddedLength) {
+  byte buffer[300];
+  EncodeInPlaceAndDecode(buffer, 5);
+}
+
+TEST(Packet, EncodeInPlace_EmptyPayload) {
+  byte buffer[300];
+  EncodeInPlaceAndDecode(buffer, 0);
+}
+
+TEST(Packet, EncodeInPlace_PayloadNotInPlace) {
+  byte buffer[64];
+  Packet packet(PacketType::RESPONSE, 1, 42, 100, 0, kPayload);
+  EXPECT_EQ(Status::InvalidArgument(), packet.EncodeInPlace(buffer).status());
+}
+
 }  // namespace
 }  // namespace pw::rpc::internal
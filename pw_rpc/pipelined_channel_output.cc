@@ -0,0 +1,136 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/pipelined_channel_output.h"
+
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+namespace pw::rpc {
+
+PipelinedChannelOutput::PipelinedChannelOutput(const char* name,
+                                               std::span<Buffer> buffers,
+                                               std::span<Buffer*> queue,
+                                               size_t buffer_size)
+    : ChannelOutput(name),
+      buffer_size_(buffer_size),
+      buffers_(buffers),
+      queue_(queue),
+      queue_head_(0),
+      queue_size_(0),
+      transmit_errors_(0) {
+  PW_CHECK_UINT_EQ(buffers.size(), queue.size());
+  free_.release(buffers.size());
+}
+
+std::span<std::byte> PipelinedChannelOutput::AcquireBuffer() {
+  free_.acquire();
+
+  std::lock_guard lock(mutex_);
+  for (Buffer& buffer : buffers_) {
+    if (!buffer.in_use) {
+      buffer.in_use = true;
+      return std::span(buffer.data, buffer_size_);
+    }
+  }
+  PW_CRASH("No free buffer, though the free buffer count was nonzero");
+}
+
+Status PipelinedChannelOutput::SendAndReleaseBuffer(
+    std::span<const std::byte> packet) {
+  {
+    std::lock_guard lock(mutex_);
+    Buffer* buffer = FindBuffer(packet.data());
+
+    // pw_rpc may release a buffer that was never acquired.
+    if (buffer == nullptr) {
+      PW_CHECK(packet.empty(),
+               "The packet is not in a buffer from AcquireBuffer()");
+      return OkStatus();
+    }
+
+    if (!packet.empty()) {
+      buffer->size = packet.size();
+      queue_[(queue_head_ + queue_size_) % queue_.size()] = buffer;
+      queue_size_ += 1;
+      queued_.release();
+      return OkStatus();
+    }
+
+    buffer->in_use = false;
+  }
+
+  free_.release();
+  return OkStatus();
+}
+
+void PipelinedChannelOutput::TransmitNext() {
+  queued_.acquire();
+  TransmitQueued();
+}
+
+size_t PipelinedChannelOutput::TransmitPending() {
+  size_t transmitted = 0;
+  while (queued_.try_acquire()) {
+    TransmitQueued();
+    transmitted += 1;
+  }
+  return transmitted;
+}
+
+size_t PipelinedChannelOutput::queued_packets() const {
+  std::lock_guard lock(mutex_);
+  return queue_size_;
+}
+
+size_t PipelinedChannelOutput::transmit_errors() const {
+  std::lock_guard lock(mutex_);
+  return transmit_errors_;
+}
+
+void PipelinedChannelOutput::TransmitQueued() {
+  Buffer* buffer;
+  {
+    std::lock_guard lock(mutex_);
+    buffer = queue_[queue_head_];
+    queue_head_ = (queue_head_ + 1) % queue_.size();
+    queue_size_ -= 1;
+  }
+
+  // Other threads may acquire and queue buffers while this one is sent.
+  const Status status = Transmit(ConstByteSpan(buffer->data, buffer->size));
+
+  {
+    std::lock_guard lock(mutex_);
+    if (!status.ok()) {
+      transmit_errors_ += 1;
+    }
+    buffer->in_use = false;
+  }
+  free_.release();
+}
+
+PipelinedChannelOutput::Buffer* PipelinedChannelOutput::FindBuffer(
+    const std::byte* data) {
+  for (Buffer& buffer : buffers_) {
+    if (buffer.in_use && data >= buffer.data &&
+        data < buffer.data + buffer_size_) {
+      return &buffer;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace pw::rpc
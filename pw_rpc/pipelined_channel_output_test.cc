@@ -0,0 +1,193 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/pipelined_channel_output.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_containers/vector.h"
+#include "pw_rpc/internal/channel.h"
+#include "pw_rpc/internal/packet.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::Packet;
+using internal::PacketType;
+
+constexpr size_t kBufferSize = 32;
+constexpr size_t kBufferCount = 3;
+
+class TestOutput final
+    : public PipelinedChannelOutputWithBuffers<kBufferSize, kBufferCount> {
+ public:
+  TestOutput() : PipelinedChannelOutputWithBuffers("test") {}
+
+  Vector<std::array<std::byte, kBufferSize>, 10> packets;
+  Vector<size_t, 10> sizes;
+  Status transmit_status = OkStatus();
+
+ private:
+  Status Transmit(ConstByteSpan packet) override {
+    packets.emplace_back();
+    std::memcpy(packets.back().data(), packet.data(), packet.size());
+    sizes.push_back(packet.size());
+    return transmit_status;
+  }
+};
+
+// Fills a buffer with a packet of the given size and queues it.
+Status SendPacket(TestOutput& output, size_t size, std::byte value) {
+  std::span<std::byte> buffer = output.AcquireBuffer();
+  std::fill_n(buffer.begin(), size, value);
+  return output.SendAndReleaseBuffer(buffer.first(size));
+}
+
+TEST(PipelinedChannelOutput, AcquireBuffer_ReturnsFullBuffer) {
+  TestOutput output;
+  std::span<std::byte> buffer = output.AcquireBuffer();
+  EXPECT_EQ(kBufferSize, buffer.size());
+  output.DiscardBuffer(buffer);
+}
+
+TEST(PipelinedChannelOutput, AcquireBuffer_ReturnsDistinctBuffers) {
+  TestOutput output;
+  std::array<std::span<std::byte>, kBufferCount> buffers;
+  for (std::span<std::byte>& buffer : buffers) {
+    buffer = output.AcquireBuffer();
+  }
+
+  EXPECT_NE(buffers[0].data(), buffers[1].data());
+  EXPECT_NE(buffers[1].data(), buffers[2].data());
+  EXPECT_NE(buffers[0].data(), buffers[2].data());
+
+  for (std::span<std::byte>& buffer : buffers) {
+    output.DiscardBuffer(buffer);
+  }
+}
+
+TEST(PipelinedChannelOutput, Send_QueuesUntilTransmitted) {
+  TestOutput output;
+  ASSERT_EQ(OkStatus(), SendPacket(output, 4, std::byte{1}));
+  ASSERT_EQ(OkStatus(), SendPacket(output, 5, std::byte{2}));
+
+  EXPECT_EQ(2u, output.queued_packets());
+  EXPECT_TRUE(output.packets.empty());
+
+  EXPECT_EQ(2u, output.TransmitPending());
+  EXPECT_EQ(0u, output.queued_packets());
+
+  ASSERT_EQ(2u, output.packets.size());
+  EXPECT_EQ(4u, output.sizes[0]);
+  EXPECT_EQ(std::byte{1}, output.packets[0][3]);
+  EXPECT_EQ(5u, output.sizes[1]);
+  EXPECT_EQ(std::byte{2}, output.packets[1][4]);
+}
+
+TEST(PipelinedChannelOutput, TransmitPending_NothingQueued) {
+  TestOutput output;
+  EXPECT_EQ(0u, output.TransmitPending());
+}
+
+TEST(PipelinedChannelOutput, TransmitNext_SendsOldestPacket) {
+  TestOutput output;
+  ASSERT_EQ(OkStatus(), SendPacket(output, 1, std::byte{1}));
+  ASSERT_EQ(OkStatus(), SendPacket(output, 2, std::byte{2}));
+
+  output.TransmitNext();
+  ASSERT_EQ(1u, output.packets.size());
+  EXPECT_EQ(1u, output.sizes[0]);
+  EXPECT_EQ(1u, output.queued_packets());
+
+  output.TransmitNext();
+  ASSERT_EQ(2u, output.packets.size());
+  EXPECT_EQ(2u, output.sizes[1]);
+}
+
+TEST(PipelinedChannelOutput, TransmittedBuffersAreReused) {
+  TestOutput output;
+
+  // Send more packets than there are buffers, transmitting as buffers fill,
+  // so the ring of queued packets wraps around.
+  for (size_t i = 0; i < 3 * kBufferCount; ++i) {
+    ASSERT_EQ(OkStatus(),
+              SendPacket(output, i + 1, static_cast<std::byte>(i)));
+    if (output.queued_packets() == kBufferCount - 1) {
+      output.TransmitPending();
+    }
+  }
+  output.TransmitPending();
+
+  ASSERT_EQ(3 * kBufferCount, output.packets.size());
+  for (size_t i = 0; i < output.packets.size(); ++i) {
+    EXPECT_EQ(i + 1, output.sizes[i]);
+    EXPECT_EQ(static_cast<std::byte>(i), output.packets[i][i]);
+  }
+}
+
+TEST(PipelinedChannelOutput, DiscardBuffer_ReleasesWithoutSending) {
+  TestOutput output;
+  for (size_t i = 0; i < 2 * kBufferCount; ++i) {
+    output.DiscardBuffer(output.AcquireBuffer());
+  }
+
+  EXPECT_EQ(0u, output.queued_packets());
+  EXPECT_EQ(0u, output.TransmitPending());
+  EXPECT_TRUE(output.packets.empty());
+}
+
+TEST(PipelinedChannelOutput, DiscardBuffer_NeverAcquired) {
+  TestOutput output;
+  output.DiscardBuffer({});
+  EXPECT_EQ(0u, output.queued_packets());
+}
+
+TEST(PipelinedChannelOutput, TransmitErrors_AreCounted) {
+  TestOutput output;
+  output.transmit_status = Status::Unavailable();
+
+  ASSERT_EQ(OkStatus(), SendPacket(output, 1, std::byte{1}));
+  ASSERT_EQ(OkStatus(), SendPacket(output, 1, std::byte{1}));
+  output.TransmitPending();
+
+  EXPECT_EQ(2u, output.transmit_errors());
+}
+
+TEST(PipelinedChannelOutput, Channel_PacketsAreEncodedBeforeTransmit) {
+  TestOutput output;
+  internal::Channel channel(1, &output);
+
+  constexpr std::byte kPayload[] = {std::byte{0xab}, std::byte{0xcd}};
+  const Packet packet(PacketType::SERVER_STREAM, 1, 42, 100, 0, kPayload);
+
+  for (size_t i = 0; i < kBufferCount; ++i) {
+    ASSERT_EQ(OkStatus(), channel.Send(packet));
+  }
+  EXPECT_EQ(kBufferCount, output.queued_packets());
+
+  ASSERT_EQ(kBufferCount, output.TransmitPending());
+  for (size_t i = 0; i < kBufferCount; ++i) {
+    Result<Packet> decoded =
+        Packet::FromBuffer(std::span(output.packets[i]).first(output.sizes[i]));
+    ASSERT_EQ(OkStatus(), decoded.status());
+    EXPECT_EQ(42u, decoded.value().service_id());
+    EXPECT_EQ(sizeof(kPayload), decoded.value().payload().size());
+  }
+}
+
+}  // namespace
+}  // namespace pw::rpc
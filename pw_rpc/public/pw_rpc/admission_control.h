@@ -0,0 +1,59 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+
+// Decides whether a Server starts a new call. Set a server's admission control
+// with Server::set_admission_control() to shed load, for example by limiting
+// the number of concurrent calls to a service or by rejecting calls to a
+// low-priority service while the system is busy.
+class AdmissionControl {
+ public:
+  // Describes a REQUEST that the server is about to dispatch.
+  struct Request {
+    uint32_t channel_id;
+    uint32_t service_id;
+    uint32_t method_id;
+
+    // The timeout requested by the client in milliseconds, or 0 if none.
+    uint32_t timeout_ms;
+
+    // How long the packet waited before the server processed it, in
+    // milliseconds, if known.
+    uint32_t queued_ms;
+
+    // The number of ongoing calls to the same service, not including this
+    // one.
+    uint32_t ongoing_service_calls;
+  };
+
+  virtual ~AdmissionControl() = default;
+
+  // Called for every REQUEST before the method's handler is invoked. Returns
+  // OK to start the call. Any other status rejects the call: the handler is
+  // not invoked and the status is sent to the client in a SERVER_ERROR packet.
+  // RESOURCE_EXHAUSTED or UNAVAILABLE are typical for shedding load.
+  //
+  // Admit() may be called from any thread that processes packets, so it must
+  // be thread safe if several threads do. It is called without the RPC lock
+  // held, but should be quick, since it delays every call.
+  virtual Status Admit(const Request& request) = 0;
+};
+
+}  // namespace pw::rpc
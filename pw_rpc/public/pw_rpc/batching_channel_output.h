@@ -0,0 +1,119 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_rpc/channel.h"
+#include "pw_status/status.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::rpc {
+
+// A ChannelOutput that combines packets into RpcPacketBatch messages, each of
+// which is sent through another ChannelOutput as a single packet. Transports
+// like HDLC add framing to every packet, so batching small, frequent packets,
+// such as log and metric stream responses, shares that overhead among them.
+//
+// Packets are held until the next one might not fit in the batch, or until the
+// oldest has waited for max_latency. Packets are only sent when another packet
+// is sent or the batch is flushed, so call FlushIfExpired() periodically, such
+// as from a timer or the thread that drives the stream, to bound the latency
+// of the last packets in a burst. A batch of one packet is sent as a plain
+// packet.
+//
+// Servers, clients and ClientServers unpack batches in ProcessPacket(). Only
+// use batching on channels whose receivers support it.
+//
+// Like SynchronizedChannelOutput, AcquireBuffer() locks a mutex that is
+// released by SendAndReleaseBuffer(), so the output may be shared by multiple
+// threads.
+class BatchingChannelOutput : public ChannelOutput {
+ public:
+  // Creates an output that batches packets into buffer and sends the batches
+  // through output. max_packet_size is the size of the buffer returned by
+  // AcquireBuffer(), so it must fit the largest packet sent on the channel.
+  // buffer must be larger than max_packet_size, and output's buffer must be at
+  // least as large as buffer.
+  BatchingChannelOutput(const char* name,
+                        ChannelOutput& output,
+                        ByteSpan buffer,
+                        size_t max_packet_size,
+                        chrono::SystemClock::duration max_latency);
+
+  BatchingChannelOutput(const BatchingChannelOutput&) = delete;
+  BatchingChannelOutput& operator=(const BatchingChannelOutput&) = delete;
+
+  std::span<std::byte> AcquireBuffer() final
+      PW_EXCLUSIVE_LOCK_FUNCTION(mutex_);
+
+  // Adds the packet to the batch. Returns the status from sending the batch
+  // if it was sent, or OK if the packet is waiting to be sent.
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) final
+      PW_UNLOCK_FUNCTION(mutex_);
+
+  // Sends the pending batch, if any. Returns the status from the underlying
+  // output, or OK if no packets were pending.
+  Status Flush() PW_LOCKS_EXCLUDED(mutex_);
+
+  // Sends the pending batch if its oldest packet has waited for max_latency.
+  Status FlushIfExpired() PW_LOCKS_EXCLUDED(mutex_);
+
+  // The number of packets waiting to be sent.
+  size_t pending_packets() const PW_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  Status SendBatch() PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  bool Expired() const PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return chrono::SystemClock::now() - oldest_packet_ >= max_latency_;
+  }
+
+  ChannelOutput& output_;
+  const ByteSpan buffer_;
+  const size_t max_packet_size_;
+  const chrono::SystemClock::duration max_latency_;
+
+  // Packets are encoded after room for the largest field key and length
+  // prefix, then moved into place.
+  const size_t max_prefix_size_;
+
+  mutable sync::Mutex mutex_;
+  size_t size_ PW_GUARDED_BY(mutex_);
+  size_t packet_count_ PW_GUARDED_BY(mutex_);
+  size_t first_packet_offset_ PW_GUARDED_BY(mutex_);
+  chrono::SystemClock::time_point oldest_packet_ PW_GUARDED_BY(mutex_);
+};
+
+// BatchingChannelOutput with its own kBatchSizeBytes buffer.
+template <size_t kBatchSizeBytes>
+class BatchingChannelOutputWithBuffer : public BatchingChannelOutput {
+ public:
+  BatchingChannelOutputWithBuffer(const char* name,
+                                  ChannelOutput& output,
+                                  size_t max_packet_size,
+                                  chrono::SystemClock::duration max_latency)
+      : BatchingChannelOutput(
+            name, output, buffer_, max_packet_size, max_latency) {}
+
+ private:
+  std::array<std::byte, kBatchSizeBytes> buffer_;
+};
+
+}  // namespace pw::rpc
@@ -13,12 +13,19 @@
 // the License.
 #pragma once
 
+#include <cstdint>
+
 #include "pw_rpc/benchmark.raw_rpc.pb.h"
 
 namespace pw::rpc {
 
 // RPC service with low-level RPCs for transmitting data. Used for benchmarking
 // and testing.
+//
+// ServerStream sends its responses from the handler, so it occupies the thread
+// that processes packets until every response is sent. Only one ClientStream
+// or BidirectionalEcho call is active at a time; a new call replaces the
+// previous one.
 class BenchmarkService : public generated::Benchmark<BenchmarkService> {
  public:
   static StatusWithSize UnaryEcho(ServerContext&,
@@ -27,8 +34,20 @@ class BenchmarkService : public generated::Benchmark<BenchmarkService> {
 
   void BidirectionalEcho(ServerContext&, RawServerReaderWriter& reader_writer);
 
+  static void ServerStream(ServerContext&,
+                           ConstByteSpan request,
+                           RawServerWriter& writer);
+
+  void ClientStream(ServerContext&, RawServerReader& reader);
+
  private:
+  void FinishClientStream();
+
   RawServerReaderWriter reader_writer_;
+
+  RawServerReader reader_;
+  uint32_t payload_count_ = 0;
+  uint64_t payload_bytes_ = 0;
 };
 
 }  // namespace pw::rpc
@@ -13,12 +13,15 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <span>
 #include <type_traits>
 
 #include "pw_assert/assert.h"
 #include "pw_status/status.h"
+#include "pw_stream/stream.h"
 
 namespace pw::rpc {
 namespace internal {
@@ -52,10 +55,35 @@ class ChannelOutput {
   // FAILED_PRECONDITION or INTERNAL, which are reserved by pw_rpc.
   virtual Status SendAndReleaseBuffer(std::span<const std::byte> buffer) = 0;
 
+  // Returns the largest encoded RPC packet this output can send, in bytes.
+  // pw_rpc uses at most this much of the buffer from AcquireBuffer(), so
+  // payloads are sized to fit. Outputs without a limit other than the size of
+  // their buffer return the maximum size_t.
+  virtual size_t MaximumTransmissionUnit() {
+    return std::numeric_limits<size_t>::max();
+  }
+
   void DiscardBuffer(std::span<const std::byte> buffer) {
     SendAndReleaseBuffer(buffer.first(0)).IgnoreError();
   }
 
+  // ChannelOutputs may optionally encode packets directly into a
+  // stream::Writer, such as a transport's framing encoder, instead of into the
+  // buffer from AcquireBuffer(). This avoids copying each packet an extra time.
+  //
+  // StartPacket() is called while the buffer from AcquireBuffer() is held,
+  // since the packet's payload may be stored there. It returns the writer to encode
+  // the packet to, or nullptr if the output does not support streaming, in
+  // which case the packet is encoded into the buffer and sent with
+  // SendAndReleaseBuffer(). The buffer is always released separately.
+  virtual stream::Writer* StartPacket() { return nullptr; }
+
+  // Finishes a packet started with StartPacket(). write_status is the status of
+  // encoding the packet to the writer; if it is not OK, the output should
+  // discard the partially written packet, if possible. Has the same return
+  // value requirements as SendAndReleaseBuffer().
+  virtual Status FinishPacket(Status write_status) { return write_status; }
+
  private:
   const char* name_;
 };
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <span>
 
 #include "pw_bytes/span.h"
@@ -27,7 +28,8 @@ class Client : public internal::Endpoint {
  public:
   // Creates a client that uses a set of RPC channels. Channels can be shared
   // between a client and a server, but not between multiple clients.
-  constexpr Client(std::span<Channel> channels) : Endpoint(channels) {
+  constexpr Client(std::span<Channel> channels)
+      : Endpoint(channels), request_timeout_ms_(0), stream_credits_(0) {
     // TODO(hepler): Remove the Client* from Channel.
     for (Channel& channel : channels) {
       static_cast<internal::Channel&>(channel).set_client(this);
@@ -43,8 +45,41 @@ class Client : public internal::Endpoint {
   //   INVALID_ARGUMENT - The packet is intended for a server, not a client.
   //   UNAVAILABLE - No RPC channel with the requested ID was found.
   //
+  // The packet may also be an RpcPacketBatch, in which case each packet in it
+  // is processed. A batch returns DATA_LOSS if it is malformed, and otherwise
+  // the first error from its packets.
   Status ProcessPacket(ConstByteSpan data)
       PW_LOCKS_EXCLUDED(internal::rpc_lock());
+
+  // Sets the timeout sent in the REQUEST packets of calls started after this,
+  // in milliseconds. A server that cannot start a call within the timeout
+  // rejects it with DEADLINE_EXCEEDED, rather than processing a request that
+  // the client may have given up on. 0, the default, means no timeout.
+  //
+  // This must not be changed while calls are being started on other threads.
+  void set_request_timeout_ms(uint32_t timeout_ms) {
+    request_timeout_ms_ = timeout_ms;
+  }
+
+  uint32_t request_timeout_ms() const { return request_timeout_ms_; }
+
+  // Enables flow control for the server streams of calls started after this.
+  // The server may send up to this many stream packets before the client
+  // grants it more credits. The client grants credits as packets are handled,
+  // so a slow on_next callback slows the server down instead of packets being
+  // dropped. 0, the default, disables flow control.
+  //
+  // This must not be changed while streaming calls are active.
+  void set_stream_credits(uint32_t credits) { stream_credits_ = credits; }
+
+  uint32_t stream_credits() const { return stream_credits_; }
+
+ private:
+  Status ProcessSinglePacket(ConstByteSpan data)
+      PW_LOCKS_EXCLUDED(internal::rpc_lock());
+
+  uint32_t request_timeout_ms_;
+  uint32_t stream_credits_;
 };
 
 }  // namespace pw::rpc
@@ -26,6 +26,8 @@ class ClientServer {
       : client_(channels), server_(channels) {}
 
   // Sends a packet to either the client or the server, depending on its type.
+  // Each packet in an RpcPacketBatch is sent to the client or server
+  // separately.
   Status ProcessPacket(std::span<const std::byte> packet,
                        ChannelOutput& interface);
 
@@ -33,6 +35,9 @@ class ClientServer {
   constexpr Server& server() { return server_; }
 
  private:
+  Status ProcessSinglePacket(std::span<const std::byte> packet,
+                             ChannelOutput& interface);
+
   Client client_;
   Server server_;
 };
@@ -0,0 +1,39 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_rpc/internal/config.h"
+
+#if PW_RPC_INSTRUMENTATION
+
+#include "pw_metric/metric.h"  // nogncheck
+
+namespace pw::rpc {
+
+// Returns the metrics recorded by pw_rpc's server instrumentation. The group
+// has two child groups:
+//
+//   methods: A group for each method, named by the method ID, with its
+//       service ID, the number of requests, and a histogram of the time the
+//       method's handler took to run, in microseconds.
+//   channels: A group for each channel, named by the channel ID, with the
+//       packets and bytes received and sent and the number of failed sends.
+//
+// Add this group to a parent group to report it, for example through the
+// pw_metric RPC service.
+metric::Group& InstrumentationMetrics();
+
+}  // namespace pw::rpc
+
+#endif  // PW_RPC_INSTRUMENTATION
@@ -14,14 +14,17 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <mutex>
 #include <span>
 #include <utility>
 
-#include "pw_containers/intrusive_list.h"
+#include "pw_containers/intrusive_dlist.h"
 #include "pw_function/function.h"
 #include "pw_rpc/internal/call_context.h"
 #include "pw_rpc/internal/channel.h"
+#include "pw_rpc/internal/instrumentation.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/method.h"
 #include "pw_rpc/internal/packet.h"
@@ -42,10 +45,15 @@ class Packet;
 //
 // Private inheritance is used in place of composition or more complex
 // inheritance hierarchy so that these objects all inherit from a common
-// IntrusiveList::Item object. Private inheritance also gives the derived classs
-// full control over their interfaces.
-class Call : public IntrusiveList<Call>::Item {
+// IntrusiveDList::Item object. Private inheritance also gives the derived
+// classs full control over their interfaces.
+class Call : public IntrusiveDList<Call>::Item {
  public:
+  // The available_credits() of a call whose server stream is not flow
+  // controlled.
+  static constexpr uint32_t kUnlimitedCredits =
+      std::numeric_limits<uint32_t>::max();
+
   Call(const Call&) = delete;
 
   // Move support is provided to derived classes through the MoveFrom function.
@@ -95,9 +103,19 @@ class Call : public IntrusiveList<Call>::Item {
   // Ends the client stream for a client call.
   Status EndClientStream() PW_UNLOCK_FUNCTION(rpc_lock());
 
-  // Sends a payload in either a server or client stream packet.
+  // Sends a payload in either a server or client stream packet. If the server
+  // stream is flow controlled and has no credits left, returns UNAVAILABLE
+  // without sending anything.
   Status Write(ConstByteSpan payload) PW_LOCKS_EXCLUDED(rpc_lock());
 
+  // Returns how many more server stream packets may be sent before the client
+  // grants more credits, or kUnlimitedCredits if the client did not enable flow
+  // control for the call.
+  uint32_t available_credits() const PW_LOCKS_EXCLUDED(rpc_lock()) {
+    std::lock_guard lock(rpc_lock());
+    return credits_;
+  }
+
   // Whenever a payload arrives (in a server/client stream or in a response),
   // call the on_next_ callback.
   // Precondition: rpc_lock() must be held.
@@ -131,6 +149,11 @@ class Call : public IntrusiveList<Call>::Item {
   // Releases the buffer without sending a packet.
   void ReleasePayloadBuffer();
 
+  // Returns the largest payload that fits in a stream packet within the
+  // channel output's MTU, or the maximum size_t if the output has no MTU. The
+  // buffer from AcquirePayloadBuffer() may be smaller.
+  size_t MaxWriteSizeBytes() const;
+
   // Keep this public so the Nanopb implementation can set it from a helper
   // function.
   void set_on_next(Function<void(ConstByteSpan)>&& on_next)
@@ -150,7 +173,8 @@ class Call : public IntrusiveList<Call>::Item {
         rpc_state_{},
         type_{},
         call_type_{},
-        client_stream_state_{} {}
+        client_stream_state_{},
+        credits_{} {}
 
   // Creates an active server-side Call.
   Call(const CallContext& context, MethodType type)
@@ -160,7 +184,10 @@ class Call : public IntrusiveList<Call>::Item {
              context.service().id(),
              context.method().id(),
              type,
-             kServerCall) {}
+             kServerCall,
+             HasServerStream(type) && context.stream_credits() != 0
+                 ? context.stream_credits()
+                 : kUnlimitedCredits) {}
 
   // Creates an active client-side Call.
   Call(Endpoint& client,
@@ -187,8 +214,13 @@ class Call : public IntrusiveList<Call>::Item {
   // call has already completed.
   void on_error(Status error) PW_UNLOCK_FUNCTION(rpc_lock()) {
     const bool invoke = on_error_ != nullptr;
+    const bool server_call = call_type_ == kServerCall;
+    const uint32_t method_id = method_id_;
 
     rpc_lock().unlock();
+    if (server_call) {
+      TraceCallEnd(method_id);
+    }
     if (invoke) {
       on_error_(error);
     }
@@ -206,7 +238,27 @@ class Call : public IntrusiveList<Call>::Item {
   // Returns FAILED_PRECONDITION if the call is not active().
   Status SendPacket(PacketType type,
                     ConstByteSpan payload,
-                    Status status = OkStatus()) PW_UNLOCK_FUNCTION(rpc_lock());
+                    Status status = OkStatus()) PW_UNLOCK_FUNCTION(rpc_lock()) {
+    return SendPacket(MakePacket(type, payload, status));
+  }
+
+  // Sends a packet for this call, such as one created with MakePacket().
+  Status SendPacket(const Packet& packet) PW_UNLOCK_FUNCTION(rpc_lock());
+
+  uint32_t credits() const PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return credits_;
+  }
+
+  void set_credits(uint32_t credits) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    credits_ = credits;
+  }
+
+  Packet MakePacket(PacketType type,
+                    ConstByteSpan payload,
+                    Status status = OkStatus()) const {
+    return Packet(
+        type, channel_id(), service_id(), method_id(), id_, payload, status);
+  }
 
   // Unregisters the RPC from the endpoint & marks as closed. The call may be
   // active or inactive when this is called.
@@ -228,14 +280,8 @@ class Call : public IntrusiveList<Call>::Item {
        uint32_t service_id,
        uint32_t method_id,
        MethodType type,
-       CallType call_type);
-
-  Packet MakePacket(PacketType type,
-                    ConstByteSpan payload,
-                    Status status = OkStatus()) const {
-    return Packet(
-        type, channel_id(), service_id(), method_id(), id_, payload, status);
-  }
+       CallType call_type,
+       uint32_t credits);
 
   Status CloseAndSendFinalPacket(PacketType type,
                                  ConstByteSpan response,
@@ -255,6 +301,10 @@ class Call : public IntrusiveList<Call>::Item {
     kClientStreamActive,
   } client_stream_state_;
 
+  // For server calls, the number of server stream packets the server may send.
+  // For client calls, the number the client expects the server may send.
+  uint32_t credits_;
+
   Channel::OutputBuffer response_;
 
   // Called when the RPC is terminated due to an error.
@@ -35,12 +35,14 @@ class CallContext {
                         Channel& channel,
                         Service& service,
                         const internal::Method& method,
-                        uint32_t call_id)
+                        uint32_t call_id,
+                        uint32_t stream_credits = 0)
       : server_(server),
         channel_(channel),
         service_(service),
         method_(method),
-        call_id_(call_id) {}
+        call_id_(call_id),
+        stream_credits_(stream_credits) {}
 
   constexpr Endpoint& server() const { return server_; }
 
@@ -52,12 +54,17 @@ class CallContext {
 
   constexpr uint32_t call_id() const { return call_id_; }
 
+  // The initial flow control credits for the call's server stream, or 0 if the
+  // stream is not flow controlled.
+  constexpr uint32_t stream_credits() const { return stream_credits_; }
+
  private:
   Endpoint& server_;
   Channel& channel_;
   Service& service_;
   const internal::Method& method_;
   uint32_t call_id_;
+  uint32_t stream_credits_;
 };
 
 }  // namespace internal
@@ -0,0 +1,143 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_preprocessor/compiler.h"
+#include "pw_rpc/internal/call.h"
+
+namespace pw::rpc::internal {
+
+// Fixed-capacity hash table of ongoing calls, keyed by channel, service, and
+// method ID. The index uses open addressing with linear probing, so adding,
+// removing, and finding a call are bounded by kCapacity probes and take O(1)
+// time while the table is sparsely populated.
+//
+// Calls are not always indexed. One slot is always left empty to terminate
+// probe sequences, so the index holds up to kCapacity - 1 calls. If the index
+// is full, Add() returns false and the caller must fall back to searching for
+// the call some other way.
+template <size_t kCapacity>
+class CallIndex {
+ public:
+  static_assert(kCapacity > 1u && (kCapacity & (kCapacity - 1)) == 0u,
+                "The call index capacity must be a power of two");
+
+  constexpr CallIndex() : slots_{}, size_(0) {}
+
+  // Adds a call to the index. Returns false if the index is full. The call's
+  // IDs must not change while it is indexed.
+  bool Add(Call& call) {
+    if (size_ == kCapacity - 1) {
+      return false;
+    }
+
+    size_t slot = FirstSlot(call);
+    while (slots_[slot] != nullptr) {
+      slot = NextSlot(slot);
+    }
+    slots_[slot] = &call;
+    size_ += 1;
+    return true;
+  }
+
+  // Removes a call from the index. Returns false if the call was not indexed.
+  bool Remove(const Call& call) {
+    size_t slot = FirstSlot(call);
+    while (slots_[slot] != &call) {
+      if (slots_[slot] == nullptr) {
+        return false;
+      }
+      slot = NextSlot(slot);
+    }
+
+    // Shift later entries in this probe sequence back so that lookups never
+    // stop early at the emptied slot.
+    size_t empty = slot;
+    slots_[empty] = nullptr;
+    for (slot = NextSlot(slot); slots_[slot] != nullptr;
+         slot = NextSlot(slot)) {
+      Call* const moved = slots_[slot];
+      const size_t home = FirstSlot(*moved);
+
+      // Move the entry unless its home slot lies cyclically in (empty, slot].
+      if (((slot - home) & kMask) >= ((slot - empty) & kMask)) {
+        slots_[empty] = moved;
+        slots_[slot] = nullptr;
+        empty = slot;
+      }
+    }
+
+    size_ -= 1;
+    return true;
+  }
+
+  // Returns the indexed call with these IDs or nullptr if there is none.
+  Call* Find(uint32_t channel_id,
+             uint32_t service_id,
+             uint32_t method_id) const {
+    for (size_t slot = FirstSlot(channel_id, service_id, method_id);
+         slots_[slot] != nullptr;
+         slot = NextSlot(slot)) {
+      Call& call = *slots_[slot];
+      if (call.channel_id() == channel_id && call.service_id() == service_id &&
+          call.method_id() == method_id) {
+        return &call;
+      }
+    }
+    return nullptr;
+  }
+
+  size_t size() const { return size_; }
+
+ private:
+  static constexpr size_t kMask = kCapacity - 1;
+
+  // Service and method IDs are already hashes of their names, so they only
+  // need to be combined with each other and the channel ID.
+  static constexpr size_t FirstSlot(uint32_t channel_id,
+                                    uint32_t service_id,
+                                    uint32_t method_id)
+      PW_NO_SANITIZE("unsigned-integer-overflow") {
+    uint32_t hash = (service_id ^ (method_id * 65599u)) + channel_id;
+    hash ^= hash >> 16;
+    return hash & kMask;
+  }
+
+  static size_t FirstSlot(const Call& call) {
+    return FirstSlot(call.channel_id(), call.service_id(), call.method_id());
+  }
+
+  static constexpr size_t NextSlot(size_t slot) { return (slot + 1) & kMask; }
+
+  std::array<Call*, kCapacity> slots_;
+  size_t size_;
+};
+
+// When the index is disabled, no calls are indexed.
+template <>
+class CallIndex<0> {
+ public:
+  constexpr CallIndex() = default;
+
+  constexpr bool Add(Call&) { return false; }
+  constexpr bool Remove(const Call&) { return false; }
+  constexpr Call* Find(uint32_t, uint32_t, uint32_t) const { return nullptr; }
+  constexpr size_t size() const { return 0; }
+};
+
+}  // namespace pw::rpc::internal
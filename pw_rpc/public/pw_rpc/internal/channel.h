@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <algorithm>
 #include <span>
 
 #include "pw_assert/assert.h"
@@ -50,7 +51,8 @@ class Channel : public rpc::Channel {
       return *this;
     }
 
-    // Returns a portion of this OutputBuffer to use as the packet payload.
+    // Returns a portion of this OutputBuffer to use as the packet payload. A
+    // payload built at the start of this span is sent without being copied.
     std::span<std::byte> payload(const Packet& packet) const;
 
     bool Contains(std::span<const std::byte> other) const {
@@ -69,9 +71,15 @@ class Channel : public rpc::Channel {
     std::span<std::byte> buffer_;
   };
 
-  // Acquires a buffer for the packet.
+  // Acquires a buffer for the packet, limited to the output's MTU.
   OutputBuffer AcquireBuffer() const {
-    return OutputBuffer(output().AcquireBuffer());
+    const std::span<std::byte> buffer = output().AcquireBuffer();
+    return OutputBuffer(
+        buffer.first(std::min(buffer.size(), MaximumTransmissionUnit())));
+  }
+
+  size_t MaximumTransmissionUnit() const {
+    return output().MaximumTransmissionUnit();
   }
 
   Status Send(const internal::Packet& packet) {
@@ -93,6 +101,15 @@ class Channel : public rpc::Channel {
   // TODO(pwbug/504): Remove this when users have migrated off the old API.
   using rpc::Channel::client;
   using rpc::Channel::set_client;
+
+ private:
+  Status SendToWriter(stream::Writer& writer,
+                      OutputBuffer& buffer,
+                      const internal::Packet& packet);
+
+  // Records the result of sending a packet of about size_bytes and remaps its
+  // status.
+  Status HandleSendStatus(Status status, size_t size_bytes) const;
 };
 
 }  // namespace pw::rpc::internal
@@ -43,6 +43,11 @@ class ClientCall : public Call {
   void SendInitialRequestLocked(ConstByteSpan payload)
       PW_UNLOCK_FUNCTION(rpc_lock());
 
+  // Accounts for a SERVER_STREAM packet received by a flow controlled call.
+  // Returns the number of credits to grant the server once the packet has been
+  // handled, or 0 if no CLIENT_CREDIT packet is needed yet.
+  uint32_t ConsumeStreamCredit() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
  protected:
   constexpr ClientCall() = default;
 
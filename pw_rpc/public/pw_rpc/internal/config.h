@@ -29,6 +29,18 @@
 #define PW_RPC_CLIENT_STREAM_END_CALLBACK 0
 #endif  // PW_RPC_CLIENT_STREAM_END_CALLBACK
 
+// Clients may enable flow control for a server stream, in which case server
+// writers can only send as many packets as the client has granted credits for.
+//
+// This option controls whether server writers include a callback that is
+// called when they receive credits after running out. Like the client stream
+// end callback, it is a pw::Function in every ServerReader/Writer object, so
+// may have a significant cost. Without it, producers must poll
+// available_credits().
+#ifndef PW_RPC_ON_WRITABLE_CALLBACK
+#define PW_RPC_ON_WRITABLE_CALLBACK 0
+#endif  // PW_RPC_ON_WRITABLE_CALLBACK
+
 // The Nanopb-based pw_rpc implementation allocates memory to use for Nanopb
 // structs for the request and response protobufs. The template function that
 // allocates these structs rounds struct sizes up to this value so that
@@ -49,17 +61,76 @@
 #define PW_RPC_USE_GLOBAL_MUTEX 0
 #endif  // PW_RPC_USE_GLOBAL_MUTEX
 
+// Server and client endpoints keep a list of ongoing calls, which is searched
+// for every packet received. With many concurrent calls, such as long-lived
+// server streams, this search can become a significant cost.
+//
+// If this option is nonzero, each endpoint also keeps a fixed-capacity hash
+// index of ongoing calls so that calls are found in constant time. The value,
+// which must be a power of two, is the number of slots in the index. Each slot
+// is one pointer. For best performance, use at least twice the expected number
+// of concurrent calls. The index holds one fewer call than its size; calls that
+// do not fit in the index are still found through the list.
+#ifndef PW_RPC_CALL_INDEX_SIZE
+#define PW_RPC_CALL_INDEX_SIZE 0
+#endif  // PW_RPC_CALL_INDEX_SIZE
+
+// If this option is nonzero, pw_rpc records metrics for server RPC methods and
+// channels: the number of requests and a histogram of handler times for each
+// method, and the packets and bytes sent and received on each channel. The
+// metrics are returned by pw::rpc::InstrumentationMetrics(), declared in
+// pw_rpc/instrumentation.h. Enabling this requires pw_metric and a
+// pw_chrono:system_clock backend.
+#ifndef PW_RPC_INSTRUMENTATION
+#define PW_RPC_INSTRUMENTATION 0
+#endif  // PW_RPC_INSTRUMENTATION
+
+// The number of methods and channels that instrumentation tracks. Metrics are
+// kept for the first methods and channels used; others are not recorded.
+#ifndef PW_RPC_INSTRUMENTATION_MAX_METHODS
+#define PW_RPC_INSTRUMENTATION_MAX_METHODS 16
+#endif  // PW_RPC_INSTRUMENTATION_MAX_METHODS
+
+#ifndef PW_RPC_INSTRUMENTATION_MAX_CHANNELS
+#define PW_RPC_INSTRUMENTATION_MAX_CHANNELS 4
+#endif  // PW_RPC_INSTRUMENTATION_MAX_CHANNELS
+
+// If this option is nonzero, the server emits pw_trace events at the start
+// and end of each RPC call. Events use the method ID as the trace ID. This
+// requires a pw_trace backend, such as pw_trace_tokenized.
+#ifndef PW_RPC_TRACE_CALLS
+#define PW_RPC_TRACE_CALLS 0
+#endif  // PW_RPC_TRACE_CALLS
+
 namespace pw::rpc::cfg {
 
 template <typename...>
 constexpr std::bool_constant<PW_RPC_CLIENT_STREAM_END_CALLBACK>
     kClientStreamEndCallbackEnabled;
 
+template <typename...>
+constexpr std::bool_constant<PW_RPC_ON_WRITABLE_CALLBACK>
+    kOnWritableCallbackEnabled;
+
 inline constexpr size_t kNanopbStructMinBufferSize =
     PW_RPC_NANOPB_STRUCT_MIN_BUFFER_SIZE;
 
 #undef PW_RPC_NANOPB_STRUCT_MIN_BUFFER_SIZE
 
+inline constexpr size_t kCallIndexSize = PW_RPC_CALL_INDEX_SIZE;
+
+#undef PW_RPC_CALL_INDEX_SIZE
+
+inline constexpr size_t kInstrumentationMaxMethods =
+    PW_RPC_INSTRUMENTATION_MAX_METHODS;
+
+#undef PW_RPC_INSTRUMENTATION_MAX_METHODS
+
+inline constexpr size_t kInstrumentationMaxChannels =
+    PW_RPC_INSTRUMENTATION_MAX_CHANNELS;
+
+#undef PW_RPC_INSTRUMENTATION_MAX_CHANNELS
+
 }  // namespace pw::rpc::cfg
 
 // This option determines whether to allocate the Nanopb structs on the stack or
@@ -16,10 +16,12 @@
 #include <mutex>
 #include <span>
 
-#include "pw_containers/intrusive_list.h"
+#include "pw_containers/intrusive_dlist.h"
 #include "pw_result/result.h"
 #include "pw_rpc/internal/call.h"
+#include "pw_rpc/internal/call_index.h"
 #include "pw_rpc/internal/channel.h"
+#include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_sync/lock_annotations.h"
@@ -48,6 +50,7 @@ class Endpoint {
   constexpr Endpoint(std::span<rpc::Channel> channels)
       : channels_(static_cast<internal::Channel*>(channels.data()),
                   channels.size()),
+        unindexed_calls_(0),
         next_call_id_(0) {}
 
   // Parses an RPC packet and sets ongoing_call to the matching call, if any.
@@ -63,6 +66,10 @@ class Endpoint {
         packet.channel_id(), packet.service_id(), packet.method_id());
   }
 
+  // Returns the number of ongoing calls to a service.
+  uint32_t CountCallsToService(uint32_t service_id) const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
   // Finds an internal:::Channel with this ID or nullptr if none matches.
   Channel* GetInternalChannel(uint32_t id) const;
 
@@ -91,12 +98,18 @@ class Endpoint {
   // for existing calls.
   void RegisterUniqueCall(Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     calls_.push_front(call);
+    if (!call_index_.Add(call)) {
+      unindexed_calls_ += 1;
+    }
   }
 
   // Removes the provided call from the call registry.
   void UnregisterCall(const Call& call)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     calls_.remove(call);
+    if (!call_index_.Remove(call)) {
+      unindexed_calls_ -= 1;
+    }
   }
 
   Call* FindCallById(uint32_t channel_id,
@@ -105,7 +118,14 @@ class Endpoint {
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
   std::span<Channel> channels_;
-  IntrusiveList<Call> calls_ PW_GUARDED_BY(rpc_lock());
+  // Calls are registered and unregistered frequently, so they are kept in a
+  // doubly-linked list to make unregistering O(1).
+  IntrusiveDList<Call> calls_ PW_GUARDED_BY(rpc_lock());
+
+  // Optional index of the calls in calls_. Calls that did not fit in the index
+  // are counted so the list is only searched when necessary.
+  CallIndex<cfg::kCallIndexSize> call_index_ PW_GUARDED_BY(rpc_lock());
+  size_t unindexed_calls_ PW_GUARDED_BY(rpc_lock());
 
   uint32_t next_call_id_;
 };
@@ -15,6 +15,7 @@
 
 #include <cstddef>
 #include <iterator>
+#include <limits>
 
 #include "pw_bytes/span.h"
 #include "pw_containers/vector.h"
@@ -127,6 +128,9 @@ class FakeChannelOutput : public ChannelOutput {
     return_after_packet_count_ = return_after_packet_count;
   }
 
+  // Limits the packets sent through this output to mtu bytes.
+  void set_mtu(size_t mtu) { mtu_ = mtu; }
+
   // Logs which packets have been sent for debugging purposes.
   void LogPackets() const;
 
@@ -153,9 +157,12 @@ class FakeChannelOutput : public ChannelOutput {
   // When negative, ignores `send_status_` processes buffer.
   Status SendAndReleaseBuffer(ConstByteSpan buffer) final;
 
+  size_t MaximumTransmissionUnit() final { return mtu_; }
+
   void CopyPayloadToBuffer(const ConstByteSpan& payload);
 
   int return_after_packet_count_ = -1;
+  size_t mtu_ = std::numeric_limits<size_t>::max();
   unsigned total_response_packets_ = 0;
 
   Vector<Packet>& packets_;
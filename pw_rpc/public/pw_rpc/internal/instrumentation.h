@@ -0,0 +1,85 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Hooks through which the server and channels report events to the optional
+// instrumentation and tracing. When they are disabled, the hooks are empty
+// inline functions, so they have no cost.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_rpc/internal/config.h"
+#include "pw_status/status.h"
+
+#if PW_RPC_INSTRUMENTATION
+#include "pw_chrono/system_clock.h"  // nogncheck
+#endif  // PW_RPC_INSTRUMENTATION
+
+namespace pw::rpc::internal {
+
+#if PW_RPC_INSTRUMENTATION
+
+void RecordPacketReceived(uint32_t channel_id, size_t size_bytes);
+
+void RecordPacketSent(uint32_t channel_id, size_t size_bytes, Status status);
+
+// Counts a request to a method and records how long its handler runs, from
+// construction to destruction.
+class HandlerTimer {
+ public:
+  HandlerTimer(uint32_t service_id, uint32_t method_id)
+      : service_id_(service_id),
+        method_id_(method_id),
+        start_(chrono::SystemClock::now()) {}
+
+  HandlerTimer(const HandlerTimer&) = delete;
+  HandlerTimer& operator=(const HandlerTimer&) = delete;
+
+  ~HandlerTimer();
+
+ private:
+  uint32_t service_id_;
+  uint32_t method_id_;
+  chrono::SystemClock::time_point start_;
+};
+
+#else
+
+inline void RecordPacketReceived(uint32_t, size_t) {}
+
+inline void RecordPacketSent(uint32_t, size_t, Status) {}
+
+class HandlerTimer {
+ public:
+  constexpr HandlerTimer(uint32_t, uint32_t) {}
+};
+
+#endif  // PW_RPC_INSTRUMENTATION
+
+#if PW_RPC_TRACE_CALLS
+
+void TraceCallStart(uint32_t method_id);
+
+void TraceCallEnd(uint32_t method_id);
+
+#else
+
+inline void TraceCallStart(uint32_t) {}
+
+inline void TraceCallEnd(uint32_t) {}
+
+#endif  // PW_RPC_TRACE_CALLS
+
+}  // namespace pw::rpc::internal
@@ -19,21 +19,52 @@
 
 #if PW_RPC_USE_GLOBAL_MUTEX
 
-#include "pw_sync/mutex.h"  // nogncheck
+#include "pw_metric/metric.h"  // nogncheck
+#include "pw_sync/mutex.h"     // nogncheck
 
 #endif  // PW_RPC_USE_GLOBAL_MUTEX
 
 namespace pw::rpc::internal {
 
+// The RpcLock guards the call lists of all endpoints and the state of every
+// call. It is a leaf lock: no other lock may be acquired while it is held. In
+// particular, it is always released before
+//
+//   - invoking user callbacks, such as RPC handlers or on_next / on_error,
+//   - acquiring buffers from or sending packets to a ChannelOutput, and
+//   - encoding or copying payloads.
+//
+// Locks in ChannelOutputs or user code may therefore be held while pw_rpc
+// functions are called, and the RpcLock is only held for short bookkeeping
+// sections. Streams on different calls only contend for these sections.
 #if PW_RPC_USE_GLOBAL_MUTEX
 
 class PW_LOCKABLE("pw::rpc::internal::RpcLock") RpcLock {
  public:
-  void lock() PW_EXCLUSIVE_LOCK_FUNCTION() { mutex_.lock(); }
+  void lock() PW_EXCLUSIVE_LOCK_FUNCTION() {
+    // The counters are guarded by the mutex, so update them once it is held.
+    if (mutex_.try_lock()) {
+      acquisitions_.Increment();
+      return;
+    }
+
+    mutex_.lock();
+    acquisitions_.Increment();
+    contended_acquisitions_.Increment();
+  }
+
   void unlock() PW_UNLOCK_FUNCTION() { mutex_.unlock(); }
 
+  // Metrics for the number of times the lock was acquired, and the number of
+  // those times another thread already held it.
+  metric::Group& metrics() { return metrics_; }
+
  private:
   sync::Mutex mutex_;
+
+  PW_METRIC_GROUP(metrics_, "pw_rpc_lock");
+  PW_METRIC(metrics_, acquisitions_, "acquisitions", 0u);
+  PW_METRIC(metrics_, contended_acquisitions_, "contended_acquisitions", 0u);
 };
 
 #else
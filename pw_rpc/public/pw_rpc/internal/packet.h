@@ -20,6 +20,7 @@
 #include "pw_bytes/span.h"
 #include "pw_rpc/internal/packet.pwpb.h"
 #include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
 
 namespace pw::rpc::internal {
 
@@ -84,18 +85,41 @@ class Packet {
         service_id_(service_id),
         method_id_(method_id),
         call_id_(call_id),
+        timeout_ms_(0),
+        credits_(0),
         payload_(payload),
         status_(status) {}
 
   // Encodes the packet into its wire format. Returns the encoded size.
   Result<ConstByteSpan> Encode(ByteSpan buffer) const;
 
+  // Returns the part of the buffer in which to build a payload that
+  // EncodeInPlace() can send without copying it. The payload field is encoded
+  // first: its key, then a length varint sized for the largest payload that
+  // fits, then the payload. The other fields follow the payload. Returns an
+  // empty span if the buffer is smaller than MinEncodedSizeBytes().
+  ByteSpan PayloadBuffer(ByteSpan buffer) const;
+
+  // Returns the size of PayloadBuffer() for a buffer of buffer_size bytes.
+  size_t MaxPayloadSizeBytes(size_t buffer_size) const;
+
+  // Encodes a packet whose payload is at the start of PayloadBuffer(buffer).
+  // The payload is left where it is; only the other bytes of the packet are
+  // written around it. If the payload is shorter than the largest that fits,
+  // its length is padded to the reserved size, which protobuf decoders accept.
+  Result<ConstByteSpan> EncodeInPlace(ByteSpan buffer) const;
+
+  // Encodes the packet directly to a stream::Writer. The payload is written
+  // from wherever it is stored, without copying it into an encode buffer.
+  Status Encode(stream::Writer& writer) const;
+
   // Determines the space required to encode the packet proto fields for a
   // response, excluding the payload. This may be used to split the buffer into
   // reserved space and available space for the payload.
   //
   // This method allocates two bytes for the status. Status code 0 (OK) is not
-  // encoded since 0 is the default value.
+  // encoded since 0 is the default value. The call ID, timeout, and credits
+  // are included if they are set.
   size_t MinEncodedSizeBytes() const;
 
   enum Destination : bool { kServer, kClient };
@@ -109,6 +133,8 @@ class Packet {
   constexpr uint32_t service_id() const { return service_id_; }
   constexpr uint32_t method_id() const { return method_id_; }
   constexpr uint32_t call_id() const { return call_id_; }
+  constexpr uint32_t timeout_ms() const { return timeout_ms_; }
+  constexpr uint32_t credits() const { return credits_; }
   constexpr const ConstByteSpan& payload() const { return payload_; }
   constexpr const Status& status() const { return status_; }
 
@@ -121,15 +147,24 @@ class Packet {
   }
   constexpr void set_method_id(uint32_t method_id) { method_id_ = method_id; }
   constexpr void set_call_id(uint32_t call_id) { call_id_ = call_id; }
+  constexpr void set_timeout_ms(uint32_t timeout_ms) {
+    timeout_ms_ = timeout_ms;
+  }
+  constexpr void set_credits(uint32_t credits) { credits_ = credits; }
   constexpr void set_payload(ConstByteSpan payload) { payload_ = payload; }
   constexpr void set_status(Status status) { status_ = status; }
 
  private:
+  template <typename Encoder>
+  void EncodeFields(Encoder& rpc_packet) const;
+
   PacketType type_;
   uint32_t channel_id_;
   uint32_t service_id_;
   uint32_t method_id_;
   uint32_t call_id_;
+  uint32_t timeout_ms_;
+  uint32_t credits_;
   ConstByteSpan payload_;
   Status status_;
 };
@@ -0,0 +1,64 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_rpc/internal/packet.pwpb.h"
+#include "pw_status/status.h"
+
+namespace pw::rpc::internal {
+
+inline constexpr uint32_t kPacketBatchField =
+    static_cast<uint32_t>(RpcPacketBatch::Fields::PACKETS);
+
+// Returns true if the data is an RpcPacketBatch rather than a single packet.
+// RpcPacket reserves the batch's field number, so only the first field needs
+// to be checked.
+inline bool IsPacketBatch(ConstByteSpan data) {
+  protobuf::Decoder decoder(data);
+  return decoder.Next().ok() && decoder.FieldNumber() == kPacketBatchField;
+}
+
+// Calls process, a function that takes a ConstByteSpan and returns a Status,
+// for each packet in an RpcPacketBatch.
+//
+// Returns DATA_LOSS if the batch is malformed or contains a nested batch;
+// the other packets are still processed, up to any malformed data. Otherwise,
+// returns the first error returned by process, or OK.
+template <typename Function>
+Status ForEachPacketInBatch(ConstByteSpan batch, Function&& process) {
+  protobuf::Decoder decoder(batch);
+  Status result = OkStatus();
+  Status status;
+
+  while ((status = decoder.Next()).ok()) {
+    ConstByteSpan packet;
+    if (decoder.FieldNumber() != kPacketBatchField ||
+        !decoder.ReadBytes(&packet).ok()) {
+      return Status::DataLoss();
+    }
+    if (IsPacketBatch(packet)) {
+      result.Update(Status::DataLoss());
+      continue;
+    }
+    result.Update(process(packet));
+  }
+
+  return status.IsOutOfRange() ? result : Status::DataLoss();
+}
+
+}  // namespace pw::rpc::internal
@@ -35,6 +35,10 @@ class ServerCall : public Call {
 #endif  // PW_RPC_CLIENT_STREAM_END_CALLBACK
   }
 
+  // Adds flow control credits granted by a CLIENT_CREDIT packet. Credits are
+  // ignored if the call is not flow controlled.
+  void HandleCredits(uint32_t credits) PW_UNLOCK_FUNCTION(rpc_lock());
+
  protected:
   constexpr ServerCall() = default;
 
@@ -73,11 +77,32 @@ class ServerCall : public Call {
 #endif  // PW_RPC_CLIENT_STREAM_END_CALLBACK
   }
 
+  // set_on_writable is templated so that it can be conditionally disabled with
+  // a helpful static_assert message.
+  template <typename UnusedType = void>
+  void set_on_writable([[maybe_unused]] Function<void()>&& on_writable) {
+    static_assert(
+        cfg::kOnWritableCallbackEnabled<UnusedType>,
+        "The on writable callback is disabled, so set_on_writable cannot be "
+        "called. To enable the on writable callback, set "
+        "PW_RPC_ON_WRITABLE_CALLBACK to 1.");
+#if PW_RPC_ON_WRITABLE_CALLBACK
+    std::lock_guard lock(rpc_lock());
+    on_writable_ = std::move(on_writable);
+#endif  // PW_RPC_ON_WRITABLE_CALLBACK
+  }
+
  private:
 #if PW_RPC_CLIENT_STREAM_END_CALLBACK
   // Called when a client stream completes.
   Function<void()> on_client_stream_end_;
 #endif  // PW_RPC_CLIENT_STREAM_END_CALLBACK
+
+#if PW_RPC_ON_WRITABLE_CALLBACK
+  // Called when a flow controlled server stream that ran out of credits is
+  // granted more.
+  Function<void()> on_writable_;
+#endif  // PW_RPC_ON_WRITABLE_CALLBACK
 };
 
 }  // namespace pw::rpc::internal
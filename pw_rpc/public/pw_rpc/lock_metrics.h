@@ -0,0 +1,32 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_rpc/internal/config.h"
+
+#if PW_RPC_USE_GLOBAL_MUTEX
+
+#include "pw_metric/metric.h"  // nogncheck
+
+namespace pw::rpc {
+
+// Returns the metrics for pw_rpc's lock, which count how many times the lock
+// was acquired and how many of those acquisitions had to wait for another
+// thread. Add this group to a parent group to report it, for example through
+// the pw_metric RPC service.
+metric::Group& LockMetrics();
+
+}  // namespace pw::rpc
+
+#endif  // PW_RPC_USE_GLOBAL_MUTEX
@@ -0,0 +1,136 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_rpc/channel.h"
+#include "pw_status/status.h"
+#include "pw_sync/counting_semaphore.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::rpc {
+
+// A ChannelOutput that manages a pool of packet buffers, so that packets can
+// be encoded while earlier packets are transmitted. A single-buffer output,
+// such as one wrapped in a SynchronizedChannelOutput, holds its buffer until
+// the packet is sent, so each sender waits for the previous packet to finish
+// transmitting before it can encode the next one.
+//
+// AcquireBuffer() takes a free buffer from the pool, blocking until one is
+// available. SendAndReleaseBuffer() queues the packet and returns without
+// waiting for it to be sent. A transmit thread calls TransmitNext() or
+// TransmitPending(), which send queued packets in the order they were queued
+// with Transmit() and then return their buffers to the pool.
+//
+// Packets are only sent by TransmitNext() and TransmitPending(), so these must
+// run on a different thread than the code that sends RPC packets. Otherwise,
+// sending more packets than there are buffers blocks forever.
+//
+// Use PipelinedChannelOutputWithBuffers to allocate the buffers.
+class PipelinedChannelOutput : public ChannelOutput {
+ public:
+  PipelinedChannelOutput(const PipelinedChannelOutput&) = delete;
+  PipelinedChannelOutput& operator=(const PipelinedChannelOutput&) = delete;
+
+  std::span<std::byte> AcquireBuffer() final PW_LOCKS_EXCLUDED(mutex_);
+
+  // Queues the packet for transmission, or releases the buffer if the packet
+  // is empty. Always returns OK; errors from Transmit() are counted in
+  // transmit_errors().
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) final
+      PW_LOCKS_EXCLUDED(mutex_);
+
+  // Blocks until a packet is queued, then transmits it.
+  void TransmitNext() PW_LOCKS_EXCLUDED(mutex_);
+
+  // Transmits queued packets until none remain. Returns the number of packets
+  // transmitted. Does not block if no packets are queued.
+  size_t TransmitPending() PW_LOCKS_EXCLUDED(mutex_);
+
+  // The number of packets waiting to be transmitted.
+  size_t queued_packets() const PW_LOCKS_EXCLUDED(mutex_);
+
+  // The number of times Transmit() returned an error.
+  size_t transmit_errors() const PW_LOCKS_EXCLUDED(mutex_);
+
+  size_t buffer_size() const { return buffer_size_; }
+  size_t buffer_count() const { return buffers_.size(); }
+
+ protected:
+  struct Buffer {
+    std::byte* data;
+    size_t size;
+    bool in_use;
+  };
+
+  PipelinedChannelOutput(const char* name,
+                         std::span<Buffer> buffers,
+                         std::span<Buffer*> queue,
+                         size_t buffer_size);
+
+ private:
+  // Sends one packet to the transport. Called without any locks held, so the
+  // transport may block until the packet is sent.
+  virtual Status Transmit(ConstByteSpan packet) = 0;
+
+  // Transmits the oldest queued packet. The caller must have acquired it from
+  // queued_.
+  void TransmitQueued() PW_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the in-use buffer that contains data, or nullptr if there is none.
+  Buffer* FindBuffer(const std::byte* data) PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t buffer_size_;
+
+  // Counts free buffers and queued packets, respectively.
+  sync::CountingSemaphore free_;
+  sync::CountingSemaphore queued_;
+
+  mutable sync::Mutex mutex_;
+  std::span<Buffer> buffers_ PW_GUARDED_BY(mutex_);
+
+  // Ring of queued packets, oldest first. There is a slot for every buffer, so
+  // the ring cannot overflow.
+  std::span<Buffer*> queue_ PW_GUARDED_BY(mutex_);
+  size_t queue_head_ PW_GUARDED_BY(mutex_);
+  size_t queue_size_ PW_GUARDED_BY(mutex_);
+  size_t transmit_errors_ PW_GUARDED_BY(mutex_);
+};
+
+// Allocates kBufferCount buffers of kBufferSizeBytes each. Each buffer must be
+// large enough for the largest RPC packet sent on the channel.
+template <size_t kBufferSizeBytes, size_t kBufferCount>
+class PipelinedChannelOutputWithBuffers : public PipelinedChannelOutput {
+ public:
+  static_assert(kBufferSizeBytes > 0u && kBufferCount > 0u);
+
+  PipelinedChannelOutputWithBuffers(const char* name)
+      : PipelinedChannelOutput(name, buffers_, queue_, kBufferSizeBytes) {
+    for (size_t i = 0; i < kBufferCount; ++i) {
+      buffers_[i] = {storage_[i].data(), 0, false};
+    }
+  }
+
+ private:
+  std::array<Buffer, kBufferCount> buffers_;
+  std::array<Buffer*, kBufferCount> queue_;
+  std::array<std::array<std::byte, kBufferSizeBytes>, kBufferCount> storage_;
+};
+
+}  // namespace pw::rpc
@@ -18,6 +18,7 @@
 #include <tuple>
 
 #include "pw_containers/intrusive_list.h"
+#include "pw_rpc/admission_control.h"
 #include "pw_rpc/channel.h"
 #include "pw_rpc/internal/channel.h"
 #include "pw_rpc/internal/endpoint.h"
@@ -30,11 +31,15 @@ namespace pw::rpc {
 
 class Server : public internal::Endpoint {
  public:
-  constexpr Server(std::span<Channel> channels) : Endpoint(channels) {}
+  constexpr Server(std::span<Channel> channels)
+      : Endpoint(channels), admission_control_(nullptr) {}
 
   // Registers a service with the server. This should not be called directly
   // with a Service; instead, use a generated class which inherits from it.
-  void RegisterService(Service& service) { services_.push_front(service); }
+  //
+  // Services are kept sorted by ID, so registration takes time proportional to
+  // the number of registered services.
+  void RegisterService(Service& service);
 
   // Processes an RPC packet. The packet may contain an RPC request or a control
   // packet, the result of which is processed in this function. Returns whether
@@ -44,13 +49,41 @@ class Server : public internal::Endpoint {
   //   DATA_LOSS - Failed to decode the packet.
   //   INVALID_ARGUMENT - The packet is intended for a client, not a server.
   //
+  // The packet may also be an RpcPacketBatch, in which case each packet in it
+  // is processed. A batch returns DATA_LOSS if it is malformed, and otherwise
+  // the first error from its packets.
+  //
   Status ProcessPacket(std::span<const std::byte> packet_data,
                        ChannelOutput& interface)
+      PW_LOCKS_EXCLUDED(internal::rpc_lock()) {
+    return ProcessPacket(packet_data, interface, 0);
+  }
+
+  // Processes a packet that was received queued_ms milliseconds ago, such as a
+  // packet that waited in a queue. A REQUEST whose timeout has elapsed is
+  // rejected with a DEADLINE_EXCEEDED SERVER_ERROR, and its handler is not
+  // invoked, since the client has likely given up on it. Returns the same
+  // statuses as ProcessPacket() above.
+  Status ProcessPacket(std::span<const std::byte> packet_data,
+                       ChannelOutput& interface,
+                       uint32_t queued_ms)
       PW_LOCKS_EXCLUDED(internal::rpc_lock());
 
+  // Sets the AdmissionControl that decides whether to start each call, or
+  // nullptr to start all calls. This must be set before packets are processed;
+  // it is not thread safe.
+  void set_admission_control(AdmissionControl* admission_control) {
+    admission_control_ = admission_control;
+  }
+
  private:
   friend class internal::Call;
 
+  Status ProcessSinglePacket(std::span<const std::byte> packet_data,
+                             ChannelOutput& interface,
+                             uint32_t queued_ms)
+      PW_LOCKS_EXCLUDED(internal::rpc_lock());
+
   std::tuple<Service*, const internal::Method*> FindMethod(
       const internal::Packet& packet);
 
@@ -59,7 +92,14 @@ class Server : public internal::Endpoint {
                                 internal::ServerCall* call) const
       PW_UNLOCK_FUNCTION(internal::rpc_lock());
 
-  IntrusiveList<Service> services_;
+  // Checks whether a REQUEST may start a call. Returns OK or the status with
+  // which to reject it.
+  Status AdmitRequest(const internal::Packet& packet,
+                      uint32_t queued_ms,
+                      uint32_t ongoing_service_calls);
+
+  IntrusiveList<Service> services_;  // Sorted by service ID.
+  AdmissionControl* admission_control_;
 };
 
 }  // namespace pw::rpc
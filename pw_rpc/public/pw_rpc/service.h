@@ -23,6 +23,13 @@
 #include "pw_rpc/internal/method_union.h"
 
 namespace pw::rpc {
+namespace internal {
+
+// Whether a service's method table is sorted by method ID. Generated services
+// sort their methods so that they can be found with a binary search.
+enum class MethodOrder : bool { kUnsorted, kSortedById };
+
+}  // namespace internal
 
 // Base class for all RPC services. This cannot be instantiated directly; use a
 // generated subclass instead.
@@ -42,11 +49,15 @@ class Service : public IntrusiveList<Service>::Item {
 
  protected:
   template <typename T, size_t kMethodCount>
-  constexpr Service(uint32_t id, const std::array<T, kMethodCount>& methods)
+  constexpr Service(
+      uint32_t id,
+      const std::array<T, kMethodCount>& methods,
+      internal::MethodOrder order = internal::MethodOrder::kUnsorted)
       : id_(id),
         methods_(methods.data()),
         method_size_(sizeof(T)),
-        method_count_(static_cast<uint16_t>(kMethodCount)) {
+        method_count_(static_cast<uint16_t>(kMethodCount)),
+        sorted_by_id_(order == internal::MethodOrder::kSortedById) {
     PW_MODIFY_DIAGNOSTICS_PUSH();
     // GCC 10 emits spurious -Wtype-limits warnings for the static_assert.
     PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wtype-limits");
@@ -57,7 +68,11 @@ class Service : public IntrusiveList<Service>::Item {
   // For use by tests with only one method.
   template <typename T>
   constexpr Service(uint32_t id, const T& method)
-      : id_(id), methods_(&method), method_size_(sizeof(T)), method_count_(1) {}
+      : id_(id),
+        methods_(&method),
+        method_size_(sizeof(T)),
+        method_count_(1),
+        sorted_by_id_(true) {}
 
  private:
   friend class Server;
@@ -66,10 +81,13 @@ class Service : public IntrusiveList<Service>::Item {
   // Finds the method with the provided method_id. Returns nullptr if no match.
   const internal::Method* FindMethod(uint32_t method_id) const;
 
+  const internal::Method& MethodAt(size_t index) const;
+
   const uint32_t id_;
   const internal::MethodUnion* const methods_;
   const uint16_t method_size_;
   const uint16_t method_count_;
+  const bool sorted_by_id_;
 };
 
 }  // namespace pw::rpc
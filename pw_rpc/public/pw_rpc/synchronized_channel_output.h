@@ -14,6 +14,7 @@
 #pragma once
 
 #include <algorithm>
+#include <utility>
 
 #include "pw_rpc/channel.h"
 #include "pw_sync/lock_annotations.h"
@@ -25,9 +26,14 @@ namespace pw::rpc {
 // acquire and release buffer operations. This can be used to allow a simple
 // ChannelOutput implementation to run in multi-threaded contexts. More complex
 // implementations may want to roll their own synchronization.
+//
+// pw_rpc does not hold its own lock while it encodes or sends packets, so
+// outputs that do not share a mutex send packets in parallel. Use a separate
+// mutex for each transport, such as with SynchronizedChannelOutputWithMutex,
+// unless the outputs share a buffer or device.
 template <typename BaseChannelOutput>
 class PW_LOCKABLE("pw::rpc::SynchronizedChannelOutput")
-    SynchronizedChannelOutput final : public BaseChannelOutput {
+    SynchronizedChannelOutput : public BaseChannelOutput {
  public:
   template <typename... Args>
   constexpr SynchronizedChannelOutput(sync::Mutex& mutex, Args&&... args)
@@ -49,4 +55,28 @@ class PW_LOCKABLE("pw::rpc::SynchronizedChannelOutput")
   sync::Mutex& mutex_;
 };
 
+namespace internal {
+
+// Holds the mutex for SynchronizedChannelOutputWithMutex. This is a separate
+// base class so that the mutex is constructed before the output that uses it.
+class ChannelOutputMutex {
+ protected:
+  sync::Mutex output_mutex_;
+};
+
+}  // namespace internal
+
+// SynchronizedChannelOutput with its own mutex. Each output is locked
+// separately, so threads sending on different outputs do not block each other.
+template <typename BaseChannelOutput>
+class SynchronizedChannelOutputWithMutex final
+    : private internal::ChannelOutputMutex,
+      public SynchronizedChannelOutput<BaseChannelOutput> {
+ public:
+  template <typename... Args>
+  SynchronizedChannelOutputWithMutex(Args&&... args)
+      : SynchronizedChannelOutput<BaseChannelOutput>(
+            output_mutex_, std::forward<Args>(args)...) {}
+};
+
 }  // namespace pw::rpc
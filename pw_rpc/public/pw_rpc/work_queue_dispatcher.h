@@ -0,0 +1,175 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/server.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_work_queue/work_queue.h"
+
+namespace pw::rpc {
+
+class WorkQueueDispatcher;
+
+// Routes packets for a channel, or for one service on a channel, to a
+// work_queue::WorkQueue. Packets are copied into buffers owned by the
+// DispatchQueue, so the caller's packet buffer may be reused as soon as
+// WorkQueueDispatcher::ProcessPacket returns.
+//
+// Packets routed to the same DispatchQueue are processed in the order they
+// were received. The time each packet waits in the queue counts against its
+// REQUEST timeout, so requests that expired while queued are rejected with
+// DEADLINE_EXCEEDED rather than processed. Use DispatchQueueWithBuffer to
+// allocate the packet buffers.
+class DispatchQueue : public IntrusiveList<DispatchQueue>::Item {
+ public:
+  // Matches packets for all services on the channel.
+  static constexpr uint32_t kAnyService = 0;
+
+  DispatchQueue(const DispatchQueue&) = delete;
+  DispatchQueue& operator=(const DispatchQueue&) = delete;
+
+  uint32_t channel_id() const { return channel_id_; }
+  uint32_t service_id() const { return service_id_; }
+
+  // The largest packet this queue can hold.
+  size_t max_packet_size() const { return max_packet_size_; }
+
+ protected:
+  // A packet waiting to be processed on the work queue.
+  struct PendingPacket {
+    DispatchQueue* queue;
+    ChannelOutput* output;
+    std::byte* data;
+    size_t size;
+    chrono::SystemClock::time_point received;
+    bool in_use;
+  };
+
+  DispatchQueue(work_queue::WorkQueue& work_queue,
+                uint32_t channel_id,
+                uint32_t service_id,
+                std::span<PendingPacket> packets,
+                size_t max_packet_size)
+      : work_queue_(work_queue),
+        channel_id_(channel_id),
+        service_id_(service_id),
+        max_packet_size_(max_packet_size),
+        packets_(packets),
+        server_(nullptr) {}
+
+ private:
+  friend class WorkQueueDispatcher;
+
+  bool Matches(uint32_t channel_id, uint32_t service_id) const {
+    return channel_id == channel_id_ &&
+           (service_id_ == kAnyService || service_id == service_id_);
+  }
+
+  // Copies the packet into a free buffer and schedules it on the work queue.
+  Status Enqueue(std::span<const std::byte> packet_data, ChannelOutput& output)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Runs on the work queue thread.
+  static void ProcessPending(PendingPacket& packet) PW_LOCKS_EXCLUDED(lock_);
+
+  work_queue::WorkQueue& work_queue_;
+  const uint32_t channel_id_;
+  const uint32_t service_id_;
+  const size_t max_packet_size_;
+
+  sync::InterruptSpinLock lock_;
+  std::span<PendingPacket> packets_ PW_GUARDED_BY(lock_);
+
+  // Set when the queue is added to a WorkQueueDispatcher.
+  Server* server_;
+};
+
+// Allocates buffers for up to kMaxPendingPackets packets of up to
+// kMaxPacketSizeBytes each.
+template <size_t kMaxPacketSizeBytes, size_t kMaxPendingPackets>
+class DispatchQueueWithBuffer : public DispatchQueue {
+ public:
+  static_assert(kMaxPacketSizeBytes > 0u && kMaxPendingPackets > 0u);
+
+  DispatchQueueWithBuffer(work_queue::WorkQueue& work_queue,
+                          uint32_t channel_id,
+                          uint32_t service_id = kAnyService)
+      : DispatchQueue(work_queue,
+                      channel_id,
+                      service_id,
+                      pending_,
+                      kMaxPacketSizeBytes) {
+    for (size_t i = 0; i < kMaxPendingPackets; ++i) {
+      pending_[i] = {this, nullptr, buffers_[i].data(), 0, {}, false};
+    }
+  }
+
+ private:
+  std::array<PendingPacket, kMaxPendingPackets> pending_;
+  std::array<std::array<std::byte, kMaxPacketSizeBytes>, kMaxPendingPackets>
+      buffers_;
+};
+
+// Processes server packets on work queues rather than on the thread that
+// receives them. A slow RPC handler on one channel then only delays packets
+// that were routed to the same work queue. Each work queue's thread must be
+// running for its packets to be processed.
+//
+// Packets for a channel and service with no DispatchQueue are processed
+// immediately on the calling thread, as with Server::ProcessPacket.
+//
+// Handlers may run concurrently on different work queues, so the server must
+// be built with PW_RPC_USE_GLOBAL_MUTEX enabled if more than one thread
+// processes packets.
+class WorkQueueDispatcher {
+ public:
+  constexpr WorkQueueDispatcher(Server& server) : server_(server) {}
+
+  // Adds a queue to the dispatcher. Queues with a service ID take priority
+  // over queues for all services on the same channel. Queues must be added
+  // before packets are processed; this function is not thread safe.
+  void AddQueue(DispatchQueue& queue);
+
+  // Decodes the packet's header and routes it to its DispatchQueue or, if
+  // there is none, processes it on the calling thread. Returns:
+  //
+  //   OK - The packet was queued or processed by the server.
+  //   DATA_LOSS - Failed to decode the packet.
+  //   INVALID_ARGUMENT - The packet is intended for a client, not a server.
+  //   RESOURCE_EXHAUSTED - The DispatchQueue has no free buffers, or its work
+  //       queue is full; the packet was dropped.
+  //   OUT_OF_RANGE - The packet is larger than the DispatchQueue's buffers.
+  //   FAILED_PRECONDITION - The DispatchQueue's work queue is stopping.
+  //
+  Status ProcessPacket(std::span<const std::byte> packet_data,
+                       ChannelOutput& interface);
+
+ private:
+  DispatchQueue* FindQueue(uint32_t channel_id, uint32_t service_id);
+
+  Server& server_;
+  IntrusiveList<DispatchQueue> queues_;
+};
+
+}  // namespace pw::rpc
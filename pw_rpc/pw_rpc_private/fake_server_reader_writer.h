@@ -30,8 +30,8 @@ namespace pw::rpc::internal::test {
 // readers and writers inherit from it, but hide the unsupported functionality.
 // A ReaderWriter defines conversions to Reader and Writer, so it acts as if it
 // inherited from both. This approach is unusual but necessary to have all
-// classes use a single IntrusiveList::Item base and to avoid virtual methods or
-// virtual inheritance.
+// classes use a single IntrusiveDList::Item base and to avoid virtual methods
+// or virtual inheritance.
 //
 // Call's public API is intended for rpc::Server, so hide the public methods
 // with private inheritance.
@@ -52,11 +52,13 @@ class FakeServerReaderWriter : private internal::ServerCall {
   using Call::set_on_error;
   using Call::set_on_next;
   using ServerCall::set_on_client_stream_end;
+  using ServerCall::set_on_writable;
 
   Status Finish(Status status = OkStatus()) {
     return CloseAndSendResponse(status);
   }
 
+  using Call::available_credits;
   using Call::Write;
 
   // Expose a few additional methods for test use.
@@ -76,7 +78,9 @@ class FakeServerWriter : private FakeServerReaderWriter {
   // Common reader/writer functions.
   using FakeServerReaderWriter::active;
   using FakeServerReaderWriter::Finish;
+  using FakeServerReaderWriter::available_credits;
   using FakeServerReaderWriter::set_on_error;
+  using FakeServerReaderWriter::set_on_writable;
   using FakeServerReaderWriter::Write;
 
   // Functions for test use.
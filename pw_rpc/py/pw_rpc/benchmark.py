@@ -0,0 +1,270 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Runs throughput and latency benchmarks against the pw.rpc.Benchmark service.
+
+The benchmarks only need a pw_rpc client using callback_client.Impl, so they
+run over any transport. Concurrent benchmarks run one call per channel, since
+the server only keeps one call per channel and method active at a time.
+
+.. code-block:: python
+
+  from pw_rpc import benchmark
+
+  bench = benchmark.Benchmark.from_client(client, channel_ids=[1, 2])
+  result = bench.unary_echo(payload_size=64, iterations=1000, concurrency=2)
+  print(result.summary())
+"""
+
+import dataclasses
+import math
+from concurrent.futures import ThreadPoolExecutor
+import time
+from typing import Any, Callable, Dict, Iterable, List, Sequence
+
+from pw_status import Status
+
+import pw_rpc
+from pw_rpc.callback_client import RpcError, RpcTimeout
+
+DEFAULT_TIMEOUT_S = 5.0
+
+
+def percentile(values: Sequence[float], percent: float) -> float:
+    """Returns the nearest-rank percentile of sorted values; 0 if empty."""
+    if not values:
+        return 0.0
+
+    rank = math.ceil(percent / 100 * len(values))
+    return values[min(max(rank, 1), len(values)) - 1]
+
+
+@dataclasses.dataclass
+class BenchmarkResult:
+    """Measurements from one benchmark run.
+
+    Latencies are round trip times for the echo benchmarks, and the times
+    between consecutive payloads for the streaming benchmarks. Packets and
+    payload bytes count payload-carrying packets in both directions.
+    """
+    name: str
+    payload_size: int
+    concurrency: int = 1
+    duration_s: float = 0.0
+    packets: int = 0
+    payload_bytes: int = 0
+    failures: int = 0
+    latencies_s: List[float] = dataclasses.field(default_factory=list)
+
+    def add(self, other: 'BenchmarkResult') -> None:
+        """Adds the counts and latencies from another run to this one."""
+        self.packets += other.packets
+        self.payload_bytes += other.payload_bytes
+        self.failures += other.failures
+        self.latencies_s += other.latencies_s
+
+    def percentile_s(self, percent: float) -> float:
+        return percentile(sorted(self.latencies_s), percent)
+
+    def packets_per_second(self) -> float:
+        return self.packets / self.duration_s if self.duration_s else 0.0
+
+    def bytes_per_second(self) -> float:
+        return self.payload_bytes / self.duration_s if self.duration_s else 0.0
+
+    def summary(self) -> Dict[str, Any]:
+        """Returns the result as a JSON-serializable dict."""
+        latencies = sorted(self.latencies_s)
+        return {
+            'name': self.name,
+            'payload_size': self.payload_size,
+            'concurrency': self.concurrency,
+            'duration_s': round(self.duration_s, 6),
+            'packets': self.packets,
+            'payload_bytes': self.payload_bytes,
+            'failures': self.failures,
+            'packets_per_second': round(self.packets_per_second(), 3),
+            'bytes_per_second': round(self.bytes_per_second(), 3),
+            'latency_us': {
+                f'p{p}': round(percentile(latencies, p) * 1e6, 3)
+                for p in (50, 90, 99, 100)
+            },
+        }
+
+
+def _payload(size: int, index: int) -> bytes:
+    return bytes((index + i) % 256 for i in range(size))
+
+
+class Benchmark:
+    """Runs benchmarks with pw.rpc.Benchmark service clients."""
+    def __init__(self,
+                 services: Iterable[Any],
+                 timeout_s: float = DEFAULT_TIMEOUT_S):
+        """Creates a benchmark runner.
+
+        Args:
+          services: pw.rpc.Benchmark service clients, each on its own channel;
+              e.g. client.channel(1).rpcs.pw.rpc.Benchmark
+          timeout_s: how long to wait for each response
+        """
+        self._services = list(services)
+        self._timeout_s = timeout_s
+
+        if not self._services:
+            raise ValueError('At least one Benchmark service is required')
+
+    @classmethod
+    def from_client(cls,
+                    client: pw_rpc.Client,
+                    channel_ids: Iterable[int] = None,
+                    timeout_s: float = DEFAULT_TIMEOUT_S) -> 'Benchmark':
+        """Creates a runner using the given channels, or all channels."""
+        if channel_ids is None:
+            channels = list(client.channels())
+        else:
+            channels = [client.channel(i) for i in channel_ids]
+
+        return cls((c.rpcs.pw.rpc.Benchmark for c in channels), timeout_s)
+
+    def unary_echo(self,
+                   payload_size: int,
+                   iterations: int,
+                   concurrency: int = 1) -> BenchmarkResult:
+        """Calls UnaryEcho repeatedly and measures the round trip time."""
+        def run(service: Any, result: BenchmarkResult) -> None:
+            for i in range(iterations):
+                payload = _payload(payload_size, i)
+                start = time.perf_counter()
+                status, reply = service.UnaryEcho(
+                    payload=payload, pw_rpc_timeout_s=self._timeout_s)
+                elapsed = time.perf_counter() - start
+
+                if status is not Status.OK or reply.payload != payload:
+                    result.failures += 1
+                    continue
+
+                result.latencies_s.append(elapsed)
+                result.packets += 2
+                result.payload_bytes += 2 * payload_size
+
+        return self._run('unary_echo', payload_size, concurrency, run)
+
+    def bidirectional_echo(self,
+                           payload_size: int,
+                           iterations: int,
+                           concurrency: int = 1) -> BenchmarkResult:
+        """Echoes payloads in one BidirectionalEcho call per channel."""
+        def run(service: Any, result: BenchmarkResult) -> None:
+            with service.BidirectionalEcho.invoke() as call:
+                responses = call.get_responses(timeout_s=self._timeout_s)
+
+                for i in range(iterations):
+                    payload = _payload(payload_size, i)
+                    start = time.perf_counter()
+                    call.send(payload=payload)
+                    reply = next(responses)
+                    elapsed = time.perf_counter() - start
+
+                    if reply.payload != payload:
+                        result.failures += 1
+                        continue
+
+                    result.latencies_s.append(elapsed)
+                    result.packets += 2
+                    result.payload_bytes += 2 * payload_size
+
+        return self._run('bidirectional_echo', payload_size, concurrency, run)
+
+    def server_stream(self,
+                      payload_size: int,
+                      count: int,
+                      concurrency: int = 1) -> BenchmarkResult:
+        """Requests count payloads from ServerStream on each channel."""
+        def run(service: Any, result: BenchmarkResult) -> None:
+            call = service.ServerStream.invoke(
+                request_args=dict(payload_size=payload_size, count=count),
+                timeout_s=self._timeout_s)
+
+            last = time.perf_counter()
+            for reply in call.get_responses(timeout_s=self._timeout_s):
+                now = time.perf_counter()
+                result.latencies_s.append(now - last)
+                last = now
+
+                result.packets += 1
+                result.payload_bytes += len(reply.payload)
+
+            if call.status is not Status.OK:
+                result.failures += 1
+            result.failures += max(count - len(call.responses), 0)
+
+        return self._run('server_stream', payload_size, concurrency, run)
+
+    def client_stream(self,
+                      payload_size: int,
+                      count: int,
+                      concurrency: int = 1) -> BenchmarkResult:
+        """Sends count payloads to ClientStream on each channel.
+
+        The latency is the time to send each payload, which includes encoding
+        and writing it to the transport.
+        """
+        def run(service: Any, result: BenchmarkResult) -> None:
+            call = service.ClientStream.invoke(timeout_s=self._timeout_s)
+
+            for i in range(count):
+                payload = _payload(payload_size, i)
+                start = time.perf_counter()
+                call.send(payload=payload)
+                result.latencies_s.append(time.perf_counter() - start)
+
+            # An empty payload asks the server to respond with its totals.
+            status, stats = call.finish_and_wait([call.method.request_type()],
+                                                 timeout_s=self._timeout_s)
+
+            if status is not Status.OK or stats.payload_count != count:
+                result.failures += 1
+                return
+
+            result.packets += stats.payload_count + 1
+            result.payload_bytes += stats.payload_bytes
+
+        return self._run('client_stream', payload_size, concurrency, run)
+
+    def _run(self, name: str, payload_size: int, concurrency: int,
+             function: Callable[[Any, BenchmarkResult], None]
+             ) -> BenchmarkResult:
+        if not 1 <= concurrency <= len(self._services):
+            raise ValueError(
+                f'Concurrency must be from 1 to the number of channels '
+                f'({len(self._services)}), not {concurrency}')
+
+        def run_one(service: Any) -> BenchmarkResult:
+            result = BenchmarkResult(name, payload_size)
+            try:
+                function(service, result)
+            except (RpcError, RpcTimeout):
+                result.failures += 1
+            return result
+
+        total = BenchmarkResult(name, payload_size, concurrency)
+        start = time.perf_counter()
+
+        with ThreadPoolExecutor(max_workers=concurrency) as executor:
+            for result in executor.map(run_one,
+                                       self._services[:concurrency]):
+                total.add(result)
+
+        total.duration_s = time.perf_counter() - start
+        return total
@@ -17,14 +17,15 @@ import abc
 from dataclasses import dataclass
 import logging
 from typing import (Any, Collection, Dict, Iterable, Iterator, NamedTuple,
-                    Optional)
+                    Optional, Tuple)
 
 from google.protobuf.message import DecodeError, Message
 from pw_status import Status
 
 from pw_rpc import descriptors, packets
 from pw_rpc.descriptors import Channel, Service, Method
-from pw_rpc.internal.packet_pb2 import PacketType, RpcPacket
+from pw_rpc.internal.packet_pb2 import PacketType
+from pw_rpc.packets import Packet
 
 _LOG = logging.getLogger(__package__)
 
@@ -39,6 +40,11 @@ class PendingRpc(NamedTuple):
     service: Service
     method: Method
 
+    @property
+    def ids(self) -> Tuple[int, int, int]:
+        """The channel, service, and method IDs, which identify the RPC."""
+        return self.channel.id, self.service.id, self.method.id
+
     def __str__(self) -> str:
         return f'PendingRpc(channel={self.channel.id}, method={self.method})'
 
@@ -51,7 +57,9 @@ class _PendingRpcMetadata:
 class PendingRpcs:
     """Tracks pending RPCs and encodes outgoing RPC packets."""
     def __init__(self):
-        self._pending: Dict[PendingRpc, _PendingRpcMetadata] = {}
+        # Keyed by PendingRpc.ids, since hashing a tuple of ints is much
+        # faster than hashing the Channel, Service, and Method.
+        self._pending: Dict[Tuple[int, int, int], _PendingRpcMetadata] = {}
 
     def request(self,
                 rpc: PendingRpc,
@@ -107,11 +115,11 @@ class PendingRpcs:
         metadata = _PendingRpcMetadata(context)
 
         if override_pending:
-            previous = self._pending.get(rpc)
-            self._pending[rpc] = metadata
+            previous = self._pending.get(rpc.ids)
+            self._pending[rpc.ids] = metadata
             return None if previous is None else previous.context
 
-        if self._pending.setdefault(rpc, metadata) is not metadata:
+        if self._pending.setdefault(rpc.ids, metadata) is not metadata:
             # If the context was not added, the RPC was already pending.
             raise Error(f'Sent request for {rpc}, but it is already pending! '
                         'Cancel the RPC before invoking it again')
@@ -119,7 +127,7 @@ class PendingRpcs:
         return None
 
     def send_client_stream(self, rpc: PendingRpc, message: Message) -> None:
-        if rpc not in self._pending:
+        if rpc.ids not in self._pending:
             raise Error(
                 f'Attempt to send client stream for inactive RPC {rpc}')
 
@@ -127,7 +135,7 @@ class PendingRpcs:
             packets.encode_client_stream(rpc, message))
 
     def send_client_stream_end(self, rpc: PendingRpc) -> None:
-        if rpc not in self._pending:
+        if rpc.ids not in self._pending:
             raise Error(
                 f'Attempt to send client stream end for inactive RPC {rpc}')
 
@@ -144,7 +152,7 @@ class PendingRpcs:
           KeyError if the RPC is not pending
         """
         _LOG.debug('Cancelling %s', rpc)
-        del self._pending[rpc]
+        del self._pending[rpc.ids]
 
         if rpc.method.type is Method.Type.UNARY:
             return None
@@ -166,10 +174,10 @@ class PendingRpcs:
     def get_pending(self, rpc: PendingRpc, status: Optional[Status]):
         """Gets the pending RPC's context. If status is set, clears the RPC."""
         if status is None:
-            return self._pending[rpc].context
+            return self._pending[rpc.ids].context
 
         _LOG.debug('%s finished with status %s', rpc, status)
-        return self._pending.pop(rpc).context
+        return self._pending.pop(rpc.ids).context
 
 
 class ClientImpl(abc.ABC):
@@ -357,7 +365,7 @@ class ChannelClient:
 
 
 def _update_for_backwards_compatibility(rpc: PendingRpc,
-                                        packet: RpcPacket) -> None:
+                                        packet: Packet) -> None:
     """Adapts server streaming RPC packets to the updated protocol if needed."""
     # The protocol changes only affect server streaming RPCs.
     if rpc.method.type is not Method.Type.SERVER_STREAMING:
@@ -409,6 +417,18 @@ class Client:
             for channel in channels
         }
 
+        # A flat table of every RPC this client can receive packets for, keyed
+        # by (channel ID, service ID, method ID). Incoming packets are
+        # dispatched with a single lookup in this table.
+        self._rpcs: Dict[Tuple[int, int, int], Tuple[ChannelClient,
+                                                     PendingRpc]] = {}
+
+        for channel_client in self._channels_by_id.values():
+            for service in self.services:
+                for method in service.methods:
+                    rpc = PendingRpc(channel_client.channel, service, method)
+                    self._rpcs[rpc.ids] = channel_client, rpc
+
     def channel(self, channel_id: int = None) -> ChannelClient:
         """Returns a ChannelClient, which is used to call RPCs on a channel.
 
@@ -440,12 +460,60 @@ class Client:
         for service in self.services:
             yield from service.methods
 
+    def _process_batch(self, data: bytes, *impl_args,
+                       **impl_kwargs) -> Status:
+        try:
+            batch = packets.decode_batch(data)
+        except DecodeError as err:
+            _LOG.warning('Failed to decode packet batch: %s', err)
+            return Status.DATA_LOSS
+
+        result = Status.OK
+        for packet in batch:
+            if packets.is_batch(packet):
+                _LOG.warning('Ignoring nested packet batch')
+                status = Status.DATA_LOSS
+            else:
+                status = self._process_single_packet(packet, impl_args,
+                                                     impl_kwargs)
+
+            if result is Status.OK:
+                result = status
+
+        return result
+
+    def process_packets(self, pw_rpc_raw_packets: Iterable[bytes],
+                        *impl_args, **impl_kwargs) -> Status:
+        """Processes several incoming packets, such as those from one read.
+
+        This is equivalent to calling process_packet for each packet, but
+        avoids its per-call overhead, which matters when a transport delivers
+        many small packets at once.
+
+        Returns:
+          OK if every packet was processed; otherwise, the first error from
+          process_packet
+        """
+        result = Status.OK
+        for data in pw_rpc_raw_packets:
+            if packets.is_batch(data):
+                status = self._process_batch(data, *impl_args, **impl_kwargs)
+            else:
+                status = self._process_single_packet(data, impl_args,
+                                                     impl_kwargs)
+
+            if result is Status.OK:
+                result = status
+
+        return result
+
     def process_packet(self, pw_rpc_raw_packet_data: bytes, *impl_args,
                        **impl_kwargs) -> Status:
         """Processes an incoming packet.
 
         Args:
-          pw_rpc_raw_packet_data: raw binary data for exactly one RPC packet
+          pw_rpc_raw_packet_data: raw binary data for exactly one RPC packet or
+              RpcPacketBatch
           impl_args: optional positional arguments passed to the ClientImpl
           impl_kwargs: optional keyword arguments passed to the ClientImpl
 
@@ -454,29 +522,35 @@ class Client:
           DATA_LOSS - the packet could not be decoded
           INVALID_ARGUMENT - the packet is for a server, not a client
           NOT_FOUND - the packet's channel ID is not known to this client
+
+          A batch returns DATA_LOSS if it could not be decoded, and otherwise
+          the first error from its packets.
         """
+        if packets.is_batch(pw_rpc_raw_packet_data):
+            return self._process_batch(pw_rpc_raw_packet_data, *impl_args,
+                                       **impl_kwargs)
+
+        return self._process_single_packet(pw_rpc_raw_packet_data, impl_args,
+                                           impl_kwargs)
+
+    def _process_single_packet(self, data: bytes, impl_args: tuple,
+                               impl_kwargs: dict) -> Status:
         try:
-            packet = packets.decode(pw_rpc_raw_packet_data)
+            packet = packets.decode_packet(data)
         except DecodeError as err:
             _LOG.warning('Failed to decode packet: %s', err)
-            _LOG.debug('Raw packet: %r', pw_rpc_raw_packet_data)
+            _LOG.debug('Raw packet: %r', data)
             return Status.DATA_LOSS
 
         if packets.for_server(packet):
             return Status.INVALID_ARGUMENT
 
         try:
-            channel_client = self._channels_by_id[packet.channel_id]
+            channel_client, rpc = self._rpcs[packet.channel_id,
+                                             packet.service_id,
+                                             packet.method_id]
         except KeyError:
-            _LOG.warning('Unrecognized channel ID %d', packet.channel_id)
-            return Status.NOT_FOUND
-
-        try:
-            rpc = self._look_up_service_and_method(packet, channel_client)
-        except ValueError as err:
-            _send_client_error(channel_client, packet, Status.NOT_FOUND)
-            _LOG.warning('%s', err)
-            return Status.OK
+            return self._process_unknown_rpc(packet)
 
         _update_for_backwards_compatibility(rpc, packet)
 
@@ -534,28 +608,30 @@ class Client:
 
         return Status.OK
 
-    def _look_up_service_and_method(
-            self, packet: RpcPacket,
-            channel_client: ChannelClient) -> PendingRpc:
+    def _process_unknown_rpc(self, packet: Packet) -> Status:
+        """Handles a packet that is not in the RPC table."""
         try:
-            service = self.services[packet.service_id]
+            channel_client = self._channels_by_id[packet.channel_id]
         except KeyError:
-            raise ValueError(f'Unrecognized service ID {packet.service_id}')
+            _LOG.warning('Unrecognized channel ID %d', packet.channel_id)
+            return Status.NOT_FOUND
 
-        try:
-            method = service.methods[packet.method_id]
-        except KeyError:
-            raise ValueError(
-                f'No method ID {packet.method_id} in service {service.name}')
+        _send_client_error(channel_client, packet, Status.NOT_FOUND)
+
+        if packet.service_id not in self.services:
+            _LOG.warning('Unrecognized service ID %d', packet.service_id)
+        else:
+            _LOG.warning('No method ID %d in service %s', packet.method_id,
+                         self.services[packet.service_id].name)
 
-        return PendingRpc(channel_client.channel, service, method)
+        return Status.OK
 
     def __repr__(self) -> str:
         return (f'pw_rpc.Client(channels={list(self._channels_by_id)}, '
                 f'services={[s.full_name for s in self.services]})')
 
 
-def _send_client_error(client: ChannelClient, packet: RpcPacket,
+def _send_client_error(client: ChannelClient, packet: Packet,
                        error: Status) -> None:
     # Never send responses to SERVER_ERRORs.
     if packet.type != PacketType.SERVER_ERROR:
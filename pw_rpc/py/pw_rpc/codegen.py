@@ -341,8 +341,11 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
     gen.line(' protected:')
 
     with gen.indent():
-        gen.line('constexpr Service() : '
-                 f'{base_class}(kServiceId, kPwRpcMethods) {{}}')
+        gen.line('constexpr Service()')
+        gen.line(f'    : {base_class}(kServiceId,')
+        gen.line(f'{" " * len(base_class)}       kPwRpcMethods,')
+        gen.line(f'{" " * len(base_class)}       {RPC_NAMESPACE}::internal::'
+                 'MethodOrder::kSortedById) {}')
 
     gen.line()
     gen.line(' private:')
@@ -351,13 +354,14 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
         gen.line('friend class ::pw::rpc::internal::MethodLookup;')
         gen.line()
 
-        # Generate the method table
+        # Generate the method table, sorted by method ID so that methods can be
+        # found with a binary search.
         gen.line('static constexpr std::array<'
                  f'{RPC_NAMESPACE}::internal::{gen.method_union_name()},'
                  f' {len(service.methods())}> kPwRpcMethods = {{')
 
         with gen.indent(4):
-            for method in service.methods():
+            for method in _sorted_methods(service):
                 gen.method_descriptor(method)
 
         gen.line('};\n')
@@ -374,12 +378,18 @@ def _method_lookup_table(gen: CodeGenerator, service: ProtoService) -> None:
              f'{len(service.methods())}> kPwRpcMethodIds = {{')
 
     with gen.indent(4):
-        for method in service.methods():
+        for method in _sorted_methods(service):
             gen.line(f'{get_id(method)},  // Hash of "{method.name()}"')
 
     gen.line('};')
 
 
+def _sorted_methods(service: ProtoService) -> Sequence[ProtoServiceMethod]:
+    """Returns the service's methods sorted by method ID."""
+    return sorted(service.methods(),
+                  key=lambda method: pw_rpc.ids.calculate(method.name()))
+
+
 class StubGenerator(abc.ABC):
     """Generates stub method implementations that can be copied-and-pasted."""
     @abc.abstractmethod
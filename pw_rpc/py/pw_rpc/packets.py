@@ -13,7 +13,8 @@
 # the License.
 """Functions for working with pw_rpc packets."""
 
-from typing import Optional
+import struct
+from typing import List, Optional, Tuple, Union
 
 from google.protobuf import message
 from pw_status import Status
@@ -27,6 +28,194 @@ def decode(data: bytes) -> packet_pb2.RpcPacket:
     return packet
 
 
+class DecodedPacket:
+    """An RpcPacket decoded by decode_packet.
+
+    DecodedPacket has the same fields as RpcPacket, but is a plain object, so
+    creating one and reading its fields is much cheaper than for a protobuf
+    message in the pure Python protobuf runtime.
+    """
+    __slots__ = ('type', 'channel_id', 'service_id', 'method_id', 'payload',
+                 'status', 'call_id', 'timeout_ms', 'credits')
+
+    def __init__(self) -> None:
+        self.type = 0
+        self.channel_id = 0
+        self.service_id = 0
+        self.method_id = 0
+        self.payload = b''
+        self.status = 0
+        self.call_id = 0
+        self.timeout_ms = 0
+        self.credits = 0
+
+    def __eq__(self, other) -> bool:
+        return isinstance(other, DecodedPacket) and all(
+            getattr(self, field) == getattr(other, field)
+            for field in self.__slots__)
+
+    def __repr__(self) -> str:
+        fields = ', '.join(f'{field}={getattr(self, field)!r}'
+                           for field in self.__slots__)
+        return f'DecodedPacket({fields})'
+
+
+# A decoded packet, from either decode or decode_packet.
+Packet = Union[packet_pb2.RpcPacket, DecodedPacket]
+
+
+# Varint RpcPacket fields by field number. All are 32-bit.
+_VARINT_FIELDS = {
+    packet_pb2.RpcPacket.TYPE_FIELD_NUMBER: 'type',
+    packet_pb2.RpcPacket.CHANNEL_ID_FIELD_NUMBER: 'channel_id',
+    packet_pb2.RpcPacket.STATUS_FIELD_NUMBER: 'status',
+    packet_pb2.RpcPacket.CALL_ID_FIELD_NUMBER: 'call_id',
+    packet_pb2.RpcPacket.TIMEOUT_MS_FIELD_NUMBER: 'timeout_ms',
+    packet_pb2.RpcPacket.CREDITS_FIELD_NUMBER: 'credits',
+}
+_FIXED32_FIELDS = {
+    packet_pb2.RpcPacket.SERVICE_ID_FIELD_NUMBER: 'service_id',
+    packet_pb2.RpcPacket.METHOD_ID_FIELD_NUMBER: 'method_id',
+}
+_PAYLOAD_FIELD = packet_pb2.RpcPacket.PAYLOAD_FIELD_NUMBER
+_BATCH_FIELD = packet_pb2.RpcPacketBatch.PACKETS_FIELD_NUMBER
+
+_UINT32 = struct.Struct('<I')
+
+# Protobuf wire types.
+_VARINT = 0
+_FIXED64 = 1
+_DELIMITED = 2
+_FIXED32 = 5
+
+
+def _read_varint(data: bytes, index: int) -> Tuple[int, int]:
+    """Returns the varint at index and the index of the byte after it."""
+    try:
+        byte = data[index]
+        if byte < 0x80:  # Nearly all keys and IDs are a single byte.
+            return byte, index + 1
+
+        value = byte & 0x7f
+        shift = 7
+        while True:
+            index += 1
+            byte = data[index]
+            value |= (byte & 0x7f) << shift
+            if byte < 0x80:
+                return value, index + 1
+            shift += 7
+            if shift >= 70:
+                raise message.DecodeError('Varint is too long')
+    except IndexError:
+        raise message.DecodeError('Truncated varint') from None
+
+
+def _read_delimited(data: bytes, index: int) -> Tuple[int, int]:
+    """Returns the start and end of a length-delimited field's value."""
+    size, index = _read_varint(data, index)
+    end = index + size
+    if end > len(data):
+        raise message.DecodeError('Truncated length-delimited field')
+    return index, end
+
+
+def _skip(data: bytes, index: int, wire_type: int) -> int:
+    """Skips an unknown field's value. Returns the index after it."""
+    if wire_type == _VARINT:
+        return _read_varint(data, index)[1]
+    if wire_type == _DELIMITED:
+        return _read_delimited(data, index)[1]
+
+    if wire_type == _FIXED64:
+        index += 8
+    elif wire_type == _FIXED32:
+        index += 4
+    else:
+        raise message.DecodeError(f'Unsupported wire type {wire_type}')
+
+    if index > len(data):
+        raise message.DecodeError('Truncated fixed-size field')
+    return index
+
+
+def decode_packet(data: bytes) -> DecodedPacket:
+    """Decodes an RpcPacket without the protobuf runtime.
+
+    The packet is returned as a DecodedPacket rather than an RpcPacket message.
+    This is several times faster than decode() with the pure Python protobuf
+    runtime, and is used by the client to process incoming packets. Unknown
+    fields are skipped.
+
+    Raises:
+      google.protobuf.message.DecodeError: the packet is malformed
+    """
+    packet = DecodedPacket()
+    index = 0
+    end = len(data)
+
+    while index < end:
+        key, index = _read_varint(data, index)
+        field = key >> 3
+        wire_type = key & 0x7
+
+        if wire_type == _VARINT and field in _VARINT_FIELDS:
+            value, index = _read_varint(data, index)
+            value &= 0xffffffff  # Fields are 32 bits; the enum is signed.
+            if field == packet_pb2.RpcPacket.TYPE_FIELD_NUMBER and (
+                    value & 0x80000000):
+                value -= 1 << 32
+            setattr(packet, _VARINT_FIELDS[field], value)
+        elif wire_type == _FIXED32 and field in _FIXED32_FIELDS:
+            if index + 4 > end:
+                raise message.DecodeError('Truncated fixed32 field')
+            setattr(packet, _FIXED32_FIELDS[field],
+                    _UINT32.unpack_from(data, index)[0])
+            index += 4
+        elif wire_type == _DELIMITED and field == _PAYLOAD_FIELD:
+            start, index = _read_delimited(data, index)
+            packet.payload = bytes(data[start:index])
+        elif field == 0:
+            raise message.DecodeError('Field number 0 is invalid')
+        else:
+            index = _skip(data, index, wire_type)
+
+    return packet
+
+
+def is_batch(data: bytes) -> bool:
+    """True if the data is an RpcPacketBatch rather than a single packet."""
+    # A batch starts with the key of its packets field, which RpcPacket
+    # reserves. The field number is less than 16, so the key is a single byte.
+    return data[:1] == bytes([_BATCH_FIELD << 3 | _DELIMITED])
+
+
+def decode_batch(data: bytes) -> List[bytes]:
+    """Returns the encoded packets in an RpcPacketBatch.
+
+    The batch is split directly from the wire format, so its packets are not
+    copied into and back out of an RpcPacketBatch message.
+
+    Raises:
+      google.protobuf.message.DecodeError: the batch is malformed
+    """
+    batch: List[bytes] = []
+    index = 0
+    end = len(data)
+
+    while index < end:
+        key, index = _read_varint(data, index)
+        if key == _BATCH_FIELD << 3 | _DELIMITED:
+            start, index = _read_delimited(data, index)
+            batch.append(bytes(data[start:index]))
+        elif key >> 3 == 0:
+            raise message.DecodeError('Field number 0 is invalid')
+        else:
+            index = _skip(data, index, key & 0x7)
+
+    return batch
+
+
 def decode_payload(packet, payload_type):
     payload = payload_type()
     payload.MergeFromString(packet.payload)
@@ -70,7 +259,7 @@ def encode_client_stream(rpc: tuple, request: message.Message) -> bytes:
         payload=request.SerializeToString()).SerializeToString()
 
 
-def encode_client_error(packet: packet_pb2.RpcPacket, status: Status) -> bytes:
+def encode_client_error(packet: Packet, status: Status) -> bytes:
     return packet_pb2.RpcPacket(type=packet_pb2.PacketType.CLIENT_ERROR,
                                 channel_id=packet.channel_id,
                                 service_id=packet.service_id,
@@ -96,5 +285,5 @@ def encode_client_stream_end(rpc: tuple) -> bytes:
                                 method_id=method).SerializeToString()
 
 
-def for_server(packet: packet_pb2.RpcPacket) -> bool:
+def for_server(packet: Packet) -> bool:
     return packet.type % 2 == 0
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests the pw_rpc benchmark runner."""
+
+from types import SimpleNamespace
+import unittest
+
+from pw_status import Status
+
+from pw_rpc import benchmark
+from pw_rpc.callback_client import RpcTimeout
+
+
+class _FakeUnaryEcho:
+    """Stands in for the UnaryEcho method client."""
+    def __init__(self, fail_every: int = 0):
+        self.calls = 0
+        self._fail_every = fail_every
+
+    def __call__(self, payload: bytes, pw_rpc_timeout_s: float):
+        del pw_rpc_timeout_s
+        self.calls += 1
+        if self._fail_every and self.calls % self._fail_every == 0:
+            raise RpcTimeout(SimpleNamespace(method='UnaryEcho'), 1.0)
+        return Status.OK, SimpleNamespace(payload=payload)
+
+
+class PercentileTest(unittest.TestCase):
+    """Tests the nearest-rank percentile."""
+    def test_empty(self) -> None:
+        self.assertEqual(benchmark.percentile([], 50), 0.0)
+
+    def test_nearest_rank(self) -> None:
+        values = list(range(1, 101))
+        self.assertEqual(benchmark.percentile(values, 50), 50)
+        self.assertEqual(benchmark.percentile(values, 99), 99)
+        self.assertEqual(benchmark.percentile(values, 100), 100)
+        self.assertEqual(benchmark.percentile(values, 0), 1)
+
+    def test_single_value(self) -> None:
+        self.assertEqual(benchmark.percentile([3.5], 90), 3.5)
+
+
+class BenchmarkResultTest(unittest.TestCase):
+    """Tests BenchmarkResult calculations."""
+    def test_rates(self) -> None:
+        result = benchmark.BenchmarkResult('test', 8, duration_s=2.0)
+        result.packets = 10
+        result.payload_bytes = 80
+        self.assertEqual(result.packets_per_second(), 5.0)
+        self.assertEqual(result.bytes_per_second(), 40.0)
+
+    def test_rates_without_duration(self) -> None:
+        result = benchmark.BenchmarkResult('test', 8)
+        self.assertEqual(result.packets_per_second(), 0.0)
+        self.assertEqual(result.bytes_per_second(), 0.0)
+
+    def test_summary(self) -> None:
+        result = benchmark.BenchmarkResult('test', 8, duration_s=1.0)
+        result.latencies_s = [0.003, 0.001, 0.002]
+        summary = result.summary()
+        self.assertEqual(summary['name'], 'test')
+        self.assertEqual(summary['latency_us']['p50'], 2000.0)
+        self.assertEqual(summary['latency_us']['p100'], 3000.0)
+
+
+class BenchmarkTest(unittest.TestCase):
+    """Tests running benchmarks with fake services."""
+    def setUp(self) -> None:
+        self._echoes = [_FakeUnaryEcho(), _FakeUnaryEcho()]
+        self._bench = benchmark.Benchmark(
+            SimpleNamespace(UnaryEcho=echo) for echo in self._echoes)
+
+    def test_unary_echo(self) -> None:
+        result = self._bench.unary_echo(payload_size=4, iterations=10)
+        self.assertEqual(result.failures, 0)
+        self.assertEqual(result.packets, 20)
+        self.assertEqual(result.payload_bytes, 80)
+        self.assertEqual(len(result.latencies_s), 10)
+        self.assertEqual([e.calls for e in self._echoes], [10, 0])
+
+    def test_unary_echo_concurrent(self) -> None:
+        result = self._bench.unary_echo(4, 10, concurrency=2)
+        self.assertEqual(result.concurrency, 2)
+        self.assertEqual(result.packets, 40)
+        self.assertEqual([e.calls for e in self._echoes], [10, 10])
+
+    def test_timeout_counts_as_failure(self) -> None:
+        bench = benchmark.Benchmark(
+            [SimpleNamespace(UnaryEcho=_FakeUnaryEcho(fail_every=5))])
+        result = bench.unary_echo(4, 10)
+        self.assertEqual(result.failures, 1)
+        self.assertEqual(result.packets, 8)
+
+    def test_concurrency_above_channel_count(self) -> None:
+        with self.assertRaises(ValueError):
+            self._bench.unary_echo(4, 10, concurrency=3)
+
+    def test_no_services(self) -> None:
+        with self.assertRaises(ValueError):
+            benchmark.Benchmark([])
+
+
+if __name__ == '__main__':
+    unittest.main()
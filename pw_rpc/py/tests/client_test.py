@@ -22,7 +22,7 @@ from pw_status import Status
 
 from pw_rpc import callback_client, client, packets
 import pw_rpc.ids
-from pw_rpc.internal.packet_pb2 import PacketType, RpcPacket
+from pw_rpc.internal.packet_pb2 import PacketType, RpcPacket, RpcPacketBatch
 
 TEST_PROTO_1 = """\
 syntax = "proto3";
@@ -267,6 +267,58 @@ class ClientTest(unittest.TestCase):
                       method_id=789,
                       status=Status.NOT_FOUND.value))
 
+    def test_process_packet_batch(self) -> None:
+        service = next(iter(self._client.services))
+        request = self._protos.packages.pw.test2.Request()
+        batch = RpcPacketBatch(packets=[
+            packets.encode_response((1, service.id, 789), request),
+            packets.encode_response((1, service.id, 790), request),
+        ])
+
+        self.assertIs(self._client.process_packet(batch.SerializeToString()),
+                      Status.OK)
+
+        self.assertEqual(
+            self._last_packet_sent(),
+            RpcPacket(type=PacketType.CLIENT_ERROR,
+                      channel_id=1,
+                      service_id=service.id,
+                      method_id=790,
+                      status=Status.NOT_FOUND.value))
+
+    def test_process_packet_batch_not_for_client(self) -> None:
+        batch = RpcPacketBatch(
+            packets=[RpcPacket(type=PacketType.REQUEST).SerializeToString()])
+
+        self.assertIs(self._client.process_packet(batch.SerializeToString()),
+                      Status.INVALID_ARGUMENT)
+
+    def test_process_packets(self) -> None:
+        service = next(iter(self._client.services))
+        method = next(iter(service.methods))
+        request = self._protos.packages.pw.test2.Request()
+
+        self.assertIs(
+            self._client.process_packets([
+                packets.encode_response((1, service.id, method.id), request),
+                packets.encode_response((1, service.id, 790), request),
+            ]), Status.OK)
+
+        self.assertEqual(
+            self._last_packet_sent(),
+            RpcPacket(type=PacketType.CLIENT_ERROR,
+                      channel_id=1,
+                      service_id=service.id,
+                      method_id=790,
+                      status=Status.NOT_FOUND.value))
+
+    def test_process_packets_returns_first_error(self) -> None:
+        self.assertIs(
+            self._client.process_packets([
+                RpcPacket(type=PacketType.REQUEST).SerializeToString(),
+                b'\xff',
+            ]), Status.INVALID_ARGUMENT)
+
     def test_process_packet_non_pending_method(self) -> None:
         service = next(iter(self._client.services))
         method = next(iter(service.methods))
@@ -16,9 +16,10 @@
 
 import unittest
 
+from google.protobuf.message import DecodeError
 from pw_status import Status
 
-from pw_rpc.internal.packet_pb2 import PacketType, RpcPacket
+from pw_rpc.internal.packet_pb2 import PacketType, RpcPacket, RpcPacketBatch
 from pw_rpc import packets
 
 _TEST_REQUEST = RpcPacket(type=PacketType.REQUEST,
@@ -82,6 +83,61 @@ class PacketsTest(unittest.TestCase):
         self.assertEqual(_TEST_REQUEST,
                          packets.decode(_TEST_REQUEST.SerializeToString()))
 
+    def test_decode_packet_matches_protobuf(self):
+        packet = RpcPacket(type=PacketType.SERVER_ERROR,
+                           channel_id=300,
+                           service_id=0xffffffff,
+                           method_id=0x12345678,
+                           payload=b'\x00' * 200,
+                           status=Status.UNAVAILABLE.value,
+                           call_id=7,
+                           timeout_ms=1000,
+                           credits=2)
+        decoded = packets.decode_packet(packet.SerializeToString())
+
+        for field in packets.DecodedPacket.__slots__:
+            self.assertEqual(getattr(packet, field), getattr(decoded, field))
+
+    def test_decode_packet_defaults(self):
+        self.assertEqual(packets.decode_packet(b''), packets.DecodedPacket())
+
+    def test_decode_packet_skips_unknown_fields(self):
+        data = _TEST_REQUEST.SerializeToString()
+        # Fields 10-13, with varint, delimited, fixed64, and fixed32 types.
+        unknown = (b'\x50\x01' + b'\x5a\x02ab' + b'\x61' + b'\x00' * 8 +
+                   b'\x6d' + b'\x00' * 4)
+        decoded = packets.decode_packet(unknown + data)
+
+        self.assertEqual(decoded.channel_id, 1)
+        self.assertEqual(decoded.service_id, 2)
+        self.assertEqual(decoded.method_id, 3)
+        self.assertEqual(decoded.payload, _TEST_REQUEST.payload)
+
+    def test_decode_packet_malformed(self):
+        for data in (b'\x08', b'\x1d\x01\x02', b'\x2a\x05abc', b'\x0f',
+                     b'\x00\x00'):
+            with self.assertRaises(DecodeError, msg=repr(data)):
+                packets.decode_packet(data)
+
+    def test_is_batch(self):
+        batch = RpcPacketBatch(packets=[_TEST_REQUEST.SerializeToString()])
+
+        self.assertTrue(packets.is_batch(batch.SerializeToString()))
+        self.assertFalse(packets.is_batch(_TEST_REQUEST.SerializeToString()))
+        self.assertFalse(packets.is_batch(b''))
+
+    def test_decode_batch(self):
+        encoded = [_TEST_REQUEST.SerializeToString(), b'\x08\x01']
+        batch = RpcPacketBatch(packets=encoded).SerializeToString()
+
+        self.assertEqual(encoded, packets.decode_batch(batch))
+
+    def test_decode_batch_malformed(self):
+        batch = RpcPacketBatch(packets=[_TEST_REQUEST.SerializeToString()])
+
+        with self.assertRaises(DecodeError):
+            packets.decode_batch(batch.SerializeToString()[:-1])
+
     def test_for_server(self):
         self.assertTrue(packets.for_server(_TEST_REQUEST))
 
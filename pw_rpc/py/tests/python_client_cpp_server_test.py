@@ -18,7 +18,7 @@ from typing import List, Tuple
 import unittest
 
 import pw_hdlc.rpc
-from pw_rpc import benchmark_pb2, testing
+from pw_rpc import benchmark, benchmark_pb2, testing
 from pw_status import Status
 
 ITERATIONS = 50
@@ -78,6 +78,30 @@ class RpcIntegrationTest(unittest.TestCase):
             self.assertEqual(second_call.responses,
                              [rpc.response(payload=b'123')])
 
+    def test_server_stream(self) -> None:
+        rpc = self.rpcs.pw.rpc.Benchmark.ServerStream
+        status, responses = rpc(payload_size=16, count=ITERATIONS)
+        self.assertIs(status, Status.OK)
+        self.assertEqual(len(responses), ITERATIONS)
+        self.assertTrue(all(len(r.payload) == 16 for r in responses))
+
+    def test_client_stream(self) -> None:
+        rpc = self.rpcs.pw.rpc.Benchmark.ClientStream
+        requests = [rpc.request(payload=b'abcd')] * ITERATIONS
+        status, stats = rpc(requests + [rpc.request()])
+        self.assertIs(status, Status.OK)
+        self.assertEqual(stats.payload_count, ITERATIONS)
+        self.assertEqual(stats.payload_bytes, 4 * ITERATIONS)
+
+    def test_benchmark_runner(self) -> None:
+        bench = benchmark.Benchmark.from_client(self._context.client, [1])
+        for result in (bench.unary_echo(32, ITERATIONS),
+                       bench.bidirectional_echo(32, ITERATIONS),
+                       bench.server_stream(32, ITERATIONS),
+                       bench.client_stream(32, ITERATIONS)):
+            self.assertEqual(result.failures, 0, result.name)
+            self.assertGreater(result.packets, 0, result.name)
+
 
 def _main(test_server_command: List[str], port: int,
           unittest_args: List[str]) -> None:
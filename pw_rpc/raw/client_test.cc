@@ -14,11 +14,13 @@
 
 #include "pw_rpc/client.h"
 
+#include <array>
 #include <optional>
 
 #include "gtest/gtest.h"
 #include "pw_rpc/internal/client_call.h"
 #include "pw_rpc/internal/packet.h"
+#include "pw_rpc/internal/test_utils.h"
 #include "pw_rpc/raw/client_testing.h"
 
 namespace pw::rpc {
@@ -174,5 +176,121 @@ TEST(Client, ProcessPacket_ReturnsInvalidArgumentOnServerPacket) {
   EXPECT_EQ(context.client().ProcessPacket(*result), Status::InvalidArgument());
 }
 
+TEST(Client, RequestTimeout_SentInRequest) {
+  internal::TestOutput<64> output;
+  Channel channels[] = {Channel::Create<1>(&output)};
+  Client client(channels);
+  client.set_request_timeout_ms(250);
+
+  TestUnaryCall call(client, 1, 100, 200, MethodType::kUnary);
+  call.SendInitialRequest({});
+
+  ASSERT_EQ(1u, output.packet_count());
+  EXPECT_EQ(internal::PacketType::REQUEST, output.sent_packet().type());
+  EXPECT_EQ(250u, output.sent_packet().timeout_ms());
+}
+
+TEST(Client, RequestTimeout_NotSetByDefault) {
+  internal::TestOutput<64> output;
+  Channel channels[] = {Channel::Create<1>(&output)};
+  Client client(channels);
+
+  TestUnaryCall call(client, 1, 100, 200, MethodType::kUnary);
+  call.SendInitialRequest({});
+
+  ASSERT_EQ(1u, output.packet_count());
+  EXPECT_EQ(0u, output.sent_packet().timeout_ms());
+}
+
+TEST(Client, ProcessPacket_Batch_InvokesCallbackForEachPacket) {
+  internal::TestOutput<64> output;
+  Channel channels[] = {Channel::Create<1>(&output)};
+  Client client(channels);
+
+  TestStreamCall call(
+      client, 1, 100, 300, MethodType::kBidirectionalStreaming);
+  call.SendInitialRequest({});
+  int responses = 0;
+  call.set_on_next([&responses](ConstByteSpan) { responses += 1; });
+
+  std::array<std::byte, 32> packet;
+  Result<ConstByteSpan> stream =
+      internal::Packet(internal::PacketType::SERVER_STREAM,
+                       1,
+                       100,
+                       300,
+                       output.sent_packet().call_id())
+          .Encode(packet);
+  ASSERT_EQ(OkStatus(), stream.status());
+
+  std::array<std::byte, 80> buffer;
+  internal::RpcPacketBatch::MemoryEncoder batch(buffer);
+  ASSERT_EQ(OkStatus(), batch.WritePackets(*stream));
+  ASSERT_EQ(OkStatus(), batch.WritePackets(*stream));
+
+  EXPECT_EQ(OkStatus(), client.ProcessPacket(ConstByteSpan(batch)));
+  EXPECT_EQ(2, responses);
+}
+
+TEST(Client, StreamCredits_SentInStreamingRequest) {
+  internal::TestOutput<64> output;
+  Channel channels[] = {Channel::Create<1>(&output)};
+  Client client(channels);
+  client.set_stream_credits(4);
+
+  TestStreamCall call(
+      client, 1, 100, 300, MethodType::kBidirectionalStreaming);
+  call.SendInitialRequest({});
+
+  ASSERT_EQ(1u, output.packet_count());
+  EXPECT_EQ(4u, output.sent_packet().credits());
+}
+
+TEST(Client, StreamCredits_NotSentInUnaryRequest) {
+  internal::TestOutput<64> output;
+  Channel channels[] = {Channel::Create<1>(&output)};
+  Client client(channels);
+  client.set_stream_credits(4);
+
+  TestUnaryCall call(client, 1, 100, 200, MethodType::kUnary);
+  call.SendInitialRequest({});
+
+  ASSERT_EQ(1u, output.packet_count());
+  EXPECT_EQ(0u, output.sent_packet().credits());
+}
+
+TEST(Client, StreamCredits_GrantedAfterHalfOfWindowIsUsed) {
+  internal::TestOutput<64> output;
+  Channel channels[] = {Channel::Create<1>(&output)};
+  Client client(channels);
+  client.set_stream_credits(4);
+
+  TestStreamCall call(
+      client, 1, 100, 300, MethodType::kBidirectionalStreaming);
+  call.SendInitialRequest({});
+  const uint32_t call_id = output.sent_packet().call_id();
+
+  std::byte encoded[64];
+  Result<ConstByteSpan> stream =
+      internal::Packet(internal::PacketType::SERVER_STREAM,
+                       1,
+                       100,
+                       300,
+                       call_id,
+                       std::as_bytes(std::span("<=>")))
+          .Encode(encoded);
+  ASSERT_EQ(OkStatus(), stream.status());
+
+  ASSERT_EQ(OkStatus(), client.ProcessPacket(*stream));
+  EXPECT_EQ(1u, output.packet_count());  // Still half of the window left.
+
+  ASSERT_EQ(OkStatus(), client.ProcessPacket(*stream));
+  ASSERT_EQ(2u, output.packet_count());
+  EXPECT_EQ(internal::PacketType::CLIENT_CREDIT, output.sent_packet().type());
+  EXPECT_EQ(call_id, output.sent_packet().call_id());
+  EXPECT_EQ(2u, output.sent_packet().credits());
+  EXPECT_STREQ(call.payload, "<=>");
+}
+
 }  // namespace
 }  // namespace pw::rpc
@@ -48,6 +48,9 @@ class RawClientReaderWriter : private internal::StreamResponseClientCall {
   // Releases a buffer acquired from PayloadBuffer() without sending any data.
   void ReleaseBuffer() { ReleasePayloadBuffer(); }
 
+  // The largest payload that fits within the channel output's MTU.
+  using internal::Call::MaxWriteSizeBytes;
+
   // Sends a stream request packet with the given raw payload. The payload can
   // either be in the buffer previously acquired from PayloadBuffer(), or an
   // arbitrary external buffer.
@@ -74,18 +74,29 @@ class RawServerReaderWriter : private internal::ServerCall {
   using internal::Call::set_on_error;
   using internal::Call::set_on_next;
   using internal::ServerCall::set_on_client_stream_end;
+  using internal::ServerCall::set_on_writable;
 
   // Sends a response packet with the given raw payload. The payload can either
   // be in the buffer previously acquired from PayloadBuffer(), or an arbitrary
-  // external buffer.
+  // external buffer. Returns UNAVAILABLE if the client enabled flow control and
+  // available_credits() is 0.
   using internal::Call::Write;
 
-  // Returns a buffer in which a response payload can be built.
+  // The number of packets that may be written before the client grants more
+  // credits, or kUnlimitedCredits if the stream is not flow controlled.
+  using internal::Call::available_credits;
+  using internal::Call::kUnlimitedCredits;
+
+  // Returns a buffer in which a response payload can be built. A payload
+  // built at the start of this buffer is sent by Write() without being copied.
   ByteSpan PayloadBuffer() { return AcquirePayloadBuffer(); }
 
   // Releases a buffer acquired from PayloadBuffer() without sending any data.
   void ReleaseBuffer() { ReleasePayloadBuffer(); }
 
+  // The largest payload that fits within the channel output's MTU.
+  using internal::Call::MaxWriteSizeBytes;
+
   Status Finish(Status status = OkStatus()) {
     return CloseAndSendResponse(status);
   }
@@ -182,8 +193,11 @@ class RawServerWriter : private RawServerReaderWriter {
   using RawServerReaderWriter::open;
 
   using RawServerReaderWriter::set_on_error;
+  using RawServerReaderWriter::set_on_writable;
 
+  using RawServerReaderWriter::available_credits;
   using RawServerReaderWriter::Finish;
+  using RawServerReaderWriter::kUnlimitedCredits;
   using RawServerReaderWriter::PayloadBuffer;
   using RawServerReaderWriter::ReleaseBuffer;
   using RawServerReaderWriter::Write;
@@ -19,7 +19,9 @@
 
 #include "pw_log/log.h"
 #include "pw_rpc/internal/endpoint.h"
+#include "pw_rpc/internal/instrumentation.h"
 #include "pw_rpc/internal/packet.h"
+#include "pw_rpc/internal/packet_batch.h"
 #include "pw_rpc/server_context.h"
 
 namespace pw::rpc {
@@ -33,11 +35,26 @@ using internal::PacketType;
 }  // namespace
 
 Status Server::ProcessPacket(std::span<const byte> packet_data,
-                             ChannelOutput& interface) {
+                             ChannelOutput& interface,
+                             uint32_t queued_ms) {
+  if (internal::IsPacketBatch(packet_data)) {
+    return internal::ForEachPacketInBatch(
+        packet_data, [&](ConstByteSpan packet) {
+          return ProcessSinglePacket(packet, interface, queued_ms);
+        });
+  }
+  return ProcessSinglePacket(packet_data, interface, queued_ms);
+}
+
+Status Server::ProcessSinglePacket(std::span<const byte> packet_data,
+                                   ChannelOutput& interface,
+                                   uint32_t queued_ms) {
   PW_TRY_ASSIGN(Result<Packet> result,
                 Endpoint::ProcessPacket(packet_data, Packet::kServer));
   Packet& packet = *result;
 
+  internal::RecordPacketReceived(packet.channel_id(), packet_data.size());
+
   internal::rpc_lock().lock();
   internal::ServerCall* const call =
       static_cast<internal::ServerCall*>(FindCall(packet));
@@ -84,9 +101,30 @@ Status Server::ProcessPacket(std::span<const byte> packet_data,
     case PacketType::REQUEST: {
       // If the REQUEST is for an ongoing RPC, the existing call will be
       // cancelled when the new call object is created.
-      const internal::CallContext context(
-          *this, *channel, *service, *method, packet.call_id());
+      const internal::CallContext context(*this,
+                                          *channel,
+                                          *service,
+                                          *method,
+                                          packet.call_id(),
+                                          packet.credits());
+      // Calls are only counted if something uses the count, since this
+      // searches the list of calls.
+      const uint32_t ongoing_service_calls =
+          admission_control_ == nullptr
+              ? 0
+              : CountCallsToService(packet.service_id());
       internal::rpc_lock().unlock();
+
+      if (const Status status =
+              AdmitRequest(packet, queued_ms, ongoing_service_calls);
+          !status.ok()) {
+        channel->Send(Packet::ServerError(packet, status)).IgnoreError();
+        break;
+      }
+
+      internal::TraceCallStart(packet.method_id());
+      const internal::HandlerTimer timer(packet.service_id(),
+                                         packet.method_id());
       method->Invoke(context, packet);
       break;
     }
@@ -104,6 +142,14 @@ Status Server::ProcessPacket(std::span<const byte> packet_data,
     case PacketType::CLIENT_STREAM_END:
       HandleClientStreamPacket(packet, *channel, call);
       break;
+    case PacketType::CLIENT_CREDIT:
+      // Credits for calls that have finished are ignored.
+      if (call != nullptr && call->id() == packet.call_id()) {
+        call->HandleCredits(packet.credits());
+      } else {
+        internal::rpc_lock().unlock();
+      }
+      break;
     default:
       internal::rpc_lock().unlock();
       PW_LOG_WARN("pw_rpc server unable to handle packet of type %u",
@@ -113,14 +159,52 @@ Status Server::ProcessPacket(std::span<const byte> packet_data,
   return OkStatus();  // OK since the packet was handled
 }
 
+void Server::RegisterService(Service& service) {
+  auto previous = services_.before_begin();
+  for (auto it = services_.begin();
+       it != services_.end() && it->id() < service.id();
+       ++it) {
+    previous = it;
+  }
+  services_.insert_after(previous, service);
+}
+
+Status Server::AdmitRequest(const internal::Packet& packet,
+                            uint32_t queued_ms,
+                            uint32_t ongoing_service_calls) {
+  if (packet.timeout_ms() != 0u && queued_ms >= packet.timeout_ms()) {
+    PW_LOG_DEBUG("Rejecting RPC %u:%08x/%08x queued for %u ms, past its %u ms "
+                 "timeout",
+                 static_cast<unsigned>(packet.channel_id()),
+                 static_cast<unsigned>(packet.service_id()),
+                 static_cast<unsigned>(packet.method_id()),
+                 static_cast<unsigned>(queued_ms),
+                 static_cast<unsigned>(packet.timeout_ms()));
+    return Status::DeadlineExceeded();
+  }
+
+  if (admission_control_ == nullptr) {
+    return OkStatus();
+  }
+
+  const AdmissionControl::Request request = {packet.channel_id(),
+                                             packet.service_id(),
+                                             packet.method_id(),
+                                             packet.timeout_ms(),
+                                             queued_ms,
+                                             ongoing_service_calls};
+  return admission_control_->Admit(request);
+}
+
 std::tuple<Service*, const internal::Method*> Server::FindMethod(
     const internal::Packet& packet) {
-  // Packets always include service and method IDs.
+  // Packets always include service and method IDs. Services are sorted by ID,
+  // so the search stops at the first service with an ID that is not less.
   auto service = std::find_if(services_.begin(), services_.end(), [&](auto& s) {
-    return s.id() == packet.service_id();
+    return s.id() >= packet.service_id();
   });
 
-  if (service == services_.end()) {
+  if (service == services_.end() || service->id() != packet.service_id()) {
     return {};
   }
 
@@ -23,6 +23,7 @@ void ServerCall::MoveServerCallFrom(ServerCall& other) {
     SendPacket(PacketType::RESPONSE,
                {},
                OkStatus());  // Unlocks when it sends a packet
+    TraceCallEnd(method_id());
     rpc_lock().lock();
   }
 
@@ -31,6 +32,30 @@ void ServerCall::MoveServerCallFrom(ServerCall& other) {
 #if PW_RPC_CLIENT_STREAM_END_CALLBACK
   on_client_stream_end_ = std::move(other.on_client_stream_end_);
 #endif  // PW_RPC_CLIENT_STREAM_END_CALLBACK
+
+#if PW_RPC_ON_WRITABLE_CALLBACK
+  on_writable_ = std::move(other.on_writable_);
+#endif  // PW_RPC_ON_WRITABLE_CALLBACK
+}
+
+void ServerCall::HandleCredits(uint32_t credits) {
+  const uint32_t available = this->credits();
+  if (available == kUnlimitedCredits || credits == 0u) {
+    rpc_lock().unlock();
+    return;
+  }
+
+  // Saturate just below kUnlimitedCredits, which means no flow control.
+  set_credits(credits < kUnlimitedCredits - available
+                  ? available + credits
+                  : kUnlimitedCredits - 1);
+  rpc_lock().unlock();
+
+#if PW_RPC_ON_WRITABLE_CALLBACK
+  if (available == 0u && on_writable_) {
+    on_writable_();
+  }
+#endif  // PW_RPC_ON_WRITABLE_CALLBACK
 }
 
 }  // namespace pw::rpc::internal
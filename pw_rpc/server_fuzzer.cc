@@ -0,0 +1,298 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Fuzzes the server packet path, Server::ProcessPacket, with a real service.
+// The fuzz data is interpreted as a sequence of actions, most of which build
+// packets for the registered service, its methods, and a few call IDs, so that
+// the fuzzer reaches call handling rather than stopping at packet decoding.
+// Other actions send raw bytes or batches of packets.
+//
+// Besides crashes, the fuzzer reports packets that take far longer to process
+// than the median packet, since an algorithmic slow path lets a client consume
+// server CPU out of proportion to the data it sends. A packet is reported if
+// it is slower than PW_RPC_FUZZER_SLOW_FACTOR (default 100) times the median
+// in every one of several runs of the input, which rules out noise from the
+// host. The input is then saved by the fuzzer like any other crash.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "pw_fuzzer/fuzzed_data_provider.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_rpc/benchmark.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/hash.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/internal/packet_batch.h"
+#include "pw_rpc/server.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::Packet;
+using internal::PacketType;
+
+using Durations = std::vector<std::chrono::nanoseconds>;
+
+constexpr size_t kMaxPayloadSize = 256;
+constexpr size_t kMaxPacketsPerBatch = 8;
+
+// The output accepts a limited number of packets per input, like a congested
+// transport, so that handlers that stream many responses do bounded work.
+constexpr size_t kMaxSentPacketsPerInput = 64;
+
+// The number of packets over which the median processing time is taken.
+constexpr size_t kMedianWindow = 1024;
+
+// The number of times to run an input with a slow packet before reporting it.
+constexpr int kConfirmationRuns = 3;
+
+enum Action : uint8_t {
+  kPacket,
+  kRawPacket,
+  kBatch,
+  kMaxValue = kBatch,
+};
+
+constexpr PacketType kPacketTypes[] = {
+    PacketType::REQUEST,
+    PacketType::CLIENT_STREAM,
+    PacketType::CLIENT_ERROR,
+    PacketType::DEPRECATED_CANCEL,
+    PacketType::CLIENT_STREAM_END,
+    PacketType::CLIENT_CREDIT,
+    PacketType::RESPONSE,
+    PacketType::SERVER_ERROR,
+};
+
+constexpr uint32_t kServiceId = internal::Hash("pw.rpc.Benchmark");
+
+constexpr uint32_t kMethodIds[] = {
+    internal::Hash("UnaryEcho"),
+    internal::Hash("BidirectionalEcho"),
+    internal::Hash("ServerStream"),
+    internal::Hash("ClientStream"),
+};
+
+class FuzzChannelOutput : public ChannelOutput {
+ public:
+  FuzzChannelOutput() : ChannelOutput("fuzz"), sent_packets_(0) {}
+
+  std::span<std::byte> AcquireBuffer() override { return buffer_; }
+
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) override {
+    if (buffer.empty()) {
+      return OkStatus();
+    }
+    if (sent_packets_ == kMaxSentPacketsPerInput) {
+      return Status::Unavailable();
+    }
+    sent_packets_ += 1;
+    return OkStatus();
+  }
+
+ private:
+  std::array<std::byte, kMaxPayloadSize + 32> buffer_;
+  size_t sent_packets_;
+};
+
+// Picks an ID from a list of valid IDs, or occasionally an arbitrary one.
+template <size_t kSize>
+uint32_t ConsumeId(FuzzedDataProvider& provider,
+                   const uint32_t (&valid_ids)[kSize]) {
+  if (provider.ConsumeIntegralInRange<uint8_t>(0, 15) == 0) {
+    return provider.ConsumeIntegral<uint32_t>();
+  }
+  return provider.PickValueInArray(valid_ids);
+}
+
+// Builds and encodes a packet for the server. The payload is stored in
+// payload, which must outlive the encoded packet.
+ConstByteSpan ConsumePacket(FuzzedDataProvider& provider,
+                            std::vector<std::byte>& payload,
+                            ByteSpan buffer) {
+  Packet packet(provider.PickValueInArray(kPacketTypes),
+                ConsumeId(provider, {1u, 2u}),
+                ConsumeId(provider, {kServiceId}),
+                ConsumeId(provider, kMethodIds));
+  packet.set_call_id(provider.ConsumeIntegralInRange<uint32_t>(0, 3));
+
+  if (provider.ConsumeBool()) {
+    packet.set_status(static_cast<Status::Code>(
+        provider.ConsumeIntegralInRange<int>(0, PW_STATUS_UNAUTHENTICATED)));
+  }
+  if (provider.ConsumeBool()) {
+    packet.set_timeout_ms(provider.ConsumeIntegral<uint32_t>());
+  }
+  if (provider.ConsumeBool()) {
+    packet.set_credits(provider.ConsumeIntegral<uint32_t>());
+  }
+
+  payload = provider.ConsumeBytes<std::byte>(
+      provider.ConsumeIntegralInRange<size_t>(0, kMaxPayloadSize));
+  packet.set_payload(payload);
+
+  return packet.Encode(buffer).value_or(ConstByteSpan());
+}
+
+ConstByteSpan ConsumeBatch(FuzzedDataProvider& provider, ByteSpan buffer) {
+  std::array<std::byte, 2 * kMaxPayloadSize> packet_buffer;
+  std::vector<std::byte> payload;
+  protobuf::MemoryEncoder batch(buffer);
+
+  const size_t packets =
+      provider.ConsumeIntegralInRange<size_t>(1, kMaxPacketsPerBatch);
+  for (size_t i = 0; i < packets; ++i) {
+    batch
+        .WriteBytes(internal::kPacketBatchField,
+                    ConsumePacket(provider, payload, packet_buffer))
+        .IgnoreError();  // A truncated batch is still worth processing.
+  }
+  return ConstByteSpan(batch.data(), batch.size());
+}
+
+// Processes every packet in an input with a new server, and returns the time
+// taken to process each packet.
+Durations RunInput(const uint8_t* data, size_t size) {
+  FuzzChannelOutput output;
+  std::array<Channel, 2> channels = {
+      Channel::Create<1>(&output),
+      Channel::Create<2>(&output),
+  };
+  Server server(channels);
+  BenchmarkService service;
+  server.RegisterService(service);
+
+  FuzzedDataProvider provider(data, size);
+  std::vector<std::byte> storage;
+  std::array<std::byte, kMaxPacketsPerBatch * 2 * kMaxPayloadSize> buffer;
+  Durations durations;
+
+  while (provider.remaining_bytes() != 0) {
+    ConstByteSpan packet;
+    switch (provider.ConsumeEnum<Action>()) {
+      case kPacket:
+        packet = ConsumePacket(provider, storage, buffer);
+        break;
+      case kRawPacket:
+        storage = provider.ConsumeBytes<std::byte>(
+            provider.ConsumeIntegralInRange<size_t>(0, buffer.size()));
+        packet = storage;
+        break;
+      case kBatch:
+        packet = ConsumeBatch(provider, buffer);
+        break;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    server.ProcessPacket(packet, output).IgnoreError();
+    durations.push_back(std::chrono::steady_clock::now() - start);
+  }
+
+  return durations;
+}
+
+// Tracks the median time to process a packet.
+class PacketTimes {
+ public:
+  PacketTimes() : factor_(SlowFactor()), count_(0), median_(0) {}
+
+  // Whether a packet took more than the slow factor times the median. Always
+  // false until the median is known.
+  bool IsSlow(std::chrono::nanoseconds duration) const {
+    return median_.count() != 0 && duration > factor_ * median_;
+  }
+
+  int factor() const { return factor_; }
+  std::chrono::nanoseconds median() const { return median_; }
+
+  void Add(const Durations& durations) {
+    for (std::chrono::nanoseconds duration : durations) {
+      window_[count_++ % window_.size()] = duration;
+
+      // Recompute the median once per window to keep overhead low.
+      if (count_ % window_.size() == 0u) {
+        std::array<std::chrono::nanoseconds, kMedianWindow> sorted = window_;
+        std::nth_element(
+            sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+        // Clamp to the clock resolution so a median of 0 does not disable
+        // the oracle.
+        median_ = std::max(sorted[sorted.size() / 2],
+                           std::chrono::nanoseconds(1));
+      }
+    }
+  }
+
+ private:
+  static int SlowFactor() {
+    const char* factor = std::getenv("PW_RPC_FUZZER_SLOW_FACTOR");
+    return factor != nullptr ? std::max(std::atoi(factor), 1) : 100;
+  }
+
+  const int factor_;
+  size_t count_;
+  std::chrono::nanoseconds median_;
+  std::array<std::chrono::nanoseconds, kMedianWindow> window_;
+};
+
+// Returns the index of the first packet that is slow in durations, or
+// durations.size() if there is none.
+size_t FindSlowPacket(const PacketTimes& times, const Durations& durations) {
+  return static_cast<size_t>(
+      std::find_if(durations.begin(),
+                   durations.end(),
+                   [&times](auto duration) { return times.IsSlow(duration); }) -
+      durations.begin());
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  static PacketTimes times;
+
+  Durations durations = RunInput(data, size);
+  const size_t slow_packet = FindSlowPacket(times, durations);
+
+  if (slow_packet != durations.size()) {
+    // The server starts from the same state in each run, so a real slow path
+    // is slow in every run, while a slow run caused by the host is not.
+    std::chrono::nanoseconds fastest = durations[slow_packet];
+    for (int run = 1; run < kConfirmationRuns; ++run) {
+      const Durations rerun = RunInput(data, size);
+      fastest = std::min(fastest, rerun[slow_packet]);
+    }
+
+    if (times.IsSlow(fastest)) {
+      std::fprintf(stderr,
+                   "Packet %zu took %lld ns to process, more than %d times the "
+                   "median of %lld ns\n",
+                   slow_packet,
+                   static_cast<long long>(fastest.count()),
+                   times.factor(),
+                   static_cast<long long>(times.median().count()));
+      std::abort();
+    }
+  }
+
+  times.Add(durations);
+  return 0;
+}
+
+}  // namespace pw::rpc
@@ -16,6 +16,7 @@
 
 #include <array>
 #include <cstdint>
+#include <limits>
 
 #include "gtest/gtest.h"
 #include "pw_assert/check.h"
@@ -100,6 +101,23 @@ class BasicServer : public ::testing::Test {
                         Status::Cancelled());
   }
 
+  std::span<const byte> EncodeRequestWithTimeout(uint32_t method_id,
+                                                 uint32_t timeout_ms) {
+    Packet packet(PacketType::REQUEST, 1, 42, method_id);
+    packet.set_timeout_ms(timeout_ms);
+    auto result = packet.Encode(request_buffer_);
+    EXPECT_EQ(OkStatus(), result.status());
+    return result.value_or(ConstByteSpan());
+  }
+
+  std::span<const byte> EncodeCredit(uint32_t credits) {
+    Packet packet(PacketType::CLIENT_CREDIT, 1, 42, 100);
+    packet.set_credits(credits);
+    auto result = packet.Encode(request_buffer_);
+    EXPECT_EQ(OkStatus(), result.status());
+    return result.value_or(ConstByteSpan());
+  }
+
   template <typename T = ConstByteSpan>
   ConstByteSpan PacketForRpc(PacketType type,
                              Status status = OkStatus(),
@@ -131,6 +149,28 @@ TEST_F(BasicServer, ProcessPacket_ValidMethod_InvokesMethod) {
             0);
 }
 
+TEST_F(BasicServer, ProcessPacket_MultipleServices_InvokesMatchingService) {
+  // Register services out of order; they are kept sorted by ID.
+  TestService services[] = {TestService(50), TestService(10), TestService(43)};
+  for (TestService& service : services) {
+    server_.RegisterService(service);
+  }
+
+  for (TestService& service : services) {
+    EXPECT_EQ(OkStatus(),
+              server_.ProcessPacket(
+                  EncodePacket(PacketType::REQUEST, 2, service.id(), 200),
+                  output_));
+    EXPECT_EQ(2u, service.method(200).last_channel_id());
+  }
+  EXPECT_EQ(0u, service_.method(200).last_channel_id());
+
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(EncodePacket(PacketType::REQUEST, 1, 42, 200),
+                                  output_));
+  EXPECT_EQ(1u, service_.method(200).last_channel_id());
+}
+
 TEST_F(BasicServer, ProcessPacket_IncompletePacket_NothingIsInvoked) {
   EXPECT_EQ(Status::DataLoss(),
             server_.ProcessPacket(EncodePacket(PacketType::REQUEST, 0, 42, 101),
@@ -258,6 +298,148 @@ TEST_F(BasicServer, ProcessPacket_Cancel_MethodNotActive_SendsNothing) {
   EXPECT_EQ(output_.packet_count(), 0u);
 }
 
+TEST_F(BasicServer, ProcessPacket_Batch_ProcessesEachPacket) {
+  std::array<byte, 32> first;
+  std::array<byte, 32> second;
+  std::array<byte, 80> buffer;
+  internal::RpcPacketBatch::MemoryEncoder batch(buffer);
+  ASSERT_EQ(OkStatus(),
+            batch.WritePackets(*Packet(PacketType::REQUEST, 1, 42, 200)
+                                    .Encode(first)));
+  ASSERT_EQ(OkStatus(),
+            batch.WritePackets(*Packet(PacketType::REQUEST, 1, 42, 100)
+                                    .Encode(second)));
+
+  EXPECT_EQ(OkStatus(), server_.ProcessPacket(ConstByteSpan(batch), output_));
+
+  EXPECT_EQ(1u, service_.method(200).invocations());
+  EXPECT_EQ(1u, service_.method(100).invocations());
+}
+
+TEST_F(BasicServer, ProcessPacket_BatchWithClientPacket_InvalidArgument) {
+  std::array<byte, 32> first;
+  std::array<byte, 32> second;
+  std::array<byte, 80> buffer;
+  internal::RpcPacketBatch::MemoryEncoder batch(buffer);
+  ASSERT_EQ(OkStatus(),
+            batch.WritePackets(*Packet(PacketType::RESPONSE, 1, 42, 100)
+                                    .Encode(first)));
+  ASSERT_EQ(OkStatus(),
+            batch.WritePackets(*Packet(PacketType::REQUEST, 1, 42, 200)
+                                    .Encode(second)));
+
+  EXPECT_EQ(Status::InvalidArgument(),
+            server_.ProcessPacket(ConstByteSpan(batch), output_));
+
+  EXPECT_EQ(1u, service_.method(200).invocations());
+}
+
+TEST_F(BasicServer, ProcessPacket_NestedBatch_DataLoss) {
+  std::array<byte, 32> packet;
+  std::array<byte, 48> inner_buffer;
+  internal::RpcPacketBatch::MemoryEncoder inner(inner_buffer);
+  ASSERT_EQ(OkStatus(),
+            inner.WritePackets(*Packet(PacketType::REQUEST, 1, 42, 200)
+                                    .Encode(packet)));
+
+  std::array<byte, 64> buffer;
+  internal::RpcPacketBatch::MemoryEncoder batch(buffer);
+  ASSERT_EQ(OkStatus(), batch.WritePackets(ConstByteSpan(inner)));
+
+  EXPECT_EQ(Status::DataLoss(),
+            server_.ProcessPacket(ConstByteSpan(batch), output_));
+  EXPECT_EQ(0u, service_.method(200).invocations());
+}
+
+TEST_F(BasicServer, ProcessPacket_TimeoutElapsedWhileQueued_RejectsRequest) {
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(EncodeRequestWithTimeout(200, 10),
+                                  output_,
+                                  /*queued_ms=*/10));
+
+  EXPECT_EQ(0u, service_.method(200).invocations());
+  ASSERT_EQ(1u, output_.packet_count());
+  EXPECT_EQ(PacketType::SERVER_ERROR, output_.sent_packet().type());
+  EXPECT_EQ(Status::DeadlineExceeded(), output_.sent_packet().status());
+  EXPECT_EQ(200u, output_.sent_packet().method_id());
+}
+
+TEST_F(BasicServer, ProcessPacket_TimeoutNotElapsed_InvokesMethod) {
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(EncodeRequestWithTimeout(200, 10),
+                                  output_,
+                                  /*queued_ms=*/9));
+
+  EXPECT_EQ(1u, service_.method(200).invocations());
+}
+
+TEST_F(BasicServer, ProcessPacket_NoTimeout_InvokesMethodAfterQueueing) {
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(EncodeRequestWithTimeout(200, 0),
+                                  output_,
+                                  /*queued_ms=*/100000));
+
+  EXPECT_EQ(1u, service_.method(200).invocations());
+}
+
+class TestAdmissionControl : public AdmissionControl {
+ public:
+  Status Admit(const Request& request) override {
+    last_request = request;
+    calls += 1;
+    return result;
+  }
+
+  Status result = OkStatus();
+  Request last_request = {};
+  int calls = 0;
+};
+
+TEST_F(BasicServer, AdmissionControl_Admitted_InvokesMethod) {
+  TestAdmissionControl admission_control;
+  server_.set_admission_control(&admission_control);
+
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequestWithTimeout(200, 50), output_, /*queued_ms=*/5));
+
+  EXPECT_EQ(1, admission_control.calls);
+  EXPECT_EQ(1u, admission_control.last_request.channel_id);
+  EXPECT_EQ(42u, admission_control.last_request.service_id);
+  EXPECT_EQ(200u, admission_control.last_request.method_id);
+  EXPECT_EQ(50u, admission_control.last_request.timeout_ms);
+  EXPECT_EQ(5u, admission_control.last_request.queued_ms);
+  EXPECT_EQ(0u, admission_control.last_request.ongoing_service_calls);
+  EXPECT_EQ(1u, service_.method(200).invocations());
+}
+
+TEST_F(BasicServer, AdmissionControl_Rejected_SendsErrorWithoutInvoking) {
+  TestAdmissionControl admission_control;
+  admission_control.result = Status::Unavailable();
+  server_.set_admission_control(&admission_control);
+
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(EncodePacket(PacketType::REQUEST, 1, 42, 200),
+                                  output_));
+
+  EXPECT_EQ(0u, service_.method(200).invocations());
+  ASSERT_EQ(1u, output_.packet_count());
+  EXPECT_EQ(PacketType::SERVER_ERROR, output_.sent_packet().type());
+  EXPECT_EQ(Status::Unavailable(), output_.sent_packet().status());
+}
+
+TEST_F(BasicServer, AdmissionControl_ExpiredRequest_NotConsulted) {
+  TestAdmissionControl admission_control;
+  server_.set_admission_control(&admission_control);
+
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequestWithTimeout(200, 10), output_, /*queued_ms=*/20));
+
+  EXPECT_EQ(0, admission_control.calls);
+  EXPECT_EQ(Status::DeadlineExceeded(), output_.sent_packet().status());
+}
+
 class BidiMethod : public BasicServer {
  protected:
   BidiMethod()
@@ -291,6 +473,17 @@ TEST_F(BidiMethod, DuplicateCall_CancelsExistingThenCallsAgain) {
   EXPECT_EQ(method.invocations(), 1u);
 }
 
+TEST_F(BidiMethod, AdmissionControl_CountsOngoingCallsToService) {
+  TestAdmissionControl admission_control;
+  server_.set_admission_control(&admission_control);
+
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(EncodePacket(PacketType::REQUEST, 1, 42, 200),
+                                  output_));
+
+  EXPECT_EQ(1u, admission_control.last_request.ongoing_service_calls);
+}
+
 TEST_F(BidiMethod, Cancel_ClosesServerWriter) {
   EXPECT_EQ(OkStatus(), server_.ProcessPacket(EncodeCancel(), output_));
 
@@ -432,5 +625,105 @@ TEST_F(ServerStreamingMethod, ClientStreamEnd_InvalidArgumentError) {
   EXPECT_EQ(output_.sent_packet().status(), Status::InvalidArgument());
 }
 
+TEST_F(ServerStreamingMethod, NotFlowControlled_UnlimitedCredits) {
+  EXPECT_EQ(internal::Call::kUnlimitedCredits, responder_.available_credits());
+
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredit(5), output_));
+
+  EXPECT_EQ(output_.packet_count(), 0u);
+  EXPECT_EQ(internal::Call::kUnlimitedCredits, responder_.available_credits());
+}
+
+class FlowControlledStream : public BasicServer {
+ protected:
+  FlowControlledStream()
+      : call_(server_,
+              static_cast<internal::Channel&>(channels_[0]),
+              service_,
+              service_.method(100),
+              0,
+              /*stream_credits=*/2),
+        responder_(call_) {
+    ASSERT_TRUE(responder_.active());
+  }
+
+  internal::CallContext call_;
+  internal::test::FakeServerWriter responder_;
+};
+
+TEST_F(FlowControlledStream, Write_ConsumesCredits) {
+  EXPECT_EQ(2u, responder_.available_credits());
+
+  EXPECT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+  EXPECT_EQ(1u, responder_.available_credits());
+  EXPECT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+  EXPECT_EQ(0u, responder_.available_credits());
+
+  EXPECT_EQ(output_.packet_count(), 2u);
+}
+
+TEST_F(FlowControlledStream, Write_NoCredits_ReturnsUnavailable) {
+  ASSERT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+  ASSERT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+
+  EXPECT_EQ(Status::Unavailable(), responder_.Write(kDefaultPayload));
+  EXPECT_EQ(output_.packet_count(), 2u);
+  EXPECT_TRUE(responder_.active());
+}
+
+TEST_F(FlowControlledStream, Write_SendFails_ReturnsCredit) {
+  output_.set_send_status(Status::Unknown());
+
+  EXPECT_EQ(Status::Unknown(), responder_.Write(kDefaultPayload));
+  EXPECT_EQ(2u, responder_.available_credits());
+}
+
+TEST_F(FlowControlledStream, ClientCredit_AddsCredits) {
+  ASSERT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+  ASSERT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+  ASSERT_EQ(Status::Unavailable(), responder_.Write(kDefaultPayload));
+
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredit(3), output_));
+  EXPECT_EQ(3u, responder_.available_credits());
+
+  EXPECT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+  EXPECT_EQ(output_.packet_count(), 3u);
+}
+
+TEST_F(FlowControlledStream, ClientCredit_Saturates) {
+  ASSERT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeCredit(std::numeric_limits<uint32_t>::max()), output_));
+
+  EXPECT_EQ(internal::Call::kUnlimitedCredits - 1,
+            responder_.available_credits());
+}
+
+TEST_F(FlowControlledStream, ClientCredit_ClosedCall_Ignored) {
+  ASSERT_EQ(OkStatus(), responder_.Finish());
+
+  EXPECT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredit(3), output_));
+  EXPECT_EQ(output_.packet_count(), 1u);  // Only the response.
+}
+
+#if PW_RPC_ON_WRITABLE_CALLBACK
+
+TEST_F(FlowControlledStream, ClientCredit_OutOfCredits_CallsOnWritable) {
+  int writable = 0;
+  responder_.set_on_writable([&writable]() { writable += 1; });
+
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredit(1), output_));
+  EXPECT_EQ(writable, 0);  // Credits were still available.
+
+  ASSERT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+  ASSERT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+  ASSERT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredit(1), output_));
+  EXPECT_EQ(writable, 1);
+}
+
+#endif  // PW_RPC_ON_WRITABLE_CALLBACK
+
 }  // namespace
 }  // namespace pw::rpc
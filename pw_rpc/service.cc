@@ -20,20 +20,38 @@
 namespace pw::rpc {
 
 const internal::Method* Service::FindMethod(uint32_t method_id) const {
-  const internal::MethodUnion* method_impl = methods_;
+  if (method_count_ == 0u) {
+    return nullptr;
+  }
 
-  for (size_t i = 0; i < method_count_; ++i) {
-    const internal::Method* method = &method_impl->method();
-    if (method->id() == method_id) {
-      return method;
+  if (sorted_by_id_) {
+    // Branchless binary search: narrow the range to the last method with an ID
+    // less than or equal to method_id.
+    size_t first = 0;
+    for (size_t count = method_count_; count > 1u; count -= count / 2) {
+      const size_t middle = first + count / 2;
+      first = MethodAt(middle).id() <= method_id ? middle : first;
     }
 
-    const auto raw = reinterpret_cast<const std::byte*>(method_impl);
-    method_impl =
-        reinterpret_cast<const internal::MethodUnion*>(raw + method_size_);
+    const internal::Method& method = MethodAt(first);
+    return method.id() == method_id ? &method : nullptr;
+  }
+
+  for (size_t i = 0; i < method_count_; ++i) {
+    const internal::Method& method = MethodAt(i);
+    if (method.id() == method_id) {
+      return &method;
+    }
   }
 
   return nullptr;
 }
 
+const internal::Method& Service::MethodAt(size_t index) const {
+  const auto raw = reinterpret_cast<const std::byte*>(methods_);
+  return reinterpret_cast<const internal::MethodUnion*>(raw +
+                                                         index * method_size_)
+      ->method();
+}
+
 }  // namespace pw::rpc
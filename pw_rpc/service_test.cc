@@ -80,6 +80,37 @@ TEST(Service, MultipleMethods_FindMethod_NotPresent) {
   EXPECT_EQ(ServiceTestHelper::FindMethod(service, 999), nullptr);
 }
 
+class SortedTestService : public Service {
+ public:
+  constexpr SortedTestService()
+      : Service(0xabcd, kMethods, internal::MethodOrder::kSortedById) {}
+
+  static constexpr std::array<ServiceTestMethodUnion, 7> kMethods = {
+      ServiceTestMethod(2, 'a'),
+      ServiceTestMethod(3, 'b'),
+      ServiceTestMethod(5, 'c'),
+      ServiceTestMethod(7, 'd'),
+      ServiceTestMethod(11, 'e'),
+      ServiceTestMethod(13, 'f'),
+      ServiceTestMethod(0xffffffff, 'g'),
+  };
+};
+
+TEST(Service, SortedMethods_FindMethod_Present) {
+  SortedTestService service;
+  for (const ServiceTestMethodUnion& method : SortedTestService::kMethods) {
+    EXPECT_EQ(ServiceTestHelper::FindMethod(service, method.method().id()),
+              &method.method());
+  }
+}
+
+TEST(Service, SortedMethods_FindMethod_NotPresent) {
+  SortedTestService service;
+  for (uint32_t id : {0u, 1u, 4u, 6u, 12u, 14u, 0xfffffffeu}) {
+    EXPECT_EQ(ServiceTestHelper::FindMethod(service, id), nullptr);
+  }
+}
+
 class EmptyTestService : public Service {
  public:
   constexpr EmptyTestService() : Service(0xabcd, kMethods) {}
@@ -0,0 +1,93 @@
+// Copyright 2022 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/synchronized_channel_output.h"
+
+#include <algorithm>
+#include <array>
+
+#include "gtest/gtest.h"
+
+namespace pw::rpc {
+namespace {
+
+class TestOutput : public ChannelOutput {
+ public:
+  TestOutput(const char* name) : ChannelOutput(name) {}
+
+  std::span<std::byte> AcquireBuffer() override { return buffer_; }
+
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) override {
+    if (!buffer.empty()) {
+      packets_sent += 1;
+      last_packet_size = buffer.size();
+    }
+    return OkStatus();
+  }
+
+  size_t packets_sent = 0;
+  size_t last_packet_size = 0;
+
+ private:
+  std::array<std::byte, 16> buffer_;
+};
+
+TEST(SynchronizedChannelOutput, SendsThroughBaseOutput) {
+  sync::Mutex mutex;
+  SynchronizedChannelOutput<TestOutput> output(mutex, "test");
+
+  std::span<std::byte> buffer = output.AcquireBuffer();
+  ASSERT_EQ(16u, buffer.size());
+  std::fill_n(buffer.begin(), 5, std::byte{0x0f});
+  EXPECT_EQ(OkStatus(), output.SendAndReleaseBuffer(buffer.first(5)));
+
+  EXPECT_EQ(1u, output.packets_sent);
+  EXPECT_EQ(5u, output.last_packet_size);
+  EXPECT_STREQ("test", output.name());
+}
+
+TEST(SynchronizedChannelOutput, ReleasesMutexAfterSend) {
+  sync::Mutex mutex;
+  SynchronizedChannelOutput<TestOutput> output(mutex, "test");
+
+  output.DiscardBuffer(output.AcquireBuffer());
+  ASSERT_TRUE(mutex.try_lock());
+  mutex.unlock();
+
+  output.DiscardBuffer(output.AcquireBuffer());
+  EXPECT_EQ(0u, output.packets_sent);
+}
+
+TEST(SynchronizedChannelOutputWithMutex, OutputsLockIndependently) {
+  SynchronizedChannelOutputWithMutex<TestOutput> uart("uart");
+  SynchronizedChannelOutputWithMutex<TestOutput> usb("usb");
+
+  // Holding one output's buffer does not block sending on the other. If the
+  // outputs shared a mutex, acquiring the second buffer would deadlock.
+  std::span<std::byte> uart_buffer = uart.AcquireBuffer();
+
+  std::span<std::byte> usb_buffer = usb.AcquireBuffer();
+  EXPECT_NE(uart_buffer.data(), usb_buffer.data());
+  EXPECT_EQ(OkStatus(), usb.SendAndReleaseBuffer(usb_buffer.first(3)));
+
+  EXPECT_EQ(OkStatus(), uart.SendAndReleaseBuffer(uart_buffer.first(7)));
+
+  EXPECT_EQ(1u, usb.packets_sent);
+  EXPECT_EQ(3u, usb.last_packet_size);
+  EXPECT_EQ(1u, uart.packets_sent);
+  EXPECT_EQ(7u, uart.last_packet_size);
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -0,0 +1,132 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/work_queue_dispatcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+#include "pw_log/log.h"
+#include "pw_rpc/internal/packet.h"
+
+namespace pw::rpc {
+
+using internal::Packet;
+
+Status DispatchQueue::Enqueue(std::span<const std::byte> packet_data,
+                              ChannelOutput& output) {
+  if (packet_data.size() > max_packet_size_) {
+    return Status::OutOfRange();
+  }
+
+  PendingPacket* pending = nullptr;
+  {
+    std::lock_guard lock(lock_);
+    for (PendingPacket& packet : packets_) {
+      if (!packet.in_use) {
+        packet.in_use = true;
+        pending = &packet;
+        break;
+      }
+    }
+  }
+
+  if (pending == nullptr) {
+    return Status::ResourceExhausted();
+  }
+
+  std::memcpy(pending->data, packet_data.data(), packet_data.size());
+  pending->size = packet_data.size();
+  pending->output = &output;
+  pending->received = chrono::SystemClock::now();
+
+  // The work item only captures a pointer so that it always fits in the
+  // work_queue::WorkItem's inline storage.
+  const Status status =
+      work_queue_.PushWork([pending] { ProcessPending(*pending); });
+
+  if (!status.ok()) {
+    std::lock_guard lock(pending->queue->lock_);
+    pending->in_use = false;
+  }
+  return status;
+}
+
+void DispatchQueue::ProcessPending(PendingPacket& packet) {
+  DispatchQueue& queue = *packet.queue;
+
+  const int64_t queued_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          chrono::SystemClock::now() - packet.received)
+          .count();
+
+  // The packet was already validated when it was routed, so errors are not
+  // expected. Any responses are sent by the server.
+  queue.server_
+      ->ProcessPacket(std::span(packet.data, packet.size),
+                      *packet.output,
+                      static_cast<uint32_t>(std::clamp<int64_t>(
+                          queued_ms, 0, std::numeric_limits<uint32_t>::max())))
+      .IgnoreError();
+
+  std::lock_guard lock(queue.lock_);
+  packet.in_use = false;
+}
+
+void WorkQueueDispatcher::AddQueue(DispatchQueue& queue) {
+  queue.server_ = &server_;
+
+  // Service-specific queues are searched first.
+  if (queue.service_id() == DispatchQueue::kAnyService) {
+    queues_.push_back(queue);
+  } else {
+    queues_.push_front(queue);
+  }
+}
+
+Status WorkQueueDispatcher::ProcessPacket(
+    std::span<const std::byte> packet_data, ChannelOutput& interface) {
+  Result<Packet> result = Packet::FromBuffer(packet_data);
+  if (!result.ok()) {
+    PW_LOG_WARN("Failed to decode pw_rpc packet");
+    return Status::DataLoss();
+  }
+
+  if (result->destination() != Packet::kServer) {
+    return Status::InvalidArgument();
+  }
+
+  DispatchQueue* queue =
+      FindQueue(result->channel_id(), result->service_id());
+  if (queue == nullptr) {
+    return server_.ProcessPacket(packet_data, interface);
+  }
+
+  return queue->Enqueue(packet_data, interface);
+}
+
+DispatchQueue* WorkQueueDispatcher::FindQueue(uint32_t channel_id,
+                                              uint32_t service_id) {
+  for (DispatchQueue& queue : queues_) {
+    if (queue.Matches(channel_id, service_id)) {
+      return &queue;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace pw::rpc
@@ -0,0 +1,241 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/work_queue_dispatcher.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/internal/test_method.h"
+#include "pw_rpc/internal/test_utils.h"
+#include "pw_rpc/service.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread.h"
+#include "pw_work_queue/test_thread.h"
+
+namespace pw::rpc {
+namespace {
+
+using std::byte;
+
+using internal::Packet;
+using internal::PacketType;
+using internal::TestMethod;
+using internal::TestMethodUnion;
+
+class TestService : public Service {
+ public:
+  TestService(uint32_t service_id)
+      : Service(service_id, methods_), methods_{TestMethod(100)} {}
+
+  const TestMethod& method() { return methods_[0].test_method(); }
+
+ private:
+  std::array<TestMethodUnion, 1> methods_;
+};
+
+class WorkQueueDispatcherTest : public ::testing::Test {
+ protected:
+  WorkQueueDispatcherTest()
+      : channels_{
+            Channel::Create<1>(&output_),
+            Channel::Create<2>(&output_),
+        },
+        server_(channels_),
+        service_42_(42),
+        service_43_(43),
+        dispatcher_(server_) {
+    server_.RegisterService(service_42_);
+    server_.RegisterService(service_43_);
+  }
+
+  ConstByteSpan EncodeRequest(uint32_t channel_id,
+                              uint32_t service_id,
+                              uint32_t timeout_ms = 0) {
+    Packet packet(PacketType::REQUEST, channel_id, service_id, 100);
+    packet.set_timeout_ms(timeout_ms);
+    auto result = packet.Encode(request_buffer_);
+    EXPECT_EQ(OkStatus(), result.status());
+    return result.value_or(ConstByteSpan());
+  }
+
+  // Blocks until all work previously pushed to the queue has run.
+  static void Flush(work_queue::WorkQueue& work_queue) {
+    sync::ThreadNotification done;
+    ASSERT_EQ(OkStatus(), work_queue.PushWork([&done] { done.release(); }));
+    done.acquire();
+  }
+
+  internal::TestOutput<128> output_;
+  std::array<Channel, 2> channels_;
+  Server server_;
+  TestService service_42_;
+  TestService service_43_;
+  WorkQueueDispatcher dispatcher_;
+
+ private:
+  byte request_buffer_[64];
+};
+
+TEST_F(WorkQueueDispatcherTest, NoQueue_ProcessesInline) {
+  EXPECT_EQ(OkStatus(),
+            dispatcher_.ProcessPacket(EncodeRequest(1, 42), output_));
+  EXPECT_EQ(1u, service_42_.method().invocations());
+  EXPECT_EQ(1u, service_42_.method().last_channel_id());
+}
+
+TEST_F(WorkQueueDispatcherTest, InvalidPackets_NotQueued) {
+  constexpr byte kGarbage[] = {byte{0xff}, byte{0xff}, byte{0xff}};
+  EXPECT_EQ(Status::DataLoss(), dispatcher_.ProcessPacket(kGarbage, output_));
+
+  byte buffer[64];
+  auto response = Packet(PacketType::RESPONSE, 1, 42, 100).Encode(buffer);
+  ASSERT_EQ(OkStatus(), response.status());
+  EXPECT_EQ(Status::InvalidArgument(),
+            dispatcher_.ProcessPacket(*response, output_));
+}
+
+TEST_F(WorkQueueDispatcherTest, ChannelQueue_ProcessesOnWorkQueue) {
+  work_queue::WorkQueueWithBuffer<4> work_queue;
+  DispatchQueueWithBuffer<64, 2> queue(work_queue, 1);
+  dispatcher_.AddQueue(queue);
+
+  // The work queue thread is not running, so the packet stays queued.
+  EXPECT_EQ(OkStatus(),
+            dispatcher_.ProcessPacket(EncodeRequest(1, 42), output_));
+  EXPECT_EQ(0u, service_42_.method().invocations());
+
+  // Packets for other channels are still processed inline.
+  EXPECT_EQ(OkStatus(),
+            dispatcher_.ProcessPacket(EncodeRequest(2, 42), output_));
+  EXPECT_EQ(1u, service_42_.method().invocations());
+  EXPECT_EQ(2u, service_42_.method().last_channel_id());
+
+  thread::Thread work_thread(work_queue::test::WorkQueueThreadOptions(),
+                             work_queue);
+  Flush(work_queue);
+
+  EXPECT_EQ(2u, service_42_.method().invocations());
+  EXPECT_EQ(1u, service_42_.method().last_channel_id());
+
+  work_queue.RequestStop();
+  work_thread.join();
+}
+
+TEST_F(WorkQueueDispatcherTest, ServiceQueue_TakesPriorityOverChannelQueue) {
+  work_queue::WorkQueueWithBuffer<4> channel_work_queue;
+  work_queue::WorkQueueWithBuffer<4> service_work_queue;
+  DispatchQueueWithBuffer<64, 2> channel_queue(channel_work_queue, 1);
+  DispatchQueueWithBuffer<64, 2> service_queue(service_work_queue, 1, 43);
+  dispatcher_.AddQueue(channel_queue);
+  dispatcher_.AddQueue(service_queue);
+
+  EXPECT_EQ(OkStatus(),
+            dispatcher_.ProcessPacket(EncodeRequest(1, 42), output_));
+  EXPECT_EQ(OkStatus(),
+            dispatcher_.ProcessPacket(EncodeRequest(1, 43), output_));
+
+  thread::Thread service_thread(work_queue::test::WorkQueueThreadOptions(),
+                                service_work_queue);
+  Flush(service_work_queue);
+
+  EXPECT_EQ(0u, service_42_.method().invocations());
+  EXPECT_EQ(1u, service_43_.method().invocations());
+
+  thread::Thread channel_thread(work_queue::test::WorkQueueThreadOptions(),
+                                channel_work_queue);
+  Flush(channel_work_queue);
+
+  EXPECT_EQ(1u, service_42_.method().invocations());
+
+  service_work_queue.RequestStop();
+  service_thread.join();
+  channel_work_queue.RequestStop();
+  channel_thread.join();
+}
+
+TEST_F(WorkQueueDispatcherTest, AllBuffersInUse_ResourceExhausted) {
+  work_queue::WorkQueueWithBuffer<4> work_queue;
+  DispatchQueueWithBuffer<64, 2> queue(work_queue, 1);
+  dispatcher_.AddQueue(queue);
+
+  EXPECT_EQ(OkStatus(),
+            dispatcher_.ProcessPacket(EncodeRequest(1, 42), output_));
+  EXPECT_EQ(OkStatus(),
+            dispatcher_.ProcessPacket(EncodeRequest(1, 42), output_));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            dispatcher_.ProcessPacket(EncodeRequest(1, 42), output_));
+
+  thread::Thread work_thread(work_queue::test::WorkQueueThreadOptions(),
+                             work_queue);
+  Flush(work_queue);
+  EXPECT_EQ(2u, service_42_.method().invocations());
+
+  // The buffers are released once the packets are processed.
+  EXPECT_EQ(OkStatus(),
+            dispatcher_.ProcessPacket(EncodeRequest(1, 42), output_));
+  Flush(work_queue);
+  EXPECT_EQ(3u, service_42_.method().invocations());
+
+  work_queue.RequestStop();
+  work_thread.join();
+}
+
+TEST_F(WorkQueueDispatcherTest, TimeoutElapsedInQueue_DeadlineExceeded) {
+  work_queue::WorkQueueWithBuffer<4> work_queue;
+  DispatchQueueWithBuffer<64, 2> queue(work_queue, 1);
+  dispatcher_.AddQueue(queue);
+
+  EXPECT_EQ(OkStatus(),
+            dispatcher_.ProcessPacket(EncodeRequest(1, 42, 1), output_));
+
+  // Wait for the first request's timeout to pass while it is queued.
+  const auto enqueued = chrono::SystemClock::now();
+  while (chrono::SystemClock::now() - enqueued < std::chrono::milliseconds(5)) {
+  }
+
+  thread::Thread work_thread(work_queue::test::WorkQueueThreadOptions(),
+                             work_queue);
+  Flush(work_queue);
+
+  EXPECT_EQ(0u, service_42_.method().invocations());
+  EXPECT_EQ(1u, output_.packet_count());
+  EXPECT_EQ(PacketType::SERVER_ERROR, output_.sent_packet().type());
+  EXPECT_EQ(Status::DeadlineExceeded(), output_.sent_packet().status());
+
+  // A request with a timeout that has not elapsed is processed.
+  EXPECT_EQ(OkStatus(),
+            dispatcher_.ProcessPacket(EncodeRequest(1, 42, 60000), output_));
+  Flush(work_queue);
+  EXPECT_EQ(1u, service_42_.method().invocations());
+
+  work_queue.RequestStop();
+  work_thread.join();
+}
+
+TEST_F(WorkQueueDispatcherTest, PacketTooLarge_OutOfRange) {
+  work_queue::WorkQueueWithBuffer<4> work_queue;
+  DispatchQueueWithBuffer<4, 1> queue(work_queue, 1);
+  dispatcher_.AddQueue(queue);
+
+  EXPECT_EQ(Status::OutOfRange(),
+            dispatcher_.ProcessPacket(EncodeRequest(1, 42), output_));
+  EXPECT_EQ(0u, service_42_.method().invocations());
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -0,0 +1,44 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_snapshot/capture.h"
+
+#include <algorithm>
+
+namespace pw::snapshot {
+
+Status SnapshotCapture::StageWriter::DoWrite(ConstByteSpan data) {
+  // The encoder checks the limit before writing each field, so this only
+  // rejects writes that would otherwise leave a partial field behind.
+  if (data.size() > bytes_remaining_) {
+    return Status::ResourceExhausted();
+  }
+
+  Status status = writer_.Write(data);
+  if (status.ok()) {
+    bytes_remaining_ -= data.size();
+    bytes_written_ += data.size();
+  }
+  return status;
+}
+
+size_t SnapshotCapture::StageWriter::ConservativeLimit(
+    LimitType limit_type) const {
+  if (limit_type != LimitType::kWrite) {
+    return 0;
+  }
+  return std::min(bytes_remaining_, writer_.ConservativeWriteLimit());
+}
+
+}  // namespace pw::snapshot
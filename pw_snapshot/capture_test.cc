@@ -0,0 +1,152 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_snapshot/capture.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_persistent_ram/persistent_buffer.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::snapshot {
+namespace {
+
+constexpr uint32_t kNameField = 1;
+constexpr uint32_t kDataField = 2;
+constexpr uint32_t kNestedField = 3;
+
+constexpr auto kData = bytes::Initialized<32>([](size_t i) { return i; });
+
+class SnapshotCaptureTest : public ::testing::Test {
+ protected:
+  SnapshotCaptureTest() : writer_(buffer_), capture_(writer_, scratch_) {}
+
+  // Counts the fields in the captured data, failing if it does not decode.
+  size_t CountFields(uint32_t field_number) {
+    protobuf::Decoder decoder(writer_.WrittenData());
+    size_t count = 0;
+    Status status;
+    while ((status = decoder.Next()).ok()) {
+      if (decoder.FieldNumber() == field_number) {
+        count += 1;
+      }
+    }
+    EXPECT_EQ(Status::OutOfRange(), status);
+    return count;
+  }
+
+  std::array<std::byte, 256> buffer_ = {};
+  std::array<std::byte, 16> scratch_ = {};
+  stream::MemoryWriter writer_;
+  SnapshotCapture capture_;
+};
+
+TEST_F(SnapshotCaptureTest, StagesAreConcatenated) {
+  EXPECT_EQ(OkStatus(),
+            capture_.CaptureStage(64, [](protobuf::StreamEncoder& encoder) {
+              return encoder.WriteString(kNameField, "crash");
+            }));
+  EXPECT_EQ(OkStatus(),
+            capture_.CaptureStage(64, [](protobuf::StreamEncoder& encoder) {
+              return encoder.WriteBytes(kDataField, kData);
+            }));
+
+  EXPECT_EQ(writer_.bytes_written(), capture_.bytes_written());
+  EXPECT_EQ(1u, CountFields(kNameField));
+  EXPECT_EQ(1u, CountFields(kDataField));
+}
+
+TEST_F(SnapshotCaptureTest, StageOverLimit_KeepsWholeFields) {
+  // Each field takes 34 bytes, so only one fits in the stage.
+  EXPECT_EQ(Status::ResourceExhausted(),
+            capture_.CaptureStage(40, [](protobuf::StreamEncoder& encoder) {
+              encoder.WriteBytes(kDataField, kData).IgnoreError();
+              return encoder.WriteBytes(kDataField, kData);
+            }));
+  EXPECT_EQ(34u, capture_.bytes_written());
+
+  // Later stages have budgets of their own.
+  EXPECT_EQ(OkStatus(),
+            capture_.CaptureStage(16, [](protobuf::StreamEncoder& encoder) {
+              return encoder.WriteString(kNameField, "crash");
+            }));
+
+  EXPECT_EQ(1u, CountFields(kDataField));
+  EXPECT_EQ(1u, CountFields(kNameField));
+}
+
+TEST_F(SnapshotCaptureTest, SizedSubmessage_NeedsNoScratch) {
+  // The submessage is larger than the scratch buffer, but its size is known,
+  // so it is written directly.
+  EXPECT_EQ(OkStatus(),
+            capture_.CaptureStage(64, [](protobuf::StreamEncoder& encoder) {
+              protobuf::StreamEncoder nested =
+                  encoder.GetNestedEncoder(kNestedField, 2 + kData.size());
+              return nested.WriteBytes(kDataField, kData);
+            }));
+  EXPECT_EQ(1u, CountFields(kNestedField));
+}
+
+TEST_F(SnapshotCaptureTest, UnsizedSubmessageLargerThanScratch_Fails) {
+  EXPECT_EQ(Status::ResourceExhausted(),
+            capture_.CaptureStage(64, [](protobuf::StreamEncoder& encoder) {
+              protobuf::StreamEncoder nested =
+                  encoder.GetNestedEncoder(kNestedField);
+              return nested.WriteBytes(kDataField, kData);
+            }));
+  EXPECT_EQ(0u, capture_.bytes_written());
+}
+
+TEST_F(SnapshotCaptureTest, CaptureFunctionError_IsReturned) {
+  EXPECT_EQ(Status::Unavailable(),
+            capture_.CaptureStage(64, [](protobuf::StreamEncoder& encoder) {
+              encoder.WriteString(kNameField, "crash").IgnoreError();
+              return Status::Unavailable();
+            }));
+  EXPECT_EQ(1u, CountFields(kNameField));
+}
+
+TEST(SnapshotCapture, WritesToPersistentBuffer) {
+  persistent_ram::PersistentBuffer<48> persistent_buffer;
+  persistent_buffer.clear();
+  persistent_ram::PersistentBufferWriter writer =
+      persistent_buffer.GetWriter();
+  SnapshotCapture capture(writer, ByteSpan());
+
+  EXPECT_EQ(OkStatus(),
+            capture.CaptureStage(64, [](protobuf::StreamEncoder& encoder) {
+              return encoder.WriteBytes(kDataField, kData);
+            }));
+
+  // The buffer's own limit applies too.
+  EXPECT_EQ(Status::ResourceExhausted(),
+            capture.CaptureStage(64, [](protobuf::StreamEncoder& encoder) {
+              return encoder.WriteBytes(kDataField, kData);
+            }));
+
+  ASSERT_TRUE(persistent_buffer.has_value());
+  EXPECT_EQ(34u, persistent_buffer.size());
+  EXPECT_EQ(0,
+            std::memcmp(
+                persistent_buffer.data() + 2, kData.data(), kData.size()));
+}
+
+}  // namespace
+}  // namespace pw::snapshot
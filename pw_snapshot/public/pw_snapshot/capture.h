@@ -0,0 +1,112 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "pw_bytes/span.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::snapshot {
+
+// Captures a snapshot by streaming it to a writer in stages, without staging
+// the snapshot in RAM. The writer is typically a pw::blob_store BlobWriter or
+// a pw::persistent_ram PersistentBufferWriter, so a crash handler can write
+// thread stacks, logs, and metrics directly to persistent storage.
+//
+// Each stage encodes some fields of the Snapshot proto with its own encoder
+// and may write at most a given number of bytes. A field that does not fit in
+// what remains of its stage is not written at all, so the stage ends with
+// RESOURCE_EXHAUSTED and the snapshot stays a valid proto; later stages still
+// run with their own budgets. Since proto messages can be concatenated, the
+// stages together form one Snapshot message.
+//
+// The scratch buffer is only used for submessages encoded with
+// GetNestedEncoder(field_number), which are buffered until they are complete.
+// Submessages whose size is known in advance should be encoded with
+// GetNestedEncoder(field_number, payload_size) instead, which writes them
+// straight to the writer. With that, a small fixed scratch buffer suffices no
+// matter how large the snapshot is.
+//
+//   pw::snapshot::SnapshotCapture capture(blob_writer, scratch_buffer);
+//
+//   capture.CaptureStage<pw::snapshot::Snapshot::StreamEncoder>(
+//       256, [](pw::snapshot::Snapshot::StreamEncoder& snapshot) {
+//         return EncodeMetadata(snapshot.GetMetadataEncoder());
+//       });
+//   capture.CaptureStage(8 * 1024, [](pw::protobuf::StreamEncoder& snapshot) {
+//     return EncodeThreads(snapshot);
+//   });
+class SnapshotCapture {
+ public:
+  constexpr SnapshotCapture(stream::Writer& writer, ByteSpan scratch_buffer)
+      : writer_(writer), scratch_buffer_(scratch_buffer), bytes_written_(0) {}
+
+  SnapshotCapture(const SnapshotCapture&) = delete;
+  SnapshotCapture& operator=(const SnapshotCapture&) = delete;
+
+  // Runs a stage of the capture. The capture function is called with an
+  // encoder of type Encoder, which is pw::protobuf::StreamEncoder or a
+  // generated pw_protobuf StreamEncoder, and returns a Status. The stage may
+  // write at most max_size bytes.
+  //
+  // Returns:
+  //   OK - The stage was captured in full.
+  //   RESOURCE_EXHAUSTED - The stage exceeded max_size, the writer's limit, or
+  //       the scratch buffer. The fields written before that are kept.
+  //   Any other status returned by the capture function or the writer.
+  template <typename Encoder = protobuf::StreamEncoder, typename Function>
+  Status CaptureStage(size_t max_size, Function&& capture) {
+    StageWriter stage(writer_, max_size);
+    Status status;
+    {
+      Encoder encoder(stage, scratch_buffer_);
+      status = std::forward<Function>(capture)(encoder);
+      status.Update(encoder.status());
+    }
+    bytes_written_ += stage.bytes_written();
+    return status;
+  }
+
+  // The total number of bytes written by all stages.
+  size_t bytes_written() const { return bytes_written_; }
+
+ private:
+  // Forwards writes to the snapshot's writer, up to the stage's size limit.
+  class StageWriter final : public stream::NonSeekableWriter {
+   public:
+    constexpr StageWriter(stream::Writer& writer, size_t max_size)
+        : writer_(writer), bytes_remaining_(max_size), bytes_written_(0) {}
+
+    size_t bytes_written() const { return bytes_written_; }
+
+   private:
+    Status DoWrite(ConstByteSpan data) final;
+
+    size_t ConservativeLimit(LimitType limit_type) const final;
+
+    stream::Writer& writer_;
+    size_t bytes_remaining_;
+    size_t bytes_written_;
+  };
+
+  stream::Writer& writer_;
+  ByteSpan scratch_buffer_;
+  size_t bytes_written_;
+};
+
+}  // namespace pw::snapshot
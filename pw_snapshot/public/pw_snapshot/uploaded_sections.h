@@ -0,0 +1,144 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_checksum/crc32.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_status/status.h"
+
+namespace pw::snapshot {
+
+// Tracks the large sections of snapshots, such as thread stacks, that have
+// already been uploaded to the host, so later snapshots of the same build can
+// refer to a section by its CRC32 instead of sending it again. The host keeps
+// uploaded sections in a cache keyed by the snapshot's build UUID, and
+// restores omitted sections from it; see pw_snapshot/processor.py.
+//
+// Sections are written with WriteSection. Sections that are written in full
+// are remembered as pending; MarkUploaded() should be called once the host has
+// received the snapshot, after which snapshots omit them. When full, the oldest
+// section is forgotten.
+//
+// UploadedSections has no pointers, so it may be kept in persistent RAM (with
+// pw::persistent_ram::Persistent) or stored in a key-value store across the
+// reboot that follows a crash.
+//
+//   // In the crash handler:
+//   uploaded_sections.SetBuildId(pw::build_info::BuildId());
+//   uploaded_sections.WriteSection(thread_encoder,
+//                                  Thread::Fields::RAW_STACK,
+//                                  Thread::Fields::RAW_STACK_CRC32,
+//                                  stack);
+//
+//   // After the snapshot is uploaded:
+//   uploaded_sections.MarkUploaded();
+template <size_t kMaxSections>
+class UploadedSections {
+ public:
+  static_assert(kMaxSections > 0u);
+
+  constexpr UploadedSections() = default;
+
+  // Sets the build whose sections are tracked. If the build ID differs from
+  // the one the sections were recorded for, all sections are forgotten. This
+  // should be the build ID written to the snapshot's software_build_uuid.
+  void SetBuildId(ConstByteSpan build_id) {
+    const uint32_t build_id_crc32 = checksum::Crc32::Calculate(build_id);
+    if (build_id_crc32 != build_id_crc32_ ||
+        build_id.size() != build_id_size_bytes_) {
+      Clear();
+      build_id_crc32_ = build_id_crc32;
+      build_id_size_bytes_ = build_id.size();
+    }
+  }
+
+  // Writes data to data_field, or, if a section with the same contents has
+  // been uploaded, only its CRC32 to crc32_field as a fixed32.
+  Status WriteSection(protobuf::StreamEncoder& encoder,
+                      uint32_t data_field,
+                      uint32_t crc32_field,
+                      ConstByteSpan data) {
+    const Section section{checksum::Crc32::Calculate(data), data.size(), false};
+    Section* const existing = Find(section);
+
+    if (existing != nullptr && existing->uploaded) {
+      return encoder.WriteFixed32(crc32_field, section.crc32);
+    }
+
+    const Status status = encoder.WriteBytes(data_field, data);
+    if (status.ok() && existing == nullptr) {
+      sections_[next_] = section;
+      next_ = (next_ + 1) % kMaxSections;
+      count_ = count_ < kMaxSections ? count_ + 1 : count_;
+    }
+    return status;
+  }
+
+  template <typename FieldEnum>
+  Status WriteSection(protobuf::StreamEncoder& encoder,
+                      FieldEnum data_field,
+                      FieldEnum crc32_field,
+                      ConstByteSpan data) {
+    return WriteSection(encoder,
+                        static_cast<uint32_t>(data_field),
+                        static_cast<uint32_t>(crc32_field),
+                        data);
+  }
+
+  // Marks the sections written in full since the last call as uploaded.
+  void MarkUploaded() {
+    for (size_t i = 0; i < count_; ++i) {
+      sections_[i].uploaded = true;
+    }
+  }
+
+  // Forgets all sections.
+  void Clear() {
+    count_ = 0;
+    next_ = 0;
+  }
+
+  // The number of sections tracked, uploaded or not.
+  size_t size() const { return count_; }
+
+ private:
+  struct Section {
+    uint32_t crc32;
+    size_t size_bytes;
+    bool uploaded;
+  };
+
+  Section* Find(const Section& section) {
+    for (size_t i = 0; i < count_; ++i) {
+      if (sections_[i].crc32 == section.crc32 &&
+          sections_[i].size_bytes == section.size_bytes) {
+        return &sections_[i];
+      }
+    }
+    return nullptr;
+  }
+
+  uint32_t build_id_crc32_ = 0;
+  size_t build_id_size_bytes_ = 0;
+  std::array<Section, kMaxSections> sections_ = {};
+  size_t count_ = 0;
+  size_t next_ = 0;
+};
+
+}  // namespace pw::snapshot
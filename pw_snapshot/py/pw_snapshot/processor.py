@@ -14,14 +14,18 @@
 """Tool for processing and outputting Snapshot protos as text"""
 
 import argparse
+import concurrent.futures
 import sys
+import threading
 from pathlib import Path
-from typing import Optional, BinaryIO, TextIO, Callable
+from typing import (Optional, BinaryIO, TextIO, Callable, Dict, Iterable, List,
+                    Tuple)
 import pw_tokenizer
 import pw_cpu_exception_cortex_m
+from pw_snapshot import section_cache
 from pw_snapshot_metadata import metadata
 from pw_snapshot_protos import snapshot_pb2
-from pw_symbolizer import LlvmSymbolizer
+from pw_symbolizer import CachedSymbolizer, LlvmSymbolizer, Symbolizer
 from pw_thread import thread_analyzer
 
 _BRANDING = """
@@ -43,14 +47,53 @@ _BRANDING = """
 # whether a suitable ELF file can be provided for symbolization.
 ElfMatcher = Callable[[snapshot_pb2.Snapshot], Optional[Path]]
 
+UserProcessingCallback = Callable[[bytes], str]
+
+# Symbolizers are kept open for reuse by every snapshot built from the same
+# ELF, rather than starting a new llvm-symbolizer process per snapshot.
+_symbolizers: Dict[Tuple[Optional[Path], Optional[Path]], Symbolizer] = {}
+_symbolizers_lock = threading.Lock()
+
+
+def _get_symbolizer(elf: Optional[Path],
+                    cache_dir: Optional[Path]) -> Symbolizer:
+    with _symbolizers_lock:
+        key = (elf, cache_dir)
+        if key not in _symbolizers:
+            if elf is not None and cache_dir is not None:
+                _symbolizers[key] = CachedSymbolizer.for_elf(elf, cache_dir)
+            else:
+                _symbolizers[key] = LlvmSymbolizer(elf)
+        return _symbolizers[key]
+
 
 def process_snapshot(serialized_snapshot: bytes,
                      detokenizer: Optional[pw_tokenizer.Detokenizer] = None,
-                     elf_matcher: Optional[ElfMatcher] = None) -> str:
-    """Processes a single snapshot."""
+                     elf_matcher: Optional[ElfMatcher] = None,
+                     symbolizer_cache_dir: Optional[Path] = None,
+                     section_cache_dir: Optional[Path] = None) -> str:
+    """Processes a single snapshot.
+
+    If symbolizer_cache_dir is provided, symbols are cached there for each
+    build of an ELF, so later snapshots from the same build are symbolized
+    without invoking llvm-symbolizer.
+
+    If section_cache_dir is provided, the snapshot's large sections are cached
+    there, and sections the device omitted because an earlier snapshot of the
+    same build uploaded them are restored from it.
+    """
 
     output = [_BRANDING]
 
+    if section_cache_dir is not None:
+        serialized_snapshot, missing = section_cache.restore_sections(
+            serialized_snapshot, section_cache_dir)
+        if missing:
+            output.append('Sections omitted by the device and not found in '
+                          'the section cache:')
+            output.extend(f'  {section}' for section in missing)
+            output.append('')
+
     captured_metadata = metadata.process_snapshot(serialized_snapshot,
                                                   detokenizer)
     if captured_metadata:
@@ -59,10 +102,9 @@ def process_snapshot(serialized_snapshot: bytes,
     # Open a symbolizer.
     snapshot = snapshot_pb2.Snapshot()
     snapshot.ParseFromString(serialized_snapshot)
-    if elf_matcher is not None:
-        symbolizer = LlvmSymbolizer(elf_matcher(snapshot))
-    else:
-        symbolizer = LlvmSymbolizer()
+    symbolizer = _get_symbolizer(
+        elf_matcher(snapshot) if elf_matcher is not None else None,
+        symbolizer_cache_dir)
 
     cortex_m_cpu_state = pw_cpu_exception_cortex_m.process_snapshot(
         serialized_snapshot)
@@ -74,6 +116,9 @@ def process_snapshot(serialized_snapshot: bytes,
     if thread_info:
         output.append(thread_info)
 
+    if isinstance(symbolizer, CachedSymbolizer):
+        symbolizer.save()
+
     # Check and emit the number of related snapshots embedded in this snapshot.
     if snapshot.related_snapshots:
         snapshot_count = len(snapshot.related_snapshots)
@@ -90,13 +135,15 @@ def process_snapshots(
         serialized_snapshot: bytes,
         detokenizer: Optional[pw_tokenizer.Detokenizer] = None,
         elf_matcher: Optional[ElfMatcher] = None,
-        user_processing_callback: Optional[Callable[[bytes],
-                                                    str]] = None) -> str:
+        user_processing_callback: Optional[UserProcessingCallback] = None,
+        symbolizer_cache_dir: Optional[Path] = None,
+        section_cache_dir: Optional[Path] = None) -> str:
     """Processes a snapshot that may have multiple embedded snapshots."""
     output = []
     # Process the top-level snapshot.
     output.append(
-        process_snapshot(serialized_snapshot, detokenizer, elf_matcher))
+        process_snapshot(serialized_snapshot, detokenizer, elf_matcher,
+                         symbolizer_cache_dir, section_cache_dir))
 
     # If the user provided a custom processing callback, call it on each
     # snapshot.
@@ -110,25 +157,85 @@ def process_snapshots(
         output.append('\n[' + '=' * 78 + ']\n')
         output.append(
             str(
-                process_snapshots(nested_snapshot.SerializeToString(),
-                                  detokenizer, elf_matcher)))
+                process_snapshots(
+                    nested_snapshot.SerializeToString(),
+                    detokenizer,
+                    elf_matcher,
+                    symbolizer_cache_dir=symbolizer_cache_dir,
+                    section_cache_dir=section_cache_dir)))
 
     return '\n'.join(output)
 
 
-def _load_and_dump_snapshots(in_file: BinaryIO, out_file: TextIO,
-                             token_db: Optional[TextIO]):
+# Arguments to process_snapshots() in a worker process of
+# process_snapshots_in_parallel(), set by _init_worker().
+_worker_args: Tuple = ()
+
+
+def _init_worker(*args) -> None:
+    global _worker_args  # pylint: disable=global-statement
+    _worker_args = args
+
+
+def _process_in_worker(serialized_snapshot: bytes) -> str:
+    return process_snapshots(serialized_snapshot, *_worker_args)
+
+
+def process_snapshots_in_parallel(
+        serialized_snapshots: Iterable[bytes],
+        detokenizer: Optional[pw_tokenizer.Detokenizer] = None,
+        elf_matcher: Optional[ElfMatcher] = None,
+        user_processing_callback: Optional[UserProcessingCallback] = None,
+        symbolizer_cache_dir: Optional[Path] = None,
+        jobs: Optional[int] = None,
+        section_cache_dir: Optional[Path] = None) -> List[str]:
+    """Processes many snapshots with a pool of worker processes.
+
+    Returns the output of process_snapshots() for each snapshot, in order. Up
+    to jobs worker processes are used; the default is the number of CPUs. Each
+    worker keeps its detokenizer and symbolizers open for all of the snapshots
+    it processes. The detokenizer, elf_matcher, and callback are sent to the
+    workers, so they must be picklable on platforms that do not fork.
+    """
+    with concurrent.futures.ProcessPoolExecutor(
+            max_workers=jobs,
+            initializer=_init_worker,
+            initargs=(detokenizer, elf_matcher, user_processing_callback,
+                      symbolizer_cache_dir, section_cache_dir)) as pool:
+        return list(pool.map(_process_in_worker, serialized_snapshots))
+
+
+def _load_and_dump_snapshots(in_file: List[BinaryIO], out_file: TextIO,
+                             token_db: Optional[TextIO], jobs: int,
+                             section_cache_dir: Optional[Path]):
     detokenizer = None
     if token_db:
         detokenizer = pw_tokenizer.Detokenizer(token_db)
-    out_file.write(process_snapshots(in_file.read(), detokenizer))
+
+    serialized_snapshots = [file.read() for file in in_file]
+    if jobs == 1 or len(serialized_snapshots) == 1:
+        results = [
+            process_snapshots(snapshot,
+                              detokenizer,
+                              section_cache_dir=section_cache_dir)
+            for snapshot in serialized_snapshots
+        ]
+    else:
+        results = process_snapshots_in_parallel(
+            serialized_snapshots,
+            detokenizer,
+            jobs=jobs or None,
+            section_cache_dir=section_cache_dir)
+
+    out_file.write(('\n[' + '#' * 78 + ']\n').join(results))
 
 
 def _parse_args():
     parser = argparse.ArgumentParser(description='Decode Pigweed snapshots')
     parser.add_argument('in_file',
                         type=argparse.FileType('rb'),
-                        help='Binary snapshot file')
+                        nargs='+',
+                        help='Binary snapshot files')
     parser.add_argument(
         '--out-file',
         '-o',
@@ -139,6 +246,19 @@ def _parse_args():
         '--token-db',
         type=argparse.FileType('r'),
         help='Token database or ELF file to use for detokenization.')
+    parser.add_argument(
+        '--jobs',
+        '-j',
+        type=int,
+        default=0,
+        help=('Number of processes to use when decoding multiple snapshot '
+              'files. Defaults to the number of CPUs.'))
+    parser.add_argument(
+        '--section-cache-dir',
+        type=Path,
+        help=('Directory in which to cache snapshot sections, such as thread '
+              'stacks, and from which to restore sections that devices '
+              'omitted because they were already uploaded.'))
     return parser.parse_args()
 
 
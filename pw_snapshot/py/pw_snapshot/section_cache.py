@@ -0,0 +1,117 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Restores snapshot sections that a device omitted as already uploaded.
+
+Devices using pw::snapshot::UploadedSections send a large section, such as a
+thread's raw_stack, only once per build. Later snapshots of that build carry
+only the section's CRC32. The SectionCache stores every section it sees,
+keyed by the snapshot's software_build_uuid and the section's CRC32, and fills
+omitted sections back in.
+"""
+
+import os
+from pathlib import Path
+from typing import List, Optional, Tuple
+import zlib
+
+from pw_snapshot_protos import snapshot_pb2
+
+
+class SectionCache:
+    """Stores snapshot sections on disk, by build and CRC32."""
+    def __init__(self, directory: Path):
+        self._directory = directory
+
+    def _path(self, build_uuid: bytes, crc32: int) -> Path:
+        return self._directory / build_uuid.hex() / f'{crc32:08x}.bin'
+
+    def _store(self, build_uuid: bytes, data: bytes) -> None:
+        path = self._path(build_uuid, zlib.crc32(data))
+        if not path.exists():
+            # Write to a temporary file first, since other processes may be
+            # reading or writing the same section.
+            path.parent.mkdir(parents=True, exist_ok=True)
+            temp_path = path.with_suffix(f'.{os.getpid()}.tmp')
+            temp_path.write_bytes(data)
+            temp_path.replace(path)
+
+    def _load(self, build_uuid: bytes, crc32: int) -> Optional[bytes]:
+        path = self._path(build_uuid, crc32)
+        if not path.exists():
+            return None
+
+        data = path.read_bytes()
+        return data if zlib.crc32(data) == crc32 else None
+
+    def _restore(self, build_uuid: bytes, data: bytes, has_crc32: bool,
+                 crc32: int) -> Optional[bytes]:
+        """Returns the section's data, or None if it cannot be restored."""
+        if data:
+            if build_uuid:
+                self._store(build_uuid, data)
+            return data
+
+        if not has_crc32:
+            return data
+
+        if not build_uuid:
+            return None
+
+        return self._load(build_uuid, crc32)
+
+    def restore(self, snapshot: snapshot_pb2.Snapshot) -> List[str]:
+        """Fills in omitted sections of a snapshot and caches its sections.
+
+        Related snapshots are not modified. Returns descriptions of the
+        sections that could not be restored.
+        """
+        build_uuid = snapshot.metadata.software_build_uuid
+        missing: List[str] = []
+
+        for thread in snapshot.threads:
+            restored = self._restore(build_uuid, thread.raw_stack,
+                                     thread.HasField('raw_stack_crc32'),
+                                     thread.raw_stack_crc32)
+            name = thread.name.decode(errors='replace')
+            if restored is None:
+                missing.append(f'raw_stack of thread {name} '
+                               f'(CRC32 0x{thread.raw_stack_crc32:08x})')
+            elif not thread.raw_stack and restored:
+                thread.raw_stack = restored
+                thread.ClearField('raw_stack_crc32')
+
+        restored = self._restore(build_uuid, snapshot.trace_data,
+                                 snapshot.HasField('trace_data_crc32'),
+                                 snapshot.trace_data_crc32)
+        if restored is None:
+            missing.append(
+                f'trace_data (CRC32 0x{snapshot.trace_data_crc32:08x})')
+        elif not snapshot.trace_data and restored:
+            snapshot.trace_data = restored
+            snapshot.ClearField('trace_data_crc32')
+
+        return missing
+
+
+def restore_sections(serialized_snapshot: bytes,
+                     cache_dir: Path) -> Tuple[bytes, List[str]]:
+    """Restores a serialized snapshot's omitted sections from a cache.
+
+    Returns the restored snapshot and descriptions of the sections that could
+    not be restored.
+    """
+    snapshot = snapshot_pb2.Snapshot()
+    snapshot.ParseFromString(serialized_snapshot)
+    missing = SectionCache(cache_dir).restore(snapshot)
+    return snapshot.SerializeToString(), missing
@@ -0,0 +1,97 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests restoring omitted snapshot sections."""
+
+from pathlib import Path
+import tempfile
+import unittest
+import zlib
+
+from pw_snapshot.section_cache import restore_sections
+from pw_snapshot_protos import snapshot_pb2
+
+_BUILD_UUID = b'\xad\x2d\x39\x25'
+_STACK = bytes(range(64))
+_TRACE = b'trace data'
+
+
+def _snapshot(build_uuid: bytes = _BUILD_UUID,
+              omit: bool = False) -> snapshot_pb2.Snapshot:
+    snapshot = snapshot_pb2.Snapshot()
+    snapshot.metadata.software_build_uuid = build_uuid
+    thread = snapshot.threads.add()
+    thread.name = b'Idle'
+    if omit:
+        thread.raw_stack_crc32 = zlib.crc32(_STACK)
+        snapshot.trace_data_crc32 = zlib.crc32(_TRACE)
+    else:
+        thread.raw_stack = _STACK
+        snapshot.trace_data = _TRACE
+    return snapshot
+
+
+class SectionCacheTest(unittest.TestCase):
+    """Tests caching and restoring snapshot sections."""
+    def setUp(self):
+        super().setUp()
+        self._temp_dir = tempfile.TemporaryDirectory()
+        self.cache_dir = Path(self._temp_dir.name)
+
+    def tearDown(self):
+        self._temp_dir.cleanup()
+        super().tearDown()
+
+    def _restore(self, snapshot: snapshot_pb2.Snapshot):
+        serialized, missing = restore_sections(snapshot.SerializeToString(),
+                                               self.cache_dir)
+        restored = snapshot_pb2.Snapshot()
+        restored.ParseFromString(serialized)
+        return restored, missing
+
+    def test_full_snapshot_unchanged(self):
+        snapshot = _snapshot()
+        restored, missing = self._restore(snapshot)
+        self.assertEqual(missing, [])
+        self.assertEqual(restored, snapshot)
+
+    def test_omitted_sections_restored(self):
+        self._restore(_snapshot())
+
+        restored, missing = self._restore(_snapshot(omit=True))
+        self.assertEqual(missing, [])
+        self.assertEqual(restored, _snapshot())
+        self.assertFalse(restored.threads[0].HasField('raw_stack_crc32'))
+        self.assertFalse(restored.HasField('trace_data_crc32'))
+
+    def test_omitted_sections_not_cached(self):
+        restored, missing = self._restore(_snapshot(omit=True))
+        self.assertEqual(len(missing), 2)
+        self.assertIn('thread Idle', missing[0])
+        self.assertEqual(restored.threads[0].raw_stack, b'')
+
+    def test_other_build_not_restored(self):
+        self._restore(_snapshot())
+
+        _, missing = self._restore(_snapshot(b'\x01\x02', omit=True))
+        self.assertEqual(len(missing), 2)
+
+    def test_no_build_uuid_not_restored(self):
+        self._restore(_snapshot(b''))
+
+        _, missing = self._restore(_snapshot(b'', omit=True))
+        self.assertEqual(len(missing), 2)
+
+
+if __name__ == '__main__':
+    unittest.main()
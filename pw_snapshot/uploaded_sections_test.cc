@@ -0,0 +1,122 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_snapshot/uploaded_sections.h"
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_checksum/crc32.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+
+namespace pw::snapshot {
+namespace {
+
+constexpr uint32_t kDataField = 6;
+constexpr uint32_t kCrc32Field = 12;
+
+constexpr auto kStackA = bytes::Initialized<64>([](size_t i) { return i; });
+constexpr auto kStackB = bytes::Initialized<64>([](size_t i) { return ~i; });
+constexpr auto kBuildA = bytes::Array<0x01, 0x02, 0x03, 0x04>();
+constexpr auto kBuildB = bytes::Array<0x01, 0x02, 0x03, 0x05>();
+
+// Must be trivially copyable to be kept in persistent RAM across reboots.
+static_assert(std::is_trivially_copy_constructible_v<UploadedSections<4>>);
+static_assert(std::is_trivially_destructible_v<UploadedSections<4>>);
+
+class UploadedSectionsTest : public ::testing::Test {
+ protected:
+  void SetUp() override { sections_.SetBuildId(kBuildA); }
+
+  // Writes a section to a new message and returns whether it was omitted.
+  bool WriteOmitted(ConstByteSpan data) {
+    protobuf::MemoryEncoder encoder(buffer_);
+    EXPECT_EQ(OkStatus(),
+              sections_.WriteSection(encoder, kDataField, kCrc32Field, data));
+
+    protobuf::Decoder decoder(encoder);
+    EXPECT_EQ(OkStatus(), decoder.Next());
+    if (decoder.FieldNumber() == kDataField) {
+      ConstByteSpan written;
+      EXPECT_EQ(OkStatus(), decoder.ReadBytes(&written));
+      EXPECT_EQ(data.size(), written.size());
+      return false;
+    }
+
+    EXPECT_EQ(kCrc32Field, decoder.FieldNumber());
+    uint32_t crc32 = 0;
+    EXPECT_EQ(OkStatus(), decoder.ReadFixed32(&crc32));
+    EXPECT_EQ(checksum::Crc32::Calculate(data), crc32);
+    return true;
+  }
+
+  std::array<std::byte, 128> buffer_;
+  UploadedSections<2> sections_;
+};
+
+TEST_F(UploadedSectionsTest, NotUploaded_WrittenInFull) {
+  EXPECT_FALSE(WriteOmitted(kStackA));
+  EXPECT_FALSE(WriteOmitted(kStackA));
+  EXPECT_EQ(1u, sections_.size());
+}
+
+TEST_F(UploadedSectionsTest, Uploaded_OnlyCrc32Written) {
+  EXPECT_FALSE(WriteOmitted(kStackA));
+  sections_.MarkUploaded();
+
+  EXPECT_TRUE(WriteOmitted(kStackA));
+  EXPECT_FALSE(WriteOmitted(kStackB));
+  EXPECT_TRUE(WriteOmitted(kStackA));
+}
+
+TEST_F(UploadedSectionsTest, Full_ForgetsOldestSection) {
+  constexpr auto kStackC = bytes::Initialized<32>([](size_t i) { return i; });
+
+  EXPECT_FALSE(WriteOmitted(kStackA));
+  EXPECT_FALSE(WriteOmitted(kStackB));
+  EXPECT_FALSE(WriteOmitted(kStackC));
+  sections_.MarkUploaded();
+
+  EXPECT_EQ(2u, sections_.size());
+  EXPECT_FALSE(WriteOmitted(kStackA));
+  EXPECT_TRUE(WriteOmitted(kStackC));
+}
+
+TEST_F(UploadedSectionsTest, NewBuildId_ForgetsSections) {
+  EXPECT_FALSE(WriteOmitted(kStackA));
+  sections_.MarkUploaded();
+
+  sections_.SetBuildId(kBuildA);
+  EXPECT_TRUE(WriteOmitted(kStackA));
+
+  sections_.SetBuildId(kBuildB);
+  EXPECT_EQ(0u, sections_.size());
+  EXPECT_FALSE(WriteOmitted(kStackA));
+}
+
+TEST_F(UploadedSectionsTest, WriteFails_SectionNotRecorded) {
+  std::array<std::byte, 16> small_buffer;
+  protobuf::MemoryEncoder small_encoder(small_buffer);
+  EXPECT_EQ(
+      Status::ResourceExhausted(),
+      sections_.WriteSection(small_encoder, kDataField, kCrc32Field, kStackA));
+  EXPECT_EQ(0u, sections_.size());
+}
+
+}  // namespace
+}  // namespace pw::snapshot
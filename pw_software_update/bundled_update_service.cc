@@ -16,12 +16,14 @@
 
 #define PW_LOG_LEVEL PW_SOFTWARE_UPDATE_CONFIG_LOG_LEVEL
 
+#include <bitset>
 #include <mutex>
 #include <string_view>
 
 #include "pw_log/log.h"
 #include "pw_result/result.h"
 #include "pw_software_update/bundled_update_service.h"
+#include "pw_software_update/delta_patch.h"
 #include "pw_software_update/manifest_accessor.h"
 #include "pw_software_update/update_bundle.pwpb.h"
 #include "pw_status/status.h"
@@ -51,6 +53,7 @@
         PW_CHECK_OK(bundle_.Close());                                      \
         bundle_open_ = false;                                              \
       }                                                                    \
+      ClearStagingProgress();                                              \
       status_.state = pw_software_update_BundledUpdateState_Enum_FINISHED; \
       status_.result = res;                                                \
       status_.has_result = true;                                           \
@@ -68,6 +71,36 @@ namespace {
 constexpr std::string_view kTopLevelTargetsName = "targets";
 constexpr std::string_view kUserManifestTargetFileName = "user_manifest";
 
+// Hands a target file to the backend. Delta patch payloads are applied to the
+// target file currently on the device as the backend reads them, so the
+// backend always receives the full target file.
+Status ApplyTarget(BundledUpdateBackend& backend,
+                   protobuf::Message target_file,
+                   std::string_view file_name,
+                   stream::IntervalReader& payload) {
+  const size_t bundle_offset = payload.start();
+
+  // is_delta_patch is a bool, which is encoded as a varint.
+  protobuf::Uint32 is_delta_patch = target_file.AsUint32(static_cast<uint32_t>(
+      pw::software_update::TargetFile::Fields::IS_DELTA_PATCH));
+  if (is_delta_patch.status().IsNotFound() ||
+      (is_delta_patch.ok() && is_delta_patch.value() == 0u)) {
+    return backend.ApplyTargetFile(file_name, payload, bundle_offset);
+  }
+  PW_TRY(is_delta_patch.status());
+
+  Result<stream::SeekableReader*> base =
+      backend.GetCurrentTargetFileReader(file_name);
+  if (!base.ok()) {
+    PW_LOG_ERROR("Delta patch target file has no base image: %d",
+                 static_cast<int>(base.status().code()));
+    return base.status();
+  }
+
+  DeltaPatchReader patched(payload, *base.value());
+  return backend.ApplyTargetFile(file_name, patched, bundle_offset);
+}
+
 }  // namespace
 
 Status BundledUpdateService::GetStatus(
@@ -129,11 +162,80 @@ Status BundledUpdateService::Start(
                  "bundle_filename options max_sizes do not match");
     status_.has_bundle_filename = true;
   }
+  status_.bundle_bytes_staged = 0;
+  status_.has_bundle_bytes_staged = true;
   status_.state = pw_software_update_BundledUpdateState_Enum_TRANSFERRING;
+
+  // Save the progress so the transfer can resume after a reboot.
+  progress_ = {};
+  progress_.state = StagingProgress::State::kTransferring;
+  string::Copy(status_.bundle_filename,
+               progress_.bundle_filename,
+               sizeof(progress_.bundle_filename))
+      .IgnoreError();  // Both buffers are the same size.
+  SaveStagingProgress();
+
   response = status_;
   return OkStatus();
 }
 
+Status BundledUpdateService::RestoreStagingProgress() {
+  std::lock_guard lock(mutex_);
+  if (status_.state != pw_software_update_BundledUpdateState_Enum_INACTIVE) {
+    return Status::FailedPrecondition();
+  }
+
+  Result<StagingProgress> progress = backend_.LoadStagingProgress();
+  if (!progress.ok()) {
+    return progress.status();
+  }
+  progress_ = progress.value();
+  progress_.bundle_filename[sizeof(progress_.bundle_filename) - 1] = '\0';
+
+  if (progress_.bundle_filename[0] != '\0') {
+    string::Copy(progress_.bundle_filename,
+                 status_.bundle_filename,
+                 sizeof(status_.bundle_filename))
+        .IgnoreError();  // Both buffers are the same size.
+    status_.has_bundle_filename = true;
+  }
+
+  switch (progress_.state) {
+    case StagingProgress::State::kTransferring: {
+      Result<uint32_t> possible_transfer_id =
+          backend_.EnableBundleTransferHandler(progress_.bundle_filename);
+      if (!possible_transfer_id.ok()) {
+        SET_ERROR(pw_software_update_BundledUpdateResult_Enum_TRANSFER_FAILED,
+                  "Couldn't enable bundle transfer to resume");
+        return possible_transfer_id.status();
+      }
+      PW_LOG_INFO("Resuming bundle transfer at offset %u",
+                  static_cast<unsigned>(progress_.bundle_bytes_staged));
+      status_.transfer_id = possible_transfer_id.value();
+      status_.has_transfer_id = true;
+      status_.bundle_bytes_staged = progress_.bundle_bytes_staged;
+      status_.has_bundle_bytes_staged = true;
+      status_.state = pw_software_update_BundledUpdateState_Enum_TRANSFERRING;
+      return OkStatus();
+    }
+    case StagingProgress::State::kTransferred:
+      PW_LOG_INFO("Restored staged bundle; %u target payloads verified",
+                  static_cast<unsigned>(
+                      std::bitset<32>(progress_.verified_targets).count()));
+      status_.state = pw_software_update_BundledUpdateState_Enum_TRANSFERRED;
+      return OkStatus();
+    case StagingProgress::State::kNone:
+      break;
+  }
+
+  PW_LOG_ERROR("Saved staging progress has invalid state %u",
+               static_cast<unsigned>(progress_.state));
+  status_ = {};
+  status_.state = pw_software_update_BundledUpdateState_Enum_INACTIVE;
+  ClearStagingProgress();
+  return Status::DataLoss();
+}
+
 // TODO: Check for "ABORTING" state and bail if it's set.
 void BundledUpdateService::DoVerify() {
   std::lock_guard guard(mutex_);
@@ -422,9 +524,8 @@ void BundledUpdateService::DoApply() {
     }
     stream::IntervalReader file_reader =
         bundle_.GetTargetPayload(file_name_view);
-    const size_t bundle_offset = file_reader.start();
-    if (const Status status = backend_.ApplyTargetFile(
-            file_name_view, file_reader, bundle_offset);
+    if (const Status status =
+            ApplyTarget(backend_, file_name, file_name_view, file_reader);
         !status.ok()) {
       SET_ERROR(pw_software_update_BundledUpdateResult_Enum_APPLY_FAILED,
                 "Failed to apply target file: %d",
@@ -446,6 +547,9 @@ void BundledUpdateService::DoApply() {
     }
   }
 
+  // The staged update must not resume after the device reboots into it.
+  ClearStagingProgress();
+
   // Finalize the apply.
   //
   // TODO(davidrogers): Ensure the backend documentation and API contract is
@@ -538,7 +642,41 @@ void BundledUpdateService::NotifyTransferSucceeded() {
   PW_DCHECK(status_.has_transfer_id);
   backend_.DisableBundleTransferHandler();
   status_.has_transfer_id = false;
+  status_.has_bundle_bytes_staged = false;
   status_.state = pw_software_update_BundledUpdateState_Enum_TRANSFERRED;
+
+  progress_.state = StagingProgress::State::kTransferred;
+  SaveStagingProgress();
+}
+
+void BundledUpdateService::NotifyTransferProgress(size_t bytes_staged) {
+  std::lock_guard lock(mutex_);
+
+  if (status_.state !=
+      pw_software_update_BundledUpdateState_Enum_TRANSFERRING) {
+    return;
+  }
+
+  status_.bundle_bytes_staged = static_cast<uint32_t>(bytes_staged);
+  status_.has_bundle_bytes_staged = true;
+  progress_.bundle_bytes_staged = static_cast<uint32_t>(bytes_staged);
+  SaveStagingProgress();
+}
+
+void BundledUpdateService::SaveStagingProgress() {
+  if (const Status status = backend_.SaveStagingProgress(progress_);
+      !status.ok() && !status.IsUnimplemented()) {
+    PW_LOG_WARN("Failed to save staging progress: %d",
+                static_cast<int>(status.code()));
+  }
+}
+
+void BundledUpdateService::ClearStagingProgress() {
+  progress_ = {};
+  if (const Status status = backend_.ClearStagingProgress(); !status.ok()) {
+    PW_LOG_WARN("Failed to clear staging progress: %d",
+                static_cast<int>(status.code()));
+  }
 }
 
 }  // namespace pw::software_update
@@ -0,0 +1,154 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_software_update/delta_patch.h"
+
+#include <algorithm>
+#include <array>
+
+#include "pw_bytes/endian.h"
+#include "pw_result/result.h"
+#include "pw_status/try.h"
+
+namespace pw::software_update {
+
+StatusWithSize DeltaPatchReader::DoRead(ByteSpan destination) {
+  if (!status_.ok()) {
+    return StatusWithSize(status_, 0);
+  }
+
+  if (!header_read_) {
+    if (Status status = ReadHeader(); !status.ok()) {
+      status_ = status;
+      return StatusWithSize(status_, 0);
+    }
+  }
+
+  size_t bytes_read = 0;
+  while (bytes_read < destination.size() && !done_) {
+    if (op_remaining_ == 0u) {
+      if (Status status = StartNextOperation(); !status.ok()) {
+        status_ = status;
+        break;
+      }
+      continue;
+    }
+
+    const ByteSpan chunk = destination.subspan(
+        bytes_read, std::min(op_remaining_, destination.size() - bytes_read));
+    stream::Reader& source = op_ == kCopy ? base_ : patch_;
+    const Result<ByteSpan> result = source.Read(chunk);
+    if (!result.ok()) {
+      // Running out of either stream partway through an operation means the
+      // patch does not match the streams it is applied to.
+      status_ = Status::DataLoss();
+      break;
+    }
+
+    bytes_read += result.value().size();
+    op_remaining_ -= result.value().size();
+    bytes_produced_ += result.value().size();
+  }
+
+  // Return any data produced before an error; the error is reported by the
+  // next read.
+  if (bytes_read > 0u) {
+    return StatusWithSize(bytes_read);
+  }
+  if (!status_.ok()) {
+    return StatusWithSize(status_, 0);
+  }
+  return done_ ? StatusWithSize::OutOfRange() : StatusWithSize(0);
+}
+
+size_t DeltaPatchReader::ConservativeLimit(LimitType limit_type) const {
+  if (limit_type != LimitType::kRead || !status_.ok() || done_) {
+    return 0;
+  }
+  return header_read_ ? target_size_ - bytes_produced_ : kUnlimited;
+}
+
+Status DeltaPatchReader::ReadHeader() {
+  uint32_t magic;
+  PW_TRY(ReadPatchUint32(magic));
+  if (magic != kMagic) {
+    return Status::DataLoss();
+  }
+
+  uint32_t target_size;
+  PW_TRY(ReadPatchUint32(target_size));
+  target_size_ = target_size;
+  header_read_ = true;
+  return OkStatus();
+}
+
+Status DeltaPatchReader::StartNextOperation() {
+  std::byte op;
+  PW_TRY(ReadPatchExact(std::span(&op, 1)));
+
+  switch (static_cast<Operation>(op)) {
+    case kEnd:
+      if (bytes_produced_ != target_size_) {
+        return Status::DataLoss();
+      }
+      done_ = true;
+      return OkStatus();
+    case kCopy: {
+      uint32_t offset;
+      uint32_t length;
+      PW_TRY(ReadPatchUint32(offset));
+      PW_TRY(ReadPatchUint32(length));
+      if (base_.Seek(offset, stream::Stream::kBeginning) != OkStatus()) {
+        return Status::DataLoss();
+      }
+      op_ = kCopy;
+      op_remaining_ = length;
+      break;
+    }
+    case kInsert: {
+      uint32_t length;
+      PW_TRY(ReadPatchUint32(length));
+      op_ = kInsert;
+      op_remaining_ = length;
+      break;
+    }
+    default:
+      return Status::DataLoss();
+  }
+
+  if (op_remaining_ > target_size_ - bytes_produced_) {
+    return Status::DataLoss();
+  }
+  return OkStatus();
+}
+
+Status DeltaPatchReader::ReadPatchExact(ByteSpan destination) {
+  while (!destination.empty()) {
+    const Result<ByteSpan> result = patch_.Read(destination);
+    if (!result.ok()) {
+      return Status::DataLoss();
+    }
+    destination = destination.subspan(result.value().size());
+  }
+  return OkStatus();
+}
+
+Status DeltaPatchReader::ReadPatchUint32(uint32_t& value) {
+  std::array<std::byte, sizeof(uint32_t)> buffer;
+  PW_TRY(ReadPatchExact(buffer));
+  value = bytes::ReadInOrder<uint32_t>(std::endian::little, buffer);
+  return OkStatus();
+}
+
+}  // namespace pw::software_update
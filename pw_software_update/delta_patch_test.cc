@@ -0,0 +1,160 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_software_update/delta_patch.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::software_update {
+namespace {
+
+using Patch = DeltaPatchReader;
+
+constexpr auto kBase = bytes::String("The quick brown fox");
+
+// Produces "The slow brown fox jumps".
+constexpr auto kPatch = bytes::Concat(Patch::kMagic,
+                                      uint32_t(24),
+                                      Patch::kCopy,
+                                      uint32_t(0),
+                                      uint32_t(4),
+                                      Patch::kInsert,
+                                      uint32_t(4),
+                                      bytes::String("slow"),
+                                      Patch::kCopy,
+                                      uint32_t(9),
+                                      uint32_t(10),
+                                      Patch::kInsert,
+                                      uint32_t(6),
+                                      bytes::String(" jumps"),
+                                      Patch::kEnd);
+
+constexpr auto kExpected = bytes::String("The slow brown fox jumps");
+
+class DeltaPatchTest : public ::testing::Test {
+ protected:
+  DeltaPatchTest() : base_(kBase) {}
+
+  // Reads the patched image in chunks of the given size.
+  StatusWithSize ReadAll(ConstByteSpan patch, size_t chunk_size) {
+    stream::MemoryReader patch_reader(patch);
+    DeltaPatchReader reader(patch_reader, base_);
+
+    size_t total = 0;
+    while (true) {
+      const size_t size = std::min(chunk_size, output_.size() - total);
+      Result<ByteSpan> result =
+          reader.Read(std::span(output_).subspan(total, size));
+      if (result.status().IsOutOfRange()) {
+        return StatusWithSize(total);
+      }
+      if (!result.ok()) {
+        return StatusWithSize(result.status(), total);
+      }
+      total += result.value().size();
+    }
+  }
+
+  stream::MemoryReader base_;
+  std::array<std::byte, 64> output_ = {};
+};
+
+TEST_F(DeltaPatchTest, Read_ProducesPatchedImage) {
+  const StatusWithSize result = ReadAll(kPatch, output_.size());
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(kExpected.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(kExpected.data(), output_.data(), result.size()));
+}
+
+TEST_F(DeltaPatchTest, Read_SmallChunks) {
+  const StatusWithSize result = ReadAll(kPatch, 3);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(kExpected.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(kExpected.data(), output_.data(), result.size()));
+}
+
+TEST_F(DeltaPatchTest, Read_TargetSizeAndLimit) {
+  stream::MemoryReader patch_reader(kPatch);
+  DeltaPatchReader reader(patch_reader, base_);
+
+  std::array<std::byte, 4> buffer;
+  ASSERT_EQ(OkStatus(), reader.Read(buffer).status());
+  EXPECT_EQ(kExpected.size(), reader.target_size());
+  EXPECT_EQ(kExpected.size() - buffer.size(), reader.ConservativeReadLimit());
+}
+
+TEST_F(DeltaPatchTest, Read_EmptyImage) {
+  constexpr auto kEmpty =
+      bytes::Concat(Patch::kMagic, uint32_t(0), Patch::kEnd);
+  const StatusWithSize result = ReadAll(kEmpty, output_.size());
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.size());
+}
+
+TEST_F(DeltaPatchTest, Read_BadMagic_DataLoss) {
+  constexpr auto kBadMagic =
+      bytes::Concat(uint32_t(0x12345678), uint32_t(0), Patch::kEnd);
+  EXPECT_EQ(Status::DataLoss(), ReadAll(kBadMagic, output_.size()).status());
+}
+
+TEST_F(DeltaPatchTest, Read_UnknownOperation_DataLoss) {
+  constexpr auto kUnknownOp =
+      bytes::Concat(Patch::kMagic, uint32_t(1), uint8_t(0x7f));
+  EXPECT_EQ(Status::DataLoss(), ReadAll(kUnknownOp, output_.size()).status());
+}
+
+TEST_F(DeltaPatchTest, Read_Truncated_DataLoss) {
+  const StatusWithSize result =
+      ReadAll(std::span(kPatch).first(kPatch.size() - 4), output_.size());
+  EXPECT_EQ(Status::DataLoss(), result.status());
+}
+
+TEST_F(DeltaPatchTest, Read_CopyPastEndOfBase_DataLoss) {
+  constexpr auto kPastEnd = bytes::Concat(Patch::kMagic,
+                                          uint32_t(8),
+                                          Patch::kCopy,
+                                          uint32_t(kBase.size() - 4),
+                                          uint32_t(8),
+                                          Patch::kEnd);
+  EXPECT_EQ(Status::DataLoss(), ReadAll(kPastEnd, output_.size()).status());
+}
+
+TEST_F(DeltaPatchTest, Read_SizeMismatch_DataLoss) {
+  constexpr auto kTooShort = bytes::Concat(Patch::kMagic,
+                                           uint32_t(8),
+                                           Patch::kCopy,
+                                           uint32_t(0),
+                                           uint32_t(4),
+                                           Patch::kEnd);
+  EXPECT_EQ(Status::DataLoss(), ReadAll(kTooShort, output_.size()).status());
+
+  constexpr auto kTooLong = bytes::Concat(Patch::kMagic,
+                                          uint32_t(2),
+                                          Patch::kCopy,
+                                          uint32_t(0),
+                                          uint32_t(4),
+                                          Patch::kEnd);
+  EXPECT_EQ(Status::DataLoss(), ReadAll(kTooLong, output_.size()).status());
+}
+
+}  // namespace
+}  // namespace pw::software_update
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string_view>
 
 #include "pw_result/result.h"
@@ -23,6 +25,38 @@
 
 namespace pw::software_update {
 
+// Progress of staging an update, which the backend persists so that an update
+// interrupted by a reboot can resume where it stopped. Backends may store it as
+// is, but should store a version with it in case its layout changes.
+struct StagingProgress {
+  enum class State : uint8_t {
+    kNone = 0,
+
+    // The bundle is being transferred to the staging area.
+    kTransferring = 1,
+
+    // The bundle is fully staged.
+    kTransferred = 2,
+  };
+
+  // Targets beyond this count are verified every time.
+  static constexpr size_t kMaxTrackedTargets = 32;
+
+  State state;
+
+  // Bundle bytes committed to the staging area, as reported with
+  // BundledUpdateService::NotifyTransferProgress(). An interrupted transfer
+  // resumes at this offset.
+  uint32_t bundle_bytes_staged;
+
+  // Bit i is set once the payload of the i-th target file in the targets
+  // metadata has been verified, so that it is not verified again.
+  uint32_t verified_targets;
+
+  // The bundle_filename given to Start(), null-terminated.
+  char bundle_filename[32];
+};
+
 // TODO(pwbug/478): update documentation for backend api contract
 class BundledUpdateBackend {
  public:
@@ -41,8 +75,35 @@ class BundledUpdateBackend {
   // Perform any product-specific tasks needed before starting update sequence.
   virtual Status BeforeUpdateStart() { return OkStatus(); };
 
+  // Persists the staging progress of the update, replacing any previously saved
+  // progress. This is called when staging starts, as the transfer reports
+  // progress, when the transfer completes, and as each target payload is
+  // verified. Backends that do not resume updates can leave this
+  // unimplemented.
+  virtual Status SaveStagingProgress(
+      [[maybe_unused]] const StagingProgress& progress) {
+    return Status::Unimplemented();
+  }
+
+  // Returns the progress last saved with SaveStagingProgress(), or NOT_FOUND
+  // if no update was being staged. This is called at startup by
+  // BundledUpdateService::RestoreStagingProgress(), instead of
+  // BeforeUpdateStart(), so the backend must get ready to continue the update
+  // without discarding the data already staged.
+  virtual Result<StagingProgress> LoadStagingProgress() {
+    return Status::Unimplemented();
+  }
+
+  // Deletes the saved staging progress. This is called when the update is
+  // finished, aborted, or fails, and before FinalizeApply().
+  virtual Status ClearStagingProgress() { return OkStatus(); }
+
   // Attempts to enable the transfer service transfer handler, returning the
-  // transfer_id if successful. This is invoked after BeforeUpdateStart();
+  // transfer_id if successful. This is invoked after BeforeUpdateStart(), or
+  // after LoadStagingProgress() when resuming a transfer. A resumed transfer
+  // restarts at the offset of the staged bytes, so the handler's writer must
+  // then support seeking to that offset without discarding the data before
+  // it.
   virtual Result<uint32_t> EnableBundleTransferHandler(
       std::string_view bundle_filename) = 0;
 
@@ -86,6 +147,18 @@ class BundledUpdateBackend {
                                  stream::Reader& target_payload,
                                  size_t update_bundle_offset) = 0;
 
+  // Get a reader of the given target file as it is currently installed on the
+  // device. This is the base image that a delta patch target file is applied
+  // against. The reader must support seeking from the beginning, and must
+  // remain valid until ApplyTargetFile() returns, so ApplyTargetFile() must
+  // not overwrite the base image as it writes. Backends that do not support
+  // delta patches can leave this unimplemented, in which case bundles with
+  // delta patch target files fail to apply.
+  virtual Result<stream::SeekableReader*> GetCurrentTargetFileReader(
+      [[maybe_unused]] std::string_view target_file_name) {
+    return Status::Unimplemented();
+  }
+
   // Get reader of the device's current manifest.
   virtual Status GetCurrentManifestReader(
       [[maybe_unused]] stream::Reader* out) {
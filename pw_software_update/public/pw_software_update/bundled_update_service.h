@@ -37,10 +37,27 @@ class BundledUpdateService
         bundle_(bundle),
         bundle_open_(false),
         work_queue_(work_queue),
-        work_enqueued_(false) {
+        work_enqueued_(false),
+        progress_{} {
     status_.state = pw_software_update_BundledUpdateState_Enum_INACTIVE;
+    bundle_.set_staging_progress(&progress_);
   }
 
+  // Restores an update that was being staged before a reboot, from the
+  // progress saved by the backend. A transfer in progress is resumable at the
+  // staged offset reported in the status, and target payloads that were
+  // already verified are not verified again. Call once at startup, before the
+  // service handles any RPCs.
+  //
+  // Returns:
+  // OK - An update was restored to the TRANSFERRING or TRANSFERRED state.
+  // NOT_FOUND - No update was being staged.
+  // UNIMPLEMENTED - The backend does not save staging progress.
+  // FAILED_PRECONDITION - The service is not INACTIVE.
+  // DATA_LOSS - The saved progress is invalid, and was cleared.
+  // Other errors from the backend, which leave the update FINISHED.
+  Status RestoreStagingProgress();
+
   Status GetStatus(ServerContext&,
                    const pw_protobuf_Empty& request,
                    pw_software_update_BundledUpdateStatus& response);
@@ -79,6 +96,13 @@ class BundledUpdateService
   // it was in the TRANSFERRING state.
   void NotifyTransferSucceeded();
 
+  // Notify the service of the number of bundle bytes committed to the staging
+  // area, so that an interrupted transfer can resume from there. Users should
+  // invoke this from their transfer handler whenever staged data is durably
+  // written, such as after each flash sector, since the backend saves the
+  // progress each time.
+  void NotifyTransferProgress(size_t bytes_staged);
+
   // TODO:
   // VerifyProgress - to update % complete.
   // ApplyProgress - to update % complete.
@@ -90,10 +114,18 @@ class BundledUpdateService
   bool bundle_open_ PW_GUARDED_BY(mutex_);
   work_queue::WorkQueue& work_queue_ PW_GUARDED_BY(mutex_);
   bool work_enqueued_ PW_GUARDED_BY(mutex_);
+  StagingProgress progress_ PW_GUARDED_BY(mutex_);
   sync::Mutex mutex_;
 
   void DoVerify();
   void DoApply();
+
+  // Saves progress_ with the backend. Failures are logged, since they only
+  // prevent resuming.
+  void SaveStagingProgress() PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Clears progress_ and the backend's saved progress.
+  void ClearStagingProgress() PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 };
 
 }  // namespace pw::software_update
@@ -22,3 +22,24 @@
 // the bundle reader.
 #define WRITE_MANIFEST_STREAM_PIPE_BUFFER_SIZE 8
 #endif  // PW_SOFTWARE_UPDATE_CONFIG_LOG_LEVEL
+
+// The maximum length of a target file name whose payload can be verified.
+#ifndef PW_SOFTWARE_UPDATE_CONFIG_MAX_TARGET_NAME_LENGTH
+#define PW_SOFTWARE_UPDATE_CONFIG_MAX_TARGET_NAME_LENGTH 32
+#endif  // PW_SOFTWARE_UPDATE_CONFIG_MAX_TARGET_NAME_LENGTH
+
+// The size of the buffer to create on stack for reading target payloads while
+// hashing them. Larger buffers reduce the number of bundle reads. With an
+// asynchronous SHA256 backend, the two halves of the buffer are filled in turn
+// so that reading one half overlaps with hashing the other.
+#ifndef PW_SOFTWARE_UPDATE_CONFIG_VERIFY_READ_BUFFER_SIZE
+#define PW_SOFTWARE_UPDATE_CONFIG_VERIFY_READ_BUFFER_SIZE 256
+#endif  // PW_SOFTWARE_UPDATE_CONFIG_VERIFY_READ_BUFFER_SIZE
+
+// The number of slots in the index of target payloads built on stack while
+// verifying them. Each slot takes 12 bytes on 32-bit targets. Bundles with more
+// payloads than slots are verified without the index, which compares the name
+// of every payload for each target file. 0 disables the index.
+#ifndef PW_SOFTWARE_UPDATE_CONFIG_PAYLOAD_INDEX_SLOTS
+#define PW_SOFTWARE_UPDATE_CONFIG_PAYLOAD_INDEX_SLOTS 16
+#endif  // PW_SOFTWARE_UPDATE_CONFIG_PAYLOAD_INDEX_SLOTS
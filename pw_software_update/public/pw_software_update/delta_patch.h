@@ -0,0 +1,95 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::software_update {
+
+// Reads the target file produced by applying a block-based delta patch to a
+// base image, typically the target file currently on the device. The patched
+// image is produced as it is read, so neither the patch nor the image is ever
+// buffered in full.
+//
+// All integers in the patch are little-endian uint32_t. A patch is a header
+// followed by a sequence of operations:
+//
+//   header: kMagic, size of the patched image in bytes
+//   copy:   kCopy (1 byte), offset in the base image, length
+//   insert: kInsert (1 byte), length, followed by length literal bytes
+//   end:    kEnd (1 byte)
+//
+// Reads fail with DATA_LOSS if the patch is malformed or truncated, if a copy
+// reads past the end of the base image, or if the operations do not produce
+// exactly the number of bytes given in the header. Errors are sticky. After
+// the end operation, reads return OUT_OF_RANGE.
+class DeltaPatchReader final : public stream::NonSeekableReader {
+ public:
+  static constexpr uint32_t kMagic = 0x50445750;  // "PWDP"
+
+  enum Operation : uint8_t {
+    kEnd = 0,
+    kCopy = 1,
+    kInsert = 2,
+  };
+
+  // The base reader must support seeking from the beginning.
+  constexpr DeltaPatchReader(stream::Reader& patch, stream::Reader& base)
+      : patch_(patch),
+        base_(base),
+        status_(OkStatus()),
+        target_size_(0),
+        bytes_produced_(0),
+        op_remaining_(0),
+        op_(kEnd),
+        header_read_(false),
+        done_(false) {}
+
+  // The size of the patched image, as given in the patch header. Returns 0
+  // until the first read.
+  size_t target_size() const { return target_size_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) final;
+
+  size_t ConservativeLimit(LimitType limit_type) const final;
+
+  Status ReadHeader();
+
+  // Reads the next operation and prepares to produce its data.
+  Status StartNextOperation();
+
+  // Reads exactly destination.size() bytes of the patch.
+  Status ReadPatchExact(ByteSpan destination);
+
+  Status ReadPatchUint32(uint32_t& value);
+
+  stream::Reader& patch_;
+  stream::Reader& base_;
+  Status status_;
+  size_t target_size_;
+  size_t bytes_produced_;
+  size_t op_remaining_;
+  Operation op_;
+  bool header_read_;
+  bool done_;
+};
+
+}  // namespace pw::software_update
@@ -81,7 +81,18 @@ class UpdateBundleAccessor {
       : bundle_(bundle),
         backend_(backend),
         bundle_reader_(bundle_),
-        disable_verification_(disable_verification) {}
+        disable_verification_(disable_verification),
+        staging_progress_(nullptr) {}
+
+  // Tracks which target payloads are verified in `progress`, which must outlive
+  // the accessor. Payloads already marked as verified are not verified again,
+  // and each payload is marked as it is verified, after which the progress is
+  // saved with the backend's SaveStagingProgress(). Verification interrupted by
+  // a reboot then resumes with the next unverified payload. Pass nullptr to
+  // verify every payload.
+  void set_staging_progress(StagingProgress* progress) {
+    staging_progress_ = progress;
+  }
 
   // Opens and verifies the software update bundle.
   //
@@ -147,6 +158,7 @@ class UpdateBundleAccessor {
   blob_store::BlobStore::BlobReader bundle_reader_;
   protobuf::Message decoder_;
   bool disable_verification_;
+  StagingProgress* staging_progress_;
 
   // Opens the bundle for read-only access and readies the parser.
   Status DoOpen();
@@ -154,6 +166,25 @@ class UpdateBundleAccessor {
   // Performs TUF and downstream custom verification.
   Status DoVerify();
 
+  // Verifies the length and SHA256 digest of every target payload in the
+  // bundle against the top-level targets metadata.
+  //
+  // Returns:
+  // OK - All included payloads match their metadata.
+  // UNAUTHENTICATED - A payload does not match its metadata or has no SHA256
+  //   digest.
+  Status DoVerifyTargetPayloads();
+
+  // Verifies a single target payload against its TargetFile metadata.
+  Status VerifyTargetPayload(protobuf::Message target_file,
+                             protobuf::StringToBytesMap& target_payloads);
+
+  // Returns the map from target file names to payloads.
+  protobuf::StringToBytesMap GetTargetPayloads();
+
+  // Returns the serialized top-level targets metadata.
+  protobuf::Message GetTargetsMetadata();
+
   // The method checks whether the update bundle contains a root metadata
   // different from the on-device one. If it does, it performs the following
   // verification and upgrade flow:
@@ -16,9 +16,11 @@
 
 #define PW_LOG_LEVEL PW_SOFTWARE_UPDATE_CONFIG_LOG_LEVEL
 
+#include <array>
 #include <cstddef>
 #include <string_view>
 
+#include "pw_crypto/sha256.h"
 #include "pw_log/log.h"
 #include "pw_protobuf/message.h"
 #include "pw_result/result.h"
@@ -43,9 +45,7 @@ Status UpdateBundleAccessor::OpenAndVerify(const ManifestAccessor&) {
 // Get the target element corresponding to `target_file`
 stream::IntervalReader UpdateBundleAccessor::GetTargetPayload(
     std::string_view target_file_name) {
-  protobuf::StringToBytesMap target_payloads =
-      decoder_.AsStringToBytesMap(static_cast<uint32_t>(
-          pw::software_update::UpdateBundle::Fields::TARGET_PAYLOADS));
+  protobuf::StringToBytesMap target_payloads = GetTargetPayloads();
   PW_TRY(target_payloads.status());
   protobuf::Bytes payload = target_payloads[target_file_name];
   PW_TRY(payload.status());
@@ -57,24 +57,11 @@ Result<bool> UpdateBundleAccessor::IsTargetPayloadIncluded(
   // TODO(pwbug/456): Perform personalization check first. If the target
   // is personalized out. Don't need to proceed.
 
-  protobuf::StringToMessageMap signed_targets_metadata_map =
-      decoder_.AsStringToMessageMap(static_cast<uint32_t>(
-          pw::software_update::UpdateBundle::Fields::TARGETS_METADATA));
-  PW_TRY(signed_targets_metadata_map.status());
-
-  // There should only be one element in the map, which is the top-level
-  // targets metadata.
-  protobuf::Message signed_targets_metadata =
-      signed_targets_metadata_map[kTopLevelTargetsName];
-  PW_TRY(signed_targets_metadata.status());
-
-  protobuf::Message metadata = signed_targets_metadata.AsMessage(
-      static_cast<uint32_t>(pw::software_update::SignedTargetsMetadata::Fields::
-                                SERIALIZED_TARGETS_METADATA));
-  PW_TRY(metadata.status());
+  protobuf::Message targets_metadata = GetTargetsMetadata();
+  PW_TRY(targets_metadata.status());
 
   protobuf::RepeatedMessages target_files =
-      metadata.AsRepeatedMessages(static_cast<uint32_t>(
+      targets_metadata.AsRepeatedMessages(static_cast<uint32_t>(
           pw::software_update::TargetsMetadata::Fields::TARGET_FILES));
   PW_TRY(target_files.status());
 
@@ -92,6 +79,23 @@ Result<bool> UpdateBundleAccessor::IsTargetPayloadIncluded(
   return false;
 }
 
+protobuf::Message UpdateBundleAccessor::GetTargetsMetadata() {
+  protobuf::StringToMessageMap signed_targets_metadata_map =
+      decoder_.AsStringToMessageMap(static_cast<uint32_t>(
+          pw::software_update::UpdateBundle::Fields::TARGETS_METADATA));
+  PW_TRY(signed_targets_metadata_map.status());
+
+  // There should only be one element in the map, which is the top-level
+  // targets metadata.
+  protobuf::Message signed_targets_metadata =
+      signed_targets_metadata_map[kTopLevelTargetsName];
+  PW_TRY(signed_targets_metadata.status());
+
+  return signed_targets_metadata.AsMessage(
+      static_cast<uint32_t>(pw::software_update::SignedTargetsMetadata::Fields::
+                                SERIALIZED_TARGETS_METADATA));
+}
+
 Status UpdateBundleAccessor::WriteManifest(
     [[maybe_unused]] stream::Writer& staged_manifest_writer) {
   return Status::Unimplemented();
@@ -125,7 +129,8 @@ Status UpdateBundleAccessor::DoVerify() {
   // root.
 
   // TODO(pwbug/456): Investigate whether targets payload verification should
-  // be performed here or deferred until a specific target is requested.
+  // be deferred until a specific target is requested.
+  PW_TRY(DoVerifyTargetPayloads());
 
   // TODO(pwbug/456): Invoke the backend to do downstream verification of the
   // bundle (e.g. compatibility and manifest completeness checks).
@@ -133,6 +138,151 @@ Status UpdateBundleAccessor::DoVerify() {
   return OkStatus();
 }
 
+protobuf::StringToBytesMap UpdateBundleAccessor::GetTargetPayloads() {
+  return decoder_.AsStringToBytesMap(static_cast<uint32_t>(
+      pw::software_update::UpdateBundle::Fields::TARGET_PAYLOADS));
+}
+
+Status UpdateBundleAccessor::DoVerifyTargetPayloads() {
+  protobuf::Message targets_metadata = GetTargetsMetadata();
+  PW_TRY(targets_metadata.status());
+
+  // Each target file's payload is looked up by name. Index the payloads so
+  // that each lookup doesn't compare the name of every payload. Bundles with
+  // more payloads than the index holds fall back to scanning.
+  protobuf::StringToBytesMap target_payloads = GetTargetPayloads();
+  PW_TRY(target_payloads.status());
+  std::array<protobuf::StringMapIndexSlot,
+             PW_SOFTWARE_UPDATE_CONFIG_PAYLOAD_INDEX_SLOTS>
+      payload_index;
+  target_payloads.BuildIndex(payload_index).IgnoreError();
+
+  protobuf::RepeatedMessages target_files =
+      targets_metadata.AsRepeatedMessages(static_cast<uint32_t>(
+          pw::software_update::TargetsMetadata::Fields::TARGET_FILES));
+  PW_TRY(target_files.status());
+
+  size_t target_index = 0;
+  for (protobuf::Message target_file : target_files) {
+    const uint32_t target_bit =
+        target_index < StagingProgress::kMaxTrackedTargets
+            ? uint32_t{1} << target_index
+            : 0u;
+    target_index += 1;
+
+    if (staging_progress_ != nullptr &&
+        (staging_progress_->verified_targets & target_bit) != 0u) {
+      PW_LOG_DEBUG("Target payload %u was already verified",
+                   static_cast<unsigned>(target_index - 1));
+      continue;
+    }
+
+    PW_TRY(VerifyTargetPayload(target_file, target_payloads));
+
+    if (staging_progress_ != nullptr && target_bit != 0u) {
+      staging_progress_->verified_targets |= target_bit;
+      if (const Status status =
+              backend_.SaveStagingProgress(*staging_progress_);
+          !status.ok() && !status.IsUnimplemented()) {
+        PW_LOG_WARN("Failed to save target verification progress: %d",
+                    static_cast<int>(status.code()));
+      }
+    }
+  }
+
+  return OkStatus();
+}
+
+Status UpdateBundleAccessor::VerifyTargetPayload(
+    protobuf::Message target_file,
+    protobuf::StringToBytesMap& target_payloads) {
+  // Several fields of the target file are read below. Index it so that the
+  // bundle is not scanned again from the start of the message for each.
+  // A partial index still gives correct lookups, so the status is ignored.
+  std::array<protobuf::Message::IndexEntry, 4> index;
+  target_file.BuildIndex(index).IgnoreError();
+
+  protobuf::String name = target_file.AsString(static_cast<uint32_t>(
+      pw::software_update::TargetFile::Fields::FILE_NAME));
+  PW_TRY(name.status());
+
+  // Copy the name out so that the payload can be looked up by it.
+  std::array<char, PW_SOFTWARE_UPDATE_CONFIG_MAX_TARGET_NAME_LENGTH>
+      name_buffer;
+  stream::IntervalReader name_reader = name.GetBytesReader();
+  const size_t name_length = name_reader.interval_size();
+  if (name_length > name_buffer.size()) {
+    PW_LOG_ERROR("Target file name is too long to verify (%u bytes)",
+                 static_cast<unsigned>(name_length));
+    return Status::ResourceExhausted();
+  }
+  PW_TRY(name_reader.Read(name_buffer.data(), name_length).status());
+  const std::string_view target_file_name(name_buffer.data(), name_length);
+
+  // TODO(pwbug/456): Check personalization instead of treating any missing
+  // payload as personalized out.
+  protobuf::Bytes payload_bytes = target_payloads[target_file_name];
+  if (payload_bytes.status().IsNotFound()) {
+    PW_LOG_DEBUG("Target payload %.*s is not in the bundle",
+                 static_cast<int>(target_file_name.size()),
+                 target_file_name.data());
+    return OkStatus();
+  }
+  PW_TRY(payload_bytes.status());
+  stream::IntervalReader payload = payload_bytes.GetBytesReader();
+
+  protobuf::Uint64 length = target_file.AsUint64(static_cast<uint32_t>(
+      pw::software_update::TargetFile::Fields::LENGTH));
+  PW_TRY(length.status());
+  if (length.value() != payload.interval_size()) {
+    PW_LOG_ERROR("Target payload %.*s has the wrong length",
+                 static_cast<int>(target_file_name.size()),
+                 target_file_name.data());
+    return Status::Unauthenticated();
+  }
+
+  protobuf::RepeatedMessages hashes =
+      target_file.AsRepeatedMessages(static_cast<uint32_t>(
+          pw::software_update::TargetFile::Fields::HASHES));
+  PW_TRY(hashes.status());
+
+  for (protobuf::Message hash : hashes) {
+    protobuf::Uint32 function = hash.AsUint32(
+        static_cast<uint32_t>(pw::software_update::Hash::Fields::FUNCTION));
+    PW_TRY(function.status());
+    if (function.value() !=
+        static_cast<uint32_t>(pw::software_update::HashFunction::SHA256)) {
+      continue;
+    }
+
+    // Read the payload through a larger buffer than the digest, so that long
+    // payloads are hashed in fewer, larger chunks.
+    std::array<std::byte, crypto::sha256::kDigestSizeBytes> digest;
+    std::array<std::byte, PW_SOFTWARE_UPDATE_CONFIG_VERIFY_READ_BUFFER_SIZE>
+        read_buffer;
+    PW_TRY(crypto::sha256::Hash(payload, digest, read_buffer));
+
+    protobuf::Bytes expected_digest = hash.AsBytes(
+        static_cast<uint32_t>(pw::software_update::Hash::Fields::HASH));
+    PW_TRY(expected_digest.status());
+    Result<bool> digest_matches = expected_digest.Equal(digest);
+    PW_TRY(digest_matches.status());
+    if (!digest_matches.value()) {
+      PW_LOG_ERROR("Target payload %.*s has the wrong SHA256 digest",
+                   static_cast<int>(target_file_name.size()),
+                   target_file_name.data());
+      return Status::Unauthenticated();
+    }
+
+    return OkStatus();
+  }
+
+  PW_LOG_ERROR("Target payload %.*s has no SHA256 digest",
+               static_cast<int>(target_file_name.size()),
+               target_file_name.data());
+  return Status::Unauthenticated();
+}
+
 Status UpdateBundleAccessor::DoUpgradeRoot() {
   // TODO(pwbug/456): Check whether the bundle contains a root metadata that
   // is different from the on-device trusted root.
@@ -13,6 +13,8 @@
 // the License.
 
 #include <array>
+#include <cstring>
+#include <string_view>
 
 #include "gtest/gtest.h"
 #include "pw_kvs/fake_flash_memory.h"
@@ -49,6 +51,16 @@ class TestBundledUpdateBackend final : public BundledUpdateBackend {
   }
 
   void DisableBundleTransferHandler() override {}
+
+  Status SaveStagingProgress(const StagingProgress&) override {
+    save_count_ += 1;
+    return OkStatus();
+  }
+
+  size_t save_count() const { return save_count_; }
+
+ private:
+  size_t save_count_ = 0;
 };
 
 class UpdateBundleTest : public testing::Test {
@@ -77,6 +89,23 @@ class UpdateBundleTest : public testing::Test {
     ASSERT_OK(blob_writer.Close());
   }
 
+  // Stages a bundle with the contents of file1 changed, without updating its
+  // metadata.
+  void StageTamperedBundle() {
+    std::array<std::byte, sizeof(kTestBundle)> tampered_bundle;
+    std::memcpy(tampered_bundle.data(), kTestBundle, sizeof(kTestBundle));
+
+    constexpr std::string_view kContent = "file 1 content";
+    const std::string_view bundle_chars(
+        reinterpret_cast<const char*>(tampered_bundle.data()),
+        tampered_bundle.size());
+    const size_t content_offset = bundle_chars.find(kContent);
+    ASSERT_NE(content_offset, std::string_view::npos);
+    tampered_bundle[content_offset] = std::byte{'F'};
+
+    StageTestBundle(tampered_bundle);
+  }
+
  private:
   kvs::FakeFlashMemoryBuffer<kSectorSize, kSectorCount> blob_flash_;
   kvs::FlashPartition blob_partition_;
@@ -140,4 +169,43 @@ TEST_F(UpdateBundleTest, IsTargetPayloadIncluded) {
   ASSERT_FALSE(res.value());
 }
 
+TEST_F(UpdateBundleTest, OpenAndVerify_TamperedPayload_Fails) {
+  StageTamperedBundle();
+  UpdateBundleAccessor update_bundle(bundle_blob(), backend());
+
+  ManifestAccessor current_manifest;
+  EXPECT_EQ(Status::Unauthenticated(),
+            update_bundle.OpenAndVerify(current_manifest));
+}
+
+TEST_F(UpdateBundleTest, OpenAndVerify_RecordsVerifiedTargets) {
+  StageTestBundle(kTestBundle);
+  UpdateBundleAccessor update_bundle(bundle_blob(), backend());
+  StagingProgress progress = {};
+  progress.state = StagingProgress::State::kTransferred;
+  update_bundle.set_staging_progress(&progress);
+
+  ManifestAccessor current_manifest;
+  ASSERT_OK(update_bundle.OpenAndVerify(current_manifest));
+
+  // Both targets are verified, and the progress is saved after each.
+  EXPECT_EQ(progress.verified_targets, 0b11u);
+  EXPECT_EQ(backend().save_count(), 2u);
+}
+
+TEST_F(UpdateBundleTest, OpenAndVerify_SkipsVerifiedTargets) {
+  StageTamperedBundle();
+  UpdateBundleAccessor update_bundle(bundle_blob(), backend());
+  StagingProgress progress = {};
+  progress.state = StagingProgress::State::kTransferred;
+  progress.verified_targets = 0b11;
+  update_bundle.set_staging_progress(&progress);
+
+  // The tampered payload was verified before the bundle was changed, so it is
+  // not hashed again.
+  ManifestAccessor current_manifest;
+  EXPECT_OK(update_bundle.OpenAndVerify(current_manifest));
+  EXPECT_EQ(backend().save_count(), 0u);
+}
+
 }  // namespace pw::software_update
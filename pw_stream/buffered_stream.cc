@@ -0,0 +1,103 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/buffered_stream.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_status/try.h"
+
+namespace pw::stream {
+
+Status BufferedWriter::Flush() {
+  if (size_ == 0u) {
+    return OkStatus();
+  }
+  const Status status = writer_.Write(buffer_.first(size_));
+  size_ = 0;
+  return status;
+}
+
+Status BufferedWriter::DoWrite(ConstByteSpan data) {
+  if (data.empty()) {
+    return OkStatus();
+  }
+  if (const size_t limit = ConservativeLimit(LimitType::kWrite);
+      data.size() > limit) {
+    return limit == 0u ? Status::OutOfRange() : Status::ResourceExhausted();
+  }
+
+  if (data.size() > buffer_.size() - size_) {
+    PW_TRY(Flush());
+
+    if (data.size() >= buffer_.size()) {
+      return writer_.Write(data);
+    }
+  }
+
+  std::memcpy(buffer_.data() + size_, data.data(), data.size());
+  size_ += data.size();
+  return OkStatus();
+}
+
+size_t BufferedWriter::ConservativeLimit(LimitType type) const {
+  if (type == LimitType::kRead) {
+    return 0;
+  }
+  const size_t limit = writer_.ConservativeWriteLimit();
+  if (limit == kUnlimited) {
+    return kUnlimited;
+  }
+  return limit > size_ ? limit - size_ : 0;
+}
+
+StatusWithSize BufferedReader::DoRead(ByteSpan destination) {
+  if (destination.empty()) {
+    return StatusWithSize(0);
+  }
+  if (position_ == end_) {
+    // Large reads bypass the buffer.
+    if (destination.size() >= buffer_.size()) {
+      const Result<ByteSpan> result = reader_.Read(destination);
+      return result.ok() ? StatusWithSize(result.value().size())
+                         : StatusWithSize(result.status(), 0);
+    }
+
+    const Result<ByteSpan> result = reader_.Read(buffer_);
+    if (!result.ok()) {
+      return StatusWithSize(result.status(), 0);
+    }
+    position_ = 0;
+    end_ = result.value().size();
+  }
+
+  const size_t size = std::min(destination.size(), end_ - position_);
+  std::memcpy(destination.data(), buffer_.data() + position_, size);
+  position_ += size;
+  return StatusWithSize(size);
+}
+
+size_t BufferedReader::ConservativeLimit(LimitType type) const {
+  if (type == LimitType::kWrite) {
+    return 0;
+  }
+  const size_t limit = reader_.ConservativeReadLimit();
+  if (limit == kUnlimited) {
+    return kUnlimited;
+  }
+  return limit + buffered_bytes();
+}
+
+}  // namespace pw::stream
@@ -0,0 +1,203 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/buffered_stream.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::stream {
+namespace {
+
+constexpr auto kData = bytes::Array<1, 2, 3, 4, 5, 6, 7, 8, 9, 10>();
+
+// Counts the writes that reach the underlying stream.
+class CountingWriter : public NonSeekableWriter {
+ public:
+  constexpr CountingWriter(ByteSpan buffer) : writer_(buffer), writes_(0) {}
+
+  size_t writes() const { return writes_; }
+  ConstByteSpan data() const { return writer_.WrittenData(); }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    return writer_.Write(data);
+  }
+
+  size_t ConservativeLimit(LimitType type) const override {
+    return type == LimitType::kWrite ? writer_.ConservativeWriteLimit() : 0;
+  }
+
+  MemoryWriter writer_;
+  size_t writes_;
+};
+
+// Counts the reads of the underlying stream.
+class CountingReader : public NonSeekableReader {
+ public:
+  constexpr CountingReader(ConstByteSpan data) : reader_(data), reads_(0) {}
+
+  size_t reads() const { return reads_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    reads_ += 1;
+    const Result<ByteSpan> result = reader_.Read(destination);
+    return result.ok() ? StatusWithSize(result.value().size())
+                       : StatusWithSize(result.status(), 0);
+  }
+
+  size_t ConservativeLimit(LimitType type) const override {
+    return type == LimitType::kRead ? reader_.ConservativeReadLimit() : 0;
+  }
+
+  MemoryReader reader_;
+  size_t reads_;
+};
+
+class BufferedWriterTest : public ::testing::Test {
+ protected:
+  BufferedWriterTest() : output_{}, counting_writer_(output_) {}
+
+  std::array<std::byte, 32> output_;
+  CountingWriter counting_writer_;
+};
+
+TEST_F(BufferedWriterTest, SmallWrites_CombinedUntilFlush) {
+  BufferedWriterBuffer<4> writer(counting_writer_);
+  for (std::byte b : std::span(kData).first(3)) {
+    ASSERT_EQ(OkStatus(), writer.Write(b));
+  }
+  EXPECT_EQ(0u, counting_writer_.writes());
+  EXPECT_EQ(3u, writer.buffered_bytes());
+
+  ASSERT_EQ(OkStatus(), writer.Flush());
+  EXPECT_EQ(1u, counting_writer_.writes());
+  EXPECT_EQ(0u, writer.buffered_bytes());
+  ASSERT_EQ(3u, counting_writer_.data().size());
+  EXPECT_EQ(0, std::memcmp(kData.data(), counting_writer_.data().data(), 3));
+}
+
+TEST_F(BufferedWriterTest, BufferFull_WritesBuffer) {
+  BufferedWriterBuffer<4> writer(counting_writer_);
+  for (std::byte b : kData) {
+    ASSERT_EQ(OkStatus(), writer.Write(b));
+  }
+  EXPECT_EQ(2u, counting_writer_.writes());
+  EXPECT_EQ(2u, writer.buffered_bytes());
+
+  ASSERT_EQ(OkStatus(), writer.Flush());
+  ASSERT_EQ(kData.size(), counting_writer_.data().size());
+  EXPECT_EQ(0, std::memcmp(kData.data(), output_.data(), kData.size()));
+}
+
+TEST_F(BufferedWriterTest, LargeWrite_PassedThroughAfterBufferedData) {
+  BufferedWriterBuffer<4> writer(counting_writer_);
+  ASSERT_EQ(OkStatus(), writer.Write(kData[0]));
+  ASSERT_EQ(OkStatus(), writer.Write(std::span(kData).subspan(1)));
+
+  EXPECT_EQ(2u, counting_writer_.writes());
+  EXPECT_EQ(0u, writer.buffered_bytes());
+  ASSERT_EQ(kData.size(), counting_writer_.data().size());
+  EXPECT_EQ(0, std::memcmp(kData.data(), output_.data(), kData.size()));
+}
+
+TEST_F(BufferedWriterTest, Destructor_Flushes) {
+  {
+    BufferedWriterBuffer<16> writer(counting_writer_);
+    ASSERT_EQ(OkStatus(), writer.Write(kData));
+    EXPECT_EQ(0u, counting_writer_.writes());
+  }
+  EXPECT_EQ(1u, counting_writer_.writes());
+  EXPECT_EQ(kData.size(), counting_writer_.data().size());
+}
+
+TEST_F(BufferedWriterTest, ConservativeWriteLimit_IncludesBufferedData) {
+  BufferedWriterBuffer<16> writer(counting_writer_);
+  EXPECT_EQ(output_.size(), writer.ConservativeWriteLimit());
+
+  ASSERT_EQ(OkStatus(), writer.Write(kData));
+  EXPECT_EQ(output_.size() - kData.size(), writer.ConservativeWriteLimit());
+  EXPECT_EQ(0u, writer.ConservativeReadLimit());
+}
+
+TEST_F(BufferedWriterTest, WriteBeyondLimit_ResourceExhausted) {
+  BufferedWriterBuffer<16> writer(counting_writer_);
+  ASSERT_EQ(OkStatus(), writer.Write(kData));
+  ASSERT_EQ(OkStatus(), writer.Write(kData));
+  ASSERT_EQ(OkStatus(), writer.Write(kData));
+
+  EXPECT_EQ(Status::ResourceExhausted(), writer.Write(kData));
+  EXPECT_EQ(OkStatus(), writer.Flush());
+  EXPECT_EQ(3 * kData.size(), counting_writer_.data().size());
+}
+
+TEST(BufferedReader, SmallReads_ReadUnderlyingStreamOnce) {
+  CountingReader counting_reader(kData);
+  BufferedReaderBuffer<16> reader(counting_reader);
+
+  std::byte b;
+  for (std::byte expected : kData) {
+    ASSERT_EQ(OkStatus(), reader.Read(&b, 1).status());
+    EXPECT_EQ(expected, b);
+  }
+  EXPECT_EQ(1u, counting_reader.reads());
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(&b, 1).status());
+}
+
+TEST(BufferedReader, ReadSpansRefills_ReturnsBufferedDataFirst) {
+  CountingReader counting_reader(kData);
+  BufferedReaderBuffer<4> reader(counting_reader);
+
+  std::array<std::byte, 3> buffer;
+  ASSERT_EQ(OkStatus(), reader.Read(buffer).status());
+  EXPECT_EQ(1u, reader.buffered_bytes());
+
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(1u, result.value().size());
+  EXPECT_EQ(kData[3], buffer[0]);
+}
+
+TEST(BufferedReader, LargeRead_BypassesBuffer) {
+  CountingReader counting_reader(kData);
+  BufferedReaderBuffer<4> reader(counting_reader);
+
+  std::array<std::byte, 16> buffer;
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(kData.size(), result.value().size());
+  EXPECT_EQ(0, std::memcmp(kData.data(), buffer.data(), kData.size()));
+  EXPECT_EQ(0u, reader.buffered_bytes());
+}
+
+TEST(BufferedReader, ConservativeReadLimit_IncludesBufferedData) {
+  CountingReader counting_reader(kData);
+  BufferedReaderBuffer<8> reader(counting_reader);
+  EXPECT_EQ(kData.size(), reader.ConservativeReadLimit());
+
+  std::byte b;
+  ASSERT_EQ(OkStatus(), reader.Read(&b, 1).status());
+  EXPECT_EQ(kData.size() - 1, reader.ConservativeReadLimit());
+  EXPECT_EQ(0u, reader.ConservativeWriteLimit());
+}
+
+}  // namespace
+}  // namespace pw::stream
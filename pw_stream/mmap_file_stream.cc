@@ -0,0 +1,88 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/mmap_file_stream.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "pw_log/log.h"
+#include "pw_stream/seek.h"
+
+namespace pw::stream {
+
+Status MmapFileReader::Open(const char* path) {
+  Close();
+
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return errno == ENOENT ? Status::NotFound() : Status::Unknown();
+  }
+
+  Status status = OkStatus();
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    status = Status::Unknown();
+  } else if (file_stat.st_size > 0) {
+    // mmap fails for empty files, which are represented with no mapping.
+    const size_t size = static_cast<size_t>(file_stat.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      PW_LOG_ERROR("Failed to map %s: %s", path, std::strerror(errno));
+      status = Status::Unknown();
+    } else {
+      data_ = static_cast<const std::byte*>(mapping);
+      size_ = size;
+    }
+  }
+
+  // The mapping remains valid after the file is closed.
+  close(fd);
+  return status;
+}
+
+void MmapFileReader::Close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<std::byte*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  position_ = 0;
+}
+
+StatusWithSize MmapFileReader::DoRead(ByteSpan destination) {
+  if (position_ >= size_) {
+    return StatusWithSize::OutOfRange();
+  }
+  if (destination.empty()) {
+    return StatusWithSize(0);
+  }
+
+  const size_t size = std::min(destination.size(), size_ - position_);
+  std::memcpy(destination.data(), data_ + position_, size);
+  position_ += size;
+  return StatusWithSize(size);
+}
+
+Status MmapFileReader::DoSeek(ssize_t offset, Whence origin) {
+  return CalculateSeek(offset, origin, size_, position_);
+}
+
+}  // namespace pw::stream
@@ -0,0 +1,157 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/mmap_file_stream.h"
+
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_stream/interval_reader.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::stream {
+namespace {
+
+constexpr auto kData = bytes::Array<1, 2, 3, 4, 5, 6, 7, 8, 9, 10>();
+
+// Creates a temporary file with the provided contents.
+class TempFile {
+ public:
+  TempFile(ConstByteSpan contents) : path_{"/tmp/pw_mmap_file_testXXXXXX"} {
+    const int fd = mkstemp(path_.data());
+    if (fd >= 0) {
+      ok_ = write(fd, contents.data(), contents.size()) ==
+            static_cast<ssize_t>(contents.size());
+      close(fd);
+    }
+  }
+
+  ~TempFile() { unlink(path_.data()); }
+
+  const char* path() const { return path_.data(); }
+  bool ok() const { return ok_; }
+
+ private:
+  std::array<char, 32> path_;
+  bool ok_ = false;
+};
+
+TEST(MmapFileReader, ReadWholeFile) {
+  TempFile file(kData);
+  ASSERT_TRUE(file.ok());
+
+  MmapFileReader reader;
+  ASSERT_EQ(OkStatus(), reader.Open(file.path()));
+  EXPECT_EQ(kData.size(), reader.ConservativeReadLimit());
+
+  std::array<std::byte, 16> buffer;
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(kData.size(), result.value().size());
+  EXPECT_EQ(0, std::memcmp(kData.data(), buffer.data(), kData.size()));
+
+  EXPECT_EQ(0u, reader.ConservativeReadLimit());
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(buffer).status());
+}
+
+TEST(MmapFileReader, Seek) {
+  TempFile file(kData);
+  ASSERT_TRUE(file.ok());
+
+  MmapFileReader reader;
+  ASSERT_EQ(OkStatus(), reader.Open(file.path()));
+
+  ASSERT_EQ(OkStatus(), reader.Seek(-2, Stream::kEnd));
+  EXPECT_EQ(kData.size() - 2, reader.Tell());
+
+  std::array<std::byte, 4> buffer;
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(2u, result.value().size());
+  EXPECT_EQ(kData[8], buffer[0]);
+
+  EXPECT_EQ(Status::OutOfRange(), reader.Seek(kData.size() + 1));
+}
+
+TEST(MmapFileReader, DataExposesMapping) {
+  TempFile file(kData);
+  ASSERT_TRUE(file.ok());
+
+  MmapFileReader reader;
+  ASSERT_EQ(OkStatus(), reader.Open(file.path()));
+  ASSERT_EQ(kData.size(), reader.data().size());
+  EXPECT_EQ(0, std::memcmp(kData.data(), reader.data().data(), kData.size()));
+
+  // Read a slice of the file without copying it into a buffer first.
+  MemoryReader slice(reader.data().subspan(4, 3));
+  std::array<std::byte, 8> buffer;
+  Result<ByteSpan> result = slice.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(3u, result.value().size());
+  EXPECT_EQ(kData[4], buffer[0]);
+}
+
+TEST(MmapFileReader, IntervalReader) {
+  TempFile file(kData);
+  ASSERT_TRUE(file.ok());
+
+  MmapFileReader reader;
+  ASSERT_EQ(OkStatus(), reader.Open(file.path()));
+  IntervalReader interval(reader, 2, 5);
+
+  std::array<std::byte, 8> buffer;
+  Result<ByteSpan> result = interval.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(3u, result.value().size());
+  EXPECT_EQ(kData[2], buffer[0]);
+  EXPECT_EQ(kData[4], buffer[2]);
+}
+
+TEST(MmapFileReader, EmptyFile) {
+  TempFile file(ConstByteSpan{});
+  ASSERT_TRUE(file.ok());
+
+  MmapFileReader reader;
+  ASSERT_EQ(OkStatus(), reader.Open(file.path()));
+  EXPECT_TRUE(reader.data().empty());
+
+  std::array<std::byte, 4> buffer;
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(buffer).status());
+}
+
+TEST(MmapFileReader, MissingFile_NotFound) {
+  MmapFileReader reader;
+  EXPECT_EQ(Status::NotFound(), reader.Open("/this/file/does/not/exist"));
+  EXPECT_TRUE(reader.data().empty());
+}
+
+TEST(MmapFileReader, Close_UnmapsFile) {
+  TempFile file(kData);
+  ASSERT_TRUE(file.ok());
+
+  MmapFileReader reader;
+  ASSERT_EQ(OkStatus(), reader.Open(file.path()));
+  reader.Close();
+  EXPECT_TRUE(reader.data().empty());
+  EXPECT_EQ(0u, reader.ConservativeReadLimit());
+}
+
+}  // namespace
+}  // namespace pw::stream
@@ -0,0 +1,109 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+
+// Collects small writes in a buffer and passes them to another Writer in
+// larger chunks. This reduces the cost of writing to streams with a high
+// per-write overhead, such as sockets, when data is written a few bytes at a
+// time (e.g. encoding a protobuf field by field).
+//
+// Buffered data is written when the buffer fills, when Flush() is called, or
+// when the BufferedWriter is destroyed. Writes larger than the buffer are
+// passed directly to the underlying writer after any buffered data.
+class BufferedWriter : public NonSeekableWriter {
+ public:
+  constexpr BufferedWriter(Writer& writer, ByteSpan buffer)
+      : writer_(writer), buffer_(buffer), size_(0) {}
+
+  ~BufferedWriter() override { Flush().IgnoreError(); }
+
+  // Writes the buffered data to the underlying writer. Returns the underlying
+  // writer's status. The buffer is emptied even if the write fails.
+  Status Flush();
+
+  // The number of bytes written to the BufferedWriter that have not been
+  // passed to the underlying writer.
+  size_t buffered_bytes() const { return size_; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override;
+
+  // Data is only written to the underlying writer when the buffer is flushed,
+  // so the limit accounts for the buffered data.
+  size_t ConservativeLimit(LimitType type) const override;
+
+  Writer& writer_;
+  ByteSpan buffer_;
+  size_t size_;
+};
+
+// BufferedWriter with an internal buffer.
+template <size_t kSizeBytes>
+class BufferedWriterBuffer final : public BufferedWriter {
+ public:
+  constexpr BufferedWriterBuffer(Writer& writer)
+      : BufferedWriter(writer, buffer_) {}
+
+ private:
+  std::array<std::byte, kSizeBytes> buffer_;
+};
+
+// Reads from another Reader in chunks of up to the buffer size, so that many
+// small reads result in few reads of the underlying stream. Reads of at least
+// the buffer size go directly to the underlying reader when the buffer is
+// empty.
+//
+// Reads return data from the buffer only, so a read may return fewer bytes than
+// requested even if the underlying reader has more data.
+class BufferedReader : public NonSeekableReader {
+ public:
+  constexpr BufferedReader(Reader& reader, ByteSpan buffer)
+      : reader_(reader), buffer_(buffer), position_(0), end_(0) {}
+
+  // The number of bytes read from the underlying reader but not yet returned.
+  size_t buffered_bytes() const { return end_ - position_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override;
+
+  size_t ConservativeLimit(LimitType type) const override;
+
+  Reader& reader_;
+  ByteSpan buffer_;
+  size_t position_;
+  size_t end_;
+};
+
+// BufferedReader with an internal buffer.
+template <size_t kSizeBytes>
+class BufferedReaderBuffer final : public BufferedReader {
+ public:
+  constexpr BufferedReaderBuffer(Reader& reader)
+      : BufferedReader(reader, buffer_) {}
+
+ private:
+  std::array<std::byte, kSizeBytes> buffer_;
+};
+
+}  // namespace pw::stream
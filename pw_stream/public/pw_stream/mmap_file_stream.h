@@ -0,0 +1,69 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+
+// Reads a file that is mapped into memory with mmap. Reads and seeks are
+// memory operations rather than system calls, and the OS pages the file in as
+// it is accessed, so large files can be scanned without reading them into a
+// buffer first. Available on POSIX hosts.
+//
+// data() exposes the mapped file, so parts of it can be used without copying.
+// For example, a MemoryReader over data().subspan(offset, size) reads a slice
+// of the file with no extra copies.
+class MmapFileReader final : public SeekableReader {
+ public:
+  constexpr MmapFileReader() : data_(nullptr), size_(0), position_(0) {}
+
+  MmapFileReader(const MmapFileReader&) = delete;
+  MmapFileReader& operator=(const MmapFileReader&) = delete;
+
+  ~MmapFileReader() override { Close(); }
+
+  // Maps the file at path, closing any file that is already open. Returns
+  // NOT_FOUND if the file does not exist, or UNKNOWN if it cannot be mapped.
+  Status Open(const char* path);
+
+  // Unmaps the file. Spans from data() are invalid after this.
+  void Close();
+
+  // The contents of the mapped file. Valid until Close() is called or the
+  // MmapFileReader is destroyed.
+  ConstByteSpan data() const { return ConstByteSpan(data_, size_); }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override;
+
+  Status DoSeek(ssize_t offset, Whence origin) override;
+
+  size_t DoTell() const override { return position_; }
+
+  size_t ConservativeLimit(LimitType type) const override {
+    return type == LimitType::kRead ? size_ - position_ : 0;
+  }
+
+  const std::byte* data_;
+  size_t size_;
+  size_t position_;
+};
+
+}  // namespace pw::stream
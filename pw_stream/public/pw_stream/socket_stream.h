@@ -18,6 +18,9 @@
 #include <cstdint>
 #include <span>
 
+#include "pw_chrono/system_clock.h"
+#include "pw_result/result.h"
+#include "pw_status/status_with_size.h"
 #include "pw_stream/stream.h"
 
 namespace pw::stream {
@@ -38,11 +41,39 @@ class SocketStream : public NonSeekableReaderWriter {
   // Close the socket stream and release all resources
   void Close();
 
+  // The operations that would not block, as reported by Poll().
+  struct Readiness {
+    bool readable;  // TryRead() returns data, or the peer closed the socket.
+    bool writable;  // TryWrite() accepts at least one byte.
+  };
+
+  // Waits until the connection is readable or writable, or until the timeout
+  // expires. Returns DEADLINE_EXCEEDED if the timeout expires, or
+  // FAILED_PRECONDITION if the stream is not connected.
+  Result<Readiness> Poll(chrono::SystemClock::duration timeout);
+
+  // Reads the data that is available without blocking. Returns UNAVAILABLE if
+  // there is no data, OUT_OF_RANGE if the peer closed the connection, or
+  // UNKNOWN on other errors.
+  Result<ByteSpan> TryRead(ByteSpan dest);
+
+  // Writes as much of the data as possible without blocking. Returns the number
+  // of bytes written, which may be less than data.size(), or UNAVAILABLE if no
+  // data could be written.
+  StatusWithSize TryWrite(ConstByteSpan data);
+
+  // The connected socket's file descriptor, for use with poll(), epoll, etc. to
+  // wait on many streams at once. Returns -1 if not connected.
+  int connection_fd() const { return conn_fd_; }
+
  private:
   static constexpr int kInvalidFd = -1;
 
   Status DoWrite(std::span<const std::byte> data) override;
 
+  // Sends the buffers with sendmsg, which writes many buffers per system call.
+  Status DoWriteV(std::span<const ConstByteSpan> data) override;
+
   StatusWithSize DoRead(ByteSpan dest) override;
 
   uint16_t listen_port_ = 0;
@@ -148,6 +148,21 @@ class Stream {
   }
   Status Write(const std::byte b) { return Write(&b, 1); }
 
+  // Writes the concatenation of several buffers to this stream. Streams that
+  // can issue vectored writes, such as sockets, send the buffers with a single
+  // operation. Other streams write the buffers in order with DoWrite().
+  //
+  // WriteV() returns the same statuses as Write(). If the total size exceeds a
+  // known ConservativeWriteLimit(), RESOURCE_EXHAUSTED is returned and no data
+  // is written. Otherwise, if writing one of the buffers fails, the preceding
+  // buffers may have been written.
+  //
+  // Derived classes should NOT try to override WriteV(). Instead, override
+  // DoWriteV() if the stream has a more efficient vectored write.
+  Status WriteV(std::span<const ConstByteSpan> data) {
+    return DoWriteV(data);
+  }
+
   // Changes the current position in the stream for both reading and writing, if
   // supported.
   //
@@ -248,6 +263,9 @@ class Stream {
 
   virtual Status DoWrite(ConstByteSpan data) = 0;
 
+  // Writes each buffer with DoWrite().
+  virtual Status DoWriteV(std::span<const ConstByteSpan> data);
+
   virtual Status DoSeek(ssize_t offset, Whence origin) = 0;
 
   virtual size_t DoTell() const { return kUnknownPosition; }
@@ -286,6 +304,7 @@ class Reader : public Stream {
       : Stream(true, false, seekability) {}
 
   using Stream::Write;
+  using Stream::WriteV;
 
   Status DoWrite(ConstByteSpan) final { return Status::Unimplemented(); }
 };
@@ -13,21 +13,112 @@
 // the License.
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <limits>
 #include <span>
 
+#include "pw_status/try.h"
 #include "pw_stream/stream.h"
+#include "pw_sys_io/async.h"
 #include "pw_sys_io/sys_io.h"
 
 namespace pw::stream {
 
+// Writes to pw::sys_io with sys_io::WriteBytesAsync. Small writes are copied
+// into an internal buffer and return while the data is sent, so the caller can
+// continue while the backend transmits (with DMA, if the backend supports it).
+// Each write waits for the previous one to finish. Writes that do not fit in
+// the buffer are sent from the caller's buffer and wait until they finish.
+//
+// Since writes are asynchronous, an error from a write is reported by the next
+// write or Flush() call.
 class SysIoWriter : public NonSeekableWriter {
+ public:
+  ~SysIoWriter() override { Flush().IgnoreError(); }
+
+  // Waits for any write in progress to finish. Returns the status of the last
+  // write that has not been reported yet.
+  Status Flush() {
+    while (!write_done_) {
+    }
+    const Status status = write_status_;
+    write_status_ = OkStatus();
+    return status;
+  }
+
  private:
+  // Size of the buffer used for asynchronous writes. DoWriteV combines
+  // consecutive small buffers into it so that each WriteBytesAsync call, which
+  // may be a UART transaction, sends more data.
+  static constexpr size_t kBufferSizeBytes = 64;
+
   Status DoWrite(std::span<const std::byte> data) override {
-    return pw::sys_io::WriteBytes(data).status();
+    PW_TRY(Flush());
+    if (data.size() > buffer_.size()) {
+      return WriteAndWait(data);
+    }
+    std::copy(data.begin(), data.end(), buffer_.begin());
+    return StartWrite(std::span(buffer_).first(data.size()));
+  }
+
+  // Copies consecutive small buffers into the buffer. Large buffers are
+  // written directly.
+  Status DoWriteV(std::span<const ConstByteSpan> data) override {
+    PW_TRY(Flush());
+    size_t pending_size = 0;
+
+    for (ConstByteSpan buffer : data) {
+      if (pending_size + buffer.size() > buffer_.size()) {
+        if (pending_size != 0u) {
+          PW_TRY(WriteAndWait(std::span(buffer_).first(pending_size)));
+          pending_size = 0;
+        }
+        if (buffer.size() >= buffer_.size()) {
+          PW_TRY(WriteAndWait(buffer));
+          continue;
+        }
+      }
+      std::copy(buffer.begin(), buffer.end(), buffer_.begin() + pending_size);
+      pending_size += buffer.size();
+    }
+
+    if (pending_size == 0u) {
+      return OkStatus();
+    }
+    return StartWrite(std::span(buffer_).first(pending_size));
+  }
+
+  // Starts an asynchronous write. The data must remain valid until Flush()
+  // returns.
+  Status StartWrite(ConstByteSpan data) {
+    write_done_ = false;
+
+    // Another writer may be using sys_io; wait for its write to finish.
+    Status status;
+    do {
+      status = sys_io::WriteBytesAsync(data, [this](StatusWithSize result) {
+        write_status_ = result.status();
+        write_done_ = true;
+      });
+    } while (status.IsUnavailable());
+
+    if (!status.ok()) {
+      write_done_ = true;
+    }
+    return status;
+  }
+
+  Status WriteAndWait(ConstByteSpan data) {
+    PW_TRY(StartWrite(data));
+    return Flush();
   }
+
+  std::array<std::byte, kBufferSizeBytes> buffer_;
+  std::atomic<bool> write_done_ = true;
+  Status write_status_;
 };
 
 class SysIoReader : public NonSeekableReader {
@@ -15,9 +15,17 @@
 #include "pw_stream/socket_stream.h"
 
 #include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
 #include <cstring>
+#include <limits>
 
 #include "pw_log/log.h"
 
@@ -27,6 +35,17 @@ namespace {
 constexpr uint32_t kMaxConcurrentUser = 1;
 constexpr const char* kLocalhostAddress = "127.0.0.1";
 
+// The number of buffers sent with each sendmsg call in DoWriteV. This is well
+// under the minimum IOV_MAX required by POSIX.
+constexpr size_t kMaxIoVecs = 16;
+
+// Avoid SIGPIPE if the peer has closed the connection, where supported.
+#if defined(MSG_NOSIGNAL)
+constexpr int kTryWriteFlags = MSG_DONTWAIT | MSG_NOSIGNAL;
+#else
+constexpr int kTryWriteFlags = MSG_DONTWAIT;
+#endif  // defined(MSG_NOSIGNAL)
+
 }  // namespace
 
 // Listen to the port and return after a client is connected
@@ -115,12 +134,105 @@ void SocketStream::Close() {
   }
 }
 
-Status SocketStream::DoWrite(std::span<const std::byte> data) {
-  ssize_t bytes_sent = send(conn_fd_, data.data(), data.size_bytes(), 0);
+Result<SocketStream::Readiness> SocketStream::Poll(
+    chrono::SystemClock::duration timeout) {
+  if (conn_fd_ == kInvalidFd) {
+    return Status::FailedPrecondition();
+  }
+
+  // Round up so that short timeouts do not become non-blocking polls.
+  const auto timeout_ms =
+      std::chrono::ceil<std::chrono::milliseconds>(timeout).count();
+  const int poll_timeout = static_cast<int>(std::clamp<decltype(timeout_ms)>(
+      timeout_ms, 0, std::numeric_limits<int>::max()));
+
+  pollfd fd = {};
+  fd.fd = conn_fd_;
+  fd.events = POLLIN | POLLOUT;
+
+  int result;
+  do {
+    result = poll(&fd, 1, poll_timeout);
+  } while (result < 0 && errno == EINTR);
 
-  if (bytes_sent < 0 || static_cast<size_t>(bytes_sent) != data.size()) {
+  if (result < 0) {
     return Status::Unknown();
   }
+  if (result == 0) {
+    return Status::DeadlineExceeded();
+  }
+
+  // Errors and hangups are readable, since the next read reports them.
+  Readiness readiness;
+  readiness.readable = (fd.revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+  readiness.writable = (fd.revents & POLLOUT) != 0;
+  return readiness;
+}
+
+Result<ByteSpan> SocketStream::TryRead(ByteSpan dest) {
+  const ssize_t bytes_rcvd =
+      recv(conn_fd_, dest.data(), dest.size_bytes(), MSG_DONTWAIT);
+  if (bytes_rcvd < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK ? Status::Unavailable()
+                                                   : Status::Unknown();
+  }
+  if (bytes_rcvd == 0 && !dest.empty()) {
+    return Status::OutOfRange();
+  }
+  return dest.first(static_cast<size_t>(bytes_rcvd));
+}
+
+StatusWithSize SocketStream::TryWrite(ConstByteSpan data) {
+  const ssize_t bytes_sent =
+      send(conn_fd_, data.data(), data.size_bytes(), kTryWriteFlags);
+  if (bytes_sent < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK
+               ? StatusWithSize::Unavailable()
+               : StatusWithSize::Unknown();
+  }
+  return StatusWithSize(static_cast<size_t>(bytes_sent));
+}
+
+Status SocketStream::DoWrite(std::span<const std::byte> data) {
+  // send() may write part of the data, for example if it is interrupted.
+  while (!data.empty()) {
+    const ssize_t bytes_sent =
+        send(conn_fd_, data.data(), data.size_bytes(), 0);
+    if (bytes_sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return Status::Unknown();
+    }
+    data = data.subspan(static_cast<size_t>(bytes_sent));
+  }
+  return OkStatus();
+}
+
+Status SocketStream::DoWriteV(std::span<const ConstByteSpan> data) {
+  while (!data.empty()) {
+    std::array<iovec, kMaxIoVecs> iov;
+    size_t iov_count = 0;
+    size_t total_size = 0;
+
+    for (; iov_count < iov.size() && iov_count < data.size(); ++iov_count) {
+      // iovec is not const-correct; sendmsg does not modify the buffers.
+      iov[iov_count].iov_base = const_cast<std::byte*>(data[iov_count].data());
+      iov[iov_count].iov_len = data[iov_count].size();
+      total_size += data[iov_count].size();
+    }
+
+    msghdr message = {};
+    message.msg_iov = iov.data();
+    message.msg_iovlen = iov_count;
+
+    ssize_t bytes_sent = sendmsg(conn_fd_, &message, 0);
+    if (bytes_sent < 0 || static_cast<size_t>(bytes_sent) != total_size) {
+      return Status::Unknown();
+    }
+
+    data = data.subspan(iov_count);
+  }
   return OkStatus();
 }
 
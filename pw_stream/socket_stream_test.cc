@@ -0,0 +1,116 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/socket_stream.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::stream {
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr uint16_t kPort = 33300;
+constexpr auto kData = bytes::Array<1, 2, 3, 4, 5>();
+
+class SocketStreamTest : public ::testing::Test {
+ protected:
+  SocketStreamTest() {
+    std::thread server_thread([this] { serve_status_ = server_.Serve(kPort); });
+
+    // The server may not be listening yet; retry until the connection succeeds.
+    for (int attempt = 0; attempt < 100; ++attempt) {
+      if (client_.Connect(nullptr, kPort).ok()) {
+        break;
+      }
+      client_.Close();
+      std::this_thread::sleep_for(10ms);
+    }
+    server_thread.join();
+  }
+
+  SocketStream server_;
+  SocketStream client_;
+  Status serve_status_;
+};
+
+TEST_F(SocketStreamTest, TryRead_NoData_Unavailable) {
+  ASSERT_EQ(OkStatus(), serve_status_);
+  std::array<std::byte, 8> buffer;
+  EXPECT_EQ(Status::Unavailable(), server_.TryRead(buffer).status());
+}
+
+TEST_F(SocketStreamTest, TryWriteAndTryRead) {
+  ASSERT_EQ(OkStatus(), serve_status_);
+  const StatusWithSize written = client_.TryWrite(kData);
+  ASSERT_EQ(OkStatus(), written.status());
+  ASSERT_EQ(kData.size(), written.size());
+
+  Result<SocketStream::Readiness> ready = server_.Poll(1s);
+  ASSERT_EQ(OkStatus(), ready.status());
+  EXPECT_TRUE(ready->readable);
+
+  std::array<std::byte, 8> buffer;
+  Result<ByteSpan> result = server_.TryRead(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(kData.size(), result->size());
+  EXPECT_EQ(0, std::memcmp(kData.data(), result->data(), kData.size()));
+}
+
+TEST_F(SocketStreamTest, Poll_NoData_WritableOnly) {
+  ASSERT_EQ(OkStatus(), serve_status_);
+  Result<SocketStream::Readiness> ready = server_.Poll(10ms);
+  ASSERT_EQ(OkStatus(), ready.status());
+  EXPECT_FALSE(ready->readable);
+  EXPECT_TRUE(ready->writable);
+}
+
+TEST_F(SocketStreamTest, TryRead_PeerClosed_OutOfRange) {
+  ASSERT_EQ(OkStatus(), serve_status_);
+  client_.Close();
+
+  Result<SocketStream::Readiness> ready = server_.Poll(1s);
+  ASSERT_EQ(OkStatus(), ready.status());
+  EXPECT_TRUE(ready->readable);
+
+  std::array<std::byte, 8> buffer;
+  EXPECT_EQ(Status::OutOfRange(), server_.TryRead(buffer).status());
+}
+
+TEST_F(SocketStreamTest, TryWrite_PeerNotReading_Unavailable) {
+  ASSERT_EQ(OkStatus(), serve_status_);
+  std::array<std::byte, 4096> buffer = {};
+
+  // Fill the socket buffers, since the server never reads.
+  StatusWithSize result;
+  for (int i = 0; i < 100000 && result.ok(); ++i) {
+    result = client_.TryWrite(buffer);
+  }
+  EXPECT_EQ(Status::Unavailable(), result.status());
+}
+
+TEST(SocketStream, Poll_NotConnected_FailedPrecondition) {
+  SocketStream stream;
+  EXPECT_EQ(Status::FailedPrecondition(), stream.Poll(0ms).status());
+}
+
+}  // namespace
+}  // namespace pw::stream
@@ -14,6 +14,8 @@
 
 #include "pw_stream/std_file_stream.h"
 
+#include "pw_preprocessor/compiler.h"
+
 namespace pw::stream {
 namespace {
 
@@ -26,6 +28,7 @@ std::ios::seekdir WhenceToSeekDir(Stream::Whence whence) {
     case Stream::Whence::kEnd:
       return std::ios::end;
   }
+  PW_UNREACHABLE;
 }
 
 }  // namespace
@@ -0,0 +1,45 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+
+Status Stream::DoWriteV(std::span<const ConstByteSpan> data) {
+  if (!writable()) {
+    return Status::Unimplemented();
+  }
+
+  if (const size_t limit = ConservativeWriteLimit(); limit != kUnlimited) {
+    size_t total_size = 0;
+    for (ConstByteSpan buffer : data) {
+      total_size += buffer.size();
+    }
+    if (total_size > limit) {
+      return limit == 0u ? Status::OutOfRange() : Status::ResourceExhausted();
+    }
+  }
+
+  for (ConstByteSpan buffer : data) {
+    if (buffer.empty()) {
+      continue;
+    }
+    if (Status status = Write(buffer); !status.ok()) {
+      return status;
+    }
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::stream
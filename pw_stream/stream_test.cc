@@ -14,9 +14,13 @@
 
 #include "pw_stream/stream.h"
 
+#include <array>
+#include <cstring>
 #include <limits>
+#include <span>
 
 #include "gtest/gtest.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_stream/null_stream.h"
 
 namespace pw::stream {
@@ -194,6 +198,56 @@ TEST(Stream, SeekableReaderWriter) {
   TestStreamImpl<TestSeekableReaderWriter, kReadable, kWritable, kSeekable>();
 }
 
+// Records each DoWrite call in a MemoryWriter.
+class CountingWriter : public NonSeekableWriter {
+ public:
+  size_t writes() const { return writes_; }
+  ConstByteSpan data() const { return writer_.WrittenData(); }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    return writer_.Write(data);
+  }
+
+  MemoryWriterBuffer<16> writer_;
+  size_t writes_ = 0;
+};
+
+constexpr std::byte kWriteVData[] = {
+    std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}, std::byte{5}};
+
+TEST(Stream, WriteV_Default_WritesBuffersInOrder) {
+  CountingWriter writer;
+  const ConstByteSpan buffers[] = {std::span(kWriteVData).first(2),
+                                   ConstByteSpan(),
+                                   std::span(kWriteVData).subspan(2)};
+
+  ASSERT_EQ(OkStatus(), writer.WriteV(buffers));
+  EXPECT_EQ(2u, writer.writes());  // The empty buffer is skipped.
+  ASSERT_EQ(sizeof(kWriteVData), writer.data().size());
+  EXPECT_EQ(0, std::memcmp(kWriteVData, writer.data().data(), 5));
+}
+
+TEST(Stream, WriteV_ExceedsWriteLimit_WritesNothing) {
+  std::array<std::byte, 4> buffer;
+  MemoryWriter writer(buffer);
+  const ConstByteSpan buffers[] = {std::span(kWriteVData).first(2),
+                                   std::span(kWriteVData).subspan(2)};
+
+  EXPECT_EQ(Status::ResourceExhausted(), writer.WriteV(buffers));
+  EXPECT_EQ(0u, writer.bytes_written());
+
+  ASSERT_EQ(OkStatus(), writer.WriteV(std::span(buffers).first(1)));
+  EXPECT_EQ(2u, writer.bytes_written());
+}
+
+TEST(Stream, WriteV_Empty) {
+  CountingWriter writer;
+  EXPECT_EQ(OkStatus(), writer.WriteV({}));
+  EXPECT_EQ(0u, writer.writes());
+}
+
 TEST(NullStream, DefaultConservativeWriteLimit) {
   NullStream stream;
   EXPECT_EQ(stream.ConservativeWriteLimit(), Stream::kUnlimited);
@@ -215,5 +269,16 @@ TEST(NullStream, DefaultTell) {
   EXPECT_EQ(stream.Tell(), Stream::kUnknownPosition);
 }
 
+TEST(CountingNullStream, CountsBytesWritten) {
+  CountingNullStream stream;
+  EXPECT_EQ(stream.bytes_written(), 0u);
+
+  std::array<std::byte, 5> data = {};
+  EXPECT_EQ(stream.Write(data), OkStatus());
+  EXPECT_EQ(stream.Write(std::span(data).first(2)), OkStatus());
+  EXPECT_EQ(stream.bytes_written(), 7u);
+  EXPECT_EQ(stream.ConservativeWriteLimit(), Stream::kUnlimited);
+}
+
 }  // namespace
 }  // namespace pw::stream
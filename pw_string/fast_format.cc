@@ -0,0 +1,118 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_string/fast_format.h"
+
+#include <array>
+
+#include "pw_string/type_to_string.h"
+
+namespace pw::string::internal {
+namespace {
+
+// Large enough for any 64-bit integer in decimal, including the sign.
+using NumberBuffer = std::array<char, 24>;
+
+size_t Padding(std::string_view text, FormatField field) {
+  return field.width > text.size() ? field.width - text.size() : 0u;
+}
+
+void AppendAligned(StringBuilder& builder,
+                   std::string_view text,
+                   FormatField field) {
+  const size_t padding = Padding(text, field);
+  if (padding != 0u && !field.left_align) {
+    builder.append(padding, ' ');
+  }
+  builder.append(text);
+  if (padding != 0u && field.left_align) {
+    builder.append(padding, ' ');
+  }
+}
+
+// Like AppendAligned, but zero-padding goes between the sign and the digits.
+void AppendNumber(StringBuilder& builder,
+                  std::string_view number,
+                  FormatField field) {
+  if (!field.zero_pad || field.left_align) {
+    AppendAligned(builder, number, field);
+    return;
+  }
+
+  const size_t padding = Padding(number, field);
+  if (!number.empty() && number.front() == '-') {
+    builder.push_back('-');
+    number.remove_prefix(1);
+  }
+  if (padding != 0u) {
+    builder.append(padding, '0');
+  }
+  builder.append(number);
+}
+
+}  // namespace
+
+void AppendSigned(StringBuilder& builder, int64_t value, FormatField field) {
+  NumberBuffer buffer;
+  const StatusWithSize result = IntToString(value, buffer);
+  AppendNumber(builder, std::string_view(buffer.data(), result.size()), field);
+}
+
+void AppendUnsigned(StringBuilder& builder, uint64_t value, FormatField field) {
+  NumberBuffer buffer;
+  StatusWithSize result;
+
+  if (field.conversion == Conversion::kHex ||
+      field.conversion == Conversion::kUpperHex) {
+    result = IntToHexString(value, buffer);
+    if (field.conversion == Conversion::kUpperHex) {
+      for (size_t i = 0; i < result.size(); ++i) {
+        if (buffer[i] >= 'a') {
+          buffer[i] = static_cast<char>(buffer[i] - 'a' + 'A');
+        }
+      }
+    }
+  } else {
+    result = IntToString(value, buffer);
+  }
+
+  AppendNumber(builder, std::string_view(buffer.data(), result.size()), field);
+}
+
+void AppendChar(StringBuilder& builder, char value, FormatField field) {
+  AppendAligned(builder, std::string_view(&value, 1), field);
+}
+
+void AppendString(StringBuilder& builder,
+                  std::string_view value,
+                  FormatField field) {
+  AppendAligned(builder, value, field);
+}
+
+void AppendCString(StringBuilder& builder,
+                   const char* value,
+                   FormatField field) {
+  AppendAligned(
+      builder, value == nullptr ? kNullPointerString : value, field);
+}
+
+void AppendPointer(StringBuilder& builder,
+                   const void* value,
+                   FormatField field) {
+  NumberBuffer buffer;
+  const StatusWithSize result = PointerToString(value, buffer);
+  AppendNumber(builder, std::string_view(buffer.data(), result.size()), field);
+}
+
+}  // namespace pw::string::internal
@@ -0,0 +1,150 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_string/fast_format.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_string/to_string.h"
+
+namespace pw::string {
+namespace {
+
+// Checks that FastFormat matches snprintf for the given format and arguments.
+#define EXPECT_MATCHES_SNPRINTF(format, ...)                             \
+  do {                                                                   \
+    char expected[64];                                                   \
+    std::snprintf(expected, sizeof(expected), format, __VA_ARGS__);      \
+    char actual[64];                                                     \
+    const StatusWithSize result =                                        \
+        FastFormat(actual, PW_FORMAT_STRING(format), __VA_ARGS__);       \
+    EXPECT_EQ(OkStatus(), result.status());                              \
+    EXPECT_EQ(std::string_view(expected), std::string_view(actual));     \
+    EXPECT_EQ(std::string_view(expected).size(), result.size());         \
+  } while (0)
+
+TEST(FastFormat, LiteralOnly) {
+  char buffer[16];
+  const StatusWithSize result =
+      FastFormat(buffer, PW_FORMAT_STRING("100%% literal"));
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(std::string_view("100% literal"), buffer);
+  EXPECT_EQ(12u, result.size());
+
+  EXPECT_EQ(OkStatus(), FastFormat(buffer, PW_FORMAT_STRING("")).status());
+  EXPECT_EQ(std::string_view(""), buffer);
+}
+
+TEST(FastFormat, Integers_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%d", 0);
+  EXPECT_MATCHES_SNPRINTF("%d|%i", -12345, 67890);
+  EXPECT_MATCHES_SNPRINTF("%5d|%-5d|%05d", 42, 42, 42);
+  EXPECT_MATCHES_SNPRINTF("%05d|%-5d|%3d", -42, -42, -12345);
+  EXPECT_MATCHES_SNPRINTF("%u", 4000000000u);
+  EXPECT_MATCHES_SNPRINTF("%lld", static_cast<long long>(INT64_MIN));
+  EXPECT_MATCHES_SNPRINTF("%llu", static_cast<unsigned long long>(UINT64_MAX));
+  EXPECT_MATCHES_SNPRINTF("%hhu|%hd", static_cast<unsigned char>(200),
+                          static_cast<short>(-300));
+  EXPECT_MATCHES_SNPRINTF("%zu", sizeof(int));
+}
+
+TEST(FastFormat, Hex_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%x|%X", 0xbeefu, 0xbeefu);
+  EXPECT_MATCHES_SNPRINTF("%08x|%-8X|%8x", 0xabcu, 0xabcu, 0u);
+  EXPECT_MATCHES_SNPRINTF("%x", -1);
+  EXPECT_MATCHES_SNPRINTF("%llX", 0x0123456789abcdefull);
+}
+
+TEST(FastFormat, CharsAndStrings_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%c%c%c", 'a', 'b', 'c');
+  EXPECT_MATCHES_SNPRINTF("[%3c|%-3c]", 'x', 'y');
+  EXPECT_MATCHES_SNPRINTF("%s, %s!", "Hello", "world");
+  EXPECT_MATCHES_SNPRINTF("[%10s|%-10s|%2s]", "right", "left", "long");
+}
+
+TEST(FastFormat, StringTypes) {
+  char buffer[32];
+  const std::string_view view = "view";
+  const char* null_string = nullptr;
+  EXPECT_EQ(OkStatus(),
+            FastFormat(buffer,
+                       PW_FORMAT_STRING("%s %-6s|%s"),
+                       view.substr(0, 3),
+                       null_string,
+                       nullptr)
+                .status());
+  EXPECT_EQ(std::string_view("vie (null)|(null)"), buffer);
+}
+
+TEST(FastFormat, TypeSafeIntegers) {
+  enum class Color : uint8_t { kRed = 1, kBlue = 200 };
+
+  char buffer[32];
+  // Unlike printf, %d prints unsigned arguments as unsigned values.
+  EXPECT_EQ(OkStatus(),
+            FastFormat(buffer,
+                       PW_FORMAT_STRING("%d %u %x"),
+                       UINT32_MAX,
+                       Color::kBlue,
+                       int8_t{-1})
+                .status());
+  EXPECT_EQ(std::string_view("4294967295 200 ff"), buffer);
+}
+
+TEST(FastFormat, Pointer) {
+  char expected[32];
+  int value = 0;
+  ToString(&value, expected);
+
+  char buffer[32];
+  EXPECT_EQ(OkStatus(),
+            FastFormat(buffer, PW_FORMAT_STRING("%p"), &value).status());
+  EXPECT_EQ(std::string_view(expected), buffer);
+
+  EXPECT_EQ(OkStatus(),
+            FastFormat(buffer, PW_FORMAT_STRING("%p"), nullptr).status());
+  EXPECT_EQ(std::string_view("(null)"), buffer);
+}
+
+TEST(FastFormat, Truncates) {
+  char buffer[8];
+  StatusWithSize result =
+      FastFormat(buffer, PW_FORMAT_STRING("%s=%d"), "number", 12345);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(7u, result.size());
+  EXPECT_EQ(std::string_view("number="), buffer);
+
+  // Numbers are truncated character by character, like snprintf.
+  result = FastFormat(buffer, PW_FORMAT_STRING("%d"), 123456789);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(std::string_view("1234567"), buffer);
+
+  result = FastFormat(std::span(buffer, 0), PW_FORMAT_STRING("%d"), 1);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(0u, result.size());
+}
+
+TEST(FastFormat, StringBuilder) {
+  StringBuffer<32> buffer;
+  buffer << "[";
+  FastFormat(buffer, PW_FORMAT_STRING("%-4s:%3d"), "ab", 7) << "]";
+  EXPECT_EQ(OkStatus(), buffer.status());
+  EXPECT_EQ(std::string_view("[ab  :  7]"), buffer.view());
+}
+
+}  // namespace
+}  // namespace pw::string
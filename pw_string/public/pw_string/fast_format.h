@@ -0,0 +1,390 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// FastFormat formats printf-style strings without calling vsnprintf. The
+// format string is parsed at compile time and the arguments are checked
+// against it, so mismatched or missing arguments are compilation errors.
+// Arguments are written with the type_to_string functions, which avoids
+// linking in printf and is considerably faster than vsnprintf.
+//
+// The format string must be wrapped in PW_FORMAT_STRING:
+//
+//   pw::StringBuffer<64> buffer;
+//   pw::string::FastFormat(
+//       buffer, PW_FORMAT_STRING("%-10s:%4d |"), file_name, line_number);
+//
+// The following subset of printf is supported:
+//
+//   - Conversions: %d, %i, %u, %x, %X, %c, %s, %p, and %%.
+//   - Flags: '-' (left-align) and '0' (zero-pad numbers).
+//   - A fixed field width, up to 255.
+//   - Length modifiers (hh, h, l, ll, j, z, t) are accepted and ignored.
+//
+// Precision, '*' widths, the ' ', '+', and '#' flags, and floating point
+// conversions are not supported and fail to compile.
+//
+// Since argument types are known, integers are never reinterpreted: %d, %i,
+// and %u print the argument's value, and %x and %X print it as an unsigned
+// number of the argument's width. %s accepts any type convertible to
+// std::string_view, as well as const char*; null strings print as "(null)".
+// %p prints pointers the same way StringBuilder does.
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "pw_status/status_with_size.h"
+#include "pw_string/string_builder.h"
+
+// Wraps a string literal for use with pw::string::FastFormat. Evaluates to an
+// empty object whose type carries the format string.
+#define PW_FORMAT_STRING(format)                           \
+  ([] {                                                    \
+    struct PwFormatString {                                \
+      static constexpr std::string_view value() {          \
+        return format;                                     \
+      }                                                    \
+    };                                                     \
+    return PwFormatString{};                               \
+  }())
+
+namespace pw::string {
+namespace internal {
+
+enum class Conversion : uint8_t {
+  kLiteral,
+  kSigned,
+  kUnsigned,
+  kHex,
+  kUpperHex,
+  kChar,
+  kString,
+  kPointer,
+  kInvalid,
+};
+
+// One piece of a parsed format string: either literal text or a conversion.
+struct FormatField {
+  Conversion conversion = Conversion::kLiteral;
+  bool left_align = false;
+  bool zero_pad = false;
+  uint8_t width = 0;
+
+  // The literal text, as an offset and size in the format string.
+  uint16_t offset = 0;
+  uint16_t size = 0;
+};
+
+constexpr bool IsDigit(char ch) { return '0' <= ch && ch <= '9'; }
+
+constexpr Conversion ParseConversion(char ch) {
+  switch (ch) {
+    case 'd':
+    case 'i':
+      return Conversion::kSigned;
+    case 'u':
+      return Conversion::kUnsigned;
+    case 'x':
+      return Conversion::kHex;
+    case 'X':
+      return Conversion::kUpperHex;
+    case 'c':
+      return Conversion::kChar;
+    case 's':
+      return Conversion::kString;
+    case 'p':
+      return Conversion::kPointer;
+    default:
+      return Conversion::kInvalid;
+  }
+}
+
+// Parses the format string. Returns the number of fields and, if fields is not
+// null, writes them to it. Unsupported conversions are kInvalid fields.
+constexpr size_t ParseFormat(std::string_view format, FormatField* fields) {
+  size_t count = 0;
+  size_t i = 0;
+
+  const auto add = [&](const FormatField& field) {
+    if (fields != nullptr) {
+      fields[count] = field;
+    }
+    count += 1;
+  };
+
+  while (i < format.size()) {
+    if (format[i] != '%') {
+      const size_t start = i;
+      while (i < format.size() && format[i] != '%') {
+        i += 1;
+      }
+      FormatField literal;
+      literal.offset = static_cast<uint16_t>(start);
+      literal.size = static_cast<uint16_t>(i - start);
+      add(literal);
+      continue;
+    }
+
+    i += 1;  // Skip the '%'.
+
+    if (i < format.size() && format[i] == '%') {
+      FormatField percent;
+      percent.offset = static_cast<uint16_t>(i);
+      percent.size = 1;
+      add(percent);
+      i += 1;
+      continue;
+    }
+
+    FormatField field;
+    for (; i < format.size(); ++i) {
+      if (format[i] == '-') {
+        field.left_align = true;
+      } else if (format[i] == '0') {
+        field.zero_pad = true;
+      } else {
+        break;
+      }
+    }
+
+    unsigned width = 0;
+    for (; i < format.size() && IsDigit(format[i]); ++i) {
+      width = width * 10 + static_cast<unsigned>(format[i] - '0');
+      if (width > 255u) {
+        field.conversion = Conversion::kInvalid;
+      }
+    }
+    field.width = static_cast<uint8_t>(width);
+
+    // Skip length modifiers; argument sizes come from the argument types.
+    constexpr std::string_view kLengthModifiers = "hljzt";
+    while (i < format.size() &&
+           kLengthModifiers.find(format[i]) != std::string_view::npos) {
+      i += 1;
+    }
+
+    if (i == format.size()) {
+      field.conversion = Conversion::kInvalid;
+    } else if (field.conversion != Conversion::kInvalid) {
+      field.conversion = ParseConversion(format[i]);
+      i += 1;
+    }
+    add(field);
+  }
+
+  return count;
+}
+
+template <size_t kCount>
+constexpr std::array<FormatField, kCount> ParseFields(std::string_view format) {
+  std::array<FormatField, kCount> fields{};
+  ParseFormat(format, fields.data());
+  return fields;
+}
+
+// The compile-time representation of a PW_FORMAT_STRING.
+template <typename FormatString>
+struct ParsedFormat {
+  static constexpr std::string_view kString = FormatString::value();
+  static constexpr size_t kFieldCount = ParseFormat(kString, nullptr);
+  static constexpr std::array<FormatField, kFieldCount> kFields =
+      ParseFields<kFieldCount>(kString);
+
+  static constexpr bool IsValid() {
+    for (const FormatField& field : kFields) {
+      if (field.conversion == Conversion::kInvalid) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static constexpr size_t ArgCount() { return ArgIndex(kFieldCount); }
+
+  // Returns the index of the argument consumed by the field.
+  static constexpr size_t ArgIndex(size_t field_index) {
+    size_t args = 0;
+    for (size_t i = 0; i < field_index; ++i) {
+      if (kFields[i].conversion != Conversion::kLiteral) {
+        args += 1;
+      }
+    }
+    return args;
+  }
+
+  static constexpr Conversion ArgConversion(size_t arg_index) {
+    for (const FormatField& field : kFields) {
+      if (field.conversion != Conversion::kLiteral) {
+        if (arg_index == 0u) {
+          return field.conversion;
+        }
+        arg_index -= 1;
+      }
+    }
+    return Conversion::kInvalid;
+  }
+};
+
+template <typename T>
+constexpr bool ArgMatches(Conversion conversion) {
+  using Arg = std::decay_t<T>;
+  switch (conversion) {
+    case Conversion::kSigned:
+    case Conversion::kUnsigned:
+    case Conversion::kHex:
+    case Conversion::kUpperHex:
+    case Conversion::kChar:
+      return std::is_integral_v<Arg> || std::is_enum_v<Arg>;
+    case Conversion::kString:
+      return std::is_convertible_v<const T&, std::string_view> ||
+             std::is_same_v<Arg, std::nullptr_t>;
+    case Conversion::kPointer:
+      return std::is_pointer_v<Arg> || std::is_same_v<Arg, std::nullptr_t>;
+    case Conversion::kLiteral:
+    case Conversion::kInvalid:
+      break;
+  }
+  return false;
+}
+
+template <typename Parsed, typename... Args, size_t... kArgs>
+constexpr bool ArgsMatch(std::index_sequence<kArgs...>) {
+  return (ArgMatches<Args>(Parsed::ArgConversion(kArgs)) && ...);
+}
+
+// Non-template functions that do the actual formatting, to keep code size
+// down. Each appends one argument with the field's width and flags applied.
+void AppendSigned(StringBuilder& builder, int64_t value, FormatField field);
+void AppendUnsigned(StringBuilder& builder, uint64_t value, FormatField field);
+void AppendChar(StringBuilder& builder, char value, FormatField field);
+void AppendString(StringBuilder& builder,
+                  std::string_view value,
+                  FormatField field);
+void AppendCString(StringBuilder& builder,
+                   const char* value,
+                   FormatField field);
+void AppendPointer(StringBuilder& builder,
+                   const void* value,
+                   FormatField field);
+
+template <typename T>
+void AppendArg(StringBuilder& builder, const T& arg, FormatField field) {
+  using Arg = std::decay_t<T>;
+
+  if constexpr (std::is_enum_v<Arg>) {
+    AppendArg(builder, static_cast<std::underlying_type_t<Arg>>(arg), field);
+  } else if constexpr (std::is_integral_v<Arg>) {
+    switch (field.conversion) {
+      case Conversion::kChar:
+        AppendChar(builder, static_cast<char>(arg), field);
+        break;
+      case Conversion::kHex:
+      case Conversion::kUpperHex:
+        AppendUnsigned(builder,
+                       static_cast<std::make_unsigned_t<Arg>>(arg),
+                       field);
+        break;
+      default:
+        if constexpr (std::is_signed_v<Arg>) {
+          AppendSigned(builder, arg, field);
+        } else {
+          AppendUnsigned(builder, arg, field);
+        }
+        break;
+    }
+  } else if constexpr (std::is_same_v<Arg, std::nullptr_t>) {
+    AppendCString(builder, nullptr, field);
+  } else if constexpr (std::is_convertible_v<Arg, const char*>) {
+    if (field.conversion == Conversion::kPointer) {
+      AppendPointer(builder, arg, field);
+    } else {
+      AppendCString(builder, arg, field);
+    }
+  } else if constexpr (std::is_pointer_v<Arg>) {
+    AppendPointer(builder, arg, field);
+  } else {
+    AppendString(builder, arg, field);
+  }
+}
+
+template <typename Parsed, size_t kField, typename ArgTuple>
+void AppendField(StringBuilder& builder, const ArgTuple& args) {
+  constexpr FormatField field = Parsed::kFields[kField];
+
+  if constexpr (field.conversion == Conversion::kLiteral) {
+    builder.append(Parsed::kString.data() + field.offset, field.size);
+  } else {
+    AppendArg(builder, std::get<Parsed::ArgIndex(kField)>(args), field);
+  }
+}
+
+template <typename Parsed, typename ArgTuple, size_t... kFields>
+void AppendFields(StringBuilder& builder,
+                  const ArgTuple& args,
+                  std::index_sequence<kFields...>) {
+  (AppendField<Parsed, kFields>(builder, args), ...);
+}
+
+}  // namespace internal
+
+// Appends a formatted string to a StringBuilder. If the formatted string does
+// not fit, the results are truncated and the status is set to
+// RESOURCE_EXHAUSTED.
+template <typename FormatString, typename... Args>
+StringBuilder& FastFormat(StringBuilder& builder,
+                          FormatString,
+                          const Args&... args) {
+  using Parsed = internal::ParsedFormat<FormatString>;
+
+  static_assert(Parsed::IsValid(),
+                "The format string contains an unsupported conversion");
+  static_assert(Parsed::ArgCount() == sizeof...(Args),
+                "The number of arguments does not match the format string");
+
+  if constexpr (Parsed::IsValid() && Parsed::ArgCount() == sizeof...(Args)) {
+    static_assert(
+        internal::ArgsMatch<Parsed, Args...>(
+            std::index_sequence_for<Args...>()),
+        "An argument's type does not match its conversion specifier");
+
+    internal::AppendFields<Parsed>(
+        builder,
+        std::forward_as_tuple(args...),
+        std::make_index_sequence<Parsed::kFieldCount>());
+  }
+  return builder;
+}
+
+// Writes a formatted string to a buffer, like pw::string::Format. The output is
+// always null-terminated, unless the buffer is empty. Returns the number of
+// characters written, excluding the null terminator, and
+//
+//   OK if the formatted string fit in the buffer
+//   RESOURCE_EXHAUSTED if the formatted string was truncated
+//
+template <typename FormatString, typename... Args>
+StatusWithSize FastFormat(std::span<char> buffer,
+                          FormatString format,
+                          const Args&... args) {
+  StringBuilder builder(buffer);
+  FastFormat(builder, format, args...);
+  return builder.status_with_size();
+}
+
+}  // namespace pw::string
@@ -0,0 +1,106 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+#include "pw_string/string_builder.h"
+
+namespace pw {
+
+// StreamingStringBuilder is a StringBuilder that writes its string to a
+// stream::Writer as it is built, so that long text such as a metric dump or a
+// hex dump is produced in constant memory. Whenever an append does not fit in
+// the buffer, the buffered string is written to the writer and the append
+// continues in the emptied buffer. All StringBuilder operations, including
+// operator<< overloads for custom types and Format, work as they do with a
+// StringBuilder.
+//
+// Strings of any length are streamed through the buffer. A single value that
+// is converted with ToString or a single Format call must fit in the buffer by
+// itself, or it is truncated and the status is set to RESOURCE_EXHAUSTED, as
+// with a StringBuilder.
+//
+// The buffer holds the string appended since the last flush, which view(),
+// resize(), and pop_back() operate on. Call Flush() to write out the rest when
+// done; the destructor also does so.
+//
+// If the writer fails, the status is set to its error and the builder stops
+// flushing; later appends are truncated, as in a StringBuilder. Flush()
+// returns the writer's error from then on.
+//
+//   std::array<char, 64> buffer;
+//   StreamingStringBuilder sb(writer, buffer);
+//   for (const Entry& entry : entries) {
+//     sb << entry.name << ": " << entry.value << '\n';
+//   }
+//   PW_TRY(sb.Flush());
+//
+class StreamingStringBuilder : public StringBuilder {
+ public:
+  StreamingStringBuilder(stream::Writer& writer, std::span<char> buffer)
+      : StringBuilder(buffer, WriteBuffered),
+        writer_(writer),
+        writer_status_(OkStatus()),
+        bytes_written_(0) {}
+
+  StreamingStringBuilder(const StreamingStringBuilder&) = delete;
+  StreamingStringBuilder& operator=(const StreamingStringBuilder&) = delete;
+
+  ~StreamingStringBuilder() { Flush().IgnoreError(); }
+
+  // Writes the buffered string to the writer and clears the buffer. Returns:
+  //
+  //   OK - the buffered string, if any, was written
+  //   any error returned by the writer, now or in an earlier flush
+  //
+  Status Flush() {
+    if (!writer_status_.ok()) {
+      return writer_status_;
+    }
+    return FlushBuffer();
+  }
+
+  // Characters written to the writer so far.
+  size_t bytes_written() const { return bytes_written_; }
+
+ private:
+  static Status WriteBuffered(StringBuilder& builder);
+
+  stream::Writer& writer_;
+  Status writer_status_;
+  size_t bytes_written_;
+};
+
+// StreamingStringBuffer declares a buffer along with a StreamingStringBuilder.
+//
+//   StreamingStringBuffer<64> sb(writer);
+//   sb << "Threads: " << thread_count;
+//
+template <size_t kSizeBytes>
+class StreamingStringBuffer : public StreamingStringBuilder {
+ public:
+  explicit StreamingStringBuffer(stream::Writer& writer)
+      : StreamingStringBuilder(writer, buffer_) {}
+
+ private:
+  static_assert(kSizeBytes >= 2u,
+                "StreamingStringBuffers must hold at least 1 character");
+  char buffer_[kSizeBytes];
+};
+
+}  // namespace pw
@@ -73,7 +73,8 @@ namespace pw {
 class StringBuilder {
  public:
   // Creates an empty StringBuilder.
-  constexpr StringBuilder(std::span<char> buffer) : buffer_(buffer), size_(0) {
+  constexpr StringBuilder(std::span<char> buffer)
+      : buffer_(buffer), size_(0), flush_(nullptr) {
     NullTerminate();
   }
   StringBuilder(std::span<std::byte> buffer)
@@ -191,7 +192,11 @@ class StringBuilder {
     if constexpr (std::is_convertible_v<T, std::string_view>) {
       append(value);
     } else {
-      HandleStatusWithSize(ToString(value, buffer_.subspan(size_)));
+      StatusWithSize result = ToString(value, buffer_.subspan(size_));
+      if (result.IsResourceExhausted() && FlushForRetry()) {
+        result = ToString(value, buffer_.subspan(size_));
+      }
+      HandleStatusWithSize(result);
     }
     return *this;
   }
@@ -236,11 +241,40 @@ class StringBuilder {
       : buffer_(buffer),
         size_(other.size_),
         status_(other.status_),
-        last_status_(other.last_status_) {}
+        last_status_(other.last_status_),
+        flush_(nullptr) {}
 
   void CopySizeAndStatus(const StringBuilder& other);
 
+  // Functions to support StreamingStringBuilder. The flush function writes out
+  // the buffered string. It is called when an append does not fit, after which
+  // the append continues in the emptied buffer.
+  using FlushFunction = Status (*)(StringBuilder&);
+
+  constexpr StringBuilder(std::span<char> buffer, FlushFunction flush)
+      : buffer_(buffer), size_(0), flush_(flush) {
+    NullTerminate();
+  }
+
+  // Writes out and clears the buffered string. If the flush function fails,
+  // the status is set to its error and flushing is disabled, so later appends
+  // are truncated as in any StringBuilder.
+  Status FlushBuffer();
+
  private:
+  // Flushes a streaming StringBuilder's buffer so that an append that did not
+  // fit may be retried. Returns false if the append cannot fit any better.
+  bool FlushForRetry() {
+    return flush_ != nullptr && size_ != 0u && FlushBuffer().ok();
+  }
+
+  // True if appends that do not fit flush the buffer. The buffer must hold at
+  // least one character for a flush to make room.
+  bool streaming() const { return flush_ != nullptr && max_size() != 0u; }
+
+  // Fills the rest of the buffer from str and flushes it.
+  bool FillAndFlush(const char* str);
+
   size_t ResizeAndTerminate(size_t chars_to_append);
 
   void HandleStatusWithSize(StatusWithSize written);
@@ -258,6 +292,7 @@ class StringBuilder {
   size_t size_;
   Status status_;
   Status last_status_;
+  FlushFunction flush_;
 };
 
 // StringBuffers declare a buffer along with a StringBuilder. StringBuffer can
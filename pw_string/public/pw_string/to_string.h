@@ -52,6 +52,7 @@
 // StringBuilder may be easier to work with. StringBuilder's operator<< may be
 // overloaded for custom types.
 
+#include <cstddef>
 #include <span>
 #include <string_view>
 #include <type_traits>
@@ -100,4 +101,39 @@ inline StatusWithSize ToString(std::byte byte, std::span<char> buffer) {
   return string::IntToHexString(static_cast<unsigned>(byte), buffer);
 }
 
+// Writes each value in a span with ToString, separated by the separator. For
+// example, a span of {1, 2, 3} is written as "1, 2, 3". This is useful for
+// printing arrays of values, such as sensor readings, with a single call.
+//
+// Semantics match ToString. If the output is truncated, the status is
+// RESOURCE_EXHAUSTED and the size includes the values and separators that were
+// written.
+template <typename T, size_t kExtent>
+StatusWithSize ToString(std::span<T, kExtent> values,
+                        std::span<char> buffer,
+                        std::string_view separator = ", ") {
+  if (values.empty()) {
+    return string::Copy(std::string_view(), buffer);
+  }
+
+  size_t size = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i != 0u) {
+      const StatusWithSize result =
+          string::Copy(separator, buffer.subspan(size));
+      size += result.size();
+      if (!result.ok()) {
+        return StatusWithSize(result.status(), size);
+      }
+    }
+
+    const StatusWithSize result = ToString(values[i], buffer.subspan(size));
+    size += result.size();
+    if (!result.ok()) {
+      return StatusWithSize(result.status(), size);
+    }
+  }
+  return StatusWithSize(size);
+}
+
 }  // namespace pw
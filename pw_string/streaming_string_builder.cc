@@ -0,0 +1,29 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_string/streaming_string_builder.h"
+
+namespace pw {
+
+Status StreamingStringBuilder::WriteBuffered(StringBuilder& builder) {
+  StreamingStringBuilder& sb = static_cast<StreamingStringBuilder&>(builder);
+
+  sb.writer_status_ = sb.writer_.Write(sb.as_bytes());
+  if (sb.writer_status_.ok()) {
+    sb.bytes_written_ += sb.size();
+  }
+  return sb.writer_status_;
+}
+
+}  // namespace pw
@@ -0,0 +1,174 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_string/streaming_string_builder.h"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_string/string_builder.h"
+
+namespace this_pw_test {
+
+struct Point {
+  int x;
+  int y;
+};
+
+pw::StringBuilder& operator<<(pw::StringBuilder& sb, const Point& point) {
+  return sb << '(' << point.x << ", " << point.y << ')';
+}
+
+}  // namespace this_pw_test
+
+namespace pw {
+namespace {
+
+using namespace std::literals::string_view_literals;
+using this_pw_test::Point;
+
+constexpr std::string_view kLongString =
+    "This string is much longer than the buffer of the StreamingStringBuilder, "
+    "so it is written out in several pieces."sv;
+
+std::string_view Written(const stream::MemoryWriter& writer) {
+  return std::string_view(
+      reinterpret_cast<const char*>(writer.WrittenData().data()),
+      writer.bytes_written());
+}
+
+// Writes each piece of output separately and fails after a number of writes.
+class FailingWriter : public stream::NonSeekableWriter {
+ public:
+  explicit FailingWriter(size_t successful_writes)
+      : successful_writes_(successful_writes), writes_(0) {}
+
+  size_t writes() const { return writes_; }
+
+ private:
+  Status DoWrite(ConstByteSpan) override {
+    writes_ += 1;
+    return writes_ <= successful_writes_ ? OkStatus() : Status::DataLoss();
+  }
+
+  const size_t successful_writes_;
+  size_t writes_;
+};
+
+TEST(StreamingStringBuilder, LongString_IsStreamed) {
+  stream::MemoryWriterBuffer<256> writer;
+  std::array<char, 8> buffer;
+  StreamingStringBuilder sb(writer, buffer);
+
+  sb << kLongString;
+  EXPECT_EQ(OkStatus(), sb.status());
+  EXPECT_LE(sb.size(), sb.max_size());
+
+  ASSERT_EQ(OkStatus(), sb.Flush());
+  EXPECT_EQ(kLongString, Written(writer));
+  EXPECT_EQ(kLongString.size(), sb.bytes_written());
+  EXPECT_TRUE(sb.empty());
+}
+
+TEST(StreamingStringBuilder, LongCString_IsStreamed) {
+  stream::MemoryWriterBuffer<256> writer;
+  std::array<char, 8> buffer;
+  StreamingStringBuilder sb(writer, buffer);
+
+  sb.append(kLongString.data());
+  EXPECT_EQ(OkStatus(), sb.status());
+  ASSERT_EQ(OkStatus(), sb.Flush());
+  EXPECT_EQ(kLongString, Written(writer));
+}
+
+TEST(StreamingStringBuilder, RepeatedCharacter_IsStreamed) {
+  stream::MemoryWriterBuffer<256> writer;
+  std::array<char, 8> buffer;
+  StreamingStringBuilder sb(writer, buffer);
+
+  sb.append(20, '=');
+  EXPECT_EQ(OkStatus(), sb.status());
+  ASSERT_EQ(OkStatus(), sb.Flush());
+  EXPECT_EQ("===================="sv, Written(writer));
+}
+
+TEST(StreamingStringBuilder, MatchesStringBuilder) {
+  stream::MemoryWriterBuffer<256> writer;
+  StreamingStringBuffer<16> sb(writer);
+  StringBuffer<256> expected;
+
+  for (int i = 0; i < 8; ++i) {
+    sb << "point " << i << ": " << Point{i, -i * 1000} << ' ' << (i % 2 == 0);
+    sb.Format(" [%03d]\n", i);
+    expected << "point " << i << ": " << Point{i, -i * 1000} << ' '
+             << (i % 2 == 0);
+    expected.Format(" [%03d]\n", i);
+  }
+  EXPECT_EQ(OkStatus(), sb.status());
+  ASSERT_EQ(OkStatus(), expected.status());
+
+  ASSERT_EQ(OkStatus(), sb.Flush());
+  EXPECT_EQ(expected.view(), Written(writer));
+}
+
+TEST(StreamingStringBuilder, FormatLargerThanBuffer_IsTruncated) {
+  stream::MemoryWriterBuffer<256> writer;
+  StreamingStringBuffer<8> sb(writer);
+
+  sb << "ab";
+  sb.Format("%s", "0123456789");
+  EXPECT_EQ(Status::ResourceExhausted(), sb.status());
+
+  ASSERT_EQ(OkStatus(), sb.Flush());
+  EXPECT_EQ("ab0123456"sv, Written(writer));
+}
+
+TEST(StreamingStringBuilder, Destructor_Flushes) {
+  stream::MemoryWriterBuffer<256> writer;
+  {
+    StreamingStringBuffer<8> sb(writer);
+    sb << "Hello, " << 42;
+  }
+  EXPECT_EQ("Hello, 42"sv, Written(writer));
+}
+
+TEST(StreamingStringBuilder, Flush_NothingBuffered_WritesNothing) {
+  FailingWriter writer(0);
+  StreamingStringBuffer<8> sb(writer);
+
+  EXPECT_EQ(OkStatus(), sb.Flush());
+  EXPECT_EQ(0u, writer.writes());
+}
+
+TEST(StreamingStringBuilder, WriterFails_StopsFlushing) {
+  FailingWriter writer(1);
+  StreamingStringBuffer<8> sb(writer);
+
+  sb << kLongString;
+  EXPECT_FALSE(sb.ok());
+  EXPECT_EQ(2u, writer.writes());
+  EXPECT_EQ(sb.max_size(), sb.bytes_written());
+
+  // The rest of the output is truncated to the buffer, as in a StringBuilder.
+  sb << kLongString;
+  EXPECT_EQ(Status::ResourceExhausted(), sb.status());
+  EXPECT_EQ(Status::DataLoss(), sb.Flush());
+  EXPECT_EQ(2u, writer.writes());
+}
+
+}  // namespace
+}  // namespace pw
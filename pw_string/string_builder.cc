@@ -29,12 +29,32 @@ void StringBuilder::clear() {
 }
 
 StringBuilder& StringBuilder::append(size_t count, char ch) {
+  // A streaming StringBuilder fills and flushes its buffer until the rest fits.
+  while (streaming() && count > max_size() - size_) {
+    const size_t to_fill = max_size() - size_;
+    std::memset(&buffer_[size_], ch, to_fill);
+    size_ += to_fill;
+    if (!FlushBuffer().ok()) {
+      break;
+    }
+    count -= to_fill;
+  }
+
   char* const append_destination = &buffer_[size_];
   std::memset(append_destination, ch, ResizeAndTerminate(count));
   return *this;
 }
 
 StringBuilder& StringBuilder::append(const char* str, size_t count) {
+  while (streaming() && count > max_size() - size_) {
+    const size_t to_fill = max_size() - size_;
+    if (!FillAndFlush(str)) {
+      break;
+    }
+    str += to_fill;
+    count -= to_fill;
+  }
+
   char* const append_destination = &buffer_[size_];
   std::memcpy(append_destination, str, ResizeAndTerminate(count));
   return *this;
@@ -44,7 +64,19 @@ StringBuilder& StringBuilder::append(const char* str) {
   // Use buffer_.size() - size() as the maximum length so that strings too long
   // to fit in the buffer will request one character too many, which sets the
   // status to RESOURCE_EXHAUSTED.
-  return append(string::ClampedCString(str, buffer_.size() - size()));
+  std::string_view chunk = string::ClampedCString(str, buffer_.size() - size());
+
+  // A streaming StringBuilder reads the string one buffer at a time.
+  while (streaming() && chunk.size() > max_size() - size_) {
+    const size_t to_fill = max_size() - size_;
+    if (!FillAndFlush(str)) {
+      break;
+    }
+    str += to_fill;
+    chunk = string::ClampedCString(str, buffer_.size() - size());
+  }
+
+  return append(chunk);
 }
 
 StringBuilder& StringBuilder::append(const std::string_view& str) {
@@ -95,8 +127,19 @@ StringBuilder& StringBuilder::Format(const char* format, ...) {
 }
 
 StringBuilder& StringBuilder::FormatVaList(const char* format, va_list args) {
-  HandleStatusWithSize(
-      string::FormatVaList(buffer_.subspan(size_), format, args));
+  // Keep a copy of the arguments in case the output must be retried after a
+  // flush.
+  va_list retry_args;
+  va_copy(retry_args, args);
+
+  StatusWithSize result =
+      string::FormatVaList(buffer_.subspan(size_), format, args);
+  if (result.IsResourceExhausted() && FlushForRetry()) {
+    result = string::FormatVaList(buffer_.subspan(size_), format, retry_args);
+  }
+  va_end(retry_args);
+
+  HandleStatusWithSize(result);
   return *this;
 }
 
@@ -106,6 +149,33 @@ void StringBuilder::CopySizeAndStatus(const StringBuilder& other) {
   last_status_ = other.last_status_;
 }
 
+Status StringBuilder::FlushBuffer() {
+  if (flush_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  if (size_ == 0u) {
+    return OkStatus();
+  }
+
+  const Status status = flush_(*this);
+  if (!status.ok()) {
+    flush_ = nullptr;
+    SetErrorStatus(status);
+    return status;
+  }
+
+  size_ = 0;
+  NullTerminate();
+  return OkStatus();
+}
+
+bool StringBuilder::FillAndFlush(const char* str) {
+  const size_t to_fill = max_size() - size_;
+  std::memcpy(&buffer_[size_], str, to_fill);
+  size_ += to_fill;
+  return FlushBuffer().ok();
+}
+
 void StringBuilder::HandleStatusWithSize(StatusWithSize written) {
   const Status status = written.status();
   last_status_ = status;
@@ -22,6 +22,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_status/status.h"
+#include "pw_string/string_builder.h"
 #include "pw_string/type_to_string.h"
 
 namespace pw {
@@ -264,5 +265,39 @@ TEST(ToString, StdString) {
   EXPECT_STREQ("", buffer);
 }
 
+TEST(ToString, Span_Integers) {
+  constexpr std::array<int, 4> kValues = {1, -22, 333, 0};
+  auto result = ToString(std::span(kValues), buffer);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(14u, result.size());
+  EXPECT_STREQ("1, -22, 333, 0", buffer);
+
+  EXPECT_EQ(OkStatus(), ToString(std::span(kValues), buffer, ";").status());
+  EXPECT_STREQ("1;-22;333;0", buffer);
+}
+
+TEST(ToString, Span_Empty) {
+  auto result = ToString(std::span<const int>(), buffer);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.size());
+  EXPECT_STREQ("", buffer);
+}
+
+TEST(ToString, Span_TooSmall_Truncates) {
+  constexpr std::array<unsigned, 3> kValues = {12, 34, 56};
+  auto result = ToString(std::span(kValues), std::span(buffer, 8));
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(7u, result.size());
+  EXPECT_STREQ("12, 34,", buffer);
+}
+
+TEST(ToString, Span_StringBuilder) {
+  constexpr std::array<uint16_t, 3> kReadings = {100, 200, 300};
+  StringBuffer<32> sb;
+  sb << "[" << std::span(kReadings) << "]";
+  EXPECT_EQ(OkStatus(), sb.status());
+  EXPECT_STREQ("[100, 200, 300]", sb.c_str());
+}
+
 }  // namespace
 }  // namespace pw
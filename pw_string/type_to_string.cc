@@ -14,6 +14,7 @@
 
 #include "pw_string/type_to_string.h"
 
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstring>
@@ -47,6 +48,25 @@ constexpr std::array<uint64_t, 20> kPowersOf10{
     10000000000000000000ull,  // 10^19
 };
 
+// The two-digit decimal strings "00" through "99", concatenated. Converting
+// two digits at a time halves the number of divisions.
+constexpr std::array<char, 200> kDigitPairs = [] {
+  std::array<char, 200> pairs{};
+  for (size_t i = 0; i < 100u; ++i) {
+    pairs[2 * i] = static_cast<char>('0' + i / 10);
+    pairs[2 * i + 1] = static_cast<char>('0' + i % 10);
+  }
+  return pairs;
+}();
+
+// Writes the two digits of a value less than 100 before end. Returns the new
+// end.
+char* WriteDigitPair(char* end, uint32_t value) {
+  end -= 2;
+  std::memcpy(end, &kDigitPairs[2 * value], 2);
+  return end;
+}
+
 StatusWithSize HandleExhaustedBuffer(std::span<char> buffer) {
   if (!buffer.empty()) {
     buffer[0] = '\0';
@@ -73,7 +93,6 @@ uint_fast8_t DecimalDigitCount(uint64_t integer) {
 // think std::to_chars will be faster, so I kept this implementation for now.
 template <>
 StatusWithSize IntToString(uint64_t value, std::span<char> buffer) {
-  constexpr uint32_t base = 10;
   constexpr uint32_t max_uint32_base_power = 1'000'000'000;
   constexpr uint_fast8_t max_uint32_base_power_exponent = 9;
 
@@ -84,28 +103,31 @@ StatusWithSize IntToString(uint64_t value, std::span<char> buffer) {
   }
 
   buffer[total_digits] = '\0';
-
-  uint_fast8_t remaining = total_digits;
-  while (remaining > 0u) {
-    uint32_t lower_digits;     // the value of the lower digits to write
-    uint_fast8_t digit_count;  // the number of lower digits to write
-
-    // 64-bit division is slow on 32-bit platforms, so print large numbers in
-    // 32-bit chunks to minimize the number of 64-bit divisions.
-    if (value <= std::numeric_limits<uint32_t>::max()) {
-      lower_digits = value;
-      digit_count = remaining;
-    } else {
-      lower_digits = value % max_uint32_base_power;
-      digit_count = max_uint32_base_power_exponent;
-      value /= max_uint32_base_power;
+  char* end = buffer.data() + total_digits;
+
+  // 64-bit division is slow on 32-bit platforms, so print large numbers in
+  // 32-bit chunks to minimize the number of 64-bit divisions.
+  while (value > std::numeric_limits<uint32_t>::max()) {
+    uint32_t chunk = value % max_uint32_base_power;
+    value /= max_uint32_base_power;
+
+    // Write all 9 digits of the chunk, with leading 0s.
+    for (uint_fast8_t i = 0; i < max_uint32_base_power_exponent / 2; ++i) {
+      end = WriteDigitPair(end, chunk % 100);
+      chunk /= 100;
     }
+    *--end = static_cast<char>('0' + chunk);
+  }
 
-    // Write the specified number of digits, with leading 0s.
-    for (uint_fast8_t i = 0; i < digit_count; ++i) {
-      buffer[--remaining] = lower_digits % base + '0';
-      lower_digits /= base;
-    }
+  uint32_t lower_digits = value;
+  while (lower_digits >= 100u) {
+    end = WriteDigitPair(end, lower_digits % 100);
+    lower_digits /= 100;
+  }
+  if (lower_digits >= 10u) {
+    WriteDigitPair(end, lower_digits);
+  } else {
+    *--end = static_cast<char>('0' + lower_digits);
   }
   return StatusWithSize(total_digits);
 }
@@ -135,8 +157,10 @@ StatusWithSize IntToString(int64_t value, std::span<char> buffer) {
   }
 
   // Write as an unsigned number, but leave room for the leading minus sign.
+  // Negate as unsigned so that the minimum int64_t does not overflow.
   auto result = IntToString<uint64_t>(
-      std::abs(value), buffer.empty() ? buffer : buffer.subspan(1));
+      uint64_t{0} - static_cast<uint64_t>(value),
+      buffer.empty() ? buffer : buffer.subspan(1));
 
   if (result.ok()) {
     buffer[0] = '-';
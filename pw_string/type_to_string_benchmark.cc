@@ -0,0 +1,87 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures IntToString for integers of several magnitudes. Run on the host or
+// on a device with a pw_chrono:system_clock backend; results are logged.
+
+#define PW_LOG_MODULE_NAME "STRING"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_log/log.h"
+#include "pw_string/type_to_string.h"
+
+namespace pw::string {
+namespace {
+
+constexpr size_t kValues = 256;
+constexpr size_t kRounds = 2000;
+
+std::array<uint64_t, kValues> values;
+std::array<char, 24> buffer;
+
+// Returns the time in picoseconds to run the function, divided by count.
+template <typename Function>
+int64_t PicosecondsPer(size_t count, Function&& function) {
+  const auto start = chrono::SystemClock::now();
+  function();
+  const auto elapsed = chrono::SystemClock::now() - start;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() *
+         1000 / static_cast<int64_t>(count);
+}
+
+// Fills the values with pseudo-random numbers below the limit.
+void Fill(uint64_t limit) {
+  uint64_t seed = 1;
+  for (uint64_t& value : values) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    value = limit == 0u ? seed : seed % limit;
+  }
+}
+
+template <typename T>
+void Measure(const char* name, uint64_t limit) {
+  Fill(limit);
+  size_t characters = 0;
+  const int64_t ps = PicosecondsPer(kRounds * kValues, [&] {
+    for (size_t round = 0; round < kRounds; ++round) {
+      for (uint64_t value : values) {
+        characters += IntToString(static_cast<T>(value), buffer).size();
+      }
+    }
+  });
+  PW_LOG_INFO("%-20s %3ld.%02ld ns per call (%2u characters)",
+              name,
+              static_cast<long>(ps / 1000),
+              static_cast<long>(ps % 1000 / 10),
+              static_cast<unsigned>(characters / (kRounds * kValues)));
+}
+
+}  // namespace
+}  // namespace pw::string
+
+int main() {
+  using pw::string::Measure;
+  Measure<uint32_t>("uint32_t below 100", 100);
+  Measure<uint32_t>("uint32_t below 10^6", 1'000'000);
+  Measure<uint32_t>("uint32_t", 1ull << 32);
+  Measure<int32_t>("int32_t", 0);
+  Measure<uint64_t>("uint64_t", 0);
+  Measure<int64_t>("int64_t", 0);
+  return 0;
+}
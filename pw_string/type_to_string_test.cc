@@ -266,6 +266,26 @@ TEST(IntToString, UnsignedSweep) {
   }
 }
 
+TEST(IntToString, PowersOf10AndNeighbors) {
+  // Cover every digit count, and values around the 32-bit chunk boundaries.
+  for (uint64_t power = 1; power != 0u; power *= 10u) {
+    for (uint64_t value : {power - 1, power, power + 1, power * 7 + 3}) {
+      char buffer[21];
+      char printf_buffer[21];
+      int written = std::snprintf(printf_buffer,
+                                  sizeof(printf_buffer),
+                                  "%llu",
+                                  static_cast<unsigned long long>(value));
+      auto result = IntToString(value, buffer);
+      ASSERT_EQ(static_cast<size_t>(written), result.size());
+      ASSERT_STREQ(printf_buffer, buffer);
+    }
+    if (power > std::numeric_limits<uint64_t>::max() / 10u) {
+      break;
+    }
+  }
+}
+
 class IntToHexStringTest : public TestWithBuffer {};
 
 TEST_F(IntToHexStringTest, Sweep) {
@@ -15,3 +15,4 @@
 
 from pw_symbolizer.symbolizer import Symbolizer, Symbol
 from pw_symbolizer.llvm_symbolizer import LlvmSymbolizer
+from pw_symbolizer.symbol_cache import CachedSymbolizer
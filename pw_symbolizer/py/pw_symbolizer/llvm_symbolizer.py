@@ -17,13 +17,19 @@ import shutil
 import subprocess
 import threading
 import json
-from typing import Optional, Tuple
+from typing import Iterable, List, Optional, Tuple
 from pathlib import Path
 from pw_symbolizer import symbolizer
 
 
 class LlvmSymbolizer(symbolizer.Symbolizer):
     """A symbolizer that wraps llvm-symbolizer."""
+
+    # Maximum number of addresses written to llvm-symbolizer before reading
+    # their results. The results of a batch must fit in the output pipe's
+    # buffer, or llvm-symbolizer would block writing them while this blocks
+    # writing addresses.
+    _BATCH_SIZE = 128
     def __init__(self, binary: Optional[Path] = None, force_legacy=False):
         # Lets destructor return cleanly if the binary is not found.
         self._symbolizer = None
@@ -132,8 +138,25 @@ class LlvmSymbolizer(symbolizer.Symbolizer):
 
     def symbolize(self, address: int) -> symbolizer.Symbol:
         """Symbolizes an address using the loaded ELF file."""
+        return self.symbolize_all([address])[0]
+
+    def symbolize_all(self,
+                      addresses: Iterable[int]) -> List[symbolizer.Symbol]:
+        """Symbolizes addresses in batches rather than one at a time.
+
+        Writing a batch of addresses before reading any results avoids waiting
+        on a round trip through llvm-symbolizer for every address.
+        """
+        addresses = list(addresses)
         if not self._symbolizer:
-            return symbolizer.Symbol(address=address, name='', file='', line=0)
+            return [
+                symbolizer.Symbol(address=address, name='', file='', line=0)
+                for address in addresses
+            ]
+
+        read_symbol = (LlvmSymbolizer._read_json_symbol if self._json_mode
+                       else LlvmSymbolizer._read_llvm_symbol)
+        symbols: List[symbolizer.Symbol] = []
 
         with self._lock:
             if self._symbolizer.returncode is not None:
@@ -145,10 +168,13 @@ class LlvmSymbolizer(symbolizer.Symbolizer):
             assert stdin is not None
             assert stdout is not None
 
-            stdin.write(f'0x{address:08X}\n'.encode())
-            stdin.flush()
+            for start in range(0, len(addresses), self._BATCH_SIZE):
+                batch = addresses[start:start + self._BATCH_SIZE]
+                stdin.write(''.join(f'0x{address:08X}\n'
+                                    for address in batch).encode())
+                stdin.flush()
 
-            if self._json_mode:
-                return LlvmSymbolizer._read_json_symbol(address, stdout)
+                symbols.extend(read_symbol(address, stdout)
+                               for address in batch)
 
-            return LlvmSymbolizer._read_llvm_symbol(address, stdout)
+        return symbols
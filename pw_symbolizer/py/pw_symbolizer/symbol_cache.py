@@ -0,0 +1,165 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""A symbolizer that remembers symbols across runs, keyed by ELF build."""
+
+import hashlib
+import json
+import logging
+import os
+from pathlib import Path
+import tempfile
+import threading
+from typing import Dict, Iterable, List, Optional
+
+from pw_build_info import build_id
+from pw_symbolizer import symbolizer
+from pw_symbolizer.llvm_symbolizer import LlvmSymbolizer
+
+_LOG = logging.getLogger(__name__)
+
+# Bumped when the format of cache files changes; files with another version
+# are ignored.
+_CACHE_VERSION = 1
+
+
+def elf_cache_key(elf: Path) -> str:
+    """Returns a string that identifies the contents of an ELF file.
+
+    The GNU build ID is used if the ELF has one. Otherwise, the key is the
+    SHA-256 of the file.
+    """
+    with elf.open('rb') as elf_file:
+        try:
+            gnu_build_id = build_id.read_build_id(elf_file)
+        except Exception:  # pylint: disable=broad-except
+            # ELFs with malformed build IDs, or files that are not ELFs at
+            # all, still get a key from their contents.
+            gnu_build_id = None
+
+        if gnu_build_id:
+            return gnu_build_id.hex()
+
+        elf_file.seek(0)
+        digest = hashlib.sha256()
+        for chunk in iter(lambda: elf_file.read(1 << 16), b''):
+            digest.update(chunk)
+        return 'sha256-' + digest.hexdigest()
+
+
+class CachedSymbolizer(symbolizer.Symbolizer):
+    """Wraps a symbolizer and remembers the symbols it produces.
+
+    If a cache file is provided, symbols are loaded from it when the
+    CachedSymbolizer is created and written back by save(). The cache file must
+    only be shared between symbolizers for the same binary.
+    """
+    def __init__(self,
+                 wrapped: symbolizer.Symbolizer,
+                 cache_file: Optional[Path] = None):
+        self._wrapped = wrapped
+        self._cache_file = cache_file
+        self._symbols: Dict[int, symbolizer.Symbol] = {}
+        self._dirty = False
+        self._lock = threading.Lock()
+
+        if cache_file is not None:
+            self._load(cache_file)
+
+    @classmethod
+    def for_elf(cls, elf: Path, cache_dir: Path) -> 'CachedSymbolizer':
+        """Creates an LlvmSymbolizer for an ELF, cached in cache_dir.
+
+        Each build of a binary has its own cache file, so symbols are
+        computed once per build no matter how many snapshots reference it.
+        """
+        return cls(LlvmSymbolizer(elf),
+                   cache_dir / f'{elf_cache_key(elf)}.json')
+
+    def symbolize(self, address: int) -> symbolizer.Symbol:
+        return self.symbolize_all([address])[0]
+
+    def symbolize_all(self,
+                      addresses: Iterable[int]) -> List[symbolizer.Symbol]:
+        """Symbolizes addresses, passing only unknown ones to the wrapped
+        symbolizer in a single batch."""
+        addresses = list(addresses)
+
+        with self._lock:
+            missing = [
+                address for address in dict.fromkeys(addresses)
+                if address not in self._symbols
+            ]
+            if missing:
+                for symbol in self._wrapped.symbolize_all(missing):
+                    self._symbols[symbol.address] = symbol
+                self._dirty = True
+
+            return [self._symbols[address] for address in addresses]
+
+    def save(self) -> None:
+        """Writes the cache file if any symbols were added since it was read.
+
+        The file is replaced atomically, so concurrent readers never see a
+        partial file. Concurrent writers may drop each other's new symbols,
+        which only costs recomputing them later.
+        """
+        if self._cache_file is None:
+            return
+
+        with self._lock:
+            if not self._dirty:
+                return
+
+            contents = {
+                'version': _CACHE_VERSION,
+                'symbols': {
+                    f'{address:x}': [symbol.name, symbol.file, symbol.line]
+                    for address, symbol in self._symbols.items()
+                },
+            }
+            self._dirty = False
+
+        self._cache_file.parent.mkdir(parents=True, exist_ok=True)
+        fd, temp_path = tempfile.mkstemp(dir=self._cache_file.parent,
+                                         prefix=self._cache_file.name,
+                                         suffix='.tmp')
+        try:
+            with os.fdopen(fd, 'w') as temp_file:
+                json.dump(contents, temp_file, separators=(',', ':'))
+            os.replace(temp_path, self._cache_file)
+        except OSError:
+            os.unlink(temp_path)
+            raise
+
+    def _load(self, cache_file: Path) -> None:
+        try:
+            with cache_file.open() as file:
+                contents = json.load(file)
+        except FileNotFoundError:
+            return
+        except (OSError, ValueError) as err:
+            _LOG.warning('Ignoring unreadable symbol cache %s: %s', cache_file,
+                         err)
+            return
+
+        if not isinstance(contents,
+                          dict) or contents.get('version') != _CACHE_VERSION:
+            _LOG.warning('Ignoring symbol cache %s with unknown format',
+                         cache_file)
+            return
+
+        for address_str, (name, file, line) in contents['symbols'].items():
+            address = int(address_str, 16)
+            self._symbols[address] = symbolizer.Symbol(address, name, file,
+                                                       line)
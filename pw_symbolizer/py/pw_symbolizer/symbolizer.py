@@ -14,7 +14,7 @@
 """Utilities for address symbolization."""
 
 import abc
-from typing import List
+from typing import Iterable, List
 from dataclasses import dataclass
 
 
@@ -55,6 +55,14 @@ class Symbolizer(abc.ABC):
     def symbolize(self, address: int) -> Symbol:
         """Symbolizes an address using a loaded binary or symbol database."""
 
+    def symbolize_all(self, addresses: Iterable[int]) -> List[Symbol]:
+        """Symbolizes many addresses, such as all of those in a snapshot.
+
+        Symbolizers that can look up several addresses more efficiently than
+        one at a time override this.
+        """
+        return [self.symbolize(address) for address in addresses]
+
     def dump_stack_trace(self,
                          addresses,
                          most_recent_first: bool = True) -> str:
@@ -70,9 +78,8 @@ class Symbolizer(abc.ABC):
         stack_trace.append(f'Stack Trace (most recent call {order}):')
 
         max_width = len(str(len(addresses)))
-        for i, address in enumerate(addresses):
+        for i, symbol in enumerate(self.symbolize_all(addresses)):
             depth = i + 1
-            symbol = self.symbolize(address)
 
             if symbol.name:
                 sym_desc = f'{symbol.name} (0x{symbol.address:08X})'
@@ -18,7 +18,9 @@ import tempfile
 import unittest
 import json
 from pathlib import Path
+from typing import List
 import pw_symbolizer
+import pw_symbolizer.symbol_cache
 
 _MODULE_PY_DIR = Path(__file__).parent.resolve()
 _CPP_TEST_FILE_NAME = 'symbolizer_test.cc'
@@ -40,6 +42,11 @@ class TestSymbolizer(unittest.TestCase):
                 self.assertEqual(result.file, _CPP_TEST_FILE_NAME)
                 self.assertEqual(result.line, expected_symbol['Line'])
 
+        # Batch symbolization must match symbolizing one address at a time.
+        addresses = [symbol['Address'] for symbol in expected_symbols]
+        self.assertEqual(symbolizer.symbolize_all(addresses),
+                         [symbolizer.symbolize(addr) for addr in addresses])
+
     def test_symbolization(self):
         """Tests that the symbolizer can symbolize addresses properly."""
         with tempfile.TemporaryDirectory() as exe_dir:
@@ -83,6 +90,71 @@ class TestSymbolizer(unittest.TestCase):
             self._test_symbolization_results(expected_symbols, symbolizer)
 
 
+class _CountingSymbolizer(pw_symbolizer.Symbolizer):
+    """Produces a symbol named after each address and records lookups."""
+    def __init__(self):
+        self.looked_up: List[List[int]] = []
+
+    def symbolize(self, address: int) -> pw_symbolizer.Symbol:
+        return self.symbolize_all([address])[0]
+
+    def symbolize_all(self, addresses) -> List[pw_symbolizer.Symbol]:
+        addresses = list(addresses)
+        self.looked_up.append(addresses)
+        return [
+            pw_symbolizer.Symbol(address, f'fn_{address:x}', 'file.cc', 7)
+            for address in addresses
+        ]
+
+
+class TestCachedSymbolizer(unittest.TestCase):
+    """Tests the CachedSymbolizer."""
+    def setUp(self):
+        self._dir = tempfile.TemporaryDirectory()
+        self._cache_file = Path(self._dir.name) / 'cache.json'
+        self._wrapped = _CountingSymbolizer()
+
+    def tearDown(self):
+        self._dir.cleanup()
+
+    def test_only_unknown_addresses_are_looked_up(self):
+        cached = pw_symbolizer.CachedSymbolizer(self._wrapped)
+        symbols = cached.symbolize_all([1, 2, 1])
+        self.assertEqual([s.name for s in symbols], ['fn_1', 'fn_2', 'fn_1'])
+        self.assertEqual(cached.symbolize(2).name, 'fn_2')
+        cached.symbolize_all([2, 3])
+        self.assertEqual(self._wrapped.looked_up, [[1, 2], [3]])
+
+    def test_save_and_reload(self):
+        cached = pw_symbolizer.CachedSymbolizer(self._wrapped,
+                                                self._cache_file)
+        expected = cached.symbolize_all([0x8000, 0x8004])
+        cached.save()
+
+        wrapped = _CountingSymbolizer()
+        reloaded = pw_symbolizer.CachedSymbolizer(wrapped, self._cache_file)
+        self.assertEqual(reloaded.symbolize_all([0x8000, 0x8004]), expected)
+        self.assertEqual(wrapped.looked_up, [])
+
+    def test_unreadable_cache_is_ignored(self):
+        self._cache_file.write_text('not json')
+        cached = pw_symbolizer.CachedSymbolizer(self._wrapped,
+                                                self._cache_file)
+        self.assertEqual(cached.symbolize(5).name, 'fn_5')
+        cached.save()
+        self.assertIn('fn_5', self._cache_file.read_text())
+
+    def test_cache_key_depends_on_contents(self):
+        first = Path(self._dir.name) / 'first.bin'
+        second = Path(self._dir.name) / 'second.bin'
+        first.write_bytes(b'not an elf')
+        second.write_bytes(b'also not an elf')
+        self.assertEqual(pw_symbolizer.symbol_cache.elf_cache_key(first),
+                         pw_symbolizer.symbol_cache.elf_cache_key(first))
+        self.assertNotEqual(pw_symbolizer.symbol_cache.elf_cache_key(first),
+                            pw_symbolizer.symbol_cache.elf_cache_key(second))
+
+
 class TestSymbolFormatting(unittest.TestCase):
     """Tests Symbol objects to validate formatted output."""
     def test_blank_symbol(self):
@@ -0,0 +1,61 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/adaptive_mutex.h"
+
+#include <mutex>
+
+#include "gtest/gtest.h"
+
+namespace pw::sync {
+namespace {
+
+// TODO(pwbug/291): Add real concurrency tests once we have pw::thread.
+
+TEST(AdaptiveMutex, LockUnlock) {
+  AdaptiveMutex mutex;
+  mutex.lock();
+  mutex.unlock();
+
+  // Uncontended locks are not counted.
+  EXPECT_EQ(0u, mutex.spin_acquisitions());
+  EXPECT_EQ(0u, mutex.blocking_acquisitions());
+}
+
+AdaptiveMutex static_mutex;
+TEST(AdaptiveMutex, LockUnlockStatic) {
+  static_mutex.lock();
+  static_mutex.unlock();
+}
+
+TEST(AdaptiveMutex, TryLockUnlock) {
+  AdaptiveMutex mutex(0);
+  const bool locked = mutex.try_lock();
+  EXPECT_TRUE(locked);
+  if (locked) {
+    mutex.unlock();
+  }
+}
+
+TEST(AdaptiveMutex, LockGuard) {
+  AdaptiveMutex mutex(10);
+  {
+    std::lock_guard lock(mutex);
+  }
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
+
+}  // namespace
+}  // namespace pw::sync
@@ -312,5 +312,81 @@ TEST_F(BorrowableTimedLockableTest, TryAcquireUntilFailure) {
   lock_.unlock();
 }
 
+class SharedLockable : public Lockable {
+ public:
+  int readers() const { return readers_; }
+
+  void lock_shared() {
+    PW_CHECK(!locked(), "Shared lock while locked detected");
+    readers_ += 1;
+  }
+
+  bool try_lock_shared() {
+    if (locked()) {
+      return false;
+    }
+    readers_ += 1;
+    return true;
+  }
+
+  void unlock_shared() {
+    PW_CHECK_INT_GT(readers_, 0, "Shared unlock while unlocked detected");
+    readers_ -= 1;
+  }
+
+ private:
+  int readers_ = 0;
+};
+
+using BorrowableSharedLockableTest = BorrowableTest<SharedLockable>;
+
+TEST_F(BorrowableSharedLockableTest, AcquireShared) {
+  {
+    SharedBorrowedPointer<Foo, SharedLockable> borrowed_foo =
+        borrowable_foo_.acquire_shared();
+    SharedBorrowedPointer<Foo, SharedLockable> other_borrowed_foo =
+        borrowable_foo_.acquire_shared();
+    EXPECT_EQ(lock_.readers(), 2);  // Ensure the lock is shared.
+    EXPECT_FALSE(lock_.locked());
+    EXPECT_EQ(borrowed_foo->value, kInitialValue);
+    EXPECT_EQ((*other_borrowed_foo).value, kInitialValue);
+  }
+  EXPECT_EQ(lock_.readers(), 0);  // Ensure the lock is released.
+}
+
+TEST_F(BorrowableSharedLockableTest, AcquireSharedMoveable) {
+  {
+    SharedBorrowedPointer<Foo, SharedLockable> borrowed_foo =
+        borrowable_foo_.acquire_shared();
+    SharedBorrowedPointer<Foo, SharedLockable> moved_foo =
+        std::move(borrowed_foo);
+    EXPECT_EQ(lock_.readers(), 1);
+    EXPECT_EQ(moved_foo->value, kInitialValue);
+  }
+  EXPECT_EQ(lock_.readers(), 0);  // Ensure the lock is released once.
+}
+
+TEST_F(BorrowableSharedLockableTest, TryAcquireSharedSuccess) {
+  {
+    std::optional<SharedBorrowedPointer<Foo, SharedLockable>>
+        maybe_borrowed_foo = borrowable_foo_.try_acquire_shared();
+    ASSERT_TRUE(maybe_borrowed_foo.has_value());
+    EXPECT_EQ(lock_.readers(), 1);  // Ensure the lock is held.
+    EXPECT_EQ(maybe_borrowed_foo.value()->value, kInitialValue);
+  }
+  EXPECT_EQ(lock_.readers(), 0);  // Ensure the lock is released.
+}
+
+TEST_F(BorrowableSharedLockableTest, TryAcquireSharedFailure) {
+  lock_.lock();
+  {
+    std::optional<SharedBorrowedPointer<Foo, SharedLockable>>
+        maybe_borrowed_foo = borrowable_foo_.try_acquire_shared();
+    EXPECT_FALSE(maybe_borrowed_foo.has_value());
+  }
+  EXPECT_EQ(lock_.readers(), 0);
+  lock_.unlock();
+}
+
 }  // namespace
 }  // namespace pw::sync
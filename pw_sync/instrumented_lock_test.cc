@@ -0,0 +1,143 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/instrumented_lock.h"
+
+#include <chrono>
+#include <mutex>
+
+#include "gtest/gtest.h"
+
+namespace pw::sync {
+namespace {
+
+using chrono::SystemClock;
+
+#define Metric(name) \
+  MetricValue(_PW_METRIC_TOKEN_MASK & PW_TOKENIZER_STRING_TOKEN(name))
+
+constexpr uint32_t kLockName = PW_SYNC_LOCK_NAME("test_lock");
+
+void SpinFor(SystemClock::duration duration) {
+  const SystemClock::time_point until = SystemClock::now() + duration;
+  while (SystemClock::now() < until) {
+  }
+}
+
+// A lock which can be made to look contended. When it is, try_lock() fails and
+// lock() spins for a set time, as if waiting for another thread.
+class FakeLock {
+ public:
+  bool try_lock() { return !contended_; }
+
+  void lock() { SpinFor(wait_); }
+
+  void unlock() {}
+
+  static void set_contended(bool contended, SystemClock::duration wait = {}) {
+    contended_ = contended;
+    wait_ = wait;
+  }
+
+ private:
+  static inline bool contended_ = false;
+  static inline SystemClock::duration wait_ = {};
+};
+
+class InstrumentedLockTest : public ::testing::Test {
+ protected:
+  InstrumentedLockTest()
+      : lock_(kLockName,
+              SystemClock::for_at_least(std::chrono::milliseconds(20))) {}
+
+  ~InstrumentedLockTest() override { FakeLock::set_contended(false); }
+
+  uint32_t MetricValue(uint32_t token) {
+    for (const metric::Metric& metric : lock_.metrics().metrics()) {
+      if (metric.name() == token) {
+        return metric.as_int();
+      }
+    }
+    ADD_FAILURE();
+    return 0;
+  }
+
+  InstrumentedLock<FakeLock> lock_;
+};
+
+TEST_F(InstrumentedLockTest, Name) {
+  EXPECT_EQ(lock_.metrics().name(), kLockName);
+}
+
+TEST_F(InstrumentedLockTest, Uncontended_CountsAcquisitions) {
+  lock_.lock();
+  lock_.unlock();
+  ASSERT_TRUE(lock_.try_lock());
+  lock_.unlock();
+  {
+    std::lock_guard lock(lock_);
+  }
+
+  EXPECT_EQ(3u, Metric("acquisitions"));
+  EXPECT_EQ(0u, Metric("contended_acquisitions"));
+  EXPECT_EQ(0u, Metric("total_wait_us"));
+}
+
+TEST_F(InstrumentedLockTest, TryLock_Contended_NotCounted) {
+  FakeLock::set_contended(true);
+  EXPECT_FALSE(lock_.try_lock());
+
+  EXPECT_EQ(0u, Metric("acquisitions"));
+  EXPECT_EQ(0u, Metric("contended_acquisitions"));
+}
+
+TEST_F(InstrumentedLockTest, Contended_RecordsWait) {
+  FakeLock::set_contended(
+      true, SystemClock::for_at_least(std::chrono::microseconds(500)));
+  lock_.lock();
+  lock_.unlock();
+  lock_.lock();
+  lock_.unlock();
+
+  EXPECT_EQ(2u, Metric("acquisitions"));
+  EXPECT_EQ(2u, Metric("contended_acquisitions"));
+  EXPECT_EQ(0u, Metric("slow_acquisitions"));
+  EXPECT_GE(Metric("max_wait_us"), 500u);
+  EXPECT_GE(Metric("total_wait_us"), 1000u);
+}
+
+TEST_F(InstrumentedLockTest, Contended_WaitOverThreshold_CountedAsSlow) {
+  FakeLock::set_contended(
+      true, SystemClock::for_at_least(std::chrono::milliseconds(21)));
+  lock_.lock();
+  lock_.unlock();
+
+  EXPECT_EQ(1u, Metric("contended_acquisitions"));
+  EXPECT_EQ(1u, Metric("slow_acquisitions"));
+  EXPECT_GE(Metric("max_wait_us"), 21000u);
+}
+
+TEST_F(InstrumentedLockTest, Unlock_RecordsMaxHold) {
+  lock_.lock();
+  SpinFor(SystemClock::for_at_least(std::chrono::milliseconds(2)));
+  lock_.unlock();
+
+  lock_.lock();
+  lock_.unlock();
+
+  EXPECT_GE(Metric("max_hold_us"), 2000u);
+}
+
+}  // namespace
+}  // namespace pw::sync
@@ -0,0 +1,115 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+#include "pw_sync/yield_core.h"
+
+namespace pw::sync {
+
+// The AdaptiveMutex is a Mutex which spins, retrying try_lock() a bounded
+// number of times, before blocking on the kernel primitive. On SMP targets this
+// avoids the cost of blocking and waking for locks which are only held for a
+// short time. It offers the same exclusive, non-recursive ownership semantics
+// as the Mutex, and priority inheritance still applies once it blocks.
+//
+// Spinning only helps if the lock holder is running on another core; on a
+// single core, use a spin count of 0 or a plain Mutex.
+//
+// This is thread safe, but NOT IRQ safe.
+class PW_LOCKABLE("pw::sync::AdaptiveMutex") AdaptiveMutex {
+ public:
+  static constexpr uint32_t kDefaultSpinCount = 100;
+
+  AdaptiveMutex() : AdaptiveMutex(kDefaultSpinCount) {}
+  explicit AdaptiveMutex(uint32_t spin_count)
+      : spin_count_(spin_count),
+        spin_acquisitions_(0),
+        blocking_acquisitions_(0) {}
+
+  AdaptiveMutex(const AdaptiveMutex&) = delete;
+  AdaptiveMutex(AdaptiveMutex&&) = delete;
+  AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+  AdaptiveMutex& operator=(AdaptiveMutex&&) = delete;
+
+  // Locks the mutex, spinning up to spin_count times before blocking
+  // indefinitely. Failures are fatal.
+  //
+  // PRECONDITION:
+  //   The lock isn't already held by this thread. Recursive locking is
+  //   undefined behavior.
+  void lock() PW_EXCLUSIVE_LOCK_FUNCTION() {
+    if (mutex_.try_lock()) {
+      return;
+    }
+
+    for (uint32_t i = 0; i < spin_count_; ++i) {
+      PW_SYNC_YIELD_CORE_FOR_SMT();
+      if (mutex_.try_lock()) {
+        Increment(spin_acquisitions_);
+        return;
+      }
+    }
+
+    mutex_.lock();
+    Increment(blocking_acquisitions_);
+  }
+
+  // Attempts to lock the mutex in a non-blocking manner, without spinning.
+  // Returns true if the mutex was successfully acquired.
+  //
+  // PRECONDITION:
+  //   The lock isn't already held by this thread. Recursive locking is
+  //   undefined behavior.
+  bool try_lock() PW_EXCLUSIVE_TRYLOCK_FUNCTION(true) {
+    return mutex_.try_lock();
+  }
+
+  // Unlocks the mutex. Failures are fatal.
+  //
+  // PRECONDITION:
+  //   The mutex is held by this thread.
+  void unlock() PW_UNLOCK_FUNCTION() { mutex_.unlock(); }
+
+  // The number of contended lock() calls which acquired the mutex by spinning.
+  uint32_t spin_acquisitions() const {
+    return spin_acquisitions_.load(std::memory_order_relaxed);
+  }
+
+  // The number of contended lock() calls which blocked after spinning.
+  uint32_t blocking_acquisitions() const {
+    return blocking_acquisitions_.load(std::memory_order_relaxed);
+  }
+
+  Mutex& mutex() { return mutex_; }
+
+ private:
+  // The counters are only written while the mutex is held, so they do not need
+  // an atomic read-modify-write.
+  static void Increment(std::atomic<uint32_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  }
+
+  Mutex mutex_;
+  const uint32_t spin_count_;
+  std::atomic<uint32_t> spin_acquisitions_;
+  std::atomic<uint32_t> blocking_acquisitions_;
+};
+
+}  // namespace pw::sync
@@ -0,0 +1,92 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_sync/shared_mutex.h"
+
+namespace pw::sync {
+
+inline SharedMutex::SharedMutex() : native_type_() {
+  native_type_.resource.release();
+}
+
+inline SharedMutex::~SharedMutex() {}
+
+inline void SharedMutex::lock() PW_NO_LOCK_SAFETY_ANALYSIS {
+  native_type_.turnstile.lock();
+  native_type_.resource.acquire();
+}
+
+inline bool SharedMutex::try_lock() PW_NO_LOCK_SAFETY_ANALYSIS {
+  if (!native_type_.turnstile.try_lock()) {
+    return false;
+  }
+  if (!native_type_.resource.try_acquire()) {
+    native_type_.turnstile.unlock();
+    return false;
+  }
+  return true;
+}
+
+inline void SharedMutex::unlock() PW_NO_LOCK_SAFETY_ANALYSIS {
+  native_type_.resource.release();
+  native_type_.turnstile.unlock();
+}
+
+inline void SharedMutex::lock_shared() PW_NO_LOCK_SAFETY_ANALYSIS {
+  native_type_.turnstile.lock();
+  native_type_.turnstile.unlock();
+
+  native_type_.reader_count_mutex.lock();
+  if (native_type_.reader_count == 0u) {
+    native_type_.resource.acquire();
+  }
+  native_type_.reader_count += 1;
+  native_type_.reader_count_mutex.unlock();
+}
+
+inline bool SharedMutex::try_lock_shared() PW_NO_LOCK_SAFETY_ANALYSIS {
+  if (!native_type_.turnstile.try_lock()) {
+    return false;
+  }
+  native_type_.turnstile.unlock();
+
+  // The count mutex is held by the first reader while it waits for a writer,
+  // so this cannot block on it.
+  if (!native_type_.reader_count_mutex.try_lock()) {
+    return false;
+  }
+  const bool locked =
+      native_type_.reader_count != 0u || native_type_.resource.try_acquire();
+  if (locked) {
+    native_type_.reader_count += 1;
+  }
+  native_type_.reader_count_mutex.unlock();
+  return locked;
+}
+
+inline void SharedMutex::unlock_shared() PW_NO_LOCK_SAFETY_ANALYSIS {
+  native_type_.reader_count_mutex.lock();
+  native_type_.reader_count -= 1;
+  if (native_type_.reader_count == 0u) {
+    native_type_.resource.release();
+  }
+  native_type_.reader_count_mutex.unlock();
+}
+
+inline SharedMutex::native_handle_type SharedMutex::native_handle() {
+  return native_type_;
+}
+
+}  // namespace pw::sync
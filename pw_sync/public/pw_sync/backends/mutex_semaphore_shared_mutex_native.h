@@ -0,0 +1,38 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_sync/binary_semaphore.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::sync::backend {
+
+// A portable SharedMutex for kernels without a native reader-writer lock.
+//
+// The resource semaphore is held by a writer, or by the readers as a group
+// while any reader holds the lock. Writers also hold the turnstile, which every
+// reader passes through before locking, so that a waiting writer blocks new
+// readers and is not starved.
+struct NativeSharedMutex {
+  Mutex turnstile;
+  Mutex reader_count_mutex;
+  BinarySemaphore resource;
+  size_t reader_count = 0;
+};
+
+using NativeSharedMutexHandle = NativeSharedMutex&;
+
+}  // namespace pw::sync::backend
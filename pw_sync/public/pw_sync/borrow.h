@@ -85,6 +85,65 @@ class BorrowedPointer {
   GuardedType* object_;
 };
 
+// The SharedBorrowedPointer is an RAII handle which wraps a pointer to an
+// object borrowed for reading along with a shared lock which is guarding the
+// object. When destroyed, the shared lock is released.
+template <typename GuardedType, typename Lock>
+class SharedBorrowedPointer {
+ public:
+  // Release the shared lock on destruction.
+  ~SharedBorrowedPointer() {
+    if (lock_ != nullptr) {
+      lock_->unlock_shared();
+    }
+  }
+
+  // This object is moveable, but not copyable.
+  //
+  // Postcondition: The other SharedBorrowedPointer is no longer valid and will
+  //     assert if the GuardedType is accessed.
+  SharedBorrowedPointer(SharedBorrowedPointer&& other)
+      : lock_(other.lock_), object_(other.object_) {
+    other.lock_ = nullptr;
+    other.object_ = nullptr;
+  }
+  SharedBorrowedPointer& operator=(SharedBorrowedPointer&& other) {
+    lock_ = other.lock_;
+    object_ = other.object_;
+    other.lock_ = nullptr;
+    other.object_ = nullptr;
+    return *this;
+  }
+  SharedBorrowedPointer(const SharedBorrowedPointer&) = delete;
+  SharedBorrowedPointer& operator=(const SharedBorrowedPointer&) = delete;
+
+  // Provides read-only access to the borrowed object's members.
+  const GuardedType* operator->() const {
+    PW_ASSERT(object_ != nullptr);  // Ensure this isn't a stale moved instance.
+    return object_;
+  }
+
+  // Provides read-only access to the borrowed object directly.
+  //
+  // WARNING: Be careful not to leak references to the borrowed object!
+  const GuardedType& operator*() const {
+    PW_ASSERT(object_ != nullptr);  // Ensure this isn't a stale moved instance.
+    return *object_;
+  }
+
+ private:
+  // Allow SharedBorrowedPointer creation inside of Borrowable's acquire
+  // methods.
+  template <typename G, typename L>
+  friend class Borrowable;
+
+  constexpr SharedBorrowedPointer(Lock& lock, const GuardedType& object)
+      : lock_(&lock), object_(&object) {}
+
+  Lock* lock_;
+  const GuardedType* object_;
+};
+
 // The Borrowable is a helper construct that enables callers to borrow an object
 // which is guarded by a lock.
 //
@@ -92,7 +151,9 @@ class BorrowedPointer {
 // BorrowedPointer which permits access while the lock is held.
 //
 // This class is compatible with locks which comply with BasicLockable,
-// Lockable, and TimedLockable C++ named requirements.
+// Lockable, and TimedLockable C++ named requirements. Locks which also comply
+// with the SharedLockable named requirement, such as the SharedMutex, can lend
+// the object to several readers at once with the shared acquire methods.
 template <typename GuardedType, typename Lock = pw::sync::VirtualBasicLockable>
 class Borrowable {
  public:
@@ -143,6 +204,23 @@ class Borrowable {
     return BorrowedPointer<GuardedType, Lock>(*lock_, *object_);
   }
 
+  // Blocks indefinitely until the object can be borrowed for reading, which may
+  // be shared with other readers. Failures are fatal.
+  SharedBorrowedPointer<GuardedType, Lock> acquire_shared()
+      PW_NO_LOCK_SAFETY_ANALYSIS {
+    lock_->lock_shared();
+    return SharedBorrowedPointer<GuardedType, Lock>(*lock_, *object_);
+  }
+
+  // Tries to borrow the object for reading in a non-blocking manner. Returns a
+  // SharedBorrowedPointer on success, otherwise std::nullopt (nothing).
+  std::optional<SharedBorrowedPointer<GuardedType, Lock>> try_acquire_shared() {
+    if (!lock_->try_lock_shared()) {
+      return std::nullopt;
+    }
+    return SharedBorrowedPointer<GuardedType, Lock>(*lock_, *object_);
+  }
+
  private:
   Lock* lock_;
   GuardedType* object_;
@@ -0,0 +1,167 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_metric/metric.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_tokenizer/tokenize.h"
+#include "pw_trace/trace.h"
+
+// Tokenizes the name of an InstrumentedLock. The name is tokenized in the
+// metrics domain, so it is detokenized along with the rest of a metric dump.
+// Like PW_TOKENIZE_STRING, this must be assigned to a variable.
+#define PW_SYNC_LOCK_NAME(name) PW_TOKENIZE_STRING_DOMAIN("metrics", name)
+
+namespace pw::sync {
+
+// The InstrumentedLock wraps a lock, such as a Mutex or an InterruptSpinLock,
+// and records how often it is contended, how long callers wait for it, and how
+// long it is held. The statistics are kept in a metric group named after the
+// lock, so they can be dumped or served over RPC with the rest of a device's
+// metrics. Waits longer than the trace threshold also emit a pw_trace event
+// with the lock's name token and the wait in microseconds.
+//
+//   constexpr uint32_t kBufferLockName = PW_SYNC_LOCK_NAME("buffer_lock");
+//   pw::sync::InstrumentedLock<pw::sync::Mutex> buffer_lock(kBufferLockName);
+//
+// Instrumentation is opt-in: the lock is a drop-in replacement for the lock it
+// wraps, but every lock() reads the system clock, and every unlock() reads it
+// again, so only wrap locks which are being investigated. Do not instrument a
+// lock which the pw_trace backend itself acquires.
+//
+// The statistics are only updated while the lock is held. They have the same
+// thread and IRQ safety as the wrapped lock.
+template <typename Lock>
+class PW_LOCKABLE("pw::sync::InstrumentedLock") InstrumentedLock {
+ public:
+  // Contended lock() calls which wait at least this long are traced.
+  static constexpr chrono::SystemClock::duration kDefaultTraceThreshold =
+      chrono::SystemClock::for_at_least(std::chrono::milliseconds(1));
+
+  explicit InstrumentedLock(
+      metric::Token name,
+      chrono::SystemClock::duration trace_threshold = kDefaultTraceThreshold)
+      : metrics_(name), trace_threshold_(trace_threshold) {}
+
+  InstrumentedLock(const InstrumentedLock&) = delete;
+  InstrumentedLock(InstrumentedLock&&) = delete;
+  InstrumentedLock& operator=(const InstrumentedLock&) = delete;
+  InstrumentedLock& operator=(InstrumentedLock&&) = delete;
+
+  // Locks the wrapped lock. If it is already held, records the time spent
+  // waiting for it.
+  void lock() PW_EXCLUSIVE_LOCK_FUNCTION() {
+    if (lock_.try_lock()) {
+      Acquired();
+      return;
+    }
+
+    const chrono::SystemClock::time_point start = chrono::SystemClock::now();
+    lock_.lock();
+    Acquired();
+    RecordWait(acquired_at_ - start);
+  }
+
+  // Attempts to lock the wrapped lock without waiting. Returns true if the lock
+  // was acquired.
+  bool try_lock() PW_EXCLUSIVE_TRYLOCK_FUNCTION(true) {
+    if (!lock_.try_lock()) {
+      return false;
+    }
+    Acquired();
+    return true;
+  }
+
+  // Records how long the lock was held and unlocks it.
+  void unlock() PW_UNLOCK_FUNCTION() {
+    const uint32_t hold_us =
+        ToMicroseconds(chrono::SystemClock::now() - acquired_at_);
+    if (hold_us > max_hold_us_.value()) {
+      max_hold_us_.Set(hold_us);
+    }
+    lock_.unlock();
+  }
+
+  // The lock's statistics. Read them while holding the lock, or accept that
+  // they may be mid-update.
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  // Payload of the trace event emitted for a slow acquisition.
+  struct WaitEvent {
+    uint32_t name;
+    uint32_t wait_us;
+  };
+
+  static uint32_t ToMicroseconds(chrono::SystemClock::duration duration) {
+    const int64_t us =
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    if (us < 0) {
+      return 0;
+    }
+    if (us > std::numeric_limits<uint32_t>::max()) {
+      return std::numeric_limits<uint32_t>::max();
+    }
+    return static_cast<uint32_t>(us);
+  }
+
+  void Acquired() PW_EXCLUSIVE_LOCKS_REQUIRED(this) {
+    acquired_at_ = chrono::SystemClock::now();
+    acquisitions_.Increment();
+  }
+
+  void RecordWait(chrono::SystemClock::duration wait)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(this) {
+    const uint32_t wait_us = ToMicroseconds(wait);
+
+    contended_acquisitions_.Increment();
+    // Saturate rather than wrap, so the total of a long-lived lock pins at the
+    // maximum instead of dropping back to a small value.
+    const uint32_t total_wait_us = total_wait_us_.value();
+    total_wait_us_.Set(
+        wait_us > std::numeric_limits<uint32_t>::max() - total_wait_us
+            ? std::numeric_limits<uint32_t>::max()
+            : total_wait_us + wait_us);
+    if (wait_us > max_wait_us_.value()) {
+      max_wait_us_.Set(wait_us);
+    }
+
+    if (wait >= trace_threshold_) {
+      slow_acquisitions_.Increment();
+      const WaitEvent event = {.name = metrics_.name(), .wait_us = wait_us};
+      PW_TRACE_INSTANT_DATA(
+          "pw_sync_lock_wait", "@pw_py_struct_fmt:II", &event, sizeof(event));
+    }
+  }
+
+  Lock lock_;
+  chrono::SystemClock::time_point acquired_at_;
+
+  metric::Group metrics_;
+  PW_METRIC(metrics_, acquisitions_, "acquisitions", 0u);
+  PW_METRIC(metrics_, contended_acquisitions_, "contended_acquisitions", 0u);
+  PW_METRIC(metrics_, slow_acquisitions_, "slow_acquisitions", 0u);
+  PW_METRIC(metrics_, total_wait_us_, "total_wait_us", 0u);
+  PW_METRIC(metrics_, max_wait_us_, "max_wait_us", 0u);
+  PW_METRIC(metrics_, max_hold_us_, "max_hold_us", 0u);
+
+  const chrono::SystemClock::duration trace_threshold_;
+};
+
+}  // namespace pw::sync
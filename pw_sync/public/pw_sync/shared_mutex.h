@@ -0,0 +1,97 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync_backend/shared_mutex_native.h"
+
+namespace pw::sync {
+
+// The SharedMutex is a synchronization primitive that can be used to protect
+// shared data from being simultaneously accessed by multiple threads. Unlike
+// the Mutex, it offers two levels of access: any number of threads may hold it
+// in shared mode to read the data, or a single thread may hold it in exclusive
+// mode to modify it. This is thread safe, but NOT IRQ safe.
+//
+// Whether waiting writers block new readers, and whether priority inheritance
+// is used, depends on the backend.
+//
+// WARNING: In order to support global statically constructed SharedMutexes,
+// the user and/or backend MUST ensure that any initialization required in your
+// environment is done prior to the creation and/or initialization of the native
+// synchronization primitives (e.g. kernel initialization).
+class PW_LOCKABLE("pw::sync::SharedMutex") SharedMutex {
+ public:
+  using native_handle_type = backend::NativeSharedMutexHandle;
+
+  SharedMutex();
+  ~SharedMutex();
+  SharedMutex(const SharedMutex&) = delete;
+  SharedMutex(SharedMutex&&) = delete;
+  SharedMutex& operator=(const SharedMutex&) = delete;
+  SharedMutex& operator=(SharedMutex&&) = delete;
+
+  // Locks the mutex exclusively, blocking indefinitely. Failures are fatal.
+  //
+  // PRECONDITION:
+  //   The lock isn't already held by this thread in either mode. Recursive
+  //   locking is undefined behavior.
+  void lock() PW_EXCLUSIVE_LOCK_FUNCTION();
+
+  // Attempts to lock the mutex exclusively in a non-blocking manner.
+  // Returns true if the mutex was successfully acquired.
+  //
+  // PRECONDITION:
+  //   The lock isn't already held by this thread in either mode. Recursive
+  //   locking is undefined behavior.
+  bool try_lock() PW_EXCLUSIVE_TRYLOCK_FUNCTION(true);
+
+  // Unlocks the mutex from exclusive mode. Failures are fatal.
+  //
+  // PRECONDITION:
+  //   The mutex is held exclusively by this thread.
+  void unlock() PW_UNLOCK_FUNCTION();
+
+  // Locks the mutex in shared mode, blocking indefinitely. Failures are fatal.
+  //
+  // PRECONDITION:
+  //   The lock isn't already held by this thread in either mode. Recursive
+  //   locking is undefined behavior.
+  void lock_shared() PW_SHARED_LOCK_FUNCTION();
+
+  // Attempts to lock the mutex in shared mode in a non-blocking manner. This
+  // may fail spuriously while another thread is acquiring or releasing a
+  // shared lock. Returns true if the mutex was successfully acquired.
+  //
+  // PRECONDITION:
+  //   The lock isn't already held by this thread in either mode. Recursive
+  //   locking is undefined behavior.
+  bool try_lock_shared() PW_SHARED_TRYLOCK_FUNCTION(true);
+
+  // Unlocks the mutex from shared mode. Failures are fatal.
+  //
+  // PRECONDITION:
+  //   The mutex is held in shared mode by this thread.
+  void unlock_shared() PW_UNLOCK_FUNCTION();
+
+  native_handle_type native_handle();
+
+ private:
+  // This may be a wrapper around a native type with additional members.
+  backend::NativeSharedMutex native_type_;
+};
+
+}  // namespace pw::sync
+
+#include "pw_sync_backend/shared_mutex_inline.h"
@@ -0,0 +1,90 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/yield_core.h"
+
+// On ARM, waiting cores sleep with WFE until the lock holder signals an unlock
+// with SEV, rather than polling the lock continuously. The DSB makes the unlock
+// visible to other cores before they are woken.
+#if defined(__aarch64__) || defined(__arm__)
+#define _PW_SYNC_BAREMETAL_WAIT_FOR_UNLOCK() asm volatile("wfe" ::: "memory")
+#define _PW_SYNC_BAREMETAL_SIGNAL_UNLOCK() \
+  asm volatile("dsb sy\n\tsev" ::: "memory")
+#else
+#define _PW_SYNC_BAREMETAL_WAIT_FOR_UNLOCK() PW_SYNC_YIELD_CORE_FOR_SMT()
+#define _PW_SYNC_BAREMETAL_SIGNAL_UNLOCK() static_cast<void>(0)
+#endif  // defined(__aarch64__) || defined(__arm__)
+
+namespace pw::sync {
+
+constexpr InterruptSpinLock::InterruptSpinLock()
+    : native_type_{.next_ticket = 0,
+                   .now_serving = 0,
+                   .contended_locks = 0,
+                   .max_queue_depth = 0} {}
+
+inline void InterruptSpinLock::lock() {
+  // TODO(pwbug/303): Use the pw_interrupt API here to disable interrupts.
+  const uint32_t ticket =
+      native_type_.next_ticket.fetch_add(1, std::memory_order_relaxed);
+  uint32_t serving = native_type_.now_serving.load(std::memory_order_acquire);
+  if (serving == ticket) {
+    return;
+  }
+
+  // Tickets wrap around, so the subtraction gives the distance in the queue.
+  const uint32_t queue_depth = ticket - serving;
+
+  do {
+    _PW_SYNC_BAREMETAL_WAIT_FOR_UNLOCK();
+    serving = native_type_.now_serving.load(std::memory_order_acquire);
+  } while (serving != ticket);
+
+  // The lock is held, so the counters can be updated without atomics.
+  native_type_.contended_locks += 1;
+  if (queue_depth > native_type_.max_queue_depth) {
+    native_type_.max_queue_depth = queue_depth;
+  }
+}
+
+inline bool InterruptSpinLock::try_lock() {
+  // Only take a ticket if it would be served right away, so that a failed
+  // attempt never joins the queue.
+  uint32_t serving = native_type_.now_serving.load(std::memory_order_relaxed);
+  return native_type_.next_ticket.compare_exchange_strong(
+      serving,
+      serving + 1,
+      std::memory_order_acquire,
+      std::memory_order_relaxed);
+}
+
+inline void InterruptSpinLock::unlock() {
+  // Only the lock holder advances now_serving, so a plain store suffices.
+  native_type_.now_serving.store(
+      native_type_.now_serving.load(std::memory_order_relaxed) + 1,
+      std::memory_order_release);
+  _PW_SYNC_BAREMETAL_SIGNAL_UNLOCK();
+}
+
+inline InterruptSpinLock::native_handle_type
+InterruptSpinLock::native_handle() {
+  return native_type_;
+}
+
+}  // namespace pw::sync
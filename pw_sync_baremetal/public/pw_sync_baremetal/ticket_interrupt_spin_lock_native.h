@@ -0,0 +1,36 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace pw::sync::backend {
+
+// A ticket lock: each core that locks takes the next ticket and waits until it
+// is the ticket being served, so cores acquire the lock in FIFO order.
+struct NativeInterruptSpinLock {
+  std::atomic<uint32_t> next_ticket;
+  std::atomic<uint32_t> now_serving;
+
+  // Contention counters, which are only updated while the lock is held.
+  //
+  // The number of lock() calls that had to wait for the lock.
+  uint32_t contended_locks;
+  // The most lock holders and waiters ahead of any one lock() call.
+  uint32_t max_queue_depth;
+};
+using NativeInterruptSpinLockHandle = NativeInterruptSpinLock&;
+
+}  // namespace pw::sync::backend
@@ -21,35 +21,43 @@ using pw::chrono::SystemClock;
 namespace pw::sync {
 
 void BinarySemaphore::release() {
-  std::lock_guard lock(native_type_.mutex);
-  PW_DCHECK_UINT_LT(native_type_.count, BinarySemaphore::max());
-  ++native_type_.count;
-  native_type_.condition.notify_one();
+  const ptrdiff_t previous = native_type_.count.fetch_add(1);
+  PW_DCHECK_UINT_LT(previous, BinarySemaphore::max());
+
+  // Only enter the kernel if a thread is blocked. Taking the mutex ensures a
+  // waiter which has already checked the count is waiting on the condition
+  // before it is notified.
+  if (native_type_.waiters.load() != 0) {
+    std::lock_guard lock(native_type_.mutex);
+    native_type_.condition.notify_one();
+  }
 }
 
 void BinarySemaphore::acquire() {
+  if (try_acquire()) {
+    return;
+  }
   std::unique_lock lock(native_type_.mutex);
-  native_type_.condition.wait(lock, [&] { return native_type_.count != 0; });
-  native_type_.count = 0;
+  ++native_type_.waiters;
+  native_type_.condition.wait(lock, [&] { return try_acquire(); });
+  --native_type_.waiters;
 }
 
 bool BinarySemaphore::try_acquire() noexcept {
-  std::lock_guard lock(native_type_.mutex);
-  if (native_type_.count != 0) {
-    native_type_.count = 0;
-    return true;
-  }
-  return false;
+  return native_type_.count.load(std::memory_order_relaxed) != 0 &&
+         native_type_.count.exchange(0) != 0;
 }
 
 bool BinarySemaphore::try_acquire_until(SystemClock::time_point deadline) {
-  std::unique_lock lock(native_type_.mutex);
-  if (native_type_.condition.wait_until(
-          lock, deadline, [&] { return native_type_.count != 0; })) {
-    native_type_.count = 0;
+  if (try_acquire()) {
     return true;
   }
-  return false;
+  std::unique_lock lock(native_type_.mutex);
+  ++native_type_.waiters;
+  const bool acquired = native_type_.condition.wait_until(
+      lock, deadline, [&] { return try_acquire(); });
+  --native_type_.waiters;
+  return acquired;
 }
 
 }  // namespace pw::sync
@@ -22,37 +22,52 @@ namespace pw::sync {
 
 void CountingSemaphore::release(ptrdiff_t update) {
   PW_DCHECK_UINT_GE(update, 0);
-  {
+  const ptrdiff_t previous = native_type_.count.fetch_add(update);
+  PW_DCHECK_UINT_LE(update, CountingSemaphore::max() - previous);
+
+  // Only enter the kernel if a thread is blocked. Taking the mutex ensures a
+  // waiter which has already checked the count is waiting on the condition
+  // before it is notified.
+  if (native_type_.waiters.load() != 0) {
     std::lock_guard lock(native_type_.mutex);
-    PW_DCHECK_UINT_LE(update, CountingSemaphore::max() - native_type_.count);
-    native_type_.count += update;
-    native_type_.condition.notify_one();
+    if (update == 1) {
+      native_type_.condition.notify_one();
+    } else {
+      native_type_.condition.notify_all();
+    }
   }
 }
 
 void CountingSemaphore::acquire() {
+  if (try_acquire()) {
+    return;
+  }
   std::unique_lock lock(native_type_.mutex);
-  native_type_.condition.wait(lock, [&] { return native_type_.count != 0; });
-  --native_type_.count;
+  ++native_type_.waiters;
+  native_type_.condition.wait(lock, [&] { return try_acquire(); });
+  --native_type_.waiters;
 }
 
 bool CountingSemaphore::try_acquire() noexcept {
-  std::lock_guard lock(native_type_.mutex);
-  if (native_type_.count != 0) {
-    --native_type_.count;
-    return true;
+  ptrdiff_t count = native_type_.count.load(std::memory_order_relaxed);
+  while (count != 0) {
+    if (native_type_.count.compare_exchange_weak(count, count - 1)) {
+      return true;
+    }
   }
   return false;
 }
 
 bool CountingSemaphore::try_acquire_until(SystemClock::time_point deadline) {
-  std::unique_lock lock(native_type_.mutex);
-  if (native_type_.condition.wait_until(
-          lock, deadline, [&] { return native_type_.count != 0; })) {
-    --native_type_.count;
+  if (try_acquire()) {
     return true;
   }
-  return false;
+  std::unique_lock lock(native_type_.mutex);
+  ++native_type_.waiters;
+  const bool acquired = native_type_.condition.wait_until(
+      lock, deadline, [&] { return try_acquire(); });
+  --native_type_.waiters;
+  return acquired;
 }
 
 }  // namespace pw::sync
@@ -19,7 +19,7 @@
 namespace pw::sync {
 
 inline CountingSemaphore::CountingSemaphore()
-    : native_type_{.mutex = {}, .condition = {}, .count = 0} {}
+    : native_type_{.count = 0, .waiters = 0, .mutex = {}, .condition = {}} {}
 
 inline CountingSemaphore::~CountingSemaphore() {}
 
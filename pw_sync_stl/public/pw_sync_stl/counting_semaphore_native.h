@@ -13,16 +13,22 @@
 // the License.
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <limits>
 #include <mutex>
 
 namespace pw::sync::backend {
 
+// The count is updated atomically, so releasing and acquiring an available
+// semaphore never touches the mutex. The mutex and condition variable are only
+// used when a thread has to block, which is tracked through waiters.
 struct NativeCountingSemaphore {
+  std::atomic<ptrdiff_t> count;
+  std::atomic<size_t> waiters;
   std::mutex mutex;
-  std::condition_variable_any condition;
-  ptrdiff_t count;
+  std::condition_variable condition;
 };
 using NativeCountingSemaphoreHandle = NativeCountingSemaphore&;
 
@@ -0,0 +1,41 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Implements the asynchronous sys io functions synchronously, for backends
+// without hardware support for asynchronous transfers.
+
+#include "pw_sys_io/async.h"
+
+#include "pw_sys_io/sys_io.h"
+
+namespace pw::sys_io {
+
+Status WriteBytesAsync(std::span<const std::byte> src,
+                       WriteCallback&& callback) {
+  const StatusWithSize result = WriteBytes(src);
+  callback(result);
+  return OkStatus();
+}
+
+bool WriteAsyncInProgress() { return false; }
+
+Status StartReadAsync(std::span<std::byte>,
+                      std::span<std::byte>,
+                      ReadCallback&&) {
+  return Status::Unimplemented();
+}
+
+Status StopReadAsync() { return Status::Unimplemented(); }
+
+}  // namespace pw::sys_io
@@ -0,0 +1,90 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// This file extends the pw_sys_io facade with asynchronous bulk I/O. Backends
+// with DMA-capable hardware implement these functions so that transfers
+// proceed without the CPU. Other backends link the facade's default_async
+// library, which implements them on top of the synchronous functions in
+// pw_sys_io/sys_io.h.
+//
+// Callbacks may be invoked from an interrupt handler, so they must be short
+// and must not block.
+
+#include <cstddef>
+#include <span>
+
+#include "pw_function/function.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::sys_io {
+
+// Called when an asynchronous write finishes, with the number of bytes written
+// and the status of the write.
+using WriteCallback = Function<void(StatusWithSize result)>;
+
+// Called each time a receive buffer has data. The data is only valid until the
+// backend wraps around to this part of the buffer again, so it must be
+// consumed before the other receive buffer fills.
+using ReadCallback = Function<void(std::span<const std::byte> data)>;
+
+// Starts writing src out the sys io backend and returns without waiting for
+// the write to finish.
+// Implemented by: Backend, or the facade's default_async library
+//
+// src must remain valid until the callback is called. Only one asynchronous
+// write may be in progress at a time. The callback may be called before this
+// function returns; the default_async library always does so, since it writes
+// synchronously.
+//
+// Returns OkStatus() - The write was started; the callback will be called.
+//         Status::Unavailable() - Another write is in progress. The callback is
+//             not called.
+Status WriteBytesAsync(std::span<const std::byte> src,
+                       WriteCallback&& callback);
+
+// Returns true if an asynchronous write has been started and its callback has
+// not yet been called.
+// Implemented by: Backend, or the facade's default_async library
+bool WriteAsyncInProgress();
+
+// Starts receiving continuously, alternating between two buffers. The callback
+// is called with newly received data when a buffer fills, and may also be
+// called with partially filled buffers (for example, when the line goes idle).
+// Reception continues in the other buffer while the data is processed.
+// Implemented by: Backend, or the facade's default_async library
+//
+// The buffers must remain valid until StopReadAsync() is called. While
+// reception is active, ReadByte() and TryReadByte() must not be used.
+//
+// Returns OkStatus() - Reception started.
+//         Status::InvalidArgument() - A buffer is empty.
+//         Status::FailedPrecondition() - Reception is already active.
+//         Status::Unimplemented() - Not supported on this target. The
+//             default_async library always returns this.
+Status StartReadAsync(std::span<std::byte> first_buffer,
+                      std::span<std::byte> second_buffer,
+                      ReadCallback&& callback);
+
+// Stops reception started by StartReadAsync(). Data received since the last
+// callback is discarded.
+// Implemented by: Backend, or the facade's default_async library
+//
+// Returns OkStatus() - Reception stopped.
+//         Status::FailedPrecondition() - Reception was not active.
+//         Status::Unimplemented() - Not supported on this target.
+Status StopReadAsync();
+
+}  // namespace pw::sys_io
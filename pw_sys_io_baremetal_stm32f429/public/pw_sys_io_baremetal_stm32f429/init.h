@@ -20,4 +20,11 @@ PW_EXTERN_C_START
 // The actual implement of PreMainInit() in sys_io_BACKEND.
 void pw_sys_io_stm32f429_Init();
 
+// Interrupt handlers for the asynchronous functions in pw_sys_io/async.h. The
+// target's vector table must install these for the DMA2 stream 7 (USART1 TX),
+// DMA2 stream 2 (USART1 RX), and USART1 interrupts.
+void pw_sys_io_stm32f429_DmaTxHandler();
+void pw_sys_io_stm32f429_DmaRxHandler();
+void pw_sys_io_stm32f429_Usart1Handler();
+
 PW_EXTERN_C_END
@@ -12,10 +12,15 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
+#include <utility>
 
 #include "pw_preprocessor/compiler.h"
+#include "pw_sys_io/async.h"
 #include "pw_sys_io/sys_io.h"
+#include "pw_sys_io_baremetal_stm32f429/init.h"
 
 namespace {
 
@@ -43,6 +48,9 @@ PW_PACKED(struct) RccBlock {
 // Mask for ahb1_config (AHB1ENR) to enable the "A" GPIO pins.
 constexpr uint32_t kGpioAEnable = 0x1u;
 
+// Mask for ahb1_config (AHB1ENR) to enable DMA2.
+constexpr uint32_t kDma2Enable = 0x1u << 22;
+
 // Mask for apb2_config (APB2ENR) to enable USART1.
 constexpr uint32_t kUsart1Enable = 0x1u << 4;
 
@@ -83,6 +91,7 @@ constexpr uint32_t kGpio10AltModeHighPos = 8;
 constexpr uint8_t kGpioAlternateFunctionUsart1 = 0x07u;
 
 // USART status flags.
+constexpr uint32_t kIdleLineDetected = 0x1u << 4;
 constexpr uint32_t kTxRegisterEmpty = 0x1u << 7;
 
 // USART configuration flags for config1 register.
@@ -92,6 +101,11 @@ constexpr uint32_t kReceiveEnable = 0x1 << 2;
 constexpr uint32_t kTransmitEnable = 0x1 << 3;
 constexpr uint32_t kReadDataReady = 0x1u << 5;
 constexpr uint32_t kEnableUsart = 0x1 << 13;
+constexpr uint32_t kIdleInterruptEnable = 0x1u << 4;
+
+// USART configuration flags for config3 register.
+constexpr uint32_t kDmaReceiveEnable = 0x1u << 6;
+constexpr uint32_t kDmaTransmitEnable = 0x1u << 7;
 
 // Layout of memory mapped registers for USART blocks.
 PW_PACKED(struct) UsartBlock {
@@ -105,6 +119,57 @@ PW_PACKED(struct) UsartBlock {
   uint32_t config4;
 };
 
+// Layout of memory mapped registers for one DMA stream.
+PW_PACKED(struct) DmaStreamBlock {
+  uint32_t config;
+  uint32_t data_count;
+  uint32_t peripheral_address;
+  uint32_t memory0_address;
+  uint32_t memory1_address;
+  uint32_t fifo_control;
+};
+
+// Layout of memory mapped registers for DMA controllers.
+PW_PACKED(struct) DmaBlock {
+  uint32_t low_interrupt_status;
+  uint32_t high_interrupt_status;
+  uint32_t low_interrupt_clear;
+  uint32_t high_interrupt_clear;
+  DmaStreamBlock streams[8];
+};
+
+// DMA stream configuration flags.
+constexpr uint32_t kDmaStreamEnable = 0x1u;
+constexpr uint32_t kDmaTransferErrorInterrupt = 0x1u << 2;
+constexpr uint32_t kDmaTransferCompleteInterrupt = 0x1u << 4;
+constexpr uint32_t kDmaMemoryToPeripheral = 0x1u << 6;
+constexpr uint32_t kDmaCircular = 0x1u << 8;
+constexpr uint32_t kDmaMemoryIncrement = 0x1u << 10;
+constexpr uint32_t kDmaDoubleBuffer = 0x1u << 18;
+constexpr uint32_t kDmaCurrentTarget = 0x1u << 19;
+constexpr uint32_t kDmaChannelUsart1 = 0x4u << 25;
+
+// The largest transfer a DMA stream can do at once.
+constexpr size_t kMaxDmaTransfer = 0xFFFF;
+
+// USART1 TX is DMA2 stream 7, and USART1 RX is DMA2 stream 2, both on channel
+// 4. Stream 7's flags are in the high registers, starting at bit 22. Stream 2's
+// flags are in the low registers, starting at bit 16.
+constexpr size_t kTxStream = 7;
+constexpr size_t kRxStream = 2;
+constexpr uint32_t kTxFlagsPos = 22;
+constexpr uint32_t kRxFlagsPos = 16;
+
+// Per-stream interrupt flags, relative to the stream's position.
+constexpr uint32_t kDmaAllFlags = 0x3Du;
+constexpr uint32_t kDmaTransferErrorFlag = 0x1u << 3;
+constexpr uint32_t kDmaTransferCompleteFlag = 0x1u << 5;
+
+// Interrupt numbers for the NVIC.
+constexpr uint32_t kUsart1Irq = 37;
+constexpr uint32_t kDma2Stream2Irq = 58;
+constexpr uint32_t kDma2Stream7Irq = 70;
+
 // Sets the UART baud register using the peripheral clock and target baud rate.
 // These calculations are specific to the default oversample by 16 mode.
 // TODO(amontanez): Document magic calculations in full UART implementation.
@@ -128,8 +193,128 @@ volatile GpioBlock& gpio_a =
 volatile UsartBlock& usart1 =
     *reinterpret_cast<volatile UsartBlock*>(kApb2PeripheralBase + 0x1000U);
 
+// Declare a reference to the memory mapped block for DMA2.
+volatile DmaBlock& dma2 =
+    *reinterpret_cast<volatile DmaBlock*>(kAhb1PeripheralBase + 0x6400U);
+
+volatile DmaStreamBlock& tx_dma = dma2.streams[kTxStream];
+volatile DmaStreamBlock& rx_dma = dma2.streams[kRxStream];
+
+// The NVIC's interrupt set-enable registers.
+volatile uint32_t* const nvic_interrupt_enable =
+    reinterpret_cast<volatile uint32_t*>(0xE000E100U);
+
+void EnableInterrupt(uint32_t irq) {
+  nvic_interrupt_enable[irq / 32] = 0x1u << (irq % 32);
+}
+
+uint32_t ToAddress(const volatile void* pointer) {
+  return reinterpret_cast<uintptr_t>(pointer);
+}
+
+// State for asynchronous writes. Writes longer than the DMA stream's maximum
+// transfer size are done in several transfers.
+std::atomic<bool> tx_in_progress = false;
+pw::sys_io::WriteCallback tx_callback;
+const std::byte* tx_next;
+size_t tx_remaining;
+size_t tx_chunk;
+size_t tx_written;
+
+// State for asynchronous reads. rx_delivered is the number of bytes in the
+// current buffer that have already been passed to rx_callback.
+bool rx_active = false;
+std::byte* rx_buffers[2];
+size_t rx_buffer_size;
+size_t rx_delivered;
+pw::sys_io::ReadCallback rx_callback;
+
+// Starts the next DMA transfer of an asynchronous write.
+void StartTxTransfer() {
+  tx_chunk = std::min(tx_remaining, kMaxDmaTransfer);
+  dma2.high_interrupt_clear = kDmaAllFlags << kTxFlagsPos;
+  tx_dma.memory0_address = ToAddress(tx_next);
+  tx_dma.data_count = tx_chunk;
+  tx_dma.config = kDmaChannelUsart1 | kDmaMemoryIncrement |
+                  kDmaMemoryToPeripheral | kDmaTransferCompleteInterrupt |
+                  kDmaTransferErrorInterrupt | kDmaStreamEnable;
+}
+
+void FinishWrite(pw::StatusWithSize result) {
+  pw::sys_io::WriteCallback callback = std::move(tx_callback);
+  tx_in_progress = false;
+  callback(result);
+}
+
+void DeliverReceivedData(size_t buffer, size_t end) {
+  if (end > rx_delivered) {
+    rx_callback(std::span<const std::byte>(rx_buffers[buffer] + rx_delivered,
+                                           end - rx_delivered));
+  }
+  rx_delivered = end;
+}
+
+// Passes the rest of a completed receive buffer to the callback. In double
+// buffer mode, the DMA stream has already switched to the other buffer.
+void HandleRxDma() {
+  const uint32_t flags =
+      (dma2.low_interrupt_status >> kRxFlagsPos) & kDmaAllFlags;
+  dma2.low_interrupt_clear = flags << kRxFlagsPos;
+
+  if ((flags & kDmaTransferCompleteFlag) != 0u && rx_active) {
+    const size_t completed = (rx_dma.config & kDmaCurrentTarget) ? 0 : 1;
+    DeliverReceivedData(completed, rx_buffer_size);
+    rx_delivered = 0;
+  }
+}
+
 }  // namespace
 
+extern "C" void pw_sys_io_stm32f429_DmaTxHandler() {
+  const uint32_t flags =
+      (dma2.high_interrupt_status >> kTxFlagsPos) & kDmaAllFlags;
+  dma2.high_interrupt_clear = flags << kTxFlagsPos;
+
+  if (!tx_in_progress) {
+    return;
+  }
+
+  if ((flags & kDmaTransferErrorFlag) != 0u) {
+    FinishWrite(pw::StatusWithSize::Internal(tx_written));
+  } else if ((flags & kDmaTransferCompleteFlag) != 0u) {
+    tx_written += tx_chunk;
+    tx_next += tx_chunk;
+    tx_remaining -= tx_chunk;
+    if (tx_remaining == 0u) {
+      FinishWrite(pw::StatusWithSize(tx_written));
+    } else {
+      StartTxTransfer();
+    }
+  }
+}
+
+extern "C" void pw_sys_io_stm32f429_DmaRxHandler() { HandleRxDma(); }
+
+// The idle line interrupt passes partially filled buffers to the callback, so
+// short messages are handled without waiting for the buffer to fill.
+extern "C" void pw_sys_io_stm32f429_Usart1Handler() {
+  if ((usart1.status & kIdleLineDetected) == 0u) {
+    return;
+  }
+  // Reading the status register and then the data register clears the flag.
+  static_cast<void>(usart1.data_register);
+
+  if (!rx_active) {
+    return;
+  }
+
+  // Handle a pending buffer switch first so that the current target and count
+  // refer to the same buffer.
+  HandleRxDma();
+  const size_t current = (rx_dma.config & kDmaCurrentTarget) ? 1 : 0;
+  DeliverReceivedData(current, rx_buffer_size - rx_dma.data_count);
+}
+
 extern "C" void pw_sys_io_stm32f429_Init() {
   // Enable 'A' GIPO clocks.
   platform_rcc.ahb1_config |= kGpioAEnable;
@@ -157,6 +342,16 @@ extern "C" void pw_sys_io_stm32f429_Init() {
   usart1.baud_rate = CalcBaudRegister(kSystemCoreClock, /*target_baud=*/115200);
 
   usart1.config1 = kEnableUsart | kReceiveEnable | kTransmitEnable;
+
+  // Prepare DMA2 for asynchronous transfers. The streams are only enabled
+  // while a transfer is in progress.
+  platform_rcc.ahb1_config |= kDma2Enable;
+  tx_dma.peripheral_address = ToAddress(&usart1.data_register);
+  rx_dma.peripheral_address = ToAddress(&usart1.data_register);
+  usart1.config3 |= kDmaTransmitEnable;
+  EnableInterrupt(kDma2Stream7Irq);
+  EnableInterrupt(kDma2Stream2Irq);
+  EnableInterrupt(kUsart1Irq);
 }
 
 namespace pw::sys_io {
@@ -188,6 +383,10 @@ Status TryReadByte(std::byte* dest) {
 // ~87 micro seconds. This means it takes only 10 bytes to block the CPU for
 // 1ms!
 Status WriteByte(std::byte b) {
+  // Let any asynchronous write finish first.
+  while (tx_in_progress) {
+  }
+
   // Wait for TX buffer to be empty. When the buffer is empty, we can write
   // a value to be dumped out of UART.
   while (!(usart1.status & kTxRegisterEmpty)) {
@@ -212,4 +411,80 @@ StatusWithSize WriteLine(const std::string_view& s) {
   return StatusWithSize(result.status(), chars_written);
 }
 
+// Writes with DMA2 stream 7. The callback is called from the DMA interrupt.
+Status WriteBytesAsync(std::span<const std::byte> src,
+                       WriteCallback&& callback) {
+  if (tx_in_progress.exchange(true)) {
+    return Status::Unavailable();
+  }
+
+  if (src.empty()) {
+    tx_in_progress = false;
+    callback(StatusWithSize(0));
+    return OkStatus();
+  }
+
+  tx_callback = std::move(callback);
+  tx_next = src.data();
+  tx_remaining = src.size();
+  tx_written = 0;
+
+  // Wait for the last byte of any blocking write to move to the shift
+  // register, then hand the data register to the DMA stream.
+  while (!(usart1.status & kTxRegisterEmpty)) {
+  }
+  StartTxTransfer();
+  return OkStatus();
+}
+
+bool WriteAsyncInProgress() { return tx_in_progress; }
+
+// Receives with DMA2 stream 2 in double buffer mode, which switches between the
+// two buffers in hardware. Both buffers must be the same size, and no larger
+// than 65535 bytes.
+Status StartReadAsync(std::span<std::byte> first_buffer,
+                      std::span<std::byte> second_buffer,
+                      ReadCallback&& callback) {
+  if (first_buffer.empty() || first_buffer.size() != second_buffer.size() ||
+      first_buffer.size() > kMaxDmaTransfer) {
+    return Status::InvalidArgument();
+  }
+  if (rx_active) {
+    return Status::FailedPrecondition();
+  }
+
+  rx_buffers[0] = first_buffer.data();
+  rx_buffers[1] = second_buffer.data();
+  rx_buffer_size = first_buffer.size();
+  rx_delivered = 0;
+  rx_callback = std::move(callback);
+  rx_active = true;
+
+  dma2.low_interrupt_clear = kDmaAllFlags << kRxFlagsPos;
+  rx_dma.memory0_address = ToAddress(first_buffer.data());
+  rx_dma.memory1_address = ToAddress(second_buffer.data());
+  rx_dma.data_count = rx_buffer_size;
+  rx_dma.config = kDmaChannelUsart1 | kDmaDoubleBuffer | kDmaCircular |
+                  kDmaMemoryIncrement | kDmaTransferCompleteInterrupt |
+                  kDmaTransferErrorInterrupt | kDmaStreamEnable;
+
+  usart1.config3 |= kDmaReceiveEnable;
+  usart1.config1 |= kIdleInterruptEnable;
+  return OkStatus();
+}
+
+Status StopReadAsync() {
+  if (!rx_active) {
+    return Status::FailedPrecondition();
+  }
+
+  usart1.config1 &= ~kIdleInterruptEnable;
+  usart1.config3 &= ~kDmaReceiveEnable;
+  rx_dma.config &= ~kDmaStreamEnable;
+  while (rx_dma.config & kDmaStreamEnable) {
+  }
+  rx_active = false;
+  return OkStatus();
+}
+
 }  // namespace pw::sys_io
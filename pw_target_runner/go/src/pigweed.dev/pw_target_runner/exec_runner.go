@@ -38,6 +38,43 @@ func NewExecDeviceRunner(id int, command []string) *ExecDeviceRunner {
 	return &ExecDeviceRunner{command, logger}
 }
 
+// PreparingExecDeviceRunner is an ExecDeviceRunner that also runs a command to
+// prepare each executable before running it. Since it implements
+// PreparingDeviceRunner, the next executable is prepared while the current one
+// runs.
+type PreparingExecDeviceRunner struct {
+	ExecDeviceRunner
+	prepareCommand []string
+}
+
+// NewPreparingExecDeviceRunner creates a new PreparingExecDeviceRunner. Both
+// commands are run with the path of the executable as an argument.
+func NewPreparingExecDeviceRunner(
+	id int,
+	command []string,
+	prepareCommand []string,
+) *PreparingExecDeviceRunner {
+	return &PreparingExecDeviceRunner{
+		ExecDeviceRunner: *NewExecDeviceRunner(id, command),
+		prepareCommand:   prepareCommand,
+	}
+}
+
+// PrepareRunRequest runs the prepare command with the binary path as an
+// argument. Part of the PreparingDeviceRunner interface.
+func (r *PreparingExecDeviceRunner) PrepareRunRequest(req *RunRequest) error {
+	r.logger.Printf("Preparing executable %s\n", req.Path)
+
+	args := append([]string(nil), r.prepareCommand[1:]...)
+	args = append(args, req.Path)
+
+	output, err := exec.Command(r.prepareCommand[0], args...).CombinedOutput()
+	if err != nil {
+		return fmt.Errorf("prepare command failed: %v\n%s", err, output)
+	}
+	return nil
+}
+
 // WorkerStart starts the worker. Part of DeviceRunner interface.
 func (r *ExecDeviceRunner) WorkerStart() error {
 	r.logger.Printf("Starting worker")
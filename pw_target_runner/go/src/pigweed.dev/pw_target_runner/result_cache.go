@@ -0,0 +1,77 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+package pw_target_runner
+
+import (
+	"crypto/sha256"
+	"io"
+	"os"
+	"sync"
+
+	pb "pigweed.dev/proto/pw_target_runner/target_runner_pb"
+)
+
+// binaryHash identifies the contents of an executable.
+type binaryHash [sha256.Size]byte
+
+// hashBinary computes the hash of the executable at the given path.
+func hashBinary(path string) (binaryHash, error) {
+	var hash binaryHash
+
+	file, err := os.Open(path)
+	if err != nil {
+		return hash, err
+	}
+	defer file.Close()
+
+	hasher := sha256.New()
+	if _, err := io.Copy(hasher, file); err != nil {
+		return hash, err
+	}
+	copy(hash[:], hasher.Sum(nil))
+	return hash, nil
+}
+
+// resultCache stores the responses of executables that ran successfully, keyed
+// by the hash of the executable, so that unchanged executables are not run
+// again. Failures are not cached, since they may be flaky.
+type resultCache struct {
+	lock      sync.Mutex
+	responses map[binaryHash]*RunResponse
+}
+
+func newResultCache() *resultCache {
+	return &resultCache{responses: make(map[binaryHash]*RunResponse)}
+}
+
+// Get returns the cached response for an executable, if there is one.
+func (c *resultCache) Get(hash binaryHash) (*RunResponse, bool) {
+	c.lock.Lock()
+	defer c.lock.Unlock()
+
+	res, ok := c.responses[hash]
+	return res, ok
+}
+
+// Put caches a response if it is a success.
+func (c *resultCache) Put(hash binaryHash, res *RunResponse) {
+	if res.Err != nil || res.Status != pb.RunStatus_SUCCESS {
+		return
+	}
+
+	c.lock.Lock()
+	defer c.lock.Unlock()
+	c.responses[hash] = res
+}
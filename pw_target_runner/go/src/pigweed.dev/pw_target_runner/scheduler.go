@@ -0,0 +1,167 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+package pw_target_runner
+
+import (
+	"container/heap"
+	"sync"
+	"time"
+)
+
+// durationHistory records how long each executable took to run, so that the
+// longest running executables can be scheduled first.
+type durationHistory struct {
+	lock      sync.Mutex
+	durations map[string]time.Duration
+}
+
+func newDurationHistory() *durationHistory {
+	return &durationHistory{durations: make(map[string]time.Duration)}
+}
+
+// Record adds a run time for an executable. Run times are averaged with an
+// exponential moving average, so the estimate follows executables whose run
+// time changes.
+func (h *durationHistory) Record(path string, runTime time.Duration) {
+	h.lock.Lock()
+	defer h.lock.Unlock()
+
+	if previous, ok := h.durations[path]; ok {
+		runTime = (previous + runTime) / 2
+	}
+	h.durations[path] = runTime
+}
+
+// Estimate returns the expected run time of an executable, if it has run
+// before.
+func (h *durationHistory) Estimate(path string) (time.Duration, bool) {
+	h.lock.Lock()
+	defer h.lock.Unlock()
+
+	runTime, ok := h.durations[path]
+	return runTime, ok
+}
+
+// runQueue is a queue of run requests ordered longest expected run time first.
+// Scheduling the longest jobs first keeps a long job from starting last and
+// leaving the other workers idle while it finishes. Requests without a known
+// run time are treated as the longest, since nothing is known about them.
+// Requests with equal priority are dequeued in the order they were queued.
+type runQueue struct {
+	lock     sync.Mutex
+	cond     *sync.Cond
+	requests runRequestHeap
+	sequence uint64
+	stopping bool
+}
+
+func newRunQueue() *runQueue {
+	q := &runQueue{}
+	q.cond = sync.NewCond(&q.lock)
+	return q
+}
+
+// Push adds a request to the queue.
+func (q *runQueue) Push(req *RunRequest) {
+	q.lock.Lock()
+	defer q.lock.Unlock()
+
+	req.sequence = q.sequence
+	q.sequence++
+	heap.Push(&q.requests, req)
+	q.cond.Signal()
+}
+
+// Pop removes the highest priority request from the queue, blocking until one
+// is available. Returns nil if the queue is stopping.
+func (q *runQueue) Pop() *RunRequest {
+	q.lock.Lock()
+	defer q.lock.Unlock()
+
+	for len(q.requests) == 0 && !q.stopping {
+		q.cond.Wait()
+	}
+	if q.stopping {
+		return nil
+	}
+	return heap.Pop(&q.requests).(*RunRequest)
+}
+
+// TryPop removes the highest priority request from the queue if one is
+// available, without blocking.
+func (q *runQueue) TryPop() *RunRequest {
+	q.lock.Lock()
+	defer q.lock.Unlock()
+
+	if len(q.requests) == 0 || q.stopping {
+		return nil
+	}
+	return heap.Pop(&q.requests).(*RunRequest)
+}
+
+// Len returns the number of queued requests.
+func (q *runQueue) Len() int {
+	q.lock.Lock()
+	defer q.lock.Unlock()
+	return len(q.requests)
+}
+
+// SetStopping wakes all blocked Pop calls and makes them return nil while
+// stopping is true. Queued requests are kept.
+func (q *runQueue) SetStopping(stopping bool) {
+	q.lock.Lock()
+	defer q.lock.Unlock()
+
+	q.stopping = stopping
+	q.cond.Broadcast()
+}
+
+// Stopping returns true if the queue is stopping.
+func (q *runQueue) Stopping() bool {
+	q.lock.Lock()
+	defer q.lock.Unlock()
+	return q.stopping
+}
+
+// runRequestHeap implements heap.Interface for run requests.
+type runRequestHeap []*RunRequest
+
+func (h runRequestHeap) Len() int { return len(h) }
+
+func (h runRequestHeap) Less(i, j int) bool {
+	a, b := h[i], h[j]
+	if a.hasExpectedRunTime != b.hasExpectedRunTime {
+		return !a.hasExpectedRunTime
+	}
+	if a.expectedRunTime != b.expectedRunTime {
+		return a.expectedRunTime > b.expectedRunTime
+	}
+	return a.sequence < b.sequence
+}
+
+func (h runRequestHeap) Swap(i, j int) { h[i], h[j] = h[j], h[i] }
+
+func (h *runRequestHeap) Push(x interface{}) {
+	*h = append(*h, x.(*RunRequest))
+}
+
+func (h *runRequestHeap) Pop() interface{} {
+	old := *h
+	n := len(old)
+	req := old[n-1]
+	old[n-1] = nil
+	*h = old[:n-1]
+	return req
+}
@@ -22,6 +22,7 @@ import (
 	"fmt"
 	"log"
 	"net"
+	"sync/atomic"
 	"time"
 
 	"google.golang.org/grpc"
@@ -43,9 +44,11 @@ type Server struct {
 	listener    net.Listener
 	tasksPassed uint32
 	tasksFailed uint32
+	tasksCached uint32
 	startTime   time.Time
 	active      bool
 	workerPool  *WorkerPool
+	resultCache *resultCache
 }
 
 // NewServer creates a gRPC server with a registered TargetRunner service.
@@ -76,6 +79,17 @@ func (s *Server) RegisterWorker(worker DeviceRunner) {
 	s.workerPool.RegisterWorker(worker)
 }
 
+// SkipUnchangedBinaries enables or disables result caching. When enabled, an
+// executable with the same contents as one that already ran successfully is
+// not run again; the earlier response is returned instead.
+func (s *Server) SkipUnchangedBinaries(enable bool) {
+	if enable {
+		s.resultCache = newResultCache()
+	} else {
+		s.resultCache = nil
+	}
+}
+
 // RunBinary runs an executable through a worker in the server, returning
 // the worker's response. The function blocks until the executable has been
 // processed.
@@ -84,6 +98,24 @@ func (s *Server) RunBinary(path string) (*RunResponse, error) {
 		return nil, errServerNotRunning
 	}
 
+	var hash binaryHash
+	cache := s.resultCache
+	if cache != nil {
+		var err error
+		if hash, err = hashBinary(path); err != nil {
+			return nil, err
+		}
+		if cached, ok := cache.Get(hash); ok {
+			log.Printf("Skipping unchanged executable %s\n", path)
+			atomic.AddUint32(&s.tasksCached, 1)
+			return &RunResponse{
+				Output: cached.Output,
+				Status: cached.Status,
+				Cached: true,
+			}, nil
+		}
+	}
+
 	resChan := make(chan *RunResponse, 1)
 	defer close(resChan)
 
@@ -99,9 +131,13 @@ func (s *Server) RunBinary(path string) (*RunResponse, error) {
 	}
 
 	if res.Status == pb.RunStatus_SUCCESS {
-		s.tasksPassed++
+		atomic.AddUint32(&s.tasksPassed, 1)
 	} else {
-		s.tasksFailed++
+		atomic.AddUint32(&s.tasksFailed, 1)
+	}
+
+	if cache != nil {
+		cache.Put(hash, res)
 	}
 
 	return res, nil
@@ -145,6 +181,7 @@ func (s *pwTargetRunnerService) RunBinary(
 		QueueTimeNs: uint64(runRes.QueueTime),
 		RunTimeNs:   uint64(runRes.RunTime),
 		Output:      runRes.Output,
+		Cached:      runRes.Cached,
 	}
 	return res, nil
 }
@@ -156,8 +193,20 @@ func (s *pwTargetRunnerService) Status(
 ) (*pb.ServerStatus, error) {
 	resp := &pb.ServerStatus{
 		UptimeNs:    uint64(time.Since(s.server.startTime)),
-		TasksPassed: s.server.tasksPassed,
-		TasksFailed: s.server.tasksFailed,
+		TasksQueued: uint32(s.server.workerPool.QueueLength()),
+		TasksPassed: atomic.LoadUint32(&s.server.tasksPassed),
+		TasksFailed: atomic.LoadUint32(&s.server.tasksFailed),
+		TasksCached: atomic.LoadUint32(&s.server.tasksCached),
+	}
+
+	for _, stats := range s.server.workerPool.Stats() {
+		resp.Workers = append(resp.Workers, &pb.WorkerStatus{
+			Id:            uint32(stats.ID),
+			TasksRun:      stats.TasksRun,
+			RunTimeNs:     uint64(stats.RunTime),
+			PrepareTimeNs: uint64(stats.PrepareTime),
+			Utilization:   float32(stats.Utilization),
+		})
 	}
 
 	return resp, nil
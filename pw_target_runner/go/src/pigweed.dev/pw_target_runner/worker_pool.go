@@ -36,6 +36,14 @@ type RunRequest struct {
 
 	// Time when the request was queued. Internal to the worker pool.
 	queueStart time.Time
+
+	// Expected run time of the executable, based on previous runs. Internal
+	// to the worker pool.
+	expectedRunTime    time.Duration
+	hasExpectedRunTime bool
+
+	// Order in which the request was queued. Internal to the worker pool.
+	sequence uint64
 }
 
 // RunResponse is the response sent after a run request is processed.
@@ -48,12 +56,21 @@ type RunResponse struct {
 	// Set by the worker pool.
 	RunTime time.Duration
 
+	// Length of time spent preparing the executable to run, if the worker
+	// prepares executables. Set by the worker pool.
+	PrepareTime time.Duration
+
 	// Raw output of the execution.
 	Output []byte
 
 	// Result of the run.
 	Status pb.RunStatus
 
+	// True if the executable was not run because an identical executable
+	// already ran successfully. Status and Output are from the earlier run.
+	// Set by the server.
+	Cached bool
+
 	// Error that occurred during the run, if any. If this is not nil, none
 	// of the other fields in this struct are guaranteed to be valid.
 	Err error
@@ -76,16 +93,59 @@ type DeviceRunner interface {
 	WorkerExit()
 }
 
+// PreparingDeviceRunner is a DeviceRunner with a separate step to prepare an
+// executable before it runs, such as converting it to a flashable image. The
+// worker pool prepares a worker's next executable while its current one runs,
+// so preparation does not add to the time the device spends idle.
+type PreparingDeviceRunner interface {
+	DeviceRunner
+
+	// PrepareRunRequest is called before HandleRunRequest for each request,
+	// possibly while another request is being handled by HandleRunRequest.
+	// If it returns an error, the request fails without being run.
+	PrepareRunRequest(*RunRequest) error
+}
+
+// WorkerStats describes the work done by a worker since the pool started.
+type WorkerStats struct {
+	// Index of the worker in the order it was registered.
+	ID int
+
+	// Number of executables the worker ran.
+	TasksRun uint32
+
+	// Total time spent in HandleRunRequest.
+	RunTime time.Duration
+
+	// Total time spent in PrepareRunRequest.
+	PrepareTime time.Duration
+
+	// Fraction of the time since the pool started that the worker spent
+	// running executables.
+	Utilization float64
+}
+
+// workerState holds per-worker statistics, protected by the pool's statsLock.
+type workerState struct {
+	tasksRun    uint32
+	runTime     time.Duration
+	prepareTime time.Duration
+}
+
 // WorkerPool represents a collection of device runners which run on-device
 // binaries. The worker pool distributes requests to run binaries among its
-// available workers.
+// available workers, running those that took the longest in previous runs
+// first.
 type WorkerPool struct {
 	activeWorkers uint32
 	logger        *log.Logger
 	workers       []DeviceRunner
 	waitGroup     sync.WaitGroup
-	reqChannel    chan *RunRequest
-	quitChannel   chan bool
+	queue         *runQueue
+	history       *durationHistory
+	startTime     time.Time
+	statsLock     sync.Mutex
+	workerStates  []workerState
 }
 
 var (
@@ -97,10 +157,10 @@ var (
 func newWorkerPool(name string) *WorkerPool {
 	logPrefix := fmt.Sprintf("[%s] ", name)
 	return &WorkerPool{
-		logger:      log.New(os.Stdout, logPrefix, log.LstdFlags),
-		workers:     make([]DeviceRunner, 0),
-		reqChannel:  make(chan *RunRequest, 1024),
-		quitChannel: make(chan bool, 64),
+		logger:  log.New(os.Stdout, logPrefix, log.LstdFlags),
+		workers: make([]DeviceRunner, 0),
+		queue:   newRunQueue(),
+		history: newDurationHistory(),
 	}
 }
 
@@ -121,10 +181,13 @@ func (p *WorkerPool) Start() error {
 	}
 
 	p.logger.Printf("Starting %d workers\n", len(p.workers))
-	for _, worker := range p.workers {
+	p.queue.SetStopping(false)
+	p.startTime = time.Now()
+	p.workerStates = make([]workerState, len(p.workers))
+	for id, worker := range p.workers {
 		p.waitGroup.Add(1)
 		atomic.AddUint32(&p.activeWorkers, 1)
-		go p.runWorker(worker)
+		go p.runWorker(id, worker)
 	}
 
 	return nil
@@ -138,13 +201,16 @@ func (p *WorkerPool) Stop() {
 		return
 	}
 
-	// Send N quit commands to the workers and wait for them to exit.
-	for i := uint32(0); i < p.activeWorkers; i++ {
-		p.quitChannel <- true
-	}
+	// Wake the workers and wait for them to exit.
+	p.queue.SetStopping(true)
 	p.waitGroup.Wait()
 
 	p.logger.Println("All workers in pool stopped")
+	for _, stats := range p.Stats() {
+		p.logger.Printf(
+			"Worker %d ran %d executables in %v (%.0f%% utilization)\n",
+			stats.ID, stats.TasksRun, stats.RunTime, stats.Utilization*100)
+	}
 }
 
 // Active returns true if any worker routines are currently running.
@@ -168,14 +234,65 @@ func (p *WorkerPool) QueueExecutable(req *RunRequest) {
 
 	// Start tracking how long the request is queued.
 	req.queueStart = time.Now()
-	p.reqChannel <- req
+	req.expectedRunTime, req.hasExpectedRunTime = p.history.Estimate(req.Path)
+	p.queue.Push(req)
+}
+
+// QueueLength returns the number of requests waiting for a worker.
+func (p *WorkerPool) QueueLength() int {
+	return p.queue.Len()
+}
+
+// Stats returns statistics for each worker since the pool was last started.
+func (p *WorkerPool) Stats() []WorkerStats {
+	p.statsLock.Lock()
+	defer p.statsLock.Unlock()
+
+	elapsed := time.Since(p.startTime)
+	stats := make([]WorkerStats, len(p.workerStates))
+	for id, state := range p.workerStates {
+		stats[id] = WorkerStats{
+			ID:          id,
+			TasksRun:    state.tasksRun,
+			RunTime:     state.runTime,
+			PrepareTime: state.prepareTime,
+		}
+		if elapsed > 0 {
+			stats[id].Utilization =
+				float64(state.runTime) / float64(elapsed)
+		}
+	}
+	return stats
+}
+
+// preparedRequest is a request whose executable is being prepared to run.
+type preparedRequest struct {
+	req  *RunRequest
+	done chan error
+	time time.Duration
+}
+
+// prepare starts preparing a request in a separate goroutine.
+func prepare(worker PreparingDeviceRunner, req *RunRequest) *preparedRequest {
+	prepared := &preparedRequest{req: req, done: make(chan error, 1)}
+	go func() {
+		start := time.Now()
+		err := worker.PrepareRunRequest(req)
+		prepared.time = time.Since(start)
+		prepared.done <- err
+	}()
+	return prepared
 }
 
 // runWorker is a function run by the worker pool in a separate goroutine for
 // each of its registered workers. The function is responsible for calling the
 // appropriate worker lifecycle hooks and processing requests as they come in
 // through the worker pool's queue.
-func (p *WorkerPool) runWorker(worker DeviceRunner) {
+//
+// If the worker is a PreparingDeviceRunner, the worker takes its next request
+// from the queue when it starts running a request and prepares it in the
+// background, so the next executable is ready as soon as the device is free.
+func (p *WorkerPool) runWorker(id int, worker DeviceRunner) {
 	defer func() {
 		atomic.AddUint32(&p.activeWorkers, ^uint32(0))
 		p.waitGroup.Done()
@@ -185,40 +302,79 @@ func (p *WorkerPool) runWorker(worker DeviceRunner) {
 		return
 	}
 
-processLoop:
+	preparer, canPrepare := worker.(PreparingDeviceRunner)
+	var next *preparedRequest
+
 	for {
-		// Force the quit channel to be processed before the request
-		// channel by using a select statement with an empty default
-		// case to make the read non-blocking. If the quit channel is
-		// empty, the code will fall through to the main select below.
-		select {
-		case q, ok := <-p.quitChannel:
-			if q || !ok {
-				break processLoop
+		var current *preparedRequest
+		if next != nil {
+			if p.queue.Stopping() {
+				break
 			}
-		default:
-		}
-
-		select {
-		case q, ok := <-p.quitChannel:
-			if q || !ok {
-				break processLoop
+			current, next = next, nil
+		} else {
+			req := p.queue.Pop()
+			if req == nil {
+				break
 			}
-		case req, ok := <-p.reqChannel:
-			if !ok {
-				continue
+			if canPrepare {
+				current = prepare(preparer, req)
+			} else {
+				current = &preparedRequest{req: req}
 			}
+		}
 
-			queueTime := time.Since(req.queueStart)
+		req := current.req
+		queueTime := time.Since(req.queueStart)
 
+		var prepareErr error
+		if current.done != nil {
+			prepareErr = <-current.done
+			// Prepare the next request while this one runs.
+			if nextReq := p.queue.TryPop(); nextReq != nil {
+				next = prepare(preparer, nextReq)
+			}
+		}
+
+		var res *RunResponse
+		if prepareErr != nil {
+			p.logger.Printf("Failed to prepare %s: %v\n", req.Path, prepareErr)
+			res = &RunResponse{
+				Status: pb.RunStatus_FAILURE,
+				Output: []byte(prepareErr.Error()),
+			}
+		} else {
 			runStart := time.Now()
-			res := worker.HandleRunRequest(req)
+			res = worker.HandleRunRequest(req)
 			res.RunTime = time.Since(runStart)
 
-			res.QueueTime = queueTime
-			req.ResponseChannel <- res
+			if res.Err == nil {
+				p.history.Record(req.Path, res.RunTime)
+			}
 		}
+
+		res.QueueTime = queueTime
+		res.PrepareTime = current.time
+		p.recordStats(id, res)
+		req.ResponseChannel <- res
+	}
+
+	// Return a request that was prepared but not run to the queue, so it
+	// runs when the pool is restarted.
+	if next != nil {
+		<-next.done
+		p.queue.Push(next.req)
 	}
 
 	worker.WorkerExit()
 }
+
+func (p *WorkerPool) recordStats(id int, res *RunResponse) {
+	p.statsLock.Lock()
+	defer p.statsLock.Unlock()
+
+	state := &p.workerStates[id]
+	state.tasksRun++
+	state.runTime += res.RunTime
+	state.prepareTime += res.PrepareTime
+}
@@ -66,11 +66,15 @@ func (c *Client) RunBinary(path string) error {
 	}
 
 	fmt.Printf("%s\n", path)
-	fmt.Printf(
-		"Queued for %v, ran in %v\n\n",
-		time.Duration(res.QueueTimeNs),
-		time.Duration(res.RunTimeNs),
-	)
+	if res.Cached {
+		fmt.Printf("Unchanged since it last passed; not run\n\n")
+	} else {
+		fmt.Printf(
+			"Queued for %v, ran in %v\n\n",
+			time.Duration(res.QueueTimeNs),
+			time.Duration(res.RunTimeNs),
+		)
+	}
 	fmt.Println(string(res.Output))
 
 	if res.Result != pb.RunStatus_SUCCESS {
@@ -51,6 +51,11 @@ func configureServerFromFile(s *pw_target_runner.Server, filepath string) error
 
 	log.Printf("Parsed server configuration from %s\n", filepath)
 
+	if config.GetSkipUnchangedBinaries() {
+		log.Println("Skipping binaries that are unchanged since they passed")
+		s.SkipUnchangedBinaries(true)
+	}
+
 	runners := config.GetRunner()
 	if runners == nil {
 		return nil
@@ -73,6 +78,24 @@ func configureServerFromFile(s *pw_target_runner.Server, filepath string) error
 			cmd = append(cmd, args...)
 		}
 
+		// Runners with a prepare command prepare the next binary while
+		// the current one runs.
+		if prepareCmd := runner.GetPrepareCommand(); prepareCmd != "" {
+			prepare := append(
+				[]string{prepareCmd}, runner.GetPrepareArgs()...)
+			s.RegisterWorker(
+				pw_target_runner.NewPreparingExecDeviceRunner(i, cmd, prepare))
+
+			log.Printf(
+				"Registered PreparingExecDeviceRunner %s with args %v, "+
+					"prepared by %s with args %v\n",
+				cmd[0],
+				cmd[1:],
+				prepare[0],
+				prepare[1:])
+			continue
+		}
+
 		worker := pw_target_runner.NewExecDeviceRunner(i, cmd)
 		s.RegisterWorker(worker)
 
@@ -0,0 +1,128 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include "pw_thread/id.h"
+
+namespace pw::thread::internal {
+
+// Storage for up to kMaxThreads instances of T, which threads claim and release
+// without locking. ThreadLocal backends build on this when the RTOS cannot
+// allocate per-thread storage.
+//
+// Instances which are still claimed when the pool is destroyed are not
+// destroyed.
+template <typename T, size_t kMaxThreads>
+class ThreadLocalPool {
+ public:
+  static constexpr size_t kNone = kMaxThreads;
+
+  constexpr ThreadLocalPool() = default;
+
+  // Claims an unused slot and default constructs a T in it. Returns the slot's
+  // index, or kNone if every slot is in use.
+  size_t Claim() {
+    for (size_t i = 0; i < kMaxThreads; ++i) {
+      bool in_use = false;
+      if (in_use_[i].compare_exchange_strong(in_use,
+                                             true,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+        new (&slots_[i]) T();
+        return i;
+      }
+    }
+    return kNone;
+  }
+
+  // Destroys the instance in a claimed slot and makes the slot available.
+  void Release(size_t index) {
+    (*this)[index].~T();
+    in_use_[index].store(false, std::memory_order_release);
+  }
+
+  T& operator[](size_t index) {
+    return *std::launder(reinterpret_cast<T*>(&slots_[index]));
+  }
+
+  // Returns the index of the slot which holds an instance from this pool.
+  size_t IndexOf(const T* instance) const {
+    return static_cast<size_t>(reinterpret_cast<const Slot*>(instance) -
+                               slots_.data());
+  }
+
+ private:
+  struct Slot {
+    alignas(T) std::byte bytes[sizeof(T)];
+  };
+
+  std::array<std::atomic<bool>, kMaxThreads> in_use_ = {};
+  std::array<Slot, kMaxThreads> slots_ = {};
+};
+
+// A ThreadLocal implementation for RTOSes without thread-local storage
+// pointers. Each slot of a ThreadLocalPool records the ID of the thread which
+// claimed it, and get() finds the calling thread's slot by ID.
+//
+// Lookups are a linear scan of the slots, so keep kMaxThreads small.
+template <typename T, size_t kMaxThreads>
+class ThreadLocalById {
+ public:
+  constexpr ThreadLocalById() = default;
+
+  T* get() {
+    const Id id = this_thread::get_id();
+    for (size_t i = 0; i < kMaxThreads; ++i) {
+      if (owners_[i].load(std::memory_order_acquire) == id) {
+        return &pool_[i];
+      }
+    }
+
+    const size_t index = pool_.Claim();
+    if (index == pool_.kNone) {
+      return nullptr;
+    }
+    owners_[index].store(id, std::memory_order_release);
+    return &pool_[index];
+  }
+
+  void release() {
+    const Id id = this_thread::get_id();
+    for (size_t i = 0; i < kMaxThreads; ++i) {
+      if (owners_[i].load(std::memory_order_relaxed) == id) {
+        owners_[i].store(Id(), std::memory_order_relaxed);
+        pool_.Release(i);
+        return;
+      }
+    }
+  }
+
+ private:
+  static_assert(std::is_trivially_copyable_v<Id>,
+                "ThreadLocalById requires a trivially copyable thread::Id");
+
+  ThreadLocalPool<T, kMaxThreads> pool_;
+
+  // Zero initialized, which is the default Id that represents no thread for
+  // the handle-based IDs of the RTOSes which use this.
+  std::array<std::atomic<Id>, kMaxThreads> owners_ = {};
+};
+
+}  // namespace pw::thread::internal
@@ -0,0 +1,75 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_thread_backend/thread_local_native.h"
+
+namespace pw::thread {
+
+// The default number of threads which may hold an instance of a ThreadLocal at
+// the same time, on backends which reserve storage for a fixed number.
+inline constexpr size_t kDefaultThreadLocalMaxThreads = 8;
+
+// ThreadLocal gives each thread which uses it its own instance of T, so
+// per-thread caches and scratch buffers need neither a lock nor space on every
+// thread's stack. A thread's instance is default constructed the first time it
+// calls get(), and is destroyed by release().
+//
+//   pw::thread::ThreadLocal<std::array<std::byte, 256>> encode_buffer;
+//
+//   void EncodeSample(const Sample& sample) {
+//     auto* buffer = encode_buffer.get();
+//     ...
+//   }
+//
+// Depending on the backend, storage for up to kMaxThreads instances is
+// reserved in the ThreadLocal itself, or instances are allocated as needed.
+// With reserved storage, a thread must call release() before it exits, or its
+// instance stays claimed. Backends which allocate destroy a thread's instances
+// when it exits.
+//
+// A ThreadLocal must outlive every thread which uses it, so declare it with
+// static storage duration.
+template <typename T, size_t kMaxThreads = kDefaultThreadLocalMaxThreads>
+class ThreadLocal {
+ public:
+  static_assert(kMaxThreads > 0, "A ThreadLocal must allow at least 1 thread");
+
+  constexpr ThreadLocal() = default;
+
+  ThreadLocal(const ThreadLocal&) = delete;
+  ThreadLocal(ThreadLocal&&) = delete;
+  ThreadLocal& operator=(const ThreadLocal&) = delete;
+  ThreadLocal& operator=(ThreadLocal&&) = delete;
+
+  // Returns the calling thread's instance of T, default constructing it if
+  // this thread does not have one yet. Returns nullptr if the backend reserves
+  // storage and kMaxThreads other threads already hold instances.
+  //
+  // This is thread safe, but NOT IRQ safe.
+  T* get() { return native_.get(); }
+
+  // Destroys the calling thread's instance of T, if it has one, so its storage
+  // can be used by another thread.
+  //
+  // This is thread safe, but NOT IRQ safe.
+  void release() { native_.release(); }
+
+ private:
+  backend::NativeThreadLocal<T, kMaxThreads> native_;
+};
+
+}  // namespace pw::thread
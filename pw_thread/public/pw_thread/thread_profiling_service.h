@@ -0,0 +1,101 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_status/status.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/thread_usage.h"
+#include "pw_thread_protos/thread_profiling_service.raw_rpc.pb.h"
+
+namespace pw::thread {
+
+// Streams the CPU and stack usage of every thread to a client over RPC.
+//
+// The service does not sample on its own. Call Sample() periodically, e.g.
+// from a work queue or a timer, to measure every thread with the backend's
+// ThreadUsageSampler and send the result to the listening client as a
+// pw.thread.SnapshotThreadInfo. CPU usage is the share of the run time of all
+// threads since the previous Sample() call, so include the idle thread.
+//
+// The service keeps a Record for each thread between samples; threads beyond
+// the number of records are not reported. The record of an exited thread is
+// freed at the end of the sample that no longer sees it, so provide a spare
+// record if threads are created and destroyed at runtime.
+class ThreadProfilingService final
+    : public pw_rpc::raw::ThreadProfiling::Service<ThreadProfilingService> {
+ public:
+  // Thread names longer than this are truncated.
+  static constexpr size_t kMaxNameLength = 32;
+
+  class Record {
+   private:
+    friend class ThreadProfilingService;
+
+    // The name is copied, since a thread may be deleted while it is encoded.
+    std::array<char, kMaxNameLength> name;
+    size_t name_length;
+    uintptr_t id;
+    uintptr_t stack_low_addr;
+    uintptr_t stack_high_addr;
+    std::optional<uintptr_t> stack_pointer_est_peak;
+    uint64_t previous_run_time;
+    uint64_t run_time_delta;
+    bool seen;
+  };
+
+  ThreadProfilingService(ThreadUsageSampler sampler, std::span<Record> records)
+      : sampler_(sampler), records_(records), record_count_(0) {}
+
+  // Starts streaming samples to the client. Only one client listens at a
+  // time; a new call replaces the previous one.
+  void Listen(rpc::ServerContext&,
+              ConstByteSpan,
+              rpc::RawServerWriter& writer)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Samples every thread and sends the result to the listening client.
+  //
+  // Returns:
+  //   OK - the sample was sent.
+  //   FAILED_PRECONDITION - no client is listening. The sample still becomes
+  //       the baseline for the next call.
+  //   RESOURCE_EXHAUSTED - the sample does not fit in an RPC packet.
+  //   Any error from the sampler or from sending the packet.
+  Status Sample() PW_LOCKS_EXCLUDED(lock_);
+
+ private:
+  // Records a thread reported by the sampler.
+  void Update(const ThreadUsageSample& sample)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  Status Send(uint64_t total_run_time_delta)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  const ThreadUsageSampler sampler_;
+  const std::span<Record> records_;
+
+  sync::Mutex lock_;
+  size_t record_count_ PW_GUARDED_BY(lock_);
+  rpc::RawServerWriter writer_ PW_GUARDED_BY(lock_);
+};
+
+}  // namespace pw::thread
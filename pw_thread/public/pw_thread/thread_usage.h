@@ -0,0 +1,52 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "pw_function/function.h"
+#include "pw_status/status.h"
+
+namespace pw::thread {
+
+// A measurement of one thread's CPU and stack usage, as reported by an RTOS
+// backend. See pw::thread::freertos::SampleThreadUsage and
+// pw::thread::threadx::SampleThreadUsage.
+struct ThreadUsageSample {
+  std::string_view name;
+
+  // Identifies the thread across samples, e.g. the address of its TCB.
+  uintptr_t id;
+
+  // The total time the thread has run for, in backend-defined units. Only the
+  // difference between two samples is meaningful.
+  uint64_t run_time;
+
+  // The bounds of the thread's stack, or 0 if they are not known.
+  uintptr_t stack_low_addr;
+  uintptr_t stack_high_addr;
+
+  // The deepest address the thread's stack is estimated to have reached.
+  std::optional<uintptr_t> stack_pointer_est_peak;
+};
+
+using ThreadUsageCallback = Function<void(const ThreadUsageSample&)>;
+
+// Invokes the callback once for every thread. Backends provide a function of
+// this type.
+using ThreadUsageSampler = Status (*)(const ThreadUsageCallback& callback);
+
+}  // namespace pw::thread
@@ -15,7 +15,7 @@
 
 from typing import Optional, List, Mapping
 import pw_tokenizer
-from pw_symbolizer import LlvmSymbolizer
+from pw_symbolizer import LlvmSymbolizer, Symbolizer
 from pw_tokenizer import proto as proto_detokenizer
 from pw_thread_protos import thread_pb2
 
@@ -33,7 +33,7 @@ THREAD_STATE_TO_STRING: Mapping[int, str] = {
 def process_snapshot(
     serialized_snapshot: bytes,
     tokenizer_db: Optional[pw_tokenizer.Detokenizer],
-    symbolizer: LlvmSymbolizer = LlvmSymbolizer()
+    symbolizer: Symbolizer = LlvmSymbolizer()
 ) -> str:
     """Processes snapshot threads, producing a multi-line string."""
     captured_threads = thread_pb2.SnapshotThreadInfo()
@@ -175,7 +175,7 @@ class ThreadSnapshotAnalyzer:
     def __init__(self,
                  threads: thread_pb2.SnapshotThreadInfo,
                  tokenizer_db: Optional[pw_tokenizer.Detokenizer] = None,
-                 symbolizer: LlvmSymbolizer = LlvmSymbolizer()):
+                 symbolizer: Symbolizer = LlvmSymbolizer()):
         self._threads = threads.threads
         self._tokenizer_db = (tokenizer_db if tokenizer_db is not None else
                               pw_tokenizer.Detokenizer(None))
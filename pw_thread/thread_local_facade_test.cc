@@ -0,0 +1,98 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "gtest/gtest.h"
+#include "pw_thread/thread_local.h"
+
+namespace pw::thread {
+namespace {
+
+// TODO(pwbug/291): Test instances on multiple threads once thread creation can
+// be used in facade tests.
+
+struct Counter {
+  Counter() { constructed += 1; }
+  ~Counter() { destroyed += 1; }
+
+  int value = 0;
+
+  static inline int constructed = 0;
+  static inline int destroyed = 0;
+};
+
+class ThreadLocalTest : public ::testing::Test {
+ protected:
+  ThreadLocalTest() {
+    Counter::constructed = 0;
+    Counter::destroyed = 0;
+  }
+};
+
+TEST_F(ThreadLocalTest, Get_ConstructsOnFirstUse) {
+  ThreadLocal<Counter> counter;
+  EXPECT_EQ(0, Counter::constructed);
+
+  Counter* instance = counter.get();
+  ASSERT_NE(instance, nullptr);
+  EXPECT_EQ(1, Counter::constructed);
+  EXPECT_EQ(0, instance->value);
+
+  counter.release();
+}
+
+TEST_F(ThreadLocalTest, Get_ReturnsSameInstance) {
+  ThreadLocal<Counter> counter;
+  counter.get()->value = 42;
+
+  EXPECT_EQ(counter.get(), counter.get());
+  EXPECT_EQ(42, counter.get()->value);
+  EXPECT_EQ(1, Counter::constructed);
+
+  counter.release();
+}
+
+TEST_F(ThreadLocalTest, Release_DestroysInstance) {
+  ThreadLocal<Counter> counter;
+  counter.get()->value = 42;
+  counter.release();
+  EXPECT_EQ(1, Counter::destroyed);
+
+  EXPECT_EQ(0, counter.get()->value);
+  EXPECT_EQ(2, Counter::constructed);
+
+  counter.release();
+}
+
+TEST_F(ThreadLocalTest, Release_WithoutInstance_DoesNothing) {
+  ThreadLocal<Counter> counter;
+  counter.release();
+  EXPECT_EQ(0, Counter::destroyed);
+}
+
+TEST_F(ThreadLocalTest, SeparateThreadLocals_HaveSeparateInstances) {
+  ThreadLocal<Counter, 1> first;
+  ThreadLocal<Counter, 1> second;
+  first.get()->value = 1;
+  second.get()->value = 2;
+
+  EXPECT_NE(first.get(), second.get());
+  EXPECT_EQ(1, first.get()->value);
+  EXPECT_EQ(2, second.get()->value);
+
+  first.release();
+  second.release();
+}
+
+}  // namespace
+}  // namespace pw::thread
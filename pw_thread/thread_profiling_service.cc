@@ -0,0 +1,132 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_profiling_service.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include "pw_protobuf/encoder.h"
+#include "pw_thread_protos/thread.pwpb.h"
+
+namespace pw::thread {
+
+void ThreadProfilingService::Listen(rpc::ServerContext&,
+                                    ConstByteSpan,
+                                    rpc::RawServerWriter& writer) {
+  std::lock_guard lock(lock_);
+  writer_ = std::move(writer);
+}
+
+Status ThreadProfilingService::Sample() {
+  std::lock_guard lock(lock_);
+  for (size_t i = 0; i < record_count_; ++i) {
+    records_[i].seen = false;
+  }
+
+  const ThreadUsageCallback update(
+      [this](const ThreadUsageSample& sample) PW_NO_LOCK_SAFETY_ANALYSIS {
+        Update(sample);
+      });
+  const Status status = sampler_(update);
+
+  // Drop the records of threads which no longer exist.
+  size_t kept = 0;
+  uint64_t total_run_time_delta = 0;
+  for (size_t i = 0; i < record_count_; ++i) {
+    if (records_[i].seen) {
+      total_run_time_delta += records_[i].run_time_delta;
+      records_[kept++] = records_[i];
+    }
+  }
+  record_count_ = kept;
+
+  if (!status.ok()) {
+    return status;
+  }
+  return Send(total_run_time_delta);
+}
+
+void ThreadProfilingService::Update(const ThreadUsageSample& sample) {
+  Record* record = nullptr;
+  for (size_t i = 0; i < record_count_; ++i) {
+    if (records_[i].id == sample.id) {
+      record = &records_[i];
+      break;
+    }
+  }
+
+  if (record == nullptr) {
+    if (record_count_ == records_.size()) {
+      return;  // Out of records; this thread is not reported.
+    }
+    // A new thread has no baseline, so its usage starts at the next sample.
+    record = &records_[record_count_++];
+    record->id = sample.id;
+    record->previous_run_time = sample.run_time;
+  }
+
+  // A run time smaller than the previous one means that the backend's counter
+  // wrapped, which is assumed to be at 32 bits.
+  const uint64_t elapsed = sample.run_time - record->previous_run_time;
+  record->run_time_delta = sample.run_time >= record->previous_run_time
+                               ? elapsed
+                               : static_cast<uint32_t>(elapsed);
+  record->previous_run_time = sample.run_time;
+
+  record->name_length = std::min(sample.name.size(), kMaxNameLength);
+  std::memcpy(record->name.data(), sample.name.data(), record->name_length);
+  record->stack_low_addr = sample.stack_low_addr;
+  record->stack_high_addr = sample.stack_high_addr;
+  record->stack_pointer_est_peak = sample.stack_pointer_est_peak;
+  record->seen = true;
+}
+
+Status ThreadProfilingService::Send(uint64_t total_run_time_delta) {
+  if (!writer_.active()) {
+    return Status::FailedPrecondition();
+  }
+
+  const ByteSpan buffer = writer_.PayloadBuffer();
+  SnapshotThreadInfo::MemoryEncoder encoder(buffer);
+  for (size_t i = 0; i < record_count_; ++i) {
+    const Record& record = records_[i];
+    Thread::StreamEncoder thread = encoder.GetThreadsEncoder();
+    thread.WriteName(
+        std::as_bytes(std::span(record.name.data(), record.name_length)));
+    thread.WriteCpuUsageHundredths(
+        total_run_time_delta == 0u
+            ? 0u
+            : static_cast<uint32_t>(record.run_time_delta * 10000u /
+                                    total_run_time_delta));
+
+    // Stacks are assumed to descend, as in pw::thread::SnapshotStack().
+    if (record.stack_high_addr != 0u) {
+      thread.WriteStackStartPointer(record.stack_high_addr);
+      thread.WriteStackEndPointer(record.stack_low_addr);
+    }
+    if (record.stack_pointer_est_peak.has_value()) {
+      thread.WriteStackPointerEstPeak(record.stack_pointer_est_peak.value());
+    }
+  }
+
+  if (!encoder.status().ok()) {
+    writer_.ReleaseBuffer();
+    return Status::ResourceExhausted();
+  }
+  return writer_.Write(ConstByteSpan(encoder.data(), encoder.size()));
+}
+
+}  // namespace pw::thread
@@ -0,0 +1,199 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_profiling_service.h"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_rpc/raw/test_method_context.h"
+
+namespace pw::thread {
+namespace {
+
+// Field numbers from thread.proto.
+constexpr uint32_t kSnapshotThreads = 18;
+constexpr uint32_t kThreadName = 1;
+constexpr uint32_t kThreadStackStartPointer = 7;
+constexpr uint32_t kThreadCpuUsageHundredths = 10;
+constexpr uint32_t kThreadStackPointerEstPeak = 11;
+
+struct DecodedThread {
+  std::string_view name;
+  uint32_t cpu_usage_hundredths = 0;
+  uint64_t stack_start_pointer = 0;
+  uint64_t stack_pointer_est_peak = 0;
+};
+
+std::array<ThreadUsageSample, 4> fake_threads;
+size_t fake_thread_count;
+
+Status SampleFakeThreads(const ThreadUsageCallback& callback) {
+  for (size_t i = 0; i < fake_thread_count; ++i) {
+    callback(fake_threads[i]);
+  }
+  return OkStatus();
+}
+
+template <size_t kMaxThreads>
+std::array<DecodedThread, kMaxThreads> Decode(ConstByteSpan response,
+                                              size_t& count) {
+  std::array<DecodedThread, kMaxThreads> threads;
+  count = 0;
+  protobuf::Decoder snapshot(response);
+  while (snapshot.Next().ok()) {
+    EXPECT_EQ(kSnapshotThreads, snapshot.FieldNumber());
+    ConstByteSpan thread_bytes;
+    EXPECT_EQ(OkStatus(), snapshot.ReadBytes(&thread_bytes));
+
+    DecodedThread& thread = threads[count++];
+    protobuf::Decoder decoder(thread_bytes);
+    while (decoder.Next().ok()) {
+      switch (decoder.FieldNumber()) {
+        case kThreadName:
+          EXPECT_EQ(OkStatus(), decoder.ReadString(&thread.name));
+          break;
+        case kThreadStackStartPointer:
+          EXPECT_EQ(OkStatus(),
+                    decoder.ReadUint64(&thread.stack_start_pointer));
+          break;
+        case kThreadCpuUsageHundredths:
+          EXPECT_EQ(OkStatus(),
+                    decoder.ReadUint32(&thread.cpu_usage_hundredths));
+          break;
+        case kThreadStackPointerEstPeak:
+          EXPECT_EQ(OkStatus(),
+                    decoder.ReadUint64(&thread.stack_pointer_est_peak));
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  return threads;
+}
+
+class ThreadProfilingServiceTest : public ::testing::Test {
+ protected:
+  ThreadProfilingServiceTest() {
+    fake_threads[0] = {.name = "idle",
+                       .id = 1,
+                       .run_time = 100,
+                       .stack_low_addr = 0x1000,
+                       .stack_high_addr = 0x2000,
+                       .stack_pointer_est_peak = 0x1800};
+    fake_threads[1] = {.name = "rpc",
+                       .id = 2,
+                       .run_time = 50,
+                       .stack_low_addr = 0,
+                       .stack_high_addr = 0,
+                       .stack_pointer_est_peak = std::nullopt};
+    fake_thread_count = 2;
+  }
+
+  std::array<ThreadProfilingService::Record, 3> records_;
+};
+
+TEST_F(ThreadProfilingServiceTest, Sample_NotListening_FailedPrecondition) {
+  ThreadProfilingService service(SampleFakeThreads, records_);
+  EXPECT_EQ(Status::FailedPrecondition(), service.Sample());
+}
+
+TEST_F(ThreadProfilingServiceTest, Sample_ReportsUsageSincePreviousSample) {
+  PW_RAW_TEST_METHOD_CONTEXT(ThreadProfilingService, Listen)
+  ctx(SampleFakeThreads, records_);
+  ctx.call({});
+
+  // The first sample is the baseline.
+  ASSERT_EQ(OkStatus(), ctx.service().Sample());
+
+  fake_threads[0].run_time += 75;
+  fake_threads[1].run_time += 25;
+  ASSERT_EQ(OkStatus(), ctx.service().Sample());
+  ASSERT_EQ(2u, ctx.responses().size());
+
+  size_t count;
+  auto threads = Decode<2>(ctx.responses()[0], count);
+  ASSERT_EQ(2u, count);
+  EXPECT_EQ(0u, threads[0].cpu_usage_hundredths);
+
+  threads = Decode<2>(ctx.responses()[1], count);
+  ASSERT_EQ(2u, count);
+  EXPECT_EQ("idle", threads[0].name);
+  EXPECT_EQ(7500u, threads[0].cpu_usage_hundredths);
+  EXPECT_EQ(0x2000u, threads[0].stack_start_pointer);
+  EXPECT_EQ(0x1800u, threads[0].stack_pointer_est_peak);
+  EXPECT_EQ("rpc", threads[1].name);
+  EXPECT_EQ(2500u, threads[1].cpu_usage_hundredths);
+  EXPECT_EQ(0u, threads[1].stack_start_pointer);
+}
+
+TEST_F(ThreadProfilingServiceTest, Sample_RunTimeWrapped) {
+  fake_threads[1].run_time = 0xffffffc0;
+  PW_RAW_TEST_METHOD_CONTEXT(ThreadProfilingService, Listen)
+  ctx(SampleFakeThreads, records_);
+  ctx.call({});
+  ASSERT_EQ(OkStatus(), ctx.service().Sample());
+
+  fake_threads[0].run_time += 0x40;
+  fake_threads[1].run_time = 0x40;  // 0x80 after wrapping.
+  ASSERT_EQ(OkStatus(), ctx.service().Sample());
+
+  size_t count;
+  const auto threads = Decode<2>(ctx.responses()[1], count);
+  ASSERT_EQ(2u, count);
+  EXPECT_EQ(3333u, threads[0].cpu_usage_hundredths);
+  EXPECT_EQ(6666u, threads[1].cpu_usage_hundredths);
+}
+
+TEST_F(ThreadProfilingServiceTest, Sample_TracksThreadsAsTheyComeAndGo) {
+  PW_RAW_TEST_METHOD_CONTEXT(ThreadProfilingService, Listen)
+  ctx(SampleFakeThreads, records_);
+  ctx.call({});
+  ASSERT_EQ(OkStatus(), ctx.service().Sample());
+
+  // The rpc thread exits; a new thread is reported in its place.
+  fake_threads[1] = {.name = "transfer",
+                     .id = 3,
+                     .run_time = 10,
+                     .stack_low_addr = 0,
+                     .stack_high_addr = 0,
+                     .stack_pointer_est_peak = std::nullopt};
+  fake_threads[0].run_time += 10;
+  ASSERT_EQ(OkStatus(), ctx.service().Sample());
+
+  size_t count;
+  auto threads = Decode<2>(ctx.responses()[1], count);
+  ASSERT_EQ(2u, count);
+  EXPECT_EQ("idle", threads[0].name);
+  EXPECT_EQ(10000u, threads[0].cpu_usage_hundredths);
+  EXPECT_EQ("transfer", threads[1].name);
+  EXPECT_EQ(0u, threads[1].cpu_usage_hundredths);
+
+  // Threads beyond the number of records are not reported.
+  fake_threads[2] = fake_threads[1];
+  fake_threads[2].id = 4;
+  fake_threads[3] = fake_threads[1];
+  fake_threads[3].id = 5;
+  fake_thread_count = 4;
+  ASSERT_EQ(OkStatus(), ctx.service().Sample());
+  Decode<4>(ctx.responses()[2], count);
+  EXPECT_EQ(3u, count);
+}
+
+}  // namespace
+}  // namespace pw::thread
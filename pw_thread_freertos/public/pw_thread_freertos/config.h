@@ -63,6 +63,24 @@
 #define PW_THREAD_FREERTOS_CONFIG_MAXIMUM_PRIORITY (configMAX_PRIORITIES - 1)
 #endif  // PW_THREAD_FREERTOS_CONFIG_MAXIMUM_PRIORITY
 
+// Whether threads may be pinned to a subset of cores. By default this matches
+// the FreeRTOS SMP configuration, i.e. configUSE_CORE_AFFINITY.
+#ifndef PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+#if defined(configUSE_CORE_AFFINITY) && configUSE_CORE_AFFINITY == 1
+#define PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED 1
+#else
+#define PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED 0
+#endif  // configUSE_CORE_AFFINITY
+#endif  // PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+
+// The first FreeRTOS thread local storage pointer index used by
+// pw::thread::ThreadLocal. Each ThreadLocal claims the next index the first
+// time it is used, up to configNUM_THREAD_LOCAL_STORAGE_POINTERS - 1. Lower
+// indices are left for the application.
+#ifndef PW_THREAD_FREERTOS_CONFIG_THREAD_LOCAL_FIRST_INDEX
+#define PW_THREAD_FREERTOS_CONFIG_THREAD_LOCAL_FIRST_INDEX 0
+#endif  // PW_THREAD_FREERTOS_CONFIG_THREAD_LOCAL_FIRST_INDEX
+
 // The log level to use for this module. Logs below this level are omitted.
 #ifndef PW_THREAD_FREERTOS_CONFIG_LOG_LEVEL
 #define PW_THREAD_FREERTOS_CONFIG_LOG_LEVEL PW_LOG_LEVEL_DEBUG
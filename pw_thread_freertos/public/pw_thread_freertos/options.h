@@ -79,6 +79,17 @@ class Options : public thread::Options {
   }
 #endif  // PW_THREAD_FREERTOS_CONFIG_DYNAMIC_ALLOCATION_ENABLED
 
+#if PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+  // Restricts the FreeRTOS task to the cores set in core_mask, where bit N
+  // represents core N. By default the task may run on any core, i.e.
+  // tskNO_AFFINITY.
+  constexpr Options& set_core_affinity(UBaseType_t core_mask) {
+    PW_DASSERT(core_mask != 0);
+    core_affinity_ = core_mask;
+    return *this;
+  }
+#endif  // PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+
   // Set the pre-allocated context (all memory needed to run a thread), see the
   // pw::thread::freertos::StaticContext for more detail.
   constexpr Options& set_static_context(StaticContext& context) {
@@ -97,6 +108,9 @@ class Options : public thread::Options {
 #if PW_THREAD_FREERTOS_CONFIG_DYNAMIC_ALLOCATION_ENABLED
   size_t stack_size_words() const { return stack_size_words_; }
 #endif  // PW_THREAD_FREERTOS_CONFIG_DYNAMIC_ALLOCATION_ENABLED
+#if PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+  UBaseType_t core_affinity() const { return core_affinity_; }
+#endif  // PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
   StaticContext* static_context() const { return context_; }
 
   const char* name_ = kDefaultName;
@@ -104,6 +118,9 @@ class Options : public thread::Options {
 #if PW_THREAD_FREERTOS_CONFIG_DYNAMIC_ALLOCATION_ENABLED
   size_t stack_size_words_ = config::kDefaultStackSizeWords;
 #endif  // PW_THREAD_FREERTOS_CONFIG_DYNAMIC_ALLOCATION_ENABLED
+#if PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+  UBaseType_t core_affinity_ = tskNO_AFFINITY;
+#endif  // PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
   StaticContext* context_ = nullptr;
 };
 
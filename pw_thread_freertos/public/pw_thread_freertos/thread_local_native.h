@@ -0,0 +1,89 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "FreeRTOS.h"
+#include "pw_thread/internal/thread_local_pool.h"
+#include "task.h"
+
+namespace pw::thread {
+namespace freertos {
+
+// A FreeRTOS thread local storage pointer index, claimed on first use.
+class ThreadLocalIndex {
+ public:
+  constexpr ThreadLocalIndex() : index_(kUnassigned) {}
+
+  // Returns this object's index, claiming the next free index if it does not
+  // have one yet. Running out of indices is fatal.
+  BaseType_t Get() {
+    const BaseType_t index = index_.load(std::memory_order_acquire);
+    return index != kUnassigned ? index : Assign();
+  }
+
+ private:
+  static constexpr BaseType_t kUnassigned = -1;
+
+  BaseType_t Assign();
+
+  std::atomic<BaseType_t> index_;
+};
+
+}  // namespace freertos
+
+namespace backend {
+
+// The FreeRTOS backend keeps a pointer to each thread's instance in one of the
+// thread's thread local storage pointers, so get() does not search. Instances
+// live in storage for kMaxThreads instances, reserved in the ThreadLocal.
+template <typename T, size_t kMaxThreads>
+class NativeThreadLocal {
+ public:
+  constexpr NativeThreadLocal() = default;
+
+  T* get() {
+    const BaseType_t index = index_.Get();
+    void* const instance = pvTaskGetThreadLocalStoragePointer(nullptr, index);
+    if (instance != nullptr) {
+      return static_cast<T*>(instance);
+    }
+
+    const size_t slot = pool_.Claim();
+    if (slot == pool_.kNone) {
+      return nullptr;
+    }
+    vTaskSetThreadLocalStoragePointer(nullptr, index, &pool_[slot]);
+    return &pool_[slot];
+  }
+
+  void release() {
+    const BaseType_t index = index_.Get();
+    void* const instance = pvTaskGetThreadLocalStoragePointer(nullptr, index);
+    if (instance == nullptr) {
+      return;
+    }
+    vTaskSetThreadLocalStoragePointer(nullptr, index, nullptr);
+    pool_.Release(pool_.IndexOf(static_cast<T*>(instance)));
+  }
+
+ private:
+  freertos::ThreadLocalIndex index_;
+  internal::ThreadLocalPool<T, kMaxThreads> pool_;
+};
+
+}  // namespace backend
+}  // namespace pw::thread
@@ -0,0 +1,36 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_status/status.h"
+#include "pw_thread/thread_usage.h"
+
+namespace pw::thread::freertos {
+
+// Reports the run time and stack usage of every FreeRTOS task. This is a
+// pw::thread::ThreadUsageSampler for pw::thread::ThreadProfilingService.
+//
+// The run time is the task's ulRunTimeCounter, which requires
+// configGENERATE_RUN_TIME_STATS. Otherwise every task reports a run time of 0.
+// The stack high-water mark requires INCLUDE_uxTaskGetStackHighWaterMark, and
+// the stack's upper bound requires configRECORD_STACK_HIGH_ADDRESS.
+//
+// Note: this requires the pw_thread_freertos:freertos_tskcb backend to be set
+// in order to access the task control blocks.
+//
+// The scheduler is suspended while the tasks are iterated, so this must be
+// called from a task after the scheduler has started.
+Status SampleThreadUsage(const ThreadUsageCallback& callback);
+
+}  // namespace pw::thread::freertos
@@ -139,6 +139,19 @@ Thread::Thread(const thread::Options& facade_options,
     // deep copied into the context with a small wrapping function to actually
     // invoke the task with its arg.
     native_type_->set_thread_routine(entry, arg);
+#if PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+    // Set the affinity as part of creation so the task never runs on a core
+    // outside of its mask.
+    const TaskHandle_t task_handle =
+        xTaskCreateStaticAffinitySet(Context::ThreadEntryPoint,
+                                     options.name(),
+                                     options.static_context()->stack().size(),
+                                     native_type_,
+                                     options.priority(),
+                                     options.static_context()->stack().data(),
+                                     &options.static_context()->tcb(),
+                                     options.core_affinity());
+#else
     const TaskHandle_t task_handle =
         xTaskCreateStatic(Context::ThreadEntryPoint,
                           options.name(),
@@ -147,6 +160,7 @@ Thread::Thread(const thread::Options& facade_options,
                           options.priority(),
                           options.static_context()->stack().data(),
                           &options.static_context()->tcb());
+#endif  // PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
     PW_CHECK_NOTNULL(task_handle);  // Ensure it succeeded.
     native_type_->set_task_handle(task_handle);
   } else {
@@ -171,12 +185,22 @@ Thread::Thread(const thread::Options& facade_options,
     // invoke the task with its arg.
     native_type_->set_thread_routine(entry, arg);
     TaskHandle_t task_handle;
+#if PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
+    const BaseType_t result = xTaskCreateAffinitySet(Context::ThreadEntryPoint,
+                                                     options.name(),
+                                                     options.stack_size_words(),
+                                                     native_type_,
+                                                     options.priority(),
+                                                     options.core_affinity(),
+                                                     &task_handle);
+#else
     const BaseType_t result = xTaskCreate(Context::ThreadEntryPoint,
                                           options.name(),
                                           options.stack_size_words(),
                                           native_type_,
                                           options.priority(),
                                           &task_handle);
+#endif  // PW_THREAD_FREERTOS_CONFIG_CORE_AFFINITY_ENABLED
 
     // Ensure it succeeded.
     PW_CHECK_UINT_EQ(result, pdPASS);
@@ -0,0 +1,51 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "FreeRTOS.h"
+#include "pw_assert/check.h"
+#include "pw_thread/thread_local.h"
+#include "pw_thread_freertos/config.h"
+#include "task.h"
+
+static_assert(configNUM_THREAD_LOCAL_STORAGE_POINTERS >
+                  PW_THREAD_FREERTOS_CONFIG_THREAD_LOCAL_FIRST_INDEX,
+              "pw::thread::ThreadLocal requires FreeRTOS thread local storage "
+              "pointers; increase configNUM_THREAD_LOCAL_STORAGE_POINTERS");
+
+namespace pw::thread::freertos {
+namespace {
+
+// Guarded by the FreeRTOS critical section.
+BaseType_t next_thread_local_index =
+    PW_THREAD_FREERTOS_CONFIG_THREAD_LOCAL_FIRST_INDEX;
+
+}  // namespace
+
+BaseType_t ThreadLocalIndex::Assign() {
+  taskENTER_CRITICAL();
+  BaseType_t index = index_.load(std::memory_order_relaxed);
+  if (index == kUnassigned) {
+    index = next_thread_local_index++;
+    index_.store(index, std::memory_order_release);
+  }
+  taskEXIT_CRITICAL();
+
+  PW_CHECK_INT_LT(index,
+                  configNUM_THREAD_LOCAL_STORAGE_POINTERS,
+                  "Out of FreeRTOS thread local storage pointers for "
+                  "pw::thread::ThreadLocal");
+  return index;
+}
+
+}  // namespace pw::thread::freertos
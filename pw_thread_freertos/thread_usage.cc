@@ -0,0 +1,67 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread_freertos/thread_usage.h"
+
+#include <string_view>
+
+#include "FreeRTOS.h"
+#include "pw_thread_freertos/freertos_tsktcb.h"
+#include "pw_thread_freertos/util.h"
+#include "task.h"
+
+namespace pw::thread::freertos {
+
+Status SampleThreadUsage(const ThreadUsageCallback& callback) {
+  // TODO(pwbug/422): Update this once we add support for ascending stacks.
+  static_assert(portSTACK_GROWTH < 0, "Ascending stacks are not yet supported");
+
+  const ThreadCallback sample_thread([&callback](TaskHandle_t thread,
+                                                 eTaskState) {
+    const tskTCB& tcb = *reinterpret_cast<tskTCB*>(thread);
+    const uintptr_t stack_low_addr = reinterpret_cast<uintptr_t>(tcb.pxStack);
+
+    ThreadUsageSample sample = {
+        .name = tcb.pcTaskName,
+        .id = reinterpret_cast<uintptr_t>(thread),
+        .run_time = 0,
+        .stack_low_addr = stack_low_addr,
+        .stack_high_addr = 0,
+        .stack_pointer_est_peak = std::nullopt,
+    };
+#if configGENERATE_RUN_TIME_STATS == 1
+    sample.run_time = tcb.ulRunTimeCounter;
+#endif  // configGENERATE_RUN_TIME_STATS == 1
+#if configRECORD_STACK_HIGH_ADDRESS == 1
+    sample.stack_high_addr = reinterpret_cast<uintptr_t>(tcb.pxEndOfStack);
+#endif  // configRECORD_STACK_HIGH_ADDRESS == 1
+#if INCLUDE_uxTaskGetStackHighWaterMark == 1
+    // The high-water mark is the least free stack space, in words, which for
+    // a descending stack is the distance from its lowest address.
+    sample.stack_pointer_est_peak =
+        stack_low_addr +
+        sizeof(StackType_t) * uxTaskGetStackHighWaterMark(thread);
+#endif  // INCLUDE_uxTaskGetStackHighWaterMark == 1
+
+    callback(sample);
+    return true;  // Iterate through all threads.
+  });
+
+  vTaskSuspendAll();
+  const Status status = ForEachThread(sample_thread);
+  xTaskResumeAll();
+  return status;
+}
+
+}  // namespace pw::thread::freertos
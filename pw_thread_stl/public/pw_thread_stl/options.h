@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstdint>
+
 #include "pw_thread/thread.h"
 
 namespace pw::thread::stl {
@@ -21,6 +23,31 @@ namespace pw::thread::stl {
 // Instead, users are expected to start the thread and after dynamically adjust
 // the thread's attributes using std::thread::native_handle based on the native
 // threading APIs.
-class Options : public thread::Options {};
+//
+// The exception is CPU affinity on Linux, which the thread applies to itself
+// before invoking the thread's entry function.
+class Options : public thread::Options {
+ public:
+  constexpr Options() = default;
+  constexpr Options(const Options&) = default;
+  constexpr Options(Options&& other) = default;
+
+#if defined(__linux__)
+  // Restricts the thread to the CPUs set in cpu_mask, where bit N represents
+  // CPU N. By default the thread may run on any CPU.
+  constexpr Options& set_cpu_affinity(uint64_t cpu_mask) {
+    cpu_affinity_ = cpu_mask;
+    return *this;
+  }
+#endif  // defined(__linux__)
+
+ private:
+  friend thread::Thread;
+
+  // A mask of 0 means that no affinity is applied.
+  uint64_t cpu_affinity() const { return cpu_affinity_; }
+
+  uint64_t cpu_affinity_ = 0;
+};
 
 }  // namespace pw::thread::stl
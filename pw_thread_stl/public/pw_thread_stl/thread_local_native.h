@@ -0,0 +1,51 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+namespace pw::thread::backend {
+
+// The STL backend allocates each thread's instance on first use and keeps it
+// in a thread_local map, so instances are destroyed when their thread exits
+// and any number of threads may hold one. kMaxThreads is ignored.
+template <typename T, size_t kMaxThreads>
+class NativeThreadLocal {
+ public:
+  constexpr NativeThreadLocal() = default;
+
+  T* get() {
+    std::unique_ptr<T>& instance = Instances()[this];
+    if (instance == nullptr) {
+      instance = std::make_unique<T>();
+    }
+    return instance.get();
+  }
+
+  void release() { Instances().erase(this); }
+
+ private:
+  using InstanceMap =
+      std::unordered_map<const NativeThreadLocal*, std::unique_ptr<T>>;
+
+  // The calling thread's instances of every NativeThreadLocal<T, kMaxThreads>.
+  static InstanceMap& Instances() {
+    thread_local InstanceMap instances;
+    return instances;
+  }
+};
+
+}  // namespace pw::thread::backend
@@ -0,0 +1,65 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread.h"
+
+#include <thread>
+
+#include "pw_thread_stl/options.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif  // defined(__linux__)
+
+namespace pw::thread {
+namespace {
+
+#if defined(__linux__)
+void SetCurrentThreadAffinity(uint64_t cpu_mask) {
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  for (int cpu = 0; cpu < 64; ++cpu) {
+    if ((cpu_mask & (uint64_t(1) << cpu)) != 0) {
+      CPU_SET(cpu, &cpus);
+    }
+  }
+  // This is best effort, as the host may not have the requested CPUs.
+  pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+}
+#endif  // defined(__linux__)
+
+}  // namespace
+
+Thread::Thread(const thread::Options& facade_options,
+               ThreadRoutine entry,
+               void* arg) {
+  // Cast the generic facade options to the backend specific option of which
+  // only one type can exist at compile time.
+  const auto& options = static_cast<const stl::Options&>(facade_options);
+#if defined(__linux__)
+  if (const uint64_t cpu_mask = options.cpu_affinity(); cpu_mask != 0) {
+    native_type_ = std::thread([cpu_mask, entry, arg] {
+      SetCurrentThreadAffinity(cpu_mask);
+      entry(arg);
+    });
+    return;
+  }
+#else
+  static_cast<void>(options);
+#endif  // defined(__linux__)
+  native_type_ = std::thread(entry, arg);
+}
+
+}  // namespace pw::thread
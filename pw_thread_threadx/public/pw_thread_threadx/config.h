@@ -66,6 +66,16 @@
   PW_THREAD_THREADX_CONFIG_MIN_PRIORITY
 #endif  // PW_THREAD_THREADX_CONFIG_DEFAULT_PRIORITY
 
+// Whether threads may be pinned to a subset of cores. By default this matches
+// whether ThreadX SMP is in use, i.e. TX_THREAD_SMP_MAX_CORES is defined.
+#ifndef PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+#ifdef TX_THREAD_SMP_MAX_CORES
+#define PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED 1
+#else
+#define PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED 0
+#endif  // TX_THREAD_SMP_MAX_CORES
+#endif  // PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+
 // The log level to use for this module. Logs below this level are omitted.
 #ifndef PW_THREAD_THREADX_CONFIG_LOG_LEVEL
 #define PW_THREAD_THREADX_CONFIG_LOG_LEVEL PW_LOG_LEVEL_DEBUG
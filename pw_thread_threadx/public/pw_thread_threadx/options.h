@@ -108,6 +108,16 @@ class Options : public thread::Options {
     return *this;
   }
 
+#if PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+  // Restricts the ThreadX thread to the cores set in core_mask, where bit N
+  // represents core N. By default the thread may run on any core.
+  constexpr Options& set_core_affinity(ULONG core_mask) {
+    PW_DASSERT(core_mask != 0);
+    core_affinity_ = core_mask;
+    return *this;
+  }
+#endif  // PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+
   // Set the pre-allocated context (all memory needed to run a thread), see the
   // pw::thread::threadx::Context for more detail.
   constexpr Options& set_context(Context& context) {
@@ -127,6 +137,9 @@ class Options : public thread::Options {
     return possible_preemption_threshold_.value_or(priority_);
   }
   ULONG time_slice_interval() const { return time_slice_interval_; }
+#if PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+  ULONG core_affinity() const { return core_affinity_; }
+#endif  // PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
   Context* context() const { return context_; }
 
   const char* name_ = kDefaultName;
@@ -135,6 +148,9 @@ class Options : public thread::Options {
   // have to be based on the selected priority.
   std::optional<UINT> possible_preemption_threshold_ = std::nullopt;
   ULONG time_slice_interval_ = config::kDefaultTimeSliceInterval;
+#if PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+  ULONG core_affinity_ = ~ULONG(0);
+#endif  // PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
   Context* context_ = nullptr;
 };
 
@@ -0,0 +1,28 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_thread/internal/thread_local_pool.h"
+
+namespace pw::thread::backend {
+
+// Unlike FreeRTOS, ThreadX has no per-thread storage pointers for applications
+// to claim, so the ThreadX backend finds the calling thread's instance by its
+// thread::Id. Storage for kMaxThreads instances is reserved in the ThreadLocal.
+template <typename T, size_t kMaxThreads>
+using NativeThreadLocal = internal::ThreadLocalById<T, kMaxThreads>;
+
+}  // namespace pw::thread::backend
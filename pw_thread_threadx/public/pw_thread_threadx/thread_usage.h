@@ -0,0 +1,31 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_status/status.h"
+#include "pw_thread/thread_usage.h"
+
+namespace pw::thread::threadx {
+
+// Reports the run time and stack usage of every ThreadX thread. This is a
+// pw::thread::ThreadUsageSampler for pw::thread::ThreadProfilingService.
+//
+// The run time comes from the ThreadX execution profile kit, which requires
+// TX_EXECUTION_PROFILE_ENABLE. Otherwise every thread reports a run time of 0.
+// The stack high-water mark requires TX_ENABLE_STACK_CHECKING.
+//
+// Interrupts are disabled while the threads are iterated.
+Status SampleThreadUsage(const ThreadUsageCallback& callback);
+
+}  // namespace pw::thread::threadx
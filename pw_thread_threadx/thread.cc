@@ -154,8 +154,23 @@ Thread::Thread(const thread::Options& facade_options,
                        options.priority(),
                        options.preemption_threshold(),
                        options.time_slice_interval(),
+#if PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+                       TX_DONT_START);
+#else
                        TX_AUTO_START);
+#endif  // PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
   PW_CHECK_UINT_EQ(TX_SUCCESS, thread_result, "Failed to create the thread");
+
+#if PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
+  // The thread is created suspended so that it never runs on an excluded core.
+  PW_CHECK_UINT_EQ(TX_SUCCESS,
+                   tx_thread_smp_core_exclude(&options.context()->tcb(),
+                                              ~options.core_affinity()),
+                   "Failed to set the thread's core affinity");
+  PW_CHECK_UINT_EQ(TX_SUCCESS,
+                   tx_thread_resume(&options.context()->tcb()),
+                   "Failed to start the thread");
+#endif  // PW_THREAD_THREADX_CONFIG_CORE_AFFINITY_ENABLED
 }
 
 void Thread::detach() {
@@ -0,0 +1,69 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread_threadx/thread_usage.h"
+
+#include <string_view>
+
+#include "pw_thread_threadx/util.h"
+#include "tx_api.h"
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+#include "tx_execution_profile.h"
+#endif  // TX_EXECUTION_PROFILE_ENABLE
+
+namespace pw::thread::threadx {
+
+Status SampleThreadUsage(const ThreadUsageCallback& callback) {
+  const ThreadCallback sample_thread([&callback](const TX_THREAD& thread) {
+    ThreadUsageSample sample = {
+        .name = thread.tx_thread_name != nullptr
+                    ? std::string_view(thread.tx_thread_name)
+                    : std::string_view(),
+        .id = reinterpret_cast<uintptr_t>(&thread),
+        .run_time = 0,
+        // As in SnapshotThread(), the lowest word is reserved for a watermark
+        // when stack checking is enabled.
+        .stack_low_addr =
+            reinterpret_cast<uintptr_t>(thread.tx_thread_stack_start) +
+            sizeof(ULONG),
+        .stack_high_addr =
+            reinterpret_cast<uintptr_t>(thread.tx_thread_stack_end),
+        .stack_pointer_est_peak = std::nullopt,
+    };
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    EXECUTION_TIME run_time;
+    if (_tx_execution_thread_time_get(const_cast<TX_THREAD*>(&thread),
+                                      &run_time) == TX_SUCCESS) {
+      sample.run_time = run_time;
+    }
+#endif  // TX_EXECUTION_PROFILE_ENABLE
+#ifdef TX_ENABLE_STACK_CHECKING
+    sample.stack_pointer_est_peak =
+        reinterpret_cast<uintptr_t>(thread.tx_thread_stack_highest_ptr);
+#endif  // TX_ENABLE_STACK_CHECKING
+
+    callback(sample);
+    return true;  // Iterate through all threads.
+  });
+
+  // ForEachThread() requires that the thread list does not change while it is
+  // iterated.
+  const UINT previous_interrupt_state = tx_interrupt_control(TX_INT_DISABLE);
+  const Status status = ForEachThread(sample_thread);
+  tx_interrupt_control(previous_interrupt_state);
+  return status;
+}
+
+}  // namespace pw::thread::threadx
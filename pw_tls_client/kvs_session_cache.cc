@@ -0,0 +1,65 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tls_client/kvs_session_cache.h"
+
+#include "pw_kvs/internal/entry.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::tls_client {
+namespace {
+
+using KeyBuffer = StringBuffer<kvs::internal::Entry::kMaxKeyLength + 1>;
+
+Status BuildKey(std::string_view prefix,
+                std::string_view server_name,
+                KeyBuffer& key) {
+  if (server_name.empty()) {
+    return Status::InvalidArgument();
+  }
+  key << prefix << server_name;
+  return key.ok() ? OkStatus() : Status::InvalidArgument();
+}
+
+}  // namespace
+
+Status KvsSessionCache::Store(std::string_view server_name,
+                              ConstByteSpan session) {
+  KeyBuffer key;
+  if (Status status = BuildKey(key_prefix_, server_name, key); !status.ok()) {
+    return status;
+  }
+  return kvs_.Put(key.view(), session);
+}
+
+StatusWithSize KvsSessionCache::Load(std::string_view server_name,
+                                     ByteSpan dest) {
+  KeyBuffer key;
+  if (Status status = BuildKey(key_prefix_, server_name, key); !status.ok()) {
+    return StatusWithSize(status, 0);
+  }
+  return kvs_.Get(key.view(), dest);
+}
+
+Status KvsSessionCache::Remove(std::string_view server_name) {
+  KeyBuffer key;
+  if (Status status = BuildKey(key_prefix_, server_name, key); !status.ok()) {
+    return status;
+  }
+
+  const Status status = kvs_.Delete(key.view());
+  return status.IsNotFound() ? OkStatus() : status;
+}
+
+}  // namespace pw::tls_client
@@ -0,0 +1,52 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <string_view>
+
+#include "pw_bytes/span.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_tls_client/session_cache.h"
+
+namespace pw::tls_client {
+
+// A SessionCache that persists sessions in a key-value store, so that sessions
+// can be resumed after a reboot. Each session is stored under the key prefix
+// followed by the server name.
+//
+// Sessions contain secrets, so the key-value store should be on storage that
+// is protected from readout.
+class KvsSessionCache final : public SessionCache {
+ public:
+  // The prefix and server name together may be at most
+  // kvs::internal::Entry::kMaxKeyLength characters. The KVS and the memory
+  // referred to by key_prefix must outlive the cache.
+  constexpr KvsSessionCache(kvs::KeyValueStore& kvs,
+                            std::string_view key_prefix = "tls_session/")
+      : kvs_(kvs), key_prefix_(key_prefix) {}
+
+  Status Store(std::string_view server_name, ConstByteSpan session) override;
+
+  StatusWithSize Load(std::string_view server_name, ByteSpan dest) override;
+
+  Status Remove(std::string_view server_name) override;
+
+ private:
+  kvs::KeyValueStore& kvs_;
+  std::string_view key_prefix_;
+};
+
+}  // namespace pw::tls_client
@@ -0,0 +1,153 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::tls_client {
+
+// A SessionCache stores serialized TLS session state so that a later Session
+// to the same server can resume the TLS session with an abbreviated handshake
+// instead of a full one. Depending on the backend and server, the state is a
+// session ticket (RFC 5077 / RFC 8446 PSK) or a session ID with its master
+// secret.
+//
+// The serialized state includes secrets that allow decrypting the resumed
+// connection, so caches that persist it must store it somewhere protected.
+//
+// Sessions are keyed by server name. A backend that is given a cache through
+// SessionOptions::set_session_cache loads the saved session in Open(), and
+// stores the new session once the handshake completes or a new ticket
+// arrives. If the server rejects resumption, the backend removes the entry.
+class SessionCache {
+ public:
+  virtual ~SessionCache() = default;
+
+  // Saves the serialized session for server_name, replacing any session
+  // already stored for it. Returns:
+  //
+  //   OK - the session was stored
+  //   RESOURCE_EXHAUSTED - the session is too large for this cache
+  //   INVALID_ARGUMENT - the server name cannot be stored by this cache
+  //
+  // Other errors may be returned by the underlying storage.
+  virtual Status Store(std::string_view server_name, ConstByteSpan session) = 0;
+
+  // Loads the session saved for server_name into dest. Returns:
+  //
+  //   OK - the session was loaded; the size is its length in bytes
+  //   NOT_FOUND - no session is stored for the server
+  //   RESOURCE_EXHAUSTED - dest is too small to hold the session
+  virtual StatusWithSize Load(std::string_view server_name, ByteSpan dest) = 0;
+
+  // Removes the session saved for server_name, if any.
+  virtual Status Remove(std::string_view server_name) = 0;
+};
+
+// A SessionCache that stores sessions in memory, for reuse across Session
+// instances within one boot. When the cache is full, storing a session for a
+// new server replaces the least recently used one.
+template <size_t kMaxSessions,
+          size_t kMaxSessionSizeBytes,
+          size_t kMaxServerNameLength = 64>
+class InMemorySessionCache final : public SessionCache {
+ public:
+  static_assert(kMaxSessions > 0u);
+
+  constexpr InMemorySessionCache() : entries_{}, clock_(0) {}
+
+  Status Store(std::string_view server_name, ConstByteSpan session) override {
+    if (server_name.empty() || server_name.size() > kMaxServerNameLength) {
+      return Status::InvalidArgument();
+    }
+    if (session.size() > kMaxSessionSizeBytes) {
+      return Status::ResourceExhausted();
+    }
+
+    Entry* entry = Find(server_name);
+    if (entry == nullptr) {
+      entry = &*std::min_element(
+          entries_.begin(), entries_.end(), [](auto& lhs, auto& rhs) {
+            return lhs.last_used < rhs.last_used;
+          });
+      std::memcpy(entry->server_name.data(),
+                  server_name.data(),
+                  server_name.size());
+      entry->server_name_size = server_name.size();
+    }
+
+    std::memcpy(entry->session.data(), session.data(), session.size());
+    entry->session_size = session.size();
+    entry->last_used = ++clock_;
+    return OkStatus();
+  }
+
+  StatusWithSize Load(std::string_view server_name, ByteSpan dest) override {
+    Entry* entry = Find(server_name);
+    if (entry == nullptr) {
+      return StatusWithSize::NotFound();
+    }
+    if (entry->session_size > dest.size()) {
+      return StatusWithSize::ResourceExhausted();
+    }
+
+    std::memcpy(dest.data(), entry->session.data(), entry->session_size);
+    entry->last_used = ++clock_;
+    return StatusWithSize(entry->session_size);
+  }
+
+  Status Remove(std::string_view server_name) override {
+    if (Entry* entry = Find(server_name); entry != nullptr) {
+      // Wipe the session, since it contains secrets.
+      *entry = {};
+    }
+    return OkStatus();
+  }
+
+ private:
+  struct Entry {
+    std::string_view name() const {
+      return std::string_view(server_name.data(), server_name_size);
+    }
+
+    std::array<char, kMaxServerNameLength> server_name;
+    size_t server_name_size;
+    std::array<std::byte, kMaxSessionSizeBytes> session;
+    size_t session_size;
+    uint32_t last_used;  // 0 if the entry is empty
+  };
+
+  Entry* Find(std::string_view server_name) {
+    for (Entry& entry : entries_) {
+      if (entry.last_used != 0u && entry.name() == server_name) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  std::array<Entry, kMaxSessions> entries_;
+  uint32_t clock_;
+};
+
+}  // namespace pw::tls_client
@@ -0,0 +1,148 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tls_client/session_cache.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_tls_client/kvs_session_cache.h"
+
+namespace pw::tls_client {
+namespace {
+
+constexpr auto kSession = bytes::Array<1, 2, 3, 4, 5, 6, 7, 8>();
+constexpr auto kOtherSession = bytes::Array<9, 8, 7>();
+
+class InMemorySessionCacheTest : public ::testing::Test {
+ protected:
+  InMemorySessionCache<2, 16, 16> cache_;
+  std::array<std::byte, 16> buffer_ = {};
+};
+
+TEST_F(InMemorySessionCacheTest, Load_NotFound) {
+  EXPECT_EQ(Status::NotFound(), cache_.Load("example.com", buffer_).status());
+}
+
+TEST_F(InMemorySessionCacheTest, StoreAndLoad) {
+  ASSERT_EQ(OkStatus(), cache_.Store("example.com", kSession));
+
+  const StatusWithSize result = cache_.Load("example.com", buffer_);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(kSession.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(kSession.data(), buffer_.data(), kSession.size()));
+}
+
+TEST_F(InMemorySessionCacheTest, Store_ReplacesSameServer) {
+  ASSERT_EQ(OkStatus(), cache_.Store("example.com", kSession));
+  ASSERT_EQ(OkStatus(), cache_.Store("example.com", kOtherSession));
+  ASSERT_EQ(OkStatus(), cache_.Store("pigweed.dev", kSession));
+
+  const StatusWithSize result = cache_.Load("example.com", buffer_);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(kOtherSession.size(), result.size());
+  EXPECT_EQ(0,
+            std::memcmp(
+                kOtherSession.data(), buffer_.data(), kOtherSession.size()));
+}
+
+TEST_F(InMemorySessionCacheTest, Store_EvictsLeastRecentlyUsed) {
+  ASSERT_EQ(OkStatus(), cache_.Store("a.com", kSession));
+  ASSERT_EQ(OkStatus(), cache_.Store("b.com", kSession));
+  ASSERT_EQ(OkStatus(), cache_.Load("a.com", buffer_).status());
+  ASSERT_EQ(OkStatus(), cache_.Store("c.com", kSession));
+
+  EXPECT_EQ(OkStatus(), cache_.Load("a.com", buffer_).status());
+  EXPECT_EQ(Status::NotFound(), cache_.Load("b.com", buffer_).status());
+  EXPECT_EQ(OkStatus(), cache_.Load("c.com", buffer_).status());
+}
+
+TEST_F(InMemorySessionCacheTest, Store_Limits) {
+  std::array<std::byte, 17> too_large = {};
+  EXPECT_EQ(Status::ResourceExhausted(), cache_.Store("a.com", too_large));
+  EXPECT_EQ(Status::InvalidArgument(),
+            cache_.Store("a.very.long.server.name", kSession));
+  EXPECT_EQ(Status::InvalidArgument(), cache_.Store("", kSession));
+}
+
+TEST_F(InMemorySessionCacheTest, Load_BufferTooSmall) {
+  ASSERT_EQ(OkStatus(), cache_.Store("example.com", kSession));
+  std::array<std::byte, 4> small;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            cache_.Load("example.com", small).status());
+}
+
+TEST_F(InMemorySessionCacheTest, Remove) {
+  ASSERT_EQ(OkStatus(), cache_.Store("example.com", kSession));
+  EXPECT_EQ(OkStatus(), cache_.Remove("example.com"));
+  EXPECT_EQ(Status::NotFound(), cache_.Load("example.com", buffer_).status());
+  EXPECT_EQ(OkStatus(), cache_.Remove("example.com"));
+}
+
+constexpr kvs::EntryFormat kFormat{.magic = 0x5e551011, .checksum = nullptr};
+
+class KvsSessionCacheTest : public ::testing::Test {
+ protected:
+  KvsSessionCacheTest()
+      : flash_(16),
+        partition_(&flash_),
+        kvs_(&partition_, kFormat),
+        cache_(kvs_) {}
+
+  void SetUp() override { ASSERT_EQ(OkStatus(), kvs_.Init()); }
+
+  kvs::FakeFlashMemoryBuffer<512, 4> flash_;
+  kvs::FlashPartition partition_;
+  kvs::KeyValueStoreBuffer<4, 4> kvs_;
+  KvsSessionCache cache_;
+  std::array<std::byte, 16> buffer_ = {};
+};
+
+TEST_F(KvsSessionCacheTest, StoreAndLoad) {
+  EXPECT_EQ(Status::NotFound(), cache_.Load("example.com", buffer_).status());
+  ASSERT_EQ(OkStatus(), cache_.Store("example.com", kSession));
+
+  const StatusWithSize result = cache_.Load("example.com", buffer_);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(kSession.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(kSession.data(), buffer_.data(), kSession.size()));
+
+  EXPECT_EQ(kSession.size(),
+            kvs_.ValueSize("tls_session/example.com").size());
+}
+
+TEST_F(KvsSessionCacheTest, Remove) {
+  ASSERT_EQ(OkStatus(), cache_.Store("example.com", kSession));
+  EXPECT_EQ(OkStatus(), cache_.Remove("example.com"));
+  EXPECT_EQ(Status::NotFound(), cache_.Load("example.com", buffer_).status());
+  EXPECT_EQ(OkStatus(), cache_.Remove("example.com"));
+}
+
+TEST_F(KvsSessionCacheTest, ServerNameTooLong) {
+  constexpr std::string_view kLongName =
+      "a.very.long.server.name.that.does.not.fit.in.a.kvs.key.com";
+  EXPECT_EQ(Status::InvalidArgument(), cache_.Store(kLongName, kSession));
+  EXPECT_EQ(Status::InvalidArgument(),
+            cache_.Load(kLongName, buffer_).status());
+}
+
+}  // namespace
+}  // namespace pw::tls_client
@@ -28,6 +28,15 @@ class SessionImplementation {
   SessionImplementation(SessionOptions options);
   ~SessionImplementation();
   Status Setup();
+
+  // Saves the current TLS session to the session cache from the options, if
+  // there is one. Called once the handshake completes.
+  Status SaveSession();
+
+  // The largest serialized session that is saved or loaded. Sessions are much
+  // smaller if MBEDTLS_SSL_KEEP_PEER_CERTIFICATE is disabled, since the peer
+  // certificate is then not part of the session.
+  static constexpr size_t kMaxSavedSessionSizeBytes = 1024;
   void SetTlsStatus(TLSStatus status) { tls_status_ = status; }
   TLSStatus GetTlsStatus() { return tls_status_; }
 
@@ -51,6 +60,10 @@ class SessionImplementation {
 
   TLSStatus tls_status_ = TLSStatus::kOk;
 
+  // Loads a saved session for the server, so that the handshake resumes it.
+  // If no session can be loaded, a full handshake is done.
+  void LoadSession();
+
   static int MbedTlsWrite(void* ctx, const uint8_t* buf, size_t len);
   static int MbedTlsRead(void* ctx, unsigned char* buf, size_t len);
   static int MbedTlsEntropySource(void* ctx,
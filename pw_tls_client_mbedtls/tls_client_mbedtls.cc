@@ -12,6 +12,10 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <array>
+#include <cstring>
+#include <span>
+
 #include "mbedtls/ssl.h"
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
@@ -163,9 +167,74 @@ Status SessionImplementation::Setup() {
     return Status::Internal();
   }
 
+  LoadSession();
   return OkStatus();
 }
 
+void SessionImplementation::LoadSession() {
+  SessionCache* cache = session_options_.session_cache();
+  if (cache == nullptr) {
+    return;
+  }
+
+  std::array<std::byte, kMaxSavedSessionSizeBytes> buffer;
+  const StatusWithSize loaded =
+      cache->Load(session_options_.server_name(), buffer);
+  if (!loaded.ok()) {
+    return;
+  }
+
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  int ret = mbedtls_ssl_session_load(
+      &session, reinterpret_cast<unsigned char*>(buffer.data()), loaded.size());
+  if (ret == 0) {
+    ret = mbedtls_ssl_set_session(&ssl_ctx_, &session);
+  }
+  if (ret != 0) {
+    // The saved session is unusable, likely from a different version or
+    // configuration of MbedTLS. Drop it and do a full handshake.
+    PW_LOG_DEBUG("Failed to load saved TLS session");
+    cache->Remove(session_options_.server_name()).IgnoreError();
+  }
+
+  mbedtls_ssl_session_free(&session);
+  std::memset(buffer.data(), 0, buffer.size());
+}
+
+Status SessionImplementation::SaveSession() {
+  SessionCache* cache = session_options_.session_cache();
+  if (cache == nullptr) {
+    return OkStatus();
+  }
+
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  std::array<std::byte, kMaxSavedSessionSizeBytes> buffer;
+  size_t size = 0;
+
+  int ret = mbedtls_ssl_get_session(&ssl_ctx_, &session);
+  if (ret == 0) {
+    ret = mbedtls_ssl_session_save(
+        &session,
+        reinterpret_cast<unsigned char*>(buffer.data()),
+        buffer.size(),
+        &size);
+  }
+  mbedtls_ssl_session_free(&session);
+
+  Status status = Status::Internal();
+  if (ret == 0) {
+    status = cache->Store(session_options_.server_name(),
+                          std::span(buffer).first(size));
+  } else if (ret == MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL) {
+    status = Status::ResourceExhausted();
+  }
+
+  std::memset(buffer.data(), 0, buffer.size());
+  return status;
+}
+
 }  // namespace backend
 
 Session::Session(const SessionOptions& options) : session_impl_(options) {}
@@ -198,7 +267,8 @@ Result<Session*> Session::Create(const SessionOptions& options) {
 }
 
 Status Session::Open() {
-  // TODO(pwbug/398): To implement
+  // TODO(pwbug/398): To implement. Once the handshake completes, call
+  // session_impl_.SaveSession() so that later sessions can resume this one.
   return Status::Unimplemented();
 }
 
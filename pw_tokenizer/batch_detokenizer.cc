@@ -0,0 +1,116 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tokenizer/batch_detokenizer.h"
+
+#include <algorithm>
+
+namespace pw::tokenizer {
+
+BatchDetokenizer::BatchDetokenizer(const Detokenizer& detokenizer,
+                                   size_t thread_count)
+    : detokenizer_(detokenizer),
+      arenas_(std::max<size_t>(thread_count, 1)),
+      next_message_(0),
+      batch_(0),
+      busy_workers_(0),
+      stopping_(false) {
+  // Arena 0 belongs to the thread that calls Detokenize.
+  for (size_t worker = 1; worker < arenas_.size(); ++worker) {
+    threads_.emplace_back([this, worker] { WorkerLoop(worker); });
+  }
+}
+
+BatchDetokenizer::~BatchDetokenizer() {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  batch_started_.notify_all();
+
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+void BatchDetokenizer::Detokenize(
+    std::span<const std::span<const uint8_t>> messages) {
+  // Clearing keeps the capacity from earlier batches.
+  for (std::string& arena : arenas_) {
+    arena.clear();
+  }
+  results_.resize(messages.size());
+
+  messages_ = messages;
+  next_message_.store(0, std::memory_order_relaxed);
+
+  // Publishing the batch under the mutex makes the state above visible to the
+  // workers when they wake up.
+  {
+    std::lock_guard lock(mutex_);
+    batch_ += 1;
+    busy_workers_ = threads_.size();
+  }
+  batch_started_.notify_all();
+
+  ProcessMessages(0);
+
+  std::unique_lock lock(mutex_);
+  batch_finished_.wait(lock, [this] { return busy_workers_ == 0u; });
+}
+
+void BatchDetokenizer::WorkerLoop(size_t worker) {
+  uint64_t last_batch = 0;
+
+  while (true) {
+    {
+      std::unique_lock lock(mutex_);
+      batch_started_.wait(
+          lock, [&] { return stopping_ || batch_ != last_batch; });
+      if (stopping_) {
+        return;
+      }
+      last_batch = batch_;
+    }
+
+    ProcessMessages(worker);
+
+    std::lock_guard lock(mutex_);
+    busy_workers_ -= 1;
+    if (busy_workers_ == 0u) {
+      batch_finished_.notify_one();
+    }
+  }
+}
+
+void BatchDetokenizer::ProcessMessages(size_t worker) {
+  std::string& arena = arenas_[worker];
+
+  while (true) {
+    const size_t first =
+        next_message_.fetch_add(kChunkSize, std::memory_order_relaxed);
+    if (first >= messages_.size()) {
+      return;
+    }
+    const size_t last = std::min(first + kChunkSize, messages_.size());
+
+    for (size_t i = first; i < last; ++i) {
+      const size_t offset = arena.size();
+      detokenizer_.AppendDetokenized(messages_[i], arena);
+      results_[i] = {worker, offset, arena.size() - offset};
+    }
+  }
+}
+
+}  // namespace pw::tokenizer
@@ -0,0 +1,187 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures detokenization throughput of Detokenizer::Detokenize and
+// BatchDetokenizer with several thread counts on a synthetic log stream. This
+// benchmark only runs on the host.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pw_tokenizer/batch_detokenizer.h"
+#include "pw_tokenizer/detokenize.h"
+#include "pw_varint/varint.h"
+
+namespace pw::tokenizer {
+namespace {
+
+constexpr size_t kMessages = 200000;
+constexpr size_t kRounds = 5;
+
+constexpr const char* kFormats[] = {
+    "Boot complete",
+    "Sensor %d read %d samples",
+    "Battery at %u%%, %d mV",
+    "Task %s started on core %d",
+    "Temperature %f C above threshold %f C",
+    "Connection to %s failed: error %d (retry %u of %u)",
+    "Flash write of %u bytes at 0x%08x took %u us",
+    "Received packet from %s with %d bytes",
+};
+
+// Builds a binary token database with each format string under token i + 1.
+std::vector<uint8_t> BuildDatabase() {
+  std::vector<uint8_t> database = {
+      'T', 'O', 'K', 'E', 'N', 'S', '\0', '\0', std::size(kFormats), 0, 0, 0,
+      0,   0,   0,   0};
+
+  for (size_t i = 0; i < std::size(kFormats); ++i) {
+    const uint32_t token = i + 1;
+    for (size_t byte = 0; byte < sizeof(token); ++byte) {
+      database.push_back(token >> (8 * byte));
+    }
+    database.insert(database.end(), 4, 0xff);  // Not removed
+  }
+
+  for (const char* format : kFormats) {
+    database.insert(database.end(), format, format + std::strlen(format) + 1);
+  }
+  return database;
+}
+
+class MessageEncoder {
+ public:
+  MessageEncoder(uint32_t token) {
+    for (size_t byte = 0; byte < sizeof(token); ++byte) {
+      message_.push_back(token >> (8 * byte));
+    }
+  }
+
+  MessageEncoder& Int(int64_t value) {
+    std::array<std::byte, varint::kMaxVarint64SizeBytes> buffer;
+    const size_t size = varint::Encode(value, buffer);
+    const auto* bytes = reinterpret_cast<const uint8_t*>(buffer.data());
+    message_.insert(message_.end(), bytes, bytes + size);
+    return *this;
+  }
+
+  MessageEncoder& Float(float value) {
+    uint8_t bytes[sizeof(value)];
+    std::memcpy(bytes, &value, sizeof(value));
+    message_.insert(message_.end(), bytes, bytes + sizeof(bytes));
+    return *this;
+  }
+
+  MessageEncoder& String(const char* value) {
+    message_.push_back(std::strlen(value));
+    message_.insert(message_.end(), value, value + std::strlen(value));
+    return *this;
+  }
+
+  std::vector<uint8_t> Finish() { return std::move(message_); }
+
+ private:
+  std::vector<uint8_t> message_;
+};
+
+std::vector<uint8_t> EncodeMessage(size_t i) {
+  const int n = static_cast<int>(i);
+  switch (i % std::size(kFormats)) {
+    case 0:
+      return MessageEncoder(1).Finish();
+    case 1:
+      return MessageEncoder(2).Int(n % 16).Int(n % 1000).Finish();
+    case 2:
+      return MessageEncoder(3).Int(n % 100).Int(3000 + n % 1200).Finish();
+    case 3:
+      return MessageEncoder(4).String("log_drain").Int(n % 4).Finish();
+    case 4:
+      return MessageEncoder(5).Float(n * 0.25f).Float(85.0f).Finish();
+    case 5:
+      return MessageEncoder(6)
+          .String("gateway.local")
+          .Int(-n % 128)
+          .Int(n % 3)
+          .Int(3)
+          .Finish();
+    case 6:
+      return MessageEncoder(7).Int(256).Int(n * 256).Int(n % 700).Finish();
+    default:
+      return MessageEncoder(8).String("10.0.0.2").Int(n % 1500).Finish();
+  }
+}
+
+double MessagesPerSecond(std::chrono::steady_clock::duration elapsed) {
+  const double seconds = std::chrono::duration<double>(elapsed).count();
+  return static_cast<double>(kMessages * kRounds) / seconds;
+}
+
+void Run() {
+  const std::vector<uint8_t> database = BuildDatabase();
+  const Detokenizer detokenizer(TokenDatabase::Create(database));
+
+  std::vector<std::vector<uint8_t>> encoded;
+  std::vector<std::span<const uint8_t>> messages;
+  encoded.reserve(kMessages);
+  for (size_t i = 0; i < kMessages; ++i) {
+    encoded.push_back(EncodeMessage(i));
+    messages.push_back(encoded.back());
+  }
+
+  // Baseline: one DetokenizedString and std::string per message.
+  size_t total_size = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < kRounds; ++round) {
+    for (const auto& message : messages) {
+      total_size +=
+          detokenizer.Detokenize(message).BestStringWithErrors().size();
+    }
+  }
+  std::printf("Detokenizer::Detokenize:  %10.0f messages/s\n",
+              MessagesPerSecond(std::chrono::steady_clock::now() - start));
+
+  const size_t max_threads =
+      std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    BatchDetokenizer batch(detokenizer, threads);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < kRounds; ++round) {
+      batch.Detokenize(messages);
+      total_size += batch[batch.size() - 1].size();
+    }
+    std::printf("BatchDetokenizer (%2zu threads): %10.0f messages/s\n",
+                threads,
+                MessagesPerSecond(std::chrono::steady_clock::now() - start));
+  }
+
+  // Print the total so the results can't be optimized away.
+  std::printf("(%zu bytes)\n", total_size);
+}
+
+}  // namespace
+}  // namespace pw::tokenizer
+
+int main() {
+  pw::tokenizer::Run();
+  return 0;
+}
@@ -0,0 +1,166 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tokenizer/batch_detokenizer.h"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace pw::tokenizer {
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+#define ERR PW_TOKENIZER_ARG_DECODING_ERROR
+
+alignas(TokenDatabase::RawEntry) constexpr char kData[] =
+    "TOKENS\0\0"
+    "\x04\x00\x00\x00"
+    "\0\0\0\0"
+    "\x01\x00\x00\x00----"
+    "\x02\x00\x00\x00----"
+    "\x03\x00\x00\x00----"
+    "\x03\x00\x00\x00----"
+    "One\0"
+    "Number %d\0"
+    "Hello %s\0"
+    "collision\0";
+
+std::span<const uint8_t> AsBytes(std::string_view data) {
+  return std::span(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+// Encoded messages and their expected results.
+struct TestMessage {
+  std::string_view encoded;
+  std::string_view expected;
+};
+
+constexpr TestMessage kMessages[] = {
+    {"\1\0\0\0"sv, "One"sv},
+    {"\2\0\0\0\x0a"sv, "Number 5"sv},
+    {"\2\0\0\0\x0b"sv, "Number -6"sv},
+    {"\2\0\0\0"sv, "Number " ERR("%d MISSING")},
+    {"\3\0\0\0\5world"sv, "Hello world"sv},
+    {"\4\0\0\0"sv, ERR("unknown token 00000004")},
+    {"\1\0"sv, ERR("missing token")},
+};
+
+class BatchDetokenizerTest : public ::testing::Test {
+ protected:
+  BatchDetokenizerTest() : detok_(TokenDatabase::Create<kData>()) {}
+
+  // Repeats the test messages to fill a batch of the given size.
+  void FillBatch(size_t size) {
+    messages_.clear();
+    for (size_t i = 0; i < size; ++i) {
+      messages_.push_back(
+          AsBytes(kMessages[i % std::size(kMessages)].encoded));
+    }
+  }
+
+  void ExpectResults(const BatchDetokenizer& batch) {
+    ASSERT_EQ(batch.size(), messages_.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+      EXPECT_EQ(batch[i], kMessages[i % std::size(kMessages)].expected);
+    }
+  }
+
+  Detokenizer detok_;
+  std::vector<std::span<const uint8_t>> messages_;
+};
+
+TEST_F(BatchDetokenizerTest, SingleThread) {
+  BatchDetokenizer batch(detok_, 1);
+  EXPECT_EQ(batch.thread_count(), 1u);
+
+  FillBatch(std::size(kMessages));
+  batch.Detokenize(messages_);
+  ExpectResults(batch);
+}
+
+TEST_F(BatchDetokenizerTest, ZeroThreadsRunsOnCaller) {
+  BatchDetokenizer batch(detok_, 0);
+  EXPECT_EQ(batch.thread_count(), 1u);
+
+  FillBatch(100);
+  batch.Detokenize(messages_);
+  ExpectResults(batch);
+}
+
+TEST_F(BatchDetokenizerTest, MultipleThreads) {
+  BatchDetokenizer batch(detok_, 4);
+
+  FillBatch(10 * BatchDetokenizer::kChunkSize + 3);
+  batch.Detokenize(messages_);
+  ExpectResults(batch);
+}
+
+TEST_F(BatchDetokenizerTest, MatchesDetokenizer) {
+  BatchDetokenizer batch(detok_, 3);
+
+  FillBatch(std::size(kMessages));
+  batch.Detokenize(messages_);
+
+  ASSERT_EQ(batch.size(), messages_.size());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    EXPECT_EQ(batch[i], detok_.Detokenize(messages_[i]).BestStringWithErrors());
+  }
+}
+
+TEST_F(BatchDetokenizerTest, Collision_UsesBestMatch) {
+  BatchDetokenizer batch(detok_, 2);
+
+  // Token 3 has two strings; only "Hello %s" consumes the argument.
+  messages_ = {AsBytes("\3\0\0\0\2hi"sv)};
+  batch.Detokenize(messages_);
+
+  ASSERT_EQ(batch.size(), 1u);
+  EXPECT_EQ(batch[0], "Hello hi");
+}
+
+TEST_F(BatchDetokenizerTest, ReuseReplacesResults) {
+  BatchDetokenizer batch(detok_, 4);
+
+  FillBatch(1000);
+  batch.Detokenize(messages_);
+  ExpectResults(batch);
+
+  FillBatch(10);
+  batch.Detokenize(messages_);
+  ExpectResults(batch);
+
+  FillBatch(2000);
+  batch.Detokenize(messages_);
+  ExpectResults(batch);
+}
+
+TEST_F(BatchDetokenizerTest, EmptyBatch) {
+  BatchDetokenizer batch(detok_, 4);
+
+  FillBatch(20);
+  batch.Detokenize(messages_);
+  ASSERT_EQ(batch.size(), 20u);
+
+  messages_.clear();
+  batch.Detokenize(messages_);
+  EXPECT_EQ(batch.size(), 0u);
+}
+
+}  // namespace
+}  // namespace pw::tokenizer
@@ -273,22 +273,26 @@ DecodedArg StringSegment::Skip() const {
 
 std::string DecodedFormatString::value() const {
   std::string output;
-
-  for (const DecodedArg& arg : segments_) {
-    output.append(arg.ok() ? arg.value() : arg.spec());
-  }
-
+  AppendValue(output);
   return output;
 }
 
 std::string DecodedFormatString::value_with_errors() const {
   std::string output;
+  AppendValueWithErrors(output);
+  return output;
+}
 
+void DecodedFormatString::AppendValue(std::string& output) const {
   for (const DecodedArg& arg : segments_) {
-    output.append(arg.value());
+    output.append(arg.ok() ? arg.value() : arg.spec());
   }
+}
 
-  return output;
+void DecodedFormatString::AppendValueWithErrors(std::string& output) const {
+  for (const DecodedArg& arg : segments_) {
+    output.append(arg.value());
+  }
 }
 
 size_t DecodedFormatString::argument_count() const {
@@ -334,6 +338,7 @@ FormatString::FormatString(const char* format) {
 DecodedFormatString FormatString::Format(
     std::span<const uint8_t> arguments) const {
   std::vector<DecodedArg> results;
+  results.reserve(segments_.size());
   bool skip = false;
 
   for (const auto& segment : segments_) {
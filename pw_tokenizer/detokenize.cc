@@ -33,6 +33,29 @@ std::string UnknownTokenMessage(uint32_t value) {
   return output;
 }
 
+// Parses the 8 hexadecimal digits of a nested token.
+bool ParseNestedToken(std::string_view digits, uint32_t& token) {
+  if (digits.size() < 8u) {
+    return false;
+  }
+  token = 0;
+  for (size_t i = 0; i < 8u; ++i) {
+    const char c = digits[i];
+    uint32_t value;
+    if (c >= '0' && c <= '9') {
+      value = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      value = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      value = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    token = token << 4 | value;
+  }
+  return true;
+}
+
 // Decoding result with the date removed, for sorting.
 using DecodingResult = std::pair<DecodedFormatString, uint32_t>;
 
@@ -97,9 +120,93 @@ std::string DetokenizedString::BestStringWithErrors() const {
   return matches_[0].value_with_errors();
 }
 
+std::span<const TokenizedStringEntry> Detokenizer::TokenEntries::formats()
+    const {
+  std::call_once(parsed_, [this] {
+    formats_.reserve(strings_.size());
+    for (const auto& [string, date_removed] : strings_) {
+      formats_.emplace_back(string.c_str(), date_removed);
+    }
+    // The FormatStrings hold copies of the text, so the originals can go.
+    strings_ = {};
+  });
+  return formats_;
+}
+
 Detokenizer::Detokenizer(const TokenDatabase& database) {
   for (const auto& entry : database) {
-    database_[entry.token].emplace_back(entry.string, entry.date_removed);
+    database_[entry.token].Add(entry.string, entry.date_removed);
+  }
+}
+
+void Detokenizer::AppendDetokenized(const std::span<const uint8_t>& encoded,
+                                    std::string& output) const {
+  if (encoded.size() >= sizeof(uint32_t)) {
+    const uint32_t token =
+        encoded[3] << 24 | encoded[2] << 16 | encoded[1] << 8 | encoded[0];
+
+    // Format directly into the output in the common case of no collisions.
+    if (const auto result = database_.find(token); result != database_.end()) {
+      if (const auto formats = result->second.formats(); formats.size() == 1u) {
+        const size_t start = output.size();
+        formats[0]
+            .first.Format(encoded.subspan(sizeof(token)))
+            .AppendValueWithErrors(output);
+
+        // Nested tokens are rare, so only copy the message if it has one.
+        if (output.find(kNestedTokenPrefix, start) != std::string::npos) {
+          const std::string message = output.substr(start);
+          output.resize(start);
+          AppendExpanded(message, kDefaultNestedTokenRecursion, output);
+        }
+        return;
+      }
+    }
+  }
+
+  AppendExpanded(Detokenize(encoded).BestStringWithErrors(),
+                 kDefaultNestedTokenRecursion,
+                 output);
+}
+
+std::string Detokenizer::ExpandNestedTokens(std::string_view text,
+                                            unsigned max_recursion) const {
+  std::string output;
+  AppendExpanded(text, max_recursion, output);
+  return output;
+}
+
+void Detokenizer::AppendExpanded(std::string_view text,
+                                 unsigned max_recursion,
+                                 std::string& output) const {
+  constexpr size_t kTokenDigits = 8;
+
+  while (true) {
+    const size_t prefix = text.find(kNestedTokenPrefix);
+    if (prefix == std::string_view::npos) {
+      output.append(text);
+      return;
+    }
+    output.append(text.substr(0, prefix));
+    text.remove_prefix(prefix + kNestedTokenPrefix.size());
+
+    uint32_t token;
+    const auto entry = ParseNestedToken(text, token) ? database_.find(token)
+                                                     : database_.end();
+    if (entry == database_.end()) {
+      // Not a nested token, or an unknown one; keep the text as is.
+      output.append(kNestedTokenPrefix);
+      continue;
+    }
+    text.remove_prefix(kTokenDigits);
+
+    const DetokenizedString nested(
+        token, entry->second.formats(), std::span<const uint8_t>());
+    if (max_recursion == 0u) {
+      output.append(nested.BestString());
+    } else {
+      AppendExpanded(nested.BestString(), max_recursion - 1, output);
+    }
   }
 }
 
@@ -117,8 +224,8 @@ DetokenizedString Detokenizer::Detokenize(
 
   return DetokenizedString(token,
                            result == database_.end()
-                               ? std::span<TokenizedStringEntry>()
-                               : std::span(result->second),
+                               ? std::span<const TokenizedStringEntry>()
+                               : result->second.formats(),
                            encoded.subspan(sizeof(token)));
 }
 
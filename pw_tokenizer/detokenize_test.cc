@@ -14,7 +14,11 @@
 
 #include "pw_tokenizer/detokenize.h"
 
+#include <memory>
+#include <span>
+#include <string>
 #include <string_view>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -97,6 +101,103 @@ TEST_F(Detokenize, BestStringWithErrors_UnknownToken_ErrorMessage) {
             ERR("unknown token fedcba98"));
 }
 
+TEST_F(Detokenize, AppendDetokenized_AppendsBestStringWithErrors) {
+  constexpr std::string_view kKnown = "\5\0\0\0"sv;
+  constexpr std::string_view kUnknown = "\2\0\0\0"sv;
+  std::string output = "> ";
+
+  detok_.AppendDetokenized(
+      std::span(reinterpret_cast<const uint8_t*>(kKnown.data()), kKnown.size()),
+      output);
+  EXPECT_EQ(output, "> TWO");
+
+  detok_.AppendDetokenized(
+      std::span(reinterpret_cast<const uint8_t*>(kUnknown.data()),
+                kUnknown.size()),
+      output);
+  EXPECT_EQ(output, "> TWO" ERR("unknown token 00000002"));
+}
+
+TEST(DetokenizeLazyParsing, DatabaseMemoryFreedBeforeFirstUse) {
+  // Format strings are parsed on first use, so the Detokenizer must not refer
+  // to the database memory after construction.
+  auto data = std::make_unique<std::vector<char>>(
+      std::begin(kBasicData), std::end(kBasicData));
+  Detokenizer detok(TokenDatabase::Create(*data));
+  data.reset();
+
+  EXPECT_EQ(detok.Detokenize("\1\0\0\0"sv).BestString(), "One");
+  EXPECT_EQ(detok.Detokenize("\xff\xee\xee\xdd"sv).BestString(), "FOUR");
+}
+
+alignas(TokenDatabase::RawEntry) constexpr char kNestedData[] =
+    "TOKENS\0\0"
+    "\x04\x00\x00\x00"
+    "\0\0\0\0"
+    "\x01\x00\x00\x00----"
+    "\x02\x00\x00\x00----"
+    "\x03\x00\x00\x00----"
+    "\x04\x00\x00\x00----"
+    "Entering $#%08x\0"
+    "STANDBY\0"
+    "state $#00000002\0"
+    "recursive $#00000004";
+
+class DetokenizeNested : public ::testing::Test {
+ protected:
+  DetokenizeNested() : detok_(TokenDatabase::Create<kNestedData>()) {}
+  Detokenizer detok_;
+};
+
+TEST_F(DetokenizeNested, Detokenize_LeavesNestedTokens) {
+  EXPECT_EQ(detok_.Detokenize("\1\0\0\0\4"sv).BestString(),
+            "Entering $#00000002");
+}
+
+TEST_F(DetokenizeNested, ExpandNestedTokens_TokenArgument) {
+  EXPECT_EQ(detok_.ExpandNestedTokens(
+                detok_.Detokenize("\1\0\0\0\4"sv).BestString()),
+            "Entering STANDBY");
+}
+
+TEST_F(DetokenizeNested, ExpandNestedTokens_TokenInFormatString) {
+  EXPECT_EQ(detok_.ExpandNestedTokens(
+                detok_.Detokenize("\3\0\0\0"sv).BestString()),
+            "state STANDBY");
+}
+
+TEST_F(DetokenizeNested, ExpandNestedTokens_UnknownTokenUnchanged) {
+  EXPECT_EQ(detok_.ExpandNestedTokens(
+                detok_.Detokenize("\1\0\0\0\x0a"sv).BestString()),
+            "Entering $#00000005");
+}
+
+TEST_F(DetokenizeNested, ExpandNestedTokens) {
+  EXPECT_EQ(detok_.ExpandNestedTokens("$#00000002"), "STANDBY");
+  EXPECT_EQ(detok_.ExpandNestedTokens("a $#00000002 b $#00000002"),
+            "a STANDBY b STANDBY");
+  EXPECT_EQ(detok_.ExpandNestedTokens("$#$#00000002"), "$#STANDBY");
+  EXPECT_EQ(detok_.ExpandNestedTokens("$#0000000"), "$#0000000");
+  EXPECT_EQ(detok_.ExpandNestedTokens("$#0000000g"), "$#0000000g");
+  EXPECT_EQ(detok_.ExpandNestedTokens("no tokens"), "no tokens");
+}
+
+TEST_F(DetokenizeNested, ExpandNestedTokens_LimitsRecursion) {
+  EXPECT_EQ(detok_.ExpandNestedTokens("$#00000003", 0), "state $#00000002");
+  EXPECT_EQ(detok_.ExpandNestedTokens("$#00000003", 1), "state STANDBY");
+  EXPECT_EQ(detok_.ExpandNestedTokens("$#00000004", 2),
+            "recursive recursive recursive $#00000004");
+}
+
+TEST_F(DetokenizeNested, AppendDetokenized_ExpandsNestedTokens) {
+  constexpr std::string_view kData = "\1\0\0\0\4"sv;
+  std::string output = "> ";
+  detok_.AppendDetokenized(
+      std::span(reinterpret_cast<const uint8_t*>(kData.data()), kData.size()),
+      output);
+  EXPECT_EQ(output, "> Entering STANDBY");
+}
+
 alignas(TokenDatabase::RawEntry) constexpr char kDataWithArguments[] =
     "TOKENS\0\0"
     "\x09\x00\x00\x00"
@@ -32,15 +32,19 @@ enum class ArgType : uint8_t {
   kString = PW_TOKENIZER_ARG_TYPE_STRING,
 };
 
-size_t EncodeInt(int value, const std::span<std::byte>& output) {
-  return varint::Encode(value, std::as_writable_bytes(output));
+}  // namespace
+
+namespace internal {
+
+size_t EncodeInt(int value, std::span<std::byte> output) {
+  return varint::Encode(value, output);
 }
 
-size_t EncodeInt64(int64_t value, const std::span<std::byte>& output) {
-  return varint::Encode(value, std::as_writable_bytes(output));
+size_t EncodeInt64(int64_t value, std::span<std::byte> output) {
+  return varint::Encode(value, output);
 }
 
-size_t EncodeFloat(float value, const std::span<std::byte>& output) {
+size_t EncodeFloat(float value, std::span<std::byte> output) {
   if (output.size() < sizeof(value)) {
     return 0;
   }
@@ -48,7 +52,7 @@ size_t EncodeFloat(float value, const std::span<std::byte>& output) {
   return sizeof(value);
 }
 
-size_t EncodeString(const char* string, const std::span<std::byte>& output) {
+size_t EncodeString(const char* string, std::span<std::byte> output) {
   // The top bit of the status byte indicates if the string was truncated.
   static constexpr size_t kMaxStringLength = 0x7Fu;
 
@@ -82,7 +86,7 @@ size_t EncodeString(const char* string, const std::span<std::byte>& output) {
   return bytes_to_copy + 1;  // include the status byte in the total
 }
 
-}  // namespace
+}  // namespace internal
 
 size_t EncodeArgs(pw_tokenizer_ArgTypes types,
                   va_list args,
@@ -97,17 +101,18 @@ size_t EncodeArgs(pw_tokenizer_ArgTypes types,
 
     switch (static_cast<ArgType>(types & 0b11u)) {
       case ArgType::kInt:
-        argument_bytes = EncodeInt(va_arg(args, int), output);
+        argument_bytes = internal::EncodeInt(va_arg(args, int), output);
         break;
       case ArgType::kInt64:
-        argument_bytes = EncodeInt64(va_arg(args, int64_t), output);
+        argument_bytes = internal::EncodeInt64(va_arg(args, int64_t), output);
         break;
       case ArgType::kDouble:
-        argument_bytes =
-            EncodeFloat(static_cast<float>(va_arg(args, double)), output);
+        argument_bytes = internal::EncodeFloat(
+            static_cast<float>(va_arg(args, double)), output);
         break;
       case ArgType::kString:
-        argument_bytes = EncodeString(va_arg(args, const char*), output);
+        argument_bytes =
+            internal::EncodeString(va_arg(args, const char*), output);
         break;
     }
 
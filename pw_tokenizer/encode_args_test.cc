@@ -0,0 +1,118 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tokenizer/encode_args.h"
+
+#include <array>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "gtest/gtest.h"
+
+namespace pw::tokenizer {
+namespace {
+
+constexpr size_t kMaxBufferSize = 64;
+
+template <pw_tokenizer_ArgTypes kTypes>
+size_t EncodeSpecialized(std::byte* buffer, size_t buffer_size, ...) {
+  va_list args;
+  va_start(args, buffer_size);
+  const size_t size = EncodeArgs<kTypes>(args, std::span(buffer, buffer_size));
+  va_end(args);
+  return size;
+}
+
+// Checks that the specialized encoder matches the generic encoder for the
+// arguments with every buffer size up to kMaxBufferSize.
+template <pw_tokenizer_ArgTypes kTypes>
+void ExpectSameEncoding(int unused, ...) {
+  va_list args;
+  va_start(args, unused);
+
+  for (size_t buffer_size = 0; buffer_size <= kMaxBufferSize; ++buffer_size) {
+    std::array<std::byte, kMaxBufferSize> generic{};
+    std::array<std::byte, kMaxBufferSize> specialized{};
+
+    va_list generic_args;
+    va_copy(generic_args, args);
+    const size_t generic_size = EncodeArgs(
+        kTypes, generic_args, std::span(generic).first(buffer_size));
+    va_end(generic_args);
+
+    va_list specialized_args;
+    va_copy(specialized_args, args);
+    const size_t specialized_size = EncodeArgs<kTypes>(
+        specialized_args, std::span(specialized).first(buffer_size));
+    va_end(specialized_args);
+
+    ASSERT_EQ(generic_size, specialized_size);
+    EXPECT_EQ(0, std::memcmp(generic.data(), specialized.data(), generic_size));
+  }
+
+  va_end(args);
+}
+
+#define EXPECT_SAME_ENCODING(...) \
+  ExpectSameEncoding<PW_TOKENIZER_ARG_TYPES(__VA_ARGS__)>(0, __VA_ARGS__)
+
+TEST(EncodeArgs, Specialized_NoArguments) {
+  std::array<std::byte, 4> buffer;
+  EXPECT_EQ(0u,
+            EncodeSpecialized<PW_TOKENIZER_ARG_TYPES()>(buffer.data(),
+                                                        buffer.size()));
+}
+
+TEST(EncodeArgs, Specialized_EncodesIntegers) {
+  std::array<std::byte, 16> buffer;
+  const size_t size = EncodeSpecialized<PW_TOKENIZER_ARG_TYPES(1, -1, 64)>(
+      buffer.data(), buffer.size(), 1, -1, 64);
+  ASSERT_EQ(4u, size);
+  EXPECT_EQ(std::byte{0x02}, buffer[0]);
+  EXPECT_EQ(std::byte{0x01}, buffer[1]);
+  EXPECT_EQ(std::byte{0x80}, buffer[2]);
+  EXPECT_EQ(std::byte{0x01}, buffer[3]);
+}
+
+TEST(EncodeArgs, Specialized_MatchesGeneric_Integers) {
+  EXPECT_SAME_ENCODING(0, -1, 1, std::numeric_limits<int>::min());
+  EXPECT_SAME_ENCODING(std::numeric_limits<int>::max(),
+                       std::numeric_limits<int64_t>::min(),
+                       std::numeric_limits<int64_t>::max(),
+                       int64_t{-1234567890123});
+  EXPECT_SAME_ENCODING('c', static_cast<unsigned>(-1), uint64_t{1} << 63);
+}
+
+TEST(EncodeArgs, Specialized_MatchesGeneric_Floats) {
+  EXPECT_SAME_ENCODING(0.0f, -1.5, 3.14159, 1e38);
+}
+
+TEST(EncodeArgs, Specialized_MatchesGeneric_Strings) {
+  const char* null_string = nullptr;
+  EXPECT_SAME_ENCODING("Hello", "", null_string);
+  EXPECT_SAME_ENCODING(
+      "This string is long enough that it is truncated in small buffers");
+}
+
+TEST(EncodeArgs, Specialized_MatchesGeneric_Mixed) {
+  EXPECT_SAME_ENCODING(42, "name", 2.5f, int64_t{-99999999999});
+  EXPECT_SAME_ENCODING(int64_t{1} << 40, -7, 0.25, "last");
+  EXPECT_SAME_ENCODING("first", 1, "second", 2, 3.0);
+}
+
+}  // namespace
+}  // namespace pw::tokenizer
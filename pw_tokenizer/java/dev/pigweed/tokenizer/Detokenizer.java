@@ -22,6 +22,10 @@
 package dev.pigweed.tokenizer;
 
 import android.util.Base64;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.LinkedHashMap;
+import java.util.Map;
 import java.util.regex.Matcher;
 import java.util.regex.Pattern;
 
@@ -32,6 +36,12 @@ public class Detokenizer {
   private static final Pattern TOKENIZED_STRING =
       Pattern.compile("\\$([A-Za-z0-9+/]{4})*([A-Za-z0-9+/]{3}=|[A-Za-z0-9+/]{2}==)?");
 
+  // Number of zero-argument messages for which detokenized strings are cached by default.
+  private static final int DEFAULT_CACHE_SIZE = 256;
+
+  // Size of an encoded token. Messages of this size have no arguments.
+  private static final int TOKEN_SIZE = 4;
+
   static {
     System.loadLibrary("detokenizer");
   }
@@ -39,12 +49,129 @@ public class Detokenizer {
   // The handle to the C++ detokenizer instance.
   private final long handle;
 
+  // Least recently used cache of strings for messages without arguments, keyed by token. Logs
+  // often repeat the same argument-free messages, and reusing their Strings avoids crossing into
+  // JNI and allocating a new String each time.
+  private final Map<Integer, String> cache;
+
   public Detokenizer() {
     this(new byte[0]);
   }
 
   public Detokenizer(byte[] tokenDatabase) {
+    this(tokenDatabase, DEFAULT_CACHE_SIZE);
+  }
+
+  /**
+   * Creates a detokenizer that caches up to cacheSize strings for messages without arguments. A
+   * cacheSize of 0 disables the cache.
+   */
+  public Detokenizer(byte[] tokenDatabase, int cacheSize) {
     handle = newNativeDetokenizer(tokenDatabase);
+    cache =
+        new LinkedHashMap<Integer, String>(16, 0.75f, /* accessOrder= */ true) {
+          @Override
+          protected boolean removeEldestEntry(Map.Entry<Integer, String> eldest) {
+            return size() > cacheSize;
+          }
+        };
+  }
+
+  /**
+   * Detokenizes a binary tokenized message. Returns null if the message's token is not in the
+   * database.
+   */
+  public String detokenize(byte[] message) {
+    return detokenize(message, 0, message.length);
+  }
+
+  /** Detokenizes the binary tokenized message in message[offset, offset + length). */
+  public String detokenize(byte[] message, int offset, int length) {
+    if (length == TOKEN_SIZE) {
+      int token = ByteBuffer.wrap(message).order(ByteOrder.LITTLE_ENDIAN).getInt(offset);
+      String cached = lookUp(token);
+      return cached != null
+          ? cached
+          : cache(token, detokenizeNative(handle, message, offset, length));
+    }
+    return detokenizeNative(handle, message, offset, length);
+  }
+
+  /**
+   * Detokenizes the binary tokenized message between the buffer's position and limit. Direct
+   * buffers are read in place, without copying. The buffer's position is not changed.
+   */
+  public String detokenize(ByteBuffer message) {
+    if (!message.isDirect()) {
+      if (message.hasArray()) {
+        return detokenize(
+            message.array(), message.arrayOffset() + message.position(), message.remaining());
+      }
+      byte[] copy = new byte[message.remaining()];
+      message.duplicate().get(copy);
+      return detokenize(copy);
+    }
+
+    if (message.remaining() == TOKEN_SIZE) {
+      int token = message.duplicate().order(ByteOrder.LITTLE_ENDIAN).getInt(message.position());
+      String cached = lookUp(token);
+      return cached != null
+          ? cached
+          : cache(token, detokenizeDirectNative(handle, message, message.position(), TOKEN_SIZE));
+    }
+    return detokenizeDirectNative(handle, message, message.position(), message.remaining());
+  }
+
+  /**
+   * Detokenizes many binary tokenized messages stored in a direct ByteBuffer in one JNI call.
+   * Message i is the lengths[i] bytes at absolute index offsets[i] of the buffer. Returns the
+   * detokenized strings, with null for messages whose tokens are not in the database.
+   */
+  public String[] detokenizeBatch(ByteBuffer buffer, int[] offsets, int[] lengths) {
+    if (!buffer.isDirect()) {
+      throw new IllegalArgumentException("detokenizeBatch requires a direct ByteBuffer");
+    }
+    if (offsets.length != lengths.length) {
+      throw new IllegalArgumentException("offsets and lengths must be the same length");
+    }
+
+    // Take cached strings where possible, and detokenize the rest natively in one call.
+    String[] results = new String[offsets.length];
+    int[] missIndices = new int[offsets.length];
+    int misses = 0;
+
+    ByteBuffer littleEndian = buffer.duplicate().order(ByteOrder.LITTLE_ENDIAN);
+    synchronized (cache) {
+      for (int i = 0; i < offsets.length; ++i) {
+        if (lengths[i] == TOKEN_SIZE) {
+          results[i] = cache.get(littleEndian.getInt(offsets[i]));
+        }
+        if (results[i] == null) {
+          missIndices[misses++] = i;
+        }
+      }
+    }
+
+    if (misses == 0) {
+      return results;
+    }
+
+    int[] missOffsets = new int[misses];
+    int[] missLengths = new int[misses];
+    for (int i = 0; i < misses; ++i) {
+      missOffsets[i] = offsets[missIndices[i]];
+      missLengths[i] = lengths[missIndices[i]];
+    }
+
+    String[] detokenized = detokenizeBatchNative(handle, buffer, missOffsets, missLengths);
+    for (int i = 0; i < misses; ++i) {
+      int index = missIndices[i];
+      results[index] = detokenized[i];
+      if (lengths[index] == TOKEN_SIZE) {
+        cache(littleEndian.getInt(offsets[index]), detokenized[i]);
+      }
+    }
+    return results;
   }
 
   /**
@@ -59,8 +186,7 @@ public class Detokenizer {
     while (matcher.find()) {
       result.append(message, lastIndex, matcher.start());
 
-      String decoded =
-          detokenizeNative(handle, Base64.decode(matcher.group().substring(1), Base64.DEFAULT));
+      String decoded = detokenize(Base64.decode(matcher.group().substring(1), Base64.DEFAULT));
       result.append(decoded != null ? decoded : matcher.group());
 
       lastIndex = matcher.end();
@@ -70,6 +196,21 @@ public class Detokenizer {
     return result.toString();
   }
 
+  private String lookUp(int token) {
+    synchronized (cache) {
+      return cache.get(token);
+    }
+  }
+
+  private String cache(int token, String detokenized) {
+    if (detokenized != null) {
+      synchronized (cache) {
+        cache.put(token, detokenized);
+      }
+    }
+    return detokenized;
+  }
+
   /** Deletes memory allocated in C++ when this class is garbage collected. */
   @Override
   protected void finalize() {
@@ -87,5 +228,13 @@ public class Detokenizer {
    * reference held while the function is running, which prevents finalize from running before
    * detokenizeNative finishes.
    */
-  private native String detokenizeNative(long handle, byte[] data);
+  private native String detokenizeNative(long handle, byte[] data, int offset, int length);
+
+  /** Detokenizes data in a direct ByteBuffer without copying it. */
+  private native String detokenizeDirectNative(
+      long handle, ByteBuffer buffer, int offset, int length);
+
+  /** Detokenizes several messages in a direct ByteBuffer in one call. */
+  private native String[] detokenizeBatchNative(
+      long handle, ByteBuffer buffer, int[] offsets, int[] lengths);
 }
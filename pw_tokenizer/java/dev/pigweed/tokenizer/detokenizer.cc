@@ -45,6 +45,24 @@ jlong PointerToHandle(Detokenizer* detokenizer) {
   return handle;
 }
 
+// Returns a new Java String for the result, or null if no strings matched.
+jstring ToJavaString(JNIEnv* env, const DetokenizedString& result) {
+  return result.matches().empty()
+             ? nullptr
+             : env->NewStringUTF(result.BestString().c_str());
+}
+
+// Returns the address of a direct ByteBuffer, or throws
+// IllegalArgumentException and returns null if the buffer is not direct.
+const jbyte* DirectBufferAddress(JNIEnv* env, jobject buffer) {
+  const void* address = env->GetDirectBufferAddress(buffer);
+  if (address == nullptr) {
+    env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"),
+                  "The ByteBuffer must be direct");
+  }
+  return static_cast<const jbyte*>(address);
+}
+
 }  // namespace
 
 extern "C" {
@@ -61,7 +79,7 @@ JNIEXPORT jlong DETOKENIZER_METHOD(newNativeDetokenizer)(JNIEnv* env,
   const jlong handle =
       PointerToHandle(new Detokenizer(tokens.ok() ? tokens : TokenDatabase()));
 
-  env->ReleaseByteArrayElements(array, data, 0);
+  env->ReleaseByteArrayElements(array, data, JNI_ABORT);
   return handle;
 }
 
@@ -74,17 +92,73 @@ JNIEXPORT void DETOKENIZER_METHOD(deleteNativeDetokenizer)(JNIEnv*,
 JNIEXPORT jstring DETOKENIZER_METHOD(detokenizeNative)(JNIEnv* env,
                                                        jobject,
                                                        jlong handle,
-                                                       jbyteArray array) {
-  jbyte* const data = env->GetByteArrayElements(array, nullptr);
-  const jsize size = env->GetArrayLength(array);
-
-  DetokenizedString result = HandleToPointer(handle)->Detokenize(data, size);
+                                                       jbyteArray array,
+                                                       jint offset,
+                                                       jint length) {
+  // Detokenizing makes no JNI calls, so the array may be accessed directly
+  // rather than copied. JNI_ABORT skips copying the unmodified data back.
+  jbyte* const data =
+      static_cast<jbyte*>(env->GetPrimitiveArrayCritical(array, nullptr));
+  DetokenizedString result =
+      HandleToPointer(handle)->Detokenize(data + offset, length);
+  env->ReleasePrimitiveArrayCritical(array, data, JNI_ABORT);
+
+  return ToJavaString(env, result);
+}
 
-  env->ReleaseByteArrayElements(array, data, 0);
+JNIEXPORT jstring DETOKENIZER_METHOD(detokenizeDirectNative)(JNIEnv* env,
+                                                             jobject,
+                                                             jlong handle,
+                                                             jobject buffer,
+                                                             jint offset,
+                                                             jint length) {
+  const jbyte* const data = DirectBufferAddress(env, buffer);
+  if (data == nullptr) {
+    return nullptr;
+  }
+  return ToJavaString(
+      env, HandleToPointer(handle)->Detokenize(data + offset, length));
+}
 
-  return result.matches().empty()
-             ? nullptr
-             : env->NewStringUTF(result.BestString().c_str());
+JNIEXPORT jobjectArray DETOKENIZER_METHOD(detokenizeBatchNative)(
+    JNIEnv* env,
+    jobject,
+    jlong handle,
+    jobject buffer,
+    jintArray offsets_array,
+    jintArray lengths_array) {
+  const jbyte* const data = DirectBufferAddress(env, buffer);
+  if (data == nullptr) {
+    return nullptr;
+  }
+
+  const jsize count = env->GetArrayLength(offsets_array);
+  jobjectArray results =
+      env->NewObjectArray(count, env->FindClass("java/lang/String"), nullptr);
+  if (results == nullptr) {
+    return nullptr;  // OutOfMemoryError was thrown.
+  }
+
+  jint* const offsets = env->GetIntArrayElements(offsets_array, nullptr);
+  jint* const lengths = env->GetIntArrayElements(lengths_array, nullptr);
+  const Detokenizer& detokenizer = *HandleToPointer(handle);
+
+  for (jsize i = 0; i < count; ++i) {
+    jstring string = ToJavaString(
+        env, detokenizer.Detokenize(data + offsets[i], lengths[i]));
+    if (string != nullptr) {
+      env->SetObjectArrayElement(results, i, string);
+      // Release each string's local reference so large batches do not
+      // overflow the local reference table.
+      env->DeleteLocalRef(string);
+    } else if (env->ExceptionCheck()) {
+      break;  // OutOfMemoryError was thrown.
+    }
+  }
+
+  env->ReleaseIntArrayElements(lengths_array, lengths, JNI_ABORT);
+  env->ReleaseIntArrayElements(offsets_array, offsets, JNI_ABORT);
+  return results;
 }
 
 }  // extern "C"
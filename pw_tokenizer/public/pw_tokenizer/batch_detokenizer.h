@@ -0,0 +1,122 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This file provides the BatchDetokenizer class, which detokenizes batches of
+// messages across a pool of threads. It is intended for host-side services
+// that ingest large volumes of tokenized logs:
+//
+//   Detokenizer detok(TokenDatabase::Create(data));
+//   BatchDetokenizer batch(detok, std::thread::hardware_concurrency());
+//
+//   batch.Detokenize(messages);
+//   for (size_t i = 0; i < batch.size(); ++i) {
+//     std::cout << batch[i] << '\n';
+//   }
+//
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "pw_tokenizer/detokenize.h"
+
+namespace pw::tokenizer {
+
+// Detokenizes batches of encoded messages with a fixed pool of threads.
+//
+// Each thread appends its results to its own string arena. The arenas and the
+// result table are cleared, but not freed, at the start of each batch, so once
+// they have grown to fit a typical batch, detokenizing allocates only for
+// per-argument decoding.
+//
+// A BatchDetokenizer is not thread safe; one thread at a time may call
+// Detokenize and read the results.
+class BatchDetokenizer {
+ public:
+  // Messages are claimed by threads in chunks of this many.
+  static constexpr size_t kChunkSize = 64;
+
+  // Creates a pool of thread_count threads, including the thread that calls
+  // Detokenize, so thread_count - 1 threads are started. A thread_count of 0
+  // or 1 detokenizes on the calling thread. The Detokenizer must outlive the
+  // BatchDetokenizer.
+  BatchDetokenizer(const Detokenizer& detokenizer, size_t thread_count);
+
+  BatchDetokenizer(const BatchDetokenizer&) = delete;
+  BatchDetokenizer& operator=(const BatchDetokenizer&) = delete;
+
+  // Stops and joins the threads.
+  ~BatchDetokenizer();
+
+  // Detokenizes each message, replacing the results of the previous batch.
+  // Blocks until all messages are done. Each result is the message's
+  // DetokenizedString::BestStringWithErrors().
+  void Detokenize(std::span<const std::span<const uint8_t>> messages);
+
+  // Number of results from the last batch.
+  size_t size() const { return results_.size(); }
+
+  // Returns the result for the message at this index in the last batch. The
+  // string is valid until the next call to Detokenize.
+  std::string_view operator[](size_t index) const {
+    const Result& result = results_[index];
+    return std::string_view(arenas_[result.arena]).substr(result.offset,
+                                                          result.size);
+  }
+
+  // Number of threads that detokenize, including the calling thread.
+  size_t thread_count() const { return arenas_.size(); }
+
+ private:
+  // Where a result is stored. Offsets are used rather than pointers, since an
+  // arena may be reallocated as it grows.
+  struct Result {
+    size_t arena;
+    size_t offset;
+    size_t size;
+  };
+
+  void WorkerLoop(size_t worker);
+
+  // Claims and detokenizes chunks of messages until none are left.
+  void ProcessMessages(size_t worker);
+
+  const Detokenizer& detokenizer_;
+
+  std::vector<std::string> arenas_;  // One per thread.
+  std::vector<Result> results_;
+
+  std::span<const std::span<const uint8_t>> messages_;
+  std::atomic<size_t> next_message_;
+
+  // Protects the batch state below and signals the start and end of batches.
+  std::mutex mutex_;
+  std::condition_variable batch_started_;
+  std::condition_variable batch_finished_;
+  uint64_t batch_;
+  size_t busy_workers_;
+  bool stopping_;
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace pw::tokenizer
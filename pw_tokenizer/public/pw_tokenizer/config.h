@@ -66,3 +66,13 @@ static_assert(PW_TOKENIZER_CFG_ARG_TYPES_SIZE_BYTES == 4 ||
 #ifndef PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES
 #define PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES 52
 #endif  // PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES
+
+// If true, PW_TOKENIZE_TO_GLOBAL_HANDLER_WITH_PAYLOAD in C++ encodes arguments
+// with an encoder generated for the argument types at the call site, rather
+// than the generic encoder that dispatches on each argument's type at runtime.
+// This makes encoding faster, but instantiates a separate encoding function for
+// each distinct combination of argument types. C code always uses the generic
+// encoder, as does C++14.
+#ifndef PW_TOKENIZER_CFG_SPECIALIZED_ENCODERS
+#define PW_TOKENIZER_CFG_SPECIALIZED_ENCODERS 0
+#endif  // PW_TOKENIZER_CFG_SPECIALIZED_ENCODERS
@@ -26,8 +26,10 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <mutex>
 #include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -72,8 +74,19 @@ class DetokenizedString {
 
 // Decodes and detokenizes strings from a TokenDatabase. This class builds a
 // hash table from the TokenDatabase to give O(1) token lookups.
+//
+// Format strings are parsed the first time their token is detokenized and the
+// parsed FormatStrings are cached, so constructing a Detokenizer from a large
+// database is cheap and each message only walks pre-split segments. Multiple
+// threads may detokenize with the same Detokenizer concurrently.
 class Detokenizer {
  public:
+  // Prefix of nested tokens, as written by PW_TOKEN_FMT().
+  static constexpr std::string_view kNestedTokenPrefix = "$#";
+
+  // How many levels of nested tokens are expanded by default.
+  static constexpr unsigned kDefaultNestedTokenRecursion = 9;
+
   // Constructs a detokenizer from a TokenDatabase. The TokenDatabase is not
   // referenced by the Detokenizer after construction; its memory can be freed.
   Detokenizer(const TokenDatabase& database);
@@ -91,8 +104,46 @@ class Detokenizer {
         std::span(static_cast<const uint8_t*>(encoded), size_bytes));
   }
 
+  // Decodes and detokenizes the encoded message and appends the result of
+  // DetokenizedString::BestStringWithErrors(), with nested tokens expanded, to
+  // output. If the token has a single match, this skips building a
+  // DetokenizedString, so detokenizing many messages into a reused string
+  // allocates less.
+  void AppendDetokenized(const std::span<const uint8_t>& encoded,
+                         std::string& output) const;
+
+  // Replaces nested tokens in detokenized text with their strings. A nested
+  // token is kNestedTokenPrefix followed by the token as 8 hexadecimal digits,
+  // as written by PW_TOKEN_FMT(). Nested tokens in the replacement strings are
+  // expanded too, up to max_recursion levels. Unknown tokens are left as is.
+  std::string ExpandNestedTokens(
+      std::string_view text,
+      unsigned max_recursion = kDefaultNestedTokenRecursion) const;
+
  private:
-  std::unordered_map<uint32_t, std::vector<TokenizedStringEntry>> database_;
+  // Appends text to output with its nested tokens expanded.
+  void AppendExpanded(std::string_view text,
+                      unsigned max_recursion,
+                      std::string& output) const;
+
+  // The strings for one token. Parsing is deferred until the token is first
+  // detokenized.
+  class TokenEntries {
+   public:
+    void Add(const char* string, uint32_t date_removed) {
+      strings_.emplace_back(string, date_removed);
+    }
+
+    // Returns the parsed format strings, parsing them on the first call.
+    std::span<const TokenizedStringEntry> formats() const;
+
+   private:
+    mutable std::vector<std::pair<std::string, uint32_t>> strings_;
+    mutable std::once_flag parsed_;
+    mutable std::vector<TokenizedStringEntry> formats_;
+  };
+
+  std::unordered_map<uint32_t, TokenEntries> database_;
 };
 
 }  // namespace pw::tokenizer
@@ -15,8 +15,11 @@
 
 #include <cstdarg>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <span>
+#include <type_traits>
+#include <utility>
 
 #include "pw_tokenizer/config.h"
 #include "pw_tokenizer/internal/argument_types.h"
@@ -34,6 +37,150 @@ size_t EncodeArgs(pw_tokenizer_ArgTypes types,
                   va_list args,
                   std::span<std::byte> output);
 
+namespace internal {
+
+// Encoders for individual arguments. Each returns the number of bytes written,
+// or 0 if the argument did not fit in the output.
+size_t EncodeInt(int value, std::span<std::byte> output);
+size_t EncodeInt64(int64_t value, std::span<std::byte> output);
+size_t EncodeFloat(float value, std::span<std::byte> output);
+size_t EncodeString(const char* string, std::span<std::byte> output);
+
+constexpr size_t ArgCount(pw_tokenizer_ArgTypes types) {
+  return types & PW_TOKENIZER_TYPE_COUNT_MASK;
+}
+
+constexpr pw_tokenizer_ArgTypes ArgTypeAt(pw_tokenizer_ArgTypes types,
+                                          size_t index) {
+  return (types >> (PW_TOKENIZER_TYPE_COUNT_SIZE_BITS + 2 * index)) & 0b11u;
+}
+
+// The index of the first string argument, or the argument count if there are
+// no strings. Strings have no maximum encoded size, so arguments after the
+// first string cannot be bounds checked ahead of time.
+constexpr size_t FirstStringIndex(pw_tokenizer_ArgTypes types) {
+  size_t index = 0;
+  while (index < ArgCount(types) &&
+         ArgTypeAt(types, index) != PW_TOKENIZER_ARG_TYPE_STRING) {
+    index += 1;
+  }
+  return index;
+}
+
+// The largest possible encoding of the arguments before the first string.
+constexpr size_t MaxPrefixEncodedSize(pw_tokenizer_ArgTypes types) {
+  size_t size = 0;
+  for (size_t i = 0; i < FirstStringIndex(types); ++i) {
+    switch (ArgTypeAt(types, i)) {
+      case PW_TOKENIZER_ARG_TYPE_INT:
+        size += 5;  // a ZigZag-encoded 32-bit varint
+        break;
+      case PW_TOKENIZER_ARG_TYPE_INT64:
+        size += 10;  // a ZigZag-encoded 64-bit varint
+        break;
+      default:
+        size += sizeof(float);
+        break;
+    }
+  }
+  return size;
+}
+
+// The encoders specialized by argument type require C++17.
+#if __cplusplus >= 201703L
+
+// ZigZag and LEB128 encodes a value into a buffer known to be large enough.
+inline std::byte* EncodeVarintUnchecked(int64_t value, std::byte* output) {
+  uint64_t zigzag =
+      (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+  while (zigzag >= 0x80u) {
+    *output++ = static_cast<std::byte>(zigzag | 0x80u);
+    zigzag >>= 7;
+  }
+  *output++ = static_cast<std::byte>(zigzag);
+  return output;
+}
+
+// Encodes one argument. Arguments before the first string were bounds checked
+// together by the caller, so they are written without checks.
+template <pw_tokenizer_ArgTypes kTypes, size_t kIndex>
+bool EncodeArgAt(va_list* args, std::byte*& output, std::byte* end) {
+  constexpr pw_tokenizer_ArgTypes kType = ArgTypeAt(kTypes, kIndex);
+  constexpr bool kChecked = kIndex >= FirstStringIndex(kTypes);
+  const std::span<std::byte> remaining(output, end - output);
+
+  size_t size;
+  if constexpr (kType == PW_TOKENIZER_ARG_TYPE_STRING) {
+    size = EncodeString(va_arg(*args, const char*), remaining);
+  } else if constexpr (kType == PW_TOKENIZER_ARG_TYPE_DOUBLE) {
+    const float value = static_cast<float>(va_arg(*args, double));
+    if constexpr (kChecked) {
+      size = EncodeFloat(value, remaining);
+    } else {
+      std::memcpy(output, &value, sizeof(value));
+      size = sizeof(value);
+    }
+  } else {
+    int64_t value;
+    if constexpr (kType == PW_TOKENIZER_ARG_TYPE_INT) {
+      value = va_arg(*args, int);
+    } else {
+      value = va_arg(*args, int64_t);
+    }
+    if constexpr (kChecked) {
+      size = EncodeInt64(value, remaining);
+    } else {
+      size = EncodeVarintUnchecked(value, output) - output;
+    }
+  }
+
+  output += size;
+  return size != 0u;
+}
+
+template <pw_tokenizer_ArgTypes kTypes, size_t... kIndices>
+size_t EncodeArgsUnrolled([[maybe_unused]] va_list* args,
+                          std::span<std::byte> output,
+                          std::index_sequence<kIndices...>) {
+  std::byte* position = output.data();
+  [[maybe_unused]] std::byte* const end = output.data() + output.size();
+
+  // Encode the arguments in order, stopping at the first that doesn't fit.
+  [[maybe_unused]] bool fits = true;
+  ((fits = fits && EncodeArgAt<kTypes, kIndices>(args, position, end)), ...);
+
+  return position - output.data();
+}
+
+#endif  // __cplusplus >= 201703L
+
+}  // namespace internal
+
+#if __cplusplus >= 201703L
+
+// Encodes arguments with types that are known at compile time. This produces
+// the same encoding as the EncodeArgs function above, but generates an encoder
+// for the specific argument types, which avoids the per-argument dispatch.
+// Arguments up to the first string are bounds checked with a single check.
+//
+// Each distinct kTypes value instantiates a separate encoder, so this trades
+// code size for speed.
+template <pw_tokenizer_ArgTypes kTypes>
+size_t EncodeArgs(va_list args, std::span<std::byte> output) {
+  if (output.size() < internal::MaxPrefixEncodedSize(kTypes)) {
+    return EncodeArgs(kTypes, args, output);
+  }
+
+  va_list copy;
+  va_copy(copy, args);
+  const size_t encoded_bytes = internal::EncodeArgsUnrolled<kTypes>(
+      &copy, output, std::make_index_sequence<internal::ArgCount(kTypes)>());
+  va_end(copy);
+  return encoded_bytes;
+}
+
+#endif  // __cplusplus >= 201703L
+
 // Encodes a tokenized message to a fixed size buffer. The size of the buffer is
 // determined by the PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES config macro.
 //
@@ -69,6 +216,18 @@ class EncodedMessage {
         types, args, std::span<std::byte>(data_).subspan(sizeof(token)));
   }
 
+#if __cplusplus >= 201703L
+  // Encodes a tokenized message with argument types known at compile time.
+  template <pw_tokenizer_ArgTypes kTypes>
+  EncodedMessage(pw_tokenizer_Token token,
+                 std::integral_constant<pw_tokenizer_ArgTypes, kTypes>,
+                 va_list args) {
+    std::memcpy(data_, &token, sizeof(token));
+    args_size_ = EncodeArgs<kTypes>(
+        args, std::span<std::byte>(data_).subspan(sizeof(token)));
+  }
+#endif  // __cplusplus >= 201703L
+
   // The binary-encoded tokenized message.
   const std::byte* data() const { return data_; }
 
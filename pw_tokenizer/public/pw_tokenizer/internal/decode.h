@@ -204,6 +204,11 @@ class DecodedFormatString {
   // that failed to decode.
   std::string value_with_errors() const;
 
+  // Append value() or value_with_errors() to an existing string, which avoids
+  // allocating a new string when the output buffer is reused.
+  void AppendValue(std::string& output) const;
+  void AppendValueWithErrors(std::string& output) const;
+
   bool ok() const { return remaining_bytes() == 0u && decoding_errors() == 0u; }
 
   // Returns the number of bytes that remained after decoding.
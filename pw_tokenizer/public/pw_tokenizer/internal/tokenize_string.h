@@ -17,6 +17,7 @@
 // PW_TOKENIZER_CFG_C_HASH_LENGTH. The options are:
 //
 //   - C++ hash constexpr function, which works for any hash length
+//   - C++14 hash constexpr function, equivalent to the C++17 function
 //   - C 80-character hash macro
 //   - C 96-character hash macro
 //   - C 128-character hash macro
@@ -25,6 +26,7 @@
 // and added to this file.
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define _PW_TOKENIZER_ENTRY_MAGIC UINT32_C(0xBAA98DEE)
@@ -94,7 +96,9 @@ Entry {
 
 #endif  // __cplusplus
 
-// In C++17, use a constexpr function to calculate the hash.
+// In C++, always use a constexpr function to calculate the hash. The hash
+// macros expand to an expression with hundreds of terms per string, which makes
+// translation units with many tokenized strings very slow to compile as C++.
 #if defined(__cpp_constexpr) && __cpp_constexpr >= 201304L && \
     defined(__cpp_inline_variables)
 
@@ -102,6 +106,38 @@ Entry {
 
 #define PW_TOKENIZER_STRING_TOKEN(format) ::pw::tokenizer::Hash(format)
 
+#elif defined(__cpp_constexpr) && __cpp_constexpr >= 201304L
+
+// pw_tokenizer/hash.h requires C++17, so C++14 uses this equivalent of
+// pw::tokenizer::Hash for string literals and character arrays.
+namespace pw {
+namespace tokenizer {
+namespace internal {
+
+template <size_t kSize>
+constexpr uint32_t Cpp14Hash(const char (&string)[kSize])
+    PW_NO_SANITIZE("unsigned-integer-overflow") {
+  static_assert(kSize > 0u, "Must have at least a null terminator");
+
+  // The length is hashed as if it were the first character.
+  uint32_t hash = kSize - 1;
+  uint32_t coefficient = 65599u;
+
+  for (size_t i = 0; i < kSize - 1; ++i) {
+    hash += coefficient * static_cast<uint8_t>(string[i]);
+    coefficient *= 65599u;
+  }
+
+  return hash;
+}
+
+}  // namespace internal
+}  // namespace tokenizer
+}  // namespace pw
+
+#define PW_TOKENIZER_STRING_TOKEN(format) \
+  ::pw::tokenizer::internal::Cpp14Hash(format)
+
 #else  // In C or older C++ code, use the hashing macro.
 
 #if PW_TOKENIZER_CFG_C_HASH_LENGTH == 80
@@ -137,4 +173,4 @@ Entry {
 
 #endif  // PW_TOKENIZER_CFG_C_HASH_LENGTH
 
-#endif  // __cpp_constexpr >= 201304L && defined(__cpp_inline_variables)
+#endif  // __cpp_constexpr >= 201304L
@@ -27,16 +27,16 @@ namespace pw::tokenizer {
 // of 8-byte entries and a table of null-terminated strings. The header
 // specifies the number of entries. Each entry contains information about a
 // tokenized string: the token and removal date, if any. All fields are
-// little-endian.
+// little-endian. Indexed databases add a string index after the string table.
 //
 //            Header
 //            ======
 //   Offset  Size  Field
 //   -----------------------------------
 //        0     6  Magic number (TOKENS)
-//        6     2  Version (00 00)
+//        6     2  Version (00 00 or 01 00)
 //        8     4  Entry count
-//       12     4  Reserved
+//       12     4  Index offset (0 if there is no string index)
 //
 //             Entry
 //             =====
@@ -48,8 +48,22 @@ namespace pw::tokenizer {
 // Entries are sorted by token. A string table with a null-terminated string for
 // each entry in order follows the entries.
 //
-// Entries are accessed by iterating over the database. A O(n) Find function is
-// also provided. In typical use, a TokenDatabase is preprocessed by a
+// An indexed database has a non-zero index offset, which is the offset from the
+// start of the database to the string index. The string index follows the
+// string table and holds a 4-byte offset for each entry, relative to the start
+// of the string table, to the entry's string. In an indexed database, entries
+// are guaranteed to be sorted by token; IsValid checks this. Readers that don't
+// know about the index treat it as trailing data.
+//
+// Version 1 databases are always indexed and have a deduplicated string table.
+// Each distinct string is stored once, and a string that ends another string
+// is stored as the end of that string. Several index entries may refer to the
+// same string, so the string table can only be read through the index. Readers
+// that only support version 0 reject version 1 databases.
+//
+// Entries are accessed by iterating over the database. A Find function is also
+// provided; it is O(log n) for indexed databases and O(n) otherwise. Neither
+// uses any RAM. In typical use, a TokenDatabase is preprocessed by a
 // Detokenizer into a std::unordered_map.
 class TokenDatabase {
  public:
@@ -84,22 +98,33 @@ class TokenDatabase {
   class Iterator {
    public:
     constexpr Iterator(const RawEntry* raw_entry, const char* string)
-        : raw_(raw_entry), string_(string) {}
+        : raw_(raw_entry), string_(string), index_(nullptr) {}
+
+    // Iterates with a string index. index points to the entry's offset in the
+    // string index and string_table to the start of the string table.
+    constexpr Iterator(const RawEntry* raw_entry,
+                       const char* string_table,
+                       const char* index)
+        : raw_(raw_entry), string_(string_table), index_(index) {}
 
     // Constructs a TokenDatabase::Entry for the entry this iterator refers to.
     constexpr Entry entry() const {
-      return {raw_->token, raw_->date_removed, string_};
+      return {raw_->token, raw_->date_removed, string()};
     }
 
     constexpr Iterator& operator++() {
       raw_ += 1;
+      if (index_ != nullptr) {
+        index_ += kIndexEntrySize;
+        return *this;
+      }
       // Move string_ to the character beyond the next null terminator.
       while (*string_++ != '\0') {
       }
       return *this;
     }
     constexpr Iterator operator++(int) {
-      Iterator previous(raw_, string_);
+      Iterator previous = *this;
       operator++();
       return previous;
     }
@@ -122,8 +147,13 @@ class TokenDatabase {
     }
 
    private:
+    constexpr const char* string() const {
+      return index_ == nullptr ? string_ : string_ + ReadUint32(index_);
+    }
+
     const RawEntry* raw_;
-    const char* string_;
+    const char* string_;  // the current string, or the string table if indexed
+    const char* index_;   // the current string index entry, if indexed
   };
 
   // A list of token entries returned from a Find operation. This object can be
@@ -153,12 +183,16 @@ class TokenDatabase {
   };
 
   // Returns true if the provided data is a valid token database. This checks
-  // the magic number ("TOKENS"), version (which must be 0), and that there is
-  // is one string for each entry in the database. A database with extra strings
-  // or other trailing data is considered valid.
+  // the magic number ("TOKENS"), version (which must be 0 or 1), and that there
+  // is one string for each entry in the database. For indexed databases, this
+  // also checks that the entries are sorted and the index matches the string
+  // table. For deduplicated (version 1) databases, this checks that each index
+  // entry refers to a string within the string table. A database with extra
+  // strings or other trailing data is considered valid.
   template <typename ByteArray>
   static constexpr bool IsValid(const ByteArray& bytes) {
-    return HasValidHeader(bytes) && EachEntryHasAString(bytes);
+    return HasValidHeader(bytes) && EachEntryHasAString(bytes) &&
+           HasValidIndex(bytes);
   }
 
   // Creates a TokenDatabase and checks if the provided data is valid at compile
@@ -177,6 +211,10 @@ class TokenDatabase {
     static_assert(EachEntryHasAString<decltype(kDatabaseBytes)>(kDatabaseBytes),
                   "The database must have at least one string for each entry.");
 
+    static_assert(HasValidIndex<decltype(kDatabaseBytes)>(kDatabaseBytes),
+                  "Indexed databases must be sorted by token and the index "
+                  "must refer to each string in the string table.");
+
     return TokenDatabase(std::data(kDatabaseBytes));
   }
 
@@ -194,9 +232,13 @@ class TokenDatabase {
                : TokenDatabase();  // Invalid database.
   }
   // Creates a database with no data. ok() returns false.
-  constexpr TokenDatabase() : begin_{.data = nullptr}, end_{.data = nullptr} {}
+  constexpr TokenDatabase()
+      : begin_{.data = nullptr},
+        end_{.data = nullptr},
+        index_{.data = nullptr} {}
 
-  // Returns all entries associated with this token. This is a O(n) operation.
+  // Returns all entries associated with this token. This is a O(log n)
+  // operation for indexed databases and a O(n) operation otherwise.
   Entries Find(uint32_t token) const;
 
   // Returns the total number of entries (unique token-string pairs).
@@ -207,7 +249,13 @@ class TokenDatabase {
   // True if this database was constructed with valid data.
   constexpr bool ok() const { return begin_.data != nullptr; }
 
-  Iterator begin() const { return Iterator(begin_.entry, end_.data); }
+  // True if this database has a string index, which makes Find O(log n).
+  constexpr bool indexed() const { return index_.data != nullptr; }
+
+  Iterator begin() const {
+    return indexed() ? Iterator(begin_.entry, end_.data, index_.data)
+                     : Iterator(begin_.entry, end_.data);
+  }
   Iterator end() const { return Iterator(end_.entry, nullptr); }
 
  private:
@@ -215,9 +263,12 @@ class TokenDatabase {
     std::array<char, 6> magic;
     uint16_t version;
     uint32_t entry_count;
-    uint32_t reserved;
+    uint32_t index_offset;
   };
 
+  // Size of each offset in the string index.
+  static constexpr size_t kIndexEntrySize = sizeof(uint32_t);
+
   static_assert(sizeof(Header) == 2 * sizeof(RawEntry));
 
   template <typename ByteArray>
@@ -229,17 +280,28 @@ class TokenDatabase {
     }
 
     // Check the magic number and version.
-    for (size_t i = 0; i < kMagicAndVersion.size(); ++i) {
-      if (bytes[i] != kMagicAndVersion[i]) {
+    for (size_t i = 0; i < kMagic.size(); ++i) {
+      if (bytes[i] != kMagic[i]) {
         return false;
       }
     }
 
-    return true;
+    switch (ReadVersion(std::data(bytes))) {
+      case kVersion:
+        return true;
+      case kDeduplicatedVersion:
+        return ReadIndexOffset(std::data(bytes)) != 0u;
+      default:
+        return false;
+    }
   }
 
   template <typename ByteArray>
   static constexpr bool EachEntryHasAString(const ByteArray& bytes) {
+    if (ReadVersion(std::data(bytes)) == kDeduplicatedVersion) {
+      return true;  // Strings are shared, so they are checked with the index.
+    }
+
     const size_t entries = ReadEntryCount(std::data(bytes));
 
     // Check that the data is large enough to have a string table.
@@ -258,15 +320,112 @@ class TokenDatabase {
     return string_count >= entries;
   }
 
-  // Reads the number of entries from a database header. Cast to the bytes to
-  // uint8_t to avoid sign extension if T is signed.
+  template <typename ByteArray>
+  static constexpr bool HasValidIndex(const ByteArray& bytes) {
+    const auto* data = std::data(bytes);
+    const size_t index = ReadIndexOffset(data);
+    if (index == 0u) {
+      return true;  // Not indexed.
+    }
+
+    const size_t entries = ReadEntryCount(data);
+    const size_t string_table = StringTable(entries);
+
+    // The index must follow the string table and fit in the data.
+    if (index < string_table || index > std::size(bytes) ||
+        (std::size(bytes) - index) / kIndexEntrySize < entries) {
+      return false;
+    }
+
+    if (ReadVersion(data) == kDeduplicatedVersion) {
+      return HasValidDeduplicatedIndex(data, entries, string_table, index);
+    }
+
+    // Walk the string table to check that each index entry refers to the
+    // string that follows the previous one, and that entries are sorted.
+    size_t string = string_table;
+    for (size_t i = 0; i < entries; ++i) {
+      if (ReadUint32(data + index + i * kIndexEntrySize) !=
+          string - string_table) {
+        return false;
+      }
+      while (string < index && data[string] != '\0') {
+        string += 1;
+      }
+      if (string == index) {
+        return false;  // The string is not terminated before the index.
+      }
+      string += 1;
+
+      if (i != 0u && ReadEntryToken(data, i) < ReadEntryToken(data, i - 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Checks that each index entry refers to a string in the string table. The
+  // table ends with a null terminator, so every string in it is terminated.
+  template <typename T>
+  static constexpr bool HasValidDeduplicatedIndex(const T* data,
+                                                  size_t entries,
+                                                  size_t string_table,
+                                                  size_t index) {
+    if (entries == 0u) {
+      return true;
+    }
+    if (index == string_table || data[index - 1] != '\0') {
+      return false;
+    }
+
+    for (size_t i = 0; i < entries; ++i) {
+      if (ReadUint32(data + index + i * kIndexEntrySize) >=
+          index - string_table) {
+        return false;
+      }
+      if (i != 0u && ReadEntryToken(data, i) < ReadEntryToken(data, i - 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Reads a little-endian uint32_t. Cast to the bytes to uint8_t to avoid sign
+  // extension if T is signed.
+  template <typename T>
+  static constexpr uint32_t ReadUint32(const T* bytes) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(bytes[0])) |
+           static_cast<uint32_t>(static_cast<uint8_t>(bytes[1])) << 8 |
+           static_cast<uint32_t>(static_cast<uint8_t>(bytes[2])) << 16 |
+           static_cast<uint32_t>(static_cast<uint8_t>(bytes[3])) << 24;
+  }
+
+  // Reads the version from a database header.
+  template <typename T>
+  static constexpr uint16_t ReadVersion(const T* header_bytes) {
+    return static_cast<uint16_t>(
+        static_cast<uint8_t>(header_bytes[offsetof(Header, version)]) |
+        static_cast<uint8_t>(header_bytes[offsetof(Header, version) + 1])
+            << 8);
+  }
+
+  // Reads the number of entries from a database header.
   template <typename T>
   static constexpr uint32_t ReadEntryCount(const T* header_bytes) {
-    const T* bytes = header_bytes + offsetof(Header, entry_count);
-    return static_cast<uint8_t>(bytes[0]) |
-           static_cast<uint8_t>(bytes[1]) << 8 |
-           static_cast<uint8_t>(bytes[2]) << 16 |
-           static_cast<uint8_t>(bytes[3]) << 24;
+    return ReadUint32(header_bytes + offsetof(Header, entry_count));
+  }
+
+  // Reads the token of the entry at the given position.
+  template <typename T>
+  static constexpr uint32_t ReadEntryToken(const T* header_bytes,
+                                           size_t entry) {
+    return ReadUint32(header_bytes + sizeof(Header) + entry * sizeof(RawEntry));
+  }
+
+  // Reads the offset of the string index from a database header.
+  template <typename T>
+  static constexpr uint32_t ReadIndexOffset(const T* header_bytes) {
+    return ReadUint32(header_bytes + offsetof(Header, index_offset));
   }
 
   // Calculates the offset of the string table.
@@ -276,13 +435,18 @@ class TokenDatabase {
 
   // The magic number that starts the table is "TOKENS". The version is encoded
   // next as two bytes.
-  static constexpr std::array<char, 8> kMagicAndVersion = {
-      'T', 'O', 'K', 'E', 'N', 'S', '\0', '\0'};
+  static constexpr std::array<char, 6> kMagic = {'T', 'O', 'K', 'E', 'N', 'S'};
+
+  static constexpr uint16_t kVersion = 0;
+  static constexpr uint16_t kDeduplicatedVersion = 1;
 
   template <typename Byte>
   constexpr TokenDatabase(const Byte bytes[])
       : TokenDatabase(bytes + sizeof(Header),
-                      bytes + StringTable(ReadEntryCount(bytes))) {
+                      bytes + StringTable(ReadEntryCount(bytes)),
+                      ReadIndexOffset(bytes) == 0u
+                          ? nullptr
+                          : bytes + ReadIndexOffset(bytes)) {
     static_assert(sizeof(Byte) == 1u);
   }
 
@@ -290,23 +454,37 @@ class TokenDatabase {
   // use unions. Instead of using a reinterpret_cast to change the byte pointer
   // to a RawEntry pointer, have a separate overload for each byte pointer type
   // and store them in a union.
-  constexpr TokenDatabase(const char* begin, const char* end)
-      : begin_{.data = begin}, end_{.data = end} {}
-
-  constexpr TokenDatabase(const unsigned char* begin, const unsigned char* end)
-      : begin_{.unsigned_data = begin}, end_{.unsigned_data = end} {}
-
-  constexpr TokenDatabase(const signed char* begin, const signed char* end)
-      : begin_{.signed_data = begin}, end_{.signed_data = end} {}
+  constexpr TokenDatabase(const char* begin,
+                          const char* end,
+                          const char* index)
+      : begin_{.data = begin}, end_{.data = end}, index_{.data = index} {}
+
+  constexpr TokenDatabase(const unsigned char* begin,
+                          const unsigned char* end,
+                          const unsigned char* index)
+      : begin_{.unsigned_data = begin},
+        end_{.unsigned_data = end},
+        index_{.unsigned_data = index} {}
+
+  constexpr TokenDatabase(const signed char* begin,
+                          const signed char* end,
+                          const signed char* index)
+      : begin_{.signed_data = begin},
+        end_{.signed_data = end},
+        index_{.signed_data = index} {}
+
+  // Binary searches an indexed database.
+  Entries FindIndexed(uint32_t token) const;
 
   // Store the beginning and end pointers as a union to avoid breaking constexpr
-  // rules for reinterpret_cast.
+  // rules for reinterpret_cast. index_ points to the string index, or is null
+  // if the database is not indexed.
   union {
     const RawEntry* entry;
     const char* data;
     const unsigned char* unsigned_data;
     const signed char* signed_data;
-  } begin_, end_;
+  } begin_, end_, index_;
 };
 
 }  // namespace pw::tokenizer
@@ -0,0 +1,121 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace pw::tokenizer {
+
+// Maps the tokens of a tokenization domain to the dense indices 0 to size() - 1
+// with a minimal perfect hash, so firmware can check whether a token is in the
+// domain, or keep a counter or bit per token, in constant time.
+//
+// TokenIndex objects are generated from a token database with
+//
+//   database.py create --type cpp_index --database tokens.h ...
+//
+// which emits an inline constexpr TokenIndex, so the tables are placed in
+// read-only memory. Each token is hashed twice: once to pick a bucket, and once
+// with that bucket's seed to pick its index. Buckets of one token store the
+// index itself instead of a seed. The index's slot holds the token, so tokens
+// outside the domain are rejected with one compare. The tables take 4.5 bytes
+// per token.
+//
+// The hash must match TokenIndex in pw_tokenizer/token_index.py.
+template <size_t kTokenCount, size_t kBucketCount>
+class TokenIndex {
+ public:
+  // Seeds with this bit set hold the index of their bucket's only token.
+  static constexpr uint16_t kDirectIndex = 0x8000;
+
+  static_assert(kTokenCount <= kDirectIndex,
+                "A TokenIndex holds at most 32768 tokens");
+
+  // tokens[i] is the token at index i; seeds holds each bucket's seed.
+  constexpr TokenIndex(const uint32_t (&tokens)[kTokenCount],
+                       const uint16_t (&seeds)[kBucketCount])
+      : tokens_(ToArray(tokens)), seeds_(ToArray(seeds)) {}
+
+  // Number of tokens in the domain.
+  static constexpr size_t size() { return kTokenCount; }
+
+  // Returns the index of the token, or std::nullopt if it is not in the domain.
+  constexpr std::optional<size_t> Find(uint32_t token) const {
+    const uint32_t bucket = Reduce(Mix(token, 0), kBucketCount);
+    const uint16_t seed = seeds_[bucket];
+    const uint32_t slot = (seed & kDirectIndex) != 0u
+                              ? seed ^ kDirectIndex
+                              : Reduce(Mix(token, seed), kTokenCount);
+    if (tokens_[slot] != token) {
+      return std::nullopt;
+    }
+    return slot;
+  }
+
+  constexpr bool Contains(uint32_t token) const {
+    return Find(token).has_value();
+  }
+
+  // The token at an index.
+  constexpr uint32_t token(size_t index) const { return tokens_[index]; }
+
+ private:
+  // The murmur3 finalizer, applied to the token offset by the seed.
+  static constexpr uint32_t Mix(uint32_t token, uint32_t seed) {
+    uint32_t hash = token ^ (seed * 0x9e3779b9u);
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+  }
+
+  // Maps a hash to [0, size) with a multiply instead of a division.
+  static constexpr uint32_t Reduce(uint32_t hash, size_t size) {
+    return static_cast<uint32_t>((uint64_t{hash} * size) >> 32);
+  }
+
+  template <typename T, size_t kSize>
+  static constexpr std::array<T, kSize> ToArray(const T (&values)[kSize]) {
+    std::array<T, kSize> array{};
+    for (size_t i = 0; i < kSize; ++i) {
+      array[i] = values[i];
+    }
+    return array;
+  }
+
+  std::array<uint32_t, kTokenCount> tokens_;
+  std::array<uint16_t, kBucketCount> seeds_;
+};
+
+// The index of an empty domain.
+template <>
+class TokenIndex<0, 0> {
+ public:
+  static constexpr size_t size() { return 0; }
+
+  constexpr std::optional<size_t> Find(uint32_t) const { return std::nullopt; }
+
+  constexpr bool Contains(uint32_t) const { return false; }
+};
+
+template <size_t kTokenCount, size_t kBucketCount>
+TokenIndex(const uint32_t (&)[kTokenCount], const uint16_t (&)[kBucketCount])
+    -> TokenIndex<kTokenCount, kBucketCount>;
+
+}  // namespace pw::tokenizer
@@ -15,12 +15,14 @@
 
 #ifdef __cplusplus
 
+#include <cinttypes>
 #include <cstddef>
 #include <cstdint>
 
 #else
 
 #include <assert.h>
+#include <inttypes.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -81,6 +83,18 @@ typedef uint32_t pw_tokenizer_Token;
 #define _PW_TOKENIZER_MASK_TOKEN(mask, string_literal) \
   ((pw_tokenizer_Token)(mask)&PW_TOKENIZER_STRING_TOKEN(string_literal))
 
+// Format specifier for a nested token: a string argument, such as a state or
+// module name, that is sent as its token rather than as text. The argument is
+// a pw_tokenizer_Token from PW_TOKENIZE_STRING, which is encoded like any other
+// integer, in at most 5 bytes. Detokenizers replace the "$#" and 8 hexadecimal
+// digits that the specifier produces with the token's string. For example:
+//
+//   constexpr pw_tokenizer_Token kStandby = PW_TOKENIZE_STRING("STANDBY");
+//
+//   PW_TOKENIZE_TO_BUFFER(buffer, &size, "Entering " PW_TOKEN_FMT(), kStandby);
+//
+#define PW_TOKEN_FMT() "$#%08" PRIx32
+
 // Encodes a tokenized string and arguments to the provided buffer. The size of
 // the buffer is passed via a pointer to a size_t. After encoding is complete,
 // the size_t is set to the number of bytes written to the buffer.
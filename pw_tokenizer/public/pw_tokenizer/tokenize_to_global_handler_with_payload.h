@@ -57,12 +57,30 @@
     domain, mask, payload, format, ...)                                  \
   do {                                                                   \
     PW_TOKENIZE_FORMAT_STRING(domain, mask, format, __VA_ARGS__);        \
-    _pw_tokenizer_ToGlobalHandlerWithPayload(                            \
+    _PW_TOKENIZER_TO_GLOBAL_HANDLER_WITH_PAYLOAD(                        \
         payload,                                                         \
         _pw_tokenizer_token,                                             \
-        PW_TOKENIZER_ARG_TYPES(__VA_ARGS__) PW_COMMA_ARGS(__VA_ARGS__)); \
+        PW_TOKENIZER_ARG_TYPES(__VA_ARGS__),                             \
+        __VA_ARGS__);                                                    \
   } while (0)
 
+#if PW_TOKENIZER_CFG_SPECIALIZED_ENCODERS && defined(__cplusplus) && \
+    __cplusplus >= 201703L
+
+#define _PW_TOKENIZER_TO_GLOBAL_HANDLER_WITH_PAYLOAD(           \
+    payload, token, types, ...)                                 \
+  ::pw::tokenizer::internal::ToGlobalHandlerWithPayload<types>( \
+      payload, token PW_COMMA_ARGS(__VA_ARGS__))
+
+#else
+
+#define _PW_TOKENIZER_TO_GLOBAL_HANDLER_WITH_PAYLOAD( \
+    payload, token, types, ...)                       \
+  _pw_tokenizer_ToGlobalHandlerWithPayload(           \
+      payload, token, types PW_COMMA_ARGS(__VA_ARGS__))
+
+#endif  // PW_TOKENIZER_CFG_SPECIALIZED_ENCODERS && C++17
+
 PW_EXTERN_C_START
 
 typedef uintptr_t pw_tokenizer_Payload;
@@ -83,3 +101,33 @@ void _pw_tokenizer_ToGlobalHandlerWithPayload(pw_tokenizer_Payload payload,
                                               ...);
 
 PW_EXTERN_C_END
+
+#if PW_TOKENIZER_CFG_SPECIALIZED_ENCODERS && defined(__cplusplus) && \
+    __cplusplus >= 201703L
+
+#include <cstdarg>
+#include <type_traits>
+
+#include "pw_tokenizer/encode_args.h"
+
+namespace pw::tokenizer::internal {
+
+// Encodes with an encoder specialized for the argument types; see
+// PW_TOKENIZER_CFG_SPECIALIZED_ENCODERS.
+template <pw_tokenizer_ArgTypes kTypes>
+void ToGlobalHandlerWithPayload(pw_tokenizer_Payload payload,
+                                pw_tokenizer_Token token,
+                                ...) {
+  va_list args;
+  va_start(args, token);
+  EncodedMessage encoded(
+      token, std::integral_constant<pw_tokenizer_ArgTypes, kTypes>(), args);
+  va_end(args);
+
+  pw_tokenizer_HandleEncodedMessageWithPayload(
+      payload, encoded.data_as_uint8(), encoded.size());
+}
+
+}  // namespace pw::tokenizer::internal
+
+#endif  // PW_TOKENIZER_CFG_SPECIALIZED_ENCODERS && C++17
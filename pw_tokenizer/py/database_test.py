@@ -187,6 +187,17 @@ class DatabaseCommandLineTest(unittest.TestCase):
         self.assertEqual(CSV_DEFAULT_DOMAIN.splitlines(),
                          self._csv.read_text().splitlines())
 
+    def test_create_cpp_index(self):
+        header = self._dir / 'index.h'
+        run_cli('create', '--type', 'cpp_index', '--index-name', 'kTest',
+                '--index-namespace', 'test', '--database', header, self._elf)
+
+        text = header.read_text()
+        self.assertIn('inline constexpr pw::tokenizer::TokenIndex kTest(', text)
+        self.assertIn('namespace test {', text)
+        for line in CSV_DEFAULT_DOMAIN.splitlines():
+            self.assertIn(f'0x{line[:8]}u,', text)
+
     def test_add_does_not_recalculate_tokens(self):
         db_with_custom_token = '01234567,          ,"hello"'
 
@@ -247,6 +258,84 @@ class DatabaseCommandLineTest(unittest.TestCase):
             CSV_DEFAULT_DOMAIN.replace('Jello', sub).replace('Hello', sub),
             self._csv.read_text())
 
+    def test_create_with_elf_cache(self):
+        cache = self._dir / 'cache'
+        run_cli('create', '--elf-cache', cache, '--database', self._csv,
+                self._elf)
+        self.assertEqual(1, len(list(cache.iterdir())))
+
+        # pylint: disable=protected-access
+        with mock.patch.object(database,
+                               '_database_from_elf',
+                               wraps=database._database_from_elf) as read:
+            run_cli('create', '--force', '--elf-cache', cache, '--database',
+                    self._csv, self._elf)
+            read.assert_not_called()
+        # pylint: enable=protected-access
+
+        self.assertEqual(CSV_DEFAULT_DOMAIN.splitlines(),
+                         self._csv.read_text().splitlines())
+
+    def test_elf_cache_after_databases_fails(self):
+        with self.assertRaises(SystemExit), mock.patch('sys.stderr'):
+            run_cli('create', '--database', self._csv, self._elf,
+                    '--elf-cache', self._dir / 'cache')
+
+
+class ElfTokenCacheTest(unittest.TestCase):
+    """Tests reading ELF files through an ElfTokenCache."""
+    def setUp(self):
+        self._dir = Path(tempfile.mkdtemp('_pw_tokenizer_test'))
+        self._cache = database.ElfTokenCache(self._dir / 'cache')
+
+    def tearDown(self):
+        shutil.rmtree(self._dir)
+
+    def _load(self, elf: Path = TOKENIZED_ENTRIES_ELF, domain: str = ''):
+        return database.load_token_database(elf,
+                                            domain=domain,
+                                            elf_cache=self._cache)
+
+    def test_caches_each_elf_once(self):
+        first = self._load()
+        second = self._load()
+
+        self.assertEqual(1, self._cache.misses)
+        self.assertEqual(1, self._cache.hits)
+        self.assertEqual(str(first), str(second))
+        self.assertEqual(CSV_DEFAULT_DOMAIN, str(second))
+
+    def test_domains_are_cached_separately(self):
+        self.assertEqual(CSV_DEFAULT_DOMAIN, str(self._load()))
+        self.assertEqual(CSV_TEST_DOMAIN,
+                         str(self._load(domain='TEST_DOMAIN')))
+        self.assertEqual(CSV_ALL_DOMAINS, str(self._load(domain='.*')))
+
+        self.assertEqual(3, self._cache.misses)
+        self.assertEqual(0, self._cache.hits)
+
+    def test_changed_elf_is_read_again(self):
+        elf = self._dir / 'copy.elf'
+        shutil.copy(TOKENIZED_ENTRIES_ELF, elf)
+        self._load(elf)
+
+        shutil.copy(LEGACY_PLAIN_STRING_ELF, elf)
+        self.assertEqual('00000000,          ,""\n' + CSV_TEST_DOMAIN,
+                         str(self._load(elf, 'TEST_DOMAIN')))
+        self.assertEqual(2, self._cache.misses)
+
+    def test_corrupt_cache_entry_is_replaced(self):
+        self._load()
+        for path in self._cache.directory.iterdir():
+            path.write_bytes(b'TOKENS\0\0\xff')
+
+        # pylint: disable=protected-access
+        with mock.patch.object(database._LOG, 'warning'):
+            self.assertEqual(CSV_DEFAULT_DOMAIN, str(self._load()))
+        self.assertEqual(2, self._cache.misses)
+        self.assertEqual(CSV_DEFAULT_DOMAIN, str(self._load()))
+        self.assertEqual(1, self._cache.hits)
+
 
 class LegacyDatabaseCommandLineTest(DatabaseCommandLineTest):
     """Test an ELF with the legacy plain string storage format."""
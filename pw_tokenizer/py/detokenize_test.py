@@ -27,6 +27,7 @@ from unittest import mock
 from pw_tokenizer import database
 from pw_tokenizer import detokenize
 from pw_tokenizer import elf_reader
+from pw_tokenizer import encode
 from pw_tokenizer import tokens
 
 
@@ -314,27 +315,27 @@ class DetokenizeTest(unittest.TestCase):
 
 class DetokenizeWithCollisions(unittest.TestCase):
     """Tests collision resolution."""
+    # Database with several conflicting tokens.
+    DATABASE = tokens.Database([
+        tokens.TokenizedStringEntry(
+            0xbaad, 'REMOVED', date_removed=dt.datetime(9, 1, 1)),
+        tokens.TokenizedStringEntry(0xbaad, 'newer'),
+        tokens.TokenizedStringEntry(
+            0xbaad, 'A: %d', date_removed=dt.datetime(30, 5, 9)),
+        tokens.TokenizedStringEntry(
+            0xbaad, 'B: %c', date_removed=dt.datetime(30, 5, 10)),
+        tokens.TokenizedStringEntry(0xbaad, 'C: %s'),
+        tokens.TokenizedStringEntry(0xbaad, '%d%u'),
+        tokens.TokenizedStringEntry(0xbaad, '%s%u %d'),
+        tokens.TokenizedStringEntry(1, '%s'),
+        tokens.TokenizedStringEntry(1, '%d'),
+        tokens.TokenizedStringEntry(2, 'Three %s %s %s'),
+        tokens.TokenizedStringEntry(2, 'Five %d %d %d %d %s'),
+    ])  # yapf: disable
+
     def setUp(self):
         super().setUp()
-        token = 0xbaad
-
-        # Database with several conflicting tokens.
-        self.detok = detokenize.Detokenizer(tokens.Database([
-            tokens.TokenizedStringEntry(
-                token, 'REMOVED', date_removed=dt.datetime(9, 1, 1)),
-            tokens.TokenizedStringEntry(token, 'newer'),
-            tokens.TokenizedStringEntry(
-                token, 'A: %d', date_removed=dt.datetime(30, 5, 9)),
-            tokens.TokenizedStringEntry(
-                token, 'B: %c', date_removed=dt.datetime(30, 5, 10)),
-            tokens.TokenizedStringEntry(token, 'C: %s'),
-            tokens.TokenizedStringEntry(token, '%d%u'),
-            tokens.TokenizedStringEntry(token, '%s%u %d'),
-            tokens.TokenizedStringEntry(1, '%s'),
-            tokens.TokenizedStringEntry(1, '%d'),
-            tokens.TokenizedStringEntry(2, 'Three %s %s %s'),
-            tokens.TokenizedStringEntry(2, 'Five %d %d %d %d %s'),
-        ]))  # yapf: disable
+        self.detok = detokenize.Detokenizer(self.DATABASE)
 
     def test_collision_no_args_favors_most_recently_present(self):
         no_args = self.detok.detokenize(b'\xad\xba\0\0')
@@ -388,6 +389,21 @@ class DetokenizeWithCollisions(unittest.TestCase):
         self.assertIn('#0 -1', repr(unambiguous))
 
 
+class DetokenizeWithCollisionsMapped(DetokenizeWithCollisions):
+    """Runs the collision tests against a memory-mapped database."""
+    def setUp(self):
+        with tempfile.NamedTemporaryFile('wb', delete=False) as file:
+            tokens.write_deduplicated_binary(self.DATABASE, file)
+            self._path = file.name
+
+        self._database = tokens.MappedBinaryDatabase(self._path)
+        self.detok = detokenize.Detokenizer(self._database)
+
+    def tearDown(self):
+        self._database.close()
+        os.unlink(self._path)
+
+
 @mock.patch('os.path.getmtime')
 class AutoUpdatingDetokenizerTest(unittest.TestCase):
     """Tests the AutoUpdatingDetokenizer class."""
@@ -520,14 +536,18 @@ class DetokenizeBase64(unittest.TestCase):
          b'\'The secret message is "Jello, world!"\', said the spy.'),
     )
 
-    def setUp(self):
-        super().setUp()
+    @classmethod
+    def database(cls) -> tokens.Database:
         db = database.load_token_database(
             io.BytesIO(ELF_WITH_TOKENIZER_SECTIONS))
         db.add(
             tokens.TokenizedStringEntry(tokens.default_hash(s), s)
-            for s in [self.RECURSION_STRING, self.RECURSION_STRING_2])
-        self.detok = detokenize.Detokenizer(db)
+            for s in [cls.RECURSION_STRING, cls.RECURSION_STRING_2])
+        return db
+
+    def setUp(self):
+        super().setUp()
+        self.detok = detokenize.Detokenizer(self.database())
 
     def test_detokenize_base64_live(self):
         for data, expected in self.TEST_CASES:
@@ -589,5 +609,123 @@ class DetokenizeBase64InfiniteRecursion(unittest.TestCase):
             b'I said "$AwAAAA=="')
 
 
+class DetokenizeNestedTokens(unittest.TestCase):
+    """Tests detokenizing strings with PW_TOKEN_FMT() arguments."""
+    DATABASE = tokens.Database([
+        tokens.TokenizedStringEntry(1, 'Entering $#%08x'),
+        tokens.TokenizedStringEntry(2, 'STANDBY'),
+        tokens.TokenizedStringEntry(3, 'state $#00000002'),
+        tokens.TokenizedStringEntry(4, 'recursive $#00000004'),
+        tokens.TokenizedStringEntry(0x89abcdef, 'ACTIVE'),
+    ])
+
+    # Messages and their detokenized strings.
+    TEST_CASES = (
+        (encode.encode_token_and_args(1, 2), 'Entering STANDBY'),
+        (encode.encode_token_and_args(1, 0x89abcdef), 'Entering ACTIVE'),
+        (encode.encode_token_and_args(1, 3), 'Entering state STANDBY'),
+        (encode.encode_token_and_args(1, 5), 'Entering $#00000005'),
+    )
+
+    def setUp(self):
+        super().setUp()
+        self.detok = detokenize.Detokenizer(self.DATABASE, native=False)
+
+    def test_detokenize(self):
+        for data, expected in self.TEST_CASES:
+            self.assertEqual(str(self.detok.detokenize(data)), expected)
+            self.assertEqual(self.detok.detokenize_to_string(data), expected)
+
+    def test_expand_nested_tokens(self):
+        self.assertEqual(
+            self.detok.expand_nested_tokens('$#$#00000002 $#0000000 $#0x2'),
+            '$#STANDBY $#0000000 $#0x2')
+        self.assertEqual(self.detok.expand_nested_tokens('$#00000003'),
+                         'state STANDBY')
+
+    def test_expand_nested_tokens_recursion(self):
+        self.assertEqual(
+            self.detok.expand_nested_tokens('$#00000003', recursion=0),
+            'state $#00000002')
+        self.assertEqual(
+            self.detok.expand_nested_tokens('$#00000004', recursion=1),
+            'recursive recursive $#00000004')
+
+
+# Messages for DetokenizeWithCollisions.DATABASE that are detokenized the same
+# way in Python and C++. The C++ decoder does not range check %c arguments, so
+# b'\xad\xba\0\0\xfe\xff\xff\xff\x0f' resolves differently.
+_COLLISION_MESSAGES = (
+    b'\xad\xba\0\0',
+    b'\xad\xba\0\0\x7a',
+    b'\xad\xba\0\0\x02Hi',
+    b'\1\0\0\0\x83hi',
+    b'\2\0\0\0\1\2\1\4\5',
+    b'\xad\xba\0\0\x01#\x00\x01',
+    b'\xad\xba',
+    b'\xef\xbe\xad\xde',
+    b'',
+)
+
+
+@unittest.skipUnless(detokenize.NATIVE_DETOKENIZER_AVAILABLE,
+                     'the native detokenizer was not built')
+class NativeDetokenizerTest(unittest.TestCase):
+    """Tests that the native and Python detokenizers produce the same output."""
+    def _detokenizers(self, *database, **kwargs):
+        return (detokenize.Detokenizer(*database, native=False, **kwargs),
+                detokenize.Detokenizer(*database, native=True, **kwargs))
+
+    def _check_same(self, messages, *database, **kwargs):
+        python, native = self._detokenizers(*database, **kwargs)
+        for message in messages:
+            self.assertEqual(python.detokenize_to_string(message),
+                             native.detokenize_to_string(message),
+                             f'Detokenizing {message!r}')
+
+        self.assertEqual(python.detokenize_batch(messages),
+                         native.detokenize_batch(messages))
+        self.assertEqual(native.detokenize_batch(iter(messages)),
+                         native.detokenize_batch(messages))
+
+    def test_elf_database(self):
+        db = database.load_token_database(
+            io.BytesIO(ELF_WITH_TOKENIZER_SECTIONS))
+        self._check_same([
+            struct.pack('<I', entry.token) + b'\5\1\2'
+            for entry in db.entries()
+        ], db)
+
+    def test_collisions(self):
+        self._check_same(_COLLISION_MESSAGES,
+                         DetokenizeWithCollisions.DATABASE)
+
+    def test_collisions_show_errors(self):
+        self._check_same(_COLLISION_MESSAGES,
+                         DetokenizeWithCollisions.DATABASE,
+                         show_errors=True)
+
+    def test_unknown_token_is_none(self):
+        native = detokenize.Detokenizer(io.BytesIO(EMPTY_ELF), native=True)
+        self.assertIsNone(native.detokenize_to_string(b'\1\0\0\0'))
+        self.assertEqual(native.detokenize_batch([b'\1\0\0\0', b'']),
+                         [None, None])
+
+    def test_batch_requires_bytes(self):
+        native = detokenize.Detokenizer(io.BytesIO(EMPTY_ELF), native=True)
+        with self.assertRaises(TypeError):
+            native.detokenize_batch(['not bytes'])
+
+    def test_nested_tokens(self):
+        messages = [data for data, _ in DetokenizeNestedTokens.TEST_CASES]
+        self._check_same(messages, DetokenizeNestedTokens.DATABASE)
+
+    def test_base64_matches_python(self):
+        python, native = self._detokenizers(DetokenizeBase64.database())
+        for data, _ in DetokenizeBase64.TEST_CASES:
+            self.assertEqual(python.detokenize_base64(data),
+                             native.detokenize_base64(data))
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,295 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This file provides a CPython extension version of the Detokenizer class,
+// similar to the JNI version in java/dev/pigweed/tokenizer/detokenizer.cc.
+// pw_tokenizer.detokenize uses it, when available, to detokenize messages to
+// strings without decoding arguments in Python.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "pw_tokenizer/detokenize.h"
+#include "pw_tokenizer/token_database.h"
+
+namespace pw::tokenizer {
+namespace {
+
+// Detokenizes a message into output. Returns false if no strings matched the
+// token, in which case output is unchanged.
+bool DetokenizeToString(const Detokenizer& detokenizer,
+                        std::span<const uint8_t> message,
+                        bool show_errors,
+                        std::string& output) {
+  const DetokenizedString result = detokenizer.Detokenize(message);
+  if (result.matches().empty()) {
+    return false;
+  }
+
+  const size_t start = output.size();
+  if (show_errors) {
+    result.matches()[0].AppendValueWithErrors(output);
+  } else {
+    result.matches()[0].AppendValue(output);
+  }
+
+  if (output.find(Detokenizer::kNestedTokenPrefix, start) !=
+      std::string::npos) {
+    const std::string expanded =
+        detokenizer.ExpandNestedTokens(std::string_view(output).substr(start));
+    output.replace(start, std::string::npos, expanded);
+  }
+  return true;
+}
+
+// Arguments decoded from %s may contain invalid UTF-8, so replace it instead
+// of raising an exception.
+PyObject* ToPythonString(const char* data, size_t size) {
+  return PyUnicode_DecodeUTF8(data, Py_ssize_t(size), "replace");
+}
+
+struct DetokenizerObject {
+  PyObject_HEAD Detokenizer* detokenizer;
+};
+
+const Detokenizer& GetDetokenizer(PyObject* object) {
+  return *reinterpret_cast<DetokenizerObject*>(object)->detokenizer;
+}
+
+PyObject* Detokenizer_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+  static const char* keywords[] = {"database", nullptr};
+  Py_buffer database;
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "y*", const_cast<char**>(keywords), &database)) {
+    return nullptr;
+  }
+
+  const TokenDatabase tokens = TokenDatabase::Create(
+      std::span(static_cast<const uint8_t*>(database.buf),
+                size_t(database.len)));
+  if (!tokens.ok()) {
+    PyBuffer_Release(&database);
+    PyErr_SetString(PyExc_ValueError, "Invalid binary token database");
+    return nullptr;
+  }
+
+  DetokenizerObject* self =
+      reinterpret_cast<DetokenizerObject*>(type->tp_alloc(type, 0));
+  if (self != nullptr) {
+    // The Detokenizer copies the strings, so the database can be released.
+    self->detokenizer = new (std::nothrow) Detokenizer(tokens);
+    if (self->detokenizer == nullptr) {
+      Py_CLEAR(self);
+      PyErr_NoMemory();
+    }
+  }
+
+  PyBuffer_Release(&database);
+  return reinterpret_cast<PyObject*>(self);
+}
+
+void Detokenizer_dealloc(PyObject* object) {
+  PyTypeObject* type = Py_TYPE(object);
+  delete reinterpret_cast<DetokenizerObject*>(object)->detokenizer;
+  type->tp_free(object);
+  Py_DECREF(type);  // Instances of heap types hold a reference to the type.
+}
+
+PyObject* Detokenizer_detokenize(PyObject* self,
+                                 PyObject* args,
+                                 PyObject* kwds) {
+  static const char* keywords[] = {"message", "show_errors", nullptr};
+  Py_buffer message;
+  int show_errors = 0;
+  if (!PyArg_ParseTupleAndKeywords(args,
+                                   kwds,
+                                   "y*|p",
+                                   const_cast<char**>(keywords),
+                                   &message,
+                                   &show_errors)) {
+    return nullptr;
+  }
+
+  std::string output;
+  bool matched;
+  Py_BEGIN_ALLOW_THREADS;
+  matched = DetokenizeToString(
+      GetDetokenizer(self),
+      std::span(static_cast<const uint8_t*>(message.buf), size_t(message.len)),
+      show_errors != 0,
+      output);
+  Py_END_ALLOW_THREADS;
+  PyBuffer_Release(&message);
+
+  if (!matched) {
+    Py_RETURN_NONE;
+  }
+  return ToPythonString(output.data(), output.size());
+}
+
+PyObject* Detokenizer_detokenize_batch(PyObject* self,
+                                       PyObject* args,
+                                       PyObject* kwds) {
+  static const char* keywords[] = {"messages", "show_errors", nullptr};
+  PyObject* messages_arg;
+  int show_errors = 0;
+  if (!PyArg_ParseTupleAndKeywords(args,
+                                   kwds,
+                                   "O|p",
+                                   const_cast<char**>(keywords),
+                                   &messages_arg,
+                                   &show_errors)) {
+    return nullptr;
+  }
+
+  PyObject* messages =
+      PySequence_Fast(messages_arg, "messages must be a sequence of bytes");
+  if (messages == nullptr) {
+    return nullptr;
+  }
+
+  const Py_ssize_t count = PySequence_Fast_GET_SIZE(messages);
+  std::vector<std::span<const uint8_t>> encoded;
+  encoded.reserve(size_t(count));
+
+  for (Py_ssize_t i = 0; i < count; ++i) {
+    char* data;
+    Py_ssize_t size;
+    if (PyBytes_AsStringAndSize(
+            PySequence_Fast_GET_ITEM(messages, i), &data, &size) != 0) {
+      Py_DECREF(messages);
+      return nullptr;
+    }
+    encoded.emplace_back(reinterpret_cast<const uint8_t*>(data), size_t(size));
+  }
+
+  // Detokenize every message into one arena before creating any Python
+  // objects, so the GIL is only released once per batch. The bytes objects
+  // are immutable and referenced by messages, so their data stays valid.
+  struct Result {
+    size_t offset;
+    size_t size;
+    bool matched;
+  };
+  std::vector<Result> results(encoded.size());
+  std::string arena;
+
+  Py_BEGIN_ALLOW_THREADS;
+  const Detokenizer& detokenizer = GetDetokenizer(self);
+  for (size_t i = 0; i < encoded.size(); ++i) {
+    const size_t offset = arena.size();
+    const bool matched =
+        DetokenizeToString(detokenizer, encoded[i], show_errors != 0, arena);
+    results[i] = {offset, arena.size() - offset, matched};
+  }
+  Py_END_ALLOW_THREADS;
+  Py_DECREF(messages);
+
+  PyObject* list = PyList_New(count);
+  if (list == nullptr) {
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    PyObject* item;
+    if (results[i].matched) {
+      item = ToPythonString(arena.data() + results[i].offset, results[i].size);
+      if (item == nullptr) {
+        Py_DECREF(list);
+        return nullptr;
+      }
+    } else {
+      Py_INCREF(Py_None);
+      item = Py_None;
+    }
+    PyList_SET_ITEM(list, Py_ssize_t(i), item);
+  }
+  return list;
+}
+
+PyMethodDef detokenizer_methods[] = {
+    {"detokenize",
+     reinterpret_cast<PyCFunction>(
+         reinterpret_cast<void (*)()>(Detokenizer_detokenize)),
+     METH_VARARGS | METH_KEYWORDS,
+     "detokenize(message, show_errors=False) -> Optional[str]\n\n"
+     "Detokenizes a message to its most likely string. Returns None if no\n"
+     "strings match the message's token."},
+    {"detokenize_batch",
+     reinterpret_cast<PyCFunction>(
+         reinterpret_cast<void (*)()>(Detokenizer_detokenize_batch)),
+     METH_VARARGS | METH_KEYWORDS,
+     "detokenize_batch(messages, show_errors=False) -> List[Optional[str]]\n\n"
+     "Detokenizes a sequence of bytes messages, as detokenize() does, without\n"
+     "holding the GIL."},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+PyType_Slot detokenizer_slots[] = {
+    {Py_tp_doc,
+     const_cast<char*>("Detokenizer(database: bytes)\n\n"
+                       "Detokenizes messages with a binary token database.")},
+    {Py_tp_new, reinterpret_cast<void*>(Detokenizer_new)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(Detokenizer_dealloc)},
+    {Py_tp_methods, detokenizer_methods},
+    {0, nullptr},
+};
+
+PyType_Spec detokenizer_spec = {
+    "pw_tokenizer._native_detokenize.Detokenizer",
+    sizeof(DetokenizerObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    detokenizer_slots,
+};
+
+PyModuleDef native_detokenize_module = {
+    PyModuleDef_HEAD_INIT,
+    "pw_tokenizer._native_detokenize",
+    "Native detokenization for pw_tokenizer.detokenize.",
+    -1,
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr,
+};
+
+}  // namespace
+}  // namespace pw::tokenizer
+
+PyMODINIT_FUNC PyInit__native_detokenize() {
+  PyObject* module =
+      PyModule_Create(&pw::tokenizer::native_detokenize_module);
+  if (module == nullptr) {
+    return nullptr;
+  }
+
+  PyObject* detokenizer_type =
+      PyType_FromSpec(&pw::tokenizer::detokenizer_spec);
+  if (detokenizer_type == nullptr ||
+      PyModule_AddObject(module, "Detokenizer", detokenizer_type) != 0) {
+    Py_XDECREF(detokenizer_type);
+    Py_DECREF(module);
+    return nullptr;
+  }
+  return module;
+}
@@ -21,6 +21,8 @@ maintaining token databases.
 import argparse
 from datetime import datetime
 import glob
+import hashlib
+import io
 import json
 import logging
 import os
@@ -28,17 +30,18 @@ from pathlib import Path
 import re
 import struct
 import sys
-from typing import (Any, Callable, Dict, Iterable, Iterator, List, Pattern,
-                    Set, TextIO, Tuple, Union)
+import tempfile
+from typing import (Any, BinaryIO, Callable, Dict, Iterable, Iterator, List,
+                    Optional, Pattern, Set, TextIO, Tuple, Union)
 
 try:
-    from pw_tokenizer import elf_reader, tokens
+    from pw_tokenizer import elf_reader, token_index, tokens
 except ImportError:
     # Append this path to the module search path to allow running this module
     # without installing the pw_tokenizer package.
     sys.path.append(os.path.dirname(os.path.dirname(
         os.path.abspath(__file__))))
-    from pw_tokenizer import elf_reader, tokens
+    from pw_tokenizer import elf_reader, token_index, tokens
 
 _LOG = logging.getLogger('pw_tokenizer')
 
@@ -135,6 +138,73 @@ def _database_from_elf(elf, domain: Pattern[str]) -> tokens.Database:
     return tokens.Database([])
 
 
+class ElfTokenCache:
+    """Caches the tokenized strings read from ELF files.
+
+    The strings read from each ELF are stored as a binary token database in the
+    cache directory, named by a hash of the ELF's contents and the domain. Only
+    ELFs that changed since they were last read are parsed again. The cache
+    directory may be shared by concurrent processes.
+    """
+
+    # Change this when the cached contents for an ELF change.
+    _VERSION = b'1'
+
+    def __init__(self, directory: Union[str, Path]):
+        self.directory = Path(directory)
+        self.hits = 0
+        self.misses = 0
+
+    def _path(self, elf: BinaryIO, domain: Pattern[str]) -> Path:
+        digest = hashlib.sha256(self._VERSION)
+        digest.update(domain.pattern.encode() + b'\0')
+
+        elf.seek(0)
+        for chunk in iter(lambda: elf.read(1 << 20), b''):
+            digest.update(chunk)
+        elf.seek(0)
+
+        return self.directory / f'{digest.hexdigest()}.bin'
+
+    def database_from_elf(self, elf: BinaryIO,
+                          domain: Pattern[str]) -> tokens.Database:
+        """Reads the tokenized strings from an ELF file object or the cache."""
+        path = self._path(elf, domain)
+
+        try:
+            with path.open('rb') as fd:
+                database = tokens.Database(tokens.parse_binary(fd))
+        except FileNotFoundError:
+            pass
+        except (tokens.DatabaseFormatError, struct.error):
+            _LOG.warning('Ignoring corrupt cached tokens %s', path)
+        else:
+            self.hits += 1
+            _LOG.debug('Using cached tokens %s for %s', path, elf)
+            return database
+
+        self.misses += 1
+        database = _database_from_elf(elf, domain)
+
+        # Write to a temporary file and rename it so that other processes never
+        # read a partially written cache entry.
+        self.directory.mkdir(parents=True, exist_ok=True)
+        with tempfile.NamedTemporaryFile('wb', dir=self.directory,
+                                         delete=False) as fd:
+            tokens.write_binary(database, fd)
+        os.replace(fd.name, path)
+
+        return database
+
+
+def _read_elf(elf, domain: Pattern[str],
+              elf_cache: Optional[ElfTokenCache]) -> tokens.Database:
+    if elf_cache is None or isinstance(elf, elf_reader.Elf):
+        return _database_from_elf(elf, domain)
+
+    return elf_cache.database_from_elf(elf, domain)
+
+
 def tokenization_domains(elf) -> Iterator[str]:
     """Lists all tokenization domains in an ELF file."""
     reader = _elf_reader(elf)
@@ -166,7 +236,9 @@ def read_tokenizer_metadata(elf) -> Dict[str, int]:
     return metadata
 
 
-def _load_token_database(db, domain: Pattern[str]) -> tokens.Database:
+def _load_token_database(
+        db, domain: Pattern[str],
+        elf_cache: Optional[ElfTokenCache]) -> tokens.Database:
     """Loads a Database from a database object, ELF, CSV, or binary database."""
     if db is None:
         return tokens.Database()
@@ -174,6 +246,9 @@ def _load_token_database(db, domain: Pattern[str]) -> tokens.Database:
     if isinstance(db, tokens.Database):
         return db
 
+    if isinstance(db, tokens.MappedBinaryDatabase):
+        return tokens.Database(db.entries())
+
     if isinstance(db, elf_reader.Elf):
         return _database_from_elf(db, domain)
 
@@ -186,14 +261,14 @@ def _load_token_database(db, domain: Pattern[str]) -> tokens.Database:
         # Read the path as an ELF file.
         with open(db, 'rb') as fd:
             if elf_reader.compatible_file(fd):
-                return _database_from_elf(fd, domain)
+                return _read_elf(fd, domain, elf_cache)
 
         # Read the path as a packed binary or CSV file.
         return tokens.DatabaseFile(db)
 
     # Assume that it's a file object and check if it's an ELF.
     if elf_reader.compatible_file(db):
-        return _database_from_elf(db, domain)
+        return _read_elf(db, domain, elf_cache)
 
     # Read the database as CSV or packed binary from a file object's path.
     if hasattr(db, 'name') and os.path.exists(db.name):
@@ -204,12 +279,15 @@ def _load_token_database(db, domain: Pattern[str]) -> tokens.Database:
 
 
 def load_token_database(
-    *databases,
-    domain: Union[str,
-                  Pattern[str]] = tokens.DEFAULT_DOMAIN) -> tokens.Database:
-    """Loads a Database from database objects, ELFs, CSVs, or binary files."""
+        *databases,
+        domain: Union[str, Pattern[str]] = tokens.DEFAULT_DOMAIN,
+        elf_cache: Optional[ElfTokenCache] = None) -> tokens.Database:
+    """Loads a Database from database objects, ELFs, CSVs, or binary files.
+
+    If an ElfTokenCache is provided, tokens read from ELF files are cached.
+    """
     domain = re.compile(domain)
-    return tokens.Database.merged(*(_load_token_database(db, domain)
+    return tokens.Database.merged(*(_load_token_database(db, domain, elf_cache)
                                     for db in databases))
 
 
@@ -257,7 +335,7 @@ def generate_reports(paths: Iterable[Path]) -> _DatabaseReport:
 
 
 def _handle_create(databases, database, force, output_type, include, exclude,
-                   replace):
+                   replace, index_name, index_namespace):
     """Creates a token database file from one or more ELF files."""
 
     if database == '-':
@@ -277,6 +355,14 @@ def _handle_create(databases, database, force, output_type, include, exclude,
             tokens.write_csv(database, fd)
         elif output_type == 'binary':
             tokens.write_binary(database, fd)
+        elif output_type == 'indexed_binary':
+            tokens.write_indexed_binary(database, fd)
+        elif output_type == 'deduplicated_binary':
+            tokens.write_deduplicated_binary(database, fd)
+        elif output_type == 'cpp_index':
+            with io.TextIOWrapper(fd, encoding='utf-8') as text:
+                token_index.write_header(database, text, index_name,
+                                         index_namespace)
         else:
             raise ValueError(f'Unknown database type "{output_type}"')
 
@@ -344,38 +430,43 @@ class ExpandGlobs(argparse.Action):
         setattr(namespace, self.dest, list(expand_paths_or_globs(*values)))
 
 
-def _read_elf_with_domain(elf: str,
-                          domain: Pattern[str]) -> Iterable[tokens.Database]:
+def _read_elf_with_domain(
+        elf: str, domain: Pattern[str],
+        elf_cache: Optional[ElfTokenCache]) -> Iterable[tokens.Database]:
     for path in expand_paths_or_globs(elf):
         with path.open('rb') as file:
             if not elf_reader.compatible_file(file):
                 raise ValueError(f'{elf} is not an ELF file, '
                                  f'but the "{domain}" domain was specified')
 
-            yield _database_from_elf(file, domain)
+            yield _read_elf(file, domain, elf_cache)
 
 
 class LoadTokenDatabases(argparse.Action):
     """Argparse action that reads tokenize databases from paths or globs.
 
     ELF files may have #domain appended to them to specify a tokenization domain
-    other than the default.
+    other than the default. If the namespace has an ElfTokenCache in elf_cache,
+    it is used to read ELF files.
     """
     def __call__(self, parser, namespace, values, option_string=None):
         databases: List[tokens.Database] = []
         paths: Set[Path] = set()
+        elf_cache = getattr(namespace, 'elf_cache', None)
 
         try:
             for value in values:
                 if value.count('#') == 1:
                     path, domain = value.split('#')
                     domain = re.compile(domain)
-                    databases.extend(_read_elf_with_domain(path, domain))
+                    databases.extend(
+                        _read_elf_with_domain(path, domain, elf_cache))
                 else:
                     paths.update(expand_paths_or_globs(value))
 
             for path in paths:
-                databases.append(load_token_database(path))
+                databases.append(
+                    load_token_database(path, elf_cache=elf_cache))
         except tokens.DatabaseFormatError as err:
             parser.error(
                 f'argument elf_or_token_database: {path} is not a supported '
@@ -391,6 +482,16 @@ class LoadTokenDatabases(argparse.Action):
         setattr(namespace, self.dest, databases)
 
 
+class _ElfCacheDirectory(argparse.Action):
+    """Argparse action that creates an ElfTokenCache for LoadTokenDatabases."""
+    def __call__(self, parser, namespace, values, unused_option_string=None):
+        if getattr(namespace, 'databases', None) is not None:
+            parser.error(f'{self.option_strings[0]} must be specified before '
+                         'the token databases')
+
+        setattr(namespace, self.dest, ElfTokenCache(values))
+
+
 def token_databases_parser(nargs: str = '+') -> argparse.ArgumentParser:
     """Returns an argument parser for reading token databases.
 
@@ -431,6 +532,13 @@ def _parse_args():
                            help='The database file to update.')
 
     option_tokens = token_databases_parser('*')
+    option_tokens.add_argument(
+        '--elf-cache',
+        dest='elf_cache',
+        action=_ElfCacheDirectory,
+        help=('Directory in which to cache the tokens read from ELF files. '
+              'Only ELF files that changed since they were cached are read '
+              'again. Must be specified before the token databases.'))
 
     # Top-level argument parser.
     parser = argparse.ArgumentParser(
@@ -457,9 +565,24 @@ def _parse_args():
         '-t',
         '--type',
         dest='output_type',
-        choices=('csv', 'binary'),
+        choices=('csv', 'binary', 'indexed_binary', 'deduplicated_binary',
+                 'cpp_index'),
         default='csv',
-        help='Which type of database to create. (default: csv)')
+        help=('Which type of database to create. indexed_binary adds a string '
+              'index for O(log n) lookups in C++. deduplicated_binary is '
+              'indexed and stores each distinct string once; it is the most '
+              'compact format and can be memory mapped by '
+              'tokens.MappedBinaryDatabase. cpp_index is a C++ header with a '
+              'pw::tokenizer::TokenIndex that maps the tokens to dense '
+              'indices on the device. (default: csv)'))
+    subparser.add_argument(
+        '--index-name',
+        default='kTokenIndex',
+        help='Name of the TokenIndex for cpp_index. (default: kTokenIndex)')
+    subparser.add_argument(
+        '--index-namespace',
+        default='',
+        help='C++ namespace of the TokenIndex for cpp_index.')
     subparser.add_argument('-f',
                            '--force',
                            action='store_true',
@@ -569,6 +692,10 @@ def _parse_args():
     handler = args.handler
     del args.handler
 
+    # The ELF cache is only used while loading the token databases.
+    if hasattr(args, 'elf_cache'):
+        del args.elf_cache
+
     return handler, args
 
 
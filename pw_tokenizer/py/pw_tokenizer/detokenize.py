@@ -44,8 +44,9 @@ import string
 import struct
 import sys
 import time
-from typing import (AnyStr, BinaryIO, Callable, Dict, List, Iterable, Iterator,
-                    Match, NamedTuple, Optional, Pattern, Tuple, Union)
+from typing import (Any, AnyStr, BinaryIO, Callable, Dict, List, Iterable,
+                    Iterator, Match, NamedTuple, Optional, Pattern, Tuple,
+                    Union)
 
 try:
     from pw_tokenizer import database, decode, encode, tokens
@@ -56,12 +57,25 @@ except ImportError:
         os.path.abspath(__file__))))
     from pw_tokenizer import database, decode, encode, tokens
 
+try:
+    from pw_tokenizer import _native_detokenize  # type: ignore
+except ImportError:
+    _native_detokenize = None
+
 _LOG = logging.getLogger('pw_tokenizer')
 
+# True if the native detokenizer extension, which wraps the C++ Detokenizer, was
+# built. If it is not available, detokenization is done in pure Python.
+NATIVE_DETOKENIZER_AVAILABLE = _native_detokenize is not None
+
 ENCODED_TOKEN = struct.Struct('<I')
 BASE64_PREFIX = encode.BASE64_PREFIX.encode()
 DEFAULT_RECURSION = 9
 
+# Nested tokens, as written by PW_TOKEN_FMT(): "$#" and the token in hex.
+NESTED_TOKEN_PREFIX = '$#'
+_NESTED_TOKEN = re.compile(r'\$#([0-9A-Fa-f]{8})')
+
 
 class DetokenizedString:
     """A detokenized string, with all results if there are collisions."""
@@ -69,7 +83,8 @@ class DetokenizedString:
                  token: Optional[int],
                  format_string_entries: Iterable[tuple],
                  encoded_message: bytes,
-                 show_errors: bool = False):
+                 show_errors: bool = False,
+                 expand_nested: Optional[Callable[[str], str]] = None):
         self.token = token
         self.encoded_message = encoded_message
         self._show_errors = show_errors
@@ -82,6 +97,8 @@ class DetokenizedString:
         for entry, fmt in format_string_entries:
             result = fmt.format(encoded_message[ENCODED_TOKEN.size:],
                                 show_errors)
+            if expand_nested and NESTED_TOKEN_PREFIX in result.value:
+                result = result._replace(value=expand_nested(result.value))
 
             # Sort competing entries so the most likely matches appear first.
             # Decoded strings are prioritized by whether they
@@ -173,25 +190,63 @@ class _TokenizedFormatString(NamedTuple):
 
 class Detokenizer:
     """Main detokenization class; detokenizes strings and caches results."""
-    def __init__(self, *token_database_or_elf, show_errors: bool = False):
+    def __init__(self,
+                 *token_database_or_elf,
+                 show_errors: bool = False,
+                 native: Optional[bool] = None):
         """Decodes and detokenizes binary messages.
 
         Args:
           *token_database_or_elf: a path or file object for an ELF or CSV
-              database, a tokens.Database, or an elf_reader.Elf
+              database, a tokens.Database, or an elf_reader.Elf; a single
+              tokens.MappedBinaryDatabase is used without loading it
           show_errors: if True, an error message is used in place of the %
               conversion specifier when an argument fails to decode
+          native: whether to use the native C++ detokenizer for
+              detokenize_to_string, detokenize_batch, and the Base64
+              functions; by default, it is used if available
         """
         self.show_errors = show_errors
 
+        if native is None:
+            native = NATIVE_DETOKENIZER_AVAILABLE
+        elif native and not NATIVE_DETOKENIZER_AVAILABLE:
+            raise ImportError('The pw_tokenizer native detokenizer was not '
+                              'built')
+
+        self._use_native = native
+        self._native: Any = None
+
         # Cache FormatStrings for faster lookup & formatting.
         self._cache: Dict[int, List[_TokenizedFormatString]] = {}
 
         self._initialize_database(token_database_or_elf)
 
     def _initialize_database(self, token_sources: Iterable) -> None:
-        self.database = database.load_token_database(*token_sources)
+        token_sources = list(token_sources)
         self._cache.clear()
+        self.database: Union[tokens.Database, tokens.MappedBinaryDatabase]
+
+        # A memory-mapped database is used directly rather than loaded, so
+        # entries are only decoded when their tokens are looked up.
+        if (len(token_sources) == 1
+                and isinstance(token_sources[0], tokens.MappedBinaryDatabase)):
+            self.database = token_sources[0]
+            if self._use_native:
+                self._native = _native_detokenize.Detokenizer(
+                    bytes(self.database.data))
+            return
+
+        self.database = database.load_token_database(*token_sources)
+
+        if self._use_native:
+            binary_database = io.BytesIO()
+            tokens.write_binary(self.database, binary_database)
+            self._native = _native_detokenize.Detokenizer(
+                binary_database.getvalue())
+
+    def _reload_if_changed(self) -> None:
+        """Called before each lookup; subclasses may reload the database."""
 
     def lookup(self, token: int) -> List[_TokenizedFormatString]:
         """Returns (TokenizedStringEntry, FormatString) list for matches."""
@@ -213,7 +268,62 @@ class Detokenizer:
 
         token, = ENCODED_TOKEN.unpack_from(encoded_message)
         return DetokenizedString(token, self.lookup(token), encoded_message,
-                                 self.show_errors)
+                                 self.show_errors, self.expand_nested_tokens)
+
+    def expand_nested_tokens(self,
+                             text: str,
+                             recursion: int = DEFAULT_RECURSION) -> str:
+        """Replaces nested tokens in detokenized text with their strings.
+
+        A nested token is "$#" followed by the token as 8 hexadecimal digits,
+        as written by PW_TOKEN_FMT(). Nested tokens in the replacement strings
+        are expanded too, up to recursion levels. Unknown tokens are left as
+        is.
+        """
+        def expand(match: Match[str]) -> str:
+            token = int(match.group(1), 16)
+            entries = self.lookup(token)
+            if not entries:
+                return match.group(0)
+
+            result = DetokenizedString(token, entries,
+                                       ENCODED_TOKEN.pack(token)).best_result()
+            assert result is not None
+            if recursion > 0:
+                return self.expand_nested_tokens(result.value, recursion - 1)
+            return result.value
+
+        return _NESTED_TOKEN.sub(expand, text)
+
+    def detokenize_to_string(self, encoded_message: bytes) -> Optional[str]:
+        """Detokenizes a message to its most likely string.
+
+        This is equivalent to str(detokenize(encoded_message)), but returns
+        None if no strings match the message's token. It is much faster when
+        the native detokenizer is used, since no DetokenizedString is built.
+        """
+        if self._native is not None:
+            self._reload_if_changed()
+            return self._native.detokenize(encoded_message, self.show_errors)
+
+        result = self.detokenize(encoded_message)
+        return str(result) if result.matches() else None
+
+    def detokenize_batch(
+            self, encoded_messages: Iterable[bytes]) -> List[Optional[str]]:
+        """Detokenizes many bytes messages with detokenize_to_string.
+
+        With the native detokenizer, the whole batch is detokenized in one call
+        that does not hold the GIL, so other threads may run meanwhile.
+        """
+        if self._native is not None:
+            self._reload_if_changed()
+            return self._native.detokenize_batch(
+                encoded_messages if isinstance(encoded_messages,
+                                               (list, tuple)) else
+                list(encoded_messages), self.show_errors)
+
+        return [self.detokenize_to_string(msg) for msg in encoded_messages]
 
     def detokenize_base64(self,
                           data: AnyStr,
@@ -281,10 +391,10 @@ class Detokenizer:
             original = match.group(0)
 
             try:
-                detokenized_string = self.detokenize(
+                detokenized_string = self.detokenize_to_string(
                     base64.b64decode(original[1:], validate=True))
-                if detokenized_string.matches():
-                    result = str(detokenized_string).encode()
+                if detokenized_string is not None:
+                    result = detokenized_string.encode()
 
                     if recursion > 0 and original != result:
                         result = self.detokenize_base64(
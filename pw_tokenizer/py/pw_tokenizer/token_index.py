@@ -0,0 +1,169 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Builds minimal perfect hashes of tokens for pw::tokenizer::TokenIndex.
+
+The tokens of a database are mapped to the dense indices 0 to N - 1. The index
+is written as a C++ header with an inline constexpr pw::tokenizer::TokenIndex,
+which looks up tokens in constant time on the device.
+
+The hash MUST match pw_tokenizer/public/pw_tokenizer/token_index.h.
+"""
+
+from collections import defaultdict
+import re
+from typing import Dict, Iterable, List, Optional, TextIO
+
+from pw_tokenizer import tokens
+
+# Average number of tokens per bucket. Larger buckets take less memory, but
+# take longer to place.
+_BUCKET_SIZE = 4
+
+# Seeds with this bit set hold the index of their bucket's only token.
+DIRECT_INDEX = 0x8000
+MAX_TOKENS = DIRECT_INDEX
+
+_MASK = 0xFFFFFFFF
+
+
+def _mix(token: int, seed: int) -> int:
+    """The murmur3 finalizer, applied to the token offset by the seed."""
+    value = (token ^ (seed * 0x9e3779b9)) & _MASK
+    value ^= value >> 16
+    value = (value * 0x85ebca6b) & _MASK
+    value ^= value >> 13
+    value = (value * 0xc2b2ae35) & _MASK
+    value ^= value >> 16
+    return value
+
+
+def _reduce(value: int, size: int) -> int:
+    """Maps a 32-bit hash to [0, size)."""
+    return (value * size) >> 32
+
+
+class TokenIndex:
+    """A minimal perfect hash of a set of tokens."""
+    def __init__(self, token_values: Iterable[int]):
+        self.tokens: List[int] = sorted(set(token_values))
+        if len(self.tokens) > MAX_TOKENS:
+            raise ValueError(f'A TokenIndex holds at most {MAX_TOKENS} '
+                             f'tokens, not {len(self.tokens)}')
+
+        self.seeds: List[int] = []
+        if self.tokens:
+            self._build()
+
+    def _build(self) -> None:
+        size = len(self.tokens)
+        bucket_count = (size + _BUCKET_SIZE - 1) // _BUCKET_SIZE
+
+        buckets: Dict[int, List[int]] = defaultdict(list)
+        for token in self.tokens:
+            buckets[_reduce(_mix(token, 0), bucket_count)].append(token)
+
+        slots: List[Optional[int]] = [None] * size
+        self.seeds = [0] * bucket_count
+
+        # Place the largest buckets first, while most slots are free. Buckets
+        # of one token take whichever slots are left.
+        ordered = sorted(buckets.items(), key=lambda item: -len(item[1]))
+        free_slots = iter(range(size))
+
+        for bucket, members in ordered:
+            if len(members) == 1:
+                slot = next(s for s in free_slots if slots[s] is None)
+                slots[slot] = members[0]
+                self.seeds[bucket] = DIRECT_INDEX | slot
+                continue
+
+            for seed in range(1, DIRECT_INDEX):
+                placed = {_reduce(_mix(t, seed), size) for t in members}
+                if len(placed) == len(members) and all(slots[s] is None
+                                                       for s in placed):
+                    break
+            else:
+                raise ValueError(
+                    f'Failed to find a seed for {len(members)} tokens')
+
+            for token in members:
+                slots[_reduce(_mix(token, seed), size)] = token
+            self.seeds[bucket] = seed
+
+        assert all(token is not None for token in slots)
+        self.tokens = [token for token in slots if token is not None]
+
+    def __len__(self) -> int:
+        return len(self.tokens)
+
+    def find(self, token: int) -> Optional[int]:
+        """Returns the index of the token, or None if it is not present."""
+        if not self.tokens:
+            return None
+
+        seed = self.seeds[_reduce(_mix(token, 0), len(self.seeds))]
+        if seed & DIRECT_INDEX:
+            slot = seed ^ DIRECT_INDEX
+        else:
+            slot = _reduce(_mix(token, seed), len(self.tokens))
+
+        return slot if self.tokens[slot] == token else None
+
+
+_IDENTIFIER = re.compile(r'[A-Za-z_][A-Za-z0-9_]*')
+
+
+def write_header(database: tokens.Database,
+                 output: TextIO,
+                 name: str = 'kTokenIndex',
+                 namespace: str = '') -> None:
+    """Writes a C++ header that defines a TokenIndex of the database."""
+    if not _IDENTIFIER.fullmatch(name):
+        raise ValueError(f'"{name}" is not a valid C++ identifier')
+    if namespace and not all(
+            _IDENTIFIER.fullmatch(part) for part in namespace.split('::')):
+        raise ValueError(f'"{namespace}" is not a valid C++ namespace')
+
+    strings: Dict[int, str] = {}
+    for entry in sorted(database.entries()):
+        strings.setdefault(entry.token, entry.string)
+
+    index = TokenIndex(strings)
+
+    output.write('// Generated by pw_tokenizer/py/pw_tokenizer/database.py.\n'
+                 '// Do not edit.\n'
+                 '#pragma once\n\n'
+                 '#include "pw_tokenizer/token_index.h"\n\n')
+    if namespace:
+        output.write(f'namespace {namespace} {{\n\n')
+
+    if not index.tokens:
+        output.write(
+            f'inline constexpr pw::tokenizer::TokenIndex<0, 0> {name};\n')
+    else:
+        output.write(f'// {len(index)} tokens\n'
+                     f'inline constexpr pw::tokenizer::TokenIndex {name}(\n'
+                     '    {\n')
+        for token in index.tokens:
+            output.write(f'        0x{token:08x}u,  // '
+                         f'{strings[token][:48]!r}\n')
+        output.write('    },\n    {\n')
+        for i in range(0, len(index.seeds), 8):
+            seeds = ', '.join(f'0x{seed:04x}'
+                              for seed in index.seeds[i:i + 8])
+            output.write(f'        {seeds},\n')
+        output.write('    });\n')
+
+    if namespace:
+        output.write(f'\n}}  // namespace {namespace}\n')
@@ -19,6 +19,7 @@ from dataclasses import dataclass
 from datetime import datetime
 import io
 import logging
+import mmap
 from pathlib import Path
 import re
 import struct
@@ -327,8 +328,10 @@ class _BinaryFileFormat(NamedTuple):
     """Attributes of the binary token database file format."""
 
     magic: bytes = b'TOKENS\0\0'
-    header: struct.Struct = struct.Struct('<8sI4x')
+    deduplicated_magic: bytes = b'TOKENS\x01\0'
+    header: struct.Struct = struct.Struct('<8sII')
     entry: struct.Struct = struct.Struct('<IBBH')
+    index_entry: struct.Struct = struct.Struct('<I')
 
 
 BINARY_FORMAT = _BinaryFileFormat()
@@ -344,7 +347,7 @@ def file_is_binary_database(fd: BinaryIO) -> bool:
         fd.seek(0)
         magic = fd.read(len(BINARY_FORMAT.magic))
         fd.seek(0)
-        return BINARY_FORMAT.magic == magic
+        return magic in (BINARY_FORMAT.magic, BINARY_FORMAT.deduplicated_magic)
     except IOError:
         return False
 
@@ -371,28 +374,56 @@ def _check_that_file_is_csv_database(path: Path) -> None:
         ) from err
 
 
-def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
-    """Parses TokenizedStringEntries from a binary token database file."""
-    magic, entry_count = BINARY_FORMAT.header.unpack(
+def binary_database_is_indexed(fd: BinaryIO) -> bool:
+    """True if the binary token database has a string index."""
+    fd.seek(0)
+    _, _, index_offset = BINARY_FORMAT.header.unpack(
         fd.read(BINARY_FORMAT.header.size))
+    fd.seek(0)
+    return index_offset != 0
+
+
+def binary_database_is_deduplicated(fd: BinaryIO) -> bool:
+    """True if the binary token database has a deduplicated string table."""
+    fd.seek(0)
+    magic = fd.read(len(BINARY_FORMAT.deduplicated_magic))
+    fd.seek(0)
+    return magic == BINARY_FORMAT.deduplicated_magic
 
-    if magic != BINARY_FORMAT.magic:
+
+def _check_binary_magic(magic: bytes, source) -> None:
+    if magic not in (BINARY_FORMAT.magic, BINARY_FORMAT.deduplicated_magic):
         raise DatabaseFormatError(
             f'Binary token database magic number mismatch (found {magic!r}, '
-            f'expected {BINARY_FORMAT.magic!r}) while reading from {fd}')
+            f'expected {BINARY_FORMAT.magic!r} or '
+            f'{BINARY_FORMAT.deduplicated_magic!r}) while reading from '
+            f'{source}')
+
+
+def _date_removed(day: int, month: int, year: int) -> Optional[datetime]:
+    try:
+        return datetime(year, month, day)
+    except ValueError:
+        return None  # 0xff/0xff/0xffff means that the entry was not removed.
+
+
+def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
+    """Parses TokenizedStringEntries from a binary token database file.
+
+    The string index of indexed databases is only used if the string table is
+    deduplicated.
+    """
+    magic, entry_count, index_offset = BINARY_FORMAT.header.unpack(
+        fd.read(BINARY_FORMAT.header.size))
+
+    _check_binary_magic(magic, fd)
 
     entries = []
 
     for _ in range(entry_count):
         token, day, month, year = BINARY_FORMAT.entry.unpack(
             fd.read(BINARY_FORMAT.entry.size))
-
-        try:
-            date_removed: Optional[datetime] = datetime(year, month, day)
-        except ValueError:
-            date_removed = None
-
-        entries.append((token, date_removed))
+        entries.append((token, _date_removed(day, month, year)))
 
     # Read the entire string table and define a function for looking up strings.
     string_table = fd.read()
@@ -402,19 +433,80 @@ def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
         return string_table[start:string_table.find(b'\0', start)].decode(
         ), end + 1
 
+    if magic == BINARY_FORMAT.deduplicated_magic:
+        index = index_offset - (BINARY_FORMAT.header.size +
+                                BINARY_FORMAT.entry.size * entry_count)
+        for i, (token, removed) in enumerate(entries):
+            offset, = BINARY_FORMAT.index_entry.unpack_from(
+                string_table, index + i * BINARY_FORMAT.index_entry.size)
+            yield TokenizedStringEntry(token,
+                                       read_string(offset)[0], DEFAULT_DOMAIN,
+                                       removed)
+        return
+
     offset = 0
     for token, removed in entries:
         string, offset = read_string(offset)
         yield TokenizedStringEntry(token, string, DEFAULT_DOMAIN, removed)
 
 
-def write_binary(database: Database, fd: BinaryIO) -> None:
-    """Writes the database as packed binary to the provided binary file."""
-    entries = sorted(database.entries())
+def _deduplicated_string_table(
+        strings: Iterable[str]) -> Tuple[bytes, Dict[str, int]]:
+    """Builds a string table that stores each distinct string once.
+
+    A string that ends another string is stored as the end of that string.
+    Returns the table and the offset of each string in it.
+    """
+    # Sorting by the reversed strings puts strings right after the strings
+    # that end with them.
+    encoded = sorted(((string.encode(), string) for string in set(strings)),
+                     key=lambda item: item[0][::-1],
+                     reverse=True)
+
+    table = bytearray()
+    offsets: Dict[str, int] = {}
+    previous = b''
+    previous_offset = 0
+
+    for data, string in encoded:
+        if previous.endswith(data) and offsets:
+            offset = previous_offset + len(previous) - len(data)
+        else:
+            offset = len(table)
+            table += data
+            table.append(0)
+
+        offsets[string] = offset
+        previous, previous_offset = data, offset
 
-    fd.write(BINARY_FORMAT.header.pack(BINARY_FORMAT.magic, len(entries)))
+    return bytes(table), offsets
 
+
+def write_binary(database: Database,
+                 fd: BinaryIO,
+                 indexed: bool = False,
+                 deduplicated: bool = False) -> None:
+    """Writes the database as packed binary to the provided binary file.
+
+    If indexed is True, a string index with the offset of each entry's string is
+    written after the string table. Entries are always sorted by token, but the
+    index lets the C++ TokenDatabase rely on that and binary search for tokens.
+
+    If deduplicated is True, a version 1 database is written. Its string table
+    stores each distinct string once and strings that end other strings share
+    their storage. Deduplicated databases are always indexed.
+    """
+    entries = sorted(database.entries())
+
+    entry_table: List[bytes] = []
     string_table = bytearray()
+    string_index = bytearray()
+
+    offsets: Dict[str, int] = {}
+    if deduplicated:
+        indexed = True
+        pool, offsets = _deduplicated_string_table(e.string for e in entries)
+        string_table += pool
 
     for entry in entries:
         if entry.date_removed:
@@ -429,15 +521,163 @@ def write_binary(database: Database, fd: BinaryIO) -> None:
             removed_month = 0xff
             removed_year = 0xffff
 
-        string_table += entry.string.encode()
-        string_table.append(0)
+        if deduplicated:
+            string_index += BINARY_FORMAT.index_entry.pack(
+                offsets[entry.string])
+        else:
+            string_index += BINARY_FORMAT.index_entry.pack(len(string_table))
+            string_table += entry.string.encode()
+            string_table.append(0)
 
-        fd.write(
+        entry_table.append(
             BINARY_FORMAT.entry.pack(entry.token, removed_day, removed_month,
                                      removed_year))
 
+    index_offset = 0
+    if indexed:
+        index_offset = (BINARY_FORMAT.header.size +
+                        BINARY_FORMAT.entry.size * len(entries) +
+                        len(string_table))
+
+    fd.write(
+        BINARY_FORMAT.header.pack(
+            BINARY_FORMAT.deduplicated_magic
+            if deduplicated else BINARY_FORMAT.magic, len(entries),
+            index_offset))
+    fd.write(b''.join(entry_table))
     fd.write(string_table)
 
+    if indexed:
+        fd.write(string_index)
+
+
+def write_indexed_binary(database: Database, fd: BinaryIO) -> None:
+    """Writes the database as packed binary with a string index."""
+    write_binary(database, fd, indexed=True)
+
+
+def write_deduplicated_binary(database: Database, fd: BinaryIO) -> None:
+    """Writes the database as packed binary with a deduplicated string table."""
+    write_binary(database, fd, deduplicated=True)
+
+
+class _MappedTokenLookup:
+    """Maps tokens to entries like Database.token_to_entries, but on demand."""
+    def __init__(self, database: 'MappedBinaryDatabase'):
+        self._database = database
+
+    def __getitem__(self, token: int) -> List[TokenizedStringEntry]:
+        return self._database.find(token)
+
+    def __contains__(self, token: int) -> bool:
+        return bool(self._database.find(token))
+
+    def get(self, token: int, default=None):
+        return self._database.find(token) or default
+
+
+class MappedBinaryDatabase:
+    """Reads an indexed binary token database from a memory-mapped file.
+
+    Opening the database only reads its header, so it takes the same time for
+    any size of database. Entries are decoded when they are looked up, and the
+    mapped pages are shared by every process that opens the file. Lookups
+    binary search the entries, which are sorted by token in indexed databases.
+
+    This supports the lookups used by detokenize.Detokenizer. Use DatabaseFile
+    to modify a database.
+    """
+    def __init__(self, path: Union[Path, str]):
+        self.path = Path(path)
+
+        with self.path.open('rb') as fd:
+            if self.path.stat().st_size < BINARY_FORMAT.header.size:
+                raise DatabaseFormatError(
+                    f'{self.path} is too small to be a binary token database')
+            self._data = mmap.mmap(fd.fileno(), 0, access=mmap.ACCESS_READ)
+
+        magic, self._entry_count, self._index = (
+            BINARY_FORMAT.header.unpack_from(self._data))
+        _check_binary_magic(magic, self.path)
+
+        self._strings = (BINARY_FORMAT.header.size +
+                         BINARY_FORMAT.entry.size * self._entry_count)
+
+        if self._index == 0:
+            raise DatabaseFormatError(
+                f'{self.path} has no string index; only indexed binary token '
+                'databases can be memory mapped')
+        if (self._index < self._strings or self._index +
+                BINARY_FORMAT.index_entry.size * self._entry_count > len(
+                    self._data)):
+            raise DatabaseFormatError(
+                f'{self.path} has an invalid string index')
+
+    def close(self) -> None:
+        self._data.close()
+
+    def __enter__(self) -> 'MappedBinaryDatabase':
+        return self
+
+    def __exit__(self, *_) -> None:
+        self.close()
+
+    def __len__(self) -> int:
+        return self._entry_count
+
+    @property
+    def data(self) -> memoryview:
+        """The raw binary database."""
+        return memoryview(self._data)
+
+    @property
+    def token_to_entries(self) -> _MappedTokenLookup:
+        """Looks up the entries for a token, like Database.token_to_entries."""
+        return _MappedTokenLookup(self)
+
+    @staticmethod
+    def _entry_offset(i: int) -> int:
+        return BINARY_FORMAT.header.size + BINARY_FORMAT.entry.size * i
+
+    def _token(self, i: int) -> int:
+        return struct.unpack_from('<I', self._data, self._entry_offset(i))[0]
+
+    def _entry(self, i: int) -> TokenizedStringEntry:
+        token, day, month, year = BINARY_FORMAT.entry.unpack_from(
+            self._data, self._entry_offset(i))
+        offset, = BINARY_FORMAT.index_entry.unpack_from(
+            self._data, self._index + BINARY_FORMAT.index_entry.size * i)
+
+        start = self._strings + offset
+        end = self._data.find(b'\0', start, self._index)
+        if end == -1:
+            raise DatabaseFormatError(
+                f'The string for entry {i} in {self.path} is not terminated')
+
+        return TokenizedStringEntry(token, self._data[start:end].decode(),
+                                    DEFAULT_DOMAIN,
+                                    _date_removed(day, month, year))
+
+    def find(self, token: int) -> List[TokenizedStringEntry]:
+        """Returns the entries for a token; O(log n) in the database size."""
+        low, high = 0, self._entry_count
+        while low < high:
+            middle = (low + high) // 2
+            if self._token(middle) < token:
+                low = middle + 1
+            else:
+                high = middle
+
+        found = []
+        while low < self._entry_count and self._token(low) == token:
+            found.append(self._entry(low))
+            low += 1
+        return found
+
+    def entries(self) -> Iterator[TokenizedStringEntry]:
+        """Decodes every entry in the database."""
+        return (self._entry(i) for i in range(self._entry_count))
+
 
 class DatabaseFile(Database):
     """A token database that is associated with a particular file.
@@ -451,8 +691,13 @@ class DatabaseFile(Database):
         # Read the path as a packed binary file.
         with self.path.open('rb') as fd:
             if file_is_binary_database(fd):
+                if binary_database_is_deduplicated(fd):
+                    self._export = write_deduplicated_binary
+                elif binary_database_is_indexed(fd):
+                    self._export = write_indexed_binary
+                else:
+                    self._export = write_binary
                 super().__init__(parse_binary(fd))
-                self._export = write_binary
                 return
 
         # Read the path as a CSV file.
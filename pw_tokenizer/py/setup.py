@@ -17,6 +17,36 @@ Installing pw_tokenizer with this setup.py does not include the
 pw_tokenizer.proto package, since it contains a generated protobuf module. To
 access pw_tokenizer.proto, install pw_tokenizer from GN."""
 
+from pathlib import Path
+
 import setuptools  # type: ignore
 
-setuptools.setup()  # Package definition in setup.cfg
+# The native detokenizer wraps the C++ Detokenizer, so it can only be built
+# from a Pigweed checkout. It is optional; pw_tokenizer.detokenize falls back
+# to pure Python if it is not available.
+_PIGWEED_ROOT = Path(__file__).resolve().parent.parent.parent
+_NATIVE_SOURCES = [
+    'pw_tokenizer/_native_detokenize.cc',
+    _PIGWEED_ROOT / 'pw_tokenizer/decode.cc',
+    _PIGWEED_ROOT / 'pw_tokenizer/detokenize.cc',
+    _PIGWEED_ROOT / 'pw_varint/varint.cc',
+]
+_NATIVE_INCLUDE_DIRS = [
+    _PIGWEED_ROOT / 'pw_polyfill/public',
+    _PIGWEED_ROOT / 'pw_preprocessor/public',
+    _PIGWEED_ROOT / 'pw_tokenizer/public',
+    _PIGWEED_ROOT / 'pw_varint/public',
+]
+
+_EXTENSIONS = []
+
+if all(Path(path).exists() for path in _NATIVE_SOURCES[1:]):
+    _EXTENSIONS.append(
+        setuptools.Extension(
+            'pw_tokenizer._native_detokenize',
+            sources=[str(path) for path in _NATIVE_SOURCES],
+            include_dirs=[str(path) for path in _NATIVE_INCLUDE_DIRS],
+            extra_compile_args=['-std=c++20'],
+            optional=True))
+
+setuptools.setup(ext_modules=_EXTENSIONS)  # Package definition in setup.cfg
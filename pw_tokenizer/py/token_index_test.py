@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for the token_index module."""
+
+import io
+import random
+import unittest
+
+from pw_tokenizer import token_index, tokens
+
+
+class TokenIndexTest(unittest.TestCase):
+    """Tests building and searching TokenIndex objects."""
+    def _check_index(self, token_values) -> token_index.TokenIndex:
+        index = token_index.TokenIndex(token_values)
+        self.assertEqual(len(index), len(set(token_values)))
+        self.assertEqual(sorted(index.find(t) for t in set(token_values)),
+                         list(range(len(index))))
+        return index
+
+    def test_empty(self):
+        index = self._check_index([])
+        self.assertIsNone(index.find(0))
+
+    def test_small(self):
+        for count in range(1, 10):
+            self._check_index(list(range(count)))
+
+    def test_duplicate_tokens(self):
+        self._check_index([1, 2, 2, 3, 3, 3])
+
+    def test_random_tokens(self):
+        rng = random.Random(1)
+        values = rng.sample(range(2**32), 5000)
+        index = self._check_index(values)
+
+        present = set(values)
+        for token in rng.sample(range(2**32), 1000):
+            if token not in present:
+                self.assertIsNone(index.find(token))
+
+    def test_too_many_tokens(self):
+        with self.assertRaises(ValueError):
+            token_index.TokenIndex(range(token_index.MAX_TOKENS + 1))
+
+
+class WriteHeaderTest(unittest.TestCase):
+    """Tests writing a TokenIndex as a C++ header."""
+    def test_header(self):
+        db = tokens.Database.from_strings(['Hello %s', 'Goodbye', '%d'])
+        output = io.StringIO()
+        token_index.write_header(db, output, 'kIndex', 'foo::bar')
+        header = output.getvalue()
+
+        self.assertIn('#include "pw_tokenizer/token_index.h"', header)
+        self.assertIn('namespace foo::bar {', header)
+        self.assertIn('inline constexpr pw::tokenizer::TokenIndex kIndex(',
+                      header)
+        for entry in db.entries():
+            self.assertIn(f"0x{entry.token:08x}u,  // '{entry.string}'",
+                          header)
+
+    def test_empty_header(self):
+        output = io.StringIO()
+        token_index.write_header(tokens.Database(), output)
+        self.assertIn(
+            'inline constexpr pw::tokenizer::TokenIndex<0, 0> kTokenIndex;',
+            output.getvalue())
+
+    def test_invalid_names(self):
+        with self.assertRaises(ValueError):
+            token_index.write_header(tokens.Database(), io.StringIO(), '1x')
+        with self.assertRaises(ValueError):
+            token_index.write_header(tokens.Database(), io.StringIO(), 'k',
+                                     'foo::')
+
+
+if __name__ == '__main__':
+    unittest.main()
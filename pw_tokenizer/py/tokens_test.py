@@ -392,6 +392,95 @@ class TokenDatabaseTest(unittest.TestCase):
 
         self.assertEqual(str(db), CSV_DATABASE)
 
+    def test_indexed_binary_format_write(self):
+        db = tokens.Database(_entries('one', 'two', 'three'))
+
+        with io.BytesIO() as fd:
+            tokens.write_indexed_binary(db, fd)
+            binary_db = fd.getvalue()
+
+        entries = sorted(db.entries())
+        string_table = b''.join(e.string.encode() + b'\0' for e in entries)
+        index_offset = 16 + 8 * len(entries) + len(string_table)
+
+        self.assertEqual(
+            binary_db[:16],
+            b'TOKENS\0\0\x03\0\0\0' + bytes([index_offset, 0, 0, 0]))
+        self.assertEqual(
+            [int.from_bytes(binary_db[16 + 8 * i:20 + 8 * i], 'little')
+             for i in range(3)],
+            sorted(e.token for e in entries))
+        self.assertEqual(binary_db[16 + 8 * len(entries):index_offset],
+                         string_table)
+
+        offsets = [
+            int.from_bytes(binary_db[i:i + 4], 'little')
+            for i in range(index_offset, len(binary_db), 4)
+        ]
+        self.assertEqual(len(offsets), len(entries))
+        for offset, entry in zip(offsets, entries):
+            self.assertTrue(string_table[offset:].startswith(
+                entry.string.encode() + b'\0'))
+
+    def test_indexed_binary_format_parse(self):
+        db = read_db_from_csv(CSV_DATABASE)
+
+        with io.BytesIO() as fd:
+            tokens.write_indexed_binary(db, fd)
+            fd.seek(0)
+            self.assertTrue(tokens.binary_database_is_indexed(fd))
+            parsed = tokens.Database(tokens.parse_binary(fd))
+
+        self.assertEqual(str(parsed), CSV_DATABASE)
+
+        with io.BytesIO(BINARY_DATABASE) as fd:
+            self.assertFalse(tokens.binary_database_is_indexed(fd))
+
+    def test_deduplicated_binary_format_write(self):
+        db = tokens.Database([
+            tokens.TokenizedStringEntry(1, '%s items'),
+            tokens.TokenizedStringEntry(2, 'items'),
+            tokens.TokenizedStringEntry(3, '%s items'),
+            tokens.TokenizedStringEntry(4, 'other'),
+            tokens.TokenizedStringEntry(5, ''),
+        ])
+
+        with io.BytesIO() as fd:
+            tokens.write_deduplicated_binary(db, fd)
+            binary_db = fd.getvalue()
+
+        string_table = 16 + 8 * 5
+        self.assertEqual(binary_db[:16],
+                         b'TOKENS\x01\0\x05\0\0\0' +
+                         bytes([string_table + 15, 0, 0, 0]))
+
+        # Only '%s items' and 'other' are stored; the others share storage.
+        pool = binary_db[string_table:string_table + 15]
+        self.assertEqual(sorted(pool.split(b'\0')[:-1]),
+                         [b'%s items', b'other'])
+
+        offsets = [
+            int.from_bytes(binary_db[i:i + 4], 'little')
+            for i in range(string_table + 15, len(binary_db), 4)
+        ]
+        self.assertEqual(offsets[0], offsets[2])
+        for offset, entry in zip(offsets, sorted(db.entries())):
+            self.assertTrue(pool[offset:].startswith(entry.string.encode() +
+                                                     b'\0'))
+
+    def test_deduplicated_binary_format_parse(self):
+        db = read_db_from_csv(CSV_DATABASE)
+
+        with io.BytesIO() as fd:
+            tokens.write_deduplicated_binary(db, fd)
+            fd.seek(0)
+            self.assertTrue(tokens.file_is_binary_database(fd))
+            self.assertTrue(tokens.binary_database_is_indexed(fd))
+            self.assertTrue(tokens.binary_database_is_deduplicated(fd))
+            parsed = tokens.Database(tokens.parse_binary(fd))
+
+        self.assertEqual(str(parsed), CSV_DATABASE)
+
 
 class TestDatabaseFile(unittest.TestCase):
     """Tests the DatabaseFile class."""
@@ -415,6 +504,32 @@ class TestDatabaseFile(unittest.TestCase):
         self.assertEqual(self._path.read_text(),
                          CSV_DATABASE + 'ffffffff,          ,"New entry!"\n')
 
+    def test_update_indexed_binary_file_stays_indexed(self):
+        with self._path.open('wb') as fd:
+            tokens.write_indexed_binary(read_db_from_csv(CSV_DATABASE), fd)
+
+        db = tokens.DatabaseFile(self._path)
+        db.add([tokens.TokenizedStringEntry(0xffffffff, 'New entry!')])
+        db.write_to_file()
+
+        with self._path.open('rb') as fd:
+            self.assertTrue(tokens.binary_database_is_indexed(fd))
+            self.assertEqual(len(list(tokens.parse_binary(fd))), len(db))
+
+    def test_update_deduplicated_binary_file_stays_deduplicated(self):
+        with self._path.open('wb') as fd:
+            tokens.write_deduplicated_binary(read_db_from_csv(CSV_DATABASE),
+                                             fd)
+
+        db = tokens.DatabaseFile(self._path)
+        self.assertEqual(str(db), CSV_DATABASE)
+        db.add([tokens.TokenizedStringEntry(0xffffffff, 'New entry!')])
+        db.write_to_file()
+
+        with self._path.open('rb') as fd:
+            self.assertTrue(tokens.binary_database_is_deduplicated(fd))
+            self.assertEqual(len(list(tokens.parse_binary(fd))), len(db))
+
     def test_csv_file_too_short_raises_exception(self):
         self._path.write_text('1234')
 
@@ -434,6 +549,64 @@ class TestDatabaseFile(unittest.TestCase):
             tokens.DatabaseFile(self._path)
 
 
+class TestMappedBinaryDatabase(unittest.TestCase):
+    """Tests the MappedBinaryDatabase class."""
+    def setUp(self):
+        file = tempfile.NamedTemporaryFile(delete=False)
+        file.close()
+        self._path = Path(file.name)
+        self._db = read_db_from_csv(CSV_DATABASE)
+
+    def tearDown(self):
+        self._path.unlink()
+
+    def _write(self, write) -> None:
+        with self._path.open('wb') as fd:
+            write(self._db, fd)
+
+    def test_find(self):
+        for write in (tokens.write_indexed_binary,
+                      tokens.write_deduplicated_binary):
+            self._write(write)
+
+            with tokens.MappedBinaryDatabase(self._path) as mapped:
+                self.assertEqual(len(mapped), len(self._db))
+
+                for token, entries in self._db.token_to_entries.items():
+                    self.assertEqual(mapped.find(token), entries)
+                    self.assertEqual(mapped.token_to_entries[token], entries)
+
+                self.assertEqual(mapped.find(0x12345678), [])
+                self.assertNotIn(0x12345678, mapped.token_to_entries)
+
+    def test_find_removed_entry(self):
+        self._write(tokens.write_deduplicated_binary)
+
+        with tokens.MappedBinaryDatabase(self._path) as mapped:
+            entry, = mapped.find(0x2e668cd6)
+            self.assertEqual(entry.string, 'Jello, world!')
+            self.assertEqual(entry.date_removed, datetime.datetime(2019, 6, 11))
+
+    def test_entries(self):
+        self._write(tokens.write_deduplicated_binary)
+
+        with tokens.MappedBinaryDatabase(self._path) as mapped:
+            self.assertEqual(str(tokens.Database(mapped.entries())),
+                             CSV_DATABASE)
+
+    def test_unindexed_raises_exception(self):
+        self._write(tokens.write_binary)
+
+        with self.assertRaises(tokens.DatabaseFormatError):
+            tokens.MappedBinaryDatabase(self._path)
+
+    def test_not_a_database_raises_exception(self):
+        self._path.write_bytes(b'\x80' * 20)
+
+        with self.assertRaises(tokens.DatabaseFormatError):
+            tokens.MappedBinaryDatabase(self._path)
+
+
 class TestFilter(unittest.TestCase):
     """Tests the filtering functionality."""
     def setUp(self):
@@ -25,7 +25,8 @@ namespace tokenizer {
 namespace {
 
 template <size_t kSize>
-uint32_t TestHash(const char (&str)[kSize])
+uint32_t TestHash(const char (&str)[kSize],
+                  size_t hash_length = PW_TOKENIZER_CFG_C_HASH_LENGTH)
     PW_NO_SANITIZE("unsigned-integer-overflow") {
   static_assert(kSize > 0u, "Must have at least a null terminator");
 
@@ -35,8 +36,7 @@ uint32_t TestHash(const char (&str)[kSize])
   uint32_t hash = kSize - 1;
   uint32_t coefficient = k65599HashConstant;
 
-  size_t length =
-      std::min(static_cast<size_t>(PW_TOKENIZER_CFG_C_HASH_LENGTH), kSize - 1);
+  size_t length = std::min(hash_length, kSize - 1);
 
   // Hash all of the characters in the string as unsigned ints.
   // The coefficient calculation is done modulo 0x100000000, so the unsigned
@@ -65,6 +65,25 @@ TEST(TokenizeStringLiteral, GlobalVariable_MatchesHash) {
   EXPECT_EQ(TestHash(">:-[]"), kGlobalToken);
 }
 
+// Longer than the C hash macros support for any PW_TOKENIZER_CFG_C_HASH_LENGTH.
+#define LONG_STRING                           \
+  "0123456789012345678901234567890123456789" \
+  "0123456789012345678901234567890123456789" \
+  "0123456789012345678901234567890123456789" \
+  "0123456789012345678901234567890123456789" \
+  "0123456789012345678901234567890123456789" \
+  "0123456789012345678901234567890123456789" \
+  "0123456789012345678901234567890123456789" \
+  "end"
+
+TEST(TokenizeStringLiteral, LongString_HashesEntireString) {
+  // C++ always hashes with a constexpr function, which is not limited to the
+  // C hash macro length.
+  constexpr uint32_t token = PW_TOKENIZE_STRING(LONG_STRING);
+  EXPECT_EQ(TestHash(LONG_STRING, sizeof(LONG_STRING)), token);
+  EXPECT_NE(TestHash(LONG_STRING), token);
+}
+
 class TokenizeToBuffer : public ::testing::Test {
  public:
   TokenizeToBuffer() : buffer_{} {}
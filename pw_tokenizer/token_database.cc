@@ -14,6 +14,8 @@
 
 #include "pw_tokenizer/token_database.h"
 
+#include <algorithm>
+
 namespace pw::tokenizer {
 
 TokenDatabase::Entry TokenDatabase::Entries::operator[](size_t index) const {
@@ -25,6 +27,10 @@ TokenDatabase::Entry TokenDatabase::Entries::operator[](size_t index) const {
 }
 
 TokenDatabase::Entries TokenDatabase::Find(const uint32_t token) const {
+  if (indexed()) {
+    return FindIndexed(token);
+  }
+
   Iterator first = begin();
   while (first != end() && token > first->token) {
     ++first;
@@ -38,4 +44,20 @@ TokenDatabase::Entries TokenDatabase::Find(const uint32_t token) const {
   return Entries(first, last);
 }
 
+TokenDatabase::Entries TokenDatabase::FindIndexed(const uint32_t token) const {
+  const RawEntry* first = std::lower_bound(
+      begin_.entry, end_.entry, token, [](const RawEntry& entry, uint32_t t) {
+        return entry.token < t;
+      });
+  const RawEntry* last = std::upper_bound(
+      first, end_.entry, token, [](uint32_t t, const RawEntry& entry) {
+        return t < entry.token;
+      });
+
+  const size_t position = first - begin_.entry;
+  return Entries(
+      Iterator(first, end_.data, index_.data + position * kIndexEntrySize),
+      Iterator(last, nullptr));
+}
+
 }  // namespace pw::tokenizer
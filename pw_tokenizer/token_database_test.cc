@@ -238,6 +238,204 @@ TEST(TokenDatabase, MultipleEntriesWithSameToken) {
   }
 }
 
+// Indexed database with the string index after the string table at 0x43.
+alignas(TokenDatabase::RawEntry) constexpr char kIndexedData[] =
+    "TOKENS\0\0\x04\0\0\0\x43\0\0\0"
+    "\x01\0\0\0date"
+    "\x05\0\0\0date"
+    "\x05\0\0\0date"
+    "\xFF\0\0\0date"
+    "one\0five\0FIVE\0last\0"
+    "\x00\0\0\0"
+    "\x04\0\0\0"
+    "\x09\0\0\0"
+    "\x0e\0\0\0";
+
+constexpr TokenDatabase kIndexed = TokenDatabase::Create<kIndexedData>();
+static_assert(kIndexed.size() == 4u);
+static_assert(kIndexed.indexed());
+static_assert(!kBasicDatabase.indexed());
+
+TEST(TokenDatabase, Indexed_ValidCheck) {
+  static_assert(TokenDatabase::IsValid(kIndexedData));
+
+  // Entries are not sorted by token.
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\0\0\x02\0\0\0\x24\0\0\0"
+                              "\x02\0\0\0date"
+                              "\x01\0\0\0date"
+                              "a\0b\0"
+                              "\0\0\0\0\x02\0\0\0"sv));
+  static_assert(
+      TokenDatabase::IsValid("TOKENS\0\0\x02\0\0\0\x24\0\0\0"
+                             "\x01\0\0\0date"
+                             "\x02\0\0\0date"
+                             "a\0b\0"
+                             "\0\0\0\0\x02\0\0\0"sv));
+
+  // The second offset does not point to the second string.
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\0\0\x02\0\0\0\x24\0\0\0"
+                              "\x01\0\0\0date"
+                              "\x02\0\0\0date"
+                              "a\0b\0"
+                              "\0\0\0\0\x03\0\0\0"sv));
+
+  // The index is truncated.
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\0\0\x02\0\0\0\x24\0\0\0"
+                              "\x01\0\0\0date"
+                              "\x02\0\0\0date"
+                              "a\0b\0"
+                              "\0\0\0\0\x02\0\0"sv));
+
+  // The index starts inside the string table.
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\0\0\x02\0\0\0\x22\0\0\0"
+                              "\x01\0\0\0date"
+                              "\x02\0\0\0date"
+                              "a\0b\0"
+                              "\0\0\0\0\x02\0\0\0"sv));
+}
+
+TEST(TokenDatabase, Indexed_IteratesLikeUnindexed) {
+  auto it = kIndexed.begin();
+  EXPECT_STREQ((it++).entry().string, "one");
+  EXPECT_STREQ((it++).entry().string, "five");
+  EXPECT_STREQ((it++).entry().string, "FIVE");
+  EXPECT_STREQ((it++).entry().string, "last");
+  EXPECT_EQ(it, kIndexed.end());
+}
+
+TEST(TokenDatabase, Indexed_SingleEntryLookup) {
+  auto match = kIndexed.Find(1);
+  ASSERT_EQ(match.size(), 1u);
+  EXPECT_STREQ(match[0].string, "one");
+
+  match = kIndexed.Find(0xFF);
+  ASSERT_EQ(match.size(), 1u);
+  EXPECT_EQ(match.begin()->token, 0xFFu);
+  EXPECT_STREQ(match[0].string, "last");
+}
+
+TEST(TokenDatabase, Indexed_MultipleEntriesWithSameToken) {
+  TokenDatabase::Entries match = kIndexed.Find(5);
+
+  EXPECT_EQ(match.begin()->token, 5u);
+  EXPECT_EQ(match.end()->token, 0xFFu);
+  ASSERT_EQ(match.size(), 2u);
+
+  EXPECT_STREQ(match[0].string, "five");
+  EXPECT_STREQ(match[1].string, "FIVE");
+}
+
+TEST(TokenDatabase, Indexed_NonPresent) {
+  EXPECT_TRUE(kIndexed.Find(0).empty());
+  EXPECT_TRUE(kIndexed.Find(3).empty());
+  EXPECT_TRUE(kIndexed.Find(6).empty());
+  EXPECT_TRUE(kIndexed.Find(0xFFFFFFFFu).empty());
+}
+
+alignas(TokenDatabase::RawEntry) constexpr char kIndexedEmptyData[] =
+    "TOKENS\0\0\0\0\0\0\x10\0\0\0";
+
+TEST(TokenDatabase, Indexed_Empty) {
+  constexpr TokenDatabase empty_db = TokenDatabase::Create<kIndexedEmptyData>();
+  static_assert(empty_db.indexed());
+  EXPECT_TRUE(empty_db.Find(0).empty());
+}
+
+// Deduplicated database. Entries 1 and 3 share a string, and entry 2's string
+// is the end of it.
+alignas(TokenDatabase::RawEntry) constexpr char kDeduplicatedData[] =
+    "TOKENS\x01\0\x04\0\0\0\x3f\0\0\0"
+    "\x01\0\0\0date"
+    "\x02\0\0\0date"
+    "\x03\0\0\0date"
+    "\x04\0\0\0date"
+    "%s items\0other\0"
+    "\x00\0\0\0"
+    "\x03\0\0\0"
+    "\x00\0\0\0"
+    "\x09\0\0\0";
+
+constexpr TokenDatabase kDeduplicated =
+    TokenDatabase::Create<kDeduplicatedData>();
+static_assert(kDeduplicated.size() == 4u);
+static_assert(kDeduplicated.indexed());
+
+TEST(TokenDatabase, Deduplicated_ValidCheck) {
+  static_assert(TokenDatabase::IsValid(kDeduplicatedData));
+  static_assert(
+      TokenDatabase::IsValid("TOKENS\x01\0\x02\0\0\0\x22\0\0\0"
+                             "\x01\0\0\0date"
+                             "\x02\0\0\0date"
+                             "a\0"
+                             "\0\0\0\0\x01\0\0\0"sv));
+
+  // Deduplicated databases must be indexed.
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\x01\0\x01\0\0\0\0\0\0\0"
+                              "\x01\0\0\0date"
+                              "a\0"sv));
+
+  // An offset is past the end of the string table.
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\x01\0\x02\0\0\0\x22\0\0\0"
+                              "\x01\0\0\0date"
+                              "\x02\0\0\0date"
+                              "a\0"
+                              "\0\0\0\0\x02\0\0\0"sv));
+
+  // The string table is not null terminated.
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\x01\0\x02\0\0\0\x22\0\0\0"
+                              "\x01\0\0\0date"
+                              "\x02\0\0\0date"
+                              "ab"
+                              "\0\0\0\0\x01\0\0\0"sv));
+
+  // Unknown version.
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\x02\0\x01\0\0\0\x1a\0\0\0"
+                              "\x01\0\0\0date"
+                              "a\0"
+                              "\0\0\0\0"sv));
+}
+
+TEST(TokenDatabase, Deduplicated_Iterator) {
+  auto it = kDeduplicated.begin();
+  EXPECT_STREQ((it++).entry().string, "%s items");
+  EXPECT_STREQ((it++).entry().string, "items");
+  EXPECT_STREQ((it++).entry().string, "%s items");
+  EXPECT_STREQ((it++).entry().string, "other");
+  EXPECT_EQ(it, kDeduplicated.end());
+}
+
+TEST(TokenDatabase, Deduplicated_Find) {
+  auto match = kDeduplicated.Find(2);
+  ASSERT_EQ(match.size(), 1u);
+  EXPECT_STREQ(match[0].string, "items");
+
+  match = kDeduplicated.Find(3);
+  ASSERT_EQ(match.size(), 1u);
+  EXPECT_STREQ(match[0].string, "%s items");
+  EXPECT_EQ(match[0].string, kDeduplicated.Find(1)[0].string);
+
+  EXPECT_TRUE(kDeduplicated.Find(5).empty());
+}
+
+alignas(TokenDatabase::RawEntry) constexpr char kDeduplicatedEmptyData[] =
+    "TOKENS\x01\0\0\0\0\0\x10\0\0\0";
+
+TEST(TokenDatabase, Deduplicated_Empty) {
+  constexpr TokenDatabase empty_db =
+      TokenDatabase::Create<kDeduplicatedEmptyData>();
+  static_assert(empty_db.ok());
+  EXPECT_TRUE(empty_db.Find(0).empty());
+  EXPECT_EQ(empty_db.begin(), empty_db.end());
+}
+
 TEST(TokenDatabase, Empty) {
   constexpr TokenDatabase empty_db = TokenDatabase::Create<kEmptyData>();
   static_assert(empty_db.size() == 0u);
@@ -0,0 +1,99 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tokenizer/token_index.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_tokenizer/hash.h"
+
+namespace pw::tokenizer {
+namespace {
+
+// Generated with pw_tokenizer/py/pw_tokenizer/token_index.py, so these tests
+// check that the C++ and Python hashes match.
+constexpr TokenIndex kIndex(
+    {
+        0xc9be2adcu,  // 'Keep alive'
+        0x5d6a732au,  // 'Low battery'
+        0x5c056b1au,  // 'Unknown command 0x%02x'
+        0xd6ed9817u,  // 'Stack overflow in %s'
+        0x1dd9896bu,  // 'Reboot'
+        0x6be00138u,  // 'Hello, world'
+        0xf8fc7f16u,  // 'Goodbye'
+        0xfcf71032u,  // 'The answer is %d'
+        0xd186c41eu,  // 'Sensor %u: %d mV'
+        0xd967060du,  // '%s: %x'
+    },
+    {
+        0x0009,
+        0x0003,
+        0x0004,
+    });
+
+static_assert(kIndex.size() == 10u);
+static_assert(kIndex.Find(Hash("Keep alive")) == 0u);
+static_assert(kIndex.Find(Hash("%s: %x")) == 9u);
+static_assert(!kIndex.Contains(Hash("Not in the domain")));
+
+TEST(TokenIndex, Find_AllTokens) {
+  for (size_t i = 0; i < kIndex.size(); ++i) {
+    const std::optional<size_t> index = kIndex.Find(kIndex.token(i));
+    ASSERT_TRUE(index.has_value());
+    EXPECT_EQ(i, *index);
+  }
+}
+
+TEST(TokenIndex, Find_TokensFromStrings) {
+  EXPECT_EQ(6u, kIndex.Find(Hash("Goodbye")));
+  EXPECT_EQ(7u, kIndex.Find(Hash("The answer is %d")));
+  EXPECT_TRUE(kIndex.Contains(Hash("Low battery")));
+}
+
+TEST(TokenIndex, Find_OtherTokens) {
+  EXPECT_FALSE(kIndex.Find(0u).has_value());
+  EXPECT_FALSE(kIndex.Find(0xffffffffu).has_value());
+  EXPECT_FALSE(kIndex.Contains(Hash("Goodbye!")));
+
+  // Tokens outside the domain are rejected, whichever slot they map to.
+  uint32_t found = 0;
+  for (uint32_t token = 0; token < 100000u; ++token) {
+    found += kIndex.Contains(token) ? 1 : 0;
+  }
+  EXPECT_EQ(0u, found);
+}
+
+TEST(TokenIndex, CountPerToken) {
+  std::array<uint16_t, kIndex.size()> counts{};
+  for (uint32_t token : {Hash("Reboot"), Hash("Reboot"), Hash("Keep alive")}) {
+    if (const std::optional<size_t> index = kIndex.Find(token)) {
+      counts[*index] += 1;
+    }
+  }
+  EXPECT_EQ(2u, counts[4]);
+  EXPECT_EQ(1u, counts[0]);
+}
+
+TEST(TokenIndex, Empty) {
+  constexpr TokenIndex<0, 0> kEmpty;
+  static_assert(kEmpty.size() == 0u);
+  EXPECT_FALSE(kEmpty.Find(Hash("Goodbye")).has_value());
+  EXPECT_FALSE(kEmpty.Contains(0u));
+}
+
+}  // namespace
+}  // namespace pw::tokenizer
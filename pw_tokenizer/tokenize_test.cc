@@ -209,6 +209,24 @@ TEST_F(TokenizeToBuffer, Integer64Overflow) {
   }
 }
 
+TEST_F(TokenizeToBuffer, NestedToken) {
+  constexpr pw_tokenizer_Token kNested = PW_TOKENIZE_STRING("STANDBY");
+  size_t message_size = sizeof(buffer_);
+  PW_TOKENIZE_TO_BUFFER(
+      buffer_, &message_size, "Entering " PW_TOKEN_FMT(), kNested);
+
+  // The token is encoded like any other 32-bit integer argument.
+  uint8_t expected[sizeof(uint32_t) + 5];
+  const uint32_t format_token = Hash("Entering " PW_TOKEN_FMT());
+  std::memcpy(expected, &format_token, sizeof(format_token));
+  const size_t arg_size =
+      varint::Encode(static_cast<int32_t>(kNested),
+                     std::as_writable_bytes(std::span(expected))
+                         .subspan(sizeof(format_token)));
+  ASSERT_EQ(sizeof(format_token) + arg_size, message_size);
+  EXPECT_EQ(std::memcmp(expected, buffer_, message_size), 0);
+}
+
 TEST_F(TokenizeToBuffer, IntegerNegative) {
   size_t message_size = 9;
   PW_TOKENIZE_TO_BUFFER(
@@ -15,10 +15,14 @@
 include($ENV{PW_ROOT}/pw_build/pigweed.cmake)
 
 pw_set_backend(pw_assert pw_assert_log)
+pw_set_backend(pw_chrono.profiling_clock pw_chrono_stl.profiling_clock)
 pw_set_backend(pw_chrono.system_clock pw_chrono_stl.system_clock)
 pw_set_backend(pw_log pw_log_basic)
 pw_set_backend(pw_rpc.system_server targets.host.system_rpc_server)
+pw_set_backend(pw_sync.counting_semaphore
+               pw_sync_stl.counting_semaphore_backend)
 pw_set_backend(pw_sync.mutex pw_sync_stl.mutex_backend)
+pw_set_backend(pw_sync.shared_mutex pw_sync_stl.shared_mutex_backend)
 pw_set_backend(pw_sys_io pw_sys_io_stdio)
 
 set(CMAKE_C_COMPILER gcc)
@@ -0,0 +1,631 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/perfetto_converter.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "pw_varint/varint.h"
+
+namespace pw::trace {
+namespace {
+
+// Token of the sync events sent with the packed encoding.
+constexpr uint32_t kSyncEventToken = 0;
+
+// Field numbers from Perfetto's protos/perfetto/trace.
+namespace field {
+
+constexpr uint32_t kTracePacket = 1;  // Trace.packet
+
+constexpr uint32_t kTimestamp = 8;         // TracePacket.timestamp
+constexpr uint32_t kSequenceId = 10;       // .trusted_packet_sequence_id
+constexpr uint32_t kTrackEvent = 11;       // TracePacket.track_event
+constexpr uint32_t kInternedData = 12;     // TracePacket.interned_data
+constexpr uint32_t kSequenceFlags = 13;    // TracePacket.sequence_flags
+constexpr uint32_t kTrackDescriptor = 60;  // TracePacket.track_descriptor
+
+constexpr uint32_t kSequenceStateCleared = 1;  // SEQ_INCREMENTAL_STATE_CLEARED
+constexpr uint32_t kSequenceNeedsState = 2;    // SEQ_NEEDS_INCREMENTAL_STATE
+
+constexpr uint32_t kInternedCategories = 1;  // InternedData.event_categories
+constexpr uint32_t kInternedNames = 2;       // InternedData.event_names
+constexpr uint32_t kInternedIid = 1;         // EventName.iid, EventCategory.iid
+constexpr uint32_t kInternedName = 2;        // EventName.name, .name
+
+constexpr uint32_t kTrackUuid = 1;        // TrackDescriptor.uuid
+constexpr uint32_t kTrackName = 2;        // TrackDescriptor.name
+constexpr uint32_t kTrackParentUuid = 5;  // TrackDescriptor.parent_uuid
+
+constexpr uint32_t kCategoryIids = 3;     // TrackEvent.category_iids
+constexpr uint32_t kAnnotations = 4;      // TrackEvent.debug_annotations
+constexpr uint32_t kEventType = 9;        // TrackEvent.type
+constexpr uint32_t kNameIid = 10;         // TrackEvent.name_iid
+constexpr uint32_t kEventTrackUuid = 11;  // TrackEvent.track_uuid
+
+constexpr uint32_t kStringValue = 6;      // DebugAnnotation.string_value
+constexpr uint32_t kAnnotationName = 10;  // DebugAnnotation.name
+
+}  // namespace field
+
+// TrackEvent.Type values.
+enum class PerfettoEventType : uint32_t {
+  kSliceBegin = 1,
+  kSliceEnd = 2,
+  kInstant = 3,
+};
+
+enum class WireType : uint32_t {
+  kVarint = 0,
+  kDelimited = 2,
+};
+
+void AppendVarint(uint64_t value, std::string& output) {
+  std::array<std::byte, varint::kMaxVarint64SizeBytes> buffer;
+  const size_t size = varint::Encode(value, buffer);
+  output.append(reinterpret_cast<const char*>(buffer.data()), size);
+}
+
+void AppendKey(uint32_t field_number, WireType type, std::string& output) {
+  AppendVarint(field_number << 3 | static_cast<uint32_t>(type), output);
+}
+
+void AppendVarintField(uint32_t field_number,
+                       uint64_t value,
+                       std::string& output) {
+  AppendKey(field_number, WireType::kVarint, output);
+  AppendVarint(value, output);
+}
+
+void AppendBytesField(uint32_t field_number,
+                      std::string_view value,
+                      std::string& output) {
+  AppendKey(field_number, WireType::kDelimited, output);
+  AppendVarint(value.size(), output);
+  output.append(value);
+}
+
+// Tracks are looked up by a hash of their names, so finding an event's track
+// does not build a string.
+class TrackHash {
+ public:
+  TrackHash& Add(std::string_view value) {
+    for (char c : value) {
+      AddByte(static_cast<uint8_t>(c));
+    }
+    AddByte(0);  // Separate values, so "ab", "c" differs from "a", "bc".
+    return *this;
+  }
+
+  TrackHash& Add(uint32_t value) {
+    for (size_t i = 0; i < sizeof(value); ++i) {
+      AddByte(static_cast<uint8_t>(value >> (8 * i)));
+    }
+    return *this;
+  }
+
+  uint64_t value() const { return hash_; }
+
+ private:
+  // 64-bit FNV-1a.
+  void AddByte(uint8_t byte) {
+    hash_ ^= byte;
+    hash_ *= 0x100000001b3u;
+  }
+
+  uint64_t hash_ = 0xcbf29ce484222325u;
+};
+
+void AppendHex(std::span<const std::byte> data, std::string& output) {
+  constexpr char kDigits[] = "0123456789abcdef";
+  for (std::byte byte : data) {
+    output.push_back(kDigits[std::to_integer<uint8_t>(byte) >> 4]);
+    output.push_back(kDigits[std::to_integer<uint8_t>(byte) & 0xf]);
+  }
+}
+
+// Runs function(i) for i in [0, count), each on its own thread. The calling
+// thread runs function(0).
+template <typename Function>
+void RunInParallel(size_t count, Function&& function) {
+  std::vector<std::thread> threads;
+  threads.reserve(count == 0 ? 0 : count - 1);
+  for (size_t i = 1; i < count; ++i) {
+    threads.emplace_back(function, i);
+  }
+  if (count > 0) {
+    function(0);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+
+// A trace token string, parsed from "event_type|flag|module|group|label" with
+// an optional "|data_format".
+struct PerfettoConverter::TokenInfo {
+  enum class Type {
+    kInvalid,
+    kInstant,
+    kInstantGroup,
+    kAsyncStart,
+    kAsyncStep,
+    kAsyncEnd,
+    kDurationStart,
+    kDurationEnd,
+    kDurationGroupStart,
+    kDurationGroupEnd,
+  };
+
+  static Type ParseType(std::string_view type) {
+    constexpr std::string_view kPrefix = "PW_TRACE_EVENT_TYPE_";
+    if (type.substr(0, kPrefix.size()) != kPrefix) {
+      return Type::kInvalid;
+    }
+    type.remove_prefix(kPrefix.size());
+
+    constexpr std::pair<std::string_view, Type> kTypes[] = {
+        {"INSTANT", Type::kInstant},
+        {"INSTANT_GROUP", Type::kInstantGroup},
+        {"ASYNC_START", Type::kAsyncStart},
+        {"ASYNC_STEP", Type::kAsyncStep},
+        {"ASYNC_END", Type::kAsyncEnd},
+        {"DURATION_START", Type::kDurationStart},
+        {"DURATION_END", Type::kDurationEnd},
+        {"DURATION_GROUP_START", Type::kDurationGroupStart},
+        {"DURATION_GROUP_END", Type::kDurationGroupEnd},
+    };
+    for (const auto& [name, value] : kTypes) {
+      if (type == name) {
+        return value;
+      }
+    }
+    return Type::kInvalid;
+  }
+
+  // Leaves the type invalid if the string is not a trace event.
+  void Parse(std::string_view token_string) {
+    std::array<std::string_view, 6> values;
+    size_t count = 0;
+    while (count < values.size()) {
+      const size_t end = token_string.find('|');
+      values[count++] = token_string.substr(0, end);
+      if (end == std::string_view::npos) {
+        break;
+      }
+      token_string.remove_prefix(end + 1);
+    }
+    if (count < 5) {
+      return;
+    }
+
+    type = ParseType(values[0]);
+    module = values[2];
+    group = values[3];
+    label = values[4];
+    has_data = count > 5;
+    data_format = values[5];
+  }
+
+  bool has_trace_id() const {
+    return type == Type::kAsyncStart || type == Type::kAsyncStep ||
+           type == Type::kAsyncEnd;
+  }
+
+  Type type = Type::kInvalid;
+  std::string module;
+  std::string group;
+  std::string label;
+  bool has_data = false;
+  std::string data_format;
+
+  // Interned string IDs, set by ResolveSegment.
+  uint64_t category_iid = 0;
+  uint64_t name_iid = 0;
+};
+
+struct PerfettoConverter::Event {
+  // Null for sync events.
+  TokenInfo* info;
+
+  // The time since the previous event, or the full time of a sync event.
+  uint64_t ticks;
+
+  // By the packed encoding, if the event uses the previous event's trace ID.
+  bool same_trace_id;
+  uint32_t trace_id;
+  std::span<const std::byte> data;
+
+  // Set by ResolveSegment.
+  uint64_t timestamp_ns;
+  uint64_t track_uuid;
+};
+
+struct PerfettoConverter::Segment {
+  std::unordered_map<uint32_t, TokenInfo> tokens;
+
+  std::span<const std::span<const std::byte>> entries;
+  std::vector<Event> events;
+  Stats stats;
+
+  // The encoded packets, and scratch buffers for their nested messages.
+  std::string output;
+  std::string packet;
+  std::string track_event;
+  std::string annotation;
+};
+
+PerfettoConverter::PerfettoConverter(const tokenizer::Detokenizer& detokenizer,
+                                     const Options& options)
+    : detokenizer_(detokenizer), options_(options) {
+  const size_t thread_count = std::max<size_t>(options_.thread_count, 1);
+  for (size_t i = 0; i < thread_count; ++i) {
+    segments_.push_back(std::make_unique<Segment>());
+  }
+}
+
+PerfettoConverter::~PerfettoConverter() = default;
+
+PerfettoConverter::Stats PerfettoConverter::Convert(
+    std::span<const std::byte> trace_data, std::ostream& output) {
+  Stats stats;
+  const size_t round_size = kEntriesPerSegment * segments_.size();
+  std::vector<std::span<const std::byte>> entries;
+  entries.reserve(round_size);
+  const auto convert_round = [&] {
+    // Split the round's entries evenly between the threads.
+    const size_t per_segment =
+        (entries.size() + segments_.size() - 1) / segments_.size();
+    const size_t segment_count =
+        per_segment == 0 ? 0 : (entries.size() + per_segment - 1) / per_segment;
+    for (size_t i = 0; i < segment_count; ++i) {
+      const size_t begin = i * per_segment;
+      segments_[i]->entries = std::span(entries).subspan(
+          begin, std::min(per_segment, entries.size() - begin));
+    }
+
+    RunInParallel(segment_count, [this](size_t i) {
+      Segment& segment = *segments_[i];
+      segment.events.clear();
+      segment.stats = {};
+      for (std::span<const std::byte> entry : segment.entries) {
+        DecodeEntry(entry, segment);
+      }
+    });
+
+    header_.clear();
+    interned_data_.clear();
+    for (size_t i = 0; i < segment_count; ++i) {
+      ResolveSegment(*segments_[i]);
+    }
+    if (!interned_data_.empty()) {
+      AppendHeaderPacket(field::kInternedData, interned_data_);
+    }
+
+    RunInParallel(segment_count,
+                  [this](size_t i) { EncodeSegment(*segments_[i]); });
+
+    output.write(header_.data(), header_.size());
+    for (size_t i = 0; i < segment_count; ++i) {
+      const Segment& segment = *segments_[i];
+      output.write(segment.output.data(), segment.output.size());
+      stats.events += segment.stats.events;
+      stats.unknown_tokens += segment.stats.unknown_tokens;
+      stats.malformed_entries += segment.stats.malformed_entries;
+    }
+    entries.clear();
+  };
+
+  // Finding the entries is the only step which must be sequential.
+  while (!trace_data.empty()) {
+    uint64_t size;
+    const size_t size_bytes = varint::Decode(trace_data, &size);
+    if (size_bytes == 0 || size > trace_data.size() - size_bytes) {
+      stats.malformed_entries += 1;
+      break;
+    }
+    entries.push_back(trace_data.subspan(size_bytes, size));
+    trace_data = trace_data.subspan(size_bytes + size);
+
+    if (entries.size() == round_size) {
+      convert_round();
+    }
+  }
+  convert_round();
+  return stats;
+}
+
+bool PerfettoConverter::DecodeEntry(std::span<const std::byte> entry,
+                                    Segment& segment) {
+  if (entry.size() < sizeof(uint32_t)) {
+    segment.stats.malformed_entries += 1;
+    return false;
+  }
+
+  uint32_t token = 0;
+  for (size_t i = 0; i < sizeof(token); ++i) {
+    token |= std::to_integer<uint32_t>(entry[i]) << (8 * i);
+  }
+  entry = entry.subspan(sizeof(token));
+
+  uint64_t ticks;
+  const size_t ticks_bytes = varint::Decode(entry, &ticks);
+  if (ticks_bytes == 0) {
+    segment.stats.malformed_entries += 1;
+    return false;
+  }
+  entry = entry.subspan(ticks_bytes);
+
+  if (options_.packed && token == kSyncEventToken) {
+    segment.events.push_back({.info = nullptr,
+                              .ticks = ticks,
+                              .same_trace_id = false,
+                              .trace_id = 0,
+                              .data = {},
+                              .timestamp_ns = 0,
+                              .track_uuid = 0});
+    return true;
+  }
+
+  auto [it, inserted] = segment.tokens.try_emplace(token);
+  TokenInfo& info = it->second;
+  if (inserted) {
+    const tokenizer::DetokenizedString result = detokenizer_.Detokenize(
+        std::span(reinterpret_cast<const uint8_t*>(&token), sizeof(token)));
+    if (!result.matches().empty()) {
+      info.Parse(result.BestString());
+    }
+  }
+  if (info.type == TokenInfo::Type::kInvalid) {
+    segment.stats.unknown_tokens += 1;
+    return false;
+  }
+
+  // With the packed encoding, the lowest bit of the time delta indicates if
+  // the trace ID is present.
+  bool trace_id_present = info.has_trace_id();
+  if (options_.packed && info.has_trace_id()) {
+    trace_id_present = (ticks & 1) != 0;
+    ticks >>= 1;
+  }
+
+  uint64_t trace_id = 0;
+  if (trace_id_present && !entry.empty()) {
+    const size_t trace_id_bytes = varint::Decode(entry, &trace_id);
+    if (trace_id_bytes == 0) {
+      segment.stats.malformed_entries += 1;
+      return false;
+    }
+    entry = entry.subspan(trace_id_bytes);
+  }
+
+  segment.events.push_back({
+      .info = &info,
+      .ticks = ticks,
+      .same_trace_id =
+          options_.packed && info.has_trace_id() && !trace_id_present,
+      .trace_id = static_cast<uint32_t>(trace_id),
+      .data = info.has_data ? entry : std::span<const std::byte>(),
+      .timestamp_ns = 0,
+      .track_uuid = 0,
+  });
+  return true;
+}
+
+void PerfettoConverter::ResolveSegment(Segment& segment) {
+  using Type = TokenInfo::Type;
+
+  for (Event& event : segment.events) {
+    if (event.info == nullptr) {
+      // Sync events hold the full time and reset the previous trace ID.
+      time_ticks_ = event.ticks;
+      has_trace_id_ = false;
+      continue;
+    }
+
+    time_ticks_ += event.ticks;
+    event.timestamp_ns =
+        time_ticks_ / options_.ticks_per_second * 1'000'000'000u +
+        time_ticks_ % options_.ticks_per_second * 1'000'000'000u /
+            options_.ticks_per_second;
+
+    TokenInfo& info = *event.info;
+    if (info.has_trace_id()) {
+      if (event.same_trace_id) {
+        event.trace_id = has_trace_id_ ? last_trace_id_ : 0;
+      }
+      last_trace_id_ = event.trace_id;
+      has_trace_id_ = true;
+    }
+
+    // Each thread parses its own copy of a token's strings, so the copies are
+    // interned separately, though they map to the same IDs.
+    if (info.category_iid == 0) {
+      info.category_iid =
+          Intern(categories_, field::kInternedCategories, info.module);
+      info.name_iid = Intern(event_names_, field::kInternedNames, info.label);
+    }
+
+    const uint64_t module_uuid =
+        AddTrack(TrackHash().Add(info.module).value(), 0, info.module);
+
+    switch (info.type) {
+      case Type::kInstant:
+        event.track_uuid = module_uuid;
+        break;
+      case Type::kInstantGroup:
+      case Type::kDurationGroupStart:
+      case Type::kDurationGroupEnd:
+        event.track_uuid =
+            AddTrack(TrackHash().Add(info.module).Add(info.group).value(),
+                     module_uuid,
+                     info.group);
+        break;
+      case Type::kDurationStart:
+      case Type::kDurationEnd:
+        event.track_uuid =
+            AddTrack(TrackHash().Add(info.module).Add(info.label).value(),
+                     module_uuid,
+                     info.label);
+        break;
+      case Type::kAsyncStart:
+      case Type::kAsyncStep:
+      case Type::kAsyncEnd: {
+        const uint64_t key = TrackHash()
+                                 .Add(info.module)
+                                 .Add(info.group)
+                                 .Add(event.trace_id)
+                                 .value();
+        const auto track = tracks_.find(key);
+        event.track_uuid =
+            track != tracks_.end()
+                ? track->second
+                : AddTrack(key,
+                           module_uuid,
+                           info.group + ' ' + std::to_string(event.trace_id));
+        break;
+      }
+      case Type::kInvalid:
+        break;
+    }
+  }
+}
+
+void PerfettoConverter::EncodeSegment(Segment& segment) const {
+  using Type = TokenInfo::Type;
+
+  segment.output.clear();
+  for (const Event& event : segment.events) {
+    if (event.info == nullptr) {
+      continue;
+    }
+    const TokenInfo& info = *event.info;
+
+    PerfettoEventType type = PerfettoEventType::kInstant;
+    switch (info.type) {
+      case Type::kAsyncStart:
+      case Type::kDurationStart:
+      case Type::kDurationGroupStart:
+        type = PerfettoEventType::kSliceBegin;
+        break;
+      case Type::kAsyncEnd:
+      case Type::kDurationEnd:
+      case Type::kDurationGroupEnd:
+        type = PerfettoEventType::kSliceEnd;
+        break;
+      case Type::kInstant:
+      case Type::kInstantGroup:
+      case Type::kAsyncStep:
+      case Type::kInvalid:
+        break;
+    }
+
+    std::string& track_event = segment.track_event;
+    track_event.clear();
+    AppendVarintField(
+        field::kEventType, static_cast<uint32_t>(type), track_event);
+    AppendVarintField(field::kEventTrackUuid, event.track_uuid, track_event);
+    AppendVarintField(field::kCategoryIids, info.category_iid, track_event);
+    if (type != PerfettoEventType::kSliceEnd) {
+      AppendVarintField(field::kNameIid, info.name_iid, track_event);
+    }
+
+    // Event data is recorded as hex with its format, which host tools such as
+    // pw_trace's Python decoder can interpret.
+    if (!event.data.empty()) {
+      std::string& annotation = segment.annotation;
+      annotation.clear();
+      AppendBytesField(field::kAnnotationName, "data", annotation);
+      AppendKey(field::kStringValue, WireType::kDelimited, annotation);
+      AppendVarint(event.data.size() * 2, annotation);
+      AppendHex(event.data, annotation);
+      AppendBytesField(field::kAnnotations, annotation, track_event);
+
+      annotation.clear();
+      AppendBytesField(field::kAnnotationName, "data_format", annotation);
+      AppendBytesField(field::kStringValue, info.data_format, annotation);
+      AppendBytesField(field::kAnnotations, annotation, track_event);
+    }
+
+    std::string& packet = segment.packet;
+    packet.clear();
+    AppendVarintField(field::kTimestamp, event.timestamp_ns, packet);
+    AppendVarintField(field::kSequenceId, options_.sequence_id, packet);
+    AppendVarintField(
+        field::kSequenceFlags, field::kSequenceNeedsState, packet);
+    AppendBytesField(field::kTrackEvent, track_event, packet);
+
+    AppendBytesField(field::kTracePacket, packet, segment.output);
+    segment.stats.events += 1;
+  }
+}
+
+uint64_t PerfettoConverter::AddTrack(uint64_t key,
+                                     uint64_t parent_uuid,
+                                     std::string_view name) {
+  const auto [track, inserted] = tracks_.try_emplace(key, tracks_.size() + 1);
+  if (!inserted) {
+    return track->second;
+  }
+
+  std::string descriptor;
+  AppendVarintField(field::kTrackUuid, track->second, descriptor);
+  if (parent_uuid != 0) {
+    AppendVarintField(field::kTrackParentUuid, parent_uuid, descriptor);
+  }
+  AppendBytesField(field::kTrackName, name, descriptor);
+  AppendHeaderPacket(field::kTrackDescriptor, descriptor);
+  return track->second;
+}
+
+uint64_t PerfettoConverter::Intern(
+    std::unordered_map<std::string, uint64_t>& table,
+    uint32_t field_number,
+    std::string_view value) {
+  const auto [entry, inserted] =
+      table.try_emplace(std::string(value), table.size() + 1);
+  if (inserted) {
+    std::string message;
+    AppendVarintField(field::kInternedIid, entry->second, message);
+    AppendBytesField(field::kInternedName, value, message);
+    AppendBytesField(field_number, message, interned_data_);
+  }
+  return entry->second;
+}
+
+void PerfettoConverter::AppendHeaderPacket(uint32_t field_number,
+                                           std::string_view message) {
+  std::string packet;
+  AppendVarintField(field::kSequenceId, options_.sequence_id, packet);
+  if (!sequence_started_) {
+    // Perfetto ignores a sequence's packets until its state is cleared.
+    AppendVarintField(field::kSequenceFlags,
+                      field::kSequenceStateCleared | field::kSequenceNeedsState,
+                      packet);
+    sequence_started_ = true;
+  } else {
+    AppendVarintField(
+        field::kSequenceFlags, field::kSequenceNeedsState, packet);
+  }
+  AppendBytesField(field_number, message, packet);
+  AppendBytesField(field::kTracePacket, packet, header_);
+}
+
+}  // namespace pw::trace
@@ -0,0 +1,422 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/perfetto_converter.h"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_varint/varint.h"
+
+namespace pw::trace {
+namespace {
+
+alignas(tokenizer::TokenDatabase::RawEntry) constexpr char kData[] =
+    "TOKENS\0\0"
+    "\x06\x00\x00\x00"
+    "\0\0\0\0"
+    "\x01\x00\x00\x00----"
+    "\x02\x00\x00\x00----"
+    "\x03\x00\x00\x00----"
+    "\x04\x00\x00\x00----"
+    "\x05\x00\x00\x00----"
+    "\x06\x00\x00\x00----"
+    "PW_TRACE_EVENT_TYPE_DURATION_START|0|mod|grp|Work\0"
+    "PW_TRACE_EVENT_TYPE_DURATION_END|0|mod|grp|Work\0"
+    "PW_TRACE_EVENT_TYPE_ASYNC_START|0|mod|Jobs|Job\0"
+    "PW_TRACE_EVENT_TYPE_ASYNC_END|0|mod|Jobs|Job\0"
+    "PW_TRACE_EVENT_TYPE_INSTANT|0|mod|grp|Tick|@pw_arg_counter\0"
+    "Not a trace event\0";
+
+constexpr uint32_t kDurationStart = 1;
+constexpr uint32_t kDurationEnd = 2;
+constexpr uint32_t kAsyncStart = 3;
+constexpr uint32_t kAsyncEnd = 4;
+constexpr uint32_t kInstantWithData = 5;
+constexpr uint32_t kNotTrace = 6;
+constexpr uint32_t kUnknown = 100;
+
+// The parts of a Perfetto TracePacket the converter writes.
+struct Packet {
+  uint64_t timestamp_ns = 0;
+  bool state_cleared = false;
+
+  bool is_track = false;
+  uint64_t uuid = 0;
+  uint64_t parent_uuid = 0;
+
+  bool is_event = false;
+  uint64_t type = 0;
+  uint64_t track_uuid = 0;
+  uint64_t name_iid = 0;
+  uint64_t category_iid = 0;
+
+  // The track's name, or the event's name and category from interned data.
+  std::string name;
+  std::string category;
+  std::vector<std::pair<std::string, std::string>> annotations;
+};
+
+std::string ReadString(protobuf::Decoder& decoder) {
+  std::string_view value;
+  EXPECT_EQ(OkStatus(), decoder.ReadString(&value));
+  return std::string(value);
+}
+
+uint64_t ReadUint64(protobuf::Decoder& decoder) {
+  uint64_t value = 0;
+  EXPECT_EQ(OkStatus(), decoder.ReadUint64(&value));
+  return value;
+}
+
+protobuf::Decoder ReadMessage(protobuf::Decoder& decoder) {
+  std::span<const std::byte> bytes;
+  EXPECT_EQ(OkStatus(), decoder.ReadBytes(&bytes));
+  return protobuf::Decoder(bytes);
+}
+
+void ParseTrackEvent(protobuf::Decoder decoder, Packet& packet) {
+  packet.is_event = true;
+  while (decoder.Next().ok()) {
+    switch (decoder.FieldNumber()) {
+      case 4: {
+        protobuf::Decoder annotation = ReadMessage(decoder);
+        std::string name;
+        std::string value;
+        while (annotation.Next().ok()) {
+          if (annotation.FieldNumber() == 10) {
+            name = ReadString(annotation);
+          } else if (annotation.FieldNumber() == 6) {
+            value = ReadString(annotation);
+          }
+        }
+        packet.annotations.emplace_back(name, value);
+        break;
+      }
+      case 3:
+        packet.category_iid = ReadUint64(decoder);
+        break;
+      case 9:
+        packet.type = ReadUint64(decoder);
+        break;
+      case 10:
+        packet.name_iid = ReadUint64(decoder);
+        break;
+      case 11:
+        packet.track_uuid = ReadUint64(decoder);
+        break;
+    }
+  }
+}
+
+using InternedStrings = std::map<uint64_t, std::string>;
+
+// Reads InternedData.event_categories (1) and event_names (2).
+void ParseInternedData(protobuf::Decoder decoder,
+                       InternedStrings& categories,
+                       InternedStrings& names) {
+  while (decoder.Next().ok()) {
+    InternedStrings& table = decoder.FieldNumber() == 1 ? categories : names;
+    protobuf::Decoder entry = ReadMessage(decoder);
+    uint64_t iid = 0;
+    std::string name;
+    while (entry.Next().ok()) {
+      if (entry.FieldNumber() == 1) {
+        iid = ReadUint64(entry);
+      } else if (entry.FieldNumber() == 2) {
+        name = ReadString(entry);
+      }
+    }
+    EXPECT_EQ(0u, table.count(iid));
+    table[iid] = name;
+  }
+}
+
+void ParseTrackDescriptor(protobuf::Decoder decoder, Packet& packet) {
+  packet.is_track = true;
+  while (decoder.Next().ok()) {
+    switch (decoder.FieldNumber()) {
+      case 1:
+        packet.uuid = ReadUint64(decoder);
+        break;
+      case 2:
+        packet.name = ReadString(decoder);
+        break;
+      case 5:
+        packet.parent_uuid = ReadUint64(decoder);
+        break;
+    }
+  }
+}
+
+std::vector<Packet> ParseTrace(const std::string& trace) {
+  std::vector<Packet> packets;
+  InternedStrings categories;
+  InternedStrings names;
+  protobuf::Decoder decoder(std::as_bytes(std::span(trace)));
+  while (decoder.Next().ok()) {
+    EXPECT_EQ(decoder.FieldNumber(), 1u);
+    protobuf::Decoder packet_decoder = ReadMessage(decoder);
+    Packet& packet = packets.emplace_back();
+    while (packet_decoder.Next().ok()) {
+      switch (packet_decoder.FieldNumber()) {
+        case 8:
+          packet.timestamp_ns = ReadUint64(packet_decoder);
+          break;
+        case 10:
+          EXPECT_EQ(ReadUint64(packet_decoder), 1u);
+          break;
+        case 11:
+          ParseTrackEvent(ReadMessage(packet_decoder), packet);
+          break;
+        case 12:
+          ParseInternedData(ReadMessage(packet_decoder), categories, names);
+          break;
+        case 13:
+          packet.state_cleared = (ReadUint64(packet_decoder) & 1u) != 0;
+          break;
+        case 60:
+          ParseTrackDescriptor(ReadMessage(packet_decoder), packet);
+          break;
+      }
+    }
+  }
+
+  for (Packet& packet : packets) {
+    if (packet.is_event) {
+      packet.category = categories[packet.category_iid];
+      if (packet.name_iid != 0) {
+        packet.name = names[packet.name_iid];
+      }
+    }
+  }
+  return packets;
+}
+
+std::vector<Packet> Events(const std::vector<Packet>& packets) {
+  std::vector<Packet> events;
+  for (const Packet& packet : packets) {
+    if (packet.is_event) {
+      events.push_back(packet);
+    }
+  }
+  return events;
+}
+
+void AppendVarint(uint64_t value, std::vector<std::byte>& output) {
+  std::array<std::byte, varint::kMaxVarint64SizeBytes> buffer;
+  const size_t size = varint::Encode(value, buffer);
+  output.insert(output.end(), buffer.begin(), buffer.begin() + size);
+}
+
+// Appends a size-prefixed trace entry.
+void AddEntry(std::vector<std::byte>& trace,
+              uint32_t token,
+              uint64_t time_delta,
+              std::optional<uint64_t> trace_id = std::nullopt,
+              std::string_view data = "") {
+  std::vector<std::byte> entry;
+  for (size_t i = 0; i < sizeof(token); ++i) {
+    entry.push_back(static_cast<std::byte>(token >> (8 * i)));
+  }
+  AppendVarint(time_delta, entry);
+  if (trace_id.has_value()) {
+    AppendVarint(*trace_id, entry);
+  }
+  for (char c : data) {
+    entry.push_back(static_cast<std::byte>(c));
+  }
+
+  AppendVarint(entry.size(), trace);
+  trace.insert(trace.end(), entry.begin(), entry.end());
+}
+
+class PerfettoConverterTest : public ::testing::Test {
+ protected:
+  PerfettoConverterTest()
+      : detokenizer_(tokenizer::TokenDatabase::Create<kData>()) {}
+
+  std::vector<Packet> Convert(const PerfettoConverter::Options& options) {
+    PerfettoConverter converter(detokenizer_, options);
+    std::ostringstream output;
+    stats_ = converter.Convert(trace_, output);
+    return ParseTrace(output.str());
+  }
+
+  tokenizer::Detokenizer detokenizer_;
+  std::vector<std::byte> trace_;
+  PerfettoConverter::Stats stats_;
+};
+
+TEST_F(PerfettoConverterTest, DurationEvents) {
+  AddEntry(trace_, kDurationStart, 0);
+  AddEntry(trace_, kDurationEnd, 5);
+
+  const std::vector<Packet> packets = Convert({.ticks_per_second = 1000});
+  EXPECT_EQ(2u, stats_.events);
+  ASSERT_EQ(5u, packets.size());
+
+  // The module track, then the label's track within it, then the interned
+  // strings. Only the first packet clears the sequence state.
+  EXPECT_TRUE(packets[0].is_track);
+  EXPECT_TRUE(packets[0].state_cleared);
+  EXPECT_EQ("mod", packets[0].name);
+  EXPECT_EQ(0u, packets[0].parent_uuid);
+
+  EXPECT_TRUE(packets[1].is_track);
+  EXPECT_FALSE(packets[1].state_cleared);
+  EXPECT_EQ("Work", packets[1].name);
+  EXPECT_EQ(packets[0].uuid, packets[1].parent_uuid);
+
+  EXPECT_TRUE(packets[3].is_event);
+  EXPECT_EQ(1u, packets[3].type);  // SLICE_BEGIN
+  EXPECT_EQ(0u, packets[3].timestamp_ns);
+  EXPECT_EQ("Work", packets[3].name);
+  EXPECT_EQ("mod", packets[3].category);
+  EXPECT_EQ(packets[1].uuid, packets[3].track_uuid);
+
+  EXPECT_TRUE(packets[4].is_event);
+  EXPECT_EQ(2u, packets[4].type);  // SLICE_END
+  EXPECT_EQ(5'000'000u, packets[4].timestamp_ns);
+  EXPECT_EQ(packets[1].uuid, packets[4].track_uuid);
+}
+
+TEST_F(PerfettoConverterTest, AsyncEvents_TrackPerTraceId) {
+  AddEntry(trace_, kAsyncStart, 0, 7);
+  AddEntry(trace_, kAsyncStart, 1, 8);
+  AddEntry(trace_, kAsyncEnd, 1, 7);
+
+  const std::vector<Packet> packets = Convert({});
+  const std::vector<Packet> events = Events(packets);
+  ASSERT_EQ(3u, events.size());
+  EXPECT_NE(events[0].track_uuid, events[1].track_uuid);
+  EXPECT_EQ(events[0].track_uuid, events[2].track_uuid);
+  EXPECT_EQ(2u, events[2].type);
+
+  // Each round's tracks and interned strings are described before its events:
+  // the module track and one track for each trace ID.
+  ASSERT_EQ(7u, packets.size());
+  EXPECT_EQ("Jobs 7", packets[1].name);
+  EXPECT_EQ("Jobs 8", packets[2].name);
+}
+
+TEST_F(PerfettoConverterTest, Packed_SyncEventsAndPreviousTraceId) {
+  AddEntry(trace_, 0, 1000);                     // Sync event
+  AddEntry(trace_, kAsyncStart, 2 << 1 | 1, 9);  // Trace ID present
+  AddEntry(trace_, kAsyncEnd, 3 << 1);           // Previous trace ID
+  AddEntry(trace_, kDurationStart, 4);           // No trace ID bit
+
+  const std::vector<Packet> events =
+      Events(Convert({.ticks_per_second = 1000, .packed = true}));
+  ASSERT_EQ(3u, events.size());
+  EXPECT_EQ(1'002'000'000u, events[0].timestamp_ns);
+  EXPECT_EQ(1'005'000'000u, events[1].timestamp_ns);
+  EXPECT_EQ(1'009'000'000u, events[2].timestamp_ns);
+  EXPECT_EQ(events[0].track_uuid, events[1].track_uuid);
+}
+
+TEST_F(PerfettoConverterTest, InstantEventData) {
+  AddEntry(trace_, kInstantWithData, 0, std::nullopt, "\x01\xab");
+
+  const std::vector<Packet> events = Events(Convert({}));
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(3u, events[0].type);  // INSTANT
+  EXPECT_EQ("Tick", events[0].name);
+  ASSERT_EQ(2u, events[0].annotations.size());
+  EXPECT_EQ("data", events[0].annotations[0].first);
+  EXPECT_EQ("01ab", events[0].annotations[0].second);
+  EXPECT_EQ("data_format", events[0].annotations[1].first);
+  EXPECT_EQ("@pw_arg_counter", events[0].annotations[1].second);
+}
+
+TEST_F(PerfettoConverterTest, SkipsUnknownAndMalformedEntries) {
+  AddEntry(trace_, kUnknown, 0);
+  AddEntry(trace_, kNotTrace, 0);
+  AddEntry(trace_, kDurationStart, 3);
+  trace_.push_back(std::byte{2});  // Entry too small for a token.
+  trace_.push_back(std::byte{0});
+  trace_.push_back(std::byte{0});
+  AddEntry(trace_, kDurationEnd, 4);
+  trace_.push_back(std::byte{10});  // Truncated entry.
+
+  const std::vector<Packet> events = Events(Convert({}));
+  EXPECT_EQ(2u, stats_.events);
+  EXPECT_EQ(2u, stats_.unknown_tokens);
+  EXPECT_EQ(2u, stats_.malformed_entries);
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ(7'000'000u, events[1].timestamp_ns);
+}
+
+TEST_F(PerfettoConverterTest, MultithreadedOutputMatchesSingleThreaded) {
+  constexpr size_t kEntries = 3 * PerfettoConverter::kEntriesPerSegment + 17;
+  for (size_t i = 0; i < kEntries; ++i) {
+    switch (i % 4) {
+      case 0:
+        AddEntry(trace_, kDurationStart, 1);
+        break;
+      case 1:
+        AddEntry(trace_, kAsyncStart, 2, i % 16);
+        break;
+      case 2:
+        AddEntry(trace_, kAsyncEnd, 3, (i - 1) % 16);
+        break;
+      case 3:
+        AddEntry(trace_, kDurationEnd, 4);
+        break;
+    }
+  }
+
+  PerfettoConverter single(detokenizer_, {.thread_count = 1});
+  std::ostringstream single_output;
+  const PerfettoConverter::Stats single_stats =
+      single.Convert(trace_, single_output);
+
+  PerfettoConverter multi(detokenizer_, {.thread_count = 4});
+  std::ostringstream multi_output;
+  const PerfettoConverter::Stats multi_stats =
+      multi.Convert(trace_, multi_output);
+
+  EXPECT_EQ(kEntries, single_stats.events);
+  EXPECT_EQ(kEntries, multi_stats.events);
+  EXPECT_EQ(single_output.str(), multi_output.str());
+}
+
+TEST_F(PerfettoConverterTest, ConvertInParts_ContinuesSequence) {
+  AddEntry(trace_, kDurationStart, 0);
+  PerfettoConverter converter(detokenizer_, {.ticks_per_second = 1000});
+  std::ostringstream output;
+  converter.Convert(trace_, output);
+
+  trace_.clear();
+  AddEntry(trace_, kDurationEnd, 5);
+  converter.Convert(trace_, output);
+
+  const std::vector<Packet> packets = ParseTrace(output.str());
+  // Tracks and strings are only described once.
+  ASSERT_EQ(5u, packets.size());
+  EXPECT_EQ("Work", packets[3].name);
+  EXPECT_EQ(5'000'000u, packets[4].timestamp_ns);
+  EXPECT_EQ(packets[3].track_uuid, packets[4].track_uuid);
+}
+
+}  // namespace
+}  // namespace pw::trace
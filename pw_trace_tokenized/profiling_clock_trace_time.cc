@@ -0,0 +1,29 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Trace time source backed by pw::chrono::ProfilingClock. The raw counter is
+// used directly, since the trace encoding only stores deltas between events and
+// a wrapping counter is handled by the decoder's sync events.
+
+#include "pw_chrono/profiling_clock.h"
+#include "pw_trace_tokenized/trace_tokenized.h"
+
+PW_TRACE_TIME_TYPE pw_trace_GetTraceTime() {
+  return static_cast<PW_TRACE_TIME_TYPE>(
+      pw::chrono::ProfilingClock::counter());
+}
+
+size_t pw_trace_GetTraceTimeTicksPerSecond() {
+  return static_cast<size_t>(pw::chrono::ProfilingClock::kTicksPerSecond);
+}
@@ -70,6 +70,26 @@ static_assert(
 #endif  // __cplusplus
 #endif  // PW_TRACE_GET_TIME_DELTA
 
+// --- Config options for encoding ----
+
+// PW_TRACE_CONFIG_PACKED_ENCODING enables a more compact encoding of trace
+// events. For event types with a trace ID, the lowest bit of the time delta
+// varint indicates if the trace ID follows; it is omitted if it matches the
+// trace ID of the previous such event. Sync events, which have a token of 0 and
+// the full time as a varint, are sent periodically so that decoders can recover
+// the absolute time and the trace ID. Decoders must be told that this encoding
+// is used.
+#ifndef PW_TRACE_CONFIG_PACKED_ENCODING
+#define PW_TRACE_CONFIG_PACKED_ENCODING 0
+#endif  // PW_TRACE_CONFIG_PACKED_ENCODING
+
+// PW_TRACE_CONFIG_SYNC_INTERVAL_EVENTS is the number of events between sync
+// events when PW_TRACE_CONFIG_PACKED_ENCODING is enabled. A sync event is also
+// sent before the first event after tracing is enabled.
+#ifndef PW_TRACE_CONFIG_SYNC_INTERVAL_EVENTS
+#define PW_TRACE_CONFIG_SYNC_INTERVAL_EVENTS 64
+#endif  // PW_TRACE_CONFIG_SYNC_INTERVAL_EVENTS
+
 // --- Config options for callbacks ----
 
 // PW_TRACE_CONFIG_MAX_EVENT_CALLBACKS is the maximum number of event callbacks
@@ -119,6 +139,65 @@ static_assert(
 #define PW_TRACE_QUEUE_UNLOCK()
 #endif  // PW_TRACE_QUEUE_UNLOCK
 
+// --- Config options for per-thread trace buffers ---
+
+// PW_TRACE_CONFIG_THREAD_BUFFER_COUNT is the number of per-thread trace
+// buffers. If it is not 0, trace events are appended without locking to the
+// buffer of the calling thread instead of being queued and passed to the
+// callbacks and sinks. The buffers are merged in timestamp order when the trace
+// buffer is read.
+#ifndef PW_TRACE_CONFIG_THREAD_BUFFER_COUNT
+#define PW_TRACE_CONFIG_THREAD_BUFFER_COUNT 0
+#endif  // PW_TRACE_CONFIG_THREAD_BUFFER_COUNT
+
+// PW_TRACE_CONFIG_THREAD_BUFFER_SIZE_BYTES is the size in bytes of each
+// per-thread trace buffer.
+#ifndef PW_TRACE_CONFIG_THREAD_BUFFER_SIZE_BYTES
+#define PW_TRACE_CONFIG_THREAD_BUFFER_SIZE_BYTES 256
+#endif  // PW_TRACE_CONFIG_THREAD_BUFFER_SIZE_BYTES
+
+// PW_TRACE_GET_THREAD_BUFFER_INDEX is the macro which is called to select the
+// per-thread buffer for a trace event. It must return a value less than
+// PW_TRACE_CONFIG_THREAD_BUFFER_COUNT, and no two threads or interrupts that
+// can preempt each other may use the same index; for example, use the index of
+// the thread, or the index of the core with interrupt tracing disabled. Events
+// with an out of range index are dropped. It's default is to use
+// pw_trace_GetThreadBufferIndex() which needs to be provided by the platform.
+#if PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+#ifndef PW_TRACE_GET_THREAD_BUFFER_INDEX
+#define PW_TRACE_GET_THREAD_BUFFER_INDEX() pw_trace_GetThreadBufferIndex()
+extern size_t pw_trace_GetThreadBufferIndex(void);
+#endif  // PW_TRACE_GET_THREAD_BUFFER_INDEX
+#endif  // PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+
+#if PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0 && PW_TRACE_CONFIG_PACKED_ENCODING
+#error "Per-thread trace buffers do not support the packed encoding."
+#endif
+
+// --- Config options for event filtering and sampling ---
+
+// PW_TRACE_CONFIG_TOKEN_FILTER_BITS is the number of bits in the bitmap used to
+// disable individual trace events by token. Each token maps to the bit given by
+// its low bits, so it must be a power of two; tokens which share a bit are
+// enabled and disabled together. Disabled events are dropped before they are
+// queued. If it is 0, there is no bitmap.
+#ifndef PW_TRACE_CONFIG_TOKEN_FILTER_BITS
+#define PW_TRACE_CONFIG_TOKEN_FILTER_BITS 0
+#endif  // PW_TRACE_CONFIG_TOKEN_FILTER_BITS
+
+#if (PW_TRACE_CONFIG_TOKEN_FILTER_BITS &                                       \
+     (PW_TRACE_CONFIG_TOKEN_FILTER_BITS - 1)) != 0 ||                          \
+    PW_TRACE_CONFIG_TOKEN_FILTER_BITS % 32 != 0
+#error "PW_TRACE_CONFIG_TOKEN_FILTER_BITS must be 0 or a power of 2 >= 32."
+#endif
+
+// PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS is the maximum number of trace events,
+// by token, which can be sampled at a time. Only one in every N occurrences of
+// a sampled event is recorded.
+#ifndef PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS
+#define PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS 0
+#endif  // PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS
+
 // --- Config options for optional trace buffer ---
 
 // PW_TRACE_BUFFER_SIZE_BYTES is the size in bytes of the optional trace buffer.
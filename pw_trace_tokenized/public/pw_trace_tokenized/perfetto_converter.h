@@ -0,0 +1,154 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This file provides the PerfettoConverter class, which converts tokenized
+// trace data to a Perfetto protobuf trace on the host:
+//
+//   Detokenizer detok(TokenDatabase::Create(database));
+//   PerfettoConverter converter(detok, {.ticks_per_second = 1000000});
+//
+//   std::ofstream output("trace.perfetto-trace", std::ios::binary);
+//   converter.Convert(trace_data, output);
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "pw_tokenizer/detokenize.h"
+
+namespace pw::trace {
+
+// Converts tokenized trace data, as read from the trace buffer by get_trace.py
+// or a TraceTransferHandler, to Perfetto TracePacket protos.
+//
+// The trace data is a series of trace entries, each prefixed by its size as a
+// varint. Entries are decoded in rounds of up to kEntriesPerSegment entries per
+// thread. Each thread decodes and encodes its own segment of the round, since
+// only timestamps and trace IDs depend on earlier entries, and those are
+// resolved between the two steps. Each round is written to the output as soon
+// as it is encoded, so the whole trace is never held in memory.
+//
+// Events are placed on one Perfetto track per module, with a child track for
+// each duration event label or group. Each async event trace ID gets its own
+// child track, since its slices may overlap others of its group. Event names
+// and modules are interned, so each event's packet is only a few bytes.
+//
+// A PerfettoConverter is not thread safe; one thread at a time may call
+// Convert. Multiple calls continue the same Perfetto packet sequence, so the
+// data of one trace may be converted in parts.
+class PerfettoConverter {
+ public:
+  // Entries decoded by each thread per round.
+  static constexpr size_t kEntriesPerSegment = 16384;
+
+  struct Options {
+    // The rate of the trace time, from PW_TRACE_GET_TIME_TICKS_PER_SECOND().
+    // Must not be 0.
+    uint64_t ticks_per_second = 1000;
+
+    // Decode the packed encoding, enabled on the device with
+    // PW_TRACE_CONFIG_PACKED_ENCODING.
+    bool packed = false;
+
+    // Threads which decode the trace, including the calling thread.
+    size_t thread_count = 1;
+
+    // trusted_packet_sequence_id of the written packets.
+    uint32_t sequence_id = 1;
+  };
+
+  struct Stats {
+    // Trace events written as Perfetto track events.
+    size_t events = 0;
+
+    // Entries whose token is not a trace event in the database, which are
+    // skipped.
+    size_t unknown_tokens = 0;
+
+    // Entries which could not be decoded, which are skipped.
+    size_t malformed_entries = 0;
+  };
+
+  // The Detokenizer must outlive the PerfettoConverter.
+  PerfettoConverter(const tokenizer::Detokenizer& detokenizer,
+                    const Options& options);
+
+  PerfettoConverter(const PerfettoConverter&) = delete;
+  PerfettoConverter& operator=(const PerfettoConverter&) = delete;
+
+  ~PerfettoConverter();
+
+  // Converts the trace data and writes the Perfetto packets to the output, as
+  // fields of a perfetto.protos.Trace message. Returns the counts for this
+  // call. An incomplete entry at the end of the data is counted as malformed.
+  Stats Convert(std::span<const std::byte> trace_data, std::ostream& output);
+
+ private:
+  struct TokenInfo;
+  struct Event;
+  struct Segment;
+
+  // Decodes one entry, or returns false if it is skipped.
+  bool DecodeEntry(std::span<const std::byte> entry, Segment& segment);
+
+  // Resolves timestamps, trace IDs, tracks, and interned strings in order.
+  // New tracks and strings are added to the round's header.
+  void ResolveSegment(Segment& segment);
+
+  void EncodeSegment(Segment& segment) const;
+
+  // Returns the UUID of the track with this key, describing it in the header if
+  // it is new.
+  uint64_t AddTrack(uint64_t key, uint64_t parent_uuid, std::string_view name);
+
+  // Returns the interned ID of the string, adding it to the round's interned
+  // data if it is new.
+  uint64_t Intern(std::unordered_map<std::string, uint64_t>& table,
+                  uint32_t field_number,
+                  std::string_view value);
+
+  void AppendHeaderPacket(uint32_t field_number, std::string_view message);
+
+  const tokenizer::Detokenizer& detokenizer_;
+  const Options options_;
+
+  // One per thread. Token strings are cached per thread, so threads do not
+  // contend on a shared cache.
+  std::vector<std::unique_ptr<Segment>> segments_;
+
+  // Timing state carried between entries and calls.
+  uint64_t time_ticks_ = 0;
+  bool has_trace_id_ = false;
+  uint32_t last_trace_id_ = 0;
+  bool sequence_started_ = false;
+
+  // Track keys and interned strings, which are written once per sequence.
+  std::unordered_map<uint64_t, uint64_t> tracks_;
+  std::unordered_map<std::string, uint64_t> categories_;
+  std::unordered_map<std::string, uint64_t> event_names_;
+
+  // Packets written before the events of each round.
+  std::string header_;
+  std::string interned_data_;
+};
+
+}  // namespace pw::trace
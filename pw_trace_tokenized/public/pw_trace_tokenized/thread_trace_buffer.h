@@ -0,0 +1,106 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// This file provides per-thread trace buffers, which trace events are appended
+// to without locking, and a merger which reads them back in timestamp order.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_ring_buffer/single_producer_entry_queue.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_trace_tokenized/config.h"
+
+namespace pw {
+namespace trace {
+
+// A trace buffer with a single producer, typically one thread or core, and a
+// single consumer. The producer appends events without locking or blocking;
+// events that do not fit are dropped and counted.
+//
+// Each entry holds the absolute time of the event rather than the delta from
+// the previous event, so entries from several buffers can be merged.
+class ThreadTraceBuffer {
+ public:
+  constexpr ThreadTraceBuffer() = default;
+
+  // Sets the buffer backing the trace buffer and discards any events. This must
+  // not be called while the buffer is in use.
+  Status SetBuffer(ByteSpan buffer) { return queue_.SetBuffer(buffer); }
+
+  // Producer API. Appends an event. The trace ID is only provided for event
+  // types that have one, as for the sinks.
+  //
+  // Return values:
+  // OK - The event was appended.
+  // INVALID_ARGUMENT - The data is larger than
+  //     PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES; the event was dropped.
+  // RESOURCE_EXHAUSTED - The buffer is full; the event was dropped and
+  //     counted.
+  // FAILED_PRECONDITION - No buffer has been set.
+  Status Append(PW_TRACE_TIME_TYPE time,
+                uint32_t trace_token,
+                std::optional<uint32_t> trace_id,
+                ConstByteSpan data);
+
+  // Number of events dropped because the buffer was full.
+  uint32_t drop_count() const { return queue_.drop_count(); }
+
+ private:
+  friend class ThreadTraceBufferMerger;
+
+  ring_buffer::SingleProducerEntryQueue queue_;
+};
+
+// Reads the events of several ThreadTraceBuffers in timestamp order. Events are
+// written in the format the trace sinks receive, with the time encoded as the
+// delta from the previous merged event, so they can be stored in the trace
+// buffer and decoded with the existing tools.
+//
+// The merger is the consumer of all of the buffers, so only one merger may read
+// a set of buffers at a time. Events that are appended while the merger is
+// reading may have an earlier time than the last merged event; those are
+// written with a delta of 0. Pause tracing while reading for exact ordering.
+class ThreadTraceBufferMerger {
+ public:
+  constexpr ThreadTraceBufferMerger(std::span<ThreadTraceBuffer> buffers)
+      : buffers_(buffers), last_time_(0), has_last_time_(false) {}
+
+  // Writes the earliest event in any buffer to the output and removes it.
+  //
+  // Return values:
+  // OK - An event was written; the size is the size of the event.
+  // OUT_OF_RANGE - All of the buffers are empty.
+  // RESOURCE_EXHAUSTED - The event does not fit in the output. The event is
+  //     not removed.
+  StatusWithSize ReadNext(ByteSpan output);
+
+  // Discards all events in the buffers.
+  void Clear();
+
+ private:
+  std::span<ThreadTraceBuffer> buffers_;
+  PW_TRACE_TIME_TYPE last_time_;
+  bool has_last_time_;
+};
+
+}  // namespace trace
+}  // namespace pw
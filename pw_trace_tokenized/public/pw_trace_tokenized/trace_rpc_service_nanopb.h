@@ -30,6 +30,10 @@ class TraceService final : public generated::TraceService<TraceService> {
   void GetTraceData(ServerContext&,
                     const pw_trace_Empty& request,
                     ServerWriter<pw_trace_TraceDataMessage>& writer);
+
+  pw::Status GetTime(ServerContext&,
+                     const pw_trace_Empty& request,
+                     pw_trace_TraceTimeMessage& response);
 };
 
 }  // namespace pw::trace
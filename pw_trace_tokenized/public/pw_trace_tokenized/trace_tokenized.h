@@ -34,6 +34,12 @@
 #include "pw_trace_tokenized/internal/trace_tokenized_internal.h"
 
 #ifdef __cplusplus
+#if PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+#include <span>
+
+#include "pw_trace_tokenized/thread_trace_buffer.h"
+#endif  // PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+
 namespace pw {
 namespace trace {
 
@@ -118,6 +124,12 @@ class TokenizedTraceImpl {
   void Enable(bool enable) {
     if (enable != enabled_ && enable) {
       event_queue_.Clear();
+#if PW_TRACE_CONFIG_PACKED_ENCODING
+      events_until_sync_ = 0;
+#endif  // PW_TRACE_CONFIG_PACKED_ENCODING
+#if PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+      ResetThreadBuffers();
+#endif  // PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
     }
     enabled_ = enable;
   }
@@ -131,6 +143,42 @@ class TokenizedTraceImpl {
                         const void* data_buffer,
                         size_t data_size);
 
+#if PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+  // The per-thread buffers which trace events are appended to instead of being
+  // passed to the callbacks and sinks.
+  std::span<ThreadTraceBuffer> thread_buffers() { return thread_buffers_; }
+#endif  // PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+
+#if PW_TRACE_CONFIG_TOKEN_FILTER_BITS > 0
+  // Enables or disables the trace event with the given token, along with any
+  // other tokens which share its bit in the filter bitmap. All events are
+  // enabled by default.
+  void SetEventEnabled(uint32_t trace_token, bool enable);
+
+  bool IsEventEnabled(uint32_t trace_token) const {
+    return (disabled_tokens_[TokenFilterWord(trace_token)] &
+            TokenFilterBit(trace_token)) == 0u;
+  }
+#endif  // PW_TRACE_CONFIG_TOKEN_FILTER_BITS > 0
+
+#if PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS > 0
+  // Records only one in every interval occurrences of the trace event with the
+  // given token, starting with the first. An interval of 0 or 1 records every
+  // occurrence again. Returns RESOURCE_EXHAUSTED if
+  // PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS events are already sampled.
+  pw::Status SetEventSampling(uint32_t trace_token, uint32_t interval);
+#endif  // PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS > 0
+
+  // Arms a trigger which freezes the trace. Once the event with the trigger
+  // token is recorded, post_trigger_events more events are recorded and then
+  // tracing is disabled, so a trace buffer holds the events around the
+  // trigger. Arming a trigger replaces any previous one.
+  void SetTrigger(uint32_t trigger_token, size_t post_trigger_events);
+  void ClearTrigger();
+
+  // True if the armed trigger event has been recorded.
+  bool triggered() const { return triggered_; }
+
  private:
   using TraceQueue = internal::TraceQueue<PW_TRACE_QUEUE_SIZE_EVENTS>;
   PW_TRACE_TIME_TYPE last_trace_time_ = 0;
@@ -139,6 +187,56 @@ class TokenizedTraceImpl {
 
   void HandleNextItemInQueue(
       const volatile TraceQueue::QueueEventBlock* event_block);
+
+#if PW_TRACE_CONFIG_PACKED_ENCODING
+  // Sends a sync event with the full time, and resets the trace ID state.
+  void SendSyncEvent(PW_TRACE_TIME_TYPE trace_time);
+
+  size_t events_until_sync_ = 0;
+  uint32_t last_trace_id_ = 0;
+  bool has_last_trace_id_ = false;
+#endif  // PW_TRACE_CONFIG_PACKED_ENCODING
+
+#if PW_TRACE_CONFIG_TOKEN_FILTER_BITS > 0
+  static constexpr size_t TokenFilterWord(uint32_t trace_token) {
+    return (trace_token & (PW_TRACE_CONFIG_TOKEN_FILTER_BITS - 1)) / 32;
+  }
+  static constexpr uint32_t TokenFilterBit(uint32_t trace_token) {
+    return 1u << (trace_token % 32);
+  }
+
+  // A set bit disables its tokens, so that every event is enabled at first.
+  uint32_t disabled_tokens_[PW_TRACE_CONFIG_TOKEN_FILTER_BITS / 32] = {};
+#endif  // PW_TRACE_CONFIG_TOKEN_FILTER_BITS > 0
+
+#if PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS > 0
+  // Returns true if this occurrence of the event should be recorded.
+  bool SampleEvent(uint32_t trace_token);
+
+  struct SampledEvent {
+    uint32_t trace_token;
+    uint32_t interval;  // 0 if the entry is free.
+    uint32_t count;
+  };
+  SampledEvent sampled_events_[PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS] = {};
+  size_t sampled_event_count_ = 0;
+#endif  // PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS > 0
+
+  // Advances the trigger after an event is recorded.
+  void UpdateTrigger(uint32_t trace_token);
+
+  uint32_t trigger_token_ = 0;
+  size_t post_trigger_events_ = 0;
+  bool trigger_armed_ = false;
+  bool triggered_ = false;
+
+#if PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+  void ResetThreadBuffers();
+
+  ThreadTraceBuffer thread_buffers_[PW_TRACE_CONFIG_THREAD_BUFFER_COUNT];
+  std::byte thread_buffer_storage_[PW_TRACE_CONFIG_THREAD_BUFFER_COUNT]
+                                  [PW_TRACE_CONFIG_THREAD_BUFFER_SIZE_BYTES];
+#endif  // PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
 };
 
 // A singleton object of the TokenizedTraceImpl class which can be used to
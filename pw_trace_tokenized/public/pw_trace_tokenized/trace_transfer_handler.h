@@ -0,0 +1,73 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// This file provides a pw_transfer read handler which exports the tokenized
+// trace buffer in bulk.
+
+#pragma once
+
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_stream/stream.h"
+#include "pw_transfer/handler.h"
+
+namespace pw {
+namespace trace {
+
+// Exports the trace buffer as a read transfer. The data is the raw
+// prefixed-ring-buffer format, a varint size followed by each entry, as
+// returned by DeringAndViewRawBuffer().
+//
+// In snapshot mode, tracing is paused for the duration of the transfer and the
+// deringed buffer is sent as a single blob. The buffer is cleared if the
+// transfer succeeds.
+//
+// In stream mode, tracing continues during the transfer. Whole entries are
+// popped from the buffer as chunks are sent, and the transfer ends once the
+// buffer is empty, so a host reads again to keep streaming. The popped entries
+// cannot be resent, so a lost chunk aborts the transfer.
+class TraceTransferHandler final : public transfer::ReadOnlyHandler {
+ public:
+  enum class Mode { kSnapshot, kStream };
+
+  TraceTransferHandler(uint32_t transfer_id, Mode mode)
+      : transfer::ReadOnlyHandler(transfer_id),
+        mode_(mode),
+        was_enabled_(false),
+        snapshot_reader_(ConstByteSpan()) {}
+
+  Status PrepareRead() final;
+
+  void FinalizeRead(Status status) final;
+
+ private:
+  // Pops whole entries from the trace buffer under the trace lock.
+  class StreamReader final : public stream::NonSeekableReader {
+   private:
+    StatusWithSize DoRead(ByteSpan destination) final;
+  };
+
+  Mode mode_;
+  bool was_enabled_;
+  stream::MemoryReader snapshot_reader_;
+  StreamReader stream_reader_;
+};
+
+}  // namespace trace
+}  // namespace pw
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests the clock_sync module."""
+
+import unittest
+
+from pw_trace_tokenized import clock_sync
+from pw_trace_tokenized.clock_sync import ClockMapping, ClockSample
+
+_EPOCH_US = 1_600_000_000_000_000
+
+
+class FakeDevice:
+    """A device clock at 1 MHz with an offset and drift from the host."""
+    def __init__(self, offset_us: float, drift_ppm: float, rtt_us: float):
+        self.host_us = float(_EPOCH_US)
+        self.offset_us = offset_us
+        self.drift_ppm = drift_ppm
+        self.rtt_us = rtt_us
+
+    def host_clock(self) -> float:
+        return self.host_us
+
+    def get_time(self):
+        # The device reads its time halfway through the round trip.
+        self.host_us += self.rtt_us / 2
+        ticks = round((self.host_us - _EPOCH_US + self.offset_us) /
+                      (1 + self.drift_ppm / 1e6))
+        self.host_us += self.rtt_us / 2
+        return ticks, 1_000_000
+
+
+class ClockSyncTest(unittest.TestCase):
+    """Tests estimating the mapping from device to host time."""
+    def test_single_sample_uses_midpoint(self):
+        mapping = clock_sync.estimate_mapping(
+            [[ClockSample(1000.0, 500, 1100.0)]], ticks_per_second=1000)
+        self.assertEqual(mapping.drift_ppm, 0)
+        self.assertEqual(mapping.uncertainty_us, 50)
+        self.assertEqual(mapping.to_host_us(500), 1050)
+        self.assertEqual(mapping.to_host_us(501), 2050)
+
+    def test_prefers_short_round_trips(self):
+        samples = [
+            ClockSample(0.0, 100, 10.0),
+            ClockSample(1000.0, 1000, 9000.0),
+            ClockSample(20.0, 120, 30.0),
+        ]
+        mapping = clock_sync.estimate_mapping([samples],
+                                              ticks_per_second=1_000_000,
+                                              best_fraction=0.5)
+        self.assertEqual(mapping.uncertainty_us, 5)
+        self.assertEqual(mapping.to_host_us(100), 5)
+
+    def test_estimates_offset_and_drift(self):
+        device = FakeDevice(offset_us=-250_000, drift_ppm=40, rtt_us=200)
+        before, tps = clock_sync.take_samples(device.get_time, 8,
+                                              device.host_clock)
+        device.host_us += 60e6
+        after, _ = clock_sync.take_samples(device.get_time, 8,
+                                           device.host_clock)
+
+        mapping = clock_sync.estimate_mapping([before, after], tps)
+        self.assertAlmostEqual(mapping.drift_ppm, 40, delta=0.1)
+
+        ticks, _ = device.get_time()
+        self.assertAlmostEqual(mapping.to_host_us(ticks),
+                               device.host_us - device.rtt_us / 2,
+                               delta=2)
+
+    def test_device_us_matches_ticks(self):
+        mapping = ClockMapping(ticks_per_second=1000,
+                               reference_ticks=10,
+                               reference_host_us=5000.0)
+        self.assertEqual(mapping.device_us_to_host_us(12_000),
+                         mapping.to_host_us(12))
+
+    def test_json_round_trip(self):
+        mapping = ClockMapping(ticks_per_second=32768,
+                               reference_ticks=123,
+                               reference_host_us=456.5,
+                               drift_ppm=-12.5,
+                               uncertainty_us=30.0)
+        self.assertEqual(ClockMapping.from_json(mapping.to_json()), mapping)
+
+    def test_no_samples_raises(self):
+        with self.assertRaises(ValueError):
+            clock_sync.estimate_mapping([[]], ticks_per_second=1000)
+
+
+if __name__ == '__main__':
+    unittest.main()
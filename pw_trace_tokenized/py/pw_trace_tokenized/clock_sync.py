@@ -0,0 +1,180 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Aligns a device's trace time with the host's clock.
+
+The host reads the device's trace time with the TraceService.GetTime RPC,
+recording the host time before the request is sent and after the response is
+received. As in NTP, the device time is assumed to have been read halfway
+through the round trip, so each sample's error is at most half of its round
+trip time. Samples with the shortest round trips are the most accurate, so only
+those are used.
+
+A line fit through samples taken over a period of time estimates both the
+offset between the clocks and the drift of the device's clock from its nominal
+rate. Taking a set of samples before and after a trace is captured gives a
+mapping which holds for the whole trace.
+"""
+
+import json
+import time
+from typing import Any, Callable, Dict, Iterable, List, NamedTuple, Tuple
+
+HostClock = Callable[[], float]
+
+
+def wall_clock_us() -> float:
+    """The default host clock, in microseconds since the epoch, so aligned
+    traces line up with host logs."""
+    return time.time_ns() / 1000
+
+
+class ClockSample(NamedTuple):
+    """A single reading of the device's trace time."""
+    host_send_us: float
+    device_ticks: int
+    host_receive_us: float
+
+    @property
+    def round_trip_us(self) -> float:
+        return self.host_receive_us - self.host_send_us
+
+    @property
+    def host_midpoint_us(self) -> float:
+        return (self.host_send_us + self.host_receive_us) / 2
+
+
+class ClockMapping(NamedTuple):
+    """Maps device trace time to host time.
+
+    host_us = reference_host_us
+              + (ticks - reference_ticks) * 1e6 / ticks_per_second
+                * (1 + drift_ppm / 1e6)
+    """
+    ticks_per_second: int
+    reference_ticks: int
+    reference_host_us: float
+    drift_ppm: float = 0.0
+    uncertainty_us: float = 0.0
+
+    def to_host_us(self, ticks: float) -> float:
+        """Converts a device trace time in ticks to host microseconds."""
+        us_per_tick = 1e6 / self.ticks_per_second * (1 + self.drift_ppm / 1e6)
+        return self.reference_host_us + (ticks -
+                                         self.reference_ticks) * us_per_tick
+
+    def device_us_to_host_us(self, device_us: float) -> float:
+        """Converts a device time in microseconds, as decoded from trace
+        events, to host microseconds."""
+        return self.to_host_us(device_us * self.ticks_per_second / 1e6)
+
+    def to_dict(self) -> Dict[str, Any]:
+        return self._asdict()
+
+    def to_json(self) -> str:
+        return json.dumps(self.to_dict())
+
+    @classmethod
+    def from_dict(cls, values: Dict[str, Any]) -> 'ClockMapping':
+        return cls(**values)
+
+    @classmethod
+    def from_json(cls, text: str) -> 'ClockMapping':
+        return cls.from_dict(json.loads(text))
+
+
+def _best_samples(samples: List[ClockSample],
+                  best_fraction: float) -> List[ClockSample]:
+    count = max(1, int(len(samples) * best_fraction))
+    return sorted(samples, key=lambda s: s.round_trip_us)[:count]
+
+
+def estimate_mapping(bursts: Iterable[Iterable[ClockSample]],
+                     ticks_per_second: int,
+                     best_fraction: float = 0.5) -> ClockMapping:
+    """Estimates a clock mapping from bursts of samples of the device time.
+
+    Only the best_fraction of each burst's samples, those with the shortest
+    round trips, are used. The drift is only estimated if the samples used span
+    more than one device time; otherwise the device clock is assumed to run at
+    its nominal rate. For an accurate drift, take bursts far apart in time.
+    """
+    if ticks_per_second <= 0:
+        raise ValueError('ticks_per_second must be positive')
+
+    best: List[ClockSample] = []
+    for burst in bursts:
+        samples = list(burst)
+        if samples:
+            best += _best_samples(samples, best_fraction)
+    if not best:
+        raise ValueError('At least one clock sample is required')
+
+    uncertainty_us = max(s.round_trip_us for s in best) / 2
+
+    # Fit host time against device time in microseconds. Measuring from the
+    # first sample keeps the values small enough for floats to stay accurate.
+    origin = min(best, key=lambda s: s.device_ticks)
+    xs = [(s.device_ticks - origin.device_ticks) * 1e6 / ticks_per_second
+          for s in best]
+    ys = [s.host_midpoint_us - origin.host_midpoint_us for s in best]
+
+    mean_x = sum(xs) / len(xs)
+    mean_y = sum(ys) / len(ys)
+    variance = sum((x - mean_x)**2 for x in xs)
+
+    if variance == 0:
+        slope = 1.0
+    else:
+        slope = sum(
+            (x - mean_x) * (y - mean_y) for x, y in zip(xs, ys)) / variance
+
+    # The intercept of the fitted line maps the first sample's device time.
+    reference_host_us = origin.host_midpoint_us + mean_y - slope * mean_x
+
+    return ClockMapping(ticks_per_second=ticks_per_second,
+                        reference_ticks=origin.device_ticks,
+                        reference_host_us=reference_host_us,
+                        drift_ppm=(slope - 1) * 1e6,
+                        uncertainty_us=uncertainty_us)
+
+
+def take_samples(
+        get_time: Callable[[], Tuple[int, int]],
+        count: int = 16,
+        host_clock: HostClock = wall_clock_us
+) -> Tuple[List[ClockSample], int]:
+    """Reads the device time count times.
+
+    get_time returns the device's trace time and ticks per second. Returns the
+    samples and the device's ticks per second.
+    """
+    samples = []
+    ticks_per_second = 0
+    for _ in range(count):
+        send_us = host_clock()
+        ticks, ticks_per_second = get_time()
+        samples.append(ClockSample(send_us, ticks, host_clock()))
+    return samples, ticks_per_second
+
+
+def rpc_get_time(trace_service) -> Callable[[], Tuple[int, int]]:
+    """Returns a get_time function which calls TraceService.GetTime."""
+    def get_time() -> Tuple[int, int]:
+        status, response = trace_service.GetTime()
+        if not status.ok():
+            raise RuntimeError(f'TraceService.GetTime failed with {status}')
+        return response.trace_time, response.ticks_per_second
+
+    return get_time
+
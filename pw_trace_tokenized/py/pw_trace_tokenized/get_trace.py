@@ -25,15 +25,17 @@ python pw_trace_tokenized/py/pw_trace_tokenized/get_trace.py -s localhost:33000
 import argparse
 import logging
 import glob
+import json
 from pathlib import Path
 import sys
-from typing import Collection, Iterable, Iterator
+from typing import Collection, Iterable, Iterator, List
 import serial  # type: ignore
 from pw_tokenizer import database
 from pw_trace import trace
 from pw_hdlc.rpc import HdlcRpcClient, default_channels
 from pw_hdlc.rpc_console import SocketClientImpl
-from pw_trace_tokenized import trace_tokenized
+from pw_trace_tokenized import clock_sync, trace_tokenized
+import pw_transfer
 
 _LOG = logging.getLogger('pw_trace_tokenizer')
 
@@ -98,6 +100,68 @@ def get_trace_data_from_device(client):
     return data
 
 
+def get_clock_samples(client, count: int = 16):
+    """Samples the device's trace time with the TraceService.
+
+    Returns the samples and the device's ticks per second, or None if the
+    device does not support TraceService.GetTime.
+    """
+    service = client.client.channel(1).rpcs.pw.trace.TraceService
+    if not hasattr(service, 'GetTime'):
+        _LOG.warning('TraceService.GetTime is not in the provided protos; the '
+                     'trace is not aligned with the host clock')
+        return None
+    try:
+        return clock_sync.take_samples(clock_sync.rpc_get_time(service),
+                                       count)
+    except RuntimeError as err:
+        _LOG.warning('%s; the trace is not aligned with the host clock', err)
+        return None
+
+
+def align_trace_events(events: List[trace.TraceEvent],
+                       mapping: clock_sync.ClockMapping):
+    """Converts the timestamps of decoded events to host time."""
+    return [
+        event._replace(
+            timestamp_us=mapping.device_us_to_host_us(event.timestamp_us))
+        for event in events
+    ]
+
+
+def clock_sync_json(mapping: clock_sync.ClockMapping) -> str:
+    """A metadata event which records the clock mapping in the trace file."""
+    return json.dumps({
+        'ph': 'M',
+        'name': 'clock_sync',
+        'pid': 'clock_sync',
+        'args': mapping.to_dict(),
+    })
+
+
+def get_trace_data_from_transfer(client, transfer_id: int,
+                                 stream: bool = False) -> bytes:
+    """Get the trace data using pw_transfer from a Client.
+
+    The device exports the trace buffer with a TraceTransferHandler. Entries in
+    the raw buffer are prefixed with a varint size, which is a single byte for
+    entries shorter than 128 bytes, as in the trace file format. In stream mode,
+    reads are repeated until interrupted.
+    """
+    transfer_manager = pw_transfer.Manager(
+        client.client.channel(1).rpcs.pw.transfer.Transfer)
+    if not stream:
+        return transfer_manager.read(transfer_id)
+
+    data = b''
+    try:
+        while True:
+            data += transfer_manager.read(transfer_id)
+    except KeyboardInterrupt:
+        _LOG.info('Stopped streaming after %d bytes', len(data))
+    return data
+
+
 def _parse_args():
     """Parse and return command line arguments."""
 
@@ -134,6 +198,29 @@ def _parse_args():
         dest='ticks_per_second',
         default=1000,
         help=('The clock rate of the trace events (Default 1000).'))
+    parser.add_argument(
+        '--packed',
+        action='store_true',
+        help=('Decode the packed encoding, enabled on the device with '
+              'PW_TRACE_CONFIG_PACKED_ENCODING.'))
+    parser.add_argument(
+        '--transfer_id',
+        type=int,
+        help=('Read the trace buffer with pw_transfer from this transfer ID '
+              'instead of using the TraceService.'))
+    parser.add_argument(
+        '--stream',
+        action='store_true',
+        help=('Keep reading from the transfer ID until interrupted, for a '
+              'device with a stream mode TraceTransferHandler.'))
+    parser.add_argument(
+        '--no_clock_sync',
+        dest='clock_sync',
+        action='store_false',
+        help=('Do not align the trace with the host clock. By default, the '
+              'device time is sampled with TraceService.GetTime before and '
+              'after reading the trace, and packed traces are converted to '
+              'host time.'))
     return parser.parse_args()
 
 
@@ -142,13 +229,40 @@ def _main(args):
         database.load_token_database(args.trace_token_database, domain="trace")
     _LOG.info(database.database_summary(token_database))
     client = get_hdlc_rpc_client(**vars(args))
-    data = get_trace_data_from_device(client)
+
+    sync_before = get_clock_samples(client) if args.clock_sync else None
+    if args.transfer_id is None:
+        data = get_trace_data_from_device(client)
+    else:
+        data = get_trace_data_from_transfer(client, args.transfer_id,
+                                            args.stream)
+    sync_after = get_clock_samples(client) if sync_before else None
+
+    mapping = None
+    ticks_per_second = args.ticks_per_second
+    if sync_before and sync_after:
+        ticks_per_second = sync_before[1]
+        mapping = clock_sync.estimate_mapping(
+            [sync_before[0], sync_after[0]], ticks_per_second)
+        _LOG.info('Clock sync: drift %.1f ppm, uncertainty %.0f us',
+                  mapping.drift_ppm, mapping.uncertainty_us)
+
     events = trace_tokenized.get_trace_events([token_database], data,
-                                              args.ticks_per_second)
-    json_lines = trace.generate_trace_json(events)
+                                              ticks_per_second, args.packed)
+    json_lines = []
+    if mapping is not None:
+        # Only packed traces have sync events with the absolute device time.
+        # Other traces are relative to their first event, so they are left as
+        # is, but the mapping is still recorded for tools which know the start.
+        if args.packed:
+            events = align_trace_events(events, mapping)
+        else:
+            _LOG.warning('Unpacked traces are relative to their first event '
+                         'and are not converted to host time')
+        json_lines.append(clock_sync_json(mapping))
+    json_lines += trace.generate_trace_json(events)
     trace_tokenized.save_trace_file(json_lines, args.trace_output_file)
 
-
 if __name__ == '__main__':
     if sys.version_info[0] < 3:
         sys.exit('ERROR: The detokenizer command line tools require Python 3.')
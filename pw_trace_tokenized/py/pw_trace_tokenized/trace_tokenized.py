@@ -106,7 +106,16 @@ def create_trace_event(token_string, timestamp_us, trace_id, data):
                             data=data if has_data(token_string) else b'')
 
 
-def parse_trace_event(buffer, db, last_time, ticks_per_second):
+# Token of the sync events sent with the packed encoding.
+SYNC_EVENT_TOKEN = 0
+
+
+def parse_trace_event(buffer,
+                      db,
+                      last_time,
+                      ticks_per_second,
+                      packed=False,
+                      last_trace_id=None):
     """Parse a single trace event from bytes"""
     us_per_tick = 1000000 / ticks_per_second
     idx = 0
@@ -123,14 +132,23 @@ def parse_trace_event(buffer, db, last_time, ticks_per_second):
 
     # Read time
     time_delta, time_bytes = varint_decode(buffer[idx:])
-    timestamp_us = last_time + us_per_tick * time_delta
     idx += time_bytes
 
+    # With the packed encoding, the lowest bit of the time delta indicates if
+    # the trace ID is present.
+    trace_id_present = has_trace_id(token_string)
+    if packed and has_trace_id(token_string):
+        trace_id_present = bool(time_delta & 1)
+        time_delta >>= 1
+    timestamp_us = last_time + us_per_tick * time_delta
+
     # Trace ID
     trace_id = None
-    if has_trace_id(token_string) and idx < len(buffer):
+    if trace_id_present and idx < len(buffer):
         trace_id, trace_id_bytes = varint_decode(buffer[idx:])
         idx += trace_id_bytes
+    elif packed and has_trace_id(token_string):
+        trace_id = last_trace_id
 
     # Data
     data = None
@@ -141,11 +159,19 @@ def parse_trace_event(buffer, db, last_time, ticks_per_second):
     return create_trace_event(token_string, timestamp_us, trace_id, data)
 
 
-def get_trace_events(databases, raw_trace_data, ticks_per_second):
-    """Handles the decoding traces."""
+def get_trace_events(databases,
+                     raw_trace_data,
+                     ticks_per_second,
+                     packed=False):
+    """Handles the decoding traces.
+
+    If packed is True, the events are decoded with the packed encoding
+    (PW_TRACE_CONFIG_PACKED_ENCODING), which includes sync events.
+    """
 
     db = tokens.Database.merged(*databases)
     last_timestamp = 0
+    last_trace_id = None
     events = []
     idx = 0
 
@@ -156,12 +182,23 @@ def get_trace_events(databases, raw_trace_data, ticks_per_second):
             _LOG.error("incomplete file")
             break
 
-        event = parse_trace_event(raw_trace_data[idx + 1:idx + 1 + size], db,
-                                  last_timestamp, ticks_per_second)
+        buffer = raw_trace_data[idx + 1:idx + 1 + size]
+        idx = idx + size + 1
+
+        # Sync events hold the full time and reset the previous trace ID.
+        if packed and struct.unpack('I', buffer[:4])[0] == SYNC_EVENT_TOKEN:
+            sync_time, _ = varint_decode(buffer[4:])
+            last_timestamp = sync_time * 1000000 / ticks_per_second
+            last_trace_id = None
+            continue
+
+        event = parse_trace_event(buffer, db, last_timestamp,
+                                  ticks_per_second, packed, last_trace_id)
         if event:
             last_timestamp = event.timestamp_us
+            if event.trace_id is not None:
+                last_trace_id = event.trace_id
             events.append(event)
-        idx = idx + size + 1
     return events
 
 
@@ -181,10 +218,14 @@ def save_trace_file(trace_lines, file_name):
         output_file.write("{}]")
 
 
-def get_trace_events_from_file(databases, input_file_name, ticks_per_second):
+def get_trace_events_from_file(databases,
+                               input_file_name,
+                               ticks_per_second,
+                               packed=False):
     """Get trace events from a file."""
     raw_trace_data = get_trace_data_from_file(input_file_name)
-    return get_trace_events(databases, raw_trace_data, ticks_per_second)
+    return get_trace_events(databases, raw_trace_data, ticks_per_second,
+                            packed)
 
 
 def _parse_args():
@@ -214,13 +255,18 @@ def _parse_args():
         dest='ticks_per_second',
         default=1000,
         help=('The clock rate of the trace events (Default 1000).'))
+    parser.add_argument(
+        '--packed',
+        action='store_true',
+        help=('Decode the packed encoding, enabled on the device with '
+              'PW_TRACE_CONFIG_PACKED_ENCODING.'))
 
     return parser.parse_args()
 
 
 def _main(args):
     events = get_trace_events_from_file(args.databases, args.input_file,
-                                        args.ticks_per_second)
+                                        args.ticks_per_second, args.packed)
     json_lines = trace.generate_trace_json(events)
     save_trace_file(json_lines, args.output_file)
 
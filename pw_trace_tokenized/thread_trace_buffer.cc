@@ -0,0 +1,147 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+#include "pw_trace_tokenized/thread_trace_buffer.h"
+
+#include <cstring>
+#include <limits>
+
+#include "pw_varint/varint.h"
+
+namespace pw {
+namespace trace {
+namespace {
+
+// Each entry holds the absolute time, followed by the token, the trace ID
+// varint if the event has one, and the data.
+constexpr size_t kTimeSize = sizeof(PW_TRACE_TIME_TYPE);
+constexpr size_t kTokenSize = sizeof(uint32_t);
+constexpr size_t kMaxEntrySize = kTimeSize + kTokenSize +
+                                 varint::kMaxVarint32SizeBytes +
+                                 PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES;
+
+// Events appended while merging may be earlier than the last merged event. The
+// distance to those wraps around to more than half of the range of the time
+// type.
+constexpr PW_TRACE_TIME_TYPE kMaxDistance =
+    std::numeric_limits<PW_TRACE_TIME_TYPE>::max() / 2;
+
+PW_TRACE_TIME_TYPE EntryTime(std::span<const std::byte> entry) {
+  PW_TRACE_TIME_TYPE time;
+  std::memcpy(&time, entry.data(), kTimeSize);
+  return time;
+}
+
+}  // namespace
+
+Status ThreadTraceBuffer::Append(PW_TRACE_TIME_TYPE time,
+                                 uint32_t trace_token,
+                                 std::optional<uint32_t> trace_id,
+                                 ConstByteSpan data) {
+  if (data.size() > PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES) {
+    return Status::InvalidArgument();
+  }
+
+  std::byte entry[kMaxEntrySize];
+  std::memcpy(entry, &time, kTimeSize);
+  std::memcpy(&entry[kTimeSize], &trace_token, kTokenSize);
+  size_t entry_size = kTimeSize + kTokenSize;
+
+  if (trace_id.has_value()) {
+    const std::span<std::byte> remaining(&entry[entry_size],
+                                         kMaxEntrySize - entry_size);
+    entry_size += varint::Encode(trace_id.value(), remaining);
+  }
+  if (!data.empty()) {
+    std::memcpy(&entry[entry_size], data.data(), data.size());
+    entry_size += data.size();
+  }
+
+  return queue_.PushBack(std::span(entry, entry_size));
+}
+
+StatusWithSize ThreadTraceBufferMerger::ReadNext(ByteSpan output) {
+  // Find the buffer whose next event is the closest after the last merged
+  // event. Measuring from the last merged event handles time wrapping in the
+  // same way the sinks' delta encoding does. Late events are merged first,
+  // with a delta of 0.
+  ThreadTraceBuffer* next = nullptr;
+  std::span<const std::byte> next_entry;
+  PW_TRACE_TIME_TYPE next_distance = 0;
+
+  for (ThreadTraceBuffer& buffer : buffers_) {
+    const Result<std::span<const std::byte>> entry = buffer.queue_.PeekFront();
+    if (!entry.ok()) {
+      continue;
+    }
+    const PW_TRACE_TIME_TYPE time = EntryTime(entry.value());
+    PW_TRACE_TIME_TYPE distance = time;
+    if (has_last_time_) {
+      distance = PW_TRACE_GET_TIME_DELTA(last_time_, time);
+      if (distance > kMaxDistance) {
+        distance = 0;
+      }
+    }
+    if (next == nullptr || distance < next_distance) {
+      next = &buffer;
+      next_entry = entry.value();
+      next_distance = distance;
+    }
+  }
+
+  if (next == nullptr) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  // Rewrite the entry as the token, the time delta varint, and the rest of the
+  // entry unchanged.
+  const PW_TRACE_TIME_TYPE time = EntryTime(next_entry);
+  const PW_TRACE_TIME_TYPE delta = has_last_time_ ? next_distance : 0;
+
+  std::byte delta_varint[varint::kMaxVarint64SizeBytes];
+  const size_t delta_size = varint::Encode(delta, delta_varint);
+  const std::span<const std::byte> token =
+      next_entry.subspan(kTimeSize, kTokenSize);
+  const std::span<const std::byte> rest =
+      next_entry.subspan(kTimeSize + kTokenSize);
+
+  const size_t size = token.size() + delta_size + rest.size();
+  if (size > output.size()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  std::memcpy(output.data(), token.data(), token.size());
+  std::memcpy(&output[token.size()], delta_varint, delta_size);
+  if (!rest.empty()) {
+    std::memcpy(&output[token.size() + delta_size], rest.data(), rest.size());
+  }
+
+  if (!has_last_time_ || delta != 0u) {
+    last_time_ = time;
+    has_last_time_ = true;
+  }
+  next->queue_.PopFront().IgnoreError();  // The entry was just peeked.
+  return StatusWithSize(size);
+}
+
+void ThreadTraceBufferMerger::Clear() {
+  for (ThreadTraceBuffer& buffer : buffers_) {
+    while (buffer.queue_.PopFront().ok()) {
+    }
+  }
+}
+
+}  // namespace trace
+}  // namespace pw
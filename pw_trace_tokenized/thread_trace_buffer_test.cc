@@ -0,0 +1,150 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/thread_trace_buffer.h"
+
+#include <array>
+#include <cstring>
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::trace {
+namespace {
+
+constexpr uint32_t kToken1 = 0x11111111;
+constexpr uint32_t kToken2 = 0x22222222;
+
+class ThreadTraceBufferTest : public ::testing::Test {
+ protected:
+  ThreadTraceBufferTest() : merger_(buffers_) {
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+      EXPECT_EQ(OkStatus(), buffers_[i].SetBuffer(storage_[i]));
+    }
+  }
+
+  // Reads the next merged event and checks its token and time delta.
+  void ExpectNext(uint32_t token, uint8_t delta) {
+    std::array<std::byte, 32> block;
+    const StatusWithSize result = merger_.ReadNext(block);
+    ASSERT_EQ(OkStatus(), result.status());
+    ASSERT_GE(result.size(), 5u);
+
+    uint32_t read_token;
+    std::memcpy(&read_token, block.data(), sizeof(read_token));
+    EXPECT_EQ(token, read_token);
+    EXPECT_EQ(std::byte{delta}, block[4]);  // Single byte varint
+  }
+
+  std::array<std::array<std::byte, 64>, 3> storage_ = {};
+  std::array<ThreadTraceBuffer, 3> buffers_;
+  ThreadTraceBufferMerger merger_;
+};
+
+TEST_F(ThreadTraceBufferTest, ReadNext_Empty) {
+  std::array<std::byte, 32> block;
+  EXPECT_EQ(Status::OutOfRange(), merger_.ReadNext(block).status());
+}
+
+TEST_F(ThreadTraceBufferTest, ReadNext_MergesInTimeOrder) {
+  ASSERT_EQ(OkStatus(), buffers_[0].Append(10, kToken1, std::nullopt, {}));
+  ASSERT_EQ(OkStatus(), buffers_[0].Append(40, kToken1, std::nullopt, {}));
+  ASSERT_EQ(OkStatus(), buffers_[1].Append(20, kToken2, std::nullopt, {}));
+  ASSERT_EQ(OkStatus(), buffers_[2].Append(30, kToken2, std::nullopt, {}));
+  ASSERT_EQ(OkStatus(), buffers_[1].Append(50, kToken2, std::nullopt, {}));
+
+  ExpectNext(kToken1, 0);  // The first event has no previous event.
+  ExpectNext(kToken2, 10);
+  ExpectNext(kToken2, 10);
+  ExpectNext(kToken1, 10);
+  ExpectNext(kToken2, 10);
+
+  std::array<std::byte, 32> block;
+  EXPECT_EQ(Status::OutOfRange(), merger_.ReadNext(block).status());
+}
+
+TEST_F(ThreadTraceBufferTest, ReadNext_TraceIdAndData) {
+  constexpr auto kData = bytes::Array<1, 2, 3>();
+  ASSERT_EQ(OkStatus(), buffers_[1].Append(5, kToken1, 300, kData));
+
+  std::array<std::byte, 32> block;
+  const StatusWithSize result = merger_.ReadNext(block);
+  ASSERT_EQ(OkStatus(), result.status());
+
+  // Token, time delta, trace ID varint, data.
+  constexpr auto kExpected = bytes::Concat(
+      kToken1, bytes::Array<0x00, 0xac, 0x02>(), bytes::Array<1, 2, 3>());
+  ASSERT_EQ(kExpected.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(kExpected.data(), block.data(), result.size()));
+}
+
+TEST_F(ThreadTraceBufferTest, ReadNext_OutputTooSmall_KeepsEvent) {
+  ASSERT_EQ(OkStatus(), buffers_[0].Append(5, kToken1, std::nullopt, {}));
+
+  std::array<std::byte, 4> small;
+  EXPECT_EQ(Status::ResourceExhausted(), merger_.ReadNext(small).status());
+  ExpectNext(kToken1, 0);
+}
+
+TEST_F(ThreadTraceBufferTest, ReadNext_TimeWraps) {
+  constexpr PW_TRACE_TIME_TYPE kMax =
+      std::numeric_limits<PW_TRACE_TIME_TYPE>::max();
+  ASSERT_EQ(OkStatus(),
+            buffers_[0].Append(kMax - 4, kToken1, std::nullopt, {}));
+  ASSERT_EQ(OkStatus(), buffers_[1].Append(kMax, kToken1, std::nullopt, {}));
+  ASSERT_EQ(OkStatus(), buffers_[0].Append(5, kToken2, std::nullopt, {}));
+
+  ExpectNext(kToken1, 0);
+  ExpectNext(kToken1, 4);
+  ExpectNext(kToken2, 6);
+}
+
+TEST_F(ThreadTraceBufferTest, ReadNext_LateEvent_ZeroDelta) {
+  ASSERT_EQ(OkStatus(), buffers_[0].Append(100, kToken1, std::nullopt, {}));
+  ExpectNext(kToken1, 0);
+
+  // An event from before the last merged event, then a later one.
+  ASSERT_EQ(OkStatus(), buffers_[1].Append(90, kToken2, std::nullopt, {}));
+  ASSERT_EQ(OkStatus(), buffers_[0].Append(110, kToken1, std::nullopt, {}));
+  ExpectNext(kToken2, 0);
+  ExpectNext(kToken1, 10);
+}
+
+TEST_F(ThreadTraceBufferTest, Append_Full_CountsDrops) {
+  Status status;
+  while ((status = buffers_[0].Append(1, kToken1, std::nullopt, {})).ok()) {
+  }
+  EXPECT_EQ(Status::ResourceExhausted(), status);
+  EXPECT_EQ(1u, buffers_[0].drop_count());
+  EXPECT_EQ(0u, buffers_[1].drop_count());
+}
+
+TEST_F(ThreadTraceBufferTest, Append_DataTooLarge) {
+  std::array<std::byte, PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES + 1> data = {};
+  EXPECT_EQ(Status::InvalidArgument(),
+            buffers_[0].Append(1, kToken1, std::nullopt, data));
+}
+
+TEST_F(ThreadTraceBufferTest, Clear) {
+  ASSERT_EQ(OkStatus(), buffers_[0].Append(1, kToken1, std::nullopt, {}));
+  ASSERT_EQ(OkStatus(), buffers_[2].Append(2, kToken1, std::nullopt, {}));
+  merger_.Clear();
+
+  std::array<std::byte, 32> block;
+  EXPECT_EQ(Status::OutOfRange(), merger_.ReadNext(block).status());
+}
+
+}  // namespace
+}  // namespace pw::trace
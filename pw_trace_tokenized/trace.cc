@@ -16,6 +16,9 @@
 
 #include "pw_trace/trace.h"
 
+#include <optional>
+#include <span>
+
 #include "pw_preprocessor/util.h"
 #include "pw_trace_tokenized/trace_callback.h"
 #include "pw_trace_tokenized/trace_tokenized.h"
@@ -34,12 +37,39 @@ void TokenizedTraceImpl::HandleTraceEvent(uint32_t trace_token,
                                           uint8_t flags,
                                           const void* data_buffer,
                                           size_t data_size) {
+#if PW_TRACE_CONFIG_TOKEN_FILTER_BITS > 0
+  if (!IsEventEnabled(trace_token)) {
+    return;
+  }
+#endif  // PW_TRACE_CONFIG_TOKEN_FILTER_BITS > 0
+
   // Early exit if disabled and no callbacks are register to receive events
   // while disabled.
   if (!enabled_ && Callbacks::Instance().GetCalledOnEveryEventCount() == 0) {
     return;
   }
 
+#if PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+  // Append the event to the calling thread's buffer without locking. Event
+  // callbacks and sinks are not called; the buffers are merged when read.
+  if (!enabled_) {
+    return;
+  }
+  const size_t buffer_index = PW_TRACE_GET_THREAD_BUFFER_INDEX();
+  if (buffer_index < PW_TRACE_CONFIG_THREAD_BUFFER_COUNT) {
+    thread_buffers_[buffer_index]
+        .Append(PW_TRACE_GET_TIME(),
+                trace_token,
+                PW_TRACE_HAS_TRACE_ID(event_type)
+                    ? std::optional<uint32_t>(trace_id)
+                    : std::nullopt,
+                std::span(static_cast<const std::byte*>(data_buffer),
+                          data_size))
+        .IgnoreError();  // Dropped events are counted by the buffer.
+  }
+  return;
+#endif  // PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+
   // Create trace event
   PW_TRACE_QUEUE_LOCK();
   if (!event_queue_
@@ -94,6 +124,12 @@ void TokenizedTraceImpl::HandleNextItemInQueue(
     return;
   }
 
+#if PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS > 0
+  if (sampled_event_count_ != 0u && !SampleEvent(trace_token)) {
+    return;
+  }
+#endif  // PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS > 0
+
   // Call any event callback not already called.
   ret_flags |= Callbacks::Instance().CallEventCallbacks(
       CallbacksImpl::kCallOnlyWhenEnabled,
@@ -118,14 +154,47 @@ void TokenizedTraceImpl::HandleNextItemInQueue(
 
   // Compute delta of time elapsed since last trace entry.
   PW_TRACE_TIME_TYPE trace_time = pw_trace_GetTraceTime();
+#if PW_TRACE_CONFIG_PACKED_ENCODING
+  if (events_until_sync_ == 0) {
+    SendSyncEvent(trace_time);
+    events_until_sync_ = PW_TRACE_CONFIG_SYNC_INTERVAL_EVENTS;
+  }
+  events_until_sync_ -= 1;
+#endif  // PW_TRACE_CONFIG_PACKED_ENCODING
   PW_TRACE_TIME_TYPE delta =
       (last_trace_time_ == 0)
           ? 0
           : PW_TRACE_GET_TIME_DELTA(last_trace_time_, trace_time);
+  last_trace_time_ = trace_time;
+
+#if PW_TRACE_CONFIG_PACKED_ENCODING
+  // The lowest bit of the delta indicates if the trace ID follows. It is only
+  // sent when it differs from the previous event's trace ID.
+  if (PW_TRACE_HAS_TRACE_ID(event_type)) {
+    const bool send_trace_id =
+        !has_last_trace_id_ || trace_id != last_trace_id_;
+    header_size += pw::varint::Encode(
+        (static_cast<uint64_t>(delta) << 1) | (send_trace_id ? 1u : 0u),
+        std::span<std::byte>(&header[header_size],
+                             kMaxHeaderSize - header_size));
+    if (send_trace_id) {
+      header_size += pw::varint::Encode(
+          trace_id,
+          std::span<std::byte>(&header[header_size],
+                               kMaxHeaderSize - header_size));
+      last_trace_id_ = trace_id;
+      has_last_trace_id_ = true;
+    }
+  } else {
+    header_size += pw::varint::Encode(
+        delta,
+        std::span<std::byte>(&header[header_size],
+                             kMaxHeaderSize - header_size));
+  }
+#else
   header_size += pw::varint::Encode(
       delta,
       std::span<std::byte>(&header[header_size], kMaxHeaderSize - header_size));
-  last_trace_time_ = trace_time;
 
   // Calculate packet id if needed.
   if (PW_TRACE_HAS_TRACE_ID(event_type)) {
@@ -134,6 +203,7 @@ void TokenizedTraceImpl::HandleNextItemInQueue(
                            std::span<std::byte>(&header[header_size],
                                                 kMaxHeaderSize - header_size));
   }
+#endif  // PW_TRACE_CONFIG_PACKED_ENCODING
 
   // Send encoded output to any registered trace sinks.
   Callbacks::Instance().CallSinks(
@@ -144,7 +214,130 @@ void TokenizedTraceImpl::HandleNextItemInQueue(
   if (PW_TRACE_EVENT_RETURN_FLAGS_DISABLE_AFTER_PROCESSING & ret_flags) {
     enabled_ = false;
   }
+  if (trigger_armed_) {
+    UpdateTrigger(trace_token);
+  }
+}
+
+#if PW_TRACE_CONFIG_TOKEN_FILTER_BITS > 0
+void TokenizedTraceImpl::SetEventEnabled(uint32_t trace_token, bool enable) {
+  PW_TRACE_LOCK();
+  if (enable) {
+    disabled_tokens_[TokenFilterWord(trace_token)] &=
+        ~TokenFilterBit(trace_token);
+  } else {
+    disabled_tokens_[TokenFilterWord(trace_token)] |=
+        TokenFilterBit(trace_token);
+  }
+  PW_TRACE_UNLOCK();
+}
+#endif  // PW_TRACE_CONFIG_TOKEN_FILTER_BITS > 0
+
+#if PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS > 0
+pw::Status TokenizedTraceImpl::SetEventSampling(uint32_t trace_token,
+                                                uint32_t interval) {
+  if (interval == 1u) {
+    interval = 0;
+  }
+
+  pw::Status status = pw::OkStatus();
+  PW_TRACE_LOCK();
+  SampledEvent* free_entry = nullptr;
+  SampledEvent* entry = nullptr;
+  for (SampledEvent& sampled : sampled_events_) {
+    if (sampled.interval == 0u) {
+      free_entry = free_entry == nullptr ? &sampled : free_entry;
+    } else if (sampled.trace_token == trace_token) {
+      entry = &sampled;
+    }
+  }
+
+  if (entry == nullptr && interval != 0u) {
+    entry = free_entry;
+    if (entry == nullptr) {
+      status = pw::Status::ResourceExhausted();
+    } else {
+      sampled_event_count_ += 1;
+    }
+  } else if (entry != nullptr && interval == 0u) {
+    sampled_event_count_ -= 1;
+  }
+
+  if (entry != nullptr) {
+    *entry = {.trace_token = trace_token, .interval = interval, .count = 0};
+  }
+  PW_TRACE_UNLOCK();
+  return status;
+}
+
+bool TokenizedTraceImpl::SampleEvent(uint32_t trace_token) {
+  for (SampledEvent& sampled : sampled_events_) {
+    if (sampled.interval != 0u && sampled.trace_token == trace_token) {
+      const bool record = sampled.count == 0u;
+      sampled.count = (sampled.count + 1) % sampled.interval;
+      return record;
+    }
+  }
+  return true;
+}
+#endif  // PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS > 0
+
+void TokenizedTraceImpl::SetTrigger(uint32_t trigger_token,
+                                    size_t post_trigger_events) {
+  PW_TRACE_LOCK();
+  trigger_token_ = trigger_token;
+  post_trigger_events_ = post_trigger_events;
+  trigger_armed_ = true;
+  triggered_ = false;
+  PW_TRACE_UNLOCK();
+}
+
+void TokenizedTraceImpl::ClearTrigger() {
+  PW_TRACE_LOCK();
+  trigger_armed_ = false;
+  triggered_ = false;
+  PW_TRACE_UNLOCK();
+}
+
+void TokenizedTraceImpl::UpdateTrigger(uint32_t trace_token) {
+  if (!triggered_) {
+    triggered_ = trace_token == trigger_token_;
+  } else if (post_trigger_events_ > 0u) {
+    post_trigger_events_ -= 1;
+  }
+
+  if (triggered_ && post_trigger_events_ == 0u) {
+    enabled_ = false;
+    trigger_armed_ = false;
+  }
+}
+
+#if PW_TRACE_CONFIG_PACKED_ENCODING
+void TokenizedTraceImpl::SendSyncEvent(PW_TRACE_TIME_TYPE trace_time) {
+  // Token 0 is the empty string, so it is never a trace event's token.
+  std::byte sync[sizeof(uint32_t) + pw::varint::kMaxVarint64SizeBytes] = {};
+  const size_t sync_size =
+      sizeof(uint32_t) +
+      pw::varint::Encode(trace_time,
+                         std::span(sync).subspan(sizeof(uint32_t)));
+  Callbacks::Instance().CallSinks(std::span(sync, sync_size),
+                                  std::span<const std::byte>());
+
+  // The next event is encoded relative to the sync event.
+  last_trace_time_ = trace_time;
+  has_last_trace_id_ = false;
+}
+#endif  // PW_TRACE_CONFIG_PACKED_ENCODING
+
+#if PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+void TokenizedTraceImpl::ResetThreadBuffers() {
+  for (size_t i = 0; i < PW_TRACE_CONFIG_THREAD_BUFFER_COUNT; i++) {
+    thread_buffers_[i]
+        .SetBuffer(thread_buffer_storage_[i])
+        .IgnoreError();  // The storage is always large enough.
+  }
 }
+#endif  // PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
 
 pw_trace_TraceEventReturnFlags CallbacksImpl::CallEventCallbacks(
     CallOnEveryEvent called_on_every_event,
@@ -69,10 +69,19 @@ class TraceBuffer {
   }
 
   pw::ring_buffer::PrefixedEntryRingBuffer& RingBuffer() {
+    MergeThreadBuffers();
     return ring_buffer_;
   };
 
+  void Clear() {
+#if PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+    thread_buffer_merger_.Clear();
+#endif  // PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+    ring_buffer_.Clear();
+  }
+
   ConstByteSpan DeringAndViewRawBuffer() {
+    MergeThreadBuffers();
     ring_buffer_.Dering();
     return ByteSpan(raw_buffer_, ring_buffer_.TotalUsedBytes());
   }
@@ -83,6 +92,25 @@ class TraceBuffer {
   std::byte current_block_[PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES];
   std::byte raw_buffer_[PW_TRACE_BUFFER_SIZE_BYTES];
   pw::ring_buffer::PrefixedEntryRingBuffer ring_buffer_{false};
+
+  // Moves the events in the per-thread trace buffers, if any, into the ring
+  // buffer in timestamp order. The sinks are not called when per-thread
+  // buffers are used, so the current block is free to use.
+  void MergeThreadBuffers() {
+#if PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+    StatusWithSize result;
+    while ((result = thread_buffer_merger_.ReadNext(current_block_)).ok()) {
+      ring_buffer_
+          .PushBack(std::span<const std::byte>(current_block_, result.size()))
+          .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+    }
+#endif  // PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+  }
+
+#if PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
+  ThreadTraceBufferMerger thread_buffer_merger_{
+      TokenizedTrace::Instance().thread_buffers()};
+#endif  // PW_TRACE_CONFIG_THREAD_BUFFER_COUNT > 0
 };
 
 #if PW_TRACE_BUFFER_SIZE_BYTES > 0
@@ -91,7 +119,7 @@ TraceBuffer trace_buffer_instance;
 
 }  // namespace
 
-void ClearBuffer() { trace_buffer_instance.RingBuffer().Clear(); }
+void ClearBuffer() { trace_buffer_instance.Clear(); }
 
 pw::ring_buffer::PrefixedEntryRingBuffer* GetBuffer() {
   return &trace_buffer_instance.RingBuffer();
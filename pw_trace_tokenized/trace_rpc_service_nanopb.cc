@@ -60,4 +60,12 @@ void TraceService::GetTraceData(
   }
   writer.Finish();
 }
+
+pw::Status TraceService::GetTime(ServerContext&,
+                                 const pw_trace_Empty&,
+                                 pw_trace_TraceTimeMessage& response) {
+  response.trace_time = PW_TRACE_GET_TIME();
+  response.ticks_per_second = PW_TRACE_GET_TIME_TICKS_PER_SECOND();
+  return PW_STATUS_OK;
+}
 }  // namespace pw::trace
\ No newline at end of file
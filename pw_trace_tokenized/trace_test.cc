@@ -435,6 +435,123 @@ TEST(TokenizedTrace, DisableAfterTrace) {
   EXPECT_TRUE(test_interface.GetEvents().empty());
 }
 
+TEST(TokenizedTrace, TriggerFreezesAfterPostTriggerEvents) {
+  TraceTestInterface test_interface;
+  constexpr uint32_t kTrigger = PW_TRACE_REF(PW_TRACE_TYPE_INSTANT,
+                                             "TST",    // Module
+                                             "Test2",  // Label
+                                             PW_TRACE_FLAGS_DEFAULT,
+                                             PW_TRACE_GROUP_LABEL_DEFAULT);
+  pw::trace::TokenizedTrace::Instance().SetTrigger(kTrigger, 1);
+
+  PW_TRACE_INSTANT("Test1");
+  EXPECT_FALSE(pw::trace::TokenizedTrace::Instance().triggered());
+  PW_TRACE_INSTANT("Test2");
+  EXPECT_TRUE(pw::trace::TokenizedTrace::Instance().triggered());
+  PW_TRACE_INSTANT("Test3");
+  PW_TRACE_INSTANT("Test4");
+
+  // Check results
+  EXPECT_FALSE(pw_trace_IsEnabled());
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test1");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test2");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test3");
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+  pw::trace::TokenizedTrace::Instance().ClearTrigger();
+}
+
+TEST(TokenizedTrace, ClearTrigger) {
+  TraceTestInterface test_interface;
+  constexpr uint32_t kTrigger = PW_TRACE_REF(PW_TRACE_TYPE_INSTANT,
+                                             "TST",    // Module
+                                             "Test1",  // Label
+                                             PW_TRACE_FLAGS_DEFAULT,
+                                             PW_TRACE_GROUP_LABEL_DEFAULT);
+  pw::trace::TokenizedTrace::Instance().SetTrigger(kTrigger, 0);
+  pw::trace::TokenizedTrace::Instance().ClearTrigger();
+
+  PW_TRACE_INSTANT("Test1");
+  PW_TRACE_INSTANT("Test2");
+
+  // Check results
+  EXPECT_TRUE(pw_trace_IsEnabled());
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test1");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test2");
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+}
+
+#if PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS > 0
+TEST(TokenizedTrace, SampleEvent) {
+  TraceTestInterface test_interface;
+  constexpr uint32_t kTest1 = PW_TRACE_REF(PW_TRACE_TYPE_INSTANT,
+                                           "TST",    // Module
+                                           "Test1",  // Label
+                                           PW_TRACE_FLAGS_DEFAULT,
+                                           PW_TRACE_GROUP_LABEL_DEFAULT);
+  ASSERT_EQ(pw::OkStatus(),
+            pw::trace::TokenizedTrace::Instance().SetEventSampling(kTest1, 3));
+
+  for (int i = 0; i < 4; ++i) {
+    PW_TRACE_INSTANT("Test1");
+    PW_TRACE_INSTANT("Test2");
+  }
+
+  // Check results
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test1");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test2");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test2");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test2");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test1");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test2");
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+
+  ASSERT_EQ(pw::OkStatus(),
+            pw::trace::TokenizedTrace::Instance().SetEventSampling(kTest1, 1));
+  PW_TRACE_INSTANT("Test1");
+  PW_TRACE_INSTANT("Test1");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test1");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test1");
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+}
+
+TEST(TokenizedTrace, SampleEvent_TooMany) {
+  for (uint32_t i = 0; i < PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS; ++i) {
+    EXPECT_EQ(pw::OkStatus(),
+              pw::trace::TokenizedTrace::Instance().SetEventSampling(i, 2));
+  }
+  EXPECT_EQ(pw::Status::ResourceExhausted(),
+            pw::trace::TokenizedTrace::Instance().SetEventSampling(
+                PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS, 2));
+  for (uint32_t i = 0; i < PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS; ++i) {
+    EXPECT_EQ(pw::OkStatus(),
+              pw::trace::TokenizedTrace::Instance().SetEventSampling(i, 0));
+  }
+}
+#endif  // PW_TRACE_CONFIG_MAX_SAMPLED_EVENTS > 0
+
+#if PW_TRACE_CONFIG_TOKEN_FILTER_BITS > 0
+TEST(TokenizedTrace, DisableEventByToken) {
+  TraceTestInterface test_interface;
+  constexpr uint32_t kTest1 = PW_TRACE_REF(PW_TRACE_TYPE_INSTANT,
+                                           "TST",    // Module
+                                           "Test1",  // Label
+                                           PW_TRACE_FLAGS_DEFAULT,
+                                           PW_TRACE_GROUP_LABEL_DEFAULT);
+  pw::trace::TokenizedTrace::Instance().SetEventEnabled(kTest1, false);
+  EXPECT_FALSE(pw::trace::TokenizedTrace::Instance().IsEventEnabled(kTest1));
+
+  PW_TRACE_INSTANT("Test1");
+  PW_TRACE_INSTANT("Test2");
+  pw::trace::TokenizedTrace::Instance().SetEventEnabled(kTest1, true);
+  PW_TRACE_INSTANT("Test1");
+
+  // Check results
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test2");
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test1");
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+}
+#endif  // PW_TRACE_CONFIG_TOKEN_FILTER_BITS > 0
+
 TEST(TokenizedTrace, Scope) {
   TraceTestInterface test_interface;
 
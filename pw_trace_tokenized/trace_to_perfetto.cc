@@ -0,0 +1,124 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Converts a binary tokenized trace file, such as the data read by
+// get_trace.py, to a Perfetto trace. This tool only runs on the host.
+//
+//   trace_to_perfetto [--packed] [--ticks_per_second N] [--threads N]
+//       DATABASE INPUT OUTPUT
+//
+// DATABASE is a binary token database, which can be created with
+// pw_tokenizer's database.py create --type binary.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "pw_tokenizer/detokenize.h"
+#include "pw_trace_tokenized/perfetto_converter.h"
+
+namespace pw::trace {
+namespace {
+
+bool ReadFile(const char* path, std::vector<char>& contents) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  contents.assign(std::istreambuf_iterator<char>(file),
+                  std::istreambuf_iterator<char>());
+  return !file.bad();
+}
+
+int Usage(const char* program) {
+  std::fprintf(stderr,
+               "Usage: %s [--packed] [--ticks_per_second N] [--threads N] "
+               "DATABASE INPUT OUTPUT\n",
+               program);
+  return 1;
+}
+
+int Main(int argc, char* argv[]) {
+  PerfettoConverter::Options options = {
+      .ticks_per_second = 1000,
+      .packed = false,
+      .thread_count = std::max(std::thread::hardware_concurrency(), 1u),
+      .sequence_id = 1,
+  };
+  std::vector<const char*> paths;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (arg == "--packed") {
+      options.packed = true;
+    } else if (arg == "--ticks_per_second" && i + 1 < argc) {
+      options.ticks_per_second = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--threads" && i + 1 < argc) {
+      options.thread_count = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg.substr(0, 2) == "--") {
+      return Usage(argv[0]);
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+  if (paths.size() != 3u || options.ticks_per_second == 0) {
+    return Usage(argv[0]);
+  }
+
+  std::vector<char> database;
+  if (!ReadFile(paths[0], database)) {
+    std::fprintf(stderr, "Failed to read %s\n", paths[0]);
+    return 1;
+  }
+  const tokenizer::TokenDatabase token_database =
+      tokenizer::TokenDatabase::Create(database);
+  if (!token_database.ok()) {
+    std::fprintf(stderr, "%s is not a binary token database\n", paths[0]);
+    return 1;
+  }
+  const tokenizer::Detokenizer detokenizer(token_database);
+
+  std::vector<char> trace;
+  if (!ReadFile(paths[1], trace)) {
+    std::fprintf(stderr, "Failed to read %s\n", paths[1]);
+    return 1;
+  }
+
+  std::ofstream output(paths[2], std::ios::binary);
+  PerfettoConverter converter(detokenizer, options);
+  const PerfettoConverter::Stats stats =
+      converter.Convert(std::as_bytes(std::span(trace)), output);
+  output.close();
+  if (!output) {
+    std::fprintf(stderr, "Failed to write %s\n", paths[2]);
+    return 1;
+  }
+
+  std::printf("Converted %zu events (%zu unknown tokens, %zu malformed)\n",
+              stats.events,
+              stats.unknown_tokens,
+              stats.malformed_entries);
+  return 0;
+}
+
+}  // namespace
+}  // namespace pw::trace
+
+int main(int argc, char* argv[]) { return pw::trace::Main(argc, argv); }
@@ -0,0 +1,87 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+#include "pw_trace_tokenized/trace_transfer_handler.h"
+
+#include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
+#include "pw_trace_tokenized/config.h"
+#include "pw_trace_tokenized/trace_buffer.h"
+#include "pw_trace_tokenized/trace_tokenized.h"
+
+namespace pw {
+namespace trace {
+
+Status TraceTransferHandler::PrepareRead() {
+  if (mode_ == Mode::kStream) {
+    set_reader(stream_reader_);
+    return OkStatus();
+  }
+
+  // The buffer is viewed in place, so it must not change until the transfer
+  // is finalized.
+  was_enabled_ = pw_trace_IsEnabled();
+  PW_TRACE_SET_ENABLED(false);
+  snapshot_reader_ = stream::MemoryReader(DeringAndViewRawBuffer());
+  set_reader(snapshot_reader_);
+  return OkStatus();
+}
+
+void TraceTransferHandler::FinalizeRead(Status status) {
+  if (mode_ == Mode::kStream) {
+    return;
+  }
+
+  if (status.ok()) {
+    ClearBuffer();
+  }
+  snapshot_reader_ = stream::MemoryReader(ConstByteSpan());
+  PW_TRACE_SET_ENABLED(was_enabled_);
+}
+
+StatusWithSize TraceTransferHandler::StreamReader::DoRead(
+    ByteSpan destination) {
+  size_t bytes_written = 0;
+  bool empty = false;
+
+  PW_TRACE_LOCK();
+  ring_buffer::PrefixedEntryRingBuffer& buffer = *GetBuffer();
+  while (true) {
+    if (buffer.EntryCount() == 0u) {
+      empty = true;
+      break;
+    }
+
+    // Only whole entries are sent; stop at the first one which does not fit.
+    size_t entry_size = 0;
+    if (!buffer
+             .PeekFrontWithPreamble(destination.subspan(bytes_written),
+                                    &entry_size)
+             .ok()) {
+      break;
+    }
+    buffer.PopFront().IgnoreError();  // The entry was just peeked.
+    bytes_written += entry_size;
+  }
+  PW_TRACE_UNLOCK();
+
+  if (bytes_written > 0u) {
+    return StatusWithSize(bytes_written);
+  }
+  return empty ? StatusWithSize::OutOfRange()
+               : StatusWithSize::ResourceExhausted();
+}
+
+}  // namespace trace
+}  // namespace pw
@@ -72,6 +72,20 @@ Status DecodeChunk(ConstByteSpan message, Chunk& chunk) {
         PW_TRY(decoder.ReadUint32(&value));
         chunk.status = static_cast<Status::Code>(value);
         break;
+
+      case ProtoChunk::Fields::COMPRESSION:
+        PW_TRY(decoder.ReadUint32(&value));
+        chunk.compression = static_cast<Compression>(value);
+        break;
+
+      case ProtoChunk::Fields::COMPRESSION_WINDOW_BYTES:
+        PW_TRY(decoder.ReadUint32(&value));
+        chunk.compression_window_bytes = value;
+        break;
+
+      case ProtoChunk::Fields::RESUME:
+        PW_TRY(decoder.ReadBool(&chunk.resume));
+        break;
     }
   }
 
@@ -106,6 +120,19 @@ Result<ConstByteSpan> EncodeChunk(const Chunk& chunk, ByteSpan buffer) {
   if (chunk.status.has_value()) {
     encoder.WriteStatus(chunk.status.value().code()).IgnoreError();
   }
+  if (chunk.compression.has_value()) {
+    encoder
+        .WriteCompression(
+            static_cast<transfer::Compression>(chunk.compression.value()))
+        .IgnoreError();
+  }
+  if (chunk.compression_window_bytes.has_value()) {
+    encoder.WriteCompressionWindowBytes(chunk.compression_window_bytes.value())
+        .IgnoreError();
+  }
+  if (chunk.resume) {
+    encoder.WriteResume(true).IgnoreError();
+  }
 
   PW_TRY(encoder.status());
   return ConstByteSpan(encoder);
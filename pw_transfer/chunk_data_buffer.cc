@@ -14,19 +14,16 @@
 
 #include "pw_transfer/internal/chunk_data_buffer.h"
 
-#include <cstring>
-
-#include "pw_assert/assert.h"
+#include "pw_transfer/internal/lzss.h"
 
 namespace pw::transfer::internal {
 
-void ChunkDataBuffer::Write(ConstByteSpan data, bool last_chunk) {
-  PW_DASSERT(data.size() <= buffer_.size());
-
-  std::memcpy(buffer_.data(), data.data(), data.size());
-  size_ = data.size();
+Status ChunkDataBuffer::WriteLzss(ConstByteSpan compressed, bool last_chunk) {
+  const StatusWithSize result = LzssDecompress(compressed, buffer_);
+  data_ = buffer_.first(result.ok() ? result.size() : 0);
 
   last_chunk_ = last_chunk;
+  return result.status();
 }
 
 }  // namespace pw::transfer::internal
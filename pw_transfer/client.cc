@@ -27,7 +27,8 @@ namespace pw::transfer {
 
 Status Client::Read(uint32_t transfer_id,
                     stream::Writer& output,
-                    CompletionFunc&& on_completion) {
+                    CompletionFunc&& on_completion,
+                    uint32_t offset) {
   if (on_completion == nullptr) {
     return Status::InvalidArgument();
   }
@@ -37,12 +38,14 @@ Status Client::Read(uint32_t transfer_id,
         client_.Read([this](ConstByteSpan chunk) { OnChunk(chunk, kRead); });
   }
 
-  return StartNewTransfer(transfer_id, output, std::move(on_completion), kRead);
+  return StartNewTransfer(
+      transfer_id, output, std::move(on_completion), kRead, offset);
 }
 
 Status Client::Write(uint32_t transfer_id,
                      stream::Reader& input,
-                     CompletionFunc&& on_completion) {
+                     CompletionFunc&& on_completion,
+                     uint32_t offset) {
   if (on_completion == nullptr) {
     return Status::InvalidArgument();
   }
@@ -52,13 +55,15 @@ Status Client::Write(uint32_t transfer_id,
         client_.Write([this](ConstByteSpan chunk) { OnChunk(chunk, kWrite); });
   }
 
-  return StartNewTransfer(transfer_id, input, std::move(on_completion), kWrite);
+  return StartNewTransfer(
+      transfer_id, input, std::move(on_completion), kWrite, offset);
 }
 
 Status Client::StartNewTransfer(uint32_t transfer_id,
                                 stream::Stream& stream,
                                 CompletionFunc&& on_completion,
-                                Type type) {
+                                Type type,
+                                uint32_t offset) {
   std::lock_guard lock(transfer_context_mutex_);
   ClientContext* context = nullptr;
 
@@ -79,21 +84,25 @@ Status Client::StartNewTransfer(uint32_t transfer_id,
   }
 
   if (type == kWrite) {
-    PW_LOG_DEBUG("Starting new write transfer %u",
-                 static_cast<unsigned>(transfer_id));
+    PW_LOG_DEBUG("Starting new write transfer %u at offset %u",
+                 static_cast<unsigned>(transfer_id),
+                 static_cast<unsigned>(offset));
     context->StartWrite(*this,
                         transfer_id,
                         static_cast<stream::Reader&>(stream),
                         write_stream_,
-                        std::move(on_completion));
+                        std::move(on_completion),
+                        offset);
   } else {
-    PW_LOG_DEBUG("Starting new read transfer %u",
-                 static_cast<unsigned>(transfer_id));
+    PW_LOG_DEBUG("Starting new read transfer %u at offset %u",
+                 static_cast<unsigned>(transfer_id),
+                 static_cast<unsigned>(offset));
     context->StartRead(*this,
                        transfer_id,
                        static_cast<stream::Writer&>(stream),
                        read_stream_,
-                       std::move(on_completion));
+                       std::move(on_completion),
+                       offset);
   }
 
   return context->InitiateTransfer(max_parameters_);
@@ -22,7 +22,8 @@ void ClientContext::StartRead(Client& client,
                               uint32_t transfer_id,
                               stream::Writer& writer,
                               rpc::RawClientReaderWriter& stream,
-                              Function<void(Status)>&& on_completion) {
+                              Function<void(Status)>&& on_completion,
+                              uint32_t offset) {
   PW_DCHECK(!active());
   PW_DCHECK(on_completion != nullptr);
 
@@ -30,14 +31,15 @@ void ClientContext::StartRead(Client& client,
   on_completion_ = std::move(on_completion);
   writer_.set_writer(stream);
 
-  InitializeForReceive(transfer_id, writer_, writer);
+  InitializeForReceive(transfer_id, writer_, writer, offset);
 }
 
 void ClientContext::StartWrite(Client& client,
                                uint32_t transfer_id,
                                stream::Reader& reader,
                                rpc::RawClientReaderWriter& stream,
-                               Function<void(Status)>&& on_completion) {
+                               Function<void(Status)>&& on_completion,
+                              uint32_t offset) {
   PW_DCHECK(!active());
   PW_DCHECK(on_completion != nullptr);
 
@@ -45,7 +47,7 @@ void ClientContext::StartWrite(Client& client,
   on_completion_ = std::move(on_completion);
   writer_.set_writer(stream);
 
-  InitializeForTransmit(transfer_id, writer_, reader);
+  InitializeForTransmit(transfer_id, writer_, reader, offset);
 }
 
 }  // namespace pw::transfer::internal
@@ -20,6 +20,7 @@
 #include "pw_assert/check.h"
 #include "pw_bytes/array.h"
 #include "pw_rpc/raw/client_testing.h"
+#include "pw_transfer/internal/lzss.h"
 #include "pw_transfer_private/chunk_testing.h"
 
 namespace pw::transfer::test {
@@ -83,6 +84,42 @@ TEST_F(ReadTransfer, SingleChunk) {
             0);
 }
 
+TEST_F(ReadTransfer, Resume_SendsOffsetInInitialChunk) {
+  stream::MemoryWriterBuffer<64> writer;
+  Status transfer_status = Status::Unknown();
+
+  client_.Read(
+      3,
+      writer,
+      [&transfer_status](Status status) { transfer_status = status; },
+      16);
+
+  rpc::PayloadsView payloads =
+      context_.output().payloads<Transfer::Read>(context_.channel().id());
+  ASSERT_EQ(payloads.size(), 1u);
+
+  Chunk c0 = DecodeChunk(payloads[0]);
+  EXPECT_EQ(c0.transfer_id, 3u);
+  EXPECT_EQ(c0.offset, 16u);
+  EXPECT_TRUE(c0.resume);
+  EXPECT_EQ(c0.pending_bytes.value(), 64u);
+
+  context_.server().SendServerStream<Transfer::Read>(
+      EncodeChunk({.transfer_id = 3u,
+                   .offset = 16,
+                   .data = std::span(kData32).subspan(16),
+                   .remaining_bytes = 0}));
+  ASSERT_EQ(payloads.size(), 2u);
+
+  Chunk c1 = DecodeChunk(payloads[1]);
+  ASSERT_TRUE(c1.status.has_value());
+  EXPECT_EQ(c1.status.value(), OkStatus());
+
+  EXPECT_EQ(transfer_status, OkStatus());
+  ASSERT_EQ(writer.bytes_written(), 16u);
+  EXPECT_EQ(std::memcmp(writer.data(), kData32.data() + 16, 16), 0);
+}
+
 TEST_F(ReadTransfer, MultiChunk) {
   stream::MemoryWriterBuffer<64> writer;
   Status transfer_status = Status::Unknown();
@@ -124,6 +161,45 @@ TEST_F(ReadTransfer, MultiChunk) {
             0);
 }
 
+TEST_F(ReadTransfer, CompressedChunk) {
+  stream::MemoryWriterBuffer<64> writer;
+  Status transfer_status = Status::Unknown();
+
+  client_.Read(3, writer, [&transfer_status](Status status) {
+    transfer_status = status;
+  });
+
+  // The parameters chunk accepts compressed data up to the buffer size.
+  rpc::PayloadsView payloads =
+      context_.output().payloads<Transfer::Read>(context_.channel().id());
+  ASSERT_EQ(payloads.size(), 1u);
+  Chunk c0 = DecodeChunk(payloads[0]);
+  EXPECT_EQ(c0.compression, internal::Compression::kLzss);
+  EXPECT_EQ(c0.compression_window_bytes, 64u);
+
+  constexpr auto kRepeated = bytes::Initialized<48>([](size_t) { return 7; });
+  std::array<std::byte, 16> compressed;
+  const internal::LzssCompressResult result =
+      internal::LzssCompress(kRepeated, compressed);
+  ASSERT_EQ(result.bytes_read, kRepeated.size());
+
+  context_.server().SendServerStream<Transfer::Read>(
+      EncodeChunk({.transfer_id = 3u,
+                   .offset = 0,
+                   .data = std::span(compressed).first(result.bytes_written),
+                   .remaining_bytes = 0,
+                   .compression = internal::Compression::kLzss}));
+  ASSERT_EQ(payloads.size(), 2u);
+
+  Chunk c1 = DecodeChunk(payloads[1]);
+  ASSERT_TRUE(c1.status.has_value());
+  EXPECT_EQ(c1.status.value(), OkStatus());
+
+  EXPECT_EQ(transfer_status, OkStatus());
+  ASSERT_EQ(writer.bytes_written(), kRepeated.size());
+  EXPECT_EQ(std::memcmp(writer.data(), kRepeated.data(), kRepeated.size()), 0);
+}
+
 class ReadTransferMaxBytes32 : public ReadTransfer {
  protected:
   ReadTransferMaxBytes32() : ReadTransfer(/*max_bytes_to_receive=*/32) {}
@@ -530,6 +606,48 @@ TEST_F(WriteTransfer, SingleChunk) {
   EXPECT_EQ(transfer_status, OkStatus());
 }
 
+TEST_F(WriteTransfer, Resume_SendsDataFromOffset) {
+  stream::MemoryReader reader(kData32);
+  ASSERT_EQ(reader.Seek(16), OkStatus());
+  Status transfer_status = Status::Unknown();
+
+  client_.Write(
+      3,
+      reader,
+      [&transfer_status](Status status) { transfer_status = status; },
+      16);
+
+  rpc::PayloadsView payloads =
+      context_.output().payloads<Transfer::Write>(context_.channel().id());
+  ASSERT_EQ(payloads.size(), 1u);
+
+  Chunk c0 = DecodeChunk(payloads[0]);
+  EXPECT_EQ(c0.transfer_id, 3u);
+  EXPECT_EQ(c0.offset, 16u);
+  EXPECT_TRUE(c0.resume);
+
+  context_.server().SendServerStream<Transfer::Write>(
+      EncodeChunk({.transfer_id = 3,
+                   .pending_bytes = 64,
+                   .max_chunk_size_bytes = 32,
+                   .offset = 16}));
+
+  ASSERT_EQ(payloads.size(), 3u);
+
+  Chunk c1 = DecodeChunk(payloads[1]);
+  EXPECT_EQ(c1.offset, 16u);
+  ASSERT_EQ(c1.data.size(), 16u);
+  EXPECT_EQ(std::memcmp(c1.data.data(), kData32.data() + 16, 16), 0);
+
+  Chunk c2 = DecodeChunk(payloads[2]);
+  ASSERT_TRUE(c2.remaining_bytes.has_value());
+  EXPECT_EQ(c2.remaining_bytes.value(), 0u);
+
+  context_.server().SendServerStream<Transfer::Write>(
+      EncodeChunk({.transfer_id = 3, .status = OkStatus()}));
+  EXPECT_EQ(transfer_status, OkStatus());
+}
+
 TEST_F(WriteTransfer, MultiChunk) {
   stream::MemoryReader reader(kData32);
   Status transfer_status = Status::Unknown();
@@ -16,9 +16,14 @@
 
 #include "pw_transfer/internal/context.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
 #include "pw_status/try.h"
+#include "pw_transfer/internal/lzss.h"
 #include "pw_transfer/transfer.pwpb.h"
 #include "pw_varint/varint.h"
 
@@ -27,15 +32,21 @@ namespace pw::transfer::internal {
 Status Context::InitiateTransfer(const TransferParameters& max_parameters) {
   PW_DCHECK(active());
 
+  // A transfer that starts at a nonzero offset resumes an interrupted transfer.
+  const bool resume = offset_ != 0u;
+
   if (type_ == kReceive) {
     // A receiver begins a new transfer with a parameters chunk telling the
     // transmitter what to send.
-    return SendTransferParameters(max_parameters);
+    return SendTransferParameters(max_parameters, resume);
   }
 
-  // A transmitter begins a transfer by just sending its ID.
+  // A transmitter begins a transfer by just sending its ID, and its offset if
+  // resuming.
   internal::Chunk chunk = {};
   chunk.transfer_id = transfer_id_;
+  chunk.offset = static_cast<uint32_t>(offset_);
+  chunk.resume = resume;
 
   Result<ConstByteSpan> result =
       EncodeChunk(chunk, rpc_writer_->PayloadBuffer());
@@ -59,6 +70,14 @@ void Context::UpdateParameters(const TransferParameters& max_parameters,
     max_chunk_size_bytes_ = std::min(chunk.max_chunk_size_bytes.value(),
                                      max_parameters.max_chunk_size_bytes());
   }
+
+  // Compression is renegotiated by every parameters chunk.
+  if (chunk.compression == Compression::kLzss &&
+      chunk.compression_window_bytes.has_value()) {
+    compression_window_bytes_ = chunk.compression_window_bytes.value();
+  } else {
+    compression_window_bytes_ = 0;
+  }
 }
 
 bool Context::ReadTransmitChunk(const TransferParameters& max_parameters,
@@ -118,6 +137,9 @@ bool Context::ReadTransmitChunk(const TransferParameters& max_parameters,
       FinishAndSendStatus(seek_status);
       return false;
     }
+
+    // Data read ahead for compression no longer follows the offset.
+    compression_buffer_size_ = 0;
   }
 
   UpdateParameters(max_parameters, chunk);
@@ -125,16 +147,26 @@ bool Context::ReadTransmitChunk(const TransferParameters& max_parameters,
 }
 
 void Context::ProcessTransmitChunk() {
-  Status status;
+  // Continue until all requested bytes are sent.
+  SendTransmitChunks(std::numeric_limits<size_t>::max());
+}
 
-  while ((status = SendNextDataChunk()).ok()) {
-    // Continue until all requested bytes are sent.
-  }
+bool Context::SendTransmitChunks(size_t max_chunks) {
+  for (size_t i = 0; i < max_chunks; ++i) {
+    const Status status = SendNextDataChunk();
+    if (status.ok()) {
+      continue;
+    }
 
-  // If all bytes are successfully sent, SendNextChunk will return OUT_OF_RANGE.
-  if (!status.IsOutOfRange()) {
-    FinishAndSendStatus(status);
+    // If all bytes are successfully sent, SendNextChunk will return
+    // OUT_OF_RANGE.
+    if (!status.IsOutOfRange()) {
+      FinishAndSendStatus(status);
+    }
+    return false;
   }
+
+  return has_pending_transmit_data();
 }
 
 bool Context::ReadReceiveChunk(ChunkDataBuffer& buffer,
@@ -218,6 +250,10 @@ void Context::ProcessReceiveChunk(ChunkDataBuffer& buffer,
     }
   }
 
+  // Update the transfer state.
+  offset_ += buffer.size();
+  pending_bytes_ -= buffer.size();
+
   // When the client sets remaining_bytes to 0, it indicates completion of the
   // transfer. Acknowledge the completion through a status chunk and clean up.
   if (buffer.last_chunk()) {
@@ -225,15 +261,12 @@ void Context::ProcessReceiveChunk(ChunkDataBuffer& buffer,
     return;
   }
 
-  // Update the transfer state.
-  offset_ += buffer.size();
-  pending_bytes_ -= buffer.size();
-
   // TODO(frolv): Release the buffer.
 
   if (pending_bytes_ == 0u) {
     // All pending data has been received. Send a new parameters chunk to start
-    // the next batch.
+    // the next batch, with a larger window since nothing was lost.
+    GrowWindow(max_parameters);
     SendTransferParameters(max_parameters);
   }
 }
@@ -253,24 +286,44 @@ Status Context::SendNextDataChunk() {
 
   // Reserve space for the data proto field overhead and use the remainder of
   // the buffer for the chunk data.
+  const bool compress = compressing();
   size_t reserved_size = encoder.size() + 1 /* data key */ + 5 /* data size */;
+  if (compress) {
+    reserved_size += 2;  // compression field
+  }
 
   ByteSpan data_buffer = buffer.subspan(reserved_size);
-  size_t max_bytes_to_send = std::min(pending_bytes_, max_chunk_size_bytes_);
+
+  // pending_bytes counts uncompressed data, which ReadCompressedData() limits
+  // separately from the size of the compressed data. The payload buffer is
+  // limited to the channel's MTU, so the chunk fits in one packet.
+  size_t max_bytes_to_send =
+      std::min(max_chunk_size_bytes_, chunk_size_limit_bytes_);
+  if (!compress) {
+    max_bytes_to_send = std::min(max_bytes_to_send, pending_bytes_);
+  }
 
   if (max_bytes_to_send < data_buffer.size()) {
     data_buffer = data_buffer.first(max_bytes_to_send);
   }
 
-  Result<ByteSpan> data = reader().Read(data_buffer);
+  size_t bytes_read = 0;
+  Result<ByteSpan> data = compress ? ReadCompressedData(data_buffer, bytes_read)
+                                  : reader().Read(data_buffer);
   if (data.status().IsOutOfRange()) {
     // No more data to read.
     encoder.WriteRemainingBytes(0).IgnoreError();
     pending_bytes_ = 0;
   } else if (data.ok()) {
+    if (!compress) {
+      bytes_read = data.value().size();
+    }
     encoder.WriteData(data.value()).IgnoreError();
-    offset_ += data.value().size();
-    pending_bytes_ -= data.value().size();
+    if (data.value().size() < bytes_read) {
+      encoder.WriteCompression(transfer::Compression::LZSS).IgnoreError();
+    }
+    offset_ += bytes_read;
+    pending_bytes_ -= bytes_read;
   } else {
     PW_LOG_ERROR("Transfer %u Read() failed with status %u",
                  static_cast<unsigned>(transfer_id_),
@@ -287,6 +340,14 @@ Status Context::SendNextDataChunk() {
   }
 
   if (const Status status = rpc_writer_->Write(encoder); !status.ok()) {
+    // Transports report chunks too large to send with RESOURCE_EXHAUSTED.
+    // Compressed data has already left the compression buffer, so only
+    // uncompressed chunks are resent.
+    if (status.IsResourceExhausted() && data.ok() && !compress &&
+        ReduceChunkSize(bytes_read)) {
+      return OkStatus();
+    }
+
     PW_LOG_ERROR("Transfer %u failed to send transmit chunk, status %u",
                  static_cast<unsigned>(transfer_id_),
                  status.code());
@@ -296,10 +357,87 @@ Status Context::SendNextDataChunk() {
   return data.status();
 }
 
+bool Context::ReduceChunkSize(size_t chunk_size) {
+  if (chunk_size <= 1u) {
+    return false;
+  }
+
+  offset_ -= chunk_size;
+  pending_bytes_ += chunk_size;
+  if (!reader().Seek(offset_).ok()) {
+    return false;
+  }
+
+  chunk_size_limit_bytes_ = chunk_size / 2;
+  chunk_size_reductions_ += 1;
+
+  PW_LOG_DEBUG("Transfer %u failed to send %u B chunk; reduced to %u B",
+               static_cast<unsigned>(transfer_id_),
+               static_cast<unsigned>(chunk_size),
+               static_cast<unsigned>(chunk_size_limit_bytes_));
+  return true;
+}
+
+Result<ByteSpan> Context::ReadCompressedData(ByteSpan destination,
+                                             size_t& bytes_read) {
+  const ByteSpan buffer(compression_buffer_);
+  const size_t max_read = std::min(pending_bytes_, buffer.size());
+  const bool accepts_compression = compression_window_bytes_ > 0u;
+
+  // Top up the buffer, unless the receiver stopped accepting compressed data
+  // and only the data already read remains to be sent.
+  if (accepts_compression && compression_buffer_size_ < max_read) {
+    Result<ByteSpan> result = reader().Read(buffer.subspan(
+        compression_buffer_size_, max_read - compression_buffer_size_));
+    if (result.ok()) {
+      compression_buffer_size_ += result.value().size();
+    } else if (!result.status().IsOutOfRange() ||
+               compression_buffer_size_ == 0u) {
+      return result.status();
+    }
+  }
+
+  bytes_read = 0;
+  if (compression_buffer_size_ == 0u) {
+    return destination.first(0);
+  }
+
+  ConstByteSpan input = buffer.first(compression_buffer_size_);
+  if (accepts_compression) {
+    input = input.first(std::min(
+        {input.size(), max_read, compression_window_bytes_}));
+  } else {
+    input = input.first(std::min(input.size(), pending_bytes_));
+  }
+
+  LzssCompressResult result = {0, 0};
+  if (accepts_compression) {
+    result = LzssCompress(input, destination);
+  }
+
+  // Send data that does not compress as is.
+  if (result.bytes_written >= result.bytes_read) {
+    const size_t size = std::min(input.size(), destination.size());
+    std::memcpy(destination.data(), input.data(), size);
+    result = {size, size};
+  }
+
+  bytes_read = result.bytes_read;
+  compression_buffer_size_ -= bytes_read;
+  std::memmove(buffer.data(),
+               buffer.data() + bytes_read,
+               compression_buffer_size_);
+  return destination.first(result.bytes_written);
+}
+
 bool Context::HandleDataChunk(ChunkDataBuffer& buffer,
                               const TransferParameters& max_parameters,
                               const Chunk& chunk) {
-  if (chunk.data.size() > pending_bytes_) {
+  const Compression compression =
+      chunk.compression.value_or(Compression::kNone);
+
+  // The size of compressed data is checked once it is decompressed.
+  if (compression == Compression::kNone && chunk.data.size() > pending_bytes_) {
     // End the transfer, as this indcates a bug with the client implementation
     // where it doesn't respect pending_bytes. Trying to recover from here
     // could potentially result in an infinite transfer loop.
@@ -316,6 +454,7 @@ bool Context::HandleDataChunk(ChunkDataBuffer& buffer,
         static_cast<unsigned>(transfer_id_),
         static_cast<unsigned>(offset_),
         static_cast<unsigned>(chunk.offset));
+    ShrinkWindow(max_parameters);
     SendTransferParameters(max_parameters);
     state_ = kRecovery;
 
@@ -324,14 +463,45 @@ bool Context::HandleDataChunk(ChunkDataBuffer& buffer,
     return false;
   }
 
-  // Write the chunk data to the buffer to be processed later. If the chunk has
-  // no data, this will clear the buffer.
-  buffer.Write(chunk.data, chunk.IsFinalTransmitChunk());
+  // Stage the chunk data to be written when the chunk is processed. It is
+  // written straight from the received packet rather than copied into the
+  // buffer first. If the chunk has no data, this clears the buffer.
+  if (compression == Compression::kNone) {
+    buffer.Reference(chunk.data, chunk.IsFinalTransmitChunk());
+    return true;
+  }
+
+  if (compression != Compression::kLzss) {
+    PW_LOG_ERROR("Transfer %u received data with unknown compression %u",
+                 static_cast<unsigned>(transfer_id_),
+                 static_cast<unsigned>(compression));
+    FinishAndSendStatus(Status::InvalidArgument());
+    return false;
+  }
+
+  if (Status status =
+          buffer.WriteLzss(chunk.data, chunk.IsFinalTransmitChunk());
+      !status.ok()) {
+    PW_LOG_ERROR("Transfer %u failed to decompress chunk, status %u",
+                 static_cast<unsigned>(transfer_id_),
+                 status.code());
+    // Data that does not fit in the buffer exceeds the compression window.
+    FinishAndSendStatus(status.IsResourceExhausted() ? Status::Internal()
+                                                     : Status::DataLoss());
+    return false;
+  }
+
+  if (buffer.size() > pending_bytes_) {
+    PW_LOG_ERROR(
+        "Received more data than what was requested; terminating transfer.");
+    FinishAndSendStatus(Status::Internal());
+    return false;
+  }
   return true;
 }
 
 Status Context::SendTransferParameters(
-    const TransferParameters& max_parameters) {
+    const TransferParameters& max_parameters, bool resume) {
   const size_t write_limit = writer().ConservativeWriteLimit();
   if (write_limit == 0) {
     PW_LOG_WARN(
@@ -342,18 +512,24 @@ Status Context::SendTransferParameters(
     return Status::ResourceExhausted();
   }
 
-  set_pending_bytes(std::min(max_parameters.pending_bytes(),
-                             static_cast<uint32_t>(write_limit)));
+  set_pending_bytes(std::min({max_parameters.pending_bytes(),
+                              static_cast<uint32_t>(window_size_),
+                              static_cast<uint32_t>(write_limit)}));
 
   const uint32_t max_chunk_size_bytes = MaxWriteChunkSize(
       max_parameters.max_chunk_size_bytes(), rpc_writer_->channel_id());
 
-  const internal::Chunk parameters = {
-      .transfer_id = transfer_id_,
-      .pending_bytes = pending_bytes_,
-      .max_chunk_size_bytes = max_chunk_size_bytes,
-      .offset = static_cast<uint32_t>(offset_),
-  };
+  internal::Chunk parameters = {};
+  parameters.transfer_id = transfer_id_;
+  parameters.pending_bytes = pending_bytes_;
+  parameters.max_chunk_size_bytes = max_chunk_size_bytes;
+  parameters.offset = static_cast<uint32_t>(offset_);
+  parameters.resume = resume;
+
+  // Received data is decompressed into the chunk data buffer, which is as
+  // large as the maximum chunk size.
+  parameters.compression = Compression::kLzss;
+  parameters.compression_window_bytes = max_parameters.max_chunk_size_bytes();
 
   PW_LOG_DEBUG(
       "Transfer %u sending transfer parameters: "
@@ -390,10 +566,31 @@ Status Context::SendTransferParameters(
   return OkStatus();
 }
 
+void Context::ShrinkWindow(const TransferParameters& max_parameters) {
+  const size_t min_window = std::min(max_parameters.max_chunk_size_bytes(),
+                                     max_parameters.pending_bytes());
+  const size_t window =
+      std::min<size_t>(window_size_, max_parameters.pending_bytes());
+  window_size_ = std::max(window / 2, min_window);
+
+  PW_LOG_DEBUG("Transfer %u window reduced to %u B after data loss",
+               static_cast<unsigned>(transfer_id_),
+               static_cast<unsigned>(window_size_));
+}
+
+void Context::GrowWindow(const TransferParameters& max_parameters) {
+  const size_t window =
+      std::min<size_t>(window_size_, max_parameters.pending_bytes());
+  window_size_ = std::min<size_t>(
+      window + max_parameters.max_chunk_size_bytes(),
+      max_parameters.pending_bytes());
+}
+
 void Context::Initialize(Type type,
                          uint32_t transfer_id,
                          RawWriter& rpc_writer,
-                         stream::Stream& stream) {
+                         stream::Stream& stream,
+                         uint32_t offset) {
   PW_DCHECK(!active());
 
   transfer_id_ = transfer_id;
@@ -403,12 +600,33 @@ void Context::Initialize(Type type,
   rpc_writer_ = &rpc_writer;
   stream_ = &stream;
 
-  offset_ = 0;
+  offset_ = offset;
   pending_bytes_ = 0;
   max_chunk_size_bytes_ = std::numeric_limits<uint32_t>::max();
+  chunk_size_limit_bytes_ = std::numeric_limits<uint32_t>::max();
+  chunk_size_reductions_ = 0;
+  window_size_ = std::numeric_limits<uint32_t>::max();
 
   status_ = Status::Unknown();
   last_received_offset_ = 0;
+
+  compression_window_bytes_ = 0;
+  compression_buffer_size_ = 0;
+
+  start_offset_ = offset;
+  start_time_ = chrono::SystemClock::now();
+}
+
+uint32_t Context::GoodputBytesPerSecond() const {
+  const uint64_t bytes = offset_ > start_offset_ ? offset_ - start_offset_ : 0;
+  const uint64_t elapsed_us = std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          chrono::SystemClock::now() - start_time_)
+          .count(),
+      1);
+  return static_cast<uint32_t>(
+      std::min<uint64_t>(bytes * 1'000'000 / elapsed_us,
+                         std::numeric_limits<uint32_t>::max()));
 }
 
 void Context::SendStatusChunk(Status status) {
@@ -474,6 +692,12 @@ uint32_t Context::MaxWriteChunkSize(uint32_t max_chunk_size_bytes,
   // pw_transfer depend on RPC internals.
   max_size -= 5;
 
+  // Packets from the transmitter must also fit within the channel's MTU.
+  const size_t max_write_size = rpc_writer_->MaxWriteSizeBytes();
+  if (max_size > 0 && max_write_size < static_cast<size_t>(max_size)) {
+    max_size = static_cast<ssize_t>(max_write_size);
+  }
+
   // Subtract the transfer service overhead for a client write chunk
   // (pw_transfer/transfer.proto).
   //
@@ -0,0 +1,146 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/lzss.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace pw::transfer::internal {
+namespace {
+
+constexpr size_t kItemsPerGroup = 8;
+constexpr size_t kMatchSize = 2;
+
+static_assert(kLzssMaxMatch - kLzssMinMatch <= 0xfu);
+static_assert(kLzssMaxDistance - 1 <= 0xfffu);
+
+struct Match {
+  size_t distance;
+  size_t length;
+};
+
+// Finds the longest match for the data at position in the preceding window.
+// Prefers the nearest of equally long matches.
+Match FindLongestMatch(ConstByteSpan input, size_t position) {
+  const size_t max_length =
+      std::min(kLzssMaxMatch, input.size() - position);
+  const size_t max_distance = std::min(kLzssMaxDistance, position);
+
+  Match best = {0, 0};
+  for (size_t distance = 1; distance <= max_distance; ++distance) {
+    const size_t start = position - distance;
+    size_t length = 0;
+    while (length < max_length &&
+           input[start + length] == input[position + length]) {
+      ++length;
+    }
+
+    if (length > best.length) {
+      best = {distance, length};
+      if (length == max_length) {
+        break;
+      }
+    }
+  }
+  return best;
+}
+
+}  // namespace
+
+LzssCompressResult LzssCompress(ConstByteSpan input, ByteSpan output) {
+  size_t in = 0;
+  size_t out = 0;
+  size_t flags_position = 0;
+  size_t items = kItemsPerGroup;
+
+  while (in < input.size()) {
+    if (items == kItemsPerGroup) {
+      // A new group needs room for its flags and at least one literal.
+      if (output.size() - out < 2) {
+        break;
+      }
+      flags_position = out++;
+      output[flags_position] = std::byte{0};
+      items = 0;
+    }
+
+    const Match match = FindLongestMatch(input, in);
+    if (match.length >= kLzssMinMatch && output.size() - out >= kMatchSize) {
+      const size_t distance = match.distance - 1;
+      output[out++] = static_cast<std::byte>(distance & 0xffu);
+      output[out++] = static_cast<std::byte>(
+          ((distance >> 8) << 4) | (match.length - kLzssMinMatch));
+      in += match.length;
+    } else if (out < output.size()) {
+      output[flags_position] |= static_cast<std::byte>(1u << items);
+      output[out++] = input[in++];
+    } else {
+      break;
+    }
+
+    items += 1;
+  }
+
+  // Drop the flags of a group that ended up without any items.
+  if (items == 0) {
+    out -= 1;
+  }
+
+  return {in, out};
+}
+
+StatusWithSize LzssDecompress(ConstByteSpan input, ByteSpan output) {
+  size_t in = 0;
+  size_t out = 0;
+
+  while (in < input.size()) {
+    const uint8_t flags = static_cast<uint8_t>(input[in++]);
+
+    for (size_t item = 0; item < kItemsPerGroup && in < input.size();
+         ++item) {
+      if ((flags & (1u << item)) != 0u) {
+        if (out == output.size()) {
+          return StatusWithSize::ResourceExhausted(out);
+        }
+        output[out++] = input[in++];
+        continue;
+      }
+
+      if (input.size() - in < kMatchSize) {
+        return StatusWithSize::DataLoss(out);
+      }
+      const size_t low = static_cast<uint8_t>(input[in++]);
+      const size_t high = static_cast<uint8_t>(input[in++]);
+      const size_t distance = (low | ((high >> 4) << 8)) + 1;
+      const size_t length = (high & 0xfu) + kLzssMinMatch;
+
+      if (distance > out) {
+        return StatusWithSize::DataLoss(out);
+      }
+      if (length > output.size() - out) {
+        return StatusWithSize::ResourceExhausted(out);
+      }
+
+      // Copy byte by byte, since a match may overlap the data it produces.
+      for (size_t i = 0; i < length; ++i, ++out) {
+        output[out] = output[out - distance];
+      }
+    }
+  }
+
+  return StatusWithSize(out);
+}
+
+}  // namespace pw::transfer::internal
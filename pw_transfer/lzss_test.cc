@@ -0,0 +1,117 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/lzss.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::transfer::internal {
+namespace {
+
+constexpr auto kText = bytes::String(
+    "It was the best of times, it was the worst of times, it was the age of "
+    "wisdom, it was the age of foolishness, it was the epoch of belief, it "
+    "was the epoch of incredulity");
+
+class LzssTest : public ::testing::Test {
+ protected:
+  // Compresses and decompresses the input, expecting the original data back.
+  size_t RoundTrip(ConstByteSpan input) {
+    const LzssCompressResult compressed = LzssCompress(input, compressed_);
+    EXPECT_EQ(input.size(), compressed.bytes_read);
+
+    const StatusWithSize decompressed = LzssDecompress(
+        std::span(compressed_).first(compressed.bytes_written), output_);
+    EXPECT_EQ(OkStatus(), decompressed.status());
+    EXPECT_EQ(input.size(), decompressed.size());
+    EXPECT_EQ(0, std::memcmp(input.data(), output_.data(), input.size()));
+    return compressed.bytes_written;
+  }
+
+  std::array<std::byte, 512> compressed_ = {};
+  std::array<std::byte, 512> output_ = {};
+};
+
+TEST_F(LzssTest, Compress_Empty) {
+  const LzssCompressResult result = LzssCompress(ConstByteSpan(), compressed_);
+  EXPECT_EQ(0u, result.bytes_read);
+  EXPECT_EQ(0u, result.bytes_written);
+}
+
+TEST_F(LzssTest, RoundTrip_Text_Compresses) {
+  EXPECT_LT(RoundTrip(kText), kText.size() * 3 / 4);
+}
+
+TEST_F(LzssTest, RoundTrip_Repeated_Compresses) {
+  std::array<std::byte, 400> input;
+  input.fill(std::byte{0x5a});
+  EXPECT_LT(RoundTrip(input), input.size() / 4);
+}
+
+TEST_F(LzssTest, RoundTrip_Incompressible_GrowsByFlagsOnly) {
+  std::array<std::byte, 256> input;
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<std::byte>(i);
+  }
+  EXPECT_EQ(input.size() + input.size() / 8, RoundTrip(input));
+}
+
+TEST_F(LzssTest, Compress_OutputTooSmall_CompressesPrefix) {
+  std::array<std::byte, 16> small_output;
+  const LzssCompressResult result = LzssCompress(kText, small_output);
+  ASSERT_GT(result.bytes_read, 0u);
+  ASSERT_LT(result.bytes_read, kText.size());
+  ASSERT_LE(result.bytes_written, small_output.size());
+
+  const StatusWithSize decompressed = LzssDecompress(
+      std::span(small_output).first(result.bytes_written), output_);
+  ASSERT_EQ(OkStatus(), decompressed.status());
+  ASSERT_EQ(result.bytes_read, decompressed.size());
+  EXPECT_EQ(0, std::memcmp(kText.data(), output_.data(), result.bytes_read));
+}
+
+TEST_F(LzssTest, Decompress_OverlappingMatch) {
+  // A literal 'a' followed by a match of length 5 at distance 1.
+  constexpr auto kCompressed = bytes::Array<0b01, 'a', 0x00, 5 - 3>();
+  const StatusWithSize result = LzssDecompress(kCompressed, output_);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(6u, result.size());
+  EXPECT_EQ(0, std::memcmp("aaaaaa", output_.data(), result.size()));
+}
+
+TEST_F(LzssTest, Decompress_OutputTooSmall_ResourceExhausted) {
+  const LzssCompressResult compressed = LzssCompress(kText, compressed_);
+  std::array<std::byte, 32> small_output;
+  const ConstByteSpan input =
+      std::span(compressed_).first(compressed.bytes_written);
+  EXPECT_EQ(Status::ResourceExhausted(),
+            LzssDecompress(input, small_output).status());
+}
+
+TEST_F(LzssTest, Decompress_MatchBeforeStart_DataLoss) {
+  constexpr auto kCompressed = bytes::Array<0b01, 'a', 0x01, 0x00>();
+  EXPECT_EQ(Status::DataLoss(), LzssDecompress(kCompressed, output_).status());
+}
+
+TEST_F(LzssTest, Decompress_TruncatedMatch_DataLoss) {
+  constexpr auto kCompressed = bytes::Array<0b01, 'a', 0x00>();
+  EXPECT_EQ(Status::DataLoss(), LzssDecompress(kCompressed, output_).status());
+}
+
+}  // namespace
+}  // namespace pw::transfer::internal
@@ -69,17 +69,28 @@ class Client {
   // the server is written to the provided writer. Returns OK if the transfer is
   // successfully started. When the transfer finishes (successfully or not), the
   // completion callback is invoked with the overall status.
+  //
+  // To resume an interrupted transfer, pass the number of bytes already
+  // received as the offset. The server continues from that offset, and the
+  // writer must already be positioned after the received data. Servers whose
+  // handlers do not support seeking fail the transfer with UNIMPLEMENTED.
   Status Read(uint32_t transfer_id,
               stream::Writer& output,
-              CompletionFunc&& on_completion);
+              CompletionFunc&& on_completion,
+              uint32_t offset = 0);
 
   // Begins a new write transfer for the given transfer ID. Data from the
   // provided writer is sent to the server. When the transfer finishes
   // (successfully or not), the completion callback is invoked with the overall
   // status.
+  //
+  // To resume an interrupted transfer, pass the number of bytes the server
+  // already received as the offset. The reader must already be positioned at
+  // that offset.
   Status Write(uint32_t transfer_id,
                stream::Reader& input,
-               CompletionFunc&& on_completion);
+               CompletionFunc&& on_completion,
+               uint32_t offset = 0);
 
  private:
   using Transfer = pw_rpc::raw::Transfer;
@@ -90,7 +101,8 @@ class Client {
   Status StartNewTransfer(uint32_t transfer_id,
                           stream::Stream& stream,
                           CompletionFunc&& on_completion,
-                          Type type);
+                          Type type,
+                          uint32_t offset);
   ClientContext* GetActiveTransfer(uint32_t transfer_id);
 
   // Function called when a chunk is received, from the context of the RPC
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstdint>
+
 #include "pw_assert/assert.h"
 #include "pw_containers/intrusive_list.h"
 #include "pw_status/status.h"
@@ -34,6 +36,12 @@ class Handler : public IntrusiveList<Handler>::Item {
 
   constexpr uint32_t id() const { return transfer_id_; }
 
+  // When the transfer service sends read transfer data from a work queue,
+  // concurrent read transfers share the outgoing bandwidth in proportion to
+  // priority() + 1. Handlers start with the lowest priority, 0.
+  constexpr uint8_t priority() const { return priority_; }
+  constexpr void set_priority(uint8_t priority) { priority_ = priority; }
+
   // Called at the beginning of a read transfer. The stream::Reader must be
   // ready to read after a successful PrepareRead() call. Returning a non-OK
   // status aborts the read.
@@ -61,10 +69,10 @@ class Handler : public IntrusiveList<Handler>::Item {
 
  protected:
   constexpr Handler(uint32_t transfer_id, stream::Reader* reader)
-      : transfer_id_(transfer_id), reader_(reader) {}
+      : transfer_id_(transfer_id), priority_(0), reader_(reader) {}
 
   constexpr Handler(uint32_t transfer_id, stream::Writer* writer)
-      : transfer_id_(transfer_id), writer_(writer) {}
+      : transfer_id_(transfer_id), priority_(0), writer_(writer) {}
 
   void set_reader(stream::Reader& reader) { reader_ = &reader; }
   void set_writer(stream::Writer& writer) { writer_ = &writer; }
@@ -90,6 +98,7 @@ class Handler : public IntrusiveList<Handler>::Item {
   }
 
   uint32_t transfer_id_;
+  uint8_t priority_;
 
   // Use a union to support constexpr construction.
   union {
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <cstdint>
 #include <optional>
 
 #include "pw_bytes/span.h"
@@ -20,12 +21,19 @@
 
 namespace pw::transfer::internal {
 
+// Compression algorithms for chunk data (pw.transfer.Compression).
+enum class Compression : uint8_t {
+  kNone = 0,
+  kLzss = 1,
+};
+
 struct Chunk {
-  // The initial chunk always has an offset of 0 and no data or status.
+  // The initial chunk has no data or status. Its offset is 0, unless it resumes
+  // an interrupted transfer.
   //
   // Pending bytes is required in all read chunks, so that is checked elsewhere.
   constexpr bool IsInitialChunk() const {
-    return offset == 0 && data.empty() && !status.has_value();
+    return (offset == 0 || resume) && data.empty() && !status.has_value();
   }
 
   // The final chunk from the transmitter sets remaining_bytes to 0 in both Read
@@ -40,6 +48,9 @@ struct Chunk {
   ConstByteSpan data;
   std::optional<uint64_t> remaining_bytes;
   std::optional<Status> status;
+  std::optional<Compression> compression;
+  std::optional<uint32_t> compression_window_bytes;
+  bool resume;
 };
 
 Status DecodeChunk(ConstByteSpan message, Chunk& chunk);
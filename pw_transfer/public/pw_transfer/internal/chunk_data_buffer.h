@@ -14,6 +14,7 @@
 #pragma once
 
 #include "pw_bytes/span.h"
+#include "pw_status/status.h"
 
 namespace pw::transfer::internal {
 
@@ -23,27 +24,38 @@ namespace pw::transfer::internal {
 // written directly to a stream::Writer from the RPC callback. Instead, it is
 // copied into this buffer and later drained by a job in a work queue. This
 // buffer must be locked when it is written to, and unlocked when drained.
+// Stages the data from a received chunk until it is written to the transfer's
+// stream. Uncompressed data is referenced in place in the received packet, so
+// only decompressed data is stored in the buffer.
 class ChunkDataBuffer {
  public:
   constexpr ChunkDataBuffer(ByteSpan buffer)
-      : buffer_(buffer), size_(0), last_chunk_(false) {}
+      : buffer_(buffer), data_(), last_chunk_(false) {}
 
-  constexpr std::byte* data() const { return buffer_.data(); }
+  constexpr const std::byte* data() const { return data_.data(); }
 
-  constexpr size_t size() const { return size_; }
+  constexpr size_t size() const { return data_.size(); }
   constexpr size_t max_size() const { return buffer_.size(); }
 
   constexpr bool empty() const { return size() == 0u; }
 
   constexpr bool last_chunk() const { return last_chunk_; }
 
-  void Write(ConstByteSpan data, bool last_chunk);
+  // Stages data without copying it. The data must remain valid until the chunk
+  // has been processed, so the chunk must be processed before the RPC callback
+  // that received it returns.
+  void Reference(ConstByteSpan data, bool last_chunk) {
+    data_ = data;
+    last_chunk_ = last_chunk;
+  }
+
+  // Decompresses LZSS-compressed data into the buffer. Returns the status from
+  // LzssDecompress(); the buffer is empty if decompression fails.
+  Status WriteLzss(ConstByteSpan compressed, bool last_chunk);
 
  private:
-  // TODO(frolv): This should be locked for use between an RPC thread and work
-  // queue.
   ByteSpan buffer_;
-  size_t size_;
+  ConstByteSpan data_;
   bool last_chunk_;
 };
 
@@ -37,6 +37,9 @@ class RawClientWriter final : public RawWriter {
 
   uint32_t channel_id() const final { return writer_->channel_id(); }
   ByteSpan PayloadBuffer() final { return writer_->PayloadBuffer(); }
+  size_t MaxWriteSizeBytes() const final {
+    return writer_->MaxWriteSizeBytes();
+  }
   void ReleaseBuffer() final { writer_->ReleaseBuffer(); }
   Status Write(ConstByteSpan data) final { return writer_->Write(data); }
 
@@ -61,17 +64,21 @@ class ClientContext : public Context {
     return *client_;
   }
 
+  // Begins a read or write transfer. A nonzero offset resumes an interrupted
+  // transfer at that offset.
   void StartRead(Client& client,
                  uint32_t transfer_id,
                  stream::Writer& writer,
                  rpc::RawClientReaderWriter& stream,
-                 Function<void(Status)>&& on_completion);
+                 Function<void(Status)>&& on_completion,
+                 uint32_t offset);
 
   void StartWrite(Client& client,
                   uint32_t transfer_id,
                   stream::Reader& reader,
                   rpc::RawClientReaderWriter& stream,
-                  Function<void(Status)>&& on_completion);
+                  Function<void(Status)>&& on_completion,
+                 uint32_t offset);
 
   void Finish(Status status) {
     PW_DASSERT(active());
@@ -0,0 +1,41 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+// The maximum number of concurrent read transfers, and separately of
+// concurrent write transfers, that a TransferService can serve. Each transfer
+// slot holds a transfer context in the service.
+#ifndef PW_TRANSFER_CONFIG_MAX_CONCURRENT_TRANSFERS
+#define PW_TRANSFER_CONFIG_MAX_CONCURRENT_TRANSFERS 2
+#endif  // PW_TRANSFER_CONFIG_MAX_CONCURRENT_TRANSFERS
+
+static_assert(PW_TRANSFER_CONFIG_MAX_CONCURRENT_TRANSFERS > 0);
+
+// The size of the buffer each transfer context uses to compress data it
+// transmits, which bounds the uncompressed size of a compressed chunk. Data is
+// only compressed if the receiver accepts compression. If 0, data is never
+// compressed. Received compressed data is decompressed into the transfer data
+// buffer, so receiving compressed data does not need this buffer.
+#ifndef PW_TRANSFER_CONFIG_COMPRESSION_BUFFER_SIZE_BYTES
+#define PW_TRANSFER_CONFIG_COMPRESSION_BUFFER_SIZE_BYTES 0
+#endif  // PW_TRANSFER_CONFIG_COMPRESSION_BUFFER_SIZE_BYTES
+
+namespace pw::transfer::cfg {
+
+inline constexpr size_t kCompressionBufferSizeBytes =
+    PW_TRANSFER_CONFIG_COMPRESSION_BUFFER_SIZE_BYTES;
+
+}  // namespace pw::transfer::cfg
@@ -13,15 +13,19 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cinttypes>
 #include <cstddef>
 #include <limits>
 
 #include "pw_assert/assert.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_result/result.h"
 #include "pw_status/status.h"
 #include "pw_stream/stream.h"
 #include "pw_transfer/internal/chunk.h"
 #include "pw_transfer/internal/chunk_data_buffer.h"
+#include "pw_transfer/internal/config.h"
 
 namespace pw::transfer::internal {
 
@@ -54,6 +58,8 @@ class RawWriter {
 
   virtual uint32_t channel_id() const = 0;
   virtual ByteSpan PayloadBuffer() = 0;
+  // The largest payload that fits in one packet within the channel's MTU.
+  virtual size_t MaxWriteSizeBytes() const = 0;
   virtual void ReleaseBuffer() = 0;
   virtual Status Write(ConstByteSpan data) = 0;
 };
@@ -108,6 +114,29 @@ class Context {
     ProcessReceiveChunk(buffer, max_parameters);
   }
 
+  // True if this is an active transmit transfer with data left in the window
+  // the receiver requested.
+  constexpr bool has_pending_transmit_data() const {
+    return state_ == kData && type_ == kTransmit && pending_bytes_ > 0u;
+  }
+
+  // In a transmit transfer, sends up to max_chunks data chunks from the
+  // window the receiver requested. ProcessChunk() sends the whole window at
+  // once; this allows a window to be sent in several turns instead. Returns
+  // true if there is data left to send.
+  bool SendTransmitChunks(size_t max_chunks);
+
+  // The rate at which data was transferred since the transfer started, in
+  // bytes per second. Call this when the transfer completes to get its
+  // goodput; retransmitted data and protocol overhead are not counted.
+  uint32_t GoodputBytesPerSecond() const;
+
+  // The number of times a transmit transfer reduced its chunk size because the
+  // transport could not send a chunk.
+  constexpr uint32_t chunk_size_reductions() const {
+    return chunk_size_reductions_;
+  }
+
  protected:
   using CompletionFunction = Status (*)(Context&, Status);
 
@@ -120,8 +149,16 @@ class Context {
         offset_(0),
         pending_bytes_(0),
         max_chunk_size_bytes_(std::numeric_limits<uint32_t>::max()),
+        chunk_size_limit_bytes_(std::numeric_limits<uint32_t>::max()),
+        chunk_size_reductions_(0),
+        window_size_(std::numeric_limits<uint32_t>::max()),
         status_(Status::Unknown()),
         last_received_offset_(0),
+        compression_window_bytes_(0),
+        compression_buffer_size_(0),
+        compression_buffer_{},
+        start_offset_(0),
+        start_time_(),
         on_completion_(on_completion) {}
 
   enum State : uint8_t {
@@ -142,26 +179,27 @@ class Context {
   constexpr State state() const { return state_; }
   constexpr void set_state(State state) { state_ = state; }
 
-  // Begins a new transmit transfer from this context.
+  // Begins a new transmit transfer from this context, starting at offset.
   // Precontion: context is not active.
   void InitializeForTransmit(uint32_t transfer_id,
                              RawWriter& rpc_writer,
-                             stream::Reader& reader) {
-    Initialize(kTransmit, transfer_id, rpc_writer, reader);
+                             stream::Reader& reader,
+                             uint32_t offset) {
+    Initialize(kTransmit, transfer_id, rpc_writer, reader, offset);
   }
 
-  // Begins a new receive transfer from this context.
+  // Begins a new receive transfer from this context, starting at offset.
   // Precontion: context is not active.
   void InitializeForReceive(uint32_t transfer_id,
                             RawWriter& rpc_writer,
-                            stream::Writer& writer) {
-    Initialize(kReceive, transfer_id, rpc_writer, writer);
+                            stream::Writer& writer,
+                            uint32_t offset) {
+    Initialize(kReceive, transfer_id, rpc_writer, writer, offset);
   }
 
   constexpr Type type() const { return type_; }
 
   constexpr uint32_t offset() const { return offset_; }
-  constexpr void set_offset(size_t offset) { offset_ = offset; }
 
   constexpr uint32_t pending_bytes() const { return pending_bytes_; }
   constexpr void set_pending_bytes(size_t pending_bytes) {
@@ -177,7 +215,8 @@ class Context {
 
   // Calculates the maximum size of actual data that can be sent within a single
   // client write transfer chunk, accounting for the overhead of the transfer
-  // protocol and RPC system.
+  // protocol and RPC system. The channel's MTU is assumed to apply in both
+  // directions, so it also limits the size.
   //
   // Note: This function relies on RPC protocol internals. This is generally a
   // *bad* idea, but is necessary here due to limitations of the RPC system and
@@ -192,7 +231,8 @@ class Context {
   void Initialize(Type type,
                   uint32_t transfer_id,
                   RawWriter& rpc_writer,
-                  stream::Stream& stream);
+                  stream::Stream& stream,
+                  uint32_t offset);
 
   stream::Reader& reader() const {
     PW_DASSERT(active() && type_ == kTransmit);
@@ -229,6 +269,27 @@ class Context {
   //
   Status SendNextDataChunk();
 
+  // In a transmit transfer, handles an uncompressed data chunk of chunk_size
+  // bytes that the transport could not send because it was too large. Rewinds
+  // the stream to resend the data and halves the chunk size. Returns false if
+  // the chunk cannot be resent in smaller chunks.
+  bool ReduceChunkSize(size_t chunk_size);
+
+  // True if a transmit transfer sends data through the compression buffer:
+  // either the receiver accepts compressed data, or data read for compression
+  // has not been sent yet.
+  constexpr bool compressing() const {
+    return (compression_window_bytes_ > 0u && !compression_buffer_.empty()) ||
+           compression_buffer_size_ > 0u;
+  }
+
+  // In a transmit transfer, reads data from the stream into the compression
+  // buffer and writes as much of it as fits to the destination, compressed if
+  // that makes it smaller. Sets bytes_read to the amount of uncompressed data
+  // written; the data is compressed if it is smaller than that. Returns
+  // OUT_OF_RANGE at the end of the stream.
+  Result<ByteSpan> ReadCompressedData(ByteSpan destination, size_t& bytes_read);
+
   // In a receive transfer, processes the fields from a data chunk and stages
   // the data for a deferred write. Returns true if there is a deferred
   // operation to complete.
@@ -237,8 +298,17 @@ class Context {
                        const Chunk& chunk);
 
   // In a receive transfer, sends a parameters chunk telling the transmitter how
-  // much data they can send.
-  Status SendTransferParameters(const TransferParameters& max_parameters);
+  // much data they can send. The resume flag is set in the first chunk of a
+  // resumed transfer.
+  Status SendTransferParameters(const TransferParameters& max_parameters,
+                                bool resume = false);
+
+  // In a receive transfer, adapts the window requested in parameters chunks to
+  // the observed loss: the window is halved when a chunk is dropped and grows
+  // by one chunk for each window received without loss, between one chunk and
+  // the maximum pending bytes.
+  void ShrinkWindow(const TransferParameters& max_parameters);
+  void GrowWindow(const TransferParameters& max_parameters);
 
   void SendStatusChunk(Status status);
 
@@ -255,9 +325,32 @@ class Context {
   size_t pending_bytes_;
   size_t max_chunk_size_bytes_;
 
+  // In a transmit transfer, the largest chunk data to send, whatever the
+  // receiver requests. Halved whenever the transport fails to send a chunk
+  // because it is too large.
+  size_t chunk_size_limit_bytes_;
+  uint32_t chunk_size_reductions_;
+
+  // The most data a receiver requests in one parameters chunk. Starts at the
+  // maximum pending bytes, represented by UINT32_MAX until it first changes.
+  size_t window_size_;
+
   Status status_;
   size_t last_received_offset_;
 
+  // In a transmit transfer, the most uncompressed data the receiver accepts in
+  // a compressed chunk, or 0 if it does not accept compressed data.
+  size_t compression_window_bytes_;
+
+  // Data read from the stream that has not been sent yet. The stream is
+  // positioned at offset_ + compression_buffer_size_.
+  size_t compression_buffer_size_;
+  std::array<std::byte, cfg::kCompressionBufferSizeBytes> compression_buffer_;
+
+  // Where and when the transfer started, to measure its goodput.
+  size_t start_offset_;
+  chrono::SystemClock::time_point start_time_;
+
   CompletionFunction on_completion_;
 };
 
@@ -0,0 +1,59 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::transfer::internal {
+
+// LZSS compression for transfer chunk data (pw.transfer.Compression.LZSS).
+//
+// Each chunk is compressed independently, so a chunk can be decompressed
+// without any of the data that preceded it. Neither compression nor
+// decompression needs memory beyond the input and output buffers.
+//
+// Compressed data is a sequence of groups of up to eight items. Each group
+// starts with a flag byte; bit N, starting from the least significant bit,
+// describes item N of the group:
+//
+//   1: a literal byte, which is copied to the output.
+//   0: a two-byte match, which repeats earlier output. The first byte and the
+//      high nibble of the second byte are the distance back minus 1 (little
+//      endian); the low nibble is the length minus kLzssMinMatch.
+//
+inline constexpr size_t kLzssMaxDistance = 4096;
+inline constexpr size_t kLzssMinMatch = 3;
+inline constexpr size_t kLzssMaxMatch = 18;
+
+struct LzssCompressResult {
+  size_t bytes_read;     // Bytes of input compressed.
+  size_t bytes_written;  // Bytes of compressed data written to the output.
+};
+
+// Compresses as much of the input as fits in the output. The compressed data
+// may be larger than the input if the input does not compress.
+LzssCompressResult LzssCompress(ConstByteSpan input, ByteSpan output);
+
+// Decompresses data compressed by LzssCompress(). Returns the decompressed
+// size, or one of the following errors:
+//
+//   RESOURCE_EXHAUSTED - The decompressed data does not fit in the output.
+//   DATA_LOSS - The compressed data is malformed.
+//
+StatusWithSize LzssDecompress(ConstByteSpan input, ByteSpan output);
+
+}  // namespace pw::transfer::internal
@@ -13,12 +13,16 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+
 #include "pw_assert/assert.h"
 #include "pw_containers/intrusive_list.h"
+#include "pw_metric/metric.h"
 #include "pw_result/result.h"
 #include "pw_rpc/raw/server_reader_writer.h"
 #include "pw_transfer/handler.h"
 #include "pw_transfer/internal/client_connection.h"
+#include "pw_transfer/internal/config.h"
 #include "pw_transfer/internal/context.h"
 
 namespace pw::transfer::internal {
@@ -33,6 +37,9 @@ class RawServerWriter final : public RawWriter {
 
   uint32_t channel_id() const final { return writer_->channel_id(); }
   ByteSpan PayloadBuffer() final { return writer_->PayloadBuffer(); }
+  size_t MaxWriteSizeBytes() const final {
+    return writer_->MaxWriteSizeBytes();
+  }
   void ReleaseBuffer() final { writer_->ReleaseBuffer(); }
   Status Write(ConstByteSpan data) final { return writer_->Write(data); }
 
@@ -44,29 +51,66 @@ class RawServerWriter final : public RawWriter {
 
 struct Chunk;
 
+// Metrics for the transfers served by a TransferService.
+class ServerMetrics {
+ public:
+  ServerMetrics() = default;
+
+  ServerMetrics(const ServerMetrics&) = delete;
+  ServerMetrics& operator=(const ServerMetrics&) = delete;
+
+  // Records a transfer that ended with the given status.
+  void RecordTransfer(const Context& transfer, Status status);
+
+  metric::Group& group() { return metrics_; }
+
+ private:
+  PW_METRIC_GROUP(metrics_, "pw_transfer");
+  PW_METRIC(metrics_, transfers_completed_, "transfers_completed", 0u);
+  PW_METRIC(metrics_, transfers_failed_, "transfers_failed", 0u);
+  PW_METRIC(metrics_,
+            last_goodput_,
+            "last_goodput_bytes_per_second",
+            0u);
+  PW_METRIC(metrics_, chunk_size_reductions_, "chunk_size_reductions", 0u);
+};
+
 // Transfer context for use within the transfer service (server-side). Stores a
 // pointer to a transfer handler when active to stream the transfer data.
 class ServerContext : public Context {
  public:
   constexpr ServerContext()
-      : Context(OnCompletion), type_(kRead), handler_(nullptr) {}
+      : Context(OnCompletion),
+        type_(kRead),
+        handler_(nullptr),
+        metrics_(nullptr) {}
 
   // Begins a new transfer with the specified type and handler. Calls into the
-  // handler's Prepare method.
+  // handler's Prepare method. A transfer that resumes at a nonzero offset seeks
+  // the handler's stream to that offset.
   //
   // Precondition: Context is not already active.
   Status Start(TransferType type,
                Handler& handler,
-               rpc::RawServerReaderWriter& stream);
+               uint32_t offset,
+               rpc::RawServerReaderWriter& stream,
+               ServerMetrics& metrics);
 
   // Ends the transfer with the given status, calling the handler's Finalize
-  // method. No chunks are sent.
+  // method and recording the transfer in the metrics. No chunks are sent.
   //
   // Returns DATA_LOSS if the finalize call fails.
   //
   // Precondition: Transfer context is active.
   Status Finish(Status status);
 
+  // The number of data chunks a transmit transfer sends in each turn when
+  // sharing bandwidth with other transfers.
+  size_t chunks_per_turn() const {
+    PW_DASSERT(handler_ != nullptr);
+    return handler_->priority() + 1u;
+  }
+
  private:
   static Status OnCompletion(Context& ctx, Status status) {
     return static_cast<ServerContext&>(ctx).Finish(status);
@@ -75,14 +119,16 @@ class ServerContext : public Context {
   TransferType type_;
   Handler* handler_;
   RawServerWriter writer_;
+  ServerMetrics* metrics_;
 };
 
 // A fixed-size pool of allocatable transfer contexts.
 class ServerContextPool {
  public:
   constexpr ServerContextPool(TransferType type,
-                              IntrusiveList<internal::Handler>& handlers)
-      : type_(type), handlers_(handlers) {}
+                              IntrusiveList<internal::Handler>& handlers,
+                              ServerMetrics& metrics)
+      : type_(type), handlers_(handlers), metrics_(metrics) {}
 
   // Looks up an active context by ID. If none exists, tries to allocate and
   // start a new context.
@@ -91,20 +137,30 @@ class ServerContextPool {
   //
   //   NOT_FOUND - No handler exists for the specified transfer ID.
   //   RESOURCE_EXHAUSTED - Out of transfer context slots.
+  //   UNIMPLEMENTED - The transfer resumes at an offset, but the handler's
+  //       stream does not support seeking.
+  //   OUT_OF_RANGE - The transfer resumes at an offset past the end of the
+  //       handler's stream.
   //
   Result<ServerContext*> StartTransfer(uint32_t transfer_id,
+                                       uint32_t offset,
                                        rpc::RawServerReaderWriter& stream);
 
   Result<ServerContext*> GetPendingTransfer(uint32_t transfer_id);
 
+  // Gives each transmit transfer with pending data one turn, in which it sends
+  // up to chunks_per_turn() chunks. Returns true if any transfer still has
+  // data to send afterwards.
+  bool SendPendingData();
+
  private:
-  // TODO(frolv): Initially, only one transfer at a time is supported. Once that
-  // is updated, this should be made configurable.
-  static constexpr int kMaxConcurrentTransfers = 1;
+  static constexpr int kMaxConcurrentTransfers =
+      PW_TRANSFER_CONFIG_MAX_CONCURRENT_TRANSFERS;
 
   TransferType type_;
   std::array<ServerContext, kMaxConcurrentTransfers> transfers_;
   IntrusiveList<internal::Handler>& handlers_;
+  ServerMetrics& metrics_;
 };
 
 }  // namespace pw::transfer::internal
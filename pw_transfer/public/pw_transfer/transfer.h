@@ -16,12 +16,17 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <mutex>
 
 #include "pw_bytes/span.h"
+#include "pw_metric/metric.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
 #include "pw_transfer/handler.h"
 #include "pw_transfer/internal/client_connection.h"
 #include "pw_transfer/internal/server_context.h"
 #include "pw_transfer/transfer.raw_rpc.pb.h"
+#include "pw_work_queue/work_queue.h"
 
 namespace pw::transfer {
 namespace internal {
@@ -46,12 +51,28 @@ class TransferService : public generated::Transfer<TransferService> {
   // reliable transport. However, if the underlying transport is unreliable,
   // larger values could slow down a transfer in the event of repeated packet
   // loss.
-  constexpr TransferService(ByteSpan transfer_data_buffer,
-                            uint32_t max_pending_bytes)
-      : read_transfers_(internal::kRead, handlers_),
-        write_transfers_(internal::kWrite, handlers_),
+  //
+  // If a work queue is provided, read transfer data is read from the handlers
+  // and sent from the work queue instead of from the RPC thread, so a slow
+  // handler does not hold up incoming chunks. Concurrent read transfers then
+  // take turns: each turn sends up to priority() + 1 chunks for every read
+  // transfer with data pending (see Handler::set_priority()), then yields the
+  // work queue to other work. Write transfer data is always written from the
+  // RPC thread, directly from the received packet without an intermediate
+  // copy. transfer_data_buffer only holds decompressed data.
+  //
+  // Transfer chunks are sized to fit within the RPC channel's MTU, if its
+  // ChannelOutput sets one. A read transfer that fails to send a chunk with
+  // RESOURCE_EXHAUSTED halves its chunk size and resends the data.
+  TransferService(ByteSpan transfer_data_buffer,
+                  uint32_t max_pending_bytes,
+                  work_queue::WorkQueue* work_queue = nullptr)
+      : read_transfers_(internal::kRead, handlers_, metrics_),
+        write_transfers_(internal::kWrite, handlers_, metrics_),
         client_(max_pending_bytes, transfer_data_buffer.size()),
-        chunk_data_buffer_(transfer_data_buffer) {}
+        chunk_data_buffer_(transfer_data_buffer),
+        work_queue_(work_queue),
+        read_data_scheduled_(false) {}
 
   TransferService(const TransferService&) = delete;
   TransferService(TransferService&&) = delete;
@@ -60,25 +81,34 @@ class TransferService : public generated::Transfer<TransferService> {
   TransferService& operator=(TransferService&&) = delete;
 
   void Read(ServerContext&, RawServerReaderWriter& reader_writer) {
+    std::lock_guard lock(mutex_);
     client_.InitializeRead(reader_writer, [this](ConstByteSpan message) {
       HandleChunk(message, internal::kRead);
     });
   }
 
   void Write(ServerContext&, RawServerReaderWriter& reader_writer) {
+    std::lock_guard lock(mutex_);
     client_.InitializeWrite(reader_writer, [this](ConstByteSpan message) {
       HandleChunk(message, internal::kWrite);
     });
   }
 
   void RegisterHandler(internal::Handler& handler) {
+    std::lock_guard lock(mutex_);
     handlers_.push_front(handler);
   }
 
   void UnregisterHandler(internal::Handler& handler) {
+    std::lock_guard lock(mutex_);
     handlers_.remove(handler);
   }
 
+  // Metrics for the transfers this service has served: the number that
+  // completed and failed, the goodput of the last completed transfer, and the
+  // number of times a read transfer reduced its chunk size.
+  metric::Group& metrics() { return metrics_.group(); }
+
  private:
   // Calls transfer.Finish() and sends the final status chunk.
   void FinishTransfer(internal::ServerContext& transfer, Status status);
@@ -87,26 +117,46 @@ class TransferService : public generated::Transfer<TransferService> {
   // sent successfully.
   bool SendNextReadChunk(internal::ServerContext& context);
 
-  void HandleChunk(ConstByteSpan message, internal::TransferType type);
+  void HandleChunk(ConstByteSpan message, internal::TransferType type)
+      PW_LOCKS_EXCLUDED(mutex_);
+
+  // Queues SendReadData() on the work queue, unless it is already queued. If
+  // the work cannot be queued, sends the data from the calling thread.
+  void ScheduleReadData() PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Gives each read transfer a turn to send data, then requeues itself if
+  // there is more to send. Runs on the work queue.
+  void SendReadData() PW_LOCKS_EXCLUDED(mutex_);
+
+  // Guards the transfer contexts, which are used from both the RPC thread and
+  // the work queue.
+  sync::Mutex mutex_;
 
   // All registered transfer handlers.
-  IntrusiveList<internal::Handler> handlers_;
+  IntrusiveList<internal::Handler> handlers_ PW_GUARDED_BY(mutex_);
 
-  internal::ServerContextPool read_transfers_;
-  internal::ServerContextPool write_transfers_;
+  // Updated with mutex_ held, but may be read without it.
+  internal::ServerMetrics metrics_;
+
+  internal::ServerContextPool read_transfers_ PW_GUARDED_BY(mutex_);
+  internal::ServerContextPool write_transfers_ PW_GUARDED_BY(mutex_);
 
   // Stores the RPC streams and parameters for communicating with the client.
-  internal::ClientConnection client_;
+  internal::ClientConnection client_ PW_GUARDED_BY(mutex_);
+
+  internal::ChunkDataBuffer chunk_data_buffer_ PW_GUARDED_BY(mutex_);
 
-  internal::ChunkDataBuffer chunk_data_buffer_;
+  work_queue::WorkQueue* const work_queue_;
+  bool read_data_scheduled_ PW_GUARDED_BY(mutex_);
 };
 
 // A transfer service with its own buffer for transfer data.
 template <size_t kSizeBytes>
 class TransferServiceBuffer : public TransferService {
  public:
-  constexpr TransferServiceBuffer(uint32_t max_pending_bytes)
-      : TransferService(transfer_data_buffer_, max_pending_bytes) {}
+  TransferServiceBuffer(uint32_t max_pending_bytes,
+                        work_queue::WorkQueue* work_queue = nullptr)
+      : TransferService(transfer_data_buffer_, max_pending_bytes, work_queue) {}
 
  private:
   std::array<std::byte, kSizeBytes> transfer_data_buffer_;
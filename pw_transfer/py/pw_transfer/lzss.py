@@ -0,0 +1,63 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Decompresses LZSS-compressed transfer chunk data.
+
+The format is described in pw_transfer/internal/lzss.h. Each chunk is
+compressed independently.
+"""
+
+_MIN_MATCH = 3
+
+
+def decompress(data: bytes) -> bytes:
+    """Decompresses the data from a chunk compressed with LZSS.
+
+    Raises:
+      ValueError: the data is malformed
+    """
+    output = bytearray()
+    i = 0
+
+    while i < len(data):
+        flags = data[i]
+        i += 1
+
+        for item in range(8):
+            if i == len(data):
+                break
+
+            if flags & (1 << item):
+                output.append(data[i])
+                i += 1
+                continue
+
+            if len(data) - i < 2:
+                raise ValueError('LZSS data ends within a match')
+
+            low, high = data[i], data[i + 1]
+            i += 2
+            distance = (low | (high >> 4) << 8) + 1
+            length = (high & 0xf) + _MIN_MATCH
+
+            if distance > len(output):
+                raise ValueError(
+                    f'LZSS match at distance {distance} is before the start '
+                    f'of the data ({len(output)} B decompressed)')
+
+            # Copy byte by byte, since a match may overlap the data it produces.
+            start = len(output) - distance
+            for j in range(length):
+                output.append(output[start + j])
+
+    return bytes(output)
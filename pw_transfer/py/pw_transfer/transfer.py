@@ -22,7 +22,8 @@ import threading
 from typing import Any, Callable, Optional
 
 from pw_status import Status
-from pw_transfer.transfer_pb2 import Chunk
+from pw_transfer import lzss
+from pw_transfer.transfer_pb2 import Chunk, Compression
 
 _LOG = logging.getLogger(__package__)
 
@@ -387,9 +388,24 @@ class ReadTransfer(Transfer):
             self._send_chunk(self._transfer_parameters())
             return
 
-        self._data += chunk.data
-        self._pending_bytes -= len(chunk.data)
-        self._offset += len(chunk.data)
+        data = chunk.data
+        if chunk.compression == Compression.LZSS:
+            try:
+                data = lzss.decompress(chunk.data)
+            except ValueError as err:
+                _LOG.error('Transfer %d: failed to decompress chunk: %s',
+                           self.id, err)
+                self._send_error(Status.DATA_LOSS)
+                return
+        elif chunk.compression != Compression.NONE:
+            _LOG.error('Transfer %d: unknown compression %d', self.id,
+                       chunk.compression)
+            self._send_error(Status.INVALID_ARGUMENT)
+            return
+
+        self._data += data
+        self._pending_bytes -= len(data)
+        self._offset += len(data)
 
         if chunk.HasField('remaining_bytes'):
             if chunk.remaining_bytes == 0:
@@ -403,7 +419,7 @@ class ReadTransfer(Transfer):
             self._remaining_transfer_size = chunk.remaining_bytes
         elif self._remaining_transfer_size is not None:
             # Update the remaining transfer size, if it is known.
-            self._remaining_transfer_size -= len(chunk.data)
+            self._remaining_transfer_size -= len(data)
 
             # If the transfer size drops to zero, the estimate was inaccurate.
             if self._remaining_transfer_size <= 0:
@@ -426,10 +442,13 @@ class ReadTransfer(Transfer):
 
         self._pending_bytes = self._max_bytes_to_receive
 
+        # Compressed chunks may hold up to a full window of data.
         chunk = Chunk(transfer_id=self.id,
                       pending_bytes=self._pending_bytes,
                       max_chunk_size_bytes=self._max_chunk_size,
-                      offset=self._offset)
+                      offset=self._offset,
+                      compression=Compression.LZSS,
+                      compression_window_bytes=self._pending_bytes)
 
         if self._chunk_delay_us:
             chunk.min_delay_microseconds = self._chunk_delay_us
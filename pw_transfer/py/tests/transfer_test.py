@@ -24,7 +24,7 @@ from pw_rpc import callback_client, client, ids, packets
 from pw_rpc.internal import packet_pb2
 
 import pw_transfer
-from pw_transfer.transfer_pb2 import Chunk
+from pw_transfer.transfer_pb2 import Chunk, Compression
 
 _TRANSFER_SERVICE_ID = ids.calculate('pw.transfer.Transfer')
 
@@ -110,6 +110,47 @@ class TransferManagerTest(unittest.TestCase):
         self.assertTrue(self._sent_chunks[-1].HasField('status'))
         self.assertEqual(self._sent_chunks[-1].status, 0)
 
+    def test_read_transfer_accepts_compression(self) -> None:
+        manager = pw_transfer.Manager(
+            self._service, default_response_timeout_s=DEFAULT_TIMEOUT_S)
+
+        # A literal 'a' followed by a match of 5 bytes at distance 1, then the
+        # literal 'b'.
+        self._enqueue_server_responses(
+            _Method.READ,
+            ((Chunk(transfer_id=3,
+                    offset=0,
+                    data=b'\x05a\x00\x02b',
+                    remaining_bytes=0,
+                    compression=Compression.LZSS), ), ),
+        )
+
+        data = manager.read(3)
+        self.assertEqual(data, b'aaaaaab')
+        self.assertEqual(self._sent_chunks[0].compression, Compression.LZSS)
+        self.assertEqual(self._sent_chunks[0].compression_window_bytes,
+                         self._sent_chunks[0].pending_bytes)
+        self.assertEqual(self._sent_chunks[-1].status, 0)
+
+    def test_read_transfer_corrupt_compressed_data(self) -> None:
+        manager = pw_transfer.Manager(
+            self._service, default_response_timeout_s=DEFAULT_TIMEOUT_S)
+
+        self._enqueue_server_responses(
+            _Method.READ,
+            ((Chunk(transfer_id=3,
+                    offset=0,
+                    data=b'\x00\x10\x00',
+                    remaining_bytes=0,
+                    compression=Compression.LZSS), ), ),
+        )
+
+        with self.assertRaises(pw_transfer.Error) as context:
+            manager.read(3)
+
+        self.assertEqual(context.exception.status, Status.DATA_LOSS)
+        self.assertEqual(self._sent_chunks[-1].status, Status.DATA_LOSS.value)
+
     def test_read_transfer_multichunk(self) -> None:
         manager = pw_transfer.Manager(
             self._service, default_response_timeout_s=DEFAULT_TIMEOUT_S)
@@ -25,9 +25,28 @@
 
 namespace pw::transfer::internal {
 
+void ServerMetrics::RecordTransfer(const Context& transfer, Status status) {
+  chunk_size_reductions_.Increment(transfer.chunk_size_reductions());
+
+  if (!status.ok()) {
+    transfers_failed_.Increment();
+    return;
+  }
+
+  const uint32_t goodput = transfer.GoodputBytesPerSecond();
+  transfers_completed_.Increment();
+  last_goodput_.Set(goodput);
+
+  PW_LOG_INFO("Transfer %u completed at %u B/s",
+              static_cast<unsigned>(transfer.transfer_id()),
+              static_cast<unsigned>(goodput));
+}
+
 Status ServerContext::Start(TransferType type,
                             Handler& handler,
-                            rpc::RawServerReaderWriter& stream) {
+                            uint32_t offset,
+                            rpc::RawServerReaderWriter& stream,
+                            ServerMetrics& metrics) {
   PW_DCHECK(!active());
 
   PW_LOG_INFO("Starting transfer %u", static_cast<unsigned>(handler.id()));
@@ -39,14 +58,43 @@ Status ServerContext::Start(TransferType type,
     return status.IsPermissionDenied() ? status : Status::DataLoss();
   }
 
+  if (offset != 0u) {
+    PW_LOG_INFO("Resuming transfer %u at offset %u",
+                static_cast<unsigned>(handler.id()),
+                static_cast<unsigned>(offset));
+
+    Status seek_status = type == kRead ? handler.reader().Seek(offset)
+                                       : handler.writer().Seek(offset);
+    if (!seek_status.ok()) {
+      PW_LOG_WARN("Transfer %u seek to %u failed with status %u",
+                  static_cast<unsigned>(handler.id()),
+                  static_cast<unsigned>(offset),
+                  seek_status.code());
+
+      // Seeking is not supported or the offset is past the end of the data;
+      // any other error means the stream is in a bad state.
+      if (!seek_status.IsUnimplemented() && !seek_status.IsOutOfRange()) {
+        seek_status = Status::DataLoss();
+      }
+
+      if (type == kRead) {
+        handler.FinalizeRead(seek_status);
+      } else {
+        handler.FinalizeWrite(seek_status).IgnoreError();
+      }
+      return seek_status;
+    }
+  }
+
   type_ = type;
   writer_.set_writer(stream);
   handler_ = &handler;
+  metrics_ = &metrics;
 
   if (type == kRead) {
-    InitializeForTransmit(handler.id(), writer_, handler.reader());
+    InitializeForTransmit(handler.id(), writer_, handler.reader(), offset);
   } else {
-    InitializeForReceive(handler.id(), writer_, handler.writer());
+    InitializeForReceive(handler.id(), writer_, handler.writer(), offset);
   }
 
   return OkStatus();
@@ -57,6 +105,7 @@ Status ServerContext::Finish(const Status status) {
 
   Handler& handler = *handler_;
   set_state(kCompleted);
+  metrics_->RecordTransfer(*this, status);
 
   if (type_ == kRead) {
     handler.FinalizeRead(status);
@@ -75,25 +124,35 @@ Status ServerContext::Finish(const Status status) {
 }
 
 Result<ServerContext*> ServerContextPool::StartTransfer(
-    uint32_t transfer_id, rpc::RawServerReaderWriter& stream) {
+    uint32_t transfer_id,
+    uint32_t offset,
+    rpc::RawServerReaderWriter& stream) {
   ServerContext* new_transfer = nullptr;
 
-  // Check if the ID belongs to an active transfer. If not, pick an inactive
-  // slot to start a new transfer.
+  // Check if the ID belongs to a previous transfer. If not, pick an inactive
+  // slot to start a new transfer. Reusing a previous transfer's slot ensures
+  // that GetPendingTransfer() finds the new transfer rather than a completed
+  // one with the same ID.
   for (ServerContext& transfer : transfers_) {
-    if (transfer.active()) {
+    if (transfer.initialized() && transfer.transfer_id() == transfer_id) {
       // Check if restarting a currently pending transfer.
-      if (transfer.transfer_id() == transfer_id) {
+      if (transfer.active()) {
         PW_LOG_DEBUG(
             "Received initial chunk for transfer %u which was already in "
             "progress; aborting and restarting",
             static_cast<unsigned>(transfer_id));
         transfer.Finish(Status::Aborted());
-        new_transfer = &transfer;
-        break;
       }
-    } else {
-      // Remember this but keep searching for an active transfer with this ID.
+      new_transfer = &transfer;
+      break;
+    }
+
+    // Remember this but keep searching for a transfer with this ID. Prefer
+    // unused slots over completed transfers, which may still need to respond
+    // to a retried final chunk.
+    if (!transfer.active() &&
+        (new_transfer == nullptr ||
+         (new_transfer->initialized() && !transfer.initialized()))) {
       new_transfer = &transfer;
     }
   }
@@ -111,7 +170,7 @@ Result<ServerContext*> ServerContextPool::StartTransfer(
     return Status::NotFound();
   }
 
-  PW_TRY(new_transfer->Start(type_, *handler, stream));
+  PW_TRY(new_transfer->Start(type_, *handler, offset, stream, metrics_));
   return new_transfer;
 }
 
@@ -131,4 +190,17 @@ Result<ServerContext*> ServerContextPool::GetPendingTransfer(
   return &(*transfer);
 }
 
+bool ServerContextPool::SendPendingData() {
+  bool data_remaining = false;
+
+  for (ServerContext& transfer : transfers_) {
+    if (transfer.has_pending_transmit_data() &&
+        transfer.SendTransmitChunks(transfer.chunks_per_turn())) {
+      data_remaining = true;
+    }
+  }
+
+  return data_remaining;
+}
+
 }  // namespace pw::transfer::internal
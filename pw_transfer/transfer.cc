@@ -16,6 +16,8 @@
 
 #include "pw_transfer/transfer.h"
 
+#include <mutex>
+
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
 #include "pw_status/try.h"
@@ -36,6 +38,7 @@ void TransferService::HandleChunk(ConstByteSpan message,
   //   - offset (required)
   //   - max_chunk_size_bytes
   //   - min_delay_microseconds (not yet supported)
+  //   - compression and compression_window_bytes
   //
   internal::Chunk chunk;
 
@@ -46,14 +49,19 @@ void TransferService::HandleChunk(ConstByteSpan message,
     return;
   }
 
+  std::lock_guard lock(mutex_);
+
   internal::ServerContextPool& pool =
       type == internal::kRead ? read_transfers_ : write_transfers_;
   rpc::RawServerReaderWriter& stream =
       type == internal::kRead ? client_.read_stream() : client_.write_stream();
 
+  // A chunk that resumes an interrupted transfer starts it again at the
+  // chunk's offset.
   Result<internal::ServerContext*> result =
-      chunk.IsInitialChunk() ? pool.StartTransfer(chunk.transfer_id, stream)
-                             : pool.GetPendingTransfer(chunk.transfer_id);
+      chunk.IsInitialChunk()
+          ? pool.StartTransfer(chunk.transfer_id, chunk.offset, stream)
+          : pool.GetPendingTransfer(chunk.transfer_id);
   if (!result.ok()) {
     client_.SendStatusChunk(type, chunk.transfer_id, result.status());
     PW_LOG_ERROR("Error handling chunk for transfer %u: %d",
@@ -76,12 +84,53 @@ void TransferService::HandleChunk(ConstByteSpan message,
     return;
   }
 
-  if (transfer.ReadChunkData(
+  if (!transfer.ReadChunkData(
           chunk_data_buffer_, client_.max_parameters(), chunk)) {
-    // Call this synchronously for now. Later, this will be deferred within a
-    // work queue.
-    transfer.ProcessChunk(chunk_data_buffer_, client_.max_parameters());
+    return;
+  }
+
+  // Read transfer data is sent from the work queue, if there is one. Received
+  // write transfer data must be written before this callback returns, since it
+  // is referenced in place in the received packet.
+  if (type == internal::kRead && work_queue_ != nullptr) {
+    ScheduleReadData();
+    return;
   }
+
+  transfer.ProcessChunk(chunk_data_buffer_, client_.max_parameters());
+}
+
+void TransferService::ScheduleReadData() {
+  if (read_data_scheduled_) {
+    return;  // The queued work sends data for all read transfers.
+  }
+
+  if (work_queue_->PushWork([this] { SendReadData(); }).ok()) {
+    read_data_scheduled_ = true;
+    return;
+  }
+
+  PW_LOG_WARN("Failed to queue transfer data; sending from the RPC thread");
+  while (read_transfers_.SendPendingData()) {
+  }
+}
+
+void TransferService::SendReadData() {
+  std::lock_guard lock(mutex_);
+
+  if (read_transfers_.SendPendingData()) {
+    // Requeue rather than loop, so that other work, including other modules'
+    // work, runs between turns.
+    if (work_queue_->PushWork([this] { SendReadData(); }).ok()) {
+      return;
+    }
+
+    PW_LOG_WARN("Failed to requeue transfer data; sending all pending data");
+    while (read_transfers_.SendPendingData()) {
+    }
+  }
+
+  read_data_scheduled_ = false;
 }
 
 }  // namespace pw::transfer
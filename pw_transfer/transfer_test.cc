@@ -14,9 +14,13 @@
 
 #include "pw_transfer/transfer.h"
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
 #include "pw_rpc/raw/test_method_context.h"
+#include "pw_transfer/internal/config.h"
+#include "pw_transfer/internal/lzss.h"
 #include "pw_transfer/transfer.pwpb.h"
 #include "pw_transfer_private/chunk_testing.h"
 
@@ -27,6 +31,7 @@ PW_MODIFY_DIAGNOSTICS_PUSH();
 PW_MODIFY_DIAGNOSTIC(ignored, "-Wmissing-field-initializers");
 
 using internal::Chunk;
+using internal::Compression;
 
 class TestMemoryReader : public stream::SeekableReader {
  public:
@@ -208,6 +213,53 @@ TEST_F(ReadTransfer, OutOfOrder_SeekingNotSupported_EndsWithUnimplemented) {
   EXPECT_EQ(chunk.status, Status::Unimplemented());
 }
 
+TEST_F(ReadTransfer, Resume_SendsDataFromOffset) {
+  ctx_.SendClientStream(EncodeChunk(
+      {.transfer_id = 3, .pending_bytes = 64, .offset = 16, .resume = true}));
+  EXPECT_TRUE(handler_.prepare_read_called);
+  EXPECT_FALSE(handler_.finalize_read_called);
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk c0 = DecodeChunk(ctx_.responses()[0]);
+  Chunk c1 = DecodeChunk(ctx_.responses()[1]);
+
+  EXPECT_EQ(c0.transfer_id, 3u);
+  EXPECT_EQ(c0.offset, 16u);
+  ASSERT_EQ(c0.data.size(), 16u);
+  EXPECT_EQ(std::memcmp(c0.data.data(), kData.data() + 16, c0.data.size()), 0);
+
+  ASSERT_TRUE(c1.remaining_bytes.has_value());
+  EXPECT_EQ(c1.remaining_bytes.value(), 0u);
+
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3, .status = OkStatus()}));
+  EXPECT_TRUE(handler_.finalize_read_called);
+  EXPECT_EQ(handler_.finalize_read_status, OkStatus());
+}
+
+TEST_F(ReadTransfer, Resume_SeekingNotSupported_EndsWithUnimplemented) {
+  handler_.set_seek_status(Status::Unimplemented());
+
+  ctx_.SendClientStream(EncodeChunk(
+      {.transfer_id = 3, .pending_bytes = 64, .offset = 16, .resume = true}));
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[0]);
+  EXPECT_EQ(chunk.transfer_id, 3u);
+  EXPECT_EQ(chunk.status, Status::Unimplemented());
+
+  EXPECT_TRUE(handler_.finalize_read_called);
+  EXPECT_EQ(handler_.finalize_read_status, Status::Unimplemented());
+}
+
+TEST_F(ReadTransfer, Resume_PastEndOfData_EndsWithOutOfRange) {
+  ctx_.SendClientStream(EncodeChunk(
+      {.transfer_id = 3, .pending_bytes = 64, .offset = 33, .resume = true}));
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[0]);
+  EXPECT_EQ(chunk.status, Status::OutOfRange());
+}
+
 TEST_F(ReadTransfer, MaxChunkSize_Client) {
   ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
                                      .pending_bytes = 64,
@@ -304,6 +356,81 @@ TEST_F(ReadTransferMaxChunkSize8, MaxChunkSize_Server) {
   EXPECT_EQ(handler_.finalize_read_status, OkStatus());
 }
 
+TEST_F(ReadTransfer, ChunksFitInChannelMtu) {
+  ctx_.output().set_mtu(48);
+
+  ctx_.SendClientStream(
+      EncodeChunk({.transfer_id = 3, .pending_bytes = 64, .offset = 0}));
+  ASSERT_GE(ctx_.total_responses(), 3u);
+
+  // The data is split into chunks smaller than the payload buffer would allow.
+  std::array<std::byte, kData.size()> received = {};
+  size_t offset = 0;
+  for (size_t i = 0; i < ctx_.total_responses() - 1; ++i) {
+    Chunk chunk = DecodeChunk(ctx_.responses()[i]);
+    EXPECT_EQ(chunk.offset, offset);
+    ASSERT_GT(chunk.data.size(), 0u);
+    ASSERT_LT(chunk.data.size(), kData.size());
+    ASSERT_LE(offset + chunk.data.size(), received.size());
+    std::memcpy(received.data() + offset, chunk.data.data(), chunk.data.size());
+    offset += chunk.data.size();
+  }
+  EXPECT_EQ(offset, kData.size());
+  EXPECT_EQ(std::memcmp(received.data(), kData.data(), kData.size()), 0);
+
+  Chunk last = DecodeChunk(ctx_.responses()[ctx_.total_responses() - 1]);
+  ASSERT_TRUE(last.remaining_bytes.has_value());
+  EXPECT_EQ(last.remaining_bytes.value(), 0u);
+}
+
+TEST_F(ReadTransfer, SendFailure_ReducesChunkSizeAndResends) {
+  // The second chunk is too large for the transport.
+  ctx_.output().set_send_status(Status::ResourceExhausted(), 1);
+
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                     .pending_bytes = 64,
+                                     .max_chunk_size_bytes = 16,
+                                     .offset = 0}));
+  EXPECT_FALSE(handler_.finalize_read_called);
+
+  ASSERT_EQ(ctx_.total_responses(), 4u);
+  Chunk c0 = DecodeChunk(ctx_.responses()[0]);
+  Chunk c1 = DecodeChunk(ctx_.responses()[1]);
+  Chunk c2 = DecodeChunk(ctx_.responses()[2]);
+  Chunk c3 = DecodeChunk(ctx_.responses()[3]);
+
+  EXPECT_EQ(c0.offset, 0u);
+  ASSERT_EQ(c0.data.size(), 16u);
+
+  // The data from the failed chunk is resent in chunks of half the size.
+  EXPECT_EQ(c1.offset, 16u);
+  ASSERT_EQ(c1.data.size(), 8u);
+  EXPECT_EQ(std::memcmp(c1.data.data(), kData.data() + 16, c1.data.size()), 0);
+
+  EXPECT_EQ(c2.offset, 24u);
+  ASSERT_EQ(c2.data.size(), 8u);
+  EXPECT_EQ(std::memcmp(c2.data.data(), kData.data() + 24, c2.data.size()), 0);
+
+  ASSERT_TRUE(c3.remaining_bytes.has_value());
+  EXPECT_EQ(c3.remaining_bytes.value(), 0u);
+
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3, .status = OkStatus()}));
+  EXPECT_TRUE(handler_.finalize_read_called);
+  EXPECT_EQ(handler_.finalize_read_status, OkStatus());
+}
+
+TEST_F(ReadTransfer, SendFailure_SeekingNotSupported_EndsWithDataLoss) {
+  handler_.set_seek_status(Status::Unimplemented());
+  ctx_.output().set_send_status(Status::ResourceExhausted(), 1);
+
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                     .pending_bytes = 64,
+                                     .max_chunk_size_bytes = 16,
+                                     .offset = 0}));
+  EXPECT_TRUE(handler_.finalize_read_called);
+  EXPECT_EQ(handler_.finalize_read_status, Status::DataLoss());
+}
+
 TEST_F(ReadTransfer, ClientError) {
   ctx_.SendClientStream(
       EncodeChunk({.transfer_id = 3, .pending_bytes = 16, .offset = 0}));
@@ -438,6 +565,109 @@ TEST_F(ReadTransfer, SendsErrorIfChunkIsReceivedInCompletedState) {
   EXPECT_FALSE(handler_.finalize_read_called);
 }
 
+#if PW_TRANSFER_CONFIG_COMPRESSION_BUFFER_SIZE_BYTES > 0
+
+constexpr auto kRepeatedData =
+    bytes::Initialized<48>([](size_t i) { return i % 4; });
+
+class CompressedReadTransfer : public ::testing::Test {
+ protected:
+  CompressedReadTransfer()
+      : handler_(3, kRepeatedData), ctx_(data_buffer_, 64) {
+    ctx_.service().RegisterHandler(handler_);
+    ctx_.call();  // Open the read stream
+  }
+
+  // Decompresses the data from a data chunk.
+  ConstByteSpan Decompress(const Chunk& chunk) {
+    const StatusWithSize result = internal::LzssDecompress(chunk.data, output_);
+    EXPECT_EQ(OkStatus(), result.status());
+    return std::span(output_).first(result.size());
+  }
+
+  SimpleReadTransfer handler_;
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Read) ctx_;
+  std::array<std::byte, 64> data_buffer_;
+  std::array<std::byte, 64> output_;
+};
+
+TEST_F(CompressedReadTransfer, SendsCompressedData) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                     .pending_bytes = 64,
+                                     .offset = 0,
+                                     .compression = Compression::kLzss,
+                                     .compression_window_bytes = 64}));
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk c0 = DecodeChunk(ctx_.responses()[0]);
+  EXPECT_EQ(c0.compression, Compression::kLzss);
+  EXPECT_LT(c0.data.size(), kRepeatedData.size());
+
+  ConstByteSpan data = Decompress(c0);
+  ASSERT_EQ(data.size(), kRepeatedData.size());
+  EXPECT_EQ(std::memcmp(data.data(), kRepeatedData.data(), data.size()), 0);
+
+  Chunk c1 = DecodeChunk(ctx_.responses()[1]);
+  EXPECT_EQ(c1.remaining_bytes, 0u);
+}
+
+TEST_F(CompressedReadTransfer, CompressionWindowLimitsChunkData) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                     .pending_bytes = 64,
+                                     .offset = 0,
+                                     .compression = Compression::kLzss,
+                                     .compression_window_bytes = 16}));
+
+  ASSERT_EQ(ctx_.total_responses(), 4u);
+  for (size_t i = 0; i < 3u; ++i) {
+    Chunk chunk = DecodeChunk(ctx_.responses()[i]);
+    EXPECT_EQ(chunk.offset, 16u * i);
+    ConstByteSpan data = Decompress(chunk);
+    ASSERT_EQ(data.size(), 16u);
+    EXPECT_EQ(
+        std::memcmp(data.data(), kRepeatedData.data() + 16 * i, data.size()),
+        0);
+  }
+}
+
+TEST_F(CompressedReadTransfer, NotAccepted_SendsUncompressedData) {
+  ctx_.SendClientStream(
+      EncodeChunk({.transfer_id = 3, .pending_bytes = 64, .offset = 0}));
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk c0 = DecodeChunk(ctx_.responses()[0]);
+  EXPECT_FALSE(c0.compression.has_value());
+  ASSERT_EQ(c0.data.size(), kRepeatedData.size());
+  EXPECT_EQ(std::memcmp(c0.data.data(), kRepeatedData.data(), c0.data.size()),
+            0);
+}
+
+TEST_F(CompressedReadTransfer, Retry_CompressesFromRequestedOffset) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                     .pending_bytes = 16,
+                                     .offset = 0,
+                                     .compression = Compression::kLzss,
+                                     .compression_window_bytes = 64}));
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+
+  // Request data from an earlier offset, as if the first chunk was lost.
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                     .pending_bytes = 64,
+                                     .offset = 4,
+                                     .compression = Compression::kLzss,
+                                     .compression_window_bytes = 64}));
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+
+  Chunk chunk = DecodeChunk(ctx_.responses()[1]);
+  EXPECT_EQ(chunk.offset, 4u);
+  ConstByteSpan data = Decompress(chunk);
+  ASSERT_EQ(data.size(), kRepeatedData.size() - 4);
+  EXPECT_EQ(std::memcmp(data.data(), kRepeatedData.data() + 4, data.size()),
+            0);
+}
+
+#endif  // PW_TRANSFER_CONFIG_COMPRESSION_BUFFER_SIZE_BYTES > 0
+
 class SimpleWriteTransfer final : public WriteOnlyHandler {
  public:
   SimpleWriteTransfer(uint32_t transfer_id, ByteSpan data)
@@ -523,6 +753,63 @@ TEST_F(WriteTransfer, SingleChunk) {
   EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), kData.size()), 0);
 }
 
+TEST_F(WriteTransfer, MaxChunkSize_LimitedByChannelMtu) {
+  ctx_.output().set_mtu(48);
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 7}));
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[0]);
+  ASSERT_TRUE(chunk.max_chunk_size_bytes.has_value());
+  EXPECT_GT(chunk.max_chunk_size_bytes.value(), 0u);
+  EXPECT_LT(chunk.max_chunk_size_bytes.value(), 37u);
+}
+
+TEST_F(WriteTransfer, SingleChunk_DataNotCopiedToBuffer) {
+  std::fill(data_buffer_.begin(), data_buffer_.end(), std::byte{0xee});
+
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 7}));
+  ctx_.SendClientStream<64>(EncodeChunk({.transfer_id = 7,
+                                         .offset = 0,
+                                         .data = std::span(kData),
+                                         .remaining_bytes = 0}));
+
+  ASSERT_TRUE(handler_.finalize_write_called);
+  EXPECT_EQ(handler_.finalize_write_status, OkStatus());
+  EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), kData.size()), 0);
+
+  // The chunk data was written to the handler straight from the packet.
+  EXPECT_TRUE(std::all_of(data_buffer_.begin(),
+                          data_buffer_.end(),
+                          [](std::byte b) { return b == std::byte{0xee}; }));
+}
+
+TEST_F(WriteTransfer, Resume_ReceivesDataFromOffset) {
+  std::memcpy(buffer.data(), kData.data(), 16);
+
+  ctx_.SendClientStream(
+      EncodeChunk({.transfer_id = 7, .offset = 16, .resume = true}));
+  EXPECT_TRUE(handler_.prepare_write_called);
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[0]);
+  EXPECT_EQ(chunk.transfer_id, 7u);
+  EXPECT_EQ(chunk.offset, 16u);
+  ASSERT_TRUE(chunk.pending_bytes.has_value());
+  EXPECT_EQ(chunk.pending_bytes.value(), 16u);
+
+  ctx_.SendClientStream<64>(EncodeChunk({.transfer_id = 7,
+                                         .offset = 16,
+                                         .data = std::span(kData).subspan(16),
+                                         .remaining_bytes = 0}));
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  chunk = DecodeChunk(ctx_.responses()[1]);
+  EXPECT_EQ(chunk.status, OkStatus());
+
+  EXPECT_TRUE(handler_.finalize_write_called);
+  EXPECT_EQ(handler_.finalize_write_status, OkStatus());
+  EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), kData.size()), 0);
+}
+
 TEST_F(WriteTransfer, FinalizeFails) {
   // Return an error when FinalizeWrite is called.
   handler_.set_finalize_write_return(Status::FailedPrecondition());
@@ -726,6 +1013,128 @@ TEST_F(WriteTransferMaxBytes16, TooMuchData) {
   EXPECT_EQ(chunk.status.value(), Status::Internal());
 }
 
+TEST_F(WriteTransfer, AcceptsCompressedData) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 7}));
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[0]);
+  EXPECT_EQ(chunk.compression, Compression::kLzss);
+  EXPECT_EQ(chunk.compression_window_bytes, 64u);
+
+  constexpr auto kRepeated = bytes::Initialized<32>([](size_t) { return 1; });
+  std::array<std::byte, 16> compressed;
+  const internal::LzssCompressResult result =
+      internal::LzssCompress(kRepeated, compressed);
+  ASSERT_EQ(result.bytes_read, kRepeated.size());
+
+  ctx_.SendClientStream<64>(
+      EncodeChunk({.transfer_id = 7,
+                   .offset = 0,
+                   .data = std::span(compressed).first(result.bytes_written),
+                   .remaining_bytes = 0,
+                   .compression = Compression::kLzss}));
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  chunk = DecodeChunk(ctx_.responses()[1]);
+  ASSERT_TRUE(chunk.status.has_value());
+  EXPECT_EQ(chunk.status.value(), OkStatus());
+  EXPECT_EQ(std::memcmp(buffer.data(), kRepeated.data(), kRepeated.size()), 0);
+}
+
+TEST_F(WriteTransfer, CorruptCompressedData_DataLoss) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 7}));
+
+  // A match that refers to data before the start of the chunk.
+  constexpr auto kCorrupt = bytes::Array<0x00, 0x10, 0x00>();
+  ctx_.SendClientStream<64>(EncodeChunk({.transfer_id = 7,
+                                         .offset = 0,
+                                         .data = kCorrupt,
+                                         .compression = Compression::kLzss}));
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[1]);
+  ASSERT_TRUE(chunk.status.has_value());
+  EXPECT_EQ(chunk.status.value(), Status::DataLoss());
+  EXPECT_EQ(handler_.finalize_write_status, Status::DataLoss());
+}
+
+TEST_F(WriteTransferMaxBytes16, TooMuchCompressedData) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 7}));
+
+  // pending_bytes = 16, but the data decompresses to 32 bytes.
+  constexpr auto kRepeated = bytes::Initialized<32>([](size_t) { return 1; });
+  std::array<std::byte, 16> compressed;
+  const internal::LzssCompressResult result =
+      internal::LzssCompress(kRepeated, compressed);
+
+  ctx_.SendClientStream<64>(
+      EncodeChunk({.transfer_id = 7,
+                   .offset = 0,
+                   .data = std::span(compressed).first(result.bytes_written),
+                   .compression = Compression::kLzss}));
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[1]);
+  ASSERT_TRUE(chunk.status.has_value());
+  EXPECT_EQ(chunk.status.value(), Status::Internal());
+}
+
+class WriteTransferAdaptiveWindow : public ::testing::Test {
+ protected:
+  WriteTransferAdaptiveWindow()
+      : buffer{},
+        handler_(7, buffer),
+        ctx_(std::span(data_buffer_).first(kMaxChunkSizeBytes),
+             kMaxPendingBytes) {
+    ctx_.service().RegisterHandler(handler_);
+    ctx_.call();  // Open the write stream
+  }
+
+  static constexpr size_t kMaxChunkSizeBytes = 40;
+  static constexpr uint32_t kMaxPendingBytes = 64;
+
+  // Sends 8-byte chunks covering [begin, end).
+  void SendData(uint32_t begin, uint32_t end) {
+    for (uint32_t offset = begin; offset < end; offset += 8) {
+      ctx_.SendClientStream<64>(EncodeChunk(
+          {.transfer_id = 7, .offset = offset, .data = std::span(kData8)}));
+    }
+  }
+
+  static constexpr auto kData8 = bytes::Initialized<8>([](size_t i) {
+    return i;
+  });
+
+  std::array<std::byte, 256> buffer;
+  SimpleWriteTransfer handler_;
+
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Write) ctx_;
+  std::array<std::byte, 64> data_buffer_;
+};
+
+TEST_F(WriteTransferAdaptiveWindow, ShrinksOnLossAndGrowsBack) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 7}));
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk chunk = DecodeChunk(ctx_.responses().back());
+  ASSERT_TRUE(chunk.pending_bytes.has_value());
+  EXPECT_EQ(chunk.pending_bytes.value(), kMaxPendingBytes);
+
+  // Drop the chunk at offset 8. The window is halved, but is never smaller
+  // than the maximum chunk size.
+  SendData(0, 8);
+  SendData(16, 24);
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.offset, 8u);
+  ASSERT_TRUE(chunk.pending_bytes.has_value());
+  EXPECT_EQ(chunk.pending_bytes.value(), kMaxChunkSizeBytes);
+
+  // Receiving the whole window without loss grows it again, up to the maximum.
+  SendData(8, 8 + kMaxChunkSizeBytes);
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+  chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.offset, 8u + kMaxChunkSizeBytes);
+  ASSERT_TRUE(chunk.pending_bytes.has_value());
+  EXPECT_EQ(chunk.pending_bytes.value(), kMaxPendingBytes);
+}
+
 TEST_F(WriteTransfer, UnregisteredHandler) {
   ctx_.SendClientStream(EncodeChunk({.transfer_id = 999}));
 
@@ -963,6 +1372,100 @@ TEST_F(ReadTransfer, PrepareError) {
   EXPECT_EQ(std::memcmp(chunk.data.data(), kData.data(), chunk.data.size()), 0);
 }
 
+TEST_F(ReadTransfer, ConcurrentTransfers) {
+  SimpleReadTransfer other_handler(4, kData);
+  ctx_.service().RegisterHandler(other_handler);
+
+  ctx_.SendClientStream(
+      EncodeChunk({.transfer_id = 3, .pending_bytes = 16, .offset = 0}));
+  ctx_.SendClientStream(
+      EncodeChunk({.transfer_id = 4, .pending_bytes = 16, .offset = 0}));
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  EXPECT_EQ(DecodeChunk(ctx_.responses()[0]).transfer_id, 3u);
+  EXPECT_EQ(DecodeChunk(ctx_.responses()[1]).transfer_id, 4u);
+
+  ctx_.SendClientStream(
+      EncodeChunk({.transfer_id = 4, .pending_bytes = 16, .offset = 16}));
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 4, .status = OkStatus()}));
+  EXPECT_TRUE(other_handler.finalize_read_called);
+  EXPECT_FALSE(handler_.finalize_read_called);
+
+  ctx_.SendClientStream(
+      EncodeChunk({.transfer_id = 3, .pending_bytes = 16, .offset = 16}));
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3, .status = OkStatus()}));
+  EXPECT_TRUE(handler_.finalize_read_called);
+  EXPECT_EQ(handler_.finalize_read_status, OkStatus());
+}
+
+class ReadTransferWorkQueue : public ::testing::Test {
+ protected:
+  ReadTransferWorkQueue()
+      : handler_(3, kData),
+        priority_handler_(4, kData),
+        ctx_(data_buffer_, 64, &work_queue_) {
+    priority_handler_.set_priority(1);
+    ctx_.service().RegisterHandler(handler_);
+    ctx_.service().RegisterHandler(priority_handler_);
+    ctx_.call();  // Open the read stream
+  }
+
+  // Runs all queued work on this thread. Once stopped, the work queue rejects
+  // new work, so the service sends any remaining data without yielding.
+  void RunWorkQueue() {
+    work_queue_.RequestStop();
+    work_queue_.Start();
+  }
+
+  work_queue::WorkQueueWithBuffer<4> work_queue_;
+  SimpleReadTransfer handler_;
+  SimpleReadTransfer priority_handler_;
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Read, 10) ctx_;
+  std::array<std::byte, 64> data_buffer_;
+};
+
+TEST_F(ReadTransferWorkQueue, SendsDataFromWorkQueue) {
+  ctx_.SendClientStream(
+      EncodeChunk({.transfer_id = 3, .pending_bytes = 64, .offset = 0}));
+  EXPECT_TRUE(handler_.prepare_read_called);
+  EXPECT_EQ(ctx_.total_responses(), 0u);
+
+  RunWorkQueue();
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk chunk = DecodeChunk(ctx_.responses()[0]);
+  EXPECT_EQ(chunk.transfer_id, 3u);
+  ASSERT_EQ(chunk.data.size(), kData.size());
+  EXPECT_EQ(std::memcmp(chunk.data.data(), kData.data(), chunk.data.size()), 0);
+
+  chunk = DecodeChunk(ctx_.responses()[1]);
+  ASSERT_TRUE(chunk.remaining_bytes.has_value());
+  EXPECT_EQ(chunk.remaining_bytes.value(), 0u);
+}
+
+TEST_F(ReadTransferWorkQueue, SharesBandwidthByPriority) {
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 3,
+                                     .pending_bytes = 32,
+                                     .max_chunk_size_bytes = 8,
+                                     .offset = 0}));
+  ctx_.SendClientStream(EncodeChunk({.transfer_id = 4,
+                                     .pending_bytes = 32,
+                                     .max_chunk_size_bytes = 8,
+                                     .offset = 0}));
+  EXPECT_EQ(ctx_.total_responses(), 0u);
+
+  RunWorkQueue();
+
+  // Transfer 4 has priority 1, so it sends two chunks in each turn to transfer
+  // 3's one, until its window is sent.
+  constexpr uint32_t kExpectedOrder[] = {3, 4, 4, 3, 4, 4, 3, 3};
+  ASSERT_EQ(ctx_.total_responses(), std::size(kExpectedOrder));
+  for (size_t i = 0; i < std::size(kExpectedOrder); ++i) {
+    Chunk chunk = DecodeChunk(ctx_.responses()[i]);
+    EXPECT_EQ(chunk.transfer_id, kExpectedOrder[i]);
+    EXPECT_EQ(chunk.data.size(), 8u);
+  }
+}
+
 PW_MODIFY_DIAGNOSTICS_POP();
 
 }  // namespace
@@ -24,6 +24,10 @@ void RegisterEventHandler(EventHandler* event_handler) {
   internal::Framework::Get().RegisterEventHandler(event_handler);
 }
 
+void RegisterTestClock(const TestClock& clock) {
+  internal::Framework::Get().RegisterTestClock(clock);
+}
+
 namespace internal {
 
 // Singleton instance of the unit test framework class.
@@ -56,8 +60,16 @@ int Framework::RunAllTests() {
   if (event_handler_ != nullptr) {
     event_handler_->RunAllTestsStart();
   }
+  uint32_t position = 0;
   for (const TestInfo* test = tests_; test != nullptr; test = test->next()) {
+    // Tests in other shards are not reported at all, so that the summaries of
+    // all shards can be added together.
+    if (position++ % shard_count_ != shard_index_) {
+      continue;
+    }
+
     if (ShouldRunTest(*test)) {
+      EndSuiteIfChanged(test);
       test->run();
     } else if (!test->enabled()) {
       run_tests_summary_.disabled_tests++;
@@ -69,12 +81,32 @@ int Framework::RunAllTests() {
       run_tests_summary_.skipped_tests++;
     }
   }
+  EndSuiteIfChanged(nullptr);
   if (event_handler_ != nullptr) {
     event_handler_->RunAllTestsEnd(run_tests_summary_);
   }
   return exit_status_;
 }
 
+void Framework::EndSuiteIfChanged(const TestInfo* next_test) {
+  if (suite_name_ != nullptr &&
+      (next_test == nullptr ||
+       std::strcmp(suite_name_, next_test->test_case().suite_name) != 0)) {
+    if (event_handler_ != nullptr) {
+      event_handler_->TestSuiteElapsed(
+          suite_name_,
+          ElapsedTime{.ticks = suite_elapsed_ticks_,
+                      .ticks_per_second = clock_.ticks_per_second});
+    }
+    suite_name_ = nullptr;
+  }
+
+  if (clock_.now != nullptr && suite_name_ == nullptr && next_test != nullptr) {
+    suite_name_ = next_test->test_case().suite_name;
+    suite_elapsed_ticks_ = 0;
+  }
+}
+
 void Framework::StartTest(const TestInfo& test) {
   current_test_ = &test;
   current_result_ = TestResult::kSuccess;
@@ -82,9 +114,17 @@ void Framework::StartTest(const TestInfo& test) {
   if (event_handler_ != nullptr) {
     event_handler_->TestCaseStart(test.test_case());
   }
+
+  // Read the clock last to exclude the event handler from the test's time.
+  if (clock_.now != nullptr) {
+    test_start_time_ = clock_.now();
+  }
 }
 
 void Framework::EndCurrentTest() {
+  const int64_t elapsed_ticks =
+      clock_.now != nullptr ? clock_.now() - test_start_time_ : 0;
+
   switch (current_result_) {
     case TestResult::kSuccess:
       run_tests_summary_.passed_tests++;
@@ -98,6 +138,16 @@ void Framework::EndCurrentTest() {
     event_handler_->TestCaseEnd(current_test_->test_case(), current_result_);
   }
 
+  if (clock_.now != nullptr) {
+    suite_elapsed_ticks_ += elapsed_ticks;
+    if (event_handler_ != nullptr) {
+      event_handler_->TestCaseElapsed(
+          current_test_->test_case(),
+          ElapsedTime{.ticks = elapsed_ticks,
+                      .ticks_per_second = clock_.ticks_per_second});
+    }
+  }
+
   current_test_ = nullptr;
 }
 
@@ -139,11 +189,99 @@ bool Framework::ShouldRunTest(const TestInfo& test_info) {
       return false;
     }
   }
+
+  if (!filter_.empty() && !TestMatchesFilter(filter_, test_info.test_case())) {
+    return false;
+  }
 #endif  // PW_CXX_STANDARD_IS_SUPPORTED(17)
 
   return test_info.enabled();
 }
 
+#if PW_CXX_STANDARD_IS_SUPPORTED(17)
+namespace {
+
+// The full name of a test, "Suite.Name", without copying it.
+class FullTestName {
+ public:
+  explicit FullTestName(const TestCase& test_case)
+      : suite_(test_case.suite_name), name_(test_case.test_name) {}
+
+  size_t size() const { return suite_.size() + 1 + name_.size(); }
+
+  char operator[](size_t index) const {
+    if (index < suite_.size()) {
+      return suite_[index];
+    }
+    return index == suite_.size() ? '.' : name_[index - suite_.size() - 1];
+  }
+
+ private:
+  std::string_view suite_;
+  std::string_view name_;
+};
+
+// Matches a glob pattern with '*' and '?' wildcards. On a mismatch, returns to
+// the most recent '*' and lets it match one more character.
+bool MatchesPattern(std::string_view pattern, const FullTestName& name) {
+  size_t p = 0;
+  size_t n = 0;
+  size_t star = std::string_view::npos;
+  size_t star_match = 0;
+
+  while (n < name.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+      p += 1;
+      n += 1;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      star_match = n;
+    } else if (star != std::string_view::npos) {
+      p = star + 1;
+      n = ++star_match;
+    } else {
+      return false;
+    }
+  }
+
+  while (p < pattern.size() && pattern[p] == '*') {
+    p += 1;
+  }
+  return p == pattern.size();
+}
+
+bool MatchesAnyPattern(std::string_view patterns, const FullTestName& name) {
+  while (true) {
+    const size_t end = patterns.find(':');
+    if (MatchesPattern(patterns.substr(0, end), name)) {
+      return true;
+    }
+    if (end == std::string_view::npos) {
+      return false;
+    }
+    patterns.remove_prefix(end + 1);
+  }
+}
+
+}  // namespace
+
+bool TestMatchesFilter(std::string_view filter, const TestCase& test_case) {
+  const FullTestName name(test_case);
+
+  const size_t negative_start = filter.find('-');
+  std::string_view positive = filter.substr(0, negative_start);
+  if (positive.empty()) {
+    positive = "*";
+  }
+
+  if (!MatchesAnyPattern(positive, name)) {
+    return false;
+  }
+  return negative_start == std::string_view::npos ||
+         !MatchesAnyPattern(filter.substr(negative_start + 1), name);
+}
+#endif  // PW_CXX_STANDARD_IS_SUPPORTED(17)
+
 bool TestInfo::enabled() const {
   constexpr size_t kStringSize = sizeof("DISABLED_") - 1;
   return std::strncmp("DISABLED_", test_case().test_name, kStringSize) != 0 &&
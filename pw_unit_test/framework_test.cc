@@ -191,5 +191,54 @@ TEST_F(SetUpAndTearDown, MakeSureItIsSet) {
   value_ = 3210;
 }
 
+TEST(ElapsedTime, Microseconds) {
+  constexpr unit_test::ElapsedTime kCycles = {.ticks = 48'000'123,
+                                              .ticks_per_second = 16'000'000};
+  EXPECT_EQ(kCycles.microseconds(), 3'000'007);
+
+  constexpr unit_test::ElapsedTime kNanoseconds = {
+      .ticks = 1'000'000'000'000'999, .ticks_per_second = 1'000'000'000};
+  EXPECT_EQ(kNanoseconds.microseconds(), 1'000'000'000'000);
+
+  constexpr unit_test::ElapsedTime kZero = {.ticks = 0,
+                                            .ticks_per_second = 1'000};
+  EXPECT_EQ(kZero.microseconds(), 0);
+}
+
+using unit_test::internal::TestMatchesFilter;
+
+TEST(TestFilter, MatchesFullName) {
+  const unit_test::TestCase test_case = {
+      .suite_name = "KeyValueStore", .test_name = "Put", .file_name = ""};
+
+  EXPECT_TRUE(TestMatchesFilter("", test_case));
+  EXPECT_TRUE(TestMatchesFilter("*", test_case));
+  EXPECT_TRUE(TestMatchesFilter("KeyValueStore.Put", test_case));
+  EXPECT_TRUE(TestMatchesFilter("Key*.P?t", test_case));
+  EXPECT_TRUE(TestMatchesFilter("*e.*", test_case));
+  EXPECT_FALSE(TestMatchesFilter("KeyValueStore", test_case));
+  EXPECT_FALSE(TestMatchesFilter("*.Get", test_case));
+  EXPECT_FALSE(TestMatchesFilter("?", test_case));
+}
+
+TEST(TestFilter, PositiveAndNegativePatterns) {
+  const unit_test::TestCase test_case = {
+      .suite_name = "Transfer", .test_name = "Slow", .file_name = ""};
+
+  EXPECT_TRUE(TestMatchesFilter("Kvs.*:Transfer.*", test_case));
+  EXPECT_TRUE(TestMatchesFilter("-*.Fast", test_case));
+  EXPECT_FALSE(TestMatchesFilter("-*.Slow", test_case));
+  EXPECT_FALSE(TestMatchesFilter("Transfer.*-*.Fast:*.Slow", test_case));
+  EXPECT_FALSE(TestMatchesFilter("Kvs.*:Rpc.*", test_case));
+}
+
+TEST(TestShard, IndexMustBeLessThanCount) {
+  static unit_test::internal::Framework framework;
+  EXPECT_TRUE(framework.SetTestShard(0, 1));
+  EXPECT_TRUE(framework.SetTestShard(63, 64));
+  EXPECT_FALSE(framework.SetTestShard(1, 1));
+  EXPECT_FALSE(framework.SetTestShard(0, 0));
+}
+
 }  // namespace
 }  // namespace pw
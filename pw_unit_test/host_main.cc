@@ -0,0 +1,125 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// A main for host test binaries that supports running a subset of the tests,
+// so that test runners can split a binary across processes. Supports the same
+// interface as Googletest:
+//
+//   --gtest_filter=FILTER  Runs only the tests matching FILTER. If the flag is
+//                          not given, the GTEST_FILTER variable is used.
+//   GTEST_TOTAL_SHARDS     The number of shards to split the tests into.
+//   GTEST_SHARD_INDEX      The shard to run, from 0 to GTEST_TOTAL_SHARDS - 1.
+//   GTEST_SHARD_STATUS_FILE
+//                          Created to tell the runner that sharding is
+//                          supported, as required by Bazel.
+//
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string_view>
+
+#include "pw_sys_io/sys_io.h"
+#include "pw_unit_test/framework.h"
+#include "pw_unit_test/simple_printing_event_handler.h"
+
+namespace {
+
+constexpr std::string_view kFilterFlag = "--gtest_filter=";
+
+// Reads an unsigned integer from an environment variable. Returns false if the
+// variable is set but is not a number.
+bool ReadVariable(const char* name, const char*& string, uint32_t& value) {
+  string = std::getenv(name);
+  if (string == nullptr) {
+    return true;
+  }
+
+  char* end;
+  const unsigned long parsed = std::strtoul(string, &end, 10);
+  if (*string == '\0' || *end != '\0' || parsed > UINT32_MAX) {
+    std::fprintf(stderr, "Invalid value for %s: \"%s\"\n", name, string);
+    return false;
+  }
+  value = static_cast<uint32_t>(parsed);
+  return true;
+}
+
+bool ConfigureSharding() {
+  if (const char* status_file = std::getenv("GTEST_SHARD_STATUS_FILE");
+      status_file != nullptr) {
+    if (std::FILE* file = std::fopen(status_file, "w"); file != nullptr) {
+      std::fclose(file);
+    }
+  }
+
+  const char* total_string;
+  const char* index_string;
+  uint32_t total = 1;
+  uint32_t index = 0;
+  if (!ReadVariable("GTEST_TOTAL_SHARDS", total_string, total) ||
+      !ReadVariable("GTEST_SHARD_INDEX", index_string, index)) {
+    return false;
+  }
+
+  // Googletest shards only if both variables are set.
+  if (total_string == nullptr || index_string == nullptr) {
+    return true;
+  }
+
+  if (!pw::unit_test::SetTestShard(index, total)) {
+    std::fprintf(stderr,
+                 "GTEST_SHARD_INDEX (%u) must be less than GTEST_TOTAL_SHARDS "
+                 "(%u)\n",
+                 static_cast<unsigned>(index),
+                 static_cast<unsigned>(total));
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const char* filter = std::getenv("GTEST_FILTER");
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg(argv[i]);
+    if (arg.substr(0, kFilterFlag.size()) != kFilterFlag) {
+      std::fprintf(stderr, "Unrecognized argument: %s\n", argv[i]);
+      return 1;
+    }
+    filter = argv[i] + kFilterFlag.size();
+  }
+
+  if (!ConfigureSharding()) {
+    return 1;
+  }
+
+  if (filter != nullptr) {
+    pw::unit_test::SetTestFilter(filter);
+  }
+
+  pw::unit_test::SimplePrintingEventHandler handler(
+      [](const std::string_view& s, bool append_newline) {
+        if (append_newline) {
+          pw::sys_io::WriteLine(s);
+        } else {
+          pw::sys_io::WriteBytes(std::as_bytes(std::span(s)));
+        }
+      });
+
+  pw::unit_test::RegisterEventHandler(&handler);
+  return RUN_ALL_TESTS();
+}
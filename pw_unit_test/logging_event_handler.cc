@@ -79,6 +79,21 @@ void LoggingEventHandler::TestCaseExpect(const TestCase& test_case,
          expectation.evaluated_expression);
 }
 
+void LoggingEventHandler::TestCaseElapsed(const TestCase& test_case,
+                                          const ElapsedTime& elapsed) {
+  PW_LOG_INFO("[   TIME   ] %s.%s %lld us",
+              test_case.suite_name,
+              test_case.test_name,
+              static_cast<long long>(elapsed.microseconds()));
+}
+
+void LoggingEventHandler::TestSuiteElapsed(const char* suite_name,
+                                           const ElapsedTime& elapsed) {
+  PW_LOG_INFO("[   TIME   ] %s %lld us",
+              suite_name,
+              static_cast<long long>(elapsed.microseconds()));
+}
+
 void LoggingEventHandler::TestCaseDisabled(const TestCase& test) {
   PW_LOG_DEBUG("Skipping disabled test %s.%s", test.suite_name, test.test_name);
 }
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstdint>
+
 namespace pw {
 namespace unit_test {
 
@@ -46,6 +48,11 @@ namespace unit_test {
 // sequence of events dispatched is the same, except that this TestCaseExpect
 // event is marked as a failure. The result passed alongside the TestCaseEnd
 // event also indicates that the test case did not complete successfully.
+//
+// If a test clock is registered, each TestCaseEnd event is followed by a
+// TestCaseElapsed event with the time the test case took to run. After the
+// last test case of a suite, a TestSuiteElapsed event reports the total time
+// of the suite's test cases.
 
 // The result of a complete test run.
 enum class TestResult {
@@ -78,6 +85,30 @@ struct TestExpectation {
   bool success;
 };
 
+// A monotonic clock used to time test cases.
+struct TestClock {
+  // Returns the current time in ticks.
+  int64_t (*now)();
+
+  // The number of ticks per second.
+  int64_t ticks_per_second;
+};
+
+// The time taken by a test case or test suite.
+struct ElapsedTime {
+  // Elapsed time in ticks of the test clock.
+  int64_t ticks;
+
+  // The number of ticks per second of the test clock.
+  int64_t ticks_per_second;
+
+  // Returns the elapsed time in microseconds, rounded down.
+  constexpr int64_t microseconds() const {
+    return ticks / ticks_per_second * 1000000 +
+           ticks % ticks_per_second * 1000000 / ticks_per_second;
+  }
+};
+
 struct RunTestsSummary {
   // The number of passed tests among the run tests.
   int passed_tests;
@@ -115,6 +146,18 @@ class EventHandler {
   // Called when a disabled test case is encountered.
   virtual void TestCaseDisabled(const TestCase&) {}
 
+  // Called after TestCaseEnd with the time the test case took to run,
+  // including its fixture's setup and teardown. Only called if a test clock is
+  // registered.
+  virtual void TestCaseElapsed(const TestCase&, const ElapsedTime&) {}
+
+  // Called after the last test case of a run of consecutive test cases from
+  // the same suite, with the total time they took to run. Suites whose test
+  // cases are not defined consecutively are reported once per run. Only
+  // called if a test clock is registered.
+  virtual void TestSuiteElapsed(const char* /* suite_name */,
+                                const ElapsedTime&) {}
+
   // Called after each expect/assert statement within a test case with the
   // result of the expectation.
   virtual void TestCaseExpect(const TestCase& test_case,
@@ -125,5 +168,9 @@ class EventHandler {
 // to receive test output.
 void RegisterEventHandler(EventHandler* event_handler);
 
+// Sets the clock with which to time test cases. Test cases are not timed
+// unless a clock is registered. Must be called before RUN_ALL_TESTS().
+void RegisterTestClock(const TestClock& clock);
+
 }  // namespace unit_test
 }  // namespace pw
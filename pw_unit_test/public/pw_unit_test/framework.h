@@ -164,6 +164,12 @@ class Framework {
                            .disabled_tests = 0},
         exit_status_(0),
         event_handler_(nullptr),
+        clock_{.now = nullptr, .ticks_per_second = 0},
+        test_start_time_(0),
+        suite_name_(nullptr),
+        suite_elapsed_ticks_(0),
+        shard_index_(0),
+        shard_count_(1),
         memory_pool_() {}
 
   static Framework& Get() { return framework_; }
@@ -178,6 +184,9 @@ class Framework {
     event_handler_ = event_handler;
   }
 
+  // Sets the clock with which to time test cases.
+  void RegisterTestClock(const TestClock& clock) { clock_ = clock; }
+
   // Runs all registered test cases, returning a status of 0 if all succeeded or
   // nonzero if there were any failures. Test events that occur during the run
   // are sent to the registered event handler, if any.
@@ -190,8 +199,24 @@ class Framework {
   void SetTestSuitesToRun(std::span<std::string_view> test_suites) {
     test_suites_to_run_ = test_suites;
   }
+
+  // Only run tests whose full names match a Googletest-style filter during the
+  // next test run. The filter must outlive the test run. This is C++17 only.
+  void SetTestFilter(std::string_view filter) { filter_ = filter; }
 #endif  // PW_CXX_STANDARD_IS_SUPPORTED(17)
 
+  // Only run the tests assigned to one of shard_count shards during the next
+  // test run. Returns false and leaves sharding unchanged if the index is not
+  // less than the count.
+  bool SetTestShard(uint32_t shard_index, uint32_t shard_count) {
+    if (shard_index >= shard_count) {
+      return false;
+    }
+    shard_index_ = shard_index;
+    shard_count_ = shard_count;
+    return true;
+  }
+
   bool ShouldRunTest(const TestInfo& test_info);
 
   // Constructs an instance of a unit test class and runs the test.
@@ -275,6 +300,10 @@ class Framework {
   // Dispatches event indicating that a test finished and clears current_test_.
   void EndCurrentTest();
 
+  // Dispatches the elapsed time of the current suite if the next test to run is
+  // in a different suite, or if there is no next test.
+  void EndSuiteIfChanged(const TestInfo* next_test);
+
   // Singleton instance of the framework class.
   static Framework framework_;
 
@@ -297,8 +326,27 @@ class Framework {
   // Handler to which to dispatch test events.
   EventHandler* event_handler_;
 
+  // Clock with which to time tests, if now is set.
+  TestClock clock_;
+
+  // When the current test case started and the suite it belongs to, and the
+  // total time of the consecutive test cases run from that suite.
+  int64_t test_start_time_;
+  const char* suite_name_;
+  int64_t suite_elapsed_ticks_;
+
+  // Tests are assigned to shards by their position in the list of registered
+  // tests, so every test is reported by exactly one shard.
+  uint32_t shard_index_;
+  uint32_t shard_count_;
+
 #if PW_CXX_STANDARD_IS_SUPPORTED(17)
   std::span<std::string_view> test_suites_to_run_;
+  std::string_view filter_;
+#else
+  // The framework is built as C++17, but tests may be compiled as C++14.
+  // Reserve space for the C++17-only members so that the layout matches.
+  const void* cpp17_members_[4] = {};
 #endif  // PW_CXX_STANDARD_IS_SUPPORTED(17)
 
   std::aligned_storage_t<config::kMemoryPoolSize, alignof(std::max_align_t)>
@@ -398,8 +446,31 @@ class Test {
 inline void SetTestSuitesToRun(std::span<std::string_view> test_suites) {
   internal::Framework::Get().SetTestSuitesToRun(test_suites);
 }
+
+// Sets a Googletest-style filter of the tests to run. The filter is a
+// ':'-separated list of patterns matched against "Suite.Name", optionally
+// followed by '-' and a list of patterns to exclude. Patterns may use '*' to
+// match any string and '?' to match any character. The filter is not copied.
+inline void SetTestFilter(std::string_view filter) {
+  internal::Framework::Get().SetTestFilter(filter);
+}
+
+namespace internal {
+
+// Returns whether a test matches a filter in the format used by SetTestFilter.
+bool TestMatchesFilter(std::string_view filter, const TestCase& test_case);
+
+}  // namespace internal
 #endif  // PW_CXX_STANDARD_IS_SUPPORTED(17)
 
+// Splits the tests into shard_count shards and runs only the tests in
+// shard_index. Running every shard runs every test exactly once, and the run
+// summaries of the shards add up to the summary of an unsharded run. Returns
+// false if shard_index is not less than shard_count.
+inline bool SetTestShard(uint32_t shard_index, uint32_t shard_count) {
+  return internal::Framework::Get().SetTestShard(shard_index, shard_count);
+}
+
 }  // namespace unit_test
 }  // namespace pw
 
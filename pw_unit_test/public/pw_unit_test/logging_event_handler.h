@@ -31,6 +31,10 @@ class LoggingEventHandler : public EventHandler {
   void TestCaseExpect(const TestCase& test_case,
                       const TestExpectation& expectation) override;
   void TestCaseDisabled(const TestCase& test_case) override;
+  void TestCaseElapsed(const TestCase& test_case,
+                       const ElapsedTime& elapsed) override;
+  void TestSuiteElapsed(const char* suite_name,
+                        const ElapsedTime& elapsed) override;
 
  private:
   bool verbose_;
@@ -32,6 +32,12 @@ namespace pw::unit_test {
 //     at ../path/to/my/file_test.cc:4831
 //   <<< Test MyTestSuite.TestCase1 failed
 //
+// If a test clock is registered, the time taken by each test case and suite is
+// written in microseconds:
+//
+//   [   TIME   ] MyTestSuite.TestCase1 1234 us
+//   [   TIME   ] MyTestSuite 5678 us
+//
 class SimplePrintingEventHandler : public EventHandler {
  public:
   // Function for writing output as a string.
@@ -51,6 +57,10 @@ class SimplePrintingEventHandler : public EventHandler {
   void TestCaseExpect(const TestCase& test_case,
                       const TestExpectation& expectation) override;
   void TestCaseDisabled(const TestCase& test_case) override;
+  void TestCaseElapsed(const TestCase& test_case,
+                       const ElapsedTime& elapsed) override;
+  void TestSuiteElapsed(const char* suite_name,
+                        const ElapsedTime& elapsed) override;
 
  private:
   void WriteLine(const char* format, ...) PW_PRINTF_FORMAT(2, 3);
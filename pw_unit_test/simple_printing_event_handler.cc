@@ -66,6 +66,21 @@ void SimplePrintingEventHandler::TestCaseExpect(
   write_(expectation.evaluated_expression, true);
 }
 
+void SimplePrintingEventHandler::TestCaseElapsed(const TestCase& test_case,
+                                                 const ElapsedTime& elapsed) {
+  WriteLine("[   TIME   ] %s.%s %lld us",
+            test_case.suite_name,
+            test_case.test_name,
+            static_cast<long long>(elapsed.microseconds()));
+}
+
+void SimplePrintingEventHandler::TestSuiteElapsed(const char* suite_name,
+                                                  const ElapsedTime& elapsed) {
+  WriteLine("[   TIME   ] %s %lld us",
+            suite_name,
+            static_cast<long long>(elapsed.microseconds()));
+}
+
 void SimplePrintingEventHandler::WriteLine(const char* format, ...) {
   va_list args;
 
@@ -70,6 +70,7 @@ size_t pw_varint_ZigZagEncodedSize(int64_t integer);
 
 }  // extern "C"
 
+#include <limits>
 #include <span>
 #include <type_traits>
 
@@ -163,6 +164,22 @@ inline size_t Decode(const std::span<const std::byte>& input, uint64_t* value) {
   return pw_varint_Decode(input.data(), input.size(), value);
 }
 
+// Decodes consecutive varints, such as the values of a packed repeated protobuf
+// field, into output. Decoding stops when the input is exhausted, the output is
+// full, or a varint fails to decode. Returns the number of values decoded and
+// sets bytes_read to the number of input bytes they occupied. If fewer than
+// output.size() values were decoded and bytes_read is less than input.size(),
+// the input contains an invalid or truncated varint.
+//
+// The int64_t overload ZigZag decodes the values.
+size_t DecodeMany(std::span<const std::byte> input,
+                  std::span<uint64_t> output,
+                  size_t* bytes_read);
+
+size_t DecodeMany(std::span<const std::byte> input,
+                  std::span<int64_t> output,
+                  size_t* bytes_read);
+
 enum class Format {
   kZeroTerminatedLeastSignificant = PW_VARINT_ZERO_TERMINATED_LEAST_SIGNIFICANT,
   kZeroTerminatedMostSignificant = PW_VARINT_ZERO_TERMINATED_MOST_SIGNIFICANT,
@@ -15,6 +15,7 @@
 #include "pw_varint/varint.h"
 
 #include <algorithm>
+#include <cstring>
 
 namespace pw {
 namespace varint {
@@ -28,58 +29,13 @@ inline bool LeastSignificant(pw_varint_Format format) {
   return (static_cast<unsigned>(format) & 0b01) == 0;
 }
 
-}  // namespace
-
-extern "C" size_t pw_varint_EncodeCustom(uint64_t integer,
-                                         void* output,
-                                         size_t output_size,
-                                         pw_varint_Format format) {
-  size_t written = 0;
-  std::byte* buffer = static_cast<std::byte*>(output);
-
-  int value_shift = LeastSignificant(format) ? 1 : 0;
-  int term_shift = value_shift == 1 ? 0 : 7;
-
-  std::byte cont, term;
-  if (ZeroTerminated(format)) {
-    cont = std::byte(0x01) << term_shift;
-    term = std::byte(0x00) << term_shift;
-  } else {
-    cont = std::byte(0x00) << term_shift;
-    term = std::byte(0x01) << term_shift;
-  }
-
-  do {
-    if (written >= output_size) {
-      return 0;
-    }
-
-    bool last_byte = (integer >> 7) == 0u;
-
-    // Grab 7 bits and set the eighth according to the continuation bit.
-    std::byte value = (static_cast<std::byte>(integer) & std::byte(0x7f))
-                      << value_shift;
-
-    if (last_byte) {
-      value |= term;
-    } else {
-      value |= cont;
-    }
-
-    buffer[written++] = value;
-    integer >>= 7;
-  } while (integer != 0u);
-
-  return written;
-}
-
-extern "C" size_t pw_varint_DecodeCustom(const void* input,
-                                         size_t input_size,
-                                         uint64_t* output,
-                                         pw_varint_Format format) {
+// Decodes a varint in any format one byte at a time.
+size_t DecodeBytewise(const std::byte* buffer,
+                      size_t input_size,
+                      uint64_t* output,
+                      pw_varint_Format format) {
   uint64_t decoded_value = 0;
   uint_fast8_t count = 0;
-  const std::byte* buffer = static_cast<const std::byte*>(input);
 
   // The largest 64-bit ints require 10 B.
   const size_t max_count = std::min(kMaxVarint64SizeBytes, input_size);
@@ -121,6 +77,178 @@ extern "C" size_t pw_varint_DecodeCustom(const void* input,
   return count;
 }
 
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+// Packs the low 7 bits of each byte of a little-endian word into a 56-bit
+// value: 7 bits per 8, then 14 per 16, then 28 per 32.
+constexpr uint64_t PackSevenBitGroups(uint64_t word) {
+  word &= 0x7f7f7f7f7f7f7f7fu;
+  word = ((word & 0x7f007f007f007f00u) >> 1) | (word & 0x007f007f007f007fu);
+  word = ((word & 0x3fff00003fff0000u) >> 2) | (word & 0x00003fff00003fffu);
+  word = ((word & 0x0fffffff00000000u) >> 4) | (word & 0x000000000fffffffu);
+  return word;
+}
+
+#endif  // __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+// Decodes a protobuf-style varint (zero-terminated, continuation bit in the
+// most significant bit). Most varints are 1 or 2 bytes, so those are decoded
+// directly. Longer varints are decoded from a single 8-byte load when enough
+// input remains.
+inline size_t DecodeProtobufFormat(const std::byte* buffer,
+                                   size_t input_size,
+                                   uint64_t* output) {
+  if (input_size == 0u) {
+    return 0;
+  }
+
+  const uint32_t byte0 = static_cast<uint32_t>(buffer[0]);
+  if ((byte0 & 0x80u) == 0u) {
+    *output = byte0;
+    return 1;
+  }
+
+  if (input_size >= 2u) {
+    const uint32_t byte1 = static_cast<uint32_t>(buffer[1]);
+    if ((byte1 & 0x80u) == 0u) {
+      *output = (byte0 & 0x7fu) | (byte1 << 7);
+      return 2;
+    }
+  }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  if (input_size >= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, buffer, sizeof(word));
+
+    // The lowest clear continuation bit marks the last byte.
+    const uint64_t last_bytes = ~word & 0x8080808080808080u;
+    if (last_bytes != 0u) {
+      // Keep the bytes up to and including the last byte.
+      *output = PackSevenBitGroups(word & (last_bytes ^ (last_bytes - 1)));
+      return static_cast<size_t>(__builtin_ctzll(last_bytes)) / 8 + 1;
+    }
+
+    // The first 8 bytes all continue, so finish with the last 2 bytes.
+    uint64_t value = PackSevenBitGroups(word);
+    const size_t max_count = std::min(kMaxVarint64SizeBytes, input_size);
+    for (size_t i = sizeof(word); i < max_count; ++i) {
+      const uint64_t byte = static_cast<uint64_t>(buffer[i]);
+      value |= (byte & 0x7fu) << (7 * i);
+      if ((byte & 0x80u) == 0u) {
+        *output = value;
+        return i + 1;
+      }
+    }
+    return 0;
+  }
+#endif  // __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+  return DecodeBytewise(
+      buffer, input_size, output, PW_VARINT_ZERO_TERMINATED_MOST_SIGNIFICANT);
+}
+
+}  // namespace
+
+extern "C" size_t pw_varint_EncodeCustom(uint64_t integer,
+                                         void* output,
+                                         size_t output_size,
+                                         pw_varint_Format format) {
+  std::byte* buffer = static_cast<std::byte*>(output);
+
+  // Checking the size up front removes the bounds check from the loop and
+  // leaves the output untouched if the varint doesn't fit.
+  const size_t size = EncodedSize(integer);
+  if (size > output_size) {
+    return 0;
+  }
+
+  // Protobuf varints need no shifting or masking of the value bits.
+  if (format == PW_VARINT_ZERO_TERMINATED_MOST_SIGNIFICANT) {
+    for (size_t i = 0; i < size - 1; ++i) {
+      buffer[i] = static_cast<std::byte>(integer | 0x80u);
+      integer >>= 7;
+    }
+    buffer[size - 1] = static_cast<std::byte>(integer);
+    return size;
+  }
+
+  int value_shift = LeastSignificant(format) ? 1 : 0;
+  int term_shift = value_shift == 1 ? 0 : 7;
+
+  std::byte cont, term;
+  if (ZeroTerminated(format)) {
+    cont = std::byte(0x01) << term_shift;
+    term = std::byte(0x00) << term_shift;
+  } else {
+    cont = std::byte(0x00) << term_shift;
+    term = std::byte(0x01) << term_shift;
+  }
+
+  // Grab 7 bits at a time and set the eighth according to the continuation
+  // bit.
+  for (size_t i = 0; i < size - 1; ++i) {
+    buffer[i] = ((static_cast<std::byte>(integer) & std::byte(0x7f))
+                 << value_shift) |
+                cont;
+    integer >>= 7;
+  }
+  buffer[size - 1] =
+      ((static_cast<std::byte>(integer) & std::byte(0x7f)) << value_shift) |
+      term;
+
+  return size;
+}
+
+extern "C" size_t pw_varint_DecodeCustom(const void* input,
+                                         size_t input_size,
+                                         uint64_t* output,
+                                         pw_varint_Format format) {
+  const std::byte* buffer = static_cast<const std::byte*>(input);
+
+  // Protobuf varints take a faster path.
+  if (format == PW_VARINT_ZERO_TERMINATED_MOST_SIGNIFICANT) {
+    return DecodeProtobufFormat(buffer, input_size, output);
+  }
+
+  return DecodeBytewise(buffer, input_size, output, format);
+}
+
+size_t DecodeMany(std::span<const std::byte> input,
+                  std::span<uint64_t> output,
+                  size_t* bytes_read) {
+  size_t read = 0;
+  size_t count = 0;
+
+  while (count < output.size() && read < input.size()) {
+    const size_t bytes = DecodeProtobufFormat(
+        input.data() + read, input.size() - read, &output[count]);
+    if (bytes == 0u) {
+      break;
+    }
+    read += bytes;
+    count += 1;
+  }
+
+  *bytes_read = read;
+  return count;
+}
+
+size_t DecodeMany(std::span<const std::byte> input,
+                  std::span<int64_t> output,
+                  size_t* bytes_read) {
+  // Decode in place, then ZigZag decode each value.
+  const size_t count = DecodeMany(
+      input,
+      std::span(reinterpret_cast<uint64_t*>(output.data()), output.size()),
+      bytes_read);
+
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = ZigZagDecode(static_cast<uint64_t>(output[i]));
+  }
+  return count;
+}
+
 // TODO(frolv): Remove this deprecated alias.
 extern "C" size_t pw_VarintEncode(uint64_t integer,
                                   void* output,
@@ -17,7 +17,9 @@
 #include <cinttypes>
 #include <cstdint>
 #include <cstring>
+#include <iterator>
 #include <limits>
+#include <span>
 
 #include "gtest/gtest.h"
 
@@ -1078,5 +1080,101 @@ TEST(Varint, MaxValueInBytes) {
   static_assert(MaxValueInBytes(100) == std::numeric_limits<uint64_t>::max());
 }
 
+TEST(Varint, Decode_AllSizesWithTrailingData) {
+  // Decode each size of varint at the start of a large buffer, which takes the
+  // 8-byte load path, and in a buffer of exactly its size.
+  for (size_t size = 1; size <= kMaxVarint64SizeBytes; ++size) {
+    const uint64_t value = MaxValueInBytes(size) - 0x55;
+    std::byte buffer[16];
+    std::memset(buffer, 0xff, sizeof(buffer));
+    ASSERT_EQ(Encode(value, buffer), size);
+
+    uint64_t result = 0;
+    EXPECT_EQ(Decode(std::span(buffer), &result), size);
+    EXPECT_EQ(result, value);
+
+    result = 0;
+    EXPECT_EQ(Decode(std::span(buffer, size), &result), size);
+    EXPECT_EQ(result, value);
+  }
+}
+
+TEST(Varint, Decode_UnterminatedLongInput_Fails) {
+  std::byte buffer[16];
+  std::memset(buffer, 0x80, sizeof(buffer));
+
+  uint64_t result = 0;
+  EXPECT_EQ(Decode(std::span(buffer), &result), 0u);
+  EXPECT_EQ(Decode(std::span(buffer, 8), &result), 0u);
+  EXPECT_EQ(Decode(std::span(buffer, 2), &result), 0u);
+}
+
+TEST(Varint, Encode_DoesNotFit_LeavesOutputUnchanged) {
+  std::byte buffer[2] = {std::byte{'a'}, std::byte{'b'}};
+
+  EXPECT_EQ(Encode(UINT32_C(0x1fffff), buffer), 0u);
+  EXPECT_EQ(buffer[0], std::byte{'a'});
+  EXPECT_EQ(buffer[1], std::byte{'b'});
+}
+
+TEST(Varint, DecodeMany_Unsigned) {
+  constexpr uint64_t kValues[] = {
+      0, 1, 127, 128, 300, 0x1fffff, 0xffffffff, UINT64_MAX};
+  std::byte buffer[64];
+  size_t size = 0;
+  for (uint64_t value : kValues) {
+    size += Encode(value, std::span(buffer).subspan(size));
+  }
+
+  uint64_t results[std::size(kValues)] = {};
+  size_t bytes_read = 0;
+  ASSERT_EQ(DecodeMany(std::span(buffer, size), results, &bytes_read),
+            std::size(kValues));
+  EXPECT_EQ(bytes_read, size);
+  for (size_t i = 0; i < std::size(kValues); ++i) {
+    EXPECT_EQ(results[i], kValues[i]);
+  }
+}
+
+TEST(Varint, DecodeMany_Signed) {
+  constexpr int64_t kValues[] = {0, -1, 1, -64, 64, INT64_MIN, INT64_MAX};
+  std::byte buffer[64];
+  size_t size = 0;
+  for (int64_t value : kValues) {
+    size += Encode(value, std::span(buffer).subspan(size));
+  }
+
+  int64_t results[std::size(kValues)] = {};
+  size_t bytes_read = 0;
+  ASSERT_EQ(DecodeMany(std::span(buffer, size), results, &bytes_read),
+            std::size(kValues));
+  EXPECT_EQ(bytes_read, size);
+  for (size_t i = 0; i < std::size(kValues); ++i) {
+    EXPECT_EQ(results[i], kValues[i]);
+  }
+}
+
+TEST(Varint, DecodeMany_StopsWhenOutputFull) {
+  constexpr std::byte kInput[] = {
+      std::byte{1}, std::byte{0x80}, std::byte{1}, std::byte{3}};
+
+  uint64_t results[2] = {};
+  size_t bytes_read = 0;
+  EXPECT_EQ(DecodeMany(kInput, results, &bytes_read), 2u);
+  EXPECT_EQ(bytes_read, 3u);
+  EXPECT_EQ(results[0], 1u);
+  EXPECT_EQ(results[1], 128u);
+}
+
+TEST(Varint, DecodeMany_StopsAtTruncatedVarint) {
+  constexpr std::byte kInput[] = {std::byte{5}, std::byte{0x80}};
+
+  uint64_t results[4] = {};
+  size_t bytes_read = 0;
+  EXPECT_EQ(DecodeMany(kInput, results, &bytes_read), 1u);
+  EXPECT_EQ(bytes_read, 1u);
+  EXPECT_EQ(results[0], 5u);
+}
+
 }  // namespace
 }  // namespace pw::varint
@@ -13,4 +13,6 @@
 // the License.
 
 export {default as DeviceTransport} from './src/transport/device_transport';
+export * from './src/transport/frame_decoder_worker';
 export * from './src/transport/web_serial_transport';
+export * from './src/transport/worker_frame_decoder';
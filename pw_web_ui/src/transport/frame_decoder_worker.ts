@@ -0,0 +1,58 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+/* eslint-env browser */
+import {Decoder} from '@pigweed/pw_hdlc';
+
+/** A valid HDLC frame, as posted by serveFrameDecoder(). */
+export interface DecodedFrame {
+  address: number;
+  control: Uint8Array;
+  data: Uint8Array;
+}
+
+/** The part of a Worker, MessagePort or worker global scope that is used. */
+export interface MessageEndpoint {
+  onmessage: ((event: MessageEvent) => void) | null;
+  postMessage(message: unknown, transfer: Transferable[]): void;
+}
+
+/**
+ * Decodes the chunks of bytes posted to the endpoint as HDLC, and posts back
+ * the valid frames completed by each chunk as a single DecodedFrame array.
+ * Frame buffers are transferred rather than copied.
+ *
+ * Call this from a Web Worker, such as frame_decoder_worker_main.ts, and send
+ * chunks to it with a WorkerFrameDecoder so that decoding never runs on the UI
+ * thread.
+ */
+export function serveFrameDecoder(endpoint: MessageEndpoint): void {
+  const decoder = new Decoder();
+
+  endpoint.onmessage = (event: MessageEvent<Uint8Array>) => {
+    const frames: DecodedFrame[] = [];
+    const transfer: Transferable[] = [];
+    for (const frame of decoder.processValidFrames(event.data)) {
+      frames.push({
+        address: frame.address,
+        control: frame.control,
+        data: frame.data,
+      });
+      transfer.push(frame.control.buffer, frame.data.buffer);
+    }
+    if (frames.length > 0) {
+      endpoint.postMessage(frames, transfer);
+    }
+  };
+}
@@ -0,0 +1,73 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+/* eslint-env browser */
+import {Subject, Subscription} from 'rxjs';
+
+import DeviceTransport from './device_transport';
+import {DecodedFrame, MessageEndpoint} from './frame_decoder_worker';
+
+/**
+ * WorkerFrameDecoder decodes the HDLC frames in a transport's chunks on a Web
+ * Worker, and emits the valid frames on the UI thread.
+ *
+ * Each chunk is posted to the worker whole as it arrives, so the UI thread
+ * only copies chunks and receives finished frames; it never processes
+ * individual bytes. The worker must run serveFrameDecoder(), for example by
+ * loading the frame_decoder_worker_main.ts bundle:
+ *
+ *   const decoder = new WorkerFrameDecoder(
+ *     new Worker('frame_decoder_worker_bundle.js')
+ *   );
+ *   decoder.frames.subscribe(frame => handleFrame(frame));
+ *   decoder.connect(transport);
+ */
+export class WorkerFrameDecoder {
+  frames = new Subject<DecodedFrame>();
+  private subscription: Subscription | undefined;
+
+  constructor(private worker: MessageEndpoint) {
+    worker.onmessage = (event: MessageEvent<DecodedFrame[]>) => {
+      for (const frame of event.data) {
+        this.frames.next(frame);
+      }
+    };
+  }
+
+  /**
+   * Decode the chunks received by the transport until disconnect() is called
+   * or another transport is connected.
+   */
+  connect(transport: DeviceTransport): void {
+    this.disconnect();
+    this.subscription = transport.chunks.subscribe(chunk => {
+      this.process(chunk);
+    });
+  }
+
+  /** Stop decoding the connected transport's chunks. */
+  disconnect(): void {
+    this.subscription?.unsubscribe();
+    this.subscription = undefined;
+  }
+
+  /**
+   * Send a chunk to the worker to be decoded. The chunk is copied, so it may
+   * still be used by other subscribers of the transport.
+   * @param {Uint8Array} chunk The chunk to decode
+   */
+  process(chunk: Uint8Array): void {
+    this.worker.postMessage(chunk, []);
+  }
+}
@@ -0,0 +1,83 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+/* eslint-env browser, jasmine */
+import {Encoder} from '@pigweed/pw_hdlc';
+import {Subject} from 'rxjs';
+import {take, toArray} from 'rxjs/operators';
+
+import DeviceTransport from './device_transport';
+import {MessageEndpoint, serveFrameDecoder} from './frame_decoder_worker';
+import {WorkerFrameDecoder} from './worker_frame_decoder';
+
+describe('WorkerFrameDecoder', () => {
+  let channel: MessageChannel;
+  let decoder: WorkerFrameDecoder;
+  let encoder: Encoder;
+
+  beforeEach(() => {
+    // One end of the channel stands in for the worker.
+    channel = new MessageChannel();
+    serveFrameDecoder(channel.port2 as MessageEndpoint);
+    decoder = new WorkerFrameDecoder(channel.port1 as MessageEndpoint);
+    encoder = new Encoder();
+  });
+
+  afterEach(() => {
+    channel.port1.close();
+    channel.port2.close();
+  });
+
+  it('emits frames decoded by the worker', async () => {
+    const frames = decoder.frames.pipe(take(2), toArray()).toPromise();
+
+    decoder.process(encoder.uiFrame(1, new Uint8Array([1, 2, 3])));
+    decoder.process(encoder.uiFrame(2, new Uint8Array([4, 5])));
+
+    const [first, second] = await frames;
+    expect(first.address).toEqual(1);
+    expect(first.data).toEqual(new Uint8Array([1, 2, 3]));
+    expect(second.address).toEqual(2);
+    expect(second.data).toEqual(new Uint8Array([4, 5]));
+  });
+
+  it('decodes frames split across chunks', async () => {
+    const frame = decoder.frames.pipe(take(1)).toPromise();
+
+    const encoded = encoder.uiFrame(3, new Uint8Array([6, 7, 8, 9]));
+    decoder.process(encoded.slice(0, 4));
+    decoder.process(encoded.slice(4));
+
+    const decoded = await frame;
+    expect(decoded.address).toEqual(3);
+    expect(decoded.data).toEqual(new Uint8Array([6, 7, 8, 9]));
+  });
+
+  it('decodes the chunks of a connected transport', async () => {
+    const chunks = new Subject<Uint8Array>();
+    const transport = {chunks} as unknown as DeviceTransport;
+    const frame = decoder.frames.pipe(take(1)).toPromise();
+
+    decoder.connect(transport);
+    chunks.next(encoder.uiFrame(4, new Uint8Array([10])));
+
+    const decoded = await frame;
+    expect(decoded.address).toEqual(4);
+    expect(decoded.data).toEqual(new Uint8Array([10]));
+    expect(chunks.observed).toBeTrue();
+
+    decoder.disconnect();
+    expect(chunks.observed).toBeFalse();
+  });
+});
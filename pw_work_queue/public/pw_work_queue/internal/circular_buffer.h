@@ -18,6 +18,8 @@
 #include <optional>
 #include <span>
 
+#include "pw_assert/assert.h"
+
 namespace pw::work_queue::internal {
 
 // TODO(hepler): Replace this with a std::deque like container.
@@ -0,0 +1,81 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "pw_assert/assert.h"
+
+namespace pw::work_queue::internal {
+
+// A fixed-capacity queue of entries ordered by their deadline member. Entries
+// with the same deadline are popped in the order they were pushed.
+//
+// Entries are kept sorted with the latest deadline first, so the next entry to
+// expire is popped without moving the others. Pushing is linear in the number
+// of entries that expire after the new one.
+template <typename T>
+class DeadlineQueue {
+ public:
+  explicit constexpr DeadlineQueue(std::span<T> buffer)
+      : buffer_(buffer), count_(0) {}
+
+  bool empty() const { return count_ == 0; }
+  bool full() const { return count_ == buffer_.size(); }
+  size_t size() const { return count_; }
+  size_t capacity() const { return buffer_.size(); }
+
+  // The entry with the earliest deadline. The queue must not be empty.
+  const T& front() const {
+    PW_DASSERT(!empty());
+    return buffer_[count_ - 1];
+  }
+
+  bool Push(T&& value) {
+    if (full()) {
+      return false;
+    }
+
+    size_t index = count_;
+    while (index > 0 && buffer_[index - 1].deadline <= value.deadline) {
+      buffer_[index] = std::move(buffer_[index - 1]);
+      --index;
+    }
+    buffer_[index] = std::move(value);
+    ++count_;
+    return true;
+  }
+
+  std::optional<T> Pop() {
+    if (empty()) {
+      return std::nullopt;
+    }
+
+    --count_;
+    return std::move(buffer_[count_]);
+  }
+
+  void Clear() {
+    while (Pop().has_value()) {
+    }
+  }
+
+ private:
+  std::span<T> buffer_;
+  size_t count_;
+};
+
+}  // namespace pw::work_queue::internal
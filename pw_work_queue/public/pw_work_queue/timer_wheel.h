@@ -0,0 +1,196 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_chrono/system_timer.h"
+#include "pw_metric/metric.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+#include "pw_work_queue/work_queue.h"
+
+namespace pw::work_queue {
+
+// A hierarchical timer wheel that multiplexes many software timers over a
+// single pw::chrono::SystemTimer. Arming or cancelling a timer is O(1) and
+// does not touch the underlying timer unless the wheel's next expiry moves
+// earlier. Expired timers are processed in batches on a WorkQueue, so their
+// callbacks run in thread context rather than in the SystemTimer's callback.
+//
+// Time is quantized to ticks of a configurable duration. A timer fires on the
+// first tick at or after its deadline and never early. The wheel has kLevels
+// levels of kSlots slots each; level N holds timers due within
+// kSlots^(N + 1) ticks, which are moved down a level as their deadline nears.
+// Timers further out than the wheel's range are kept on the top level until
+// they come within range.
+//
+// The Timer API is thread safe, but not IRQ safe.
+class TimerWheel {
+ public:
+  using ExpiryCallback = chrono::SystemTimer::ExpiryCallback;
+
+  static constexpr size_t kSlotBits = 5;
+  static constexpr size_t kSlots = size_t{1} << kSlotBits;
+  static constexpr size_t kLevels = 5;
+
+  // A one-shot timer on a TimerWheel, with the same semantics as
+  // pw::chrono::SystemTimer. The callback is invoked from the wheel's work
+  // queue thread with the deadline that was requested.
+  class Timer {
+   public:
+    Timer(TimerWheel& wheel, ExpiryCallback&& callback)
+        : wheel_(wheel),
+          callback_(std::move(callback)),
+          next_(nullptr),
+          link_(nullptr),
+          level_(0),
+          slot_(0),
+          expiry_tick_(0) {}
+
+    ~Timer() { Cancel(); }  // The callback must not be running.
+
+    Timer(const Timer&) = delete;
+    Timer(Timer&&) = delete;
+    Timer& operator=(const Timer&) = delete;
+    Timer& operator=(Timer&&) = delete;
+
+    // Invokes the callback after at least the given delay. Rescheduling a
+    // pending timer replaces its deadline.
+    void InvokeAfter(chrono::SystemClock::duration delay) {
+      InvokeAt(chrono::SystemClock::TimePointAfterAtLeast(delay));
+    }
+
+    // Invokes the callback at or after the given time.
+    void InvokeAt(chrono::SystemClock::time_point deadline) {
+      wheel_.Schedule(*this, deadline);
+    }
+
+    // Cancels the callback if it is pending. Does nothing otherwise.
+    void Cancel() { wheel_.Cancel(*this); }
+
+   private:
+    friend class TimerWheel;
+
+    bool pending() const { return link_ != nullptr; }
+
+    TimerWheel& wheel_;
+    ExpiryCallback callback_;
+
+    // Timers in a slot form a doubly linked list; link_ points to the pointer
+    // that refers to this timer, so it can be unlinked in constant time.
+    Timer* next_;
+    Timer** link_;
+    uint8_t level_;
+    uint8_t slot_;
+
+    int64_t expiry_tick_;
+    chrono::SystemClock::time_point deadline_;
+    chrono::SystemClock::time_point scheduled_at_;
+  };
+
+  // The tick is the wheel's resolution; it should be no finer than the
+  // precision timers actually need, since each tick with expiring timers is a
+  // separate wakeup.
+  TimerWheel(WorkQueue& work_queue, chrono::SystemClock::duration tick);
+
+  // All timers must have been cancelled or have expired, and the wheel's work
+  // queue must not be processing it.
+  ~TimerWheel();
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel(TimerWheel&&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+  TimerWheel& operator=(TimerWheel&&) = delete;
+
+  // Timer statistics for this wheel:
+  //
+  //   scheduled - Number of times a timer was armed.
+  //   expired - Number of timer callbacks invoked.
+  //   cancelled - Number of pending timers cancelled or rescheduled.
+  //   pending - Number of timers currently armed.
+  //   max_pending - Most timers armed at once.
+  //   cascaded - Number of times a timer moved to a lower level.
+  //   batches - Number of times expired timers were processed.
+  //   max_lifetime_us - Longest time between arming a timer and its expiry or
+  //       cancellation.
+  //   max_lateness_us - Longest time between a timer's deadline and its
+  //       callback being invoked.
+  //
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  static constexpr int64_t kNever = INT64_MAX;
+  static constexpr int64_t kRangeTicks = int64_t{1} << (kSlotBits * kLevels);
+
+  void Schedule(Timer& timer, chrono::SystemClock::time_point deadline)
+      PW_LOCKS_EXCLUDED(lock_);
+  void Cancel(Timer& timer) PW_LOCKS_EXCLUDED(lock_);
+
+  // Called from the SystemTimer callback; queues processing of expired timers.
+  void OnSystemTimerExpired();
+
+  // Advances the wheel to the current time on the work queue, invoking the
+  // callbacks of expired timers, then rearms the SystemTimer.
+  void ProcessExpiredTimers() PW_LOCKS_EXCLUDED(lock_);
+
+  // Places a timer in the slot for its expiry tick, relative to current_tick_.
+  void Insert(Timer& timer) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void Unlink(Timer& timer) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Moves the timers in a slot of upper level to lower levels.
+  void Cascade(size_t level, size_t slot) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Returns the next tick after current_tick_ at which a slot needs to be
+  // processed, or kNever if the wheel is empty.
+  int64_t NextEventTick() const PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Arms the SystemTimer for the tick if it is earlier than the armed tick.
+  void ArmForTick(int64_t tick) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  void RecordLifetime(const Timer& timer, chrono::SystemClock::time_point now)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  int64_t CeilTicks(chrono::SystemClock::time_point time) const;
+  int64_t FloorTicks(chrono::SystemClock::time_point time) const;
+
+  WorkQueue& work_queue_;
+  const chrono::SystemClock::duration tick_;
+  chrono::SystemTimer system_timer_;
+  std::atomic<bool> processing_queued_;
+
+  sync::Mutex lock_;
+  int64_t current_tick_ PW_GUARDED_BY(lock_);
+  int64_t armed_tick_ PW_GUARDED_BY(lock_);
+  std::array<uint32_t, kLevels> occupied_ PW_GUARDED_BY(lock_);
+  std::array<std::array<Timer*, kSlots>, kLevels> slots_ PW_GUARDED_BY(lock_);
+
+  PW_METRIC_GROUP(metrics_, "pw::work_queue::TimerWheel");
+  PW_METRIC(metrics_, scheduled_, "scheduled", 0u);
+  PW_METRIC(metrics_, expired_, "expired", 0u);
+  PW_METRIC(metrics_, cancelled_, "cancelled", 0u);
+  PW_METRIC(metrics_, pending_, "pending", 0u);
+  PW_METRIC(metrics_, max_pending_, "max_pending", 0u);
+  PW_METRIC(metrics_, cascaded_, "cascaded", 0u);
+  PW_METRIC(metrics_, batches_, "batches", 0u);
+  PW_METRIC(metrics_, max_lifetime_us_, "max_lifetime_us", 0u);
+  PW_METRIC(metrics_, max_lateness_us_, "max_lateness_us", 0u);
+};
+
+}  // namespace pw::work_queue
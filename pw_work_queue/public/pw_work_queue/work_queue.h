@@ -18,28 +18,61 @@
 #include <cstdint>
 #include <span>
 
+#include "pw_chrono/system_clock.h"
 #include "pw_function/function.h"
 #include "pw_metric/metric.h"
 #include "pw_status/status.h"
 #include "pw_sync/interrupt_spin_lock.h"
 #include "pw_sync/lock_annotations.h"
-#include "pw_sync/thread_notification.h"
+#include "pw_sync/timed_thread_notification.h"
 #include "pw_thread/thread_core.h"
 #include "pw_work_queue/internal/circular_buffer.h"
+#include "pw_work_queue/internal/deadline_queue.h"
 
 namespace pw::work_queue {
 
 using WorkItem = Function<void()>;
 
+// An entry of a WorkQueue's delayed-work storage, which holds work queued with
+// PushWorkAfter() or SchedulePeriodic() until it is due. Its members are only
+// used by the WorkQueue.
+struct DelayedWork {
+  chrono::SystemClock::time_point deadline;
+  chrono::SystemClock::duration period;  // Zero for work that runs once.
+  WorkItem work_item;
+};
+
 // The WorkQueue class enables threads and interrupts to enqueue work as a
 // pw::work_queue::WorkItem for execution by the work queue.
 //
+// Work is queued in two lanes. High-priority work always runs before
+// normal-priority work that has not yet started; work within a lane runs in
+// the order it was queued. The worker thread is only notified when work is
+// pushed into an empty queue, so a burst of pushes results in a single wakeup
+// that drains the whole burst.
+//
+// Work may also be queued to run after a delay or periodically. Delayed work is
+// kept in its own storage, ordered by deadline, and the worker thread sleeps
+// until the earliest deadline, so any number of delayed and periodic jobs share
+// the worker without a timer each. Once due, delayed work runs after queued
+// high-priority work and before queued normal-priority work.
+//
 // The entire API is thread and interrupt safe.
 class WorkQueue : public thread::ThreadCore {
  public:
-  // Note: the ThreadNotification prevents this from being constexpr.
-  explicit WorkQueue(std::span<WorkItem> queue_storage)
-      : stop_requested_(false), circular_buffer_(queue_storage) {}
+  // Note: the TimedThreadNotification prevents this from being constexpr.
+  //
+  // High-priority work may only be pushed if high_priority_queue_storage is
+  // provided, and delayed or periodic work only if delayed_queue_storage is.
+  explicit WorkQueue(std::span<WorkItem> queue_storage,
+                     std::span<WorkItem> high_priority_queue_storage = {},
+                     std::span<DelayedWork> delayed_queue_storage = {})
+      : stop_requested_(false),
+        wakeup_pending_(false),
+        periodic_work_running_(false),
+        circular_buffer_(queue_storage),
+        high_priority_buffer_(high_priority_queue_storage),
+        delayed_queue_(delayed_queue_storage) {}
 
   // Enqueues a work_item for execution by the work queue thread.
   //
@@ -49,7 +82,17 @@ class WorkQueue : public thread::ThreadCore {
   //     longer permitted.
   // ResourceExhausted - internal work queue is full, entry was not enqueued.
   Status PushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_) {
-    return InternalPushWork(std::move(work_item));
+    return InternalPushWork(circular_buffer_, std::move(work_item));
+  }
+
+  // Enqueues a work_item for execution ahead of all queued normal-priority
+  // work. High-priority work is stored separately from normal-priority work,
+  // so it may be queued even if the normal-priority queue is full.
+  //
+  // Returns the same statuses as PushWork(). ResourceExhausted is always
+  // returned if the work queue has no high-priority storage.
+  Status PushHighPriorityWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_) {
+    return InternalPushWork(high_priority_buffer_, std::move(work_item));
   }
 
   // Queue work for execution. Crash if the work cannot be queued due to a
@@ -64,45 +107,121 @@ class WorkQueue : public thread::ThreadCore {
   //     not be in the process of shutting down.
   void CheckPushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
 
+  // The high-priority equivalent of CheckPushWork(), with the same
+  // preconditions.
+  void CheckPushHighPriorityWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+
+  // Enqueues a work_item to run once, no sooner than delay from now. Work that
+  // is not yet due when stop is requested is discarded.
+  //
+  // Returns:
+  // Ok - Success, entry was enqueued for execution.
+  // FailedPrecondition - the work queue is shutting down, entries are no
+  //     longer permitted.
+  // ResourceExhausted - the delayed-work storage is full, or the work queue has
+  //     none; entry was not enqueued.
+  Status PushWorkAfter(chrono::SystemClock::duration delay,
+                       WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+
+  // Runs work_item every period, starting one period from now, until stop is
+  // requested. Each run is scheduled one period after the previous deadline,
+  // so runs do not drift; runs missed because the worker was busy are skipped
+  // rather than run back to back. Periodic work occupies an entry of the
+  // delayed-work storage for as long as the work queue runs.
+  //
+  // Returns the same statuses as PushWorkAfter(), and InvalidArgument if the
+  // period is not positive.
+  Status SchedulePeriodic(chrono::SystemClock::duration period,
+                          WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+
   // Locks the queue to prevent further work enqueing, finishes outstanding
-  // work, then shuts down the worker thread.
+  // work, then shuts down the worker thread. Delayed work which is not yet due
+  // is discarded, and periodic work stops.
   //
   // The WorkQueue cannot be resumed after stopping as the ThreadCore thread
   // returns and may be joined. It must be reconstructed for re-use after
   // the thread has been joined.
   void RequestStop() PW_LOCKS_EXCLUDED(lock_);
 
+  // The queue depth and latency metrics for this work queue:
+  //
+  //   max_queue_used - Most entries queued at once, across both lanes.
+  //   min_queue_remaining - Fewest free entries, across both lanes.
+  //   wakeups - Number of times the worker thread was notified of new work.
+  //   max_wakeup_latency_us - Longest time between work being pushed into an
+  //       empty queue and the worker thread starting to drain it.
+  //
+  metric::Group& metrics() { return metrics_; }
+
  private:
   void Run() override PW_LOCKS_EXCLUDED(lock_);
-  Status InternalPushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+  Status InternalPushWork(internal::CircularBuffer<WorkItem>& buffer,
+                          WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+  Status InternalPushDelayedWork(DelayedWork&& delayed_work)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Waits until work is pushed, stop is requested or delayed work is due.
+  void WaitForWork() PW_LOCKS_EXCLUDED(lock_);
+
+  // Requeues periodic work after it has run.
+  void ReschedulePeriodic(DelayedWork&& delayed_work) PW_LOCKS_EXCLUDED(lock_);
+
+  bool queue_empty() const PW_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    return circular_buffer_.empty() && high_priority_buffer_.empty();
+  }
+
+  bool delayed_work_due(chrono::SystemClock::time_point now) const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    return !delayed_queue_.empty() && delayed_queue_.front().deadline <= now;
+  }
+
+  // Records the wakeup latency if the worker was notified since the last time
+  // it was called.
+  void UpdateWakeupLatency() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   sync::InterruptSpinLock lock_;
   bool stop_requested_ PW_GUARDED_BY(lock_);
+  bool wakeup_pending_ PW_GUARDED_BY(lock_);
+  // Whether the worker is running periodic work, whose entry of the
+  // delayed-work storage stays reserved until it is requeued.
+  bool periodic_work_running_ PW_GUARDED_BY(lock_);
+  chrono::SystemClock::time_point wakeup_requested_at_ PW_GUARDED_BY(lock_);
   internal::CircularBuffer<WorkItem> circular_buffer_ PW_GUARDED_BY(lock_);
-  sync::ThreadNotification work_notification_;
+  internal::CircularBuffer<WorkItem> high_priority_buffer_
+      PW_GUARDED_BY(lock_);
+  internal::DeadlineQueue<DelayedWork> delayed_queue_ PW_GUARDED_BY(lock_);
+  sync::TimedThreadNotification work_notification_;
 
   // TODO(ewout): The group and/or its name token should be passed as a ctor
-  // arg instead. Depending on the approach here the group should be exposed
-  // While doing this evaluate whether perhaps we should instead construct
-  // TypedMetric<uint32_t>s directly, avoiding the macro usage given the
-  // min_queue_remaining_ initial value requires dependency injection.
-  // And lastly when the restructure is finalized add unit tests to ensure these
-  // metrics work as intended.
+  // arg instead. While doing this evaluate whether perhaps we should instead
+  // construct TypedMetric<uint32_t>s directly, avoiding the macro usage given
+  // the min_queue_remaining_ initial value requires dependency injection.
   PW_METRIC_GROUP(metrics_, "pw::work_queue::WorkQueue");
   PW_METRIC(metrics_, max_queue_used_, "max_queue_used", 0u);
   PW_METRIC(metrics_,
             min_queue_remaining_,
             "min_queue_remaining",
-            static_cast<uint32_t>(circular_buffer_.capacity()));
+            static_cast<uint32_t>(circular_buffer_.capacity() +
+                                  high_priority_buffer_.capacity()));
+  PW_METRIC(metrics_, wakeups_, "wakeups", 0u);
+  PW_METRIC(metrics_, max_wakeup_latency_us_, "max_wakeup_latency_us", 0u);
 };
 
-template <size_t kWorkQueueEntries>
+template <size_t kWorkQueueEntries,
+          size_t kHighPriorityWorkQueueEntries = 0,
+          size_t kDelayedWorkQueueEntries = 0>
 class WorkQueueWithBuffer : public WorkQueue {
  public:
-  constexpr WorkQueueWithBuffer() : WorkQueue(queue_storage_) {}
+  constexpr WorkQueueWithBuffer()
+      : WorkQueue(queue_storage_,
+                  high_priority_queue_storage_,
+                  delayed_queue_storage_) {}
 
  private:
   std::array<WorkItem, kWorkQueueEntries> queue_storage_;
+  std::array<WorkItem, kHighPriorityWorkQueueEntries>
+      high_priority_queue_storage_;
+  std::array<DelayedWork, kDelayedWorkQueueEntries> delayed_queue_storage_;
 };
 
 }  // namespace pw::work_queue
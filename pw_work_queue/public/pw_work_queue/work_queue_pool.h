@@ -0,0 +1,153 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread_core.h"
+#include "pw_work_queue/internal/circular_buffer.h"
+#include "pw_work_queue/work_queue.h"
+
+namespace pw::work_queue {
+
+// A pool of workers that run WorkItems on multiple threads.
+//
+// Each worker has its own queue. Work is distributed across the workers'
+// queues round-robin, and a worker whose queue is empty steals work from the
+// other workers' queues, so a worker blocked on a long-running item does not
+// hold up the work queued behind it. Work items may run concurrently and in
+// any order.
+//
+// The pool does not create threads. Each worker is a thread::ThreadCore which
+// must be run on its own thread, created with the options for the thread
+// backend in use. Backend-specific settings, such as core affinity, are
+// provided through those options.
+//
+//   WorkQueuePoolWithBuffer<4, 8> pool;
+//
+//   thread::Thread(worker_options[0], pool.worker(0)).detach();
+//   thread::Thread(worker_options[1], pool.worker(1)).detach();
+//   ...
+//
+// The entire API is thread and interrupt safe.
+class WorkQueuePool {
+ public:
+  class Worker final : public thread::ThreadCore {
+   public:
+    // Workers are set up by the WorkQueuePool that owns them.
+    Worker() : pool_(nullptr), queue_({}), waiting_(false) {}
+
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+
+   private:
+    friend class WorkQueuePool;
+
+    void Run() override;
+
+    WorkQueuePool* pool_;
+    // Guarded by the owning pool's lock_.
+    internal::CircularBuffer<WorkItem> queue_;
+    sync::ThreadNotification notification_;
+    bool waiting_;
+  };
+
+  // The queue storage is divided evenly between the workers.
+  //
+  // Precondition: There is at least one worker.
+  WorkQueuePool(std::span<Worker> workers, std::span<WorkItem> queue_storage);
+
+  WorkQueuePool(const WorkQueuePool&) = delete;
+  WorkQueuePool& operator=(const WorkQueuePool&) = delete;
+
+  // Enqueues a work_item for execution by one of the workers.
+  //
+  // Returns:
+  // Ok - Success, entry was enqueued for execution.
+  // FailedPrecondition - the pool is shutting down, entries are no longer
+  //     permitted.
+  // ResourceExhausted - every worker's queue is full, entry was not enqueued.
+  Status PushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+
+  // Queue work for execution. Crash if the work cannot be queued due to full
+  // queues or a stopped pool. See WorkQueue::CheckPushWork().
+  void CheckPushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+
+  // Prevents further work from being enqueued, finishes all outstanding work,
+  // then returns from every worker's Run() so their threads may be joined.
+  //
+  // As with WorkQueue, the pool cannot be restarted after stopping.
+  void RequestStop() PW_LOCKS_EXCLUDED(lock_);
+
+  size_t worker_count() const { return workers_.size(); }
+
+  // The ThreadCore to run on the worker's thread.
+  thread::ThreadCore& worker(size_t index) { return workers_[index]; }
+
+ private:
+  void RunWorker(Worker& worker) PW_LOCKS_EXCLUDED(lock_);
+
+  // Takes the next item from the worker's own queue or, if it is empty, from
+  // another worker's queue.
+  std::optional<WorkItem> TakeWork(Worker& worker)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Wakes a waiting worker, preferring the one whose queue received work.
+  void WakeWorker(Worker& preferred) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  size_t worker_index(const Worker& worker) const {
+    return static_cast<size_t>(&worker - workers_.data());
+  }
+
+  const std::span<Worker> workers_;
+
+  // A single lock guards every worker's queue, so that stealing never has to
+  // hold more than one lock at a time.
+  sync::InterruptSpinLock lock_;
+  size_t next_worker_ PW_GUARDED_BY(lock_);
+  bool stop_requested_ PW_GUARDED_BY(lock_);
+};
+
+namespace internal {
+
+// The workers must be constructed before the WorkQueuePool sets them up, so
+// WorkQueuePoolWithBuffer inherits its storage from a base class that is
+// initialized first.
+template <size_t kWorkers, size_t kEntriesPerWorker>
+struct WorkQueuePoolStorage {
+  std::array<WorkQueuePool::Worker, kWorkers> workers;
+  std::array<WorkItem, kWorkers * kEntriesPerWorker> queue_storage;
+};
+
+}  // namespace internal
+
+template <size_t kWorkers, size_t kEntriesPerWorker>
+class WorkQueuePoolWithBuffer
+    : private internal::WorkQueuePoolStorage<kWorkers, kEntriesPerWorker>,
+      public WorkQueuePool {
+ public:
+  static_assert(kWorkers > 0u && kEntriesPerWorker > 0u);
+
+  WorkQueuePoolWithBuffer()
+      : WorkQueuePool(this->workers, this->queue_storage) {}
+};
+
+}  // namespace pw::work_queue
@@ -0,0 +1,274 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_work_queue/timer_wheel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+namespace pw::work_queue {
+namespace {
+
+using chrono::SystemClock;
+
+constexpr uint32_t kSlotMask = TimerWheel::kSlots - 1;
+
+constexpr size_t LevelShift(size_t level) {
+  return TimerWheel::kSlotBits * level;
+}
+
+uint32_t ElapsedUs(SystemClock::time_point start, SystemClock::time_point end) {
+  if (end <= start) {
+    return 0;
+  }
+  const int64_t us =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+          .count();
+  return static_cast<uint32_t>(
+      std::min<int64_t>(us, std::numeric_limits<uint32_t>::max()));
+}
+
+}  // namespace
+
+TimerWheel::TimerWheel(WorkQueue& work_queue, SystemClock::duration tick)
+    : work_queue_(work_queue),
+      tick_(tick),
+      system_timer_(
+          [this](SystemClock::time_point) { OnSystemTimerExpired(); }),
+      processing_queued_(false),
+      current_tick_(0),
+      armed_tick_(kNever),
+      occupied_{},
+      slots_{} {
+  PW_CHECK_INT_GT(tick_.count(), 0, "The timer wheel tick must be positive");
+  current_tick_ = FloorTicks(SystemClock::now());
+}
+
+TimerWheel::~TimerWheel() {
+  PW_CHECK_UINT_EQ(pending_.value(),
+                   0u,
+                   "Timers must be cancelled before their wheel is destroyed");
+}
+
+void TimerWheel::Schedule(Timer& timer, SystemClock::time_point deadline) {
+  const SystemClock::time_point now = SystemClock::now();
+  std::lock_guard lock(lock_);
+
+  if (timer.pending()) {
+    Unlink(timer);
+    cancelled_.Increment();
+    RecordLifetime(timer, now);
+  } else {
+    pending_.Increment();
+    max_pending_.Set(std::max(max_pending_.value(), pending_.value()));
+  }
+
+  scheduled_.Increment();
+  timer.deadline_ = deadline;
+  timer.scheduled_at_ = now;
+  timer.expiry_tick_ = CeilTicks(deadline);
+  Insert(timer);
+  ArmForTick(NextEventTick());
+}
+
+void TimerWheel::Cancel(Timer& timer) {
+  std::lock_guard lock(lock_);
+  if (!timer.pending()) {
+    return;
+  }
+
+  // The SystemTimer is left armed. If this was the next timer to expire, the
+  // wheel wakes up once without work to do and rearms for the next timer.
+  Unlink(timer);
+  cancelled_.Increment();
+  pending_.Set(pending_.value() - 1);
+  RecordLifetime(timer, SystemClock::now());
+}
+
+void TimerWheel::OnSystemTimerExpired() {
+  // Expiries that occur while processing is queued are handled by that
+  // processing, since it reads the time when it runs.
+  if (processing_queued_.exchange(true)) {
+    return;
+  }
+  const Status status =
+      work_queue_.PushWork([this] { ProcessExpiredTimers(); });
+  if (!status.ok()) {
+    processing_queued_.store(false);
+    // If the work queue is full, try again on the next tick. If it is
+    // stopping, the timers can no longer expire.
+    if (status.IsResourceExhausted()) {
+      system_timer_.InvokeAfter(tick_);
+    }
+  }
+}
+
+void TimerWheel::ProcessExpiredTimers() {
+  processing_queued_.store(false);
+  const SystemClock::time_point now = SystemClock::now();
+  const int64_t now_tick = FloorTicks(now);
+
+  lock_.lock();
+  batches_.Increment();
+
+  // The SystemTimer has fired, so it must be rearmed below even if it is
+  // rearmed for the same tick.
+  armed_tick_ = kNever;
+
+  for (int64_t tick = NextEventTick(); tick <= now_tick;
+       tick = NextEventTick()) {
+    current_tick_ = tick;
+
+    // Move the timers due within the next rotation of each lower level down.
+    for (size_t level = kLevels - 1; level > 0; --level) {
+      const int64_t level_mask = (int64_t{1} << LevelShift(level)) - 1;
+      if ((tick & level_mask) == 0) {
+        Cascade(level, (tick >> LevelShift(level)) & kSlotMask);
+      }
+    }
+
+    Timer* const* slot = &slots_[0][tick & kSlotMask];
+    while (*slot != nullptr) {
+      Timer& timer = **slot;
+      Unlink(timer);
+
+      // Timers beyond the wheel's range are placed at its end and reinserted
+      // until they are within range.
+      if (timer.expiry_tick_ > tick) {
+        Insert(timer);
+        continue;
+      }
+
+      expired_.Increment();
+      pending_.Set(pending_.value() - 1);
+      RecordLifetime(timer, now);
+      max_lateness_us_.Set(
+          std::max(max_lateness_us_.value(), ElapsedUs(timer.deadline_, now)));
+
+      // The callback may reschedule this or any other timer.
+      const SystemClock::time_point deadline = timer.deadline_;
+      lock_.unlock();
+      timer.callback_(deadline);
+      lock_.lock();
+    }
+  }
+
+  current_tick_ = std::max(current_tick_, now_tick);
+  if (const int64_t next = NextEventTick(); next != kNever) {
+    ArmForTick(next);
+  }
+  lock_.unlock();
+}
+
+void TimerWheel::Insert(Timer& timer) {
+  // The slot for the current tick has already been processed, so timers that
+  // are already due go on the next tick.
+  const int64_t tick = std::clamp(timer.expiry_tick_,
+                                  current_tick_ + 1,
+                                  current_tick_ + kRangeTicks - 1);
+  const int64_t delta = tick - current_tick_;
+
+  size_t level = 0;
+  while (delta >= (int64_t{1} << LevelShift(level + 1))) {
+    level += 1;
+  }
+  const size_t slot = (tick >> LevelShift(level)) & kSlotMask;
+
+  Timer*& head = slots_[level][slot];
+  timer.next_ = head;
+  if (head != nullptr) {
+    head->link_ = &timer.next_;
+  }
+  head = &timer;
+  timer.link_ = &head;
+  timer.level_ = static_cast<uint8_t>(level);
+  timer.slot_ = static_cast<uint8_t>(slot);
+  occupied_[level] |= uint32_t{1} << slot;
+}
+
+void TimerWheel::Unlink(Timer& timer) {
+  *timer.link_ = timer.next_;
+  if (timer.next_ != nullptr) {
+    timer.next_->link_ = timer.link_;
+  }
+  if (slots_[timer.level_][timer.slot_] == nullptr) {
+    occupied_[timer.level_] &= ~(uint32_t{1} << timer.slot_);
+  }
+  timer.next_ = nullptr;
+  timer.link_ = nullptr;
+}
+
+void TimerWheel::Cascade(size_t level, size_t slot) {
+  Timer* timer = slots_[level][slot];
+  slots_[level][slot] = nullptr;
+  occupied_[level] &= ~(uint32_t{1} << slot);
+
+  while (timer != nullptr) {
+    Timer* const next = timer->next_;
+    Insert(*timer);
+    cascaded_.Increment();
+    timer = next;
+  }
+}
+
+int64_t TimerWheel::NextEventTick() const {
+  int64_t next = kNever;
+
+  for (size_t level = 0; level < kLevels; ++level) {
+    const uint32_t occupied = occupied_[level];
+    if (occupied == 0u) {
+      continue;
+    }
+
+    // Find the first occupied slot on this level, counting from the first
+    // slot boundary after the current tick.
+    const size_t shift = LevelShift(level);
+    const int64_t first = (current_tick_ >> shift) + 1;
+    const uint32_t start = first & kSlotMask;
+    const uint32_t rotated =
+        start == 0u ? occupied
+                    : (occupied >> start) | (occupied << (kSlots - start));
+    const int64_t slot_tick = (first + __builtin_ctz(rotated)) << shift;
+    next = std::min(next, slot_tick);
+  }
+  return next;
+}
+
+void TimerWheel::ArmForTick(int64_t tick) {
+  if (tick < armed_tick_) {
+    armed_tick_ = tick;
+    system_timer_.InvokeAt(SystemClock::time_point(tick_ * tick));
+  }
+}
+
+void TimerWheel::RecordLifetime(const Timer& timer,
+                                SystemClock::time_point now) {
+  max_lifetime_us_.Set(
+      std::max(max_lifetime_us_.value(), ElapsedUs(timer.scheduled_at_, now)));
+}
+
+int64_t TimerWheel::CeilTicks(SystemClock::time_point time) const {
+  const int64_t count = std::max<int64_t>(time.time_since_epoch().count(), 0);
+  return (count + tick_.count() - 1) / tick_.count();
+}
+
+int64_t TimerWheel::FloorTicks(SystemClock::time_point time) const {
+  return std::max<int64_t>(time.time_since_epoch().count(), 0) / tick_.count();
+}
+
+}  // namespace pw::work_queue
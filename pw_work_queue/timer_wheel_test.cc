@@ -0,0 +1,237 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_work_queue/timer_wheel.h"
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread.h"
+#include "pw_tokenizer/hash.h"
+#include "pw_work_queue/test_thread.h"
+
+namespace pw::work_queue {
+namespace {
+
+using namespace std::chrono_literals;
+using chrono::SystemClock;
+
+class TimerWheelTest : public ::testing::Test {
+ protected:
+  TimerWheelTest()
+      : wheel_(work_queue_, 1ms),
+        work_thread_(test::WorkQueueThreadOptions(), work_queue_) {}
+
+  ~TimerWheelTest() {
+    work_queue_.RequestStop();
+    work_thread_.join();
+  }
+
+  // Metric names are tokens with the top bit masked off.
+  uint32_t GetMetric(std::string_view name) {
+    const uint32_t token = tokenizer::Hash(name) & 0x7fffffff;
+    for (const metric::Metric& metric : wheel_.metrics().metrics()) {
+      if (metric.name() == token) {
+        return metric.as_int();
+      }
+    }
+    ADD_FAILURE();
+    return 0;
+  }
+
+  WorkQueueWithBuffer<4> work_queue_;
+  TimerWheel wheel_;
+  thread::Thread work_thread_;
+};
+
+// Callbacks capture a single pointer to fit in the default function size.
+struct Expiry {
+  sync::ThreadNotification done;
+  SystemClock::time_point expired_at;
+  SystemClock::time_point deadline;
+  int expirations = 0;
+};
+
+TEST_F(TimerWheelTest, InvokeAt_NotBeforeDeadline) {
+  Expiry expiry;
+  TimerWheel::Timer timer(wheel_, [&expiry](SystemClock::time_point deadline) {
+    expiry.expired_at = SystemClock::now();
+    expiry.deadline = deadline;
+    expiry.done.release();
+  });
+
+  const SystemClock::time_point deadline = SystemClock::now() + 5ms;
+  timer.InvokeAt(deadline);
+  expiry.done.acquire();
+
+  EXPECT_GE(expiry.expired_at, deadline);
+  EXPECT_EQ(expiry.deadline, deadline);
+  EXPECT_EQ(GetMetric("expired"), 1u);
+  EXPECT_EQ(GetMetric("pending"), 0u);
+}
+
+TEST_F(TimerWheelTest, InvokeAt_PastDeadline_ExpiresOnNextTick) {
+  Expiry expiry;
+  TimerWheel::Timer timer(wheel_, [&expiry](SystemClock::time_point deadline) {
+    expiry.deadline = deadline;
+    expiry.done.release();
+  });
+
+  const SystemClock::time_point deadline = SystemClock::now() - 10ms;
+  timer.InvokeAt(deadline);
+  expiry.done.acquire();
+
+  EXPECT_EQ(expiry.deadline, deadline);
+}
+
+TEST_F(TimerWheelTest, Timers_ExpireInDeadlineOrder) {
+  struct {
+    std::array<int, 3> order = {};
+    size_t expired = 0;
+    sync::ThreadNotification done;
+  } context;
+
+  TimerWheel::Timer third(wheel_, [&context](SystemClock::time_point) {
+    context.order[context.expired++] = 3;
+    context.done.release();
+  });
+  TimerWheel::Timer first(wheel_, [&context](SystemClock::time_point) {
+    context.order[context.expired++] = 1;
+  });
+  TimerWheel::Timer second(wheel_, [&context](SystemClock::time_point) {
+    context.order[context.expired++] = 2;
+  });
+
+  third.InvokeAfter(30ms);
+  first.InvokeAfter(2ms);
+  second.InvokeAfter(12ms);
+  context.done.acquire();
+
+  EXPECT_EQ(context.expired, 3u);
+  EXPECT_EQ(context.order, (std::array<int, 3>{1, 2, 3}));
+}
+
+TEST_F(TimerWheelTest, Cancel_PreventsExpiry) {
+  Expiry cancelled_expiry;
+  Expiry sentinel_expiry;
+
+  TimerWheel::Timer cancelled(
+      wheel_, [&cancelled_expiry](SystemClock::time_point) {
+        cancelled_expiry.expirations += 1;
+      });
+  TimerWheel::Timer sentinel(wheel_,
+                             [&sentinel_expiry](SystemClock::time_point) {
+                               sentinel_expiry.done.release();
+                             });
+
+  cancelled.InvokeAfter(2ms);
+  sentinel.InvokeAfter(10ms);
+  cancelled.Cancel();
+  sentinel_expiry.done.acquire();
+
+  EXPECT_EQ(cancelled_expiry.expirations, 0);
+  EXPECT_EQ(GetMetric("cancelled"), 1u);
+  EXPECT_EQ(GetMetric("expired"), 1u);
+}
+
+TEST_F(TimerWheelTest, Reschedule_ReplacesDeadline) {
+  Expiry timer_expiry;
+  Expiry sentinel_expiry;
+
+  TimerWheel::Timer timer(wheel_, [&timer_expiry](SystemClock::time_point) {
+    timer_expiry.expirations += 1;
+  });
+  TimerWheel::Timer sentinel(wheel_,
+                             [&sentinel_expiry](SystemClock::time_point) {
+                               sentinel_expiry.done.release();
+                             });
+
+  timer.InvokeAfter(2ms);
+  sentinel.InvokeAfter(10ms);
+  timer.InvokeAfter(20ms);
+  sentinel_expiry.done.acquire();
+  EXPECT_EQ(timer_expiry.expirations, 0);
+
+  sentinel.InvokeAfter(30ms);
+  sentinel_expiry.done.acquire();
+  EXPECT_EQ(timer_expiry.expirations, 1);
+}
+
+TEST_F(TimerWheelTest, Callback_CanRescheduleItself) {
+  struct {
+    TimerWheel::Timer* timer = nullptr;
+    int expirations = 0;
+    sync::ThreadNotification done;
+  } context;
+
+  TimerWheel::Timer timer(wheel_,
+                          [&context](SystemClock::time_point deadline) {
+                            if (++context.expirations < 3) {
+                              context.timer->InvokeAt(deadline + 2ms);
+                            } else {
+                              context.done.release();
+                            }
+                          });
+  context.timer = &timer;
+
+  timer.InvokeAfter(2ms);
+  context.done.acquire();
+
+  EXPECT_EQ(context.expirations, 3);
+}
+
+TEST_F(TimerWheelTest, DistantTimer_CascadesToLowerLevels) {
+  Expiry expiry;
+  TimerWheel::Timer timer(wheel_, [&expiry](SystemClock::time_point) {
+    expiry.expired_at = SystemClock::now();
+    expiry.done.release();
+  });
+
+  // Beyond the first level of the wheel, which spans kSlots ticks.
+  const SystemClock::time_point deadline =
+      SystemClock::now() + 1ms * (TimerWheel::kSlots + 8);
+  timer.InvokeAt(deadline);
+  expiry.done.acquire();
+
+  EXPECT_GE(expiry.expired_at, deadline);
+  EXPECT_GE(GetMetric("cascaded"), 1u);
+}
+
+TEST_F(TimerWheelTest, ManyTimers_AllExpire) {
+  constexpr int kTimers = 50;
+  Expiry expiry;
+
+  std::array<std::optional<TimerWheel::Timer>, kTimers> timers;
+  for (int i = 0; i < kTimers; ++i) {
+    timers[i].emplace(wheel_, [&expiry](SystemClock::time_point) {
+      if (++expiry.expirations == kTimers) {
+        expiry.done.release();
+      }
+    });
+    timers[i]->InvokeAfter(1ms * (i % 10 + 1));
+  }
+  expiry.done.acquire();
+
+  EXPECT_EQ(expiry.expirations, kTimers);
+  EXPECT_EQ(GetMetric("max_pending"), static_cast<uint32_t>(kTimers));
+  EXPECT_EQ(GetMetric("pending"), 0u);
+}
+
+}  // namespace
+}  // namespace pw::work_queue
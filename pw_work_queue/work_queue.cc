@@ -14,6 +14,9 @@
 
 #include "pw_work_queue/work_queue.h"
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <mutex>
 
 #include "pw_assert/check.h"
@@ -28,19 +31,41 @@ void WorkQueue::RequestStop() {
 
 void WorkQueue::Run() {
   while (true) {
-    work_notification_.acquire();
+    WaitForWork();
 
-    // Drain the work queue.
+    // Drain the work queue: high-priority work first, then delayed work which
+    // is due, then normal-priority work.
     bool stop_requested;
     bool work_remaining;
     do {
       std::optional<WorkItem> possible_work_item;
+      std::optional<DelayedWork> periodic_work;
       {
         std::lock_guard lock(lock_);
-        possible_work_item = circular_buffer_.Pop();
-        work_remaining = !circular_buffer_.empty();
+        UpdateWakeupLatency();
+        const chrono::SystemClock::time_point now = chrono::SystemClock::now();
+        if (!high_priority_buffer_.empty()) {
+          possible_work_item = high_priority_buffer_.Pop();
+        } else if (delayed_work_due(now)) {
+          DelayedWork delayed_work = std::move(delayed_queue_.Pop().value());
+          if (delayed_work.period == chrono::SystemClock::duration::zero()) {
+            possible_work_item = std::move(delayed_work.work_item);
+          } else {
+            periodic_work_running_ = true;
+            periodic_work = std::move(delayed_work);
+          }
+        } else if (!circular_buffer_.empty()) {
+          possible_work_item = circular_buffer_.Pop();
+        }
+        work_remaining = !queue_empty() || delayed_work_due(now);
         stop_requested = stop_requested_;
       }
+      if (periodic_work.has_value()) {
+        PW_CHECK(periodic_work->work_item != nullptr);
+        periodic_work->work_item();
+        ReschedulePeriodic(std::move(periodic_work.value()));
+        continue;
+      }
       if (!possible_work_item.has_value()) {
         continue;  // No work item to process.
       }
@@ -49,19 +74,112 @@ void WorkQueue::Run() {
       work_item();
     } while (work_remaining);
 
-    // Queue was drained, return if we've been requested to stop.
+    // Queue was drained, return if we've been requested to stop. Delayed work
+    // which is not yet due is discarded.
     if (stop_requested) {
+      std::lock_guard lock(lock_);
+      delayed_queue_.Clear();
       return;
     }
   }
 }
 
+void WorkQueue::WaitForWork() {
+  std::optional<chrono::SystemClock::time_point> next_deadline;
+  {
+    std::lock_guard lock(lock_);
+    if (!delayed_queue_.empty()) {
+      next_deadline = delayed_queue_.front().deadline;
+    }
+  }
+
+  // Work pushed after the deadline was read releases the notification, so the
+  // wait below returns and the deadline is read again.
+  if (next_deadline.has_value()) {
+    work_notification_.try_acquire_until(next_deadline.value());
+  } else {
+    work_notification_.acquire();
+  }
+}
+
+void WorkQueue::ReschedulePeriodic(DelayedWork&& delayed_work) {
+  std::lock_guard lock(lock_);
+  periodic_work_running_ = false;
+  if (stop_requested_) {
+    return;
+  }
+
+  // Keep to the original schedule, but skip any runs which were missed rather
+  // than running them back to back.
+  const chrono::SystemClock::time_point now = chrono::SystemClock::now();
+  delayed_work.deadline += delayed_work.period;
+  if (delayed_work.deadline <= now) {
+    delayed_work.deadline = now + delayed_work.period;
+  }
+
+  // The entry was reserved while the work ran, so there is always room.
+  PW_CHECK(delayed_queue_.Push(std::move(delayed_work)));
+}
+
 void WorkQueue::CheckPushWork(WorkItem&& work_item) {
-  PW_CHECK_OK(InternalPushWork(std::move(work_item)),
+  PW_CHECK_OK(PushWork(std::move(work_item)),
               "Failed to push work item into the work queue");
 }
 
-Status WorkQueue::InternalPushWork(WorkItem&& work_item) {
+void WorkQueue::CheckPushHighPriorityWork(WorkItem&& work_item) {
+  PW_CHECK_OK(PushHighPriorityWork(std::move(work_item)),
+              "Failed to push high-priority work item into the work queue");
+}
+
+Status WorkQueue::PushWorkAfter(chrono::SystemClock::duration delay,
+                                WorkItem&& work_item) {
+  return InternalPushDelayedWork({
+      .deadline = chrono::SystemClock::TimePointAfterAtLeast(delay),
+      .period = chrono::SystemClock::duration::zero(),
+      .work_item = std::move(work_item),
+  });
+}
+
+Status WorkQueue::SchedulePeriodic(chrono::SystemClock::duration period,
+                                   WorkItem&& work_item) {
+  if (period <= chrono::SystemClock::duration::zero()) {
+    return Status::InvalidArgument();
+  }
+  return InternalPushDelayedWork({
+      .deadline = chrono::SystemClock::TimePointAfterAtLeast(period),
+      .period = period,
+      .work_item = std::move(work_item),
+  });
+}
+
+Status WorkQueue::InternalPushDelayedWork(DelayedWork&& delayed_work) {
+  std::lock_guard lock(lock_);
+
+  if (stop_requested_) {
+    return Status::FailedPrecondition();
+  }
+
+  // While periodic work runs, its entry is reserved for it to be requeued.
+  const size_t reserved = periodic_work_running_ ? 1 : 0;
+  if (delayed_queue_.size() + reserved >= delayed_queue_.capacity()) {
+    return Status::ResourceExhausted();
+  }
+
+  // The worker only needs to be woken if it is sleeping past the new deadline.
+  const bool notify_worker =
+      delayed_queue_.empty() ||
+      delayed_work.deadline < delayed_queue_.front().deadline;
+
+  delayed_queue_.Push(std::move(delayed_work));
+
+  if (notify_worker) {
+    work_notification_.release();
+  }
+  return OkStatus();
+}
+
+Status WorkQueue::InternalPushWork(internal::CircularBuffer<WorkItem>& buffer,
+                                   WorkItem&& work_item) {
   std::lock_guard lock(lock_);
 
   if (stop_requested_) {
@@ -69,24 +187,55 @@ Status WorkQueue::InternalPushWork(WorkItem&& work_item) {
     return Status::FailedPrecondition();
   }
 
-  if (circular_buffer_.full()) {
+  if (buffer.full()) {
     return Status::ResourceExhausted();
   }
 
-  circular_buffer_.Push(std::move(work_item));
+  // The worker drains the queue until it is empty before waiting again, so it
+  // only needs to be notified when work is pushed into an empty queue.
+  const bool notify_worker = queue_empty();
+
+  buffer.Push(std::move(work_item));
 
   // Update the watermarks for the queue.
-  const uint32_t queue_entries = circular_buffer_.size();
+  const uint32_t queue_entries =
+      circular_buffer_.size() + high_priority_buffer_.size();
   if (queue_entries > max_queue_used_.value()) {
     max_queue_used_.Set(queue_entries);
   }
-  const uint32_t queue_remaining = circular_buffer_.capacity() - queue_entries;
+  const uint32_t queue_remaining = circular_buffer_.capacity() +
+                                   high_priority_buffer_.capacity() -
+                                   queue_entries;
   if (queue_remaining < min_queue_remaining_.value()) {
-    min_queue_remaining_.Set(queue_entries);
+    min_queue_remaining_.Set(queue_remaining);
   }
 
-  work_notification_.release();
+  if (notify_worker) {
+    wakeups_.Increment();
+    if (!wakeup_pending_) {
+      wakeup_pending_ = true;
+      wakeup_requested_at_ = chrono::SystemClock::now();
+    }
+    work_notification_.release();
+  }
   return OkStatus();
 }
 
+void WorkQueue::UpdateWakeupLatency() {
+  if (!wakeup_pending_) {
+    return;
+  }
+  wakeup_pending_ = false;
+
+  const int64_t latency_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          chrono::SystemClock::now() - wakeup_requested_at_)
+          .count();
+  const uint32_t clamped_latency_us = static_cast<uint32_t>(
+      std::min<int64_t>(latency_us, std::numeric_limits<uint32_t>::max()));
+  if (clamped_latency_us > max_wakeup_latency_us_.value()) {
+    max_wakeup_latency_us_.Set(clamped_latency_us);
+  }
+}
+
 }  // namespace pw::work_queue
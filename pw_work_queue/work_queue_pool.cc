@@ -0,0 +1,139 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_work_queue/work_queue_pool.h"
+
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+namespace pw::work_queue {
+
+void WorkQueuePool::Worker::Run() { pool_->RunWorker(*this); }
+
+WorkQueuePool::WorkQueuePool(std::span<Worker> workers,
+                             std::span<WorkItem> queue_storage)
+    : workers_(workers), next_worker_(0), stop_requested_(false) {
+  PW_CHECK(!workers_.empty(), "A WorkQueuePool requires at least one worker");
+
+  const size_t entries_per_worker = queue_storage.size() / workers_.size();
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i].pool_ = this;
+    workers_[i].queue_ = internal::CircularBuffer<WorkItem>(
+        queue_storage.subspan(i * entries_per_worker, entries_per_worker));
+  }
+}
+
+Status WorkQueuePool::PushWork(WorkItem&& work_item) {
+  std::lock_guard lock(lock_);
+
+  if (stop_requested_) {
+    // Entries are not permitted to be enqueued once stop has been requested.
+    return Status::FailedPrecondition();
+  }
+
+  // Start with the next worker in round-robin order, skipping full queues.
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    Worker& worker = workers_[(next_worker_ + i) % workers_.size()];
+    if (worker.queue_.full()) {
+      continue;
+    }
+
+    worker.queue_.Push(std::move(work_item));
+    next_worker_ = (worker_index(worker) + 1) % workers_.size();
+    WakeWorker(worker);
+    return OkStatus();
+  }
+
+  return Status::ResourceExhausted();
+}
+
+void WorkQueuePool::CheckPushWork(WorkItem&& work_item) {
+  PW_CHECK_OK(PushWork(std::move(work_item)),
+              "Failed to push work item into the work queue pool");
+}
+
+void WorkQueuePool::RequestStop() {
+  std::lock_guard lock(lock_);
+  stop_requested_ = true;
+  for (Worker& worker : workers_) {
+    worker.waiting_ = false;
+    worker.notification_.release();
+  }
+}
+
+void WorkQueuePool::RunWorker(Worker& worker) {
+  while (true) {
+    std::optional<WorkItem> possible_work_item;
+    {
+      std::lock_guard lock(lock_);
+      possible_work_item = TakeWork(worker);
+      if (!possible_work_item.has_value()) {
+        // Every queue is empty. Return once stop has been requested, since no
+        // more work can be queued.
+        if (stop_requested_) {
+          return;
+        }
+        worker.waiting_ = true;
+      }
+    }
+
+    if (!possible_work_item.has_value()) {
+      worker.notification_.acquire();
+      continue;
+    }
+
+    WorkItem& work_item = possible_work_item.value();
+    PW_CHECK(work_item != nullptr);
+    work_item();
+  }
+}
+
+std::optional<WorkItem> WorkQueuePool::TakeWork(Worker& worker) {
+  if (!worker.queue_.empty()) {
+    return worker.queue_.Pop();
+  }
+
+  // Steal the oldest item from the next worker with queued work.
+  const size_t index = worker_index(worker);
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker& victim = workers_[(index + i) % workers_.size()];
+    if (!victim.queue_.empty()) {
+      return victim.queue_.Pop();
+    }
+  }
+  return std::nullopt;
+}
+
+void WorkQueuePool::WakeWorker(Worker& preferred) {
+  // If the worker that received the work is busy, wake another worker to
+  // steal it.
+  Worker* to_wake = &preferred;
+  if (!preferred.waiting_) {
+    to_wake = nullptr;
+    for (Worker& worker : workers_) {
+      if (worker.waiting_) {
+        to_wake = &worker;
+        break;
+      }
+    }
+  }
+
+  if (to_wake != nullptr) {
+    to_wake->waiting_ = false;
+    to_wake->notification_.release();
+  }
+}
+
+}  // namespace pw::work_queue
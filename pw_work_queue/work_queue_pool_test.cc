@@ -0,0 +1,126 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_work_queue/work_queue_pool.h"
+
+#include <mutex>
+
+#include "gtest/gtest.h"
+#include "pw_sync/mutex.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/yield.h"
+#include "pw_work_queue/test_thread.h"
+
+namespace pw::work_queue {
+namespace {
+
+TEST(WorkQueuePool, RunsAllWork) {
+  struct {
+    sync::Mutex mutex;
+    int counter = 0;
+  } context;
+
+  WorkQueuePoolWithBuffer<3, 4> pool;
+  thread::Thread thread_0(test::WorkQueueThreadOptions(), pool.worker(0));
+  thread::Thread thread_1(test::WorkQueueThreadOptions(), pool.worker(1));
+  thread::Thread thread_2(test::WorkQueueThreadOptions(), pool.worker(2));
+
+  const int kItems = 300;
+  for (int i = 0; i < kItems; ++i) {
+    // The queues are small, so retry when every worker is behind.
+    while (pool.PushWork([&context] {
+                 std::lock_guard lock(context.mutex);
+                 context.counter += 1;
+               }) == Status::ResourceExhausted()) {
+      this_thread::yield();
+    }
+  }
+
+  // Stopping finishes all outstanding work.
+  pool.RequestStop();
+  thread_0.join();
+  thread_1.join();
+  thread_2.join();
+
+  EXPECT_EQ(context.counter, kItems);
+}
+
+TEST(WorkQueuePool, QueuedWorkRunsWhileAWorkerIsBlocked) {
+  sync::ThreadNotification release_blocked_item;
+  struct {
+    sync::Mutex mutex;
+    int items_run = 0;
+    sync::ThreadNotification done;
+  } context;
+
+  WorkQueuePoolWithBuffer<2, 4> pool;
+  thread::Thread thread_0(test::WorkQueueThreadOptions(), pool.worker(0));
+  thread::Thread thread_1(test::WorkQueueThreadOptions(), pool.worker(1));
+
+  // Queue work on both workers behind an item that blocks one of them. The
+  // other worker must steal it, or the test never finishes.
+  ASSERT_EQ(OkStatus(), pool.PushWork([&release_blocked_item] {
+    release_blocked_item.acquire();
+  }));
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(OkStatus(),
+              pool.PushWork([&context] {
+                std::lock_guard lock(context.mutex);
+                if (++context.items_run == 4) {
+                  context.done.release();
+                }
+              }));
+  }
+
+  context.done.acquire();
+  release_blocked_item.release();
+
+  pool.RequestStop();
+  thread_0.join();
+  thread_1.join();
+}
+
+TEST(WorkQueuePool, WorkerStealsFromOtherQueues) {
+  int counter = 0;
+
+  WorkQueuePoolWithBuffer<3, 2> pool;
+
+  // Work is distributed round-robin, so each worker's queue gets two items.
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_EQ(OkStatus(), pool.PushWork([&counter] { counter += 1; }));
+  }
+  EXPECT_EQ(Status::ResourceExhausted(), pool.PushWork([] {}));
+
+  // Running only the first worker, on this thread, finishes all of the work.
+  pool.RequestStop();
+  pool.worker(0).Start();
+  EXPECT_EQ(counter, 6);
+
+  pool.worker(1).Start();
+  pool.worker(2).Start();
+  EXPECT_EQ(counter, 6);
+}
+
+TEST(WorkQueuePool, PushAfterStop_FailedPrecondition) {
+  WorkQueuePoolWithBuffer<2, 2> pool;
+  pool.RequestStop();
+  EXPECT_EQ(Status::FailedPrecondition(), pool.PushWork([] {}));
+
+  pool.worker(0).Start();
+  pool.worker(1).Start();
+}
+
+}  // namespace
+}  // namespace pw::work_queue
@@ -14,11 +14,18 @@
 
 #include "pw_work_queue/work_queue.h"
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
 #include "gtest/gtest.h"
+#include "pw_chrono/system_clock.h"
 #include "pw_function/function.h"
 #include "pw_log/log.h"
 #include "pw_sync/thread_notification.h"
 #include "pw_thread/thread.h"
+#include "pw_tokenizer/hash.h"
 #include "pw_work_queue/test_thread.h"
 
 namespace pw::work_queue {
@@ -126,7 +133,254 @@ TEST(WorkQueue, PingPongTwoRequestTypesWithExtraRequests) {
   EXPECT_EQ(context_b.counter, kPingPongs);
 }
 
-// TODO(ewout): Add unit tests for the metrics once they have been restructured.
+// Metric names are tokens with the top bit masked off.
+uint32_t GetMetric(WorkQueue& work_queue, std::string_view name) {
+  const uint32_t token = tokenizer::Hash(name) & 0x7fffffff;
+  for (const metric::Metric& metric : work_queue.metrics().metrics()) {
+    if (metric.name() == token) {
+      return metric.as_int();
+    }
+  }
+  ADD_FAILURE();
+  return 0;
+}
+
+// Stopping the queue before running it on the test thread drains all queued
+// work and then returns.
+void DrainOnThisThread(WorkQueue& work_queue) {
+  work_queue.RequestStop();
+  work_queue.Start();
+}
+
+TEST(WorkQueue, HighPriorityWorkRunsFirst) {
+  std::array<int, 5> order = {};
+  size_t count = 0;
+  auto record = [&order, &count](int value) { order[count++] = value; };
+
+  WorkQueueWithBuffer<4, 2> work_queue;
+  ASSERT_EQ(OkStatus(), work_queue.PushWork([&record] { record(1); }));
+  ASSERT_EQ(OkStatus(), work_queue.PushWork([&record] { record(2); }));
+  ASSERT_EQ(OkStatus(),
+            work_queue.PushHighPriorityWork([&record] { record(3); }));
+  ASSERT_EQ(OkStatus(), work_queue.PushWork([&record] { record(4); }));
+  ASSERT_EQ(OkStatus(),
+            work_queue.PushHighPriorityWork([&record] { record(5); }));
+
+  DrainOnThisThread(work_queue);
+
+  ASSERT_EQ(count, 5u);
+  EXPECT_EQ(order, (std::array<int, 5>{3, 5, 1, 2, 4}));
+}
+
+TEST(WorkQueue, HighPriorityWork_QueuedWhenNormalQueueFull) {
+  WorkQueueWithBuffer<1, 1> work_queue;
+  ASSERT_EQ(OkStatus(), work_queue.PushWork([] {}));
+  EXPECT_EQ(Status::ResourceExhausted(), work_queue.PushWork([] {}));
+  EXPECT_EQ(OkStatus(), work_queue.PushHighPriorityWork([] {}));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            work_queue.PushHighPriorityWork([] {}));
+  DrainOnThisThread(work_queue);
+}
+
+TEST(WorkQueue, HighPriorityWork_NoStorage) {
+  WorkQueueWithBuffer<2> work_queue;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            work_queue.PushHighPriorityWork([] {}));
+  DrainOnThisThread(work_queue);
+}
+
+constexpr chrono::SystemClock::duration kShortDelay =
+    chrono::SystemClock::for_at_least(std::chrono::milliseconds(10));
+
+TEST(WorkQueue, PushAfterStop_FailedPrecondition) {
+  WorkQueueWithBuffer<2, 2, 2> work_queue;
+  work_queue.RequestStop();
+  EXPECT_EQ(Status::FailedPrecondition(), work_queue.PushWork([] {}));
+  EXPECT_EQ(Status::FailedPrecondition(),
+            work_queue.PushHighPriorityWork([] {}));
+  EXPECT_EQ(Status::FailedPrecondition(),
+            work_queue.PushWorkAfter(kShortDelay, [] {}));
+  EXPECT_EQ(Status::FailedPrecondition(),
+            work_queue.SchedulePeriodic(kShortDelay, [] {}));
+  work_queue.Start();
+}
+
+TEST(WorkQueue, Metrics_TrackQueueDepth) {
+  WorkQueueWithBuffer<4, 2> work_queue;
+  EXPECT_EQ(GetMetric(work_queue, "min_queue_remaining"), 6u);
+
+  ASSERT_EQ(OkStatus(), work_queue.PushWork([] {}));
+  ASSERT_EQ(OkStatus(), work_queue.PushWork([] {}));
+  ASSERT_EQ(OkStatus(), work_queue.PushHighPriorityWork([] {}));
+
+  EXPECT_EQ(GetMetric(work_queue, "max_queue_used"), 3u);
+  EXPECT_EQ(GetMetric(work_queue, "min_queue_remaining"), 3u);
+
+  DrainOnThisThread(work_queue);
+
+  // The watermarks persist after the queue is drained.
+  EXPECT_EQ(GetMetric(work_queue, "max_queue_used"), 3u);
+  EXPECT_EQ(GetMetric(work_queue, "min_queue_remaining"), 3u);
+}
+
+TEST(WorkQueue, Metrics_CoalescesWakeups) {
+  WorkQueueWithBuffer<10> work_queue;
+
+  // Only the push into the empty queue notifies the worker.
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_EQ(OkStatus(), work_queue.PushWork([] {}));
+  }
+  EXPECT_EQ(GetMetric(work_queue, "wakeups"), 1u);
+
+  DrainOnThisThread(work_queue);
+  EXPECT_EQ(GetMetric(work_queue, "wakeups"), 1u);
+}
+
+TEST(WorkQueue, Metrics_WakeupsWithWorkerThread) {
+  sync::ThreadNotification done;
+  WorkQueueWithBuffer<10> work_queue;
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+
+  const uint32_t kRounds = 10;
+  for (uint32_t i = 0; i < kRounds; ++i) {
+    ASSERT_EQ(OkStatus(), work_queue.PushWork([] {}));
+    ASSERT_EQ(OkStatus(), work_queue.PushWork([&done] { done.release(); }));
+    done.acquire();
+  }
+
+  work_queue.RequestStop();
+  work_thread.join();
+
+  // The first push of each round is into an empty queue. The second push may
+  // or may not find the first still queued, so each round wakes the worker
+  // once or twice.
+  const uint32_t wakeups = GetMetric(work_queue, "wakeups");
+  EXPECT_GE(wakeups, kRounds);
+  EXPECT_LE(wakeups, 2 * kRounds);
+}
+
+TEST(WorkQueue, DelayedWork_RunsAfterDelay) {
+  struct {
+    chrono::SystemClock::time_point ran_at;
+    sync::ThreadNotification done;
+  } context;
+
+  WorkQueueWithBuffer<2, 0, 2> work_queue;
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+
+  const chrono::SystemClock::time_point pushed_at = chrono::SystemClock::now();
+  ASSERT_EQ(OkStatus(), work_queue.PushWorkAfter(kShortDelay, [&context] {
+    context.ran_at = chrono::SystemClock::now();
+    context.done.release();
+  }));
+  context.done.acquire();
+
+  work_queue.RequestStop();
+  work_thread.join();
+
+  EXPECT_GE(context.ran_at - pushed_at, kShortDelay);
+}
+
+TEST(WorkQueue, DelayedWork_RunsInDeadlineOrder) {
+  struct {
+    std::array<int, 4> order = {};
+    size_t count = 0;
+    sync::ThreadNotification done;
+
+    void Record(int value) {
+      order[count++] = value;
+      if (count == order.size()) {
+        done.release();
+      }
+    }
+  } context;
+
+  WorkQueueWithBuffer<2, 0, 4> work_queue;
+  ASSERT_EQ(OkStatus(), work_queue.PushWorkAfter(3 * kShortDelay, [&context] {
+    context.Record(1);
+  }));
+  ASSERT_EQ(OkStatus(), work_queue.PushWorkAfter(kShortDelay, [&context] {
+    context.Record(2);
+  }));
+  ASSERT_EQ(OkStatus(), work_queue.PushWorkAfter(2 * kShortDelay, [&context] {
+    context.Record(3);
+  }));
+  ASSERT_EQ(OkStatus(), work_queue.PushWork([&context] { context.Record(4); }));
+
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+  context.done.acquire();
+  work_queue.RequestStop();
+  work_thread.join();
+
+  EXPECT_EQ(context.order, (std::array<int, 4>{4, 2, 3, 1}));
+}
+
+TEST(WorkQueue, DelayedWork_NoStorage) {
+  WorkQueueWithBuffer<2, 2> work_queue;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            work_queue.PushWorkAfter(kShortDelay, [] {}));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            work_queue.SchedulePeriodic(kShortDelay, [] {}));
+  DrainOnThisThread(work_queue);
+}
+
+TEST(WorkQueue, DelayedWork_StorageFull) {
+  WorkQueueWithBuffer<2, 0, 2> work_queue;
+  ASSERT_EQ(OkStatus(), work_queue.PushWorkAfter(kShortDelay, [] {}));
+  ASSERT_EQ(OkStatus(), work_queue.SchedulePeriodic(kShortDelay, [] {}));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            work_queue.PushWorkAfter(kShortDelay, [] {}));
+
+  // Delayed work is stored separately from immediate work.
+  EXPECT_EQ(OkStatus(), work_queue.PushWork([] {}));
+  DrainOnThisThread(work_queue);
+}
+
+TEST(WorkQueue, DelayedWork_NotDueWhenStopped_Discarded) {
+  bool ran = false;
+  WorkQueueWithBuffer<2, 0, 2> work_queue;
+  ASSERT_EQ(OkStatus(),
+            work_queue.PushWorkAfter(
+                chrono::SystemClock::for_at_least(std::chrono::hours(1)),
+                [&ran] { ran = true; }));
+
+  DrainOnThisThread(work_queue);
+  EXPECT_FALSE(ran);
+}
+
+TEST(WorkQueue, Periodic_RunsUntilStopped) {
+  struct {
+    int runs = 0;
+    sync::ThreadNotification done;
+  } context;
+
+  WorkQueueWithBuffer<2, 0, 1> work_queue;
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+
+  ASSERT_EQ(OkStatus(), work_queue.SchedulePeriodic(kShortDelay, [&context] {
+    if (++context.runs == 3) {
+      context.done.release();
+    }
+  }));
+  context.done.acquire();
+
+  // The periodic work keeps its entry between runs, so the storage is full.
+  EXPECT_EQ(Status::ResourceExhausted(),
+            work_queue.PushWorkAfter(kShortDelay, [] {}));
+
+  work_queue.RequestStop();
+  work_thread.join();
+
+  EXPECT_GE(context.runs, 3);
+}
+
+TEST(WorkQueue, Periodic_InvalidPeriod) {
+  WorkQueueWithBuffer<2, 0, 2> work_queue;
+  EXPECT_EQ(Status::InvalidArgument(),
+            work_queue.SchedulePeriodic(chrono::SystemClock::duration::zero(),
+                                        [] {}));
+  DrainOnThisThread(work_queue);
+}
 
 }  // namespace
 }  // namespace pw::work_queue
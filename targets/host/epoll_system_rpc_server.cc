@@ -0,0 +1,379 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// pw_rpc system server backend for Linux that serves many socket connections
+// from a single thread with epoll.
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+#include "pw_assert/check.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_hdlc/rpc_packets.h"
+#include "pw_log/log.h"
+#include "pw_result/result.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/synchronized_channel_output.h"
+#include "pw_rpc_system_server/rpc_server.h"
+#include "pw_status/try.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_stream/stream.h"
+#include "pw_sync/mutex.h"
+
+// The maximum number of simultaneous client connections.
+#ifndef PW_RPC_SYSTEM_SERVER_EPOLL_MAX_CONNECTIONS
+#define PW_RPC_SYSTEM_SERVER_EPOLL_MAX_CONNECTIONS 256
+#endif  // PW_RPC_SYSTEM_SERVER_EPOLL_MAX_CONNECTIONS
+
+namespace pw::rpc::system_server {
+namespace {
+
+constexpr size_t kMaxTransmissionUnit = 512;
+constexpr size_t kMaxConnections = PW_RPC_SYSTEM_SERVER_EPOLL_MAX_CONNECTIONS;
+
+// Bytes read from a socket per readiness event. Each connection gets one read
+// per event so that a busy client cannot starve the others.
+constexpr size_t kReadSizeBytes = 4096;
+constexpr size_t kMaxEventsPerWait = 64;
+
+constexpr int kInvalidFd = -1;
+
+// epoll user data for the listening socket. Connections use their index.
+constexpr uint64_t kListenerId = std::numeric_limits<uint64_t>::max();
+
+uint16_t socket_port = 33000;
+int listen_fd = kInvalidFd;
+int epoll_fd = kInvalidFd;
+
+// Writes to a connected socket. Reads are done by the event loop.
+class SocketWriter : public stream::NonSeekableWriter {
+ public:
+  void set_fd(int fd) { fd_ = fd; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    while (!data.empty()) {
+      const ssize_t sent = send(fd_, data.data(), data.size(), MSG_NOSIGNAL);
+      if (sent < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return Status::Unavailable();
+      }
+      data = data.subspan(static_cast<size_t>(sent));
+    }
+    return OkStatus();
+  }
+
+  int fd_ = kInvalidFd;
+};
+
+// Each connection has its own server-side channel ID. Clients typically all
+// use the same channel ID, so this output replaces the connection's channel ID
+// in outgoing packets with the one the client used.
+class ConnectionOutput : public ChannelOutput {
+ public:
+  ConnectionOutput(stream::Writer& writer)
+      : ChannelOutput("epoll connection"),
+        writer_(writer),
+        client_channel_id_(Channel::kUnassignedChannelId) {}
+
+  void set_client_channel_id(uint32_t id) { client_channel_id_ = id; }
+
+  std::span<std::byte> AcquireBuffer() override { return packet_buffer_; }
+
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) override {
+    if (buffer.empty()) {
+      return OkStatus();
+    }
+    PW_TRY_ASSIGN(internal::Packet packet,
+                  internal::Packet::FromBuffer(buffer));
+    packet.set_channel_id(client_channel_id_);
+    PW_TRY_ASSIGN(ConstByteSpan encoded, packet.Encode(encode_buffer_));
+
+    // Encode the whole frame before sending it, so that it takes one send()
+    // call instead of one per escaped section.
+    stream::MemoryWriter frame(frame_buffer_);
+    PW_TRY(hdlc::WriteUIFrame(hdlc::kDefaultRpcAddress, encoded, frame));
+    return writer_.Write(frame.WrittenData());
+  }
+
+ private:
+  stream::Writer& writer_;
+  uint32_t client_channel_id_;
+  std::array<std::byte, kMaxTransmissionUnit> packet_buffer_;
+  std::array<std::byte, kMaxTransmissionUnit> encode_buffer_;
+
+  // Enough for a packet with every byte escaped, plus the frame's address,
+  // control field, and CRC.
+  std::array<std::byte, 2 * (kMaxTransmissionUnit + 16)> frame_buffer_;
+};
+
+struct Connection {
+  Connection() : output(mutex, writer), decoder(decode_buffer) {}
+
+  // Guards the output and writer, which any thread may use to send packets.
+  sync::Mutex mutex;
+  SocketWriter writer;
+  SynchronizedChannelOutput<ConnectionOutput> output;
+
+  // Used by the event loop only.
+  int fd = kInvalidFd;
+  std::array<std::byte, kMaxTransmissionUnit> decode_buffer = {};
+  hdlc::Decoder decoder;
+  std::array<std::byte, kMaxTransmissionUnit> packet_buffer;
+};
+
+std::array<Connection, kMaxConnections> connections;
+std::array<Channel, kMaxConnections> channels;
+rpc::Server server(channels);
+
+constexpr uint32_t ChannelId(size_t index) {
+  return static_cast<uint32_t>(index) + 1;
+}
+
+Status Listen() {
+  listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if (listen_fd == kInvalidFd) {
+    PW_LOG_ERROR("Failed to create socket: %s", std::strerror(errno));
+    return Status::Unknown();
+  }
+
+  // Allow restarting the server while connections from a previous run are
+  // still closing.
+  constexpr int value = 1;
+  if (setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(int)) <
+      0) {
+    PW_LOG_WARN("Failed to set SO_REUSEADDR: %s", std::strerror(errno));
+  }
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(socket_port);
+  addr.sin_addr.s_addr = INADDR_ANY;
+
+  if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    PW_LOG_ERROR("Failed to bind socket to port %hu: %s",
+                 socket_port,
+                 std::strerror(errno));
+    return Status::Unknown();
+  }
+
+  if (listen(listen_fd, SOMAXCONN) < 0) {
+    PW_LOG_ERROR("Failed to listen to socket: %s", std::strerror(errno));
+    return Status::Unknown();
+  }
+
+  epoll_fd = epoll_create1(0);
+  if (epoll_fd == kInvalidFd) {
+    PW_LOG_ERROR("Failed to create epoll instance: %s", std::strerror(errno));
+    return Status::Unknown();
+  }
+
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.u64 = kListenerId;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) < 0) {
+    PW_LOG_ERROR("Failed to watch socket: %s", std::strerror(errno));
+    return Status::Unknown();
+  }
+  return OkStatus();
+}
+
+void OpenConnection(size_t index, int fd) {
+  Connection& connection = connections[index];
+
+  // RPC packets are small; send them immediately rather than batching them.
+  constexpr int value = 1;
+  if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(int)) < 0) {
+    PW_LOG_WARN("Failed to set TCP_NODELAY: %s", std::strerror(errno));
+  }
+
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.u64 = index;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+    PW_LOG_ERROR("Failed to watch connection: %s", std::strerror(errno));
+    close(fd);
+    return;
+  }
+
+  connection.fd = fd;
+  std::lock_guard lock(connection.mutex);
+  connection.writer.set_fd(fd);
+  connection.output.set_client_channel_id(Channel::kUnassignedChannelId);
+  PW_LOG_DEBUG("Opened connection on channel %u",
+               static_cast<unsigned>(ChannelId(index)));
+}
+
+void CloseConnection(size_t index) {
+  Connection& connection = connections[index];
+  epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection.fd, nullptr);
+  {
+    std::lock_guard lock(connection.mutex);
+    connection.writer.set_fd(kInvalidFd);
+  }
+  close(connection.fd);
+  connection.fd = kInvalidFd;
+  connection.decoder.Clear();
+  PW_LOG_DEBUG("Closed connection on channel %u",
+               static_cast<unsigned>(ChannelId(index)));
+}
+
+void AcceptConnections() {
+  while (true) {
+    const int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        PW_LOG_WARN("Failed to accept connection: %s", std::strerror(errno));
+      }
+      return;
+    }
+
+    size_t index = 0;
+    while (index < connections.size() && connections[index].fd != kInvalidFd) {
+      index += 1;
+    }
+
+    if (index == connections.size()) {
+      PW_LOG_WARN("Refusing connection; all %u connections are in use",
+                  static_cast<unsigned>(connections.size()));
+      close(fd);
+      continue;
+    }
+    OpenConnection(index, fd);
+  }
+}
+
+// Passes an RPC packet to the server on the connection's channel.
+void ProcessFrame(size_t index, const hdlc::Frame& frame) {
+  if (frame.address() != hdlc::kDefaultRpcAddress) {
+    return;
+  }
+
+  Result<internal::Packet> packet = internal::Packet::FromBuffer(frame.data());
+  if (!packet.ok()) {
+    PW_LOG_WARN("Dropping malformed RPC packet");
+    return;
+  }
+
+  Connection& connection = connections[index];
+  {
+    std::lock_guard lock(connection.mutex);
+    connection.output.set_client_channel_id(packet->channel_id());
+  }
+
+  packet->set_channel_id(ChannelId(index));
+  Result<ConstByteSpan> encoded = packet->Encode(connection.packet_buffer);
+  if (!encoded.ok()) {
+    return;
+  }
+  server.ProcessPacket(*encoded, connection.output)
+      .IgnoreError();  // TODO(pwbug/387): Handle Status properly
+}
+
+void ReadFromConnection(size_t index) {
+  Connection& connection = connections[index];
+  std::array<std::byte, kReadSizeBytes> data;
+
+  const ssize_t size =
+      recv(connection.fd, data.data(), data.size(), MSG_DONTWAIT);
+  if (size < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      CloseConnection(index);
+    }
+    return;
+  }
+  if (size == 0) {
+    CloseConnection(index);
+    return;
+  }
+
+  for (std::byte byte : std::span(data).first(static_cast<size_t>(size))) {
+    if (auto result = connection.decoder.Process(byte); result.ok()) {
+      ProcessFrame(index, result.value());
+    }
+  }
+}
+
+void HandleConnectionEvent(size_t index, uint32_t events) {
+  if (connections[index].fd == kInvalidFd) {
+    return;  // Closed earlier in this batch of events.
+  }
+  if ((events & EPOLLIN) != 0u) {
+    ReadFromConnection(index);
+  } else if ((events & (EPOLLHUP | EPOLLERR)) != 0u) {
+    CloseConnection(index);
+  }
+}
+
+}  // namespace
+
+void set_socket_port(uint16_t new_socket_port) {
+  socket_port = new_socket_port;
+}
+
+void Init() {
+  for (size_t i = 0; i < channels.size(); ++i) {
+    channels[i].Configure(ChannelId(i), connections[i].output);
+  }
+
+  PW_LOG_INFO("Starting pw_rpc server on port %d for up to %u connections",
+              socket_port,
+              static_cast<unsigned>(kMaxConnections));
+  PW_CHECK_OK(Listen());
+}
+
+rpc::Server& Server() { return server; }
+
+Status Start() {
+  std::array<epoll_event, kMaxEventsPerWait> events;
+
+  while (true) {
+    const int count = epoll_wait(epoll_fd, events.data(), events.size(), -1);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      PW_LOG_ERROR("Failed to wait for events: %s", std::strerror(errno));
+      return Status::Unknown();
+    }
+
+    for (int i = 0; i < count; ++i) {
+      if (events[i].data.u64 == kListenerId) {
+        AcceptConnections();
+      } else {
+        HandleConnectionEvent(static_cast<size_t>(events[i].data.u64),
+                              events[i].events);
+      }
+    }
+  }
+}
+
+}  // namespace pw::rpc::system_server
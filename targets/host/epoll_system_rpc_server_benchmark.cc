@@ -0,0 +1,213 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures the throughput of the epoll system RPC server for different numbers
+// of simultaneous connections. The server runs on a thread in this process;
+// each client connection sends one UnaryEcho request at a time and sends the
+// next when the response arrives. Results are logged.
+
+#define PW_LOG_MODULE_NAME "RPC"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_hdlc/rpc_packets.h"
+#include "pw_log/log.h"
+#include "pw_rpc/benchmark.h"
+#include "pw_rpc/internal/hash.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc_system_server/rpc_server.h"
+#include "pw_rpc_system_server/socket.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr uint16_t kPort = 33100;
+constexpr size_t kMaxClients = 256;
+constexpr size_t kRequestsPerTrial = 50000;
+constexpr size_t kPayloadSizeBytes = 64;
+constexpr int kTimeoutMs = 5000;
+
+struct ClientConnection {
+  ClientConnection() : decoder(decode_buffer) {}
+
+  int fd = -1;
+  size_t requests_remaining = 0;
+  std::array<std::byte, 512> decode_buffer = {};
+  hdlc::Decoder decoder;
+};
+
+BenchmarkService benchmark_service;
+std::array<ClientConnection, kMaxClients> clients;
+std::array<pollfd, kMaxClients> poll_fds;
+
+std::array<std::byte, 256> request_frame_buffer;
+ConstByteSpan request_frame;
+
+// Encodes the HDLC frame for a UnaryEcho request, which every client sends.
+Status EncodeRequest() {
+  std::array<std::byte, kPayloadSizeBytes + 2> payload = {};
+  payload[0] = std::byte{0x0a};  // Payload.payload, length-delimited
+  payload[1] = std::byte{kPayloadSizeBytes};
+
+  const internal::Packet packet(internal::PacketType::REQUEST,
+                                1,
+                                internal::Hash("pw.rpc.Benchmark"),
+                                internal::Hash("UnaryEcho"),
+                                1,
+                                payload);
+  std::array<std::byte, 128> packet_buffer;
+  PW_TRY_ASSIGN(ConstByteSpan encoded, packet.Encode(packet_buffer));
+
+  stream::MemoryWriter writer(request_frame_buffer);
+  PW_TRY(hdlc::WriteUIFrame(hdlc::kDefaultRpcAddress, encoded, writer));
+  request_frame = writer.WrittenData();
+  return OkStatus();
+}
+
+bool SendRequest(ClientConnection& client) {
+  client.requests_remaining -= 1;
+  return send(client.fd, request_frame.data(), request_frame.size(), 0) ==
+         static_cast<ssize_t>(request_frame.size());
+}
+
+Status Connect(ClientConnection& client) {
+  client.fd = socket(AF_INET, SOCK_STREAM, 0);
+  constexpr int value = 1;
+  setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(int));
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(kPort);
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  if (connect(client.fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) <
+      0) {
+    return Status::Unavailable();
+  }
+  return OkStatus();
+}
+
+// Reads responses from a client. Returns the number of responses received, or
+// -1 if the connection failed.
+int ReadResponses(ClientConnection& client) {
+  std::array<std::byte, 4096> data;
+  const ssize_t size = recv(client.fd, data.data(), data.size(), 0);
+  if (size <= 0) {
+    return -1;
+  }
+
+  int responses = 0;
+  for (std::byte byte : std::span(data).first(static_cast<size_t>(size))) {
+    if (client.decoder.Process(byte).ok()) {
+      responses += 1;
+      if (client.requests_remaining > 0u && !SendRequest(client)) {
+        return -1;
+      }
+    }
+  }
+  return responses;
+}
+
+void RunTrial(size_t client_count) {
+  for (size_t i = 0; i < client_count; ++i) {
+    if (!Connect(clients[i]).ok()) {
+      PW_LOG_ERROR("Failed to connect client %u", static_cast<unsigned>(i));
+      return;
+    }
+    clients[i].requests_remaining = kRequestsPerTrial / client_count;
+    poll_fds[i] = {.fd = clients[i].fd, .events = POLLIN, .revents = 0};
+  }
+
+  const size_t total_requests =
+      kRequestsPerTrial / client_count * client_count;
+  size_t responses = 0;
+
+  const auto start = chrono::SystemClock::now();
+  for (size_t i = 0; i < client_count; ++i) {
+    SendRequest(clients[i]);
+  }
+
+  while (responses < total_requests) {
+    const int ready = poll(poll_fds.data(), client_count, kTimeoutMs);
+    if (ready <= 0) {
+      PW_LOG_ERROR("Timed out waiting for responses");
+      break;
+    }
+    for (size_t i = 0; i < client_count; ++i) {
+      if ((poll_fds[i].revents & POLLIN) == 0) {
+        continue;
+      }
+      const int count = ReadResponses(clients[i]);
+      if (count < 0) {
+        PW_LOG_ERROR("Client %u failed", static_cast<unsigned>(i));
+        poll_fds[i].fd = -1;
+        continue;
+      }
+      responses += static_cast<size_t>(count);
+    }
+  }
+  const auto elapsed = chrono::SystemClock::now() - start;
+
+  for (size_t i = 0; i < client_count; ++i) {
+    close(clients[i].fd);
+    clients[i].decoder.Clear();
+  }
+
+  const int64_t us =
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  const int64_t per_second =
+      us == 0 ? 0 : static_cast<int64_t>(responses) * 1000000 / us;
+  PW_LOG_INFO("%3u connections: %6u requests in %5ld ms (%7ld requests/s)",
+              static_cast<unsigned>(client_count),
+              static_cast<unsigned>(responses),
+              static_cast<long>(us / 1000),
+              static_cast<long>(per_second));
+}
+
+}  // namespace
+}  // namespace pw::rpc
+
+int main() {
+  using namespace pw::rpc;
+
+  system_server::set_socket_port(kPort);
+  system_server::Init();
+  system_server::Server().RegisterService(benchmark_service);
+  std::thread server_thread([] { system_server::Start().IgnoreError(); });
+  server_thread.detach();
+
+  if (!EncodeRequest().ok()) {
+    PW_LOG_ERROR("Failed to encode the request");
+    return 1;
+  }
+
+  for (size_t client_count : {1, 4, 16, 64, 256}) {
+    RunTrial(client_count);
+  }
+  return 0;
+}
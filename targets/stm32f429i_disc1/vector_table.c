@@ -16,6 +16,7 @@
 
 #include "pw_boot/boot.h"
 #include "pw_boot_cortex_m/boot.h"
+#include "pw_sys_io_baremetal_stm32f429/init.h"
 
 // Default handler to insert into the ARMv7-M vector table (below).
 // This function exists for convenience. If a device isn't doing what you
@@ -55,4 +56,10 @@ const InterruptHandler vector_table[] = {
     [2] = DefaultFaultHandler,
     // HardFault handler.
     [3] = DefaultFaultHandler,
+
+    // Device interrupts start at entry 16. These are used by the asynchronous
+    // pw_sys_io functions.
+    [16 + 37] = pw_sys_io_stm32f429_Usart1Handler,  // USART1
+    [16 + 58] = pw_sys_io_stm32f429_DmaRxHandler,   // DMA2 stream 2
+    [16 + 70] = pw_sys_io_stm32f429_DmaTxHandler,   // DMA2 stream 7
 };